@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <cuda_bf16.h>
 #include <cuda_fp16.h>
 #include <dlpack/dlpack.h>
 #include <stdint.h>
@@ -69,7 +70,6 @@ struct PackedOn16Bytes<half> {
   using Type = PackedHalf;
 };
 
-#ifdef ENABLE_BF16
 using PackedBFloat16 = union {
   int4 packed;
   __nv_bfloat162 unpacked[4];
@@ -79,7 +79,6 @@ template <>
 struct PackedOn16Bytes<__nv_bfloat16> {
   using Type = PackedBFloat16;
 };
-#endif
 
 // add two 128b data
 template <typename T>
@@ -92,6 +91,19 @@ inline __device__ int4 add128b(T& a, T& b) {
   return c.packed;
 }
 
+// bfloat16 arithmetic is not native before sm_80, add in float32 instead.
+template <>
+inline __device__ int4 add128b(PackedBFloat16& a, PackedBFloat16& b) {
+  PackedBFloat16 c;
+#pragma unroll
+  for (int i = 0; i < 4; ++i) {
+    float2 fa = __bfloat1622float2(a.unpacked[i]);
+    float2 fb = __bfloat1622float2(b.unpacked[i]);
+    c.unpacked[i] = __floats2bfloat162_rn(fa.x + fb.x, fa.y + fb.y);
+  }
+  return c.packed;
+}
+
 __inline__ __device__ void multi_gpu_barrier(uint32_t** signals, const uint32_t flag,
                                              const size_t rank, const size_t world_size,
                                              int const tidx, int const bidx) {
@@ -356,17 +368,26 @@ void invokeOneOrTwoShotAllReduceKernel(AllReduceParams& param, AllReduceStrategy
     case 2:
       dispatchARKernels<T, 2>(strat, param, blocks_per_grid, threads_per_block, stream);
       break;
+    case 3:
+      dispatchARKernels<T, 3>(strat, param, blocks_per_grid, threads_per_block, stream);
+      break;
     case 4:
       dispatchARKernels<T, 4>(strat, param, blocks_per_grid, threads_per_block, stream);
       break;
+    case 5:
+      dispatchARKernels<T, 5>(strat, param, blocks_per_grid, threads_per_block, stream);
+      break;
     case 6:
       dispatchARKernels<T, 6>(strat, param, blocks_per_grid, threads_per_block, stream);
       break;
+    case 7:
+      dispatchARKernels<T, 7>(strat, param, blocks_per_grid, threads_per_block, stream);
+      break;
     case 8:
       dispatchARKernels<T, 8>(strat, param, blocks_per_grid, threads_per_block, stream);
       break;
     default:
-      break;
+      LOG(FATAL) << "Unsupported number of ranks for customAllReduce: " << param.ranks_per_node;
   }
   last_error = cudaGetLastError();
   if (last_error != cudaSuccess) {
@@ -387,13 +408,9 @@ void customAllReduce(AllReduceParams& params, void* data, size_t elts, DLDataTyp
     invokeOneOrTwoShotAllReduceKernel<float>(params, strat, stream);
   } else if (dataType.code == kDLFloat && dataType.bits == 16) {
     invokeOneOrTwoShotAllReduceKernel<half>(params, strat, stream);
-  }
-#ifdef ENABLE_BF16
-  else if (dataType.code == kDLBfloat && dataType.bits == 16) {
+  } else if (dataType.code == kDLBfloat && dataType.bits == 16) {
     invokeOneOrTwoShotAllReduceKernel<__nv_bfloat16>(params, strat, stream);
-  }
-#endif
-  else {
+  } else {
     LOG(FATAL) << ("Unsupported dataType for customAllReduce");
   }
 }
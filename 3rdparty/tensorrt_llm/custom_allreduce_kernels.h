@@ -15,6 +15,7 @@
  */
 
 #include <cuda_fp16.h>
+#include <dlpack/dlpack.h>
 #include <stdint.h>
 
 namespace tensorrt_llm {
@@ -51,28 +52,49 @@ inline size_t GetMaxRequiredWorkspaceSize(int world_size) {
   return 8 * 1000 * 1000;
 }
 
-inline AllReduceStrategyType SelectImplementation(size_t message_size, int world_size) {
-  const size_t maxWorkspaceSize = GetMaxRequiredWorkspaceSize(world_size);
-
-  if (message_size > maxWorkspaceSize) {
-    return AllReduceStrategyType::RING;
-  }
+/*! \brief The message sizes (in bytes) up to which each custom strategy is picked. */
+struct AllReduceCrossover {
+  /*! \brief Messages up to this size use the one-shot kernel. */
+  size_t oneshot_max_bytes;
+  /*! \brief Larger messages up to this size use the two-shot kernel, the rest go to NCCL. */
+  size_t twoshot_max_bytes;
+};
 
+inline AllReduceCrossover DefaultCrossover(int world_size) {
+  const size_t maxWorkspaceSize = GetMaxRequiredWorkspaceSize(world_size);
   if (world_size <= 2) {
-    return AllReduceStrategyType::ONESHOT;
+    return {maxWorkspaceSize, maxWorkspaceSize};
   }
-
   if (world_size <= 4) {
-    if (message_size < 1 * 1000 * 1000) {
-      return AllReduceStrategyType::ONESHOT;
-    }
-    return AllReduceStrategyType::TWOSHOT;
+    return {1 * 1000 * 1000, maxWorkspaceSize};
   }
+  return {500 * 1000, maxWorkspaceSize};
+}
 
-  if (message_size < 500 * 1000) {
+inline AllReduceStrategyType SelectImplementation(size_t message_size,
+                                                  const AllReduceCrossover& crossover) {
+  if (message_size <= crossover.oneshot_max_bytes) {
     return AllReduceStrategyType::ONESHOT;
   }
-  return AllReduceStrategyType::TWOSHOT;
+  if (message_size <= crossover.twoshot_max_bytes) {
+    return AllReduceStrategyType::TWOSHOT;
+  }
+  return AllReduceStrategyType::RING;
+}
+
+inline AllReduceStrategyType SelectImplementation(size_t message_size, int world_size) {
+  return SelectImplementation(message_size, DefaultCrossover(world_size));
+}
+
+/*! \brief Check if the custom kernels are compiled for the given number of ranks. */
+inline bool IsSupportedWorldSize(int world_size) {
+  return world_size >= 2 && world_size <= static_cast<int>(MAX_RANKS_PER_NODE);
+}
+
+/*! \brief Check if the custom kernels support the data type (float32, float16 and bfloat16). */
+inline bool IsSupportedDataType(DLDataType dtype) {
+  return dtype.lanes == 1 && ((dtype.code == kDLFloat && (dtype.bits == 32 || dtype.bits == 16)) ||
+                              (dtype.code == kDLBfloat && dtype.bits == 16));
 }
 
 void customAllReduce(AllReduceParams& params, void* data, size_t elts, DLDataType dataType,
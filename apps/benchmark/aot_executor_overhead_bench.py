@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compare the time of one inference with the graph executor and the AOT executor on a CPU.
+
+The AOT executor runs a main function which calls the kernels directly, with the workspace of
+the model planned by USMP and the kernels called through their unchecked entries. A chain of
+small elementwise ops measures the overhead per op of each executor, and ResNet-18 measures the
+time of a model whose kernels dominate.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.relay import testing
+from tvm.relay.backend import Executor
+
+
+def chain_workload(num_ops):
+    """A chain of elementwise ops on a small tensor, which are not fused at opt_level 0."""
+    x = relay.var("data", shape=(1, 64), dtype="float32")
+    y = x
+    for i in range(num_ops):
+        y = relay.sigmoid(y) if i % 2 else relay.nn.relu(y)
+    return tvm.IRModule.from_expr(relay.Function([x], y)), {}
+
+
+WORKLOADS = {
+    "chain-64": (lambda: chain_workload(64), 0),
+    "resnet-18": (lambda: testing.resnet.get_workload(num_layers=18, batch_size=1), 3),
+}
+
+
+def build(target, mod, params, opt_level, executor):
+    if executor == "graph":
+        config = {"tir.emit_unchecked_api": True}
+        with tvm.transform.PassContext(opt_level=opt_level, config=config):
+            lib = relay.build(mod, target=target, params=params)
+        return graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    config = {"tir.emit_unchecked_api": True, "tir.usmp.enable": True}
+    with tvm.transform.PassContext(opt_level=opt_level, config=config):
+        lib = relay.build(
+            mod,
+            target=target,
+            params=params,
+            executor=Executor("aot", {"interface-api": "packed", "unpacked-api": False}),
+        )
+    return tvm.runtime.executor.AotModule(lib["default"](tvm.cpu()))
+
+
+def benchmark(target, mod, params, opt_level, executor, repeat):
+    """Return the mean time of one inference in seconds."""
+    module = build(target, mod, params, opt_level, executor)
+    shape = [int(dim) for dim in mod["main"].params[0].checked_type.shape]
+    module.set_input("data", np.random.uniform(size=shape).astype("float32"))
+    timer = module.module.time_evaluator("run", tvm.cpu(), number=100, repeat=repeat)
+    return timer().mean
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -mcpu=native")
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    print("%12s %14s %14s %8s" % ("model", "graph (us)", "aot (us)", "speedup"))
+    for name, (get_workload, level) in WORKLOADS.items():
+        model, model_params = get_workload()
+        model = relay.transform.InferType()(model)
+        graph_time = benchmark(args.target, model, model_params, level, "graph", args.repeat)
+        aot_time = benchmark(args.target, model, model_params, level, "aot", args.repeat)
+        print(
+            "%12s %14.2f %14.2f %8.2f"
+            % (name, graph_time * 1e6, aot_time * 1e6, graph_time / aot_time)
+        )
@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Microbenchmark of the custom CUDA IPC all-reduce against NCCL.
+
+Times the ring (NCCL), one-shot and two-shot strategies over a range of message sizes and
+reports the crossover sizes for the current machine, which can be applied to the AUTO
+strategy with `runtime.disco.cuda_ipc.set_custom_allreduce_crossover`.
+"""
+import argparse
+
+import tvm
+from tvm.runtime import DataType, ShapeTuple, disco
+
+STRATEGIES = {"ring": 0, "oneshot": 1, "twoshot": 2}
+
+
+def benchmark(num_workers, dtype, min_bytes, max_bytes, num_iters):
+    """Return a list of (message bytes, {strategy: latency in us})."""
+    sess = disco.ProcessSession(num_workers=num_workers)
+    sess.init_ccl("nccl", *range(num_workers))
+    falloc_ipc_storage = sess.get_global_func("runtime.disco.cuda_ipc.alloc_storage")
+    falloc_tensor = sess.get_global_func("vm.builtin.alloc_tensor")
+    fbench = sess.get_global_func("runtime.disco.cuda_ipc.benchmark_custom_allreduce")
+
+    itemsize = DataType(dtype).bits // 8
+    results = []
+    nbytes = min_bytes
+    while nbytes <= max_bytes:
+        shape = ShapeTuple([nbytes // itemsize])
+        d_storage = sess.call_packed(falloc_ipc_storage, shape, DataType(dtype))
+        d_input = sess.call_packed(falloc_tensor, d_storage, 0, shape, DataType(dtype))
+        d_output = sess.empty(tuple(shape), dtype)
+        latency = {}
+        for name, strategy in STRATEGIES.items():
+            d_latency = sess.call_packed(fbench, d_input, strategy, d_output, num_iters)
+            latency[name] = d_latency.debug_get_from_remote(0)
+        results.append((nbytes, latency))
+        nbytes *= 2
+    sess.shutdown()
+    return results
+
+
+def crossover(results):
+    """The largest sizes at which one-shot wins, and at which a custom kernel beats NCCL."""
+    oneshot_max_bytes = 0
+    twoshot_max_bytes = 0
+    for nbytes, latency in results:
+        if latency["oneshot"] <= min(latency["twoshot"], latency["ring"]):
+            oneshot_max_bytes = nbytes
+        if min(latency["oneshot"], latency["twoshot"]) <= latency["ring"]:
+            twoshot_max_bytes = nbytes
+    return oneshot_max_bytes, max(oneshot_max_bytes, twoshot_max_bytes)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-workers", type=int, default=2)
+    parser.add_argument("--dtype", type=str, default="float16")
+    parser.add_argument("--min-bytes", type=int, default=1 << 10)
+    parser.add_argument("--max-bytes", type=int, default=16 << 20)
+    parser.add_argument("--num-iters", type=int, default=100)
+    args = parser.parse_args()
+
+    results = benchmark(
+        args.num_workers, args.dtype, args.min_bytes, args.max_bytes, args.num_iters
+    )
+    print("%-12s %12s %12s %12s" % ("bytes", "ring (us)", "oneshot (us)", "twoshot (us)"))
+    for nbytes, latency in results:
+        print(
+            "%-12d %12.2f %12.2f %12.2f"
+            % (nbytes, latency["ring"], latency["oneshot"], latency["twoshot"])
+        )
+    oneshot_max_bytes, twoshot_max_bytes = crossover(results)
+    print(
+        "crossover for %d workers: oneshot_max_bytes=%d, twoshot_max_bytes=%d"
+        % (args.num_workers, oneshot_max_bytes, twoshot_max_bytes)
+    )
@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compare the storage planned by the graph memory planners of the Relay graph executor.
+
+Builds reference models with the "greedy" and the "offset" planner of
+`relay.backend.graph_memory_planner`, and reports the total bytes of the storage of each graph,
+parameters included, and the time of one run.
+"""
+import argparse
+import json
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.relay import testing
+
+MODELS = {
+    "resnet-18": lambda batch: testing.resnet.get_workload(num_layers=18, batch_size=batch),
+    "resnet-50": lambda batch: testing.resnet.get_workload(num_layers=50, batch_size=batch),
+    "mobilenet": lambda batch: testing.mobilenet.get_workload(batch_size=batch),
+    "inception_v3": lambda batch: testing.inception_v3.get_workload(batch_size=batch),
+    "densenet-121": lambda batch: testing.densenet.get_workload(batch_size=batch),
+}
+
+
+def storage_bytes(graph_json):
+    """Return the total bytes of the storage of a graph."""
+    attrs = graph_json["attrs"]
+    num_entries = len(attrs["storage_id"][1])
+    offsets = attrs.get("storage_offset", ["list_int", [0] * num_entries])[1]
+    sid_bytes = {}
+    for sid, shape, dtype, offset in zip(
+        attrs["storage_id"][1], attrs["shape"][1], attrs["dltype"][1], offsets
+    ):
+        nbytes = int(np.prod(shape)) * np.dtype(dtype).itemsize + offset
+        sid_bytes[sid] = max(sid_bytes.get(sid, 0), nbytes)
+    return sum(sid_bytes.values())
+
+
+def benchmark(target, mod, params, planner, repeat):
+    """Return the storage bytes and the mean time of one run in seconds."""
+    config = {"relay.backend.graph_memory_planner": planner}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = relay.build(mod, target=target, params=params)
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    timer = gmod.module.time_evaluator("run", tvm.cpu(), number=5, repeat=repeat)
+    return storage_bytes(json.loads(lib.get_graph_json())), timer().mean
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -mcpu=native")
+    parser.add_argument("--models", type=str, nargs="+", default=list(MODELS))
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    print(
+        "%14s %14s %14s %8s %12s %12s"
+        % ("model", "greedy (MB)", "offset (MB)", "saved", "greedy (ms)", "offset (ms)")
+    )
+    for name in args.models:
+        model, params = MODELS[name](args.batch_size)
+        greedy_bytes, greedy_time = benchmark(args.target, model, params, "greedy", args.repeat)
+        offset_bytes, offset_time = benchmark(args.target, model, params, "offset", args.repeat)
+        print(
+            "%14s %14.2f %14.2f %7.1f%% %12.3f %12.3f"
+            % (
+                name,
+                greedy_bytes / 2**20,
+                offset_bytes / 2**20,
+                100.0 * (1 - offset_bytes / greedy_bytes),
+                greedy_time * 1e3,
+                offset_time * 1e3,
+            )
+        )
@@ -0,0 +1,93 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the unions of the integer sets in the access region detection of large PrimFuncs.
+
+Generates a chain of strided stencils, each block reading a tensor at `taps` constant offsets of
+the same affine index, so the region of each buffer is the union of one interval per access. The
+benchmark times the creation of the PrimFunc, which detects the access regions of every block, and
+the detection on the blocks of the created PrimFunc.
+"""
+import argparse
+import time
+
+from tvm import te, tir
+
+
+def make_func(num_blocks, taps, stride, size):
+    """A chain of `num_blocks` strided stencils of `taps` taps each."""
+    tensors = [te.placeholder(((size - 1) * stride + taps,), name="A")]
+    for i in range(num_blocks):
+        x = tensors[-1]
+        tensors.append(
+            te.compute(
+                (size,),
+                lambda j, x=x: sum(x[j * stride + t] for t in range(taps)),
+                name=f"B{i}",
+            )
+        )
+        # The next stencil reads the output at the same strided offsets.
+        tensors.append(
+            te.compute(
+                ((size - 1) * stride + taps,),
+                lambda j, y=tensors[-1]: y[j // stride],
+                name=f"C{i}",
+            )
+        )
+    return tensors[0], tensors[-1]
+
+
+def collect_blocks(func):
+    blocks = []
+
+    def fvisit(node):
+        if isinstance(node, tir.Block) and node.name_hint != "root":
+            blocks.append(node)
+
+    tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return blocks
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-blocks", type=int, default=64)
+    parser.add_argument("--taps", type=int, default=16)
+    parser.add_argument("--stride", type=int, default=4)
+    parser.add_argument("--size", type=int, default=256)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+    inputs, output = make_func(args.num_blocks, args.taps, args.stride, args.size)
+    create_time = detect_time = float("inf")
+    for _ in range(args.repeat):
+        start = time.perf_counter()
+        func = te.create_prim_func([inputs, output])
+        create_time = min(create_time, time.perf_counter() - start)
+        root = func.body.block
+        buffer_var_map = {buf.data: buf for buf in root.alloc_buffers}
+        buffer_var_map.update({buf.data: buf for buf in func.buffer_map.values()})
+        blocks = collect_blocks(func)
+        start = time.perf_counter()
+        for block in blocks:
+            tir.analysis.get_block_access_region(block, buffer_var_map)
+        detect_time = min(detect_time, time.perf_counter() - start)
+    num_accesses = args.num_blocks * (args.taps + 1)
+    print(f"{len(blocks)} blocks, {num_accesses} accesses")
+    print(f"create_prim_func:        {create_time * 1e3:10.3f} ms")
+    print(f"get_block_access_region: {detect_time * 1e3:10.3f} ms")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the compile time of the LLVM backend with a partitioned code generation.
+
+Builds a module of many independent kernels with each value of `target.llvm_codegen_partitions`,
+and times the build, which generates and optimizes the LLVM IR, and the export, which emits the
+object code.
+"""
+import argparse
+import os
+import tempfile
+import time
+
+import tvm
+from tvm import te
+
+
+def make_kernels(num_kernels, size):
+    """Lower `num_kernels` tiled matmuls of different constants."""
+    funcs = []
+    for i in range(num_kernels):
+        a = te.placeholder((size, size), name="A")
+        b = te.placeholder((size, size), name="B")
+        k = te.reduce_axis((0, size), name="k")
+        c = te.compute(
+            (size, size), lambda x, y: te.sum(a[x, k] * b[k, y] * (i + 1), axis=k), name="C"
+        )
+        s = te.create_schedule(c.op)
+        xo, yo, xi, yi = s[c].tile(c.op.axis[0], c.op.axis[1], 32, 32)
+        s[c].reorder(xo, yo, k, xi, yi)
+        s[c].vectorize(yi)
+        s[c].parallel(xo)
+        funcs.append(tvm.lower(s, [a, b, c], name="kernel%d" % i))
+    return funcs
+
+
+def benchmark(target, funcs, num_partitions):
+    """Return the (build, export) time in seconds."""
+    config = {"target.llvm_codegen_partitions": num_partitions}
+    with tvm.transform.PassContext(config=config):
+        start = time.perf_counter()
+        lib = tvm.build(funcs, target)
+        build_time = time.perf_counter() - start
+    with tempfile.TemporaryDirectory() as tmp:
+        start = time.perf_counter()
+        lib.export_library(os.path.join(tmp, "lib.so"))
+        export_time = time.perf_counter() - start
+    return build_time, export_time
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--num-kernels", type=int, default=64)
+    parser.add_argument("--size", type=int, default=256)
+    parser.add_argument("--num-partitions", type=int, nargs="+", default=[1, 2, 4, 8])
+    args = parser.parse_args()
+
+    funcs = make_kernels(args.num_kernels, args.size)
+    print("%12s %12s %12s" % ("partitions", "build (s)", "export (s)"))
+    for num_partitions in args.num_partitions:
+        build_time, export_time = benchmark(args.target, funcs, num_partitions)
+        print("%12d %12.3f %12.3f" % (num_partitions, build_time, export_time))
@@ -0,0 +1,199 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Replay a trace of requests through the language model engine of the runtime on a CUDA GPU.
+
+The engine `vm.builtin.lm_engine_*` runs the step loop of continuous batching on the paged KV
+cache with the batched sampler. The model is the attention of the KV cache of each layer on random
+queries, keys and values, whose kernels are built by the tests of the paged KV cache, followed by
+random logits, so the benchmark measures the runtime around the kernels of a model.
+
+The requests arrive by a Poisson process, or by a trace file of one JSON object per line with
+the fields "arrival" in seconds, "prompt_len" and "output_len". The benchmark reports the prefill
+and decode throughput, the mean host time of each phase of a step, where the copy of the
+auxiliary arrays of the KV cache is the excess time of the first attention over the others, and
+the percentiles of the inter-token latency.
+"""
+import argparse
+import importlib.util
+import json
+import os
+import time
+
+import numpy as np
+
+import tvm
+
+KV_CACHE_TEST = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)),
+    "../../tests/python/relax/test_runtime_builtin_paged_attention_kv_cache_tir.py",
+)
+
+f_create = tvm.get_global_func("vm.builtin.lm_engine_create")
+f_submit = tvm.get_global_func("vm.builtin.lm_engine_submit")
+f_poll = tvm.get_global_func("vm.builtin.lm_engine_poll")
+f_step = tvm.get_global_func("vm.builtin.lm_engine_step")
+f_set_record_step_stats = tvm.get_global_func("vm.builtin.lm_engine_set_record_step_stats")
+f_take_step_stats = tvm.get_global_func("vm.builtin.lm_engine_take_step_stats")
+
+
+def load_trace(args):
+    """Return the requests as a list of (arrival, prompt_len, output_len) sorted by arrival."""
+    if args.trace is not None:
+        with open(args.trace) as f:
+            requests = [json.loads(line) for line in f if line.strip()]
+        return sorted((r["arrival"], r["prompt_len"], r["output_len"]) for r in requests)
+    rng = np.random.default_rng(args.seed)
+    if args.arrival_rate > 0:
+        arrivals = np.cumsum(rng.exponential(1.0 / args.arrival_rate, args.num_requests))
+    else:
+        arrivals = np.zeros(args.num_requests)
+    # The lengths are uniform within half of their means.
+    prompt_lens = rng.integers(args.prompt_len // 2, args.prompt_len * 3 // 2 + 1, len(arrivals))
+    output_lens = rng.integers(args.output_len // 2, args.output_len * 3 // 2 + 1, len(arrivals))
+    return [
+        (float(arrival), max(int(prompt_len), 1), max(int(output_len), 1))
+        for arrival, prompt_len, output_len in zip(arrivals, prompt_lens, output_lens)
+    ]
+
+
+def create_kv_cache(args):
+    """Create the paged KV cache with the kernels of the tests of the paged KV cache."""
+    spec = importlib.util.spec_from_file_location("paged_kv_cache_test", KV_CACHE_TEST)
+    kv_cache_test = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(kv_cache_test)
+    kv_cache_test.reserved_nseq = args.max_batch_size
+    kv_cache_test.maximum_total_seq_length = args.max_total_seq_length
+    kv_cache_test.prefill_chunk_size = args.prefill_chunk_size
+    kv_cache_test.page_size = args.page_size
+    kv_cache_test.num_layers = args.num_layers
+    kv_cache_test.set_global_func(args.head_dim, args.dtype)
+    kv_cache = kv_cache_test.create_kv_cache(
+        args.head_dim, args.dtype, kv_cache_test.RopeMode.NORMAL, False
+    )
+    return kv_cache, kv_cache_test
+
+
+def create_forward(args, kv_cache_test, aux_times):
+    """Create the forward function of the model, which records the time of the aux copy."""
+    device = tvm.cuda()
+    num_heads = kv_cache_test.num_qo_heads + 2 * kv_cache_test.num_kv_heads
+    shape = (args.prefill_chunk_size, num_heads, args.head_dim)
+    qkv = tvm.nd.array(np.random.uniform(size=shape).astype(args.dtype), device)
+    shape = (args.prefill_chunk_size, kv_cache_test.num_qo_heads, args.head_dim)
+    outputs = tvm.nd.empty(shape, args.dtype, device)
+    shape = (args.max_batch_size, args.vocab_size)
+    logits = tvm.nd.array(np.random.normal(size=shape).astype("float32"), device)
+    f_attention = kv_cache_test.fattention_with_fuse_qkv
+
+    def forward(input_ids, logit_positions, kv_state):
+        num_tokens = input_ids.shape[0]
+        layer_qkv = qkv._create_view((num_tokens,) + qkv.shape[1:])
+        layer_outputs = outputs._create_view((num_tokens,) + outputs.shape[1:])
+        # The first attention of a step copies the auxiliary arrays to the device.
+        tstart = time.perf_counter()
+        f_attention(kv_state, 0, 1.0, layer_qkv, layer_outputs)
+        device.sync()
+        tlayer = time.perf_counter()
+        for layer_id in range(1, args.num_layers):
+            f_attention(kv_state, layer_id, 1.0, layer_qkv, layer_outputs)
+        device.sync()
+        tend = time.perf_counter()
+        steady = (tend - tlayer) / max(args.num_layers - 1, 1)
+        aux_times.append(max(tlayer - tstart - steady, 0.0))
+        return logits._create_view((logit_positions.shape[0], args.vocab_size))
+
+    return forward
+
+
+def benchmark(args):
+    requests = load_trace(args)
+    kv_cache, kv_cache_test = create_kv_cache(args)
+    aux_times = []
+    forward = create_forward(args, kv_cache_test, aux_times)
+    engine = f_create(
+        forward,
+        kv_cache,
+        tvm.cuda(),
+        args.max_batch_size,
+        args.prefill_chunk_size,
+        args.page_size,
+    )
+    token_times = [[] for _ in requests]
+    finished = []
+
+    def f_stream(request_id, new_tokens, finish_reason, _new_text):
+        now = time.perf_counter()
+        token_times[request_id] += [now] * len(new_tokens)
+        if finish_reason:
+            finished.append(request_id)
+
+    rng = np.random.default_rng(args.seed)
+    f_set_record_step_stats(engine, True)
+    num_submitted = 0
+    num_unfinished = 0
+    tstart = time.perf_counter()
+    while num_submitted < len(requests) or num_unfinished > 0:
+        now = time.perf_counter() - tstart
+        if num_unfinished == 0 and requests[num_submitted][0] > now:
+            time.sleep(requests[num_submitted][0] - now)
+            now = requests[num_submitted][0]
+        while num_submitted < len(requests) and requests[num_submitted][0] <= now:
+            _, prompt_len, output_len = requests[num_submitted]
+            prompt = rng.integers(0, args.vocab_size, prompt_len).tolist()
+            args_submit = [engine, num_submitted, tvm.runtime.ShapeTuple(prompt), output_len]
+            args_submit += [1.0, 0.95, tvm.runtime.ShapeTuple([]), f_stream]
+            f_submit(*args_submit)
+            num_submitted += 1
+        num_unfinished = f_step(engine)
+        for request_id in finished:
+            f_poll(engine, request_id)
+        finished.clear()
+    duration = time.perf_counter() - tstart
+
+    stats = f_take_step_stats(engine).numpy()
+    aux = np.array(aux_times)
+    inter_token = np.concatenate([np.diff(times) for times in token_times])
+    print(f"{len(requests)} requests in {len(stats)} steps, {duration:.2f} s")
+    print(f"prefill: {stats[:, 1].sum() / duration:10.1f} tokens/s")
+    print(f"decode:  {stats[:, 0].sum() / duration:10.1f} tokens/s")
+    print("Mean host time of a step (us):")
+    print(f"  {'BeginForward':<14}{stats[:, 2].mean() * 1e6:10.1f}")
+    print(f"  {'aux copy':<14}{aux.mean() * 1e6:10.1f}")
+    print(f"  {'kernel':<14}{(stats[:, 3] - aux).mean() * 1e6:10.1f}")
+    print(f"  {'sampling':<14}{stats[:, 4].mean() * 1e6:10.1f}")
+    if len(inter_token) > 0:
+        p50, p99 = np.percentile(inter_token, [50, 99]) * 1e3
+        print(f"Inter-token latency: p50 {p50:.2f} ms, p99 {p99:.2f} ms")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--trace", type=str, default=None)
+    parser.add_argument("--num-requests", type=int, default=64)
+    parser.add_argument("--arrival-rate", type=float, default=8.0, help="0 for all at once")
+    parser.add_argument("--prompt-len", type=int, default=256)
+    parser.add_argument("--output-len", type=int, default=128)
+    parser.add_argument("--max-batch-size", type=int, default=32)
+    parser.add_argument("--prefill-chunk-size", type=int, default=512)
+    parser.add_argument("--max-total-seq-length", type=int, default=16384)
+    parser.add_argument("--page-size", type=int, default=16)
+    parser.add_argument("--num-layers", type=int, default=8)
+    parser.add_argument("--head-dim", type=int, default=128)
+    parser.add_argument("--dtype", type=str, default="float16")
+    parser.add_argument("--vocab-size", type=int, default=32000)
+    parser.add_argument("--seed", type=int, default=0)
+    benchmark(parser.parse_args())
@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the throughput of the per-store feature extraction of MetaSchedule.
+
+Samples candidates of a matmul from its design space, and times the feature extraction of them
+with each number of threads, both on fresh candidates and on candidates already seen, which the
+feature cache serves as in the later iterations of the evolutionary search.
+"""
+import argparse
+import time
+
+from tvm import meta_schedule as ms
+from tvm import te, tir
+from tvm.target import Target
+
+
+def make_candidates(target, size, num_candidates, seed):
+    """Sample `num_candidates` schedules of a matmul."""
+    a = te.placeholder((size, size), name="A")
+    b = te.placeholder((size, size), name="B")
+    k = te.reduce_axis((0, size), name="k")
+    c = te.compute((size, size), lambda i, j: te.sum(a[i, k] * b[k, j], axis=k), name="C")
+    context = ms.TuneContext(
+        mod=te.create_prim_func([a, b, c]),
+        target=target,
+        space_generator="post-order-apply",
+        search_strategy="replay-trace",
+        rand_state=seed,
+    )
+    (space,) = context.generate_design_space()
+    # The trace with no decisions, which samples new ones when applied.
+    trace = tir.Trace(space.trace.insts, {})
+    candidates = []
+    for i in range(num_candidates):
+        sch = tir.Schedule(context.mod, seed=seed + i)
+        trace.apply_to_schedule(sch, remove_postproc=True)
+        candidates.append(ms.MeasureCandidate(sch, args_info=[]))
+    return candidates
+
+
+def benchmark(target, candidates, num_threads):
+    """Return (fresh, cached) throughput in candidates per second."""
+    context = ms.TuneContext(target=target, num_threads=num_threads)
+    extractor = ms.feature_extractor.PerStoreFeature()
+    results = []
+    for _ in range(2):
+        start = time.perf_counter()
+        extractor.extract_from(context, candidates)
+        results.append(len(candidates) / (time.perf_counter() - start))
+    return tuple(results)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -num-cores=8")
+    parser.add_argument("--size", type=int, default=512)
+    parser.add_argument("--num-candidates", type=int, default=256)
+    parser.add_argument("--num-threads", type=int, nargs="+", default=[1, 2, 4, 8])
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    target = Target(args.target)
+    candidates = make_candidates(target, args.size, args.num_candidates, args.seed)
+    print("%8s %16s %16s" % ("threads", "fresh (cand/s)", "cached (cand/s)"))
+    for num_threads in args.num_threads:
+        fresh, cached = benchmark(target, candidates, num_threads)
+        print("%8d %16.1f %16.1f" % (num_threads, fresh, cached))
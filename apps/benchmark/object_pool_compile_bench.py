@@ -0,0 +1,113 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the end-to-end compile time of reference models, e.g. to compare builds of TVM with
+and without `USE_OBJECT_POOL_ALLOCATOR`.
+
+Times the Relay build of ResNet-18 and the Relax build of a stack of LLM decoder layers. Run it
+with each build of TVM and compare the times.
+"""
+import argparse
+import time
+
+import tvm
+from tvm import relax, relay
+from tvm.relax.frontend import nn
+from tvm.relax.frontend.nn import op, spec
+from tvm.relay import testing
+
+
+class DecoderLayer(nn.Module):
+    """A decoder layer of self-attention and a gated MLP, as in Llama."""
+
+    def __init__(self, hidden, num_heads, intermediate):
+        self.num_heads = num_heads
+        self.input_norm = nn.RMSNorm(hidden, axes=-1, bias=False)
+        self.q_proj = nn.Linear(hidden, hidden, bias=False)
+        self.k_proj = nn.Linear(hidden, hidden, bias=False)
+        self.v_proj = nn.Linear(hidden, hidden, bias=False)
+        self.o_proj = nn.Linear(hidden, hidden, bias=False)
+        self.post_norm = nn.RMSNorm(hidden, axes=-1, bias=False)
+        self.gate_proj = nn.Linear(hidden, intermediate, bias=False)
+        self.up_proj = nn.Linear(hidden, intermediate, bias=False)
+        self.down_proj = nn.Linear(intermediate, hidden, bias=False)
+
+    def forward(self, x):
+        batch, seq_len, hidden = x.shape
+        head_dim = hidden // self.num_heads
+
+        def split_heads(t):
+            t = op.reshape(t, (batch, seq_len, self.num_heads, head_dim))
+            return op.permute_dims(t, (0, 2, 1, 3))
+
+        h = self.input_norm(x)
+        q, k, v = [split_heads(proj(h)) for proj in (self.q_proj, self.k_proj, self.v_proj)]
+        scores = op.matmul(q, op.permute_dims(k, (0, 1, 3, 2))) / (head_dim**0.5)
+        attn = op.matmul(op.softmax(scores, axis=-1), v)
+        attn = op.reshape(op.permute_dims(attn, (0, 2, 1, 3)), (batch, seq_len, hidden))
+        x = x + self.o_proj(attn)
+        h = self.post_norm(x)
+        return x + self.down_proj(op.silu(self.gate_proj(h)) * self.up_proj(h))
+
+
+class Decoder(nn.Module):
+    def __init__(self, num_layers, hidden, num_heads, intermediate):
+        self.layers = nn.ModuleList(
+            [DecoderLayer(hidden, num_heads, intermediate) for _ in range(num_layers)]
+        )
+
+    def forward(self, x):
+        for layer in self.layers:
+            x = layer(x)
+        return x
+
+
+def time_resnet(target):
+    mod, params = testing.resnet.get_workload(num_layers=18, batch_size=1)
+    start = time.perf_counter()
+    with tvm.transform.PassContext(opt_level=3):
+        relay.build(mod, target=target, params=params)
+    return time.perf_counter() - start
+
+
+def time_decoder(target, num_layers, seq_len):
+    hidden, num_heads, intermediate = 512, 8, 1376
+    x_spec = spec.Tensor((1, seq_len, hidden), "float32")
+    mod, _ = Decoder(num_layers, hidden, num_heads, intermediate).export_tvm(
+        spec={"forward": {"x": x_spec}}
+    )
+    start = time.perf_counter()
+    relax.build(mod, target=target)
+    return time.perf_counter() - start
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--num-layers", type=int, default=8)
+    parser.add_argument("--seq-len", type=int, default=32)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    pooled = tvm.support.libinfo().get("USE_OBJECT_POOL_ALLOCATOR", "NOT-FOUND")
+    print("USE_OBJECT_POOL_ALLOCATOR: %s" % pooled)
+    print("%24s %12s" % ("model", "build (s)"))
+    resnet_time = min(time_resnet(args.target) for _ in range(args.repeat))
+    print("%24s %12.3f" % ("ResNet-18 (Relay)", resnet_time))
+    decoder_time = min(
+        time_decoder(args.target, args.num_layers, args.seq_len) for _ in range(args.repeat)
+    )
+    print("%24s %12.3f" % ("%d-layer decoder (Relax)" % args.num_layers, decoder_time))
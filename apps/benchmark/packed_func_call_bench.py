@@ -0,0 +1,41 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the per-call overhead of PackedFunc calls from C++.
+
+Calls a function registered with `set_body_typed` from C++ through each calling convention: the
+typed call of a TypedPackedFunc, which skips the packing of the arguments, the variadic call of
+a PackedFunc, and CallPacked with arguments packed in std::vector or in a TVMArgsPack.
+"""
+import argparse
+
+import tvm
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-calls", type=int, default=10000000)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    f_overhead = tvm.get_global_func("testing.packed_call_overhead")
+    best = {}
+    for _ in range(args.repeat):
+        for name, time_ns in f_overhead(args.num_calls).items():
+            best[str(name)] = min(best.get(str(name), float("inf")), time_ns.value)
+    print("%16s %12s" % ("convention", "ns / call"))
+    for name in ["typed", "packed", "vector_args", "args_pack"]:
+        print("%16s %12.2f" % (name, best[name]))
@@ -0,0 +1,73 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compare the bytecode and compiled execution modes of the Relax VM.
+
+Builds the same chain of small element-wise kernels in both modes and times a call of the
+function, where the host-side overhead of dispatching each kernel dominates the latency.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relax
+from tvm.script import relax as R
+
+
+def make_module(num_layers, size):
+    """A function that adds one to its input `num_layers` times."""
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", R.Tensor((size,), "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            y = x
+            for _ in range(num_layers):
+                y = bb.emit(relax.op.add(y, relax.const(1.0, "float32")))
+            gv = bb.emit_output(y)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def benchmark(target, num_layers, size, number, repeat):
+    """Return {exec mode: mean latency in us}."""
+    mod = make_module(num_layers, size)
+    dev = tvm.device(str(target.kind), 0)
+    x = tvm.nd.array(np.zeros((size,), "float32"), dev)
+    results = {}
+    for exec_mode in ["bytecode", "compiled"]:
+        ex = relax.build(mod, target, exec_mode=exec_mode)
+        vm = relax.VirtualMachine(ex, dev)
+        np.testing.assert_allclose(vm["main"](x).numpy(), np.full((size,), num_layers))
+        timer = vm.time_evaluator("main", dev, number=number, repeat=repeat)
+        results[exec_mode] = timer(x).mean * 1e6
+    return results
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--num-layers", type=int, default=256)
+    parser.add_argument("--size", type=int, default=16)
+    parser.add_argument("--number", type=int, default=100)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    target = tvm.target.Target(args.target, host="llvm")
+    results = benchmark(target, args.num_layers, args.size, args.number, args.repeat)
+    for exec_mode, latency in results.items():
+        print("%-10s %12.2f us" % (exec_mode, latency))
+    print("speedup of compiled: %.2fx" % (results["bytecode"] / results["compiled"]))
@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the latency of the schedule primitives on high-rank layouts.
+
+Builds a chain of an elementwise op and a reduction on tensors of the given rank, like the
+blocked layouts of attention, tiles every loop of both blocks, and reports the mean latency of
+each primitive. Each primitive redoes the affine binding checks of the blocks under the replaced
+statement, which the schedule state memoizes.
+"""
+import argparse
+import time
+from collections import defaultdict
+
+from tvm import te, tir
+
+
+def make_func(rank, extent):
+    """An elementwise op followed by a sum over the last axis of a rank-`rank` tensor."""
+    shape = [extent] * rank
+    a = te.placeholder(shape, name="A")
+    b = te.compute(shape, lambda *idx: a(*idx) * 2.0, name="B")
+    k = te.reduce_axis((0, extent), name="k")
+    c = te.compute(shape[:-1], lambda *idx: te.sum(b(*idx, k), axis=k), name="C")
+    return te.create_prim_func([a, c])
+
+
+def schedule(func, factor, times):
+    """Tile both blocks and compute the producer at the consumer, timing each primitive."""
+
+    def timed(name, f, *args, **kwargs):
+        start = time.perf_counter()
+        result = f(*args, **kwargs)
+        times[name].append(time.perf_counter() - start)
+        return result
+
+    sch = tir.Schedule(func)
+    for block_name in ["C", "B"]:
+        block = sch.get_block(block_name)
+        outers, inners = [], []
+        for loop in sch.get_loops(block):
+            outer, inner = timed("split", sch.split, loop, factors=[None, factor])
+            outers.append(outer)
+            inners.append(inner)
+        timed("reorder", sch.reorder, *outers, *inners)
+        fused = timed("fuse", sch.fuse, *outers[:2])
+        if block_name == "C":
+            consumer_loop = fused
+    timed("compute_at", sch.compute_at, sch.get_block("B"), consumer_loop)
+    timed(
+        "transform_layout",
+        sch.transform_layout,
+        sch.get_block("C"),
+        ("write", 0),
+        lambda *idx: list(reversed(idx)),
+    )
+    return sch
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--ranks", type=int, nargs="+", default=[4, 6, 8])
+    parser.add_argument("--extent", type=int, default=8)
+    parser.add_argument("--factor", type=int, default=2)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+    for rank in args.ranks:
+        func = make_func(rank, args.extent)
+        times = defaultdict(list)
+        for _ in range(args.repeat):
+            schedule(func, args.factor, times)
+        print(f"rank {rank}:")
+        for name, samples in times.items():
+            print(f"  {name:<18}{sum(samples) / len(samples) * 1e3:10.3f} ms")
+
+
+if __name__ == "__main__":
+    main()
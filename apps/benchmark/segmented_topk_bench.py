@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the throughput of the segmented top-k against the full-sort top-k.
+
+The shapes follow MoE gating (many tokens, few experts, small k) and sampling (few rows,
+a vocabulary-sized row, larger k). On the CPU tvm.contrib.sort.topk is compared with
+tvm.contrib.sort.segmented_topk, on CUDA tvm.contrib.thrust.sort with
+tvm.contrib.thrust.segmented_topk.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+from tvm.contrib.thrust import can_use_thrust
+
+# (rows, row length, k)
+WORKLOADS = [
+    (4096, 8, 2),
+    (4096, 64, 8),
+    (16384, 128, 8),
+    (32, 32000, 50),
+    (32, 128000, 1000),
+]
+
+
+def build(target, rows, n, k, dtype, segmented):
+    data = te.placeholder((rows, n), name="data", dtype=dtype)
+    if target.kind.name == "cuda":
+        with target:
+            if segmented:
+                outs = topi.cuda.segmented_topk_thrust(data, k)
+            else:
+                outs = topi.cuda.topk_thrust(data, k)
+    elif segmented:
+        outs = topi.segmented_topk(data, k)
+    else:
+        outs = topi.topk(data, k)
+    s = te.create_schedule([out.op for out in outs])
+    return tvm.build(s, [data, *outs], target)
+
+
+def benchmark(target, rows, n, k, dtype, segmented, repeat):
+    """Return the mean time of one call in seconds."""
+    dev = tvm.device(target.kind.name, 0)
+    func = build(target, rows, n, k, dtype, segmented)
+    data = tvm.nd.array(np.random.uniform(size=(rows, n)).astype(dtype), dev)
+    values = tvm.nd.empty((rows, k), dtype, dev)
+    indices = tvm.nd.empty((rows, k), "int64", dev)
+    timer = func.time_evaluator(func.entry_name, dev, number=10, repeat=repeat)
+    return timer(data, values, indices).mean
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -num-cores=8")
+    parser.add_argument("--dtype", type=str, default="float32")
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    tgt = tvm.target.Target(args.target)
+    if tgt.kind.name == "cuda" and not can_use_thrust(tgt, "tvm.contrib.thrust.segmented_topk"):
+        raise RuntimeError("The CUDA benchmark needs a target with -libs=thrust")
+
+    print(
+        "%8s %8s %6s %12s %12s %14s %8s"
+        % ("rows", "n", "k", "topk (ms)", "seg (ms)", "seg (Mrow/s)", "speedup")
+    )
+    for num_rows, row_len, top_k in WORKLOADS:
+        base = benchmark(tgt, num_rows, row_len, top_k, args.dtype, False, args.repeat)
+        seg = benchmark(tgt, num_rows, row_len, top_k, args.dtype, True, args.repeat)
+        print(
+            "%8d %8d %6d %12.3f %12.3f %14.3f %8.2f"
+            % (num_rows, row_len, top_k, base * 1e3, seg * 1e3, num_rows / seg / 1e6, base / seg)
+        )
@@ -0,0 +1,82 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the structural hash cache on the workload deduplication of the task extraction.
+
+Builds a Relax model of repeated layers, whose kernels the task extraction hashes once per call
+to deduplicate the tasks, and times the extraction and a rehash of the whole module with and
+without the cache.
+"""
+import argparse
+import time
+
+import tvm
+from tvm import meta_schedule as ms
+from tvm import relax, topi
+
+
+def make_model(num_layers, hidden):
+    """A chain of dense, bias add and relu layers."""
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", relax.TensorStructInfo((1, hidden), "float32"))
+    weight = relax.Var("weight", relax.TensorStructInfo((hidden, hidden), "float32"))
+    bias = relax.Var("bias", relax.TensorStructInfo((hidden,), "float32"))
+    with bb.function("main", [x, weight, bias]):
+        with bb.dataflow():
+            out = x
+            for _ in range(num_layers):
+                out = bb.emit_te(topi.nn.dense, out, weight)
+                out = bb.emit_te(topi.add, out, bias)
+                out = bb.emit_te(topi.nn.relu, out)
+            out = bb.emit_output(out)
+        bb.emit_func_output(out)
+    return bb.get()
+
+
+def benchmark(mod, target, capacity, repeat):
+    """Return the best (extraction, rehash) time in seconds."""
+    tvm.ir.set_structural_hash_cache_capacity(capacity)
+    tvm.ir.clear_structural_hash_cache()
+    extract_time = rehash_time = float("inf")
+    for _ in range(repeat):
+        start = time.perf_counter()
+        ms.relax_integration.extract_tasks(mod, target)
+        extract_time = min(extract_time, time.perf_counter() - start)
+        start = time.perf_counter()
+        tvm.ir.structural_hash(mod)
+        rehash_time = min(rehash_time, time.perf_counter() - start)
+    stats = tvm.ir.structural_hash_cache_stats()
+    tvm.ir.set_structural_hash_cache_capacity(0)
+    return extract_time, rehash_time, stats
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -num-cores=4")
+    parser.add_argument("--num-layers", type=int, default=256)
+    parser.add_argument("--hidden", type=int, default=1024)
+    parser.add_argument("--capacity", type=int, default=65536)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    model = make_model(args.num_layers, args.hidden)
+    print("%10s %16s %12s %8s %8s" % ("cache", "extraction (s)", "rehash (s)", "hits", "misses"))
+    for cache_capacity in [0, args.capacity]:
+        result = benchmark(model, tvm.target.Target(args.target), cache_capacity, args.repeat)
+        print(
+            "%10d %16.4f %12.4f %8d %8d"
+            % (cache_capacity, result[0], result[1], result[2]["hits"], result[2]["misses"])
+        )
@@ -0,0 +1,176 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the memory footprint and the reuse rate of the OpenCL texture pool.
+
+The activations of ResNet-50 and MobileNetV2 are replayed as texture workspace
+allocations in the NCHW4c layout used by the Adreno schedules, for a few
+inferences, through device_api.opencl.alloc_nd/free_nd.  Each configuration runs
+on its own thread, as every thread has its own texture pool.
+
+The script calls the allocator directly, so it has to run on the device itself
+rather than through RPC.
+"""
+import argparse
+import ctypes
+import json
+import threading
+
+import tvm
+
+SCOPE = "global.texture"
+
+
+def resnet50_blocks():
+    """Yield (input channels, output channels, output size, stride) of the bottlenecks."""
+    in_channels = 64
+    for channels, num_blocks, size in [(64, 3, 56), (128, 4, 28), (256, 6, 14), (512, 3, 7)]:
+        for i in range(num_blocks):
+            yield in_channels, channels, size, 2 if i == 0 and channels != 64 else 1
+            in_channels = channels * 4
+
+
+def resnet50_trace():
+    """Return the allocations and frees of one inference, as ("alloc"|"free", id, C, H)."""
+    trace = [("alloc", 0, 64, 112), ("alloc", 1, 64, 56), ("free", 0)]
+    current, next_id = 1, 2
+    for in_channels, channels, size, _ in resnet50_blocks():
+        a, b, c, out = next_id, next_id + 1, next_id + 2, next_id + 3
+        next_id += 4
+        trace += [("alloc", a, channels, size), ("alloc", b, channels, size), ("free", a)]
+        trace += [("alloc", c, channels * 4, size), ("free", b)]
+        if in_channels != channels * 4:
+            shortcut = next_id
+            next_id += 1
+            trace += [("alloc", shortcut, channels * 4, size), ("free", current)]
+            current = shortcut
+        trace += [("alloc", out, channels * 4, size), ("free", c), ("free", current)]
+        current = out
+    trace += [("free", current)]
+    return trace
+
+
+def mobilenet_v2_trace():
+    """Return the allocations and frees of one inference, as ("alloc"|"free", id, C, H)."""
+    trace = [("alloc", 0, 32, 112)]
+    current, next_id, in_channels, size = 0, 1, 32, 112
+    for expand, channels, num_blocks, stride in [
+        (1, 16, 1, 1),
+        (6, 24, 2, 2),
+        (6, 32, 3, 2),
+        (6, 64, 4, 2),
+        (6, 96, 3, 1),
+        (6, 160, 3, 2),
+        (6, 320, 1, 1),
+    ]:
+        for i in range(num_blocks):
+            block_stride = stride if i == 0 else 1
+            out_size = size // block_stride
+            hidden = in_channels * expand
+            expanded, depthwise, out = next_id, next_id + 1, next_id + 2
+            next_id += 3
+            trace += [("alloc", expanded, hidden, size)]
+            trace += [("alloc", depthwise, hidden, out_size), ("free", expanded)]
+            trace += [("alloc", out, channels, out_size), ("free", depthwise)]
+            trace += [("free", current)]
+            current, in_channels, size = out, channels, out_size
+    trace += [("free", current)]
+    return trace
+
+
+WORKLOADS = {"resnet50": resnet50_trace, "mobilenet_v2": mobilenet_v2_trace}
+
+
+def replay(trace, num_runs, device_id, max_cached_mb, result):
+    """Replay a trace on the texture pool of the calling thread."""
+    alloc_nd = tvm.get_global_func("device_api.opencl.alloc_nd")
+    free_nd = tvm.get_global_func("device_api.opencl.free_nd")
+    pool_stats = tvm.get_global_func("device_api.opencl.texture_pool_stats")
+    pool_trim = tvm.get_global_func("device_api.opencl.texture_pool_trim")
+    if max_cached_mb >= 0:
+        set_max_cached = tvm.get_global_func("device_api.opencl.texture_pool_set_max_cached_bytes")
+        set_max_cached(max_cached_mb << 20)
+
+    device_type = tvm.opencl(device_id).device_type
+    live = {}
+    for _ in range(num_runs):
+        for event in trace:
+            if event[0] == "alloc":
+                _, tensor_id, channels, size = event
+                # [N, C/4, H, W, 4] is flattened to a texture of height N*C/4*H and width W.
+                shape = (ctypes.c_int64 * 2)(size, channels // 4 * size)
+                live[tensor_id] = alloc_nd(
+                    device_type, device_id, 2, 16, SCOPE, 2, ctypes.cast(shape, ctypes.c_void_p)
+                )
+            else:
+                free_nd(device_type, device_id, SCOPE, live.pop(event[1]))
+    result.update(json.loads(pool_stats(device_id)))
+    pool_trim(device_id, 0)
+
+
+def requested_peak_bytes(trace):
+    """Return the peak size of the live tensors of a trace."""
+    sizes, live, peak = {}, 0, 0
+    for event in trace:
+        if event[0] == "alloc":
+            _, tensor_id, channels, size = event
+            sizes[tensor_id] = channels * size * size * 2
+            live += sizes[tensor_id]
+            peak = max(peak, live)
+        else:
+            live -= sizes.pop(event[1])
+    return peak
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device-id", type=int, default=0)
+    parser.add_argument("--runs", type=int, default=10)
+    parser.add_argument(
+        "--max-cached-mb",
+        type=int,
+        nargs="*",
+        default=[-1, 16],
+        help="limits of the free textures kept by the pool, in MiB, -1 for no limit",
+    )
+    args = parser.parse_args()
+
+    if not tvm.opencl(args.device_id).exist:
+        raise RuntimeError("No OpenCL device found")
+
+    columns = ("workload", "cached MiB", "needed MiB", "peak MiB", "device allocs", "reuse %")
+    print("%-14s %-10s %12s %12s %14s %10s %10s" % (*columns, "evicted"))
+    for name, make_trace in WORKLOADS.items():
+        trace = make_trace()
+        for max_cached_mb in args.max_cached_mb:
+            stats = {}
+            thread = threading.Thread(
+                target=replay, args=(trace, args.runs, args.device_id, max_cached_mb, stats)
+            )
+            thread.start()
+            thread.join()
+            print(
+                "%-14s %-10s %12.1f %12.1f %14d %10.1f %10d"
+                % (
+                    name,
+                    "unlimited" if max_cached_mb < 0 else max_cached_mb,
+                    requested_peak_bytes(trace) / 2**20,
+                    stats["peak_bytes"] / 2**20,
+                    stats["num_allocs"] - stats["num_reuses"],
+                    100.0 * stats["num_reuses"] / max(stats["num_allocs"], 1),
+                    stats["num_evictions"],
+                )
+            )
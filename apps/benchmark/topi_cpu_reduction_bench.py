@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the bandwidth of the x86 schedules of the last-axis reductions and softmax.
+
+The shapes follow the normalizations, softmax and sampling of LLMs: a few rows of a hidden or
+vocabulary size, and many rows of attention scores. The x86 schedules are compared with the
+generic schedules, and the bandwidth is the size of the input over the time of one call.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+
+# (name, input shape)
+WORKLOADS = [
+    ("sum", (1, 4096)),
+    ("sum", (128, 4096)),
+    ("max", (1, 128000)),
+    ("argmax", (1, 32000)),
+    ("softmax", (1, 32000)),
+    ("softmax", (32 * 128, 1024)),
+]
+
+
+def build(target, name, shape, dtype, use_x86):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    with target:
+        if name == "softmax":
+            out = topi.nn.softmax(data, axis=-1)
+            schedule = topi.x86.schedule_softmax if use_x86 else topi.generic.schedule_softmax
+        else:
+            out = getattr(topi, name)(data, axis=-1)
+            schedule = topi.x86.schedule_reduce if use_x86 else topi.generic.schedule_reduce
+        s = schedule([out])
+    return tvm.build(s, [data, out], target), out
+
+
+def benchmark(target, name, shape, dtype, use_x86, repeat):
+    """Return the mean time of one call in seconds."""
+    dev = tvm.cpu()
+    func, out = build(target, name, shape, dtype, use_x86)
+    data = tvm.nd.array(np.random.uniform(size=shape).astype(dtype), dev)
+    result = tvm.nd.empty([int(d) for d in out.shape], out.dtype, dev)
+    timer = func.time_evaluator(func.entry_name, dev, number=10, repeat=repeat)
+    return timer(data, result).mean
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -mcpu=native")
+    parser.add_argument("--dtype", type=str, default="float32")
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    tgt = tvm.target.Target(args.target)
+    print(
+        "%8s %14s %14s %12s %14s %8s"
+        % ("op", "shape", "generic (ms)", "x86 (ms)", "x86 (GB/s)", "speedup")
+    )
+    for op_name, in_shape in WORKLOADS:
+        base = benchmark(tgt, op_name, in_shape, args.dtype, False, args.repeat)
+        x86 = benchmark(tgt, op_name, in_shape, args.dtype, True, args.repeat)
+        num_bytes = np.prod(in_shape) * np.dtype(args.dtype).itemsize
+        shape_str = "x".join(map(str, in_shape))
+        print(
+            "%8s %14s %14.4f %12.4f %14.2f %8.2f"
+            % (op_name, shape_str, base * 1e3, x86 * 1e3, num_bytes / x86 / 1e9, base / x86)
+        )
@@ -0,0 +1,50 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measure the alloc/free pairs per second of the CPU workspace pool.
+
+Each thread allocates two nested workspaces through TVMBackendAllocWorkspace in turn and frees
+them in reverse order, like the parallel workers of a kernel with temporaries. The sizes of the
+workspaces cycle through a list, so the pool sees both repeated and changing sizes.
+"""
+import argparse
+
+import tvm
+
+SIZES = {
+    "same 8K": [8 << 10],
+    "mixed 4K-64K": [4 << 10, 12 << 10, 64 << 10, 20 << 10, 40 << 10],
+    "mixed 4K-1M": [4 << 10, 1 << 20, 16 << 10, 300 << 10],
+}
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-threads", type=int, nargs="*", default=[1, 2, 4, 8, 16])
+    parser.add_argument("--num-pairs", type=int, default=1000000)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    f_throughput = tvm.get_global_func("testing.workspace_alloc_throughput")
+    print("%-14s" % "sizes" + "".join("%12s" % f"{n} threads" for n in args.num_threads))
+    for name, sizes in SIZES.items():
+        row = "%-14s" % name
+        for num_threads in args.num_threads:
+            best = max(
+                f_throughput(num_threads, args.num_pairs, sizes) for _ in range(args.repeat)
+            )
+            row += "%12s" % f"{best / 1e6:.2f}M/s"
+        print(row)
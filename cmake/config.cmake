@@ -59,9 +59,10 @@ set(USE_NCCL OFF)
 # - OFF: disable MSCCL
 set(USE_MSCCL OFF)
 
-# Whether to enable NVTX support (must have USE_CUDA enabled):
-# - ON: enable NCCL with cmake's auto search
-# - OFF: disable NCCL
+# Whether to enable NVTX support (must have USE_CUDA enabled), or ROCTX support on ROCm.
+# The ranges are recorded once turned on at runtime, see TVM_NVTX_RANGES:
+# - ON: enable NVTX with cmake's auto search
+# - OFF: disable NVTX
 set(USE_NVTX OFF)
 
 # Whether enable ROCM runtime
@@ -356,6 +357,10 @@ set(USE_PT_TVMDSOOP OFF)
 # Whether to use STL's std::unordered_map or TVM's POD compatible Map
 set(USE_FALLBACK_STL_MAP OFF)
 
+# Whether to allocate the small objects, e.g. the IR nodes, from thread-local pools which reuse
+# the freed memory, to speed up the compilation
+set(USE_OBJECT_POOL_ALLOCATOR OFF)
+
 # Whether to enable Hexagon support
 set(USE_HEXAGON OFF)
 set(USE_HEXAGON_SDK /path/to/sdk)
@@ -428,6 +433,11 @@ set(BACKTRACE_ON_SEGFAULT OFF)
 # - /path/to/folder/containing/: Path to folder containing papi.pc.
 set(USE_PAPI OFF)
 
+# Whether to enable CUPTI support in profiling. CUPTI reads the performance
+# counters of CUDA kernels, e.g. their achieved occupancy and DRAM throughput.
+# Needs USE_CUDA.
+set(USE_CUPTI OFF)
+
 # Whether to use GoogleTest for C++ unit tests. When enabled, the generated
 # build file (e.g. Makefile) will have a target "cpptest".
 # Possible values:
@@ -111,6 +111,17 @@ if(USE_CUDA)
     list(APPEND RUNTIME_SRCS ${CONTRIB_CURAND_SRC_CU})
   endif(USE_CURAND)
 
+  if(USE_CUPTI)
+    if(NOT CUDA_CUPTI_LIBRARY OR NOT CUDA_CUPTI_INCLUDE_DIRS)
+      message(FATAL_ERROR "Cannot find CUPTI, USE_CUPTI=" ${USE_CUPTI})
+    endif()
+    message(STATUS "Build with CUPTI support")
+    include_directories(SYSTEM ${CUDA_CUPTI_INCLUDE_DIRS})
+    tvm_file_glob(GLOB CONTRIB_CUPTI_SRCS src/runtime/contrib/cupti/*.cc)
+    list(APPEND RUNTIME_SRCS ${CONTRIB_CUPTI_SRCS})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUPTI_LIBRARY})
+  endif(USE_CUPTI)
+
   if(USE_NVTX)
     message(STATUS "Build with NVTX support")
     message(STATUS "${CUDA_NVTX_LIBRARY}")
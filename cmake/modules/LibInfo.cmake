@@ -74,6 +74,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_NCCL="${USE_NCCL}"
     TVM_INFO_USE_MSCCL="${USE_MSCCL}"
     TVM_INFO_USE_CUDNN="${USE_CUDNN}"
+    TVM_INFO_USE_CUPTI="${USE_CUPTI}"
     TVM_INFO_USE_CUSTOM_LOGGING="${USE_CUSTOM_LOGGING}"
     TVM_INFO_USE_CUTLASS="${USE_CUTLASS}"
     TVM_INFO_USE_FLASHINFER="${USE_FLASHINFER}"
@@ -104,6 +105,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_MRVL="${USE_MRVL}"
     TVM_INFO_USE_MSVC_MT="${USE_MSVC_MT}"
     TVM_INFO_USE_NNPACK="${USE_NNPACK}"
+    TVM_INFO_USE_OBJECT_POOL_ALLOCATOR="${USE_OBJECT_POOL_ALLOCATOR}"
     TVM_INFO_USE_OPENCL="${USE_OPENCL}"
     TVM_INFO_USE_OPENCL_ENABLE_HOST_PTR="${USE_OPENCL_ENABLE_HOST_PTR}"
     TVM_INFO_USE_OPENCL_GTEST="${USE_OPENCL_GTEST}"
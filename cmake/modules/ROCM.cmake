@@ -33,11 +33,22 @@ if(USE_ROCM)
   message(STATUS "Build with ROCM support")
   tvm_file_glob(GLOB RUNTIME_ROCM_SRCS src/runtime/rocm/*.cc)
   list(APPEND RUNTIME_SRCS ${RUNTIME_ROCM_SRCS})
+  # Add ROCm builtins to RelaxVM
+  tvm_file_glob(GLOB RELAX_VM_ROCM_BUILTIN_SRC_CC src/runtime/relax_vm/rocm/*.cc)
+  list(APPEND RUNTIME_SRCS ${RELAX_VM_ROCM_BUILTIN_SRC_CC})
   list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_HIPHCC_LIBRARY})
   if (ROCM_HSA_LIBRARY)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_HSA_LIBRARY})
   endif()
 
+  if(USE_NVTX)
+    if(NOT ROCM_ROCTX_LIBRARY)
+      message(FATAL_ERROR "Cannot find roctx64 for USE_NVTX on ROCm")
+    endif()
+    message(STATUS "Build with ROCTX support")
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_ROCTX_LIBRARY})
+  endif(USE_NVTX)
+
   if(USE_MIOPEN)
     message(STATUS "Build with MIOpen support")
     tvm_file_glob(GLOB MIOPEN_CONTRIB_SRCS src/runtime/contrib/miopen/*.cc)
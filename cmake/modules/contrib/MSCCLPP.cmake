@@ -41,6 +41,11 @@ if(USE_CUDA AND USE_NCCL AND USE_MSCCL)
     $<INSTALL_INTERFACE:include/msccl>
   )
 
+  # The "mscclpp" CCL of disco, which runs on top of the NCCL one.
+  tvm_file_glob(GLOB RUNTIME_MSCCLPP_SRCS src/runtime/disco/mscclpp/*.cc)
+  include_directories(${mscclpp_SOURCE_DIR}/include ${PROJECT_SOURCE_DIR}/3rdparty/mscclpp/include)
+  list(APPEND RUNTIME_SRCS ${RUNTIME_MSCCLPP_SRCS})
+
   install(TARGETS mscclpp_obj
     EXPORT ${PROJECT_NAME}Targets
     FILE_SET HEADERS DESTINATION ${INSTALL_PREFIX}/include)
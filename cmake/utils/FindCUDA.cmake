@@ -36,6 +36,8 @@
 # - CUDA_NVRTC_LIBRARY
 # - CUDA_CUDNN_INCLUDE_DIRS
 # - CUDA_CUDNN_LIBRARY
+# - CUDA_CUPTI_INCLUDE_DIRS
+# - CUDA_CUPTI_LIBRARY
 # - CUDA_CUBLAS_LIBRARY
 #
 macro(find_cuda use_cuda use_cudnn)
@@ -109,6 +111,14 @@ macro(find_cuda use_cuda use_cudnn)
       )
       # search default path if cannot find cublaslt in non-default
       find_library(CUDA_CUBLASLT_LIBRARY NAMES cublaslt cublasLt)
+      find_library(CUDA_CUPTI_LIBRARY cupti
+        PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+        PATH_SUFFIXES extras/CUPTI/lib64 extras/CUPTI/lib lib lib64 targets/x86_64-linux/lib
+        NO_DEFAULT_PATH)
+      find_path(CUDA_CUPTI_INCLUDE_DIRS cupti.h
+        PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+        PATH_SUFFIXES extras/CUPTI/include include
+        NO_DEFAULT_PATH)
     endif(MSVC)
 
     # find cuDNN
@@ -147,6 +157,7 @@ macro(find_cuda use_cuda use_cudnn)
     message(STATUS "Found CUDA_CURAND_LIBRARY=" ${CUDA_CURAND_LIBRARY})
     message(STATUS "Found CUDA_CUBLASLT_LIBRARY=" ${CUDA_CUBLASLT_LIBRARY})
     message(STATUS "Found CUDA_NVTX_LIBRARY=" ${CUDA_NVTX_LIBRARY})
+    message(STATUS "Found CUDA_CUPTI_LIBRARY=" ${CUDA_CUPTI_LIBRARY})
     message(STATUS "Found CUDA_nvToolsExt_LIBRARY=" ${CUDA_nvToolsExt_LIBRARY})
   endif(CUDA_FOUND)
 endmacro(find_cuda)
@@ -49,6 +49,7 @@ namespace arith {
 
 // Forward declare Analyzer
 class Analyzer;
+class SimplifyCache;
 
 using tir::Var;
 
@@ -633,6 +634,8 @@ class TVM_DLL Analyzer {
    */
   Analyzer(const Analyzer&) = delete;
   Analyzer& operator=(const Analyzer&) = delete;
+  /*! \brief destructor */
+  ~Analyzer();
   /*! \brief sub-analyzer: const integer bound */
   ConstIntBoundAnalyzer const_int_bound;
   /*! \brief sub-analyzer: modular set */
@@ -645,7 +648,12 @@ class TVM_DLL Analyzer {
   IntSetAnalyzer int_set;
   /*! \brief sub-analyzer transitive comparisons */
   TransitiveComparisonAnalyzer transitive_comparisons;
-  /*! \brief constructor */
+  /*!
+   * \brief constructor
+   *
+   * The memoization of Simplify is enabled if the pass config
+   * "arith.enable_simplify_cache" of the current PassContext is set.
+   */
   Analyzer();
   /*!
    * \brief Mark the value as non-negative value globally in analyzer.
@@ -779,6 +787,32 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+
+  /*!
+   * \brief Enable or disable the memoization of Simplify.
+   *
+   * The results are keyed by the structural hash of the expression, the steps and
+   * the constraint context they are computed in, so that the structurally equal
+   * expressions are simplified once within the same context.
+   *
+   * \note The cache is cleared by Bind and MarkGlobalNonNegValue. Callers that
+   * update a sub-analyzer directly after simplifying should call ClearSimplifyCache.
+   */
+  void EnableSimplifyCache(bool enable = true);
+  /*! \brief Clear the memoized results of Simplify. */
+  void ClearSimplifyCache();
+  /*!
+   * \brief The hit and miss counters of the memoization of Simplify.
+   * \return The map with keys "hits" and "misses".
+   */
+  Map<String, Integer> GetSimplifyCacheStats() const;
+
+ private:
+  friend class ConstraintContext;
+  /*! \brief Simplify with no memoization. */
+  PrimExpr SimplifyUncached(const PrimExpr& expr, int steps);
+  /*! \brief The memoized results of Simplify, nullptr if disabled. */
+  std::unique_ptr<SimplifyCache> simplify_cache_;
 };
 
 }  // namespace arith
@@ -151,6 +151,44 @@ class PassInstrument : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(PassInstrument, ObjectRef, PassInstrumentNode);
 };
 
+/*!
+ * \brief Scope of a function-level pass running over one function, which the active pass
+ *  profiling instruments record as a slice nested in the one of the pass.
+ *
+ * \code
+ *
+ *  for (...) {
+ *    instrument::FunctionPassProfileScope scope(pass_info, gvar->name_hint);
+ *    func = pass_func(func, mod, pass_ctx);
+ *  }
+ *
+ * \endcode
+ */
+class FunctionPassProfileScope {
+ public:
+  /*!
+   * \brief Enter the scope, which costs nothing when no profiling instrument is active.
+   * \param info The information of the function-level pass.
+   * \param function_name The name of the function.
+   */
+  TVM_DLL FunctionPassProfileScope(const transform::PassInfo& info, const String& function_name);
+  TVM_DLL ~FunctionPassProfileScope();
+  FunctionPassProfileScope(const FunctionPassProfileScope&) = delete;
+  FunctionPassProfileScope& operator=(const FunctionPassProfileScope&) = delete;
+
+ private:
+  /*! \brief The active profiling instruments, empty if none */
+  std::vector<PassInstrument> profilers_;
+  /*! \brief The name of the pass */
+  String pass_name_;
+  /*! \brief The name of the function */
+  String function_name_;
+  /*! \brief The time of entering the scope, in microseconds since the epoch of steady_clock */
+  int64_t begin_us_{0};
+  /*! \brief The number of objects allocated by the thread when entering the scope */
+  int64_t begin_allocations_{0};
+};
+
 }  // namespace instrument
 }  // namespace tvm
 
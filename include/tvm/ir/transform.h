@@ -63,6 +63,7 @@
 #include <tvm/runtime/container/string.h>
 #include <tvm/support/with.h>
 
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -292,6 +293,23 @@ class PassContext : public ObjectRef {
   friend class With<PassContext>;
 };
 
+/*!
+ * \brief Scope that makes a pass context current on a worker thread, which runs part of a pass
+ * on behalf of the thread that entered the context. Unlike `With<PassContext>`, it does not call
+ * the instrument callbacks, which the entering thread has already called.
+ */
+class PassContextWorkerScope {
+ public:
+  TVM_DLL explicit PassContextWorkerScope(PassContext pass_ctx);
+  TVM_DLL ~PassContextWorkerScope();
+  PassContextWorkerScope(const PassContextWorkerScope&) = delete;
+  PassContextWorkerScope& operator=(const PassContextWorkerScope&) = delete;
+
+ private:
+  /*! \brief The pass context made current */
+  PassContext pass_ctx_;
+};
+
 #define TVM_PASS_CTX_CONFIG_VAR_DEF static TVM_ATTRIBUTE_UNUSED uint32_t __make_PassContext_tid
 
 /*!
@@ -550,6 +568,33 @@ TVM_DLL Pass CreateModulePass(
 TVM_DLL Pass ApplyPassToFunction(Pass pass, String func_name_regex,
                                  bool error_if_no_function_matches_regex = false);
 
+/*!
+ * \brief Get the number of threads to run a function-level pass over the functions of a module.
+ *
+ * It is given by the config "ir.function_pass_num_threads", where 0 stands for all the cores,
+ * and is 1 for the passes listed in "ir.function_pass_sequential", e.g. the ones that touch
+ * global state, and for the passes that run within a function-level pass already in parallel.
+ *
+ * \param pass_ctx The pass context.
+ * \param pass_info The information of the function-level pass.
+ * \param num_functions The number of functions to run the pass over.
+ * \return The number of threads, 1 for running sequentially.
+ */
+TVM_DLL int GetFunctionPassNumThreads(const PassContext& pass_ctx, const PassInfo& pass_info,
+                                      int num_functions);
+
+/*!
+ * \brief Run a function-level pass over the functions of a module on multiple threads, where
+ * `pass_ctx` is current. The exception raised for the first function, if any, is rethrown.
+ *
+ * \param pass_ctx The pass context.
+ * \param num_threads The number of threads, see GetFunctionPassNumThreads.
+ * \param num_functions The number of functions.
+ * \param f The function that runs the pass over the i-th function.
+ */
+TVM_DLL void ParallelForFunctions(const PassContext& pass_ctx, int num_threads, int num_functions,
+                                  const std::function<void(int)>& f);
+
 /*!
  * \brief A special trace pass that prints the header and IR to LOG(INFO).
  * \param header The header to be attached to the output.
@@ -21,6 +21,7 @@
 #define TVM_META_SCHEDULE_COST_MODEL_H_
 
 #include <tvm/meta_schedule/arg_info.h>
+#include <tvm/meta_schedule/feature_extractor.h>
 #include <tvm/meta_schedule/measure_candidate.h>
 #include <tvm/meta_schedule/runner.h>
 #include <tvm/node/reflection.h>
@@ -165,6 +166,25 @@ class CostModel : public runtime::ObjectRef {
                                        PyCostModelNode::FUpdate f_update,    //
                                        PyCostModelNode::FPredict f_predict,  //
                                        PyCostModelNode::FAsString f_as_string);
+  /*!
+   * \brief Create a cost model of gradient boosted regression trees, trained in C++ on the
+   * per-store features as XGBModel.
+   * \param extractor The feature extractor.
+   * \param num_warmup_samples The number of samples before which the predictions are random.
+   * \param max_depth The maximum depth of a tree.
+   * \param num_rounds The maximum number of trees.
+   * \param eta The learning rate.
+   * \param gamma The minimum loss reduction of a split.
+   * \param min_child_weight The minimum sum of the hessian of a child.
+   * \param early_stopping_rounds The number of rounds with no improvement of the training error
+   * after which the training stops.
+   * \param seed The random seed of the warmup predictions.
+   * \return The cost model created.
+   */
+  TVM_DLL static CostModel TreeEnsemble(FeatureExtractor extractor, int num_warmup_samples,
+                                        int max_depth, int num_rounds, double eta, double gamma,
+                                        double min_child_weight, int early_stopping_rounds,
+                                        support::LinearCongruentialEngine::TRandState seed);
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CostModel, ObjectRef, CostModelNode);
 };
 
@@ -228,6 +228,16 @@ class DatabaseNode : public runtime::Object {
    * \return An Array of all the tuning records in the database.
    */
   virtual Array<TuningRecord> GetAllTuningRecords() = 0;
+  /*!
+   * \brief Get the best valid tuning records of the workloads similar to, but not the same as,
+   * the given one. Two workloads are similar if their anchor blocks have the same name, iteration
+   * types and buffer types, and the nearest ones are those with their loop extents closest in
+   * log scale. The records are sorted by the distance of their workloads, then by run time.
+   * \param mod The IRModule to be searched for.
+   * \param top_k The number of records to be returned.
+   * \return An array of at most K tuning records of similar workloads.
+   */
+  virtual Array<TuningRecord> GetTopKSimilar(const IRModule& mod, int top_k);
   /*!
    * \brief Get the size of the database.
    * \return The size of the database.
@@ -483,6 +493,16 @@ class Database : public runtime::ObjectRef {
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
                                        bool allow_missing, String mod_eq_name = "structural");
+  /*!
+   * \brief Create a database of two binary tables, which only reads an index of the tuning
+   * records of each workload when opened, and parses the records when they are returned.
+   * \param path_workload The path to the workload table.
+   * \param path_tuning_record The path to the database table.
+   * \param allow_missing Whether to create new file when the given path is not found.
+   * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   */
+  TVM_DLL static Database BinaryDatabase(String path_workload, String path_tuning_record,
+                                         bool allow_missing, String mod_eq_name = "structural");
   /*!
    * \brief A database composed of multiple databases, allowing users to guide IR rewriting using
    * combined knowledge of those databases. To each query, it returns the best record among all the
@@ -28,6 +28,8 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/target/target.h>
 
+#include <chrono>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -51,6 +53,20 @@ class ScopedTimer {
   runtime::TypedPackedFunc<void()> deferred_;
 };
 
+/*! \brief A timestamped span of the tuning pipeline */
+struct ProfilerSpan {
+  /*! \brief The track of the span, "search", "builder" or "runner" */
+  std::string track;
+  /*! \brief The name of the span */
+  std::string name;
+  /*! \brief The task the span works on, or -1 if none */
+  int task_id;
+  /*! \brief The start of the span, in microseconds since the profiler entered its scope */
+  double start_us;
+  /*! \brief The end of the span, in microseconds since the profiler entered its scope */
+  double end_us;
+};
+
 /*! \brief A generic profiler */
 class ProfilerNode : public runtime::Object {
  public:
@@ -58,6 +74,16 @@ class ProfilerNode : public runtime::Object {
   std::unordered_map<std::string, double> stats_sec;
   /*! \brief Counter for the total time used */
   runtime::PackedFunc total_timer;
+  /*! \brief The spans recorded in the scope of the profiler */
+  std::vector<ProfilerSpan> spans;
+  /*! \brief The task the tuning thread works on, or -1 if none */
+  int current_task_id = -1;
+  /*! \brief The start of the spans of the runner still running, by task */
+  std::unordered_map<int, double> runner_start_us;
+  /*! \brief The time the profiler entered its scope */
+  std::chrono::steady_clock::time_point start_time;
+  /*! \brief The mutex guarding `spans` */
+  std::mutex mutex;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     // `stats_sec` is not visited.
@@ -72,6 +98,21 @@ class ProfilerNode : public runtime::Object {
   Map<String, FloatImm> Get() const;
   /*! \brief Return a summary of profiling results as table format */
   String Table() const;
+  /*! \brief The time since the profiler entered its scope, in microseconds */
+  double ElapsedUs() const;
+  /*! \brief Record a span on a track */
+  void RecordSpan(std::string track, std::string name, int task_id, double start_us,
+                  double end_us);
+  /*!
+   * \brief Export the spans as a trace of the Chrome trace event format, which can be loaded by
+   * chrome://tracing or Perfetto. The overlapping spans of a track are laid out on several lanes.
+   */
+  String ChromeTrace();
+  /*!
+   * \brief Return the busy fraction of the search thread, the builder and the runner over the
+   * total time, and the time of the spans of each task, as table format.
+   */
+  String Utilization();
 };
 
 /*!
@@ -95,6 +136,29 @@ class Profiler : public runtime::ObjectRef {
    * \return A scope timer for time profiling.
    */
   static ScopedTimer TimedScope(String name);
+  /*!
+   * \brief Profile the time of the given scope as a span on a track, without adding it to the
+   * stats of the scopes.
+   * \param track The track of the span.
+   * \param name Name for the span.
+   * \return A scope timer for time profiling.
+   */
+  static ScopedTimer TimedSpan(String track, String name);
+  /*!
+   * \brief Attribute the spans of the tuning thread to a task from now on.
+   * \param task_id The id of the task, or -1 for none.
+   */
+  static void SetCurrentTask(int task_id);
+  /*!
+   * \brief Start the span of the runner for the current task, which ends with `EndRunnerSpan`.
+   * The runner measures the candidates asynchronously.
+   */
+  static void BeginRunnerSpan();
+  /*!
+   * \brief End the span of the runner for a task, as observed by the task scheduler.
+   * \param task_id The id of the task.
+   */
+  static void EndRunnerSpan(int task_id);
 };
 
 }  // namespace meta_schedule
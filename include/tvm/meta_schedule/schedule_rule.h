@@ -258,12 +258,24 @@ class ScheduleRule : public runtime::ObjectRef {
    * \param unroll_max_steps The options of the maximum number of unroll steps to be done.
    * Use an empty array to disable unroll.
    * \param unroll_explicit Whether to explicitly unroll the loop, or just add an "unroll" pragma.
+   * \param vectorize_reduction Whether to also vectorize the innermost loop of a reduction block
+   * when it is a reduction loop, which VectorizeLoop lowers to vector accumulators.
    * \return The schedule rule created
    */
   TVM_DLL static ScheduleRule ParallelizeVectorizeUnroll(int max_jobs_per_core,            //
                                                          int max_vectorize_extent,         //
                                                          Array<Integer> unroll_max_steps,  //
-                                                         bool unroll_explicit);
+                                                         bool unroll_explicit,             //
+                                                         bool vectorize_reduction = false);
+  /*!
+   * \brief Prefetch the data of later iterations of the innermost serial reduction loop of a block
+   * into the cache, with a sampled prefetch distance. It is meant for CPU targets, after the
+   * loops of the block are tiled.
+   * \param prefetch_distances The candidates of the prefetch distance, in iterations, where 0
+   * disables prefetch.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule SoftwarePrefetch(Array<Integer> prefetch_distances);
   /*!
    * \brief Auto bind loops around the block to BlockIdx and ThreadIdx
    * \param max_threadblocks The maximum number of threadblock on GPU
@@ -290,7 +302,7 @@ class ScheduleRule : public runtime::ObjectRef {
 
   /*! \brief Create default schedule rules for LLVM */
   TVM_DLL static Array<ScheduleRule, void> DefaultLLVM();
-  /*! \brief Create default schedule rules for x86 (AVX512 and VNNI) */
+  /*! \brief Create default schedule rules for x86 (AVX512, VNNI and AMX) */
   TVM_DLL static Array<ScheduleRule, void> DefaultX86(const String& type);
   /*! \brief Create default schedule rules for CUDA */
   TVM_DLL static Array<ScheduleRule, void> DefaultCUDA();
@@ -300,7 +312,7 @@ class ScheduleRule : public runtime::ObjectRef {
   TVM_DLL static Array<ScheduleRule, void> DefaultHexagon();
   /*! \brief Create default schedule rules for Micro */
   TVM_DLL static Array<ScheduleRule, void> DefaultMicro();
-  /*! \brief Create default schedule rules for ARM CPU (NEON and DOTPROD) */
+  /*! \brief Create default schedule rules for ARM CPU (NEON, DOTPROD and I8MM) */
   TVM_DLL static Array<ScheduleRule, void> DefaultARM(const String& type);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(ScheduleRule, ObjectRef, ScheduleRuleNode);
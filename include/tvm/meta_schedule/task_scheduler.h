@@ -31,12 +31,15 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/support/random_engine.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace tvm {
 namespace meta_schedule {
 
+class MeasureCache;
+
 class TaskRecordNode : public runtime::Object {
  public:
   /*! \brief The tune context of the task. */
@@ -139,6 +142,8 @@ class TaskSchedulerNode : public runtime::Object {
   Optional<CostModel> cost_model_;
   /*! \brief The number of remaining tasks to be tuned. */
   int remaining_tasks_;
+  /*! \brief The results of the measured candidates, keyed by the scheduled module and target. */
+  std::shared_ptr<MeasureCache> measure_cache_;
 
   /*! \brief The default destructor. */
   virtual ~TaskSchedulerNode() = default;
@@ -150,6 +155,7 @@ class TaskSchedulerNode : public runtime::Object {
     v->Visit("database_", &database_);
     v->Visit("cost_model_", &cost_model_);
     v->Visit("remaining_tasks_", &remaining_tasks_);
+    // `measure_cache_` is not visited
   }
 
   /*!
@@ -272,10 +278,13 @@ class TaskScheduler : public runtime::ObjectRef {
    * \param logger The tuning task's logging function.
    * \param alpha The parameter alpha to control gradient computation.
    * \param window_size The parameter to control backward window size.
+   * \param patience The number of rounds with no improvement after which a task is terminated
+   * early, or 0 to tune each task up to its trial budget.
    * \param seed The random seed.
    * \return The task scheduler created.
    */
   TVM_DLL static TaskScheduler GradientBased(PackedFunc logger, double alpha, int window_size,
+                                             int patience,
                                              support::LinearCongruentialEngine::TRandState seed);
   /*!
    * \brief Create a task scheduler with customized methods on the python-side.
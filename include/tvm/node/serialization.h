@@ -24,6 +24,7 @@
 #ifndef TVM_NODE_SERIALIZATION_H_
 #define TVM_NODE_SERIALIZATION_H_
 
+#include <dmlc/io.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/object.h>
 
@@ -47,5 +48,24 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief Save the node as well as all the node it depends on in a compact binary format.
+ *
+ *  The binary holds a string table, the fields of the nodes as varints and the raw payload of
+ *  the NDArrays, and is faster to save and load than the json. Unlike the json, it can only be
+ *  loaded by a TVM whose objects have the same fields as the one that saved it.
+ *
+ * \param strm The stream to write to.
+ * \param node The node to save.
+ */
+TVM_DLL void SaveBinary(dmlc::Stream* strm, const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load the node saved by SaveBinary.
+ * \param strm The stream to read from.
+ * \return The node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(dmlc::Stream* strm);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
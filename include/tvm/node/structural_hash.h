@@ -244,6 +244,30 @@ class SHashHandlerDefault : public SHashReducer::Handler {
   Impl* impl;
 };
 
+/*!
+ * \brief The process-wide cache of the structural hashes of large subtrees.
+ *
+ *  When the cache has a non-zero capacity, SHashHandlerDefault records the hash of each subtree
+ *  of at least a few hundred nodes that contains no graph node, together with the outer
+ *  variables it refers to, so that a later hash of a tree that shares the subtree, e.g. the
+ *  same module or a function of it, reuses the hash instead of visiting the subtree again.
+ *  The hash values are the same with and without the cache.
+ *
+ * \note A cached subtree is kept alive by the cache, which makes its nodes shared, so that a
+ *  CopyOnWrite copies them instead of mutating them in place. The IRModule, which is mutated
+ *  in place, is never cached, so that rehashing a module costs a lookup per function.
+ */
+class StructuralHashCache {
+ public:
+  /*!
+   * \brief Set the maximum number of cached subtrees.
+   * \param capacity The capacity, where 0, the default, disables and clears the cache.
+   */
+  TVM_DLL static void SetCapacity(size_t capacity);
+  /*! \brief Remove all the cached subtrees. */
+  TVM_DLL static void Clear();
+};
+
 class SEqualReducer;
 struct NDArrayContainerTrait {
   static constexpr const std::nullptr_t VisitAttrs = nullptr;
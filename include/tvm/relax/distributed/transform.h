@@ -26,6 +26,7 @@
 
 #include <tvm/ir/transform.h>
 #include <tvm/relax/dataflow_pattern.h>
+#include <tvm/relax/distributed/global_info.h>
 #include <tvm/relax/expr.h>
 #include <tvm/relax/transform.h>
 #include <tvm/tir/function.h>
@@ -41,6 +42,18 @@ using PassInfo = tvm::transform::PassInfo;
 using PassContext = tvm::transform::PassContext;
 using Function = tvm::relax::Function;
 using DataflowBlock = tvm::relax::DataflowBlock;
+/*!
+ * \brief Choose the sharding of the parameters of each function over a device mesh with a
+ * communication and compute cost model, and annotate the parameters with it for
+ * PropagateSharding.
+ *
+ * \param device_mesh The device mesh to shard the parameters over.
+ * \param device_flops The compute throughput of each device, in FLOP/s.
+ * \param link_bandwidth The bandwidth of the links between the devices, in bytes/s.
+ * \return The Pass.
+ */
+TVM_DLL Pass AutoShard(DeviceMesh device_mesh, double device_flops, double link_bandwidth);
+
 /*!
  * \brief Propagate sharding information.
  *
@@ -68,6 +81,16 @@ TVM_DLL Pass LegalizeRedistribute();
  * \return The Pass.
  */
 TVM_DLL Pass LowerDistIR();
+
+/*!
+ * \brief Fuse the small independent allreduce and allgather ops of each dataflow block into
+ * collectives of a flat buffer of their inputs, and schedule each fused collective as soon as its
+ * inputs are ready.
+ *
+ * \param max_bucket_bytes The maximum size of the flat buffer of a fused collective.
+ * \return The Pass.
+ */
+TVM_DLL Pass BucketCollectives(int64_t max_bucket_bytes);
 }  // namespace transform
 }  // namespace distributed
 }  // namespace relax
@@ -117,6 +117,21 @@ TVM_DLL Pass CallTIRRewrite();
  */
 TVM_DLL Pass RewriteDataflowReshape();
 
+/*!
+ * \brief Rewrite the strided_slice, split and permute_dims calls within dataflow blocks, whose
+ * results are contiguous in the memory of their input, to relax.memory.view, so that they are
+ * lowered to a CreateView at runtime instead of a copy kernel.
+ *
+ * A slice is contiguous when it is full along the axes after some axis, and has one element
+ * along the axes before it. A permutation is when it only moves the axes of one element.
+ *
+ * \param allow_byte_offset Whether to rewrite the slices which do not start at the beginning of
+ * the input. Their views have a byte offset, which the default buffers of the TIR kernels do not
+ * accept, so it should only be set when the views are consumed by the functions which accept it.
+ * \return The Pass.
+ */
+TVM_DLL Pass RewriteSliceToView(bool allow_byte_offset = false);
+
 /*!
  * \brief The static memory planning pass on BindingBlock level.
  * The pass will reuse allocated memory to its best effort, in order to
@@ -218,9 +233,12 @@ TVM_DLL Pass BindSymbolicVars(Map<ObjectRef, PrimExpr> binding_map,
  *
  * \note ConvertToDataflow may need to be called first to provide dataflow blocks.
  *
+ * \param batched Whether to fold in rounds, each of which builds the functions of the foldable
+ * calls in one module and evaluates the calls in parallel, rather than building and evaluating
+ * each call as it is visited.
  * \return The Pass.
  */
-TVM_DLL Pass FoldConstant();
+TVM_DLL Pass FoldConstant(bool batched = false);
 
 /*!
  * \brief Legalize high-level operator calls in Relax functions to call_tir
@@ -253,6 +271,25 @@ TVM_DLL Pass LegalizeOps(Optional<Map<String, PackedFunc>> cmap, bool enable_war
  */
 TVM_DLL Pass RealizeVDevice();
 
+/*!
+ * \brief Place the operators of the dataflow blocks on the host or on the device, whichever
+ * minimizes the estimated run time of the block including the transfers between them.
+ *
+ * The operators on tensors of static shapes whose device is not specified are placed between
+ * the first CPU and the first other virtual device of the module. The run time of an operator
+ * on each device is estimated by a roofline model of its FLOPs and bytes, plus a launch
+ * overhead, and the placement is the minimum cut of the dataflow graph between the two devices.
+ * The operators placed on the host are annotated with its virtual device, and `to_vdevice` is
+ * inserted where the values cross the devices. All the other values stay on the device.
+ *
+ * \param cost_model The overrides of the parameters of the cost model: "host_flops",
+ * "host_bandwidth", "host_launch_overhead", "device_flops", "device_bandwidth",
+ * "device_launch_overhead", "transfer_bandwidth" and "transfer_latency", in FLOP/s, bytes/s and
+ * seconds.
+ * \return The Pass.
+ */
+TVM_DLL Pass AutoPlaceVDevice(Map<String, FloatImm> cost_model = {});
+
 /*!
  * \brief Lift transformation of the parameters of a function.
  *
@@ -605,7 +642,8 @@ TVM_DLL Pass DeadCodeElimination(Array<runtime::String> entry_functions = {});
  * (generally, these are elementwise operations) in dataflow blocks into in-place implementations.
  * Supported operators will be replaced by calls to `call_tir_inplace` that invoke in-place
  * PrimFunc implementations of those operators (which are based on the legalizations of those
- * operators).
+ * operators). `call_tir` calls to elementwise PrimFuncs are made in-place the same way, and
+ * liveness is analyzed over the whole function rather than within a single block.
  * \note ConvertToDataflow may need to be called first to provide dataflow blocks.
  * \return The pass.
  */
@@ -631,6 +669,26 @@ TVM_DLL Pass ToMixedPrecision(const DataType& out_dtype,
  */
 TVM_DLL Pass RewriteCUDAGraph();
 
+/*!
+ * \brief Assign the independent kernel calls of each binding block to multiple streams, with
+ * `vm.builtin.stream_sync` at the dependency edges across streams. The pass runs after
+ * CallTIRRewrite and before StaticPlanBlockMemory.
+ * \param num_streams The number of streams. When not given, it is read from the
+ * "relax.backend.num_streams" option of the PassContext, and the pass does nothing for one stream.
+ * \param device_index The index of the VM device that runs the kernels.
+ * \return The Pass.
+ */
+TVM_DLL Pass AssignStreams(Optional<Integer> num_streams = NullOpt, int device_index = 0);
+
+/*!
+ * \brief Fuse independent call_tir of small scheduled GPU kernels in a dataflow block into one
+ * kernel, whose thread blocks are dispatched to the original kernels by their index. The fused
+ * kernels must have the same thread extents and a single grid axis, blockIdx.x.
+ * \param max_num_blocks The maximum number of thread blocks of a kernel to be fused.
+ * \return The Pass.
+ */
+TVM_DLL Pass HorizontalFuseTIR(int64_t max_num_blocks = 128);
+
 /*!
  * \brief The pass is designed for few shot tuning for static shape PrimFuncs. It examines all the
  *  blocks within the PrimFunc and conducts loop fusion, splitting, and other transformations based
@@ -195,6 +195,11 @@ constexpr const char* kInline = "Inline";
 constexpr const char* kPartitionedFromPattern = "PartitionedFromPattern";
 /*! \brief Mark the function as only composed of reshape operations. */
 constexpr const char* kReshapeOnly = "relay.reshape_only";
+/*!
+ * \brief Mark the lowered call of a function only composed of elementwise and broadcast
+ * operations.
+ */
+constexpr const char* kElemwiseOnly = "relay.elemwise_only";
 
 }  // namespace attr
 
@@ -153,6 +153,20 @@ TVM_DLL int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, in
  */
 TVM_DLL int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv);
 
+/*!
+ * \brief Backend function to start counting the cycles of a loop or a function instrumented by
+ *  `tir.transform.InstrumentProfileIntrinsics`, on the calling thread.
+ * \param loop_id The id of the instrumented loop.
+ */
+TVM_DLL void TVMBackendLoopProfileStart(int32_t loop_id);
+
+/*!
+ * \brief Backend function to stop counting the cycles of an instrumented loop or function, and
+ *  add them to the counters of the calling thread.
+ * \param loop_id The id of the instrumented loop.
+ */
+TVM_DLL void TVMBackendLoopProfileEnd(int32_t loop_id);
+
 /*!
  * \brief Simple static initialization function.
  *  Run f once and set handle to be not null.
@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \brief Performance counters of CUDA kernels for profiling via the CUPTI library.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_CUPTI_H_
+#define TVM_RUNTIME_CONTRIB_CUPTI_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/profiling.h>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief Construct a metric collector that collects the metrics of CUDA kernels from the
+ * performance counters of the GPU, using the CUDA Profiling Tools Interface (CUPTI).
+ *
+ * \param metrics A mapping from a CUDA device to the metrics that should be collected on that
+ * device, e.g. `achieved_occupancy`, `sm_efficiency` or `dram_read_throughput`. You can find the
+ * names of available metrics by running `nvprof --query-metrics`. Devices that are not in the
+ * mapping collect a default set of metrics.
+ */
+TVM_DLL MetricCollector CreateCUPTIMetricCollector(Map<DeviceWrapper, Array<String>> metrics);
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_CUPTI_H_
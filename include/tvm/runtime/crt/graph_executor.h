@@ -56,6 +56,30 @@ typedef struct TVMGraphExecutorGraphAttr {
 
 typedef struct TVMGraphExecutor TVMGraphExecutor;
 
+#ifndef TVM_CRT_GRAPH_EXECUTOR_ARENA_ALIGNMENT_BYTES
+/*! \brief Alignment required from the storage entries placed in a TVMGraphExecutorArena. */
+#define TVM_CRT_GRAPH_EXECUTOR_ARENA_ALIGNMENT_BYTES 16
+#endif
+
+/*!
+ * \brief Caller-provided buffer holding every storage entry of the graph.
+ *
+ * The offsets are computed offline from the storage_id plan of the graph, e.g. by
+ * tvm.micro.plan_graph_arena, so that storage entries whose lifetimes do not overlap share
+ * bytes. When offsets is NULL, the storage entries are packed one after the other in storage id
+ * order, which needs more memory but no offline step.
+ */
+typedef struct TVMGraphExecutorArena {
+  /*! \brief Start of the arena, aligned to TVM_CRT_GRAPH_EXECUTOR_ARENA_ALIGNMENT_BYTES. */
+  uint8_t* data;
+  /*! \brief Size of the arena in bytes. */
+  size_t size;
+  /*! \brief Byte offset of each storage id in the arena, or NULL. */
+  const uint32_t* offsets;
+  /*! \brief Number of entries in offsets. */
+  uint32_t offsets_count;
+} TVMGraphExecutorArena;
+
 // public functions
 /*!
  * \brief Allocate a new GraphExecutor with TVMPlatformMemoryAllocate and initialize it.
@@ -69,6 +93,23 @@ typedef struct TVMGraphExecutor TVMGraphExecutor;
 int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
                             const DLDevice* devices, TVMGraphExecutor** executor);
 
+/*!
+ * \brief Allocate a new GraphExecutor whose tensors all live in a caller-provided arena.
+ *
+ * No tensor data is allocated at runtime: the storage entries that are not linked parameters
+ * point into the arena, which must outlive the executor. The arena is not cleared.
+ *
+ * \param sym_json JSON-encoded graph.
+ * \param module_handle TVM Module that exposes the functions to call.
+ * \param devices runtime execution device.
+ * \param arena The arena and the offset of each storage entry in it.
+ * \param executor Pointer which receives a pointer to the newly-created instance.
+ * \return 0 if successful, non-zero if the arena is too small or an offset is misaligned.
+ */
+int TVMGraphExecutor_CreateWithArena(const char* sym_json, TVMModuleHandle module_handle,
+                                     const DLDevice* devices, const TVMGraphExecutorArena* arena,
+                                     TVMGraphExecutor** executor);
+
 int TVMGraphExecutor_GetInputIndex(TVMGraphExecutor* executor, const char* name);
 
 /*!
@@ -52,6 +52,12 @@ enum DeviceAttrKind : int {
   kL2CacheSizeBytes = 13,
   kTotalGlobalMemory = 14,
   kAvailableGlobalMemory = 15,
+  /*!
+   * \brief The links to the other devices of the same type, as a JSON list of objects with the
+   * fields "device_id", "access" (whether the device can access the memory of the peer),
+   * "link" ("nvlink", "pcie" or "none") and "performance_rank" (lower is faster).
+   */
+  kPeerTopology = 16,
 };
 
 #ifdef TVM_KALLOC_ALIGNMENT
@@ -84,6 +84,44 @@ TVM_DLL void AllReduce(NDArray send, ReduceKind reduce_kind, NDArray recv);
  * \param recv The array receives the outcome of allgather
  */
 TVM_DLL void AllGather(NDArray send, NDArray recv);
+/*!
+ * \brief Perform an allreduce operation within a named group of workers, see `InitCCLGroup`.
+ * Only the members of the group call it.
+ * \param send The array send to perform allreduce on
+ * \param reduce_kind The kind of reduction operation (e.g. sum, avg, min, max)
+ * \param group The name of the group
+ * \param recv The array receives the outcome of allreduce
+ */
+TVM_DLL void AllReduceGroup(NDArray send, ReduceKind reduce_kind, String group, NDArray recv);
+/*!
+ * \brief Perform an allgather operation within a named group of workers, see `InitCCLGroup`.
+ * \param send The array send to perform allgather on
+ * \param group The name of the group
+ * \param recv The array receives the outcome of allgather
+ */
+TVM_DLL void AllGatherGroup(NDArray send, String group, NDArray recv);
+/*!
+ * \brief Enqueue an allreduce operation on the communication stream of the underlying
+ * communication library, after the work already enqueued on the compute stream.
+ * \param send The array send to perform allreduce on
+ * \param reduce_kind The kind of reduction operation (e.g. sum, avg, min, max)
+ * \param recv The array receives the outcome of allreduce
+ * \return The handle to pass to `WaitCCL` before `recv` is used, or `send` and `recv` reused
+ */
+TVM_DLL ObjectRef AllReduceAsync(NDArray send, ReduceKind reduce_kind, NDArray recv);
+/*!
+ * \brief Enqueue an allgather operation on the communication stream, see `AllReduceAsync`.
+ * \param send The array send to perform allgather on
+ * \param recv The array receives the outcome of allgather
+ * \return The handle to pass to `WaitCCL`
+ */
+TVM_DLL ObjectRef AllGatherAsync(NDArray send, NDArray recv);
+/*!
+ * \brief Make the compute stream wait for an asynchronous collective operation, without
+ * blocking the host.
+ * \param handle The handle returned by the asynchronous operation
+ */
+TVM_DLL void WaitCCL(ObjectRef handle);
 /*!
  * \brief Perform a broadcast operation from worker-0
  * \param send The buffer to be broadcasted
@@ -109,8 +147,49 @@ TVM_DLL void GatherToWorker0(NDArray send, Optional<NDArray> recv);
  * \param buffer The buffer to be received
  */
 TVM_DLL void RecvFromWorker0(NDArray buffer);
+/*!
+ * \brief Split the workers into groups of consecutive ids, so that collective operations run
+ * within each group. Must be called on all workers after the communication library is initialized.
+ * \param num_groups The number of groups, which must divide the number of workers
+ */
+TVM_DLL void InitWorkerGroups(int num_groups);
+/*!
+ * \brief Create named groups of workers for the collective operations scoped to them, such as
+ * the tensor parallel groups and the data parallel groups of hybrid parallelism. Must be called
+ * on all workers after the communication library is initialized. The communicators are cached
+ * by the partition of the workers, so several names for the same groups share them.
+ * \param name The name of the groups
+ * \param group_sizes The number of workers in each group
+ * \param ranks The worker ids of the groups concatenated, in the order of their ranks within
+ * each group. Each worker is in at most one of the groups.
+ */
+TVM_DLL void InitCCLGroup(String name, IntTuple group_sizes, IntTuple ranks);
+/*!
+ * \brief Send a buffer to another worker, matched by a `RecvFromWorker` on the receiver
+ * \param buffer The buffer to be sent
+ * \param receiver_id The id of the receiving worker
+ */
+TVM_DLL void SendToWorker(NDArray buffer, int receiver_id);
+/*!
+ * \brief Receive a buffer from another worker, matched by a `SendToWorker` on the sender
+ * \param buffer The buffer to be received
+ * \param sender_id The id of the sending worker
+ */
+TVM_DLL void RecvFromWorker(NDArray buffer, int sender_id);
+/*!
+ * \brief Send a buffer to the worker at the same position in the next group.
+ * \param buffer The buffer to be sent
+ */
+TVM_DLL void SendToNextGroup(NDArray buffer);
+/*!
+ * \brief Receive a buffer from the worker at the same position in the previous group.
+ * \param buffer The buffer to be received
+ */
+TVM_DLL void RecvFromPrevGroup(NDArray buffer);
 /*! \brief Get the local worker id */
 TVM_DLL int WorkerId();
+/*! \brief Get the group id of the local worker */
+TVM_DLL int WorkerGroup();
 /*!
  * \brief Called by the worker thread. Waiting until the worker completes all its tasks.
  * As a specific example, on a CUDA worker, it blocks until all kernels are launched and
@@ -52,6 +52,7 @@ class DiscoWorker {
                        DiscoChannel* channel)
       : worker_id(worker_id),
         num_workers(num_workers),
+        num_groups(1),
         default_device(Device{DLDeviceType::kDLCPU, 0}),
         worker_zero_data(worker_zero_data),
         channel(channel),
@@ -68,6 +69,11 @@ class DiscoWorker {
   int worker_id;
   /*! \brief Total number of workers */
   int num_workers;
+  /*!
+   * \brief The number of worker groups, e.g. pipeline stages. Workers are split into groups of
+   * `num_workers / num_groups` consecutive ids, and collective operations run within a group.
+   */
+  int num_groups;
   /*! \brief The default device to allocate data if not specified */
   Device default_device;
   /*! \brief The name of the underlying collective communication library. */
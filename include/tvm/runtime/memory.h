@@ -25,7 +25,9 @@
 
 #include <tvm/runtime/object.h>
 
+#include <atomic>
 #include <cstdlib>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -40,6 +42,26 @@ namespace runtime {
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args);
 
+/*!
+ * \brief Per-thread counter of the objects allocated by make_object, e.g. to profile the
+ *  allocations of the compiler passes. It only counts while `num_active` is positive.
+ */
+struct ObjectAllocationCounter {
+  /*! \brief The number of users of the counter, which counts while it is positive. */
+  TVM_DLL static std::atomic<int> num_active;
+  /*! \return The number of objects allocated by the calling thread while counting. */
+  static int64_t& ThreadLocalCount() {
+    static thread_local int64_t count = 0;
+    return count;
+  }
+  /*! \brief Count an allocation. */
+  static void OnAllocate() {
+    if (num_active.load(std::memory_order_relaxed) > 0) {
+      ++ThreadLocalCount();
+    }
+  }
+};
+
 // Detail implementations after this
 //
 // The current design allows swapping the
@@ -47,8 +69,10 @@ inline ObjectPtr<T> make_object(Args&&... args);
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
+//
+// make_object uses the thread-local object pools of PoolObjAllocator when TVM is built with
+// USE_OBJECT_POOL_ALLOCATOR, and SimpleObjAllocator otherwise.
 
 /*!
  * \brief Base class of object allocators that implements make.
@@ -72,6 +96,7 @@ class ObjAllocatorBase {
     T* ptr = Handler::New(static_cast<Derived*>(this), std::forward<Args>(args)...);
     ptr->type_index_ = T::RuntimeTypeIndex();
     ptr->deleter_ = Handler::Deleter();
+    ObjectAllocationCounter::OnAllocate();
     return ObjectPtr<T>(ptr);
   }
 
@@ -91,6 +116,7 @@ class ObjAllocatorBase {
         Handler::New(static_cast<Derived*>(this), num_elems, std::forward<Args>(args)...);
     ptr->type_index_ = ArrayType::RuntimeTypeIndex();
     ptr->deleter_ = Handler::Deleter();
+    ObjectAllocationCounter::OnAllocate();
     return ObjectPtr<ArrayType>(ptr);
   }
 };
@@ -191,9 +217,138 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+/*!
+ * \brief Thread-local pool of the memory of small objects, e.g. the IR nodes which the compiler
+ *  passes create and release by millions.
+ *
+ *  The memory is pooled by size classes of kUnit bytes. A freed block goes to the free list of
+ *  its size class in the pool of the thread which frees it, which holds at most kMaxFreeBlocks
+ *  blocks per size class, and is reused by the next allocation of that size class by the thread,
+ *  without going through the global allocator.
+ */
+class ObjectPool {
+ public:
+  /*! \brief The granularity of the size classes, which is also the alignment of the blocks. */
+  static constexpr size_t kUnit = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  /*! \brief The size of the largest pooled object. */
+  static constexpr size_t kMaxObjectSize = 256;
+  /*! \brief The maximum number of free blocks held per size class. */
+  static constexpr size_t kMaxFreeBlocks = 4096;
+
+  /*! \return Whether objects of \p size bytes and \p alignment are pooled. */
+  static constexpr bool Pooled(size_t size, size_t alignment) {
+    return size <= kMaxObjectSize && alignment <= kUnit;
+  }
+
+  /*! \brief Allocate a block of \p size bytes, which should be pooled. */
+  static void* Allocate(size_t size) {
+    size_t size_class = (size - 1) / kUnit;
+    if (ObjectPool* pool = ThreadLocal()) {
+      FreeList& free_list = pool->free_lists_[size_class];
+      if (FreeBlock* block = free_list.head) {
+        free_list.head = block->next;
+        --free_list.size;
+        return block;
+      }
+    }
+    return ::operator new((size_class + 1) * kUnit);
+  }
+
+  /*! \brief Free a block which Allocate has returned for \p size bytes. */
+  static void Free(void* ptr, size_t size) {
+    if (ObjectPool* pool = ThreadLocal()) {
+      FreeList& free_list = pool->free_lists_[(size - 1) / kUnit];
+      if (free_list.size < kMaxFreeBlocks) {
+        free_list.head = new (ptr) FreeBlock{free_list.head};
+        ++free_list.size;
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+
+  ~ObjectPool() {
+    // The objects freed by the destructors of the other thread-local variables after this one
+    // go to the global allocator.
+    Destroyed() = true;
+    for (FreeList& free_list : free_lists_) {
+      while (FreeBlock* block = free_list.head) {
+        free_list.head = block->next;
+        ::operator delete(block);
+      }
+    }
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct FreeList {
+    FreeBlock* head = nullptr;
+    size_t size = 0;
+  };
+
+  static bool& Destroyed() {
+    static thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  static ObjectPool* ThreadLocal() {
+    if (Destroyed()) return nullptr;
+    static thread_local ObjectPool pool;
+    return &pool;
+  }
+
+  FreeList free_lists_[kMaxObjectSize / kUnit];
+};
+
+/*!
+ * \brief Allocator that takes the memory of the small objects from the thread-local ObjectPool,
+ *  and of the other objects from new/delete.
+ */
+class PoolObjAllocator : public ObjAllocatorBase<PoolObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    using StorageType = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    template <typename... Args>
+    static T* New(PoolObjAllocator*, Args&&... args) {
+      if constexpr (ObjectPool::Pooled(sizeof(StorageType), alignof(StorageType))) {
+        void* data = ObjectPool::Allocate(sizeof(StorageType));
+        new (data) T(std::forward<Args>(args)...);
+        return reinterpret_cast<T*>(data);
+      } else {
+        return SimpleObjAllocator::Handler<T>::New(nullptr, std::forward<Args>(args)...);
+      }
+    }
+
+    static Object::FDeleter Deleter() {
+      if constexpr (ObjectPool::Pooled(sizeof(StorageType), alignof(StorageType))) {
+        return Deleter_;
+      } else {
+        return SimpleObjAllocator::Handler<T>::Deleter();
+      }
+    }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      // See SimpleObjAllocator::Handler for the casts and the explicit destructor call.
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      ObjectPool::Free(tptr, sizeof(StorageType));
+    }
+  };
+};
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
+#if TVM_USE_OBJECT_POOL_ALLOCATOR
+  return PoolObjAllocator().make_object<T>(std::forward<Args>(args)...);
+#else
   return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+#endif
 }
 
 template <typename ArrayType, typename ElemType, typename... Args>
@@ -42,6 +42,8 @@ namespace memory {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kBucketed,
+  kCaching,
 };
 
 struct Buffer {
@@ -55,6 +57,26 @@ struct Buffer {
   AllocatorType alloc_type;
 };
 
+/*! \brief Statistics of an allocator, all sizes are in bytes. */
+struct AllocatorStats {
+  /*! \brief The size of the buffers that are currently handed out. */
+  size_t live_bytes{0};
+  /*! \brief The size of the buffers reserved from the device but cached for reuse. */
+  size_t cached_bytes{0};
+  /*! \brief The peak of the memory reserved from the device. */
+  size_t peak_bytes{0};
+  /*! \brief The part of live_bytes that was added by rounding the requested sizes up. */
+  size_t rounding_waste_bytes{0};
+  /*! \brief The size of the largest cached buffer. */
+  size_t largest_free_block{0};
+  /*! \brief The number of allocations. */
+  uint64_t num_allocs{0};
+  /*! \brief The number of frees. */
+  uint64_t num_frees{0};
+  /*! \brief The number of allocations served from the cache. */
+  uint64_t num_cache_hits{0};
+};
+
 class Allocator {
  public:
   explicit Allocator(AllocatorType type) : type_(type) {}
@@ -98,6 +120,10 @@ class Allocator {
    *  \return The amount of memory currently allocated.
    */
   TVM_DLL virtual size_t UsedMemory() const = 0;
+  /*! \brief Get the statistics of the allocator.
+   *  \return The current statistics.
+   */
+  TVM_DLL virtual AllocatorStats GetStats() const;
 
  protected:
   /*! \brief Check if the given memory scope is allowed to allocate by the allocator. */
@@ -126,6 +152,11 @@ class MemoryManager {
   TVM_DLL static Allocator* GetAllocator(Device dev, AllocatorType type);
   /*! \brief Clear the allocators. */
   static void Clear();
+  /*!
+   * \brief Get the statistics of all allocators.
+   * \return A JSON list with one object per allocator.
+   */
+  TVM_DLL static std::string GetStatsJSON();
 
  private:
   MemoryManager() {}
@@ -292,6 +292,10 @@ constexpr const char* tvm_set_device = "__tvm_set_device";
 constexpr const char* tvm_global_barrier_state = "__tvm_global_barrier_state";
 /*! \brief Prepare the global barrier before kernels that uses global barrier. */
 constexpr const char* tvm_prepare_global_barrier = "__tvm_prepare_global_barrier";
+/*! \brief The loop profiling counters of a device module, the number of runs and the cycles. */
+constexpr const char* tvm_loop_profile_counters = "__tvm_loop_profile_counters";
+/*! \brief Read the loop profiling counters of a device module, see DumpLoopProfile. */
+constexpr const char* tvm_loop_profile_dump = "__tvm_loop_profile_dump";
 /*! \brief Placeholder for the module's entry function. */
 constexpr const char* tvm_module_main = "__tvm_main__";
 /*! \brief Prefix for parameter symbols emitted into the main program. */
@@ -300,6 +304,11 @@ constexpr const char* tvm_param_prefix = "__tvm_param__";
 constexpr const char* tvm_lookup_linked_param = "_lookup_linked_param";
 /*! \brief Model entrypoint generated as an interface to the AOT function outside of TIR */
 constexpr const char* tvm_entrypoint_suffix = "run";
+/*!
+ * \brief Suffix of the entry of a kernel that does not check its arguments, emitted with the
+ *  "tir.emit_unchecked_api" pass config.
+ */
+constexpr const char* tvm_unchecked_suffix = "__unchecked";
 }  // namespace symbol
 
 // implementations of inline functions.
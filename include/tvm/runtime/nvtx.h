@@ -26,7 +26,12 @@ namespace tvm {
 namespace runtime {
 
 /*!
- * \brief A class to create a NVTX range. No-op if TVM is not built against NVTX.
+ * \brief A class to create a NVTX range, or a ROCTX range on ROCm. No-op if TVM is not built
+ *  against NVTX or ROCTX, or if the ranges are not enabled at runtime.
+ *
+ *  The ranges are off by default, and are turned on by `NVTXScopedRange::SetEnabled`, or by
+ *  setting the environment variable `TVM_NVTX_RANGES=1`. Call sites which build the name of a
+ *  range should check `NVTXScopedRange::Enabled()` first, so that nothing is paid when off.
  */
 class NVTXScopedRange {
  public:
@@ -36,10 +41,18 @@ class NVTXScopedRange {
   explicit NVTXScopedRange(const std::string& name) : NVTXScopedRange(name.c_str()) {}
   /*! \brief Exist an NVTX scoped range */
   TVM_DLL ~NVTXScopedRange();
+  /*! \return Whether the ranges are recorded, which requires TVM to be built against NVTX. */
+  TVM_DLL static bool Enabled();
+  /*! \brief Turn the recording of ranges on or off. */
+  TVM_DLL static void SetEnabled(bool enabled);
   NVTXScopedRange(const NVTXScopedRange& other) = delete;
   NVTXScopedRange(NVTXScopedRange&& other) = delete;
   NVTXScopedRange& operator=(const NVTXScopedRange& other) = delete;
   NVTXScopedRange& operator=(NVTXScopedRange&& other) = delete;
+
+ private:
+  /*! \brief Whether the range was entered, which is decided once at construction. */
+  bool entered_;
 };
 
 #ifdef _MSC_VER
@@ -34,9 +34,11 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -108,6 +110,16 @@ class PackedFuncObj : public Object {
 
   /*! \brief Internal callable function pointer used to call the packed function. */
   FCallPacked* f_call_packed_;
+  /*!
+   * \brief The key of the signature of the typed function which can be called without packing
+   *  its arguments through f_call_typed_, or nullptr. See TypedPackedFunc::operator().
+   */
+  const void* typed_signature_key_ = nullptr;
+  /*! \brief The type-erased function pointer of the typed call, if typed_signature_key_ is set. */
+  void (*f_call_typed_)() = nullptr;
+
+  template <typename FType>
+  friend class TypedPackedFunc;
 };
 
 /*! \brief Derived object class for constructing PackedFuncObj. */
@@ -1772,6 +1784,65 @@ class TVMArgsSetter {
   int* type_codes_;
 };
 
+/*!
+ * \brief The packed arguments of a call, stored on the stack up to kInlineCapacity arguments and
+ *  on the heap beyond, to avoid allocating std::vector on hot calls.
+ *
+ * \code
+ *   TVMArgsPack<> pack(args.size() + 1);
+ *   pack.setter()(0, ctx);
+ *   pack.CopyFrom(args, 1);
+ *   func.CallPacked(pack.args(), rv);
+ * \endcode
+ * \tparam kInlineCapacity The number of arguments stored on the stack.
+ */
+template <int kInlineCapacity = 8>
+class TVMArgsPack {
+ public:
+  /*! \param num_args The number of arguments. */
+  explicit TVMArgsPack(int num_args) : num_args_(num_args) {
+    if (num_args > kInlineCapacity) {
+      heap_values_.reset(new TVMValue[num_args]);
+      heap_type_codes_.reset(new int[num_args]);
+    }
+  }
+  TVMArgsPack(const TVMArgsPack&) = delete;
+  TVMArgsPack& operator=(const TVMArgsPack&) = delete;
+
+  /*! \return The values of the arguments. */
+  TVMValue* values() { return heap_values_ ? heap_values_.get() : inline_values_; }
+  /*! \return The type codes of the arguments. */
+  int* type_codes() { return heap_type_codes_ ? heap_type_codes_.get() : inline_type_codes_; }
+  /*! \return The number of arguments. */
+  int size() const { return num_args_; }
+  /*! \return The setter of the arguments. */
+  TVMArgsSetter setter() { return TVMArgsSetter(values(), type_codes()); }
+  /*! \return The arguments, valid while the pack lives. */
+  TVMArgs args() { return TVMArgs(values(), type_codes(), num_args_); }
+  /*!
+   * \brief Copy packed arguments to the arguments starting at \p offset.
+   * \param src The arguments to copy.
+   * \param offset The index of the first argument to set.
+   */
+  void CopyFrom(const TVMArgs& src, int offset) {
+    ICHECK_LE(offset + src.size(), num_args_);
+    std::copy(src.values, src.values + src.size(), values() + offset);
+    std::copy(src.type_codes, src.type_codes + src.size(), type_codes() + offset);
+  }
+
+ private:
+  /*! \brief The number of arguments. */
+  int num_args_;
+  /*! \brief The values of the arguments if they fit on the stack. */
+  TVMValue inline_values_[kInlineCapacity];
+  /*! \brief The type codes of the arguments if they fit on the stack. */
+  int inline_type_codes_[kInlineCapacity];
+  /*! \brief The values of the arguments otherwise. */
+  std::unique_ptr<TVMValue[]> heap_values_;
+  /*! \brief The type codes of the arguments otherwise. */
+  std::unique_ptr<int[]> heap_type_codes_;
+};
+
 template <typename... Args>
 inline TVMRetValue PackedFunc::operator()(Args&&... args) const {
   const int kNumArgs = sizeof...(Args);
@@ -1851,6 +1922,61 @@ TVM_ALWAYS_INLINE void unpack_call(const std::string* optional_name, const F& f,
   unpack_call_dispatcher<R, nargs, 0, F>::run(optional_name, f_sig, f, args, rv);
 }
 
+/*! \brief The unique key of a function signature, see TypedPackedFunc::operator(). */
+template <typename FType>
+struct TypedSignatureKey {
+  static constexpr char key = 0;
+};
+
+template <typename FType>
+struct decayed_signature;
+
+template <typename R, typename... Args>
+struct decayed_signature<R(Args...)> {
+  using FType = R(std::decay_t<Args>...);
+};
+
+/*!
+ * \brief The callable of the PackedFunc of a typed lambda, which unpacks the arguments of the
+ *  packed calls and keeps the lambda for the typed calls.
+ * \tparam FLambda The type of the lambda.
+ * \tparam R The return type of the TypedPackedFunc.
+ * \tparam Args The argument types of the TypedPackedFunc.
+ */
+template <typename FLambda, typename R, typename... Args>
+struct TypedLambdaCallable {
+  /*!
+   * \brief Whether the TypedPackedFunc can call the lambda directly, which it does when the types
+   *  are the same up to references and cv-qualifiers, so that the conversions of the packed call
+   *  would not change the arguments nor the return value.
+   */
+  static constexpr bool kTypedCall =
+      std::is_same<typename decayed_signature<typename function_signature<FLambda>::FType>::FType,
+                   R(std::decay_t<Args>...)>::value &&
+      std::is_invocable_r<R, const FLambda&, Args&&...>::value;
+
+  /*! \brief The lambda. */
+  FLambda flambda;
+  /*! \brief The name of the function in the error messages, or std::nullopt if anonymous. */
+  std::optional<std::string> name;
+
+  void operator()(const TVMArgs& args, TVMRetValue* rv) const {
+    if (args.size() != sizeof...(Args)) {
+      FSig* f_sig = SignaturePrinter<function_signature<FLambda>>::F;
+      LOG(FATAL) << "Function " << (name ? *name : std::string("<anonymous> "))
+                 << (f_sig == nullptr ? "" : (*f_sig)()) << " expects " << sizeof...(Args)
+                 << " arguments, but " << args.size() << " were provided.";
+    }
+    unpack_call<R, sizeof...(Args)>(name ? &*name : nullptr, flambda, args, rv);
+  }
+
+  /*! \brief Call the lambda of the PackedFunc \p obj with unpacked arguments. */
+  static R CallTyped(const PackedFuncObj* obj, Args... args) {
+    const auto* self = static_cast<const PackedFuncSubObj<TypedLambdaCallable>*>(obj);
+    return self->callable_.flambda(std::forward<Args>(args)...);
+  }
+};
+
 template <typename FType>
 struct unpack_call_by_signature {};
 
@@ -1902,31 +2028,35 @@ TypedPackedFunc<R(Args...)>::TypedPackedFunc(TVMMovableArgValueWithContext_&& va
 template <typename R, typename... Args>
 template <typename FType>
 inline void TypedPackedFunc<R(Args...)>::AssignTypedLambda(FType flambda, std::string name) {
-  FSig* f_sig = detail::SignaturePrinter<detail::function_signature<FType>>::F;
-  packed_ = PackedFunc([flambda, name, f_sig](const TVMArgs& args, TVMRetValue* rv) {
-    if (args.size() != sizeof...(Args)) {
-      LOG(FATAL) << "Function " << name << (f_sig == nullptr ? "" : (*f_sig)()) << " expects "
-                 << sizeof...(Args) << " arguments, but " << args.size() << " were provided.";
-    }
-    detail::unpack_call<R, sizeof...(Args)>(&name, flambda, args, rv);
-  });
+  using Callable = detail::TypedLambdaCallable<FType, R, Args...>;
+  auto obj = make_object<PackedFuncSubObj<Callable>>(Callable{flambda, std::move(name)});
+  if constexpr (Callable::kTypedCall) {
+    obj->typed_signature_key_ = &detail::TypedSignatureKey<R(Args...)>::key;
+    obj->f_call_typed_ = reinterpret_cast<void (*)()>(&Callable::CallTyped);
+  }
+  packed_ = PackedFunc(ObjectPtr<Object>(std::move(obj)));
 }
 
 template <typename R, typename... Args>
 template <typename FType>
 inline void TypedPackedFunc<R(Args...)>::AssignTypedLambda(FType flambda) {
-  FSig* f_sig = detail::SignaturePrinter<detail::function_signature<FType>>::F;
-  packed_ = PackedFunc([flambda, f_sig](const TVMArgs& args, TVMRetValue* rv) {
-    if (args.size() != sizeof...(Args)) {
-      LOG(FATAL) << "Function <anonymous> " << (*f_sig)() << " expects " << sizeof...(Args)
-                 << " arguments, but " << args.size() << " were provided.";
-    }
-    detail::unpack_call<R, sizeof...(Args)>(nullptr, flambda, args, rv);
-  });
+  using Callable = detail::TypedLambdaCallable<FType, R, Args...>;
+  auto obj = make_object<PackedFuncSubObj<Callable>>(Callable{flambda, std::nullopt});
+  if constexpr (Callable::kTypedCall) {
+    obj->typed_signature_key_ = &detail::TypedSignatureKey<R(Args...)>::key;
+    obj->f_call_typed_ = reinterpret_cast<void (*)()>(&Callable::CallTyped);
+  }
+  packed_ = PackedFunc(ObjectPtr<Object>(std::move(obj)));
 }
 
 template <typename R, typename... Args>
 TVM_ALWAYS_INLINE R TypedPackedFunc<R(Args...)>::operator()(Args... args) const {
+  // Fast path: a typed lambda of the same signature is called without packing its arguments.
+  const auto* obj = static_cast<const PackedFuncObj*>(packed_.get());
+  if (obj != nullptr && obj->typed_signature_key_ == &detail::TypedSignatureKey<R(Args...)>::key) {
+    using FCallTyped = R (*)(const PackedFuncObj*, Args...);
+    return reinterpret_cast<FCallTyped>(obj->f_call_typed_)(obj, std::forward<Args>(args)...);
+  }
   return detail::typed_packed_call_dispatcher<R>::run(packed_, std::forward<Args>(args)...);
 }
 
@@ -26,11 +26,15 @@
 
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -425,6 +429,95 @@ class Profiler {
   std::unordered_map<String, ObjectRef> configuration_;
 };
 
+/*! \brief A profiler cheap enough to stay on in production, which times the calls of one in
+ * `sample_interval` requests of an executor and aggregates their latency into a histogram per
+ * call site.
+ *
+ * Unlike `Profiler`, it never synchronizes the device. The calls of a sampled request are timed
+ * with the `Timer` of their device, i.e. events on GPUs, and the timers are only read at the end
+ * of the next sampled request of the same thread, when the device is long done with them.
+ * Devices without a timer fall back to `DefaultTimer`, which does synchronize. Each thread
+ * records into a buffer of its own, so that recording takes no lock.
+ *
+ * Example usage:
+ * \code{.cpp}
+ * SamplingProfiler prof(100);
+ * int conv = prof.RegisterCall("conv2d", gpu);
+ * // for every request
+ * bool sampled = prof.StartRequest();
+ * if (sampled) prof.StartCall(conv);
+ * conv2d();
+ * if (sampled) prof.StopCall();
+ * if (sampled) prof.StopRequest();
+ * \endcode
+ */
+class SamplingProfiler {
+ public:
+  /*! \brief The number of buckets of the latency histograms, bucket `b` holding the latencies
+   * of `b` significant bits in nanoseconds.
+   */
+  static constexpr int kNumBuckets = 64;
+
+  /*! \brief Constructor.
+   * \param sample_interval The profiler times one request in `sample_interval`.
+   * \param configuration Additional configuration data to add to the report.
+   */
+  explicit SamplingProfiler(int sample_interval,
+                            std::unordered_map<String, ObjectRef> configuration = {});
+  ~SamplingProfiler();
+  /*! \brief Register a call site, e.g. an operator of the graph. All the call sites should be
+   * registered before the first request.
+   * \param name The name of the function called.
+   * \param dev The device the function runs on.
+   * \return The id of the call site.
+   */
+  int RegisterCall(String name, Device dev);
+  /*! \brief Start a request.
+   * \return Whether the request is sampled, in which case its calls should be timed and it
+   * should end with `StopRequest`.
+   */
+  bool StartRequest() {
+    if (num_requests_.fetch_add(1, std::memory_order_relaxed) % sample_interval_ != 0) {
+      return false;
+    }
+    ResetThreadRequest();
+    return true;
+  }
+  /*! \brief Start timing a call of a sampled request. Calls are stopped in LIFO order.
+   * \param call_id The id of the call site.
+   */
+  void StartCall(int call_id);
+  /*! \brief Stop timing the last call started. */
+  void StopCall();
+  /*! \brief End a sampled request, which reads the timers of the previous sampled request of
+   * the thread into the histograms.
+   */
+  void StopRequest();
+  /*! \brief A report of the latency of every call site that was sampled, with its count, total,
+   * mean and percentiles. The timers of the last sampled request of the calling thread are read
+   * first, while the ones of the other threads wait for their next sampled request.
+   */
+  profiling::Report Report();
+
+ private:
+  struct ThreadBuffer;
+  /*! \brief The buffer of the current thread, created on first use. */
+  ThreadBuffer* GetThreadBuffer();
+  /*! \brief Drop the calls of a sampled request that did not end, e.g. one that threw. */
+  void ResetThreadRequest();
+
+  /*! \brief A unique id of the profiler, which keys the buffers of the threads. */
+  int64_t id_;
+  int64_t sample_interval_;
+  std::atomic<int64_t> num_requests_{0};
+  std::vector<String> call_names_;
+  std::vector<Device> call_devices_;
+  std::unordered_map<String, ObjectRef> configuration_;
+  /*! \brief The buffers of the threads, which are only added under the mutex. */
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  std::mutex mutex_;
+};
+
 /* \brief A duration in time. */
 class DurationNode : public Object {
  public:
@@ -589,6 +682,50 @@ PackedFunc WrapTimeEvaluator(PackedFunc f, Device dev, int number, int repeat, i
                              int repeats_to_cooldown, int cache_flush_bytes = 0,
                              PackedFunc f_preproc = nullptr);
 
+/*!
+ * \brief Measure the time cost of several packed functions in one process, interleaving their
+ * repeats so that a drift of the device, e.g. its clock going down as it heats, spreads over all
+ * of them instead of biasing the last ones.
+ *
+ * Each function is warmed up and its `number` calibrated to `min_repeat_ms` as in
+ * `WrapTimeEvaluator`, before the `repeat` rounds each of which times every function once, in an
+ * order rotated by one every round. The timing uses the `Timer` of the device, i.e. events on
+ * CUDA, and a function that throws stops being timed.
+ *
+ * \param funcs The functions to time.
+ * \param args The arguments of each function.
+ * \param dev The device the functions run on.
+ * \param number The minimum number of runs of a function in one of its repeats.
+ * \param repeat The number of repeats.
+ * \param min_repeat_ms The minimum duration of one repeat in milliseconds.
+ * \param cache_flush_bytes The number of bytes of device memory to overwrite before every repeat
+ *        of a function, which flushes the cache of the device if it is at least its size.
+ * \return The cost in seconds of every repeat of each function as a float64 NDArray on CPU, or
+ *         the error message of the function if it failed.
+ */
+Array<ObjectRef> InterleavedTimeEvaluate(Array<PackedFunc> funcs, Array<Array<NDArray>> args,
+                                         Device dev, int number, int repeat, int min_repeat_ms,
+                                         int cache_flush_bytes = 0);
+
+/*!
+ * \brief The number of loop ids the loop profiling collects cycles for. The loops instrumented by
+ * `tir.transform.InstrumentProfileIntrinsics` with larger ids are not measured.
+ */
+constexpr int32_t kMaxProfiledLoops = 4096;
+
+/*!
+ * \brief Get the cycles of the host spent in each instrumented loop or function, summed over the
+ * threads which ran it. The cycles are counted by `TVMBackendLoopProfileStart` and
+ * `TVMBackendLoopProfileEnd`, with the time stamp counter on x86.
+ *
+ * The counters are not synchronized with the threads counting them, so this should be called
+ * after the instrumented functions returned.
+ *
+ * \param reset Whether to clear the counters after reading them.
+ * \return The (loop id, number of runs, total cycles) of each loop which ran, by ascending id.
+ */
+TVM_DLL Array<ShapeTuple> DumpLoopProfile(bool reset);
+
 }  // namespace profiling
 }  // namespace runtime
 }  // namespace tvm
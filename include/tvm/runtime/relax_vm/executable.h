@@ -24,10 +24,13 @@
 #define TVM_RUNTIME_RELAX_VM_EXECUTABLE_H_
 
 #include <tvm/runtime/container/closure.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -42,6 +45,9 @@
 
 namespace tvm {
 namespace runtime {
+
+class MappedFile;
+
 namespace relax_vm {
 
 /*!
@@ -133,6 +139,10 @@ class Executable : public runtime::ModuleNode {
   static Module LoadFromBinary(void* stream);
   /*!
    * \brief Write the Executable to the provided path as a file containing its serialized content.
+   *
+   * The data of the NDArray constants is placed at aligned offsets after the rest of the
+   * executable, so that `LoadFromFile` can map the file and view the constants without copying.
+   *
    * \param file_name The name of the file to write the serialized data to.
    * \param format The target format of the saved file.
    */
@@ -143,8 +153,24 @@ class Executable : public runtime::ModuleNode {
   Module VMProfilerLoadExecutable() const;
   /*! \brief Check if the Executable contains a specific function. */
   bool HasFunction(const String& name) const;
+  /*!
+   * \brief Get the device storage each bytecode VM function allocates, which is the activation
+   * footprint of the function after `StaticPlanBlockMemory`.
+   *
+   * The storage whose size is a constant is summed over all the `vm.builtin.alloc_storage` calls
+   * of the function, on every branch, so it is an upper bound. The storage sized at runtime is
+   * only counted, since its size depends on the inputs.
+   *
+   * \return The map from the names of the VM functions to the tuples of the planned bytes and
+   * the number of the allocations sized at runtime. Host allocations are excluded.
+   */
+  Map<String, ShapeTuple> GetPlannedStorageBytes() const;
   /*!
    * \brief Load Executable from the file.
+   *
+   * The file saved by `SaveToFile` is memory-mapped, and its NDArray constants are CPU NDArrays
+   * viewing the mapping, which the virtual machine copies to the device directly.
+   *
    * \param file_name The path of the file that load the executable from.
    * \return The loaded executable, in the form of a `runtime::Module`.
    */
@@ -170,6 +196,7 @@ class Executable : public runtime::ModuleNode {
   TVM_MODULE_VTABLE_ENTRY("vm_load_executable", &Executable::VMLoadExecutable);
   TVM_MODULE_VTABLE_ENTRY("vm_profiler_load_executable", &Executable::VMProfilerLoadExecutable);
   TVM_MODULE_VTABLE_ENTRY("has_function", &Executable::HasFunction);
+  TVM_MODULE_VTABLE_ENTRY("get_planned_storage_bytes", &Executable::GetPlannedStorageBytes);
   TVM_MODULE_VTABLE_END();
 
  private:
@@ -181,8 +208,10 @@ class Executable : public runtime::ModuleNode {
   /*!
    * \brief Save the constant pool.
    * \param strm The input stream.
+   * \param mapped_data If not null, the data of the NDArray constants is appended to it at aligned
+   *  offsets instead of written to the stream.
    */
-  void SaveConstantSection(dmlc::Stream* strm);
+  void SaveConstantSection(dmlc::Stream* strm, std::string* mapped_data = nullptr);
   /*!
    * \brief Save the instructions.
    * \param strm The input stream.
@@ -201,8 +230,11 @@ class Executable : public runtime::ModuleNode {
   /*!
    * \brief Load the constant pool.
    * \param strm The input stream.
+   * \param file The mapped file which holds the data of the NDArray constants, if any.
+   * \param data_offset The offset of the data of the NDArray constants in the mapped file.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(dmlc::Stream* strm, const std::shared_ptr<MappedFile>& file = nullptr,
+                           size_t data_offset = 0);
   /*!
    * \brief Load the instructions.
    * \param strm The input stream.
@@ -68,6 +68,15 @@ struct NDArrayCacheMetadata {
                                 std::string* raw_data_buffer,    //
                                 Optional<NDArray>* staging_buffer = nullptr) const;
 
+    /*!
+     * \brief Load a FileRecord by memory-mapping the file instead of reading it.
+     * Raw parameters on CPU become zero-copy views over the mapping, which is kept
+     * alive as long as any of them is. Other parameters are copied from the mapping.
+     */
+    TVM_DLL Array<NDArray> LoadMapped(Device device,                   //
+                                      const std::string& path_prefix,  //
+                                      Optional<NDArray>* staging_buffer = nullptr) const;
+
     /*! \brief Relative path to the bin file */
     std::string data_path;
     /*! \brief Format of the file */
@@ -27,7 +27,10 @@
 #define TVM_RELAX_VM_ENABLE_PROFILER 1
 #endif
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -98,6 +101,70 @@ class VMClosure : public Closure {
   static PackedFunc BindLastArgs(PackedFunc func, std::vector<TVMRetValue> last_args);
 };
 
+/*!
+ * \brief The pending result of a call which runs on the async workers of the VM, see
+ * `invoke_closure_async`.
+ *
+ * The call finishes once the kernels it launched complete, with its result, its error, or by
+ * cancellation. A cancelled call stops before the next instruction of its bytecode functions.
+ */
+class VMFutureObj : public Object {
+ public:
+  VMFutureObj();
+  ~VMFutureObj();
+  /*! \brief Whether the call has finished. */
+  bool IsDone() const;
+  /*!
+   * \brief Wait for the call to finish.
+   * \param timeout_ms The maximum time to wait in milliseconds, or negative to wait until done.
+   * \return Whether the call has finished.
+   */
+  bool Wait(int64_t timeout_ms = -1) const;
+  /*! \brief Wait for the call to finish, and return its result, or throw its error. */
+  TVMRetValue Get() const;
+  /*! \brief Request the cancellation of the call. */
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  /*! \brief The flag of the cancellation, which the VM checks between instructions. */
+  const std::atomic<bool>* cancelled() const { return &cancelled_; }
+  /*!
+   * \brief Set the callback called with the future once the call finishes, on the thread which
+   * finishes it, or at once if the call has finished.
+   */
+  void OnDone(PackedFunc callback);
+  /*!
+   * \brief A file descriptor which becomes readable once the call finishes, to wait for calls in
+   * an event loop, or -1 on the platforms without pipes.
+   */
+  int fd() const { return fds_[0]; }
+  /*!
+   * \brief Finish the call.
+   * \param result The result of the call.
+   * \param error The error of the call, or empty if it succeeded.
+   */
+  void Finish(TVMRetValue result, std::string error);
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.Future";
+  TVM_DECLARE_FINAL_OBJECT_INFO(VMFutureObj, Object);
+
+ private:
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cv_;
+  bool done_{false};
+  TVMRetValue result_;
+  std::string error_;
+  PackedFunc callback_;
+  std::atomic<bool> cancelled_{false};
+  /*! \brief The pipe whose read end becomes readable once the call finishes. */
+  int fds_[2] = {-1, -1};
+};
+
+/*! \brief Reference to the future of a call of the VM. */
+class VMFuture : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(VMFuture, ObjectRef, VMFutureObj);
+};
+
 /*!
  * \brief Represent a VM extension.
  * A VM extension allows the user to extend the VM with target specific functionalities.
@@ -129,6 +196,12 @@ class VMExtension : public ObjectRef {
  * enabling one to easily pass around VMs, execute them on
  * multiple threads, or serialize them to disk or over the
  * wire.
+ *
+ * The loaded executable, constants and functions are shared by all calls, while each host
+ * thread that calls into the VM runs on its own execution context, so one VM serves concurrent
+ * calls. The calls of `invoke_closure_async` run on the async workers of the VM, and return a
+ * VMFuture at once. The stateful interface (set_input, invoke_stateful, get_output) and the
+ * extensions are not synchronized beyond their creation.
  */
 class VirtualMachine : public runtime::ModuleNode {
  public:
@@ -190,6 +263,7 @@ class VirtualMachine : public runtime::ModuleNode {
   T GetOrCreateExtension() {
     using ContainerType = typename T::ContainerType;
     uint32_t key = ContainerType::RuntimeTypeIndex();
+    std::lock_guard<std::mutex> lock(extension_mutex_);
     if (auto it = extensions.find(key); it != extensions.end()) {
       return Downcast<T>((*it).second);
     }
@@ -227,6 +301,10 @@ class VirtualMachine : public runtime::ModuleNode {
   /*! \brief The VM extensions. Mapping from the type index of the extension to the extension
    * instance. */
   std::unordered_map<uint32_t, VMExtension> extensions;
+
+ private:
+  /*! \brief The mutex that guards the creation of the extensions. */
+  std::mutex extension_mutex_;
 };
 
 }  // namespace relax_vm
@@ -27,6 +27,7 @@
 #include <tvm/runtime/c_backend_api.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -149,6 +150,89 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 TVM_DLL int32_t NumThreads();
 
+/*!
+ * \brief Configure work stealing in the thread pool of the calling thread.
+ * \param chunks_per_worker The number of tasks created per worker when the
+ *  number of tasks is left to the runtime. Idle workers steal unclaimed tasks
+ *  from their peers. Zero keeps the default static partitioning.
+ * \note This does nothing when openmp is used.
+ */
+TVM_DLL void SetWorkStealing(int chunks_per_worker);
+
+/*!
+ * \brief How the idle workers of a thread pool wait for their next task.
+ */
+enum WaitPolicy : int {
+  /*! \brief Spin for TVM_THREAD_POOL_SPIN_COUNT iterations and then sleep. */
+  kFixedSpin = 0,
+  /*!
+   * \brief Spin for about the recent idle gaps of the worker when they are short, and sleep
+   *  right away when they are long.
+   */
+  kAdaptiveSpin = 1,
+};
+
+/*!
+ * \brief Set how the idle workers of the thread pool of the calling thread wait for tasks.
+ * \param policy The WaitPolicy.
+ * \note This does nothing when openmp is used.
+ */
+TVM_DLL void SetWaitPolicy(int policy);
+
+/*!
+ * \brief Keep the workers of the thread pool of the calling thread spinning for a while, e.g.
+ *  right before a burst of requests, waking the ones that sleep.
+ * \param milliseconds How long the workers keep spinning when they are idle.
+ * \note This does nothing when openmp is used.
+ */
+TVM_DLL void KeepWarm(int64_t milliseconds);
+
+/*!
+ * \brief Get the NUMA topology of the system.
+ * \return The CPU ids of each NUMA node. Without NUMA information, a single
+ *  node containing every CPU is returned.
+ */
+TVM_DLL const std::vector<std::vector<unsigned int>>& NumaNodeCpus();
+
+/*!
+ * \brief Get the NUMA node the calling thread is running on.
+ * \return The node id, or 0 when it is unknown.
+ */
+TVM_DLL int CurrentNumaNode();
+
+/*!
+ * \brief Prefer placing the pages of a memory region on a NUMA node.
+ * \param ptr The start of the region.
+ * \param nbytes The size of the region, only fully covered pages are affected.
+ * \param node The NUMA node.
+ * \note This does nothing on systems with a single node or without mbind.
+ */
+TVM_DLL void BindMemoryToNumaNode(void* ptr, size_t nbytes, int node);
+
+/*!
+ * \brief Bind the workers of the calling thread's pool, and the thread itself, to a NUMA node.
+ * \param node The NUMA node.
+ */
+TVM_DLL void ConfigureNumaNode(int node);
+
+/*!
+ * \brief Distance, in counters, between the per-task counters that TVMBackendParallelBarrier
+ *  expects behind TVMParallelGroupEnv::sync_handle, one cache line apart.
+ */
+constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
+
+/*! \brief A replacement for the thread pool, with the signature of TVMBackendParallelLaunch. */
+using FParallelLaunch = int (*)(FTVMParallelLambda flambda, void* cdata, int num_task);
+
+/*!
+ * \brief Run the parallel loops of the generated code with another launcher than the thread
+ *  pool, e.g. on hardware threads managed by a device runtime.
+ * \param launcher The launcher, nullptr restores the thread pool. It must run every task once
+ *  and point sync_handle at num_task * kSyncStride zeroed counters, or at nullptr when
+ *  TVMBackendParallelBarrier is not supported.
+ */
+TVM_DLL void SetParallelLauncher(FParallelLaunch launcher);
+
 }  // namespace threading
 
 /*!
@@ -139,6 +139,15 @@ struct VMFrame {
         code(code),
         register_file(register_file_size),
         caller_return_register(0) {}
+
+  VMFrame(Index pc, Index func_index, Index args, const Instruction* code,
+          std::vector<ObjectRef> register_file)
+      : pc(pc),
+        func_index(func_index),
+        args(args),
+        code(code),
+        register_file(std::move(register_file)),
+        caller_return_register(0) {}
 };
 
 /*!
@@ -434,6 +443,10 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
   std::vector<PackedFunc> packed_funcs_;
   /*! \brief The current stack of call frames. */
   std::vector<VMFrame> frames_;
+  /*! \brief The emptied register files of the popped frames, reused by the next frames. */
+  std::vector<std::vector<ObjectRef>> register_file_pool_;
+  /*! \brief The scratch arguments of the Invoke and InvokeClosure instructions. */
+  std::vector<ObjectRef> invoke_args_;
   /*! \brief The fuction table index of the current function. */
   Index func_index_;
   /*! \brief The current pointer to the code section. */
@@ -467,6 +480,12 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
    * object to avoid rellocation of constants during inference.
    */
   std::vector<ObjectRef> const_pool_;
+  /*!
+   * \brief The storage from a pooled allocator of each AllocStorage instruction and its
+   * allocation size, or -1 for a static shape. The instruction reuses its last storage while the
+   * size matches and nothing else holds it, such as the outputs of the previous invocation.
+   */
+  std::unordered_map<const Instruction*, std::pair<Storage, int64_t>> storage_cache_;
 };
 
 }  // namespace vm
@@ -731,6 +731,41 @@ TVM_DLL const Op& ptx_wait_barrier();
  */
 TVM_DLL const Op& create_barriers();
 
+/*!
+ * \brief tvm intrinsic for ptx asynchronous copy of a tile of a tensor from global to shared
+ *        memory using cp.async.bulk.tensor, the tensor memory accelerator (TMA) of sm90.
+ *
+ * void ptx_cp_async_bulk_tensor(Var shared_ptr, Expr shared_offset, Var tensor_map,
+ *                               int barrier_id, Expr coord_0, ..., Expr coord_{d-1});
+ *
+ * The tensor map is the address of a CUtensorMap in global memory that describes the tensor
+ * and the tile, and coord_i is the coordinate of the tile along the i-th innermost dimension.
+ */
+TVM_DLL const Op& ptx_cp_async_bulk_tensor();
+
+/*!
+ * \brief tvm intrinsic for ptx warpgroup mma instructions using wgmma.mma_async, whose
+ *        multiplicands are read from shared memory through matrix descriptors.
+ *
+ * void ptx_wgmma_mma_async(StringImm shape, StringImm A_dtype, StringImm B_dtype,
+ *                          StringImm C_dtype, Var a_smem, Expr a_offset,
+ *                          Var b_smem, Expr b_offset, Var accumulator, Expr c_index,
+ *                          bool trans_a, bool trans_b, int swizzle_bytes,
+ *                          Expr leading_byte_offset, Expr stride_byte_offset);
+ */
+TVM_DLL const Op& ptx_wgmma_mma_async();
+
+/*!
+ * \brief tvm intrinsics for the ordering and completion of ptx warpgroup mma instructions.
+ *
+ * void ptx_wgmma_fence();
+ * void ptx_wgmma_commit_group();
+ * void ptx_wgmma_wait_group(int num);
+ */
+TVM_DLL const Op& ptx_wgmma_fence();
+TVM_DLL const Op& ptx_wgmma_commit_group();
+TVM_DLL const Op& ptx_wgmma_wait_group();
+
 /*!
  * \brief tvm intrinsic for storing the result of PTX MMA into a destination pointer.
  *        For example, if each thread in a warp of size 32 has 4 elements from the result of
@@ -816,6 +851,34 @@ TVM_DLL const Op& vectorlow();
  */
 TVM_DLL const Op& vectorcombine();
 
+/*!
+ * \brief Sum the lanes of a vector, in any order of the lanes.
+ *
+ *  Type vector_reduce_add(Type x N vec);
+ */
+TVM_DLL const Op& vector_reduce_add();
+
+/*!
+ * \brief Multiply the lanes of a vector, in any order of the lanes.
+ *
+ *  Type vector_reduce_mul(Type x N vec);
+ */
+TVM_DLL const Op& vector_reduce_mul();
+
+/*!
+ * \brief Get the maximum of the lanes of a vector.
+ *
+ *  Type vector_reduce_max(Type x N vec);
+ */
+TVM_DLL const Op& vector_reduce_max();
+
+/*!
+ * \brief Get the minimum of the lanes of a vector.
+ *
+ *  Type vector_reduce_min(Type x N vec);
+ */
+TVM_DLL const Op& vector_reduce_min();
+
 /*!
  * \brief atomic add instruction, corresponding e.g. to atomicAdd in CUDA
  */
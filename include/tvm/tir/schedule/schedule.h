@@ -418,7 +418,8 @@ class ScheduleNode : public runtime::Object {
    * 2) All the blocks under the loop are complete blocks or reduction blocks, and have affine
    * bindings
    * 3) For each block under the loop, the loop can only be contained in data-parallel block iters'
-   * bindings
+   * bindings, or in reduction block iters' bindings of a block that reduces into a single buffer
+   * with a commutative reducer
    * \param loop_rv The loop to be vectorized
    */
   virtual void Vectorize(const LoopRV& loop_rv) = 0;
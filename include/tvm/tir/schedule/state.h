@@ -24,6 +24,8 @@
 #define TVM_TIR_SCHEDULE_STATE_H_
 
 #include <tvm/ir/module.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/tir/block_scope.h>
 #include <tvm/tir/function.h>
 
@@ -107,6 +109,13 @@ class ScheduleStateNode : public Object {
   std::unordered_map<StmtSRef, BlockInfo, ObjectPtrHash, ObjectPtrEqual> block_info;
   /*! \brief The reverse mapping from block/for-loop to their corresponding srefs */
   std::unordered_map<const StmtNode*, StmtSRef> stmt2ref;
+  /*!
+   * \brief The memo of the affine binding checks of the blocks, keyed by the tuple of the binding
+   * values, the domains of the outer loops and the predicate, since the checks are redone for
+   * every block under the replaced statement each time after calling the Replace method.
+   */
+  std::unordered_map<Array<ObjectRef>, bool, StructuralHash, StructuralEqual>
+      affine_binding_cache;
   /*!
    * \brief Do extra correctness checking after the class creation
    * and each time after calling the Replace method.
@@ -122,6 +131,7 @@ class ScheduleStateNode : public Object {
     v->Visit("mod", &mod);
     // `block_info` is not visited
     // `stmt2ref` is not visited
+    // `affine_binding_cache` is not visited
     v->Visit("debug_mask", &debug_mask);
     v->Visit("enable_check", &enable_check);
   }
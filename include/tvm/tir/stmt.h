@@ -1563,6 +1563,12 @@ constexpr const char* script_parsing_detect_access = "tir.script_parsing_detect_
  */
 constexpr const char* pragma_loop_partition_hint = "pragma_loop_partition_hint";
 
+/*!
+ * \brief Mark that a serial loop was vectorized in the schedule, but kept serial as the
+ *  vectorization is disabled. Source backends may still hint the loop to the downstream compiler.
+ */
+constexpr const char* vectorize_hint = "vectorize_hint";
+
 /*! \brief Mark the stage of a statement in the software pipeline */
 constexpr const char* software_pipeline_stage = "software_pipeline_stage";
 
@@ -1575,6 +1581,18 @@ constexpr const char* software_pipeline_order = "software_pipeline_order";
  */
 constexpr const char* software_pipeline_async_stages = "software_pipeline_async_stages";
 
+/*!
+ * \brief Mark that a loop prefetches the global buffers that it reads, the given number of
+ * iterations ahead. A distance of 0 prefetches nothing.
+ */
+constexpr const char* software_prefetch_distance = "software_prefetch_distance";
+
+/*!
+ * \brief The temporal locality of the prefetches of a loop marked by `software_prefetch_distance`,
+ * from 0 (no temporal locality) to 3 (keep in all levels of cache), which is 3 by default.
+ */
+constexpr const char* software_prefetch_locality = "software_prefetch_locality";
+
 /*! \brief Mark the buffers which is const access and can be transformed layout. */
 constexpr const char* layout_free_buffers = "layout_free_buffers";
 
@@ -1661,6 +1679,12 @@ constexpr const char* vector_bytes = "vector_bytes";
  */
 constexpr const char* warp_execution = "warp_execution";
 
+/*!
+ * \brief Mark whether the shared memory buffers written by a block are padded against the bank
+ * conflicts of their accesses, \sa tir::transform::InjectSharedMemoryPadding.
+ */
+constexpr const char* pad_shared_memory = "pad_shared_memory";
+
 /*! \brief Mark that a block is disallowed in auto inline. */
 constexpr const char* meta_schedule_inline_rule = "meta_schedule.inline_rule";
 
@@ -554,6 +554,17 @@ TVM_DLL Pass LowerMatchBuffer();
  */
 TVM_DLL Pass InjectPermutedLayout();
 
+/*!
+ * \brief Pad the rows of the shared memory buffers to reduce the bank conflicts of the accesses of
+ * the warps, choosing the stride of the rows from the indices accessed by the lanes of a warp.
+ *
+ * A buffer is padded if the block writing it is annotated with pad_shared_memory, or by the
+ * PassContext config tir.pad_shared_memory otherwise.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSharedMemoryPadding();
+
 /*!
  * \brief Transform Mma scope (m16n8k8.matrixA/B/C) to local scope with layout transformation.
  * \return The pass.
@@ -73,6 +73,28 @@ Array<PrimExpr> InferEinsumShape(const std::string& subscripts,
 Tensor einsum(const std::string& subscripts_str, const Array<Tensor> inputs,
               std::string name = "T_einsum", std::string tag = kEinsum);
 
+/*!
+ * \brief A pairwise contraction in the evaluation of an einsum of more than two operands. The
+ * operands at `lhs` and `rhs` of the current list of operands are removed from it, and the
+ * result of the two-operand einsum `equation` on them is appended to it.
+ */
+struct EinsumContraction {
+  int lhs;
+  int rhs;
+  std::string equation;
+};
+
+/*!
+ * \brief Find the order in which to contract the operands of an einsum pairwise, with the fewest
+ * multiply-adds. The order is searched exhaustively for up to 5 operands, and greedily otherwise.
+ * \param subscripts_str The subscripts of the einsum.
+ * \param input_shapes The shapes of the operands.
+ * \return The pairwise contractions, or an empty list for an einsum of at most two operands or
+ * with an ellipsis, which is evaluated as a whole.
+ */
+std::vector<EinsumContraction> EinsumContractionPath(const std::string& subscripts_str,
+                                                     const Array<Array<PrimExpr>>& input_shapes);
+
 struct EinsumEquation {
   /*!
    * \brief Create EinsumEquation from a string.
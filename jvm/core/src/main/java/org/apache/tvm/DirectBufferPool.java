@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.apache.tvm;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayDeque;
+import java.util.HashMap;
+import java.util.Map;
+
+/**
+ * A pool of off-heap direct buffers, aligned as TVM requires the data of an NDArray to be,
+ * so that the inputs and outputs can be transferred without allocating a buffer per request.
+ * The buffers are pooled by the size rounded up to a power of two.
+ */
+public class DirectBufferPool {
+  /** The alignment of the buffers, the alignment TVM allocates the NDArrays with. */
+  public static final int ALIGNMENT = 64;
+  private static final int MIN_POOLED_BYTES = 4096;
+  private static final int MAX_POOLED_BYTES = 1 << 30;
+
+  private final int maxBuffersPerSize;
+  private final Map<Integer, ArrayDeque<ByteBuffer>> freeBuffers =
+      new HashMap<Integer, ArrayDeque<ByteBuffer>>();
+
+  /**
+   * Create a pool.
+   * @param maxBuffersPerSize The number of free buffers kept for each size, the buffers returned
+   *                          beyond it are left to the GC.
+   */
+  public DirectBufferPool(int maxBuffersPerSize) {
+    this.maxBuffersPerSize = maxBuffersPerSize;
+  }
+
+  /**
+   * Create a pool keeping 8 free buffers for each size.
+   */
+  public DirectBufferPool() {
+    this(8);
+  }
+
+  /**
+   * Take a buffer of the given number of bytes from the pool, or allocate one if there is none.
+   * The buffer is little endian, aligned to {@link #ALIGNMENT} bytes, and its content undefined.
+   * @param nbytes The number of bytes.
+   * @return The buffer, whose position is zero and limit is nbytes.
+   */
+  public ByteBuffer acquire(int nbytes) {
+    int sizeClass = sizeClass(nbytes);
+    ByteBuffer buffer = null;
+    synchronized (this) {
+      ArrayDeque<ByteBuffer> buffers = freeBuffers.get(sizeClass);
+      if (buffers != null) {
+        buffer = buffers.poll();
+      }
+    }
+    if (buffer == null) {
+      buffer = allocateAligned(sizeClass);
+    }
+    buffer.clear();
+    buffer.limit(nbytes);
+    return buffer;
+  }
+
+  /**
+   * Return a buffer taken by {@link #acquire(int)} to the pool. The buffer must not be used
+   * afterwards, including by the NDArrays viewing it, which must be released before.
+   * @param buffer The buffer.
+   */
+  public void release(ByteBuffer buffer) {
+    int sizeClass = buffer.capacity();
+    synchronized (this) {
+      ArrayDeque<ByteBuffer> buffers = freeBuffers.get(sizeClass);
+      if (buffers == null) {
+        buffers = new ArrayDeque<ByteBuffer>();
+        freeBuffers.put(sizeClass, buffers);
+      }
+      if (buffers.size() < maxBuffersPerSize) {
+        buffers.push(buffer);
+      }
+    }
+  }
+
+  /**
+   * Drop all the free buffers, which the GC then frees.
+   */
+  public synchronized void clear() {
+    freeBuffers.clear();
+  }
+
+  private static int sizeClass(int nbytes) {
+    if (nbytes <= MIN_POOLED_BYTES) {
+      return MIN_POOLED_BYTES;
+    }
+    if (nbytes > MAX_POOLED_BYTES) {
+      throw new IllegalArgumentException(
+          "Cannot pool a buffer of " + nbytes + " bytes, at most " + MAX_POOLED_BYTES);
+    }
+    int sizeClass = Integer.highestOneBit(nbytes);
+    return sizeClass == nbytes ? sizeClass : sizeClass << 1;
+  }
+
+  private static ByteBuffer allocateAligned(int capacity) {
+    ByteBuffer raw = ByteBuffer.allocateDirect(capacity + ALIGNMENT);
+    long address = Base._LIB.tvmDirectBufferAddress(raw);
+    int offset = (int) ((ALIGNMENT - address % ALIGNMENT) % ALIGNMENT);
+    raw.position(offset);
+    raw.limit(offset + capacity);
+    ByteBuffer buffer = raw.slice();
+    buffer.order(ByteOrder.LITTLE_ENDIAN);
+    return buffer;
+  }
+}
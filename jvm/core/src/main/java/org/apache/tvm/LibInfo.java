@@ -17,6 +17,7 @@
 
 package org.apache.tvm;
 
+import java.nio.ByteBuffer;
 import java.util.List;
 
 class LibInfo {
@@ -71,6 +72,15 @@ class LibInfo {
 
   native int tvmArrayCopyToJArray(long from, byte[] to);
 
+  native int tvmArrayCopyFromDirectBuffer(ByteBuffer from, long offset, long nbytes, long to);
+
+  native int tvmArrayCopyToDirectBuffer(long from, ByteBuffer to, long offset, long nbytes);
+
+  native int tvmArrayFromDirectBuffer(ByteBuffer buffer, long offset, long[] shape,
+      int dtypeCode, int dtypeBits, int dtypeLanes, Base.RefLong refHandle);
+
+  native long tvmDirectBufferAddress(ByteBuffer buffer);
+
   // Device
   native int tvmSynchronize(int deviceType, int deviceId);
 }
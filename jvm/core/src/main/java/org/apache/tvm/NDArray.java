@@ -185,6 +185,51 @@ public class NDArray extends NDArrayBase {
     tmpArr.release();
   }
 
+  /**
+   * Copy from the remaining bytes of a byte buffer, which must be as many as the bytes of the
+   * array. A direct buffer is copied without any intermediate copy on the Java heap.
+   * The position of the buffer is not changed.
+   * @param source the source data
+   */
+  public void copyFrom(ByteBuffer source) {
+    long nbytes = checkBufferSize(source);
+    if (!source.isDirect()) {
+      byte[] raw = new byte[(int) nbytes];
+      source.duplicate().get(raw);
+      copyFromRaw(raw);
+      return;
+    }
+    Base.checkCall(Base._LIB.tvmArrayCopyFromDirectBuffer(
+        source, source.position(), nbytes, handle));
+  }
+
+  /**
+   * Copy to the remaining bytes of a byte buffer, which must be as many as the bytes of the
+   * array. A direct buffer is copied into without any intermediate copy on the Java heap.
+   * The position of the buffer is not changed.
+   * @param target the target buffer
+   * @return target
+   */
+  public ByteBuffer copyTo(ByteBuffer target) {
+    long nbytes = checkBufferSize(target);
+    if (!target.isDirect()) {
+      target.duplicate().put(internal());
+      return target;
+    }
+    Base.checkCall(Base._LIB.tvmArrayCopyToDirectBuffer(
+        handle, target, target.position(), nbytes));
+    return target;
+  }
+
+  private long checkBufferSize(ByteBuffer buffer) {
+    long nbytes = size() * dtype.numOfBytes;
+    if (buffer.remaining() != nbytes) {
+      throw new IllegalArgumentException(
+          String.format("Buffer size not match: %d v.s. %d bytes", buffer.remaining(), nbytes));
+    }
+    return nbytes;
+  }
+
   /**
    * Get shape of current NDArray.
    * @return an array representing shape of current ndarray
@@ -414,6 +459,40 @@ public class NDArray extends NDArrayBase {
     return empty(shape, new TVMType("float32", 1), dev);
   }
 
+  /**
+   * Create a cpu array viewing the remaining bytes of a direct byte buffer, without copying them.
+   * The buffer is kept alive until the array is released, and the writes through either of them
+   * are seen by the other. Its position must be aligned to 64 bytes, as the buffers of
+   * {@link DirectBufferPool} are.
+   * @param buffer The direct buffer holding the data.
+   * @param shape The shape of the array.
+   * @param dtype The data type of the array.
+   * @return The array viewing the buffer.
+   */
+  public static NDArray fromDirectBuffer(ByteBuffer buffer, long[] shape, TVMType dtype) {
+    if (!buffer.isDirect()) {
+      throw new IllegalArgumentException("Only a direct buffer can be viewed by an NDArray");
+    }
+    long nbytes = dtype.numOfBytes;
+    for (long dim : shape) {
+      nbytes *= dim;
+    }
+    if (buffer.remaining() != nbytes) {
+      throw new IllegalArgumentException(
+          String.format("Buffer size not match: %d v.s. %d bytes", buffer.remaining(), nbytes));
+    }
+    long address = Base._LIB.tvmDirectBufferAddress(buffer) + buffer.position();
+    if (address % DirectBufferPool.ALIGNMENT != 0) {
+      throw new IllegalArgumentException(
+          "The data of a direct buffer must be aligned to " + DirectBufferPool.ALIGNMENT
+          + " bytes to be viewed by an NDArray");
+    }
+    Base.RefLong refHandle = new Base.RefLong();
+    Base.checkCall(Base._LIB.tvmArrayFromDirectBuffer(
+        buffer, buffer.position(), shape, dtype.typeCode, dtype.bits, dtype.lanes, refHandle));
+    return new NDArray(refHandle.value, false, dtype, Device.cpu(0));
+  }
+
   private static ByteBuffer wrapBytes(byte[] bytes) {
     ByteBuffer bb = ByteBuffer.wrap(bytes);
     bb.order(ByteOrder.LITTLE_ENDIAN);
@@ -35,6 +35,7 @@ public class GraphModule {
   private Device device;
 
   private Function fsetInput;
+  private Function fsetInputZeroCopy;
   private Function frun;
   private Function fgetOutput;
   private Function fgetInput;
@@ -45,6 +46,7 @@ public class GraphModule {
     this.module = module;
     this.device = dev;
     fsetInput = module.getFunction("set_input");
+    fsetInputZeroCopy = module.getFunction("set_input_zero_copy");
     frun = module.getFunction("run");
     fgetInput = module.getFunction("get_input");
     fgetOutput = module.getFunction("get_output");
@@ -64,6 +66,7 @@ public class GraphModule {
    */
   public void release() {
     fsetInput.release();
+    fsetInputZeroCopy.release();
     frun.release();
     fgetInput.release();
     fgetOutput.release();
@@ -106,6 +109,30 @@ public class GraphModule {
     return this;
   }
 
+  /**
+   * Set inputs to the module without copying them, the module reads the data of the array when
+   * it runs. The array must be on the device of the module, such as an array viewing a direct
+   * buffer by {@link NDArray#fromDirectBuffer} on cpu, and be kept alive while the module uses it.
+   * @param key The input key.
+   * @param value The input value.
+   * @return self.
+   */
+  public GraphModule setInputZeroCopy(String key, NDArray value) {
+    fsetInputZeroCopy.pushArg(key).pushArg(value).invoke();
+    return this;
+  }
+
+  /**
+   * Set inputs to the module without copying them, see {@link #setInputZeroCopy(String, NDArray)}.
+   * @param key The input key.
+   * @param value The input value.
+   * @return self.
+   */
+  public GraphModule setInputZeroCopy(int key, NDArray value) {
+    fsetInputZeroCopy.pushArg(key).pushArg(value).invoke();
+    return this;
+  }
+
   /**
    * Run forward execution of the graph.
    * @return self.
@@ -19,6 +19,9 @@ package org.apache.tvm;
 
 import org.junit.Test;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
 import static org.junit.Assert.*;
 
 public class NDArrayTest {
@@ -77,4 +80,36 @@ public class NDArrayTest {
     assertArrayEquals(new char[]{65535, 2, 3, 4}, ndarray.asCharArray());
     ndarray.release();
   }
+
+  @Test
+  public void test_copy_direct_buffer() {
+    NDArray ndarray = NDArray.empty(new long[]{2, 2}, new TVMType("float32"));
+    ByteBuffer source = ByteBuffer.allocateDirect(16).order(ByteOrder.LITTLE_ENDIAN);
+    source.asFloatBuffer().put(new float[]{1, 2, 3, 4});
+    ndarray.copyFrom(source);
+    assertArrayEquals(new float[]{1f, 2f, 3f, 4f}, ndarray.asFloatArray(), 1e-3f);
+
+    ByteBuffer target = ByteBuffer.allocateDirect(16).order(ByteOrder.LITTLE_ENDIAN);
+    ndarray.copyTo(target);
+    float[] result = new float[4];
+    target.asFloatBuffer().get(result);
+    assertArrayEquals(new float[]{1f, 2f, 3f, 4f}, result, 1e-3f);
+    ndarray.release();
+  }
+
+  @Test
+  public void test_from_direct_buffer() {
+    DirectBufferPool pool = new DirectBufferPool();
+    ByteBuffer buffer = pool.acquire(16);
+    NDArray ndarray = NDArray.fromDirectBuffer(buffer, new long[]{2, 2}, new TVMType("float32"));
+    buffer.asFloatBuffer().put(new float[]{1, 2, 3, 4});
+    // The array views the buffer, so the writes to the buffer are seen without a copy.
+    assertArrayEquals(new float[]{1f, 2f, 3f, 4f}, ndarray.asFloatArray(), 1e-3f);
+    ndarray.copyFrom(new float[]{5, 6, 7, 8});
+    assertEquals(5f, buffer.getFloat(0), 1e-3f);
+    ndarray.release();
+    pool.release(buffer);
+    assertSame(buffer, pool.acquire(16));
+    pool.clear();
+  }
 }
@@ -462,6 +462,76 @@ JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayCopyToJArray(JNIEnv*
   return ret;
 }
 
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayCopyFromDirectBuffer(
+    JNIEnv* env, jobject obj, jobject jbuffer, jlong joffset, jlong jnbytes, jlong jto) {
+  char* data = static_cast<char*>(env->GetDirectBufferAddress(jbuffer));
+  return TVMArrayCopyFromBytes(reinterpret_cast<TVMArrayHandle>(jto), data + joffset,
+                               static_cast<size_t>(jnbytes));
+}
+
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayCopyToDirectBuffer(
+    JNIEnv* env, jobject obj, jlong jfrom, jobject jbuffer, jlong joffset, jlong jnbytes) {
+  char* data = static_cast<char*>(env->GetDirectBufferAddress(jbuffer));
+  return TVMArrayCopyToBytes(reinterpret_cast<TVMArrayHandle>(jfrom), data + joffset,
+                             static_cast<size_t>(jnbytes));
+}
+
+// The context of an NDArray viewing a direct buffer, which keeps the buffer alive.
+struct DirectBufferTensorContext {
+  jobject buffer;
+  std::vector<int64_t> shape;
+};
+
+static void DirectBufferTensorDeleter(DLManagedTensor* tensor) {
+  auto* ctx = static_cast<DirectBufferTensorContext*>(tensor->manager_ctx);
+  JNIEnv* env;
+  int jniStatus = _jvm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+  if (jniStatus == JNI_EDETACHED) {
+    _jvm->AttachCurrentThread(JNIEnvPtrHelper(&env), nullptr);
+  }
+  env->DeleteGlobalRef(ctx->buffer);
+  delete ctx;
+  delete tensor;
+}
+
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayFromDirectBuffer(
+    JNIEnv* env, jobject obj, jobject jbuffer, jlong joffset, jlongArray jshape, jint jdtypeCode,
+    jint jdtypeBits, jint jdtypeLanes, jobject jret) {
+  auto* ctx = new DirectBufferTensorContext();
+  ctx->buffer = env->NewGlobalRef(jbuffer);
+  ctx->shape.resize(env->GetArrayLength(jshape));
+  env->GetLongArrayRegion(jshape, 0, static_cast<jsize>(ctx->shape.size()),
+                          reinterpret_cast<jlong*>(ctx->shape.data()));
+
+  auto* tensor = new DLManagedTensor();
+  tensor->dl_tensor.data = static_cast<char*>(env->GetDirectBufferAddress(jbuffer)) + joffset;
+  tensor->dl_tensor.device = DLDevice{kDLCPU, 0};
+  tensor->dl_tensor.ndim = static_cast<int>(ctx->shape.size());
+  tensor->dl_tensor.dtype.code = static_cast<uint8_t>(jdtypeCode);
+  tensor->dl_tensor.dtype.bits = static_cast<uint8_t>(jdtypeBits);
+  tensor->dl_tensor.dtype.lanes = static_cast<uint16_t>(jdtypeLanes);
+  tensor->dl_tensor.shape = ctx->shape.data();
+  tensor->dl_tensor.strides = nullptr;
+  tensor->dl_tensor.byte_offset = 0;
+  tensor->manager_ctx = ctx;
+  tensor->deleter = DirectBufferTensorDeleter;
+
+  TVMArrayHandle out;
+  int ret = TVMArrayFromDLPack(tensor, &out);
+  if (ret != 0) {
+    DirectBufferTensorDeleter(tensor);
+    return ret;
+  }
+  setLongField(env, jret, reinterpret_cast<jlong>(out));
+  return ret;
+}
+
+JNIEXPORT jlong JNICALL Java_org_apache_tvm_LibInfo_tvmDirectBufferAddress(JNIEnv* env,
+                                                                           jobject obj,
+                                                                           jobject jbuffer) {
+  return reinterpret_cast<jlong>(env->GetDirectBufferAddress(jbuffer));
+}
+
 // Device
 JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmSynchronize(JNIEnv* env, jint deviceType,
                                                                   jint deviceId) {
@@ -558,6 +558,24 @@ class Device(ctypes.Structure):
         """
         return self._GetDeviceAttr(self.device_type, self.device_id, 15)
 
+    @property
+    def peer_topology(self):
+        """Return the links of the device to the other devices of the same type.
+
+        Supported devices include CUDA, where NVLink is told from PCIe by the support of the
+        native atomics between the devices.
+
+        Returns
+        -------
+        peer_topology : List[Dict[str, Any]] or None
+            One dict for each other device, with the fields "device_id", "access" (whether the
+            device can access the memory of the peer), "link" ("nvlink", "pcie" or "none") and
+            "performance_rank" (lower is faster).
+            Return None if the device does not support this feature.
+        """
+        topology = self._GetDeviceAttr(self.device_type, self.device_id, 16)
+        return None if topology is None else json.loads(topology)
+
     def texture_spatial_limit(self):
         """Returns limits for textures by spatial dimensions
 
@@ -25,6 +25,7 @@ from .int_set import (
     estimate_region_upper_bound,
 )
 from .analyzer import ModularSet, ConstIntBound, Analyzer, ProofStrength, Extension
+from .analyzer import simplify_cache_stats, reset_simplify_cache_stats
 from .bound import deduce_bound
 from .pattern import detect_linear_equation, detect_clip_bound, detect_common_subexpr
 from .int_solver import solve_linear_equations, solve_linear_inequalities
@@ -122,6 +122,8 @@ class Analyzer:
         self._can_prove = _mod("can_prove")
         self._get_enabled_extensions = _mod("get_enabled_extensions")
         self._set_enabled_extensions = _mod("set_enabled_extensions")
+        self._enable_simplify_cache = _mod("enable_simplify_cache")
+        self._get_simplify_cache_stats = _mod("get_simplify_cache_stats")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -195,6 +197,25 @@ class Analyzer:
     def reset_rewrite_simplify_stats(self):
         self._reset_rewrite_simplify_stats()
 
+    def enable_simplify_cache(self, enable=True):
+        """Enable or disable the memoization of simplify.
+
+        The structurally equal expressions are then simplified once within the
+        same constraint scope. The analyzers created in C++ enable it when the
+        pass config "arith.enable_simplify_cache" is set.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to memoize the results of simplify.
+        """
+        self._enable_simplify_cache(enable)
+
+    @property
+    def simplify_cache_stats(self):
+        """The "hits" and "misses" counters of the memoization of simplify."""
+        return self._get_simplify_cache_stats()
+
     def canonical_simplify(self, expr):
         """Simplify expression via canonicalization.
 
@@ -345,3 +366,20 @@ class Analyzer:
         """
         flags = Extension(flags).value
         self._set_enabled_extensions(flags)
+
+
+def simplify_cache_stats():
+    """Return the "hits" and "misses" counters of the memoization of simplify,
+    summed over all the analyzers of the process.
+
+    Returns
+    -------
+    stats : Dict[str, int]
+        The counters.
+    """
+    return {k: int(v) for k, v in _ffi_api.GetSimplifyCacheStats().items()}
+
+
+def reset_simplify_cache_stats():
+    """Reset the process wide counters of the memoization of simplify."""
+    _ffi_api.ResetSimplifyCacheStats()
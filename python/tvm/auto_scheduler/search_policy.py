@@ -181,6 +181,7 @@ class SketchPolicy(SearchPolicy):
         "retry_search_one_round_on_empty": 1,
         "sample_init_min_population": 50,
         "sample_init_use_measured_ratio": 0.2,
+        "sample_init_use_similar_task_ratio": 0.05,
         "evolutionary_search_population": 2048,
         "evolutionary_search_num_iters": 4,
         "evolutionary_search_mutation_prob": 0.85,
@@ -254,6 +255,25 @@ class SketchPolicy(SearchPolicy):
         states = _ffi_api.SketchPolicySampleInitialPopulation(self)
         return states
 
+    def sample_similar_task_states(self, num_states):
+        """Transfer the best measured states of the tasks with the same compute DAG structure as
+        this task, which were searched in this process, to this task.
+        This python interface is mainly used for debugging and testing.
+        The actual search is all done in c++.
+
+        Parameters
+        ----------
+        num_states : int
+            The maximum number of states to transfer
+
+        Returns
+        -------
+        states: List[State]
+            The transferred states
+        """
+        states = _ffi_api.SketchPolicySampleSimilarTaskStates(self, num_states)
+        return states
+
     def evolutionary_search(self, init_populations, out_size):
         """Perform evolutionary search.
         This python interface is mainly used for debugging and testing.
@@ -273,3 +293,8 @@ class SketchPolicy(SearchPolicy):
         """
         states = _ffi_api.SketchPolicyEvolutionarySearch(self, init_populations, out_size)
         return states
+
+
+def clear_similar_task_state_cache():
+    """Clear the measured states shared between the similar tasks searched in this process."""
+    _ffi_api.ClearSimilarTaskStateCache()
@@ -0,0 +1,117 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Build the functions of a module for several CPU targets into one module, which runs the best
+variant the host CPU supports.
+
+The variant of each target is built with the symbols of its functions suffixed, so all the
+variants link into one library. The returned `cpu_dispatch` module imports the variants, and at
+load time selects the first variant, in the order of the most required features, whose x86
+features the host CPU has.
+"""
+import tvm
+from tvm import tir
+from tvm.target import Target
+from tvm.target.codegen import llvm_get_cpu_features
+
+
+def host_features():
+    """Return the x86 features of the host CPU which the dispatch detects.
+
+    Returns
+    -------
+    features : set of str
+        The features of the host CPU, by their names in LLVM.
+    """
+    return set(str(f) for f in tvm.get_global_func("runtime.HostCPUFeatures")())
+
+
+def required_features(target):
+    """Return the x86 features of a target which the dispatch checks on the host CPU.
+
+    Parameters
+    ----------
+    target : Union[str, Target]
+        The LLVM target.
+
+    Returns
+    -------
+    features : List[str]
+        The sorted features of the target, by their names in LLVM.
+    """
+    known_features = set(str(f) for f in tvm.get_global_func("runtime.CPUDispatchFeatures")())
+    return sorted(known_features & set(str(f) for f in llvm_get_cpu_features(Target(target))))
+
+
+def _suffix_symbols(mod, suffix):
+    functions = {}
+    for gvar, func in mod.functions.items():
+        if isinstance(func, tir.PrimFunc):
+            symbol = gvar.name_hint
+            if func.attrs is not None and "global_symbol" in func.attrs:
+                symbol = func.attrs["global_symbol"]
+            func = func.with_attr("global_symbol", symbol + suffix)
+        functions[gvar] = func
+    return tvm.IRModule(functions, attrs=mod.attrs)
+
+
+def build(mod, targets):
+    """Build a module for several CPU targets, and dispatch to the best of them at load time.
+
+    Parameters
+    ----------
+    mod : Union[tvm.IRModule, tvm.tir.PrimFunc]
+        The module to build.
+
+    targets : List[Union[str, Target]]
+        The LLVM targets to build the module for, such as "llvm -mcpu=haswell" and
+        "llvm -mcpu=sapphirerapids". A target without x86 features serves as the fallback.
+
+    Returns
+    -------
+    module : tvm.runtime.Module
+        The `cpu_dispatch` module, whose functions are those of the selected variant.
+    """
+    if isinstance(mod, tir.PrimFunc):
+        name = "main"
+        if mod.attrs is not None and "global_symbol" in mod.attrs:
+            name = mod.attrs["global_symbol"]
+        mod = tvm.IRModule({name: mod.with_attr("global_symbol", name)})
+    variants = []
+    for target in targets:
+        target = Target(target)
+        assert target.kind.name == "llvm", f"Only LLVM targets can be dispatched, but got {target}"
+        variants.append((target, required_features(target)))
+    # The variants requiring more features come first, as they are faster where they run.
+    variants.sort(key=lambda variant: -len(variant[1]))
+
+    suffixes = [f"_cpu_variant{i}" for i in range(len(variants))]
+    libs = [
+        tvm.build(_suffix_symbols(mod, suffix), target=target)
+        for suffix, (target, _) in zip(suffixes, variants)
+    ]
+    dispatch = tvm.get_global_func("runtime.CPUDispatchModuleCreate")(
+        suffixes, [features for _, features in variants]
+    )
+    for lib in libs:
+        dispatch.import_module(lib)
+    return dispatch
+
+
+def selected_variant(mod):
+    """Return the index of the variant a `cpu_dispatch` module selected, in the order of the most
+    required features first."""
+    return tvm.get_global_func("runtime.CPUDispatchModuleSelected")(mod)
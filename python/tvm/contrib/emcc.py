@@ -24,7 +24,7 @@ from tvm._ffi.base import py_str
 from tvm._ffi.libinfo import find_lib_path
 
 
-def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None):
+def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None, threads=False):
     """Create wasm that is supposed to run with the tvmjs.
 
     Parameters
@@ -43,6 +43,11 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None):
 
     libs : list
         List of user-defined library files (e.g. .bc files) to add into the wasm.
+
+    threads : bool, optional
+        Whether to link the threaded runtime built by `make threads`, which runs the parallel
+        loops on a pool of web workers over shared memory. The page needs to be cross-origin
+        isolated to use the shared memory.
     """
     cmd = [cc]
     cmd += ["-O3"]
@@ -61,20 +66,24 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None):
     cmd += ["-s", "STANDALONE_WASM=1"]
     cmd += ["-s", "ALLOW_MEMORY_GROWTH=1"]
     cmd += ["-s", "TOTAL_MEMORY=160MB"]
+    if threads:
+        cmd += ["-pthread"]
+        cmd += ["-s", "PTHREAD_POOL_SIZE=navigator.hardwareConcurrency"]
 
     objects = [objects] if isinstance(objects, str) else objects
 
+    suffix = "_threads.bc" if threads else ".bc"
     with_runtime = False
     for obj in objects:
-        if obj.find("wasm_runtime.bc") != -1:
+        if obj.find("wasm_runtime") != -1:
             with_runtime = True
 
     all_libs = []
     if not with_runtime:
-        all_libs += [find_lib_path("wasm_runtime.bc")[0]]
+        all_libs += [find_lib_path("wasm_runtime" + suffix)[0]]
 
-    all_libs += [find_lib_path("tvmjs_support.bc")[0]]
-    all_libs += [find_lib_path("webgpu_runtime.bc")[0]]
+    all_libs += [find_lib_path("tvmjs_support" + suffix)[0]]
+    all_libs += [find_lib_path("webgpu_runtime" + suffix)[0]]
 
     if libs:
         if not isinstance(libs, list):
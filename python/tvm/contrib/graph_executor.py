@@ -66,6 +66,41 @@ def create(graph_json_str, libmod, device):
     return GraphModule(fcreate(graph_json_str, libmod, *device_type_id))
 
 
+def create_multi_profile(graph_json_strs, libmods, device, params=None):
+    """Create a runtime executor module over several profiles of a graph, e.g. the builds of
+    a model for several batch sizes, which share one set of parameters.
+
+    The storage of a profile is allocated the first time it is used. Setting an input selects
+    the profile whose input has the shape of the given data.
+
+    Parameters
+    ----------
+    graph_json_strs : List[str]
+        The graph of each profile in json format.
+
+    libmods : List[tvm.runtime.Module]
+        The module of the functions of each profile.
+
+    device : Device or list of Device
+        The device to deploy the module.
+
+    params : Optional[Dict[str, NDArray]]
+        The parameters shared by the profiles.
+
+    Returns
+    -------
+    graph_module : MultiProfileGraphModule
+        Runtime graph module that can be used to execute the profiles.
+    """
+    assert len(graph_json_strs) == len(libmods)
+    dev, _, device_type_id = get_device(libmods[0], device)
+    fcreate = tvm._ffi.get_global_func("tvm.graph_executor.create_multi_profile")
+    module = MultiProfileGraphModule(fcreate(graph_json_strs, libmods, *device_type_id))
+    if params:
+        module.load_params(tvm.runtime.save_param_dict(params))
+    return module
+
+
 def get_device(libmod, device):
     """Parse and validate all the device(s).
 
@@ -177,6 +212,8 @@ class GraphModule(object):
         self._get_num_inputs = module["get_num_inputs"]
         self._load_params = module["load_params"]
         self._share_params = module["share_params"]
+        self._load_params_from_file = module["load_params_from_file"]
+        self._load_shared_params = module["load_shared_params"]
 
     def set_input(self, key=None, value=None, **params):
         """Set inputs to the module via kwargs
@@ -263,6 +300,118 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def run_parallel(self, num_workers=4, **input_dict):
+        """Run forward execution of the graph, with the operators that do not depend on each
+        other running concurrently. The operators of a CPU graph run on a number of threads, and
+        the operators of a device graph are issued on a number of streams.
+
+        Parameters
+        ----------
+        num_workers: int
+            The number of threads or streams.
+
+        input_dict: dict of str to NDArray
+            List of input values to be feed to
+        """
+        if input_dict:
+            self.set_input(**input_dict)
+        self.module["run_parallel"](num_workers)
+
+    def enable_sampling_profiler(self, sample_interval=100):
+        """Time the operators of one in ``sample_interval`` runs, with no synchronization of the
+        device, so that it can stay on in production. The timers of a sampled run are read at the
+        next sampled run of the same thread.
+
+        Parameters
+        ----------
+        sample_interval: int
+            The number of runs per sampled run, or 0 to turn the sampling off.
+        """
+        self.module["enable_sampling_profiler"](sample_interval)
+
+    def sampling_report(self):
+        """Get the latency histograms of the operators in the sampled runs.
+
+        Returns
+        -------
+        report: tvm.runtime.profiling.Report
+            The count, total, mean and percentiles of the latency of every operator.
+        """
+        # pylint: disable=import-outside-toplevel
+        from tvm.runtime.profiling import Report
+
+        return Report.from_json(self.module["get_sampling_report"]())
+
+    def init_async(self, num_slots=2):
+        """Set up the staging slots of the asynchronous execution, which overlaps the copies of the
+        inputs and outputs of a request with the execution of the other requests in flight.
+
+        Each slot has its own copies of the inputs and outputs on the device and its own upload
+        and download streams, while the graph runs on a compute stream. Copies from and to pinned
+        host memory, e.g. arrays on ``tvm.cuda_host()``, overlap with the execution. After this
+        call the graph reads its inputs from and writes its outputs to the staging slots, so the
+        synchronous ``set_input`` and ``get_output`` should not be mixed with the asynchronous API.
+
+        Parameters
+        ----------
+        num_slots: int
+            The number of requests that are in flight at a time.
+        """
+        self.module["init_async"](num_slots)
+
+    def set_input_async(self, key, value):
+        """Copy an input of the next request into its staging slot on the upload stream.
+
+        Parameters
+        ----------
+        key : int or str
+            The input key
+
+        value : NDArray
+            The input value, which should stay alive until the request runs.
+        """
+        if not isinstance(value, tvm.nd.NDArray):
+            value = tvm.nd.array(value)
+        self.module["set_input_async"](key, value)
+
+    def run_async(self):
+        """Issue the execution of the next request on the compute stream, once its inputs are
+        uploaded and the downloads of the previous request of its slot are done.
+
+        Returns
+        -------
+        request : int
+            The id of the request, which gets its outputs.
+        """
+        return self.module["run_async"]()
+
+    def get_output_async(self, request, index, out):
+        """Copy an output of a request into out on the download stream of its slot. The copy is
+        complete after ``wait_async(request)``.
+
+        Parameters
+        ----------
+        request : int
+            The id of the request, which should be one of the last ``num_slots`` requests.
+
+        index : int
+            The output index
+
+        out : NDArray
+            The output array container
+        """
+        self.module["get_output_async"](request, index, out)
+
+    def wait_async(self, request):
+        """Wait until the outputs of a request are copied out.
+
+        Parameters
+        ----------
+        request : int
+            The id of the request
+        """
+        self.module["wait_async"](request)
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -371,15 +520,39 @@ class GraphModule(object):
         """
         raise NotImplementedError("Please use debugger.debug_executor as graph_executor instead.")
 
-    def load_params(self, params_bytes):
+    def load_params(self, params_bytes, shared=False):
         """Load parameters from serialized byte array of parameter dict.
 
         Parameters
         ----------
         params_bytes : bytearray
             The serialized parameter dict.
+
+        shared : bool
+            Whether to share the parameters on device with the other executors of the process
+            which load the same parameters on the same devices. Only the first one copies them,
+            and they are freed with the last one. The shared parameters should not be set as
+            inputs afterwards.
         """
-        self._load_params(bytearray(params_bytes))
+        if shared:
+            self._load_shared_params(bytearray(params_bytes))
+        else:
+            self._load_params(bytearray(params_bytes))
+
+    def load_params_from_file(self, path, shared=False):
+        """Load parameters from a file of serialized parameter dict, which is memory-mapped and
+        copied to the devices in parallel.
+
+        Parameters
+        ----------
+        path : str
+            The path of the parameter file, as saved by
+            :py:func:`tvm.runtime.save_param_dict_to_file`.
+
+        shared : bool
+            Whether to share the parameters with the other executors, see :py:meth:`load_params`.
+        """
+        self._load_params_from_file(path, shared)
 
     def share_params(self, other, params_bytes):
         """Share parameters from pre-existing GraphExecutor instance.
@@ -512,3 +685,51 @@ class GraphModule(object):
             cooldown_interval_ms=cooldown_interval_ms,
             repeats_to_cooldown=repeats_to_cooldown,
         )()
+
+
+class MultiProfileGraphModule(GraphModule):
+    """Wrapper runtime module over several profiles of a graph.
+
+    See :py:func:`tvm.contrib.graph_executor.create_multi_profile`.
+    """
+
+    def set_input(self, key=None, value=None, **params):
+        """Set inputs to the module via kwargs, selecting the profile from their shapes
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : the input value.
+           The input value
+
+        params : dict of str to NDArray
+           Additional arguments
+        """
+        if key is not None:
+            params = {key: value, **params}
+        for k, v in params.items():
+            if not isinstance(v, tvm.nd.NDArray):
+                v = tvm.nd.array(v)
+            self._set_input(k, v)
+
+    def select_profile(self, index):
+        """Select a profile of the graph
+
+        Parameters
+        ----------
+        index : int
+            The index of the profile.
+        """
+        self.module["select_profile"](index)
+
+    @property
+    def profile(self):
+        """The index of the selected profile, or -1 before the first selection."""
+        return self.module["get_profile"]()
+
+    @property
+    def num_profiles(self):
+        """The number of profiles of the graph."""
+        return self.module["get_num_profiles"]()
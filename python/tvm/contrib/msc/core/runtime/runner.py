@@ -303,6 +303,36 @@ class BaseRunner(object):
         out_names = [o["name"] for o in self.get_outputs()]
         return msc_utils.format_datas(outputs, out_names, style=ret_type)
 
+    def profile_nodes(
+        self,
+        inputs: Union[List[np.ndarray], Dict[str, np.ndarray]],
+        repeat: int = 10,
+        warm_up: int = 2,
+    ) -> Dict[str, float]:
+        """Profile the latency of each node in the runnable
+
+        Parameters
+        -------
+        inputs: list<data> or dict<str, data>
+            The inputs in list or dict.
+        repeat: int
+            The repeat num for profile.
+        warm_up: int
+            The warm_up num for profile.
+
+        Returns
+        -------
+        latencies: dict<str, float>
+            The average latency of each node in ms.
+        """
+
+        in_names = [i["name"] for i in self.get_inputs()]
+        inputs = msc_utils.format_datas(inputs, in_names, style="dict")
+        for _ in range(warm_up):
+            self._call_runnable(self._runnable, inputs, self._device)
+        latencies = self._profile_nodes(self._runnable, inputs, self._device, repeat)
+        return {name: latency / repeat for name, latency in latencies.items()}
+
     def save_cache(
         self,
         cache_dir: msc_utils.MSCDirectory,
@@ -959,6 +989,30 @@ class BaseRunner(object):
 
         raise NotImplementedError("_call_runnable is not implemented for " + str(self.__class__))
 
+    def _profile_nodes(
+        self, runnable: Any, inputs: Dict[str, np.ndarray], device: str, repeat: int
+    ) -> Dict[str, float]:
+        """Run the runnable with timing hooks around the nodes
+
+        Parameters
+        -------
+        runnable:
+            The runnable model.
+        inputs: dict<str, data>
+            The inputs in dict.
+        device: str
+            The device.
+        repeat: int
+            The repeat num for profile.
+
+        Returns
+        -------
+        latencies: dict<str, float>
+            The total latency of each node in ms.
+        """
+
+        raise NotImplementedError("_profile_nodes is not implemented for " + str(self.__class__))
+
     def runner_mark(self, msg: Any) -> str:
         """Mark the message with runner info
 
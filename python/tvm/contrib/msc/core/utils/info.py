@@ -376,6 +376,34 @@ def compare_arrays(
     return report
 
 
+def compare_latencies(latencies: Dict[str, Dict[str, float]]) -> dict:
+    """Compare the latencies of the nodes profiled on several backends
+
+    Parameters
+    ----------
+    latencies: dict<str, dict<str, float>>
+        The latency of each node in ms, by the backends.
+
+    Returns
+    -------
+    report: dict
+        The compare results, with the total latency of each backend, the number of nodes each
+        backend is the fastest for, and the latencies and the fastest backend of each node.
+    """
+
+    report = {"total": {}, "best": {b: 0 for b in latencies}, "info": {}}
+    nodes = {}
+    for backend, b_latencies in latencies.items():
+        report["total"][backend] = sum(b_latencies.values())
+        nodes.update({n: None for n in b_latencies})
+    for node in nodes:
+        n_latencies = {b: l[node] for b, l in latencies.items() if node in l}
+        best = min(n_latencies, key=n_latencies.get)
+        report["best"][best] += 1
+        report["info"][node] = {"latencies": n_latencies, "best": best}
+    return report
+
+
 def get_version(framework: str) -> List[int]:
     """Get the version list of framework.
 
@@ -18,7 +18,9 @@
 """tvm.contrib.msc.framework.tensorrt.runtime.runner"""
 
 import os
+import re
 from typing import Any, List, Dict
+import numpy as np
 
 import tvm
 from tvm.contrib.msc.core.ir import MSCGraph
@@ -103,6 +105,61 @@ class TensorRTRunner(BYOCRunner):
 
         return super()._generate_model(graphs, weights)
 
+    def _profile_nodes(
+        self,
+        runnable: tvm.relax.VirtualMachine,
+        inputs: Dict[str, np.ndarray],
+        device: str,
+        repeat: int,
+    ) -> Dict[str, float]:
+        """Run the runnable with the layer profilers of the engines
+
+        Parameters
+        -------
+        runnable: tvm.relax.VirtualMachine
+            The virtual machine.
+        inputs: dict<str, data>
+            The inputs in dict.
+        device: str
+            The device.
+        repeat: int
+            The repeat num for profile.
+
+        Returns
+        -------
+        latencies: dict<str, float>
+            The total latency of each node in ms.
+        """
+
+        def _get_engines(mod: tvm.runtime.Module) -> List[tvm.runtime.Module]:
+            engines = [mod] if mod.type_key == "msc_tensorrt" else []
+            for sub_mod in mod.imported_modules:
+                engines.extend(_get_engines(sub_mod))
+            return engines
+
+        engines = _get_engines(self._executable.mod)
+        assert engines, "Can not find tensorrt engines to profile"
+        for engine in engines:
+            engine["msc_set_profiling"](True)
+        try:
+            for _ in range(repeat):
+                self._call_runnable(runnable, inputs, device)
+        finally:
+            layer_latencies = {}
+            for engine in engines:
+                for layer, latency in engine["msc_get_layer_latencies"]().items():
+                    layer_latencies[layer] = float(latency.numpy()[0])
+                engine["msc_set_profiling"](False)
+
+        # The layers fused by tensorrt are named by the nodes they fuse, which share the latency.
+        nodes = set(n.name for g in self._graphs for n in g.get_nodes())
+        latencies = {}
+        for layer, latency in layer_latencies.items():
+            l_nodes = [n for n in re.split(r"[\s\+\(\)\[\]\{\},]+", layer) if n in nodes]
+            for node in l_nodes or [layer]:
+                latencies[node] = latencies.get(node, 0) + latency / max(len(l_nodes), 1)
+        return latencies
+
     def export_runnable(self, folder: msc_utils.MSCDirectory) -> dict:
         """Export the runnable
 
@@ -17,7 +17,9 @@
 # pylint: disable=unused-import
 """tvm.contrib.msc.framework.torch.runtime.runner"""
 
+import sys
 import time
+import inspect
 from typing import Dict, List, Union, Tuple, Any
 import numpy as np
 
@@ -107,6 +109,79 @@ class TorchRunner(ModelRunner):
         ]
         return runnable(*torch_inputs)
 
+    def _profile_nodes(
+        self, runnable: torch.nn.Module, inputs: Dict[str, np.ndarray], device: str, repeat: int
+    ) -> Dict[str, float]:
+        """Run the runnable with timing hooks around the nodes
+
+        Parameters
+        -------
+        runnable: torch.nn.Module
+            The runnable model.
+        inputs: dict<str, data>
+            The inputs in dict.
+        device: str
+            The device.
+        repeat: int
+            The repeat num for profile.
+
+        Returns
+        -------
+        latencies: dict<str, float>
+            The total latency of each node in ms.
+        """
+
+        # The lines of each node follow the comment of the node in the generated forward.
+        forward = inspect.unwrap(type(runnable).forward)
+        lines, first_line = inspect.getsourcelines(forward)
+        line_nodes, node = {}, None
+        for idx, line in enumerate(lines):
+            line = line.strip()
+            if line.startswith("#"):
+                name = line[1:].split("(")[0].strip()
+                node = name if self._graphs[0].has_node(name) else None
+            elif node and line:
+                line_nodes[first_line + idx] = node
+        assert line_nodes, "Can not find the nodes in forward of " + str(type(runnable))
+
+        latencies, last = {}, {"node": None, "time": 0}
+
+        def _record(lineno: int):
+            if device.startswith("cuda"):
+                torch.cuda.synchronize()
+            current = time.perf_counter()
+            if last["node"]:
+                latency = (current - last["time"]) * 1000
+                latencies[last["node"]] = latencies.get(last["node"], 0) + latency
+            last["node"], last["time"] = line_nodes.get(lineno), current
+
+        # pylint: disable=unused-argument
+        def _trace_lines(frame, event, arg):
+            if event == "line":
+                _record(frame.f_lineno)
+            elif event == "return":
+                _record(-1)
+            return _trace_lines
+
+        def _trace_calls(frame, event, arg):
+            if event == "call" and frame.f_code is forward.__code__:
+                return _trace_lines
+            return None
+
+        input_names = [i["name"] for i in self.get_inputs()]
+        torch_inputs = [
+            msc_utils.cast_array(inputs[i], MSCFramework.TORCH, device) for i in input_names
+        ]
+        tracer = sys.gettrace()
+        sys.settrace(_trace_calls)
+        try:
+            with torch.no_grad():
+                for _ in range(repeat):
+                    runnable(*torch_inputs)
+        finally:
+            sys.settrace(tracer)
+        return latencies
+
     def _get_runtime_params(self) -> Dict[str, tvm.nd.array]:
         """Get the runtime parameters
 
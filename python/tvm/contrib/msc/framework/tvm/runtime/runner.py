@@ -23,6 +23,7 @@ from typing import Dict, List, Union, Any, Tuple
 import numpy as np
 
 import tvm
+from tvm.contrib.msc.core.ir import MSCGraph
 from tvm.contrib.msc.core.runtime import ModelRunner
 from tvm.contrib.msc.core.tools import execute_step
 from tvm.contrib.msc.core.utils.message import MSCStage
@@ -55,6 +56,36 @@ class WrapRunnable(object):
         return execute_step("after_forward", output)
 
 
+def _get_call_nodes(mod: tvm.IRModule, graph: MSCGraph) -> List[Tuple[str, str]]:
+    """Get the called kernels of the nodes, in the order of the calls
+
+    Parameters
+    -------
+    mod: tvm.IRModule
+        The legalized module.
+    graph: MSCGraph
+        The graph of the module.
+
+    Returns
+    -------
+    call_nodes: list<(str, str)>
+        The symbol of each called kernel, and the name of the node it computes.
+    """
+
+    call_ops = [tvm.ir.Op.get("relax.call_tir"), tvm.ir.Op.get("relax.call_tir_inplace")]
+    call_nodes, pending = [], []
+    for block in mod["main"].body.blocks:
+        for binding in block.bindings:
+            value = binding.value
+            if isinstance(value, tvm.relax.Call) and any(value.op.same_as(o) for o in call_ops):
+                pending.append(value.args[0].name_hint)
+            # The kernels of the bindings without a node name belong to the next node.
+            if pending and graph.has_node(binding.var.name_hint):
+                call_nodes.extend((symbol, binding.var.name_hint) for symbol in pending)
+                pending = []
+    return call_nodes
+
+
 class TVMRunner(ModelRunner):
     """Runner of Relax"""
 
@@ -67,7 +98,7 @@ class TVMRunner(ModelRunner):
             The setup info.
         """
 
-        self._executable = None
+        self._executable, self._call_nodes = None, []
         return super().setup()
 
     def _build_runnable(self, model: Any) -> Any:
@@ -98,6 +129,7 @@ class TVMRunner(ModelRunner):
             )
         else:
             model = tvm.relax.transform.LegalizeOps()(model)
+            self._call_nodes = _get_call_nodes(model, self._graphs[0])
             if self._device.startswith("cpu"):
                 target = tvm.target.Target("llvm")
                 with tvm.transform.PassContext(opt_level=3):
@@ -140,6 +172,61 @@ class TVMRunner(ModelRunner):
         ]
         return runnable(*tvm_inputs)
 
+    def _profile_nodes(
+        self, runnable: WrapRunnable, inputs: Dict[str, np.ndarray], device: str, repeat: int
+    ) -> Dict[str, float]:
+        """Run the runnable with timing hooks around the nodes
+
+        Parameters
+        -------
+        runnable: WrapRunnable
+            The wrapped virtual machine.
+        inputs: dict<str, data>
+            The inputs in dict.
+        device: str
+            The device.
+        repeat: int
+            The repeat num for profile.
+
+        Returns
+        -------
+        latencies: dict<str, float>
+            The total latency of each node in ms.
+        """
+
+        assert self._executable and self._call_nodes, "Profile nodes needs the default builder"
+        tvm_device = tvm.cuda() if device.startswith("cuda") else tvm.cpu()
+        symbols = set(symbol for symbol, _ in self._call_nodes)
+        records, start = [], [0]
+
+        # pylint: disable=unused-argument
+        def _instrument(func, symbol, before_run, ret_value, *args):
+            if symbol not in symbols:
+                return
+            tvm_device.sync()
+            if before_run:
+                start[0] = time.perf_counter()
+            else:
+                records.append((symbol, (time.perf_counter() - start[0]) * 1000))
+
+        # The instrument stays with the profiling virtual machine, not with the runnable.
+        vm = tvm.relax.VirtualMachine(self._executable, tvm_device)
+        vm.set_instrument(_instrument)
+        input_names = [i["name"] for i in self.get_inputs()]
+        tvm_inputs = [
+            msc_utils.cast_array(inputs[i], MSCFramework.TVM, device) for i in input_names
+        ]
+        for _ in range(repeat):
+            vm["main"](*tvm_inputs)
+        latencies = {}
+        for idx, (symbol, latency) in enumerate(records):
+            expected, node = self._call_nodes[idx % len(self._call_nodes)]
+            assert symbol == expected, "Kernel {} is called for {}, but expect {}".format(
+                symbol, node, expected
+            )
+            latencies[node] = latencies.get(node, 0) + latency
+        return latencies
+
     def export_runnable(self, folder: msc_utils.MSCDirectory) -> dict:
         """Export the runnable
 
@@ -94,6 +94,7 @@ class BasePipeWorker(object):
         self._tools_config = map_tools(self._config.get("tools", []))
         self._relax_mod, self._sample_inputs = None, None
         self._runner = None
+        self._node_latencies = {}
 
     def update_config(self) -> dict:
         """Update config
@@ -568,6 +569,21 @@ class BasePipeWorker(object):
             latency = "{:.2f} ms @ {}".format(avg_time, runner.device)
             info["latency"] = latency + " (X{})".format(repeat)
             report += (", " if report else "") + latency
+
+        # profile the nodes, and compare them with the nodes profiled in former stages
+        nodes_config = profile_config.get("nodes", {})
+        if nodes_config:
+            backend = "{}({})".format(runner.framework, stage)
+            self._node_latencies[backend] = runner.profile_nodes(
+                self._sample_inputs,
+                repeat=nodes_config.get("repeat", 10),
+                warm_up=nodes_config.get("warm_up", 2),
+            )
+            compared = msc_utils.compare_latencies(self._node_latencies)
+            info["nodes"] = compared if runner.debug_level >= 1 else compared["best"]
+            report += (", " if report else "") + "{} nodes profiled".format(
+                len(self._node_latencies[backend])
+            )
         return info, report
 
     def export_model(self, stage: str, folder: msc_utils.MSCDirectory, dump: bool = True) -> Any:
@@ -19,6 +19,7 @@
 from __future__ import absolute_import as _abs
 
 import os
+import re
 import subprocess
 import warnings
 
@@ -134,6 +135,57 @@ def compile_cuda(code, target_format="ptx", arch=None, options=None, path_target
         return data
 
 
+def get_kernel_resource_usage(mod):
+    """Get the resource usage of the kernels of the CUDA modules compiled to binary.
+
+    The resource usage is read from the binary with cuobjdump. The kernels of PTX are compiled
+    by the driver when loaded, and are not included.
+
+    Parameters
+    ----------
+    mod : tvm.runtime.Module
+        The CUDA module, or a module importing it.
+
+    Returns
+    -------
+    usage : Dict[str, Dict[str, int]]
+        The "registers" per thread, and the bytes of the "stack", "shared" memory and "local"
+        memory per thread of each kernel. The local memory holds the spilled registers and the
+        local arrays which are not promoted to registers. For a binary of several architectures,
+        the maximum of the architectures is taken.
+    """
+    temp = utils.tempdir()
+    usage = {}
+    modules = [mod]
+    num_binaries = 0
+    while modules:
+        cuda_mod = modules.pop()
+        modules += cuda_mod.imported_modules
+        if cuda_mod.type_key != "cuda" or cuda_mod.format != "cubin":
+            continue
+        path = temp.relpath(f"tvm_kernels_{num_binaries}.cubin")
+        num_binaries += 1
+        cuda_mod.save(path, "cubin")
+        proc = subprocess.Popen(
+            ["cuobjdump", "--dump-resource-usage", path],
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+        )
+        (out, _) = proc.communicate()
+        if proc.returncode != 0:
+            raise RuntimeError("cuobjdump error:\n" + py_str(out))
+        # Function default_function_kernel:
+        #  REG:32 STACK:0 SHARED:0 LOCAL:0 CONSTANT[0]:368 TEXTURE:0 SURFACE:0 SAMPLER:0
+        pattern = r"Function ([^\s:]+):\s*REG:(\d+) STACK:(\d+) SHARED:(\d+) LOCAL:(\d+)"
+        for match in re.finditer(pattern, py_str(out)):
+            kernel = usage.setdefault(
+                match.group(1), {"registers": 0, "stack": 0, "shared": 0, "local": 0}
+            )
+            for i, key in enumerate(["registers", "stack", "shared", "local"]):
+                kernel[key] = max(kernel[key], int(match.group(i + 2)))
+    return usage
+
+
 def find_cuda_path():
     """Utility function to find cuda path
 
@@ -198,10 +250,48 @@ def get_cuda_version(cuda_path=None):
     raise RuntimeError("Cannot read cuda version file")
 
 
+def get_fatbin_arch(archs):
+    """Get the nvcc options of a fatbin with the cubins of a list of architectures.
+
+    The fatbin also embeds the PTX of the newest architecture, which the driver compiles only on
+    the GPUs newer than all the architectures.
+
+    Parameters
+    ----------
+    archs : list of str
+        The cuda architectures, such as ["sm_80", "sm_90"].
+
+    Returns
+    -------
+    arch : list of str
+        The -gencode options of nvcc.
+    """
+    def _key(version):
+        return (int("".join(filter(str.isdigit, version))), version)
+
+    versions = sorted({arch.split("_")[-1] for arch in archs}, key=_key)
+    if not versions:
+        raise ValueError("The list of cuda architectures of a fatbin should not be empty")
+    arch = []
+    for version in versions:
+        arch += ["-gencode", f"arch=compute_{version},code=sm_{version}"]
+    arch += ["-gencode", f"arch=compute_{versions[-1]},code=compute_{versions[-1]}"]
+    return arch
+
+
 @tvm._ffi.register_func
 def tvm_callback_cuda_compile(code, target):  # pylint: disable=unused-argument
-    """use nvcc to generate fatbin code for better optimization"""
-    ptx = compile_cuda(code, target_format="fatbin")
+    """use nvcc to generate fatbin code for better optimization
+
+    The fatbin has the cubin of the architecture of the target, or with the "cuda.fatbin_archs"
+    config of the pass context, the cubins of the listed architectures, so that loading the module
+    needs no JIT of PTX on the GPUs of those architectures.
+    """
+    pass_context = tvm.get_global_func("transform.GetCurrentPassContext")()
+    arch = None
+    if "cuda.fatbin_archs" in pass_context.config:
+        arch = get_fatbin_arch([str(arch) for arch in pass_context.config["cuda.fatbin_archs"]])
+    ptx = compile_cuda(code, target_format="fatbin", arch=arch)
     return ptx
 
 
@@ -59,6 +59,7 @@ class PipelineModule(object):
         self._get_num_inputs = self.module["get_num_inputs"]
         self._get_input_pipeline_map = self.module["get_input_pipeline_map"]
         self._get_pipe_execute_count = self.module["get_execute_count"]
+        self._get_stage_metrics = self.module["get_stage_metrics"]
 
     def run(self):
         """Run the pipeline executor."""
@@ -163,6 +164,19 @@ class PipelineModule(object):
         """
         return self._get_pipe_execute_count()
 
+    def get_stage_metrics(self):
+        """Getting the throughput and the queue metrics of each module of the pipeline.
+
+        Returns
+        -------
+        metrics : List[Dict[str, float]]
+            The metrics of each module, in the order of the module indices, including the
+            "requests" processed, the "dropped_requests", the "throughput" in requests per
+            second, the current "queue_depth" and the "max_queue_depth" of its input queues,
+            and the microseconds spent in "run_us", "input_wait_us" and "output_blocked_us".
+        """
+        return json.loads(self._get_stage_metrics())
+
     @property
     def num_outputs(self):
         """Get the number of outputs.
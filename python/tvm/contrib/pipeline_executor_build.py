@@ -418,6 +418,14 @@ class PipelineConfig(object):
             self.dev = None
             self.export_cc = None
             self.cpu_affinity = ""
+            # The number of requests that the queue of each input of the module can hold.
+            self.queue_capacity = 1024
+            # The number of requests that the module processes in one run, which are batched
+            # along the first axis of its inputs and outputs.
+            self.batch_size = 1
+            # "block" waits for room in the queues of the children, while "drop" drops the
+            # request, which only the first module supports.
+            self.queue_policy = "block"
             self.idx = None
             self.mod = mod
             self.input_params = InferType()(mod)["main"].params
@@ -594,6 +602,9 @@ class PipelineConfig(object):
 
             mconf["mod_idx"] = module.idx
             mconf["cpu_affinity"] = module.cpu_affinity
+            mconf["queue_capacity"] = module.queue_capacity
+            mconf["batch_size"] = module.batch_size
+            mconf["queue_policy"] = module.queue_policy
             mconf["output"] = output_conf
 
             module_connection[mod] = {
@@ -15,8 +15,10 @@
 # specific language governing permissions and limitations
 # under the License.
 """External function interface to random library."""
+import math
+
 import tvm
-from tvm import te
+from tvm import te, tir
 import tvm._ffi
 
 
@@ -112,4 +114,140 @@ def normal(loc, scale, size):
     )
 
 
+def _as_uint64(value):
+    if isinstance(value, int):
+        return tir.const(value % (1 << 64), "uint64")
+    return value.astype("uint64")
+
+
+def _philox4x32(counter, key):
+    """The Philox-4x32-10 block of a counter under a key, which are uint64 expressions."""
+    lanes = [
+        counter.astype("uint32"),
+        (counter >> tir.const(32, "uint64")).astype("uint32"),
+        tir.const(0, "uint32"),
+        tir.const(0, "uint32"),
+    ]
+    key0 = key.astype("uint32")
+    key1 = (key >> tir.const(32, "uint64")).astype("uint32")
+    for _ in range(10):
+        prod0 = tir.const(0xD2511F53, "uint64") * lanes[0].astype("uint64")
+        prod1 = tir.const(0xCD9E8D57, "uint64") * lanes[2].astype("uint64")
+        lanes = [
+            (prod1 >> tir.const(32, "uint64")).astype("uint32") ^ lanes[1] ^ key0,
+            prod1.astype("uint32"),
+            (prod0 >> tir.const(32, "uint64")).astype("uint32") ^ lanes[3] ^ key1,
+            prod0.astype("uint32"),
+        ]
+        key0 = key0 + tir.const(0x9E3779B9, "uint32")
+        key1 = key1 + tir.const(0xBB67AE85, "uint32")
+    return lanes
+
+
+def _philox_compute(seed, offset, size, fblock, name):
+    """Compute a tensor whose i-th element is taken from the Philox block of the counter
+    `offset + i / 4`, as `fblock(block, i % 4)`."""
+    seed = _as_uint64(seed)
+    offset = _as_uint64(offset)
+
+    def fcompute(*indices):
+        index = tir.const(0, "int64")
+        for dim, idx in zip(size, indices):
+            index = index * tir.const(dim, "int64") + idx.astype("int64")
+        block = _philox4x32(offset + (index // 4).astype("uint64"), seed)
+        return fblock(block, index % 4)
+
+    return te.compute(size, fcompute, name=name)
+
+
+def _to_uniform(bits):
+    return (bits >> tir.const(8, "uint32")).astype("float32") * tir.const(1.0 / 16777216, "float32")
+
+
+def philox_uniform(seed, offset, low, high, size):
+    """Draw samples from a uniform distribution with the counter-based Philox-4x32 generator.
+
+    The samples only depend on the seed, the offset and their index, so they are the same on
+    every target and for any number of threads. The i-th sample is drawn from the block of the
+    counter `offset + i / 4`, which matches `tvm.contrib.random.philox_uniform` of the runtime.
+    Unlike `uniform`, the tensor is computed in TIR, and runs on the GPUs once scheduled.
+
+    Parameters
+    ----------
+    seed : Union[int, PrimExpr]
+        The seed of the samples.
+    offset : Union[int, PrimExpr]
+        The counter of the first block, which skips `4 * offset` samples of the stream.
+    low : float
+        Lower boundary of the output interval.
+    high : float
+        Upper boundary of the output interval.
+    size : tuple of ints
+        Output shape.
+
+    Returns
+    -------
+    out : Tensor
+        A float32 tensor of the samples in [low, high).
+    """
+    assert high > low, "high must be bigger than low"
+    scale = tir.const(high - low, "float32")
+    low = tir.const(low, "float32")
+
+    def fblock(block, lane):
+        bits = tir.Select(
+            lane == 0,
+            block[0],
+            tir.Select(lane == 1, block[1], tir.Select(lane == 2, block[2], block[3])),
+        )
+        return low + _to_uniform(bits) * scale
+
+    return _philox_compute(seed, offset, size, fblock, "philox_uniform")
+
+
+def philox_normal(seed, offset, loc, scale, size):
+    """Draw samples from a normal distribution with the counter-based Philox-4x32 generator.
+
+    Each pair of lanes of a block gives two samples by the Box-Muller transform, like
+    `tvm.contrib.random.philox_normal` of the runtime, up to the precision of the math functions
+    of the target.
+
+    Parameters
+    ----------
+    seed : Union[int, PrimExpr]
+        The seed of the samples.
+    offset : Union[int, PrimExpr]
+        The counter of the first block, which skips `4 * offset` samples of the stream.
+    loc : float
+        Mean of the distribution.
+    scale : float
+        Standard deviation of the distribution.
+    size : tuple of ints
+        Output shape.
+
+    Returns
+    -------
+    out : Tensor
+        A float32 tensor of the samples.
+    """
+    assert scale > 0, "standard deviation must be positive"
+    loc = tir.const(loc, "float32")
+    scale = tir.const(scale, "float32")
+
+    def fblock(block, lane):
+        first_pair = lane < 2
+        bits0 = tir.Select(first_pair, block[0], block[2])
+        bits1 = tir.Select(first_pair, block[1], block[3])
+        # The radius lane is in (0, 1], so that its logarithm is finite.
+        u0 = ((bits0 >> tir.const(8, "uint32")) + tir.const(1, "uint32")).astype(
+            "float32"
+        ) * tir.const(1.0 / 16777216, "float32")
+        radius = tir.sqrt(tir.const(-2.0, "float32") * tir.log(u0))
+        theta = tir.const(2 * math.pi, "float32") * _to_uniform(bits1)
+        value = tir.Select(lane % 2 == 0, tir.cos(theta), tir.sin(theta))
+        return loc + radius * value * scale
+
+    return _philox_compute(seed, offset, size, fblock, "philox_normal")
+
+
 tvm._ffi._init_api("tvm.contrib.random")
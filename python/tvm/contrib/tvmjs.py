@@ -62,6 +62,22 @@ def _convert_bf16_to_f32(value):
     return (data.astype("uint32") << 16).view("float32")
 
 
+def _convert_int8_to_int4(value):
+    data = value.reshape(-1)
+    if data.size and (data.min() < -8 or data.max() > 7):
+        raise ValueError("int8-to-int4 encoding requires values in [-8, 7]")
+    if data.size % 2:
+        data = np.append(data, np.int8(0))
+    nibbles = data.astype("int8").view("uint8") & 0xF
+    return nibbles[0::2] | (nibbles[1::2] << 4)
+
+
+def _convert_int4_to_int8(value, numel):
+    data = value.view("uint8")
+    nibbles = np.stack([data & 0xF, data >> 4], axis=-1).reshape(-1)[:numel]
+    return np.where(nibbles >= 8, nibbles.astype("int16") - 16, nibbles).astype("int8")
+
+
 def _calculate_md5(filename):
     hash_md5 = hashlib.md5()
     with open(filename, "rb") as file:
@@ -222,8 +238,9 @@ def dump_ndarray_cache(
     cache_dir: str
         The path to the cache
 
-    encode_format: {"f32-to-bf16", "raw"}
-        Encoding format.
+    encode_format: {"f32-to-bf16", "f32-to-f16", "int8-to-int4", "raw"}
+        Encoding format. The encoded formats only apply to parameters of the dtype
+        before "-to-", other parameters are stored raw.
 
     meta_data: json-compatible-struct or Callable[[], Any]
         Extra meta_data to be stored in the cache json file,
@@ -239,7 +256,7 @@ def dump_ndarray_cache(
         If the cache already exists, update the cache. When set to False, it will overwrite the
         existing files.
     """
-    if encode_format not in ("raw", "f32-to-bf16"):
+    if encode_format not in ("raw", "f32-to-bf16", "f32-to-f16", "int8-to-int4"):
         raise ValueError(f"Invalie encode_format {encode_format}")
 
     records = []
@@ -283,6 +300,10 @@ def dump_ndarray_cache(
         if encode_format == "f32-to-bf16" and dtype == "float32":
             data = _convert_f32_to_bf16(v).tobytes()
             f32_to_bf16_triggered = True
+        elif encode_format == "f32-to-f16" and dtype == "float32":
+            data = v.astype("float16").tobytes()
+        elif encode_format == "int8-to-int4" and dtype == "int8":
+            data = _convert_int8_to_int4(v).tobytes()
         else:
             data = v.tobytes()
 
@@ -379,6 +400,12 @@ def load_ndarray_cache(cachepath: str, device: tvm.runtime.Device):
             if encode_format == "f32-to-bf16" and dtype == "float32":
                 data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
                 arr.copyfrom(_convert_bf16_to_f32(data))
+            elif encode_format == "f32-to-f16" and dtype == "float32":
+                data = np.frombuffer(buffer_source, dtype="float16").reshape(shape)
+                arr.copyfrom(data.astype("float32"))
+            elif encode_format == "int8-to-int4" and dtype == "int8":
+                data = np.frombuffer(buffer_source, dtype="uint8")
+                arr.copyfrom(_convert_int4_to_int8(data, math.prod(shape)).reshape(shape))
             elif dtype == "bfloat16":
                 data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
                 arr.copyfrom(data)
@@ -389,6 +416,79 @@ def load_ndarray_cache(cachepath: str, device: tvm.runtime.Device):
     return result_dict, json_info["metadata"]
 
 
+def register_ndarray_cache_decoders(target: Union[str, tvm.target.Target]):
+    """Build the device kernels that decode the encoded NDArray cache formats,
+    and register them so that parameters loaded onto the devices of the target
+    are uploaded in their compact form and decoded on device.
+
+    Parameters
+    ----------
+    target: Union[str, tvm.target.Target]
+        The target to build the kernels for.
+    """
+    # pylint: disable=import-outside-toplevel
+    from tvm import dlight as dl
+    from tvm.script import tir as T
+
+    # pylint: disable=invalid-name,missing-function-docstring
+    @T.prim_func
+    def decode_f32_to_bf16(var_data: T.handle, var_out: T.handle):
+        T.func_attr({"tir.noalias": T.bool(True)})
+        nbytes, n = T.int64(), T.int64()
+        data = T.match_buffer(var_data, (nbytes,), "uint8")
+        out = T.match_buffer(var_out, (n,), "float32")
+        for i in range(n):
+            with T.block("decode"):
+                vi = T.axis.spatial(n, i)
+                lo = T.Cast("uint32", data[vi * 2])
+                hi = T.Cast("uint32", data[vi * 2 + 1])
+                out[vi] = T.reinterpret("float32", ((hi << T.uint32(8)) | lo) << T.uint32(16))
+
+    @T.prim_func
+    def decode_f32_to_f16(var_data: T.handle, var_out: T.handle):
+        T.func_attr({"tir.noalias": T.bool(True)})
+        nbytes, n = T.int64(), T.int64()
+        data = T.match_buffer(var_data, (nbytes,), "uint8")
+        out = T.match_buffer(var_out, (n,), "float32")
+        for i in range(n):
+            with T.block("decode"):
+                vi = T.axis.spatial(n, i)
+                lo = T.Cast("uint16", data[vi * 2])
+                hi = T.Cast("uint16", data[vi * 2 + 1])
+                out[vi] = T.Cast("float32", T.reinterpret("float16", (hi << T.uint16(8)) | lo))
+
+    @T.prim_func
+    def decode_int8_to_int4(var_data: T.handle, var_out: T.handle):
+        T.func_attr({"tir.noalias": T.bool(True)})
+        nbytes, n = T.int64(), T.int64()
+        data = T.match_buffer(var_data, (nbytes,), "uint8")
+        out = T.match_buffer(var_out, (n,), "int8")
+        for i in range(n):
+            with T.block("decode"):
+                vi = T.axis.spatial(n, i)
+                shift = T.Cast("uint8", vi % 2 * 4)
+                nibble = T.Cast("int8", (data[vi // 2] >> shift) & T.uint8(15))
+                out[vi] = T.Select(nibble >= T.int8(8), nibble - T.int8(16), nibble)
+
+    # pylint: enable=invalid-name,missing-function-docstring
+
+    decoders = {
+        "f32-to-bf16": ("float32", decode_f32_to_bf16),
+        "f32-to-f16": ("float32", decode_f32_to_f16),
+        "int8-to-int4": ("int8", decode_int8_to_int4),
+    }
+    target = tvm.target.Target(target)
+    mod = tvm.IRModule({func.attrs["global_symbol"]: func for _, func in decoders.values()})
+    if "gpu" in target.keys:
+        with target:
+            mod = dl.ApplyDefaultSchedule(dl.gpu.Fallback())(mod)  # pylint: disable=not-callable
+    rt_mod = tvm.build(mod, target=target)
+    device_type = tvm.device(target.kind.name).device_type
+    fregister = tvm.get_global_func("vm.builtin.ndarray_cache.register_decoder")
+    for encode_format, (dtype, func) in decoders.items():
+        fregister(encode_format, dtype, device_type, rt_mod[func.attrs["global_symbol"]])
+
+
 def export_runtime(runtime_dir):
     """Export TVMJS runtime to the runtime_dir
 
@@ -0,0 +1,45 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""DiscoWorker connecting to the controller of a Disco SocketSession."""
+import sys
+
+from tvm._ffi import get_global_func
+
+# Register the same global functions as the workers of ProcessSession
+from . import disco_worker as _  # pylint: disable=unused-import
+
+
+def main():
+    """Main worker function"""
+    if len(sys.argv) not in (4, 5):
+        print("Usage: <host> <port> <worker_id> [<connect_timeout_sec>]")
+        return
+    host = sys.argv[1]
+    port = int(sys.argv[2])
+    worker_id = int(sys.argv[3])
+    timeout_sec = int(sys.argv[4]) if len(sys.argv) == 5 else 60
+
+    worker_func = get_global_func("runtime.disco.WorkerSocket")
+    worker_func(worker_id, host, port, timeout_sec)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (KeyboardInterrupt, IOError):
+        pass
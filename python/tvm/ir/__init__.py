@@ -27,10 +27,15 @@ from .base import (
     Span,
     SequentialSpan,
     assert_structural_equal,
+    clear_structural_hash_cache,
+    load_binary,
     load_json,
+    save_binary,
     save_json,
+    set_structural_hash_cache_capacity,
     structural_equal,
     structural_hash,
+    structural_hash_cache_stats,
 )
 from .container import Array, Map
 from .expr import BaseExpr, GlobalVar, PrimExpr, Range, RelayExpr
@@ -146,6 +146,41 @@ def save_json(node) -> str:
     return _ffi_node_api.SaveJSON(node)
 
 
+def save_binary(node) -> bytearray:
+    """Save tvm object in the compact binary format.
+
+    The binary is faster to save and load than the json, and holds the NDArrays as raw bytes,
+    but can only be loaded by a TVM whose objects have the same fields.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    data : bytearray
+        The saved bytes.
+    """
+    return _ffi_node_api.SaveBinary(node)
+
+
+def load_binary(data) -> Object:
+    """Load tvm object saved by save_binary.
+
+    Parameters
+    ----------
+    data : Union[bytes, bytearray]
+        The saved bytes.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return _ffi_node_api.LoadBinary(bytearray(data))
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
@@ -298,6 +333,40 @@ def structural_hash(node, map_free_vars=False):
     return _ffi_node_api.StructuralHash(node, map_free_vars)  # type: ignore # pylint: disable=no-member
 
 
+def set_structural_hash_cache_capacity(capacity):
+    """Set the capacity of the process-wide cache of the structural hashes of large subtrees.
+
+    With a non-zero capacity, structural_hash reuses the hash of the large subtrees it has
+    already hashed, so that rehashing an unchanged module, or a module that shares functions
+    with a hashed one, does not visit them again. The hash values are the same as without the
+    cache. A cached subtree is kept alive until it is evicted or the cache is cleared.
+
+    Parameters
+    ----------
+    capacity : int
+        The maximum number of cached subtrees, where 0, the default, disables the cache.
+    """
+    _ffi_node_api.StructuralHashCacheSetCapacity(capacity)  # type: ignore # pylint: disable=no-member
+
+
+def clear_structural_hash_cache():
+    """Remove all the subtrees of the structural hash cache."""
+    _ffi_node_api.StructuralHashCacheClear()  # type: ignore # pylint: disable=no-member
+
+
+def structural_hash_cache_stats():
+    """Get the statistics of the structural hash cache.
+
+    Returns
+    -------
+    stats : Dict[str, int]
+        The number of the reused subtrees "hits", of the cached ones "misses", the current
+        "size" and the "capacity" of the cache.
+    """
+    stats = _ffi_node_api.StructuralHashCacheStats()  # type: ignore # pylint: disable=no-member
+    return {str(key): int(value) for key, value in stats.items()}
+
+
 def deprecated(
     method_name: str,
     new_method_name: str,
@@ -257,6 +257,52 @@ class PassTimingInstrument(tvm.runtime.Object):
         return _ffi_instrument_api.RenderTimePassProfiles()
 
 
+@tvm._ffi.register_object("instrument.PassProfilingInstrument")
+class PassProfilingInstrument(tvm.runtime.Object):
+    """A pass instrument implemented in C++ that records the time and the number of objects
+    allocated by each pass, and by each function a function-level pass runs over, as a Chrome
+    trace, which can be inspected in Perfetto or chrome://tracing.
+
+    The allocations of a slice are the ones of the thread that runs it. The recorded slices are
+    kept after exiting the PassContext, until it is entered again.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        profiler = PassProfilingInstrument()
+        with tvm.transform.PassContext(instruments=[profiler]):
+            lib = tvm.build(mod, target="llvm")
+        profiler.save("passes.json")
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(_ffi_instrument_api.MakePassProfilingInstrument)
+
+    def chrome_trace(self) -> str:
+        """Return the recorded slices as the JSON of a Chrome trace.
+
+        Returns
+        -------
+        trace : str
+            The JSON, with a complete event per pass and per function, whose args hold the
+            pass, the function and the number of allocations.
+        """
+        return _ffi_instrument_api.PassProfilingInstrumentChromeTrace(self)
+
+    def save(self, path: str) -> None:
+        """Save the recorded slices as a Chrome trace.
+
+        Parameters
+        ----------
+        path : str
+            The path of the JSON file.
+        """
+        with open(path, "w") as f:
+            f.write(self.chrome_trace())
+
+
 @pass_instrument
 class PassPrintingInstrument:
     """A pass instrument to print if before or
@@ -70,6 +70,8 @@ class LocalBuilder(PyBuilder):
     f_export : Union[None, str, T_EXPORT]
         Name of the export function to be used.
         Defaults to `meta_schedule.builder.default_export`.
+    max_local_memory_bytes : Optional[int]
+        The maximum bytes of local memory per thread of the CUDA kernels.
 
     Attributes
     ----------
@@ -106,6 +108,7 @@ class LocalBuilder(PyBuilder):
     initializer: Optional[Callable[[], None]]
     f_build: Union[None, str, T_BUILD]
     f_export: Union[None, str, T_EXPORT]
+    max_local_memory_bytes: Optional[int]
 
     def __init__(
         self,
@@ -115,6 +118,7 @@ class LocalBuilder(PyBuilder):
         f_build: Union[None, str, T_BUILD] = None,
         f_export: Union[None, str, T_EXPORT] = None,
         initializer: Optional[Callable[[], None]] = None,
+        max_local_memory_bytes: Optional[int] = None,
     ) -> None:
         """Constructor.
 
@@ -133,6 +137,11 @@ class LocalBuilder(PyBuilder):
             Defaults to `meta_schedule.builder.default_export`.
         initializer : Optional[Callable[[], None]]
             The initializer to be used for the worker processes.
+        max_local_memory_bytes : Optional[int]
+            The maximum bytes of local memory per thread of the CUDA kernels, which holds the
+            spilled registers. The candidates of the kernels beyond it fail to build, so that
+            they are not measured. Read from the binaries of the kernels with cuobjdump.
+            Defaults to no limit.
         """
         super().__init__()
 
@@ -145,6 +154,7 @@ class LocalBuilder(PyBuilder):
         self.initializer = initializer
         self.f_build = f_build
         self.f_export = f_export
+        self.max_local_memory_bytes = max_local_memory_bytes
         self._sanity_check()
 
     def build(self, build_inputs: List[BuilderInput]) -> List[BuilderResult]:
@@ -170,6 +180,7 @@ class LocalBuilder(PyBuilder):
                     build_input.mod,
                     build_input.target,
                     _serialize_params(build_input.params),
+                    self.max_local_memory_bytes,
                 )
                 for build_input in build_inputs
             ],
@@ -217,6 +228,7 @@ def _worker_func(
     mod: IRModule,
     target: Target,
     params: Optional[bytearray],
+    max_local_memory_bytes: Optional[int],
 ) -> str:
     # Step 0. Get the registered functions
     f_build: T_BUILD = get_global_func_with_default_on_worker(
@@ -229,11 +241,28 @@ def _worker_func(
     )
     # Step 1. Build the IRModule
     rt_mod: Module = f_build(mod, target, _deserialize_params(params))
-    # Step 2. Export the Module
+    # Step 2. Reject the kernels which spill
+    if max_local_memory_bytes is not None and target.kind.name == "cuda":
+        _check_local_memory(rt_mod, max_local_memory_bytes)
+    # Step 3. Export the Module
     artifact_path: str = f_export(rt_mod)
     return artifact_path
 
 
+def _check_local_memory(rt_mod: Module, max_local_memory_bytes: int) -> None:
+    # pylint: disable=import-outside-toplevel
+    from tvm.contrib.nvcc import get_kernel_resource_usage
+
+    # pylint: enable=import-outside-toplevel
+    for kernel, usage in get_kernel_resource_usage(rt_mod).items():
+        if usage["local"] > max_local_memory_bytes:
+            raise RuntimeError(
+                f"Kernel {kernel} uses {usage['local']} bytes of local memory per thread with "
+                f"{usage['registers']} registers, more than the limit of "
+                f"{max_local_memory_bytes} bytes"
+            )
+
+
 @register_func("meta_schedule.builder.default_build")
 def default_build(mod: IRModule, target: Target, _params: Optional[Dict[str, NDArray]]) -> Module:
     """Default build function.
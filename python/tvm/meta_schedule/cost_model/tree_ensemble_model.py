@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Gradient boosted trees cost model, trained and evaluated in C++"""
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from ..feature_extractor import FeatureExtractor
+from .cost_model import CostModel
+
+
+@register_object("meta_schedule.TreeEnsembleModel")
+class TreeEnsembleModel(CostModel):
+    """Gradient boosted regression trees fit to the per-store features as XGBModel, with the
+    training and the batched inference in C++, so that it needs no xgboost and no round trip of
+    the features to Python.
+
+    Parameters
+    ----------
+    extractor : FeatureExtractor.FeatureExtractorType
+        The feature extractor for the model.
+    num_warmup_samples : int
+        The number of samples before which the predictions are random.
+    max_depth : int
+        The maximum depth of a tree.
+    num_rounds : int
+        The maximum number of trees.
+    eta : float
+        The learning rate.
+    gamma : float
+        The minimum loss reduction of a split.
+    min_child_weight : float
+        The minimum sum of the hessian of a child.
+    early_stopping_rounds : int
+        The number of rounds with no improvement of the training error after which the
+        training stops.
+    seed : int
+        The random seed of the warmup predictions.
+    """
+
+    def __init__(
+        self,
+        *,
+        extractor: FeatureExtractor.FeatureExtractorType = "per-store-feature",
+        num_warmup_samples: int = 100,
+        max_depth: int = 10,
+        num_rounds: int = 300,
+        eta: float = 0.2,
+        gamma: float = 0.001,
+        min_child_weight: float = 0.0,
+        early_stopping_rounds: int = 50,
+        seed: int = -1,
+    ):
+        if not isinstance(extractor, FeatureExtractor):
+            extractor = FeatureExtractor.create(extractor)
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostModelTreeEnsemble,  # type: ignore # pylint: disable=no-member
+            extractor,
+            num_warmup_samples,
+            max_depth,
+            num_rounds,
+            eta,
+            gamma,
+            min_child_weight,
+            early_stopping_rounds,
+            seed,
+        )
@@ -164,7 +164,7 @@ class TuningRecord(Object):
 class Database(Object):
     """The abstract database interface."""
 
-    DatabaseType = Union["Database", Literal["json", "memory"]]
+    DatabaseType = Union["Database", Literal["json", "binary", "memory"]]
 
     def has_workload(self, mod: IRModule) -> bool:
         """Check if the database has the given workload.
@@ -221,6 +221,25 @@ class Database(Object):
         """
         return _ffi_api.DatabaseGetTopK(self, workload, top_k)  # type: ignore # pylint: disable=no-member
 
+    def get_top_k_similar(self, mod: IRModule, top_k: int) -> List[TuningRecord]:
+        """Get the best valid tuning records of the workloads similar to, but not the same as, the
+        given one, i.e. whose anchor blocks differ only in their loop extents. They are sorted by
+        the distance of the loop extents in log scale, then by run time.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The IRModule to be searched for.
+        top_k : int
+            The number of records to get.
+
+        Returns
+        -------
+        top_k_records : List[TuningRecord]
+            The top K records of similar workloads.
+        """
+        return _ffi_api.DatabaseGetTopKSimilar(self, mod, top_k)  # type: ignore # pylint: disable=no-member
+
     def get_all_tuning_records(self) -> List[TuningRecord]:
         """Get all the tuning records from the database.
 
@@ -380,6 +399,7 @@ class Database(Object):
         kind: Union[
             Literal[
                 "json",
+                "binary",
                 "memory",
                 "union",
                 "ordered_union",
@@ -393,10 +413,10 @@ class Database(Object):
 
         Parameters
         ----------
-        kind : str = "json" | "memory" | "union" | "ordered_union" | Callable[[tvm.tir.Schedule],
-        bool]
+        kind : str = "json" | "binary" | "memory" | "union" | "ordered_union" |
+        Callable[[tvm.tir.Schedule], bool]
             The kind of the database to be created. The following kinds are supported:
-            "json", "memory", "union", "ordered_union", and a custom schedule function.
+            "json", "binary", "memory", "union", "ordered_union", and a custom schedule function.
 
         Returns
         -------
@@ -404,6 +424,7 @@ class Database(Object):
             The created database.
         """
         from . import (  # pylint: disable=import-outside-toplevel
+            BinaryDatabase,
             JSONDatabase,
             MemoryDatabase,
             OrderedUnionDatabase,
@@ -415,6 +436,8 @@ class Database(Object):
             return ScheduleFnDatabase(kind, *args, **kwargs)  # type: ignore
         if kind == "json":
             return JSONDatabase(*args, **kwargs)
+        if kind == "binary":
+            return BinaryDatabase(*args, **kwargs)
         if kind == "memory":
             return MemoryDatabase(*args, **kwargs)  # type: ignore
         if kind == "union":
@@ -28,6 +28,10 @@ from .database import Database
 class JSONDatabase(Database):
     """Database class backed by JSON.
 
+    The files can be shared by several processes, e.g. parallel tuning jobs. The lines are
+    appended under an advisory lock on `<path>.lock`, and each database picks up the workloads
+    and tuning records committed by the other processes when it is queried.
+
     Parameters
     ----------
     path_workload : str
@@ -42,6 +42,22 @@ class Profiler(Object):
         """Get the profiling results in a table format"""
         return _ffi_api.ProfilerTable(self)  # type: ignore # pylint: disable=no-member
 
+    def chrome_trace(self) -> str:
+        """Get the timestamped spans of the search thread, the builder and the runner, per task,
+        in the Chrome trace event format"""
+        return _ffi_api.ProfilerChromeTrace(self)  # type: ignore # pylint: disable=no-member
+
+    def export_chrome_trace(self, path: str) -> None:
+        """Export the spans in the Chrome trace event format, to be loaded by chrome://tracing or
+        Perfetto"""
+        with open(path, "w") as file:
+            file.write(self.chrome_trace())
+
+    def utilization(self) -> str:
+        """Get the busy fraction of the search thread, the builder and the runner, and the time of
+        the spans of each task, in a table format"""
+        return _ffi_api.ProfilerUtilization(self)  # type: ignore # pylint: disable=no-member
+
     def __enter__(self) -> "Profiler":
         """Entering the scope of the context manager"""
         _ffi_api.ProfilerEnterWithScope(self)  # type: ignore # pylint: disable=no-member
@@ -41,6 +41,9 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    cache_flush_bytes: int
+        The number of bytes of device memory to overwrite before each repeat, which flushes the
+        cache of the device, e.g. the L2 cache of a GPU, if it is at least its size. 0 disables it.
 
     Note
     ----
@@ -52,6 +55,7 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 100
     enable_cpu_cache_flush: bool = False
+    cache_flush_bytes: int = 0
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -62,6 +66,7 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            cache_flush_bytes=config.cache_flush_bytes,
         )
         return config
 
@@ -17,7 +17,7 @@
 """Local Runner"""
 import logging
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 import subprocess
 
 import tvm
@@ -165,6 +165,65 @@ def _worker_func(
     return costs
 
 
+def _batched_worker_func(
+    _f_alloc_argument: Optional[str],
+    _f_cleanup: Optional[str],
+    evaluator_config: EvaluatorConfig,
+    alloc_repeat: int,
+    runner_inputs: List[Tuple[str, str, T_ARG_INFO_JSON_OBJ_LIST]],
+) -> List[Union[List[float], str]]:
+    f_alloc_argument: T_ALLOC_ARGUMENT = get_global_func_with_default_on_worker(
+        _f_alloc_argument, default_alloc_argument
+    )
+    f_cleanup: T_CLEANUP = get_global_func_with_default_on_worker(_f_cleanup, default_cleanup)
+    f_evaluate = get_global_func_with_default_on_worker(
+        "runtime.profiling.InterleavedTimeEvaluate", None
+    )
+    results: List[Union[List[float], str]] = [[] for _ in runner_inputs]
+    # The functions to time on each device, with their arguments and the input they belong to
+    batches: Dict[str, Tuple[List[tvm.runtime.PackedFunc], List[T_ARGUMENT_LIST], List[int]]] = {}
+    try:
+        # Step 1: create the local runtime modules and allocate their arguments
+        with Profiler.timeit("LocalRunner/load_module"):
+            for i, (artifact_path, device_type, args_info) in enumerate(runner_inputs):
+                try:
+                    rt_mod = tvm.runtime.load_module(artifact_path)
+                    device = tvm.runtime.device(dev_type=device_type, dev_id=0)
+                    repeated_args = f_alloc_argument(device, args_info, alloc_repeat)
+                except Exception as exception:  # pylint: disable=broad-except
+                    results[i] = "LocalRunner: An exception occurred\n" + str(exception)
+                    continue
+                funcs, args_list, owners = batches.setdefault(device_type, ([], [], []))
+                for args in repeated_args:
+                    funcs.append(rt_mod[rt_mod.entry_name])
+                    args_list.append(args)
+                    owners.append(i)
+        # Step 2: time all the functions of a device in one interleaved run
+        with Profiler.timeit("LocalRunner/run_evaluator"):
+            for device_type, (funcs, args_list, owners) in batches.items():
+                costs = f_evaluate(
+                    funcs,
+                    args_list,
+                    tvm.runtime.device(dev_type=device_type, dev_id=0),
+                    evaluator_config.number,
+                    evaluator_config.repeat,
+                    evaluator_config.min_repeat_ms,
+                    evaluator_config.cache_flush_bytes,
+                )
+                for owner, cost in zip(owners, costs):
+                    if isinstance(results[owner], str):
+                        continue
+                    if isinstance(cost, str):
+                        results[owner] = "LocalRunner: An exception occurred\n" + cost
+                    else:
+                        results[owner].extend(float(c) for c in cost.numpy())
+    finally:
+        # Final step. Always clean up
+        with Profiler.timeit("LocalRunner/cleanup"):
+            f_cleanup()
+    return results
+
+
 @derived_object
 class LocalRunner(PyRunner):
     """Local runner
@@ -183,6 +242,8 @@ class LocalRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    batched: bool
+        Whether to measure all the inputs of a run in one job, see `__init__`.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -230,6 +291,7 @@ class LocalRunner(PyRunner):
     f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None]
     f_run_evaluator: Union[T_RUN_EVALUATOR, str, None]
     f_cleanup: Union[T_CLEANUP, str, None]
+    batched: bool
 
     pool: PopenPoolExecutor
 
@@ -243,6 +305,7 @@ class LocalRunner(PyRunner):
         f_run_evaluator: Union[T_RUN_EVALUATOR, str, None] = None,
         f_cleanup: Union[T_CLEANUP, str, None] = None,
         initializer: Optional[Callable[[], None]] = None,
+        batched: bool = False,
     ) -> None:
         """Constructor
 
@@ -264,6 +327,13 @@ class LocalRunner(PyRunner):
             The function name to cleanup the session or the function itself.
         initializer: Optional[Callable[[], None]]
             The initializer function.
+        batched: bool
+            Whether to measure all the inputs of a run in one job, which loads all the artifacts
+            in the worker process and times them with interleaved repeats on the device, instead
+            of a job per input. The timeout then applies to the whole run, and if the job fails
+            the inputs are measured again one by one. It does not support a custom
+            `f_run_evaluator` or `enable_cpu_cache_flush`, whereas `cache_flush_bytes` of the
+            evaluator config flushes the cache of any device.
         """
         super().__init__()
         self.timeout_sec = timeout_sec
@@ -273,6 +343,14 @@ class LocalRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self.batched = batched
+        if batched and (
+            f_run_evaluator is not None or self.evaluator_config.enable_cpu_cache_flush
+        ):
+            raise ValueError(
+                "LocalRunner: A batched runner supports neither f_run_evaluator nor "
+                "enable_cpu_cache_flush"
+            )
 
         err_path = subprocess.DEVNULL
         if logger.root.level <= logging.DEBUG:
@@ -288,6 +366,10 @@ class LocalRunner(PyRunner):
         self._sanity_check()
 
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        if self.batched and len(runner_inputs) > 1:
+            batched_results = self._run_batched(runner_inputs)
+            if batched_results is not None:
+                return batched_results
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
             future = self.pool.submit(
@@ -314,6 +396,37 @@ class LocalRunner(PyRunner):
             results.append(local_future)  # type: ignore
         return results
 
+    def _run_batched(self, runner_inputs: List[RunnerInput]) -> Optional[List[RunnerFuture]]:
+        future = self.pool.submit(
+            _batched_worker_func,
+            self.f_alloc_argument,
+            self.f_cleanup,
+            self.evaluator_config,
+            self.alloc_repeat,
+            [
+                (
+                    str(runner_input.artifact_path),
+                    str(runner_input.device_type),
+                    tuple(arg_info.as_json() for arg_info in runner_input.args_info),
+                )
+                for runner_input in runner_inputs
+            ],
+        )
+        try:
+            batch: List[Union[List[float], str]] = future.result()
+        except Exception as exception:  # pylint: disable=broad-except
+            logger.warning(
+                "LocalRunner: The batched run failed, measuring one by one instead: %s",
+                exception,
+            )
+            return None
+        return [
+            LocalRunnerFuture(error_message=result)
+            if isinstance(result, str)
+            else LocalRunnerFuture(res=result)
+            for result in batch
+        ]
+
     def _sanity_check(self) -> None:
         def _check(
             f_alloc_argument,
@@ -16,6 +16,7 @@
 # under the License.
 """RPC Runner"""
 import concurrent.futures
+import functools
 import os.path as osp
 from contextlib import contextmanager
 from typing import Callable, List, Optional, Union
@@ -83,6 +84,11 @@ T_CLEANUP = Callable[  # pylint: disable=invalid-name
 ]
 
 
+class RPCWorkerError(Exception):
+    """The RPC worker could not take the job, e.g. it is down or was disconnected before the
+    module was uploaded. The job can be re-queued to another worker."""
+
+
 @derived_object
 class RPCRunnerFuture(PyRunnerFuture):
     """RPC based runner future
@@ -93,12 +99,24 @@ class RPCRunnerFuture(PyRunnerFuture):
         The concurrent function to check when the function is done and to return the result.
     timeout_sec: float
         The timeout in seconds.
+    f_resubmit: Optional[Callable[[], concurrent.futures.Future]]
+        The function to submit the job again, when the worker fails to take it.
+    num_retries_left: int
+        The number of times the job can still be re-queued.
     """
 
     future: concurrent.futures.Future
     timeout_sec: float
+    f_resubmit: Optional[Callable[[], concurrent.futures.Future]]
+    num_retries_left: int
 
-    def __init__(self, future: concurrent.futures.Future, timeout_sec: float) -> None:
+    def __init__(
+        self,
+        future: concurrent.futures.Future,
+        timeout_sec: float,
+        f_resubmit: Optional[Callable[[], concurrent.futures.Future]] = None,
+        max_retries: int = 0,
+    ) -> None:
         """Constructor
 
         Parameters
@@ -107,15 +125,45 @@ class RPCRunnerFuture(PyRunnerFuture):
             The concurrent function to check when the function is done and to return the result.
         timeout_sec: float
             The timeout in seconds.
+        f_resubmit: Optional[Callable[[], concurrent.futures.Future]]
+            The function to submit the job again, when the worker fails to take it.
+        max_retries: int
+            The maximum number of times the job is re-queued.
         """
         super().__init__()
         self.future = future
         self.timeout_sec = timeout_sec
+        self.f_resubmit = f_resubmit
+        self.num_retries_left = max_retries if f_resubmit is not None else 0
+
+    def _requeue_if_worker_failed(self) -> bool:
+        """Re-queue the finished job if its worker timed out or failed to take it.
+
+        Returns
+        -------
+        requeued : bool
+            Whether the job is re-queued.
+        """
+        if self.num_retries_left <= 0:
+            return False
+        exception = self.future.exception()
+        if not isinstance(exception, (TimeoutError, RPCWorkerError)):
+            return False
+        self.num_retries_left -= 1
+        logger.warning(
+            "RPCRunner: Re-queueing the job, %d retries left, after: %s",
+            self.num_retries_left,
+            exception,
+        )
+        self.future = self.f_resubmit()
+        return True
 
     def done(self) -> bool:
-        return self.future.done()
+        return self.future.done() and not self._requeue_if_worker_failed()
 
     def result(self) -> RunnerResult:
+        while self._requeue_if_worker_failed():
+            pass
         try:
             run_secs: List[float] = self.future.result()
         except TimeoutError:
@@ -155,6 +203,8 @@ class RPCRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    max_retries: int
+        The maximum number of times a job is re-queued when its worker fails to take it.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -229,6 +279,7 @@ class RPCRunner(PyRunner):
     f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None]
     f_run_evaluator: Union[T_RUN_EVALUATOR, str, None]
     f_cleanup: Union[T_CLEANUP, str, None]
+    max_retries: int
 
     pool: PopenPoolExecutor
 
@@ -245,6 +296,7 @@ class RPCRunner(PyRunner):
         f_cleanup: Union[T_CLEANUP, str, None] = None,
         max_workers: Optional[int] = None,
         initializer: Optional[Callable[[], None]] = None,
+        max_retries: int = 0,
     ) -> None:
         """Constructor
 
@@ -272,6 +324,10 @@ class RPCRunner(PyRunner):
             The maximum number of connections. Defaults to 1.
         initializer: Optional[Callable[[], None]]
             The initializer function.
+        max_retries: int
+            The maximum number of times a job is re-queued when its worker fails to take it,
+            because the session cannot be created or the module cannot be uploaded, e.g. the
+            worker registered to the tracker is down. The tracker hands out another worker.
         """
         super().__init__()
         self.rpc_config = RPCConfig._normalized(rpc_config)
@@ -283,6 +339,7 @@ class RPCRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self.max_retries = max_retries
         if max_workers is None:
             max_workers = 1
         logger.info("RPCRunner: max_workers = %d", max_workers)
@@ -295,22 +352,26 @@ class RPCRunner(PyRunner):
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
+            f_submit = functools.partial(
+                self.pool.submit,
+                _worker_func,
+                self.f_create_session,
+                self.f_upload_module,
+                self.f_alloc_argument,
+                self.f_run_evaluator,
+                self.f_cleanup,
+                self.rpc_config,
+                self.evaluator_config,
+                self.alloc_repeat,
+                str(runner_input.artifact_path),
+                str(runner_input.device_type),
+                tuple(arg_info.as_json() for arg_info in runner_input.args_info),
+            )
             future = RPCRunnerFuture(
-                future=self.pool.submit(
-                    _worker_func,
-                    self.f_create_session,
-                    self.f_upload_module,
-                    self.f_alloc_argument,
-                    self.f_run_evaluator,
-                    self.f_cleanup,
-                    self.rpc_config,
-                    self.evaluator_config,
-                    self.alloc_repeat,
-                    str(runner_input.artifact_path),
-                    str(runner_input.device_type),
-                    tuple(arg_info.as_json() for arg_info in runner_input.args_info),
-                ),
+                future=f_submit(),
                 timeout_sec=self.rpc_config.session_timeout_sec,
+                f_resubmit=f_submit,
+                max_retries=self.max_retries,
             )
             results.append(future)  # type: ignore
         return results
@@ -383,13 +444,19 @@ def _worker_func(
     with resource_handler():
         # Step 1. Create session
         with Profiler.timeit("RPCRunner/create_session"):
-            session = f_create_session(rpc_config)
-            device = session.device(dev_type=device_type, dev_id=0)
+            try:
+                session = f_create_session(rpc_config)
+                device = session.device(dev_type=device_type, dev_id=0)
+            except Exception as exception:  # pylint: disable=broad-except
+                raise RPCWorkerError(f"Cannot create the session: {exception}") from exception
         # Step 2. Upload the module
         with Profiler.timeit("RPCRunner/upload_module"):
             _, remote_path = osp.split(artifact_path)
             local_path: str = artifact_path
-            rt_mod: Module = f_upload_module(session, local_path, remote_path)
+            try:
+                rt_mod: Module = f_upload_module(session, local_path, remote_path)
+            except Exception as exception:  # pylint: disable=broad-except
+                raise RPCWorkerError(f"Cannot upload the module: {exception}") from exception
         # Step 3: Allocate input arguments
         with Profiler.timeit("RPCRunner/alloc_argument"):
             repeated_args: List[T_ARGUMENT_LIST] = f_alloc_argument(
@@ -107,6 +107,7 @@ def run_evaluator_common(
         number=evaluator_config.number,
         repeat=evaluator_config.repeat,
         min_repeat_ms=evaluator_config.min_repeat_ms,
+        cache_flush_bytes=evaluator_config.cache_flush_bytes,
         f_preproc="cache_flush_cpu_non_first_arg"
         if evaluator_config.enable_cpu_cache_flush
         else "",
@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""blocked_ell_dense scheduling rule for cpu."""
+from typing import List
+
+import tvm
+from tvm.tir.schedule import BlockRV, Schedule
+
+
+def block_rows(sch: Schedule, block: BlockRV) -> int:
+    """Get the number of rows of the weight blocks read by a blocked_ell_dense block."""
+    for region in sch.get(block).reads:
+        if len(region.buffer.shape) == 4:
+            return int(region.buffer.shape[2])
+    raise ValueError("blocked_ell_dense block does not read 4-D weight blocks")
+
+
+def is_static(sch: Schedule, loops) -> bool:
+    return all(isinstance(sch.get(loop).extent, tvm.tir.IntImm) for loop in loops)
+
+
+@tvm.register_func("meta_schedule.cpu.blocked_ell_dense")
+def cpu_blocked_ell_dense_schedule_rule(sch: Schedule, block: BlockRV) -> List[Schedule]:
+    """Schedule the product of data and a Blocked-ELL weight.
+
+    The rows of the data are tiled, with a sampled tile size, and the tiles of rows and the block
+    rows of the weight run in parallel. Within a tile, the weight blocks of the block row are
+    read in the order of their storage, and the rows of each block are vectorized.
+
+    Parameters
+    ----------
+    sch:
+        The initial schedule.
+
+    block:
+        The blocked_ell_dense block.
+
+    Returns
+    -------
+    ret:
+        The scheduled schedule, or the initial one if the shape of the data is symbolic.
+    """
+    bs_r = block_rows(sch, block)
+    *spatial, b, c = sch.get_loops(block)
+    if len(spatial) < 2 or not is_static(sch, spatial):
+        return [sch]
+    n = spatial.pop()
+    m = sch.fuse(*spatial) if len(spatial) > 1 else spatial[0]
+    n_o, n_i = sch.split(n, [None, bs_r])
+    m_o, m_i = sch.split(m, sch.sample_perfect_tile(m, n=2, max_innermost_factor=16))
+    sch.reorder(m_o, n_o, m_i, b, c, n_i)
+    sch.parallel(sch.fuse(m_o, n_o))
+    if bs_r > 1:
+        sch.vectorize(n_i)
+    return [sch]
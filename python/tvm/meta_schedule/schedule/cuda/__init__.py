@@ -16,4 +16,4 @@
 # under the License.
 """Per-block schedule rules in MetaSchedule for target key 'cuda'"""
 
-from . import layout_transform
+from . import blocked_ell_dense, layout_transform
@@ -0,0 +1,60 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""blocked_ell_dense scheduling rule for cuda."""
+from typing import List
+
+import tvm
+from tvm.tir.schedule import BlockRV, Schedule
+
+from ..cpu.blocked_ell_dense import block_rows, is_static
+
+
+@tvm.register_func("meta_schedule.cuda.blocked_ell_dense")
+def cuda_blocked_ell_dense_schedule_rule(sch: Schedule, block: BlockRV) -> List[Schedule]:
+    """Schedule the product of data and a Blocked-ELL weight.
+
+    A thread block computes one block row of the weight for a tile of rows of the data, with a
+    sampled tile size. Each thread accumulates the outputs of one row of the data in registers,
+    while all the threads read the same weight blocks.
+
+    Parameters
+    ----------
+    sch:
+        The initial schedule.
+
+    block:
+        The blocked_ell_dense block.
+
+    Returns
+    -------
+    ret:
+        The scheduled schedule, or the initial one if the shape of the data is symbolic.
+    """
+    bs_r = block_rows(sch, block)
+    *spatial, b, c = sch.get_loops(block)
+    if len(spatial) < 2 or not is_static(sch, spatial):
+        return [sch]
+    n = spatial.pop()
+    m = sch.fuse(*spatial) if len(spatial) > 1 else spatial[0]
+    n_o, n_i = sch.split(n, [None, bs_r])
+    m_o, m_t = sch.split(m, sch.sample_perfect_tile(m, n=2, max_innermost_factor=256))
+    sch.reorder(n_o, m_o, m_t, b, c, n_i)
+    sch.bind(sch.fuse(n_o, m_o), "blockIdx.x")
+    sch.bind(m_t, "threadIdx.x")
+    write_back = sch.cache_write(block, 0, "local")
+    sch.reverse_compute_at(write_back, m_t)
+    return [sch]
@@ -25,19 +25,27 @@ from .schedule_rule import ScheduleRule
 
 
 class ReuseType(NamedTuple):
-    """Reuse type."""
+    """Reuse type.
+
+    The shared memory of the read caches is padded against bank conflicts as a tunable decision
+    if `pad` is set, see `tvm.tir.transform.InjectSharedMemoryPadding`.
+    """
 
     req: str
     levels: List[int]
     scope: str
+    pad: bool = False
 
     def as_dict(self) -> Dict[str, Any]:
         """Return the dict representation of the reuse type."""
-        return {
+        result = {
             "req": self.req,
             "levels": self.levels,
             "scope": self.scope,
         }
+        if self.pad:
+            result["pad"] = True
+        return result
 
 
 @register_object("meta_schedule.MultiLevelTiling")
@@ -44,6 +44,9 @@ class ParallelizeVectorizeUnroll(ScheduleRule):
         Use None to disable unroll
     unroll_explicit: bool
         Whether to explicitly unroll the loop, or just add an "unroll" pragma
+    vectorize_reduction: bool
+        Whether to also vectorize the innermost loop of a reduction block when it is a reduction
+        loop, which is lowered to vector accumulators by VectorizeLoop.
     """
 
     def __init__(
@@ -52,6 +55,7 @@ class ParallelizeVectorizeUnroll(ScheduleRule):
         max_vectorize_extent: int = 16,
         unroll_max_steps: Optional[List[int]] = None,
         unroll_explicit: bool = True,
+        vectorize_reduction: bool = False,
     ) -> None:
         if unroll_max_steps is None:
             unroll_max_steps = []
@@ -61,4 +65,5 @@ class ParallelizeVectorizeUnroll(ScheduleRule):
             max_vectorize_extent,
             unroll_max_steps,
             unroll_explicit,
+            vectorize_reduction,
         )
@@ -33,6 +33,7 @@ class GradientBased(TaskScheduler):
         *,
         alpha: float = 0.2,
         window_size: int = 3,
+        patience: int = 0,
         seed: int = -1,
     ) -> None:
         """Constructor.
@@ -43,6 +44,10 @@ class GradientBased(TaskScheduler):
             The parameter alpha in gradient computation.
         window_size : int = 3
             The parameter to control backward window size in gradient computation.
+        patience : int = 0
+            The number of rounds after which a task whose best latency improves by less than 1%
+            is terminated early, which leaves its remaining trials to the other tasks.
+            0 disables the early termination.
         seed : int = -1
             The random seed.
         """
@@ -51,5 +56,6 @@ class GradientBased(TaskScheduler):
             get_logging_func(logger),
             alpha,
             window_size,
+            patience,
             seed,
         )
@@ -21,6 +21,7 @@ from .build import get_standalone_crt_dir
 from .build import get_microtvm_template_projects
 from .build import copy_crt_config_header
 
+from .graph_arena import plan_graph_arena, GraphArenaPlan
 from .model_library_format import (
     export_model_library_format,
     UnsupportedInModelLibraryFormatError,
@@ -0,0 +1,152 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Offline placement of the graph executor storage in a single arena.
+
+The C runtime graph executor can place every storage entry of a graph in one caller-provided
+buffer (see TVMGraphExecutor_CreateWithArena). This module computes the offset of each storage
+id in that buffer from the storage_id plan of the graph JSON, packing storage entries whose
+lifetimes do not overlap into the same bytes.
+"""
+
+import json
+import typing
+
+from tvm.runtime import DataType
+
+# Keep in sync with TVM_CRT_GRAPH_EXECUTOR_ARENA_ALIGNMENT_BYTES.
+DEFAULT_ALIGNMENT = 16
+
+
+class GraphArenaPlan(typing.NamedTuple):
+    """Placement of the storage ids of a graph in an arena.
+
+    Attributes
+    ----------
+    size : int
+        Number of bytes the arena must hold.
+    offsets : List[int]
+        Byte offset of each storage id in the arena.
+    sizes : List[int]
+        Number of bytes of each storage id, 0 for the linked parameters.
+    """
+
+    size: int
+    offsets: typing.List[int]
+    sizes: typing.List[int]
+
+    def to_c_source(self, name: str) -> str:
+        """Return C definitions of the arena and its offset table, named after `name`."""
+        offsets = ", ".join(str(offset) for offset in self.offsets)
+        return (
+            f"#define {name.upper()}_ARENA_SIZE {max(self.size, 1)}\n"
+            f"static uint8_t {name}_arena[{name.upper()}_ARENA_SIZE] "
+            f"__attribute__((aligned({DEFAULT_ALIGNMENT})));\n"
+            f"static const uint32_t {name}_arena_offsets[{len(self.offsets)}] = {{{offsets}}};\n"
+        )
+
+
+def _storage_lifetimes(graph):
+    """Return the size and the first and last step using each storage id."""
+    attrs = graph["attrs"]
+    storage_ids = attrs["storage_id"][1]
+    shapes = attrs["shape"][1]
+    dtypes = attrs["dltype"][1]
+    row_ptr = graph["node_row_ptr"]
+    num_steps = len(graph["nodes"])
+
+    sizes, first, last = {}, {}, {}
+    for eid, sid in enumerate(storage_ids):
+        dtype = DataType(dtypes[eid])
+        num_elements = 1
+        for dim in shapes[eid]:
+            num_elements *= dim
+        nbytes = (dtype.bits * dtype.lanes + 7) // 8 * num_elements
+        sizes[sid] = max(sizes.get(sid, 0), nbytes)
+
+    def use(eid, step):
+        sid = storage_ids[eid]
+        first[sid] = min(first.get(sid, step), step)
+        last[sid] = max(last.get(sid, step), step)
+
+    for nid, node in enumerate(graph["nodes"]):
+        if node["op"] == "null":
+            # Inputs and parameters are set before the graph runs and kept across runs.
+            use(row_ptr[nid], 0)
+            use(row_ptr[nid], num_steps)
+            continue
+        for input_nid, index, _ in node["inputs"]:
+            use(row_ptr[input_nid] + index, nid)
+        for index in range(row_ptr[nid + 1] - row_ptr[nid]):
+            use(row_ptr[nid] + index, nid)
+    # The outputs are read after the graph ran.
+    for nid, index, _ in graph["heads"]:
+        use(row_ptr[nid] + index, num_steps)
+    return sizes, first, last
+
+
+def plan_graph_arena(graph_json, linked_params=None, alignment=DEFAULT_ALIGNMENT):
+    """Compute the offset of each storage id of a graph in a single arena.
+
+    Storage ids are placed by decreasing size at the lowest aligned offset that does not overlap
+    a storage id live at the same time, as the greedy-by-size algorithm of USMP does.
+
+    Parameters
+    ----------
+    graph_json : str
+        The graph JSON, as returned by get_graph_json() on the executor factory.
+    linked_params : Optional[Iterable[str]]
+        Names of the parameters linked into the module. They are not placed in the arena.
+    alignment : int
+        Alignment of each storage id in the arena.
+
+    Returns
+    -------
+    GraphArenaPlan
+        The size of the arena and the offset of each storage id.
+    """
+    graph = json.loads(graph_json)
+    sizes, first, last = _storage_lifetimes(graph)
+
+    linked_params = set(linked_params or [])
+    for nid, node in enumerate(graph["nodes"]):
+        if node["op"] == "null" and node["name"] in linked_params:
+            sizes[graph["attrs"]["storage_id"][1][graph["node_row_ptr"][nid]]] = 0
+
+    num_storage = max(sizes) + 1 if sizes else 0
+    offsets = [0] * num_storage
+    placed = []
+    arena_size = 0
+    for sid in sorted(sizes, key=lambda sid: (-sizes[sid], sid)):
+        if sizes[sid] == 0:
+            continue
+        conflicts = sorted(
+            (offsets[other], offsets[other] + sizes[other])
+            for other in placed
+            if first[other] <= last[sid] and first[sid] <= last[other]
+        )
+        offset = 0
+        for begin, end in conflicts:
+            if offset + sizes[sid] <= begin:
+                break
+            offset = max(offset, (end + alignment - 1) // alignment * alignment)
+        offsets[sid] = offset
+        placed.append(sid)
+        arena_size = max(arena_size, offset + sizes[sid])
+
+    return GraphArenaPlan(
+        size=arena_size, offsets=offsets, sizes=[sizes.get(sid, 0) for sid in range(num_storage)]
+    )
@@ -17,8 +17,10 @@
 """Relax distributed-related transformations. """
 
 from .transform import (
+    AutoShard,
     PropagateSharding,
     LowerGlobalViewToLocalView,
     LegalizeRedistribute,
     LowerDistIR,
+    BucketCollectives,
 )
@@ -18,9 +18,48 @@
 """Relax distributed-related transformation passes."""
 
 import tvm.ir
+from ..global_info import DeviceMesh
+
 from . import _ffi_api
 
 
+def AutoShard(
+    device_mesh: DeviceMesh, device_flops: float = 1e14, link_bandwidth: float = 1e11
+) -> tvm.ir.transform.Pass:
+    """Choose the sharding of the parameters of each function over a device mesh.
+
+    A sharding annotation propagates along the groups of tensor axes PropagateSharding builds,
+    so the pass chooses for each group of weight axes whether and along which mesh axis it is
+    sharded. The weights are the parameters after the "num_input" runtime inputs of the function,
+    or all its parameters without "num_input". Starting from a replicated plan, the pass
+    repeatedly takes the change of the mesh axis of one group that most reduces the estimated
+    time of the function, until no change reduces it. The time is the compute time of each operator on one device, plus the
+    time of the allreduce of partial results of reductions along a sharded axis and of the
+    allgather of the inputs an operator cannot consume sharded.
+
+    Every tensor parameter is then annotated with R.dist.annotate_sharding, so that
+    PropagateSharding, LowerGlobalViewToLocalView and LegalizeRedistribute lower the plan.
+    Functions that already have sharding annotations are left unchanged.
+
+    Parameters
+    ----------
+    device_mesh : DeviceMesh
+        The device mesh to shard the parameters over.
+
+    device_flops : float
+        The compute throughput of each device, in FLOP/s.
+
+    link_bandwidth : float
+        The bandwidth of the links between the devices, in bytes/s.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.AutoShard(device_mesh, device_flops, link_bandwidth)  # type: ignore
+
+
 def PropagateSharding() -> tvm.ir.transform.Pass:
     """Propagate sharding information.
 
@@ -65,3 +104,27 @@ def LowerDistIR() -> tvm.ir.transform.Pass:
         The registered pass
     """
     return _ffi_api.LowerDistIR()  # type: ignore
+
+
+def BucketCollectives(max_bucket_bytes: int = 4 * 1024 * 1024) -> tvm.ir.transform.Pass:
+    """Fuse small independent collectives into one collective of a flat buffer.
+
+    After LowerDistIR, each sharded operator has its own R.ccl.allreduce or R.ccl.allgather, and
+    at decode time the latency of many small collectives dominates. In each dataflow block, the
+    allreduce ops of the same reduction and dtype, and the allgather ops of the same number of
+    workers and dtype, whose inputs are of static shape and do not depend on each other, are
+    bucketed: their inputs are flattened and concatenated into one buffer, on which a single
+    collective runs, and the result is split and reshaped back. Each bucket is scheduled as soon
+    as its inputs are ready, ahead of the independent compute, which can then overlap with it.
+
+    Parameters
+    ----------
+    max_bucket_bytes : int
+        The maximum size of the flat buffer of a bucket. Larger collectives are left unchanged.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.BucketCollectives(max_bucket_bytes)  # type: ignore
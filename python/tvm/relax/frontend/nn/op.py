@@ -1668,7 +1668,7 @@ def interpolate(
     )
 
 
-def ccl_allreduce(x: Tensor, op_type: str = "sum", name="ccl_allreduce"):
+def ccl_allreduce(x: Tensor, op_type: str = "sum", name="ccl_allreduce", group: str = ""):
     """CCL Allreduce operator
 
     Parameters
@@ -1680,13 +1680,15 @@ def ccl_allreduce(x: Tensor, op_type: str = "sum", name="ccl_allreduce"):
       Now "sum", "prod", "min", "max" and "avg" are supported.
     name : str
         Name hint for this operation.
+    group : str
+      The name of the group of workers to reduce within, or empty for all the workers.
 
     Returns
     -------
     result : Tensor
       The result tensor of allreduce.
     """
-    return wrap_nested(_op.ccl.allreduce(x._expr, op_type), name)
+    return wrap_nested(_op.ccl.allreduce(x._expr, op_type, group), name)
 
 
 def ccl_broadcast_from_worker0(x: Tensor, name="broadcast_from_worker"):
@@ -2660,3 +2662,105 @@ def renormalize_top_p_top_k_prob(prob, sorted_prob, top_p, top_k):
     )
     renorm_prob = filtered_prob / sum(filtered_prob, axis=1, keepdims=True)
     return renorm_prob
+
+
+def apply_penalties_and_softmax(
+    logits: Tensor,
+    indptr: Tensor,
+    token_ids: Tensor,
+    token_cnt: Tensor,
+    penalties: Tensor,
+    temperature: Tensor,
+):
+    """Applies repetition, presence and frequency penalties to a batch of logits
+    and computes the temperature-scaled softmax, all without leaving the device.
+
+    The appeared tokens of each sequence are given as a ragged table in CSR format:
+    the tokens of sequence ``i`` are ``token_ids[indptr[i]:indptr[i + 1]]``,
+    and ``token_cnt`` holds the number of times each of them appeared.
+
+    Notes
+    -----
+    The penalties are applied in place to ``logits``, in a single kernel over the
+    batch. The temperature scaling is fused into the softmax by the compiler.
+    A temperature of zero is treated as a very small temperature, which gives an
+    (almost) one-hot distribution at the argmax.
+
+    Parameters
+    ----------
+    logits : Tensor
+        A 2-D tensor of shape (batch, vocab_size) with the logits of each sequence.
+
+    indptr : Tensor
+        A 1-D int32 tensor of shape (batch + 1,) with the offsets of each sequence
+        in ``token_ids`` and ``token_cnt``.
+
+    token_ids : Tensor
+        A 1-D int32 tensor with the appeared token ids. A token id must appear at most
+        once for each sequence.
+
+    token_cnt : Tensor
+        A 1-D int32 tensor of the same shape as ``token_ids``, with the number of times
+        each token appeared.
+
+    penalties : Tensor
+        A 2-D tensor of shape (batch, 3) with the presence, frequency and repetition
+        penalty of each sequence. Use (0, 0, 1) to disable all of them.
+
+    temperature : Tensor
+        A 2-D tensor of shape (batch, 1) with the temperature of each sequence.
+
+    Returns
+    -------
+    result : Tensor
+        The probabilities with the same shape as ``logits``.
+    """
+    prob_dtype = logits.dtype
+    batch, vocab_size = logits.shape
+
+    @T.prim_func(private=True)
+    def _apply_penalties(
+        var_logits: T.handle,
+        var_indptr: T.handle,
+        var_token_ids: T.handle,
+        var_token_cnt: T.handle,
+        var_penalties: T.handle,
+    ):
+        batch, vocab_size, num_tokens = T.int64(), T.int64(), T.int64()
+        logits = T.match_buffer(var_logits, (batch, vocab_size), prob_dtype)
+        indptr = T.match_buffer(var_indptr, (batch + 1,), "int32")
+        token_ids = T.match_buffer(var_token_ids, (num_tokens,), "int32")
+        token_cnt = T.match_buffer(var_token_cnt, (num_tokens,), "int32")
+        penalties = T.match_buffer(var_penalties, (batch, 3), prob_dtype)
+        for b in range(batch):
+            with T.block("apply_penalties"):
+                vb = T.axis.spatial(batch, b)
+                T.reads(
+                    indptr[vb : vb + 2],
+                    token_ids[0:num_tokens],
+                    token_cnt[0:num_tokens],
+                    penalties[vb, 0:3],
+                    logits[vb, 0:vocab_size],
+                )
+                T.writes(logits[vb, 0:vocab_size])
+                for p in T.serial(indptr[vb], indptr[vb + 1]):
+                    # repetition penalty, then presence and frequency penalties
+                    logits[vb, token_ids[p]] = (
+                        T.if_then_else(
+                            logits[vb, token_ids[p]] > T.cast(0, prob_dtype),
+                            logits[vb, token_ids[p]] / penalties[vb, 2],
+                            logits[vb, token_ids[p]] * penalties[vb, 2],
+                        )
+                        - T.cast(token_cnt[p], prob_dtype) * penalties[vb, 1]
+                        - penalties[vb, 0]
+                    )
+
+    logits = tensor_ir_inplace_op(
+        _apply_penalties,
+        "apply_penalties",
+        args=[logits, indptr, token_ids, token_cnt, penalties],
+        inplace_indices=[0],
+        out=Tensor.placeholder([batch, vocab_size], prob_dtype),
+    )
+    temperature = maximum(temperature, Tensor.from_scalar(1e-5, temperature.dtype))
+    return softmax(logits / temperature, axis=-1)
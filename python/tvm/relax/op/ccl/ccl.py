@@ -23,7 +23,7 @@ from ...expr import Expr
 from ....ir import PrimExpr
 
 
-def allreduce(x, op_type: str = "sum"):  # pylint: disable=invalid-name
+def allreduce(x, op_type: str = "sum", group: str = ""):  # pylint: disable=invalid-name
     """Allreduce operator
 
     Parameters
@@ -33,6 +33,9 @@ def allreduce(x, op_type: str = "sum"):  # pylint: disable=invalid-name
     op_type: str
       The type of reduction operation to be applied to the input data.
       Now "sum", "prod", "min", "max" and "avg" are supported.
+    group: str
+      The name of the group of workers to reduce within, created by
+      `Session.init_ccl_group`, or empty for all the workers.
 
     Returns
     -------
@@ -44,10 +47,12 @@ def allreduce(x, op_type: str = "sum"):  # pylint: disable=invalid-name
         "Allreduce only supports limited reduction operations, "
         f"including {supported_op_types}, but got {op_type}."
     )
-    return _ffi_api.allreduce(x, op_type)  # type: ignore # pylint: disable=no-member
+    return _ffi_api.allreduce(x, op_type, group)  # type: ignore # pylint: disable=no-member
 
 
-def allgather(x, num_workers: Union[int, PrimExpr, PrimValue]):  # pylint: disable=invalid-name
+def allgather(
+    x, num_workers: Union[int, PrimExpr, PrimValue], group: str = ""
+):  # pylint: disable=invalid-name
     """AllGather operator
 
     Parameters
@@ -58,6 +63,10 @@ def allgather(x, num_workers: Union[int, PrimExpr, PrimValue]):  # pylint: disab
     num_worker : Union[int, PrimExpr, PrimValue]
       The number of workers to gather data from.
 
+    group: str
+      The name of the group of workers to gather within, created by
+      `Session.init_ccl_group`, or empty for all the workers.
+
     Returns
     -------
     result : relax.Expr
@@ -65,7 +74,7 @@ def allgather(x, num_workers: Union[int, PrimExpr, PrimValue]):  # pylint: disab
     """
     if not isinstance(num_workers, PrimValue):
         num_workers = PrimValue(num_workers)
-    return _ffi_api.allgather(x, num_workers)  # type: ignore # pylint: disable=no-member
+    return _ffi_api.allgather(x, num_workers, group)  # type: ignore # pylint: disable=no-member
 
 
 def broadcast_from_worker0(x: Expr) -> Expr:
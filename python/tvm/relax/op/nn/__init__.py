@@ -38,6 +38,7 @@ from .nn import (
     layer_norm,
     leakyrelu,
     log_softmax,
+    lora_bgmv,
     max_pool1d,
     max_pool2d,
     max_pool3d,
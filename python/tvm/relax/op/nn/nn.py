@@ -1950,3 +1950,41 @@ def attention_var_len(
         causal_mask,
         window_size,
     )  # type: ignore
+
+
+def lora_bgmv(data: Expr, lora_a: Expr, lora_b: Expr, adapter_indices: Expr) -> Expr:
+    r"""Compute the LoRA update of a batch of tokens, each with its own adapter.
+
+    The A and B matrices of all the adapters are stacked, and each token gathers those of its
+    adapter (batched gather matrix-vector multiplication, BGMV):
+
+    .. math::
+
+        out[t, :] = lora\_b[i_t] \cdot (lora\_a[i_t] \cdot data[t, :]), \quad
+        i_t = adapter\_indices[t]
+
+    so that a batch mixing the tokens of several adapters runs in a single forward pass. The
+    update of the tokens of a negative index, without an adapter, is zero. The scaling of each
+    adapter is expected to be folded into its B matrix, and adapters of a smaller rank to be
+    padded with zeros.
+
+    Parameters
+    ----------
+    data : relax.Expr
+        The input tokens, of shape `(num_tokens, in_features)`.
+
+    lora_a : relax.Expr
+        The A matrices of the adapters, of shape `(num_adapters, rank, in_features)`.
+
+    lora_b : relax.Expr
+        The B matrices of the adapters, of shape `(num_adapters, out_features, rank)`.
+
+    adapter_indices : relax.Expr
+        The adapter of each token, an integer tensor of shape `(num_tokens,)`.
+
+    Returns
+    -------
+    result : relax.Expr
+        The LoRA update, of shape `(num_tokens, out_features)`.
+    """
+    return _ffi_api.lora_bgmv(data, lora_a, lora_b, adapter_indices)  # type: ignore
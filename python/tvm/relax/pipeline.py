@@ -27,7 +27,7 @@ from tvm import meta_schedule as ms
 from . import transform, backend
 
 
-def zero_pipeline(*, enable_warning: bool = False):
+def zero_pipeline(*, enable_warning: bool = False, fuse_epilogue: bool = False):
     """Wrapper function that returns the zero pipeline.
 
     Parameters
@@ -38,6 +38,11 @@ def zero_pipeline(*, enable_warning: bool = False):
         not registered,
         * in MetaScheduleApplyDatabase pass, for TIR functions now showing up in
         the database. By default we don't print warning.
+
+    fuse_epilogue : bool
+        A boolean value indicating if to fuse the bias, activation, residual add and
+        quantization following a matmul or conv2d into the kernel of that matmul or conv2d.
+        See FuseEpilogue.
     """
 
     @tvm.transform.module_pass(opt_level=0)
@@ -57,8 +62,10 @@ def zero_pipeline(*, enable_warning: bool = False):
         mod: tvm.ir.IRModule
             The result transformed module.
         """
+        passes = [transform.FuseEpilogue()] if fuse_epilogue else []
         seq = tvm.transform.Sequential(
-            [
+            passes
+            + [
                 transform.LegalizeOps(enable_warning=enable_warning),
                 transform.AnnotateTIROpPattern(),
                 transform.FoldConstant(),
@@ -88,6 +95,7 @@ def default_build_pipeline():
                 transform.ToNonDataflow(),
                 transform.RemovePurityChecking(),
                 transform.CallTIRRewrite(),
+                transform.AssignStreams(),
                 transform.StaticPlanBlockMemory(),
                 transform.RewriteCUDAGraph(),
                 transform.LowerAllocTensor(),
@@ -21,7 +21,9 @@ from .transform import (
     AllocateWorkspace,
     AlterOpImpl,
     AnnotateTIROpPattern,
+    AssignStreams,
     AttachGlobalSymbol,
+    AutoPlaceVDevice,
     BindParams,
     BindSymbolicVars,
     BundleModelParams,
@@ -47,6 +49,7 @@ from .transform import (
     FuseTIR,
     FusionPattern,
     Gradient,
+    HorizontalFuseTIR,
     InlinePrivateFunctions,
     KillAfterLastUse,
     LambdaLift,
@@ -70,9 +73,11 @@ from .transform import (
     ReorderTakeAfterMatmul,
     RewriteCUDAGraph,
     RewriteDataflowReshape,
+    RewriteSliceToView,
     RunCodegen,
     SplitCallTIRByPattern,
     StaticPlanBlockMemory,
+    StreamParamChains,
     ToMixedPrecision,
     ToNonDataflow,
     TopologicalSort,
@@ -84,12 +89,19 @@ from .transform import (
     function_pass,
 )
 
+from .async_ccl_rewrite import AsyncCCLRewrite
 from .ipc_allreduce_rewrite import IPCAllReduceRewrite
 from .lazy_transform_params import LazyTransformParams
 from .lower_gpu_ipc_alloc_storage import LowerGPUIPCAllocStorage
 from .optimize_layout_transform import OptimizeLayoutTransform
 from .remove_redundant_reshape import RemoveRedundantReshape
+from .specialize_shapes import SpecializeShapes
 from .fast_math import FastMathTransform
+from .fuse_epilogue import FuseEpilogue
+from .group_quantize import GroupQuantizeWeights
+from .block_sparse import DenseToBlockSparse
+from .plan_layout import PlanLayout
+from .mixed_precision_plan import ApplyMixedPrecisionPlan, calibrate_mixed_precision
 from .attach_external_modules import AttachExternModules
 
 # Import to register the legalization functions.
@@ -0,0 +1,128 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Rewrite the collective operations of disco into asynchronous ones, so that they run
+on the communication stream while the following independent computation runs.
+"""
+
+from typing import Dict, List, Tuple
+
+import tvm
+from tvm import relax
+from tvm.ir.module import IRModule
+
+_ASYNC_CCL_FUNCS = {
+    # name: (async name, number of arguments)
+    "runtime.disco.allreduce": ("runtime.disco.allreduce_async", 3),
+    "runtime.disco.allgather": ("runtime.disco.allgather_async", 2),
+}
+
+
+@tvm.transform.module_pass(opt_level=0, name="AsyncCCLRewrite")
+class AsyncCCLRewrite:
+    """Rewrite `runtime.disco.allreduce` and `runtime.disco.allgather` into their asynchronous
+    variants, and place the matching `runtime.disco.wait` right before the first later binding
+    that uses the buffers of the operation, or at the end of the binding block.
+
+    The buffers are passed to the wait as well, so that the memory planner keeps them alive
+    until then. The pass therefore runs after the collective operations are lowered to
+    `call_packed` with explicit outputs, and before `StaticPlanBlockMemory`.
+    """
+
+    def transform_module(self, mod: IRModule, _ctx: tvm.transform.PassContext) -> IRModule:
+        """IRModule-level transformation"""
+        updates = {}
+        for g_var, func in mod.functions_items():
+            if not isinstance(func, relax.Function) or not isinstance(func.body, relax.SeqExpr):
+                continue
+            blocks = [_rewrite_block(block) for block in func.body.blocks]
+            if all(new is old for new, old in zip(blocks, func.body.blocks)):
+                continue
+            body = relax.SeqExpr(blocks, func.body.body, func.body.span)
+            updates[g_var] = relax.Function(
+                func.params, body, func.ret_struct_info, func.is_pure, func.attrs, func.span
+            )
+        if not updates:
+            return mod
+        mod = mod.clone()
+        for g_var, func in updates.items():
+            mod[g_var] = func
+        return mod
+
+
+def _rewrite_block(block: relax.BindingBlock) -> relax.BindingBlock:
+    if isinstance(block, relax.DataflowBlock):
+        return block
+
+    alias_root: Dict[relax.Var, relax.Var] = {}
+    reshape_op = tvm.ir.Op.get("relax.reshape")
+
+    def root(var: relax.Var) -> relax.Var:
+        return alias_root.get(var, var)
+
+    def wait(handle: relax.Var, buffers: List[relax.Var]) -> relax.VarBinding:
+        call = relax.Call(relax.ExternFunc("runtime.disco.wait"), [handle, *buffers])
+        return relax.VarBinding(relax.Var("_", relax.ObjectStructInfo()), call)
+
+    rewritten = False
+    bindings: List[relax.Binding] = []
+    # The pending asynchronous operations, with the roots of the buffers they use.
+    pending: List[Tuple[relax.Var, List[relax.Var], List[relax.Var]]] = []
+    for binding in block.bindings:
+        value = binding.value
+        used = {root(var) for var in relax.analysis.free_vars(value)}
+        still_pending = []
+        for handle, buffers, roots in pending:
+            if any(r in used for r in roots):
+                bindings.append(wait(handle, buffers))
+            else:
+                still_pending.append((handle, buffers, roots))
+        pending = still_pending
+
+        if isinstance(binding, relax.VarBinding):
+            if isinstance(value, relax.Var):
+                alias_root[binding.var] = root(value)
+            elif (
+                isinstance(value, relax.Call)
+                and value.op == reshape_op
+                and isinstance(value.args[0], relax.Var)
+            ):
+                alias_root[binding.var] = root(value.args[0])
+
+        if (
+            isinstance(binding, relax.VarBinding)
+            and isinstance(value, relax.Call)
+            and isinstance(value.op, relax.ExternFunc)
+            and value.op.global_symbol in _ASYNC_CCL_FUNCS
+        ):
+            async_name, num_args = _ASYNC_CCL_FUNCS[value.op.global_symbol]
+            buffers = [value.args[0], value.args[-1]]
+            if len(value.args) == num_args and all(isinstance(b, relax.Var) for b in buffers):
+                call = relax.Call(
+                    relax.ExternFunc(async_name), value.args, value.attrs, value.sinfo_args
+                )
+                handle = binding.var
+                bindings.append(relax.VarBinding(handle, call))
+                pending.append((handle, buffers, [root(b) for b in buffers]))
+                rewritten = True
+                continue
+        bindings.append(binding)
+
+    for handle, buffers, _ in pending:
+        bindings.append(wait(handle, buffers))
+    if not rewritten:
+        return block
+    return relax.BindingBlock(bindings, block.span)
@@ -0,0 +1,201 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Conversion of the pruned constant weights of matmul ops to block-sparse products."""
+from typing import Optional, Sequence, Tuple
+
+import numpy as np
+
+import tvm
+from tvm import IRModule, relax, topi
+from tvm.relax import Call, Expr, PyExprMutator, expr_functor
+
+BLOCKED_ELL_DENSE_NAME_HINT = "blocked_ell_dense"
+
+
+def _nonzero_blocks(weight: np.ndarray, block_size: Tuple[int, int]):
+    """Split a 2-D weight into blocks, of shape (N / bs_r, K / bs_c, bs_r, bs_c), and return the
+    blocks and the mask of the nonzero ones."""
+    bs_r, bs_c = block_size
+    n, k = weight.shape
+    blocks = weight.reshape(n // bs_r, bs_r, k // bs_c, bs_c).transpose(0, 2, 1, 3)
+    return blocks, np.any(blocks != 0, axis=(2, 3))
+
+
+def pack_blocked_ell(
+    weight: np.ndarray, block_size: Tuple[int, int]
+) -> Tuple[np.ndarray, np.ndarray]:
+    """Pack a 2-D weight of shape (N, K) in the Blocked-ELL format of topi.nn.blocked_ell_dense.
+
+    Each block row holds as many blocks as the densest block row of the weight. The nonzero
+    blocks of a block row are stored in the order of their columns, followed by zero blocks of
+    column 0.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        The weight, whose shape is a multiple of the block size.
+
+    block_size : Tuple[int, int]
+        The number of rows and columns of the blocks.
+
+    Returns
+    -------
+    data : numpy.ndarray
+        The blocks, of shape (N / bs_r, blocks_per_row, bs_r, bs_c).
+
+    indices : numpy.ndarray
+        The int32 block column of each block, of shape (N / bs_r, blocks_per_row).
+    """
+    bs_r, bs_c = block_size
+    if weight.ndim != 2 or weight.shape[0] % bs_r != 0 or weight.shape[1] % bs_c != 0:
+        raise ValueError(
+            f"The weight of shape {weight.shape} cannot be split into {block_size} blocks"
+        )
+    blocks, nonzero = _nonzero_blocks(weight, block_size)
+    num_block_rows = blocks.shape[0]
+    blocks_per_row = max(1, int(nonzero.sum(axis=1).max()))
+    data = np.zeros((num_block_rows, blocks_per_row, bs_r, bs_c), weight.dtype)
+    indices = np.zeros((num_block_rows, blocks_per_row), "int32")
+    for row in range(num_block_rows):
+        cols = np.flatnonzero(nonzero[row])
+        data[row, : len(cols)] = blocks[row, cols]
+        indices[row, : len(cols)] = cols
+    return data, indices
+
+
+def choose_block_size(
+    weight: np.ndarray, block_sizes: Sequence[Tuple[int, int]]
+) -> Optional[Tuple[Tuple[int, int], float]]:
+    """Choose the block size of the Blocked-ELL weight with the least stored elements.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        The 2-D weight.
+
+    block_sizes : Sequence[Tuple[int, int]]
+        The candidate block sizes. Those which do not divide the shape of the weight are skipped,
+        and ties go to the larger blocks.
+
+    Returns
+    -------
+    ret : Optional[Tuple[Tuple[int, int], float]]
+        The block size and the ratio of the stored elements, padding included, to the elements
+        of the weight, or None if no block size divides the shape of the weight.
+    """
+    best = None
+    for bs_r, bs_c in block_sizes:
+        if weight.shape[0] % bs_r != 0 or weight.shape[1] % bs_c != 0:
+            continue
+        _, nonzero = _nonzero_blocks(weight, (bs_r, bs_c))
+        blocks_per_row = max(1, int(nonzero.sum(axis=1).max()))
+        density = nonzero.shape[0] * blocks_per_row * bs_r * bs_c / weight.size
+        if best is None or (density, -bs_r * bs_c) < (best[1], -best[0][0] * best[0][1]):
+            best = ((bs_r, bs_c), density)
+    return best
+
+
+@expr_functor.mutator
+class BlockSparseMutator(PyExprMutator):
+    """Replace the matmul ops of sparse constant weights by Blocked-ELL products."""
+
+    def __init__(
+        self, mod: IRModule, block_sizes: Sequence[Tuple[int, int]], sparsity_threshold: float
+    ):
+        super().__init__(mod)
+        self.block_sizes = block_sizes
+        self.sparsity_threshold = sparsity_threshold
+
+    def _as_weight(self, expr: Expr) -> Optional[np.ndarray]:
+        """Return the weight of shape (N, K) of a matmul whose rhs is `expr`."""
+        if isinstance(expr, relax.Constant):
+            return expr.data.numpy().T
+        if isinstance(expr, relax.Var):
+            value = self.lookup_binding(expr)
+            if isinstance(value, Call) and value.op.same_as(tvm.ir.Op.get("relax.permute_dims")):
+                axes = value.attrs.axes
+                if axes is not None and [int(axis) for axis in axes] != [1, 0]:
+                    return None
+                if isinstance(value.args[0], relax.Constant):
+                    return value.args[0].data.numpy()
+        return None
+
+    def visit_call_(self, call: Call) -> Expr:  # pylint: disable=arguments-renamed
+        call = self.visit_expr_post_order(call)
+        if not isinstance(call.op, tvm.ir.Op) or call.op.name != "relax.matmul":
+            return call
+        rhs_sinfo = call.args[1].struct_info
+        if not isinstance(rhs_sinfo, relax.TensorStructInfo) or rhs_sinfo.ndim != 2:
+            return call
+
+        weight = self._as_weight(call.args[1])
+        if weight is None or weight.dtype.kind != "f":
+            return call
+        choice = choose_block_size(weight, self.block_sizes)
+        if choice is None or choice[1] > 1 - self.sparsity_threshold:
+            return call
+
+        data, indices = pack_blocked_ell(weight, choice[0])
+        return self.builder_.call_te(
+            topi.nn.blocked_ell_dense,
+            call.args[0],
+            relax.const(data),
+            relax.const(indices),
+            call.struct_info.dtype,
+            primfunc_name_hint=BLOCKED_ELL_DENSE_NAME_HINT,
+        )
+
+
+@tvm.transform.module_pass(opt_level=0, name="DenseToBlockSparse")
+class DenseToBlockSparse:  # pylint: disable=too-few-public-methods
+    """Convert the matmul ops of pruned constant weights to block-sparse products.
+
+    The rhs of a matmul, or of a matmul of its transpose, is converted if it is a 2-D float
+    constant, e.g. a parameter bound by BindParams, whose Blocked-ELL packing stores at most
+    `1 - sparsity_threshold` of its elements. The block size is the candidate of the least
+    stored elements. The matmul is replaced by a call to topi.nn.blocked_ell_dense, whose
+    PrimFunc MetaSchedule tunes with the "blocked_ell_dense" schedule rule of the target.
+
+    Parameters
+    ----------
+    block_sizes : Sequence[Tuple[int, int]]
+        The candidate block sizes, as (rows, columns) of the weight of shape (N, K).
+
+    sparsity_threshold : float
+        The minimum ratio of the elements of a weight that its packing must skip.
+    """
+
+    def __init__(
+        self,
+        block_sizes: Sequence[Tuple[int, int]] = ((16, 1), (8, 1), (4, 4), (4, 1)),
+        sparsity_threshold: float = 0.5,
+    ):
+        self.block_sizes = [tuple(block_size) for block_size in block_sizes]
+        self.sparsity_threshold = sparsity_threshold
+
+    def transform_module(self, mod: IRModule, _ctx: tvm.transform.PassContext) -> IRModule:
+        """Entrypoint"""
+        mutator = BlockSparseMutator(mod, self.block_sizes, self.sparsity_threshold)
+        for gv, func in mod.functions_items():
+            if not isinstance(func, relax.Function):
+                continue
+            if func.attrs and "Primitive" in func.attrs and func.attrs["Primitive"] != 0:
+                continue
+            func = mutator.visit_expr(func)
+            mutator.builder_.update_func(gv, func)
+        return mutator.builder_.get()
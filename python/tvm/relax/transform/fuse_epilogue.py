@@ -0,0 +1,158 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Fuse the epilogue of matmul and conv2d into the producing operation.
+
+FuseOps only fuses an out-elemwise-fusable operation, such as matmul, into consumers that
+post-dominate it through elementwise and broadcast operations, so chains like
+matmul + bias + activation + residual add + quantize may end up in several kernels, each of which
+reads and writes a full tensor. This pass groups such chains, before legalization, into a
+primitive function that LegalizeOps and FuseTIR then turn into a single PrimFunc. The
+dequantization of a weight quantized by GroupQuantizeWeights is grouped with the matmul reading
+it as well, so that the weight is decoded in the matmul kernel.
+"""
+from typing import List, Optional
+
+from tvm import IRModule, relax
+from tvm.ir import structural_equal
+from tvm.ir.transform import PassContext, module_pass
+from tvm.relax.dpl import DFPattern, GlobalVarPattern, is_op, wildcard
+
+from .group_quantize import DEQUANTIZE_NAME_HINT
+from .transform import FuseOpsByPattern, FusionPattern, PatternCheckContext
+
+_PRODUCER_OPS = ["relax.matmul", "relax.nn.conv2d"]
+_PROLOGUE_OPS = ["relax.permute_dims", "relax.call_tir"]
+
+DEFAULT_ACTIVATIONS = [
+    "relax.nn.relu",
+    "relax.nn.gelu",
+    "relax.nn.gelu_tanh",
+    "relax.nn.silu",
+    "relax.sigmoid",
+    "relax.tanh",
+]
+
+
+def make_epilogue_pattern(activations: List[str]) -> DFPattern:
+    """Create the pattern of a matmul or conv2d followed by its epilogue.
+
+    The epilogue is an optional bias add, an optional activation, an optional residual add and
+    an optional cast or quantization, in this order. The weight of the matmul may be
+    transposed, and dequantized by the PrimFunc GroupQuantizeWeights emits.
+
+    Parameters
+    ----------
+    activations : List[str]
+        The names of the activation Relax ops that may appear in the epilogue.
+
+    Returns
+    -------
+    pattern : DFPattern
+        The resulting pattern. It also matches the producer alone, which the check of
+        FuseEpilogue rejects unless its weight is dequantized.
+    """
+    lhs = wildcard()
+    rhs = wildcard()
+    dequantize = is_op("relax.call_tir")(GlobalVarPattern(DEQUANTIZE_NAME_HINT), wildcard())
+    weight = dequantize | rhs
+    weight = is_op("relax.permute_dims")(weight) | weight
+    out = is_op("relax.matmul")(lhs, weight) | is_op("relax.nn.conv2d")(lhs, rhs)
+
+    out = is_op("relax.add")(out, wildcard()) | out
+    activated = out
+    for name in activations:
+        activated = is_op(name)(out) | activated
+    out = activated
+
+    residual = wildcard()
+    out = is_op("relax.add")(out, residual) | is_op("relax.add")(residual, out) | out
+    out = is_op("relax.astype")(out) | is_op("relax.quantize")(out, wildcard(), wildcard()) | out
+    return out
+
+
+def _check_epilogue(context: PatternCheckContext) -> bool:
+    """Check the matched chain has an epilogue that can be computed with the producer."""
+    from tvm.relax.backend.utils import (  # pylint: disable=import-outside-toplevel
+        has_leaking_intermediate_variables,
+    )
+
+    ops = [call.op.name for call in context.matched_bindings.values()]
+    if context.matched_expr.op.name in _PRODUCER_OPS and "relax.call_tir" not in ops:
+        return False
+    if has_leaking_intermediate_variables(context):
+        return False
+
+    producers = [
+        call for call in context.matched_bindings.values() if call.op.name in _PRODUCER_OPS
+    ]
+    if len(producers) != 1:
+        return False
+    shape = producers[0].struct_info.shape
+    if shape is None:
+        return False
+
+    # Each epilogue op must write exactly one element per output element of the producer, so
+    # that the epilogue can be inlined into the producer once fused.
+    for call in context.matched_bindings.values():
+        if call.op.name in _PROLOGUE_OPS or call.op.name in _PRODUCER_OPS:
+            continue
+        sinfo = call.struct_info
+        if not isinstance(sinfo, relax.TensorStructInfo) or sinfo.shape is None:
+            return False
+        if not structural_equal(sinfo.shape, shape):
+            return False
+    return True
+
+
+@module_pass(opt_level=0, name="FuseEpilogue")
+class FuseEpilogue:  # pylint: disable=too-few-public-methods
+    """Group each matmul or conv2d with its epilogue into a primitive function.
+
+    The epilogue is an optional bias add, activation, residual add and cast or quantization, of
+    the same shape as the matmul or conv2d output. The grouped functions have the "Primitive"
+    attribute, so that, once legalized, FuseTIR fuses each of them into a single PrimFunc, in
+    which the epilogue can be inlined into the producer. This pass must run before LegalizeOps.
+
+    Parameters
+    ----------
+    activations : Optional[List[str]]
+        The names of the activation Relax ops fused into the epilogue. Defaults to
+        DEFAULT_ACTIVATIONS.
+
+    entry_functions : Optional[List[str]]
+        The set of entry functions to start from.
+    """
+
+    def __init__(
+        self,
+        activations: Optional[List[str]] = None,
+        entry_functions: Optional[List[str]] = None,
+    ):
+        if activations is None:
+            activations = DEFAULT_ACTIVATIONS
+        self.pattern = FusionPattern(
+            "epilogue", make_epilogue_pattern(list(activations)), check=_check_epilogue
+        )
+        self.entry_functions = entry_functions
+
+    def transform_module(self, mod: IRModule, _ctx: PassContext) -> IRModule:
+        """Entrypoint"""
+        return FuseOpsByPattern(
+            [self.pattern],
+            bind_constants=False,
+            entry_functions=self.entry_functions,
+        )(mod)
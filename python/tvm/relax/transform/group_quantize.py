@@ -0,0 +1,267 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Group-wise weight-only quantization of the matmul weights."""
+from typing import Optional, Tuple
+
+import tvm
+from tvm import IRModule, relax, te, tir
+from tvm.relax import Call, Expr, PyExprMutator, expr_functor
+
+# The PrimFunc name hints, also used by FuseEpilogue to find the dequantization of a weight.
+QUANTIZE_NAME_HINT = "group_quantize"
+DEQUANTIZE_NAME_HINT = "group_dequantize"
+
+
+def _at(tensor: te.Tensor, axis: int, reduce_index, other_index):
+    """Read a 2-D tensor whose reduction axis is `axis`."""
+    if axis == 0:
+        return tensor[reduce_index, other_index]
+    return tensor[other_index, reduce_index]
+
+
+class GroupQuantizeSpec:
+    """The storage of group-wise quantized weights.
+
+    Each group of `group_size` consecutive weights along the reduction axis of the matmul shares
+    one scale, of the weight dtype. The weights are quantized symmetrically to signed integers
+    of `bits` bits, biased by 2^(bits-1)-1 and packed into uint32 words along the reduction axis.
+
+    Parameters
+    ----------
+    bits : int
+        The number of bits of each quantized weight, 4 or 8.
+
+    group_size : int
+        The number of weights sharing a scale.
+    """
+
+    def __init__(self, bits: int = 4, group_size: int = 32):
+        if bits not in (4, 8):
+            raise ValueError(f"Only 4 and 8 bit quantization is supported, but got {bits}")
+        self.bits = bits
+        self.group_size = group_size
+        self.elems_per_word = 32 // bits
+        self.max_int = (1 << (bits - 1)) - 1
+        if group_size % self.elems_per_word != 0:
+            raise ValueError(
+                f"The group size {group_size} must be a multiple of the number of "
+                f"{bits}-bit values per uint32 word"
+            )
+
+    def supports(self, shape, axis: int) -> bool:
+        """Whether a weight of the given shape can be quantized along the given axis."""
+        if len(shape) != 2 or not all(isinstance(dim, tir.IntImm) for dim in shape):
+            return False
+        return int(shape[axis]) % self.group_size == 0
+
+    def quantize(self, weight: te.Tensor, axis: int) -> Tuple[te.Tensor, te.Tensor]:
+        """Quantize a 2-D weight along `axis`, returning the packed weight and the scales."""
+
+        def with_reduce_extent(extent):
+            shape = list(weight.shape)
+            shape[axis] = extent
+            return shape
+
+        def weight_f32(reduce_index, other_index):
+            return _at(weight, axis, reduce_index, other_index).astype("float32")
+
+        num_groups = weight.shape[axis] // self.group_size
+        r = te.reduce_axis((0, self.group_size), name="r")
+        max_abs = te.compute(
+            with_reduce_extent(num_groups),
+            lambda *i: te.max(
+                te.abs(weight_f32(i[axis] * self.group_size + r, i[1 - axis])), axis=r
+            ),
+            name="max_abs",
+        )
+        scale = te.compute(
+            max_abs.shape,
+            lambda *i: (max_abs(*i) / self.max_int).astype(weight.dtype),
+            name="scale",
+        )
+
+        def quantized(reduce_index, other_index):
+            s = _at(scale, axis, reduce_index // self.group_size, other_index).astype("float32")
+            q = tir.if_then_else(
+                s == 0, tir.const(0, "float32"), te.round(weight_f32(reduce_index, other_index) / s)
+            )
+            max_q = tir.const(self.max_int, "float32")
+            q = tir.Max(tir.Min(q, max_q), -max_q)
+            return (q + self.max_int).astype("uint32")
+
+        epw = self.elems_per_word
+        k = te.reduce_axis((0, epw), name="k")
+        packed = te.compute(
+            with_reduce_extent(weight.shape[axis] // epw),
+            lambda *i: te.sum(
+                quantized(i[axis] * epw + k, i[1 - axis]) << (k.astype("uint32") * self.bits),
+                axis=k,
+            ),
+            name="packed",
+        )
+        return packed, scale
+
+    def dequantize(self, packed: te.Tensor, scale: te.Tensor, axis: int, shape) -> te.Tensor:
+        """Unpack and scale the weight of the given shape quantized along `axis`."""
+
+        def f_dequantize(*i):
+            reduce_index, other_index = i[axis], i[1 - axis]
+            word = _at(packed, axis, reduce_index // self.elems_per_word, other_index)
+            shift = (reduce_index % self.elems_per_word).astype("uint32") * self.bits
+            q = (word >> shift) & tir.const((1 << self.bits) - 1, "uint32")
+            s = _at(scale, axis, reduce_index // self.group_size, other_index)
+            return (q.astype(scale.dtype) - tir.const(self.max_int, scale.dtype)) * s
+
+        return te.compute(shape, f_dequantize, name="dequantize")
+
+
+@expr_functor.mutator
+class GroupQuantizeMutator(PyExprMutator):
+    """Quantize the weights of the matmul ops of a function."""
+
+    def __init__(self, mod: IRModule, spec: GroupQuantizeSpec):
+        super().__init__(mod)
+        self.spec = spec
+        self.weights = set()
+        self.quantized = {}
+
+    def transform(self, func: relax.Function) -> relax.Function:
+        num_input = None
+        if func.attrs and "num_input" in func.attrs:
+            num_input = func.attrs["num_input"].value
+        # Without "num_input", every parameter may be a runtime input, so only the constants
+        # are known to be weights.
+        self.weights = set(func.params[num_input:]) if num_input is not None else set()
+        return self.visit_expr(func)
+
+    def visit_dataflow_block_(self, block: relax.DataflowBlock) -> relax.BindingBlock:
+        # The quantized weights are dataflow vars, which are not visible from other blocks.
+        self.quantized = {}
+        return super().visit_dataflow_block_(block)
+
+    def _as_weight(self, expr: Expr) -> Optional[Tuple[Expr, int]]:
+        """Return the weight read by the rhs of a matmul and its reduction axis."""
+        if isinstance(expr, relax.Constant) or expr in self.weights:
+            return expr, 0
+        if isinstance(expr, relax.Var):
+            value = self.lookup_binding(expr)
+            if isinstance(value, Call) and value.op.same_as(tvm.ir.Op.get("relax.permute_dims")):
+                weight = value.args[0]
+                axes = value.attrs.axes
+                if axes is not None and [int(axis) for axis in axes] != [1, 0]:
+                    return None
+                if isinstance(weight, relax.Constant) or weight in self.weights:
+                    return weight, 1
+        return None
+
+    def _quantize(self, weight: Expr, axis: int) -> Tuple[Expr, Expr]:
+        key = (weight, axis)
+        if key not in self.quantized:
+            quantized = self.builder_.emit(
+                self.builder_.call_te(
+                    self.spec.quantize, weight, axis, primfunc_name_hint=QUANTIZE_NAME_HINT
+                )
+            )
+            # The quantization of the parameters is lifted into transform_params by
+            # LiftTransformParams, the dequantization must stay next to the matmul it feeds.
+            self.quantized[key] = tuple(
+                self.builder_.emit(
+                    relax.op.builtin.stop_lift_params(
+                        self.builder_.emit(relax.TupleGetItem(quantized, index))
+                    )
+                )
+                for index in range(2)
+            )
+        return self.quantized[key]
+
+    def _dequantize(self, weight: Expr, axis: int) -> Expr:
+        # Each matmul dequantizes the weight on its own, so that FuseEpilogue can fuse every
+        # dequantization into the matmul reading it.
+        packed, scale = self._quantize(weight, axis)
+        return self.builder_.emit(
+            self.builder_.call_te(
+                self.spec.dequantize,
+                packed,
+                scale,
+                axis,
+                weight.struct_info.shape.values,
+                primfunc_name_hint=DEQUANTIZE_NAME_HINT,
+            )
+        )
+
+    def visit_call_(self, call: Call) -> Expr:  # pylint: disable=arguments-renamed
+        call = self.visit_expr_post_order(call)
+        if not isinstance(call.op, tvm.ir.Op) or call.op.name != "relax.matmul":
+            return call
+
+        weight_and_axis = self._as_weight(call.args[1])
+        if weight_and_axis is None:
+            return call
+        weight, axis = weight_and_axis
+        sinfo = weight.struct_info
+        if (
+            not isinstance(sinfo, relax.TensorStructInfo)
+            or sinfo.dtype not in ("float16", "bfloat16", "float32")
+            or sinfo.shape is None
+            or not self.spec.supports(sinfo.shape.values, axis)
+        ):
+            return call
+
+        rhs = self._dequantize(weight, axis)
+        if axis == 1:
+            rhs = self.builder_.emit(relax.op.permute_dims(rhs))
+        return relax.op.matmul(call.args[0], rhs, out_dtype=call.attrs.out_dtype)
+
+
+@tvm.transform.module_pass(opt_level=0, name="GroupQuantizeWeights")
+class GroupQuantizeWeights:  # pylint: disable=too-few-public-methods
+    """Quantize the weights of matmul ops group-wise to 4 or 8 bits.
+
+    The rhs of a matmul, or of a matmul of its transpose, is a weight if it is a constant or a
+    parameter of a function after its "num_input" runtime inputs. Each weight is replaced by its
+    quantization, of GroupQuantizeSpec layout, followed by its dequantization. LiftTransformParams
+    then moves the quantization of the parameters into transform_params, and FoldConstant
+    quantizes the constants, so the model only reads the packed weights and their scales.
+    FuseEpilogue fuses each dequantization into the matmul reading it.
+
+    Weights of other shapes than 2-D, or whose reduction axis is not a multiple of the group
+    size, are left unchanged.
+
+    Parameters
+    ----------
+    bits : int
+        The number of bits of each quantized weight, 4 or 8.
+
+    group_size : int
+        The number of consecutive weights along the reduction axis sharing a scale.
+    """
+
+    def __init__(self, bits: int = 4, group_size: int = 32):
+        self.spec = GroupQuantizeSpec(bits, group_size)
+
+    def transform_module(self, mod: IRModule, _ctx: tvm.transform.PassContext) -> IRModule:
+        """Entrypoint"""
+        mutator = GroupQuantizeMutator(mod, self.spec)
+        for gv, func in mod.functions_items():
+            if not isinstance(func, relax.Function):
+                continue
+            if func.attrs and "Primitive" in func.attrs and func.attrs["Primitive"] != 0:
+                continue
+            func = mutator.transform(func)
+            mutator.builder_.update_func(gv, func)
+        return mutator.builder_.get()
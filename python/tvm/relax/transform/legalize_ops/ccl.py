@@ -18,7 +18,7 @@
 """Default legalization function for ccl operators."""
 from tvm import tir, arith, topi
 from ...block_builder import BlockBuilder
-from ...expr import Call, Expr, ShapeExpr
+from ...expr import Call, Expr, ShapeExpr, StringImm
 from ...op import call_dps_packed
 from ...struct_info import TensorStructInfo, ShapeStructInfo
 from .common import register_legalize
@@ -39,6 +39,12 @@ def _allreduce(_bb: BlockBuilder, call: Call) -> Expr:
             f"Unsupported reduction operation: {op_type_str}. "
             f"Supported operations are {op_type_map.keys()}."
         )
+    if call.attrs.group:
+        return call_dps_packed(
+            "runtime.disco.allreduce_group",
+            [call.args[0], ShapeExpr([op_type_map[op_type_str]]), StringImm(call.attrs.group)],
+            out_sinfo=call.args[0].struct_info,
+        )
     return call_dps_packed(
         "runtime.disco.allreduce",
         [call.args[0], ShapeExpr([op_type_map[op_type_str]])],
@@ -60,15 +66,16 @@ def _allgather(_bb: BlockBuilder, call: Call) -> Expr:
             output_shape.append(shape_value * call.args[1].value)
         else:
             output_shape.append(shape_value)
-    return call_dps_packed(
-        "runtime.disco.allgather",
-        call.args[0],
-        out_sinfo=TensorStructInfo(
-            shape=output_shape,
-            dtype=arg_sinfo.dtype,
-            vdevice=arg_sinfo.vdevice,
-        ),
+    out_sinfo = TensorStructInfo(
+        shape=output_shape, dtype=arg_sinfo.dtype, vdevice=arg_sinfo.vdevice
     )
+    if call.attrs is not None and call.attrs.group:
+        return call_dps_packed(
+            "runtime.disco.allgather_group",
+            [call.args[0], StringImm(call.attrs.group)],
+            out_sinfo=out_sinfo,
+        )
+    return call_dps_packed("runtime.disco.allgather", call.args[0], out_sinfo=out_sinfo)
 
 
 @register_legalize("relax.ccl.broadcast_from_worker0")
@@ -114,4 +114,16 @@ def _einsum(bb: BlockBuilder, call: Call) -> Expr:
     fields = (
         t.fields if isinstance(t, Tuple) else [bb.emit(TupleGetItem(t, i)) for i in range(n_field)]
     )
+    # An einsum of more operands becomes a sequence of pairwise contractions, each in its own
+    # function so that it is scheduled as a matmul.
+    path = topi.einsum_contraction_path(
+        call.attrs.subscripts, *[field.struct_info.shape.values for field in fields]
+    )
+    operands = list(fields)
+    for step, (lhs, rhs, equation) in enumerate(path):
+        if step + 1 == len(path):
+            return bb.call_te(topi.einsum, equation, operands[lhs], operands[rhs])
+        result = bb.emit_te(topi.einsum, equation, operands[lhs], operands[rhs])
+        operands = [operand for i, operand in enumerate(operands) if i not in (lhs, rhs)]
+        operands.append(result)
     return bb.call_te(topi.einsum, call.attrs.subscripts, *fields)
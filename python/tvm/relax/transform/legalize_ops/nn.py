@@ -690,6 +690,46 @@ def _nn_attention_var_len(bb: BlockBuilder, call: Call) -> Expr:
     raise RuntimeError("Legalization of attention_var_len op is not supported yet.")
 
 
+def _te_lora_bgmv(
+    data: te.Tensor, lora_a: te.Tensor, lora_b: te.Tensor, adapter_indices: te.Tensor
+):
+    num_tokens, in_features = data.shape
+    rank = lora_a.shape[1]
+    out_features = lora_b.shape[1]
+    acc_dtype = "float32" if data.dtype in ["float16", "bfloat16"] else data.dtype
+
+    def adapter(t):
+        # Tokens without an adapter read the first one, and their update is masked out.
+        return tir.max(adapter_indices[t], tir.const(0, adapter_indices.dtype))
+
+    k = te.reduce_axis((0, in_features), name="k")
+    shrink = te.compute(
+        (num_tokens, rank),
+        lambda t, r: te.sum(
+            data[t, k].astype(acc_dtype) * lora_a[adapter(t), r, k].astype(acc_dtype), axis=k
+        ),
+        name="lora_shrink",
+    )
+    j = te.reduce_axis((0, rank), name="j")
+    expand = te.compute(
+        (num_tokens, out_features),
+        lambda t, o: te.sum(shrink[t, j] * lora_b[adapter(t), o, j].astype(acc_dtype), axis=j),
+        name="lora_expand",
+    )
+    return te.compute(
+        (num_tokens, out_features),
+        lambda t, o: tir.Select(
+            adapter_indices[t] >= 0, expand[t, o], tir.const(0, acc_dtype)
+        ).astype(data.dtype),
+        name="T_lora_bgmv",
+    )
+
+
+@register_legalize("relax.nn.lora_bgmv")
+def _nn_lora_bgmv(bb: BlockBuilder, call: Call) -> Expr:
+    return bb.call_te(_te_lora_bgmv, *call.args, primfunc_name_hint="lora_bgmv")
+
+
 @register_legalize("relax.nn.nll_loss")
 def _nn_nll_loss(bb: BlockBuilder, call: Call) -> Expr:
     def nll_loss_without_weight(predictions, targets, reduction, ignore_index):
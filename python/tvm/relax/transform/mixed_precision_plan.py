@@ -0,0 +1,261 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Calibration-driven mixed precision.
+
+ToMixedPrecision casts every op of a fixed policy to fp16. Instead, calibrate_mixed_precision
+measures, on representative inputs, the error each gemm or conv adds to the outputs of a function
+when computed in each low precision dtype, and greedily casts the ops of largest estimated
+speedup per unit of error while the error of the outputs stays under a budget. The resulting plan
+is stored in the "mixed_precision_plan" attribute of the function, from which
+ApplyMixedPrecisionPlan casts the ops, so that builds are reproducible without calibrating again.
+"""
+from typing import Dict, List, Optional, Sequence
+
+import numpy as np
+
+import tvm
+from tvm import IRModule, relax, tir
+from tvm.ir import Op
+from tvm.relax import Call, Expr, PyExprMutator, expr_functor
+
+MIXED_PRECISION_PLAN_ATTR = "mixed_precision_plan"
+
+# The speedup of a gemm or conv computed in each dtype over float32.
+DEFAULT_SPEEDUPS = {"float16": 2.0, "bfloat16": 2.0, "e4m3_float8": 4.0, "e5m2_float8": 4.0}
+
+
+def _op_makers():
+    return {
+        "relax.matmul": relax.op.matmul,
+        "relax.nn.conv1d": relax.op.nn.conv1d,
+        "relax.nn.conv2d": relax.op.nn.conv2d,
+        "relax.nn.conv3d": relax.op.nn.conv3d,
+        "relax.nn.conv1d_transpose": relax.op.nn.conv1d_transpose,
+        "relax.nn.conv2d_transpose": relax.op.nn.conv2d_transpose,
+    }
+
+
+def _is_candidate(call: Expr) -> bool:
+    """Whether the call is a float32 gemm or conv that can be computed in low precision."""
+    if not isinstance(call, Call) or not isinstance(call.op, Op):
+        return False
+    if call.op.name not in _op_makers():
+        return False
+    sinfo = call.struct_info
+    return isinstance(sinfo, relax.TensorStructInfo) and sinfo.dtype == "float32"
+
+
+def _candidate_sites(func: relax.Function) -> Dict[str, Call]:
+    """Get the candidate calls of a function by the name of the var they are bound to.
+
+    Calls bound to a var whose name is not unique are left out, as a plan cannot refer to them.
+    """
+    sites = {}
+    names = []
+
+    def visit(expr):
+        if not isinstance(expr, relax.SeqExpr):
+            return
+        for block in expr.blocks:
+            for binding in block.bindings:
+                names.append(binding.var.name_hint)
+                if isinstance(binding, relax.VarBinding) and _is_candidate(binding.value):
+                    sites[binding.var.name_hint] = binding.value
+
+    relax.analysis.post_order_visit(func.body, visit)
+    return {name: call for name, call in sites.items() if names.count(name) == 1}
+
+
+def _estimate_flops(call: Call) -> float:
+    def num_elements(sinfo):
+        num = 1
+        for dim in sinfo.shape.values:
+            num *= int(dim) if isinstance(dim, tir.IntImm) else 1
+        return num
+
+    out_sinfo = call.struct_info
+    if out_sinfo.shape is None or call.args[1].struct_info.shape is None:
+        return 1.0
+    if call.op.name == "relax.matmul":
+        k = call.args[0].struct_info.shape.values[-1]
+        return 2.0 * num_elements(out_sinfo) * (int(k) if isinstance(k, tir.IntImm) else 1)
+    weight_shape = call.args[1].struct_info.shape.values
+    out_channels = weight_shape[call.attrs.kernel_layout.index("O")]
+    out_channels = int(out_channels) if isinstance(out_channels, tir.IntImm) else 1
+    return 2.0 * num_elements(out_sinfo) * num_elements(call.args[1].struct_info) / out_channels
+
+
+@expr_functor.mutator
+class _MixedPrecisionPlanApplier(PyExprMutator):
+    """Compute the calls of a plan in their dtype, accumulating in float32."""
+
+    def __init__(self, mod: IRModule, plan: Dict[str, str]):
+        super().__init__(mod)
+        self.plan = plan
+
+    def visit_var_binding_(self, binding: relax.VarBinding) -> None:
+        dtype = self.plan.get(binding.var.name_hint)
+        if dtype is None or not _is_candidate(binding.value):
+            super().visit_var_binding_(binding)
+            return
+        call = binding.value
+        args = [
+            self.builder_.emit(relax.op.astype(self.visit_expr(arg), dtype)) for arg in call.args
+        ]
+        fields = {key: call.attrs[key] for key in call.attrs.keys()}
+        fields["out_dtype"] = "float32"
+        new_value = self.builder_.normalize(_op_makers()[call.op.name](*args, **fields))
+        # The output is still float32 of the same shape, so the var is kept.
+        self.builder_.emit_normalized(relax.VarBinding(binding.var, new_value))
+
+
+@tvm.transform.module_pass(opt_level=0, name="ApplyMixedPrecisionPlan")
+class ApplyMixedPrecisionPlan:  # pylint: disable=too-few-public-methods
+    """Cast the gemm and conv ops of the "mixed_precision_plan" attribute of each function.
+
+    The plan maps the name of the var each op is bound to, to the dtype the inputs of the op are
+    cast to. The op still accumulates and outputs in float32.
+    """
+
+    def transform_module(self, mod: IRModule, _ctx: tvm.transform.PassContext) -> IRModule:
+        """Entrypoint"""
+        for gv, func in mod.functions_items():
+            if not isinstance(func, relax.Function) or not func.attrs:
+                continue
+            if MIXED_PRECISION_PLAN_ATTR not in func.attrs:
+                continue
+            plan = {str(k): str(v) for k, v in func.attrs[MIXED_PRECISION_PLAN_ATTR].items()}
+            mutator = _MixedPrecisionPlanApplier(mod, plan)
+            func = mutator.visit_expr(func)
+            mutator.builder_.update_func(gv, func)
+            mod = mutator.builder_.get()
+        return mod
+
+
+def _run(mod: IRModule, func_name: str, inputs, target, dev) -> List[List[np.ndarray]]:
+    """Run the function on each set of inputs, returning its flattened tensor outputs."""
+    mod = ApplyMixedPrecisionPlan()(mod)
+    vm = relax.VirtualMachine(relax.build(mod, target=target), dev)
+
+    def flatten(value):
+        if isinstance(value, tvm.nd.NDArray):
+            return [value.numpy()]
+        if isinstance(value, (list, tuple, tvm.ir.Array)):
+            return [array for field in value for array in flatten(field)]
+        return []
+
+    return [
+        flatten(vm[func_name](*[tvm.nd.array(arr, dev) for arr in args])) for args in inputs
+    ]
+
+
+def _relative_error(outputs, reference) -> float:
+    error = 0.0
+    for outs, refs in zip(outputs, reference):
+        for out, ref in zip(outs, refs):
+            ref = ref.astype("float64")
+            diff = np.linalg.norm(out.astype("float64") - ref)
+            error = max(error, diff / max(np.linalg.norm(ref), np.finfo("float64").tiny))
+    return error
+
+
+def calibrate_mixed_precision(
+    mod: IRModule,
+    inputs: Sequence[Sequence[np.ndarray]],
+    error_budget: float,
+    func_name: str = "main",
+    dtypes: Sequence[str] = ("float16", "bfloat16"),
+    target="llvm",
+    dev: Optional[tvm.runtime.Device] = None,
+    speedups: Optional[Dict[str, float]] = None,
+) -> IRModule:
+    """Choose the dtype of each gemm and conv of a function under an error budget.
+
+    The function is first run in float32 on the representative inputs. Then, for each float32
+    matmul or conv and each candidate dtype, the function is run with only this op computed in
+    the dtype, which measures the error the op adds to the outputs. The (op, dtype) pairs are
+    ranked by the time they save, estimated from the FLOPs of the op and the speedup of the dtype,
+    per unit of error, and greedily added to the plan as long as the error of the outputs of the
+    whole plan, measured by running it, is within the budget.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module, of float32 ops.
+
+    inputs : Sequence[Sequence[np.ndarray]]
+        The representative inputs, each a list of the arguments of the function.
+
+    error_budget : float
+        The maximum relative L2 error of each output of the function, over all inputs.
+
+    func_name : str
+        The function to calibrate.
+
+    dtypes : Sequence[str]
+        The candidate dtypes. The float8 dtypes require a target supporting them.
+
+    target : Union[str, tvm.target.Target]
+        The target the function is run on for calibration.
+
+    dev : Optional[tvm.runtime.Device]
+        The device the function is run on. Defaults to the device of the target.
+
+    speedups : Optional[Dict[str, float]]
+        The speedup of an op computed in each dtype over float32. Defaults to DEFAULT_SPEEDUPS.
+
+    Returns
+    -------
+    mod : IRModule
+        The module whose function has the "mixed_precision_plan" attribute, a map from the name
+        of the var each cast op is bound to, to its dtype. Run ApplyMixedPrecisionPlan to cast
+        the ops.
+    """
+    if dev is None:
+        dev = tvm.device(str(tvm.target.Target(target).kind), 0)
+    speedups = {**DEFAULT_SPEEDUPS, **(speedups or {})}
+    func = mod[func_name]
+    sites = _candidate_sites(func)
+
+    def with_plan(plan: Dict[str, str]) -> IRModule:
+        annotated = mod.clone()
+        annotated[func_name] = func.with_attr(MIXED_PRECISION_PLAN_ATTR, plan)
+        return annotated
+
+    def error_of(plan: Dict[str, str]) -> float:
+        return _relative_error(_run(with_plan(plan), func_name, inputs, target, dev), reference)
+
+    reference = _run(mod, func_name, inputs, target, dev)
+    ranked = []
+    for name, call in sites.items():
+        flops = _estimate_flops(call)
+        for dtype in dtypes:
+            error = error_of({name: dtype})
+            saved = flops * (1.0 - 1.0 / speedups[dtype])
+            ranked.append((saved / max(error, np.finfo("float64").tiny), name, dtype))
+    # Sort by decreasing saving per error, breaking ties by the order of the sites and dtypes.
+    ranked.sort(key=lambda item: -item[0])
+
+    plan: Dict[str, str] = {}
+    for _, name, dtype in ranked:
+        if name in plan:
+            continue
+        candidate = {**plan, name: dtype}
+        if error_of(candidate) <= error_budget:
+            plan = candidate
+    return with_plan(plan)
@@ -0,0 +1,180 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Choose the layouts ConvertLayout converts to with a cost model of the whole graph."""
+import itertools
+from typing import Callable, Dict, List, Optional
+
+from tvm import IRModule, relax, tir
+from tvm.ir import Op
+from tvm.ir.transform import PassContext, module_pass
+from tvm.runtime import DataType
+
+from .transform import ConvertLayout
+
+DEFAULT_CANDIDATE_LAYOUTS = {
+    "relax.nn.conv2d": [["NHWC", "OHWI"], ["NHWC", "HWIO"]],
+}
+
+_CONV_OPS = ["relax.nn.conv1d", "relax.nn.conv2d", "relax.nn.conv3d"]
+
+
+def _num_elements(sinfo) -> Optional[int]:
+    if not isinstance(sinfo, relax.TensorStructInfo) or sinfo.shape is None:
+        return None
+    shape = sinfo.shape.values if isinstance(sinfo.shape, relax.ShapeExpr) else None
+    if shape is None or not all(isinstance(dim, tir.IntImm) for dim in shape):
+        return None
+    num_elements = 1
+    for dim in shape:
+        num_elements *= int(dim)
+    return num_elements
+
+
+def _num_bytes(sinfo) -> Optional[int]:
+    num_elements = _num_elements(sinfo)
+    if num_elements is None or sinfo.dtype == "":
+        return None
+    dtype = DataType(sinfo.dtype)
+    return num_elements * ((dtype.bits * dtype.lanes + 7) // 8)
+
+
+class LayoutCostModel:
+    """Estimate the time of the Relax ops of a module from their layout.
+
+    Each op is bound either by its compute or by its memory traffic. The compute of a convolution
+    is vectorized along the innermost axis of its output, so that an innermost extent smaller
+    than the vector width wastes the remaining lanes: NCHW suits feature maps of large spatial
+    extent, NHWC those of many channels. The layout transforms ConvertLayout inserts are bound
+    by memory traffic, except those of constants, which FoldConstant folds.
+
+    Parameters
+    ----------
+    vector_lanes : int
+        The number of elements of a vector of the target.
+
+    peak_flops : float
+        The compute throughput of the target, in FLOP/s.
+
+    memory_bandwidth : float
+        The memory bandwidth of the target, in bytes/s.
+    """
+
+    def __init__(
+        self, vector_lanes: int = 16, peak_flops: float = 1e11, memory_bandwidth: float = 2e10
+    ):
+        self.vector_lanes = vector_lanes
+        self.peak_flops = peak_flops
+        self.memory_bandwidth = memory_bandwidth
+
+    def memory_time(self, call: relax.Call) -> float:
+        """The time to read the tensor arguments and write the output of the call."""
+        num_bytes = _num_bytes(call.struct_info) or 0
+        for arg in call.args:
+            num_bytes += _num_bytes(arg.struct_info) or 0
+        return num_bytes / self.memory_bandwidth
+
+    def conv_time(self, call: relax.Call) -> float:
+        """The time of a convolution, from its FLOPs and the vectorization of its output."""
+        out_elements = _num_elements(call.struct_info)
+        weight_elements = _num_elements(call.args[1].struct_info)
+        if out_elements is None or weight_elements is None:
+            return self.memory_time(call)
+        weight_shape = call.args[1].struct_info.shape.values
+        num_out_channels = int(weight_shape[call.attrs.kernel_layout.index("O")])
+        flops = 2 * out_elements * weight_elements // num_out_channels
+        innermost = int(call.struct_info.shape.values[-1])
+        efficiency = min(1.0, innermost / self.vector_lanes)
+        return max(flops / (self.peak_flops * efficiency), self.memory_time(call))
+
+    def __call__(self, call: relax.Call) -> float:
+        if call.op == Op.get("relax.permute_dims") and isinstance(call.args[0], relax.Constant):
+            return 0.0
+        if call.op.name in _CONV_OPS:
+            return self.conv_time(call)
+        if call.op == Op.get("relax.matmul"):
+            out_elements = _num_elements(call.struct_info)
+            lhs_sinfo = call.args[0].struct_info
+            if out_elements is not None and _num_elements(lhs_sinfo) is not None:
+                flops = 2 * out_elements * int(lhs_sinfo.shape.values[-1])
+                return max(flops / self.peak_flops, self.memory_time(call))
+        return self.memory_time(call)
+
+
+def estimate_module_time(mod: IRModule, cost_model: Callable[[relax.Call], float]) -> float:
+    """Sum the estimated time of the op calls of the Relax functions of a module."""
+    total = 0.0
+
+    def visit(expr):
+        nonlocal total
+        if isinstance(expr, relax.Call) and isinstance(expr.op, Op):
+            total += cost_model(expr)
+
+    for func in mod.functions.values():
+        if isinstance(func, relax.Function):
+            relax.analysis.post_order_visit(func.body, visit)
+    return total
+
+
+@module_pass(opt_level=0, name="PlanLayout")
+class PlanLayout:  # pylint: disable=too-few-public-methods
+    """Choose the desired layouts of ConvertLayout with a cost model, and convert to them.
+
+    Every combination of a candidate layout, or no conversion, per layout-sensitive op is applied
+    with ConvertLayout, which propagates the layouts to the ops in between and inserts the layout
+    transforms at the boundaries. The converted module of least estimated time, including that of
+    the layout transforms, is kept. Candidates are chosen per op, not per call.
+
+    ConvertLayout only swaps axes, so the candidates are permutations such as NHWC: packed layouts
+    such as NCHW16c are not supported.
+
+    Parameters
+    ----------
+    candidate_layouts : Optional[Dict[str, List[List[str]]]]
+        For each op, the candidate desired layouts, in the format of ConvertLayout. Defaults to
+        DEFAULT_CANDIDATE_LAYOUTS.
+
+    cost_model : Optional[Callable[[relax.Call], float]]
+        The estimated time of an op call. Defaults to LayoutCostModel().
+    """
+
+    def __init__(
+        self,
+        candidate_layouts: Optional[Dict[str, List[List[str]]]] = None,
+        cost_model: Optional[Callable[[relax.Call], float]] = None,
+    ):
+        if candidate_layouts is None:
+            candidate_layouts = DEFAULT_CANDIDATE_LAYOUTS
+        self.candidate_layouts = candidate_layouts
+        self.cost_model = cost_model if cost_model is not None else LayoutCostModel()
+
+    def transform_module(self, mod: IRModule, _ctx: PassContext) -> IRModule:
+        """Entrypoint"""
+        ops = list(self.candidate_layouts.keys())
+        best_mod = mod
+        best_time = estimate_module_time(mod, self.cost_model)
+        choices = [[None] + list(self.candidate_layouts[op]) for op in ops]
+        for combination in itertools.product(*choices):
+            desired_layouts = {
+                op: layouts for op, layouts in zip(ops, combination) if layouts is not None
+            }
+            if not desired_layouts:
+                continue
+            converted = ConvertLayout(desired_layouts)(mod)
+            time = estimate_module_time(converted, self.cost_model)
+            if time < best_time:
+                best_mod, best_time = converted, time
+        return best_mod
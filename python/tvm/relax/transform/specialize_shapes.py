@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A pass that adds the variants of Relax functions specialized to given argument shapes."""
+from typing import Dict, List, Optional, Sequence
+
+import tvm
+from tvm import relax
+from tvm.ir import IRModule
+from tvm.ir.transform import PassContext, module_pass
+
+ShapeSignature = Sequence[Optional[Sequence[int]]]
+
+
+def _bind_shape_signature(func: relax.Function, signature: ShapeSignature) -> relax.Function:
+    if len(signature) != len(func.params):
+        raise ValueError(
+            f"The signature {signature} has {len(signature)} arguments, "
+            f"but the function has {len(func.params)} parameters"
+        )
+    binding: Dict[tvm.tir.Var, int] = {}
+    for param, shape in zip(func.params, signature):
+        sinfo = param.struct_info
+        if shape is None or not isinstance(sinfo, relax.TensorStructInfo):
+            continue
+        if not isinstance(sinfo.shape, relax.ShapeExpr):
+            continue
+        if len(sinfo.shape.values) != len(shape):
+            raise ValueError(f"The shape {shape} does not match the parameter {param}")
+        for dim, value in zip(sinfo.shape.values, shape):
+            if not isinstance(dim, tvm.tir.Var):
+                continue
+            if dim in binding and binding[dim] != int(value):
+                raise ValueError(
+                    f"The signature {signature} binds {dim} to both {binding[dim]} and {value}"
+                )
+            binding[dim] = int(value)
+    return func.bind_symbolic_vars(binding)
+
+
+@module_pass(opt_level=0, name="SpecializeShapes")
+class SpecializeShapes:  # pylint: disable=too-few-public-methods
+    """Add the variants of Relax functions specialized to given argument shapes.
+
+    The symbolic variables in the shapes of the tensor parameters are bound to the dimensions of
+    the signature, so that the kernels called by the variant are compiled with static extents.
+    The variant of the i-th signature of a function `f` is the public function
+    `f_specialized_{i}`, which :py:meth:`tvm.runtime.relax_vm.VirtualMachine.set_shape_variant`
+    dispatches the calls of `f` of these shapes to.
+
+    Parameters
+    ----------
+    signatures : Dict[str, List[Sequence[Optional[Sequence[int]]]]]
+        The signatures of each function, each being the shape of each argument, or None for an
+        argument which is not a tensor, as reported by
+        :py:meth:`tvm.runtime.relax_vm.VirtualMachine.get_shape_signatures`.
+    """
+
+    def __init__(self, signatures: Dict[str, List[ShapeSignature]]):
+        self.signatures = signatures
+
+    def transform_module(self, mod: IRModule, _ctx: PassContext) -> IRModule:
+        """Entrypoint"""
+        mod = mod.clone()
+        for func_name, signatures in self.signatures.items():
+            func = mod[func_name]
+            if not isinstance(func, relax.Function):
+                raise TypeError(f"{func_name} is not a Relax function")
+            for index, signature in enumerate(signatures):
+                name = f"{func_name}_specialized_{index}"
+                variant = _bind_shape_signature(func, signature)
+                mod[name] = variant.with_attr("global_symbol", name)
+        return mod
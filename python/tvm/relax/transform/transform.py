@@ -281,7 +281,11 @@ def DataflowUseInplaceCalls() -> tvm.ir.transform.Pass:
     (generally, these are elementwise operations) into in-place implementations.
     Supported operators will be replaced by calls to `call_tir_inplace` that invoke
     in-place PrimFunc implementations of those operators (which are based on the legalizations of
-    those operators).
+    those operators). Calls to elementwise PrimFuncs through `call_tir`, such as fused
+    functions, are replaced by `call_tir_inplace` calls to in-place versions of the PrimFuncs.
+
+    Liveness is analyzed over the whole function, so values defined in an earlier binding block
+    can be overwritten in a later dataflow block once they are no longer used.
 
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
@@ -383,6 +387,59 @@ def LazySetOutput() -> tvm.ir.transform.Pass:
     return _ffi_api.LazySetOutput()
 
 
+def StreamParamChains(num_concurrent_chains: int = 1) -> tvm.ir.transform.Pass:
+    """A pass that transforms the parameters one chain at a time.
+
+    After LazyGetInput and LazySetOutput, a parameter transformation
+    function loads each parameter with `fget_param` and hands each
+    output to `fset_output`, but in the order of the original
+    bindings, which may load many raw parameters before producing any
+    output.  This pass reorders the bindings so that the chains that
+    produce each output, from the loads of the parameters it reads to
+    the call to `fset_output`, are emitted `num_concurrent_chains` at
+    a time.  Each raw parameter is then dead, and freed by
+    KillAfterLastUse, as soon as the chains reading it are done, so
+    that the peak memory is a few parameters rather than the whole
+    model.
+
+    Within each group of chains, the loads come first and the outputs
+    last, so that AssignStreams can run the kernels of the
+    independent chains of a group on different streams.  Impure
+    bindings other than the calls to the callbacks are kept in place.
+
+    .. code-block:: python
+
+        @R.function
+        def before(fget_param, fset_output):
+            A = fget_param(0, R.str('A'))
+            B = fget_param(1, R.str('B'))
+            A_t = R.permute_dims(A)
+            B_t = R.permute_dims(B)
+            fset_output(0, A_t)
+            fset_output(1, B_t)
+
+        @R.function
+        def after(fget_param, fset_output):
+            A = fget_param(0, R.str('A'))
+            A_t = R.permute_dims(A)
+            fset_output(0, A_t)
+            B = fget_param(1, R.str('B'))
+            B_t = R.permute_dims(B)
+            fset_output(1, B_t)
+
+    Parameters
+    ----------
+    num_concurrent_chains : int
+        The number of chains whose loads and kernels are interleaved.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+
+    """
+    return _ffi_api.StreamParamChains(num_concurrent_chains)  # type: ignore
+
+
 def ConvertToDataflow(min_size: int = 2) -> tvm.ir.transform.Pass:
     """A pass that converts consecutive dataflow operations
     inside binding blocks into dataflow blocks.
@@ -413,6 +470,30 @@ def CallTIRRewrite() -> tvm.ir.transform.Pass:
     return _ffi_api.CallTIRRewrite()  # type: ignore
 
 
+def AssignStreams(
+    num_streams: Optional[int] = None, device_index: int = 0
+) -> tvm.ir.transform.Pass:
+    """Assign the independent kernel calls of each binding block to multiple streams, and
+    synchronize the streams at the dependency edges across them. The pass runs after
+    CallTIRRewrite and before StaticPlanBlockMemory, which avoids reusing memory across the
+    streams that may run concurrently.
+
+    Parameters
+    ----------
+    num_streams: Optional[int]
+        The number of streams. When not given, it is read from the "relax.backend.num_streams"
+        option of the PassContext, and the pass does nothing for a single stream.
+
+    device_index: int
+        The index of the VM device that runs the kernels.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.AssignStreams(num_streams, device_index)  # type: ignore
+
+
 def Normalize() -> tvm.ir.transform.Pass:
     """Transforming Relax IR to normal form, i.e., the expressions are normalized(no nesting
     and hence the AST is in ANF), and all ``checked_type_`` and ``shape_`` of expressions are
@@ -511,6 +592,30 @@ def RewriteDataflowReshape() -> tvm.ir.transform.Pass:
     return _ffi_api.RewriteDataflowReshape()  # type: ignore
 
 
+def RewriteSliceToView(allow_byte_offset: bool = False) -> tvm.ir.transform.Pass:
+    """Convert the strided_slice, split and permute_dims whose results are contiguous in the
+    memory of their input to R.memory.view, which is lowered to a CreateView operation at runtime
+    instead of a copy kernel.
+
+    A slice is contiguous when it is full along the axes after some axis, and has one element
+    along the axes before it. A permutation is when it only moves the axes of one element.
+
+    Note: Operates only in dataflow blocks. ConvertToDataflow may need to be called first.
+
+    Parameters
+    ----------
+    allow_byte_offset : bool
+        Whether to rewrite the slices which do not start at the beginning of the input. Their
+        views have a byte offset, which the default buffers of the TIR kernels do not accept, so
+        it should only be set when the views are consumed by the functions which accept it.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+    """
+    return _ffi_api.RewriteSliceToView(allow_byte_offset)  # type: ignore
+
+
 def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     """The static memory planning pass on BindingBlock level.
     The pass will reuse allocated memory to its best effort, in order to
@@ -529,6 +634,11 @@ def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     signature will have upper bound 1024. And we will use 1024 as its value
     during memory planning.
 
+    A function annotated with :code:`R.func_attr({"relax.memory_plan_arena": True})`
+    further gets the planned storages of its top-level binding blocks packed into
+    a single arena per device, at offsets chosen from the lifetimes of the storages,
+    so that the function makes one allocation with a lower peak memory.
+
     Returns
     -------
     ret : tvm.ir.transform.Pass
@@ -711,16 +821,24 @@ def RunCodegen(
     return _ffi_api.RunCodegen(target_options, entry_functions)  # type: ignore
 
 
-def FoldConstant() -> tvm.ir.transform.Pass:
+def FoldConstant(batched: bool = False) -> tvm.ir.transform.Pass:
     """Fold constant expressions within dataflow blocks.
 
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
+    Parameters
+    ----------
+    batched : bool
+        Whether to fold in rounds. Each round collects the calls whose arguments are all
+        constant, builds their functions in one module with a single LLVM invocation, and
+        evaluates the calls in parallel. It speeds up the folding of many constant
+        subexpressions, such as the repacking of quantized weights.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
     """
-    return _ffi_api.FoldConstant()  # type: ignore
+    return _ffi_api.FoldConstant(batched)  # type: ignore
 
 
 def ExpandTupleArguments() -> tvm.ir.transform.Pass:
@@ -1142,6 +1260,35 @@ def RealizeVDevice() -> tvm.ir.transform.Pass:
     return _ffi_api.RealizeVDevice()  # type: ignore
 
 
+def AutoPlaceVDevice(cost_model: Optional[Dict[str, float]] = None) -> tvm.ir.transform.Pass:
+    """Place the operators of the dataflow blocks on the host or on the device, whichever
+    minimizes the estimated run time of the block including the transfers between them.
+
+    The operators on tensors of static shapes whose device is not specified are placed between
+    the first CPU and the first other virtual device of the module. Tiny operators, such as
+    shape computations, run on the host when their inputs are there or when they save the
+    launches on the device, and large ones such as GEMMs run on the device. The operators placed
+    on the host are annotated with its virtual device, and `R.to_vdevice` is inserted where the
+    values cross the devices.
+
+    Parameters
+    ----------
+    cost_model : Optional[Dict[str, float]]
+        The overrides of the parameters of the cost model: "host_flops", "host_bandwidth",
+        "host_launch_overhead", "device_flops", "device_bandwidth", "device_launch_overhead",
+        "transfer_bandwidth" and "transfer_latency", in FLOP/s, bytes/s and seconds.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    cost_model = {
+        key: tvm.tir.FloatImm("float64", value) for key, value in (cost_model or {}).items()
+    }
+    return _ffi_api.AutoPlaceVDevice(cost_model)  # type: ignore
+
+
 def MetaScheduleApplyDatabase(
     work_dir: Optional[str] = None, enable_warning: bool = False
 ) -> tvm.ir.transform.Pass:
@@ -1529,10 +1676,45 @@ def CombineParallelMatmul(check=None):
     return _ffi_api.CombineParallelMatmul(check)  # type: ignore
 
 
+def HorizontalFuseTIR(max_num_blocks: int = 128) -> tvm.ir.transform.Pass:
+    """Fuse independent calls of small GPU kernels into one kernel launch.
+
+    A kernel of few thread blocks does not fill the GPU, and back-to-back launches of many such
+    kernels, e.g. the projections of several LoRA adapters or heads, are dominated by the launch
+    overhead. This pass groups the independent `call_tir` of a dataflow block whose kernels have
+    the same thread extents into one `call_tir` of a fused kernel. The grid of the fused kernel
+    is the concatenation of the grids of the kernels, and each thread block runs the kernel its
+    blockIdx.x falls into.
+
+    The pass applies to scheduled PrimFuncs, e.g. after the dlight rules, which launch a single
+    kernel with blockIdx.x as their only grid axis.
+
+    Parameters
+    ----------
+    max_num_blocks : int
+        The maximum number of thread blocks of a kernel to be fused.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.HorizontalFuseTIR(max_num_blocks)  # type: ignore
+
+
 def RewriteCUDAGraph() -> tvm.ir.transform.Pass:
     """Rewrite a Relax module for executing with CUDA graph. This pass identifies the regions that
     can be executed with CUDA graph and lifts them into new functions for runtime graph capturing.
 
+    A region that depends on symbolic variables is captured once per value of them. The
+    ``relax.rewrite_cuda_graph.capture_buckets`` function attribute, e.g. ``{"n": [1, 2, 4, 8]}``,
+    pads the batch-like variables up to the smallest fitting bucket instead, so that a graph is
+    captured per bucket. The number of graphs kept at runtime can be capped with
+    ``vm.builtin.cuda_graph.set_max_num_captured_graphs``.
+
+    When the current target is ``rocm``, the regions are captured into HIP graphs with the
+    ``vm.builtin.hip_graph`` builtins, which have the same semantics.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
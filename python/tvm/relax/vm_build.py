@@ -16,7 +16,7 @@
 # under the License.
 # pylint: disable=invalid-name, no-member
 """VM build logics"""
-from typing import Any, Dict, List, Optional, Union
+from typing import Any, Dict, List, Optional, Tuple, Union
 
 import tvm
 from tvm import relax
@@ -48,6 +48,22 @@ class Executable:
         """print the instructions as python program."""
         return self._as_python()
 
+    def planned_storage_bytes(self) -> Dict[str, Tuple[int, int]]:
+        """Get the device storage each bytecode VM function allocates.
+
+        The storage planned by StaticPlanBlockMemory has a constant size, and is summed
+        over the function, which is the activation footprint of the function. The
+        storage sized at runtime is only counted.
+
+        Returns
+        -------
+        result : Dict[str, Tuple[int, int]]
+            The map from the function names to the planned bytes and the number of
+            allocations sized at runtime.
+        """
+        result = self.mod["get_planned_storage_bytes"]()
+        return {str(name): (int(value[0]), int(value[1])) for name, value in result.items()}
+
     def jit(self, fcompile=None, addons=None, **kwargs) -> tvm.runtime.Module:
         """Just-in-time compile and link the modules.
 
@@ -257,7 +273,7 @@ def build(
     target: Optional[Union[str, tvm.target.Target]] = None,
     params: Optional[Dict[str, list]] = None,
     pipeline: Union[None, str, tvm.transform.Pass] = "default_build",
-    exec_mode: str = "bytecode",
+    exec_mode: Optional[str] = None,
     *,
     system_lib: Optional[bool] = None,
 ) -> Executable:
@@ -285,8 +301,10 @@ def build(
     pipeline : str = "default_build"
         The compilation pipeline to use.
 
-    exec_mode: {"bytecode", "compiled"}
-        The execution mode.
+    exec_mode: Optional[str]
+        The execution mode, "bytecode" to interpret the Relax functions, or "compiled" to
+        compile them into host code ahead of time. When not given, the mode is read from the
+        "relax.vm.exec_mode" option of the current PassContext, and defaults to "bytecode".
 
     system_lib: Optional[bool]
         Whether to build system lib that is being packed statically and
@@ -324,6 +342,10 @@ def build(
         target = tvm.target.Target(target)
     if not params:
         params = {}
+    if exec_mode is None:
+        exec_mode = str(
+            tvm.transform.PassContext.current().config.get("relax.vm.exec_mode", "bytecode")
+        )
 
     if pipeline is not None:
         if isinstance(pipeline, str):
@@ -16,5 +16,6 @@
 # under the License.
 """Backend codegen modules for relay."""
 from . import te_compiler
+from .engine_cache import EngineCache
 from .executor import Executor
 from .runtime import Runtime
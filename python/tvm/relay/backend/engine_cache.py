@@ -0,0 +1,215 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Measured selection of the op implementations, cached per device.
+
+The op strategies choose between the algorithms of an op, e.g. the direct, im2col-GEMM and
+Winograd convolutions, by their plevel, which is fixed for a target whatever the shape. Within an
+`EngineCache` scope, the TE compiler instead builds and times every valid implementation of an op
+the first time it meets a workload, on the device of the target, and records the fastest one in a
+cache file of the target. Later builds select the recorded implementation without measuring.
+
+.. code-block:: python
+
+    with relay.backend.EngineCache():
+        lib = relay.build(mod, target="llvm -mcpu=skylake-avx512", params=params)
+"""
+import hashlib
+import json
+import logging
+import os
+
+import numpy as np
+
+import tvm
+from tvm import autotvm, te
+
+logger = logging.getLogger("te_compiler")
+
+
+class EngineCache(object):
+    """The scope in which the TE compiler selects the fastest measured implementation of ops.
+
+    Parameters
+    ----------
+    cache_dir : Optional[str]
+        The directory of the cache files, one file per target. Defaults to
+        `~/.tvm/engine_cache`.
+
+    ops : Tuple[str]
+        The names of the ops whose implementations are measured.
+
+    number : int
+        The number of runs of an implementation in one measurement.
+
+    repeat : int
+        The number of measurements of an implementation, of which the mean is compared.
+
+    min_repeat_ms : int
+        The minimum duration of one measurement in milliseconds.
+    """
+
+    current = None
+
+    def __init__(
+        self,
+        cache_dir=None,
+        ops=("nn.conv2d", "nn.conv2d_transpose", "nn.conv3d"),
+        number=3,
+        repeat=3,
+        min_repeat_ms=0,
+    ):
+        if cache_dir is None:
+            cache_dir = os.path.join(os.path.expanduser("~"), ".tvm", "engine_cache")
+        self.cache_dir = cache_dir
+        self.ops = set(ops)
+        self.number = number
+        self.repeat = repeat
+        self.min_repeat_ms = min_repeat_ms
+        # The records of each cache file: file path -> workload key -> implementation name.
+        self._records = {}
+        self._old_cache = None
+
+    def __enter__(self):
+        self._old_cache = EngineCache.current
+        EngineCache.current = self
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        EngineCache.current = self._old_cache
+
+    def cache_file(self, target):
+        """Get the path of the cache file of a target."""
+        target_str = str(target)
+        digest = hashlib.sha1(target_str.encode("utf-8")).hexdigest()[:16]
+        return os.path.join(self.cache_dir, "%s-%s.json" % (target.kind.name, digest))
+
+    def select(self, op, attrs, inputs, out_type, target, impls):
+        """Select the fastest of the valid implementations of an op.
+
+        Parameters
+        ----------
+        op : tvm.ir.Op
+            Relay operator.
+
+        attrs : object
+            The op attribute.
+
+        inputs : List[tvm.te.Tensor]
+            Input tensors to the op.
+
+        out_type : relay.Type
+            The output type.
+
+        target : tvm.target.Target
+            The target to compile the op.
+
+        impls : List[relay.op.OpImplementation]
+            The valid implementations of the op.
+
+        Returns
+        -------
+        ret : Optional[relay.op.OpImplementation]
+            The recorded or the fastest measured implementation, or None if the workload is
+            symbolic or no implementation could be measured.
+        """
+        key = _workload_key(op, attrs, inputs, out_type)
+        if key is None:
+            return None
+        path = self.cache_file(target)
+        records = self._load(path)
+        impls_by_name = {impl.name: impl for impl in impls}
+        if records.get(key) in impls_by_name:
+            return impls_by_name[records[key]]
+
+        dev = tvm.device(target.kind.name, 0)
+        if not dev.exist:
+            logger.warning("Cannot measure the implementations of %s: no %s device", op.name, dev)
+            return None
+        costs = {}
+        for impl in impls:
+            try:
+                costs[impl.name] = self._measure(impl, attrs, inputs, out_type, target, dev)
+            except Exception as err:  # pylint: disable=broad-except
+                logger.info("Cannot measure %s for %s: %s", impl.name, op.name, err)
+                continue
+            logger.info(
+                "Implementation %s for %s runs in %.2e s", impl.name, op.name, costs[impl.name]
+            )
+        if not costs:
+            return None
+        best = min(costs, key=costs.get)
+        records[key] = best
+        self._save(path, records)
+        return impls_by_name[best]
+
+    def _measure(self, impl, attrs, inputs, out_type, target, dev):
+        """Build an implementation on its own and return its mean run time in seconds."""
+        args = [te.placeholder(x.shape, x.dtype, name="input%d" % i) for i, x in enumerate(inputs)]
+        old_silent = autotvm.GLOBAL_SCOPE.silent
+        autotvm.GLOBAL_SCOPE.silent = True
+        try:
+            with target:
+                outs = impl.compute(attrs, args, out_type)
+                sch = impl.schedule(attrs, outs, target)
+        finally:
+            autotvm.GLOBAL_SCOPE.silent = old_silent
+        func = tvm.build(sch, args + list(outs), target)
+        nd_args = [
+            tvm.nd.array(np.random.uniform(size=_const_shape(x.shape)).astype(x.dtype), dev)
+            for x in args
+        ]
+        nd_args += [tvm.nd.empty(_const_shape(x.shape), x.dtype, dev) for x in outs]
+        timer = func.time_evaluator(
+            func.entry_name,
+            dev,
+            number=self.number,
+            repeat=self.repeat,
+            min_repeat_ms=self.min_repeat_ms,
+        )
+        return timer(*nd_args).mean
+
+    def _load(self, path):
+        if path not in self._records:
+            records = {}
+            if os.path.isfile(path):
+                with open(path, "r") as f:
+                    records = json.load(f)
+            self._records[path] = records
+        return self._records[path]
+
+    def _save(self, path, records):
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        tmp_path = "%s.%d.tmp" % (path, os.getpid())
+        with open(tmp_path, "w") as f:
+            json.dump(records, f, indent=2, sort_keys=True)
+        os.replace(tmp_path, path)
+
+
+def _const_shape(shape):
+    return [int(dim) for dim in shape]
+
+
+def _workload_key(op, attrs, inputs, out_type):
+    """Get the key of a workload in the cache file, or None if it has symbolic shapes."""
+    try:
+        input_types = [(_const_shape(x.shape), x.dtype) for x in inputs]
+    except (TypeError, ValueError):
+        return None
+    attr_dict = {}
+    if attrs is not None:
+        attr_dict = {name: str(attrs[name]) for name in attrs.keys()}
+    return json.dumps([op.name, input_types, attr_dict, str(out_type)], sort_keys=True)
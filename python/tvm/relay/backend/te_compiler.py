@@ -33,6 +33,7 @@ from .. import function as _function
 from .. import ty as _ty
 from ..backend.utils import mangle_module_name
 from . import _backend
+from .engine_cache import EngineCache
 
 logger = logging.getLogger("te_compiler")
 autotvm_logger = logging.getLogger("autotvm")
@@ -147,6 +148,9 @@ def select_implementation(op, attrs, inputs, out_type, target, use_autotvm=True)
     If use_autotvm is False, it'll directly choose the implementation with
     highest plevel.
 
+    Within an EngineCache scope, the implementations of the ops of the cache are
+    first measured on the device of the target, and the fastest one is chosen.
+
     Note that this function doesn't support op with symbolic input shapes.
 
     Parameters
@@ -184,6 +188,22 @@ def select_implementation(op, attrs, inputs, out_type, target, use_autotvm=True)
     if is_auto_scheduler_enabled() or is_meta_schedule_enabled():
         use_autotvm = False
 
+    # Within an engine cache, use the fastest measured implementation
+    engine_cache = EngineCache.current
+    if (
+        engine_cache is not None
+        and op.name in engine_cache.ops
+        and len(all_impls) > 1
+        and not (is_auto_scheduler_enabled() or is_meta_schedule_enabled())
+    ):
+        best_measured_impl = engine_cache.select(op, attrs, inputs, out_type, target, all_impls)
+        if best_measured_impl is not None:
+            logger.info(
+                "Using %s for %s based on the engine cache", best_measured_impl.name, op.name
+            )
+            outs = best_measured_impl.compute(attrs, inputs, out_type)
+            return best_measured_impl, outs
+
     # If not use autotvm, always return the implementation with the highest priority
     if not use_autotvm:
         logger.info(
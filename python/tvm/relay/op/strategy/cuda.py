@@ -1144,6 +1144,15 @@ def topk_strategy_cuda(attrs, inputs, out_type, target):
             name="topk_thrust.cuda",
             plevel=15,
         )
+    if can_use_thrust(target, "tvm.contrib.thrust.segmented_topk") and is_segmented_topk(
+        attrs, inputs, ["float16", "float32"]
+    ):
+        strategy.add_implementation(
+            wrap_compute_topk(topi.cuda.segmented_topk_thrust),
+            wrap_topi_schedule(topi.cuda.schedule_topk),
+            name="segmented_topk_thrust.cuda",
+            plevel=20,
+        )
     return strategy
 
 
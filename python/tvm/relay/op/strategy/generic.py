@@ -19,7 +19,7 @@
 import logging
 import re
 
-from tvm import _ffi, ir, te, topi
+from tvm import _ffi, ir, te, tir, topi
 from tvm.target import generic_func, override_native_generic_func
 from tvm.topi.utils import get_const_float, get_const_int, get_const_tuple, get_float_tuple
 
@@ -1130,6 +1130,21 @@ def wrap_compute_topk(topi_compute):
     return _compute_topk
 
 
+def is_segmented_topk(attrs, inputs, dtypes=None):
+    """Whether a topk can run as a segmented top-k over the rows of the last axis"""
+    if attrs.k is None:
+        return False
+    data = inputs[0]
+    ndim = len(data.shape)
+    axis = get_const_int(attrs.axis)
+    k = get_const_int(attrs.k)
+    if axis not in (-1, ndim - 1) or k < 1 or not isinstance(data.shape[-1], tir.IntImm):
+        return False
+    if k > data.shape[-1].value or attrs.dtype not in ["int32", "int64"]:
+        return False
+    return dtypes is None or data.dtype in dtypes
+
+
 @override_native_generic_func("topk_strategy")
 def topk_strategy(attrs, inputs, out_type, target):
     """topk generic strategy"""
@@ -1139,6 +1154,13 @@ def topk_strategy(attrs, inputs, out_type, target):
         wrap_topi_schedule(topi.generic.schedule_topk),
         name="topk.generic",
     )
+    if is_segmented_topk(attrs, inputs, ["float16", "float32", "float64", "int32", "int64"]):
+        strategy.add_implementation(
+            wrap_compute_topk(topi.segmented_topk),
+            wrap_topi_schedule(topi.generic.schedule_topk),
+            name="segmented_topk.generic",
+            plevel=15,
+        )
     return strategy
 
 
@@ -72,6 +72,26 @@ class RPCSession(object):
         """
         return self._sess.get_function(name)
 
+    def enable_multiplex(self, num_workers=4):
+        """Switch the connection to the multiplexed protocol.
+
+        The requests issued concurrently from several threads, e.g. an upload and a run, are
+        then all in flight at once, and complete in any order. Call it before issuing requests
+        from several threads.
+
+        Parameters
+        ----------
+        num_workers : int
+            The number of requests the server processes concurrently.
+
+        Returns
+        -------
+        enabled : bool
+            Whether the connection uses the multiplexed protocol. Servers of earlier versions
+            do not support it, and keep processing one request at a time.
+        """
+        return bool(_ffi_api.SessEnableMultiplex(self._sess, num_workers))
+
     def device(self, dev_type, dev_id=0):
         """Construct a remote device.
 
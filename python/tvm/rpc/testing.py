@@ -17,6 +17,8 @@
 
 # pylint: disable=invalid-name,unnecessary-comprehension
 """ Testing functions for the RPC server."""
+import threading
+
 import numpy as np
 import tvm
 
@@ -53,6 +55,19 @@ def _add_to_lhs(x):
     return lambda y: x + y
 
 
+_event = threading.Event()
+
+
+@tvm.register_func("rpc.test.wait_event")
+def _wait_event(timeout):
+    return _event.wait(timeout)
+
+
+@tvm.register_func("rpc.test.set_event")
+def _set_event():
+    _event.set()
+
+
 @tvm.register_func("rpc.test.remote_return_nd")
 def _my_module(name):
     # Use closure to check the ref counter correctness
@@ -21,5 +21,6 @@ from .session import (
     DRef,
     ProcessSession,
     Session,
+    SocketSession,
     ThreadedSession,
 )
@@ -311,11 +311,13 @@ class Session(Object):
             The name of the communication collective library. Currently supported libraries are:
             - nccl
             - rccl
+            - mscclpp, which runs the allreduce of small messages on the MSCCL++ kernels and
+              everything else on nccl, when TVM is built with USE_MSCCL
             - mpi
         *device_ids : int
             The device IDs to be used by the underlying communication library.
         """
-        assert ccl in ("nccl", "rccl"), f"Unsupported CCL backend: {ccl}"
+        assert ccl in ("nccl", "rccl", "mscclpp"), f"Unsupported CCL backend: {ccl}"
         _ffi_api.SessionInitCCL(self, ccl, ShapeTuple(device_ids))  # type: ignore # pylint: disable=no-member
         self._clear_ipc_memory_pool()
 
@@ -434,6 +436,7 @@ class Session(Object):
         src: DRef,
         dst: DRef,
         op: str = "sum",  # pylint: disable=invalid-name
+        group: str = "",
     ) -> DRef:
         """Perform an allreduce operation on an array.
 
@@ -448,17 +451,25 @@ class Session(Object):
             - "min"
             - "max"
             - "avg"
+        group : str = ""
+            The name of the groups created by `init_ccl_group`, within which each worker reduces,
+            or empty for all the workers. Every worker must be in one of the groups.
         """
         if op not in REDUCE_OPS:
             raise ValueError(f"Unsupported reduce op: {op}. Available ops are: {REDUCE_OPS.keys()}")
         op = ShapeTuple([REDUCE_OPS[op]])
-        func = self._get_cached_method("runtime.disco.allreduce")
-        func(src, op, dst)
+        if group:
+            func = self._get_cached_method("runtime.disco.allreduce_group")
+            func(src, op, group, dst)
+        else:
+            func = self._get_cached_method("runtime.disco.allreduce")
+            func(src, op, dst)
 
     def allgather(
         self,
         src: DRef,
         dst: DRef,
+        group: str = "",
     ) -> DRef:
         """Perform an allgather operation on an array.
 
@@ -468,9 +479,117 @@ class Session(Object):
             The array to be gathered from.
         dst : DRef
             The array to be gathered to.
+        group : str = ""
+            The name of the groups created by `init_ccl_group`, within which each worker gathers,
+            or empty for all the workers. Every worker must be in one of the groups.
         """
-        func = self._get_cached_method("runtime.disco.allgather")
-        func(src, dst)
+        if group:
+            func = self._get_cached_method("runtime.disco.allgather_group")
+            func(src, group, dst)
+        else:
+            func = self._get_cached_method("runtime.disco.allgather")
+            func(src, dst)
+
+    def init_groups(self, num_groups: int) -> None:
+        """Split the workers into groups of consecutive worker ids, e.g. pipeline stages.
+        Collective operations run within each group afterwards. Must be called after
+        `init_ccl`.
+
+        Parameters
+        ----------
+        num_groups : int
+            The number of groups, which must divide the number of workers.
+        """
+        if num_groups <= 0 or self.num_workers % num_groups != 0:
+            raise ValueError(
+                f"The number of groups must divide the number of workers {self.num_workers}, "
+                f"but got {num_groups}"
+            )
+        func = self._get_cached_method("runtime.disco.init_groups")
+        func(num_groups)
+        self._num_groups = num_groups  # pylint: disable=attribute-defined-outside-init
+
+    def init_ccl_group(self, name: str, groups: Sequence[Sequence[int]]) -> None:
+        """Create named groups of workers, for the collective operations scoped to them, e.g.
+        the tensor parallel groups and the data parallel groups of hybrid parallelism. The
+        communicators are cached by the groups, so several names for the same groups share them.
+        Must be called after `init_ccl`.
+
+        Parameters
+        ----------
+        name : str
+            The name of the groups, to pass as the `group` of the collective operations.
+        groups : Sequence[Sequence[int]]
+            The worker ids of each group, in the order of their ranks within the group. Each
+            worker is in at most one group.
+
+        Examples
+        --------
+        With 8 workers running 2 replicas of 4-way tensor parallelism:
+
+        .. code-block:: python
+
+            sess.init_ccl_group("tp", [[0, 1, 2, 3], [4, 5, 6, 7]])
+            sess.init_ccl_group("dp", [[0, 4], [1, 5], [2, 6], [3, 7]])
+        """
+        group_sizes = ShapeTuple([len(group) for group in groups])
+        ranks = ShapeTuple([rank for group in groups for rank in group])
+        func = self._get_cached_method("runtime.disco.init_ccl_group")
+        func(name, group_sizes, ranks)
+
+    def send_to_next_group(self, array: DRef) -> None:
+        """Send an array to the worker at the same position in the next group.
+
+        Parameters
+        ----------
+        array : DRef
+            The array to be sent.
+        """
+        func = self._get_cached_method("runtime.disco.send_to_next_group")
+        func(array)
+
+    def recv_from_prev_group(self, array: DRef) -> None:
+        """Receive an array from the worker at the same position in the previous group.
+
+        Parameters
+        ----------
+        array : DRef
+            The array to be received.
+        """
+        func = self._get_cached_method("runtime.disco.recv_from_prev_group")
+        func(array)
+
+    def run_pipeline(
+        self,
+        fstage: DRef,
+        num_micro_batches: int,
+        recv: DRef,
+        send: DRef,
+    ) -> None:
+        """Run micro-batches through a pipeline where each worker group is a stage.
+
+        The micro-batches are scheduled with a fill-drain schedule: at tick `t`, stage `s`
+        processes micro-batch `t - s`, so all stages are busy once the pipeline is filled.
+        All ticks are enqueued without waiting, each stage only waits for the activations
+        of the previous stage.
+
+        Parameters
+        ----------
+        fstage : DRef
+            The stage function on the workers, called as `fstage(micro_batch, input, output)`.
+            The first stage gets None as input and the last stage None as output, which read
+            the micro-batch and write the result themselves.
+        num_micro_batches : int
+            The number of micro-batches.
+        recv : DRef
+            The buffer receiving the activations from the previous stage.
+        send : DRef
+            The buffer holding the activations sent to the next stage.
+        """
+        num_stages = getattr(self, "_num_groups", 1)
+        func = self._get_cached_method("runtime.disco.pipeline_stage_step")
+        for tick in range(num_micro_batches + num_stages - 1):
+            func(fstage, tick, num_micro_batches, recv, send)
 
     def _clear_ipc_memory_pool(self):
         # Clear the IPC memory allocator when the allocator exists.
@@ -527,6 +646,29 @@ class ProcessSession(Session):
         func(config, os.getpid())
 
 
+class SocketSession(Session):
+    """A Disco session whose workers connect to the controller over TCP sockets,
+    so that they can run on other nodes. Worker 0 runs in the controller process,
+    and on each node the workers are started with
+
+    .. code-block:: bash
+
+        python -m tvm.exec.disco_socket_worker <host> <port> <worker_id>
+
+    The CCL builtins work unchanged across the nodes, as `init_ccl` sends the unique id of
+    the communicator over the sockets. Its device ids are indexed by the global worker id.
+    """
+
+    def __init__(self, num_workers: int, host: str, port: int) -> None:
+        """Create the session, waiting for the workers 1 to `num_workers - 1` to connect."""
+        self.__init_handle_by_constructor__(
+            _ffi_api.SessionSocket,  # type: ignore # pylint: disable=no-member
+            num_workers,
+            host,
+            port,
+        )
+
+
 @register_func("runtime.disco._configure_structlog")
 def _configure_structlog(pickled_config: bytes, parent_pid: int) -> None:
     """Configure structlog for all disco workers
@@ -61,6 +61,8 @@ class AotModule(object):
     def __init__(self, module):
         self.module = module
         self._set_input = module["set_input"]
+        self._set_input_zero_copy = module["set_input_zero_copy"]
+        self._set_output_zero_copy = module["set_output_zero_copy"]
         self._run = module["run"]
         self._get_output = module["get_output"]
         self._get_input = module["get_input"]
@@ -101,6 +103,34 @@ class AotModule(object):
                 if val:
                     self._get_input(k).copyfrom(params[k])
 
+    def set_input_zero_copy(self, key, value):
+        """Set an input to the module without copying it. The module reads the memory of the
+        value in the following runs.
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : NDArray
+           The input value, on the device of the module
+        """
+        self._set_input_zero_copy(key, value)
+
+    def set_output_zero_copy(self, key, value):
+        """Set an output of the module without copying it. The module writes the memory of the
+        value in the following runs.
+
+        Parameters
+        ----------
+        key : int or str
+           The output key
+
+        value : NDArray
+           The output value, on the device of the module
+        """
+        self._set_output_zero_copy(key, value)
+
     def run(self, **input_dict):
         """Run forward execution of the model
 
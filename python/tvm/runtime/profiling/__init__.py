@@ -269,6 +269,72 @@ def profile_function(mod, dev, collectors, func_name=None, warmup_iters=10):
     )
 
 
+def dump_loop_profile(mod=None, reset=True):
+    """Read the cycles spent in each loop instrumented by
+    `tvm.tir.transform.InstrumentProfileIntrinsics`, which the build runs with the pass config
+    `tir.instrument_lwp`. The loops run on the host are counted by every thread with the time
+    stamp counter, and the loops in CUDA kernels by the first thread of every block with the
+    clock of the SM.
+
+    Example
+    -------
+
+    .. code-block: python
+        with tvm.transform.PassContext(config={"tir.instrument_lwp": True}):
+            f = tvm.build(my_func, target="cuda")
+        f(*args)
+        profile = tvm.runtime.profiling.dump_loop_profile(f)
+        runs, cycles = profile["cuda"][loop_id]
+
+    Parameters
+    ----------
+    mod: Optional[Module]
+        The built module whose device modules are read as well.
+    reset: bool
+        Whether to clear the counters after reading them.
+
+    Returns
+    -------
+    profile: Dict[str, Dict[int, Tuple[int, int]]]
+        The number of runs and the total cycles of each loop id which ran, under "cpu" for the
+        host, and under the type key of each instrumented device module.
+    """
+
+    def _to_dict(rows):
+        return {int(row[0]): (int(row[1]), int(row[2])) for row in rows}
+
+    profile = {"cpu": _to_dict(_ffi_api.DumpLoopProfile(reset))}
+    modules = list(mod.imported_modules) if mod is not None else []
+    while modules:
+        device_mod = modules.pop()
+        modules.extend(device_mod.imported_modules)
+        if device_mod.implements_function("__tvm_loop_profile_dump"):
+            rows = device_mod.get_function("__tvm_loop_profile_dump")(reset)
+            if len(rows) > 0:
+                profile[device_mod.type_key] = _to_dict(rows)
+    return profile
+
+
+def set_nvtx_ranges_enabled(enabled: bool = True) -> bool:
+    """Turn on or off the NVTX ranges, or the ROCTX ranges on ROCm, which annotate the functions
+    and the packed calls of the Relax VM, the phases of the paged KV cache and the collectives of
+    disco in the traces of Nsight Systems or rocprof. The ranges are off by default, and can also
+    be turned on by setting the environment variable `TVM_NVTX_RANGES=1`.
+
+    Parameters
+    ----------
+    enabled: bool
+        Whether to record the ranges.
+
+    Returns
+    -------
+    recorded: bool
+        Whether the ranges are recorded now, which is always False when TVM is not built with
+        `USE_NVTX`.
+    """
+    return bool(_ffi_api.SetNVTXRangesEnabled(enabled))
+
+
 # We only enable this class when TVM is build with PAPI support
 if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is not None:
 
@@ -291,3 +357,30 @@ if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=T
             for dev, names in metric_names.items():
                 wrapped[DeviceWrapper(dev)] = names
             self.__init_handle_by_constructor__(_ffi_api.PAPIMetricCollector, wrapped)
+
+
+# We only enable this class when TVM is build with CUPTI support
+if _ffi.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is not None:
+
+    @_ffi.register_object("runtime.profiling.CUPTIMetricCollector")
+    class CUPTIMetricCollector(MetricCollector):
+        """Collects the metrics of CUDA kernels from the performance counters of the GPU using
+        the CUDA Profiling Tools Interface (CUPTI), e.g. their achieved occupancy, SM efficiency
+        and DRAM throughput.
+        """
+
+        def __init__(self, metric_names: Optional[Dict[Device, Sequence[str]]] = None):
+            """
+            Parameters
+            ----------
+            metric_names : Optional[Dict[Device, Sequence[str]]]
+                List of per-device metrics to collect. You can find a list of valid
+                metrics by runing `nvprof --query-metrics` from the command line. The
+                devices that are not listed collect `achieved_occupancy`, `sm_efficiency`,
+                the DRAM read and write throughput, and the DRAM bytes read and written.
+            """
+            metric_names = {} if metric_names is None else metric_names
+            wrapped = dict()
+            for dev, names in metric_names.items():
+                wrapped[DeviceWrapper(dev)] = names
+            self.__init_handle_by_constructor__(_ffi_api.CUPTIMetricCollector, wrapped)
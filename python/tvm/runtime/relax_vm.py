@@ -16,14 +16,15 @@
 # under the License.
 # pylint: disable=invalid-name, redefined-builtin, no-else-return, consider-using-dict-items
 """The Relax virtual machine."""
+import threading
 from enum import IntEnum
-from typing import Any, Callable, Dict, List, Optional, Tuple, Union
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple, Union
 
 import numpy as np  # type: ignore
 
 import tvm
 from tvm._ffi import base as _base
-from tvm._ffi import register_func
+from tvm._ffi import register_func, register_object
 from tvm.runtime import Device, Object, PackedFunc
 from tvm.runtime.profiling import Report
 
@@ -36,11 +37,59 @@ class VMInstrumentReturnKind(IntEnum):
     SKIP_RUN = 1
 
 
+@register_object("relax.vm.Future")
+class VMFuture(Object):
+    """The pending result of a call of :py:meth:`VirtualMachine.invoke_closure_async`.
+
+    The call finishes once the kernels it launched complete, with its result, its error, or by
+    cancellation. :py:meth:`fileno` makes the future usable with `select` and with
+    `asyncio.loop.add_reader`.
+    """
+
+    def done(self) -> bool:
+        """Whether the call has finished."""
+        return bool(tvm.get_global_func("vm.builtin.future_is_done")(self))
+
+    def wait(self, timeout: Optional[float] = None) -> bool:
+        """Wait for the call to finish, for at most `timeout` seconds if it is not None.
+
+        Returns
+        -------
+        done : bool
+            Whether the call has finished.
+        """
+        timeout_ms = -1 if timeout is None else int(timeout * 1000)
+        return bool(tvm.get_global_func("vm.builtin.future_wait")(self, timeout_ms))
+
+    def result(self) -> Any:
+        """Wait for the call to finish, and return its result, or raise its error."""
+        return tvm.get_global_func("vm.builtin.future_get")(self)
+
+    def cancel(self) -> None:
+        """Request the cancellation of the call.
+
+        A queued call does not run, and a running call stops before the next instruction of its
+        bytecode functions, so the compiled functions of `exec_mode="compiled"` run to the end.
+        """
+        tvm.get_global_func("vm.builtin.future_cancel")(self)
+
+    def add_done_callback(self, callback: Callable[["VMFuture"], None]) -> None:
+        """Call `callback` with the future once the call finishes, on the worker which finishes
+        it, or at once if the call has finished. A future holds one callback."""
+        tvm.get_global_func("vm.builtin.future_on_done")(self, callback)
+
+    def fileno(self) -> int:
+        """A file descriptor which becomes readable once the call finishes, or -1 on Windows."""
+        return tvm.get_global_func("vm.builtin.future_fd")(self)
+
+
 class VirtualMachine(object):
     """Relax VM runtime."""
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BUCKETED_ALLOCATOR = 3
+    CACHING_ALLOCATOR = 4
 
     def __init__(
         self,
@@ -62,11 +111,15 @@ class VirtualMachine(object):
 
         memory_cfg : Optional[Union[str, Dict[Device, str]]]
             Config the type of memory allocator. The allocator type can be ["naive",
-            "pooled"]. If memory_cfg is None, all devices will use pooled allocator
-            by default. If memory_cfg is string, all devices will use the specified
-            allocator type. If memory_cfg is a dict, each device uses the allocator
-            type specified in the dict, or pooled allocator if not specified in the
-            dict.
+            "pooled", "bucketed", "caching"]. The "bucketed" allocator rounds requests to
+            geometric size classes and reuses the best-fitting cached buffer, which reduces
+            fragmentation under dynamic shapes. The "caching" allocator reuses buffers in
+            stream order and trims idle cached memory to the high-water mark given by the
+            TVM_CACHING_ALLOCATOR_HIGH_WATER_MARK environment variable. If memory_cfg
+            is None, all devices will use pooled allocator by default. If memory_cfg is
+            string, all devices will use the specified allocator type. If memory_cfg is
+            a dict, each device uses the allocator type specified in the dict, or pooled
+            allocator if not specified in the dict.
 
         profile : Optional[bool]
             Whether or not to enable profiling.
@@ -94,6 +147,8 @@ class VirtualMachine(object):
         self._get_function_arity = self.module["get_function_arity"]
         self._get_function_param_name = self.module["get_function_param_name"]
         self._set_instrument = self.module["set_instrument"]
+        self._device = device
+        self._memory_cfg = memory_cfg
         self._setup_device(device, memory_cfg)
 
     def _setup_device(self, dev: Device, memory_cfg: Union[str, Dict[Device, str]]) -> None:
@@ -111,13 +166,18 @@ class VirtualMachine(object):
         if devs[-1].device_type % RPC_SESS_MASK != tvm.cpu().device_type:
             devs.append(tvm.cpu())
 
+        alloc_types = {
+            "naive": VirtualMachine.NAIVE_ALLOCATOR,
+            "pooled": VirtualMachine.POOLED_ALLOCATOR,
+            "bucketed": VirtualMachine.BUCKETED_ALLOCATOR,
+            "caching": VirtualMachine.CACHING_ALLOCATOR,
+        }
         default_alloc_type = VirtualMachine.POOLED_ALLOCATOR
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
-            if memory_cfg == "naive":
-                default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            assert memory_cfg in alloc_types
+            default_alloc_type = alloc_types[memory_cfg]
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -129,6 +189,8 @@ class VirtualMachine(object):
             init_args.append(device.device_type % RPC_SESS_MASK)
             init_args.append(device.device_id)
             alloc_type = memory_cfg[device] if device in memory_cfg else default_alloc_type
+            if isinstance(alloc_type, str):
+                alloc_type = alloc_types[alloc_type]
             init_args.append(alloc_type)
         self.module["vm_initialization"](*init_args)
 
@@ -153,6 +215,179 @@ class VirtualMachine(object):
         """
         return self._invoke_closure(closure, *args)
 
+    def invoke_closure_async(self, closure: Union[str, Object], *args: Any) -> VMFuture:
+        """Invoke a closure on the async workers of the VM without waiting for it.
+
+        Parameters
+        ----------
+        closure : Union[str, Object]
+            The VMClosure Object, or the name of a function of the VM.
+
+        args : list[tvm.runtime.NDArray]
+            The arguments to the closure, which are held until the call finishes.
+
+        Returns
+        -------
+        future : VMFuture
+            The future of the call.
+        """
+        return self.module["invoke_closure_async"](closure, *args)
+
+    def set_num_async_workers(self, num_workers: int) -> None:
+        """Set the number of the async workers, which is 1 by default, after the running calls
+        finish. The queued calls fail.
+
+        Parameters
+        ----------
+        num_workers : int
+            The number of the threads which run the calls of `invoke_closure_async`.
+        """
+        self.module["set_num_async_workers"](num_workers)
+
+    def record_shape_signatures(self, enable: bool = True) -> None:
+        """Start or stop recording the shape signatures of the calls of the functions of the VM,
+        made through :py:meth:`__getitem__`. Starting clears the previous records.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to record the shape signatures.
+        """
+        self.module["record_shape_signatures"](enable)
+
+    def get_shape_signatures(
+        self, func_name: str
+    ) -> List[Tuple[Tuple[Optional[Tuple[int, ...]], ...], int]]:
+        """Get the shape signatures of the recorded calls of a function, the most frequent first.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        Returns
+        -------
+        signatures : List[Tuple[Tuple[Optional[Tuple[int, ...]], ...], int]]
+            Each signature, being the shape of each argument or None for an argument which is not
+            a tensor, with its number of calls.
+        """
+        result = []
+        for entry in self.module["get_shape_signatures"](func_name):
+            values = [int(value) for value in entry]
+            signature = []
+            pos = 1
+            while pos < len(values):
+                ndim = values[pos]
+                if ndim < 0:
+                    signature.append(None)
+                else:
+                    signature.append(tuple(values[pos + 1 : pos + 1 + ndim]))
+                pos += 1 + max(ndim, 0)
+            result.append((tuple(signature), values[0]))
+        return result
+
+    def set_shape_variant(
+        self,
+        func_name: str,
+        signature: Sequence[Optional[Sequence[int]]],
+        variant: Optional[Union[str, PackedFunc]],
+    ) -> None:
+        """Dispatch the calls of a function whose arguments have the given shapes to a variant of
+        the function specialized to them, such as one added by
+        :py:class:`tvm.relax.transform.SpecializeShapes`. The calls of the other shapes still run
+        the function itself.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        signature : Sequence[Optional[Sequence[int]]]
+            The shape of each argument, or None for an argument which is not a tensor.
+
+        variant : Optional[Union[str, PackedFunc]]
+            The name of the variant in the VM, or a function, e.g. of another VM. None removes the
+            variant of the signature.
+        """
+        flat = []
+        for shape in signature:
+            if shape is None:
+                flat.append(-1)
+            else:
+                flat.append(len(shape))
+                flat.extend(int(dim) for dim in shape)
+        self.module["set_shape_variant"](func_name, tvm.runtime.ShapeTuple(flat), variant)
+
+    def specialize_hot_shapes(
+        self,
+        mod: "tvm.IRModule",
+        func_name: str,
+        target: Union[str, "tvm.target.Target"],
+        num_variants: int = 1,
+        min_calls: int = 1,
+        background: bool = False,
+    ) -> Optional[threading.Thread]:
+        """Compile the variants of a function specialized to the shape signatures it was called
+        with the most since :py:meth:`record_shape_signatures`, and dispatch the calls of these
+        shapes to them. The function itself serves the other shapes, and these ones until the
+        variants are ready.
+
+        The variants run on another VM built from `mod` on the same devices. To avoid the
+        compilation at runtime, add the variants ahead of time with
+        :py:class:`tvm.relax.transform.SpecializeShapes` and register them by name with
+        :py:meth:`set_shape_variant`.
+
+        Parameters
+        ----------
+        mod : tvm.IRModule
+            The module this VM was built from.
+
+        func_name : str
+            The name of the function.
+
+        target : Union[str, tvm.target.Target]
+            The target to build the variants for.
+
+        num_variants : int
+            The number of the most frequent signatures to specialize the function to.
+
+        min_calls : int
+            The number of calls below which a signature is not specialized to.
+
+        background : bool
+            Whether to compile the variants on a background thread.
+
+        Returns
+        -------
+        thread : Optional[threading.Thread]
+            The thread compiling the variants if `background` is set, otherwise None.
+        """
+        # pylint: disable=import-outside-toplevel
+        from tvm import relax
+
+        signatures = [
+            signature
+            for signature, count in self.get_shape_signatures(func_name)
+            if count >= min_calls
+        ][:num_variants]
+        if not signatures:
+            return None
+
+        def _compile():
+            specialized = relax.transform.SpecializeShapes({func_name: signatures})(mod)
+            executable = relax.build(specialized, target)
+            variant_vm = VirtualMachine(executable, self._device, self._memory_cfg)
+            for index, signature in enumerate(signatures):
+                variant = variant_vm[f"{func_name}_specialized_{index}"]
+                self.set_shape_variant(func_name, signature, variant)
+
+        if not background:
+            _compile()
+            return None
+        thread = threading.Thread(target=_compile, daemon=True)
+        thread.start()
+        return thread
+
     def save_function(
         self,
         func_name: str,
@@ -374,6 +609,28 @@ class VirtualMachine(object):
         """
         self._set_instrument(instrument)
 
+    def enable_sampling_profiler(self, sample_interval: int = 100) -> None:
+        """Time the calls of one in ``sample_interval`` invocations of the VM functions, with no
+        synchronization of the device, so that it can stay on in production. The timers of a
+        sampled invocation are read at the next sampled invocation of the same thread.
+
+        Parameters
+        ----------
+        sample_interval : int
+            The number of invocations per sampled invocation, or 0 to turn the sampling off.
+        """
+        self.module["enable_sampling_profiler"](sample_interval)
+
+    def sampling_report(self) -> Report:
+        """Get the latency histograms of the calls in the sampled invocations.
+
+        Returns
+        -------
+        report: tvm.runtime.profiling.Report
+            The count, total, mean and percentiles of the latency of every function called.
+        """
+        return Report.from_json(self.module["get_sampling_report"]())
+
     def time_evaluator(
         self,
         func_name: str,
@@ -1892,6 +1892,9 @@ simdgroup_load = _op_wrapper(_tir_op.simdgroup_load)
 simdgroup_store = _op_wrapper(_tir_op.simdgroup_store)
 simdgroup_multiply_accumulate = _op_wrapper(_tir_op.simdgroup_multiply_accumulate)
 create_barriers = _op_wrapper(_tir_op.create_barriers)
+ptx_wgmma_fence = _op_wrapper(_tir_op.ptx_wgmma_fence)
+ptx_wgmma_commit_group = _op_wrapper(_tir_op.ptx_wgmma_commit_group)
+ptx_wgmma_wait_group = _op_wrapper(_tir_op.ptx_wgmma_wait_group)
 assume = _op_wrapper(_tir_op.assume)
 undef = _op_wrapper(_tir_op.undef)
 TVMBackendAllocWorkspace = _op_wrapper(_tir_op.TVMBackendAllocWorkspace)
@@ -1926,11 +1929,17 @@ ptx_mma_sp = _dtype_forward(_tir_op.ptx_mma_sp)
 ptx_ldmatrix = _dtype_forward(_tir_op.ptx_ldmatrix)
 ptx_cp_async = _dtype_forward(_tir_op.ptx_cp_async)
 ptx_cp_async_bulk = _dtype_forward(_tir_op.ptx_cp_async_bulk)
+ptx_cp_async_bulk_tensor = _dtype_forward(_tir_op.ptx_cp_async_bulk_tensor)
+ptx_wgmma_mma_async = _dtype_forward(_tir_op.ptx_wgmma_mma_async)
 mma_store = _dtype_forward(_tir_op.mma_store)
 mma_fill = _dtype_forward(_tir_op.mma_fill)
 vectorlow = _dtype_forward(_tir_op.vectorlow)
 vectorhigh = _dtype_forward(_tir_op.vectorhigh)
 vectorcombine = _dtype_forward(_tir_op.vectorcombine)
+vector_reduce_add = _dtype_forward(_tir_op.vector_reduce_add)
+vector_reduce_mul = _dtype_forward(_tir_op.vector_reduce_mul)
+vector_reduce_max = _dtype_forward(_tir_op.vector_reduce_max)
+vector_reduce_min = _dtype_forward(_tir_op.vector_reduce_min)
 get_active_lane_mask = _dtype_forward(_tir_op.get_active_lane_mask)
 
 
@@ -2186,11 +2195,20 @@ __all__ = [
     "simdgroup_store",
     "simdgroup_multiply_accumulate",
     "create_barriers",
+    "ptx_cp_async_bulk_tensor",
+    "ptx_wgmma_mma_async",
+    "ptx_wgmma_fence",
+    "ptx_wgmma_commit_group",
+    "ptx_wgmma_wait_group",
     "mma_store",
     "mma_fill",
     "vectorlow",
     "vectorhigh",
     "vectorcombine",
+    "vector_reduce_add",
+    "vector_reduce_mul",
+    "vector_reduce_max",
+    "vector_reduce_min",
     "assume",
     "undef",
     "tvm_call_packed",
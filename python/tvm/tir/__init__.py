@@ -72,6 +72,11 @@ from .op import (
     ptx_arrive_barrier_expect_tx,
     ptx_wait_barrier,
     create_barriers,
+    ptx_cp_async_bulk_tensor,
+    ptx_wgmma_mma_async,
+    ptx_wgmma_fence,
+    ptx_wgmma_commit_group,
+    ptx_wgmma_wait_group,
 )
 from .op import (
     make_filled_simdgroup_matrix,
@@ -80,6 +85,7 @@ from .op import (
     simdgroup_store,
 )
 from .op import vectorlow, vectorhigh, vectorcombine
+from .op import vector_reduce_add, vector_reduce_mul, vector_reduce_max, vector_reduce_min
 from .op import infinity, reinterpret
 from .op import exp, exp2, exp10, log, log2, log10, log1p, ldexp, clz
 from .op import sin, sinh, asin, asinh
@@ -1567,6 +1567,185 @@ def create_barriers(barrier_count):
     return call_intrin("", "tir.create_barriers", barrier_count)
 
 
+def ptx_cp_async_bulk_tensor(dtype, shared_ptr, shared_offset, tensor_map, barrier_id, *coords):
+    """TVM intrinsic for ptx async copy of a tensor tile from global to shared memory using
+    cp.async.bulk.tensor
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-cp-async-bulk-tensor
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result.
+
+    shared_ptr : Var
+        The shared memory pointer variable.
+
+    shared_offset : Expr
+        The offset of shared memory pointer.
+
+    tensor_map : Var
+        The address of the CUtensorMap of the tensor in global memory.
+
+    barrier_id : int
+        The ID of the barrier shared memory pointer.
+
+    coords : List[Expr]
+        The coordinates of the tile, from the innermost dimension of the tensor outwards.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_cp_async_bulk_tensor",
+        shared_ptr,
+        shared_offset,
+        tensor_map,
+        barrier_id,
+        *coords,
+    )
+
+
+def ptx_wgmma_mma_async(
+    dtype,
+    shape,
+    A_dtype,
+    B_dtype,
+    C_dtype,
+    a_smem,
+    a_offset,
+    b_smem,
+    b_offset,
+    accumulator,
+    c_index,
+    trans_a,
+    trans_b,
+    swizzle_bytes,
+    leading_byte_offset,
+    stride_byte_offset,
+):
+    """TVM intrinsic for ptx warpgroup mma instructions
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-mma-async
+
+    Parameters
+    ----------
+    dtype : str
+        The data type of the result.
+
+    shape : str
+        The shape of the mma, of the form m64nNk16.
+
+    A_dtype : str
+        The data type of multiplicand A.
+
+    B_dtype : str
+        The data type of multiplicand B.
+
+    C_dtype : str
+        The data type of the accumulator.
+
+    a_smem : Var
+        The shared memory pointer variable of multiplicand A.
+
+    a_offset : Expr
+        The element offset of multiplicand A.
+
+    b_smem : Var
+        The shared memory pointer variable of multiplicand B.
+
+    b_offset : Expr
+        The element offset of multiplicand B.
+
+    accumulator : Var
+        The local pointer variable of the accumulator.
+
+    c_index : Expr
+        The index of the first accumulator element of the thread.
+
+    trans_a : bool
+        Whether multiplicand A is stored M-major instead of K-major.
+
+    trans_b : bool
+        Whether multiplicand B is stored N-major instead of K-major.
+
+    swizzle_bytes : int
+        The swizzle of the shared memory layout, one of 0, 32, 64 and 128.
+
+    leading_byte_offset : Expr
+        The leading dimension byte offset of the matrix descriptors.
+
+    stride_byte_offset : Expr
+        The stride dimension byte offset of the matrix descriptors.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_wgmma_mma_async",
+        shape,
+        A_dtype,
+        B_dtype,
+        C_dtype,
+        a_smem,
+        a_offset,
+        b_smem,
+        b_offset,
+        accumulator,
+        c_index,
+        trans_a,
+        trans_b,
+        swizzle_bytes,
+        leading_byte_offset,
+        stride_byte_offset,
+    )
+
+
+def ptx_wgmma_fence():
+    """TVM intrinsic for the ordering of register accesses before ptx warpgroup mma instructions
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-fence
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_fence")
+
+
+def ptx_wgmma_commit_group():
+    """TVM intrinsic to commit the pending ptx warpgroup mma instructions into a group
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-commit-group
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_commit_group")
+
+
+def ptx_wgmma_wait_group(num):
+    """TVM intrinsic to wait for the completion of ptx warpgroup mma groups
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-wait-group
+
+    Parameters
+    ----------
+    num : int
+        The number of the most recent pending groups that may remain incomplete.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_wait_group", num)
+
+
 def make_filled_simdgroup_matrix(
     d: Var,
     index: PrimExpr,
@@ -1813,6 +1992,82 @@ def vectorcombine(dtype, vec1, vec2):
     return call_intrin(dtype, "tir.vectorcombine", vec1, vec2)
 
 
+def vector_reduce_add(dtype, vec):
+    """Sum the lanes of a vector, in any order of the lanes
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_add", vec)
+
+
+def vector_reduce_mul(dtype, vec):
+    """Multiply the lanes of a vector, in any order of the lanes
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_mul", vec)
+
+
+def vector_reduce_max(dtype, vec):
+    """Get the maximum of the lanes of a vector
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_max", vec)
+
+
+def vector_reduce_min(dtype, vec):
+    """Get the minimum of the lanes of a vector
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result, the element type of the vector.
+
+    vec : PrimExpr
+       The input vector.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(dtype, "tir.vector_reduce_min", vec)
+
+
 def ret(val):
     """Create a tir return expression
 
@@ -1180,7 +1180,8 @@ class Schedule(Object):
         2) All the blocks under the loop are complete blocks or reduction blocks, and have affine
         bindings
         3) For each block under the loop, the loop can only be contained in data-parallel block
-        iters' bindings
+        iters' bindings, or in reduction block iters' bindings of a block that reduces into a
+        single buffer with a commutative reducer, which is lowered to vector accumulators
 
         Parameters
         ----------
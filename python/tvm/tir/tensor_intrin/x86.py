@@ -17,6 +17,7 @@
 # pylint: disable=invalid-name,missing-function-docstring
 """Intrinsics for x86 tensorization."""
 from tvm.script import tir as T
+from tvm.target.codegen import llvm_version_major
 from .. import TensorIntrin
 
 
@@ -112,3 +113,108 @@ AVX512_DOT_16x4_INTRIN = "dot_16x4_avx512"
 TensorIntrin.register(
     AVX512_DOT_16x4_INTRIN, dot_product_16x4_u8i8i32_desc, dot_product_16x4_u8i8i32_avx512
 )
+
+
+def get_amx_intrin(in_dtype):
+    """Get the AMX intrinsic of a 16x16 block of C += A * B, for the tiles of 16 rows of 64 bytes
+    configured by `runtime.amx_tileconfig(16, 64)`.
+
+    A row of a tile holds 64 uint8 multiplied by int8 with tdpbusd, or 32 bfloat16 multiplied with
+    tdpbf16ps. B is packed by the quads or pairs of the reduction which a 32-bit lane holds, as
+    B[k // lanes, n, k % lanes]. Each call loads the tiles of C, A and B, and stores C.
+    """
+    if in_dtype == "uint8":
+        b_dtype, out_dtype, dot_intrin = "int8", "int32", "llvm.x86.tdpbusd"
+    else:
+        assert in_dtype == "bfloat16", f"AMX does not support {in_dtype}"
+        b_dtype, out_dtype, dot_intrin = "bfloat16", "float32", "llvm.x86.tdpbf16ps"
+    in_bytes = 1 if in_dtype == "uint8" else 2
+    lanes = 4 // in_bytes
+    k_dim = 64 // in_bytes
+
+    @T.prim_func
+    def amx_desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+        A = T.match_buffer(a, (16, k_dim), in_dtype, offset_factor=1)
+        B = T.match_buffer(b, (16, 16, lanes), b_dtype, offset_factor=1)
+        C = T.match_buffer(c, (16, 16), out_dtype, offset_factor=1)
+
+        with T.block("root"):
+            T.reads(C[0:16, 0:16], A[0:16, 0:k_dim], B[0:16, 0:16, 0:lanes])
+            T.writes(C[0:16, 0:16])
+            for i, j, k in T.grid(16, 16, k_dim):
+                with T.block("update"):
+                    vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                    C[vi, vj] = C[vi, vj] + T.cast(A[vi, vk], out_dtype) * T.cast(
+                        B[vk // lanes, vj, vk % lanes], out_dtype
+                    )
+
+    @T.prim_func
+    def amx_impl(a: T.handle, b: T.handle, c: T.handle) -> None:
+        sa = T.int32()
+        sb = T.int32()
+        sc = T.int32()
+        A = T.match_buffer(a, (16, k_dim), in_dtype, offset_factor=1, strides=[sa, 1])
+        B = T.match_buffer(b, (16, 16, lanes), b_dtype, offset_factor=1, strides=[sb, lanes, 1])
+        C = T.match_buffer(c, (16, 16), out_dtype, offset_factor=1, strides=[sc, 1])
+
+        with T.block("root"):
+            T.reads(C[0:16, 0:16], A[0:16, 0:k_dim], B[0:16, 0:16, 0:lanes])
+            T.writes(C[0:16, 0:16])
+            # C is in tmm0, A in tmm1 and B in tmm2, and the strides of the rows are in bytes.
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tileloadd64",
+                    T.uint32(3),
+                    T.uint8(0),
+                    C.access_ptr("r"),
+                    T.uint64(sc * 4),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tileloadd64",
+                    T.uint32(3),
+                    T.uint8(1),
+                    A.access_ptr("r"),
+                    T.uint64(sa * in_bytes),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tileloadd64",
+                    T.uint32(3),
+                    T.uint8(2),
+                    B.access_ptr("r"),
+                    T.uint64(sb * in_bytes),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void", dot_intrin, T.uint32(3), T.uint8(0), T.uint8(1), T.uint8(2)
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tilestored64",
+                    T.uint32(3),
+                    T.uint8(0),
+                    C.access_ptr("w"),
+                    T.uint64(sc * 4),
+                )
+            )
+
+    return amx_desc, amx_impl
+
+
+AMX_INT8_16x16x64_INTRIN = "amx_16x16x64_u8i8i32"
+
+AMX_BF16_16x16x32_INTRIN = "amx_16x16x32_bf16bf16f32"
+
+# The AMX intrinsics of LLVM are available since LLVM 12.
+if llvm_version_major() >= 12:
+    TensorIntrin.register(AMX_INT8_16x16x64_INTRIN, *get_amx_intrin("uint8"))
+    TensorIntrin.register(AMX_BF16_16x16x32_INTRIN, *get_amx_intrin("bfloat16"))
@@ -459,6 +459,14 @@ def MakePackedAPI():
     `DLTensor` of shape `[16,32]`, will define `n = 16` and `n=32`, based
     on the argument's shape.
 
+    If the `tir.emit_unchecked_api` pass config is set, an additional
+    entry `<global_symbol>__unchecked` is emitted for each function.  It
+    binds the parameters in the same way, but does not check the number
+    of arguments, their type codes or the fields of the `DLTensor`
+    arguments.  The graph executor and the Relax VM, which check the
+    inputs of a model before running its kernels, call this entry when
+    it is present.
+
     Returns
     -------
     fpass : tvm.transform.Pass
@@ -989,6 +997,21 @@ def InjectPermutedLayout():
     return _ffi_api.InjectPermutedLayout()  # type: ignore
 
 
+def InjectSharedMemoryPadding():
+    """Pad the rows of the shared memory buffers to reduce the bank conflicts of the accesses of
+    the warps, choosing the stride of the rows from the indices accessed by the lanes of a warp.
+
+    A buffer is padded if the block writing it is annotated with "pad_shared_memory", or by the
+    PassContext config "tir.pad_shared_memory" otherwise.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSharedMemoryPadding()  # type: ignore
+
+
 def UnifyThreadBinding():
     """Unify all the thread bindings for "blockIdx.x/y/z",
     "threadIdx.x/y/z", and "vthread.x/y/z". Before the unification,
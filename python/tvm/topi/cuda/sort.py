@@ -1083,6 +1083,90 @@ def topk_thrust(
     return out
 
 
+
+def segmented_topk_thrust(
+    data, k=1, axis=-1, ret_type="both", is_ascend=False, dtype="int64", workspace=None
+):
+    """Get the top k elements of every row along the last axis with segmented kernels.
+
+    k <= 32 uses a warp-level bitonic top-k per row, larger k a per-block radix select.
+    Only the k selected elements of every row are sorted.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        The input tensor, float16 or float32.
+
+    k : int
+        Number of top elements to select, must be in [1, data.shape[-1]].
+
+    axis : int, optional
+        Axis along which to select, must be the last axis.
+
+    ret_type: str, optional
+        The return type [both, values, indices].
+
+    is_ascend : boolean, optional
+        Whether to select the smallest instead of the largest elements.
+
+    dtype : string, optional
+        The data type of the indices output, int32 or int64.
+
+    workspace : Optional[tvm.te.Tensor]
+        A buffer to store intermediate results. If None, it will fallback to use thrust
+        internal memory allocation.
+
+    Returns
+    -------
+    out : tvm.te.Tensor or List[tvm.te.Tensor]
+        The computed result.
+    """
+    assert ret_type in ["both", "values", "indices"]
+    ndim = len(data.shape)
+    assert axis in (-1, ndim - 1), "segmented_topk only supports the last axis"
+    if isinstance(k, tvm.tir.IntImm):
+        k = k.value
+    assert isinstance(k, int) and k >= 1, "segmented_topk requires a constant k >= 1"
+
+    out_shape = list(data.shape[:-1]) + [k]
+    data_buf = tvm.tir.decl_buffer(data.shape, data.dtype, "data_buf", data_alignment=8)
+    if workspace is not None:
+        workspace_buf = tvm.tir.decl_buffer(
+            workspace.shape, workspace.dtype, "workspace_buf", data_alignment=8
+        )
+    else:
+        workspace_buf = None
+    out_bufs = [
+        tvm.tir.decl_buffer(out_shape, data.dtype, "value_buf", data_alignment=8),
+        tvm.tir.decl_buffer(out_shape, dtype, "indices_buf", data_alignment=8),
+    ]
+
+    def f_compute(ins, outs):
+        args = ["tvm.contrib.thrust.segmented_topk", ins[0], outs[0], outs[1], is_ascend]
+        if workspace is not None:
+            args.append(ins[1])
+        return tvm.tir.call_packed(*args)
+
+    is_ascend = 1 if is_ascend else 0
+
+    out = te.extern(
+        [out_shape, out_shape],
+        [data] if workspace is None else [data, workspace],
+        f_compute,
+        in_buffers=[data_buf] if workspace is None else [data_buf, workspace_buf],
+        out_buffers=out_bufs,
+        name="segmented_topk_gpu",
+        tag="segmented_topk_gpu",
+    )
+
+    if ret_type == "values":
+        out = out[0]
+    elif ret_type == "indices":
+        out = out[1]
+
+    return out
+
+
 def schedule_topk(outs):
     """Schedule for argsort operator.
 
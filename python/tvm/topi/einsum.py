@@ -42,3 +42,28 @@ def einsum(subscripts, *operand):
     """
 
     return cpp.einsum(subscripts, operand)
+
+
+def einsum_contraction_path(subscripts, *shapes):
+    """Find the order in which to contract the operands of an einsum pairwise, with the fewest
+    multiply-adds. :py:func:`einsum` evaluates an einsum of more than two operands in this order.
+
+    Parameters
+    ----------
+    subscripts : string
+        Specifies the subscripts for summation as comma separated list of subscript labels.
+
+    shapes : tuple of list of PrimExpr
+        The shapes of the operands.
+
+    Returns
+    -------
+    path : list of tuple of (int, int, string)
+        The pairwise contractions. Each one removes the operands at the two indices from the
+        current list of operands, and appends the result of the einsum of the equation on them.
+        It is empty for an einsum of at most two operands, or with an ellipsis.
+    """
+    return [
+        (int(lhs), int(rhs), str(equation))
+        for lhs, rhs, equation in cpp.einsum_contraction_path(subscripts, shapes)
+    ]
@@ -230,6 +230,57 @@ def _sparse_dense_sp_rhs_bsrmm(data, weight_data, weight_indices, weight_indptr)
     )
 
 
+def blocked_ell_dense(data, weight_data, weight_indices, out_dtype=None):
+    """Computes `data * weight^T` for a weight in the Blocked-ELL format.
+
+    The Blocked-ELL format is BSR with the same number of blocks in every block row, padded with
+    zero blocks. The loops of the product are then static, so that it can be tuned like a dense
+    matmul, with the "blocked_ell_dense" schedule rule of MetaSchedule.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        n-D with shape [..., K]
+
+    weight_data : tvm.te.Tensor
+        4-D with shape [N / bs_r, blocks_per_row, bs_r, bs_c], the blocks of each block row of
+        the weight
+
+    weight_indices : tvm.te.Tensor
+        2-D int32 with shape [N / bs_r, blocks_per_row], the block column of each block
+
+    out_dtype : Optional[str]
+        The output dtype, the dtype of data by default.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        n-D with shape [..., N]
+    """
+    num_block_rows, blocks_per_row, bs_r, bs_c = get_const_tuple(weight_data.shape)
+    out_dtype = out_dtype or data.dtype
+    oshape = list(data.shape[:-1]) + [num_block_rows * bs_r]
+    b = te.reduce_axis((0, blocks_per_row), name="b")
+    c = te.reduce_axis((0, bs_c), name="c")
+
+    def f(*indices):
+        block_row = tvm.tir.indexdiv(indices[-1], bs_r)
+        r = tvm.tir.indexmod(indices[-1], bs_r)
+        k = weight_indices[block_row, b] * bs_c + c
+        return te.sum(
+            data(*indices[:-1], k).astype(out_dtype)
+            * weight_data[block_row, b, r, c].astype(out_dtype),
+            axis=[b, c],
+        )
+
+    return te.compute(
+        oshape,
+        f,
+        name="blocked_ell_dense",
+        tag="blocked_ell_dense",
+        attrs={"schedule_rule": "blocked_ell_dense"},
+    )
+
 def sparse_transpose(sparse_data, sparse_indices, sparse_indptr):
     """
     Transpose a square sparse matrix,
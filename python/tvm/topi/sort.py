@@ -203,3 +203,65 @@ def topk(data, k=1, axis=-1, ret_type="both", is_ascend=False, dtype="int64"):
         tag="topk_cpu",
     )
     return out
+
+
+def segmented_topk(data, k=1, axis=-1, ret_type="both", is_ascend=False, dtype="int64"):
+    """Get the top k elements of every row along the last axis.
+
+    Unlike topk, every row is only partially sorted and the rows are processed in parallel,
+    which is faster for the many short rows of MoE gating and sampling.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        The input tensor.
+
+    k : int
+        Number of top elements to select, must be in [1, data.shape[-1]].
+
+    axis : int, optional
+        Axis along which to select, must be the last axis.
+
+    ret_type: str, optional
+        The return type [both, values, indices].
+
+    is_ascend : boolean, optional
+        Whether to select the smallest instead of the largest elements.
+
+    dtype : string, optional
+        The data type of the indices output, int32 or int64.
+
+    Returns
+    -------
+    out : tvm.te.Tensor or List[tvm.te.Tensor]
+        The computed result.
+    """
+    assert ret_type in ["both", "values", "indices"]
+    ndim = len(data.shape)
+    assert axis in (-1, ndim - 1), "segmented_topk only supports the last axis"
+    if isinstance(k, tvm.tir.IntImm):
+        k = k.value
+    assert isinstance(k, int) and k >= 1, "segmented_topk requires a constant k >= 1"
+
+    out_shape = list(data.shape[:-1]) + [k]
+    data_buf = tvm.tir.decl_buffer(data.shape, data.dtype, "data_buf", data_alignment=8)
+    out_bufs = [
+        tvm.tir.decl_buffer(out_shape, data.dtype, "value_buf", data_alignment=8),
+        tvm.tir.decl_buffer(out_shape, dtype, "indices_buf", data_alignment=8),
+    ]
+    out = te.extern(
+        [out_shape, out_shape],
+        [data],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.sort.segmented_topk", ins[0], outs[0], outs[1], is_ascend
+        ),
+        in_buffers=[data_buf],
+        out_buffers=out_bufs,
+        name="segmented_topk_cpu",
+        tag="segmented_topk_cpu",
+    )
+    if ret_type == "values":
+        return out[0]
+    if ret_type == "indices":
+        return out[1]
+    return out
@@ -16,9 +16,12 @@
 # under the License.
 # pylint: disable=invalid-name,too-many-locals,unused-variable
 """x86 nn operators"""
+import tvm
 from tvm import te
+from tvm.target.x86 import get_simd_32bit_lanes
 from ..utils import traverse_inline
 from .injective import schedule_injective_from_existing
+from .reduction import rfactor_vector_lanes
 
 
 def _schedule_softmax(softmax_op, s, outs):
@@ -48,7 +51,26 @@ def _schedule_softmax(softmax_op, s, outs):
 
     output = outs[0]
 
+    # Vectorize the reductions and the elementwise loops along the last axis
+    lanes = get_simd_32bit_lanes()
+    reduce_extent = softmax_op.output(0).shape[axis]
+    vectorize = (
+        axis == len(softmax_op.output(0).shape) - 1
+        and "float" in softmax_op.output(0).dtype
+        and isinstance(reduce_extent, tvm.tir.IntImm)
+        and int(reduce_extent) % lanes == 0
+    )
+
+    def _vectorize_last_axis(tensor):
+        _, inner = s[tensor].split(s[tensor].op.axis[-1], factor=lanes)
+        s[tensor].vectorize(inner)
+
     def _schedule(output_op, softmax_op):
+        # The reductions are factored before they are attached
+        reduce_rfs = []
+        if vectorize:
+            reduce_rfs = [rfactor_vector_lanes(s, max_elem), rfactor_vector_lanes(s, expsum)]
+
         # only parallelize outer dimensions up to axis
         outer_axes = [output_op.axis[i] for i in range(0, axis)]
         fused_outer_axes = s[output_op].fuse(*outer_axes)
@@ -68,6 +90,15 @@ def _schedule_softmax(softmax_op, s, outs):
         if exp is not None:
             s[exp].compute_at(s[output_op], fused_outer_axes)
 
+        if vectorize:
+            for rf in reduce_rfs:
+                s[rf].compute_at(s[output_op], fused_outer_axes)
+            if exp is not None and delta is None:
+                _vectorize_last_axis(exp)
+            if softmax_op != output_op:
+                _vectorize_last_axis(softmax_op.output(0))
+            _vectorize_last_axis(output_op.output(0))
+
     if list(output.shape) == list(softmax_op.output(0).shape):
         _schedule(output.op, softmax_op)
     else:
@@ -18,11 +18,92 @@
 """x86 declaration and schedules."""
 import tvm
 from tvm import te
+from tvm.target.x86 import get_simd_32bit_lanes
 from .injective import schedule_injective_from_existing
 from .. import tag
 from ..utils import get_const_tuple
 
 
+# Split a reduction across threads if there are fewer outputs than this
+_MIN_PARALLEL_OUTPUTS = 8
+# The number of chunks a reduction is split into across threads
+_NUM_REDUCE_CHUNKS = 16
+# The minimum number of elements in each chunk of a reduction split across threads
+_MIN_CHUNK_EXTENT = 2048
+
+
+def reduces_innermost_axis(op):
+    """Whether a reduction reads its inputs along their innermost axis, e.g. a reduction over the
+    last axes of a row-major tensor.
+
+    Parameters
+    ----------
+    op: tvm.te.ComputeOp
+        The reduction.
+
+    Returns
+    -------
+    ret: bool
+        True if every input of the reduction is indexed by the innermost reduce axis last.
+    """
+    if not op.reduce_axis or len(op.body) != 1 or not isinstance(op.body[0], tvm.tir.Reduce):
+        return False
+    innermost = op.reduce_axis[-1].var
+    loads = []
+
+    def _collect(node):
+        if isinstance(node, tvm.tir.ProducerLoad):
+            loads.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(op.body[0].source[0], _collect)
+    return bool(loads) and all(load.indices[-1].same_as(innermost) for load in loads)
+
+
+def rfactor_vector_lanes(sch, out):
+    """Accumulate a reduction in vector registers.
+
+    The fused reduce axis of `out` is split by the SIMD width, and the inner part is factored out
+    into a stage whose vectorized axis holds one partial result per lane. `out` then only reduces
+    the lanes. For the loads to be contiguous, the reduction should read its inputs along the
+    innermost reduce axis, with an extent divisible by the SIMD width, see
+    `reduces_innermost_axis`.
+
+    Parameters
+    ----------
+    sch: Schedule
+        The schedule.
+    out: Tensor
+        The output of the reduction.
+
+    Returns
+    -------
+    rf: Tensor
+        The factored stage, to be attached at a loop of `out` or its consumers.
+    """
+    reduce_axis = sch[out].op.reduce_axis
+    k = sch[out].fuse(*reduce_axis) if len(reduce_axis) > 1 else reduce_axis[0]
+    _, ki = sch[out].split(k, factor=get_simd_32bit_lanes())
+    rf = sch.rfactor(out, ki)
+    sch[rf].vectorize(sch[rf].op.axis[0])
+    return rf
+
+
+def _vectorizable_reduce_extent(op):
+    """The extent of the reductions that can be accumulated in vector registers, or 0."""
+    out = op.output(0)
+    if "float" not in out.dtype or not reduces_innermost_axis(op):
+        return 0
+    extent = 1
+    for axis in op.reduce_axis:
+        if not isinstance(axis.dom.extent, tvm.tir.IntImm):
+            return 0
+        extent *= int(axis.dom.extent)
+    # The lanes of a vector must not straddle the innermost axis
+    lanes = get_simd_32bit_lanes()
+    innermost_extent = int(op.reduce_axis[-1].dom.extent)
+    return extent if innermost_extent % lanes == 0 and extent >= 2 * lanes else 0
+
+
 def _schedule_reduce(sch, op, is_idx_reduce=False):
     if is_idx_reduce:
         real_out = op.output(0)
@@ -38,6 +119,30 @@ def _schedule_reduce(sch, op, is_idx_reduce=False):
             const_shape = False
             break
 
+    reduce_extent = 0 if is_idx_reduce or not const_shape else _vectorizable_reduce_extent(op)
+    if reduce_extent:
+        num_outputs = 1
+        for d in out_shape:
+            num_outputs *= d
+        lanes = get_simd_32bit_lanes()
+        if (
+            num_outputs < _MIN_PARALLEL_OUTPUTS
+            and reduce_extent % (_NUM_REDUCE_CHUNKS * lanes) == 0
+            and reduce_extent // _NUM_REDUCE_CHUNKS >= _MIN_CHUNK_EXTENT
+        ):
+            # Too few outputs to parallelize over: reduce chunks of the reduce axis in parallel,
+            # each in vector registers, and then the partial results of the chunks.
+            reduce_axis = sch[out].op.reduce_axis
+            k = sch[out].fuse(*reduce_axis) if len(reduce_axis) > 1 else reduce_axis[0]
+            kp, _ = sch[out].split(k, nparts=_NUM_REDUCE_CHUNKS)
+            chunk_rf = sch.rfactor(out, kp)
+            vector_rf = rfactor_vector_lanes(sch, chunk_rf)
+            fused = sch[chunk_rf].fuse(*sch[chunk_rf].op.axis)
+            sch[chunk_rf].parallel(fused)
+            sch[vector_rf].compute_at(sch[chunk_rf], fused)
+            return
+        vector_rf = rfactor_vector_lanes(sch, out)
+
     if const_shape:
         naxes = len(sch[out].op.axis)
         parallelism = 1
@@ -49,6 +154,9 @@ def _schedule_reduce(sch, op, is_idx_reduce=False):
             fuse_axes.append(ivar)
         fused = sch[out].fuse(*fuse_axes)
         sch[out].parallel(fused)
+        if reduce_extent:
+            inner = fused if len(fuse_axes) == naxes else sch[out].op.axis[-1]
+            sch[vector_rf].compute_at(sch[out], inner)
     else:
         if len(sch[out].op.axis) >= 5:
             # avoid too many parallelism
@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Utilities for computing an approximate roofline model"""
-from typing import Dict, Optional, Union
+from typing import Dict, Optional, Sequence, Union
 
 import numpy as np
 
@@ -77,6 +77,25 @@ class SaveLoweredTIR:
                     self.functions[v] = func
 
 
+# The metrics of the CUPTI metric collector that measure the DRAM traffic of a kernel.
+MEASURED_BYTES_METRICS = ("dram_read_bytes", "dram_write_bytes")
+
+
+def _measured_bytes(call) -> Optional[int]:
+    """The DRAM bytes a call moved as measured by the performance counters, if it has them."""
+    if not all(metric in call for metric in MEASURED_BYTES_METRICS):
+        return None
+    return sum(call[metric].value for metric in MEASURED_BYTES_METRICS)
+
+
+def _tir_flops(prim: tir.PrimFunc, default: float) -> float:
+    """The FLOPs of a PrimFunc from the TIR analysis, or `default` if it cannot count them."""
+    try:
+        return tir.analysis.estimate_tir_flops(IRModule({"main": prim}))
+    except Exception:  # pylint: disable=broad-except
+        return default
+
+
 def roofline_from_existing(
     report: profiling.Report,
     tir_functions: Dict[GlobalVar, tir.PrimFunc],
@@ -188,6 +207,24 @@ def roofline_from_existing(
             call["Percent of Theoretical Optimal"] = profiling.Ratio(
                 per_compute_bound if compute_bound else per_mem_bound
             )
+
+            # With the DRAM traffic of the hardware counters, the roofline uses the measured
+            # bytes instead of the estimated ones.
+            measured_bytes = _measured_bytes(call)
+            if measured_bytes:
+                tir_flops = _tir_flops(prim, flops)
+                measured_inten = tir_flops / measured_bytes
+                call["TIR FLOPs"] = profiling.Count(int(tir_flops))
+                call["Measured Bytes"] = profiling.Count(int(measured_bytes))
+                call["Measured Arithmetic Intensity"] = profiling.Ratio(measured_inten)
+                call["Measured Bandwidth"] = profiling.Ratio(measured_bytes / runtime)
+                compute_bound = measured_inten > ridge_point
+                call["Bound"] = "compute" if compute_bound else "memory"
+                call["Percent of Theoretical Optimal"] = profiling.Ratio(
+                    (tir_flops / runtime) / peak_flops * 100.0
+                    if compute_bound
+                    else (measured_bytes / runtime) / peak_bandwidth * 100
+                )
             new_calls.append(call)
         else:
             new_calls.append(call)
@@ -200,6 +237,7 @@ def roofline_analysis(
     target: Union[str, Target],
     dev: Device,
     remote: Optional[RPCSession] = None,
+    collectors: Optional[Sequence[profiling.MetricCollector]] = None,
 ) -> profiling.Report:
     """
     Create a profiling report that contains roofline and other estimated
@@ -225,6 +263,16 @@ def roofline_analysis(
       - FLOP/s: floating point operations per second.
       - Bandwidth: Number of bytes loaded per second.
 
+    When a collector measures the DRAM traffic of the kernels, i.e. the
+    `dram_read_bytes` and `dram_write_bytes` metrics of
+    :py:class:`tvm.runtime.profiling.CUPTIMetricCollector`, the bound and the
+    percent of theoretical optimal come from the measured bytes and the FLOPs of
+    `tvm.tir.analysis.estimate_tir_flops` instead, which are reported as:
+      - Measured Bytes: number of bytes read and written in DRAM.
+      - TIR FLOPs: number of floating point operations counted on the TIR.
+      - Measured Arithmetic Intensity: ratio of TIR FLOPs per measured byte.
+      - Measured Bandwidth: number of measured bytes per second.
+
     Parameters
     ----------
     mod : IRModule
@@ -242,6 +290,10 @@ def roofline_analysis(
       Remote session used to upload artifacts for runtime evaluation. Must be
       the same session used to create `dev`.
 
+    collectors : Optional[Sequence[MetricCollector]]
+      Metric collectors to profile the operators with, e.g. a
+      :py:class:`tvm.runtime.profiling.CUPTIMetricCollector`.
+
     Returns
     -------
 
@@ -274,6 +326,6 @@ def roofline_analysis(
     vmexec = profiler_vm.VirtualMachineProfiler(lib, dev)
 
     args = _create_args(mod, dev, remote=remote)
-    report = vmexec.profile(*args)
+    report = vmexec.profile(*args, collectors=collectors)
 
     return roofline_from_existing(report, save_tir.functions, target, dev, remote=remote)
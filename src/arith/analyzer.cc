@@ -21,10 +21,18 @@
  * \file tvm/arith/analyzer.cc
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include "../support/utils.h"
 #include "./scalable_expression.h"
 #include "const_fold.h"
 #include "product_normal_form.h"
@@ -32,14 +40,116 @@
 namespace tvm {
 namespace arith {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("arith.enable_simplify_cache", Bool);
+
+/*!
+ * \brief The memoized results of Analyzer::Simplify.
+ *
+ * Each constraint context gets a fresh id when entered, and the id of the enclosing context
+ * is restored when it exits, which brings the results computed in it back into use.
+ */
+class SimplifyCache {
+ public:
+  /*! \brief The number of entries above which the cache is cleared */
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  /*! \brief The hit and miss counters of all the analyzers of the process */
+  static std::atomic<int64_t> global_hits;
+  static std::atomic<int64_t> global_misses;
+
+  Optional<PrimExpr> Lookup(const PrimExpr& expr, int steps, size_t* hash) {
+    *hash = support::HashCombine(support::HashCombine(StructuralHash()(expr), steps),
+                                 context_stack_.back());
+    auto range = entries_.equal_range(*hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry& entry = it->second;
+      if (entry.steps == steps && entry.context == context_stack_.back() &&
+          StructuralEqual()(entry.expr, expr)) {
+        ++hits_;
+        ++global_hits;
+        return entry.result;
+      }
+    }
+    ++misses_;
+    ++global_misses;
+    return NullOpt;
+  }
+
+  void Insert(size_t hash, const PrimExpr& expr, int steps, const PrimExpr& result) {
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.emplace(hash, Entry{expr, steps, context_stack_.back(), result});
+  }
+
+  void EnterContext() { context_stack_.push_back(next_context_++); }
+
+  void ExitContext() {
+    ICHECK_GT(context_stack_.size(), 1);
+    context_stack_.pop_back();
+  }
+
+  void Clear() { entries_.clear(); }
+
+  Map<String, Integer> GetStats() const {
+    return {{"hits", Integer(hits_)}, {"misses", Integer(misses_)}};
+  }
+
+ private:
+  struct Entry {
+    PrimExpr expr;
+    int steps;
+    uint64_t context;
+    PrimExpr result;
+  };
+  std::unordered_multimap<size_t, Entry> entries_;
+  std::vector<uint64_t> context_stack_{0};
+  uint64_t next_context_{1};
+  int64_t hits_{0};
+  int64_t misses_{0};
+};
+
+std::atomic<int64_t> SimplifyCache::global_hits{0};
+std::atomic<int64_t> SimplifyCache::global_misses{0};
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
       rewrite_simplify(this),
       canonical_simplify(this),
-      int_set(this) {}
+      int_set(this) {
+  if (transform::PassContext::Current()
+          ->GetConfig<Bool>("arith.enable_simplify_cache", Bool(false))
+          .value()) {
+    EnableSimplifyCache();
+  }
+}
+
+Analyzer::~Analyzer() = default;
+
+void Analyzer::EnableSimplifyCache(bool enable) {
+  if (!enable) {
+    simplify_cache_.reset();
+  } else if (simplify_cache_ == nullptr) {
+    simplify_cache_ = std::make_unique<SimplifyCache>();
+  }
+}
+
+void Analyzer::ClearSimplifyCache() {
+  if (simplify_cache_) {
+    simplify_cache_->Clear();
+  }
+}
+
+Map<String, Integer> Analyzer::GetSimplifyCacheStats() const {
+  if (simplify_cache_) {
+    return simplify_cache_->GetStats();
+  }
+  return {{"hits", Integer(0)}, {"misses", Integer(0)}};
+}
 
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
+  ClearSimplifyCache();
   PrimExpr new_expr = expr;
   new_expr = this->canonical_simplify(new_expr);
   new_expr = this->rewrite_simplify(new_expr);
@@ -54,6 +164,7 @@ void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
 
 void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   ICHECK(range.defined());
+  ClearSimplifyCache();
   if (tir::is_one(range->extent)) {
     this->Bind(var, range->min, allow_override);
   } else {
@@ -95,6 +206,7 @@ void Analyzer::MarkGlobalNonNegValue(const PrimExpr& value) {
   };
   UnpackReduction<tir::MulNode>(symbol_scale, fcollect_prod);
   if (cscale <= 0) return;
+  ClearSimplifyCache();
   // override the constant int bound by marking it as non-negative
   // NOTE: there might be future opportunities of more bound hint
   // this is a simple step and covers all the current needs
@@ -129,6 +241,14 @@ void ConstraintContext::EnterWithScope() {
   recovery_functions_.push_back(analyzer_->rewrite_simplify.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->int_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->transitive_comparisons.EnterConstraint(constraint_));
+  if (analyzer_->simplify_cache_) {
+    analyzer_->simplify_cache_->EnterContext();
+    recovery_functions_.push_back([analyzer = analyzer_]() {
+      if (analyzer->simplify_cache_) {
+        analyzer->simplify_cache_->ExitContext();
+      }
+    });
+  }
 }
 
 void ConstraintContext::ExitWithScope() {
@@ -248,6 +368,20 @@ bool Analyzer::CanProve(const PrimExpr& expr, ProofStrength strength) {
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
+  size_t hash = 0;
+  if (simplify_cache_) {
+    if (Optional<PrimExpr> cached = simplify_cache_->Lookup(expr, steps, &hash)) {
+      return cached.value();
+    }
+  }
+  PrimExpr res = SimplifyUncached(expr, steps);
+  if (simplify_cache_) {
+    simplify_cache_->Insert(hash, expr, steps, res);
+  }
+  return res;
+}
+
+PrimExpr Analyzer::SimplifyUncached(const PrimExpr& expr, int steps) {
   PrimExpr res = expr;
 
   // Always starts with a canonical simplification, as some structural property
@@ -282,6 +416,7 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "const_int_bound_update") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
         self->const_int_bound.Update(args[0], args[1], args[2]);
+        self->ClearSimplifyCache();
       });
     } else if (name == "Simplify") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
@@ -343,12 +478,29 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
         std::int64_t flags = args[0];
         self->rewrite_simplify.SetEnabledExtensions(
             static_cast<RewriteSimplifier::Extension>(flags));
+        self->ClearSimplifyCache();
       });
+    } else if (name == "enable_simplify_cache") {
+      return PackedFunc(
+          [self](TVMArgs args, TVMRetValue* ret) { self->EnableSimplifyCache(args[0]); });
+    } else if (name == "get_simplify_cache_stats") {
+      return PackedFunc(
+          [self](TVMArgs args, TVMRetValue* ret) { *ret = self->GetSimplifyCacheStats(); });
     }
     return PackedFunc();
   };
   *ret = TypedPackedFunc<PackedFunc(std::string)>(f);
 });
 
+TVM_REGISTER_GLOBAL("arith.GetSimplifyCacheStats").set_body_typed([]() -> Map<String, Integer> {
+  return {{"hits", Integer(SimplifyCache::global_hits.load())},
+          {"misses", Integer(SimplifyCache::global_misses.load())}};
+});
+
+TVM_REGISTER_GLOBAL("arith.ResetSimplifyCacheStats").set_body_typed([]() {
+  SimplifyCache::global_hits = 0;
+  SimplifyCache::global_misses = 0;
+});
+
 }  // namespace arith
 }  // namespace tvm
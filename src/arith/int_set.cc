@@ -855,9 +855,123 @@ bool IntSet::MatchRange(const Range& b) const {
          ProveEqual(&ana, a_int->max_value, b->extent + b->min - 1);
 }
 
+/*!
+ * \brief A bound of the form `var * scale + offset`, with constant scale and offset, in the form
+ * the simplifier leaves as is. The var is null for the constant bounds.
+ */
+struct AffineBound {
+  const VarNode* var{nullptr};
+  int64_t scale{0};
+  int64_t offset{0};
+
+  bool SameBase(const AffineBound& other) const {
+    return var == other.var && scale == other.scale;
+  }
+};
+
+/*!
+ * \brief Match a bound of the form `x`, `x * s`, `x * s + c`, `x * s - c`, `x + c`, `x - c` or
+ * `c`, with positive constants other than the trivial ones.
+ */
+bool MatchAffineBound(const PrimExpr& expr, AffineBound* bound) {
+  if (!expr.dtype().is_int() || expr.dtype().lanes() != 1) {
+    return false;
+  }
+  const PrimExpr* base = &expr;
+  bound->offset = 0;
+  if (const auto* imm = expr.as<IntImmNode>()) {
+    bound->var = nullptr;
+    bound->offset = imm->value;
+    return true;
+  } else if (const auto* add = expr.as<AddNode>()) {
+    const auto* imm = add->b.as<IntImmNode>();
+    if (imm == nullptr || imm->value <= 0) return false;
+    base = &add->a;
+    bound->offset = imm->value;
+  } else if (const auto* sub = expr.as<SubNode>()) {
+    const auto* imm = sub->b.as<IntImmNode>();
+    if (imm == nullptr || imm->value <= 0) return false;
+    base = &sub->a;
+    bound->offset = -imm->value;
+  }
+  if (const auto* var = base->as<VarNode>()) {
+    bound->var = var;
+    bound->scale = 1;
+    return true;
+  } else if (const auto* mul = base->as<MulNode>()) {
+    const auto* var = mul->a.as<VarNode>();
+    const auto* imm = mul->b.as<IntImmNode>();
+    if (var == nullptr || imm == nullptr || imm->value <= 1) return false;
+    bound->var = var;
+    bound->scale = imm->value;
+    return true;
+  }
+  return false;
+}
+
+/*!
+ * \brief The fast path of the union and the intersection of the intervals whose lower bounds, and
+ * whose upper bounds, are the same affine expression up to a constant offset. The bounds of the
+ * result are the bounds of the inputs, so neither an analyzer nor a new expression is needed.
+ * \param sets The sets to combine.
+ * \param is_union Whether to take the union or the intersection.
+ * \param result The result, set only if the fast path applies.
+ * \return Whether the fast path applies.
+ */
+bool CombineAffineIntervals(const Array<IntSet>& sets, bool is_union, IntSet* result) {
+  const PrimExprNode* min_value = nullptr;
+  const PrimExprNode* max_value = nullptr;
+  AffineBound min_bound, max_bound;
+  for (const IntSet& set : sets) {
+    const auto* interval = set.as<IntervalSetNode>();
+    if (interval == nullptr) return false;
+    // The empty sets are skipped by the union, and the bounds of the others are not infinite.
+    if (is_union && interval->IsEmpty()) continue;
+    AffineBound lower, upper;
+    if (!MatchAffineBound(interval->min_value, &lower) ||
+        !MatchAffineBound(interval->max_value, &upper)) {
+      return false;
+    }
+    if (min_value == nullptr) {
+      min_value = interval->min_value.get();
+      max_value = interval->max_value.get();
+      min_bound = lower;
+      max_bound = upper;
+      continue;
+    }
+    if (!lower.SameBase(min_bound) || !upper.SameBase(max_bound) ||
+        interval->min_value.dtype() != min_value->dtype ||
+        interval->max_value.dtype() != max_value->dtype) {
+      return false;
+    }
+    if (is_union ? lower.offset < min_bound.offset : lower.offset > min_bound.offset) {
+      min_value = interval->min_value.get();
+      min_bound = lower;
+    }
+    if (is_union ? upper.offset > max_bound.offset : upper.offset < max_bound.offset) {
+      max_value = interval->max_value.get();
+      max_bound = upper;
+    }
+  }
+  if (min_value == nullptr) return false;
+  if (!is_union && min_bound.SameBase(max_bound) && max_bound.offset < min_bound.offset) {
+    *result = IntervalSet::Empty();
+  } else if (!is_union && !min_bound.SameBase(max_bound)) {
+    // The emptiness of the intersection is up to the analyzer.
+    return false;
+  } else {
+    *result = IntervalSet(GetRef<PrimExpr>(min_value), GetRef<PrimExpr>(max_value));
+  }
+  return true;
+}
+
 IntSet Union(const Array<IntSet>& sets) {
   if (sets.size() == 0) return IntSet::Nothing();
   if (sets.size() == 1) return sets[0];
+  IntSet result;
+  if (CombineAffineIntervals(sets, /*is_union=*/true, &result)) {
+    return result;
+  }
   Analyzer ana;
   IntervalSet x = ToIntervalSet(sets[0]);
   for (size_t i = 1; i < sets.size(); ++i) {
@@ -941,6 +1055,10 @@ Array<IntSet> UnionRegionLowerBound(const Array<Array<IntSet>>& nd_int_sets) {
 IntSet Intersect(const Array<IntSet>& sets) {
   if (sets.size() == 0) return IntSet::Nothing();
   if (sets.size() == 1) return sets[0];
+  IntSet result;
+  if (CombineAffineIntervals(sets, /*is_union=*/false, &result)) {
+    return result;
+  }
   Analyzer ana;
   IntervalSet x = ToIntervalSet(sets[0]);
   for (size_t i = 1; i < sets.size(); ++i) {
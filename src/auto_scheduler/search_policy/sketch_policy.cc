@@ -32,9 +32,12 @@
 #include <algorithm>
 #include <iomanip>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -66,6 +69,99 @@ static InitUnroll init_unroll;
 static InitVectorization init_vectorization;
 static InitThreadBind init_thread_bind;
 
+/********** Similar task state cache **********/
+
+/*!
+ * \brief The best measured states of the tasks searched in this process, indexed by the structure
+ * of their compute DAGs, so that similar tasks seed the search of each other.
+ */
+class SimilarTaskStateCache {
+ public:
+  static SimilarTaskStateCache* Global() {
+    static SimilarTaskStateCache inst;
+    return &inst;
+  }
+
+  /*! \brief Add a measured state of a task. */
+  void Add(const SearchTask& task, const State& state, double throughput) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Entry>& entries = states_[StructureHash(task)][task->workload_key];
+    std::string state_str = state.ToStr();
+    for (const Entry& entry : entries) {
+      if (entry.state_str == state_str) {
+        return;
+      }
+    }
+    auto pos = std::find_if(entries.begin(), entries.end(), [throughput](const Entry& entry) {
+      return entry.throughput < throughput;
+    });
+    entries.insert(pos, Entry{state, std::move(state_str), throughput});
+    if (entries.size() > kMaxStatesPerTask) {
+      entries.pop_back();
+    }
+  }
+
+  /*!
+   * \brief Get the best states of the tasks similar to a task, taking the states of each task in
+   * turn.
+   */
+  std::vector<State> Get(const SearchTask& task, int num_states) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<State> ret;
+    auto it = states_.find(StructureHash(task));
+    if (it == states_.end()) {
+      return ret;
+    }
+    for (size_t rank = 0; rank < kMaxStatesPerTask; ++rank) {
+      for (const auto& [workload_key, entries] : it->second) {
+        if (static_cast<int>(ret.size()) == num_states) {
+          return ret;
+        }
+        if (workload_key != task->workload_key && rank < entries.size()) {
+          ret.push_back(entries[rank].state);
+        }
+      }
+    }
+    return ret;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    states_.clear();
+  }
+
+ private:
+  struct Entry {
+    State state;
+    std::string state_str;
+    double throughput;
+  };
+
+  /*! \brief The maximum number of states kept for each task. */
+  static constexpr size_t kMaxStatesPerTask = 16;
+
+  /*!
+   * \brief Hash the structure of the compute DAG of a task: its stages and the kinds of their
+   * iterators, but not their extents. The transform steps of a task can be replayed on the tasks
+   * of the same structure.
+   */
+  static size_t StructureHash(const SearchTask& task) {
+    std::ostringstream os;
+    os << task->target->str();
+    for (const Stage& stage : task->compute_dag->init_state->stages) {
+      os << ';' << static_cast<int>(stage->op_type) << stage->op->name << ':';
+      for (const Iterator& iter : stage->iters) {
+        os << static_cast<int>(iter->iter_kind);
+      }
+    }
+    return std::hash<std::string>()(os.str());
+  }
+
+  std::mutex mutex_;
+  /*! \brief The states of each task, by structure hash and workload key. */
+  std::unordered_map<size_t, std::map<std::string, std::vector<Entry>>> states_;
+};
+
 /********** Sketch policy **********/
 TVM_REGISTER_NODE_TYPE(SketchPolicyNode);
 
@@ -89,6 +185,10 @@ SketchPolicy::SketchPolicy(SearchTask task, CostModel program_cost_model,
     // - auto_scheduler.PreloadCustomSketchRule: Add user custom sketch rules to `sketch_rules`,
     //   these rules will be processed prior to the default rules.
     node->RunCallbacks(init_search_callbacks.value());
+    for (size_t i = 0; i < node->measured_states_vector_.size(); ++i) {
+      SimilarTaskStateCache::Global()->Add(node->search_task, node->measured_states_vector_[i],
+                                           node->measured_states_throughputs_[i]);
+    }
   }
 
   // NOTE: There are strong dependency among the rules below,
@@ -232,6 +332,7 @@ State SketchPolicyNode::Search(int n_trials, int early_stopping, int num_measure
       for (const auto& res : results) {
         measured_states_throughputs_.push_back(1.0 / FloatArrayMean(res->costs));
       }
+      ShareMeasuredStates(inputs, results);
     }
     PrintTitle("Done", verbose);
 
@@ -269,6 +370,7 @@ std::pair<Array<MeasureInput>, Array<MeasureResult>> SketchPolicyNode::ContinueS
   for (const auto& res : results) {
     measured_states_throughputs_.push_back(1.0 / FloatArrayMean(res->costs));
   }
+  ShareMeasuredStates(inputs, results);
 
   auto t_begin = std::chrono::high_resolution_clock::now();
 
@@ -304,6 +406,15 @@ Array<State> SketchPolicyNode::SearchOneRound(int num_random_states, Array<State
   for (int i = 0; i < num_use_measured; i++) {
     init_population.push_back(measured_states_vector_[indices[i]]);
   }
+  // Also insert the best states of similar tasks
+  int num_use_similar = static_cast<int>(
+      GetDoubleParam(params, SketchParamKey::SampleInitPopulation::use_similar_task_ratio) *
+      population);
+  if (num_use_similar > 0) {
+    for (const State& state : SampleSimilarTaskStates(num_use_similar)) {
+      init_population.push_back(state);
+    }
+  }
   // Sample some random states for eps-greedy
   if (num_random_states > 0 && random_states != nullptr) {
     *random_states = RandomSampleStates(init_population, &rand_gen, num_random_states);
@@ -484,6 +595,53 @@ Array<State> SketchPolicyNode::SampleInitPopulation(const Array<State>& sketches
   return out_states;
 }
 
+Array<State> SketchPolicyNode::SampleSimilarTaskStates(int num_states) {
+  Array<State> out_states;
+  for (const State& src : SimilarTaskStateCache::Global()->Get(search_task, num_states)) {
+    State state = search_task->compute_dag->init_state;
+    Array<Step> steps;
+    try {
+      for (Step step : src->transform_steps) {
+        if (auto ps = step.as<SplitStepNode>()) {
+          // Keep the split factors if they still tile the extent of the split iterator in this
+          // task, and leave them to be resampled otherwise.
+          const Iterator& iter = state->stages[ps->stage_id]->iters[ps->iter_id];
+          Optional<PrimExpr> extent;
+          if (iter->range.defined()) {
+            extent = iter->range->extent;
+          }
+          Array<Optional<Integer>> lengths = ps->lengths;
+          const auto* extent_imm = extent ? extent.value().as<IntImmNode>() : nullptr;
+          int64_t product = 1;
+          for (const auto& len : lengths) {
+            product *= len ? len.value()->value : 0;
+          }
+          if (extent_imm == nullptr || product == 0 || extent_imm->value % product != 0) {
+            lengths = Array<Optional<Integer>>(lengths.size(), NullOpt);
+          }
+          step = SplitStep(ps->stage_id, ps->iter_id, extent, lengths, ps->inner_to_outer);
+        }
+        StepApplyToState(step, &state, search_task->compute_dag);
+        steps.push_back(step);
+      }
+    } catch (const std::exception&) {
+      // The steps do not apply to this task.
+      continue;
+    }
+    state.CopyOnWrite()->transform_steps = steps;
+    if (init_fill_tile_size.Apply(this, &state, &rand_gen) ==
+        PopulationGenerationRule::ResultKind::kValid) {
+      out_states.push_back(std::move(state));
+    }
+  }
+  out_states = search_task->compute_dag.InferBound(out_states);
+  PruneInvalidState(search_task, &out_states);
+  if (!out_states.empty()) {
+    StdCout(verbose) << "Transfer Similar Task States\t#s: " << out_states.size() << std::endl;
+  }
+  return out_states;
+}
+
 Array<State> SketchPolicyNode::EvolutionarySearch(const Array<State>& init_population,
                                                   int out_size) {
   Array<State> best_states;
@@ -672,6 +830,16 @@ Array<MeasureInput> SketchPolicyNode::PickStatesWithEpsGreedy(const Array<State>
 }
 
 /********** PreloadCustomSketchRule **********/
+void SketchPolicyNode::ShareMeasuredStates(const Array<MeasureInput>& inputs,
+                                           const Array<MeasureResult>& results) {
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (results[i]->error_no == 0) {
+      SimilarTaskStateCache::Global()->Add(search_task, inputs[i]->state,
+                                           1.0 / FloatArrayMean(results[i]->costs));
+    }
+  }
+}
+
 TVM_REGISTER_OBJECT_TYPE(PreloadCustomSketchRuleNode);
 
 PreloadCustomSketchRule::PreloadCustomSketchRule(PackedFunc meet_condition_func,
@@ -709,6 +877,15 @@ TVM_REGISTER_GLOBAL("auto_scheduler.SketchPolicySampleInitialPopulation")
       return init_population;
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.SketchPolicySampleSimilarTaskStates")
+    .set_body_typed([](SketchPolicy policy, int num_states) {
+      return policy->SampleSimilarTaskStates(num_states);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.ClearSimilarTaskStateCache").set_body_typed([]() {
+  SimilarTaskStateCache::Global()->Clear();
+});
+
 TVM_REGISTER_GLOBAL("auto_scheduler.SketchPolicyEvolutionarySearch")
     .set_body_typed([](SketchPolicy policy, Array<State> init_population, int out_size) {
       Array<State> states = policy->EvolutionarySearch(init_population, out_size);
@@ -61,6 +61,11 @@ struct SketchParamKey {
     static constexpr const char* min_population = "sample_init_min_population";
     /*! \brief The maximum percentage of measured states in the initial sampling. */
     static constexpr const char* use_measured_ratio = "sample_init_use_measured_ratio";
+    /*!
+     * \brief The maximum percentage of states transferred from the measured states of similar
+     * tasks in the initial sampling.
+     */
+    static constexpr const char* use_similar_task_ratio = "sample_init_use_similar_task_ratio";
   };
 
   struct EvolutionarySearch {
@@ -130,6 +135,18 @@ class SketchPolicyNode : public SearchPolicyNode {
    */
   Array<State> SampleInitPopulation(const Array<State>& sketches);
 
+  /*!
+   * \brief Transfer the best measured states of similar tasks to this task.
+   *
+   * Tasks are similar if their compute DAGs have the same structure, e.g. repeated conv blocks
+   * with different channel counts. The transform steps of their states are replayed on this
+   * task, keeping the split factors that still divide the extents of this task and resampling
+   * the others.
+   * \param num_states The maximum number of states to transfer.
+   * \return The transferred states, with their bounds inferred.
+   */
+  Array<State> SampleSimilarTaskStates(int num_states);
+
   /*!
    * \brief Perform evolutionary search.
    * \param init_populations The states generated from init population.
@@ -163,6 +180,14 @@ class SketchPolicyNode : public SearchPolicyNode {
                                               const Array<State>& random_states,
                                               int remaining_n_trials);
 
+  /*!
+   * \brief Add the successfully measured states to the cache of states shared with similar
+   * tasks.
+   * \param inputs The measured inputs.
+   * \param results The measure results of the inputs.
+   */
+  void ShareMeasuredStates(const Array<MeasureInput>& inputs, const Array<MeasureResult>& results);
+
   /*! \brief The number of states to measure per iteration. */
   int num_measure_per_iter_;
 
@@ -25,9 +25,18 @@
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
 #include <tvm/node/repr_printer.h>
+#include <tvm/runtime/memory.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <sstream>
 #include <stack>
+#include <thread>
+#include <unordered_map>
+
+#include "../support/str_escape.h"
 
 namespace tvm {
 namespace instrument {
@@ -334,5 +343,190 @@ TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
                             run_before_pass, run_after_pass);
 });
 
+/*!
+ * \brief Pass instrument that records the time and the object allocations of each pass, and of
+ *  each function a function-level pass runs over, as slices of a Chrome trace.
+ *
+ * \note The allocations of a slice are the ones of the thread that runs it, e.g. they exclude the
+ *  ones of the functions that a function-level pass runs over on other threads.
+ */
+class PassProfilingInstrumentNode : public PassInstrumentNode {
+ public:
+  /*! \brief A completed slice */
+  struct Slice {
+    /*! \brief The name of the pass */
+    String pass_name;
+    /*! \brief The name of the function, empty for a pass over a module */
+    String function_name;
+    /*! \brief The time when the slice began, in microseconds since the epoch of steady_clock */
+    int64_t begin_us;
+    /*! \brief The duration in microseconds */
+    int64_t duration_us;
+    /*! \brief The number of objects allocated */
+    int64_t allocations;
+    /*! \brief The thread that ran the slice */
+    std::thread::id thread;
+  };
+
+  static int64_t NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void EnterPassContext() const final {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      slices_.clear();
+      open_slices_.clear();
+    }
+    ++runtime::ObjectAllocationCounter::num_active;
+    std::lock_guard<std::mutex> lock(ActiveMutex());
+    Active().push_back(GetRef<PassInstrument>(this));
+  }
+
+  void ExitPassContext() const final {
+    --runtime::ObjectAllocationCounter::num_active;
+    std::lock_guard<std::mutex> lock(ActiveMutex());
+    std::vector<PassInstrument>& active = Active();
+    active.erase(std::remove(active.begin(), active.end(), GetRef<PassInstrument>(this)),
+                 active.end());
+  }
+
+  bool ShouldRun(const IRModule&, const transform::PassInfo&) const final { return true; }
+
+  void RunBeforePass(const IRModule&, const transform::PassInfo& info) const final {
+    Slice slice{info->name, String(), NowMicros(), 0,
+                runtime::ObjectAllocationCounter::ThreadLocalCount(), std::this_thread::get_id()};
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_slices_[slice.thread].push_back(std::move(slice));
+  }
+
+  void RunAfterPass(const IRModule&, const transform::PassInfo& info) const final {
+    int64_t now_us = NowMicros();
+    int64_t allocations = runtime::ObjectAllocationCounter::ThreadLocalCount();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Slice>& open = open_slices_[std::this_thread::get_id()];
+    ICHECK(!open.empty() && open.back().pass_name == info->name)
+        << "mismatched enter/exit for pass profiling";
+    Slice slice = std::move(open.back());
+    open.pop_back();
+    slice.duration_us = now_us - slice.begin_us;
+    slice.allocations = allocations - slice.allocations;
+    slices_.push_back(std::move(slice));
+  }
+
+  /*! \brief Record a slice of a function-level pass over one function */
+  void AddSlice(Slice slice) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slices_.push_back(std::move(slice));
+  }
+
+  /*! \return The slices recorded, as the JSON of a Chrome trace */
+  String ChromeTrace() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::thread::id, int> thread_ids;
+    int64_t origin_us = slices_.empty() ? 0 : slices_.front().begin_us;
+    for (const Slice& slice : slices_) {
+      origin_us = std::min(origin_us, slice.begin_us);
+    }
+    std::ostringstream os;
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (size_t i = 0; i < slices_.size(); ++i) {
+      const Slice& slice = slices_[i];
+      int tid = thread_ids.emplace(slice.thread, thread_ids.size()).first->second;
+      bool is_function = !slice.function_name.empty();
+      std::string name = slice.pass_name;
+      if (is_function) {
+        name += ": " + std::string(slice.function_name);
+      }
+      os << (i == 0 ? "" : ",") << "\n  {\"name\": \"" << support::StrEscape(name)
+         << "\", \"cat\": \"" << (is_function ? "function" : "pass")
+         << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << tid
+         << ", \"ts\": " << slice.begin_us - origin_us << ", \"dur\": " << slice.duration_us
+         << ", \"args\": {\"pass\": \"" << support::StrEscape(slice.pass_name) << "\"";
+      if (is_function) {
+        os << ", \"function\": \"" << support::StrEscape(slice.function_name) << "\"";
+      }
+      os << ", \"allocations\": " << slice.allocations << "}}";
+    }
+    os << "\n]}\n";
+    return os.str();
+  }
+
+  /*! \return The profiling instruments of the pass contexts entered */
+  static std::vector<PassInstrument>& Active() {
+    static std::vector<PassInstrument> active;
+    return active;
+  }
+
+  /*! \return The mutex guarding `Active()` */
+  static std::mutex& ActiveMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static constexpr const char* _type_key = "instrument.PassProfilingInstrument";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PassProfilingInstrumentNode, PassInstrumentNode);
+
+ private:
+  /*! \brief The mutex guarding the slices */
+  mutable std::mutex mutex_;
+  /*! \brief The completed slices */
+  mutable std::vector<Slice> slices_;
+  /*! \brief The slices of the passes running on each thread */
+  mutable std::unordered_map<std::thread::id, std::vector<Slice>> open_slices_;
+};
+
+TVM_REGISTER_NODE_TYPE(PassProfilingInstrumentNode);
+
+FunctionPassProfileScope::FunctionPassProfileScope(const transform::PassInfo& info,
+                                                   const String& function_name) {
+  if (runtime::ObjectAllocationCounter::num_active.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(PassProfilingInstrumentNode::ActiveMutex());
+    profilers_ = PassProfilingInstrumentNode::Active();
+  }
+  if (profilers_.empty()) {
+    return;
+  }
+  pass_name_ = info->name;
+  function_name_ = function_name;
+  begin_us_ = PassProfilingInstrumentNode::NowMicros();
+  begin_allocations_ = runtime::ObjectAllocationCounter::ThreadLocalCount();
+}
+
+FunctionPassProfileScope::~FunctionPassProfileScope() {
+  if (profilers_.empty()) {
+    return;
+  }
+  PassProfilingInstrumentNode::Slice slice{
+      pass_name_,
+      function_name_,
+      begin_us_,
+      PassProfilingInstrumentNode::NowMicros() - begin_us_,
+      runtime::ObjectAllocationCounter::ThreadLocalCount() - begin_allocations_,
+      std::this_thread::get_id()};
+  for (const PassInstrument& profiler : profilers_) {
+    static_cast<const PassProfilingInstrumentNode*>(profiler.get())->AddSlice(slice);
+  }
+}
+
+TVM_REGISTER_GLOBAL("instrument.MakePassProfilingInstrument").set_body_typed([]() {
+  auto n = make_object<PassProfilingInstrumentNode>();
+  n->name = "PassProfilingInstrument";
+  return PassInstrument(n);
+});
+
+TVM_REGISTER_GLOBAL("instrument.PassProfilingInstrumentChromeTrace")
+    .set_body_typed([](PassInstrument instrument) {
+      const auto* node = instrument.as<PassProfilingInstrumentNode>();
+      CHECK(node != nullptr) << "TypeError: Expect a PassProfilingInstrument, but got "
+                             << instrument->GetTypeKey();
+      return node->ChromeTrace();
+    });
+
 }  // namespace instrument
 }  // namespace tvm
@@ -29,9 +29,13 @@
 #include <tvm/relax/tuning_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 
 #include <chrono>
+#include <exception>
 #include <iomanip>
+#include <memory>
 #include <stack>
 #include <unordered_set>
 
@@ -46,6 +50,8 @@ using tvm::runtime::TVMArgs;
 using tvm::runtime::TVMRetValue;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("testing.immutable_module", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("ir.function_pass_num_threads", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("ir.function_pass_sequential", Array<String>);
 
 struct PassContextThreadLocalEntry {
   /*! \brief The default pass context. */
@@ -76,6 +82,21 @@ void PassContext::ExitWithScope() {
   InstrumentExitPassContext();
 }
 
+PassContextWorkerScope::PassContextWorkerScope(PassContext pass_ctx)
+    : pass_ctx_(std::move(pass_ctx)) {
+  RelayPassContextThreadLocalStore::Get()->context_stack.push(pass_ctx_);
+}
+
+PassContextWorkerScope::~PassContextWorkerScope() {
+  PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
+  ICHECK(!entry->context_stack.empty());
+  ICHECK(entry->context_stack.top().same_as(pass_ctx_));
+  entry->context_stack.pop();
+}
+
+/*! \brief Whether the thread runs a function-level pass in parallel, to avoid nesting them */
+static thread_local bool in_parallel_function_pass = false;
+
 PassContext PassContext::Current() {
   PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
   if (!entry->context_stack.empty()) {
@@ -93,6 +114,44 @@ bool PassArrayContains(const Array<runtime::String>& pass_array, const std::stri
   return false;
 }
 
+int GetFunctionPassNumThreads(const PassContext& pass_ctx, const PassInfo& pass_info,
+                              int num_functions) {
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("ir.function_pass_num_threads", Integer(1)).value()->value;
+  if (num_threads == 0) {
+    num_threads = runtime::threading::MaxConcurrency();
+  }
+  if (in_parallel_function_pass ||
+      PassArrayContains(pass_ctx->GetConfig<Array<String>>("ir.function_pass_sequential", {})
+                            .value_or(Array<String>()),
+                        pass_info->name)) {
+    return 1;
+  }
+  return std::max(1, std::min(num_threads, num_functions));
+}
+
+void ParallelForFunctions(const PassContext& pass_ctx, int num_threads, int num_functions,
+                          const std::function<void(int)>& f) {
+  std::vector<std::exception_ptr> errors(num_functions);
+  support::parallel_for_dynamic(0, num_functions, num_threads, [&](int thread_id, int i) {
+    std::unique_ptr<PassContextWorkerScope> scope =
+        thread_id == 0 ? nullptr : std::make_unique<PassContextWorkerScope>(pass_ctx);
+    bool nested = in_parallel_function_pass;
+    in_parallel_function_pass = true;
+    try {
+      f(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+    in_parallel_function_pass = nested;
+  });
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 bool PassContext::PassEnabled(const PassInfo& info) const {
   if (PassArrayContains(operator->()->disabled_pass, info->name)) {
     return false;
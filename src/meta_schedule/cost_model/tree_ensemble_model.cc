@@ -0,0 +1,524 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/meta_schedule/cost_model/tree_ensemble_model.cc
+ * \brief A cost model of gradient boosted regression trees, trained and evaluated in C++.
+ *
+ * It follows XGBModel: a candidate has one feature vector per store, its predicted score is the
+ * sum of the scores of its stores, and the trees are fit to the normalized throughput
+ * `min_cost / cost` of the candidates of each workload with the weighted square error of
+ * XGBModel's pack-sum objective. The trees are grown depth-wise on histograms of the features,
+ * quantized to at most `kMaxNumBins` bins.
+ */
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The magic number at the beginning of a saved model, "TVMMSTE1". */
+constexpr uint64_t kTreeEnsembleMagic = 0x31455453534d5654;
+
+/*! \brief A node of a regression tree, which is a leaf if `feature` is -1. */
+struct TreeEnsembleNode {
+  /*! \brief The feature to split on. */
+  int32_t feature = -1;
+  /*! \brief The rows with the feature at most the threshold go to the left child. */
+  float threshold = 0.0f;
+  /*! \brief The index of the left child in the tree. */
+  int32_t left = -1;
+  /*! \brief The index of the right child in the tree. */
+  int32_t right = -1;
+  /*! \brief The score of a leaf. */
+  float value = 0.0f;
+};
+
+/*! \brief The measured candidates of a workload. */
+struct TreeEnsembleGroup {
+  /*! \brief The structural hash of the workload. */
+  uint64_t shash = 0;
+  /*! \brief The features of each candidate, a row-major matrix of one row per store. */
+  std::vector<std::vector<float>> features;
+  /*! \brief The cost of each candidate. */
+  std::vector<double> costs;
+  /*! \brief The minimum cost of the candidates. */
+  double min_cost = std::numeric_limits<double>::max();
+};
+
+/*! \brief The training rows, with the features quantized to bins. */
+struct TreeEnsembleDataset {
+  /*! \brief The number of rows. */
+  int num_rows = 0;
+  /*! \brief The candidate of each row. */
+  std::vector<int32_t> row2sample;
+  /*! \brief The label, i.e. normalized throughput, of each candidate. */
+  std::vector<double> ys;
+  /*! \brief The upper bound of each bin of each feature. */
+  std::vector<std::vector<float>> cuts;
+  /*! \brief The bin of each row of each feature, and feature-major. */
+  std::vector<uint8_t> bins;
+};
+
+class TreeEnsembleModelNode : public CostModelNode {
+ public:
+  /*! \brief The maximum number of bins of a feature. */
+  static constexpr int kMaxNumBins = 64;
+  /*! \brief The L2 regularization of the leaf scores. */
+  static constexpr double kLambda = 1.0;
+  /*! \brief The number of row-features of a node, above which its split is searched in parallel */
+  static constexpr int64_t kMinParallelWork = 1 << 16;
+
+  /*! \brief The feature extractor. */
+  FeatureExtractor extractor{nullptr};
+  /*! \brief The number of samples before which the predictions are random. */
+  int num_warmup_samples;
+  /*! \brief The maximum depth of a tree. */
+  int max_depth;
+  /*! \brief The maximum number of trees. */
+  int num_rounds;
+  /*! \brief The learning rate. */
+  double eta;
+  /*! \brief The minimum loss reduction of a split. */
+  double gamma;
+  /*! \brief The minimum sum of the hessian of a child. */
+  double min_child_weight;
+  /*! \brief The number of rounds with no improvement after which the training stops. */
+  int early_stopping_rounds;
+  /*! \brief The random state of the warmup predictions. */
+  support::LinearCongruentialEngine::TRandState rand_state;
+
+  /*! \brief The number of features of a store, or 0 before the first update. */
+  int num_features_ = 0;
+  /*! \brief The trees. */
+  std::vector<std::vector<TreeEnsembleNode>> trees_;
+  /*! \brief The measured candidates of each workload. */
+  std::vector<TreeEnsembleGroup> groups_;
+  /*! \brief The number of measured candidates. */
+  int64_t data_size_ = 0;
+  /*! \brief The number of measured candidates when the model was last trained. */
+  int64_t last_train_size_ = 0;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("extractor", &extractor);
+    v->Visit("num_warmup_samples", &num_warmup_samples);
+    v->Visit("max_depth", &max_depth);
+    v->Visit("num_rounds", &num_rounds);
+    v->Visit("eta", &eta);
+    v->Visit("gamma", &gamma);
+    v->Visit("min_child_weight", &min_child_weight);
+    v->Visit("early_stopping_rounds", &early_stopping_rounds);
+    // `rand_state` is not visited
+    // `num_features_` is not visited
+    // `trees_` is not visited
+    // `groups_` is not visited
+    // `data_size_` is not visited
+    // `last_train_size_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.TreeEnsembleModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TreeEnsembleModelNode, CostModelNode);
+
+ public:
+  void Load(const String& path) final {
+    std::ifstream is(path, std::ios::binary);
+    CHECK(is.good()) << "ValueError: Cannot open the file to read: " << path;
+    uint64_t magic = 0;
+    Read(&is, &magic);
+    CHECK(is.good() && magic == kTreeEnsembleMagic)
+        << "ValueError: File is not a saved TreeEnsembleModel: " << path;
+    int32_t num_features = 0;
+    Read(&is, &num_features);
+    std::vector<std::vector<TreeEnsembleNode>> trees(ReadSize(&is));
+    for (std::vector<TreeEnsembleNode>& tree : trees) {
+      tree.resize(ReadSize(&is));
+      is.read(reinterpret_cast<char*>(tree.data()), tree.size() * sizeof(TreeEnsembleNode));
+    }
+    std::vector<TreeEnsembleGroup> groups(ReadSize(&is));
+    int64_t data_size = 0;
+    for (TreeEnsembleGroup& group : groups) {
+      Read(&is, &group.shash);
+      int64_t num_samples = ReadSize(&is);
+      group.features.resize(num_samples);
+      group.costs.resize(num_samples);
+      for (int64_t i = 0; i < num_samples; ++i) {
+        Read(&is, &group.costs[i]);
+        group.min_cost = std::min(group.min_cost, group.costs[i]);
+        group.features[i].resize(ReadSize(&is) * num_features);
+        is.read(reinterpret_cast<char*>(group.features[i].data()),
+                group.features[i].size() * sizeof(float));
+      }
+      data_size += num_samples;
+    }
+    CHECK(is.good()) << "ValueError: The saved TreeEnsembleModel is truncated: " << path;
+    num_features_ = num_features;
+    trees_ = std::move(trees);
+    groups_ = std::move(groups);
+    data_size_ = last_train_size_ = data_size;
+  }
+
+  void Save(const String& path) final {
+    std::ofstream os(path, std::ios::binary);
+    CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path;
+    Write(&os, kTreeEnsembleMagic);
+    Write(&os, static_cast<int32_t>(num_features_));
+    Write(&os, static_cast<int64_t>(trees_.size()));
+    for (const std::vector<TreeEnsembleNode>& tree : trees_) {
+      Write(&os, static_cast<int64_t>(tree.size()));
+      os.write(reinterpret_cast<const char*>(tree.data()), tree.size() * sizeof(TreeEnsembleNode));
+    }
+    Write(&os, static_cast<int64_t>(groups_.size()));
+    for (const TreeEnsembleGroup& group : groups_) {
+      Write(&os, group.shash);
+      Write(&os, static_cast<int64_t>(group.costs.size()));
+      for (size_t i = 0; i < group.costs.size(); ++i) {
+        Write(&os, group.costs[i]);
+        Write(&os, static_cast<int64_t>(group.features[i].size() / num_features_));
+        os.write(reinterpret_cast<const char*>(group.features[i].data()),
+                 group.features[i].size() * sizeof(float));
+      }
+    }
+    CHECK(os.good()) << "ValueError: Cannot write to the file: " << path;
+  }
+
+  void Update(const TuneContext& context, const Array<MeasureCandidate>& candidates,
+              const Array<RunnerResult>& results) final {
+    CHECK_EQ(candidates.size(), results.size());
+    if (candidates.empty()) {
+      return;
+    }
+    uint64_t shash = context->mod.defined() ? StructuralHash()(context->mod.value()) : 0;
+    auto it = std::find_if(groups_.begin(), groups_.end(), [shash](const TreeEnsembleGroup& group) {
+      return group.shash == shash;
+    });
+    TreeEnsembleGroup* group = it != groups_.end() ? &*it : &groups_.emplace_back();
+    group->shash = shash;
+    Array<runtime::NDArray> features = extractor->ExtractFrom(context, candidates);
+    for (int i = 0, n = candidates.size(); i < n; ++i) {
+      // Skip the candidates with no features
+      if (features[i]->shape[0] == 0) {
+        continue;
+      }
+      group->features.push_back(AsFloatMatrix(features[i]));
+      group->costs.push_back(MedianRunSecs(results[i]));
+      group->min_cost = std::min(group->min_cost, group->costs.back());
+      ++data_size_;
+    }
+    // Only retrain when the data has grown by a fifth, as XGBModel's adaptive training
+    if (data_size_ == last_train_size_ || data_size_ - last_train_size_ < last_train_size_ / 5) {
+      return;
+    }
+    last_train_size_ = data_size_;
+    Train(std::max(context->num_threads, 1));
+  }
+
+  std::vector<double> Predict(const TuneContext& context,
+                              const Array<MeasureCandidate>& candidates) final {
+    int n = candidates.size();
+    std::vector<double> result(n, 0.0);
+    if (data_size_ < num_warmup_samples || trees_.empty()) {
+      support::LinearCongruentialEngine rng(&rand_state);
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      for (double& score : result) {
+        score = dist(rng);
+      }
+      return result;
+    }
+    Array<runtime::NDArray> features = extractor->ExtractFrom(context, candidates);
+    support::parallel_for_dynamic(0, n, std::max(context->num_threads, 1), [&](int, int i) {
+      std::vector<float> matrix = AsFloatMatrix(features[i]);
+      for (size_t row = 0; row < matrix.size(); row += num_features_) {
+        result[i] += PredictRow(&matrix[row]);
+      }
+    });
+    return result;
+  }
+
+ private:
+  /*! \brief Convert the features of a candidate to a row-major float matrix. */
+  std::vector<float> AsFloatMatrix(const runtime::NDArray& features) {
+    CHECK_EQ(features->ndim, 2);
+    CHECK(features.DataType() == DataType::Float(64))
+        << "ValueError: TreeEnsembleModel expects float64 features, but got "
+        << features.DataType();
+    int num_features = features->shape[1];
+    if (num_features_ == 0) {
+      num_features_ = num_features;
+    }
+    CHECK_EQ(num_features, num_features_)
+        << "ValueError: The feature extractor gives " << num_features
+        << " features, but the model has " << num_features_;
+    const double* data = static_cast<const double*>(features->data);
+    return std::vector<float>(data, data + features->shape[0] * num_features);
+  }
+
+  /*! \brief The median of the run time, or a large cost if the run failed, as XGBModel. */
+  static double MedianRunSecs(const RunnerResult& result) {
+    if (!result->run_secs.defined() || result->run_secs.value().empty()) {
+      return 1e10;
+    }
+    std::vector<double> run_secs;
+    for (const FloatImm& run_sec : result->run_secs.value()) {
+      run_secs.push_back(run_sec->value);
+    }
+    std::sort(run_secs.begin(), run_secs.end());
+    int n = run_secs.size();
+    return n % 2 == 1 ? run_secs[n / 2] : 0.5 * (run_secs[n / 2 - 1] + run_secs[n / 2]);
+  }
+
+  /*! \brief The score of one store, summed over the trees. */
+  double PredictRow(const float* row) const {
+    double score = 0.0;
+    for (const std::vector<TreeEnsembleNode>& tree : trees_) {
+      int node = 0;
+      while (tree[node].feature != -1) {
+        node = row[tree[node].feature] <= tree[node].threshold ? tree[node].left : tree[node].right;
+      }
+      score += tree[node].value;
+    }
+    return score;
+  }
+
+  /*! \brief Gather the rows of all the workloads and quantize their features. */
+  TreeEnsembleDataset MakeDataset(int num_threads) const {
+    TreeEnsembleDataset data;
+    std::vector<const float*> rows;
+    for (const TreeEnsembleGroup& group : groups_) {
+      for (size_t i = 0; i < group.costs.size(); ++i) {
+        int sample = data.ys.size();
+        data.ys.push_back(group.min_cost / group.costs[i]);
+        for (size_t row = 0; row < group.features[i].size(); row += num_features_) {
+          rows.push_back(&group.features[i][row]);
+          data.row2sample.push_back(sample);
+        }
+      }
+    }
+    int n = data.num_rows = rows.size();
+    data.cuts.resize(num_features_);
+    data.bins.resize(static_cast<size_t>(num_features_) * n);
+    support::parallel_for_dynamic(0, num_features_, num_threads, [&](int, int f) {
+      std::vector<float> values(n);
+      for (int r = 0; r < n; ++r) {
+        values[r] = rows[r][f];
+      }
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+      // The cuts are quantiles of the distinct values, and the last is the maximum value.
+      std::vector<float>& cuts = data.cuts[f];
+      int num_values = values.size();
+      int num_bins = std::min(num_values, kMaxNumBins);
+      for (int b = 0; b < num_bins; ++b) {
+        cuts.push_back(values[static_cast<int64_t>(b + 1) * num_values / num_bins - 1]);
+      }
+      uint8_t* bins = &data.bins[static_cast<size_t>(f) * n];
+      for (int r = 0; r < n; ++r) {
+        bins[r] = std::lower_bound(cuts.begin(), cuts.end(), rows[r][f]) - cuts.begin();
+      }
+    });
+    return data;
+  }
+
+  /*! \brief Refit the trees to all the measured candidates. */
+  void Train(int num_threads) {
+    TreeEnsembleDataset data = MakeDataset(num_threads);
+    int n_samples = data.ys.size();
+    std::vector<double> sample_pred(n_samples, 0.0);
+    std::vector<double> grad(data.num_rows), hess(data.num_rows);
+    double best_rmse = std::numeric_limits<double>::max();
+    int best_round = -1;
+    trees_.clear();
+    for (int round = 0; round < num_rounds; ++round) {
+      // The weighted square error of the sum of the scores of the stores of each candidate
+      for (int r = 0; r < data.num_rows; ++r) {
+        int s = data.row2sample[r];
+        grad[r] = (sample_pred[s] - data.ys[s]) * data.ys[s];
+        hess[r] = data.ys[s];
+      }
+      trees_.push_back(BuildTree(data, grad, hess, &sample_pred, num_threads));
+      double sse = 0.0;
+      for (int s = 0; s < n_samples; ++s) {
+        sse += (sample_pred[s] - data.ys[s]) * (sample_pred[s] - data.ys[s]);
+      }
+      double rmse = std::sqrt(sse / n_samples);
+      if (rmse < best_rmse * (1.0 - 1e-4)) {
+        best_rmse = rmse;
+        best_round = round;
+      } else if (round - best_round >= early_stopping_rounds || trees_.back().size() == 1) {
+        break;
+      }
+    }
+    trees_.resize(best_round + 1);
+  }
+
+  /*! \brief The best split of a node. */
+  struct Split {
+    int feature = -1;
+    int bin = -1;
+    double gain = 0.0;
+    double g_left = 0.0;
+    double h_left = 0.0;
+  };
+
+  /*! \brief Find the best split of the rows `row_ids[begin, end)` of a node. */
+  Split FindSplit(const TreeEnsembleDataset& data, const std::vector<double>& grad,
+                  const std::vector<double>& hess, const std::vector<int32_t>& row_ids, int begin,
+                  int end, double g, double h, int num_threads) const {
+    std::vector<Split> splits(num_features_);
+    auto f_find = [&](int, int f) {
+      int num_bins = data.cuts[f].size();
+      if (num_bins < 2) {
+        return;
+      }
+      std::vector<double> g_hist(num_bins, 0.0), h_hist(num_bins, 0.0);
+      const uint8_t* bins = &data.bins[static_cast<size_t>(f) * data.num_rows];
+      for (int i = begin; i < end; ++i) {
+        int r = row_ids[i];
+        g_hist[bins[r]] += grad[r];
+        h_hist[bins[r]] += hess[r];
+      }
+      double g_left = 0.0, h_left = 0.0;
+      for (int b = 0; b + 1 < num_bins; ++b) {
+        g_left += g_hist[b];
+        h_left += h_hist[b];
+        double g_right = g - g_left, h_right = h - h_left;
+        if (h_left <= 0.0 || h_right <= 0.0 || h_left < min_child_weight ||
+            h_right < min_child_weight) {
+          continue;
+        }
+        double gain = 0.5 * (g_left * g_left / (h_left + kLambda) +
+                             g_right * g_right / (h_right + kLambda) - g * g / (h + kLambda)) -
+                      gamma;
+        if (gain > splits[f].gain) {
+          splits[f] = Split{f, b, gain, g_left, h_left};
+        }
+      }
+    };
+    if (static_cast<int64_t>(end - begin) * num_features_ >= kMinParallelWork) {
+      support::parallel_for_dynamic(0, num_features_, num_threads, f_find);
+    } else {
+      for (int f = 0; f < num_features_; ++f) {
+        f_find(0, f);
+      }
+    }
+    Split best;
+    for (const Split& split : splits) {
+      if (split.gain > best.gain) {
+        best = split;
+      }
+    }
+    return best;
+  }
+
+  /*! \brief Grow a tree on the gradients, and add its scores to the predictions. */
+  std::vector<TreeEnsembleNode> BuildTree(const TreeEnsembleDataset& data,
+                                          const std::vector<double>& grad,
+                                          const std::vector<double>& hess,
+                                          std::vector<double>* sample_pred, int num_threads) const {
+    struct Task {
+      int node, begin, end, depth;
+      double g, h;
+    };
+    std::vector<TreeEnsembleNode> tree(1);
+    std::vector<int32_t> row_ids(data.num_rows);
+    std::iota(row_ids.begin(), row_ids.end(), 0);
+    std::vector<Task> stack{{0, 0, data.num_rows, 0,
+                             std::accumulate(grad.begin(), grad.end(), 0.0),
+                             std::accumulate(hess.begin(), hess.end(), 0.0)}};
+    while (!stack.empty()) {
+      Task task = stack.back();
+      stack.pop_back();
+      Split split;
+      if (task.depth < max_depth && task.end - task.begin >= 2) {
+        split = FindSplit(data, grad, hess, row_ids, task.begin, task.end, task.g, task.h,
+                          num_threads);
+      }
+      if (split.feature == -1) {
+        float value = -task.g / (task.h + kLambda) * eta;
+        tree[task.node].value = value;
+        for (int i = task.begin; i < task.end; ++i) {
+          (*sample_pred)[data.row2sample[row_ids[i]]] += value;
+        }
+        continue;
+      }
+      const uint8_t* bins = &data.bins[static_cast<size_t>(split.feature) * data.num_rows];
+      int mid = std::stable_partition(row_ids.begin() + task.begin, row_ids.begin() + task.end,
+                                      [&](int32_t r) { return bins[r] <= split.bin; }) -
+                row_ids.begin();
+      int left = tree.size();
+      tree.resize(left + 2);
+      tree[task.node].feature = split.feature;
+      tree[task.node].threshold = data.cuts[split.feature][split.bin];
+      tree[task.node].left = left;
+      tree[task.node].right = left + 1;
+      stack.push_back(Task{left + 1, mid, task.end, task.depth + 1, task.g - split.g_left,
+                           task.h - split.h_left});
+      stack.push_back(Task{left, task.begin, mid, task.depth + 1, split.g_left, split.h_left});
+    }
+    return tree;
+  }
+
+  template <typename T>
+  static void Read(std::istream* is, T* value) {
+    is->read(reinterpret_cast<char*>(value), sizeof(T));
+  }
+
+  static int64_t ReadSize(std::istream* is) {
+    int64_t size = 0;
+    Read(is, &size);
+    CHECK(is->good() && size >= 0) << "ValueError: The saved TreeEnsembleModel is corrupted";
+    return size;
+  }
+
+  template <typename T>
+  static void Write(std::ostream* os, const T& value) {
+    os->write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+};
+
+CostModel CostModel::TreeEnsemble(FeatureExtractor extractor, int num_warmup_samples,
+                                  int max_depth, int num_rounds, double eta, double gamma,
+                                  double min_child_weight, int early_stopping_rounds,
+                                  support::LinearCongruentialEngine::TRandState seed) {
+  CHECK_GE(max_depth, 0) << "ValueError: max_depth must be non-negative";
+  CHECK_GT(num_rounds, 0) << "ValueError: num_rounds must be positive";
+  ObjectPtr<TreeEnsembleModelNode> n = make_object<TreeEnsembleModelNode>();
+  n->extractor = extractor;
+  n->num_warmup_samples = num_warmup_samples;
+  n->max_depth = max_depth;
+  n->num_rounds = num_rounds;
+  n->eta = eta;
+  n->gamma = gamma;
+  n->min_child_weight = min_child_weight;
+  n->early_stopping_rounds = early_stopping_rounds;
+  n->rand_state = support::LinearCongruentialEngine::NormalizeSeed(seed);
+  return CostModel(n);
+}
+
+TVM_REGISTER_NODE_TYPE(TreeEnsembleModelNode);
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelTreeEnsemble").set_body_typed(CostModel::TreeEnsemble);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,441 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/meta_schedule/database/binary_database.cc
+ * \brief A database of two binary tables, which only loads an index when opened.
+ *
+ * Each table file starts with a magic number, followed by its entries. An entry is a fixed-size
+ * header and a body, the JSON string of the workload or of the tuning record as written by
+ * JSONDatabase. The header of a workload holds its structural hash, and the header of a tuning
+ * record holds the index of its workload, its validity and its mean run time. Opening the
+ * database only reads the headers, into
+ * - an index from the structural hash to the workloads, which are parsed on first use, and
+ * - the tuning records of each workload ordered by their mean run time,
+ * and the bodies of the tuning records are only parsed when they are returned.
+ *
+ * The headers are written in the byte order of the host.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+#include "../module_equality.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The magic number at the beginning of a binary table, "TVMMSDB1". */
+constexpr uint64_t kBinaryDatabaseMagic = 0x314244534d4d5654;
+
+/*! \brief The header of a workload entry. */
+struct BinaryWorkloadHeader {
+  /*! \brief The structural hash of the workload. */
+  uint64_t shash;
+  /*! \brief The number of bytes of the body. */
+  uint64_t size;
+};
+
+/*! \brief The header of a tuning record entry. */
+struct BinaryRecordHeader {
+  /*! \brief The index of the workload in the workload table. */
+  int32_t workload_index;
+  /*! \brief Whether the record is valid, see TuningRecordNode::IsValid. */
+  int32_t is_valid;
+  /*! \brief The mean run time of the record. */
+  double mean_run_secs;
+  /*! \brief The number of bytes of the body. */
+  uint64_t size;
+};
+
+/*!
+ * \brief Read the headers of a binary table.
+ * \param path The path to the table.
+ * \param allow_missing Whether to create a new table when the given path is not found.
+ * \param fvisit The callback on each header, and the offset of its body in the file.
+ * \return The size of the file.
+ */
+template <typename THeader>
+uint64_t BinaryTableReadHeaders(const String& path, bool allow_missing,
+                                const std::function<void(const THeader&, uint64_t)>& fvisit) {
+  std::ifstream is(path, std::ios::binary | std::ios::ate);
+  if (!is.good() || is.tellg() == 0) {
+    CHECK(is.good() || allow_missing) << "ValueError: File doesn't exist: " << path;
+    std::ofstream os(path, std::ios::binary);
+    CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
+    os.write(reinterpret_cast<const char*>(&kBinaryDatabaseMagic), sizeof(kBinaryDatabaseMagic));
+    return sizeof(kBinaryDatabaseMagic);
+  }
+  uint64_t file_size = is.tellg();
+  is.seekg(0);
+  uint64_t magic = 0;
+  is.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  CHECK(is.good() && magic == kBinaryDatabaseMagic)
+      << "ValueError: File is not a table of BinaryDatabase: " << path;
+  uint64_t offset = sizeof(magic);
+  while (offset < file_size) {
+    THeader header;
+    bool complete = offset + sizeof(header) <= file_size;
+    if (complete) {
+      is.read(reinterpret_cast<char*>(&header), sizeof(header));
+      complete = is.good() && offset + sizeof(header) + header.size <= file_size;
+    }
+    CHECK(complete) << "ValueError: The last entry of " << path << " is truncated, at offset "
+                    << offset
+                    << ". BinaryDatabase.compact repairs the table by keeping the complete entries";
+    offset += sizeof(header);
+    fvisit(header, offset);
+    offset += header.size;
+    is.seekg(offset);
+  }
+  return offset;
+}
+
+/*!
+ * \brief Read the body of an entry of a binary table.
+ * \param path The path to the table.
+ * \param offset The offset of the body in the file.
+ * \param size The number of bytes of the body.
+ */
+std::string BinaryTableReadBody(const String& path, uint64_t offset, uint64_t size) {
+  std::ifstream is(path, std::ios::binary);
+  CHECK(is.good()) << "ValueError: Cannot open the file to read: " << path;
+  std::string body(size, '\0');
+  is.seekg(offset);
+  is.read(body.data(), size);
+  CHECK(is.good()) << "ValueError: Cannot read " << size << " bytes at offset " << offset
+                   << " of " << path;
+  return body;
+}
+
+/*!
+ * \brief Append an entry to a binary table.
+ * \param os The stream of the table.
+ * \param header The header of the entry.
+ * \param body The body of the entry.
+ */
+template <typename THeader>
+void BinaryTableAppend(std::ostream* os, const THeader& header, const std::string& body) {
+  os->write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os->write(body.data(), body.size());
+}
+
+/*! \brief Append an entry to a binary table, as JSONFileAppendLine. */
+template <typename THeader>
+void BinaryTableAppend(const String& path, const THeader& header, const std::string& body) {
+  std::ofstream os(path, std::ios::binary | std::ios::app);
+  CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path;
+  BinaryTableAppend(&os, header, body);
+  os.flush();
+}
+
+/*! \brief A database of two binary tables, which indexes the tuning records by workload. */
+class BinaryDatabaseNode : public DatabaseNode {
+ public:
+  explicit BinaryDatabaseNode(String mod_eq_name = "structural") : DatabaseNode(mod_eq_name) {}
+
+  /*! \brief A workload in the table, which is parsed on first use. */
+  struct WorkloadEntry {
+    Workload::THashCode shash;
+    uint64_t offset;
+    uint64_t size;
+    Optional<Workload> workload;
+  };
+
+  /*! \brief A tuning record in the table, which is parsed when it is returned. */
+  struct RecordEntry {
+    uint64_t offset;
+    uint64_t size;
+    bool is_valid;
+  };
+
+  /*! \brief The path to the workload table */
+  String path_workload;
+  /*! \brief The path to the tuning record table */
+  String path_tuning_record;
+  /*! \brief The workloads in the order of the workload table */
+  std::vector<WorkloadEntry> workloads_;
+  /*! \brief The index from the structural hash to the workloads */
+  std::unordered_multimap<Workload::THashCode, int> shash2workloads_;
+  /*! \brief The tuning records of each workload ordered by mean run time */
+  std::vector<std::multimap<double, RecordEntry>> records_;
+  /*! \brief The number of tuning records */
+  int64_t num_records_ = 0;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path_workload", &path_workload);
+    v->Visit("path_tuning_record", &path_tuning_record);
+    // `workloads_` is not visited
+    // `shash2workloads_` is not visited
+    // `records_` is not visited
+    // `num_records_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.BinaryDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(BinaryDatabaseNode, DatabaseNode);
+
+ public:
+  bool HasWorkload(const IRModule& mod) {
+    return FindWorkload(GetModuleEquality().Hash(mod), mod) != -1;
+  }
+
+  Workload CommitWorkload(const IRModule& mod) {
+    Workload::THashCode shash = GetModuleEquality().Hash(mod);
+    int index = FindWorkload(shash, mod);
+    if (index != -1) {
+      return GetWorkload(index);
+    }
+    Workload workload(mod, shash);
+    std::string body = JSONDumps(workload->AsJSON());
+    BinaryTableAppend(path_workload, BinaryWorkloadHeader{workload->shash, body.size()}, body);
+    AddWorkload(workload->shash, workload_file_size_ + sizeof(BinaryWorkloadHeader), body.size());
+    workload_file_size_ += sizeof(BinaryWorkloadHeader) + body.size();
+    workloads_.back().workload = workload;
+    return workload;
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) {
+    int index = FindWorkload(record->workload->shash, record->workload->mod, record->workload);
+    CHECK_NE(index, -1) << "ValueError: The workload of the tuning record is not committed";
+    std::string body = JSONDumps(record->AsJSON());
+    BinaryRecordHeader header{
+        index, record->IsValid(),
+        SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({})), body.size()};
+    BinaryTableAppend(path_tuning_record, header, body);
+    AddRecord(header, record_file_size_ + sizeof(BinaryRecordHeader));
+    record_file_size_ += sizeof(BinaryRecordHeader) + body.size();
+  }
+
+  Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    int index = FindWorkload(workload->shash, workload->mod, workload);
+    if (top_k == 0 || index == -1) {
+      return {};
+    }
+    Array<TuningRecord> results;
+    results.reserve(top_k);
+    for (const auto& [mean_run_secs, entry] : records_[index]) {
+      if (!entry.is_valid) {
+        continue;
+      }
+      results.push_back(LoadRecord(entry, index));
+      if (results.size() == static_cast<size_t>(top_k)) {
+        break;
+      }
+    }
+    return results;
+  }
+
+  Array<TuningRecord> GetAllTuningRecords() {
+    // Order the records by mean run time, and then by their position in the table.
+    std::vector<std::tuple<double, uint64_t, const RecordEntry*, int>> entries;
+    entries.reserve(num_records_);
+    for (int index = 0; index < static_cast<int>(records_.size()); ++index) {
+      for (const auto& [mean_run_secs, entry] : records_[index]) {
+        entries.emplace_back(mean_run_secs, entry.offset, &entry, index);
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    Array<TuningRecord> results;
+    results.reserve(entries.size());
+    for (const auto& [mean_run_secs, offset, entry, index] : entries) {
+      results.push_back(LoadRecord(*entry, index));
+    }
+    return results;
+  }
+
+  int64_t Size() { return num_records_; }
+
+  /*! \brief Read the headers of the tables. */
+  void Load(bool allow_missing) {
+    workload_file_size_ = BinaryTableReadHeaders<BinaryWorkloadHeader>(
+        path_workload, allow_missing, [this](const BinaryWorkloadHeader& header, uint64_t offset) {
+          AddWorkload(header.shash, offset, header.size);
+        });
+    record_file_size_ = BinaryTableReadHeaders<BinaryRecordHeader>(
+        path_tuning_record, allow_missing,
+        [this](const BinaryRecordHeader& header, uint64_t offset) {
+          CHECK(0 <= header.workload_index &&
+                header.workload_index < static_cast<int>(workloads_.size()))
+              << "ValueError: The tuning record at offset " << offset << " of "
+              << path_tuning_record << " refers to the workload " << header.workload_index
+              << ", which is not in " << path_workload;
+          AddRecord(header, offset);
+        });
+  }
+
+ private:
+  void AddWorkload(Workload::THashCode shash, uint64_t offset, uint64_t size) {
+    shash2workloads_.emplace(shash, workloads_.size());
+    workloads_.push_back(WorkloadEntry{shash, offset, size, NullOpt});
+    records_.emplace_back();
+  }
+
+  void AddRecord(const BinaryRecordHeader& header, uint64_t offset) {
+    records_[header.workload_index].emplace(
+        header.mean_run_secs, RecordEntry{offset, header.size, header.is_valid != 0});
+    ++num_records_;
+  }
+
+  /*!
+   * \brief Find the index of the workload of the module.
+   * \param shash The hash of the module.
+   * \param mod The module.
+   * \param workload The workload of the module if known, which is compared first.
+   * \return The index, or -1 if the workload is not in the database.
+   */
+  int FindWorkload(Workload::THashCode shash, const IRModule& mod,
+                   const Optional<Workload>& workload = NullOpt) {
+    auto [begin, end] = shash2workloads_.equal_range(shash);
+    for (auto it = begin; it != end; ++it) {
+      if (workload.defined() && workloads_[it->second].workload.same_as(workload)) {
+        return it->second;
+      }
+    }
+    for (auto it = begin; it != end; ++it) {
+      if (GetModuleEquality().Equal(GetWorkload(it->second)->mod, mod)) {
+        return it->second;
+      }
+    }
+    return -1;
+  }
+
+  /*! \brief Get the workload of the index, parsing it on first use. */
+  Workload GetWorkload(int index) {
+    WorkloadEntry& entry = workloads_[index];
+    if (!entry.workload.defined()) {
+      Workload workload = Workload::FromJSON(
+          JSONLoads(BinaryTableReadBody(path_workload, entry.offset, entry.size)));
+      // Keep the hash of the module equality of the database, under which it is indexed.
+      entry.workload = Workload(workload->mod, entry.shash);
+    }
+    return entry.workload.value();
+  }
+
+  /*! \brief Parse a tuning record of the workload of the index. */
+  TuningRecord LoadRecord(const RecordEntry& entry, int index) {
+    return TuningRecord::FromJSON(
+        JSONLoads(BinaryTableReadBody(path_tuning_record, entry.offset, entry.size)),
+        GetWorkload(index));
+  }
+
+  /*! \brief The size of the workload table */
+  uint64_t workload_file_size_ = 0;
+  /*! \brief The size of the tuning record table */
+  uint64_t record_file_size_ = 0;
+};
+
+Database Database::BinaryDatabase(String path_workload, String path_tuning_record,
+                                  bool allow_missing, String mod_eq_name) {
+  ObjectPtr<BinaryDatabaseNode> n = make_object<BinaryDatabaseNode>(mod_eq_name);
+  n->path_workload = path_workload;
+  n->path_tuning_record = path_tuning_record;
+  n->Load(allow_missing);
+  return Database(n);
+}
+
+/*!
+ * \brief Compact the tuning record table of a binary database offline, keeping the `top_k`
+ * fastest valid records of each workload, which are the only ones GetTopK may return with
+ * up to `top_k`. The bodies are copied as they are, with no parsing. A table whose last entry
+ * is truncated, e.g. by an interrupted write, keeps its complete entries.
+ * \param path_tuning_record The path to the tuning record table.
+ * \param top_k The number of records to keep for each workload.
+ * \return The number of records dropped.
+ */
+int64_t BinaryDatabaseCompact(String path_tuning_record, int top_k) {
+  CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+  std::ifstream is(path_tuning_record, std::ios::binary | std::ios::ate);
+  CHECK(is.good()) << "ValueError: File doesn't exist: " << path_tuning_record;
+  uint64_t file_size = is.tellg();
+  is.seekg(0);
+  uint64_t magic = 0;
+  is.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  CHECK(is.good() && magic == kBinaryDatabaseMagic)
+      << "ValueError: File is not a table of BinaryDatabase: " << path_tuning_record;
+  // The complete entries, and the (mean run time, position) of each workload's valid entries.
+  std::vector<std::pair<BinaryRecordHeader, uint64_t>> entries;
+  std::unordered_map<int32_t, std::vector<std::pair<double, size_t>>> workload2entries;
+  for (uint64_t offset = sizeof(magic); offset < file_size;) {
+    BinaryRecordHeader header;
+    bool complete = offset + sizeof(header) <= file_size;
+    if (complete) {
+      is.read(reinterpret_cast<char*>(&header), sizeof(header));
+      complete = is.good() && offset + sizeof(header) + header.size <= file_size;
+    }
+    if (!complete) {
+      LOG(WARNING) << "Dropping the truncated last entry of " << path_tuning_record
+                   << " at offset " << offset;
+      break;
+    }
+    offset += sizeof(header);
+    if (header.is_valid) {
+      workload2entries[header.workload_index].emplace_back(header.mean_run_secs, entries.size());
+    }
+    entries.emplace_back(header, offset);
+    offset += header.size;
+    is.seekg(offset);
+  }
+  is.clear();
+  std::vector<bool> keep(entries.size(), false);
+  for (auto& [workload_index, valid_entries] : workload2entries) {
+    std::stable_sort(valid_entries.begin(), valid_entries.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t i = 0; i < valid_entries.size() && i < static_cast<size_t>(top_k); ++i) {
+      keep[valid_entries[i].second] = true;
+    }
+  }
+  // Write the kept entries in their original order, and then replace the table.
+  std::string tmp_path = std::string(path_tuning_record) + ".tmp";
+  {
+    std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+    CHECK(os.good()) << "ValueError: Cannot create new file: " << tmp_path;
+    os.write(reinterpret_cast<const char*>(&kBinaryDatabaseMagic), sizeof(kBinaryDatabaseMagic));
+    std::string body;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (!keep[i]) {
+        continue;
+      }
+      const auto& [header, offset] = entries[i];
+      body.resize(header.size);
+      is.seekg(offset);
+      is.read(body.data(), header.size);
+      CHECK(is.good()) << "ValueError: Cannot read " << header.size << " bytes at offset "
+                       << offset << " of " << path_tuning_record;
+      BinaryTableAppend(&os, header, body);
+    }
+    CHECK(os.good()) << "ValueError: Cannot write to " << tmp_path;
+  }
+  is.close();
+  CHECK_EQ(std::rename(tmp_path.c_str(), path_tuning_record.c_str()), 0)
+      << "ValueError: Cannot replace " << path_tuning_record << " with " << tmp_path;
+  return entries.size() - std::count(keep.begin(), keep.end(), true);
+}
+
+TVM_REGISTER_NODE_TYPE(BinaryDatabaseNode);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseBinaryDatabase")
+    .set_body_typed(Database::BinaryDatabase);
+TVM_REGISTER_GLOBAL("meta_schedule.BinaryDatabaseCompact").set_body_typed(BinaryDatabaseCompact);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -16,6 +16,12 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <tvm/tir/analysis.h>
+
+#include <cmath>
+#include <sstream>
+#include <unordered_map>
+
 #include "../module_equality.h"
 #include "../utils.h"
 
@@ -210,6 +216,87 @@ Optional<IRModule> DatabaseNode::QueryIRModule(const IRModule& mod, const Target
   }
 }
 
+/*!
+ * \brief The shape-free signature of the anchor block of a module, and its loop extents.
+ * \return Whether the module has an anchor block of constant loop extents.
+ */
+bool GetAnchorBlockShape(const IRModule& mod, std::string* signature,
+                         std::vector<int64_t>* extents) {
+  const tir::BlockNode* block = tir::FindAnchorBlock(mod);
+  if (block == nullptr) {
+    return false;
+  }
+  std::ostringstream os;
+  os << block->name_hint << ":";
+  for (const tir::IterVar& iter_var : block->iter_vars) {
+    const auto* extent = iter_var->dom->extent.as<IntImmNode>();
+    if (extent == nullptr || extent->value <= 0) {
+      return false;
+    }
+    os << static_cast<int>(iter_var->iter_type) << ",";
+    extents->push_back(extent->value);
+  }
+  for (const Array<tir::BufferRegion>& regions : {block->reads, block->writes}) {
+    os << ":";
+    for (const tir::BufferRegion& region : regions) {
+      os << region->buffer->dtype << "x" << region->region.size() << ",";
+    }
+  }
+  *signature = os.str();
+  return true;
+}
+
+Array<TuningRecord> DatabaseNode::GetTopKSimilar(const IRModule& mod, int top_k) {
+  CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+  std::string signature;
+  std::vector<int64_t> extents;
+  if (top_k == 0 || !GetAnchorBlockShape(mod, &signature, &extents)) {
+    return {};
+  }
+  // The distance of each workload, or a negative value if it is not similar
+  std::unordered_map<const WorkloadNode*, double> distances;
+  auto f_distance = [&](const Workload& workload) -> double {
+    auto it = distances.find(workload.get());
+    if (it != distances.end()) {
+      return it->second;
+    }
+    double distance = -1.0;
+    std::string other_signature;
+    std::vector<int64_t> other_extents;
+    if (GetAnchorBlockShape(workload->mod, &other_signature, &other_extents) &&
+        other_signature == signature && !GetModuleEquality().Equal(workload->mod, mod)) {
+      distance = 0.0;
+      for (size_t i = 0; i < extents.size(); ++i) {
+        distance += std::abs(std::log(static_cast<double>(extents[i]) / other_extents[i]));
+      }
+    }
+    return distances[workload.get()] = distance;
+  };
+  std::vector<std::pair<double, TuningRecord>> candidates;
+  for (const TuningRecord& record : this->GetAllTuningRecords()) {
+    if (!record->IsValid()) {
+      continue;
+    }
+    double distance = f_distance(record->workload);
+    if (distance >= 0.0) {
+      candidates.emplace_back(distance, record);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const std::pair<double, TuningRecord>& a,
+                      const std::pair<double, TuningRecord>& b) {
+                     if (a.first != b.first) {
+                       return a.first < b.first;
+                     }
+                     return SortTuningRecordByMeanRunSecs()(a.second, b.second);
+                   });
+  Array<TuningRecord> results;
+  for (int i = 0, n = std::min<int>(top_k, candidates.size()); i < n; ++i) {
+    results.push_back(candidates[i].second);
+  }
+  return results;
+}
+
 void DatabaseNode::DumpPruned(Database destination) {
   std::unordered_map<Workload, TuningRecord, ObjectPtrHash, ObjectPtrEqual> workload2record;
   for (const TuningRecord& record : this->GetAllTuningRecords()) {
@@ -311,6 +398,8 @@ TVM_REGISTER_GLOBAL("meta_schedule.DatabaseCommitTuningRecord")
     .set_body_method<Database>(&DatabaseNode::CommitTuningRecord);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseGetTopK")
     .set_body_method<Database>(&DatabaseNode::GetTopK);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseGetTopKSimilar")
+    .set_body_method<Database>(&DatabaseNode::GetTopKSimilar);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseGetAllTuningRecords")
     .set_body_method<Database>(&DatabaseNode::GetAllTuningRecords);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseSize").set_body_method<Database>(&DatabaseNode::Size);
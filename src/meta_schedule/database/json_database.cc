@@ -16,6 +16,13 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <mutex>
 #include <set>
 #include <thread>
 #include <unordered_map>
@@ -26,6 +33,92 @@
 namespace tvm {
 namespace meta_schedule {
 
+/*!
+ * \brief An advisory lock of a json file shared by processes, e.g. tuning jobs on one NFS
+ * directory. It is a POSIX record lock on the side file `<path>.lock`, so that closing the
+ * streams of the json file does not release it, and a mutex, since the record locks are owned
+ * by processes rather than threads. On Windows only the mutex is taken.
+ */
+class JSONFileLock {
+ public:
+  explicit JSONFileLock(const String& path) : guard_(Mutex()) {
+#ifndef _WIN32
+    std::string lock_path = std::string(path) + ".lock";
+    fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT, 0666);
+    CHECK_NE(fd_, -1) << "ValueError: Cannot open the lock file: " << lock_path;
+    struct flock lock = {};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    while (fcntl(fd_, F_SETLKW, &lock) == -1) {
+      CHECK_EQ(errno, EINTR) << "ValueError: Cannot lock the file: " << lock_path;
+    }
+#endif
+  }
+
+  ~JSONFileLock() {
+#ifndef _WIN32
+    // Closing the file releases the lock.
+    close(fd_);
+#endif
+  }
+
+ private:
+  static std::mutex& Mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  std::lock_guard<std::mutex> guard_;
+  int fd_ = -1;
+};
+
+/*!
+ * \brief Read the complete lines of a json file after an offset.
+ * \param path The path to the json file.
+ * \param offset The offset to start from, which is advanced past the lines read. A last line with
+ * no line break is being written by another process, and is left for the next read.
+ * \return The lines read, or nothing if the file does not exist.
+ */
+std::vector<String> JSONFileReadNewLines(const String& path, uint64_t* offset) {
+  std::ifstream is(path, std::ios::binary);
+  if (!is.good()) {
+    return {};
+  }
+  is.seekg(*offset);
+  std::vector<String> json_strs;
+  for (std::string str; std::getline(is, str) && !is.eof();) {
+    *offset += str.size() + 1;
+    json_strs.push_back(str);
+  }
+  return json_strs;
+}
+
+/*! \brief Parse the lines of a json file with `num_threads` threads. */
+std::vector<ObjectRef> JSONParseLines(const std::vector<String>& json_strs, int num_threads) {
+  int n = json_strs.size();
+  std::vector<ObjectRef> json_objs;
+  json_objs.resize(n);
+  support::parallel_for_dynamic(0, n, num_threads, [&](int thread_id, int task_id) {
+    json_objs[task_id] = JSONLoads(json_strs[task_id]);
+  });
+  return json_objs;
+}
+
+/*!
+ * \brief Create a json file if it does not exist.
+ * \param path The path to the json file.
+ * \param allow_missing Whether to create new file when the given path is not found.
+ */
+void JSONFileCreateIfMissing(const String& path, bool allow_missing) {
+  if (std::ifstream(path).good()) {
+    return;
+  }
+  CHECK(allow_missing) << "ValueError: File doesn't exist: " << path;
+  // Open in append mode, which does not truncate a file just created by another process.
+  std::ofstream os(path, std::ofstream::app);
+  CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
+}
+
 /*!
  * \brief Read lines from a json file.
  * \param path The path to the json file.
@@ -34,38 +127,45 @@ namespace meta_schedule {
  * \return An array containing lines read from the json file.
  */
 std::vector<ObjectRef> JSONFileReadLines(const String& path, int num_threads, bool allow_missing) {
-  std::ifstream is(path);
-  if (is.good()) {
-    std::vector<String> json_strs;
-    for (std::string str; std::getline(is, str);) {
-      json_strs.push_back(str);
-    }
-    int n = json_strs.size();
-    std::vector<ObjectRef> json_objs;
-    json_objs.resize(n);
-    support::parallel_for_dynamic(0, n, num_threads, [&](int thread_id, int task_id) {
-      json_objs[task_id] = JSONLoads(json_strs[task_id]);
-    });
-    return json_objs;
-  }
-  CHECK(allow_missing) << "ValueError: File doesn't exist: " << path;
-  std::ofstream os(path);
-  CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
-  return {};
+  JSONFileCreateIfMissing(path, allow_missing);
+  uint64_t offset = 0;
+  return JSONParseLines(JSONFileReadNewLines(path, &offset), num_threads);
 }
 
 /*!
- * \brief Append a line to a json file.
+ * \brief Append a line to a json file, whose lock is held by the caller.
  * \param path The path to the json file.
  * \param line The line to append.
+ * \return The number of bytes appended.
  */
-void JSONFileAppendLine(const String& path, const std::string& line) {
-  std::ofstream os(path, std::ofstream::app);
+uint64_t JSONFileAppendLineLocked(const String& path, const std::string& line) {
+  std::ofstream os(path, std::ofstream::app | std::ofstream::binary);
   CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path;
-  os << line << std::endl;
+  os << line << '\n';
+  os.flush();
+  CHECK(os.good()) << "ValueError: Cannot write to the file: " << path;
+  return line.size() + 1;
+}
+
+/*!
+ * \brief Append a line to a json file, with the file locked so that the lines appended by
+ * concurrent processes do not interleave.
+ * \param path The path to the json file.
+ * \param line The line to append.
+ */
+void JSONFileAppendLine(const String& path, const std::string& line) {
+  JSONFileLock lock(path);
+  JSONFileAppendLineLocked(path, line);
 }
 
-/*! \brief The default database implementation, which mimics two database tables with two files. */
+/*!
+ * \brief The default database implementation, which mimics two database tables with two files.
+ *
+ * The files may be shared by several processes. Appends are serialized by JSONFileLock, and the
+ * index of a new workload is its line in the workload file, which is read to its end with the
+ * lock held. Each database remembers how far it has read each file, and picks up the lines
+ * appended by other processes when it is queried.
+ */
 class JSONDatabaseNode : public DatabaseNode {
  public:
   explicit JSONDatabaseNode(String mod_eq_name = "structural")
@@ -80,12 +180,24 @@ class JSONDatabaseNode : public DatabaseNode {
   std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
   /*! \brief All the tuning records in the database */
   std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> tuning_records_;
+  /*! \brief The workloads in the order of the lines of the workload file */
+  std::vector<Workload> workloads_;
+  /*! \brief The offset in the workload file up to which it has been read */
+  uint64_t workload_offset_ = 0;
+  /*! \brief The offset in the tuning record file up to which it has been read */
+  uint64_t tuning_record_offset_ = 0;
+  /*! \brief The number of threads used to parse the files */
+  int num_threads_ = 1;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("path_workload", &path_workload);
     v->Visit("path_tuning_record", &path_tuning_record);
     // `workloads2idx_` is not visited
     // `tuning_records_` is not visited
+    // `workloads_` is not visited
+    // `workload_offset_` is not visited
+    // `tuning_record_offset_` is not visited
+    // `num_threads_` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.JSONDatabase";
@@ -93,30 +205,49 @@ class JSONDatabaseNode : public DatabaseNode {
 
  public:
   bool HasWorkload(const IRModule& mod) {
-    return workloads2idx_.find(Workload(mod, GetModuleEquality().Hash(mod))) !=
-           workloads2idx_.end();
+    Workload workload(mod, GetModuleEquality().Hash(mod));
+    if (workloads2idx_.count(workload)) {
+      return true;
+    }
+    RefreshWorkloads();
+    return workloads2idx_.count(workload);
   }
 
   Workload CommitWorkload(const IRModule& mod) {
-    // Try to insert `mod` into `workloads_`
-    auto [it, inserted] =
-        this->workloads2idx_.emplace(Workload(mod, GetModuleEquality().Hash(mod)), -1);
-    Workload workload = it->first;
-    // If `mod` is new in `workloads2idx_`, append it to the workload file
-    if (inserted) {
-      it->second = static_cast<int>(this->workloads2idx_.size()) - 1;
-      JSONFileAppendLine(this->path_workload, JSONDumps(workload->AsJSON()));
+    Workload workload(mod, GetModuleEquality().Hash(mod));
+    auto it = workloads2idx_.find(workload);
+    if (it != workloads2idx_.end()) {
+      return it->first;
+    }
+    // Another process may have committed `mod` since the last read, which is checked with the
+    // file locked, so that each workload is appended once and its index is its line.
+    JSONFileLock lock(path_workload);
+    RefreshWorkloads();
+    it = workloads2idx_.find(workload);
+    if (it != workloads2idx_.end()) {
+      return it->first;
     }
-    return it->first;
+    workload_offset_ += JSONFileAppendLineLocked(path_workload, JSONDumps(workload->AsJSON()));
+    workloads2idx_.emplace(workload, static_cast<int>(workloads_.size()));
+    workloads_.push_back(workload);
+    return workload;
   }
 
   void CommitTuningRecord(const TuningRecord& record) {
+    std::string line = JSONDumps(Array<ObjectRef>{
+        /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
+        /*tuning_record=*/record->AsJSON()  //
+    });
+    // Read the records appended by other processes before this one, so that the offset is past
+    // this one afterwards.
+    std::vector<String> new_lines;
+    {
+      JSONFileLock lock(path_tuning_record);
+      new_lines = JSONFileReadNewLines(path_tuning_record, &tuning_record_offset_);
+      tuning_record_offset_ += JSONFileAppendLineLocked(path_tuning_record, line);
+    }
+    AddTuningRecords(new_lines);
     this->tuning_records_.insert(record);
-    JSONFileAppendLine(this->path_tuning_record,
-                       JSONDumps(Array<ObjectRef>{
-                           /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
-                           /*tuning_record=*/record->AsJSON()  //
-                       }));
   }
 
   Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
@@ -124,6 +255,7 @@ class JSONDatabaseNode : public DatabaseNode {
     if (top_k == 0) {
       return {};
     }
+    RefreshTuningRecords();
     Array<TuningRecord> results;
     results.reserve(top_k);
     for (const TuningRecord& record : this->tuning_records_) {
@@ -143,6 +275,7 @@ class JSONDatabaseNode : public DatabaseNode {
   }
 
   Array<TuningRecord> GetAllTuningRecords() {
+    RefreshTuningRecords();
     Array<TuningRecord> results;
     results.reserve(Size());
     for (const TuningRecord& record : this->tuning_records_) {
@@ -151,23 +284,30 @@ class JSONDatabaseNode : public DatabaseNode {
     return results;
   }
 
-  int64_t Size() { return tuning_records_.size(); }
-};
+  int64_t Size() {
+    RefreshTuningRecords();
+    return tuning_records_.size();
+  }
 
-Database Database::JSONDatabase(String path_workload, String path_tuning_record, bool allow_missing,
-                                String mod_eq_name) {
-  int num_threads = std::thread::hardware_concurrency();
-  ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>(mod_eq_name);
-  // Load `n->workloads2idx_` from `path_workload`
-  std::vector<Workload> workloads;
-  {
-    std::vector<ObjectRef> json_objs = JSONFileReadLines(path_workload, num_threads, allow_missing);
+  /*! \brief Add the workloads appended to the workload file since it was last read. */
+  void RefreshWorkloads() {
+    AddWorkloads(JSONParseLines(JSONFileReadNewLines(path_workload, &workload_offset_),
+                                num_threads_));
+  }
+
+  /*! \brief Add the tuning records appended to the tuning record file since it was last read. */
+  void RefreshTuningRecords() {
+    AddTuningRecords(JSONFileReadNewLines(path_tuning_record, &tuning_record_offset_));
+  }
+
+  /*! \brief Add the workloads of the next lines of the workload file. */
+  void AddWorkloads(const std::vector<ObjectRef>& json_objs) {
     int n_objs = json_objs.size();
-    n->workloads2idx_.reserve(n_objs);
-    workloads.reserve(n_objs);
+    workloads2idx_.reserve(workloads_.size() + n_objs);
+    workloads_.reserve(workloads_.size() + n_objs);
     for (int i = 0; i < n_objs; ++i) {
       Workload workload = Workload::FromJSON(json_objs[i]);
-      auto recalc_hash = n->GetModuleEquality().Hash(workload->mod);
+      auto recalc_hash = GetModuleEquality().Hash(workload->mod);
       // Todo(tvm-team): re-enable the shash check when we get environment
       // independent structural hash values.
       if (recalc_hash != workload->shash) {
@@ -175,28 +315,38 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
         wkl->shash = recalc_hash;
         workload = Workload(wkl);
       }
-      n->workloads2idx_.emplace(workload, i);
-      workloads.push_back(workload);
+      workloads2idx_.emplace(workload, static_cast<int>(workloads_.size()));
+      workloads_.push_back(workload);
     }
   }
-  // Load `n->tuning_records_` from `path_tuning_record`
-  {
-    std::vector<ObjectRef> json_objs =
-        JSONFileReadLines(path_tuning_record, num_threads, allow_missing);
+
+  /*! \brief Add the tuning records of the next lines of the tuning record file. */
+  void AddTuningRecords(const std::vector<String>& json_strs) {
+    if (json_strs.empty()) {
+      return;
+    }
+    // The workloads of the records were appended before them.
+    RefreshWorkloads();
+    std::vector<ObjectRef> json_objs = JSONParseLines(json_strs, num_threads_);
+    int first_line = tuning_records_.size();
     std::vector<TuningRecord> records;
     records.resize(json_objs.size(), TuningRecord{nullptr});
     support::parallel_for_dynamic(
-        0, json_objs.size(), num_threads, [&](int thread_id, int task_id) {
+        0, json_objs.size(), num_threads_, [&](int thread_id, int task_id) {
           const ObjectRef& json_obj = json_objs[task_id];
           Workload workload{nullptr};
           try {
             const ArrayNode* arr = json_obj.as<ArrayNode>();
             ICHECK_EQ(arr->size(), 2);
-            workload = workloads[Downcast<Integer>(arr->at(0)).IntValue()];
+            int64_t workload_index = Downcast<Integer>(arr->at(0)).IntValue();
+            ICHECK(0 <= workload_index && workload_index < static_cast<int64_t>(workloads_.size()))
+                << "The workload index " << workload_index << " is out of range";
+            workload = workloads_[workload_index];
             records[task_id] = TuningRecord::FromJSON(arr->at(1), workload);
           } catch (std::runtime_error& e) {
-            LOG(FATAL) << "ValueError: Unable to parse TuningRecord, on line " << (task_id + 1)
-                       << " of file " << path_tuning_record << ". The workload is:\n"
+            LOG(FATAL) << "ValueError: Unable to parse TuningRecord, on line "
+                       << (first_line + task_id + 1) << " of file " << path_tuning_record
+                       << ". The workload is:\n"
                        << (workload.defined() ? workload->mod->Script() : "(null)")
                        << "\nThe JSONObject of TuningRecord is:\n"
                        << json_obj << "\nThe error message is:\n"
@@ -204,11 +354,23 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
           }
         });
     for (const TuningRecord& record : records) {
-      n->tuning_records_.insert(record);
+      tuning_records_.insert(record);
     }
   }
+};
+
+Database Database::JSONDatabase(String path_workload, String path_tuning_record, bool allow_missing,
+                                String mod_eq_name) {
+  ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>(mod_eq_name);
   n->path_workload = path_workload;
   n->path_tuning_record = path_tuning_record;
+  n->num_threads_ = std::max(1U, std::thread::hardware_concurrency());
+  JSONFileCreateIfMissing(path_workload, allow_missing);
+  JSONFileCreateIfMissing(path_tuning_record, allow_missing);
+  // Load `n->workloads2idx_` from `path_workload`
+  n->RefreshWorkloads();
+  // Load `n->tuning_records_` from `path_tuning_record`
+  n->RefreshTuningRecords();
   return Database(n);
 }
 
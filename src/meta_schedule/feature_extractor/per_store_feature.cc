@@ -20,6 +20,7 @@
 
 #include <cmath>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -1356,19 +1357,42 @@ class PerStoreFeatureCollector : private StmtVisitor {
 namespace tvm {
 namespace meta_schedule {
 
+/*!
+ * \brief The per-store feature extractor.
+ *
+ * The features of a candidate only depend on its module and the kind of target, so they are
+ * cached by the structural hash of the module. The evolutionary search scores the surviving
+ * candidates again in each of its iterations, and the cache spares their lowering.
+ */
 class PerStoreFeatureNode : public FeatureExtractorNode {
  public:
+  /*! \brief The features of a candidate in the cache. */
+  struct CachedFeatures {
+    IRModule mod;
+    bool is_gpu;
+    std::shared_ptr<const std::vector<std::vector<double>>> features;
+  };
+
+  /*! \brief The maximum number of candidates in the cache, past which it is cleared. */
+  static constexpr size_t kMaxNumCachedFeatures = 8192;
+
   int buffers_per_store;
   int arith_intensity_curve_num_samples;
   int cache_line_bytes;
   bool extract_workload;
   int feature_vector_length;
+  /*! \brief The cache from the structural hash of a candidate's module to its features. */
+  std::unordered_multimap<size_t, CachedFeatures> feature_cache_;
+  /*! \brief The mutex of `feature_cache_`, which the threads of ExtractFrom share. */
+  std::mutex feature_cache_mutex_;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("buffers_per_store", &buffers_per_store);
     v->Visit("arith_intensity_curve_num_samples", &arith_intensity_curve_num_samples);
     v->Visit("cache_line_bytes", &cache_line_bytes);
     v->Visit("feature_vector_length", &feature_vector_length);
+    // `feature_cache_` is not visited
+    // `feature_cache_mutex_` is not visited
   }
 
   void ExtractSingle(IRModule mod, bool is_gpu, std::vector<std::vector<double>>* results) {
@@ -1390,6 +1414,39 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     }
   }
 
+  /*!
+   * \brief Extract the features of a module, or look them up in the cache.
+   * \param mod The module of the candidate, which is not modified.
+   * \param is_gpu Whether the target is a GPU.
+   * \return The features of each store of the module.
+   */
+  std::shared_ptr<const std::vector<std::vector<double>>> ExtractCached(const IRModule& mod,
+                                                                         bool is_gpu) {
+    size_t shash = StructuralHash()(mod);
+    std::vector<CachedFeatures> hits;
+    {
+      std::lock_guard<std::mutex> lock(feature_cache_mutex_);
+      auto range = feature_cache_.equal_range(shash);
+      for (auto it = range.first; it != range.second; ++it) {
+        hits.push_back(it->second);
+      }
+    }
+    // Compare outside of the lock, as the other threads look up their candidates meanwhile.
+    for (const CachedFeatures& hit : hits) {
+      if (hit.is_gpu == is_gpu && StructuralEqual()(hit.mod, mod)) {
+        return hit.features;
+      }
+    }
+    auto features = std::make_shared<std::vector<std::vector<double>>>();
+    ExtractSingle(DeepCopyIRModule(mod), is_gpu, features.get());
+    std::lock_guard<std::mutex> lock(feature_cache_mutex_);
+    if (feature_cache_.size() >= kMaxNumCachedFeatures) {
+      feature_cache_.clear();
+    }
+    feature_cache_.emplace(shash, CachedFeatures{mod, is_gpu, features});
+    return features;
+  }
+
   Array<runtime::NDArray> ExtractFrom(const TuneContext& tune_context,
                                       const Array<MeasureCandidate>& candidates) {
     bool is_gpu = tune_context->target.value()->kind->name == "cuda";
@@ -1401,8 +1458,7 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     }
     auto f = [this, is_gpu, &feature_group6, &candidates, &results](int, int task_id) -> void {
       const auto& candidate = candidates[task_id];
-      std::vector<std::vector<double>> features;
-      ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu, &features);
+      std::vector<std::vector<double>> features = *ExtractCached(candidate->sch->mod(), is_gpu);
       if (extract_workload) {
         for (auto& feature : features) {
           feature_group6->Export(&feature);
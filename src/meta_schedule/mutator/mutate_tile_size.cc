@@ -54,13 +54,22 @@ int64_t Product(const std::vector<int64_t>& array) {
 /*! \brief A mutator that mutates the tile size */
 class MutateTileSizeNode : public MutatorNode {
  public:
+  /*! \brief The maximum number of threads per block of the target, or -1 if not a GPU. */
+  int64_t max_threads_per_block_ = -1;
+
   void VisitAttrs(tvm::AttrVisitor* v) {}
   static constexpr const char* _type_key = "meta_schedule.MutateTileSize";
   TVM_DECLARE_FINAL_OBJECT_INFO(MutateTileSizeNode, MutatorNode);
 
  public:
   // Inherit from `MutatorNode`
-  void InitializeWithTuneContext(const TuneContext& context) final {}
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    if (context->target.defined()) {
+      if (Optional<Integer> v = context->target.value()->GetAttr<Integer>("max_threads_per_block")) {
+        this->max_threads_per_block_ = v.value()->value;
+      }
+    }
+  }
   // Inherit from `MutatorNode`
   Optional<Trace> Apply(const Trace& trace, TRandState* rand_state) final;
   // Inherit from `MutatorNode`
@@ -230,6 +239,99 @@ Optional<Trace> MutateSampleTileSize(const Trace& trace, Instruction inst,
   }
 }
 
+/*!
+ * \brief Check the threads of each block of a trace against the bounds on them, without replaying
+ * the trace.
+ *
+ * The extent of a loop is known if it is split by sampled factors, or fused from such loops. The
+ * number of threads of a block is the product of the extents of its loops bound to threadIdx,
+ * which is bounded by the maximum of the target and the thread extent annotations of the block.
+ * \param trace The trace whose tile sizes are checked
+ * \param max_threads_per_block The maximum number of threads per block, or -1 if unbounded
+ * \return Whether the threads of all blocks whose threads are known are within the bounds
+ */
+bool CheckThreadExtents(const Trace& trace, int64_t max_threads_per_block) {
+  static const InstructionKind& inst_sample_perfect_tile =
+      InstructionKind::Get("SamplePerfectTile");
+  static const InstructionKind& inst_get_loops = InstructionKind::Get("GetLoops");
+  static const InstructionKind& inst_split = InstructionKind::Get("Split");
+  static const InstructionKind& inst_fuse = InstructionKind::Get("Fuse");
+  static const InstructionKind& inst_bind = InstructionKind::Get("Bind");
+  static const InstructionKind& inst_annotate = InstructionKind::Get("Annotate");
+  // The known values of the factors and the extents of the loops, -1 if unknown
+  std::unordered_map<const Object*, int64_t> values;
+  // The block of each loop
+  std::unordered_map<const Object*, const Object*> loop_blocks;
+  // The threads of each block, -1 if unknown
+  std::unordered_map<const Object*, int64_t> block_threads;
+  std::unordered_map<const Object*, std::pair<int64_t, int64_t>> block_bounds;
+  auto f_value = [&values](const ObjectRef& rv) -> int64_t {
+    auto it = values.find(rv.get());
+    return it != values.end() ? it->second : -1;
+  };
+  for (const Instruction& inst : trace->insts) {
+    if (inst->kind.same_as(inst_sample_perfect_tile)) {
+      std::vector<int64_t> tiles = DowncastTilingDecision(trace->decisions.at(inst));
+      for (size_t i = 0; i < inst->outputs.size(); ++i) {
+        values[inst->outputs[i].get()] = tiles[i];
+      }
+    } else if (inst->kind.same_as(inst_get_loops)) {
+      for (const ObjectRef& loop : inst->outputs) {
+        loop_blocks[loop.get()] = inst->inputs[0].get();
+      }
+    } else if (inst->kind.same_as(inst_split)) {
+      const Object* block = loop_blocks[inst->inputs[0].get()];
+      for (size_t i = 0; i < inst->outputs.size(); ++i) {
+        values[inst->outputs[i].get()] = f_value(inst->inputs[i + 1]);
+        loop_blocks[inst->outputs[i].get()] = block;
+      }
+    } else if (inst->kind.same_as(inst_fuse)) {
+      int64_t extent = 1;
+      for (const ObjectRef& loop : inst->inputs) {
+        int64_t value = f_value(loop);
+        extent = (extent == -1 || value == -1) ? -1 : extent * value;
+      }
+      values[inst->outputs[0].get()] = extent;
+      loop_blocks[inst->outputs[0].get()] = loop_blocks[inst->inputs[0].get()];
+    } else if (inst->kind.same_as(inst_bind)) {
+      if (support::StartsWith(Downcast<String>(inst->attrs[0]), "threadIdx")) {
+        const Object* block = loop_blocks[inst->inputs[0].get()];
+        int64_t extent = f_value(inst->inputs[0]);
+        auto [it, inserted] = block_threads.emplace(block, 1);
+        it->second = (it->second == -1 || extent == -1) ? -1 : it->second * extent;
+      }
+    } else if (inst->kind.same_as(inst_annotate)) {
+      String key = Downcast<String>(inst->attrs[0]);
+      if (key == tir::attr::meta_schedule_thread_extent_low_inclusive ||
+          key == tir::attr::meta_schedule_thread_extent_high_inclusive) {
+        auto [it, inserted] = block_bounds.emplace(inst->inputs[0].get(),
+                                                   std::make_pair(int64_t(1), int64_t(-1)));
+        int64_t bound = Downcast<Integer>(inst->inputs[1])->value;
+        if (key == tir::attr::meta_schedule_thread_extent_low_inclusive) {
+          it->second.first = bound;
+        } else {
+          it->second.second = bound;
+        }
+      }
+    }
+  }
+  for (const auto& [block, threads] : block_threads) {
+    if (block == nullptr || threads == -1) {
+      continue;
+    }
+    if (max_threads_per_block != -1 && threads > max_threads_per_block) {
+      return false;
+    }
+    if (auto it = block_bounds.find(block); it != block_bounds.end()) {
+      auto [low, high] = it->second;
+      if (threads < low || (high != -1 && threads > high)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 Optional<Trace> MutateSampleVectorize(const Trace& trace, Instruction inst,
                                       int64_t original_decision, TRandState* rand_state) {
   ICHECK_EQ(inst->attrs.size(), 2);
@@ -257,8 +359,14 @@ Optional<Trace> MutateTileSizeNode::Apply(const Trace& trace, TRandState* rand_s
   }
   int n = tir::SampleInt(rand_state, 0, size_a + size_b);
   if (n < size_a) {
-    return MutateSampleTileSize(trace, sample_perfect_tile_insts[n], sample_perfect_tile_tiles[n],
-                                rand_state);
+    Optional<Trace> new_trace = MutateSampleTileSize(trace, sample_perfect_tile_insts[n],
+                                                     sample_perfect_tile_tiles[n], rand_state);
+    // Prune the tile sizes whose threads are out of bounds before the trace is replayed.
+    if (new_trace.defined() &&
+        !CheckThreadExtents(new_trace.value(), this->max_threads_per_block_)) {
+      return NullOpt;
+    }
+    return new_trace;
   } else {
     n -= size_a;
     return MutateSampleVectorize(trace, sample_vectorize_insts[n], sample_vectorize_decisions[n],
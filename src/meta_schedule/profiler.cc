@@ -17,6 +17,10 @@
  * under the License.
  */
 #include <algorithm>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
 
 #include "./utils.h"
 
@@ -67,29 +71,213 @@ String ProfilerNode::Table() const {
   return p.AsStr();
 }
 
+double ProfilerNode::ElapsedUs() const {
+  auto now = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_time).count() / 1e3;
+}
+
+void ProfilerNode::RecordSpan(std::string track, std::string name, int task_id, double start_us,
+                              double end_us) {
+  std::lock_guard<std::mutex> lock(mutex);
+  spans.push_back(ProfilerSpan{std::move(track), std::move(name), task_id, start_us, end_us});
+}
+
+/*! \brief Escape a string for a JSON string literal. */
+std::string JSONEscape(const std::string& str) {
+  std::ostringstream os;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << ' ';
+    } else {
+      os << c;
+    }
+  }
+  return os.str();
+}
+
+/*! \brief The total length of the union of intervals. */
+double UnionLength(std::vector<std::pair<double, double>> intervals) {
+  std::sort(intervals.begin(), intervals.end());
+  double total = 0.0;
+  double covered = -1e300;
+  for (const auto& [start, end] : intervals) {
+    if (end > covered) {
+      total += end - std::max(start, covered);
+      covered = end;
+    }
+  }
+  return total;
+}
+
+String ProfilerNode::ChromeTrace() {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<const ProfilerSpan*> sorted;
+  for (const ProfilerSpan& span : spans) {
+    sorted.push_back(&span);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [](const ProfilerSpan* a, const ProfilerSpan* b) {
+    return a->start_us != b->start_us ? a->start_us < b->start_us : a->end_us > b->end_us;
+  });
+  // A span goes to the first lane of its track where it nests in or follows the open spans.
+  std::map<std::string, int> track_ids;
+  std::map<std::string, std::vector<std::vector<double>>> lanes;
+  std::set<std::pair<int, int>> used_lanes;
+  std::ostringstream os;
+  os << "{\"traceEvents\": [";
+  bool first = true;
+  for (const ProfilerSpan* span : sorted) {
+    int track_id = track_ids.emplace(span->track, track_ids.size()).first->second;
+    std::vector<std::vector<double>>& track_lanes = lanes[span->track];
+    int lane = 0;
+    for (;; ++lane) {
+      if (lane == static_cast<int>(track_lanes.size())) {
+        track_lanes.emplace_back();
+      }
+      std::vector<double>& open_ends = track_lanes[lane];
+      while (!open_ends.empty() && open_ends.back() <= span->start_us) {
+        open_ends.pop_back();
+      }
+      if (open_ends.empty() || span->end_us <= open_ends.back()) {
+        open_ends.push_back(span->end_us);
+        break;
+      }
+    }
+    used_lanes.emplace(track_id, lane);
+    os << (first ? "" : ",") << "\n  {\"name\": \"" << JSONEscape(span->name)
+       << "\", \"cat\": \"" << JSONEscape(span->track) << "\", \"ph\": \"X\", \"ts\": "
+       << std::fixed << std::setprecision(3) << span->start_us
+       << ", \"dur\": " << (span->end_us - span->start_us) << ", \"pid\": 0, \"tid\": "
+       << track_id * 1000 + lane << ", \"args\": {\"task\": " << span->task_id << "}}";
+    first = false;
+  }
+  for (const auto& [track, track_id] : track_ids) {
+    for (const auto& [used_track, lane] : used_lanes) {
+      if (used_track != track_id) continue;
+      std::string lane_name = lane == 0 ? track : track + " #" + std::to_string(lane);
+      os << (first ? "" : ",") << "\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+         << "\"tid\": " << track_id * 1000 + lane << ", \"args\": {\"name\": \""
+         << JSONEscape(lane_name) << "\"}}";
+      first = false;
+    }
+  }
+  os << "\n]}\n";
+  return os.str();
+}
+
+String ProfilerNode::Utilization() {
+  double total_us = stats_sec.count("Total") ? stats_sec.at("Total") * 1e6 : ElapsedUs();
+  CHECK_GT(total_us, 0) << "ValueError: The profiler has not run.";
+  std::lock_guard<std::mutex> lock(mutex);
+  // The tuning thread is idle while it waits for the builder and the runner.
+  std::vector<std::pair<double, double>> search_waits, builder_spans, runner_spans;
+  // The total time and the count of the spans of each task, by name.
+  std::map<int, std::map<std::string, std::pair<double, int>>> task_spans;
+  for (const ProfilerSpan& span : spans) {
+    bool is_wait = span.name == "SendToBuilder" || span.name == "JoinRunnerFutures";
+    if (span.track == "search" && is_wait) {
+      search_waits.emplace_back(span.start_us, span.end_us);
+    } else if (span.track == "builder") {
+      builder_spans.emplace_back(span.start_us, span.end_us);
+    } else if (span.track == "runner") {
+      runner_spans.emplace_back(span.start_us, span.end_us);
+    }
+    if (span.task_id >= 0) {
+      std::pair<double, int>& stat = task_spans[span.task_id][span.track + "/" + span.name];
+      stat.first += span.end_us - span.start_us;
+      stat.second += 1;
+    }
+  }
+  support::TablePrinter p;
+  p.Row() << "Worker"
+          << "Busy (min)"
+          << "Idle (min)"
+          << "Busy (%)";
+  p.Separator();
+  auto add_row = [&](const std::string& name, double busy_us) {
+    p.Row() << name << busy_us / 6e7 << (total_us - busy_us) / 6e7 << busy_us / total_us * 100.0;
+  };
+  add_row("Search thread", total_us - UnionLength(search_waits));
+  add_row("Builder", UnionLength(builder_spans));
+  add_row("Runner", UnionLength(runner_spans));
+  p.Separator();
+  std::ostringstream os;
+  os << p.AsStr() << "\n";
+  support::TablePrinter q;
+  q.Row() << "Task"
+          << "Span"
+          << "Time (s)"
+          << "Count";
+  q.Separator();
+  for (const auto& [task_id, stats] : task_spans) {
+    for (const auto& [name, stat] : stats) {
+      q.Row() << task_id << name << stat.first / 1e6 << stat.second;
+    }
+  }
+  q.Separator();
+  os << q.AsStr();
+  return os.str();
+}
+
 Profiler::Profiler() {
   ObjectPtr<ProfilerNode> n = make_object<ProfilerNode>();
   n->stats_sec.clear();
   n->total_timer = nullptr;
+  n->start_time = std::chrono::steady_clock::now();
   data_ = n;
 }
 
-PackedFunc ProfilerTimedScope(String name) {
+PackedFunc ProfilerTimedSpan(String track, String name, bool add_to_stats) {
   if (Optional<Profiler> opt_profiler = Profiler::Current()) {
-    return TypedPackedFunc<void()>([profiler = opt_profiler.value(),                  //
-                                    tik = std::chrono::high_resolution_clock::now(),  //
-                                    name = std::move(name)]() {
-      auto tok = std::chrono::high_resolution_clock::now();
-      double duration =
-          std::chrono::duration_cast<std::chrono::nanoseconds>(tok - tik).count() / 1e9;
-      profiler->stats_sec[name] += duration;
+    Profiler profiler = opt_profiler.value();
+    return TypedPackedFunc<void()>([profiler, task_id = profiler->current_task_id,
+                                    start_us = profiler->ElapsedUs(), track = std::move(track),
+                                    name = std::move(name), add_to_stats]() {
+      double end_us = profiler->ElapsedUs();
+      if (add_to_stats) {
+        profiler->stats_sec[name] += (end_us - start_us) / 1e6;
+      }
+      profiler->RecordSpan(track, name, task_id, start_us, end_us);
     });
   }
   return nullptr;
 }
 
+PackedFunc ProfilerTimedScope(String name) {
+  return ProfilerTimedSpan("search", std::move(name), /*add_to_stats=*/true);
+}
+
 ScopedTimer Profiler::TimedScope(String name) { return ScopedTimer(ProfilerTimedScope(name)); }
 
+ScopedTimer Profiler::TimedSpan(String track, String name) {
+  return ScopedTimer(ProfilerTimedSpan(track, name, /*add_to_stats=*/false));
+}
+
+void Profiler::SetCurrentTask(int task_id) {
+  if (Optional<Profiler> profiler = Profiler::Current()) {
+    profiler.value()->current_task_id = task_id;
+  }
+}
+
+void Profiler::BeginRunnerSpan() {
+  if (Optional<Profiler> opt_profiler = Profiler::Current()) {
+    ProfilerNode* profiler = opt_profiler.value().get();
+    profiler->runner_start_us[profiler->current_task_id] = profiler->ElapsedUs();
+  }
+}
+
+void Profiler::EndRunnerSpan(int task_id) {
+  if (Optional<Profiler> opt_profiler = Profiler::Current()) {
+    ProfilerNode* profiler = opt_profiler.value().get();
+    auto it = profiler->runner_start_us.find(task_id);
+    if (it != profiler->runner_start_us.end()) {
+      profiler->RecordSpan("runner", "Run", task_id, it->second, profiler->ElapsedUs());
+      profiler->runner_start_us.erase(it);
+    }
+  }
+}
+
 /**************** Context Manager ****************/
 
 std::vector<Profiler>* ThreadLocalProfilers() {
@@ -99,6 +287,8 @@ std::vector<Profiler>* ThreadLocalProfilers() {
 
 void Profiler::EnterWithScope() {
   ThreadLocalProfilers()->push_back(*this);
+  (*this)->start_time = std::chrono::steady_clock::now();
+  (*this)->spans.clear();
   (*this)->total_timer = ProfilerTimedScope("Total");
 }
 
@@ -131,6 +321,14 @@ TVM_REGISTER_GLOBAL("meta_schedule.ProfilerCurrent").set_body_typed(Profiler::Cu
 TVM_REGISTER_GLOBAL("meta_schedule.ProfilerGet").set_body_method<Profiler>(&ProfilerNode::Get);
 TVM_REGISTER_GLOBAL("meta_schedule.ProfilerTable").set_body_method<Profiler>(&ProfilerNode::Table);
 TVM_REGISTER_GLOBAL("meta_schedule.ProfilerTimedScope").set_body_typed(ProfilerTimedScope);
+TVM_REGISTER_GLOBAL("meta_schedule.ProfilerTimedSpan")
+    .set_body_typed([](String track, String name) {
+      return ProfilerTimedSpan(track, name, /*add_to_stats=*/false);
+    });
+TVM_REGISTER_GLOBAL("meta_schedule.ProfilerChromeTrace")
+    .set_body_method<Profiler>(&ProfilerNode::ChromeTrace);
+TVM_REGISTER_GLOBAL("meta_schedule.ProfilerUtilization")
+    .set_body_method<Profiler>(&ProfilerNode::Utilization);
 
 }  // namespace meta_schedule
 }  // namespace tvm
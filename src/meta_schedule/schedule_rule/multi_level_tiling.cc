@@ -290,6 +290,12 @@ std::vector<State> MultiLevelTilingNode::AddReadReuse(State state) const {
       sch->Fuse(Array<LoopRV>{buffer_loops.end() - buffer_ndim,  //
                               buffer_loops.end()});
       AnnotateCooperativeFetching(&sch, cache_read_block);
+      if (config.pad) {
+        // Tune whether to pad the cache, see tir::transform::InjectSharedMemoryPadding
+        ExprRV pad = sch->SampleCategorical(Array<Integer>{Integer(0), Integer(1)},
+                                            Array<FloatImm>(2, FloatImm(DataType::Float(64), 0.5)));
+        sch->Annotate(cache_read_block, tir::attr::pad_shared_memory, pad);
+      }
       new_state->read_reuse.emplace(i, cache_read_block);
     }
     results.push_back(std::move(new_state));
@@ -84,6 +84,8 @@ struct ReuseConfig {
   std::vector<int> levels;
   /*! \brief The storage scope */
   String scope;
+  /*! \brief Whether to tune the padding of the shared memory of the cache against bank conflicts */
+  bool pad = false;
 
   /*! \brief Default constructor: no data reuse */
   ReuseConfig() : req(ReuseType::kNoReuse) {}
@@ -93,7 +95,12 @@ struct ReuseConfig {
       : req(Str2ReuseType(Downcast<String>(config.at("req")))),
         levels(support::AsVector<Integer, int>(Downcast<Array<Integer>>(config.at("levels")))),
         scope(Downcast<String>(config.at("scope"))) {
-    ICHECK_EQ(config.size(), 3);
+    if (Optional<ObjectRef> pad = config.Get("pad")) {
+      this->pad = Downcast<Bool>(pad.value());
+      ICHECK_EQ(config.size(), 4);
+    } else {
+      ICHECK_EQ(config.size(), 3);
+    }
   }
 };
 
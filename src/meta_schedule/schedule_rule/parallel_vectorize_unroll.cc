@@ -31,6 +31,42 @@ bool CheckSpatialPrimFunc(const Schedule& sch, const BlockRV& root_block_rv) {
       GetRef<PrimFunc>(GetRootPrimFunc(sch->mod(), sch->Get(root_block_rv).get(), nullptr)));
 }
 
+/*!
+ * \brief Vectorize the innermost loop of a reduction block if it is a reduction loop, splitting
+ * it by the largest vector of at most `max_extent` lanes that divides its extent.
+ */
+void VectorizeInnermostReductionLoop(const Schedule& sch, const BlockRV& block_rv,
+                                     int max_extent) {
+  StmtSRef block_sref = sch->GetSRef(block_rv);
+  if (!IsVectorizableReductionBlock(GetRef<Block>(TVM_SREF_TO_BLOCK(block_sref)))) {
+    return;
+  }
+  Array<LoopRV> loops = sch->GetLoops(block_rv);
+  if (loops.empty()) {
+    return;
+  }
+  StmtSRef loop_sref = sch->GetSRef(loops.back());
+  const ForNode* loop = TVM_SREF_TO_FOR(loop_sref);
+  const int64_t* extent = GetLoopIntExtent(loop);
+  if (extent == nullptr || loop->kind != ForKind::kSerial ||
+      GetLoopIterType(loop_sref) != IterVarType::kCommReduce ||
+      !loop->body->IsInstance<BlockRealizeNode>()) {
+    return;
+  }
+  int64_t lanes = std::min<int64_t>(*extent, max_extent);
+  while (*extent % lanes != 0) {
+    --lanes;
+  }
+  if (lanes < 2) {
+    return;
+  }
+  LoopRV vectorized = loops.back();
+  if (lanes < *extent) {
+    vectorized = sch->Split(vectorized, {NullOpt, Integer(lanes)})[1];
+  }
+  sch->Vectorize(vectorized);
+}
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -50,8 +86,11 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
 
   // Inherited from ScheduleRuleNode
   Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& root_rv) {
-    // Currently only mark the root block with annotations.
+    // Currently only mark the root block with annotations, and vectorize the reductions.
     if (!tir::IsRootBlock(sch, root_rv)) {
+      if (vectorize_reduction && max_vectorize_extent != -1) {
+        tir::VectorizeInnermostReductionLoop(sch, root_rv, max_vectorize_extent);
+      }
       return {sch};
     }
 
@@ -105,6 +144,11 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
   Array<Integer> unroll_max_steps;
   /*! \brief Whether to explicitly unroll the loop, or just add an "unroll" pragma. */
   bool unroll_explicit;
+  /*!
+   * \brief Whether to vectorize the innermost loop of a reduction block when it is a reduction
+   * loop, which VectorizeLoop lowers to vector accumulators.
+   */
+  bool vectorize_reduction;
   /*! \brief The number of maximum available jobs in CPU. */
   int64_t max_parallel_extent_;
 
@@ -113,6 +157,7 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
     v->Visit("max_vectorize_extent", &max_vectorize_extent);
     v->Visit("unroll_max_steps", &unroll_max_steps);
     v->Visit("unroll_explicit", &unroll_explicit);
+    v->Visit("vectorize_reduction", &vectorize_reduction);
     // `max_parallel_extent_` is not visited
   }
 
@@ -123,12 +168,14 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
 ScheduleRule ScheduleRule::ParallelizeVectorizeUnroll(int max_jobs_per_core,
                                                       int max_vectorize_extent,
                                                       Array<Integer> unroll_max_steps,
-                                                      bool unroll_explicit) {
+                                                      bool unroll_explicit,
+                                                      bool vectorize_reduction) {
   ObjectPtr<ParallelizeVectorizeUnrollNode> n = make_object<ParallelizeVectorizeUnrollNode>();
   n->max_jobs_per_core = max_jobs_per_core;
   n->max_vectorize_extent = max_vectorize_extent;
   n->unroll_max_steps = unroll_max_steps;
   n->unroll_explicit = unroll_explicit;
+  n->vectorize_reduction = vectorize_reduction;
   n->max_parallel_extent_ = -1;
   return ScheduleRule(n);
 }
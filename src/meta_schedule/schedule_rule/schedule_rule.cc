@@ -85,10 +85,39 @@ Array<ScheduleRule> ScheduleRule::DefaultLLVM() {
   };
 }
 
+Array<ScheduleRule> GetX86AMXSpecificRules() {
+  return {
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/String("amx_16x16x64_u8i8i32"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/NullOpt,
+          /*max_innermost_factor=*/Integer(64),
+          /*vector_load_lens=*/NullOpt,
+          /*reuse_read=*/NullOpt,
+          /*reuse_write=*/
+          Map<String, ObjectRef>{{"req", String("may")},
+                                 {"levels", Array<Integer>{1, 2}},
+                                 {"scope", String("global")}}),
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/String("amx_16x16x32_bf16bf16f32"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/NullOpt,
+          /*max_innermost_factor=*/Integer(64),
+          /*vector_load_lens=*/NullOpt,
+          /*reuse_read=*/NullOpt,
+          /*reuse_write=*/
+          Map<String, ObjectRef>{{"req", String("may")},
+                                 {"levels", Array<Integer>{1, 2}},
+                                 {"scope", String("global")}}),
+  };
+}
+
 Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
+  // The int8 workloads whose weights are not packed for AMX fall back to VNNI.
   static const Map<String, String> intrins = {{"vnni", "dot_16x4_vnni"},
-                                              {"avx512", "dot_16x4_avx512"}};
-  return {
+                                              {"avx512", "dot_16x4_avx512"},
+                                              {"amx", "dot_16x4_vnni"}};
+  return Array<ScheduleRule>::Agregate(
       ScheduleRule::ApplyCustomRule(),
       ScheduleRule::InlineConstantScalars(),
       ScheduleRule::AutoInline(
@@ -102,6 +131,7 @@ Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
       ScheduleRule::AddRFactor(
           /*max_jobs_per_core=*/16,
           /*max_innermost_factor=*/Integer(64)),
+      "amx" == type ? GetX86AMXSpecificRules() : Array<ScheduleRule>{},
       ScheduleRule::MultiLevelTilingWithIntrin(
           /*intrin_name=*/intrins[type],
           /*structure=*/"SSRSRS",
@@ -128,8 +158,7 @@ Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
           /*max_vectorize_extent=*/64,
           /*unroll_max_steps=*/Array<Integer>{0, 16, 64, 512},
           /*unroll_explicit=*/true),
-      ScheduleRule::RandomComputeLocation(),
-  };
+      ScheduleRule::RandomComputeLocation());
 }
 
 Array<ScheduleRule> ScheduleRule::DefaultCUDA() {
@@ -381,6 +410,44 @@ Array<ScheduleRule> GetARMDotprodSpecificRules() {
   };
 }
 
+Array<ScheduleRule> GetARMI8mmSpecificRules() {
+  return {
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/String("mmla_2x2x8_i8i8s32_smmla"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/NullOpt,
+          /*max_innermost_factor=*/Integer(32),
+          /*vector_load_lens=*/NullOpt,
+          /*reuse_read=*/NullOpt,
+          /*reuse_write=*/
+          Map<String, ObjectRef>{{"req", String("may")},
+                                 {"levels", Array<Integer>{1, 2}},
+                                 {"scope", String("global")}}),
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/String("mmla_2x2x8_u8u8u32_ummla"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/NullOpt,
+          /*max_innermost_factor=*/Integer(32),
+          /*vector_load_lens=*/NullOpt,
+          /*reuse_read=*/NullOpt,
+          /*reuse_write=*/
+          Map<String, ObjectRef>{{"req", String("may")},
+                                 {"levels", Array<Integer>{1, 2}},
+                                 {"scope", String("global")}}),
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/String("mmla_2x2x8_u8i8s32_usmmla"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/NullOpt,
+          /*max_innermost_factor=*/Integer(32),
+          /*vector_load_lens=*/NullOpt,
+          /*reuse_read=*/NullOpt,
+          /*reuse_write=*/
+          Map<String, ObjectRef>{{"req", String("may")},
+                                 {"levels", Array<Integer>{1, 2}},
+                                 {"scope", String("global")}}),
+  };
+}
+
 Array<ScheduleRule> ScheduleRule::DefaultARM(const String& type) {
   return Array<ScheduleRule>::Agregate(
       ScheduleRule::ApplyCustomRule(), ScheduleRule::InlineConstantScalars(),
@@ -396,7 +463,8 @@ Array<ScheduleRule> ScheduleRule::DefaultARM(const String& type) {
           /*max_jobs_per_core=*/8,
           /*max_innermost_factor=*/Integer(32)),
       "neon" == type ? GetARMNeonSpecificRules() : Array<ScheduleRule>{},
-      "dotprod" == type ? GetARMDotprodSpecificRules() : Array<ScheduleRule>{},
+      "i8mm" == type ? GetARMI8mmSpecificRules() : Array<ScheduleRule>{},
+      ("dotprod" == type || "i8mm" == type) ? GetARMDotprodSpecificRules() : Array<ScheduleRule>{},
       ScheduleRule::MultiLevelTiling(
           /*structure=*/"SSRSRS",
           /*tile_binds=*/NullOpt,
@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class SoftwarePrefetchNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {}
+
+  // Inherited from ScheduleRuleNode
+  Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    // Find the innermost serial reduction loop of the block, whose iterations stream through the
+    // data that the reduction reads.
+    Optional<tir::LoopRV> prefetch_loop = NullOpt;
+    for (const tir::LoopRV& loop_rv : sch->GetLoops(block_rv)) {
+      tir::StmtSRef loop_sref = sch->GetSRef(loop_rv);
+      const tir::ForNode* loop = TVM_SREF_TO_FOR(loop_sref);
+      const int64_t* extent = tir::GetLoopIntExtent(loop);
+      if (loop->kind == tir::ForKind::kSerial && (extent == nullptr || *extent > 1) &&
+          tir::GetLoopIterType(loop_sref) == tir::IterVarType::kCommReduce) {
+        prefetch_loop = loop_rv;
+      }
+    }
+    if (!prefetch_loop.defined() || sch->Get(prefetch_loop.value())
+                                        ->annotations.count(tir::attr::software_prefetch_distance)) {
+      return {sch};
+    }
+    int n = prefetch_distances.size();
+    Array<FloatImm> probs(n, FloatImm(DataType::Float(64), 1.0 / n));
+    PrimExpr distance = sch->SampleCategorical(prefetch_distances, probs);
+    sch->Annotate(prefetch_loop.value(), tir::attr::software_prefetch_distance, distance);
+    return {sch};
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<SoftwarePrefetchNode> n = make_object<SoftwarePrefetchNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ public:
+  /*! \brief The candidates of the prefetch distance, in iterations, where 0 disables prefetch. */
+  Array<Integer> prefetch_distances;
+
+  void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("prefetch_distances", &prefetch_distances); }
+
+  static constexpr const char* _type_key = "meta_schedule.SoftwarePrefetch";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SoftwarePrefetchNode, ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::SoftwarePrefetch(Array<Integer> prefetch_distances) {
+  CHECK(!prefetch_distances.empty())
+      << "ValueError: SoftwarePrefetch expects at least one candidate of the prefetch distance";
+  for (const Integer& distance : prefetch_distances) {
+    CHECK_GE(distance->value, 0) << "ValueError: The prefetch distance should be non-negative, "
+                                 << "but got " << distance;
+  }
+  ObjectPtr<SoftwarePrefetchNode> n = make_object<SoftwarePrefetchNode>();
+  n->prefetch_distances = prefetch_distances;
+  return ScheduleRule(n);
+}
+
+TVM_REGISTER_NODE_TYPE(SoftwarePrefetchNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleSoftwarePrefetch")
+    .set_body_typed(ScheduleRule::SoftwarePrefetch);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -305,6 +305,13 @@ class EvolutionarySearchNode : public SearchStrategyNode {
      * \return The picked best candidates.
      */
     inline std::vector<Schedule> PickBestFromDatabase(int num);
+    /*!
+     * \brief Pick up the best candidates of similar workloads from database, replayed on the
+     *  workload of the search as its warm start.
+     * \param num The number of traces to produce.
+     * \return The picked candidates that can be replayed.
+     */
+    inline std::vector<Schedule> PickSimilarFromDatabase(int num);
     /*!
      * \brief Sample the initial population from previous measured results and randomly generated
      *  traces via trace replaying.
@@ -501,6 +508,53 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickBestFromDatabase(int nu
   return results;
 }
 
+std::vector<Schedule> EvolutionarySearchNode::State::PickSimilarFromDatabase(int num) {
+  auto _ = Profiler::TimedScope("EvoSearch/PickSimilarFromDatabase");
+  static const tir::InstructionKind& inst_sample_perfect_tile =
+      tir::InstructionKind::Get("SamplePerfectTile");
+  const Target& target = self->ctx_->target.value();
+  std::vector<tir::Trace> similar_traces;
+  for (const TuningRecord& record : database_->GetTopKSimilar(self->ctx_->mod.value(), num)) {
+    if (!record->target.defined() || record->target.value()->kind->name == target->kind->name) {
+      similar_traces.push_back(record->trace);
+    }
+  }
+  int actual_num = similar_traces.size();
+  ThreadedTraceApply pp(self->postprocs_);
+  std::vector<Schedule> results(actual_num, Schedule{nullptr});
+  auto f_proc_similar = [this, &similar_traces, &results, &pp](int thread_id,
+                                                               int trace_id) -> void {
+    PerThreadData& data = this->per_thread_data_.at(thread_id);
+    const tir::Trace& trace = similar_traces.at(trace_id);
+    // The tile sizes of another workload may not divide the loops of this one, in which case the
+    // trace is replayed again with the tile sizes resampled.
+    Map<tir::Instruction, ObjectRef> decisions;
+    for (const auto& kv : trace->decisions) {
+      if (!kv.first->kind.same_as(inst_sample_perfect_tile)) {
+        decisions.Set(kv.first, kv.second);
+      }
+    }
+    for (const tir::Trace& seed : {trace, tir::Trace(trace->insts, decisions)}) {
+      try {
+        if (Optional<Schedule> sch = pp.Apply(data.mod, seed, &data.rand_state)) {
+          results.at(trace_id) = sch.value();
+          return;
+        }
+      } catch (const std::runtime_error&) {
+        // The blocks or loops of the trace do not exist in this workload
+      }
+    }
+  };
+  support::parallel_for_dynamic(0, actual_num, self->ctx_->num_threads, f_proc_similar);
+  std::vector<Schedule> out_schs;
+  for (const Schedule& sch : results) {
+    if (sch.defined()) {
+      out_schs.push_back(sch);
+    }
+  }
+  return out_schs;
+}
+
 std::vector<Schedule> EvolutionarySearchNode::State::SampleInitPopulation(int num) {
   auto _ = Profiler::TimedScope("EvoSearch/SampleInitPopulation");
   ThreadedTraceApply pp(self->postprocs_);
@@ -578,9 +632,14 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
       ThreadedTraceApply pp(self->postprocs_);
       ConcurrentBitmask cbmask(self->population_size);
       std::vector<Schedule> next_population(self->population_size, Schedule{nullptr});
+      // The number of traces each mutator rejects before they are replayed
+      std::unordered_map<const Object*, std::atomic<int>> mutator_fail_counts;
+      for (const auto& kv : self->mutator_probs_) {
+        mutator_fail_counts[kv.first.get()] = 0;
+      }
       // The worker function
-      auto f_find_candidate = [&cbmask, &population, &next_population, &pp, this](int thread_id,
-                                                                                  int trace_id) {
+      auto f_find_candidate = [&cbmask, &population, &next_population, &pp, &mutator_fail_counts,
+                               this](int thread_id, int trace_id) {
         // Prepare samplers
         PerThreadData& data = this->per_thread_data_.at(thread_id);
         TRandState* rand_state = &data.rand_state;
@@ -603,6 +662,8 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
                 result = sch.value();
                 break;
               }
+            } else {
+              ++mutator_fail_counts.at(mutator.get());
             }
           } else if (cbmask.QueryAndMark(sampled_trace_id)) {
             // Decision: do not mutate
@@ -618,8 +679,13 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
                                     f_find_candidate);
 
       population.swap(next_population);
+      std::ostringstream os;
+      for (const auto& kv : self->mutator_probs_) {
+        os << "\nMutator [" << kv.first << "]: " << mutator_fail_counts.at(kv.first.get()).load()
+           << " rejection(s)";
+      }
       TVM_PY_LOG(INFO, self->ctx_->logger) << "Evolve iter #" << iter << " done. Summary:\n"
-                                           << pp.SummarizeFailures();
+                                           << pp.SummarizeFailures() << os.str();
     }
   }
   // Return the best states from the heap, sorting from higher score to lower ones
@@ -714,6 +780,13 @@ Optional<Array<MeasureCandidate>> EvolutionarySearchNode::State::GenerateMeasure
   std::vector<Schedule> measured = PickBestFromDatabase(pop * self->init_measured_ratio);
   TVM_PY_LOG(INFO, self->ctx_->logger)
       << "Picked top " << measured.size() << " candidate(s) from database";
+  if (measured.empty()) {
+    measured = PickSimilarFromDatabase(pop * self->init_measured_ratio);
+    if (!measured.empty()) {
+      TVM_PY_LOG(INFO, self->ctx_->logger)
+          << "Seeded " << measured.size() << " candidate(s) from similar workloads in database";
+    }
+  }
   std::vector<Schedule> unmeasured = SampleInitPopulation(pop - measured.size());
   if (static_cast<int>(unmeasured.size()) < self->init_min_unmeasured) {
     TVM_PY_LOG(WARNING, self->ctx_->logger)
@@ -28,6 +28,11 @@ String GetRuleKindFromTarget(const Target& target) {
         runtime::Registry::Get("target.target_has_feature");
     ICHECK(target_has_feature_fn_ptr != nullptr)
         << "The `target.target_has_feature` func is not in tvm registry.";
+    bool have_amx_int8 = (*target_has_feature_fn_ptr)("amx-int8", target);
+    bool have_amx_bf16 = (*target_has_feature_fn_ptr)("amx-bf16", target);
+    if (have_amx_int8 && have_amx_bf16) {
+      return "amx";
+    }
     bool have_avx512vnni = (*target_has_feature_fn_ptr)("avx512vnni", target);
     bool have_avxvnni = (*target_has_feature_fn_ptr)("avxvnni", target);
     if (have_avx512vnni || have_avxvnni) {
@@ -43,6 +48,9 @@ String GetRuleKindFromTarget(const Target& target) {
     TargetJSON target_json = target::parsers::aprofile::ParseTarget(target->Export());
     TargetFeatures afeatures = Downcast<TargetFeatures>(target_json.at("features"));
 
+    if (Downcast<Bool>(afeatures.at("has_matmul_i8"))) {
+      return "i8mm";
+    }
     if (Downcast<Bool>(afeatures.at("has_dotprod"))) {
       return "dotprod";
     }
@@ -117,6 +125,10 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultX86("avx512");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "amx") {
+      default_sch_rules = ScheduleRule::DefaultX86("amx");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else if (kind == "c") {
       default_sch_rules = ScheduleRule::DefaultMicro();
       default_postprocs = Postproc::DefaultMicro();
@@ -129,6 +141,10 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultARM("dotprod");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "i8mm") {
+      default_sch_rules = ScheduleRule::DefaultARM("i8mm");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else {
       LOG(FATAL) << "Unsupported kind: " << kind;
       throw;
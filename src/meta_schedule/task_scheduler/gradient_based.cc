@@ -21,11 +21,21 @@
 namespace tvm {
 namespace meta_schedule {
 
-/*! \brief The gradient based task scheduler. */
+/*!
+ * \brief The gradient based task scheduler.
+ *
+ * With `patience` set, a task converges once its best latency improves by less than
+ * `kMinRelativeImprovement` over `patience` rounds, and is terminated early. The trials left in
+ * the global budget then go to the remaining tasks, again by their weighted gradient.
+ */
 class GradientBasedNode final : public TaskSchedulerNode {
  public:
+  /*! \brief The relative improvement of the best latency below which a round does not count. */
+  static constexpr double kMinRelativeImprovement = 0.01;
+
   double alpha;
   int window_size;
+  int patience;
   support::LinearCongruentialEngine::TRandState rand_state;
 
   int round_robin_rounds_;
@@ -35,6 +45,7 @@ class GradientBasedNode final : public TaskSchedulerNode {
     TaskSchedulerNode::VisitAttrs(v);
     v->Visit("alpha", &alpha);
     v->Visit("window_size", &window_size);
+    v->Visit("patience", &patience);
     // `rand_state` is not visited.
     // `num_rounds_already_` is not visited.
     // `best_latency_history_` is not visited.
@@ -80,6 +91,9 @@ class GradientBasedNode final : public TaskSchedulerNode {
       tasks_alive.reserve(n_tasks);
       for (int i = 0; i < n_tasks; ++i) {
         this->TouchTask(i);
+        if (!this->tasks_[i]->is_terminated && IsConverged(i)) {
+          this->TerminateConvergedTask(i);
+        }
         if (!this->tasks_[i]->is_terminated) {
           tasks_alive.push_back(i);
         }
@@ -118,10 +132,35 @@ class GradientBasedNode final : public TaskSchedulerNode {
     }
     if (this->tasks_[task_id]->runner_futures.defined()) {
       JoinRunningTask(task_id);
+      if (IsConverged(task_id)) {
+        this->TerminateConvergedTask(task_id);
+        return NextTaskId();
+      }
     }
     return task_id;
   }
 
+  /*! \brief Whether the best latency of the task has stopped improving, with no running trials. */
+  bool IsConverged(int task_id) const {
+    if (patience <= 0 || this->tasks_[task_id]->runner_futures.defined()) {
+      return false;
+    }
+    const std::vector<double>& best_latency = this->best_latency_history_.at(task_id);
+    int n = best_latency.size();
+    if (n <= patience || best_latency[n - 1] >= 1e9) {
+      return false;
+    }
+    double improvement = best_latency[n - 1 - patience] - best_latency[n - 1];
+    return improvement < kMinRelativeImprovement * best_latency[n - 1 - patience];
+  }
+
+  void TerminateConvergedTask(int task_id) {
+    TVM_PY_LOG(INFO, this->logger)
+        << "Task #" << task_id << " has converged, with no improvement in the last " << patience
+        << " round(s)";
+    this->TerminateTask(task_id);
+  }
+
   Array<RunnerResult> JoinRunningTask(int task_id) final {
     Array<RunnerResult> results = TaskSchedulerNode::JoinRunningTask(task_id);
     TaskRecordNode* task = this->tasks_[task_id].get();
@@ -135,11 +174,13 @@ class GradientBasedNode final : public TaskSchedulerNode {
 };
 
 TaskScheduler TaskScheduler::GradientBased(PackedFunc logger, double alpha, int window_size,
+                                           int patience,
                                            support::LinearCongruentialEngine::TRandState seed) {
   ObjectPtr<GradientBasedNode> n = make_object<GradientBasedNode>();
   n->logger = logger;
   n->alpha = alpha;
   n->window_size = window_size;
+  n->patience = patience;
   n->rand_state = support::LinearCongruentialEngine::NormalizeSeed(seed);
   return TaskScheduler(n);
 }
@@ -16,6 +16,7 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include "../module_equality.h"
 #include "../utils.h"
 
 namespace tvm {
@@ -38,41 +39,157 @@ TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   this->data_ = std::move(n);
 }
 
-void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
+/*!
+ * \brief The results of the candidates measured in tuning, keyed by the scheduled module and the
+ * target, so that a candidate which is scheduled again is neither built nor run again.
+ */
+class MeasureCache {
+ public:
+  explicit MeasureCache(const std::string& mod_eq_name)
+      : mod_eq_(ModuleEquality::Create(mod_eq_name)) {}
+
+  /*!
+   * \brief Look up the result of a module on a target.
+   * \return The result of the module, or NullOpt if the module is not measured.
+   */
+  Optional<RunnerResult> Get(const IRModule& mod, const Target& target) const {
+    auto it = table_.find(mod_eq_->Hash(mod));
+    if (it == table_.end()) {
+      return NullOpt;
+    }
+    String target_str = target->str();
+    for (const Entry& entry : it->second) {
+      if (entry.target == target_str && mod_eq_->Equal(entry.mod, mod)) {
+        return entry.result;
+      }
+    }
+    return NullOpt;
+  }
+
+  /*! \brief Add the result of a module on a target, unless the module is already measured. */
+  void Add(const IRModule& mod, const Target& target, const RunnerResult& result) {
+    std::vector<Entry>& entries = table_[mod_eq_->Hash(mod)];
+    String target_str = target->str();
+    for (const Entry& entry : entries) {
+      if (entry.target == target_str && mod_eq_->Equal(entry.mod, mod)) {
+        return;
+      }
+    }
+    entries.push_back(Entry{mod, target_str, result});
+  }
+
+ private:
+  struct Entry {
+    IRModule mod;
+    String target;
+    RunnerResult result;
+  };
+
+  /*! \brief The method to hash and compare the modules. */
+  std::unique_ptr<ModuleEquality> mod_eq_;
+  /*! \brief The entries of each hash of the modules. */
+  std::unordered_map<size_t, std::vector<Entry>> table_;
+};
+
+/*!
+ * \brief Add the records of a task in the database to the measure cache, so that a resumed tuning
+ * does not measure the candidates again.
+ */
+void LoadMeasureCache(MeasureCache* cache, const TuneContext& ctx, const Database& database,
+                      int max_trials) {
+  auto _ = Profiler::TimedScope("LoadMeasureCache");
+  Target target = ctx->target.value();
+  Workload workload = database->CommitWorkload(ctx->mod.value());
+  for (const TuningRecord& record : database->GetTopK(workload, max_trials)) {
+    if (!record->target.defined() || record->target.value()->str() != target->str()) {
+      continue;
+    }
+    IRModule mod{nullptr};
+    try {
+      mod = record->AsMeasureCandidate()->sch->mod();
+    } catch (const std::exception& e) {
+      // The trace of the record no longer applies to the workload.
+      continue;
+    }
+    cache->Add(mod, target, RunnerResult(record->run_secs, NullOpt));
+  }
+}
+
+/*!
+ * \brief Look up the measure candidates of a task in the measure cache.
+ * \return The cached result of each candidate, or NullOpt if the candidate is to be measured.
+ */
+std::vector<Optional<RunnerResult>> LookUpMeasureCache(TaskRecordNode* self,
+                                                       const MeasureCache* cache) {
+  Array<MeasureCandidate> candidates = self->measure_candidates.value();
+  Target target = self->ctx->target.value();
+  std::vector<Optional<RunnerResult>> cached;
+  cached.reserve(candidates.size());
+  for (const MeasureCandidate& candidate : candidates) {
+    cached.push_back(cache != nullptr ? cache->Get(candidate->sch->mod(), target) : NullOpt);
+  }
+  return cached;
+}
+
+void SendToBuilder(TaskRecordNode* self, const Builder& builder,
+                   const std::vector<Optional<RunnerResult>>& cached) {
   auto _ = Profiler::TimedScope("SendToBuilder");
   Array<MeasureCandidate> candidates = self->measure_candidates.value();
   Target target = self->ctx->target.value();
+  int n = candidates.size();
   Array<BuilderInput> inputs;
-  inputs.reserve(candidates.size());
-  for (const MeasureCandidate& candidate : candidates) {
-    inputs.push_back(BuilderInput(candidate->sch->mod(), target));
+  inputs.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    if (!cached[i].defined()) {
+      inputs.push_back(BuilderInput(candidates[i]->sch->mod(), target));
+    }
+  }
+  Array<BuilderResult> results;
+  if (!inputs.empty()) {
+    auto _ = Profiler::TimedSpan("builder", "Build");
+    results = builder->Build(inputs);
+  }
+  if (static_cast<int>(inputs.size()) == n) {
+    self->builder_results = results;
+    return;
   }
-  self->builder_results = builder->Build(inputs);
+  // The cached candidates have no artifact.
+  Array<BuilderResult> builder_results;
+  builder_results.reserve(n);
+  for (int i = 0, j = 0; i < n; ++i) {
+    builder_results.push_back(cached[i].defined() ? BuilderResult(NullOpt, NullOpt) : results[j++]);
+  }
+  self->builder_results = builder_results;
 }
 
-void SendToRunner(TaskRecordNode* self, const Runner& runner) {
+void SendToRunner(TaskRecordNode* self, const Runner& runner,
+                  const std::vector<Optional<RunnerResult>>& cached) {
   auto _ = Profiler::TimedScope("SendToRunner");
   Array<MeasureCandidate> candidates = self->measure_candidates.value();
   Array<BuilderResult> builder_results = self->builder_results.value();
   Target target = self->ctx->target.value();
   ICHECK_EQ(candidates.size(), builder_results.size());
   int n = candidates.size();
-  int n_build_errors = 0;
+  int n_resolved = 0;
   Array<RunnerInput> inputs;
   inputs.reserve(n);
   for (int i = 0; i < n; ++i) {
     const MeasureCandidate& candidate = candidates[i];
     const BuilderResult& builder_result = builder_results[i];
-    if (builder_result->error_msg.defined()) {
-      ++n_build_errors;
+    if (cached[i].defined() || builder_result->error_msg.defined()) {
+      ++n_resolved;
       continue;
     }
     inputs.push_back(RunnerInput(/*artifact_path=*/builder_result->artifact_path.value(),
                                  /*device_type=*/target->kind->name,
                                  /*args_info=*/candidate->args_info));
   }
-  Array<RunnerFuture> futures = runner->Run(inputs);
-  if (n_build_errors == 0) {
+  Array<RunnerFuture> futures;
+  if (!inputs.empty()) {
+    futures = runner->Run(inputs);
+    Profiler::BeginRunnerSpan();
+  }
+  if (n_resolved == 0) {
     self->runner_futures = futures;
     return;
   }
@@ -80,7 +197,11 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
   results.reserve(n);
   for (int i = 0, j = 0; i < n; ++i) {
     const BuilderResult& builder_result = builder_results[i];
-    if (builder_result->error_msg.defined()) {
+    if (cached[i].defined()) {
+      results.push_back(RunnerFuture(
+          /*f_done=*/[]() -> bool { return true; },
+          /*f_result=*/[result = cached[i].value()]() -> RunnerResult { return result; }));
+    } else if (builder_result->error_msg.defined()) {
       results.push_back(RunnerFuture(
           /*f_done=*/[]() -> bool { return true; },
           /*f_result=*/
@@ -151,6 +272,8 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
   this->measure_callbacks_ = measure_callbacks;
   this->database_ = database;
   this->cost_model_ = cost_model;
+  this->measure_cache_ = std::make_shared<MeasureCache>(
+      database.defined() ? database.value()->GetModuleEquality().GetName() : "structural");
   this->tasks_.clear();
   this->tasks_.reserve(n_tasks);
   for (int i = 0; i < n_tasks; ++i) {
@@ -173,6 +296,9 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
     }
     ctx->search_strategy.value()->PreTuning(max_trials_per_task, num_trials_per_iter, design_spaces,
                                             database, cost_model);
+    if (database.defined()) {
+      LoadMeasureCache(this->measure_cache_.get(), ctx, database.value(), max_trials_per_task);
+    }
   }
 
   int num_trials_already = 0;
@@ -186,14 +312,30 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
       TerminateTask(task_id);
       continue;
     }
-    if (Optional<Array<MeasureCandidate>> candidates = task->measure_candidates =
-            task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
+    Profiler::SetCurrentTask(task_id);
+    Optional<Array<MeasureCandidate>> candidates;
+    {
+      auto _ = Profiler::TimedScope("GenerateMeasureCandidates");
+      candidates = task->measure_candidates =
+          task->ctx->search_strategy.value()->GenerateMeasureCandidates();
+    }
+    if (candidates) {
       int num_candidates = candidates.value().size();
       num_trials_already += num_candidates;
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
-      SendToBuilder(task, builder);
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
-      SendToRunner(task, runner);
+      std::vector<Optional<RunnerResult>> cached =
+          LookUpMeasureCache(task, this->measure_cache_.get());
+      int num_cached = std::count_if(cached.begin(), cached.end(),
+                                     [](const Optional<RunnerResult>& r) { return r.defined(); });
+      if (num_cached > 0) {
+        TVM_PY_LOG(INFO, this->logger) << "Resolved " << num_cached
+                                       << " sample(s) from the measure cache";
+      }
+      TVM_PY_LOG(INFO, this->logger)
+          << "Sending " << num_candidates - num_cached << " sample(s) to builder";
+      SendToBuilder(task, builder, cached);
+      TVM_PY_LOG(INFO, this->logger)
+          << "Sending " << num_candidates - num_cached << " sample(s) to runner";
+      SendToRunner(task, runner, cached);
     } else {
       TerminateTask(task_id);
     }
@@ -208,12 +350,18 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
     }
     task->ctx->search_strategy.value()->PostTuning();
   }
+  Profiler::SetCurrentTask(-1);
+  if (Optional<Profiler> profiler = Profiler::Current()) {
+    TVM_PY_LOG(INFO, this->logger) << "Utilization of the tuning pipeline:\n"
+                                   << profiler.value()->Utilization();
+  }
 }
 
 Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
   TaskRecordNode* task = this->tasks_[task_id].get();
   ICHECK(task->runner_futures.defined());
   Array<RunnerResult> results;
+  Profiler::SetCurrentTask(task_id);
   {
     auto _ = Profiler::TimedScope("JoinRunnerFutures");
     Array<RunnerFuture> futures = task->runner_futures.value();
@@ -222,12 +370,24 @@ Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
       results.push_back(future->Result());
     }
   }
+  Profiler::EndRunnerSpan(task_id);
   ICHECK(task->measure_candidates.defined());
   task->ctx->search_strategy.value()->NotifyRunnerResults(task->measure_candidates.value(),
                                                           results);
   ICHECK(task->builder_results.defined());
   ICHECK_EQ(results.size(), task->measure_candidates.value().size());
   ICHECK_EQ(results.size(), task->builder_results.value().size());
+  if (this->measure_cache_ != nullptr) {
+    // Only the successful runs are cached, as the errors of a run may be transient.
+    Target target = task->ctx->target.value();
+    for (int i = 0, n = results.size(); i < n; ++i) {
+      if (!task->builder_results.value()[i]->error_msg.defined() &&
+          !results[i]->error_msg.defined()) {
+        this->measure_cache_->Add(task->measure_candidates.value()[i]->sch->mod(), target,
+                                  results[i]);
+      }
+    }
+  }
   for (const MeasureCallback& callback : this->measure_callbacks_) {
     callback->Apply(GetRef<TaskScheduler>(this), task_id, task->measure_candidates.value(),
                     task->builder_results.value(), results);
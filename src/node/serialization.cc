@@ -33,8 +33,11 @@
 #include <tvm/runtime/registry.h>
 
 #include <cctype>
+#include <cstring>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../runtime/object_internal.h"
 #include "../support/base64.h"
@@ -468,6 +471,46 @@ class JSONAttrSetter : public AttrVisitor {
   }
 };
 
+/*!
+ * \brief Sort the nodes so that a node comes after the ones its data and fields refer to.
+ * \param nodes The nodes, with the indices of the nodes they refer to in `data` and `fields`.
+ */
+template <typename TNode>
+std::vector<size_t> TopoSort(const std::vector<TNode>& nodes) {
+  size_t n_nodes = nodes.size();
+  std::vector<size_t> topo_order;
+  std::vector<size_t> in_degree(n_nodes, 0);
+  for (const TNode& node : nodes) {
+    for (size_t i : node.data) {
+      ++in_degree[i];
+    }
+    for (size_t i : node.fields) {
+      ++in_degree[i];
+    }
+  }
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (in_degree[i] == 0) {
+      topo_order.push_back(i);
+    }
+  }
+  for (size_t p = 0; p < topo_order.size(); ++p) {
+    const TNode& node = nodes[topo_order[p]];
+    for (size_t i : node.data) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+    for (size_t i : node.fields) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+  }
+  ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in the serialized nodes";
+  std::reverse(std::begin(topo_order), std::end(topo_order));
+  return topo_order;
+}
+
 // json graph structure to store node
 struct JSONGraph {
   // the root of the graph
@@ -527,40 +570,7 @@ struct JSONGraph {
     return g;
   }
 
-  std::vector<size_t> TopoSort() const {
-    size_t n_nodes = nodes.size();
-    std::vector<size_t> topo_order;
-    std::vector<size_t> in_degree(n_nodes, 0);
-    for (const JSONNode& jnode : nodes) {
-      for (size_t i : jnode.data) {
-        ++in_degree[i];
-      }
-      for (size_t i : jnode.fields) {
-        ++in_degree[i];
-      }
-    }
-    for (size_t i = 0; i < n_nodes; ++i) {
-      if (in_degree[i] == 0) {
-        topo_order.push_back(i);
-      }
-    }
-    for (size_t p = 0; p < topo_order.size(); ++p) {
-      const JSONNode& jnode = nodes[topo_order[p]];
-      for (size_t i : jnode.data) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-      for (size_t i : jnode.fields) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-    }
-    ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in JSON file";
-    std::reverse(std::begin(topo_order), std::end(topo_order));
-    return topo_order;
-  }
+  std::vector<size_t> TopoSort() const { return tvm::TopoSort(nodes); }
 };
 
 std::string SaveJSON(const ObjectRef& n) {
@@ -622,7 +632,566 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+/*!
+ * \brief The binary format of the nodes.
+ *
+ *  The format is a header of the magic number and the version, a string table, the schema of
+ *  each type, i.e. the kind of each of its fields in the order of VisitAttrs, the nodes and the
+ *  raw payload of the NDArrays. The nodes are in the order of NodeIndexer, and refer to the
+ *  strings, the types, the other nodes and the NDArrays by varint indices, so that a node costs
+ *  a few bytes per field instead of a JSON object of string attrs.
+ */
+namespace binary {
+
+constexpr uint64_t kTVMNodeBinaryMagic = 0xB17A2E5C0DE0F00D;
+
+/*! \brief The kind of a field, which decides its encoding. */
+enum class FieldKind : uint8_t {
+  kDouble = 0,
+  kInt64 = 1,
+  kUInt64 = 2,
+  kInt = 3,
+  kBool = 4,
+  kString = 5,
+  kDataType = 6,
+  kNDArray = 7,
+  kObject = 8,
+};
+
+/*! \brief The encoding of a node, which is how the loader decodes its fields. */
+enum class NodeKind : uint8_t {
+  kReprBytes = 0,
+  kArray = 1,
+  kMap = 2,
+  kStrMap = 3,
+  kFields = 4,
+};
+
+/*! \brief The schema of a type. */
+struct TypeSchema {
+  /*! \brief The index of the type key in the string table. */
+  uint64_t type_key;
+  NodeKind node_kind;
+  /*! \brief The indices of the field names in the string table. */
+  std::vector<uint64_t> field_names;
+  std::vector<FieldKind> field_kinds;
+};
+
+void WriteVarint(std::string* buf, uint64_t value) {
+  while (value >= 0x80) {
+    buf->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  buf->push_back(static_cast<char>(value));
+}
+
+void WriteSigned(std::string* buf, int64_t value) {
+  // zigzag encoding, so that small negative values are short.
+  WriteVarint(buf, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+/*! \brief A reader of the varints of an in-memory section. */
+class SectionReader {
+ public:
+  explicit SectionReader(const std::string& buf) : begin_(buf.data()), end_(begin_ + buf.size()) {}
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      CHECK(begin_ != end_) << "ValueError: Truncated binary of TVM nodes";
+      uint8_t byte = static_cast<uint8_t>(*begin_++);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    LOG(FATAL) << "ValueError: Malformed varint in the binary of TVM nodes";
+    throw;
+  }
+
+  int64_t ReadSigned() {
+    uint64_t value = ReadVarint();
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  }
+
+  uint64_t ReadFixed64() {
+    CHECK_GE(end_ - begin_, 8) << "ValueError: Truncated binary of TVM nodes";
+    uint64_t value;
+    std::memcpy(&value, begin_, sizeof(value));
+    begin_ += sizeof(value);
+    return value;
+  }
+
+  uint8_t ReadByte() {
+    CHECK(begin_ != end_) << "ValueError: Truncated binary of TVM nodes";
+    return static_cast<uint8_t>(*begin_++);
+  }
+
+  std::string ReadString() {
+    uint64_t size = ReadVarint();
+    CHECK_LE(size, static_cast<uint64_t>(end_ - begin_))
+        << "ValueError: Truncated binary of TVM nodes";
+    std::string value(begin_, size);
+    begin_ += size;
+    return value;
+  }
+
+  bool AtEnd() const { return begin_ == end_; }
+
+ private:
+  const char* begin_;
+  const char* end_;
+};
+
+/*! \brief Record the names and kinds of the fields of a node. */
+class SchemaRecorder : public AttrVisitor {
+ public:
+  std::vector<std::string> names;
+  std::vector<FieldKind> kinds;
+
+  void Visit(const char* key, double* value) final { Add(key, FieldKind::kDouble); }
+  void Visit(const char* key, int64_t* value) final { Add(key, FieldKind::kInt64); }
+  void Visit(const char* key, uint64_t* value) final { Add(key, FieldKind::kUInt64); }
+  void Visit(const char* key, int* value) final { Add(key, FieldKind::kInt); }
+  void Visit(const char* key, bool* value) final { Add(key, FieldKind::kBool); }
+  void Visit(const char* key, std::string* value) final { Add(key, FieldKind::kString); }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final { Add(key, FieldKind::kDataType); }
+  void Visit(const char* key, runtime::NDArray* value) final { Add(key, FieldKind::kNDArray); }
+  void Visit(const char* key, ObjectRef* value) final { Add(key, FieldKind::kObject); }
+
+ private:
+  void Add(const char* key, FieldKind kind) {
+    names.push_back(key);
+    kinds.push_back(kind);
+  }
+};
+
+/*! \brief The encoder of the nodes indexed by NodeIndexer. */
+class BinaryWriter : public AttrVisitor {
+ public:
+  explicit BinaryWriter(const NodeIndexer* indexer) : indexer_(indexer) {}
+
+  void Save(dmlc::Stream* strm, const ObjectRef& root) {
+    WriteVarint(&nodes_, indexer_->node_list_.size());
+    for (Object* node : indexer_->node_list_) {
+      WriteNode(node);
+    }
+    WriteVarint(&nodes_, indexer_->node_index_.at(const_cast<Object*>(root.get())));
+
+    std::string header;
+    WriteVarint(&header, strings_.size());
+    for (const std::string& str : strings_) {
+      WriteVarint(&header, str.size());
+      header.append(str);
+    }
+    WriteVarint(&header, schemas_.size());
+    for (const TypeSchema& schema : schemas_) {
+      WriteVarint(&header, schema.type_key);
+      header.push_back(static_cast<char>(schema.node_kind));
+      WriteVarint(&header, schema.field_names.size());
+      for (size_t i = 0; i < schema.field_names.size(); ++i) {
+        WriteVarint(&header, schema.field_names[i]);
+        header.push_back(static_cast<char>(schema.field_kinds[i]));
+      }
+    }
+    strm->Write(kTVMNodeBinaryMagic);
+    strm->Write(std::string(TVM_VERSION));
+    strm->Write(header);
+    strm->Write(nodes_);
+    uint64_t num_tensors = indexer_->tensor_list_.size();
+    strm->Write(num_tensors);
+    for (DLTensor* tensor : indexer_->tensor_list_) {
+      runtime::SaveDLTensor(strm, tensor);
+    }
+  }
+
+  void Visit(const char* key, double* value) final {
+    Check(FieldKind::kDouble);
+    uint64_t bits;
+    std::memcpy(&bits, value, sizeof(bits));
+    nodes_.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+  }
+  void Visit(const char* key, int64_t* value) final {
+    Check(FieldKind::kInt64);
+    WriteSigned(&nodes_, *value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    Check(FieldKind::kUInt64);
+    WriteVarint(&nodes_, *value);
+  }
+  void Visit(const char* key, int* value) final {
+    Check(FieldKind::kInt);
+    WriteSigned(&nodes_, *value);
+  }
+  void Visit(const char* key, bool* value) final {
+    Check(FieldKind::kBool);
+    nodes_.push_back(static_cast<char>(*value));
+  }
+  void Visit(const char* key, std::string* value) final {
+    Check(FieldKind::kString);
+    WriteVarint(&nodes_, Intern(*value));
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    Check(FieldKind::kDataType);
+    DLDataType dtype = *value;
+    WriteVarint(&nodes_, dtype.code);
+    WriteVarint(&nodes_, dtype.bits);
+    WriteVarint(&nodes_, dtype.lanes);
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    Check(FieldKind::kNDArray);
+    WriteVarint(&nodes_,
+                indexer_->tensor_index_.at(const_cast<DLTensor*>((*value).operator->())));
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    Check(FieldKind::kObject);
+    WriteVarint(&nodes_, indexer_->node_index_.at(const_cast<Object*>(value->get())));
+  }
+
+ private:
+  uint64_t Intern(const std::string& str) {
+    auto it = string_index_.find(str);
+    if (it != string_index_.end()) return it->second;
+    string_index_.emplace(str, strings_.size());
+    strings_.push_back(str);
+    return strings_.size() - 1;
+  }
+
+  /*! \brief Get the schema index of the type of the node, recording the schema on first use. */
+  uint64_t GetSchema(Object* node, NodeKind node_kind) {
+    auto it = schema_index_.find(node->type_index());
+    if (it != schema_index_.end()) return it->second;
+    TypeSchema schema;
+    schema.type_key = Intern(node->GetTypeKey());
+    schema.node_kind = node_kind;
+    if (node_kind == NodeKind::kFields) {
+      SchemaRecorder recorder;
+      reflection_->VisitAttrs(node, &recorder);
+      for (const std::string& name : recorder.names) {
+        schema.field_names.push_back(Intern(name));
+      }
+      schema.field_kinds = std::move(recorder.kinds);
+    }
+    schema_index_[node->type_index()] = schemas_.size();
+    schemas_.emplace_back(std::move(schema));
+    return schemas_.size() - 1;
+  }
+
+  void Check(FieldKind kind) {
+    const std::vector<FieldKind>& kinds = schemas_[current_schema_].field_kinds;
+    CHECK(current_field_ < kinds.size() && kinds[current_field_] == kind)
+        << "ValueError: The fields of " << strings_[schemas_[current_schema_].type_key]
+        << " differ between its objects";
+    ++current_field_;
+  }
+
+  void WriteNode(Object* node) {
+    // The null node is encoded as type 0, and the others as their schema + 1.
+    if (node == nullptr) {
+      WriteVarint(&nodes_, 0);
+      return;
+    }
+    std::string repr_bytes;
+    if (reflection_->GetReprBytes(node, &repr_bytes)) {
+      WriteVarint(&nodes_, GetSchema(node, NodeKind::kReprBytes) + 1);
+      WriteVarint(&nodes_, Intern(repr_bytes));
+    } else if (node->IsInstance<ArrayNode>()) {
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      WriteVarint(&nodes_, GetSchema(node, NodeKind::kArray) + 1);
+      WriteVarint(&nodes_, n->size());
+      for (const ObjectRef& elem : *n) {
+        WriteVarint(&nodes_, indexer_->node_index_.at(const_cast<Object*>(elem.get())));
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      bool is_str_map = std::all_of(n->begin(), n->end(), [](const auto& v) {
+        return v.first->template IsInstance<StringObj>();
+      });
+      // The schema of a map records the encoding of its first object, which is written for
+      // each map instead.
+      WriteVarint(&nodes_, GetSchema(node, NodeKind::kMap) + 1);
+      nodes_.push_back(static_cast<char>(is_str_map ? NodeKind::kStrMap : NodeKind::kMap));
+      WriteVarint(&nodes_, n->size());
+      for (const auto& kv : *n) {
+        if (is_str_map) {
+          WriteVarint(&nodes_, Intern(Downcast<String>(kv.first)));
+        } else {
+          WriteVarint(&nodes_, indexer_->node_index_.at(const_cast<Object*>(kv.first.get())));
+        }
+        WriteVarint(&nodes_, indexer_->node_index_.at(const_cast<Object*>(kv.second.get())));
+      }
+    } else {
+      current_schema_ = GetSchema(node, NodeKind::kFields);
+      current_field_ = 0;
+      WriteVarint(&nodes_, current_schema_ + 1);
+      reflection_->VisitAttrs(node, this);
+      CHECK_EQ(current_field_, schemas_[current_schema_].field_kinds.size())
+          << "ValueError: The fields of " << node->GetTypeKey() << " differ between its objects";
+    }
+  }
+
+  const NodeIndexer* indexer_;
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint64_t> string_index_;
+  std::vector<TypeSchema> schemas_;
+  std::unordered_map<uint32_t, uint64_t> schema_index_;
+  std::string nodes_;
+  uint64_t current_schema_{0};
+  size_t current_field_{0};
+};
+
+/*! \brief A decoded node, whose fields are set once the nodes it depends on are. */
+struct BinaryNode {
+  /*! \brief The schema + 1, or 0 for the null node. */
+  uint64_t type{0};
+  NodeKind node_kind{NodeKind::kFields};
+  /*! \brief The repr bytes. */
+  std::string repr_bytes;
+  /*! \brief The elements of an array, the keys and values of a map, or the values of a str map. */
+  std::vector<size_t> data;
+  /*! \brief The keys of a str map. */
+  std::vector<std::string> keys;
+  /*! \brief The fields, as raw words in the order of VisitAttrs. */
+  std::vector<uint64_t> values;
+  /*! \brief The nodes the fields refer to, for the topological sort. */
+  std::vector<size_t> fields;
+};
+
+/*! \brief Set the fields of a node from its decoded values. */
+class BinaryAttrSetter : public AttrVisitor {
+ public:
+  const std::vector<ObjectPtr<Object>>* node_list_;
+  const std::vector<runtime::NDArray>* tensor_list_;
+  const std::vector<std::string>* strings_;
+  const BinaryNode* bnode_;
+  size_t pos_{0};
+
+  uint64_t Next() { return bnode_->values[pos_++]; }
+
+  void Visit(const char* key, double* value) final {
+    uint64_t bits = Next();
+    std::memcpy(value, &bits, sizeof(bits));
+  }
+  void Visit(const char* key, int64_t* value) final { *value = static_cast<int64_t>(Next()); }
+  void Visit(const char* key, uint64_t* value) final { *value = Next(); }
+  void Visit(const char* key, int* value) final { *value = static_cast<int>(Next()); }
+  void Visit(const char* key, bool* value) final { *value = Next() != 0; }
+  void Visit(const char* key, std::string* value) final { *value = strings_->at(Next()); }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    DLDataType dtype;
+    dtype.code = static_cast<uint8_t>(Next());
+    dtype.bits = static_cast<uint8_t>(Next());
+    dtype.lanes = static_cast<uint16_t>(Next());
+    *value = DataType(dtype);
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    *value = tensor_list_->at(Next());
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    *value = ObjectRef(node_list_->at(Next()));
+  }
+};
+
+ObjectRef Load(dmlc::Stream* strm) {
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  uint64_t magic;
+  std::string version, header, nodes_section;
+  CHECK(strm->Read(&magic) && magic == kTVMNodeBinaryMagic)
+      << "ValueError: The data is not a binary of TVM nodes";
+  CHECK(strm->Read(&version) && strm->Read(&header) && strm->Read(&nodes_section))
+      << "ValueError: Truncated binary of TVM nodes";
+  // The string table and the schemas.
+  SectionReader header_reader(header);
+  std::vector<std::string> strings(header_reader.ReadVarint());
+  for (std::string& str : strings) {
+    str = header_reader.ReadString();
+  }
+  std::vector<TypeSchema> schemas(header_reader.ReadVarint());
+  for (TypeSchema& schema : schemas) {
+    schema.type_key = header_reader.ReadVarint();
+    schema.node_kind = static_cast<NodeKind>(header_reader.ReadByte());
+    uint64_t num_fields = header_reader.ReadVarint();
+    for (uint64_t i = 0; i < num_fields; ++i) {
+      schema.field_names.push_back(header_reader.ReadVarint());
+      schema.field_kinds.push_back(static_cast<FieldKind>(header_reader.ReadByte()));
+    }
+  }
+  // The nodes.
+  SectionReader reader(nodes_section);
+  std::vector<BinaryNode> bnodes(reader.ReadVarint());
+  for (BinaryNode& bnode : bnodes) {
+    bnode.type = reader.ReadVarint();
+    if (bnode.type == 0) continue;
+    CHECK_LE(bnode.type, schemas.size()) << "ValueError: Malformed binary of TVM nodes";
+    const TypeSchema& schema = schemas[bnode.type - 1];
+    bnode.node_kind = schema.node_kind;
+    if (bnode.node_kind == NodeKind::kMap) {
+      bnode.node_kind = static_cast<NodeKind>(reader.ReadByte());
+    }
+    switch (bnode.node_kind) {
+      case NodeKind::kReprBytes:
+        bnode.repr_bytes = strings.at(reader.ReadVarint());
+        break;
+      case NodeKind::kArray:
+        bnode.data.resize(reader.ReadVarint());
+        for (size_t& index : bnode.data) {
+          index = reader.ReadVarint();
+        }
+        break;
+      case NodeKind::kMap:
+      case NodeKind::kStrMap: {
+        uint64_t size = reader.ReadVarint();
+        for (uint64_t i = 0; i < size; ++i) {
+          if (bnode.node_kind == NodeKind::kStrMap) {
+            bnode.keys.push_back(strings.at(reader.ReadVarint()));
+          } else {
+            bnode.data.push_back(reader.ReadVarint());
+          }
+          bnode.data.push_back(reader.ReadVarint());
+        }
+        break;
+      }
+      case NodeKind::kFields:
+        for (FieldKind kind : schema.field_kinds) {
+          switch (kind) {
+            case FieldKind::kDouble:
+              bnode.values.push_back(reader.ReadFixed64());
+              break;
+            case FieldKind::kInt64:
+            case FieldKind::kInt:
+              bnode.values.push_back(static_cast<uint64_t>(reader.ReadSigned()));
+              break;
+            case FieldKind::kBool:
+              bnode.values.push_back(reader.ReadByte());
+              break;
+            case FieldKind::kDataType:
+              for (int i = 0; i < 3; ++i) {
+                bnode.values.push_back(reader.ReadVarint());
+              }
+              break;
+            case FieldKind::kObject:
+              bnode.values.push_back(reader.ReadVarint());
+              bnode.fields.push_back(bnode.values.back());
+              break;
+            default:
+              bnode.values.push_back(reader.ReadVarint());
+          }
+        }
+        break;
+      default:
+        LOG(FATAL) << "ValueError: Malformed binary of TVM nodes";
+    }
+  }
+  size_t root = reader.ReadVarint();
+  CHECK(reader.AtEnd() && root < bnodes.size()) << "ValueError: Malformed binary of TVM nodes";
+  for (const BinaryNode& bnode : bnodes) {
+    for (const std::vector<size_t>* indices : {&bnode.data, &bnode.fields}) {
+      CHECK(std::all_of(indices->begin(), indices->end(),
+                        [&](size_t index) { return index < bnodes.size(); }))
+          << "ValueError: Malformed binary of TVM nodes";
+    }
+  }
+  // The tensors.
+  uint64_t num_tensors;
+  CHECK(strm->Read(&num_tensors)) << "ValueError: Truncated binary of TVM nodes";
+  std::vector<runtime::NDArray> tensors(num_tensors);
+  for (runtime::NDArray& tensor : tensors) {
+    CHECK(tensor.Load(strm)) << "ValueError: Truncated binary of TVM nodes";
+  }
+  // Pass 1: create all non-container objects, and check that their fields are the saved ones.
+  std::vector<ObjectPtr<Object>> nodes(bnodes.size(), nullptr);
+  std::vector<bool> checked(schemas.size(), false);
+  for (size_t i = 0; i < bnodes.size(); ++i) {
+    const BinaryNode& bnode = bnodes[i];
+    if (bnode.type == 0) continue;
+    const TypeSchema& schema = schemas[bnode.type - 1];
+    nodes[i] = reflection->CreateInitObject(strings.at(schema.type_key), bnode.repr_bytes);
+    if (bnode.node_kind == NodeKind::kFields && !checked[bnode.type - 1]) {
+      SchemaRecorder recorder;
+      reflection->VisitAttrs(nodes[i].get(), &recorder);
+      bool same = recorder.kinds == schema.field_kinds;
+      for (size_t j = 0; same && j < recorder.names.size(); ++j) {
+        same = recorder.names[j] == strings.at(schema.field_names[j]);
+      }
+      CHECK(same) << "ValueError: The fields of " << strings.at(schema.type_key)
+                  << " differ from the ones it had in TVM " << version
+                  << " that saved the binary, which should be loaded by the same version";
+      checked[bnode.type - 1] = true;
+    }
+  }
+  // Pass 2: topo sort, as the fields of a node may only be set once the nodes they refer to are.
+  std::vector<size_t> topo_order = TopoSort(bnodes);
+  // Pass 3: set all values
+  BinaryAttrSetter setter;
+  setter.node_list_ = &nodes;
+  setter.tensor_list_ = &tensors;
+  setter.strings_ = &strings;
+  for (size_t i : topo_order) {
+    const BinaryNode& bnode = bnodes[i];
+    if (bnode.type == 0) continue;
+    if (bnode.node_kind == NodeKind::kArray) {
+      std::vector<ObjectRef> container;
+      for (size_t index : bnode.data) {
+        container.push_back(ObjectRef(nodes.at(index)));
+      }
+      Array<ObjectRef> array(container);
+      nodes[i] = runtime::ObjectInternal::MoveObjectPtr(&array);
+    } else if (bnode.node_kind == NodeKind::kMap || bnode.node_kind == NodeKind::kStrMap) {
+      std::unordered_map<ObjectRef, ObjectRef, ObjectHash, ObjectEqual> container;
+      if (bnode.node_kind == NodeKind::kStrMap) {
+        for (size_t j = 0; j < bnode.data.size(); ++j) {
+          container[String(bnode.keys[j])] = ObjectRef(nodes.at(bnode.data[j]));
+        }
+      } else {
+        for (size_t j = 0; j < bnode.data.size(); j += 2) {
+          container[ObjectRef(nodes.at(bnode.data[j]))] = ObjectRef(nodes.at(bnode.data[j + 1]));
+        }
+      }
+      Map<ObjectRef, ObjectRef> map(container);
+      nodes[i] = runtime::ObjectInternal::MoveObjectPtr(&map);
+    } else if (bnode.node_kind == NodeKind::kFields) {
+      setter.bnode_ = &bnode;
+      setter.pos_ = 0;
+      reflection->VisitAttrs(nodes[i].get(), &setter);
+    }
+  }
+  return ObjectRef(nodes.at(root));
+}
+
+}  // namespace binary
+
+void SaveBinary(dmlc::Stream* strm, const ObjectRef& node) {
+  NodeIndexer indexer;
+  indexer.MakeIndex(const_cast<Object*>(node.get()));
+  binary::BinaryWriter(&indexer).Save(strm, node);
+}
+
+ObjectRef LoadBinary(dmlc::Stream* strm) { return binary::Load(strm); }
+
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
+
+TVM_REGISTER_GLOBAL("node.SaveBinary").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::string data;
+  dmlc::MemoryStringStream strm(&data);
+  SaveBinary(&strm, args[0].operator ObjectRef());
+  TVMByteArray arr;
+  arr.data = data.data();
+  arr.size = data.size();
+  *rv = arr;
+});
+
+TVM_REGISTER_GLOBAL("node.LoadBinary").set_body_typed([](std::string data) {
+  dmlc::MemoryStringStream strm(&data);
+  return LoadBinary(&strm);
+});
 }  // namespace tvm
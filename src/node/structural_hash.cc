@@ -20,6 +20,7 @@
  * \file src/node/structural_hash.cc
  */
 #include <dmlc/memory_io.h>
+#include <tvm/ir/module.h>
 #include <tvm/node/functor.h>
 #include <tvm/node/node.h>
 #include <tvm/node/object_path.h>
@@ -31,7 +32,13 @@
 #include <tvm/target/codegen.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../support/base64.h"
 #include "../support/str_escape.h"
@@ -50,6 +57,145 @@ void ReflectionVTable::SHashReduce(const Object* self, SHashReducer reducer) con
   fshash_reduce_[tindex](self, reducer);
 }
 
+/*!
+ * \brief The implementation of StructuralHashCache.
+ *
+ *  An entry is valid in a hash if the outer objects the subtree depends on, i.e. the free vars
+ *  it refers to and the nodes that contain them, have the same hash as when it was cached, and
+ *  if the subtree defines free vars, if the free var counter is the same. A hit replays the
+ *  free vars the subtree defines, so that the rest of the tree sees them as if it was visited.
+ */
+class StructuralHashCacheImpl {
+ public:
+  /*! \brief The minimum number of nodes of a cached subtree. */
+  static constexpr size_t kMinSubtreeSize = 256;
+  /*! \brief The maximum number of outer dependencies and free var definitions of an entry. */
+  static constexpr size_t kMaxReplaySize = 4096;
+
+  /*! \brief The cached hash of a subtree. */
+  struct Entry {
+    /*! \brief The root of the subtree, which the entry keeps alive. */
+    ObjectRef object;
+    /*! \brief The hash of the subtree. */
+    uint64_t hash;
+    /*! \brief Whether the hash depends on free vars. */
+    bool context_dependent;
+    /*! \brief The number of the subtree's nodes. */
+    size_t num_nodes;
+    /*! \brief The free var counter before the subtree. */
+    uint32_t free_var_counter_begin;
+    /*! \brief The number of free vars the subtree maps by occurrence. */
+    uint32_t num_mapped_free_vars;
+    /*! \brief The outer objects the subtree depends on, with their hash. */
+    std::vector<std::pair<ObjectRef, uint64_t>> dependencies;
+    /*! \brief The free vars the subtree defines, with their hash. */
+    std::vector<std::pair<ObjectRef, uint64_t>> definitions;
+    /*! \brief Whether the entry was hit since the last eviction sweep. */
+    mutable std::atomic<bool> recently_used{true};
+  };
+
+  static StructuralHashCacheImpl* Global() {
+    static StructuralHashCacheImpl* inst = new StructuralHashCacheImpl();
+    return inst;
+  }
+
+  bool enabled() const { return capacity_.load(std::memory_order_relaxed) != 0; }
+
+  std::shared_ptr<const Entry> Lookup(const Object* object, size_t handler, bool map_free_vars) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = entries_.find(Key{object, handler, map_free_vars});
+    if (it == entries_.end()) return nullptr;
+    it->second->recently_used.store(true, std::memory_order_relaxed);
+    return it->second;
+  }
+
+  void Insert(size_t handler, bool map_free_vars, std::shared_ptr<const Entry> entry) {
+    std::vector<std::shared_ptr<const Entry>> evicted;
+    {
+      std::unique_lock<std::shared_mutex> lock(mutex_);
+      size_t capacity = capacity_.load(std::memory_order_relaxed);
+      if (capacity == 0) return;
+      if (entries_.size() >= capacity) {
+        Evict(capacity / 2, &evicted);
+      }
+      entries_[Key{entry->object.get(), handler, map_free_vars}] = std::move(entry);
+    }
+    // The evicted subtrees are freed out of the lock.
+  }
+
+  void SetCapacity(size_t capacity) {
+    std::vector<std::shared_ptr<const Entry>> evicted;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    capacity_.store(capacity, std::memory_order_relaxed);
+    if (entries_.size() > capacity) {
+      Evict(capacity, &evicted);
+    }
+  }
+
+  void Clear() {
+    std::vector<std::shared_ptr<const Entry>> evicted;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Evict(0, &evicted);
+  }
+
+  Map<String, Integer> GetStats() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return {{"hits", Integer(hits.load())},
+            {"misses", Integer(misses.load())},
+            {"size", Integer(static_cast<int64_t>(entries_.size()))},
+            {"capacity", Integer(static_cast<int64_t>(capacity_.load()))}};
+  }
+
+  /*! \brief The number of valid lookups. */
+  std::atomic<int64_t> hits{0};
+  /*! \brief The number of subtrees of cacheable size visited with the cache enabled. */
+  std::atomic<int64_t> misses{0};
+
+ private:
+  struct Key {
+    const Object* object;
+    size_t handler;
+    bool map_free_vars;
+
+    bool operator==(const Key& other) const {
+      return object == other.object && handler == other.handler &&
+             map_free_vars == other.map_free_vars;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      size_t hash = std::hash<const Object*>()(key.object);
+      hash = support::HashCombine(hash, key.handler);
+      return support::HashCombine(hash, static_cast<size_t>(key.map_free_vars));
+    }
+  };
+
+  /*!
+   * \brief Evict the entries not used since the last sweep, then arbitrary ones down to `size`.
+   * \param size The number of the entries to keep at most.
+   * \param evicted The evicted entries, to be freed by the caller.
+   */
+  void Evict(size_t size, std::vector<std::shared_ptr<const Entry>>* evicted) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (!it->second->recently_used.exchange(false, std::memory_order_relaxed)) {
+        evicted->push_back(std::move(it->second));
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = entries_.begin(); it != entries_.end() && entries_.size() > size;) {
+      evicted->push_back(std::move(it->second));
+      it = entries_.erase(it);
+    }
+  }
+
+  std::shared_mutex mutex_;
+  std::atomic<size_t> capacity_{0};
+  std::unordered_map<Key, std::shared_ptr<const Entry>, KeyHash> entries_;
+};
+
 // Hash handler that handles free vars
 // by assigning an unique counter in the order of their occurrence.
 //
@@ -61,6 +207,16 @@ class SHashHandlerDefault::Impl {
  public:
   explicit Impl(SHashHandlerDefault* parent) : parent_(parent) {}
 
+  /*! \brief The state of the handler when the children of a task are visited. */
+  struct CacheMark {
+    uint32_t free_var_counter{0};
+    uint32_t graph_node_counter{0};
+    uint64_t memo_seq{0};
+    size_t num_visited{0};
+    size_t definition_log_size{0};
+    size_t dependency_log_size{0};
+  };
+
   /*! \brief Pending reduce tasks. */
   struct Task {
     /*!
@@ -79,6 +235,12 @@ class SHashHandlerDefault::Impl {
     bool graph_node_hash{false};
     /*! \brief whether to map the free variables. */
     bool map_free_vars;
+    /*! \brief Whether the hash depends on free vars or graph nodes. */
+    bool context_dependent{false};
+    /*! \brief Whether the object is a free var. */
+    bool free_var{false};
+    /*! \brief The state of the handler when the children are expanded, to cache the subtree. */
+    CacheMark cache_mark;
 
     Task() = default;
     explicit Task(ObjectRef object, uint64_t reduced_hash, bool map_free_vars)
@@ -94,7 +256,7 @@ class SHashHandlerDefault::Impl {
   bool LookupHashedValue(const ObjectRef& key, uint64_t* hash_value) {
     auto it = hash_memo_.find(key);
     if (it != hash_memo_.end()) {
-      hash_value[0] = it->second;
+      hash_value[0] = it->second.hash;
       return true;
     }
     return false;
@@ -106,6 +268,9 @@ class SHashHandlerDefault::Impl {
 
   void SHashReduceFreeVar(const runtime::Object* var, bool map_free_vars) {
     ICHECK(!hash_memo_.count(GetRef<ObjectRef>(var)));
+    // The free var is the object being dispatched.
+    ICHECK(!allow_push_to_stack_ && !task_stack_.empty());
+    task_stack_.back().free_var = true;
     if (map_free_vars) {
       // use counter value.
       uint64_t value = std::hash<uint64_t>()(free_var_counter_++);
@@ -127,7 +292,9 @@ class SHashHandlerDefault::Impl {
     }
     auto it = hash_memo_.find(object);
     if (it != hash_memo_.end()) {
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), it->second, false));
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), it->second.hash, false));
+      pending_tasks_.back().context_dependent = it->second.context_dependent;
+      this->LogDependency(object, it->second);
     } else {
       // Push a pending task with initial value.
       pending_tasks_.emplace_back(Task(object, object->GetTypeKeyHash(), map_free_vars));
@@ -139,6 +306,12 @@ class SHashHandlerDefault::Impl {
     ICHECK_EQ(pending_tasks_.size(), 0U);
     ICHECK_EQ(result_stack_.size(), 0U);
 
+    StructuralHashCacheImpl* cache = StructuralHashCacheImpl::Global();
+    if (cache->enabled()) {
+      cache_ = cache;
+      handler_type_ = typeid(*parent_).hash_code();
+    }
+
     this->SHashReduce(object, map_free_vars);
     ICHECK_EQ(pending_tasks_.size(), 1U);
     ICHECK(allow_push_to_stack_);
@@ -148,7 +321,7 @@ class SHashHandlerDefault::Impl {
     this->RunTasks();
 
     ICHECK_EQ(result_stack_.size(), 1U);
-    uint64_t ret = result_stack_.back();
+    uint64_t ret = result_stack_.back().hash;
     result_stack_.pop_back();
     return ret;
   }
@@ -159,30 +332,126 @@ class SHashHandlerDefault::Impl {
   }
 
  protected:
+  /*! \brief The hash of a visited object. */
+  struct MemoEntry {
+    uint64_t hash;
+    /*! \brief Whether the hash depends on free vars or graph nodes. */
+    bool context_dependent;
+    /*! \brief The order of the entry, to tell the objects visited before a subtree. */
+    uint64_t seq;
+  };
+  /*! \brief A reduced hash in the result stack. */
+  struct Result {
+    uint64_t hash;
+    bool context_dependent;
+  };
+  /*! \brief A memo entry of a free var, or that a subtree depends on, used by the cache. */
+  struct MemoRecord {
+    ObjectRef object;
+    uint64_t hash;
+    uint64_t seq;
+  };
+
   /*!
    * \brief Pop the top entry of the task stack and push the hash into the result stack.
    */
   void PopTaskStack() {
     const auto& entry = task_stack_.back();
-    result_stack_.push_back(entry.reduced_hash);
+    result_stack_.push_back(Result{entry.reduced_hash, entry.context_dependent});
     task_stack_.pop_back();
   }
   /*!
    * \brief Compute the reduced hash value for the task.
    * \param task The indicated task.
    */
-  uint64_t ReduceHash(const Task& task) {
-    uint64_t stack_begin = task.result_stack_index;
+  uint64_t ReduceHash(Task* task) {
+    uint64_t stack_begin = task->result_stack_index;
     ICHECK_LE(stack_begin, result_stack_.size());
 
     // combine in the reverse order of the stack.
-    uint64_t reduced_hash = task.reduced_hash;
+    uint64_t reduced_hash = task->reduced_hash;
     for (uint32_t i = result_stack_.size(); i != stack_begin; --i) {
-      reduced_hash = support::HashCombine(reduced_hash, result_stack_[i - 1]);
+      reduced_hash = support::HashCombine(reduced_hash, result_stack_[i - 1].hash);
+      task->context_dependent |= result_stack_[i - 1].context_dependent;
     }
     result_stack_.resize(stack_begin);
     return reduced_hash;
   }
+  /*! \brief Record that the subtrees being visited depend on a context dependent object. */
+  void LogDependency(const ObjectRef& object, const MemoEntry& memo) {
+    if (cache_ != nullptr && memo.context_dependent) {
+      dependency_log_.push_back(MemoRecord{object, memo.hash, memo.seq});
+    }
+  }
+  /*! \brief The state of the handler before the children of a task are visited. */
+  CacheMark MarkCache() const {
+    return CacheMark{free_var_counter_, graph_node_counter_, memo_seq_, num_visited_,
+                     definition_log_.size(), dependency_log_.size()};
+  }
+  /*!
+   * \brief Reuse the cached hash of the task's subtree if it is valid in this hash.
+   * \return Whether the hash is reused.
+   */
+  bool LookupCache(Task* task) {
+    std::shared_ptr<const StructuralHashCacheImpl::Entry> entry =
+        cache_->Lookup(task->object.get(), handler_type_, task->map_free_vars);
+    if (entry == nullptr) return false;
+    if (entry->num_mapped_free_vars != 0 && entry->free_var_counter_begin != free_var_counter_) {
+      return false;
+    }
+    for (const auto& kv : entry->dependencies) {
+      auto it = hash_memo_.find(kv.first);
+      if (it == hash_memo_.end() || it->second.hash != kv.second) return false;
+    }
+    for (const auto& kv : entry->definitions) {
+      if (hash_memo_.count(kv.first)) return false;
+    }
+    cache_->hits.fetch_add(1, std::memory_order_relaxed);
+    for (const auto& kv : entry->dependencies) {
+      this->LogDependency(kv.first, hash_memo_.at(kv.first));
+    }
+    for (const auto& kv : entry->definitions) {
+      hash_memo_[kv.first] = MemoEntry{kv.second, true, memo_seq_};
+      definition_log_.push_back(MemoRecord{kv.first, kv.second, memo_seq_++});
+    }
+    free_var_counter_ += entry->num_mapped_free_vars;
+    num_visited_ += entry->num_nodes;
+    hash_memo_[task->object] = MemoEntry{entry->hash, entry->context_dependent, memo_seq_++};
+    task->reduced_hash = entry->hash;
+    task->context_dependent = entry->context_dependent;
+    return true;
+  }
+  /*! \brief Cache the hash of the visited subtree of the task if it is large enough. */
+  void InsertCache(const Task& task) {
+    const CacheMark& mark = task.cache_mark;
+    size_t num_nodes = num_visited_ - mark.num_visited;
+    // The hash of the graph nodes depends on their order in the whole tree.
+    if (num_nodes < StructuralHashCacheImpl::kMinSubtreeSize ||
+        graph_node_counter_ != mark.graph_node_counter || task.object->IsInstance<IRModuleNode>()) {
+      return;
+    }
+    cache_->misses.fetch_add(1, std::memory_order_relaxed);
+    auto entry = std::make_shared<StructuralHashCacheImpl::Entry>();
+    for (size_t i = mark.dependency_log_size; i < dependency_log_.size(); ++i) {
+      if (dependency_log_[i].seq < mark.memo_seq) {
+        entry->dependencies.emplace_back(dependency_log_[i].object, dependency_log_[i].hash);
+      }
+    }
+    for (size_t i = mark.definition_log_size; i < definition_log_.size(); ++i) {
+      entry->definitions.emplace_back(definition_log_[i].object, definition_log_[i].hash);
+    }
+    if (entry->dependencies.size() + entry->definitions.size() >
+        StructuralHashCacheImpl::kMaxReplaySize) {
+      return;
+    }
+    entry->object = task.object;
+    entry->hash = task.reduced_hash;
+    entry->context_dependent = task.context_dependent;
+    entry->num_nodes = num_nodes;
+    entry->free_var_counter_begin = mark.free_var_counter;
+    entry->num_mapped_free_vars = free_var_counter_ - mark.free_var_counter;
+    cache_->Insert(handler_type_, task.map_free_vars, std::move(entry));
+  }
   // run the tasks.
   void RunTasks() {
     while (task_stack_.size() != 0) {
@@ -190,13 +459,14 @@ class SHashHandlerDefault::Impl {
       auto& entry = task_stack_.back();
       if (entry.children_expanded) {
         // reduce hash
-        entry.reduced_hash = ReduceHash(entry);
+        entry.reduced_hash = ReduceHash(&entry);
         // When all the children has expanded and visited.
         // entry.reduced_hash contains the reduced hash result.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
           // use the pre-computed hash for the object.
-          entry.reduced_hash = it->second;
+          entry.reduced_hash = it->second.hash;
+          entry.context_dependent = it->second.context_dependent;
         } else {
           // Append the graph node counter to the hash
           // so that we can distinguish DAG from trees.
@@ -204,7 +474,16 @@ class SHashHandlerDefault::Impl {
             entry.reduced_hash = support::HashCombine(entry.reduced_hash,
                                                       std::hash<uint64_t>()(graph_node_counter_++));
           }
-          hash_memo_[entry.object] = entry.reduced_hash;
+          entry.context_dependent |= entry.graph_node_hash || entry.free_var;
+          hash_memo_[entry.object] =
+              MemoEntry{entry.reduced_hash, entry.context_dependent, memo_seq_};
+          if (cache_ != nullptr) {
+            if (entry.free_var) {
+              definition_log_.push_back(MemoRecord{entry.object, entry.reduced_hash, memo_seq_});
+            }
+            this->InsertCache(entry);
+          }
+          ++memo_seq_;
         }
         // send value to parent.
         this->PopTaskStack();
@@ -215,13 +494,21 @@ class SHashHandlerDefault::Impl {
         // check if there are already hash for object.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
-          entry.reduced_hash = it->second;
+          entry.reduced_hash = it->second.hash;
+          entry.context_dependent = it->second.context_dependent;
+          this->LogDependency(entry.object, it->second);
+          this->PopTaskStack();
+        } else if (cache_ != nullptr && this->LookupCache(&entry)) {
           this->PopTaskStack();
         } else {
           // NOTE: important to modify entry before visit.
           // as entry becomes invalid after we change the stack.
           entry.children_expanded = true;
           entry.result_stack_index = result_stack_.size();
+          if (cache_ != nullptr) {
+            entry.cache_mark = this->MarkCache();
+            ++num_visited_;
+          }
 
           ICHECK_EQ(pending_tasks_.size(), 0U);
           allow_push_to_stack_ = false;
@@ -252,11 +539,23 @@ class SHashHandlerDefault::Impl {
   // Internal task stack to executed the task
   std::vector<Task> task_stack_;
   // Internal stack to store the result popped from the task stack.
-  std::vector<uint64_t> result_stack_;
+  std::vector<Result> result_stack_;
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
-  std::unordered_map<ObjectRef, uint64_t, ObjectPtrHash, ObjectPtrEqual> hash_memo_;
+  std::unordered_map<ObjectRef, MemoEntry, ObjectPtrHash, ObjectPtrEqual> hash_memo_;
+  // the number of entries added to the memo.
+  uint64_t memo_seq_{0};
+  // the subtree cache, nullptr when it is disabled.
+  StructuralHashCacheImpl* cache_{nullptr};
+  // the type of the handler, as the handler can customize the hash of the objects.
+  size_t handler_type_{0};
+  // the number of the visited objects, with the ones of the reused subtrees.
+  size_t num_visited_{0};
+  // the free vars visited in this hash, in order.
+  std::vector<MemoRecord> definition_log_;
+  // the context dependent memo entries reused in this hash, in order.
+  std::vector<MemoRecord> dependency_log_;
 };
 
 SHashHandlerDefault::SHashHandlerDefault() { impl = new Impl(this); }
@@ -294,6 +593,24 @@ TVM_REGISTER_GLOBAL("node.StructuralHash")
       return static_cast<int64_t>(hashed_value);
     });
 
+void StructuralHashCache::SetCapacity(size_t capacity) {
+  StructuralHashCacheImpl::Global()->SetCapacity(capacity);
+}
+
+void StructuralHashCache::Clear() { StructuralHashCacheImpl::Global()->Clear(); }
+
+TVM_REGISTER_GLOBAL("node.StructuralHashCacheSetCapacity").set_body_typed([](int64_t capacity) {
+  CHECK_GE(capacity, 0) << "ValueError: The capacity of the structural hash cache should be "
+                        << "non-negative, but got " << capacity;
+  StructuralHashCache::SetCapacity(capacity);
+});
+
+TVM_REGISTER_GLOBAL("node.StructuralHashCacheClear").set_body_typed(StructuralHashCache::Clear);
+
+TVM_REGISTER_GLOBAL("node.StructuralHashCacheStats").set_body_typed([]() {
+  return StructuralHashCacheImpl::Global()->GetStats();
+});
+
 uint64_t StructuralHash::operator()(const ObjectRef& object) const {
   return SHashHandlerDefault().Hash(object, false);
 }
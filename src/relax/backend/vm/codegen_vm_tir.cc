@@ -23,6 +23,7 @@
  */
 #include <tvm/driver/driver_api.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relax/exec_builder.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/op_attr_types.h>
@@ -36,12 +37,21 @@
 #include <cctype>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "../../../target/source/codegen_source_base.h"
+
 namespace tvm {
 namespace relax {
 namespace relax_vm {
 
+// Defined in codegen_vm.cc, shared with the bytecode codegen.
+FCallPacked GetPackedFuncName(const Call& call);
+
+// The default execution mode of relax.build, "bytecode" or "compiled".
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.vm.exec_mode", String);
+
 using vm::VMFuncInfo;
 
 /*!
@@ -232,7 +242,14 @@ class CodeGenVMTIR : public ExprFunctor<Optional<PrimExpr>(const Expr&)> {
     }
     int64_t dst_reg = HasVoidStructInfo(call) ? -1 : NewRegister();
     if (call->op.as<OpNode>()) {
-      if (call_node->op == call_builtin_with_ctx_op_) {
+      // special case generate for the intrinsics whose attribute fields
+      // cannot be represented by args in the CallNode
+      FCallPacked name = GetPackedFuncName(call);
+      if (!name.empty()) {
+        // If the operator has a registered packed function implementation, emit call to that packed
+        // function.
+        this->EmitCallPacked(name, VisitArray(call_node->args), dst_reg);
+      } else if (call_node->op == call_builtin_with_ctx_op_) {
         EmitCallBuiltinWithCtx(call, dst_reg);
       } else if (call_node->op == alloc_storage_op_) {
         EmitAllocStorage(call, dst_reg);
@@ -265,13 +282,16 @@ class CodeGenVMTIR : public ExprFunctor<Optional<PrimExpr>(const Expr&)> {
                            tir::Call(DataType::Int(32), tir::builtin::tvm_call_packed(),
                                      {tir::StringImm("vm.builtin.read_if_cond"), cond_value}));
 
+    // A branch that ends with a call returning void leaves the merge register as null.
     tir::Stmt true_branch = WithNewScope([&]() {
-      PrimExpr true_value = this->VisitExpr(op->true_branch).value();
-      this->EmitCallPacked("vm.builtin.copy", {true_value}, merge_register);
+      if (Optional<PrimExpr> true_value = this->VisitExpr(op->true_branch)) {
+        this->EmitCallPacked("vm.builtin.copy", {true_value.value()}, merge_register);
+      }
     });
     tir::Stmt false_branch = WithNewScope([&]() {
-      PrimExpr false_value = this->VisitExpr(op->false_branch).value();
-      this->EmitCallPacked("vm.builtin.copy", {false_value}, merge_register);
+      if (Optional<PrimExpr> false_value = this->VisitExpr(op->false_branch)) {
+        this->EmitCallPacked("vm.builtin.copy", {false_value.value()}, merge_register);
+      }
     });
     this->EmitStmt(tir::IfThenElse(cond_value, true_branch, false_branch));
     return RegListGet(merge_register);
@@ -390,10 +410,27 @@ class CodeGenVMTIR : public ExprFunctor<Optional<PrimExpr>(const Expr&)> {
   }
 
   Optional<PrimExpr> VisitExpr_(const ExternFuncNode* op) final {
+    ImportCSource(op);
     builder_->DeclareFunction(op->global_symbol, VMFuncInfo::FuncKind::kPackedFunc);
     return FuncListGet(builder_->GetFunction(op->global_symbol).value());
   }
 
+  /*! \brief Import the C source module attached to the extern function, if any. */
+  void ImportCSource(const ExternFuncNode* op) {
+    static const constexpr char* kCSource = "c_source";
+    static const constexpr char* kCSourceFmt = "c_source_fmt";
+    if (!imported_c_source_.insert(op->global_symbol).second) return;
+    if (Optional<String> opt_code = op->attrs.GetAttr<String>(kCSource)) {
+      String sym = op->global_symbol;
+      String fmt = op->attrs.GetAttr<String>(kCSourceFmt).value_or("c");
+      String code = opt_code.value();
+      runtime::Module c_source_module =
+          codegen::CSourceModuleCreate(/*code=*/code, /*fmt=*/fmt, /*func_names=*/{sym},
+                                       /*const_vars=*/{});
+      builder_->exec()->Import(c_source_module);
+    }
+  }
+
   void EmitAllocStorage(const Call& call_node, int64_t dst_reg) {
     // Handle args of the call
     Array<PrimExpr> args;
@@ -456,6 +493,9 @@ class CodeGenVMTIR : public ExprFunctor<Optional<PrimExpr>(const Expr&)> {
     // Do call closure to be safe.
     VMFuncInfo::FuncKind kind;
     auto symbol = LookupFunction(call_node->op, &kind);
+    if (auto* ext_func = call_node->op.as<ExternFuncNode>()) {
+      ImportCSource(ext_func);
+    }
 
     if (symbol.defined() && kind == VMFuncInfo::FuncKind::kPackedFunc) {
       // primfunc in the same module.
@@ -516,6 +556,8 @@ class CodeGenVMTIR : public ExprFunctor<Optional<PrimExpr>(const Expr&)> {
   IRModule ctx_mod_;
   /*! \brief system lib prefix */
   Optional<String> system_lib_prefix_;
+  /*! \brief The extern functions whose C source has been imported. */
+  std::unordered_set<String> imported_c_source_;
   /*! \brief Cache ops that need to be frequently used later to reduce lookup overhead. */
   const Op& alloc_storage_op_ = Op::Get("relax.vm.alloc_storage");
   const Op& alloc_tensor_op_ = Op::Get("relax.vm.alloc_tensor");
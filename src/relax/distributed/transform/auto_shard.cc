@@ -0,0 +1,535 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform/auto_shard.cc
+ * \brief Pass for choosing the sharding of the parameters with a cost model.
+ */
+#include <tvm/relax/attrs/statistical.h>
+#include <tvm/relax/distributed/axis_group_graph.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/utils.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+#include "../../op/distributed/distributed.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+/*!
+ * \brief Estimate the time a sharding plan takes to run a function, from the sharding specs
+ *        propagated in an axis group graph.
+ *
+ * The time is the sum of the compute time of each operator on one device, and of the time of the
+ * collective communication the plan requires:
+ * - An operator sharded along a mesh axis computes 1/n of its output on each device.
+ * - An input sharded along its reduction axis (the K axis of matmul, or a reduced axis of sum,
+ *   mean, max, min and prod) while the output is not produces partial results, which are
+ *   allreduced along the mesh axis.
+ * - Any other input sharded along a mesh axis the output is not sharded along is allgathered.
+ * - The sharded outputs of the function are allgathered.
+ * Each collective is assumed to be a ring collective over the links of the mesh axis. Symbolic
+ * dimensions count as 1.
+ */
+class ShardingCostEstimator : public ExprVisitor {
+ public:
+  /*!
+   * \brief Estimate the time of a function of the given parameters and body.
+   * \return The estimated time in seconds, or infinity if the plan is not legal, i.e. a tensor
+   *         has two axes sharded along the same mesh axis, a static axis is not divisible by the
+   *         mesh axis it is sharded along, or a constant is sharded.
+   */
+  static double Estimate(const Array<Var>& params, const Expr& body,
+                         AxisGroupGraph* axis_group_graph,
+                         const DeviceMesh& device_mesh, double device_flops,
+                         double link_bandwidth) {
+    ShardingCostEstimator estimator(axis_group_graph, device_mesh, device_flops, link_bandwidth);
+    for (const Var& param : params) {
+      if (const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(param)) {
+        estimator.GetShardedDims(param, GetRef<TensorStructInfo>(sinfo));
+      }
+    }
+    estimator.VisitExpr(body);
+    if (!estimator.legal_) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return estimator.compute_time_ + estimator.comm_time_;
+  }
+
+ private:
+  using ExprVisitor::VisitExpr_;
+
+  ShardingCostEstimator(AxisGroupGraph* axis_group_graph, DeviceMesh device_mesh,
+                        double device_flops, double link_bandwidth)
+      : axis_group_graph_(axis_group_graph),
+        device_mesh_(device_mesh),
+        device_flops_(device_flops),
+        link_bandwidth_(link_bandwidth) {}
+
+  static double NumElements(const TensorStructInfo& sinfo) {
+    double num_elements = 1;
+    if (const auto* shape = sinfo->shape.as<ShapeExprNode>()) {
+      for (const PrimExpr& dim : shape->values) {
+        if (const auto* int_dim = dim.as<IntImmNode>()) {
+          num_elements *= int_dim->value;
+        }
+      }
+    }
+    return num_elements;
+  }
+
+  static double NumBytes(const TensorStructInfo& sinfo) {
+    // Tensors of unknown dtype are assumed to be of 4-byte elements.
+    double elem_bytes =
+        sinfo->dtype.is_void() ? 4 : sinfo->dtype.bits() * sinfo->dtype.lanes() / 8.0;
+    return NumElements(sinfo) * elem_bytes;
+  }
+
+  int MeshAxisSize(int mesh_axis) const { return device_mesh_->shape[mesh_axis]; }
+
+  /*!
+   * \brief Get the tensor dim sharded along each mesh axis, -1 for replicated, and check that
+   *        the sharding is legal.
+   */
+  std::vector<int> GetShardedDims(const Expr& tensor, const TensorStructInfo& sinfo,
+                                  int tuple_index = 0) {
+    std::vector<int> sharded_dims(device_mesh_->shape.size(), -1);
+    const auto* shape = sinfo->shape.as<ShapeExprNode>();
+    for (int i = 0; i < sinfo->ndim; i++) {
+      AxisShardingSpec sharding_spec;
+      bool has_sharding_spec;
+      std::tie(sharding_spec, has_sharding_spec) =
+          axis_group_graph_->GetAxisShardingSpec({tensor.get(), i, tuple_index});
+      if (!has_sharding_spec) {
+        continue;
+      }
+      int mesh_axis = sharding_spec.second;
+      if (tensor->IsInstance<ConstantNode>() || sharded_dims[mesh_axis] != -1) {
+        legal_ = false;
+        continue;
+      }
+      sharded_dims[mesh_axis] = i;
+      if (shape) {
+        if (const auto* int_dim = shape->values[i].as<IntImmNode>()) {
+          if (int_dim->value % MeshAxisSize(mesh_axis) != 0) {
+            legal_ = false;
+          }
+        }
+      }
+    }
+    return sharded_dims;
+  }
+
+  double LocalBytes(const TensorStructInfo& sinfo, const std::vector<int>& sharded_dims) const {
+    double num_bytes = NumBytes(sinfo);
+    for (int mesh_axis = 0; mesh_axis < static_cast<int>(sharded_dims.size()); mesh_axis++) {
+      if (sharded_dims[mesh_axis] != -1) {
+        num_bytes /= MeshAxisSize(mesh_axis);
+      }
+    }
+    return num_bytes;
+  }
+
+  /*! \brief Whether the dim of the given input is reduced by the call. */
+  static bool IsReductionDim(const Call& call, int arg_index, int dim, int ndim) {
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    if (call->op.same_as(matmul_op)) {
+      if (arg_index == 0) {
+        return dim == ndim - 1;
+      }
+      return dim == std::max(ndim - 2, 0);
+    }
+    static const std::vector<Op> reduction_ops = {Op::Get("relax.sum"), Op::Get("relax.mean"),
+                                                  Op::Get("relax.max"), Op::Get("relax.min"),
+                                                  Op::Get("relax.prod")};
+    for (const Op& reduction_op : reduction_ops) {
+      if (!call->op.same_as(reduction_op)) {
+        continue;
+      }
+      const auto* attrs = call->attrs.as<StatisticalAttrs>();
+      ICHECK(attrs);
+      if (!attrs->axis.defined()) {
+        return true;
+      }
+      for (const Integer& axis : attrs->axis.value()) {
+        int reduced_dim = axis->value >= 0 ? axis->value : axis->value + ndim;
+        if (reduced_dim == dim) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* val) final {
+    static const Op& annotate_sharding_op = Op::Get("relax.dist.annotate_sharding");
+    Call call = GetRef<Call>(val);
+    if (call->op.same_as(annotate_sharding_op)) {
+      GetShardedDims(binding->var, Downcast<TensorStructInfo>(GetStructInfo(binding->var)));
+      return;
+    }
+    std::vector<TensorStructInfo> output_sinfos;
+    if (const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(binding->var)) {
+      output_sinfos.push_back(GetRef<TensorStructInfo>(tensor_sinfo));
+    } else if (const auto* tuple_sinfo = GetStructInfoAs<TupleStructInfoNode>(binding->var)) {
+      for (const StructInfo& field : tuple_sinfo->fields) {
+        if (const auto* tensor_sinfo = field.as<TensorStructInfoNode>()) {
+          output_sinfos.push_back(GetRef<TensorStructInfo>(tensor_sinfo));
+        }
+      }
+    }
+    if (output_sinfos.empty()) {
+      ExprVisitor::VisitBinding_(binding, val);
+      return;
+    }
+
+    std::vector<int> output_sharded_dims;
+    double flops = 0;
+    for (int i = 0; i < static_cast<int>(output_sinfos.size()); i++) {
+      std::vector<int> sharded_dims = GetShardedDims(binding->var, output_sinfos[i], i);
+      if (i == 0) {
+        output_sharded_dims = sharded_dims;
+      }
+      flops += NumElements(output_sinfos[i]);
+    }
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    if (call->op.same_as(matmul_op)) {
+      const auto* lhs_sinfo = GetStructInfoAs<TensorStructInfoNode>(call->args[0]);
+      const auto* lhs_shape = lhs_sinfo ? lhs_sinfo->shape.as<ShapeExprNode>() : nullptr;
+      if (lhs_shape && !lhs_shape->values.empty()) {
+        if (const auto* k = lhs_shape->values.back().as<IntImmNode>()) {
+          flops *= 2 * k->value;
+        }
+      }
+    }
+
+    std::vector<bool> partial(device_mesh_->shape.size(), false);
+    Array<Expr> args = GetCallArgs(call);
+    for (int arg_index = 0; arg_index < static_cast<int>(args.size()); arg_index++) {
+      const Expr& arg = args[arg_index];
+      const auto* arg_sinfo = GetStructInfoAs<TensorStructInfoNode>(arg);
+      if (!arg_sinfo || (!arg->IsInstance<VarNode>() && !arg->IsInstance<ConstantNode>())) {
+        continue;
+      }
+      std::vector<int> sharded_dims = GetShardedDims(arg, GetRef<TensorStructInfo>(arg_sinfo));
+      for (int mesh_axis = 0; mesh_axis < static_cast<int>(sharded_dims.size()); mesh_axis++) {
+        if (sharded_dims[mesh_axis] == -1 || output_sharded_dims[mesh_axis] != -1) {
+          continue;
+        }
+        if (IsReductionDim(call, arg_index, sharded_dims[mesh_axis], arg_sinfo->ndim)) {
+          partial[mesh_axis] = true;
+        } else {
+          // Ring allgather: each device receives the n - 1 shards it does not own.
+          comm_time_ += (MeshAxisSize(mesh_axis) - 1) *
+                        LocalBytes(GetRef<TensorStructInfo>(arg_sinfo), sharded_dims) /
+                        link_bandwidth_;
+        }
+      }
+    }
+
+    double local_flops = flops;
+    for (int mesh_axis = 0; mesh_axis < static_cast<int>(partial.size()); mesh_axis++) {
+      if (output_sharded_dims[mesh_axis] != -1 || partial[mesh_axis]) {
+        local_flops /= MeshAxisSize(mesh_axis);
+      }
+      if (partial[mesh_axis]) {
+        // Ring allreduce: a reduce-scatter and an allgather of the local output.
+        int n = MeshAxisSize(mesh_axis);
+        comm_time_ += 2.0 * (n - 1) / n * LocalBytes(output_sinfos[0], output_sharded_dims) /
+                      link_bandwidth_;
+      }
+    }
+    compute_time_ += local_flops / device_flops_;
+    ExprVisitor::VisitBinding_(binding, val);
+  }
+
+  void VisitExpr_(const SeqExprNode* op) final {
+    ExprVisitor::VisitExpr_(op);
+    Array<Expr> outputs;
+    if (const auto* tuple = op->body.as<TupleNode>()) {
+      outputs = tuple->fields;
+    } else {
+      outputs.push_back(op->body);
+    }
+    for (const Expr& output : outputs) {
+      const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(output);
+      if (!sinfo || !output->IsInstance<VarNode>()) {
+        continue;
+      }
+      std::vector<int> sharded_dims = GetShardedDims(output, GetRef<TensorStructInfo>(sinfo));
+      for (int mesh_axis = 0; mesh_axis < static_cast<int>(sharded_dims.size()); mesh_axis++) {
+        if (sharded_dims[mesh_axis] != -1) {
+          comm_time_ += (MeshAxisSize(mesh_axis) - 1) *
+                        LocalBytes(GetRef<TensorStructInfo>(sinfo), sharded_dims) /
+                        link_bandwidth_;
+        }
+      }
+    }
+  }
+
+  AxisGroupGraph* axis_group_graph_;
+  DeviceMesh device_mesh_;
+  double device_flops_;
+  double link_bandwidth_;
+  double compute_time_ = 0;
+  double comm_time_ = 0;
+  bool legal_ = true;
+};
+
+/*!
+ * \brief Choose the sharding of the parameters of a function, and annotate them.
+ *
+ * A sharding annotation of a parameter axis propagates to every tensor axis of its group in the
+ * axis group graph, so the plan chooses, for each group containing a weight axis, the mesh axis
+ * it is sharded along, if any. Starting from the replicated plan, the plan repeatedly takes the
+ * change of the mesh axis of one group that most reduces the time ShardingCostEstimator
+ * estimates, until no change reduces it.
+ */
+class ShardingPlanner {
+ public:
+  ShardingPlanner(IRModule mod, DeviceMesh device_mesh, double device_flops,
+                  double link_bandwidth)
+      : mod_(mod),
+        device_mesh_(device_mesh),
+        device_flops_(device_flops),
+        link_bandwidth_(link_bandwidth) {}
+
+  Function Plan(const Function& func) {
+    // Step 1. Annotate each tensor parameter, so that the plan is evaluated on the same axis
+    // group graph as PropagateSharding builds from the annotated function.
+    Map<Var, Expr> param_remap;
+    // Without "num_input", every parameter may be a weight.
+    int num_input = 0;
+    if (auto opt = func->attrs.GetAttr<Integer>(attr::kNumInput)) {
+      num_input = opt.value()->value;
+    }
+    std::vector<Var> weights;
+    for (int i = 0; i < static_cast<int>(func->params.size()); i++) {
+      const Var& param = func->params[i];
+      if (!GetStructInfoAs<TensorStructInfoNode>(param)) {
+        continue;
+      }
+      Var annotated(param->name_hint(), GetStructInfo(param));
+      params_.push_back(param);
+      annotated_params_.push_back(annotated);
+      param_remap.Set(param, annotated);
+      if (i >= num_input) {
+        weights.push_back(annotated);
+      }
+    }
+    if (params_.empty()) {
+      return func;
+    }
+    body_ = Downcast<SeqExpr>(Bind(func->body, param_remap));
+    Function annotated_func = WithAnnotations(func, std::vector<Placement>(params_.size()));
+    BuildAxisGroupGraph(&axis_group_graph_, annotated_func, mod_);
+
+    // Step 2. Find the groups of the weight axes.
+    std::vector<Axis> groups;
+    std::unordered_set<Axis, AxisHash> grouped_axes;
+    for (const Var& weight : weights) {
+      int ndim = GetStructInfoAs<TensorStructInfoNode>(weight)->ndim;
+      for (int dim = 0; dim < ndim; dim++) {
+        Axis axis(weight.get(), dim);
+        if (grouped_axes.count(axis)) {
+          continue;
+        }
+        AxisGroupGraph graph = axis_group_graph_;
+        graph.AddSrcShardingPoint(axis, {device_mesh_, 0});
+        if (!Propagate(&graph)) {
+          continue;
+        }
+        for (const Var& other : weights) {
+          int other_ndim = GetStructInfoAs<TensorStructInfoNode>(other)->ndim;
+          for (int other_dim = 0; other_dim < other_ndim; other_dim++) {
+            if (std::get<1>(graph.GetAxisShardingSpec({other.get(), other_dim}))) {
+              grouped_axes.insert({other.get(), other_dim});
+            }
+          }
+        }
+        groups.push_back(axis);
+      }
+    }
+
+    // Step 3. Greedily shard the groups.
+    std::vector<int> mesh_axes(groups.size(), -1);
+    std::vector<Placement> placements;
+    double best_time = Estimate(groups, mesh_axes, &placements);
+    ICHECK(best_time < std::numeric_limits<double>::infinity());
+    while (true) {
+      std::vector<int> best_mesh_axes;
+      std::vector<Placement> best_placements;
+      for (int i = 0; i < static_cast<int>(groups.size()); i++) {
+        for (int mesh_axis = -1; mesh_axis < static_cast<int>(device_mesh_->shape.size());
+             mesh_axis++) {
+          if (mesh_axis == mesh_axes[i]) {
+            continue;
+          }
+          std::vector<int> candidate = mesh_axes;
+          candidate[i] = mesh_axis;
+          std::vector<Placement> candidate_placements;
+          double time = Estimate(groups, candidate, &candidate_placements);
+          if (time < best_time) {
+            best_time = time;
+            best_mesh_axes = candidate;
+            best_placements = candidate_placements;
+          }
+        }
+      }
+      if (best_mesh_axes.empty()) {
+        break;
+      }
+      mesh_axes = best_mesh_axes;
+      placements = best_placements;
+    }
+    return WithAnnotations(func, placements);
+  }
+
+ private:
+  /*! \brief Propagate the sharding specs, returning false on conflict. */
+  static bool Propagate(AxisGroupGraph* graph) {
+    try {
+      graph->PropagateShardingSpec();
+    } catch (const runtime::Error&) {
+      return false;
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Estimate the time of sharding each group along the given mesh axis, -1 for
+   *        replicated, and get the resulting placement of each parameter.
+   */
+  double Estimate(const std::vector<Axis>& groups, const std::vector<int>& mesh_axes,
+                  std::vector<Placement>* placements) {
+    // The annotations only mark the group sources as sharded, but every parameter is annotated
+    // with the placement the groups propagate to it. The plan is evaluated from these final
+    // annotations, which can propagate differently.
+    AxisGroupGraph group_graph = axis_group_graph_;
+    for (int i = 0; i < static_cast<int>(groups.size()); i++) {
+      if (mesh_axes[i] != -1) {
+        group_graph.AddSrcShardingPoint(groups[i], {device_mesh_, mesh_axes[i]});
+      }
+    }
+    if (!Propagate(&group_graph)) {
+      return std::numeric_limits<double>::infinity();
+    }
+    placements->clear();
+    AxisGroupGraph graph = axis_group_graph_;
+    for (const Var& annotated : annotated_params_) {
+      Array<PlacementSpec> placement_specs(
+          std::vector<PlacementSpec>(device_mesh_->shape.size(), PlacementSpec::Replica()));
+      int ndim = GetStructInfoAs<TensorStructInfoNode>(annotated)->ndim;
+      for (int dim = 0; dim < ndim; dim++) {
+        AxisShardingSpec sharding_spec;
+        bool has_sharding_spec;
+        std::tie(sharding_spec, has_sharding_spec) =
+            group_graph.GetAxisShardingSpec({annotated.get(), dim});
+        if (has_sharding_spec) {
+          placement_specs.Set(sharding_spec.second, PlacementSpec::Sharding(dim));
+          graph.AddSrcShardingPoint({annotated.get(), dim}, sharding_spec);
+        }
+      }
+      graph.AddSrcShardingPoint({annotated.get(), -1}, {device_mesh_, -1});
+      placements->push_back(Placement(placement_specs));
+    }
+    if (!Propagate(&graph)) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return ShardingCostEstimator::Estimate(params_, AnnotatedBody(*placements), &graph,
+                                           device_mesh_, device_flops_, link_bandwidth_);
+  }
+
+  /*!
+   * \brief Get the body of the function annotating each tensor parameter with the given
+   *        placement, or with a replicated placement if it is not defined.
+   */
+  SeqExpr AnnotatedBody(const std::vector<Placement>& placements) {
+    Array<Binding> bindings;
+    for (int i = 0; i < static_cast<int>(params_.size()); i++) {
+      Placement placement = placements[i];
+      if (!placement.defined()) {
+        placement = Placement(Array<PlacementSpec>(
+            std::vector<PlacementSpec>(device_mesh_->shape.size(), PlacementSpec::Replica())));
+      }
+      Expr annotation = annotate_sharding(params_[i], device_mesh_, placement);
+      UpdateStructInfo(annotation, GetStructInfo(params_[i]));
+      bindings.push_back(VarBinding(annotated_params_[i], annotation));
+    }
+    Array<BindingBlock> blocks{BindingBlock(bindings)};
+    blocks.insert(blocks.end(), body_->blocks.begin(), body_->blocks.end());
+    SeqExpr body(blocks, body_->body);
+    UpdateStructInfo(body, GetStructInfo(body_));
+    return body;
+  }
+
+  Function WithAnnotations(const Function& func, const std::vector<Placement>& placements) {
+    return Function(func->params, AnnotatedBody(placements), func->ret_struct_info, func->is_pure,
+                    func->attrs, func->span);
+  }
+
+  IRModule mod_;
+  DeviceMesh device_mesh_;
+  double device_flops_;
+  double link_bandwidth_;
+  /*! \brief The tensor parameters of the function and the annotated vars replacing them. */
+  Array<Var> params_;
+  std::vector<Var> annotated_params_;
+  /*! \brief The body of the function, reading the annotated vars. */
+  SeqExpr body_;
+  AxisGroupGraph axis_group_graph_;
+};
+
+namespace transform {
+
+Pass AutoShard(DeviceMesh device_mesh, double device_flops, double link_bandwidth) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    IRModule updates;
+    for (const auto& [gv, base_func] : mod->functions) {
+      const auto* func = base_func.as<FunctionNode>();
+      if (func == nullptr || func->HasNonzeroAttr(attr::kPrimitive) ||
+          IsShardingAnnotatedFunc(GetRef<Function>(func)) ||
+          IsDistIRFunc(GetRef<Function>(func))) {
+        continue;
+      }
+      ShardingPlanner planner(mod, device_mesh, device_flops, link_bandwidth);
+      updates->Add(gv, planner.Plan(GetRef<Function>(func)));
+    }
+    if (updates->functions.size()) {
+      mod.CopyOnWrite()->Update(updates);
+    }
+    return mod;
+  };
+  return CreateModulePass(pass_func, 1, "AutoShard", {});
+}
+TVM_REGISTER_GLOBAL("relax.distributed.transform.AutoShard").set_body_typed(AutoShard);
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
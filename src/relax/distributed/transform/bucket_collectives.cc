@@ -0,0 +1,436 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform/bucket_collectives.cc
+ * \brief Pass for fusing small independent collectives into bucketed collectives.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/ccl.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/utils.h>
+
+#include <queue>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../op/ccl/ccl.h"
+#include "../../op/tensor/manipulate.h"
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+/*!
+ * \brief Plan the bucketing and the order of the bindings of a dataflow block.
+ *
+ * A collective is a candidate for bucketing if it is an allreduce or an allgather of a tensor of
+ * static shape of at most max_bucket_bytes bytes. Candidates are, in order, added to the bucket
+ * of the same kind, reduction or number of workers, group of workers, and dtype, as long as the
+ * bucket stays under max_bucket_bytes and the candidate does not depend on the bucket, even
+ * through other buckets.
+ * The bindings are then scheduled in topological order, each bucket as soon as its inputs are
+ * ready, so that the collective can overlap with the independent compute scheduled after it, and
+ * the other bindings in their original order.
+ */
+class CollectiveBucketPlanner {
+ public:
+  /*! \brief A scheduled node: a binding, or a bucket of collective bindings. */
+  using Node = std::vector<int>;
+
+  CollectiveBucketPlanner(const Array<Binding>& bindings, int64_t max_bucket_bytes)
+      : bindings_(bindings), max_bucket_bytes_(max_bucket_bytes) {}
+
+  /*!
+   * \brief Plan the schedule of the bindings.
+   * \return The scheduled nodes, or an empty vector if no collectives are bucketed.
+   */
+  std::vector<Node> Plan() {
+    int num_bindings = bindings_.size();
+    std::unordered_map<const VarNode*, int> binding_index;
+    for (int i = 0; i < num_bindings; i++) {
+      binding_index[bindings_[i]->var.get()] = i;
+    }
+    deps_.resize(num_bindings);
+    int last_match_cast = -1;
+    for (int i = 0; i < num_bindings; i++) {
+      Expr value = GetBoundValue(bindings_[i]);
+      for (const Var& var : FreeVars(value)) {
+        auto it = binding_index.find(var.get());
+        if (it != binding_index.end()) {
+          deps_[i].push_back(it->second);
+        }
+      }
+      // The symbolic variables a match_cast defines may be used by any later binding.
+      if (last_match_cast != -1) {
+        deps_[i].push_back(last_match_cast);
+      }
+      if (bindings_[i]->IsInstance<MatchCastNode>()) {
+        last_match_cast = i;
+      }
+    }
+
+    // Step 1. Find the candidates and the candidates each binding depends on.
+    std::vector<int> candidate_index(num_bindings, -1);
+    for (int i = 0; i < num_bindings; i++) {
+      if (IsCandidate(bindings_[i])) {
+        candidate_index[i] = candidates_.size();
+        candidates_.push_back(i);
+      }
+    }
+    if (candidates_.size() < 2) {
+      return {};
+    }
+    int num_words = (candidates_.size() + 63) / 64;
+    std::vector<std::vector<uint64_t>> ancestors(num_bindings,
+                                                 std::vector<uint64_t>(num_words, 0));
+    for (int i = 0; i < num_bindings; i++) {
+      for (int dep : deps_[i]) {
+        for (int w = 0; w < num_words; w++) {
+          ancestors[i][w] |= ancestors[dep][w];
+        }
+        if (candidate_index[dep] != -1) {
+          ancestors[i][candidate_index[dep] / 64] |= uint64_t(1) << (candidate_index[dep] % 64);
+        }
+      }
+    }
+
+    // Step 2. Bucket the candidates.
+    std::vector<int> bucket_of(candidates_.size(), -1);
+    std::vector<std::vector<int>> buckets;
+    std::vector<std::vector<uint64_t>> bucket_ancestors;
+    std::vector<int64_t> bucket_bytes;
+    std::unordered_map<std::string, int> open_bucket;
+    auto get_bucket_deps = [&](const std::vector<uint64_t>& ancestor_bits) {
+      std::vector<int> deps;
+      for (int c = 0; c < static_cast<int>(candidates_.size()); c++) {
+        if ((ancestor_bits[c / 64] >> (c % 64)) & 1) {
+          deps.push_back(bucket_of[c]);
+        }
+      }
+      return deps;
+    };
+    for (int c = 0; c < static_cast<int>(candidates_.size()); c++) {
+      const Binding& binding = bindings_[candidates_[c]];
+      std::string key = BucketKey(binding);
+      int64_t num_bytes = NumBytes(binding);
+      auto it = open_bucket.find(key);
+      if (it != open_bucket.end() && bucket_bytes[it->second] + num_bytes <= max_bucket_bytes_ &&
+          !DependsOnBucket(get_bucket_deps(ancestors[candidates_[c]]), it->second, buckets,
+                           bucket_ancestors, get_bucket_deps)) {
+        int bucket = it->second;
+        buckets[bucket].push_back(candidates_[c]);
+        bucket_bytes[bucket] += num_bytes;
+        for (int w = 0; w < num_words; w++) {
+          bucket_ancestors[bucket][w] |= ancestors[candidates_[c]][w];
+        }
+        bucket_of[c] = bucket;
+      } else {
+        bucket_of[c] = buckets.size();
+        open_bucket[key] = buckets.size();
+        buckets.push_back({candidates_[c]});
+        bucket_ancestors.push_back(ancestors[candidates_[c]]);
+        bucket_bytes.push_back(num_bytes);
+      }
+    }
+    if (buckets.size() == candidates_.size()) {
+      return {};
+    }
+
+    // Step 3. Schedule the bindings and the buckets in topological order.
+    std::vector<Node> nodes;
+    std::vector<int> node_of(num_bindings, -1);
+    for (const std::vector<int>& bucket : buckets) {
+      for (int i : bucket) {
+        node_of[i] = nodes.size();
+      }
+      nodes.push_back(bucket);
+    }
+    for (int i = 0; i < num_bindings; i++) {
+      if (node_of[i] == -1) {
+        node_of[i] = nodes.size();
+        nodes.push_back({i});
+      }
+    }
+    std::vector<int> num_pending_deps(nodes.size(), 0);
+    std::vector<std::vector<int>> users(nodes.size());
+    for (int n = 0; n < static_cast<int>(nodes.size()); n++) {
+      std::unordered_set<int> node_deps;
+      for (int i : nodes[n]) {
+        for (int dep : deps_[i]) {
+          node_deps.insert(node_of[dep]);
+        }
+      }
+      for (int dep : node_deps) {
+        users[dep].push_back(n);
+      }
+      num_pending_deps[n] = node_deps.size();
+    }
+    // The collectives go first, then the other bindings in their original order.
+    using Priority = std::tuple<bool, int, int>;
+    auto priority = [&](int n) {
+      return Priority(!IsCollective(bindings_[nodes[n][0]]), nodes[n][0], n);
+    };
+    std::priority_queue<Priority, std::vector<Priority>, std::greater<Priority>> ready;
+    for (int n = 0; n < static_cast<int>(nodes.size()); n++) {
+      if (num_pending_deps[n] == 0) {
+        ready.push(priority(n));
+      }
+    }
+    std::vector<Node> schedule;
+    while (!ready.empty()) {
+      int n = std::get<2>(ready.top());
+      ready.pop();
+      schedule.push_back(nodes[n]);
+      for (int user : users[n]) {
+        if (--num_pending_deps[user] == 0) {
+          ready.push(priority(user));
+        }
+      }
+    }
+    ICHECK_EQ(schedule.size(), nodes.size()) << "InternalError: the buckets form a cycle";
+    return schedule;
+  }
+
+  /*! \return Whether the binding is an allreduce or an allgather. */
+  static bool IsCollective(const Binding& binding) {
+    static const Op& allreduce_op = Op::Get("relax.ccl.allreduce");
+    static const Op& allgather_op = Op::Get("relax.ccl.allgather");
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (!var_binding) {
+      return false;
+    }
+    const auto* call = var_binding->value.as<CallNode>();
+    return call && (call->op.same_as(allreduce_op) || call->op.same_as(allgather_op));
+  }
+
+  /*! \return The number of elements of the static shape of the tensor, or -1. */
+  static int64_t NumElements(const Expr& tensor) {
+    const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(tensor);
+    if (!sinfo || sinfo->IsUnknownDtype()) {
+      return -1;
+    }
+    const auto* shape = sinfo->shape.as<ShapeExprNode>();
+    if (!shape) {
+      return -1;
+    }
+    int64_t num_elements = 1;
+    for (const PrimExpr& dim : shape->values) {
+      const auto* int_dim = dim.as<IntImmNode>();
+      if (!int_dim) {
+        return -1;
+      }
+      num_elements *= int_dim->value;
+    }
+    return num_elements;
+  }
+
+ private:
+  static Call GetCall(const Binding& binding) {
+    return Downcast<Call>(Downcast<VarBinding>(binding)->value);
+  }
+
+  int64_t NumBytes(const Binding& binding) const {
+    Expr input = GetCall(binding)->args[0];
+    DataType dtype = GetStructInfoAs<TensorStructInfoNode>(input)->dtype;
+    return NumElements(input) * ((dtype.bits() * dtype.lanes() + 7) / 8);
+  }
+
+  bool IsCandidate(const Binding& binding) const {
+    if (!IsCollective(binding)) {
+      return false;
+    }
+    Call call = GetCall(binding);
+    if (NumElements(call->args[0]) < 0 || NumBytes(binding) > max_bucket_bytes_) {
+      return false;
+    }
+    if (call->args.size() > 1) {
+      // The number of workers of allgather must be static to split the gathered buffer.
+      const auto* num_workers = call->args[1].as<PrimValueNode>();
+      if (!num_workers || !num_workers->value->IsInstance<IntImmNode>()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The collectives of the same key can be bucketed. */
+  static std::string BucketKey(const Binding& binding) {
+    Call call = GetCall(binding);
+    std::ostringstream os;
+    os << Downcast<Op>(call->op)->name << ","
+       << GetStructInfoAs<TensorStructInfoNode>(call->args[0])->dtype;
+    if (const auto* attrs = call->attrs.as<AllReduceAttrs>()) {
+      os << "," << attrs->op_type << "," << attrs->group;
+    }
+    if (const auto* attrs = call->attrs.as<AllGatherAttrs>()) {
+      os << "," << attrs->group;
+    }
+    if (call->args.size() > 1) {
+      os << "," << Downcast<IntImm>(Downcast<PrimValue>(call->args[1])->value)->value;
+    }
+    return os.str();
+  }
+
+  /*!
+   * \brief Whether the buckets of the given indices depend, directly or through other buckets,
+   *        on the given bucket.
+   */
+  template <typename FGetBucketDeps>
+  static bool DependsOnBucket(std::vector<int> stack, int bucket,
+                              const std::vector<std::vector<int>>& buckets,
+                              const std::vector<std::vector<uint64_t>>& bucket_ancestors,
+                              FGetBucketDeps get_bucket_deps) {
+    std::vector<bool> visited(buckets.size(), false);
+    while (!stack.empty()) {
+      int cur = stack.back();
+      stack.pop_back();
+      if (cur == bucket) {
+        return true;
+      }
+      if (visited[cur]) {
+        continue;
+      }
+      visited[cur] = true;
+      for (int dep : get_bucket_deps(bucket_ancestors[cur])) {
+        stack.push_back(dep);
+      }
+    }
+    return false;
+  }
+
+  Array<Binding> bindings_;
+  int64_t max_bucket_bytes_;
+  /*! \brief The indices of the bindings each binding uses. */
+  std::vector<std::vector<int>> deps_;
+  /*! \brief The indices of the candidate bindings. */
+  std::vector<int> candidates_;
+};
+
+/*!
+ * \brief Replace each bucket of collectives by a single collective of a flat buffer of their
+ *        inputs.
+ */
+class CollectiveBucketer : public ExprMutator {
+ public:
+  explicit CollectiveBucketer(int64_t max_bucket_bytes) : max_bucket_bytes_(max_bucket_bytes) {}
+
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    std::vector<CollectiveBucketPlanner::Node> schedule =
+        CollectiveBucketPlanner(block->bindings, max_bucket_bytes_).Plan();
+    if (schedule.empty()) {
+      return ExprMutator::VisitBindingBlock_(block);
+    }
+    builder_->BeginDataflowBlock();
+    for (const CollectiveBucketPlanner::Node& node : schedule) {
+      if (node.size() == 1) {
+        VisitBinding(block->bindings[node[0]]);
+      } else {
+        std::vector<const VarBindingNode*> members;
+        for (int i : node) {
+          members.push_back(block->bindings[i].as<VarBindingNode>());
+        }
+        EmitBucket(members);
+      }
+    }
+    return builder_->EndBlock();
+  }
+
+ private:
+  static ShapeExpr ShapeOf(const Expr& tensor) {
+    return Downcast<ShapeExpr>(GetStructInfoAs<TensorStructInfoNode>(tensor)->shape.value());
+  }
+
+  static ShapeExpr StaticShape(std::vector<int64_t> dims) {
+    Array<PrimExpr> values;
+    for (int64_t dim : dims) {
+      values.push_back(IntImm(DataType::Int(64), dim));
+    }
+    return ShapeExpr(values);
+  }
+
+  void EmitBucket(const std::vector<const VarBindingNode*>& members) {
+    static const Op& allreduce_op = Op::Get("relax.ccl.allreduce");
+    Call first = Downcast<Call>(members[0]->value);
+    bool is_allreduce = first->op.same_as(allreduce_op);
+
+    // Flatten the inputs into one buffer.
+    Array<Expr> flat_inputs;
+    Array<IntImm> split_indices;
+    int64_t total = 0;
+    for (const VarBindingNode* member : members) {
+      Expr input = VisitExpr(Downcast<Call>(member->value)->args[0]);
+      int64_t num_elements = CollectiveBucketPlanner::NumElements(input);
+      flat_inputs.push_back(builder_->Emit(reshape(input, StaticShape({num_elements}))));
+      if (total > 0) {
+        split_indices.push_back(IntImm(DataType::Int(64), total));
+      }
+      total += num_elements;
+    }
+    Expr flat = builder_->Emit(concat(Tuple(flat_inputs), Integer(0)));
+
+    // Run the collective on the buffer, and split it back.
+    Expr parts;
+    if (is_allreduce) {
+      const auto* attrs = first->attrs.as<AllReduceAttrs>();
+      Expr reduced = builder_->Emit(allreduce(flat, attrs->op_type, attrs->group));
+      parts = builder_->Emit(split(reduced, split_indices, 0));
+    } else {
+      // The gathered buffer is the concatenation of the flat buffer of each worker.
+      int64_t num_workers =
+          Downcast<IntImm>(Downcast<PrimValue>(first->args[1])->value)->value;
+      const auto* attrs = first->attrs.as<AllGatherAttrs>();
+      Expr gathered =
+          builder_->Emit(allgather(flat, first->args[1], attrs ? attrs->group : String("")));
+      Expr per_worker = builder_->Emit(reshape(gathered, StaticShape({num_workers, total})));
+      parts = builder_->Emit(split(per_worker, split_indices, 1));
+    }
+    for (int i = 0; i < static_cast<int>(members.size()); i++) {
+      Expr part = builder_->Normalize(
+          reshape(TupleGetItem(parts, i), ShapeOf(members[i]->var)));
+      ReEmitBinding(members[i], part);
+    }
+  }
+
+  int64_t max_bucket_bytes_;
+};
+
+namespace transform {
+
+Pass BucketCollectives(int64_t max_bucket_bytes) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(CollectiveBucketer(max_bucket_bytes).VisitExpr(f));
+      };
+  return relax::transform::CreateFunctionPass(pass_func, 1, "BucketCollectives", {});
+}
+TVM_REGISTER_GLOBAL("relax.distributed.transform.BucketCollectives")
+    .set_body_typed(BucketCollectives);
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
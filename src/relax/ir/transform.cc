@@ -22,6 +22,7 @@
  * \brief Relax specific transformation passes.
  */
 #include <dmlc/thread_local.h>
+#include <tvm/ir/instrument.h>
 #include <tvm/node/repr_printer.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
@@ -144,9 +145,20 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   for (const auto& it : updated_mod->functions) {
     // only picks up relax::Function
     if (auto* n = it.second.as<FunctionNode>()) {
-      Function func = GetRef<Function>(n);
-      auto updated_func = SkipFunction(func) ? func : pass_func(func, updated_mod, pass_ctx);
-      updates.push_back({it.first, updated_func});
+      updates.push_back({it.first, GetRef<Function>(n)});
+    }
+  }
+  auto f_update = [&](int i) {
+    instrument::FunctionPassProfileScope scope(pass_info, updates[i].first->name_hint);
+    Function func = updates[i].second;
+    updates[i].second = SkipFunction(func) ? func : pass_func(func, updated_mod, pass_ctx);
+  };
+  int num_threads = tvm::transform::GetFunctionPassNumThreads(pass_ctx, pass_info, updates.size());
+  if (num_threads > 1) {
+    tvm::transform::ParallelForFunctions(pass_ctx, num_threads, updates.size(), f_update);
+  } else {
+    for (size_t i = 0; i < updates.size(); ++i) {
+      f_update(i);
     }
   }
 
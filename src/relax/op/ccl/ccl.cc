@@ -27,9 +27,10 @@ namespace relax {
 /* relax.ccl.allreduce */
 TVM_REGISTER_NODE_TYPE(AllReduceAttrs);
 
-Expr allreduce(Expr x, String op_type) {
+Expr allreduce(Expr x, String op_type, String group) {
   ObjectPtr<AllReduceAttrs> attrs = make_object<AllReduceAttrs>();
   attrs->op_type = std::move(op_type);
+  attrs->group = std::move(group);
 
   static const Op& op = Op::Get("relax.ccl.allreduce");
   return Call(op, {std::move(x)}, Attrs{attrs}, {});
@@ -51,9 +52,14 @@ TVM_REGISTER_OP("relax.ccl.allreduce")
     .set_attr<Bool>("FPurity", Bool(true));
 
 /* relax.ccl.allgather */
-Expr allgather(Expr x, Expr num_workers) {
+TVM_REGISTER_NODE_TYPE(AllGatherAttrs);
+
+Expr allgather(Expr x, Expr num_workers, String group) {
+  ObjectPtr<AllGatherAttrs> attrs = make_object<AllGatherAttrs>();
+  attrs->group = std::move(group);
+
   static const Op& op = Op::Get("relax.ccl.allgather");
-  return Call(op, {std::move(x), std::move(num_workers)});
+  return Call(op, {std::move(x), std::move(num_workers)}, Attrs{attrs}, {});
 }
 
 TVM_REGISTER_GLOBAL("relax.op.ccl.allgather").set_body_typed(allgather);
@@ -76,6 +82,7 @@ StructInfo InferStructInfoAllGather(const Call& call, const BlockBuilder& ctx) {
 }
 
 TVM_REGISTER_OP("relax.ccl.allgather")
+    .set_attrs_type<AllGatherAttrs>()
     .set_num_inputs(1)
     .add_argument("x", "Tensor", "Input to which allgather will be applied.")
     .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllGather)
@@ -32,11 +32,11 @@
 namespace tvm {
 namespace relax {
 
-/*! \brief AllReduce. */
-Expr allreduce(Expr data, String op_type);
+/*! \brief AllReduce, within the named group of workers if `group` is not empty. */
+Expr allreduce(Expr data, String op_type, String group = "");
 
-/*! \brief AllGather. */
-Expr allgather(Expr data, Expr num_workers);
+/*! \brief AllGather, within the named group of workers if `group` is not empty. */
+Expr allgather(Expr data, Expr num_workers, String group = "");
 
 /*! \brief Broadcast data from worker-0 to all other workers. */
 Expr broadcast_from_worker0(Expr data);
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "lora.h"
+
+#include <utility>
+
+namespace tvm {
+namespace relax {
+
+/* relax.nn.lora_bgmv */
+
+Expr lora_bgmv(Expr data, Expr lora_a, Expr lora_b, Expr adapter_indices) {
+  static const Op& op = Op::Get("relax.nn.lora_bgmv");
+  return Call(op,
+              {std::move(data), std::move(lora_a), std::move(lora_b), std::move(adapter_indices)},
+              Attrs(), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.lora_bgmv").set_body_typed(lora_bgmv);
+
+StructInfo InferStructInfoLoraBGMV(const Call& call, const BlockBuilder& ctx) {
+  Array<TensorStructInfo> input_sinfo = GetInputTensorStructInfo(call, ctx);
+  TensorStructInfo data_sinfo = input_sinfo[0];
+  TensorStructInfo lora_a_sinfo = input_sinfo[1];
+  TensorStructInfo lora_b_sinfo = input_sinfo[2];
+  TensorStructInfo indices_sinfo = input_sinfo[3];
+
+  auto diag_ndim = [&](const TensorStructInfo& sinfo, int ndim, String name) {
+    if (!sinfo->IsUnknownNdim() && sinfo->ndim != ndim) {
+      ctx->ReportFatal(Diagnostic::Error(call)
+                       << "LoRA BGMV requires the " << name << " to have " << ndim
+                       << " dimensions. However, the " << name << " has " << sinfo->ndim
+                       << " dimensions.");
+    }
+  };
+  diag_ndim(data_sinfo, 2, "data");
+  diag_ndim(lora_a_sinfo, 3, "A matrices");
+  diag_ndim(lora_b_sinfo, 3, "B matrices");
+  diag_ndim(indices_sinfo, 1, "adapter indices");
+  if (!indices_sinfo->IsUnknownDtype() && !indices_sinfo->dtype.is_int()) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "LoRA BGMV requires the adapter indices to be integers. However, their "
+                     << "dtype is " << indices_sinfo->dtype);
+  }
+  if (!data_sinfo->IsUnknownDtype() && !lora_a_sinfo->IsUnknownDtype() &&
+      !lora_b_sinfo->IsUnknownDtype() &&
+      (data_sinfo->dtype != lora_a_sinfo->dtype || data_sinfo->dtype != lora_b_sinfo->dtype)) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "LoRA BGMV requires the data and the A and B matrices to have the same "
+                     << "dtype. However, their dtypes are " << data_sinfo->dtype << ", "
+                     << lora_a_sinfo->dtype << " and " << lora_b_sinfo->dtype);
+  }
+
+  const auto* data_shape = data_sinfo->shape.as<ShapeExprNode>();
+  const auto* lora_a_shape = lora_a_sinfo->shape.as<ShapeExprNode>();
+  const auto* lora_b_shape = lora_b_sinfo->shape.as<ShapeExprNode>();
+  const auto* indices_shape = indices_sinfo->shape.as<ShapeExprNode>();
+  if (!data_shape || !lora_b_shape) {
+    return TensorStructInfo(data_sinfo->dtype, /*ndim=*/2, data_sinfo->vdevice);
+  }
+
+  arith::Analyzer* analyzer = ctx->GetAnalyzer();
+  auto diag_equal = [&](PrimExpr v1, PrimExpr v2, String m1, String m2, String dim) {
+    if (analyzer->CanProve(v1 != v2)) {
+      ctx->ReportFatal(Diagnostic::Error(call)
+                       << "The " << m1 << " " << dim << " and the " << m2 << " " << dim
+                       << " should be the same. However, the " << dim << " of " << m1 << " is "
+                       << v1 << " while the " << dim << " of " << m2 << " is " << v2);
+    }
+  };
+  if (lora_a_shape) {
+    diag_equal(data_shape->values[1], lora_a_shape->values[2], "data", "A matrices",
+               "input features");
+    diag_equal(lora_a_shape->values[0], lora_b_shape->values[0], "A matrices", "B matrices",
+               "number of adapters");
+    diag_equal(lora_a_shape->values[1], lora_b_shape->values[2], "A matrices", "B matrices",
+               "rank");
+  }
+  if (indices_shape) {
+    diag_equal(data_shape->values[0], indices_shape->values[0], "data", "adapter indices",
+               "number of tokens");
+  }
+
+  Array<PrimExpr> output_shape = {data_shape->values[0], lora_b_shape->values[1]};
+  return TensorStructInfo(ShapeExpr(output_shape), data_sinfo->dtype, data_sinfo->vdevice);
+}
+
+TVM_REGISTER_OP("relax.nn.lora_bgmv")
+    .set_num_inputs(4)
+    .add_argument("data", "Tensor", "The input tokens.")
+    .add_argument("lora_a", "Tensor", "The A matrices of the adapters.")
+    .add_argument("lora_b", "Tensor", "The B matrices of the adapters.")
+    .add_argument("adapter_indices", "Tensor", "The adapter of each token.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoLoraBGMV)
+    .set_attr<Bool>("FPurity", Bool(true));
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,47 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file lora.h
+ * \brief The functions to make Relax LoRA operator calls.
+ */
+
+#ifndef TVM_RELAX_OP_NN_LORA_H_
+#define TVM_RELAX_OP_NN_LORA_H_
+
+#include "../op_common.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief The LoRA update of a batch of tokens, each with its own adapter.
+ * \param data The input tokens, of shape (num_tokens, in_features).
+ * \param lora_a The A matrices of the adapters, of shape (num_adapters, rank, in_features).
+ * \param lora_b The B matrices of the adapters, of shape (num_adapters, out_features, rank).
+ * \param adapter_indices The adapter of each token, of shape (num_tokens,). A negative index
+ * means no adapter.
+ * \return The LoRA update, of shape (num_tokens, out_features).
+ */
+Expr lora_bgmv(Expr data, Expr lora_a, Expr lora_b, Expr adapter_indices);
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_OP_NN_LORA_H_
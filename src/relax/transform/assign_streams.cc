@@ -0,0 +1,444 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/assign_streams.cc
+ * \brief Assign the independent kernel calls of each binding block to multiple streams.
+ * \details
+ * The pass runs after CallTIRRewrite, where each kernel is a call to a PrimFunc or to an
+ * external function with its outputs passed explicitly. Within each binding block, it
+ * - builds the dependencies of the kernels from the tensors they read and write,
+ * - assigns each kernel to the stream of one of its dependencies that has issued nothing since,
+ *   and the other kernels to the streams in a round-robin way,
+ * - inserts `vm.builtin.stream_sync` at the dependency edges across streams, and
+ * - joins the side streams back into stream 0 with `vm.builtin.stream_join` before any
+ *   binding that is not a kernel nor a host-only operation, and at the end of the block.
+ *
+ * A side stream first waits for the work issued to stream 0 when it is used after a join, so
+ * that the memory freed before the join is safe to use on each stream. StaticPlanBlockMemory
+ * and KillAfterLastUse recognize the stream builtins to avoid reusing or freeing the memory
+ * of a tensor still in use by another stream.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.backend.num_streams", Integer);
+
+/*!
+ * \brief Get whether each parameter of a PrimFunc may be written by the function. The buffers
+ * whose pointer escapes into a call are treated as written.
+ */
+std::vector<bool> GetWrittenParams(const tir::PrimFunc& func) {
+  std::unordered_set<const tir::VarNode*> written;
+  tir::PostOrderVisit(func->body, [&written](const ObjectRef& obj) {
+    if (const auto* store = obj.as<tir::BufferStoreNode>()) {
+      written.insert(store->buffer->data.get());
+    } else if (const auto* block = obj.as<tir::BlockNode>()) {
+      for (const tir::BufferRegion& region : block->writes) {
+        written.insert(region->buffer->data.get());
+      }
+      for (const tir::MatchBufferRegion& match : block->match_buffers) {
+        written.insert(match->source->buffer->data.get());
+      }
+    } else if (const auto* call = obj.as<tir::CallNode>()) {
+      for (const PrimExpr& arg : call->args) {
+        if (const auto* var = arg.as<tir::VarNode>(); var && var->dtype.is_handle()) {
+          written.insert(var);
+        } else if (const auto* load = arg.as<tir::BufferLoadNode>();
+                   load && call->op.same_as(tir::builtin::address_of())) {
+          written.insert(load->buffer->data.get());
+        }
+      }
+    }
+  });
+
+  std::vector<bool> result;
+  result.reserve(func->params.size());
+  for (const tir::Var& param : func->params) {
+    if (Optional<tir::Buffer> buffer = func->buffer_map.Get(param)) {
+      result.push_back(written.count(buffer.value()->data.get()));
+    } else {
+      // A scalar parameter cannot be written, while an opaque handle may be.
+      result.push_back(param->dtype.is_handle());
+    }
+  }
+  return result;
+}
+
+class StreamAssigner : public ExprMutator {
+ public:
+  explicit StreamAssigner(IRModule mod, int num_streams, int device_index)
+      : ExprMutator(mod), mod_(mod), num_streams_(num_streams), device_index_(device_index) {}
+
+  IRModule Run() {
+    for (const auto& [gv, func] : mod_->functions) {
+      if (func->IsInstance<FunctionNode>()) {
+        auto updated_func = Downcast<Function>(this->VisitExpr(func));
+        builder_->UpdateFunction(gv, Downcast<BaseFunc>(updated_func));
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitBindingBlock_;
+
+  enum class BindingKind { kAlloc, kKernel, kBarrier, kHost };
+
+  /*! \brief The plan of a binding in the block. */
+  struct BindingPlan {
+    BindingKind kind = BindingKind::kHost;
+    /*! \brief The stream of a kernel. */
+    int stream = 0;
+    /*! \brief The (src, dst) streams to sync before a kernel. */
+    std::vector<std::pair<int, int>> syncs;
+    /*! \brief Whether to join the side streams before a barrier. */
+    bool join = false;
+    /*! \brief The allocations moved to right before a kernel. */
+    std::vector<int> allocs;
+  };
+
+  /*! \brief The last writer and the readers since then of a tensor, by binding index. */
+  struct TensorState {
+    int writer = -1;
+    std::vector<int> readers;
+  };
+
+  BindingBlock VisitBindingBlock_(const BindingBlockNode* block) final {
+    const Array<Binding>& bindings = block->bindings;
+    int num_bindings = bindings.size();
+    std::vector<BindingPlan> plans(num_bindings);
+
+    // The tensors that each variable may refer to, for the variables aliasing other tensors.
+    std::unordered_map<const VarNode*, std::vector<const VarNode*>> roots;
+    auto roots_of = [&roots](const Expr& expr) {
+      std::vector<const VarNode*> result;
+      for (const Var& var : FreeVars(expr)) {
+        auto it = roots.find(var.get());
+        if (it == roots.end()) {
+          result.push_back(var.get());
+        } else {
+          result.insert(result.end(), it->second.begin(), it->second.end());
+        }
+      }
+      std::sort(result.begin(), result.end());
+      result.erase(std::unique(result.begin(), result.end()), result.end());
+      return result;
+    };
+
+    std::unordered_map<const VarNode*, TensorState> tensors;
+    // The allocations not used by any kernel yet.
+    std::unordered_set<const VarNode*> fresh_allocs;
+    std::vector<int> node_stream(num_bindings, 0);
+    // The last binding issued to each stream.
+    std::vector<int> tail(num_streams_, -1);
+    // known[s][t] is the last binding issued to stream t that stream s has synchronized with.
+    std::vector<std::vector<int>> known(num_streams_, std::vector<int>(num_streams_, -1));
+    std::vector<bool> forked(num_streams_, false);
+    bool in_region = false;
+    bool used_side_stream = false;
+    int next_stream = 0;
+
+    auto sync = [&](int src, int dst, BindingPlan* plan) {
+      plan->syncs.emplace_back(src, dst);
+      for (int u = 0; u < num_streams_; ++u) {
+        known[dst][u] = std::max(known[dst][u], known[src][u]);
+      }
+      known[dst][src] = tail[src];
+    };
+    auto join = [&]() {
+      for (int t = 1; t < num_streams_; ++t) {
+        for (int u = 0; u < num_streams_; ++u) {
+          known[0][u] = std::max(known[0][u], known[t][u]);
+        }
+        known[0][t] = tail[t];
+        forked[t] = false;
+      }
+      in_region = false;
+    };
+
+    for (int i = 0; i < num_bindings; ++i) {
+      const Binding& binding = bindings[i];
+      const VarNode* var = binding->var.get();
+      Expr value = GetBoundValue(binding);
+      BindingPlan& plan = plans[i];
+      plan.kind = Classify(binding);
+
+      if (plan.kind == BindingKind::kHost) {
+        roots[var] = roots_of(value);
+        continue;
+      }
+      roots[var] = {var};
+      if (plan.kind == BindingKind::kAlloc) {
+        fresh_allocs.insert(var);
+        continue;
+      }
+
+      if (plan.kind == BindingKind::kBarrier) {
+        plan.join = in_region;
+        if (in_region) {
+          join();
+        }
+        for (const VarNode* root : roots_of(value)) {
+          tensors[root] = TensorState{i, {}};
+        }
+        tensors[var] = TensorState{i, {}};
+        tail[0] = i;
+        continue;
+      }
+
+      // Collect the tensors the kernel reads and writes, and its dependencies.
+      std::vector<const VarNode*> reads, writes{var};
+      const auto* call = value.as<CallNode>();
+      Array<Expr> args = GetKernelArgs(call);
+      std::vector<bool> written = GetWrittenArgs(call, args.size());
+      for (size_t j = 0; j < args.size(); ++j) {
+        for (const VarNode* root : roots_of(args[j])) {
+          // The first kernel using an allocation is the one it is allocated as output for.
+          bool is_output = fresh_allocs.erase(root);
+          (written[j] || is_output ? writes : reads).push_back(root);
+        }
+      }
+      std::vector<int> deps;
+      for (const VarNode* root : reads) {
+        if (auto it = tensors.find(root); it != tensors.end() && it->second.writer >= 0) {
+          deps.push_back(it->second.writer);
+        }
+      }
+      for (const VarNode* root : writes) {
+        if (auto it = tensors.find(root); it != tensors.end()) {
+          if (it->second.writer >= 0) {
+            deps.push_back(it->second.writer);
+          }
+          deps.insert(deps.end(), it->second.readers.begin(), it->second.readers.end());
+        }
+      }
+      std::sort(deps.begin(), deps.end());
+      deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+      // Continue the stream of the latest dependency that nothing is issued after, which keeps
+      // a chain of kernels on one stream. Otherwise the kernel starts a new branch.
+      int stream = -1;
+      for (auto it = deps.rbegin(); it != deps.rend(); ++it) {
+        if (tail[node_stream[*it]] == *it) {
+          stream = node_stream[*it];
+          break;
+        }
+      }
+      if (stream == -1) {
+        stream = next_stream;
+        next_stream = (next_stream + 1) % num_streams_;
+      }
+      plan.stream = stream;
+
+      if (stream != 0 && !forked[stream]) {
+        sync(0, stream, &plan);
+        forked[stream] = true;
+        in_region = true;
+        used_side_stream = true;
+      }
+      for (int dep : deps) {
+        int src = node_stream[dep];
+        if (src != stream && known[stream][src] < dep) {
+          sync(src, stream, &plan);
+        }
+      }
+      node_stream[i] = stream;
+      tail[stream] = i;
+
+      for (const VarNode* root : reads) {
+        tensors[root].readers.push_back(i);
+      }
+      for (const VarNode* root : writes) {
+        tensors[root] = TensorState{i, {}};
+      }
+    }
+
+    if (!used_side_stream) {
+      return ExprMutator::VisitBindingBlock_(block);
+    }
+
+    // Move each allocation that is first used by a kernel, after only other allocations, to
+    // right after the stream switch of the kernel, so that the memory planning sees the stream
+    // of the allocation.
+    std::vector<bool> moved(num_bindings, false);
+    for (int i = 0; i < num_bindings; ++i) {
+      if (plans[i].kind != BindingKind::kAlloc) {
+        continue;
+      }
+      int j = i + 1;
+      while (j < num_bindings && plans[j].kind == BindingKind::kAlloc) {
+        ++j;
+      }
+      if (j == num_bindings || plans[j].kind != BindingKind::kKernel) {
+        continue;
+      }
+      Array<Var> used = FreeVars(GetBoundValue(bindings[j]));
+      if (std::any_of(used.begin(), used.end(),
+                      [&](const Var& v) { return v.same_as(bindings[i]->var); })) {
+        plans[j].allocs.push_back(i);
+        moved[i] = true;
+      }
+    }
+
+    builder_->BeginBindingBlock();
+    int cur_stream = 0;
+    for (int i = 0; i < num_bindings; ++i) {
+      const BindingPlan& plan = plans[i];
+      if (moved[i]) {
+        continue;
+      }
+      if (plan.kind == BindingKind::kKernel) {
+        if (plan.stream != cur_stream) {
+          EmitStreamBuiltin("vm.builtin.stream_switch", {plan.stream});
+          cur_stream = plan.stream;
+        }
+        for (const auto& [src, dst] : plan.syncs) {
+          EmitStreamBuiltin("vm.builtin.stream_sync", {src, dst});
+        }
+        for (int alloc : plan.allocs) {
+          VisitBinding(bindings[alloc]);
+        }
+      } else if (plan.join) {
+        EmitStreamBuiltin("vm.builtin.stream_join", {});
+        cur_stream = 0;
+      }
+      VisitBinding(bindings[i]);
+    }
+    if (in_region) {
+      EmitStreamBuiltin("vm.builtin.stream_join", {});
+    }
+    return builder_->EndBlock();
+  }
+
+  BindingKind Classify(const Binding& binding) {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    static const Op& reshape_op = Op::Get("relax.reshape");
+    static const Op& call_tir_dyn_op = Op::Get("relax.vm.call_tir_dyn");
+    Expr value = GetBoundValue(binding);
+    if (const auto* call = value.as<CallNode>()) {
+      if (call->op.same_as(alloc_tensor_op)) {
+        return BindingKind::kAlloc;
+      }
+      if (call->op.same_as(reshape_op)) {
+        return BindingKind::kHost;
+      }
+      if (call->op->IsInstance<ExternFuncNode>() || call->op.same_as(call_tir_dyn_op) ||
+          LookupPrimFunc(call->op).defined()) {
+        return BindingKind::kKernel;
+      }
+      return BindingKind::kBarrier;
+    }
+    if (value->IsInstance<IfNode>() || value->IsInstance<SeqExprNode>()) {
+      return BindingKind::kBarrier;
+    }
+    return BindingKind::kHost;
+  }
+
+  Optional<tir::PrimFunc> LookupPrimFunc(const Expr& op) {
+    if (const auto* gv = op.as<GlobalVarNode>()) {
+      if (Optional<BaseFunc> func = mod_->functions.Get(GetRef<GlobalVar>(gv))) {
+        return func.value().as<tir::PrimFunc>();
+      }
+    }
+    return NullOpt;
+  }
+
+  Array<Expr> GetKernelArgs(const CallNode* call) {
+    static const Op& call_tir_dyn_op = Op::Get("relax.vm.call_tir_dyn");
+    if (call->op.same_as(call_tir_dyn_op)) {
+      return Downcast<Tuple>(call->args[1])->fields;
+    }
+    return call->args;
+  }
+
+  /*! \brief Get whether the kernel may write each of its arguments. */
+  std::vector<bool> GetWrittenArgs(const CallNode* call, size_t num_args) {
+    static const Op& call_tir_dyn_op = Op::Get("relax.vm.call_tir_dyn");
+    Expr callee = call->op.same_as(call_tir_dyn_op) ? call->args[0] : call->op;
+    if (Optional<tir::PrimFunc> func = LookupPrimFunc(callee)) {
+      auto it = written_params_.find(func.value().get());
+      if (it == written_params_.end()) {
+        it = written_params_.emplace(func.value().get(), GetWrittenParams(func.value())).first;
+      }
+      if (it->second.size() == num_args) {
+        return it->second;
+      }
+    }
+    // The external functions may write any of the arguments.
+    return std::vector<bool>(num_args, true);
+  }
+
+  void EmitStreamBuiltin(const char* name, std::vector<int> args) {
+    static const Op& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+    Array<Expr> fields{PrimValue::Int64(device_index_)};
+    for (int arg : args) {
+      fields.push_back(PrimValue::Int64(arg));
+    }
+    builder_->Emit(Call(call_builtin_with_ctx_op, {ExternFunc(name), Tuple(fields)}, Attrs(),
+                        {TupleStructInfo(Array<StructInfo>())}),
+                   /*name_hint=*/"_");
+  }
+
+  /*! \brief The context IRModule. */
+  IRModule mod_;
+  /*! \brief The number of streams. */
+  int num_streams_;
+  /*! \brief The index of the VM device the kernels run on. */
+  int device_index_;
+  /*! \brief The cache of the written parameters of each PrimFunc. */
+  std::unordered_map<const tir::PrimFuncNode*, std::vector<bool>> written_params_;
+};
+
+namespace transform {
+
+Pass AssignStreams(Optional<Integer> num_streams, int device_index) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) {
+        int64_t n = num_streams.value_or(pc->GetConfig<Integer>("relax.backend.num_streams")
+                                             .value_or(Integer(1)))
+                        ->value;
+        if (n <= 1) {
+          return mod;
+        }
+        return StreamAssigner(mod, n, device_index).Run();
+      };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"AssignStreams",
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.AssignStreams").set_body_typed(AssignStreams);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,451 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/auto_place_vdevice.cc
+ * \brief Place the operators of dataflow blocks on the host or the device by their estimated
+ * run time and the cost of the transfers between them.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/op.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The parameters of the cost model, in FLOP/s, bytes/s and seconds. */
+struct PlacementCostModel {
+  double host_flops = 1e11;
+  double host_bandwidth = 2e10;
+  double host_launch_overhead = 1e-7;
+  double device_flops = 1e13;
+  double device_bandwidth = 5e11;
+  double device_launch_overhead = 5e-6;
+  double transfer_bandwidth = 1e10;
+  double transfer_latency = 1e-5;
+
+  explicit PlacementCostModel(const Map<String, FloatImm>& overrides) {
+    std::unordered_map<std::string, double*> fields = {
+        {"host_flops", &host_flops},
+        {"host_bandwidth", &host_bandwidth},
+        {"host_launch_overhead", &host_launch_overhead},
+        {"device_flops", &device_flops},
+        {"device_bandwidth", &device_bandwidth},
+        {"device_launch_overhead", &device_launch_overhead},
+        {"transfer_bandwidth", &transfer_bandwidth},
+        {"transfer_latency", &transfer_latency},
+    };
+    for (const auto& [name, value] : overrides) {
+      auto it = fields.find(name);
+      CHECK(it != fields.end()) << "ValueError: Unknown parameter of the placement cost model "
+                                << name;
+      *it->second = value->value;
+    }
+  }
+};
+
+/*! \brief The minimum s-t cut of a graph of real capacities, by Dinic's algorithm. */
+class MinCut {
+ public:
+  explicit MinCut(int num_nodes) : adj_(num_nodes), level_(num_nodes), next_(num_nodes) {}
+
+  void AddEdge(int from, int to, double capacity) {
+    if (capacity <= 0) return;
+    adj_[from].push_back(edges_.size());
+    edges_.push_back({to, capacity});
+    adj_[to].push_back(edges_.size());
+    edges_.push_back({from, 0});
+  }
+
+  /*! \return Whether each node is on the source side of a minimum cut. */
+  std::vector<bool> Solve(int source, int sink) {
+    while (BuildLevels(source, sink)) {
+      std::fill(next_.begin(), next_.end(), 0);
+      while (Augment(source, sink, std::numeric_limits<double>::infinity()) > kEpsilon) {
+      }
+    }
+    BuildLevels(source, sink);
+    std::vector<bool> source_side(adj_.size());
+    for (size_t i = 0; i < adj_.size(); ++i) {
+      source_side[i] = level_[i] >= 0;
+    }
+    return source_side;
+  }
+
+ private:
+  struct Edge {
+    int to;
+    double capacity;
+  };
+
+  static constexpr double kEpsilon = 1e-15;
+
+  bool BuildLevels(int source, int sink) {
+    std::fill(level_.begin(), level_.end(), -1);
+    std::queue<int> queue;
+    level_[source] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+      int node = queue.front();
+      queue.pop();
+      for (size_t e : adj_[node]) {
+        if (edges_[e].capacity > kEpsilon && level_[edges_[e].to] < 0) {
+          level_[edges_[e].to] = level_[node] + 1;
+          queue.push(edges_[e].to);
+        }
+      }
+    }
+    return level_[sink] >= 0;
+  }
+
+  double Augment(int node, int sink, double flow) {
+    if (node == sink) return flow;
+    for (size_t& i = next_[node]; i < adj_[node].size(); ++i) {
+      size_t e = adj_[node][i];
+      Edge& edge = edges_[e];
+      if (edge.capacity > kEpsilon && level_[edge.to] == level_[node] + 1) {
+        double pushed = Augment(edge.to, sink, std::min(flow, edge.capacity));
+        if (pushed > kEpsilon) {
+          edge.capacity -= pushed;
+          edges_[e ^ 1].capacity += pushed;
+          return pushed;
+        }
+      }
+    }
+    return 0;
+  }
+
+  std::vector<Edge> edges_;
+  std::vector<std::vector<size_t>> adj_;
+  std::vector<int> level_;
+  std::vector<size_t> next_;
+};
+
+class VDeviceAutoPlacer : public ExprMutator {
+ public:
+  VDeviceAutoPlacer(const IRModule& mod, VDevice host, VDevice device, PlacementCostModel model)
+      : ExprMutator(mod),
+        mod_(mod),
+        host_(std::move(host)),
+        device_(std::move(device)),
+        model_(model) {}
+
+  IRModule Run() {
+    for (const auto& [gv, func] : mod_->functions) {
+      if (func->IsInstance<FunctionNode>()) {
+        auto updated_func = Downcast<Function>(this->VisitExpr(func));
+        builder_->UpdateFunction(gv, Downcast<BaseFunc>(updated_func));
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  /*! \return The size of a tensor of static shape in bytes, or -1 for other values. */
+  static double StaticTensorBytes(const StructInfo& sinfo) {
+    const auto* tensor = sinfo.as<TensorStructInfoNode>();
+    if (tensor == nullptr || tensor->IsUnknownDtype()) return -1;
+    const auto* shape = tensor->shape.as<ShapeExprNode>();
+    if (shape == nullptr) return -1;
+    double numel = 1;
+    for (const PrimExpr& dim : shape->values) {
+      const auto* extent = dim.as<IntImmNode>();
+      if (extent == nullptr) return -1;
+      numel *= extent->value;
+    }
+    return numel * ((tensor->dtype.bits() * tensor->dtype.lanes() + 7) / 8);
+  }
+
+  double TransferTime(double bytes) const {
+    return model_.transfer_latency + bytes / model_.transfer_bandwidth;
+  }
+
+  /*!
+   * \return Whether the operator of a binding may be placed on either the host or the device: a
+   * call of an operator on tensors of static shapes, whose output is not placed yet.
+   */
+  bool IsPlaceable(const VarBindingNode* binding) const {
+    const auto* call = binding->value.as<CallNode>();
+    if (call == nullptr) return false;
+    const auto* op = call->op.as<OpNode>();
+    if (op == nullptr) return false;
+    const std::string& name = op->name;
+    for (const char* prefix : {"relax.call_", "relax.memory.", "relax.vm.", "relax.builtin."}) {
+      if (name.rfind(prefix, 0) == 0) return false;
+    }
+    if (name == "relax.to_vdevice" || name == "relax.hint_on_device") return false;
+    const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(binding->var);
+    if (tensor == nullptr || tensor->vdevice.defined() ||
+        StaticTensorBytes(GetStructInfo(binding->var)) < 0) {
+      return false;
+    }
+    for (const Var& var : FreeVars(binding->value)) {
+      if (var->struct_info_.as<TensorStructInfoNode>() &&
+          StaticTensorBytes(GetStructInfo(var)) < 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \return The estimated run time of an operator on the host and on the device. */
+  std::pair<double, double> OpTime(const VarBindingNode* binding) const {
+    const auto* call = binding->value.as<CallNode>();
+    const std::string& name = Downcast<Op>(call->op)->name;
+    double out_bytes = StaticTensorBytes(GetStructInfo(binding->var));
+    const auto* out_tensor = GetStructInfoAs<TensorStructInfoNode>(binding->var);
+    double out_numel = out_bytes / std::max(1, (out_tensor->dtype.bits() + 7) / 8);
+    double in_bytes = 0;
+    double in_numel = 0;
+    for (const Var& var : FreeVars(binding->value)) {
+      double bytes = StaticTensorBytes(GetStructInfo(var));
+      if (bytes < 0) continue;
+      in_bytes += bytes;
+      const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(var);
+      in_numel = std::max(in_numel, bytes / std::max(1, (tensor->dtype.bits() + 7) / 8));
+    }
+    double flops = std::max(out_numel, in_numel);
+    auto static_dims = [](const Expr& arg) {
+      std::vector<int64_t> dims;
+      const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(arg);
+      if (const auto* shape = tensor ? tensor->shape.as<ShapeExprNode>() : nullptr) {
+        for (const PrimExpr& dim : shape->values) {
+          const auto* extent = dim.as<IntImmNode>();
+          dims.push_back(extent ? extent->value : 1);
+        }
+      }
+      return dims;
+    };
+    if (name == "relax.matmul" && !call->args.empty()) {
+      std::vector<int64_t> lhs = static_dims(call->args[0]);
+      flops = 2 * out_numel * (lhs.empty() ? 1 : lhs.back());
+    } else if (name.rfind("relax.nn.conv", 0) == 0 && call->args.size() >= 2) {
+      // Each output element reduces over the weight of one output channel.
+      std::vector<int64_t> weight = static_dims(call->args[1]);
+      double weight_numel = 1;
+      for (int64_t dim : weight) weight_numel *= dim;
+      flops = 2 * out_numel * weight_numel / std::max<int64_t>(1, weight.empty() ? 1 : weight[0]);
+    } else if (name == "relax.take" && call->args.size() >= 2) {
+      // An embedding lookup reads the looked up rows rather than the whole table.
+      in_bytes = out_bytes + std::max(0.0, StaticTensorBytes(GetStructInfo(call->args[1])));
+    }
+    double bytes = in_bytes + out_bytes;
+    double host_time = model_.host_launch_overhead +
+                       std::max(flops / model_.host_flops, bytes / model_.host_bandwidth);
+    double device_time = model_.device_launch_overhead +
+                         std::max(flops / model_.device_flops, bytes / model_.device_bandwidth);
+    return {host_time, device_time};
+  }
+
+  /*!
+   * \brief Place the placeable operators of a dataflow block by a minimum cut of its dataflow
+   * graph between the host and the device. The operators run on the device unless placed.
+   */
+  void PlaceBlock(const DataflowBlockNode* block) {
+    std::unordered_map<const VarNode*, int> node_index;
+    std::vector<const VarBindingNode*> nodes;
+    for (const Binding& binding : block->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      if (var_binding != nullptr && IsPlaceable(var_binding)) {
+        node_index[var_binding->var.get()] = nodes.size();
+        nodes.push_back(var_binding);
+      }
+    }
+    if (nodes.empty()) return;
+    // The unary costs of placing each operator on the host and on the device.
+    std::vector<double> host_cost(nodes.size()), device_cost(nodes.size());
+    int num_nodes = nodes.size();
+    int source = num_nodes, sink = num_nodes + 1;
+    MinCut graph(num_nodes + 2);
+    for (int i = 0; i < num_nodes; ++i) {
+      std::tie(host_cost[i], device_cost[i]) = OpTime(nodes[i]);
+      for (const Var& var : FreeVars(nodes[i]->value)) {
+        double bytes = StaticTensorBytes(GetStructInfo(var));
+        if (bytes < 0) continue;
+        auto it = node_index.find(var.get());
+        if (it != node_index.end()) {
+          graph.AddEdge(it->second, i, TransferTime(bytes));
+          graph.AddEdge(i, it->second, TransferTime(bytes));
+        } else if (DeviceOf(var) == host_) {
+          device_cost[i] += TransferTime(bytes);
+        } else {
+          host_cost[i] += TransferTime(bytes);
+        }
+      }
+    }
+    // The values used outside of the placeable operators are expected on the device.
+    std::unordered_set<const VarNode*> used_on_device;
+    for (const Binding& binding : block->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      if (var_binding != nullptr && node_index.count(var_binding->var.get())) continue;
+      Expr value = var_binding ? var_binding->value : binding.as<MatchCastNode>()->value;
+      for (const Var& var : FreeVars(value)) used_on_device.insert(var.get());
+    }
+    for (int i = 0; i < num_nodes; ++i) {
+      const Var& var = nodes[i]->var;
+      if (!var->IsInstance<DataflowVarNode>() || used_on_device.count(var.get())) {
+        host_cost[i] += TransferTime(StaticTensorBytes(GetStructInfo(var)));
+      }
+      graph.AddEdge(source, i, device_cost[i]);
+      graph.AddEdge(i, sink, host_cost[i]);
+    }
+    std::vector<bool> on_host = graph.Solve(source, sink);
+    for (int i = 0; i < num_nodes; ++i) {
+      if (on_host[i]) placement_[nodes[i]->var.get()] = host_;
+    }
+  }
+
+  /*! \return The device of a value, which is the device unless specified or placed otherwise. */
+  VDevice DeviceOf(const Var& var) const {
+    auto it = placement_.find(var.get());
+    if (it != placement_.end()) return it->second;
+    const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(var);
+    if (tensor != nullptr && tensor->vdevice.defined()) return tensor->vdevice.value();
+    return device_;
+  }
+
+  /*! \return The value moved to a device, transferred once per block. */
+  Expr MoveTo(const Var& var, const VDevice& vdevice) {
+    auto key = std::make_pair(var.get(), vdevice.get());
+    auto it = moved_.find(key);
+    if (it != moved_.end()) return it->second;
+    ObjectPtr<ToVDeviceAttrs> attrs = make_object<ToVDeviceAttrs>();
+    attrs->dst_vdevice = vdevice;
+    Var moved = builder_->Emit(Call(to_vdevice_op_, {var}, Attrs(attrs), {}));
+    placement_[moved.get()] = vdevice;
+    moved_[key] = moved;
+    return moved;
+  }
+
+  Expr VisitExpr_(const VarNode* op) final {
+    Var var = Downcast<Var>(ExprMutator::VisitExpr_(op));
+    if (!var->struct_info_.as<TensorStructInfoNode>()) return var;
+    if (placing_.defined()) {
+      // The arguments of a placed operator are moved to its device.
+      if (DeviceOf(var) != placing_.value()) return MoveTo(var, placing_.value());
+    } else if (placement_.count(var.get()) && placement_[var.get()] != device_) {
+      // The other uses expect the values on the device, where they were before the placement.
+      return MoveTo(var, device_);
+    }
+    return var;
+  }
+
+  Expr VisitExpr_(const DataflowVarNode* op) final {
+    return VisitExpr_(static_cast<const VarNode*>(op));
+  }
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    PlaceBlock(block);
+    BindingBlock result = ExprMutator::VisitBindingBlock_(block);
+    moved_.clear();
+    return result;
+  }
+
+  BindingBlock VisitBindingBlock_(const BindingBlockNode* block) final {
+    BindingBlock result = ExprMutator::VisitBindingBlock_(block);
+    moved_.clear();
+    return result;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
+    auto it = placement_.find(binding->var.get());
+    if (it == placement_.end()) {
+      ExprMutator::VisitBinding_(binding, call);
+      return;
+    }
+    VDevice vdevice = it->second;
+    placing_ = vdevice;
+    Call new_call = Downcast<Call>(ExprMutator::VisitExpr_(call));
+    placing_ = NullOpt;
+    // The operators without tensor arguments do not infer the device of their output.
+    const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(binding->var);
+    new_call = Call(new_call->op, new_call->args, new_call->attrs, new_call->sinfo_args,
+                    new_call->span);
+    new_call->struct_info_ =
+        TensorStructInfo(tensor->shape.value(), tensor->dtype, vdevice, tensor->span);
+    Expr new_value = builder_->Normalize(new_call);
+    ReEmitBinding(binding, new_value);
+    placement_[LookupBinding(binding->var)] = vdevice;
+  }
+
+  const VarNode* LookupBinding(const Var& var) {
+    auto it = var_remap_.find(var->vid);
+    return it != var_remap_.end() ? it->second.get() : var.get();
+  }
+
+  /*! \brief The context IRModule. */
+  IRModule mod_;
+  /*! \brief The host and the device to place the operators on. */
+  VDevice host_, device_;
+  /*! \brief The cost model. */
+  PlacementCostModel model_;
+  /*! \brief The devices of the placed values, before and after the rewrite. */
+  std::unordered_map<const VarNode*, VDevice> placement_;
+  /*! \brief The values moved to other devices in the current block. */
+  std::map<std::pair<const VarNode*, const Object*>, Var> moved_;
+  /*! \brief The device of the operator whose arguments are being visited. */
+  Optional<VDevice> placing_;
+
+  const Op& to_vdevice_op_ = Op::Get("relax.to_vdevice");
+};
+
+namespace transform {
+
+Pass AutoPlaceVDevice(Map<String, FloatImm> cost_model) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    // The operators are placed between the first host and the first device of the module.
+    Optional<VDevice> host, device;
+    for (const GlobalInfo& info : mod->global_infos.Get("vdevice").value_or(Array<GlobalInfo>())) {
+      VDevice vdevice = Downcast<VDevice>(info);
+      if (vdevice->target->GetTargetDeviceType() == kDLCPU) {
+        if (!host.defined()) host = vdevice;
+      } else if (!device.defined()) {
+        device = vdevice;
+      }
+    }
+    if (!host.defined() || !device.defined()) return mod;
+    return VDeviceAutoPlacer(mod, host.value(), device.value(), PlacementCostModel(cost_model))
+        .Run();
+  };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"AutoPlaceVDevice",
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.AutoPlaceVDevice").set_body_typed(AutoPlaceVDevice);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -41,7 +41,13 @@ namespace relax {
 // pairs of indices (the liveness interval, from the starting index to the end index).
 // A starting index of -1 means the var is defined before the block starts and an end index
 // of block->bindings.size() (one past the last index) means it is live after the block ends.
-std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock& block) {
+// If live_after is given, it holds the vars used after the block in the enclosing function and
+// only those non-dataflow vars are live after the block; otherwise all of them are assumed to be.
+std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(
+    const DataflowBlock& block, const std::unordered_set<Var>* live_after = nullptr) {
+  auto is_live_after = [live_after](const Var& var) {
+    return !var.as<DataflowVarNode>() && (live_after == nullptr || live_after->count(var));
+  };
   std::unordered_map<Var, std::pair<int, int>> ret;
   for (int i = block->bindings.size() - 1; i >= 0; i--) {
     Binding b = block->bindings[i];
@@ -64,9 +70,8 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
 
     for (auto var : used_vars) {
       int range_end = i;
-      // if the var is not a dataflow var, then it is live
-      // after the block (we are not checking later blocks)
-      if (!var.as<DataflowVarNode>()) {
+      // if the var is not a dataflow var, then it may be live after the block
+      if (is_live_after(var)) {
         range_end = block->bindings.size();
       }
       if (!ret.count(var)) {
@@ -75,8 +80,8 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
     }
 
     if (!ret.count(defined_var)) {
-      // if it's an output, then it lives past the end of the block
-      if (!defined_var.as<DataflowVarNode>()) {
+      // if it's an output used later, then it lives past the end of the block
+      if (is_live_after(defined_var)) {
         ret[defined_var] = {i, block->bindings.size()};
       } else {
         // otherwise, it's live only here
@@ -102,9 +107,12 @@ class AliasAnalyzer {
   // that correspond to tuples (this maps to sets of memory locations for each tuple element).
   // Note: inputs are values that should be assumed not to be aliased and are therefore
   // (in the case of in-place ops) safe to overwrite. This may not be true of function args.
+  // The prior blocks are the binding blocks of the enclosing function that precede the block,
+  // so that the vars they define are not treated as unknown external values.
   std::pair<std::unordered_map<Var, std::unordered_set<int>>,
             std::unordered_map<int, std::vector<std::unordered_set<int>>>>
-  Analyze(const DataflowBlock& block, const Array<Var>& inputs) {
+  Analyze(const DataflowBlock& block, const Array<Var>& inputs,
+          const Array<BindingBlock>& prior_blocks = {}) {
     for (auto input : inputs) {
       int curr_idx = get_fresh_idx();
       alias_map_[input] = {curr_idx};
@@ -113,6 +121,27 @@ class AliasAnalyzer {
       }
     }
 
+    std::unordered_set<int> escaped;
+    for (const BindingBlock& prior_block : prior_blocks) {
+      bool is_dataflow = prior_block.as<DataflowBlockNode>();
+      for (const Binding& binding : prior_block->bindings) {
+        Expr value = GetBoundValue(binding);
+        alias_map_[binding->var] = GetAliasSet(value, binding->var);
+        // Outside of dataflow blocks, an impure call, a closure or control flow may keep a
+        // reference to its arguments, so none of their aliases may be overwritten later.
+        if (!is_dataflow && MayRetainArguments(value)) {
+          for (const Var& var : AllVars(value)) {
+            if (alias_map_.count(var)) {
+              for (int alias_idx : alias_map_[var]) {
+                AddCapturedIndices(&escaped, alias_idx);
+              }
+            }
+          }
+        }
+      }
+    }
+    MarkEscaped(escaped);
+
     for (const Binding& binding : block->bindings) {
       Var current_var = binding->var;
       Expr value = GetBoundValue(binding);
@@ -129,6 +158,40 @@ class AliasAnalyzer {
     return ret;
   }
 
+  static bool MayRetainArguments(const Expr& value) {
+    if (auto* call_node = value.as<CallNode>()) {
+      return IsImpureCall(GetRef<Call>(call_node));
+    }
+    return value.as<FunctionNode>() || value.as<IfNode>() || value.as<SeqExprNode>();
+  }
+
+  // Treat every location that may alias an escaped one as an unknown external value (-1)
+  void MarkEscaped(const std::unordered_set<int>& escaped) {
+    if (escaped.empty()) {
+      return;
+    }
+    auto intersects = [&escaped](const std::unordered_set<int>& alias_set) {
+      for (int alias_idx : alias_set) {
+        if (escaped.count(alias_idx)) {
+          return true;
+        }
+      }
+      return false;
+    };
+    for (auto& kv : alias_map_) {
+      if (intersects(kv.second)) {
+        kv.second.insert(-1);
+      }
+    }
+    for (auto& kv : tuple_map_) {
+      for (auto& member_set : kv.second) {
+        if (intersects(member_set)) {
+          member_set.insert(-1);
+        }
+      }
+    }
+  }
+
   // Fresh tuple = each element is assumed to be a unique allocation
   void InsertFreshTuple(int tup_idx, const TupleStructInfoNode* tup_info) {
     std::vector<std::unordered_set<int>> tuple_set;
@@ -225,6 +288,9 @@ class AliasAnalyzer {
     if (value.as<ConstantNode>() || value.as<PrimValueNode>() || value.as<FunctionNode>()) {
       // TODO(@slyubomirsky): We will probably want special handling for closures
       ret.insert(get_fresh_idx());
+    } else if (value.as<IfNode>() || value.as<SeqExprNode>()) {
+      // only found outside of dataflow blocks: the result may be any value of the branches
+      ret.insert(-1);
     } else if (auto* target_var_node = value.as<VarNode>()) {
       auto target_var = GetRef<Var>(target_var_node);
       if (alias_map_.count(target_var)) {
@@ -263,6 +329,9 @@ class AliasAnalyzer {
         // call_pure_packed: treat as non-op call
         if (op_node->name == "relax.call_pure_packed") {
           return HandleMysteryCall(call_node, bound_var, true);
+        } else if (op_node->name == "relax.call_tir_inplace") {
+          // the results are written into some of the arguments
+          return HandleMysteryCall(call_node, bound_var);
         } else if (op_node->name == "relax.call_tir") {
           // call_tir: can potentially return a tuple
           if (auto* tuple_struct_info = call_node->sinfo_args[0].as<TupleStructInfoNode>()) {
@@ -510,11 +579,117 @@ bool InplaceConditionsMet(
 }
 
 // this is obviously not a complete list
-static std::unordered_set<std::string> SUPPORTED_OPS = {"relax.add",      "relax.subtract",
-                                                        "relax.multiply", "relax.divide",
-                                                        "relax.nn.silu",  "relax.nn.relu"};
+// (all of these legalize to elementwise TOPI computations)
+static std::unordered_set<std::string> SUPPORTED_OPS = {
+    "relax.add",     "relax.subtract", "relax.multiply",   "relax.divide",  "relax.maximum",
+    "relax.minimum", "relax.power",    "relax.exp",        "relax.log",     "relax.sqrt",
+    "relax.rsqrt",   "relax.negative", "relax.abs",        "relax.sigmoid", "relax.tanh",
+    "relax.clip",    "relax.nn.silu",  "relax.nn.relu",    "relax.nn.gelu", "relax.nn.gelu_tanh"};
 bool OpSupportsInplace(const Op& op) { return SUPPORTED_OPS.count(op->name); }
 
+// Checks whether a PrimFunc can write its output into the buffer of one of its inputs.
+// This holds when both buffers are only accessed inside blocks at exactly the data-parallel
+// iteration point of the block (so every element is read before it is overwritten), and no block
+// reads the input after a block that wrote the output.
+class InplaceAccessChecker : public tir::StmtExprVisitor {
+ public:
+  static bool Check(const tir::PrimFunc& func, const tir::Var& input, const tir::Var& output) {
+    if (!func->buffer_map.count(input) || !func->buffer_map.count(output)) {
+      return false;
+    }
+    InplaceAccessChecker checker(func->buffer_map.at(input)->data,
+                                 func->buffer_map.at(output)->data);
+    checker(func->body);
+    return checker.safe_;
+  }
+
+ private:
+  InplaceAccessChecker(const tir::Var& input_data, const tir::Var& output_data)
+      : input_data_(input_data), output_data_(output_data) {}
+
+  void VisitStmt_(const tir::BlockNode* op) final {
+    for (const tir::MatchBufferRegion& match : op->match_buffers) {
+      if (IsChecked(match->source->buffer->data)) {
+        safe_ = false;
+      }
+    }
+    const tir::BlockNode* outer_block = block_;
+    bool outer_writes_output = block_writes_output_;
+    block_ = op;
+    block_writes_output_ = false;
+    tir::StmtExprVisitor::VisitStmt_(op);
+    output_written_ = output_written_ || block_writes_output_;
+    block_ = outer_block;
+    block_writes_output_ = outer_writes_output || block_writes_output_;
+  }
+
+  void VisitExpr_(const tir::BufferLoadNode* op) final {
+    if (op->buffer->data.same_as(input_data_) && output_written_) {
+      safe_ = false;
+    }
+    CheckAccess(op->buffer, op->indices);
+    tir::StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const tir::BufferStoreNode* op) final {
+    if (op->buffer->data.same_as(output_data_)) {
+      block_writes_output_ = true;
+    }
+    CheckAccess(op->buffer, op->indices);
+    tir::StmtExprVisitor::VisitStmt_(op);
+  }
+
+  // any other use of the data pointers (e.g. an extern call) may access arbitrary elements
+  void VisitExpr_(const tir::VarNode* op) final {
+    if (IsChecked(GetRef<tir::Var>(op))) {
+      safe_ = false;
+    }
+  }
+
+  void CheckAccess(const tir::Buffer& buffer, const Array<PrimExpr>& indices) {
+    if (!IsChecked(buffer->data)) {
+      return;
+    }
+    if (block_ == nullptr || block_->iter_vars.size() != indices.size()) {
+      safe_ = false;
+      return;
+    }
+    for (size_t i = 0; i < indices.size(); i++) {
+      if (block_->iter_vars[i]->iter_type != tir::kDataPar ||
+          !indices[i].same_as(block_->iter_vars[i]->var)) {
+        safe_ = false;
+      }
+    }
+  }
+
+  bool IsChecked(const tir::Var& var) const {
+    return var.same_as(input_data_) || var.same_as(output_data_);
+  }
+
+  tir::Var input_data_;
+  tir::Var output_data_;
+  const tir::BlockNode* block_ = nullptr;
+  bool block_writes_output_ = false;
+  bool output_written_ = false;
+  bool safe_ = true;
+};
+
+// Returns the PrimFunc called by a call_tir with a single tensor output and an explicit
+// argument tuple, or nothing if the call cannot be made in-place.
+Optional<tir::PrimFunc> GetInplaceCandidatePrimFunc(const CallNode* call_node,
+                                                    const BlockBuilder& ctx) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  if (!call_node->op.same_as(call_tir_op) || !call_node->args[1].as<TupleNode>() ||
+      !call_node->sinfo_args[0].as<TensorStructInfoNode>()) {
+    return NullOpt;
+  }
+  auto gv = call_node->args[0].as<GlobalVar>();
+  if (!gv || !ctx->GetContextIRModule()->functions.count(gv.value())) {
+    return NullOpt;
+  }
+  return ctx->GetContextIRModule()->Lookup(gv.value()).as<tir::PrimFunc>();
+}
+
 /*! \brief Corresponds to a binding where at least one argument meets the conditions to be
  *  made in-place. Contains the binding index and indices of the applicable arguments
  */
@@ -547,6 +722,39 @@ class InplaceOpportunity : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(InplaceOpportunity, ObjectRef, InplaceOpportunityNode);
 };
 
+// Check that the output of a call_tir can be written into argument `arg_idx` by the PrimFunc,
+// considering every other argument that may alias it as well.
+bool PrimFuncArgSupportsInplace(const tir::PrimFunc& func, const Array<Expr>& args,
+                                const std::unordered_map<Var, std::unordered_set<int>>& alias_sets,
+                                int arg_idx) {
+  if (func->params.size() <= args.size()) {
+    return false;
+  }
+  const tir::Var& output = func->params[args.size()];
+  if (!InplaceAccessChecker::Check(func, func->params[arg_idx], output)) {
+    return false;
+  }
+  auto* target = args[arg_idx].as<VarNode>();
+  if (!target || !alias_sets.count(GetRef<Var>(target))) {
+    return false;
+  }
+  const auto& target_aliases = alias_sets.at(GetRef<Var>(target));
+  for (size_t i = 0; i < args.size(); i++) {
+    auto* other = args[i].as<VarNode>();
+    if (static_cast<int>(i) == arg_idx || !other || !alias_sets.count(GetRef<Var>(other))) {
+      continue;
+    }
+    bool may_alias = false;
+    for (int alias_idx : alias_sets.at(GetRef<Var>(other))) {
+      may_alias = may_alias || target_aliases.count(alias_idx);
+    }
+    if (may_alias && !InplaceAccessChecker::Check(func, func->params[i], output)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Check for in-place eligibility:
 //  1. see if there's an arg big enough to hold the result
 //  2. see if the arg is live past the call
@@ -560,15 +768,29 @@ class InplaceOpportunity : public ObjectRef {
 // For both lists, each element is a list of ints of the following format:
 //   The first element is the index of the *binding* in the block.
 //   All remaining elements are the indices of *eligible arguments* in that call.
+// For call_tir, the argument indices refer to the fields of the argument tuple.
+// If the enclosing function is known, prior_blocks are the binding blocks before this one and
+// live_after holds the vars used after it, so that values defined in earlier blocks and dead
+// after this one can also be overwritten.
 std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>>
 FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
-                         const BlockBuilder& ctx) {
-  auto live_ranges = AnalyzeLiveness(block);
+                         const BlockBuilder& ctx, const Array<BindingBlock>& prior_blocks = {},
+                         const std::unordered_set<Var>* live_after = nullptr) {
+  auto live_ranges = AnalyzeLiveness(block, live_after);
   AliasAnalyzer analyzer;
-  auto alias_info = analyzer.Analyze(block, inputs);
+  auto alias_info = analyzer.Analyze(block, inputs, prior_blocks);
   auto alias_sets = alias_info.first;
   auto tuple_map = alias_info.second;
 
+  // values from earlier blocks that are not used in this one may still alias a candidate
+  if (live_after != nullptr) {
+    for (const Var& var : *live_after) {
+      if (alias_sets.count(var) && !live_ranges.count(var)) {
+        live_ranges[var] = {-1, static_cast<int>(block->bindings.size())};
+      }
+    }
+  }
+
   std::vector<InplaceOpportunity> size_match_list;
   std::vector<InplaceOpportunity> exact_match_list;
 
@@ -616,9 +838,14 @@ FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
 
     if (auto* call_node = value.as<CallNode>()) {
       if (auto* op_node = call_node->op.as<OpNode>()) {
-        if (!OpSupportsInplace(GetRef<Op>(op_node))) {
+        Optional<tir::PrimFunc> prim_func = GetInplaceCandidatePrimFunc(call_node, ctx);
+        if (!prim_func && !OpSupportsInplace(GetRef<Op>(op_node))) {
           continue;
         }
+        Array<Expr> args = call_node->args;
+        if (prim_func) {
+          args = Downcast<Tuple>(call_node->args[1])->fields;
+        }
 
         std::unordered_set<int> candidates;
         std::unordered_set<int> exact_match_candidates;
@@ -630,8 +857,8 @@ FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
         }
 
         // Check that at least one argument matches size with the result
-        for (size_t j = 0; j < call_node->args.size(); j++) {
-          auto arg = call_node->args[j];
+        for (size_t j = 0; j < args.size(); j++) {
+          auto arg = args[j];
           for (auto target : target_sinfo) {
             auto [matches_size, matches_exactly] = SizeMatches(target, GetStructInfo(arg), ctx);
             if (matches_size) {
@@ -651,7 +878,9 @@ FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
         std::unordered_set<int> remove_candidates;
         for (auto candidate : candidates) {
           if (!InplaceConditionsMet(live_ranges, alias_sets, tuple_map, currently_live,
-                                    call_node->args[candidate], i)) {
+                                    args[candidate], i) ||
+              (prim_func && !PrimFuncArgSupportsInplace(prim_func.value(), args, alias_sets,
+                                                        candidate))) {
             remove_candidates.insert(candidate);
           }
         }
@@ -799,11 +1028,37 @@ class ModuleInplaceTransformer : public ExprMutator {
   Expr VisitExpr_(const FunctionNode* op) override {
     auto old_func_params = func_params;
     func_params = op->params;
+    if (auto* seq = op->body.as<SeqExprNode>()) {
+      AnalyzeFunctionBlocks(GetRef<SeqExpr>(seq));
+    }
     auto ret = ExprMutator::VisitExpr_(op);
     func_params = old_func_params;
     return ret;
   }
 
+  // Record, for each top-level dataflow block of a function body, the blocks before it and the
+  // vars used after it, so that in-place opportunities can be found across block boundaries.
+  void AnalyzeFunctionBlocks(const SeqExpr& seq) {
+    std::unordered_set<Var> live;
+    for (const Var& var : AllVars(seq->body)) {
+      live.insert(var);
+    }
+    for (int i = static_cast<int>(seq->blocks.size()) - 1; i >= 0; i--) {
+      const BindingBlock& block = seq->blocks[i];
+      if (block.as<DataflowBlockNode>()) {
+        BlockContext& context = block_contexts[block.get()];
+        context.prior_blocks = Array<BindingBlock>(seq->blocks.begin(), seq->blocks.begin() + i);
+        context.live_after = live;
+      }
+      for (const Binding& binding : block->bindings) {
+        Expr value = GetBoundValue(binding);
+        for (const Var& var : value.as<FunctionNode>() ? FreeVars(value) : AllVars(value)) {
+          live.insert(var);
+        }
+      }
+    }
+  }
+
   // the only case we will override: we will visit all binding blocks
   // and replace any valid calls in them
   BindingBlock VisitBindingBlock_(const DataflowBlockNode* op) override {
@@ -813,7 +1068,13 @@ class ModuleInplaceTransformer : public ExprMutator {
     // For now, only handle exact match cases.
     // Note: Not passing any input values for now, as we can't make any assumptions
     // about them.
-    auto matches_found = FindInplaceOpportunities(block, {}, builder_);
+    // Blocks at the top level of a function body are analyzed together with the rest of it.
+    auto it = block_contexts.find(op);
+    auto matches_found =
+        it == block_contexts.end()
+            ? FindInplaceOpportunities(block, {}, builder_)
+            : FindInplaceOpportunities(block, {}, builder_, it->second.prior_blocks,
+                                       &it->second.live_after);
     Map<Binding, Array<Integer>> new_idxs;
     for (auto match : matches_found.second) {
       new_idxs.Set(block->bindings[match->binding_idx.IntValue()], match->arg_idxs);
@@ -830,7 +1091,9 @@ class ModuleInplaceTransformer : public ExprMutator {
     // now replace the binding appropriately
     auto arg_idxs = inplace_idxs.at(binding);
     auto target = Downcast<Call>(GetBoundValue(binding));
-    auto new_call = CreateInplaceCall(target, {arg_idxs[0]});
+    static const auto& call_tir_op = Op::Get("relax.call_tir");
+    auto new_call = target->op.same_as(call_tir_op) ? CreateInplaceCallTIR(target, {arg_idxs[0]})
+                                                    : CreateInplaceCall(target, {arg_idxs[0]});
     return builder_->Normalize(new_call);
   }
 
@@ -860,16 +1123,23 @@ class ModuleInplaceTransformer : public ExprMutator {
   // (Made public for testing.)
   Call CreateInplaceCall(const Call& call, const Array<Integer>& inplace_indices) {
     static const auto& legalize_map = Op::GetAttrMap<FLegalize>("FLegalize");
-    static const auto& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
 
     auto op = Downcast<Op>(call->op);
     auto legalized_call = Downcast<Call>(legalize_map[op](builder_, call));
-    auto* legalized_call_cow = legalized_call.CopyOnWrite();
 
     // The legalized call should be call_tir. We will replace it with call_tir_inplace
     // and replace the called PrimFunc with an inplace version
     auto legal_op = Downcast<GlobalVar>(legalized_call->args[0]);
     legalizers_added.push_back(legal_op);
+    return CreateInplaceCallTIR(legalized_call, inplace_indices);
+  }
+
+  // Replace a call_tir with a call_tir_inplace to an in-place version of the called PrimFunc.
+  // The original PrimFunc is left in the module, other calls may still use it.
+  Call CreateInplaceCallTIR(Call call_tir, const Array<Integer>& inplace_indices) {
+    static const auto& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
+
+    auto legal_op = Downcast<GlobalVar>(call_tir->args[0]);
     auto inline_legal_op_name = legal_op->name_hint + "_inplace";
 
     auto mod = builder_->GetContextIRModule();
@@ -878,7 +1148,8 @@ class ModuleInplaceTransformer : public ExprMutator {
     tir::Stmt new_body = old_primfunc->body;
 
     size_t num_outs = inplace_indices.size();
-    size_t num_params = old_primfunc->params.size();
+    // the outputs follow the inputs (and may be followed by the TIR vars of the call)
+    size_t num_inputs = Downcast<Tuple>(call_tir->args[1])->fields.size();
 
     // the replacement we must make:
     // 1. For each output var, replace its corresponding buffers with the corresponding inplace
@@ -891,7 +1162,7 @@ class ModuleInplaceTransformer : public ExprMutator {
     Map<tir::Var, tir::Var> var_subst_map;
     for (size_t i = 0; i < num_outs; i++) {
       // we will substitute output i with the corresponding param indicated by inplace indices
-      auto output_var = old_primfunc->params[num_params - num_outs + i];
+      auto output_var = old_primfunc->params[num_inputs + i];
       auto inplace_var = old_primfunc->params[inplace_indices[i].IntValue()];
       var_subst_map.Set(output_var, inplace_var);
 
@@ -914,13 +1185,16 @@ class ModuleInplaceTransformer : public ExprMutator {
     // remove the now-unused outputs from the buffer map
     auto new_buffer_map = old_primfunc->buffer_map;
     for (size_t i = 0; i < num_outs; i++) {
-      new_buffer_map.erase(old_primfunc->params[num_params - num_outs + i]);
+      new_buffer_map.erase(old_primfunc->params[num_inputs + i]);
     }
 
-    // now get rid of the last num_outputs arguments
+    // now get rid of the output arguments
     // (couldn't do earlier or else it would have thrown off the indexing)
     Array<tir::Var> new_params(old_primfunc->params.begin(),
-                               old_primfunc->params.begin() + (num_params - num_outs));
+                               old_primfunc->params.begin() + num_inputs);
+    for (size_t i = num_inputs + num_outs; i < old_primfunc->params.size(); i++) {
+      new_params.push_back(old_primfunc->params[i]);
+    }
 
     tir::PrimFunc new_primfunc(new_params, new_body, old_primfunc->ret_type, new_buffer_map,
                                old_primfunc->attrs, old_primfunc->span);
@@ -930,17 +1204,18 @@ class ModuleInplaceTransformer : public ExprMutator {
     auto new_gv = builder_->AddFunction(new_primfunc, inline_legal_op_name);
 
     // update the call (change the op, update the argument, change the attrs)
-    legalized_call_cow->op = call_tir_inplace_op;
+    auto* call_cow = call_tir.CopyOnWrite();
+    call_cow->op = call_tir_inplace_op;
 
-    Array<Expr> new_args(legalized_call->args.begin(), legalized_call->args.end());
+    Array<Expr> new_args(call_tir->args.begin(), call_tir->args.end());
     new_args.Set(0, new_gv);
-    legalized_call_cow->args = new_args;
+    call_cow->args = new_args;
 
     ObjectPtr<CallTIRInplaceAttrs> attrs = make_object<CallTIRInplaceAttrs>();
     attrs->inplace_indices = inplace_indices;
-    legalized_call_cow->attrs = Attrs(attrs);
+    call_cow->attrs = Attrs(attrs);
 
-    return legalized_call;
+    return call_tir;
   }
 
   // Made public for testing.
@@ -955,6 +1230,14 @@ class ModuleInplaceTransformer : public ExprMutator {
   Array<Var> func_params;
   // map of eligible bindings to indices of arguments that can be used as the in-place target
   Map<Binding, Array<Integer>> inplace_idxs;
+  // The enclosing function seen from a dataflow block
+  struct BlockContext {
+    // binding blocks of the function before the dataflow block
+    Array<BindingBlock> prior_blocks;
+    // vars used after the dataflow block
+    std::unordered_set<Var> live_after;
+  };
+  std::unordered_map<const DataflowBlockNode*, BlockContext> block_contexts;
 };
 
 namespace transform {
@@ -24,22 +24,214 @@
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/type.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace tvm {
 namespace relax {
 
+/*!
+ * \brief Build a PrimFunc for the CPU.
+ * \return The built function, or nullopt if the function cannot be built.
+ */
+Optional<PackedFunc> BuildForCPU(const tir::PrimFunc& func) {
+  Target eval_cpu_target{"llvm"};
+  try {
+    // Not all the primfunc can be directly built via llvm, for example, if a function is
+    // already scheduled to only work on GPU, we will need to skip this in the const folder for
+    // now
+    // TODO(Hongyi): further check and narrow the scope of foldable function
+    runtime::Module rt_module =
+        build(LowerPrimFunc(func, "tir_function"), eval_cpu_target, eval_cpu_target);
+    return rt_module.GetFunction("tir_function");
+  } catch (const tvm::Error& err) {
+    // build failure may happen in which case we skip
+    DLOG(WARNING) << "Build failure for function " << func << ", Error message: " << err.what();
+  }
+  return NullOpt;
+}
+
+/*! \brief Evaluate a built PrimFunc on constant arguments into a new output tensor. */
+runtime::NDArray EvaluateOnCPU(const PackedFunc& func, const Array<runtime::NDArray>& arr_args,
+                               runtime::ShapeTuple shape, DataType ret_type) {
+  // here the vector size has an additional + 1 because we need to put ret_tensor at the end
+  std::vector<TVMValue> values(arr_args.size() + 1);
+  std::vector<int> type_codes(arr_args.size() + 1);
+
+  DLDevice cpu_dev = {DLDeviceType::kDLCPU, 0};
+  runtime::NDArray ret_tensor = runtime::NDArray::Empty(shape, ret_type, cpu_dev);
+
+  // avoid set rvalue ref which get de-allocated later, store args in a vector
+  // where temp_args[i] are lvalue ref that is stable
+  std::vector<runtime::NDArray> temp_args(arr_args.begin(), arr_args.end());
+
+  size_t arg_offset = 0;
+  for (; arg_offset < arr_args.size(); ++arg_offset) {
+    runtime::TVMArgsSetter(values.data(), type_codes.data())(arg_offset, temp_args[arg_offset]);
+  }
+  // set return value
+  runtime::TVMArgsSetter(values.data(), type_codes.data())(arg_offset++, ret_tensor);
+
+  TVMRetValue ret;
+  // invoke
+  func.CallPacked(TVMArgs(values.data(), type_codes.data(), values.size()), &ret);
+  return ret_tensor;
+}
+
+/*!
+ * \brief The evaluator of the foldable calls in the batched mode of FoldConstant.
+ *
+ * A round of folding queues the calls whose arguments are all constant instead of evaluating
+ * them. The evaluator then builds the PrimFuncs of the queued calls in one module, with a single
+ * LLVM invocation, and evaluates the calls in parallel. The next round folds the calls to their
+ * results, which makes the calls using them foldable in turn.
+ */
+class BatchedConstEvaluator {
+ public:
+  /*!
+   * \brief Get the result of a call evaluated in a previous round, or queue the call.
+   * \return The result, or nullopt if the call is not evaluated yet or cannot be.
+   */
+  Optional<runtime::NDArray> Lookup(const tir::PrimFunc& func,
+                                    const Array<runtime::NDArray>& arr_args,
+                                    runtime::ShapeTuple shape, DataType ret_type) {
+    auto it_func = func_index_.find(func);
+    if (it_func == func_index_.end()) {
+      it_func = func_index_.emplace(func, funcs_.size()).first;
+      funcs_.push_back(func);
+    }
+    int func_index = it_func->second;
+    if (func_index < static_cast<int>(built_.size()) && !built_[func_index].defined()) {
+      return NullOpt;
+    }
+    // The constants of a call are the same arrays from round to round.
+    std::ostringstream os;
+    os << func_index << ":" << ret_type << shape;
+    for (const runtime::NDArray& arr : arr_args) {
+      os << ":" << arr.get();
+    }
+    std::string key = os.str();
+    auto it_result = results_.find(key);
+    if (it_result != results_.end()) {
+      return it_result->second;
+    }
+    if (!queued_keys_.count(key)) {
+      queued_keys_.insert(key);
+      queued_.push_back(QueuedCall{func_index, arr_args, shape, ret_type, key});
+    }
+    return NullOpt;
+  }
+
+  /*!
+   * \brief Build and evaluate the queued calls.
+   * \return Whether any call is evaluated, in which case another round can fold more.
+   */
+  bool Evaluate() {
+    BuildNewFuncs();
+    std::vector<QueuedCall> calls;
+    for (QueuedCall& call : queued_) {
+      if (built_[call.func_index].defined()) {
+        calls.push_back(std::move(call));
+      }
+    }
+    queued_.clear();
+    queued_keys_.clear();
+    if (calls.empty()) return false;
+    int num_calls = calls.size();
+    std::vector<runtime::NDArray> outputs(num_calls);
+    support::parallel_for_dynamic(0, num_calls,
+                                  std::min(runtime::threading::MaxConcurrency(), num_calls),
+                                  [&](int thread_id, int i) {
+                                    const QueuedCall& call = calls[i];
+                                    outputs[i] = EvaluateOnCPU(built_[call.func_index].value(),
+                                                               call.arr_args, call.shape,
+                                                               call.ret_type);
+                                  });
+    for (int i = 0; i < num_calls; ++i) {
+      results_[calls[i].key] = outputs[i];
+      // The arguments stay alive, so that their addresses in the keys are not reused.
+      evaluated_args_.push_back(std::move(calls[i].arr_args));
+    }
+    return true;
+  }
+
+ private:
+  struct QueuedCall {
+    int func_index;
+    Array<runtime::NDArray> arr_args;
+    runtime::ShapeTuple shape;
+    DataType ret_type;
+    std::string key;
+  };
+
+  /*! \brief Build the functions which are not built yet in one module. */
+  void BuildNewFuncs() {
+    int begin = built_.size();
+    int end = funcs_.size();
+    if (begin == end) return;
+    auto func_name = [](int index) { return "tir_function_" + std::to_string(index); };
+    Target eval_cpu_target{"llvm"};
+    try {
+      IRModule mod;
+      for (int i = begin; i < end; ++i) {
+        mod->Update(LowerPrimFunc(funcs_[i], func_name(i)));
+      }
+      runtime::Module rt_module = build(mod, eval_cpu_target, eval_cpu_target);
+      for (int i = begin; i < end; ++i) {
+        built_.push_back(rt_module.GetFunction(func_name(i)));
+      }
+    } catch (const tvm::Error& err) {
+      // Some function cannot be built for the CPU, so build them one by one to skip it.
+      built_.resize(begin);
+      for (int i = begin; i < end; ++i) {
+        built_.push_back(BuildForCPU(funcs_[i]));
+      }
+    }
+  }
+
+  /*! \brief The index of each function, via structural equality. */
+  std::unordered_map<tir::PrimFunc, int, StructuralHash, StructuralEqual> func_index_;
+  /*! \brief The functions, in the order of their indices. */
+  std::vector<tir::PrimFunc> funcs_;
+  /*! \brief The built functions, or nullopt for those which cannot be built. */
+  std::vector<Optional<PackedFunc>> built_;
+  /*! \brief The calls to evaluate after the current round. */
+  std::vector<QueuedCall> queued_;
+  std::unordered_set<std::string> queued_keys_;
+  /*! \brief The results of the evaluated calls. */
+  std::unordered_map<std::string, runtime::NDArray> results_;
+  std::vector<Array<runtime::NDArray>> evaluated_args_;
+};
+
 class ConstantFolder : public ExprMutator {
  public:
-  static Function Fold(Function func, IRModule ctx_module) {
-    ConstantFolder folder(std::move(ctx_module));
-    func = Downcast<Function>(RemoveAllUnused(folder(func)));
+  static Function Fold(Function func, IRModule ctx_module, bool batched) {
+    if (!batched) {
+      ConstantFolder folder(std::move(ctx_module), nullptr);
+      func = Downcast<Function>(RemoveAllUnused(folder(func)));
+      return func;
+    }
+    // Each round folds the calls evaluated after the previous one.
+    BatchedConstEvaluator evaluator;
+    do {
+      ConstantFolder folder(ctx_module, &evaluator);
+      func = Downcast<Function>(RemoveAllUnused(folder(func)));
+    } while (evaluator.Evaluate());
     return func;
   }
 
  private:
-  explicit ConstantFolder(IRModule ctx_module) : ExprMutator(ctx_module) {}
+  ConstantFolder(IRModule ctx_module, BatchedConstEvaluator* evaluator)
+      : ExprMutator(ctx_module), evaluator_(evaluator) {}
 
   /*!
    * \brief Pattern match the shape inside the given struct info to a
@@ -101,28 +293,12 @@ class ConstantFolder : public ExprMutator {
    * \return The cached func, nullopt if func cannot be built.
    */
   Optional<PackedFunc> GetCachedBuild(tir::PrimFunc func) {
-    // TODO(tvm-team): consider another way of bulk extract and build PrimFunc once
-    // would be helpful for future cases where PrimFunc recursively call into each other
-    Target eval_cpu_target{"llvm"};
-
+    // NOTE: the batched mode builds the functions of a round in bulk, see BatchedConstEvaluator.
     auto it = func_build_cache_.find(func);
     if (it != func_build_cache_.end()) {
       return it->second;
     }
-    Optional<PackedFunc> build_func = NullOpt;
-
-    try {
-      // Not all the primfunc can be directly built via llvm, for example, if a function is
-      // already scheduled to only work on GPU, we will need to skip this in the const folder for
-      // now
-      // TODO(Hongyi): further check and narrow the scope of foldable function
-      runtime::Module rt_module =
-          build(LowerPrimFunc(func, "tir_function"), eval_cpu_target, eval_cpu_target);
-      build_func = rt_module.GetFunction("tir_function");
-    } catch (const tvm::Error& err) {
-      // build failure may happen in which case we skip
-      DLOG(WARNING) << "Build failure for function " << func << ", Error message: " << err.what();
-    }
+    Optional<PackedFunc> build_func = BuildForCPU(func);
     func_build_cache_[func] = build_func;
     return build_func;
   }
@@ -144,32 +320,15 @@ class ConstantFolder : public ExprMutator {
   // if failed return NullOpt
   Optional<Expr> ConstEvaluateCallTIR(tir::PrimFunc tir_func, Array<runtime::NDArray> arr_args,
                                       runtime::ShapeTuple shape, DataType ret_type) {
+    if (evaluator_ != nullptr) {
+      Optional<runtime::NDArray> result = evaluator_->Lookup(tir_func, arr_args, shape, ret_type);
+      if (!result) return NullOpt;
+      return Constant(result.value());
+    }
     // obtain function from the cache.
     Optional<PackedFunc> func = GetCachedBuild(tir_func);
     if (!func) return NullOpt;
-
-    // here the vector size has an additional + 1 because we need to put ret_tensor at the end
-    std::vector<TVMValue> values(arr_args.size() + 1);
-    std::vector<int> type_codes(arr_args.size() + 1);
-
-    DLDevice cpu_dev = {DLDeviceType::kDLCPU, 0};
-    runtime::NDArray ret_tensor = runtime::NDArray::Empty(shape, ret_type, cpu_dev);
-
-    // avoid set rvalue ref which get de-allocated later, store args in a vector
-    // where temp_args[i] are lvalue ref that is stable
-    std::vector<runtime::NDArray> temp_args(arr_args.begin(), arr_args.end());
-
-    size_t arg_offset = 0;
-    for (; arg_offset < arr_args.size(); ++arg_offset) {
-      runtime::TVMArgsSetter(values.data(), type_codes.data())(arg_offset, temp_args[arg_offset]);
-    }
-    // set return value
-    runtime::TVMArgsSetter(values.data(), type_codes.data())(arg_offset++, ret_tensor);
-
-    TVMRetValue ret;
-    // invoke
-    func.value().CallPacked(TVMArgs(values.data(), type_codes.data(), values.size()), &ret);
-    return Constant(ret_tensor);
+    return Constant(EvaluateOnCPU(func.value(), arr_args, shape, ret_type));
   }
 
   // Returns the folded expr if the call is successfully folded to constant, otherwise null.
@@ -317,13 +476,15 @@ class ConstantFolder : public ExprMutator {
   // cache for function build, via structural equality
   std::unordered_map<tir::PrimFunc, Optional<runtime::PackedFunc>, StructuralHash, StructuralEqual>
       func_build_cache_;
+  // the evaluator of the batched mode, or nullptr to evaluate each call as it is visited
+  BatchedConstEvaluator* evaluator_;
 };
 
 namespace transform {
 
-Pass FoldConstant() {
+Pass FoldConstant(bool batched) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
-      [=](Function f, IRModule m, PassContext pc) { return ConstantFolder::Fold(f, m); };
+      [=](Function f, IRModule m, PassContext pc) { return ConstantFolder::Fold(f, m, batched); };
   return CreateFunctionPass(pass_func, 0, "FoldConstant", {});
 }
 
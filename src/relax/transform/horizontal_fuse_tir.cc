@@ -0,0 +1,521 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/horizontal_fuse_tir.cc
+ * \brief Fuse independent small GPU kernels of a dataflow block into one kernel.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <map>
+#include <optional>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief A scheduled PrimFunc that launches one kernel on a one-dimensional grid. */
+struct KernelInfo {
+  /*! \brief The loop bound to blockIdx.x. */
+  tir::For block_loop;
+  /*! \brief The buffers allocated by the root block. */
+  Array<tir::Buffer> alloc_buffers;
+  /*! \brief The number of thread blocks. */
+  int64_t num_blocks;
+  /*!
+   * \brief The kernels of the same key can share a launch: they have the same thread extents,
+   *        dtype of the block index and target.
+   */
+  std::string key;
+};
+
+/*!
+ * \brief Analyze the kernel of a PrimFunc.
+ * \return The kernel, or std::nullopt if the PrimFunc is not a single kernel whose grid and
+ *         thread extents are static, with blockIdx.x as its only grid axis.
+ */
+std::optional<KernelInfo> AnalyzeKernel(const tir::PrimFunc& func) {
+  KernelInfo info;
+  tir::Stmt body = func->body;
+  if (const auto* realize = body.as<tir::BlockRealizeNode>()) {
+    const tir::Block& root = realize->block;
+    if (!root->match_buffers.empty() || root->init.defined()) {
+      return std::nullopt;
+    }
+    info.alloc_buffers = root->alloc_buffers;
+    body = root->body;
+  }
+  const auto* loop = body.as<tir::ForNode>();
+  if (!loop || loop->kind != tir::ForKind::kThreadBinding || !is_zero(loop->min) ||
+      loop->thread_binding.value()->thread_tag != "blockIdx.x" ||
+      !loop->extent->IsInstance<IntImmNode>()) {
+    return std::nullopt;
+  }
+  info.block_loop = GetRef<tir::For>(loop);
+  info.num_blocks = Downcast<IntImm>(loop->extent)->value;
+
+  std::map<std::string, int64_t> thread_extents;
+  bool valid = true;
+  tir::PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+    if (const auto* attr = obj.as<tir::AttrStmtNode>()) {
+      if (attr->attr_key == tir::attr::thread_extent ||
+          attr->attr_key == tir::attr::virtual_thread) {
+        valid = false;
+      }
+      return;
+    }
+    const auto* inner = obj.as<tir::ForNode>();
+    if (!inner || inner->kind != tir::ForKind::kThreadBinding) {
+      return;
+    }
+    std::string tag = inner->thread_binding.value()->thread_tag;
+    const auto* extent = inner->extent.as<IntImmNode>();
+    if (tag.rfind("threadIdx.", 0) != 0 || !extent) {
+      valid = false;
+      return;
+    }
+    auto it = thread_extents.find(tag);
+    if (it == thread_extents.end()) {
+      thread_extents[tag] = extent->value;
+    } else if (it->second != extent->value) {
+      valid = false;
+    }
+  });
+  if (!valid) {
+    return std::nullopt;
+  }
+
+  std::ostringstream os;
+  os << loop->loop_var.dtype();
+  for (const auto& [tag, extent] : thread_extents) {
+    os << "," << tag << "=" << extent;
+  }
+  if (Optional<Target> target = func->GetAttr<Target>(tvm::attr::kTarget)) {
+    os << "," << target.value()->str();
+  }
+  info.key = os.str();
+  return info;
+}
+
+/*!
+ * \brief Plan the fusion and the order of the bindings of a dataflow block.
+ *
+ * A binding is a candidate if it is a call_tir of a kernel of at most max_num_blocks thread
+ * blocks, which does not fill the GPU on its own. Candidates are, in order, added to the group of
+ * the same kernel key, as long as they do not depend on the group, even through other groups.
+ * The bindings are then scheduled in topological order, each group at the position of its first
+ * member, and the other bindings in their original order.
+ */
+class HorizontalFusionPlanner {
+ public:
+  /*! \brief A scheduled node: a binding, or a group of call_tir bindings. */
+  using Node = std::vector<int>;
+
+  HorizontalFusionPlanner(const Array<Binding>& bindings, const IRModule& mod,
+                          int64_t max_num_blocks)
+      : bindings_(bindings), mod_(mod), max_num_blocks_(max_num_blocks) {}
+
+  /*!
+   * \brief Plan the schedule of the bindings.
+   * \return The scheduled nodes, or an empty vector if no kernels are fused.
+   */
+  std::vector<Node> Plan() {
+    int num_bindings = bindings_.size();
+    std::unordered_map<const VarNode*, int> binding_index;
+    for (int i = 0; i < num_bindings; i++) {
+      binding_index[bindings_[i]->var.get()] = i;
+    }
+    std::vector<std::vector<int>> deps(num_bindings);
+    int last_match_cast = -1;
+    for (int i = 0; i < num_bindings; i++) {
+      for (const Var& var : FreeVars(GetBoundValue(bindings_[i]))) {
+        auto it = binding_index.find(var.get());
+        if (it != binding_index.end()) {
+          deps[i].push_back(it->second);
+        }
+      }
+      // The symbolic variables a match_cast defines may be used by any later binding.
+      if (last_match_cast != -1) {
+        deps[i].push_back(last_match_cast);
+      }
+      if (bindings_[i]->IsInstance<MatchCastNode>()) {
+        last_match_cast = i;
+      }
+    }
+
+    // Step 1. Find the candidates and the keys of their kernels.
+    std::vector<std::string> keys(num_bindings);
+    int num_candidates = 0;
+    for (int i = 0; i < num_bindings; i++) {
+      if (std::optional<KernelInfo> kernel = GetCandidateKernel(bindings_[i])) {
+        keys[i] = kernel->key;
+        num_candidates++;
+      }
+    }
+    if (num_candidates < 2) {
+      return {};
+    }
+
+    // Step 2. Group the candidates.
+    std::vector<int> group_of(num_bindings, -1);
+    std::vector<std::vector<int>> groups;
+    // The groups each binding, and each group, depends on, directly or through other bindings.
+    std::vector<std::unordered_set<int>> binding_group_deps(num_bindings);
+    std::vector<std::unordered_set<int>> group_deps;
+    std::unordered_map<std::string, int> open_group;
+    for (int i = 0; i < num_bindings; i++) {
+      for (int dep : deps[i]) {
+        const std::unordered_set<int>& dep_groups = binding_group_deps[dep];
+        binding_group_deps[i].insert(dep_groups.begin(), dep_groups.end());
+        if (group_of[dep] != -1) {
+          binding_group_deps[i].insert(group_of[dep]);
+        }
+      }
+      if (keys[i].empty()) {
+        continue;
+      }
+      auto it = open_group.find(keys[i]);
+      if (it != open_group.end() &&
+          !DependsOnGroup(binding_group_deps[i], it->second, group_deps)) {
+        int group = it->second;
+        groups[group].push_back(i);
+        group_deps[group].insert(binding_group_deps[i].begin(), binding_group_deps[i].end());
+        group_of[i] = group;
+      } else {
+        group_of[i] = groups.size();
+        open_group[keys[i]] = groups.size();
+        groups.push_back({i});
+        group_deps.push_back(binding_group_deps[i]);
+      }
+    }
+    if (static_cast<int>(groups.size()) == num_candidates) {
+      return {};
+    }
+
+    // Step 3. Schedule the bindings and the groups in topological order.
+    std::vector<Node> nodes;
+    std::vector<int> node_of(num_bindings, -1);
+    for (int i = 0; i < num_bindings; i++) {
+      if (group_of[i] != -1 && groups[group_of[i]][0] != i) {
+        node_of[i] = node_of[groups[group_of[i]][0]];
+      } else {
+        node_of[i] = nodes.size();
+        nodes.push_back(group_of[i] != -1 ? groups[group_of[i]] : Node{i});
+      }
+    }
+    std::vector<int> num_pending_deps(nodes.size(), 0);
+    std::vector<std::vector<int>> users(nodes.size());
+    for (int n = 0; n < static_cast<int>(nodes.size()); n++) {
+      std::unordered_set<int> node_deps;
+      for (int i : nodes[n]) {
+        for (int dep : deps[i]) {
+          node_deps.insert(node_of[dep]);
+        }
+      }
+      for (int dep : node_deps) {
+        users[dep].push_back(n);
+      }
+      num_pending_deps[n] = node_deps.size();
+    }
+    std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+    for (int n = 0; n < static_cast<int>(nodes.size()); n++) {
+      if (num_pending_deps[n] == 0) {
+        ready.push(n);
+      }
+    }
+    std::vector<Node> schedule;
+    while (!ready.empty()) {
+      int n = ready.top();
+      ready.pop();
+      schedule.push_back(nodes[n]);
+      for (int user : users[n]) {
+        if (--num_pending_deps[user] == 0) {
+          ready.push(user);
+        }
+      }
+    }
+    ICHECK_EQ(schedule.size(), nodes.size()) << "InternalError: the fused kernels form a cycle";
+    return schedule;
+  }
+
+  /*!
+   * \return The kernel the binding launches, or std::nullopt if the binding is not a call_tir
+   *         that can be fused.
+   */
+  std::optional<KernelInfo> GetCandidateKernel(const Binding& binding) const {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (!var_binding) {
+      return std::nullopt;
+    }
+    const auto* call = var_binding->value.as<CallNode>();
+    // call_tir with symbolic variable arguments is not fused.
+    if (!call || !call->op.same_as(call_tir_op) || call->args.size() != 2) {
+      return std::nullopt;
+    }
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    const auto* args = call->args[1].as<TupleNode>();
+    if (!gv || !args || !mod_->ContainGlobalVar(gv->name_hint)) {
+      return std::nullopt;
+    }
+    const auto* func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>();
+    if (!func || func->params.size() != args->fields.size() + NumOutputs(call)) {
+      return std::nullopt;
+    }
+    for (const tir::Var& param : func->params) {
+      if (!func->buffer_map.count(param)) {
+        return std::nullopt;
+      }
+    }
+    std::optional<KernelInfo> kernel = AnalyzeKernel(GetRef<tir::PrimFunc>(func));
+    if (!kernel || kernel->num_blocks > max_num_blocks_) {
+      return std::nullopt;
+    }
+    return kernel;
+  }
+
+  /*! \return The number of output tensors of the call_tir. */
+  static size_t NumOutputs(const CallNode* call) {
+    if (const auto* tuple = call->sinfo_args[0].as<TupleStructInfoNode>()) {
+      return tuple->fields.size();
+    }
+    return 1;
+  }
+
+ private:
+  /*!
+   * \brief Whether the given groups depend, directly or through other groups, on the given
+   *        group.
+   */
+  static bool DependsOnGroup(const std::unordered_set<int>& deps, int group,
+                             const std::vector<std::unordered_set<int>>& group_deps) {
+    std::vector<int> stack(deps.begin(), deps.end());
+    std::vector<bool> visited(group_deps.size(), false);
+    while (!stack.empty()) {
+      int cur = stack.back();
+      stack.pop_back();
+      if (cur == group) {
+        return true;
+      }
+      if (visited[cur]) {
+        continue;
+      }
+      visited[cur] = true;
+      stack.insert(stack.end(), group_deps[cur].begin(), group_deps[cur].end());
+    }
+    return false;
+  }
+
+  Array<Binding> bindings_;
+  IRModule mod_;
+  int64_t max_num_blocks_;
+};
+
+/*!
+ * \brief Fuse kernels into one kernel, whose thread blocks are dispatched to the kernels by their
+ *        index.
+ *
+ * The parameters of the fused kernel are the inputs of the kernels, then their outputs, in
+ * order, which matches the calling convention of call_tir.
+ *
+ * \param funcs The PrimFuncs of the kernels.
+ * \param num_inputs The number of input parameters of each PrimFunc.
+ * \return The fused PrimFunc.
+ */
+tir::PrimFunc FuseKernels(const std::vector<tir::PrimFunc>& funcs,
+                          const std::vector<size_t>& num_inputs) {
+  Array<tir::Var> input_params;
+  Array<tir::Var> output_params;
+  Map<tir::Var, tir::Buffer> buffer_map;
+  Array<tir::Buffer> alloc_buffers;
+  std::vector<KernelInfo> kernels;
+  std::unordered_set<const tir::PrimFuncNode*> visited;
+  for (size_t i = 0; i < funcs.size(); i++) {
+    tir::PrimFunc func = funcs[i];
+    // A PrimFunc called several times is copied, so that each variable is defined once.
+    if (!visited.insert(func.get()).second) {
+      func = tir::RenewDefs(func);
+    }
+    for (size_t j = 0; j < func->params.size(); j++) {
+      const tir::Var& param = func->params[j];
+      (j < num_inputs[i] ? input_params : output_params).push_back(param);
+      buffer_map.Set(param, func->buffer_map[param]);
+    }
+    std::optional<KernelInfo> kernel = AnalyzeKernel(func);
+    ICHECK(kernel.has_value());
+    alloc_buffers.insert(alloc_buffers.end(), kernel->alloc_buffers.begin(),
+                         kernel->alloc_buffers.end());
+    kernels.push_back(kernel.value());
+  }
+
+  DataType dtype = kernels[0].block_loop->loop_var.dtype();
+  std::vector<int64_t> offsets = {0};
+  for (const KernelInfo& kernel : kernels) {
+    offsets.push_back(offsets.back() + kernel.num_blocks);
+  }
+  tir::Var block_idx("bx", dtype);
+  tir::Stmt body;
+  for (int i = static_cast<int>(kernels.size()) - 1; i >= 0; i--) {
+    // The thread blocks of kernel i are those of index offsets[i] to offsets[i + 1].
+    PrimExpr local_idx = block_idx;
+    if (offsets[i] != 0) {
+      local_idx = block_idx - IntImm(dtype, offsets[i]);
+    }
+    Map<tir::Var, PrimExpr> vmap{{kernels[i].block_loop->loop_var, local_idx}};
+    tir::Stmt kernel_body = tir::Substitute(kernels[i].block_loop->body, vmap);
+    body = body.defined()
+               ? tir::IfThenElse(block_idx < IntImm(dtype, offsets[i + 1]), kernel_body, body)
+               : kernel_body;
+  }
+  PrimExpr num_blocks = IntImm(dtype, offsets.back());
+  body = tir::For(block_idx, IntImm(dtype, 0), num_blocks, tir::ForKind::kThreadBinding, body,
+                  tir::IterVar(/*dom=*/Range(nullptr), /*var=*/tir::Var("blockIdx.x", dtype),
+                               /*iter_type=*/tir::kThreadIndex, /*thread_tag=*/"blockIdx.x"));
+  body = tir::BlockRealize(/*iter_values=*/{}, /*predicate=*/Bool(true),
+                           tir::Block(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{},
+                                      /*name_hint=*/"root", body, /*init=*/NullOpt,
+                                      alloc_buffers));
+
+  Array<tir::Var> params = input_params;
+  params.insert(params.end(), output_params.begin(), output_params.end());
+  return WithoutAttr(tir::PrimFunc(params, body, VoidType(), buffer_map, funcs[0]->attrs),
+                     tvm::attr::kGlobalSymbol);
+}
+
+/*! \brief Replace each group of independent call_tir by a call_tir of their fused kernel. */
+class HorizontalFuser : public ExprMutator {
+ public:
+  HorizontalFuser(const IRModule& mod, int64_t max_num_blocks)
+      : ExprMutator(mod), mod_(mod), max_num_blocks_(max_num_blocks) {}
+
+  IRModule Run() {
+    for (const auto& [gv, func] : mod_->functions) {
+      if (const auto* relax_func = func.as<FunctionNode>()) {
+        Function updated = Downcast<Function>(VisitExpr(GetRef<Function>(relax_func)));
+        if (!updated.same_as(func)) {
+          builder_->UpdateFunction(gv, updated);
+        }
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    std::vector<HorizontalFusionPlanner::Node> schedule =
+        HorizontalFusionPlanner(block->bindings, mod_, max_num_blocks_).Plan();
+    if (schedule.empty()) {
+      return ExprMutator::VisitBindingBlock_(block);
+    }
+    builder_->BeginDataflowBlock();
+    for (const HorizontalFusionPlanner::Node& node : schedule) {
+      if (node.size() == 1) {
+        VisitBinding(block->bindings[node[0]]);
+      } else {
+        std::vector<const VarBindingNode*> members;
+        for (int i : node) {
+          members.push_back(block->bindings[i].as<VarBindingNode>());
+        }
+        EmitGroup(members);
+      }
+    }
+    return builder_->EndBlock();
+  }
+
+ private:
+  void EmitGroup(const std::vector<const VarBindingNode*>& members) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    std::vector<tir::PrimFunc> funcs;
+    std::vector<size_t> num_inputs;
+    Array<Expr> inputs;
+    Array<StructInfo> outputs;
+    std::string name = "fused_horizontal";
+    for (const VarBindingNode* member : members) {
+      Call call = Downcast<Call>(member->value);
+      GlobalVar gv = Downcast<GlobalVar>(call->args[0]);
+      funcs.push_back(Downcast<tir::PrimFunc>(mod_->Lookup(gv)));
+      name += "_" + gv->name_hint;
+      Array<Expr> args = Downcast<Tuple>(call->args[1])->fields;
+      num_inputs.push_back(args.size());
+      for (const Expr& arg : args) {
+        inputs.push_back(VisitExpr(arg));
+      }
+      if (const auto* tuple = call->sinfo_args[0].as<TupleStructInfoNode>()) {
+        outputs.insert(outputs.end(), tuple->fields.begin(), tuple->fields.end());
+      } else {
+        outputs.push_back(call->sinfo_args[0]);
+      }
+    }
+    GlobalVar fused_gv = builder_->AddFunction(FuseKernels(funcs, num_inputs), name);
+    Var fused = builder_->Emit(
+        Call(call_tir_op, {fused_gv, Tuple(inputs)}, {}, {TupleStructInfo(outputs)}), "lv");
+
+    int index = 0;
+    for (const VarBindingNode* member : members) {
+      size_t num_outputs =
+          HorizontalFusionPlanner::NumOutputs(Downcast<Call>(member->value).get());
+      Expr value;
+      if (member->value.as<CallNode>()->sinfo_args[0].as<TupleStructInfoNode>()) {
+        Array<Expr> fields;
+        for (size_t j = 0; j < num_outputs; j++) {
+          fields.push_back(TupleGetItem(fused, index++));
+        }
+        value = Tuple(fields);
+      } else {
+        value = TupleGetItem(fused, index++);
+      }
+      ReEmitBinding(member, builder_->Normalize(value));
+    }
+  }
+
+  IRModule mod_;
+  int64_t max_num_blocks_;
+};
+
+namespace transform {
+
+Pass HorizontalFuseTIR(int64_t max_num_blocks) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return HorizontalFuser(mod, max_num_blocks).Run(); };
+  auto inner_pass = CreateModulePass(/*pass_function=*/pass_func,             //
+                                     /*opt_level=*/0,                         //
+                                     /*pass_name=*/"HorizontalFuseTIRInner",  //
+                                     /*required=*/{});
+  // Remove the PrimFuncs no longer called.
+  return tvm::transform::Sequential({inner_pass, DeadCodeElimination()}, "HorizontalFuseTIR");
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.HorizontalFuseTIR").set_body_typed(HorizontalFuseTIR);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -150,6 +150,9 @@ class CollectLastUsage : public ExprVisitor {
     // this occurs in an output, then current_binding_ will be
     // nullptr.
     last_usage_of_[op] = current_binding_;
+    if (in_stream_region_) {
+      stream_region_vars_.push_back(op);
+    }
   }
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* val) override {
@@ -160,7 +163,23 @@ class CollectLastUsage : public ExprVisitor {
     static const Op& mem_kill_storage = Op::Get("relax.memory.kill_storage");
     static const Op& vm_kill_object = Op::Get("relax.vm.kill_object");
 
-    if (val->op.same_as(vm_alloc_storage) || val->op.same_as(mem_alloc_storage)) {
+    static const Op& call_builtin_with_ctx = Op::Get("relax.call_builtin_with_ctx");
+
+    if (val->op.same_as(call_builtin_with_ctx) && val->args[0].as<ExternFuncNode>()) {
+      // The objects used while side streams run may still be in use by a kernel on another
+      // stream, until the streams are joined by `vm.builtin.stream_join`.
+      String name = Downcast<ExternFunc>(val->args[0])->global_symbol;
+      if (name == "vm.builtin.stream_switch") {
+        in_stream_region_ = true;
+      } else if (name == "vm.builtin.stream_join") {
+        for (const VarNode* var : stream_region_vars_) {
+          last_usage_of_[var] = current_binding_;
+        }
+        stream_region_vars_.clear();
+        in_stream_region_ = false;
+      }
+      ExprVisitor::VisitBinding_(binding, val);
+    } else if (val->op.same_as(vm_alloc_storage) || val->op.same_as(mem_alloc_storage)) {
       storage_objects_.insert(binding->var.get());
     } else if (val->op.same_as(mem_kill_tensor) || val->op.same_as(mem_kill_storage) ||
                val->op.same_as(vm_kill_object)) {
@@ -207,6 +226,13 @@ class CollectLastUsage : public ExprVisitor {
 
   // Trivial var-to-var bindings.
   std::unordered_map<const VarNode*, const VarNode*> trivial_bindings_;
+
+  // Whether side streams may run, since a `vm.builtin.stream_switch`
+  // and until the next `vm.builtin.stream_join`.
+  bool in_stream_region_{false};
+
+  // The variables used while side streams may run.
+  std::vector<const VarNode*> stream_region_vars_;
 };
 
 class KillInserter : public ExprMutator {
@@ -23,9 +23,14 @@
 #include <tvm/relax/expr.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
 
+#include <algorithm>
 #include <optional>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "utils.h"
 
@@ -225,6 +230,141 @@ class LazyOutputMutator : public ExprMutator {
   };
   std::optional<FunctionPlan> plan_;
 };
+
+/*!
+ * \brief Reorder the bindings of a function so that the parameters are transformed chain by chain.
+ *
+ * A chain is everything needed to produce an output passed to a callback parameter returning
+ * an empty tuple, such as `fset_output`. The loads are the calls to the other callback
+ * parameters, such as `fget_param`, and the MatchCast of their results. The chains are emitted
+ * `num_concurrent_chains` at a time: first the loads of the chains, then their computation, then
+ * their outputs. Other impure bindings are kept in place, and nothing is moved across them.
+ */
+class ParamChainScheduler {
+ public:
+  ParamChainScheduler(const Function& func, int num_concurrent_chains)
+      : num_concurrent_chains_(num_concurrent_chains) {
+    for (const Var& param : func->params) {
+      callbacks_.insert(param.get());
+    }
+  }
+
+  Array<Binding> Schedule(const Array<Binding>& bindings) {
+    Array<Binding> output;
+    std::vector<Binding> segment;
+    for (const Binding& binding : bindings) {
+      Kind kind = Classify(binding);
+      if (kind == Kind::kBarrier) {
+        ScheduleSegment(segment, &output);
+        segment.clear();
+        output.push_back(binding);
+      } else {
+        segment.push_back(binding);
+      }
+    }
+    ScheduleSegment(segment, &output);
+    return output;
+  }
+
+ private:
+  enum class Kind { kLoad = 0, kCompute = 1, kStore = 2, kBarrier = 3 };
+
+  Kind Classify(const Binding& binding) {
+    Expr value = GetBoundValue(binding);
+    Kind kind = Kind::kCompute;
+    if (const auto* call = value.as<CallNode>()) {
+      if (call->op->IsInstance<VarNode>() && callbacks_.count(call->op.as<VarNode>())) {
+        const auto* ret = call->struct_info_.as<TupleStructInfoNode>();
+        kind = ret && ret->fields.empty() ? Kind::kStore : Kind::kLoad;
+      } else if (IsImpureCall(GetRef<Call>(call))) {
+        kind = Kind::kBarrier;
+      }
+    } else if (binding->IsInstance<MatchCastNode>()) {
+      if (const auto* var = value.as<VarNode>(); var && loads_.count(var)) {
+        kind = Kind::kLoad;
+      }
+    }
+    if (kind == Kind::kLoad) {
+      loads_.insert(binding->var.get());
+    }
+    kinds_[binding->var.get()] = kind;
+    return kind;
+  }
+
+  void ScheduleSegment(const std::vector<Binding>& segment, Array<Binding>* output) {
+    size_t num_bindings = segment.size();
+    std::unordered_map<const VarNode*, size_t> index_of;
+    for (size_t i = 0; i < num_bindings; ++i) {
+      index_of[segment[i]->var.get()] = i;
+    }
+    std::vector<std::vector<size_t>> deps(num_bindings), users(num_bindings);
+    std::vector<size_t> stores;
+    for (size_t i = 0; i < num_bindings; ++i) {
+      for (const Var& var : FreeVars(GetBoundValue(segment[i]))) {
+        if (auto it = index_of.find(var.get()); it != index_of.end()) {
+          deps[i].push_back(it->second);
+          users[it->second].push_back(i);
+        }
+      }
+      if (kinds_[segment[i]->var.get()] == Kind::kStore) {
+        stores.push_back(i);
+      }
+    }
+
+    std::vector<bool> emitted(num_bindings, false);
+    // Emit the bindings needed by `roots` that are not emitted yet, loads first and stores last,
+    // in their original order otherwise.
+    auto emit = [&](const std::vector<size_t>& roots) {
+      std::vector<bool> needed(num_bindings, false);
+      std::vector<size_t> stack(roots.begin(), roots.end());
+      while (!stack.empty()) {
+        size_t i = stack.back();
+        stack.pop_back();
+        if (emitted[i] || needed[i]) continue;
+        needed[i] = true;
+        stack.insert(stack.end(), deps[i].begin(), deps[i].end());
+      }
+      std::vector<size_t> num_pending(num_bindings, 0);
+      std::set<std::pair<int, size_t>> ready;
+      for (size_t i = 0; i < num_bindings; ++i) {
+        if (!needed[i]) continue;
+        for (size_t dep : deps[i]) {
+          num_pending[i] += needed[dep];
+        }
+        if (num_pending[i] == 0) {
+          ready.emplace(static_cast<int>(kinds_[segment[i]->var.get()]), i);
+        }
+      }
+      while (!ready.empty()) {
+        size_t i = ready.begin()->second;
+        ready.erase(ready.begin());
+        emitted[i] = true;
+        output->push_back(segment[i]);
+        for (size_t user : users[i]) {
+          if (needed[user] && --num_pending[user] == 0) {
+            ready.emplace(static_cast<int>(kinds_[segment[user]->var.get()]), user);
+          }
+        }
+      }
+    };
+
+    for (size_t begin = 0; begin < stores.size(); begin += num_concurrent_chains_) {
+      size_t end = std::min(stores.size(), begin + num_concurrent_chains_);
+      emit(std::vector<size_t>(stores.begin() + begin, stores.begin() + end));
+    }
+    // The bindings no output depends on stay in their original order.
+    for (size_t i = 0; i < num_bindings; ++i) {
+      if (!emitted[i]) {
+        emit({i});
+      }
+    }
+  }
+
+  size_t num_concurrent_chains_;
+  std::unordered_set<const VarNode*> callbacks_;
+  std::unordered_set<const VarNode*> loads_;
+  std::unordered_map<const VarNode*, Kind> kinds_;
+};
 }  // namespace
 
 Function WithLazyInputs(Function func) {
@@ -243,6 +383,27 @@ Function WithLazyOutputs(Function func) {
   return func;
 }
 
+Function WithStreamedParamChains(Function func, int num_concurrent_chains) {
+  CHECK_GE(num_concurrent_chains, 1)
+      << "ValueError: The number of concurrent parameter chains must be positive, but was "
+      << num_concurrent_chains;
+  const auto* body = func->body.as<SeqExprNode>();
+  if (!body) {
+    return func;
+  }
+
+  ParamChainScheduler scheduler(func, num_concurrent_chains);
+  Array<BindingBlock> blocks = body->blocks.Map([&](const BindingBlock& block) -> BindingBlock {
+    Array<Binding> bindings = scheduler.Schedule(block->bindings);
+    if (block->IsInstance<DataflowBlockNode>()) {
+      return DataflowBlock(bindings, block->span);
+    }
+    return BindingBlock(bindings, block->span);
+  });
+  func.CopyOnWrite()->body = SeqExpr(blocks, body->body, body->span);
+  return func;
+}
+
 namespace transform {
 
 Pass LazyGetInput() {
@@ -275,6 +436,21 @@ Pass LazySetOutput() {
 
 TVM_REGISTER_GLOBAL("relax.transform.LazySetOutput").set_body_typed(LazySetOutput);
 
+Pass StreamParamChains(int num_concurrent_chains) {
+  auto pass_func = [=](Function func, IRModule, PassContext) -> Function {
+    if (!func->GetAttr<String>(tvm::attr::kGlobalSymbol).defined()) {
+      return func;
+    }
+    return WithStreamedParamChains(func, num_concurrent_chains);
+  };
+  return CreateFunctionPass(/*pass_function=*/pass_func,
+                            /*opt_level=*/0,
+                            /*pass_name=*/"StreamParamChains",
+                            /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.StreamParamChains").set_body_typed(StreamParamChains);
+
 }  // namespace transform
 }  // namespace relax
 }  // namespace tvm
@@ -48,10 +48,24 @@
  *
  * 2. Lift the regions identified in step 1 to a separate function and rewrite the original function
  * with `CUDAGraphRewriter`.
+ *
+ * A region that depends on captured symbolic variables is captured once per value of the
+ * variables. The `relax.rewrite_cuda_graph.capture_buckets` function attribute, a dict from the
+ * names of the symbolic variables to their bucket lists, e.g. `{"n": [1, 2, 4, 8]}`, bounds the
+ * number of captures instead. The variable is rounded up to the smallest bucket that fits, the
+ * inputs of the region are re-created from their static storage with the padded shape, and the
+ * outputs are viewed back with the original shape. Values beyond the largest bucket are still
+ * captured as is. This is only valid for batch-like variables, the computation must not mix the
+ * data across the padded dimension. A region is captured without padding unless the bucketed
+ * variables only appear in the leading dimension of its inputs and outputs, which are allocated
+ * with `R.memory.alloc_tensor`. `StaticPlanBlockMemory` uses the largest bucket as the upper
+ * bound of the variables without `tir_var_upper_bound`.
  */
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/backend.h>
 #include <tvm/relax/expr_functor.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/expr_functor.h>
 #include <tvm/tir/stmt_functor.h>
@@ -89,6 +103,10 @@ struct LiftedFunctionRewritePlan {
   std::vector<const VarNode*> inputs;
   // The tir vars in the original function that are propagated to the lifted function
   Optional<ShapeExpr> propogated_tir_vars = NullOpt;
+  // The bucketed tir vars to the expressions rounding them up to their buckets
+  Map<tir::Var, PrimExpr> bucket_remap;
+  // The inputs and outputs padded to the buckets, to their `R.memory.alloc_tensor` calls
+  std::unordered_map<const VarNode*, Call> padded_tensors;
 };
 
 /*! \brief Builder of the lifted function for cuda graph capturing or allocations */
@@ -248,6 +266,8 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
         auto num_inputs =
             func->attrs.GetAttr<Integer>(attr::kNumInput).value_or(Integer(func->params.size()));
         auto capture_symbolic_var_name_hints = ExtractSymbolicVarHints(func);
+        auto capture_buckets = ExtractCaptureBuckets(func);
+        std::unordered_set<const tir::VarNode*> fixed_symbolic_vars;
         for (int i = 0; i < static_cast<int>(func->params.size()); ++i) {
           Array<tir::Var> symbolic_vars = DefinableTIRVarsInStructInfo(
               Downcast<StructInfo>(func->params[i]->struct_info_.value()));
@@ -256,14 +276,24 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
               if (capture_symbolic_var_name_hints.count(symbolic_var->name_hint)) {
                 capture_symbolic_vars_.insert(symbolic_var.get());
               }
+              if (auto it = capture_buckets.find(symbolic_var->name_hint);
+                  it != capture_buckets.end()) {
+                capture_symbolic_vars_.insert(symbolic_var.get());
+                capture_buckets_[symbolic_var.get()] = it->second;
+              }
             }
           } else {
             static_vars_.insert(func->params[i].get());
             for (const auto& symbolic_var : symbolic_vars) {
               capture_symbolic_vars_.insert(symbolic_var.get());
+              fixed_symbolic_vars.insert(symbolic_var.get());
             }
           }
         }
+        // The fixed inputs are not padded, the variables in their shapes are not bucketed.
+        for (const auto* symbolic_var : fixed_symbolic_vars) {
+          capture_buckets_.erase(symbolic_var);
+        }
         disabled_storage_vars_ = OutputStorageCollector::Collect(func);
         VisitExpr(func);
       }
@@ -287,6 +317,9 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
       for (const auto* var : region->outputs_) {
         plan->outputs[var] = plan->outputs.size();
       }
+      if (!is_alloc) {
+        PlanBuckets(region, plan);
+      }
       return plan;
     };
 
@@ -312,6 +345,99 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     return {symbolic_var_names.begin(), symbolic_var_names.end()};
   }
 
+  /*!
+   * \brief Extract the sorted bucket lists of the symbolic variables from the
+   * 'relax.rewrite_cuda_graph.capture_buckets' function attribute.
+   */
+  std::unordered_map<String, std::vector<int64_t>> ExtractCaptureBuckets(const Function& func) {
+    auto buckets_attr =
+        func->attrs.GetAttr<Map<String, Array<Integer>>>("relax.rewrite_cuda_graph.capture_buckets")
+            .value_or(Map<String, Array<Integer>>());
+    auto upper_bounds = func->attrs.GetAttr<Map<String, Integer>>("tir_var_upper_bound")
+                            .value_or(Map<String, Integer>());
+    std::unordered_map<String, std::vector<int64_t>> capture_buckets;
+    for (const auto& [name, buckets] : buckets_attr) {
+      std::vector<int64_t> sorted_buckets;
+      for (const Integer& bucket : buckets) {
+        CHECK_GT(bucket->value, 0) << "ValueError: The capture buckets of " << name
+                                   << " should be positive, but got " << buckets;
+        if (auto upper_bound = upper_bounds.Get(name)) {
+          CHECK_LE(bucket->value, upper_bound.value()->value)
+              << "ValueError: The capture bucket " << bucket << " of " << name
+              << " exceeds its upper bound " << upper_bound.value();
+        }
+        sorted_buckets.push_back(bucket->value);
+      }
+      std::sort(sorted_buckets.begin(), sorted_buckets.end());
+      sorted_buckets.erase(std::unique(sorted_buckets.begin(), sorted_buckets.end()),
+                           sorted_buckets.end());
+      if (sorted_buckets.size()) {
+        capture_buckets[name] = std::move(sorted_buckets);
+      }
+    }
+    return capture_buckets;
+  }
+
+  /*!
+   * \brief Plan the padding of the bucketed symbolic variables of a capture region. The region is
+   * left unpadded unless every input and output that depends on the bucketed variables is a
+   * tensor allocated with `R.memory.alloc_tensor` whose leading dimension is the only one using
+   * them, so that the padded tensor keeps the original data as its leading rows.
+   */
+  void PlanBuckets(const FuncBuilder* region, LiftedFunctionRewritePlan* plan) {
+    Map<tir::Var, PrimExpr> bucket_remap;
+    for (const auto* var : region->shape_expr_inputs_) {
+      auto it = capture_buckets_.find(var);
+      if (it == capture_buckets_.end()) {
+        continue;
+      }
+      // Round up to the smallest bucket that fits, values beyond the largest bucket are kept.
+      tir::Var tir_var = GetRef<tir::Var>(var);
+      PrimExpr bucket = tir_var;
+      for (auto rit = it->second.rbegin(); rit != it->second.rend(); ++rit) {
+        PrimExpr bucket_value = IntImm(tir_var->dtype, *rit);
+        bucket = tir::Select(tir_var <= bucket_value, bucket_value, bucket);
+      }
+      bucket_remap.Set(tir_var, bucket);
+    }
+    if (bucket_remap.empty()) {
+      return;
+    }
+
+    auto is_bucketed = [&](const tir::VarNode* var) {
+      return bucket_remap.count(GetRef<tir::Var>(var)) > 0;
+    };
+    std::unordered_map<const VarNode*, Call> padded_tensors;
+    auto can_pad = [&](const VarNode* var) {
+      StructInfo sinfo = GetStructInfo(GetRef<Var>(var));
+      Array<tir::Var> tir_vars = TIRVarsInStructInfo(sinfo);
+      if (std::none_of(tir_vars.begin(), tir_vars.end(),
+                       [&](const tir::Var& tir_var) { return is_bucketed(tir_var.get()); })) {
+        return true;
+      }
+      const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+      auto it = alloc_tensor_calls_.find(var);
+      if (tensor_sinfo == nullptr || it == alloc_tensor_calls_.end() ||
+          !it->second->args[0]->IsInstance<VarNode>() ||
+          !it->second->args[2]->IsInstance<ShapeExprNode>()) {
+        return false;
+      }
+      auto shape = Downcast<ShapeExpr>(it->second->args[2])->values;
+      for (int i = 1; i < static_cast<int>(shape.size()); ++i) {
+        if (tir::UsesVar(shape[i], is_bucketed)) {
+          return false;
+        }
+      }
+      padded_tensors[var] = it->second;
+      return true;
+    };
+    if (std::all_of(region->inputs_.begin(), region->inputs_.end(), can_pad) &&
+        std::all_of(region->outputs_.begin(), region->outputs_.end(), can_pad)) {
+      plan->bucket_remap = std::move(bucket_remap);
+      plan->padded_tensors = std::move(padded_tensors);
+    }
+  }
+
   /*!
    *\brief Start a new static region. This method should be called when encountering a
    * CUDA kernel launch (calls to PrimFunc or ExternFunc) that only depends on static parameters.
@@ -352,7 +478,11 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     static const auto& mem_alloc_storage_op = Op::Get("relax.memory.alloc_storage");
     static const auto& builtin_alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
     static const auto& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+    static const auto& mem_alloc_tensor_op = Op::Get("relax.memory.alloc_tensor");
 
+    if (call->op.same_as(mem_alloc_tensor_op)) {
+      alloc_tensor_calls_[binding->var.get()] = GetRef<Call>(call);
+    }
     if (call->op.same_as(mem_alloc_storage_op)) {
       if (IsStaticAllocStorage(binding)) {
         AddStaticBinding(binding, /*is_alloc_storage=*/true);
@@ -616,6 +746,10 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
   // Symbolic variables that are allowed to be captured. This can come from symbolic shapes of
   // weights or hints in the function annotations.
   std::unordered_set<const tir::VarNode*> capture_symbolic_vars_;
+  // The sorted capture buckets of the symbolic variables
+  std::unordered_map<const tir::VarNode*, std::vector<int64_t>> capture_buckets_;
+  // The calls to R.memory.alloc_tensor that define the binding variables
+  std::unordered_map<const VarNode*, Call> alloc_tensor_calls_;
   // Binding to the FuncBuilder if the binding is lifted. This is used to update the inputs/outputs
   // of the lifted function when its binding is used outside.
   std::unordered_map<const VarNode*, FuncBuilder*> binding_to_region_;
@@ -733,7 +867,15 @@ Function MergeAllocationPlans(const std::vector<LiftedFunctionRewritePlan*>& all
 /*! \brief The rewriter for CUDA graph */
 class CUDAGraphRewriter : public ExprMutator {
  public:
-  explicit CUDAGraphRewriter(const IRModule& mod) : ExprMutator(mod) {}
+  /*!
+   * \param mod The module to rewrite.
+   * \param builtin_prefix The prefix of the VM builtins of the device graphs, which capture and
+   * launch CUDA graphs or HIP graphs.
+   */
+  CUDAGraphRewriter(const IRModule& mod, const String& builtin_prefix)
+      : ExprMutator(mod),
+        builtin_run_or_capture_(builtin_prefix + ".run_or_capture"),
+        builtin_get_cached_alloc_(builtin_prefix + ".get_cached_alloc") {}
 
   IRModule Rewrite() {
     CUDAGraphRewritePlanner planner(builder_->GetContextIRModule(), &arena_);
@@ -770,9 +912,6 @@ class CUDAGraphRewriter : public ExprMutator {
 
   void LaunchSubgraph(const VarBindingNode* op, const LiftedFunctionRewritePlan* plan) {
     static const auto& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
-    static const auto& builtin_run_or_capture = ExternFunc("vm.builtin.cuda_graph.run_or_capture");
-    static const auto& builtin_get_cached_alloc =
-        ExternFunc("vm.builtin.cuda_graph.get_cached_alloc");
 
     Expr launch_subgraph;
     if (plan->is_alloc) {
@@ -783,7 +922,7 @@ class CUDAGraphRewriter : public ExprMutator {
       auto ret_struct_info = Downcast<FuncStructInfo>(gv_alloc->struct_info_.value())->ret;
       launch_subgraph = Call(
           call_builtin_with_ctx_op,
-          {builtin_get_cached_alloc, Tuple({gv_alloc, PrimValue(IntImm(DataType::Int(64), 0))})},
+          {builtin_get_cached_alloc_, Tuple({gv_alloc, PrimValue(IntImm(DataType::Int(64), 0))})},
           Attrs(), {ret_struct_info});
     } else {
       auto gv_func = builder_->AddFunction(
@@ -792,10 +931,22 @@ class CUDAGraphRewriter : public ExprMutator {
       // Arguments of the lifted function
       Array<Expr> args;
       for (const auto& arg : plan->inputs) {
-        args.push_back(VisitExpr_(arg));
+        if (auto it = plan->padded_tensors.find(arg); it != plan->padded_tensors.end()) {
+          // Re-create the input from its storage with the shape padded to the bucket.
+          args.push_back(builder_->Emit(RemapAllocTensor(it->second, plan->bucket_remap),
+                                        arg->name_hint() + "_padded"));
+        } else {
+          args.push_back(VisitExpr_(arg));
+        }
       }
+      Optional<ShapeExpr> shape_expr_arg = NullOpt;
       if (plan->propogated_tir_vars.defined()) {
         ShapeExpr propogated_tir_vars = plan->propogated_tir_vars.value();
+        if (!plan->bucket_remap.empty()) {
+          propogated_tir_vars = ShapeExpr(propogated_tir_vars->values.Map(
+              [&](const PrimExpr& value) { return tir::Substitute(value, plan->bucket_remap); }));
+        }
+        shape_expr_arg = propogated_tir_vars;
         args.push_back(propogated_tir_vars);
         // The ret_struct_info of the lifted function can contain symbolic variables. We need to
         // bind the symbolic parameters to the actual values.
@@ -812,19 +963,24 @@ class CUDAGraphRewriter : public ExprMutator {
       // Arguments of builtin_run_or_capture
       Array<Expr> tuple_arg_fields{gv_func, Tuple(args),
                                    PrimValue(IntImm(DataType::Int(64), index_capture_++))};
-      if (plan->propogated_tir_vars.defined()) {
+      if (shape_expr_arg.defined()) {
         // The shape expr is explicitly passed twice, one as the last argument of the lifted
         // function, one as the last argument of builtin_run_or_capture as the cache key. Explicitly
         // passing it twice simplifies the handling during the capture phase.
-        tuple_arg_fields.push_back(plan->propogated_tir_vars.value());
+        tuple_arg_fields.push_back(shape_expr_arg.value());
       }
       launch_subgraph =
-          Call(call_builtin_with_ctx_op, {builtin_run_or_capture, Tuple(tuple_arg_fields)}, Attrs(),
-               {call_sinfo});
+          Call(call_builtin_with_ctx_op, {builtin_run_or_capture_, Tuple(tuple_arg_fields)},
+               Attrs(), {call_sinfo});
     }
     Expr ret_value = builder_->Emit(launch_subgraph);
     for (const auto& [var, tuple_index] : plan->outputs) {
-      var_redef_[var] = TupleGetItem(ret_value, tuple_index);
+      if (auto it = plan->padded_tensors.find(var); it != plan->padded_tensors.end()) {
+        // The output is padded in the lifted function, view its leading rows from the storage.
+        var_redef_[var] = RemapAllocTensor(it->second, {});
+      } else {
+        var_redef_[var] = TupleGetItem(ret_value, tuple_index);
+      }
     }
     std::transform(plan->lifted_bindings.begin(), plan->lifted_bindings.end(),
                    std::inserter(lifted_binding_vars_, lifted_binding_vars_.end()),
@@ -859,6 +1015,20 @@ class CUDAGraphRewriter : public ExprMutator {
     return GetRef<Expr>(op);
   }
 
+  /*!
+   * \brief Re-create the tensor of a R.memory.alloc_tensor call on the same storage, with the
+   * symbolic variables of its shape remapped.
+   */
+  Call RemapAllocTensor(const Call& alloc_tensor, const Map<tir::Var, PrimExpr>& tir_var_remap) {
+    auto shape = Downcast<ShapeExpr>(alloc_tensor->args[2]);
+    Array<PrimExpr> new_shape = shape->values.Map(
+        [&](const PrimExpr& value) { return tir::Substitute(value, tir_var_remap); });
+    return Call(alloc_tensor->op,
+                {VisitExpr(alloc_tensor->args[0]), alloc_tensor->args[1], ShapeExpr(new_shape),
+                 alloc_tensor->args[3]},
+                alloc_tensor->attrs, alloc_tensor->sinfo_args);
+  }
+
   Var EmitRedef(const VarNode* var, const Expr& redef) {
     auto new_var = builder_->Emit(redef, var->name_hint());
     var_remap_[var->vid] = new_var;
@@ -873,10 +1043,21 @@ class CUDAGraphRewriter : public ExprMutator {
   support::Arena arena_;
   Optional<GlobalVar> gv_global_alloc_ = NullOpt;
   Optional<GlobalVar> current_func_ = NullOpt;
+  /*! \brief The builtin which launches the graph of a lifted function, or captures it */
+  ExternFunc builtin_run_or_capture_;
+  /*! \brief The builtin which runs the lifted allocations once and caches them */
+  ExternFunc builtin_get_cached_alloc_;
 };
 
 IRModule RewriteCUDAGraph(IRModule mod) {
-  CUDAGraphRewriter rewriter(mod);
+  // The graphs are HIP graphs on ROCm, which have the same capture and replay semantics.
+  String builtin_prefix = "vm.builtin.cuda_graph";
+  if (Optional<Target> target = Target::Current(/*allow_not_defined=*/true)) {
+    if (target.value()->kind->name == "rocm") {
+      builtin_prefix = "vm.builtin.hip_graph";
+    }
+  }
+  CUDAGraphRewriter rewriter(mod, builtin_prefix);
   mod = rewriter.Rewrite();
   return mod;
 }
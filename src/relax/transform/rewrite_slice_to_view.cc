@@ -0,0 +1,248 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/rewrite_slice_to_view.cc
+ * \brief Rewrite the strided_slice, split and permute_dims within dataflow blocks, whose results
+ * are contiguous in the memory of their input, to relax.memory.view.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/attrs/manipulate.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <vector>
+
+#include "../op/memory/view.h"
+
+namespace tvm {
+namespace relax {
+
+class SliceToViewRewriter : public ExprMutator {
+ public:
+  explicit SliceToViewRewriter(bool allow_byte_offset) : allow_byte_offset_(allow_byte_offset) {}
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  BindingBlock VisitBindingBlock(const BindingBlock& block) final {
+    // We only rewrite the bindings inside dataflow blocks.
+    if (const auto* dataflow_block = block.as<DataflowBlockNode>()) {
+      return VisitBindingBlock_(dataflow_block);
+    } else {
+      return block;
+    }
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    // As RewriteDataflowReshape, we only rewrite the bindings that are not dataflow output.
+    if (!binding->var->IsInstance<DataflowVarNode>()) {
+      this->builder_->EmitNormalized(GetRef<VarBinding>(binding));
+    } else {
+      ExprMutator::VisitBinding_(binding);
+    }
+  }
+
+  Expr VisitExpr_(const CallNode* call) final {
+    static const Op& strided_slice_op = Op::Get("relax.strided_slice");
+    static const Op& split_op = Op::Get("relax.split");
+    static const Op& permute_dims_op = Op::Get("relax.permute_dims");
+    Call new_call = Downcast<Call>(ExprMutator::VisitExpr_(call));
+    Optional<Expr> rewritten;
+    if (new_call->op.same_as(strided_slice_op)) {
+      rewritten = RewriteStridedSlice(new_call);
+    } else if (new_call->op.same_as(split_op)) {
+      rewritten = RewriteSplit(new_call);
+    } else if (new_call->op.same_as(permute_dims_op)) {
+      rewritten = RewritePermuteDims(new_call);
+    }
+    return rewritten.value_or(new_call);
+  }
+
+  /*! \brief The shape of a tensor of a known dtype in whole bytes, or NullOpt. */
+  static Optional<Array<PrimExpr>> GetViewableShape(const StructInfo& sinfo) {
+    const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+    if (tensor_sinfo == nullptr || tensor_sinfo->IsUnknownDtype() ||
+        tensor_sinfo->dtype.bits() % 8 != 0 || tensor_sinfo->dtype.lanes() != 1) {
+      return NullOpt;
+    }
+    return tensor_sinfo->GetShape();
+  }
+
+  /*!
+   * \brief Get the offset in elements of a region of a row-major tensor, if the region is
+   * contiguous, i.e. it is full along the axes after some axis and has one element along the
+   * axes before it.
+   * \param shape The shape of the tensor.
+   * \param begin The begin of the region along each axis.
+   * \param region The shape of the region.
+   * \return The offset, or NullOpt if the region is not contiguous.
+   */
+  Optional<PrimExpr> GetContiguousOffset(const Array<PrimExpr>& shape,
+                                         const std::vector<PrimExpr>& begin,
+                                         const Array<PrimExpr>& region) {
+    int ndim = shape.size();
+    int axis = ndim - 1;
+    while (axis >= 0 && analyzer_.CanProveEqual(begin[axis], 0) &&
+           analyzer_.CanProveEqual(region[axis], shape[axis])) {
+      --axis;
+    }
+    for (int i = 0; i < axis; ++i) {
+      if (!analyzer_.CanProveEqual(region[i], 1)) {
+        return NullOpt;
+      }
+    }
+    PrimExpr offset = IntImm(DataType::Int(64), 0);
+    PrimExpr stride = IntImm(DataType::Int(64), 1);
+    for (int i = ndim - 1; i >= 0; --i) {
+      offset = offset + cast(DataType::Int(64), begin[i]) * stride;
+      stride = stride * cast(DataType::Int(64), shape[i]);
+    }
+    return analyzer_.Simplify(offset);
+  }
+
+  /*! \brief View `data` as a tensor of the shape, at the element offset. */
+  Optional<Expr> MakeView(const Expr& data, const Array<PrimExpr>& shape, PrimExpr offset) {
+    if (!analyzer_.CanProveEqual(offset, 0) && !allow_byte_offset_) {
+      return NullOpt;
+    }
+    DataType dtype = Downcast<TensorStructInfo>(GetStructInfo(data))->dtype;
+    PrimExpr byte_offset = analyzer_.Simplify(offset * (dtype.bits() / 8));
+    return view(data, ShapeExpr(shape), NullOpt, PrimValue(byte_offset));
+  }
+
+  Optional<Expr> RewriteStridedSlice(const Call& call) {
+    Expr data = call->args[0];
+    Optional<Array<PrimExpr>> shape = GetViewableShape(GetStructInfo(data));
+    Optional<Array<PrimExpr>> region = GetViewableShape(GetStructInfo(call));
+    const auto* axes = call->args[1].as<TupleNode>();
+    const auto* begins = call->args[2].as<TupleNode>();
+    if (!shape.defined() || !region.defined() || axes == nullptr || begins == nullptr) {
+      return NullOpt;
+    }
+    if (call->args.size() > 4) {
+      const auto* strides = call->args[4].as<TupleNode>();
+      if (strides == nullptr) return NullOpt;
+      for (const Expr& stride : strides->fields) {
+        const auto* value = stride.as<PrimValueNode>();
+        if (value == nullptr || !analyzer_.CanProveEqual(value->value, 1)) return NullOpt;
+      }
+    }
+    int ndim = shape.value().size();
+    std::vector<PrimExpr> begin(ndim, IntImm(DataType::Int(64), 0));
+    for (size_t i = 0; i < axes->fields.size(); ++i) {
+      const auto* axis = axes->fields[i].as<PrimValueNode>();
+      const auto* axis_begin = begins->fields[i].as<PrimValueNode>();
+      if (axis == nullptr || axis_begin == nullptr || !axis->value->IsInstance<IntImmNode>()) {
+        return NullOpt;
+      }
+      int64_t index = Downcast<IntImm>(axis->value)->value;
+      index = index < 0 ? index + ndim : index;
+      if (index < 0 || index >= ndim) return NullOpt;
+      // A negative begin counts from the end of the axis.
+      PrimExpr value = cast(DataType::Int(64), axis_begin->value);
+      if (const auto* imm = value.as<IntImmNode>(); imm && imm->value < 0) {
+        value = cast(DataType::Int(64), shape.value()[index]) + value;
+      }
+      if (!analyzer_.CanProve(value >= 0) ||
+          !analyzer_.CanProve(value + region.value()[index] <= shape.value()[index])) {
+        return NullOpt;
+      }
+      begin[index] = value;
+    }
+    if (Optional<PrimExpr> offset = GetContiguousOffset(shape.value(), begin, region.value())) {
+      return MakeView(data, region.value(), offset.value());
+    }
+    return NullOpt;
+  }
+
+  Optional<Expr> RewriteSplit(const Call& call) {
+    Expr data = call->args[0];
+    Optional<Array<PrimExpr>> shape = GetViewableShape(GetStructInfo(data));
+    const auto* pieces = GetStructInfoAs<TupleStructInfoNode>(call);
+    if (!shape.defined() || pieces == nullptr) {
+      return NullOpt;
+    }
+    int ndim = shape.value().size();
+    int axis = call->attrs.as<SplitAttrs>()->axis;
+    axis = axis < 0 ? axis + ndim : axis;
+    std::vector<PrimExpr> begin(ndim, IntImm(DataType::Int(64), 0));
+    Array<Expr> views;
+    for (const StructInfo& piece : pieces->fields) {
+      Optional<Array<PrimExpr>> region = GetViewableShape(piece);
+      if (!region.defined()) return NullOpt;
+      Optional<PrimExpr> offset = GetContiguousOffset(shape.value(), begin, region.value());
+      if (!offset.defined()) return NullOpt;
+      Optional<Expr> piece_view = MakeView(data, region.value(), offset.value());
+      if (!piece_view.defined()) return NullOpt;
+      views.push_back(piece_view.value());
+      begin[axis] = analyzer_.Simplify(begin[axis] + region.value()[axis]);
+    }
+    return Tuple(views);
+  }
+
+  Optional<Expr> RewritePermuteDims(const Call& call) {
+    Expr data = call->args[0];
+    Optional<Array<PrimExpr>> shape = GetViewableShape(GetStructInfo(data));
+    Optional<Array<PrimExpr>> permuted = GetViewableShape(GetStructInfo(call));
+    if (!shape.defined() || !permuted.defined()) {
+      return NullOpt;
+    }
+    int ndim = shape.value().size();
+    std::vector<int> axes;
+    if (Optional<Array<Integer>> attr_axes = call->attrs.as<PermuteDimsAttrs>()->axes) {
+      for (const Integer& axis : attr_axes.value()) {
+        axes.push_back(axis->value < 0 ? axis->value + ndim : axis->value);
+      }
+    } else {
+      for (int i = ndim - 1; i >= 0; --i) axes.push_back(i);
+    }
+    // The permutation keeps the memory layout if it only moves the axes of one element.
+    int last_axis = -1;
+    for (int axis : axes) {
+      if (analyzer_.CanProveEqual(shape.value()[axis], 1)) continue;
+      if (axis < last_axis) return NullOpt;
+      last_axis = axis;
+    }
+    return MakeView(data, permuted.value(), IntImm(DataType::Int(64), 0));
+  }
+
+  bool allow_byte_offset_;
+  arith::Analyzer analyzer_;
+};
+
+Expr RewriteSliceToView(const Function& f, bool allow_byte_offset) {
+  return SliceToViewRewriter(allow_byte_offset)(f);
+}
+
+namespace transform {
+
+Pass RewriteSliceToView(bool allow_byte_offset) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(relax::RewriteSliceToView(f, allow_byte_offset));
+      };
+  return CreateFunctionPass(pass_func, 0, "RewriteSliceToView", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.RewriteSliceToView").set_body_typed(RewriteSliceToView);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -63,15 +63,35 @@
  *   `R.func_attr({"tir_var_upper_bound": {"n": 1024}})`.
  * It means the maximum value of variable that names "n" in the function
  * signature will have upper bound 1024. And we will use 1024 as its value
- * during memory planning.
+ * during memory planning. The largest of the buckets in the
+ * "relax.rewrite_cuda_graph.capture_buckets" attribute is used as the upper
+ * bound of the TIR vars that are not annotated.
+ *
+ * The planning is aware of the streams assigned by the AssignStreams pass.
+ * It follows the `vm.builtin.stream_switch/sync/join` builtins, and only
+ * reuses a token for an allocation on stream s when every earlier use of
+ * the token either ran on s, or is known to have completed on s through a
+ * stream sync.
+ *
+ * A function with the attribute "relax.memory_plan_arena" set to true
+ * further packs the planned tokens of its top-level binding blocks into one
+ * storage per device, the arena. After the token planning above, each
+ * token has a lifetime, from its first allocation to its last use (or to
+ * the `vm.builtin.stream_join` after it, when it is used on a side stream),
+ * and a size, evaluated at the upper bounds of the TIR vars. The tokens are
+ * then placed at offsets of the arena by size, largest first, at the lowest
+ * aligned offset that does not overlap any placed token whose lifetime
+ * overlaps. The tokens whose size stays symbolic keep their own storage.
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/transform.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <functional>
 #include <map>
 #include <set>
 #include <vector>
@@ -106,6 +126,10 @@ class StorageTokenNode : public Object {
   std::string storage_scope;
   /*! \brief The storage id, reserved for debug and demo use. */
   int storage_id{-1};
+  /*! \brief The position of the last use of this token on each stream. */
+  std::map<int, int64_t> stream_last_use;
+  /*! \brief The positions of the first allocation and the last use of this token. */
+  int64_t lifetime_begin{-1}, lifetime_end{-1};
 
   /*! \brief Get the constant number of bytes that this token requires, or -1 if the number of bytes
    * is symbolic */
@@ -166,10 +190,12 @@ class TokenAllocator1D {
    * \brief Request a storage token from the available token pool for a
    * given prototype, or report no appropriate available token in the pool.
    * \param prototype The requesting prototype storage token.
+   * \param can_reuse The check of whether an available token can be reused.
    * \return The request result token. Return NullOpt if there is no
    * appropriate available token in the pool.
    */
-  Optional<StorageToken> RequestReuse(StorageToken prototype) {
+  Optional<StorageToken> RequestReuse(StorageToken prototype,
+                                      const std::function<bool(const StorageToken&)>& can_reuse) {
     // Step 0. Sanity check: the prototype token is supposed not to be allocated with actual storage
     ICHECK_EQ(prototype->storage_id, -1) << "The token is expected not to be allocated before.";
     // If the prototype has no reference at all, feel free to allocate new storage.
@@ -189,7 +215,8 @@ class TokenAllocator1D {
       auto [begin, end] = pool.equal_range(size);
       for (; begin != end; ++begin) {
         StorageToken available_token = begin->second;
-        if (analyzer_->CanProveEqual(prototype->bytes, available_token->bytes)) {
+        if (analyzer_->CanProveEqual(prototype->bytes, available_token->bytes) &&
+            can_reuse(available_token)) {
           ICHECK_EQ(available_token->ref_counter, 0)
               << "Available tokens are expected to have 0 reference.";
           available_token->ref_counter = prototype->ref_counter;
@@ -204,19 +231,25 @@ class TokenAllocator1D {
     auto mid = pool.lower_bound(size);
     auto end = pool.upper_bound(size * match_range_);
     // Step 3. Search for memory block that equals or is larger than the requested size.
-    if (mid != end) {
-      StorageToken available_token = mid->second;
+    for (auto it = mid; it != end; ++it) {
+      StorageToken available_token = it->second;
+      if (!can_reuse(available_token)) {
+        continue;
+      }
       ICHECK_EQ(available_token->ref_counter, 0)
           << "Available tokens are expected to have 0 reference.";
       ICHECK_LE(size, available_token->const_bytes());
       available_token->ref_counter = prototype->ref_counter;
-      pool.erase(mid);
+      pool.erase(it);
       return available_token;
     }
     // Step 4. Then search for memory block that is smaller than the requested size.
-    if (mid != begin) {
-      --mid;
-      StorageToken available_token = mid->second;
+    for (auto it = mid; it != begin;) {
+      --it;
+      StorageToken available_token = it->second;
+      if (!can_reuse(available_token)) {
+        continue;
+      }
       int64_t available_size = available_token->const_bytes();
       ICHECK_EQ(available_token->ref_counter, 0)
           << "Available tokens are expected to have 0 reference.";
@@ -225,7 +258,7 @@ class TokenAllocator1D {
       // Enlarge the token size.
       available_token->bytes = tir::make_const(DataType::Int(64), size);
       available_token->ref_counter = prototype->ref_counter;
-      pool.erase(mid);
+      pool.erase(it);
       return available_token;
     }
     // Return `NullOpt` indicating that no satisfiable storage token is found in the available pool.
@@ -286,8 +319,16 @@ class TokenAllocator1D {
   std::vector<StorageToken> full_pool_;
 };
 
-/*! \brief Check if the input op is "relax.reshape". */
-bool IsReshape(const Expr& op) { return op.same_as(Op::Get("relax.reshape")); }
+/*!
+ * \brief Check if the input op creates a view of its first argument, which is "relax.reshape" or
+ * the legalized "relax.memory.view".
+ */
+bool IsViewOfInput(const Expr& op) {
+  if (const auto* extern_func = op.as<ExternFuncNode>()) {
+    return extern_func->global_symbol == "runtime.TVMArrayCreateView";
+  }
+  return op.same_as(Op::Get("relax.reshape"));
+}
 
 /*! \brief The base class for the storage allocation visitor. */
 class StorageAllocatorBaseVisitor : public ExprVisitor {
@@ -383,6 +424,23 @@ void SetTIRVarUpperBound(Function func, arith::Analyzer* ana,
         << value->value << " is got.";
     var_upper_bound_attr[GetRef<String>(key)] = GetRef<IntImm>(value);
   }
+  // The variables bucketed for CUDA graph capturing are padded up to their buckets. Use the
+  // largest bucket as the upper bound of those without an annotated one.
+  Map<String, Array<Integer>> capture_buckets =
+      func->GetAttr<Map<String, Array<Integer>>>("relax.rewrite_cuda_graph.capture_buckets")
+          .value_or(Map<String, Array<Integer>>());
+  for (const auto& [name, buckets] : capture_buckets) {
+    if (var_upper_bound_attr.count(name) || buckets.empty()) {
+      continue;
+    }
+    int64_t max_bucket = 0;
+    for (const Integer& bucket : buckets) {
+      max_bucket = std::max(max_bucket, bucket->value);
+    }
+    CHECK_GT(max_bucket, 0) << "The capture buckets of " << name
+                            << " should be positive integers, while " << buckets << " is got.";
+    var_upper_bound_attr[name] = IntImm(DataType::Int(64), max_bucket);
+  }
   for (ObjectRef var_name : non_negative_var_attr_raw) {
     const auto* key = var_name.as<StringObj>();
     CHECK(key != nullptr) << "The element of attr `tir_non_negative_var` should be string. However "
@@ -498,7 +556,7 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
       // Create a storage token for builtin alloc_tensor.
       this->CreateToken(call);
       return;
-    } else if (IsReshape(call->op)) {
+    } else if (IsViewOfInput(call->op)) {
       // Reuse the input's token for builtin reshape.
       SetTokens(call, GetTokens(call->args[0]));
       return;
@@ -677,7 +735,7 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
  * initialization stage, we request a storage reuse or decide to allocate
  * storage for this token, depending on if there is appropriate available
  * token in the token pool we maintain.
- * - For each VM builtin reshape, we reuse the input's tokens.
+ * - For each VM builtin reshape and view, we reuse the input's tokens.
  *
  * After the allocation planning, we know the token that each builtin
  * alloc_tensor plans to use. Compared with the initialization, here
@@ -700,7 +758,15 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
       }
       // Clear the allocator to make the planning of different functions independent.
       allocator_.Clear();
+      cur_stream_ = 0;
+      stream_clock_.clear();
+      immediate_alloc_tensors_.clear();
+      stream_region_tokens_.clear();
+      token2device_.clear();
       this->VisitExpr_(func);
+      if (func->GetAttr<Bool>("relax.memory_plan_arena").value_or(Bool(false))) {
+        this->PlanArenas(func);
+      }
     }
   }
 
@@ -711,12 +777,40 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
   std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token;
   /*! \brief The mapping from each binding block to the storage tokens that are create inside. */
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens;
+  /*! \brief The mapping from each token packed into an arena to the arena and its offset. */
+  std::unordered_map<const StorageTokenNode*, std::pair<int, int64_t>> token2arena;
+  /*! \brief The number of bytes of each arena. */
+  std::vector<int64_t> arena_bytes;
 
  private:
   using ExprVisitor::VisitBinding_;
   using ExprVisitor::VisitExpr_;
 
   void VisitBindingBlock_(const BindingBlockNode* block) final {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    // Find the alloc_tensors that are followed, after only other alloc_tensors, by a call using
+    // them, which then run on the current stream at the alloc_tensor.
+    for (size_t i = 0; i < block->bindings.size(); ++i) {
+      const auto* call = GetBoundValue(block->bindings[i]).as<CallNode>();
+      if (call == nullptr || call->op != alloc_tensor_op) {
+        continue;
+      }
+      size_t j = i + 1;
+      const CallNode* user = nullptr;
+      for (; j < block->bindings.size(); ++j) {
+        user = GetBoundValue(block->bindings[j]).as<CallNode>();
+        if (user == nullptr || user->op != alloc_tensor_op) {
+          break;
+        }
+      }
+      if (user != nullptr && j < block->bindings.size()) {
+        const Var& var = block->bindings[i]->var;
+        if (std::any_of(user->args.begin(), user->args.end(),
+                        [&var](const Expr& arg) { return arg.same_as(var); })) {
+          immediate_alloc_tensors_.insert(call);
+        }
+      }
+    }
     StorageAllocatorBaseVisitor::VisitBindingBlock_(block);
     // Sanity check: each token allocated inside the block should not be
     // referenced by anyone at the end of the block.
@@ -727,6 +821,10 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
     static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    ++pos_;
+    if (VisitStreamBuiltin(call)) {
+      return;
+    }
     if (call->op == alloc_tensor_op) {
       auto it = token_map_.find(call);
       ICHECK(it != token_map_.end());
@@ -737,10 +835,33 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
         return;
       }
       ICHECK(it->second.IsLeaf());
-      StorageToken new_token = this->RequestReuseOrAlloc(it->second.LeafValue());
+      // When the stream of the user is unknown, only reuse the tokens that are safe on any stream.
+      std::function<bool(const StorageToken&)> can_reuse;
+      if (immediate_alloc_tensors_.count(call)) {
+        can_reuse = [this](const StorageToken& token) {
+          return CanReuseOnStream(token, cur_stream_);
+        };
+      } else {
+        can_reuse = [this](const StorageToken& token) {
+          int num_streams = std::max(static_cast<int>(stream_clock_.size()), 1);
+          for (int stream = 0; stream < num_streams; ++stream) {
+            if (!CanReuseOnStream(token, stream)) {
+              return false;
+            }
+          }
+          return true;
+        };
+      }
+      StorageToken new_token = this->RequestReuseOrAlloc(it->second.LeafValue(), can_reuse);
 
       // Record that this alloc_tensor is using the token.
       alloc_tensor2token.insert({call, new_token});
+      if (new_token->lifetime_begin == -1) {
+        new_token->lifetime_begin = pos_;
+        token2device_[new_token.get()] =
+            Downcast<IntImm>(Downcast<PrimValue>(call->args[2])->value)->value;
+      }
+      new_token->lifetime_end = std::max(new_token->lifetime_end, pos_);
       token2cur_tensor_[new_token.get()].push_back(binding->var);
       SetTokens(call, Tokens(new_token));
       // Record that the token is allocated in the current block.
@@ -751,7 +872,7 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
         block_tokens.push_back(new_token.get());
       }
       return;
-    } else if (IsReshape(call->op)) {
+    } else if (IsViewOfInput(call->op)) {
       Tokens tokens = GetTokens(call->args[0]);
       ICHECK(!tokens.IsNested());
       if (tokens.IsLeaf()) {
@@ -772,14 +893,155 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
       ForEachLeaf(tokens, [this](StorageToken token) {
         ICHECK_GT(token->ref_counter, 0);
         token->ref_counter -= 1;
+        token->stream_last_use[cur_stream_] = pos_;
+        token->lifetime_end = std::max(token->lifetime_end, pos_);
+        if (in_stream_region_) {
+          stream_region_tokens_.push_back(token);
+        }
         this->CheckForRelease(token);
       });
     }
   }
 
+  /*!
+   * \brief Follow the stream builtins inserted by AssignStreams.
+   * \return Whether the call is a stream builtin.
+   */
+  bool VisitStreamBuiltin(const CallNode* call) {
+    static const Op& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+    if (call->op != call_builtin_with_ctx_op) {
+      return false;
+    }
+    const auto* func = call->args[0].as<ExternFuncNode>();
+    if (func == nullptr) {
+      return false;
+    }
+    auto int_arg = [call](int index) {
+      return Downcast<IntImm>(Downcast<PrimValue>(Downcast<Tuple>(call->args[1])->fields[index])
+                                  ->value)
+          ->value;
+    };
+    if (func->global_symbol == "vm.builtin.stream_switch") {
+      cur_stream_ = int_arg(1);
+      GetClock(cur_stream_);
+      in_stream_region_ = true;
+    } else if (func->global_symbol == "vm.builtin.stream_sync") {
+      SyncStream(int_arg(1), int_arg(2));
+    } else if (func->global_symbol == "vm.builtin.stream_join") {
+      for (int stream = 1; stream < static_cast<int>(stream_clock_.size()); ++stream) {
+        SyncStream(stream, 0);
+      }
+      cur_stream_ = 0;
+      // The kernels of the side streams may use the tokens until the join.
+      for (const StorageToken& token : stream_region_tokens_) {
+        token->lifetime_end = std::max(token->lifetime_end, pos_);
+      }
+      stream_region_tokens_.clear();
+      in_stream_region_ = false;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  /*! \brief Get the clock of a stream, the position up to which each stream is synced with it. */
+  std::vector<int64_t>& GetClock(int stream) {
+    ICHECK_GE(stream, 0);
+    if (static_cast<int>(stream_clock_.size()) <= stream) {
+      stream_clock_.resize(stream + 1);
+    }
+    for (std::vector<int64_t>& clock : stream_clock_) {
+      clock.resize(stream_clock_.size(), -1);
+    }
+    return stream_clock_[stream];
+  }
+
+  /*! \brief Make the later uses on stream `dst` wait for the earlier uses on stream `src`. */
+  void SyncStream(int src, int dst) {
+    std::vector<int64_t> src_clock = GetClock(src);
+    std::vector<int64_t>& dst_clock = GetClock(dst);
+    for (size_t i = 0; i < dst_clock.size(); ++i) {
+      dst_clock[i] = std::max(dst_clock[i], src_clock[i]);
+    }
+    dst_clock[src] = pos_;
+  }
+
+  /*! \brief Check if every earlier use of the token is ordered before the later uses on stream. */
+  bool CanReuseOnStream(const StorageToken& token, int stream) {
+    for (const auto& [use_stream, use_pos] : token->stream_last_use) {
+      if (use_stream != stream && GetClock(stream)[use_stream] <= use_pos) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Pack the constant-sized global tokens of the top-level binding blocks of the function
+   * into one arena per device, by the lifetimes of the tokens.
+   * \param func The planned function.
+   */
+  void PlanArenas(const FunctionNode* func) {
+    const auto* seq = func->body.as<SeqExprNode>();
+    if (seq == nullptr) {
+      return;
+    }
+    std::map<int64_t, std::vector<const StorageTokenNode*>> device2tokens;
+    for (const BindingBlock& block : seq->blocks) {
+      // The vars of a dataflow block are not visible to the later blocks.
+      if (block->IsInstance<DataflowBlockNode>()) {
+        continue;
+      }
+      for (const StorageTokenNode* token : block2tokens[block.get()]) {
+        if (token->const_bytes() >= 0 && token->storage_scope == "global") {
+          device2tokens[token2device_.at(token)].push_back(token);
+        }
+      }
+    }
+    for (auto& [device, tokens] : device2tokens) {
+      if (tokens.size() <= 1) {
+        continue;
+      }
+      // Place the larger tokens first, each at the lowest aligned offset that is free during
+      // its lifetime.
+      std::stable_sort(tokens.begin(), tokens.end(),
+                       [](const StorageTokenNode* a, const StorageTokenNode* b) {
+                         return a->const_bytes() > b->const_bytes();
+                       });
+      int arena = arena_bytes.size();
+      int64_t total_bytes = 0;
+      std::vector<std::pair<int64_t, const StorageTokenNode*>> placed;
+      for (const StorageTokenNode* token : tokens) {
+        std::vector<std::pair<int64_t, const StorageTokenNode*>> overlapping;
+        for (const auto& item : placed) {
+          if (item.second->lifetime_begin <= token->lifetime_end &&
+              token->lifetime_begin <= item.second->lifetime_end) {
+            overlapping.push_back(item);
+          }
+        }
+        std::sort(overlapping.begin(), overlapping.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        int64_t offset = 0;
+        for (const auto& [other_offset, other] : overlapping) {
+          if (offset + token->const_bytes() <= other_offset) {
+            break;
+          }
+          int64_t other_end = other_offset + other->const_bytes();
+          offset = std::max(offset, (other_end + runtime::kAllocAlignment - 1) /
+                                        runtime::kAllocAlignment * runtime::kAllocAlignment);
+        }
+        placed.emplace_back(offset, token);
+        token2arena[token] = {arena, offset};
+        total_bytes = std::max(total_bytes, offset + token->const_bytes());
+      }
+      arena_bytes.push_back(total_bytes);
+    }
+  }
+
   /*! \brief Request a storage reuse, or allocate storage if no appropriate storage is reusable. */
-  StorageToken RequestReuseOrAlloc(StorageToken prototype) {
-    Optional<StorageToken> token = allocator_.RequestReuse(prototype);
+  StorageToken RequestReuseOrAlloc(StorageToken prototype,
+                                   const std::function<bool(const StorageToken&)>& can_reuse) {
+    Optional<StorageToken> token = allocator_.RequestReuse(prototype, can_reuse);
     if (!token.defined()) {
       return allocator_.Alloc(prototype, this->n_storage_++);
     } else {
@@ -806,6 +1068,23 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   /*! \brief Number of allocated storages. */
   int n_storage_{0};
+  /*! \brief The position of the current call binding, for ordering the uses on streams. */
+  int64_t pos_{0};
+  /*! \brief The stream at the current binding. */
+  int cur_stream_{0};
+  /*!
+   * \brief The clocks of the streams, where `stream_clock_[s][t]` means the uses on stream t
+   * before that position have completed before the later uses on stream s.
+   */
+  std::vector<std::vector<int64_t>> stream_clock_;
+  /*! \brief The alloc_tensors whose first user follows right after them. */
+  std::unordered_set<const CallNode*> immediate_alloc_tensors_;
+  /*! \brief Whether side streams may run, since a `vm.builtin.stream_switch`. */
+  bool in_stream_region_{false};
+  /*! \brief The tokens used since the last `vm.builtin.stream_switch`. */
+  std::vector<StorageToken> stream_region_tokens_;
+  /*! \brief The device index of the first allocation of each token. */
+  std::unordered_map<const StorageTokenNode*, int64_t> token2device_;
   /*! \brief The 1D memory allocator. */
   TokenAllocator1D allocator_;
   /*! \brief The mapping from each token to the tensors that are currently using it. */
@@ -823,10 +1102,14 @@ class StorageAllocationRewriter : public ExprMutator {
   explicit StorageAllocationRewriter(
       IRModule mod, std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token,
       std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>>
-          block2tokens)
+          block2tokens,
+      std::unordered_map<const StorageTokenNode*, std::pair<int, int64_t>> token2arena,
+      std::vector<int64_t> arena_bytes)
       : ExprMutator(std::move(mod)),
         alloc_tensor2token_(std::move(alloc_tensor2token)),
-        block2tokens_(std::move(block2tokens)) {}
+        block2tokens_(std::move(block2tokens)),
+        token2arena_(std::move(token2arena)),
+        arena_bytes_(std::move(arena_bytes)) {}
 
   IRModule Rewrite() {
     const IRModule& mod = builder_->GetContextIRModule();
@@ -842,10 +1125,14 @@ class StorageAllocationRewriter : public ExprMutator {
         SetTIRVarUpperBound(GetRef<Function>(func_), &ana_, &dom_map_);
       }
       token2storage_var_.clear();
+      arena2storage_var_.clear();
       Function func = Downcast<Function>(this->VisitExpr_(func_));
       if (plan_dynamic_output_) {
         func = WithoutAttr(func, plan_dyn_attr_);
       }
+      if (func->attrs.defined() && func->attrs->dict.count("relax.memory_plan_arena")) {
+        func = WithoutAttr(func, "relax.memory_plan_arena");
+      }
       builder_->UpdateFunction(gv, func);
     }
     return builder_->GetContextIRModule();
@@ -867,9 +1154,27 @@ class StorageAllocationRewriter : public ExprMutator {
       ICHECK_NOTNULL(sinfo->shape.as<ShapeExprNode>());
       PrimValue runtime_device_index = Downcast<PrimValue>(call->args[2]);
 
+      StorageToken token = it->second;
+      if (auto it_arena = token2arena_.find(token.get()); it_arena != token2arena_.end()) {
+        // The token is packed into an arena, which is allocated at its first use.
+        auto [arena, offset] = it_arena->second;
+        auto it_var = arena2storage_var_.find(arena);
+        if (it_var == arena2storage_var_.end()) {
+          Call alloc_storage(mem_alloc_storage,
+                             {ShapeExpr({IntImm(DataType::Int(64), arena_bytes_[arena])}),
+                              runtime_device_index, StringImm("global"),
+                              DataTypeImm(DataType::UInt(8))},
+                             Attrs());
+          it_var = arena2storage_var_.emplace(arena, builder_->Emit(alloc_storage, "arena")).first;
+        }
+        return Call(mem_alloc_tensor,
+                    {it_var->second, PrimValue::Int64(offset), sinfo->shape.value(),
+                     DataTypeImm(sinfo->dtype)},
+                    Attrs());
+      }
+
       // If the token is visited for the first time, create a storage variable using
       // `memory.alloc_storage` for it.
-      StorageToken token = it->second;
       Var storage_var{nullptr};
       auto it_token = token2storage_var_.find(token.get());
       if (it_token == token2storage_var_.end()) {
@@ -942,6 +1247,12 @@ class StorageAllocationRewriter : public ExprMutator {
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens_;
   /*! \brief The mapping from each token to its corresponding storage var in each function. */
   std::unordered_map<const StorageTokenNode*, Var> token2storage_var_;
+  /*! \brief The mapping from each token packed into an arena to the arena and its offset. */
+  std::unordered_map<const StorageTokenNode*, std::pair<int, int64_t>> token2arena_;
+  /*! \brief The number of bytes of each arena. */
+  std::vector<int64_t> arena_bytes_;
+  /*! \brief The mapping from each arena to its storage var in each function. */
+  std::unordered_map<int, Var> arena2storage_var_;
 };
 
 IRModule StaticPlanBlockMemory(IRModule mod) {
@@ -956,7 +1267,9 @@ IRModule StaticPlanBlockMemory(IRModule mod) {
   // Step 3. Rewrite the function.
   StorageAllocationRewriter rewriter(std::move(mod),  //
                                      std::move(allocator.alloc_tensor2token),
-                                     std::move(allocator.block2tokens));
+                                     std::move(allocator.block2tokens),
+                                     std::move(allocator.token2arena),
+                                     std::move(allocator.arena_bytes));
   return rewriter.Rewrite();
 }
 
@@ -29,6 +29,7 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/runtime.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/module.h>
 #include <tvm/runtime/name_transforms.h>
 #include <tvm/runtime/object.h>
 #include <tvm/tir/analysis.h>
@@ -492,6 +493,9 @@ class AOTExecutorCodegen : public MixedModeVisitor {
         } else {
           // NOTE: LowerTVMBuiltin expects some device_context placeholder.
           args.push_back(tir::make_zero(DataType::Handle()));
+          if (call_unchecked_ && num_arguments_.count(global_var)) {
+            args.Set(0, tir::StringImm(func_name + runtime::symbol::tvm_unchecked_suffix));
+          }
         }
         func_call = tir::Evaluate(
             tvm::tir::Call(DataType::Int(32), tvm::tir::builtin::tvm_call_cpacked(), args));
@@ -1047,6 +1051,12 @@ class AOTExecutorCodegen : public MixedModeVisitor {
    * See CallType for more documentation.
    */
   CallType call_type_;
+  /*!
+   * \brief Whether the kernels lowered by TVM are called through their unchecked entries, which
+   * MakePackedAPI emits under "tir.emit_unchecked_api". The main function checks its own
+   * arguments, and passes the kernels the tensors it planned.
+   */
+  bool call_unchecked_{false};
 
   /*!
    * \brief parameters (i.e. ConstantNodes found in the graph).
@@ -1108,6 +1118,9 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     } else if (runtime_config->name == kTvmRuntimeCpp) {
       if (unpacked_api == false && interface_api == "packed") {
         call_type_ = CallType::kCPacked;
+        call_unchecked_ = transform::PassContext::Current()
+                              ->GetConfig<Bool>("tir.emit_unchecked_api", Bool(false))
+                              .value();
       } else {
         CHECK(static_cast<bool>(unpacked_api) == false && interface_api == "packed")
             << "Need unpacked-api == false (got: " << unpacked_api
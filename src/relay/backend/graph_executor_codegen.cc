@@ -33,6 +33,7 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <vector>
@@ -310,6 +311,9 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       storage_ids.push_back(v);
     }
     node->attrs_["storage_id"] = std::move(storage_ids);
+    if (!storage_info->storage_offsets_in_bytes.empty()) {
+      node->attrs_["storage_offset"] = storage_info->storage_offsets_in_bytes;
+    }
     // type
     std::vector<int64_t> device_types;
     for (const auto& virtual_device : storage_info->virtual_devices) {
@@ -402,7 +406,7 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     StorageInfo rit = GetStorageInfo(rhs);
     int64_t lhs_storage_id = lit->storage_ids[0];
     int64_t rhs_storage_id = rit->storage_ids[0];
-    return lhs_storage_id == rhs_storage_id;
+    return lhs_storage_id == rhs_storage_id && lit->storage_offset(0) == rit->storage_offset(0);
   }
 
   std::vector<GraphNodeRef> GraphAddCallNode(const CallNode* call_node, GraphAttrs attrs) {
@@ -536,6 +540,7 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     size_t num_entry = 0;
     ShapeVector shapes;
     std::vector<size_t> storage_ids;
+    std::vector<size_t> storage_offsets;
     std::vector<std::string> storage_scopes;
     std::vector<size_t> device_types;
     std::vector<std::string> dltypes;
@@ -553,6 +558,13 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       shapes.insert(shapes.end(), shape_vec.begin(), shape_vec.end());
       dltypes.insert(dltypes.end(), dtype_vec.begin(), dtype_vec.end());
       storage_ids.insert(storage_ids.end(), storage_id.begin(), storage_id.end());
+      if (node->attrs_.count("storage_offset")) {
+        const auto& storage_offset =
+            dmlc::get<std::vector<int64_t>>(node->attrs_["storage_offset"]);
+        storage_offsets.insert(storage_offsets.end(), storage_offset.begin(), storage_offset.end());
+      } else {
+        storage_offsets.insert(storage_offsets.end(), node->num_outputs_, 0);
+      }
       storage_scopes.insert(storage_scopes.end(), storage_scope.begin(), storage_scope.end());
       if (node->attrs_.count("device_index")) {
         const auto& dev_types = dmlc::get<std::vector<int64_t>>(node->attrs_["device_index"]);
@@ -581,6 +593,12 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     attrs["shape"].emplace_back(shapes);
     attrs["storage_id"].emplace_back(std::string("list_int"));
     attrs["storage_id"].emplace_back(storage_ids);
+    // Only the storage pools of the offset memory planner place tensors at nonzero offsets.
+    if (std::any_of(storage_offsets.begin(), storage_offsets.end(),
+                    [](size_t offset) { return offset != 0; })) {
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+    }
     if (device_types.size()) {
       attrs["device_index"].emplace_back(std::string("list_int"));
       attrs["device_index"].emplace_back(device_types);
@@ -29,8 +29,14 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+#include <utility>
+
 #include "../../runtime/texture.h"
 #include "../../support/arena.h"
 #include "../op/annotation/annotation.h"
@@ -401,7 +407,262 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   TokenAllocator allocator_;
 };
 
-StaticMemoryPlan GraphPlanMemory(const Function& func) { return StorageAllocator().Plan(func); }
+/*!
+ * \brief Associate storage with every expression, packing the intermediate tensors of each device
+ * into one storage pool at offsets planned over their lifetimes.
+ *
+ * Each call is a step of the function. A tensor is live from the step of the call producing it to
+ * the step of its last use, included. The tensors are placed by decreasing size, each at the
+ * offset of the smallest gap of the pool between the placed tensors live at the same time, or
+ * after them. Besides the outputs of reshapes, the output of an elementwise call takes the
+ * storage of an input of the same type whose last use is the call.
+ *
+ * Parameters, constants and 2d textures keep a storage of their own, so that the executor can
+ * set the inputs without copies. So do the tensors of devices whose buffers are handles rather
+ * than addresses, e.g. OpenCL, since the kernels cannot take a byte offset.
+ */
+class OffsetStorageAllocator : public StorageAllocaBaseVisitor {
+ public:
+  OffsetStorageAllocator() = default;
+
+  // Run storage allocation for a function.
+  StaticMemoryPlan Plan(const Function& func) {
+    VLOG_CONTEXT << "OffsetStorageAllocator";
+    prototype_ = StorageAllocaInit(&arena_).GetInitTokenMap(func);
+    this->Run(func);
+
+    // The tokens still referenced are the outputs of the function, which live to its end.
+    std::map<std::pair<int, int>, std::vector<StorageToken*>> pools;
+    int64_t num_storage_ids = 0;
+    for (StorageToken* tok : tokens_) {
+      if (!last_step_.count(tok)) {
+        last_step_[tok] = step_ + 1;
+      }
+      if (reusable_.count(tok) && !Is2DStorage(tok->virtual_device->memory_scope) &&
+          HasAddressableMemory(tok->virtual_device->device_type())) {
+        pools[{tok->virtual_device->device_type(), tok->virtual_device->virtual_device_id}]
+            .push_back(tok);
+      } else {
+        tok->storage_id = num_storage_ids++;
+      }
+    }
+    for (auto& kv : pools) {
+      int64_t pool_bytes = PlaceInPool(&kv.second);
+      VLOG(1) << "storage pool " << num_storage_ids << " of device type " << kv.first.first
+              << " holds " << kv.second.size() << " tensors in " << pool_bytes << " bytes";
+      for (StorageToken* tok : kv.second) {
+        tok->storage_id = num_storage_ids;
+      }
+      ++num_storage_ids;
+    }
+
+    Map<Expr, backend::StorageInfo> smap;
+    for (const auto& kv : token_map_) {
+      std::vector<int64_t> storage_ids;
+      std::vector<VirtualDevice> virtual_devices;
+      std::vector<int64_t> sid_sizes_byte;
+      std::vector<int64_t> sid_offsets_byte;
+      for (StorageToken* tok : kv.second) {
+        storage_ids.push_back(tok->storage_id);
+        virtual_devices.push_back(tok->virtual_device);
+        sid_sizes_byte.push_back(GetMemorySize(tok));
+        auto it = offset_.find(tok);
+        sid_offsets_byte.push_back(it == offset_.end() ? 0 : it->second);
+      }
+      smap.Set(GetRef<Expr>(kv.first),
+               backend::StorageInfo(std::move(storage_ids), std::move(virtual_devices),
+                                    std::move(sid_sizes_byte), std::move(sid_offsets_byte)));
+    }
+    return backend::StaticMemoryPlan(smap);
+  }
+
+ protected:
+  void CreateTokenOnDevice(const ExprNode* op, const VirtualDevice& virtual_device,
+                           bool can_realloc) final {
+    ICHECK(!token_map_.count(op));
+    auto it = prototype_.find(op);
+    ICHECK(it != prototype_.end());
+    std::vector<StorageToken*> tokens;
+    for (StorageToken* prototype : it->second) {
+      ICHECK(prototype->virtual_device == virtual_device);
+      StorageToken* tok = arena_.make<StorageToken>();
+      tok->ttype = prototype->ttype;
+      tok->virtual_device = prototype->virtual_device;
+      tok->ref_counter = prototype->ref_counter;
+      if (can_realloc) {
+        reusable_.insert(tok);
+      } else {
+        // ensure it never get released.
+        tok->ref_counter += 1;
+      }
+      first_step_[tok] = step_;
+      tokens_.push_back(tok);
+      tokens.push_back(tok);
+    }
+    token_map_[op] = tokens;
+  }
+
+  // Mark op to reuse the input_token, which lives as long as both are referenced.
+  void ReuseInputToken(const ExprNode* op, StorageToken* input_token) {
+    ICHECK(!token_map_.count(op));
+    auto it = prototype_.find(op);
+    ICHECK(it != prototype_.end());
+    ICHECK_EQ(it->second.size(), 1U);
+    input_token->ref_counter += it->second[0]->ref_counter;
+    token_map_[op] = {input_token};
+  }
+
+  /*!
+   * \brief Returns an input of the elementwise \p call_node whose storage its output can take,
+   * or nullptr if there is none.
+   */
+  StorageToken* GetInplaceInput(const CallNode* call_node, const CallLoweredProps& props,
+                                const std::vector<StorageToken*>& args) {
+    if (!props.lowered_func.defined() || !IsElemwiseOnly(props)) {
+      return nullptr;
+    }
+    const std::vector<StorageToken*>& outputs = prototype_.at(call_node);
+    if (outputs.size() != 1 || Is2DStorage(outputs[0]->virtual_device->memory_scope)) {
+      return nullptr;
+    }
+    for (StorageToken* tok : args) {
+      // The input must die at this call, i.e. only be referenced by its arguments.
+      if (reusable_.count(tok) && tok->virtual_device == outputs[0]->virtual_device &&
+          tok->ref_counter == std::count(args.begin(), args.end(), tok) &&
+          StructuralEqual()(tok->ttype, outputs[0]->ttype)) {
+        return tok;
+      }
+    }
+    return nullptr;
+  }
+
+  using StorageAllocaBaseVisitor::DeviceAwareVisitExpr_;
+
+  void DeviceAwareVisitExpr_(const CallNode* call_node) final {
+    ++step_;
+    std::vector<StorageToken*> args;
+    for (const Expr& arg : call_node->args) {
+      for (StorageToken* tok : GetToken(arg)) {
+        args.push_back(tok);
+      }
+    }
+
+    // TODO(mbs): "reshape" cleanup.
+    CallLoweredProps call_lowered_props = GetCallLoweredProps(call_node);
+    if (call_lowered_props.lowered_func.defined() && IsReshapeOnly(call_lowered_props)) {
+      ICHECK_EQ(call_lowered_props.arguments.size(), 1U);
+      ReuseInputToken(call_node, args[0]);
+    } else if (StorageToken* input = GetInplaceInput(call_node, call_lowered_props, args)) {
+      ReuseInputToken(call_node, input);
+    } else {
+      CreateToken(call_node, true);
+    }
+
+    for (StorageToken* tok : token_map_.at(call_node)) {
+      CheckForRelease(tok);
+    }
+    for (StorageToken* tok : args) {
+      tok->ref_counter -= 1;
+      CheckForRelease(tok);
+    }
+  }
+
+ private:
+  void CheckForRelease(StorageToken* tok) {
+    ICHECK_GE(tok->ref_counter, 0);
+    if (tok->ref_counter == 0 && !last_step_.count(tok)) {
+      last_step_[tok] = step_;
+    }
+  }
+
+  static int64_t GetMemorySize(StorageToken* tok) {
+    return Is2DStorage(tok->virtual_device->memory_scope)
+               ? 0
+               : static_cast<int64_t>(TokenAllocator1D().GetMemorySize(tok));
+  }
+
+  /*! \brief Whether the buffers of a device are addresses, which views offset into. */
+  static bool HasAddressableMemory(DLDeviceType device_type) {
+    return device_type == kDLCPU || device_type == kDLCUDA || device_type == kDLCUDAHost ||
+           device_type == kDLCUDAManaged || device_type == kDLROCM;
+  }
+
+  /*!
+   * \brief Place the tokens of a storage pool by best fit decreasing.
+   * \return The size of the pool in bytes.
+   */
+  int64_t PlaceInPool(std::vector<StorageToken*>* tokens) {
+    auto aligned_size = [](StorageToken* tok) {
+      int64_t align = runtime::kAllocAlignment;
+      return (GetMemorySize(tok) + align - 1) / align * align;
+    };
+    std::stable_sort(tokens->begin(), tokens->end(), [&](StorageToken* lhs, StorageToken* rhs) {
+      return aligned_size(lhs) > aligned_size(rhs);
+    });
+    int64_t pool_bytes = 0;
+    std::vector<StorageToken*> placed;
+    for (StorageToken* tok : *tokens) {
+      int64_t size = aligned_size(tok);
+      // The placed tokens live at the same time, by offset.
+      std::vector<StorageToken*> live;
+      for (StorageToken* other : placed) {
+        if (first_step_.at(other) <= last_step_.at(tok) &&
+            first_step_.at(tok) <= last_step_.at(other)) {
+          live.push_back(other);
+        }
+      }
+      std::sort(live.begin(), live.end(), [&](StorageToken* lhs, StorageToken* rhs) {
+        return offset_.at(lhs) < offset_.at(rhs);
+      });
+      int64_t best_offset = -1;
+      int64_t best_gap = 0;
+      int64_t gap_begin = 0;
+      for (StorageToken* other : live) {
+        int64_t gap = offset_.at(other) - gap_begin;
+        if (gap >= size && (best_offset < 0 || gap < best_gap)) {
+          best_offset = gap_begin;
+          best_gap = gap;
+        }
+        gap_begin = std::max(gap_begin, offset_.at(other) + aligned_size(other));
+      }
+      offset_[tok] = best_offset < 0 ? gap_begin : best_offset;
+      pool_bytes = std::max(pool_bytes, offset_[tok] + size);
+      placed.push_back(tok);
+    }
+    return pool_bytes;
+  }
+
+  // allocator
+  support::Arena arena_;
+  /*! \brief internal prototype token map */
+  std::unordered_map<const ExprNode*, std::vector<StorageToken*>> prototype_;
+  /*! \brief All the tokens, in their order of creation. */
+  std::vector<StorageToken*> tokens_;
+  /*! \brief The tokens which may share a storage pool. */
+  std::unordered_set<StorageToken*> reusable_;
+  /*! \brief The step of the call creating each token. */
+  std::unordered_map<StorageToken*, int> first_step_;
+  /*! \brief The step of the last call referencing each released token. */
+  std::unordered_map<StorageToken*, int> last_step_;
+  /*! \brief The byte offset of each token in its storage pool. */
+  std::unordered_map<StorageToken*, int64_t> offset_;
+  /*! \brief The current step. */
+  int step_{0};
+};
+
+StaticMemoryPlan GraphPlanMemory(const Function& func) {
+  String planner = transform::PassContext::Current()
+                       ->GetConfig<String>("relay.backend.graph_memory_planner", String("greedy"))
+                       .value();
+  if (planner == "offset") {
+    return OffsetStorageAllocator().Plan(func);
+  }
+  ICHECK(planner == "greedy") << "Unknown graph memory planner \"" << planner
+                              << "\", expected \"greedy\" or \"offset\"";
+  return StorageAllocator().Plan(func);
+}
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.graph_memory_planner", String);
 
 TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory").set_body_typed(GraphPlanMemory);
 
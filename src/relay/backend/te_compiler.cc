@@ -102,13 +102,17 @@
 #include <tvm/relay/op.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/te/schedule.h>
 #include <tvm/te/schedule_pass.h>
 #include <tvm/tir/transform.h>
 #include <tvm/topi/tags.h>
 
+#include <exception>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <tuple>
 #include <unordered_map>
@@ -173,6 +177,53 @@ class TECompilerImpl : public TECompilerNode {
     return LowerShapeFuncInternal(key)->cached_func;
   }
 
+  void LowerInParallel(const Array<CCacheKey>& keys, int num_threads) final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Build the TE schedules one by one in the order of the keys, which names the lowered
+    // functions and their constants exactly as lowering the keys one by one would.
+    std::vector<std::pair<CCacheKey, CCacheValue>> pending;
+    for (const CCacheKey& key : keys) {
+      if (key->source_func->GetAttr<String>(attr::kCompiler).defined() || cache_.count(key)) {
+        continue;
+      }
+      CCacheValue value(make_object<CCacheValueNode>());
+      value->use_count = 0;
+      cache_[key] = value;
+      cur_ccache_key_ = key;
+      With<Target> target_scope(key->target);
+      value->cached_func =
+          PrimFuncFor(key->source_func, key->target, global_var_supply_, constant_name_supply_);
+      pending.emplace_back(key, value);
+    }
+    VLOG(1) << "lowering " << pending.size() << " primitive functions to TIR on " << num_threads
+            << " threads";
+
+    // Then lower the schedules to TIR concurrently. Each worker only reads the GlobalVar
+    // already assigned to its function, so give it a supply of its own.
+    PassContext pass_ctx = PassContext::Current();
+    std::vector<std::exception_ptr> errors(pending.size());
+    support::parallel_for_dynamic(0, pending.size(), num_threads, [&](int thread_id, int i) {
+      std::unique_ptr<tvm::transform::PassContextWorkerScope> scope =
+          thread_id == 0 ? nullptr
+                         : std::make_unique<tvm::transform::PassContextWorkerScope>(pass_ctx);
+      const CCacheKey& key = pending[i].first;
+      const CCacheValue& value = pending[i].second;
+      GlobalVar prim_fn_var = value->cached_func->prim_fn_var;
+      try {
+        With<Target> target_scope(key->target);
+        LowerToTIR(key, value,
+                   GlobalVarSupply(NameSupply(""), {{prim_fn_var->name_hint, prim_fn_var}}));
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+    for (const std::exception_ptr& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
   IRModule GetLoweredFunctions() {
     VLOG(1) << "GetLoweredFunctions";
     IRModule mod;
@@ -393,7 +444,16 @@ class TECompilerImpl : public TECompilerNode {
     ICHECK(!value->cached_func.defined());
     value->cached_func =
         PrimFuncFor(key->source_func, key->target, global_var_supply, constant_name_supply_);
+    LowerToTIR(key, value, global_var_supply);
+    return value;
+  }
 
+  /*!
+   * \brief Lower the schedule or PrimFunc of \p value, which PrimFuncFor has built for \p key,
+   * into the TIR functions of its cached function.
+   */
+  void LowerToTIR(const CCacheKey& key, const CCacheValue& value,
+                  GlobalVarSupply global_var_supply) {
     if (value->cached_func->prim_func.defined()) {
       VLOG(1) << "Lowering PrimFunc";
       IRModule lowered = tvm::LowerPrimFunc(value->cached_func->prim_func.value(),
@@ -465,8 +525,6 @@ class TECompilerImpl : public TECompilerNode {
             << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
             << "with definitions:" << std::endl
             << PrettyPrint(value->cached_func->funcs);
-
-    return value;
   }
 
   // implement lowered shape func
@@ -552,6 +610,7 @@ TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_auto_scheduler", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule_dispatch", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.tir_converter", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.lower_te_num_threads", Integer);
 
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobal").set_body_typed([]() {
   return TECompiler::Global();
@@ -587,6 +646,31 @@ TVM_REGISTER_GLOBAL("relay.backend._TECompilerListItems").set_body_typed([](TECo
 
 using AnalysisRemapping = std::unordered_map<Expr, Expr, ObjectHash, ObjectEqual>;
 
+/*!
+ * \brief Returns true if \p base_func is a Relay function computing a single tensor by elementwise
+ * and broadcast operators only. Each element of its output then only reads the same element of
+ * the inputs of the same shape, so that the output may take the storage of such an input.
+ */
+bool IsElemwiseOnlyFunction(const BaseFunc& base_func) {
+  const auto* func = base_func.as<FunctionNode>();
+  if (func == nullptr || !func->body->checked_type_.as<TensorTypeNode>()) {
+    return false;
+  }
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  bool has_call = false;
+  bool elemwise_only = true;
+  PostOrderVisit(func->body, [&](const Expr& expr) {
+    if (const auto* call = expr.as<CallNode>()) {
+      has_call = true;
+      const auto* op = call->op.as<OpNode>();
+      if (op == nullptr || fpattern.get(GetRef<Op>(op), kOpaque) > kBroadcast) {
+        elemwise_only = false;
+      }
+    }
+  });
+  return has_call && elemwise_only;
+}
+
 /*!
  * \brief Rewrites call expressions to Relay Functions marked as "primitive"
  * to calls to the corresponding TIR PrimFunc for the appropriate target.
@@ -627,13 +711,19 @@ using AnalysisRemapping = std::unordered_map<Expr, Expr, ObjectHash, ObjectEqual
  */
 class LowerTensorExprMutator : public DeviceAwareExprMutator {
  public:
+  /*!
+   * \brief Constructor.
+   * \param collected_keys If not null, the mutator only appends to it the keys of the primitive
+   * functions to lower, in the order of their first use, and leaves the calls unchanged.
+   */
   LowerTensorExprMutator(IRModule module, ProcessFn process_fn, CompilationConfig config,
-                         TECompiler compiler)
+                         TECompiler compiler, Array<CCacheKey>* collected_keys = nullptr)
       : DeviceAwareExprMutator(module),
         module_(std::move(module)),
         process_fn_(std::move(process_fn)),
         config_(std::move(config)),
         compiler_(std::move(compiler)),
+        collected_keys_(collected_keys),
         debug_op_(Op::Get("debug")) {}
 
   /*!
@@ -756,6 +846,10 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
       call_lowered_attrs.metadata.Set(attr::kReshapeOnly, tvm::Integer(1));
     }
 
+    if (!opt_compiler && IsElemwiseOnlyFunction(original_function)) {
+      call_lowered_attrs.metadata.Set(attr::kElemwiseOnly, tvm::Integer(1));
+    }
+
     call_lowered_attrs.metadata.Set("relay_attrs", original_function->attrs);
     call_lowered_attrs.metadata.Set("all_prim_fn_vars", all_prim_fn_vars);
 
@@ -929,6 +1023,10 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
       // codegen.
       CCacheKey key(Downcast<Function>(primitive_func), target,
                     GetVirtualDevice(GetRef<Call>(call_node)));
+      if (collected_keys_ != nullptr) {
+        collected_keys_->push_back(key);
+        return WithFields(GetRef<Call>(call_node), std::move(new_op), std::move(new_args));
+      }
       CachedFunc cfunc = compiler_->Lower(key);
       ICHECK(cfunc.defined());
       return MakeLoweredCall(primitive_func, cfunc->prim_fn_var, std::move(new_args),
@@ -947,6 +1045,8 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
   // lowered for multiple device types, each which will be assigned a fresh var.
   std::unordered_map<const VarNode*, BaseFunc> primitive_functions_;
   TECompiler compiler_;
+  // If not null, the keys of the primitive functions to lower, collected instead of lowering them.
+  Array<CCacheKey>* collected_keys_;
   // Cache ops that need to be frequently used later to reduce lookup overhead.
   const Op& debug_op_;
 };
@@ -960,6 +1060,23 @@ Pass LowerTensorExpr(TECompiler compiler, ProcessFn process_fn, CompilationConfi
   return CreateFunctionPass(pass_func, 0, "LowerTensorExpr", {});
 }
 
+/*!
+ * \brief Returns the keys of the primitive functions which LowerTensorExpr would lower in
+ * \p module, in the order of their first use.
+ */
+Array<CCacheKey> CollectCCacheKeys(const IRModule& module, TECompiler compiler,
+                                   CompilationConfig config) {
+  Array<CCacheKey> keys;
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [&](Function func, IRModule module, PassContext ctx) {
+        LowerTensorExprMutator collector(module, DefaultProcessFn, config, compiler, &keys);
+        collector.Mutate(func);
+        return func;
+      };
+  CreateFunctionPass(pass_func, 0, "CollectCCacheKeys", {})(module);
+  return keys;
+}
+
 backend::FunctionInfo UpdateMainWorkspaceSize(const IRModule& mod, const CompilationConfig& config,
                                               Map<Expr, backend::StorageInfo> storage_info_map) {
   Function func = Downcast<Function>(mod->Lookup("main"));
@@ -1039,9 +1156,11 @@ backend::FunctionInfo UpdateMainWorkspaceSize(const IRModule& mod, const Compila
         // Here we record the largest size of the tensor
         // that share the same storage id, because storage_id will
         // be shared between multiple tensors that are not live simultaneously.
+        // Tensors placed at an offset of a storage pool need the storage up to their end.
         DLDeviceType device_type = virtual_devices[i]->device_type();
-        if (size_bytes > sid_workspace[device_type][storage_ids[i]]) {
-          sid_workspace[device_type][storage_ids[i]] = size_bytes;
+        int64_t end_bytes = size_bytes + storage_info->storage_offset(i);
+        if (end_bytes > sid_workspace[device_type][storage_ids[i]]) {
+          sid_workspace[device_type][storage_ids[i]] = end_bytes;
         }
       }
     }
@@ -1200,6 +1319,19 @@ IRModule LowerTE(const IRModule& module, const String& module_name, ProcessFn pr
   //    GlobalVar, and calls updated (sticking with regular Relay Call).
   //  - Calls to functions tagged with "Primitive" are compiled to PrimFuncs, and calls updated
   //    (using call_lowered convention).
+  //  When "relay.backend.lower_te_num_threads" is not 1, the calls to primitive functions are
+  //  first collected and their TIR is built concurrently, so that the rewrite finds them all in
+  //  the compiler cache.
+  PassContext pass_ctx = PassContext::Current();
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("relay.backend.lower_te_num_threads", Integer(1)).value()->value;
+  if (num_threads == 0) {
+    num_threads = runtime::threading::MaxConcurrency();
+  }
+  // Instruments expect to observe the passes one at a time.
+  if (num_threads > 1 && pass_ctx->instruments.empty()) {
+    compiler->LowerInParallel(CollectCCacheKeys(module, compiler, config), num_threads);
+  }
   IRModule updated_module =
       LowerTensorExpr(compiler, std::move(process_fn), std::move(config))(module);
 
@@ -98,6 +98,15 @@ class TECompilerNode : public Object {
    * \return The result.
    */
   virtual CachedFunc LowerShapeFunc(const CCacheKey& key) = 0;
+  /*!
+   * \brief Lower the primitive functions of \p keys ahead of their first use, so that Lower
+   * finds them in the cache. The TE schedules are built in the order of \p keys, which assigns
+   * the same names as lowering the keys one by one, and are then lowered to TIR concurrently.
+   * \param keys The keys to the functions, in the order of their first use. Duplicated keys and
+   * functions for external codegen are skipped.
+   * \param num_threads The number of threads lowering to TIR.
+   */
+  virtual void LowerInParallel(const Array<CCacheKey>& keys, int num_threads) = 0;
   /*!
    * \brief Lower the external function using external codegen tools.
    * \return The runtime modules for each needed external codegen tool.
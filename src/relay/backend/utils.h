@@ -212,6 +212,16 @@ class StorageInfoNode : public Object {
   std::vector<VirtualDevice> virtual_devices;
   /* \brief The sizes of each storage element, in bytes. */
   std::vector<int64_t> storage_sizes_in_bytes;
+  /*!
+   * \brief The byte offset of each storage element within its storage, or empty if all the
+   * elements start their storage.
+   */
+  std::vector<int64_t> storage_offsets_in_bytes;
+
+  /*! \return The byte offset of the \p i-th storage element within its storage. */
+  int64_t storage_offset(size_t i) const {
+    return storage_offsets_in_bytes.empty() ? 0 : storage_offsets_in_bytes[i];
+  }
 
   // TODO(@jroesch): expose the fields
   void VisitAttrs(AttrVisitor* v) {}
@@ -224,7 +234,8 @@ class StorageInfoNode : public Object {
 class StorageInfo : public ObjectRef {
  public:
   StorageInfo(std::vector<int64_t> storage_ids, std::vector<VirtualDevice> virtual_devices,
-              std::vector<int64_t> storage_sizes_in_bytes);
+              std::vector<int64_t> storage_sizes_in_bytes,
+              std::vector<int64_t> storage_offsets_in_bytes = {});
   TVM_DEFINE_OBJECT_REF_METHODS(StorageInfo, ObjectRef, StorageInfoNode);
 };
 
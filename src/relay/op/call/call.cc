@@ -135,5 +135,10 @@ bool IsReshapeOnly(const CallLoweredProps& props) {
   return false;
 }
 
+bool IsElemwiseOnly(const CallLoweredProps& props) {
+  return props.attrs.metadata.count(attr::kElemwiseOnly) &&
+         Downcast<Integer>(props.attrs.metadata[attr::kElemwiseOnly])->value != 0;
+}
+
 }  // namespace relay
 }  // namespace tvm
@@ -90,6 +90,12 @@ Call GetAnyCall(const CallNode* call_node);
  */
 bool IsReshapeOnly(const CallLoweredProps& props);
 
+/*!
+ * \brief Returns true if lowered call described by \p props is to a primitive only composed of
+ * elementwise and broadcast operations.
+ */
+bool IsElemwiseOnly(const CallLoweredProps& props);
+
 }  // namespace relay
 }  // namespace tvm
 
@@ -30,7 +30,6 @@
 #include <tvm/runtime/name_transforms.h>
 
 #include <limits>
-#include <memory>
 
 #include "../meta_data.h"
 
@@ -91,6 +90,14 @@ AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>&
       args_.emplace_back(NDArray::Empty({pool_len}, DataType::UInt(8), devices_[0]));
     }
   }
+
+  // The arguments of the main function are set up once, and only change when a tensor is set
+  // without copies.
+  call_values_.resize(args_.size());
+  call_type_codes_.assign(args_.size(), kTVMDLTensorHandle);
+  for (size_t i = 0; i < args_.size(); ++i) {
+    call_values_[i].v_handle = const_cast<DLTensor*>(args_[i].operator->());
+  }
 }
 
 PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) {
@@ -164,23 +171,17 @@ PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>&
 }
 
 void AotExecutor::Run() {
-  auto pf = module_.GetFunction(
-      get_name_mangled(metadata_->mod_name(), ::tvm::runtime::symbol::tvm_module_main),
-      true /* query_imports */);
-  ICHECK(pf != nullptr) << "Module entrypoint is not defined";
-
-  const int num_args = args_.size();
-  auto call_values = ::std::make_unique<TVMValue[]>(num_args);
-  auto call_type_codes = ::std::make_unique<int[]>(num_args);
-  for (int i = 0; i < num_args; ++i) {
-    auto managed = args_[i].ToDLPack();
-    call_values.get()[i].v_handle = &managed->dl_tensor;
-    call_type_codes.get()[i] = kTVMDLTensorHandle;
+  if (main_func_ == nullptr) {
+    main_func_ = module_.GetFunction(
+        get_name_mangled(metadata_->mod_name(), ::tvm::runtime::symbol::tvm_module_main),
+        true /* query_imports */);
+    ICHECK(main_func_ != nullptr) << "Module entrypoint is not defined";
   }
 
-  TVMArgs args{call_values.get(), call_type_codes.get(), num_args};
+  TVMArgs args{call_values_.data(), call_type_codes_.data(),
+               static_cast<int>(call_values_.size())};
   TVMRetValue rv;
-  pf.CallPacked(args, &rv);
+  main_func_.CallPacked(args, &rv);
 }
 
 int AotExecutor::GetInputIndex(const std::string& name) {
@@ -210,12 +211,30 @@ int AotExecutor::GetOutputIndex(const std::string& name) {
 
 void AotExecutor::SetInput(int index, DLTensor* data_ref) { args_[index].CopyFrom(data_ref); }
 
+void AotExecutor::CheckExternalDLTensor(const DLTensor* external, int arg_index) const {
+  const DLTensor* internal = args_[arg_index].operator->();
+  ICHECK(DataType(internal->dtype) == DataType(external->dtype));
+  ICHECK_EQ(internal->ndim, external->ndim);
+  ICHECK_EQ(internal->device.device_type, external->device.device_type);
+  ICHECK_EQ(internal->device.device_id, external->device.device_id);
+  for (int i = 0; i < external->ndim; ++i) {
+    ICHECK_EQ(internal->shape[i], external->shape[i]);
+  }
+}
+
 void AotExecutor::SetInputZeroCopy(int index, DLTensor* data_ref) {
-  ICHECK(false) << "not implemented";
+  ICHECK_LT(index, NumInputs());
+  CheckExternalDLTensor(data_ref, index);
+  args_[index] = NDArray::FromExternalDLTensor(*data_ref);
+  call_values_[index].v_handle = const_cast<DLTensor*>(args_[index].operator->());
 }
 
 void AotExecutor::SetOutputZeroCopy(int index, DLTensor* data_ref) {
-  ICHECK(false) << "not implemented";
+  ICHECK_LT(index, NumOutputs());
+  int arg_index = metadata_->num_inputs() + index;
+  CheckExternalDLTensor(data_ref, arg_index);
+  args_[arg_index] = NDArray::FromExternalDLTensor(*data_ref);
+  call_values_[arg_index].v_handle = const_cast<DLTensor*>(args_[arg_index].operator->());
 }
 
 int AotExecutor::NumOutputs() const { return metadata_->num_outputs(); }
@@ -93,13 +93,15 @@ class TVM_DLL AotExecutor : public ModuleNode {
    */
   void SetInput(int index, DLTensor* data_in);
   /*!
-   * \brief set index-th input to the graph without copying the data
+   * \brief set index-th input to the graph without copying the data. The executor then reads
+   * and GetInput returns the memory of \p data_ref, which must outlive the runs.
    * \param index The input index.
    * \param data_ref The input data that is referred.
    */
   void SetInputZeroCopy(int index, DLTensor* data_ref);
   /*!
-   * \brief set index-th output to the graph without copying the data.
+   * \brief set index-th output to the graph without copying the data. The executor then writes
+   * and GetOutput returns the memory of \p data_ref, which must outlive the runs.
    * \param index The output index.
    * \param data_ref The output data that is referred.
    */
@@ -147,8 +149,24 @@ class TVM_DLL AotExecutor : public ModuleNode {
   /*! \brief The devices which should be used to execute the computations. */
   std::vector<Device> devices_;
 
+  /*!
+   * \brief Check that an external tensor can replace an argument of the main function.
+   * \param external The external tensor.
+   * \param arg_index The index of the argument.
+   */
+  void CheckExternalDLTensor(const DLTensor* external, int arg_index) const;
+
   /*! \brief Holds one NDArray per function argument in the same order. */
   std::vector<NDArray> args_;
+
+  /*! \brief The main function of the module, looked up on the first run. */
+  PackedFunc main_func_;
+
+  /*! \brief The values of the arguments passed to the main function, one per entry of args_. */
+  std::vector<TVMValue> call_values_;
+
+  /*! \brief The type codes of the arguments passed to the main function. */
+  std::vector<int> call_type_codes_;
 };
 
 }  // namespace runtime
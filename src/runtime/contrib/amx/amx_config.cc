@@ -21,6 +21,7 @@
  * \file src/runtime/contrib/amx/amx_config.cc
  * \brief extraction of AMX configuration on x86 platforms
  */
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
@@ -83,6 +84,13 @@ TVM_REGISTER_GLOBAL("runtime.amx_tileconfig").set_body([](TVMArgs args, TVMRetVa
   // -----------Config for AMX tile resgister----------------------
   __tilecfg_u cfg;
   init_tile_config(&cfg, cols, rows);
+  // The tile configuration is per thread, so the workers of the parallel loops load it too.
+  TVMBackendParallelLaunch(
+      [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+        _tile_loadconfig(static_cast<__tilecfg_u*>(cdata)->a);
+        return 0;
+      },
+      &cfg, 0);
 
   *rv = 1;
   return;
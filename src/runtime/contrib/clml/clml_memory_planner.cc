@@ -24,8 +24,12 @@
 #ifdef TVM_GRAPH_EXECUTOR_CLML
 #include "clml_memory_planner.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include "clml_utils.h"
 
@@ -59,9 +63,9 @@ void FreeMemory(CachedLayer* layer, int nid) {
         }
       }
       // Look into DDR allocation
-      if (layer->ddr_alloc_plan.find(nid) != layer->ddr_alloc_plan.end()) {
+      if (layer->ddr_slot_plan.find(nid) != layer->ddr_slot_plan.end()) {
         LOG_MEM << "Free DDR segment from local pool";
-        layer->ddr_storage_ref_map[layer->ddr_alloc_plan[nid]].second = false;
+        layer->ddr_slots[layer->ddr_slot_plan[nid]].second = false;
         return;
       }
       LOG_MEM << "*** Not a managed memory buffer";
@@ -195,55 +199,84 @@ size_t RequestOnChipMemory(CachedLayer* layer, size_t size) {
 }
 
 /*!
- * \brief Allocate DDR memory for requested size.
+ * \brief Plan DDR memory for requested size on a virtual buffer of the layer.
  *
+ * The virtual buffers get their backing memory by BindDDRMemory once the plan of the layer is
+ * complete, so a free virtual buffer grows to fit a larger request instead of adding a buffer.
  */
-cl_mem RequestDDRMemory(CachedLayer* layer, size_t size) {
-  // Look for local storage map for a best fit
-  auto cws = CLMLWorkspace::Global();
-  cl_mem memptr = nullptr;
-  size_t best_fit = INT_MAX;
-  for (auto it = layer->ddr_storage_ref_map.begin(); it != layer->ddr_storage_ref_map.end(); it++) {
-    if ((it->second.first >= size) && (false == it->second.second)) {
-      if (best_fit > it->second.first) {
-        memptr = it->first;
-        best_fit = it->second.first;
-      }
+size_t RequestDDRMemory(CachedLayer* layer, size_t size) {
+  const size_t none = layer->ddr_slots.size();
+  size_t best_fit = none;
+  size_t largest = none;
+  for (size_t i = 0; i < layer->ddr_slots.size(); ++i) {
+    const auto& slot = layer->ddr_slots[i];
+    if (slot.second) continue;
+    if ((slot.first >= size) &&
+        ((best_fit == none) || (slot.first < layer->ddr_slots[best_fit].first))) {
+      best_fit = i;
+    }
+    if ((largest == none) || (slot.first > layer->ddr_slots[largest].first)) {
+      largest = i;
     }
   }
 
-  if (memptr) {
-    LOG_MEM << "Reuse from local pool";
-    layer->ddr_storage_ref_map[memptr].second = true;
-    return memptr;
+  size_t slot = best_fit != none ? best_fit : largest;
+  if (slot != none) {
+    LOG_MEM << "Reuse from local pool:" << slot << " Size:" << layer->ddr_slots[slot].first;
+    layer->ddr_slots[slot].first = std::max(layer->ddr_slots[slot].first, size);
+    layer->ddr_slots[slot].second = true;
+    return slot;
   }
-  // No available buffer in local pool, look for global pool
-  for (auto it = cws->ddr_global_pool.begin(); it != cws->ddr_global_pool.end(); it++) {
-    if ((it->second.first >= size) &&
-        (layer->ddr_storage_ref_map.find(it->first) == layer->ddr_storage_ref_map.end())) {
-      // Found a buffer in global pool. Insert in local pool and then use.
-      if (best_fit > it->second.first) {
+  LOG_MEM << "New buffer in local pool:" << slot;
+  layer->ddr_slots.push_back(std::make_pair(size, true));
+  return slot;
+}
+
+/*!
+ * \brief Back the virtual buffers of the layer by the buffers of the global pool.
+ *
+ * The subgraphs run one after the other, so a buffer of the global pool backs one virtual buffer
+ * of each layer. The largest virtual buffers take the best fits first, which keeps the global
+ * pool near the largest need of any subgraph rather than the sum over the subgraphs.
+ */
+void BindDDRMemory(CachedLayer* layer) {
+  auto cws = CLMLWorkspace::Global();
+  std::vector<size_t> order(layer->ddr_slots.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [layer](size_t lhs, size_t rhs) {
+    return layer->ddr_slots[lhs].first > layer->ddr_slots[rhs].first;
+  });
+
+  std::vector<cl_mem> slot_mem(layer->ddr_slots.size(), nullptr);
+  for (size_t slot : order) {
+    size_t size = layer->ddr_slots[slot].first;
+    cl_mem memptr = nullptr;
+    size_t best_fit = SIZE_MAX;
+    for (auto it = cws->ddr_global_pool.begin(); it != cws->ddr_global_pool.end(); it++) {
+      size_t pool_size = it->second.first;
+      if ((pool_size >= size) && (pool_size < best_fit) &&
+          (layer->ddr_storage_ref_map.find(it->first) == layer->ddr_storage_ref_map.end())) {
         memptr = it->first;
-        best_fit = it->second.first;
+        best_fit = pool_size;
       }
     }
-  }
 
-  if (memptr) {
-    LOG_MEM << "Reuse from global pool";
-    cws->ddr_global_pool[memptr].second += 1;
+    if (memptr) {
+      LOG_MEM << "Reuse from global pool";
+      cws->ddr_global_pool[memptr].second += 1;
+    } else {
+      LOG_MEM << "Allocating fresh buffer in global pool";
+      memptr = AllocateDDRTensorMemory(size);
+      cws->ddr_global_pool.insert({memptr, std::make_pair(size, 1)});
+    }
     layer->ddr_storage_ref_map.insert(
         {memptr, std::make_pair(cws->ddr_global_pool[memptr].first, true)});
-    return memptr;
+    slot_mem[slot] = memptr;
   }
 
-  // Allocate a fresh buffer in global then use in local pool.
-  LOG_MEM << "Allocating fresh buffer in global pool";
-  memptr = AllocateDDRTensorMemory(size);
-  cws->ddr_global_pool.insert({memptr, std::make_pair(size, 1)});
-  layer->ddr_storage_ref_map.insert({memptr, std::make_pair(size, true)});
-
-  return memptr;
+  for (auto it = layer->ddr_slot_plan.begin(); it != layer->ddr_slot_plan.end(); it++) {
+    layer->ddr_alloc_plan.insert({it->first, slot_mem[it->second]});
+  }
 }
 
 /*!
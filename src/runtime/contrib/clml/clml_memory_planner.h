@@ -36,7 +36,9 @@ void ReleaseDDRMemory(cl_mem memptr);
 
 size_t RequestOnChipMemory(CachedLayer* layer, size_t size);
 
-cl_mem RequestDDRMemory(CachedLayer* layer, size_t size);
+size_t RequestDDRMemory(CachedLayer* layer, size_t size);
+
+void BindDDRMemory(CachedLayer* layer);
 
 }  // namespace contrib
 }  // namespace runtime
@@ -142,14 +142,17 @@ class CLMLRuntime : public JSONRuntimeBase {
       auto tensor_desc = it->second.first;
       result = CLML_INTF->clReleaseMLTensorQCOM(tensor_desc->tensor);
       ICHECK(result == CL_SUCCESS) << "clReleaseMLTensorQCOM:" << result;
-      if (this->layer_.ddr_storage_ref_map.find(tensor_desc->memory) !=
+      if (this->layer_.ddr_storage_ref_map.find(tensor_desc->memory) ==
           this->layer_.ddr_storage_ref_map.end()) {
-        ReleaseDDRMemory(tensor_desc->memory);
-      } else {
         result = clReleaseMemObject(tensor_desc->memory);
         ICHECK(result == CL_SUCCESS) << "clReleaseMemObject:" << result;
       }
     }
+    // The layer holds one reference on each buffer of the global pool it uses.
+    for (auto it = this->layer_.ddr_storage_ref_map.begin();
+         it != this->layer_.ddr_storage_ref_map.end(); it++) {
+      ReleaseDDRMemory(it->first);
+    }
     for (size_t i = 0; i < this->layer_.function.size(); ++i) {
       result = CLML_INTF->clReleaseMLOpQCOM(this->layer_.function[i]);
       ICHECK(result == CL_SUCCESS) << "clReleaseMLOpQCOM:" << result;
@@ -467,9 +470,9 @@ class CLMLRuntime : public JSONRuntimeBase {
         } else {
           layer_.on_chip_reject.insert({nid, size});
           // DDR Allocation
-          auto ddr_mem = RequestDDRMemory(&this->layer_, size);
-          LOG_MEM << "Alloc DDR from global pool for nid:" << nid << " Type:" << node.GetOpType();
-          layer_.ddr_alloc_plan.insert({nid, ddr_mem});
+          auto ddr_slot = RequestDDRMemory(&this->layer_, size);
+          LOG_MEM << "Alloc DDR from local pool for nid:" << nid << " Type:" << node.GetOpType();
+          layer_.ddr_slot_plan.insert({nid, ddr_slot});
         }
 
         // Now free up the input tensors on-chip memory for reuse.
@@ -481,6 +484,8 @@ class CLMLRuntime : public JSONRuntimeBase {
         }
       }
     }
+    // Back the DDR plan by the buffers shared with the other subgraphs.
+    BindDDRMemory(&this->layer_);
 
     // Stats dump
     size_t in_chip_total_alloc = 0;
@@ -161,6 +161,8 @@ struct CachedLayer {
   int on_chip_alert_fail;                                       // Faliure due to fragmentation
 
   /* DDR memory planner */
+  std::vector<std::pair<size_t, bool>> ddr_slots;              // virtual buffers: size & in use
+  std::map<int, size_t> ddr_slot_plan;                         // nid & virtual buffer
   std::map<cl_mem, std::pair<int, bool>> ddr_storage_ref_map;  // local pool reference count
   std::map<int, cl_mem> ddr_alloc_plan;                        // allocation map <nid, cl_mem>
 
@@ -24,7 +24,14 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "../../3rdparty/compiler-rt/builtin_fp16.h"
+#include "../../cuda/cuda_common.h"
 #include "../cblas/gemm_common.h"
 #include "cublas_utils.h"
 
@@ -135,6 +142,72 @@ int roundoff(int v, int d) { return (v + d - 1) / d * d; }
 
 #if CUDART_VERSION >= 10010
 
+/*!
+ * \brief Pick the algorithm of a matmul plan, whose pointer attributes are set. With autotuning,
+ *  the algorithm picked for the configuration before is reused, or the heuristic candidates are
+ *  benchmarked on the given buffers and the fastest one is recorded.
+ */
+cublasLtMatmulAlgo_t PickMatmulAlgo(cublasLtHandle_t hdl, cudaStream_t stream,
+                                    cublasLtMatmulPreference_t matmul_pref_desc,
+                                    const CuBlasLtMatmulPlan& plan, const void* alpha,
+                                    const void* beta, const void* A_data, const void* B_data,
+                                    void* C_data, void* workspace_ptr, size_t workspace_size,
+                                    const std::string& key) {
+  CuBlasLtAlgoStore* store = CuBlasLtAlgoStore::Global();
+  int num_candidates = store->NumCandidates();
+  cublasLtMatmulAlgo_t algo;
+  if (num_candidates > 0 && store->Lookup(key, &algo)) {
+    cublasLtMatmulHeuristicResult_t check = {};
+    if (cublasLtMatmulAlgoCheck(hdl, plan.op_desc, plan.A_desc, plan.B_desc, plan.C_desc,
+                                plan.C_desc, &algo, &check) == CUBLAS_STATUS_SUCCESS &&
+        check.workspaceSize <= workspace_size) {
+      return algo;
+    }
+  }
+  std::vector<cublasLtMatmulHeuristicResult_t> results(std::max(num_candidates, 1));
+  int returned_result = 0;
+  CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(
+      hdl, plan.op_desc, plan.A_desc, plan.B_desc, plan.C_desc, plan.C_desc, matmul_pref_desc,
+      results.size(), results.data(), &returned_result));
+  if (returned_result == 0) {
+    CHECK_CUBLAS_ERROR(CUBLAS_STATUS_NOT_SUPPORTED);
+  }
+  if (num_candidates == 0) {
+    return results[0].algo;
+  }
+  // Benchmark the candidates, whose runs only overwrite the output of the GEMM.
+  auto run = [&](const cublasLtMatmulAlgo_t& candidate) {
+    return cublasLtMatmul(hdl, plan.op_desc, alpha, B_data, plan.A_desc, A_data, plan.B_desc, beta,
+                          C_data, plan.C_desc, C_data, plan.C_desc, &candidate, workspace_ptr,
+                          workspace_size, stream);
+  };
+  constexpr int kRepeat = 10;
+  cudaEvent_t start, stop;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&stop));
+  int best = 0;
+  float best_ms = std::numeric_limits<float>::max();
+  for (int i = 0; i < returned_result; ++i) {
+    if (run(results[i].algo) != CUBLAS_STATUS_SUCCESS) continue;
+    CUDA_CALL(cudaEventRecord(start, stream));
+    for (int r = 0; r < kRepeat; ++r) {
+      run(results[i].algo);
+    }
+    CUDA_CALL(cudaEventRecord(stop, stream));
+    CUDA_CALL(cudaEventSynchronize(stop));
+    float ms = 0;
+    CUDA_CALL(cudaEventElapsedTime(&ms, start, stop));
+    if (ms < best_ms) {
+      best = i;
+      best_ms = ms;
+    }
+  }
+  CUDA_CALL(cudaEventDestroy(start));
+  CUDA_CALL(cudaEventDestroy(stop));
+  store->Save(key, results[best].algo);
+  return results[best].algo;
+}
+
 void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
                   cublasLtMatmulPreference_t matmul_pref_desc, const DLTensor* A, const DLTensor* B,
                   const DLTensor* bias, const DLTensor* scaleA, const DLTensor* scaleB,
@@ -179,35 +252,9 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
     beta = &zero_i32;
   }
 
-  cublasLtMatmulDesc_t op_desc;
   cublasOperation_t op_transa = CUBLASBooleanToTranspose(transa);
   cublasOperation_t op_transb = CUBLASBooleanToTranspose(transb);
 
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&op_desc, compute_type, scale_type));
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSA,
-                                                    &op_transb, sizeof(op_transb)));
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSB,
-                                                    &op_transa, sizeof(op_transa)));
-
-  if (bias != nullptr) {
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
-                                                      &bias->data, sizeof(float*)));
-  }
-
-  if (scaleA != nullptr && scaleB != nullptr) {
-    auto scaleA_data = static_cast<char*>(scaleA->data) + scaleA->byte_offset;
-    auto scaleB_data = static_cast<char*>(scaleB->data) + scaleB->byte_offset;
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
-                                                      &scaleA_data, sizeof(float*)));
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
-                                                      &scaleB_data, sizeof(float*)));
-  }
-
-  if (epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
-                                                      &epilogue, sizeof(epilogue)));
-  }
-
   int batch_offset_A = A->ndim - 2;
   int batch_offset_B = B->ndim - 2;
 
@@ -234,69 +281,109 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
   int ldb = transa ? N : K;
   int ldc = M;
 
-  cublasLtMatrixLayout_t A_desc, B_desc, C_desc;
-  CHECK_CUBLAS_ERROR(
-      cublasLtMatrixLayoutCreate(&A_desc, ab_type, !transb ? M : K, !transb ? K : M, lda));
-  CHECK_CUBLAS_ERROR(
-      cublasLtMatrixLayoutCreate(&B_desc, ab_type, !transa ? K : N, !transa ? N : K, ldb));
-  CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&C_desc, c_type, M, N, ldc));
-
-  if (use_batched_gemm) {
-    auto get_batch_count = [](int64_t* shape, int batch_offset) {
-      int64_t count = 1;
-      for (int i = 0; i < batch_offset; ++i) {
-        count *= shape[i];
-      }
-      return count;
-    };
-    auto set_batch = [](cublasLtMatrixLayout_t mat_desc, int batch_count, int64_t batch_stride) {
-      CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
-          mat_desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
-      CHECK_CUBLAS_ERROR(
-          cublasLtMatrixLayoutSetAttribute(mat_desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET,
-                                           &batch_stride, sizeof(batch_stride)));
-    };
-
-    int batch_count_A = get_batch_count(A->shape, batch_offset_A);
-    int batch_count_B = get_batch_count(B->shape, batch_offset_B);
-    int batch_count_C = get_batch_count(C->shape, C->ndim - 2);
-    int64_t batch_stride_A = M * K;
-    int64_t batch_stride_B = K * N;
-    int64_t batch_stride_C = M * N;
-
-    // cuBLASLt does not seem to support batched GEMM with one of matrices having
-    // one batch (with batch_stride 0).
-    ICHECK_EQ(batch_count_A, batch_count_B);
-
-    set_batch(A_desc, batch_count_A, batch_stride_A);
-    set_batch(B_desc, batch_count_B, batch_stride_B);
-    set_batch(C_desc, batch_count_C, batch_stride_C);
+  auto get_batch_count = [](int64_t* shape, int batch_offset) {
+    int64_t count = 1;
+    for (int i = 0; i < batch_offset; ++i) {
+      count *= shape[i];
+    }
+    return count;
+  };
+  int batch_count_A = use_batched_gemm ? get_batch_count(A->shape, batch_offset_A) : 1;
+  int batch_count_B = use_batched_gemm ? get_batch_count(B->shape, batch_offset_B) : 1;
+  int batch_count_C = use_batched_gemm ? get_batch_count(C->shape, C->ndim - 2) : 1;
+
+  // The configuration of the GEMM, which identifies its plan. The algorithms picked by autotuning
+  // are keyed by it without the device, so that they apply to the devices of the same arch.
+  int device_id = 0;
+  int cc_major = 0;
+  int cc_minor = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&cc_major, cudaDevAttrComputeCapabilityMajor, device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&cc_minor, cudaDevAttrComputeCapabilityMinor, device_id));
+  std::ostringstream os;
+  os << "sm" << cc_major << cc_minor << ":" << static_cast<int>(ab_type) << ","
+     << static_cast<int>(c_type) << "," << static_cast<int>(compute_type) << "," << transa << ","
+     << transb << "," << M << "," << N << "," << K << "," << batch_count_A << ","
+     << batch_count_B << "," << batch_count_C << "," << static_cast<int>(epilogue) << ","
+     << (bias != nullptr) << "," << (scaleA != nullptr && scaleB != nullptr) << ","
+     << workspace_size;
+  std::string key = os.str();
+
+  std::unique_ptr<CuBlasLtMatmulPlan>& plan =
+      CuBlasLtPlanCache::ThreadLocal()->plans[std::to_string(device_id) + "/" + key];
+  bool new_plan = plan == nullptr;
+  if (new_plan) {
+    plan = std::make_unique<CuBlasLtMatmulPlan>();
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&plan->op_desc, compute_type, scale_type));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_TRANSA,
+                                                      &op_transb, sizeof(op_transb)));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_TRANSB,
+                                                      &op_transa, sizeof(op_transa)));
+    if (epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
+      CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+          plan->op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue, sizeof(epilogue)));
+    }
+
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->A_desc, ab_type, !transb ? M : K,
+                                                  !transb ? K : M, lda));
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->B_desc, ab_type, !transa ? K : N,
+                                                  !transa ? N : K, ldb));
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->C_desc, c_type, M, N, ldc));
+
+    if (use_batched_gemm) {
+      auto set_batch = [](cublasLtMatrixLayout_t mat_desc, int batch_count,
+                          int64_t batch_stride) {
+        CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
+            mat_desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
+        CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
+            mat_desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET, &batch_stride,
+            sizeof(batch_stride)));
+      };
+
+      int64_t batch_stride_A = M * K;
+      int64_t batch_stride_B = K * N;
+      int64_t batch_stride_C = M * N;
+
+      // cuBLASLt does not seem to support batched GEMM with one of matrices having
+      // one batch (with batch_stride 0).
+      ICHECK_EQ(batch_count_A, batch_count_B);
+
+      set_batch(plan->A_desc, batch_count_A, batch_stride_A);
+      set_batch(plan->B_desc, batch_count_B, batch_stride_B);
+      set_batch(plan->C_desc, batch_count_C, batch_stride_C);
+    }
+  }
+
+  // The pointers differ from call to call, and are set on the cached descriptor every time.
+  if (bias != nullptr) {
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan->op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias->data, sizeof(float*)));
+  }
+
+  if (scaleA != nullptr && scaleB != nullptr) {
+    auto scaleA_data = static_cast<char*>(scaleA->data) + scaleA->byte_offset;
+    auto scaleB_data = static_cast<char*>(scaleB->data) + scaleB->byte_offset;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan->op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER, &scaleA_data, sizeof(float*)));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan->op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER, &scaleB_data, sizeof(float*)));
   }
 
   auto A_data = static_cast<char*>(A->data) + A->byte_offset;
   auto B_data = static_cast<char*>(B->data) + B->byte_offset;
   auto C_data = static_cast<char*>(C->data) + C->byte_offset;
 
-  cublasLtMatmulPreferenceSetAttribute(matmul_pref_desc, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
-                                       &workspace_size, sizeof(size_t));
-
-  cublasLtMatmulHeuristicResult_t heuristic_result = {};
-  int returned_result = 0;
-  CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(hdl, op_desc, A_desc, B_desc, C_desc, C_desc,
-                                                    matmul_pref_desc, 1, &heuristic_result,
-                                                    &returned_result));
-  if (returned_result == 0) {
-    CHECK_CUBLAS_ERROR(CUBLAS_STATUS_NOT_SUPPORTED);
+  if (new_plan) {
+    cublasLtMatmulPreferenceSetAttribute(matmul_pref_desc,
+                                         CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_size,
+                                         sizeof(size_t));
+    plan->algo = PickMatmulAlgo(hdl, stream, matmul_pref_desc, *plan, alpha, beta, A_data, B_data,
+                                C_data, workspace_ptr, workspace_size, key);
   }
 
-  CHECK_CUBLAS_ERROR(cublasLtMatmul(hdl, op_desc, alpha, B_data, A_desc, A_data, B_desc, beta,
-                                    C_data, C_desc, C_data, C_desc, &heuristic_result.algo,
-                                    workspace_ptr, workspace_size, stream));
-
-  cublasLtMatmulDescDestroy(op_desc);
-  cublasLtMatrixLayoutDestroy(A_desc);
-  cublasLtMatrixLayoutDestroy(B_desc);
-  cublasLtMatrixLayoutDestroy(C_desc);
+  CHECK_CUBLAS_ERROR(cublasLtMatmul(hdl, plan->op_desc, alpha, B_data, plan->A_desc, A_data,
+                                    plan->B_desc, beta, C_data, plan->C_desc, C_data, plan->C_desc,
+                                    &plan->algo, workspace_ptr, workspace_size, stream));
 }
 
 inline void CallLtIgemm(TVMArgs args, TVMRetValue* ret, cublasLtHandle_t hdl, cudaStream_t stream) {
@@ -72,23 +72,7 @@ class CublasJSONRuntime : public JSONRuntimeBase {
     cudaStream_t stream = static_cast<cudaStream_t>((*func)().operator void*());
 
     std::vector<const DLTensor*> dl_tensors(NumEntries());
-
-    for (size_t i = 0; i < static_cast<size_t>(args.size()); i++) {
-      auto eid = i < input_var_eid_.size() ? input_var_eid_[i]
-                                           : EntryID(outputs_[i - input_var_eid_.size()]);
-      ICHECK(args[i].type_code() == kTVMNDArrayHandle || args[i].type_code() == kTVMDLTensorHandle)
-          << "Expect NDArray or DLTensor as inputs";
-
-      const DLTensor* arg;
-      if (args[i].IsObjectRef<NDArray>()) {
-        NDArray arr = args[i];
-        arg = arr.operator->();
-      } else {
-        arg = args[i].operator DLTensor*();
-      }
-
-      dl_tensors[eid] = arg;
-    }
+    BindInputOutputBuffers(args, &dl_tensors);
 
     auto get_input = [this, &dl_tensors](const JSONGraphNode& node, int idx) {
       ICHECK_LT(idx, node.GetInputs().size());
@@ -25,6 +25,12 @@
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
 #include "../../cuda/cuda_common.h"
 
 namespace tvm {
@@ -73,5 +79,99 @@ typedef dmlc::ThreadLocalStore<CuBlasLtThreadEntry> CuBlasLtThreadStore;
 
 CuBlasLtThreadEntry* CuBlasLtThreadEntry::ThreadLocal() { return CuBlasLtThreadStore::Get(); }
 
+CuBlasLtMatmulPlan::~CuBlasLtMatmulPlan() {
+  if (op_desc) cublasLtMatmulDescDestroy(op_desc);
+  if (A_desc) cublasLtMatrixLayoutDestroy(A_desc);
+  if (B_desc) cublasLtMatrixLayoutDestroy(B_desc);
+  if (C_desc) cublasLtMatrixLayoutDestroy(C_desc);
+}
+
+typedef dmlc::ThreadLocalStore<CuBlasLtPlanCache> CuBlasLtPlanCacheStore;
+
+CuBlasLtPlanCache* CuBlasLtPlanCache::ThreadLocal() { return CuBlasLtPlanCacheStore::Get(); }
+
+CuBlasLtAlgoStore::CuBlasLtAlgoStore() {
+  const char* num_candidates = getenv("TVM_CUBLASLT_AUTOTUNE");
+  const char* path = getenv("TVM_CUBLASLT_AUTOTUNE_FILE");
+  Configure(num_candidates ? atoi(num_candidates) : 0, path ? path : "");
+}
+
+CuBlasLtAlgoStore* CuBlasLtAlgoStore::Global() {
+  static CuBlasLtAlgoStore* inst = new CuBlasLtAlgoStore();
+  return inst;
+}
+
+void CuBlasLtAlgoStore::Configure(int num_candidates, const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_candidates_ = std::max(num_candidates, 0);
+  if (path != path_) {
+    path_ = path;
+    Load();
+  }
+}
+
+int CuBlasLtAlgoStore::NumCandidates() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_candidates_;
+}
+
+bool CuBlasLtAlgoStore::Lookup(const std::string& key, cublasLtMatmulAlgo_t* algo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = algos_.find(key);
+  if (it == algos_.end()) return false;
+  *algo = it->second;
+  return true;
+}
+
+void CuBlasLtAlgoStore::Load() {
+  algos_.clear();
+  if (path_.empty()) return;
+  std::ifstream is(path_);
+  std::string version;
+  // The first line is the version of cuBLASLt which the algorithms were picked with.
+  if (!std::getline(is, version) || version != std::to_string(cublasLtGetVersion())) return;
+  std::string key, hex;
+  while (is >> key >> hex) {
+    cublasLtMatmulAlgo_t algo;
+    if (hex.size() != 2 * sizeof(algo)) continue;
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&algo);
+    for (size_t i = 0; i < sizeof(algo); ++i) {
+      bytes[i] = static_cast<uint8_t>(std::stoi(hex.substr(2 * i, 2), nullptr, 16));
+    }
+    algos_[key] = algo;
+  }
+}
+
+void CuBlasLtAlgoStore::Save(const std::string& key, const cublasLtMatmulAlgo_t& algo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  algos_[key] = algo;
+  if (path_.empty()) return;
+  // Write a new file and move it over the old one, so that a concurrent reader never sees a
+  // partial file.
+  std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream os(tmp_path);
+    os << cublasLtGetVersion() << "\n";
+    for (const auto& kv : algos_) {
+      os << kv.first << " ";
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&kv.second);
+      for (size_t i = 0; i < sizeof(kv.second); ++i) {
+        char buf[3];
+        snprintf(buf, sizeof(buf), "%02x", bytes[i]);
+        os << buf;
+      }
+      os << "\n";
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the cuBLASLt autotuning file " << path_;
+  }
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.cublaslt.configure_autotune")
+    .set_body_typed([](int num_candidates, String path) {
+      CuBlasLtAlgoStore::Global()->Configure(num_candidates, path);
+    });
+
 }  // namespace contrib
 }  // namespace tvm
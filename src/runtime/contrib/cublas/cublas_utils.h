@@ -34,7 +34,11 @@
 #if CUDART_VERSION >= 10010
 #include <cublasLt.h>
 #endif  // CUDART_VERSION >= 10010
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <unordered_map>
 
 namespace tvm {
 namespace contrib {
@@ -92,6 +96,65 @@ struct CuBlasLtThreadEntry {
   static CuBlasLtThreadEntry* ThreadLocal();
 };  // CuBlasLtThreadEntry
 
+/*! \brief The descriptors and the algorithm of a cuBLASLt matmul configuration. */
+struct CuBlasLtMatmulPlan {
+  CuBlasLtMatmulPlan() = default;
+  CuBlasLtMatmulPlan(const CuBlasLtMatmulPlan&) = delete;
+  CuBlasLtMatmulPlan& operator=(const CuBlasLtMatmulPlan&) = delete;
+  ~CuBlasLtMatmulPlan();
+
+  cublasLtMatmulDesc_t op_desc{nullptr};
+  cublasLtMatrixLayout_t A_desc{nullptr};
+  cublasLtMatrixLayout_t B_desc{nullptr};
+  cublasLtMatrixLayout_t C_desc{nullptr};
+  cublasLtMatmulAlgo_t algo;
+};  // CuBlasLtMatmulPlan
+
+/*!
+ * \brief The matmul plans of a thread, keyed by the shapes, the data types, the epilogue and the
+ *  device of the GEMM, so that repeated GEMMs skip the descriptor creation and the heuristic.
+ */
+struct CuBlasLtPlanCache {
+  std::unordered_map<std::string, std::unique_ptr<CuBlasLtMatmulPlan>> plans;
+
+  static CuBlasLtPlanCache* ThreadLocal();
+};  // CuBlasLtPlanCache
+
+/*!
+ * \brief The matmul algorithms picked by autotuning, which are shared by the threads and
+ *  persisted to a file that later processes reuse.
+ *
+ *  Autotuning is configured by TVM_CUBLASLT_AUTOTUNE, the number of heuristic candidates to
+ *  benchmark (0, the default, takes the first heuristic), and TVM_CUBLASLT_AUTOTUNE_FILE, the
+ *  file of the picked algorithms.
+ */
+class CuBlasLtAlgoStore {
+ public:
+  static CuBlasLtAlgoStore* Global();
+  /*!
+   * \brief Configure autotuning.
+   * \param num_candidates The number of heuristic candidates to benchmark, 0 disables autotuning.
+   * \param path The file of the picked algorithms, empty to keep them in memory only.
+   */
+  void Configure(int num_candidates, const std::string& path);
+  /*! \brief The number of heuristic candidates to benchmark. */
+  int NumCandidates();
+  /*! \brief Look up the algorithm picked for a GEMM configuration. */
+  bool Lookup(const std::string& key, cublasLtMatmulAlgo_t* algo);
+  /*! \brief Record the algorithm picked for a GEMM configuration, and persist it. */
+  void Save(const std::string& key, const cublasLtMatmulAlgo_t& algo);
+
+ private:
+  CuBlasLtAlgoStore();
+  /*! \brief Load the algorithms of the file, which are dropped for another cuBLASLt version. */
+  void Load();
+
+  std::mutex mutex_;
+  int num_candidates_{0};
+  std::string path_;
+  std::unordered_map<std::string, cublasLtMatmulAlgo_t> algos_;
+};  // CuBlasLtAlgoStore
+
 inline cudaDataType_t GetCudaDataType(DLDataType type) {
   if (type.code == kDLInt) {
     switch (type.bits) {
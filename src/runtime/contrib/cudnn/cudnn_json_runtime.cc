@@ -125,18 +125,35 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
 
   const char* type_key() const override { return "cudnn_json"; }  // May be overridden
 
-  void Run() override {
-    auto get_inputs = [this](const JSONGraphNode& node, bool has_bias) {
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) override {
+    // The cuDNN handles and workspaces are thread local, so the calls from different threads run
+    // concurrently as long as each of them binds its arguments to its own data entries.
+    if (this->symbol_name_ == name) {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK(this->initialized_) << "The module has not been initialized";
+        std::vector<const DLTensor*> data_entry = this->data_entry_;
+        this->BindInputOutputBuffers(args, &data_entry);
+        this->Run(data_entry);
+      });
+    } else {
+      return JSONRuntimeBase::GetFunction(name, sptr_to_self);
+    }
+  }
+
+  void Run() override { Run(data_entry_); }
+
+  void Run(const std::vector<const DLTensor*>& data_entry) {
+    auto get_inputs = [this, &data_entry](const JSONGraphNode& node, bool has_bias) {
       const DLTensor* bias = nullptr;
       if (has_bias) {
-        bias = GetInput(node, 2);
+        bias = GetInput(data_entry, node, 2);
       }
-      return std::make_tuple(GetInput(node, 0), GetInput(node, 1), bias);
+      return std::make_tuple(GetInput(data_entry, node, 0), GetInput(data_entry, node, 1), bias);
     };
 
     auto [a_ptr, b_ptr, bias_ptr] = get_inputs(kernel_node, has_bias);
     uint32_t output_eid = EntryID(outputs_[0]);
-    auto out_ptr = data_entry_[output_eid];
+    auto out_ptr = data_entry[output_eid];
 
     if (this->has_bias) {
       tvm::contrib::ConvolutionBiasActivationForward(
@@ -151,11 +168,12 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
   }
 
  private:
-  const DLTensor* GetInput(const JSONGraphNode& node, const int idx) {
+  const DLTensor* GetInput(const std::vector<const DLTensor*>& data_entry,
+                           const JSONGraphNode& node, const int idx) {
     ICHECK_LT(idx, node.GetInputs().size());
     auto eid = EntryID(node.GetInputs()[idx]);
-    ICHECK(eid < data_entry_.size());
-    return data_entry_[eid];
+    ICHECK(eid < data_entry.size());
+    return data_entry[eid];
   }
   /*conv op name*/
   std::string op_name;
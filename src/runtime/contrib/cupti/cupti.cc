@@ -0,0 +1,304 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <cuda.h>
+#include <cuda_runtime.h>
+#include <cupti.h>
+#include <tvm/runtime/contrib/cupti.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define CUPTI_CALL(func)                                             \
+  {                                                                  \
+    CUptiResult e = (func);                                          \
+    if (e != CUPTI_SUCCESS) {                                        \
+      const char* msg = nullptr;                                     \
+      cuptiGetResultString(e, &msg);                                 \
+      LOG(FATAL) << "CUPTIError: in function " #func " " << e << " " \
+                 << (msg != nullptr ? msg : "");                     \
+    }                                                                \
+  }
+
+/*! \brief The metrics collected on a device when none are given, which the roofline uses. */
+static const std::vector<std::string> default_metric_names = {
+    "achieved_occupancy",    "sm_efficiency",   "dram_read_throughput",
+    "dram_write_throughput", "dram_read_bytes", "dram_write_bytes"};
+
+/*! \brief Object that holds the values of the counters at the start of a function call. */
+struct CUPTICountersNode : public Object {
+  /*! \brief The starting values of the events of the device. */
+  std::vector<uint64_t> start_values;
+  /*! \brief The CUPTI timestamp at the start of the call, in nanoseconds. */
+  uint64_t start_time;
+  /*! \brief The device these counters are for. */
+  Device dev;
+
+  explicit CUPTICountersNode(std::vector<uint64_t> start_values, uint64_t start_time, Device dev)
+      : start_values(start_values), start_time(start_time), dev(dev) {}
+
+  static constexpr const char* _type_key = "CUPTICountersNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTICountersNode, Object);
+};
+
+/*! \brief The counters collected on one device. */
+struct CUPTIDeviceCounters {
+  CUdevice device;
+  /*! \brief The event groups that collect the events of all the metrics in one pass. */
+  CUpti_EventGroupSets* group_sets = nullptr;
+  /*! \brief The metrics collected, which all fit in the first set of `group_sets`. */
+  std::vector<std::string> metric_names;
+  std::vector<CUpti_MetricID> metric_ids;
+  /*! \brief The events read, in the order of the values of `Read`. */
+  std::vector<CUpti_EventID> event_ids;
+
+  /*! \brief Read the events of the device, normalized over the instances of their domain. */
+  std::vector<uint64_t> Read() {
+    std::vector<uint64_t> result;
+    std::vector<CUpti_EventID> ids;
+    CUpti_EventGroupSet& set = group_sets->sets[0];
+    for (uint32_t g = 0; g < set.numEventGroups; ++g) {
+      CUpti_EventGroup group = set.eventGroups[g];
+      uint32_t num_instances = 0, num_events = 0, total_instances = 0;
+      CUpti_EventDomainID domain;
+      size_t size = sizeof(num_instances);
+      CUPTI_CALL(cuptiEventGroupGetAttribute(group, CUPTI_EVENT_GROUP_ATTR_INSTANCE_COUNT, &size,
+                                             &num_instances));
+      size = sizeof(num_events);
+      CUPTI_CALL(cuptiEventGroupGetAttribute(group, CUPTI_EVENT_GROUP_ATTR_NUM_EVENTS, &size,
+                                             &num_events));
+      size = sizeof(domain);
+      CUPTI_CALL(cuptiEventGroupGetAttribute(group, CUPTI_EVENT_GROUP_ATTR_EVENT_DOMAIN_ID, &size,
+                                             &domain));
+      size = sizeof(total_instances);
+      CUPTI_CALL(cuptiDeviceGetEventDomainAttribute(
+          device, domain, CUPTI_EVENT_DOMAIN_ATTR_TOTAL_INSTANCE_COUNT, &size, &total_instances));
+      std::vector<uint64_t> values(static_cast<size_t>(num_instances) * num_events);
+      std::vector<CUpti_EventID> group_ids(num_events);
+      size_t values_bytes = values.size() * sizeof(uint64_t);
+      size_t ids_bytes = group_ids.size() * sizeof(CUpti_EventID);
+      size_t num_read = 0;
+      CUPTI_CALL(cuptiEventGroupReadAllEvents(group, CUPTI_EVENT_READ_FLAG_NONE, &values_bytes,
+                                              values.data(), &ids_bytes, group_ids.data(),
+                                              &num_read));
+      // The values are laid out by domain instance, then by event.
+      for (uint32_t e = 0; e < num_events; ++e) {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < num_instances; ++i) {
+          sum += values[static_cast<size_t>(i) * num_events + e];
+        }
+        result.push_back(num_instances == 0 ? 0 : sum * total_instances / num_instances);
+        ids.push_back(group_ids[e]);
+      }
+    }
+    event_ids = ids;
+    return result;
+  }
+};
+
+/*! \brief MetricCollectorNode for the metrics of CUDA kernels.
+ *
+ * The counters run continuously from `Init`, and the metrics of a call come from the change of
+ * the counters between its `Start` and its `Stop`, which both synchronize the device. The
+ * metrics that would need more than one pass over the kernel are dropped with a warning.
+ */
+struct CUPTIMetricCollectorNode final : public MetricCollectorNode {
+  explicit CUPTIMetricCollectorNode(Map<DeviceWrapper, Array<String>> metrics) {
+    for (auto& p : metrics) {
+      metric_names[p.first->device] = {};
+      for (auto& metric : p.second) {
+        metric_names[p.first->device].push_back(metric);
+      }
+    }
+  }
+
+  /*! \brief Initialization call.
+   * \param devices The devices this collector will be running on
+   */
+  void Init(Array<DeviceWrapper> devices) final {
+    for (auto wrapped_device : devices) {
+      Device dev = wrapped_device->device;
+      if (dev.device_type != kDLCUDA) continue;
+      auto it = metric_names.find(dev);
+      const std::vector<std::string>& names =
+          it != metric_names.end() ? it->second : default_metric_names;
+
+      CUPTIDeviceCounters state;
+      CUDA_CALL(cudaSetDevice(dev.device_id));
+      // Make the primary context of the device current.
+      CUDA_CALL(cudaFree(nullptr));
+      CUcontext context;
+      CUDA_DRIVER_CALL(cuCtxGetCurrent(&context));
+      CUDA_DRIVER_CALL(cuDeviceGet(&state.device, dev.device_id));
+      CUPTI_CALL(cuptiSetEventCollectionMode(context, CUPTI_EVENT_COLLECTION_MODE_CONTINUOUS));
+
+      // Add the metrics one by one, keeping the ones whose events still fit in one pass.
+      for (const std::string& name : names) {
+        CUpti_MetricID id;
+        if (cuptiMetricGetIdFromName(state.device, name.c_str(), &id) != CUPTI_SUCCESS) {
+          LOG(WARNING) << "CUPTI has no metric " << name << " on " << DeviceName(dev);
+          continue;
+        }
+        std::vector<CUpti_MetricID> ids = state.metric_ids;
+        ids.push_back(id);
+        CUpti_EventGroupSets* sets = nullptr;
+        CUptiResult e = cuptiMetricCreateEventGroupSets(
+            context, ids.size() * sizeof(CUpti_MetricID), ids.data(), &sets);
+        if (e != CUPTI_SUCCESS || sets->numSets > 1) {
+          LOG(WARNING) << "Dropping the CUPTI metric " << name << ", as it does not fit in one "
+                       << "pass over the kernels with the metrics before it";
+          if (e == CUPTI_SUCCESS) CUPTI_CALL(cuptiEventGroupSetsDestroy(sets));
+          continue;
+        }
+        if (state.group_sets != nullptr) CUPTI_CALL(cuptiEventGroupSetsDestroy(state.group_sets));
+        state.group_sets = sets;
+        state.metric_ids = ids;
+        state.metric_names.push_back(name);
+      }
+      if (state.group_sets == nullptr) continue;
+      CUPTI_CALL(cuptiEventGroupSetEnable(&state.group_sets->sets[0]));
+      counters[dev] = state;
+    }
+  }
+
+  /*! \brief Called right before a function call. Reads the starting values of the counters.
+   *
+   * \param dev The device the function will be run on.
+   * \returns A `CUPTICountersNode` passed to the corresponding `Stop` call, or nullptr if the
+   * device collects no metric.
+   */
+  ObjectRef Start(Device dev) final {
+    auto it = counters.find(dev);
+    if (it == counters.end()) return ObjectRef(nullptr);
+    TVMSynchronize(dev.device_type, dev.device_id, nullptr);
+    uint64_t timestamp;
+    CUPTI_CALL(cuptiGetTimestamp(&timestamp));
+    return ObjectRef(make_object<CUPTICountersNode>(it->second.Read(), timestamp, dev));
+  }
+
+  /*! \brief Called right after a function call. Computes the metrics from the change of the
+   * counters since the corresponding `Start` call.
+   *
+   * \param obj `CUPTICountersNode` created by a call to `Start`.
+   * \returns A mapping from metric name to value.
+   */
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const CUPTICountersNode* start = obj.as<CUPTICountersNode>();
+    TVMSynchronize(start->dev.device_type, start->dev.device_id, nullptr);
+    uint64_t timestamp;
+    CUPTI_CALL(cuptiGetTimestamp(&timestamp));
+    CUPTIDeviceCounters& state = counters[start->dev];
+    std::vector<uint64_t> deltas = state.Read();
+    for (size_t i = 0; i < deltas.size(); ++i) {
+      deltas[i] = deltas[i] >= start->start_values[i] ? deltas[i] - start->start_values[i] : 0;
+    }
+    uint64_t duration = timestamp - start->start_time;
+
+    std::unordered_map<String, ObjectRef> reported_metrics;
+    for (size_t i = 0; i < state.metric_ids.size(); ++i) {
+      CUpti_MetricValue value;
+      CUptiResult e =
+          cuptiMetricGetValue(state.device, state.metric_ids[i],
+                              state.event_ids.size() * sizeof(CUpti_EventID),
+                              state.event_ids.data(), deltas.size() * sizeof(uint64_t),
+                              deltas.data(), duration, &value);
+      if (e != CUPTI_SUCCESS) continue;
+      CUpti_MetricValueKind kind;
+      size_t size = sizeof(kind);
+      CUPTI_CALL(
+          cuptiMetricGetAttribute(state.metric_ids[i], CUPTI_METRIC_ATTR_VALUE_KIND, &size, &kind));
+      ObjectRef reported;
+      switch (kind) {
+        case CUPTI_METRIC_VALUE_KIND_DOUBLE:
+          reported = ObjectRef(make_object<RatioNode>(value.metricValueDouble));
+          break;
+        case CUPTI_METRIC_VALUE_KIND_UINT64:
+          reported = ObjectRef(make_object<CountNode>(value.metricValueUint64));
+          break;
+        case CUPTI_METRIC_VALUE_KIND_INT64:
+          reported = ObjectRef(make_object<CountNode>(value.metricValueInt64));
+          break;
+        // Ratios, since percentages of the calls should be averaged instead of summed.
+        case CUPTI_METRIC_VALUE_KIND_PERCENT:
+          reported = ObjectRef(make_object<RatioNode>(value.metricValuePercent));
+          break;
+        case CUPTI_METRIC_VALUE_KIND_THROUGHPUT:
+          reported = ObjectRef(make_object<RatioNode>(value.metricValueThroughput));
+          break;
+        case CUPTI_METRIC_VALUE_KIND_UTILIZATION_LEVEL:
+          reported = ObjectRef(make_object<CountNode>(value.metricValueUtilizationLevel));
+          break;
+        default:
+          continue;
+      }
+      reported_metrics[state.metric_names[i]] = reported;
+    }
+    return reported_metrics;
+  }
+
+  ~CUPTIMetricCollectorNode() final {
+    for (auto& p : counters) {
+      cuptiEventGroupSetDisable(&p.second.group_sets->sets[0]);
+      cuptiEventGroupSetsDestroy(p.second.group_sets);
+    }
+  }
+
+  /*! \brief The counters of each device that collects metrics. */
+  std::unordered_map<Device, CUPTIDeviceCounters> counters;
+  /*! \brief The metrics requested for each device. */
+  std::unordered_map<Device, std::vector<std::string>> metric_names;
+
+  static constexpr const char* _type_key = "runtime.profiling.CUPTIMetricCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTIMetricCollectorNode, MetricCollectorNode);
+
+ private:
+  static std::string DeviceName(Device dev) { return "cuda" + std::to_string(dev.device_id); }
+};
+
+/*! \brief Wrapper for `CUPTIMetricCollectorNode`. */
+class CUPTIMetricCollector : public MetricCollector {
+ public:
+  explicit CUPTIMetricCollector(Map<DeviceWrapper, Array<String>> metrics) {
+    data_ = make_object<CUPTIMetricCollectorNode>(metrics);
+  }
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CUPTIMetricCollector, MetricCollector,
+                                        CUPTIMetricCollectorNode);
+};
+
+MetricCollector CreateCUPTIMetricCollector(Map<DeviceWrapper, Array<String>> metrics) {
+  return CUPTIMetricCollector(metrics);
+}
+
+TVM_REGISTER_OBJECT_TYPE(CUPTICountersNode);
+TVM_REGISTER_OBJECT_TYPE(CUPTIMetricCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.CUPTIMetricCollector")
+    .set_body_typed([](Map<DeviceWrapper, Array<String>> metrics) {
+      return CUPTIMetricCollector(metrics);
+    });
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file group_gemm_runner_sm80.cuh
+ * \brief The grouped GEMM of CUTLASS 2.x for sm80 and sm89, whose problem sizes are computed on
+ *  the device from the indptr of the groups, so that the row counts of the groups, e.g. the tokens
+ *  routed to each expert of a MoE layer, never go through the host.
+ */
+#include <algorithm>
+
+#include "../../cuda/cuda_common.h"
+
+// clang-format off
+#include "cutlass/cutlass.h"
+
+#include "cutlass/epilogue/thread/linear_combination.h"
+#include "cutlass/gemm/device/gemm_grouped.h"
+#include "cutlass/gemm/kernel/default_gemm_grouped.h"
+// clang-format on
+
+#ifndef CUTLASS_CHECK
+#define CUTLASS_CHECK(status)                                      \
+  {                                                                \
+    cutlass::Status error = status;                                \
+    CHECK(error == cutlass::Status::kSuccess)                      \
+        << "Got cutlass error: " << cutlassGetStatusString(error); \
+  }
+#endif
+
+inline size_t aligned_sm80(size_t value, size_t alignment = 16) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+/*!
+ * \brief The grouped GEMM out[indptr[i-1]:indptr[i]] = x[indptr[i-1]:indptr[i]] @ weight[i]^T,
+ *  with the row-major x and out and the weight of shape (num_groups, n, k).
+ */
+template <typename ElementA, typename ElementB, typename ElementC>
+struct CutlassGroupGemmRunnerSm80 {
+  static constexpr int AlignmentA = 128 / cutlass::sizeof_bits<ElementA>::value;
+  static constexpr int AlignmentB = 128 / cutlass::sizeof_bits<ElementB>::value;
+  static constexpr int AlignmentC = 128 / cutlass::sizeof_bits<ElementC>::value;
+
+  using ElementAccumulator = float;
+  using LayoutA = cutlass::layout::RowMajor;
+  // The weight of a group is (n, k) row-major, i.e. the column-major B of the GEMM.
+  using LayoutB = cutlass::layout::ColumnMajor;
+  using LayoutC = cutlass::layout::RowMajor;
+  using EpilogueOp = cutlass::epilogue::thread::LinearCombination<ElementC, AlignmentC,
+                                                                  ElementAccumulator,
+                                                                  ElementAccumulator>;
+
+  // The problem sizes are only visited on the device, which computes them before the launch.
+  using GemmKernel = typename cutlass::gemm::kernel::DefaultGemmGrouped<
+      ElementA, LayoutA, cutlass::ComplexTransform::kNone, AlignmentA, ElementB, LayoutB,
+      cutlass::ComplexTransform::kNone, AlignmentB, ElementC, LayoutC, ElementAccumulator,
+      cutlass::arch::OpClassTensorOp, cutlass::arch::Sm80, cutlass::gemm::GemmShape<128, 128, 32>,
+      cutlass::gemm::GemmShape<64, 64, 32>, cutlass::gemm::GemmShape<16, 8, 16>, EpilogueOp,
+      cutlass::gemm::threadblock::GemmBatchedIdentityThreadblockSwizzle, /*Stages=*/4,
+      cutlass::gemm::kernel::GroupScheduleMode::kDeviceOnly>::GemmKernel;
+
+  using Gemm = cutlass::gemm::device::GemmGrouped<GemmKernel>;
+  using LongIndex = typename LayoutA::Stride::LongIndex;
+};
+
+template <typename ElementA, typename ElementB, typename ElementC, typename LongIndex>
+__global__ void prepare_group_gemm_arguments_sm80(
+    cutlass::gemm::GemmCoord* problem_sizes, ElementA** ptr_A, ElementB** ptr_B, ElementC** ptr_D,
+    LongIndex* lda, LongIndex* ldb, LongIndex* ldd, ElementA* x, ElementB* weight, ElementC* out,
+    const int64_t* indptr, int64_t n, int64_t k, int64_t num_groups) {
+  for (int group_id = threadIdx.x; group_id < num_groups; group_id += blockDim.x) {
+    int64_t prev_rows = group_id == 0 ? 0 : indptr[group_id - 1];
+    ptr_A[group_id] = x + prev_rows * k;
+    ptr_B[group_id] = weight + group_id * k * n;
+    ptr_D[group_id] = out + prev_rows * n;
+    int rows = static_cast<int>(indptr[group_id] - prev_rows);
+    problem_sizes[group_id] =
+        cutlass::gemm::GemmCoord(rows, static_cast<int>(n), static_cast<int>(k));
+    lda[group_id] = k;
+    ldb[group_id] = k;
+    ldd[group_id] = n;
+  }
+}
+
+template <typename ElementA, typename ElementB, typename ElementC>
+void cutlass_group_gemm_sm80(ElementA* x, ElementB* weight, int64_t* indptr, uint8_t* workspace,
+                             int64_t workspace_size, int64_t n, int64_t k, int64_t num_groups,
+                             float alpha, float beta, ElementC* out, cudaStream_t stream) {
+  using Runner = CutlassGroupGemmRunnerSm80<ElementA, ElementB, ElementC>;
+  using Gemm = typename Runner::Gemm;
+  using LongIndex = typename Runner::LongIndex;
+
+  std::ptrdiff_t offset = 0;
+  auto* problem_sizes = reinterpret_cast<cutlass::gemm::GemmCoord*>(workspace + offset);
+  offset += aligned_sm80(sizeof(cutlass::gemm::GemmCoord) * num_groups);
+  auto** ptr_A = reinterpret_cast<ElementA**>(workspace + offset);
+  offset += aligned_sm80(sizeof(ElementA*) * num_groups);
+  auto** ptr_B = reinterpret_cast<ElementB**>(workspace + offset);
+  offset += aligned_sm80(sizeof(ElementB*) * num_groups);
+  auto** ptr_D = reinterpret_cast<ElementC**>(workspace + offset);
+  offset += aligned_sm80(sizeof(ElementC*) * num_groups);
+  auto* lda = reinterpret_cast<LongIndex*>(workspace + offset);
+  offset += aligned_sm80(sizeof(LongIndex) * num_groups);
+  auto* ldb = reinterpret_cast<LongIndex*>(workspace + offset);
+  offset += aligned_sm80(sizeof(LongIndex) * num_groups);
+  auto* ldd = reinterpret_cast<LongIndex*>(workspace + offset);
+  offset += aligned_sm80(sizeof(LongIndex) * num_groups);
+  offset = aligned_sm80(offset, 256);
+  CHECK_LE(offset, workspace_size) << "The workspace is too small for " << num_groups << " groups";
+
+  int num_threads = static_cast<int>(std::min<int64_t>(num_groups, 1024));
+  prepare_group_gemm_arguments_sm80<<<1, num_threads, 0, stream>>>(
+      problem_sizes, ptr_A, ptr_B, ptr_D, lda, ldb, ldd, x, weight, out, indptr, n, k, num_groups);
+
+  // Without the host problem sizes, the kernel is launched with the blocks that fill the device,
+  // which visit the tiles of all the groups.
+  int threadblock_count = Gemm::sufficient();
+  typename Gemm::EpilogueOutputOp::Params epilogue_params{alpha, beta};
+  typename Gemm::Arguments arguments(problem_sizes, static_cast<int>(num_groups),
+                                     threadblock_count, epilogue_params, ptr_A, ptr_B, ptr_D, ptr_D,
+                                     lda, ldb, ldd, ldd);
+  Gemm gemm_op;
+  CUTLASS_CHECK(gemm_op.can_implement(arguments));
+  CHECK_GE(workspace_size - offset, gemm_op.get_workspace_size(arguments));
+  CUTLASS_CHECK(gemm_op.initialize(arguments, workspace + offset, stream));
+  CUTLASS_CHECK(gemm_op.run(stream));
+}
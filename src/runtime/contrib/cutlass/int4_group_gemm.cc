@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file int4_group_gemm.cc
+ * \brief The grouped GEMM of fp16 or bf16 activations and int4 weights for sm80 and sm89, e.g.
+ *  for the experts of a MoE layer, with the MoE kernels of FasterTransformer.
+ */
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include "cutlass/numeric_types.h"
+#include "cutlass_kernels/moe_gemm/moe_gemm_kernels.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief out[indptr[i-1]:indptr[i]] = x[indptr[i-1]:indptr[i]] @ (weight[i] * scales[i]).
+ * \param x The activations, of shape (total_rows, k).
+ * \param weight The int4 weights of shape (num_groups, k, n), packed in int8 of shape
+ *  (num_groups, k, n / 2) and preprocessed by cutlass.ft_preprocess_weight.
+ * \param scales The per-channel scales of the weights, of shape (num_groups, n).
+ * \param indptr The number of rows up to the end of each group, of shape (num_groups,). It stays on
+ *  the device, so the row count of each group never goes through the host.
+ * \param out The output, of shape (total_rows, n).
+ */
+template <typename T>
+void tvm_cutlass_int4_group_gemm(NDArray x, NDArray weight, NDArray scales, NDArray indptr,
+                                 NDArray out) {
+  auto func = tvm::runtime::Registry::Get("runtime.get_cuda_stream");
+  ICHECK(func != nullptr);
+  CHECK_EQ(x->ndim, 2);
+  CHECK_EQ(weight->ndim, 3);
+  CHECK_EQ(scales->ndim, 2);
+  CHECK_EQ(indptr->ndim, 1);
+  CHECK_EQ(out->ndim, 2);
+  int num_groups = weight->shape[0];
+  int64_t k = weight->shape[1];
+  int64_t n = weight->shape[2] * 2;
+  int64_t total_rows = x->shape[0];
+  CHECK_EQ(x->shape[1], k);
+  CHECK_EQ(scales->shape[0], num_groups);
+  CHECK_EQ(scales->shape[1], n);
+  CHECK_EQ(indptr->shape[0], num_groups);
+  CHECK_EQ(out->shape[0], total_rows);
+  CHECK_EQ(out->shape[1], n);
+  cudaStream_t stream = static_cast<cudaStream_t>((*func)().operator void*());
+  fastertransformer::MoeGemmRunner<T, cutlass::uint4b_t> runner;
+  runner.moe_gemm(static_cast<const T*>(x->data),
+                  static_cast<const cutlass::uint4b_t*>(weight->data),
+                  static_cast<const T*>(scales->data), static_cast<T*>(out->data),
+                  static_cast<int64_t*>(indptr->data), total_rows, n, k, num_groups, stream);
+}
+
+TVM_REGISTER_GLOBAL("cutlass.group_gemm_fp16_int4_sm80")
+    .set_body_typed(tvm_cutlass_int4_group_gemm<half>);
+
+TVM_REGISTER_GLOBAL("cutlass.group_gemm_bf16_int4_sm80")
+    .set_body_typed(tvm_cutlass_int4_group_gemm<__nv_bfloat16>);
+
+}  // namespace runtime
+}  // namespace tvm
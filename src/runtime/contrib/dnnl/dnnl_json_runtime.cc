@@ -22,11 +22,20 @@
  * \brief A simple JSON runtime for DNNL.
  */
 
+#include <dmlc/parameter.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../../../runtime/regex.h"
@@ -49,12 +58,34 @@ using namespace tvm::runtime::json;
 
 class DNNLJSONRuntime : public JSONRuntimeBase {
  public:
+  /*! \brief The primitives and the memories of the subgraph for the input shapes of a batch. */
+  struct ExecutionPlan {
+    /* The network layers that are represented in dnnl primitives. */
+    TensorRegistry::ActionQue net;
+    /* Storage for all memory objects */
+    TensorRegistry tensor_registry;
+    /* The number of elements of the outputs. */
+    std::vector<int64_t> output_sizes;
+    /* The intermediate memories of the finished runs, reused by the next runs. */
+    mutable std::vector<std::vector<dnnl::memory>> free_tmp_mems;
+    mutable std::mutex mutex;
+  };
+
   DNNLJSONRuntime(const std::string& symbol_name, const std::string& graph_json,
                   const Array<String> const_names)
       : JSONRuntimeBase(symbol_name, graph_json, const_names),
         next_unique_eid_offset_(data_entry_.size()),
         run_arg_eid_(input_var_eid_) {
     for (const auto e : outputs_) run_arg_eid_.push_back(EntryID(e));
+    for (uint32_t nid : input_nodes_) {
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (const auto& shape : nodes_[nid].GetOpShape()) input_shapes_.push_back(shape);
+    }
+    // The leading dimension of the first input is the batch, which may vary across the runs.
+    if (!input_shapes_.empty() && !input_shapes_[0].empty()) {
+      graph_batch_size_ = input_shapes_[0][0];
+    }
+    max_cached_plans_ = dmlc::GetEnv("TVM_DNNL_MAX_CACHED_PLANS", max_cached_plans_);
   }
 
   const char* type_key() const override { return "dnnl_json"; }
@@ -65,18 +96,43 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     // Setup constants entries for weights.
     SetupConstants(consts);
-    BuildEngine();
+    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
+    stream_ = dnnl::stream(engine_);
+    for (const auto& shape : input_shapes_) {
+      graph_shape_key_.insert(graph_shape_key_.end(), shape.begin(), shape.end());
+    }
+    // The plan of a dynamic batch is built on the first run of each batch size.
+    if (std::all_of(graph_shape_key_.begin(), graph_shape_key_.end(),
+                    [](int64_t dim) { return dim >= 0; })) {
+      graph_plan_ = BuildPlan(graph_batch_size_);
+    }
   }
 
   /* Unused stub implementation */
   void Run() override { LOG(FATAL) << "Unreachable code"; }
 
   /* Thread safe implementation of Run. Keep runtime instance immutable */
-  void Run(const TVMArgs& args) const {
+  void Run(const ExecutionPlan& plan, const TVMArgs& args) const {
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+      const DLTensor* output = ExtractDLTensor(args[input_shapes_.size() + i]);
+      ICHECK_EQ(GetSize(output->shape, output->shape + output->ndim), plan.output_sizes[i])
+          << "The size of output " << i << " does not match the shape of the inputs";
+    }
+    // The intermediate memories are allocated once for each run in flight, and reused after.
+    std::vector<dnnl::memory> tmp_mems;
+    {
+      std::lock_guard<std::mutex> lock(plan.mutex);
+      if (!plan.free_tmp_mems.empty()) {
+        tmp_mems = std::move(plan.free_tmp_mems.back());
+        plan.free_tmp_mems.pop_back();
+      }
+    }
+    if (tmp_mems.empty()) tmp_mems = plan.tensor_registry.MakeTmpMems();
+
     auto arg_data_provider = makeIODataProvider(args);
-    auto mem_solver = tensor_registry_.MakeSolver(arg_data_provider);
+    auto mem_solver = plan.tensor_registry.MakeSolver(arg_data_provider, tmp_mems);
     // Execute primitives one by one
-    for (const auto& act : net_) {
+    for (const auto& act : plan.net) {
       auto prim = std::get<0>(act);
       auto arg_reqs = std::get<1>(act);
 
@@ -96,6 +152,9 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
       prim.execute(stream_, mem_args);
     }
+
+    std::lock_guard<std::mutex> lock(plan.mutex);
+    plan.free_tmp_mems.push_back(std::move(tmp_mems));
   }
 
   /* Override GetFunction to reimplement Run method */
@@ -107,7 +166,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         ICHECK_EQ(args.size(), input_var_eid_.size() + outputs_.size())
             << "Found mismatch in the number of provided data entries and required.";
 
-        Run(args);
+        Run(*GetOrBuildPlan(args), args);
       });
     } else {
       return JSONRuntimeBase::GetFunction(name, sptr_to_self);
@@ -116,16 +175,9 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   /* Same as makeInitDataProvider but in case of InputOutput return real DLTensor */
   TensorRegistry::DLTensorProvider makeIODataProvider(const TVMArgs& args) const {
-    auto extract_dl_tensor = [](const TVMArgValue& val) -> const DLTensor* {
-      ICHECK(val.type_code() == kTVMNDArrayHandle || val.type_code() == kTVMDLTensorHandle)
-          << "Expect NDArray or DLTensor";
-      return val.IsObjectRef<NDArray>() ? val.operator NDArray().operator->()
-                                        : val.operator DLTensor*();
-    };
-
     std::map<uint32_t, const DLTensor*> io_map;  // eid to dl tensor map
     for (size_t i = 0; i < run_arg_eid_.size(); i++) {
-      io_map[run_arg_eid_[i]] = extract_dl_tensor(args[i]);
+      io_map[run_arg_eid_[i]] = ExtractDLTensor(args[i]);
     }
 
     // lambda with captured IO data handlers
@@ -133,6 +185,95 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   }
 
  private:
+  static const DLTensor* ExtractDLTensor(const TVMArgValue& val) {
+    ICHECK(val.type_code() == kTVMNDArrayHandle || val.type_code() == kTVMDLTensorHandle)
+        << "Expect NDArray or DLTensor";
+    return val.IsObjectRef<NDArray>() ? val.operator NDArray().operator->()
+                                      : val.operator DLTensor*();
+  }
+
+  /*!
+   * \brief Get the plan for the input shapes of a run, which is built on the first run of the
+   * shapes and cached with LRU eviction. Only the batch size may differ from the graph.
+   */
+  std::shared_ptr<const ExecutionPlan> GetOrBuildPlan(const TVMArgs& args) {
+    std::vector<int64_t> key;
+    for (size_t i = 0; i < input_shapes_.size(); ++i) {
+      const DLTensor* input = ExtractDLTensor(args[i]);
+      ICHECK_EQ(static_cast<size_t>(input->ndim), input_shapes_[i].size())
+          << "The rank of input " << i << " does not match the graph";
+      key.insert(key.end(), input->shape, input->shape + input->ndim);
+    }
+    if (graph_plan_ != nullptr && key == graph_shape_key_) return graph_plan_;
+
+    std::lock_guard<std::mutex> lock(plan_mutex_);
+    auto it = plan_index_.find(key);
+    if (it != plan_index_.end()) {
+      cached_plans_.splice(cached_plans_.begin(), cached_plans_, it->second);
+      return it->second->second;
+    }
+    int64_t batch_size = input_shapes_.empty() || input_shapes_[0].empty() ? graph_batch_size_
+                                                                            : key[0];
+    ICHECK(key == GetShapeKey(batch_size))
+        << "The DNNL JSON runtime supports only the change of the batch size of the inputs";
+    auto plan = BuildPlan(batch_size);
+    if (max_cached_plans_ > 0) {
+      cached_plans_.emplace_front(key, plan);
+      plan_index_[key] = cached_plans_.begin();
+      if (cached_plans_.size() > static_cast<size_t>(max_cached_plans_)) {
+        plan_index_.erase(cached_plans_.back().first);
+        cached_plans_.pop_back();
+      }
+    }
+    return plan;
+  }
+
+  /*! \brief The number of elements of a shape. */
+  template <typename Iter>
+  static int64_t GetSize(Iter begin, Iter end) {
+    return std::accumulate(begin, end, int64_t(1), std::multiplies<int64_t>());
+  }
+
+  /*! \brief The input shapes of the graph for a batch size, concatenated. */
+  std::vector<int64_t> GetShapeKey(int64_t batch_size) const {
+    std::vector<int64_t> key;
+    for (const auto& shape : input_shapes_) {
+      size_t begin = key.size();
+      key.insert(key.end(), shape.begin(), shape.end());
+      if (!shape.empty() && shape[0] == graph_batch_size_) key[begin] = batch_size;
+    }
+    return key;
+  }
+
+  /*! \brief The shape of an entry for the batch size of the plan being built. */
+  std::vector<int64_t> GetEntryShape(uint32_t nid, uint32_t idx) const {
+    auto shape = nodes_[nid].GetOpShape()[idx];
+    // The constants keep their shapes, and the other entries follow the batch of the inputs.
+    if (!shape.empty() && shape[0] == graph_batch_size_ &&
+        data_entry_[EntryID(nid, idx)] == nullptr) {
+      shape[0] = batch_size_;
+    }
+    return shape;
+  }
+
+  /*! \brief Build the primitives of the subgraph for a batch size. */
+  std::shared_ptr<ExecutionPlan> BuildPlan(int64_t batch_size) {
+    batch_size_ = batch_size;
+    next_unique_eid_offset_ = data_entry_.size();
+    net_.clear();
+    BuildEngine();
+
+    auto plan = std::make_shared<ExecutionPlan>();
+    plan->net = std::move(net_);
+    plan->tensor_registry = std::move(tensor_registry_);
+    for (const auto& e : outputs_) {
+      auto shape = GetEntryShape(e.id_, e.index_);
+      plan->output_sizes.push_back(GetSize(shape.begin(), shape.end()));
+    }
+    net_.clear();
+    return plan;
+  }
+
   const std::map<std::string, dnnl::algorithm> elt_name2algo{
       {"abs", dnnl::algorithm::eltwise_abs},
       {"exp", dnnl::algorithm::eltwise_exp},
@@ -248,9 +389,6 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   // Build up the engine based on the input graph.
   void BuildEngine() {
-    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
-    stream_ = dnnl::stream(engine_);
-
     std::set<uint32_t> io_eid_set(run_arg_eid_.begin(), run_arg_eid_.end());
     tensor_registry_ = TensorRegistry(engine_, io_eid_set);
 
@@ -816,7 +954,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     ICHECK_LT(idx, node.GetInputs().size());
     auto data_entry = node.GetInputs()[idx];
 
-    auto shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
+    auto shape = GetEntryShape(data_entry.id_, data_entry.index_);
     auto dtype = nodes_[data_entry.id_].GetOpDataType()[data_entry.index_];
     auto eid = node_row_ptr_[data_entry.id_] + data_entry.index_;
     auto const_dl_tensor = data_entry_[eid];
@@ -845,7 +983,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     const JSONGraphNode& node = nodes_[nid];
 
     ICHECK_LT(idx, node.GetNumOutput());
-    auto shape = node.GetOpShape()[idx];
+    auto shape = GetEntryShape(nid, idx);
     auto dtype = node.GetOpDataType()[idx];
     auto eid = node_row_ptr_[nid] + static_cast<uint32_t>(idx);
 
@@ -918,10 +1056,27 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   dnnl::engine engine_;
   /* The dnnl stream. */
   dnnl::stream stream_;
-  /* The network layers that are represented in dnnl primitives. */
+  /* The network layers that are represented in dnnl primitives, of the plan being built. */
   TensorRegistry::ActionQue net_;
-  /* Storage for all memory objects */
+  /* Storage for all memory objects, of the plan being built. */
   TensorRegistry tensor_registry_;
+  /* The batch size of the plan being built. */
+  int64_t batch_size_ = -1;
+  /* The batch size of the graph, which is negative if it is dynamic. */
+  int64_t graph_batch_size_ = -1;
+  /* The shapes of the inputs in the graph. */
+  std::vector<std::vector<int64_t>> input_shapes_;
+  /* The plan for the input shapes of the graph, and its key. */
+  std::shared_ptr<const ExecutionPlan> graph_plan_;
+  std::vector<int64_t> graph_shape_key_;
+  /* The plans for the other input shapes, most recently used first, and their index by key. */
+  using PlanEntry = std::pair<std::vector<int64_t>, std::shared_ptr<const ExecutionPlan>>;
+  std::list<PlanEntry> cached_plans_;
+  std::map<std::vector<int64_t>, std::list<PlanEntry>::iterator> plan_index_;
+  /* The capacity of the cache of plans, set by TVM_DNNL_MAX_CACHED_PLANS. */
+  int max_cached_plans_ = 8;
+  /* Guards the cache of plans and the build of a plan. */
+  std::mutex plan_mutex_;
   /* Generator of new unique eid which doesn't match with existing data entry */
   uint32_t next_unique_eid_offset_;
   /* Map of Run arg idx to corresponding eid */
@@ -599,8 +599,39 @@ class TensorRegistry {
    * \return memory solver object to match ArgId to dnnl::memory objects
    */
   MemSolver MakeSolver(const DLTensorProvider& ext_provider) const {
-    return MemSolverImpl(eng_, ext_provider, const_mem_collection_, ext_mem_collection_,
-                         tmp_mem_collection_, tmp_mem_mapping_);
+    return MakeSolver(ext_provider, MakeTmpMems());
+  }
+
+  /*!
+   * \brief Construct memory solver on the intermediate memory objects of a previous run.
+   * \param ext_provider callback to resolve external IO buffers
+   * \param tmp_mems intermediate memory objects created by MakeTmpMems()
+   * \return memory solver object to match ArgId to dnnl::memory objects
+   */
+  MemSolver MakeSolver(const DLTensorProvider& ext_provider,
+                       const std::vector<dnnl::memory>& tmp_mems) const {
+    ICHECK_EQ(tmp_mems.size(), tmp_mem_collection_.size());
+    return MemSolverImpl(eng_, ext_provider, const_mem_collection_, ext_mem_collection_, tmp_mems);
+  }
+
+  /*!
+   * \brief Allocate the intermediate memory objects of all registered TRs. The scratchpads of all
+   * primitives share the single buffer at zero position.
+   * \return intermediate memory objects, which may be reused by the runs one at a time
+   */
+  std::vector<dnnl::memory> MakeTmpMems() const {
+    std::vector<dnnl::memory> tmp_mems(tmp_mem_collection_.size());
+    for (size_t i = 0; i < tmp_mem_collection_.size(); i++) {
+      auto found = tmp_mem_mapping_.find(i);
+
+      if (found != tmp_mem_mapping_.end()) {
+        auto reuse_hdl = tmp_mems[found->second].get_data_handle();
+        tmp_mems[i] = dnnl::memory(tmp_mem_collection_[i], eng_, reuse_hdl);
+      } else {
+        tmp_mems[i] = dnnl::memory(tmp_mem_collection_[i], eng_);
+      }
+    }
+    return tmp_mems;
   }
 
   void MarkInplace(const TensorRequisite& tr, const TensorRequisite& shared) {
@@ -660,26 +691,12 @@ class TensorRegistry {
     MemSolverImpl(const dnnl::engine& eng, const DLTensorProvider& ext_data_provider,
                   const std::vector<dnnl::memory>& const_mems,
                   const std::vector<std::pair<uint32_t, dnnl::memory::desc>>& ext_mems,
-                  const std::vector<dnnl::memory::desc>& tmp_mem_descs,
-                  const std::map<size_t, size_t>& tmp_mem_mapping)
+                  const std::vector<dnnl::memory>& tmp_mems)
         : eng_(eng),
           ext_data_provider_(ext_data_provider),
           const_mems_(const_mems),
-          ext_mems_(ext_mems) {
-      // Construct temp memory objects on the fly. While we have no scratchpads
-      // support on VM/GraphExecutor level.
-      tmp_mems_.resize(tmp_mem_descs.size());
-      for (size_t i = 0; i < tmp_mem_descs.size(); i++) {
-        auto found = tmp_mem_mapping.find(i);
-
-        if (found != tmp_mem_mapping.end()) {
-          auto reuse_hdl = tmp_mems_[found->second].get_data_handle();
-          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng_, reuse_hdl);
-        } else {
-          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng_);
-        }
-      }
-    }
+          ext_mems_(ext_mems),
+          tmp_mems_(tmp_mems) {}
 
     /*! \brief Find memory object associated with provided ArgId */
     dnnl::memory operator()(const ArgId& ar) const {
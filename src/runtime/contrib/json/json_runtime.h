@@ -154,7 +154,18 @@ class JSONRuntimeBase : public ModuleNode {
    *
    * \param args The packed args.
    */
-  void SetInputOutputBuffers(const TVMArgs& args) {
+  void SetInputOutputBuffers(const TVMArgs& args) { BindInputOutputBuffers(args, &data_entry_); }
+
+  /*!
+   * \brief Bind the DLTensor pointers of the input and output buffers to the corresponding entries
+   * of a table of data entries. The runtimes which run concurrent calls bind each call to its own
+   * table, since the data entries of the module are shared by the calls.
+   *
+   * \param args The packed args.
+   * \param data_entry The table of data entries.
+   */
+  void BindInputOutputBuffers(const TVMArgs& args,
+                              std::vector<const DLTensor*>* data_entry) const {
     ICHECK_EQ(args.size(), input_var_eid_.size() + outputs_.size())
         << "Found mismatch in the number of provided data entryies and required.";
 
@@ -174,7 +185,7 @@ class JSONRuntimeBase : public ModuleNode {
 
       // Assign input/output the NDArray pointers to data entry so that we can directly
       // read/write host buffers.
-      data_entry_[eid] = arg;
+      (*data_entry)[eid] = arg;
     }
   }
 
@@ -27,6 +27,7 @@
 #include <tvm/runtime/registry.h>
 
 #include <fstream>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -81,6 +82,32 @@ class MSCTensorRTRuntime : public JSONRuntimeBase {
     return ModulePropertyMask::kBinarySerializable | ModulePropertyMask::kRunnable;
   }
 
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) override {
+    if (name == "msc_set_profiling") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->SetProfiling(args[0]); });
+    } else if (name == "msc_get_layer_latencies") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetLayerLatencies(); });
+    }
+    return JSONRuntimeBase::GetFunction(name, sptr_to_self);
+  }
+
+  /*!
+   * \brief Get the latencies of the layers since the profiling is set.
+   *
+   * \return The total latency of each layer in ms, as a float64 array of one element.
+   */
+  Map<String, NDArray> GetLayerLatencies() {
+    Map<String, NDArray> latencies;
+    for (const auto& pair : layer_latencies_) {
+      NDArray latency = NDArray::Empty({1}, DataType::Float(64), {kDLCPU, 0});
+      static_cast<double*>(latency->data)[0] = pair.second;
+      latencies.Set(pair.first, latency);
+    }
+    return latencies;
+  }
+
   /*!
    * \brief Initialize runtime.
    *
@@ -132,8 +159,14 @@ class MSCTensorRTRuntime : public JSONRuntimeBase {
     }
     auto tvm_stream = CUDAThreadEntry::ThreadLocal()->stream;
 #if TRT_VERSION_GE(6, 0, 1)
-    ICHECK(context_->enqueueV2(bindings_.data(), tvm_stream, nullptr))
-        << "Running TensorRT failed.";
+    if (profiling_) {
+      // The layers are reported to the profiler by the synchronous execution.
+      CUDA_CALL(cudaStreamSynchronize(tvm_stream));
+      ICHECK(context_->executeV2(bindings_.data())) << "Running TensorRT failed.";
+    } else {
+      ICHECK(context_->enqueueV2(bindings_.data(), tvm_stream, nullptr))
+          << "Running TensorRT failed.";
+    }
 #else
     LOG_FATAL << "Only support tensorrt with version >=6.0.0";
 #endif
@@ -166,6 +199,17 @@ class MSCTensorRTRuntime : public JSONRuntimeBase {
     }
   }
 
+  /*!
+   * \brief Set whether to profile the latency of each layer, which clears the latencies.
+   *
+   * \param profiling Whether to profile.
+   */
+  void SetProfiling(bool profiling) {
+    layer_latencies_.clear();
+    profiling_ = profiling;
+    context_->setProfiler(profiling ? &profiler_ : nullptr);
+  }
+
   bool LoadEngine(const String& engine_file) {
     IRuntime* runtime = createInferRuntime(logger_);
     // build engine
@@ -320,6 +364,11 @@ class MSCTensorRTRuntime : public JSONRuntimeBase {
                << "Please build with USE_TENSORRT_RUNTIME.";
   }
 
+  void SetProfiling(bool profiling) {
+    LOG(FATAL) << "TensorRT runtime is not enabled. "
+               << "Please build with USE_TENSORRT_RUNTIME.";
+  }
+
   bool LoadEngine(const String& engine_file) { return false; }
 
   void DestroyEngine() {}
@@ -330,8 +379,24 @@ class MSCTensorRTRuntime : public JSONRuntimeBase {
   String tool_tag_;
   String graph_name_;
   std::unordered_map<std::string, std::pair<size_t, size_t>> tensor_ids_;
+  std::map<std::string, double> layer_latencies_;
+  bool profiling_{false};
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+  /*! \brief The profiler accumulating the latency of each layer. */
+  class LayerProfiler : public IProfiler {
+   public:
+    explicit LayerProfiler(std::map<std::string, double>* latencies) : latencies_(latencies) {}
+
+    void reportLayerTime(const char* layer_name, float ms) noexcept override {
+      (*latencies_)[layer_name] += ms;
+    }
+
+   private:
+    std::map<std::string, double>* latencies_;
+  };
+
   TensorRTLogger logger_;
+  LayerProfiler profiler_{&layer_latencies_};
   ICudaEngine* engine_{nullptr};
   IExecutionContext* context_{nullptr};
   std::unordered_map<int, uint32_t> input_bindings_;
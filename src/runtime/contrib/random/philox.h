@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file random/philox.h
+ * \brief The Philox-4x32-10 counter-based random number generator.
+ *
+ * Philox maps a counter and a key to a block of four random 32-bit integers, so the numbers of
+ * a stream are generated in any order and in parallel, and do not depend on the number of
+ * threads. The i-th number of the stream of a seed is lane i % 4 of the block of the counter
+ * `offset + i / 4` under the key `seed`. tvm.contrib.random.philox_uniform implements the same
+ * mapping in TIR, which runs on the GPUs.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+#define TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+
+#include <cmath>
+#include <cstdint>
+
+namespace tvm {
+namespace contrib {
+
+/*! \brief The number of counters generated together, which the compilers vectorize. */
+constexpr int kPhiloxBatch = 8;
+
+/*!
+ * \brief Generate the blocks of kPhiloxBatch consecutive counters.
+ * \param counter The first counter.
+ * \param key The key, which is the seed of the stream.
+ * \param out The blocks, lane-major: out[lane][j] is lane `lane` of the block of counter + j.
+ */
+inline void Philox4x32Batch(uint64_t counter, uint64_t key, uint32_t out[4][kPhiloxBatch]) {
+  const uint32_t kM0 = 0xD2511F53, kM1 = 0xCD9E8D57;
+  const uint32_t kW0 = 0x9E3779B9, kW1 = 0xBB67AE85;
+  uint32_t* c0 = out[0];
+  uint32_t* c1 = out[1];
+  uint32_t* c2 = out[2];
+  uint32_t* c3 = out[3];
+  for (int j = 0; j < kPhiloxBatch; ++j) {
+    uint64_t c = counter + j;
+    c0[j] = static_cast<uint32_t>(c);
+    c1[j] = static_cast<uint32_t>(c >> 32);
+    c2[j] = 0;
+    c3[j] = 0;
+  }
+  uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+  for (int round = 0; round < 10; ++round) {
+    for (int j = 0; j < kPhiloxBatch; ++j) {
+      uint64_t p0 = static_cast<uint64_t>(kM0) * c0[j];
+      uint64_t p1 = static_cast<uint64_t>(kM1) * c2[j];
+      uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[j] ^ k0;
+      uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[j] ^ k1;
+      c1[j] = static_cast<uint32_t>(p1);
+      c3[j] = static_cast<uint32_t>(p0);
+      c0[j] = n0;
+      c2[j] = n2;
+    }
+    k0 += kW0;
+    k1 += kW1;
+  }
+}
+
+/*! \brief Convert random bits to a float32 in [0, 1) with 24 random bits. */
+inline float PhiloxToUniform(uint32_t bits) {
+  return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+/*!
+ * \brief Generate the numbers of a stream in [begin, end).
+ * \param seed The seed of the stream.
+ * \param offset The counter of the first block of the stream.
+ * \param begin The index of the first number, which is a multiple of 4.
+ * \param end The index past the last number.
+ * \param fblock The callback taking the index of each block's first number and the block.
+ */
+template <typename FBlock>
+inline void PhiloxGenerate(uint64_t seed, uint64_t offset, int64_t begin, int64_t end,
+                           FBlock fblock) {
+  uint32_t blocks[4][kPhiloxBatch];
+  for (int64_t i = begin; i < end; i += 4 * kPhiloxBatch) {
+    Philox4x32Batch(offset + i / 4, seed, blocks);
+    for (int j = 0; j < kPhiloxBatch && i + j * 4 < end; ++j) {
+      uint32_t block[4] = {blocks[0][j], blocks[1][j], blocks[2][j], blocks[3][j]};
+      fblock(i + j * 4, block);
+    }
+  }
+}
+
+/*! \brief The first uniform number in [0, 1) of the stream of a seed. */
+inline float PhiloxUniform(uint64_t seed, uint64_t offset = 0) {
+  float result = 0.0f;
+  PhiloxGenerate(seed, offset, 0, 1,
+                 [&](int64_t, const uint32_t block[4]) { result = PhiloxToUniform(block[0]); });
+  return result;
+}
+
+/*!
+ * \brief Convert two lanes of a block to two standard normal numbers, by Box-Muller.
+ * \param bits0 The lane of the radius.
+ * \param bits1 The lane of the angle.
+ * \param out The two numbers.
+ */
+inline void PhiloxToNormal(uint32_t bits0, uint32_t bits1, float out[2]) {
+  // The radius lane is in (0, 1], so that its logarithm is finite.
+  float u0 = static_cast<float>((bits0 >> 8) + 1) * (1.0f / 16777216.0f);
+  float u1 = PhiloxToUniform(bits1);
+  float radius = std::sqrt(-2.0f * std::log(u0));
+  float theta = 6.2831853071795864f * u1;
+  out[0] = radius * std::cos(theta);
+  out[1] = radius * std::sin(theta);
+}
+
+}  // namespace contrib
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
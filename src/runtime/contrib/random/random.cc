@@ -27,8 +27,10 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <vector>
 
 #include "mt_random_engine.cc"
+#include "philox.h"
 
 #define DLPACK_INTEGER_TYPE_SWITCH(type, DType, ...)    \
   if (type.code == kDLInt && type.bits == 32) {         \
@@ -118,6 +120,83 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.normal").set_body([](TVMArgs args, TVMRe
   entry->random_engine.SampleNormal(out, loc, scale);
 });
 
+/*!
+ * \brief Fill a float32 tensor with the numbers of a Philox stream, in parallel.
+ * \param out The tensor. The tensors of other devices are filled through a host copy.
+ * \param seed The seed of the stream.
+ * \param offset The counter of the first block of the stream.
+ * \param fblock The callback converting a block to the four numbers at its index.
+ */
+template <typename FBlock>
+void PhiloxFill(DLTensor* out, uint64_t seed, uint64_t offset, FBlock fblock) {
+  ICHECK(out->strides == nullptr);
+  ICHECK(out->dtype.code == kDLFloat && out->dtype.bits == 32 && out->dtype.lanes == 1);
+  if (out->device.device_type != kDLCPU) {
+    NDArray local = NDArray::Empty(std::vector<int64_t>{out->shape, out->shape + out->ndim},
+                                   out->dtype, {kDLCPU, 0});
+    PhiloxFill(const_cast<DLTensor*>(local.operator->()), seed, offset, fblock);
+    NDArray::CopyFromTo(local.operator->(), out);
+    return;
+  }
+  int64_t size = 1;
+  for (int i = 0; i < out->ndim; ++i) {
+    size *= out->shape[i];
+  }
+  if (size == 0) return;
+  float* data = static_cast<float*>(out->data);
+  // Each task generates a chunk of whole blocks, so the result does not depend on the threads.
+  constexpr int64_t kChunkSize = 4 * kPhiloxBatch * 256;
+  parallel_for_with_threading_backend(
+      [&](int64_t chunk) {
+        int64_t begin = chunk * kChunkSize;
+        int64_t end = std::min(begin + kChunkSize, size);
+        PhiloxGenerate(seed, offset, begin, end, [&](int64_t i, const uint32_t block[4]) {
+          float values[4];
+          fblock(block, values);
+          for (int lane = 0; lane < 4 && i + lane < end; ++lane) {
+            data[i + lane] = values[lane];
+          }
+        });
+      },
+      0, (size + kChunkSize - 1) / kChunkSize);
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_uniform")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      int64_t seed = args[0];
+      int64_t offset = args[1];
+      double low = args[2];
+      double high = args[3];
+      DLTensor* out = args[4];
+      ICHECK_GT(high, low) << "high must be bigger than low";
+      float flow = static_cast<float>(low);
+      float scale = static_cast<float>(high - low);
+      PhiloxFill(out, seed, offset, [&](const uint32_t block[4], float values[4]) {
+        for (int lane = 0; lane < 4; ++lane) {
+          values[lane] = flow + PhiloxToUniform(block[lane]) * scale;
+        }
+      });
+    });
+
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_normal")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      int64_t seed = args[0];
+      int64_t offset = args[1];
+      double loc = args[2];
+      double scale = args[3];
+      DLTensor* out = args[4];
+      ICHECK_GT(scale, 0) << "standard deviation must be positive";
+      float floc = static_cast<float>(loc);
+      float fscale = static_cast<float>(scale);
+      PhiloxFill(out, seed, offset, [&](const uint32_t block[4], float values[4]) {
+        PhiloxToNormal(block[0], block[1], values);
+        PhiloxToNormal(block[2], block[3], values + 2);
+        for (int lane = 0; lane < 4; ++lane) {
+          values[lane] = floc + values[lane] * fscale;
+        }
+      });
+    });
+
 TVM_REGISTER_GLOBAL("tvm.contrib.random.random_fill").set_body([](TVMArgs args, TVMRetValue* ret) {
   RandomThreadLocalEntry* entry = RandomThreadLocalEntry::ThreadLocal();
   DLTensor* out = args[0];
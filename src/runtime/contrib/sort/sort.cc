@@ -23,6 +23,7 @@
 
 #include <dlpack/dlpack.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
 #include <vector>
@@ -558,5 +559,93 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.topk").set_body([](TVMArgs args, TVMRetVal
   }
 });
 
+// Top-k over the last axis for many short rows, e.g. MoE gating and sampling.
+// Every row is a segment of length n, k is taken from the last dimension of the outputs.
+// Rows are distributed over the runtime thread pool and each row only runs a partial
+// selection (nth_element) followed by a sort of the k selected elements, instead of
+// maintaining a heap over the whole row. Ties are broken by the smaller index, so the
+// result matches tvm.contrib.sort.topk.
+template <typename DataType, typename IndicesType>
+void segmented_topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices,
+                    bool is_ascend) {
+  const DataType* data_ptr = static_cast<const DataType*>(input->data);
+  DataType* values_ptr = static_cast<DataType*>(out_values->data);
+  IndicesType* indices_ptr = static_cast<IndicesType*>(out_indices->data);
+
+  const int64_t n = input->shape[input->ndim - 1];
+  const int64_t k = out_values->shape[out_values->ndim - 1];
+  ICHECK_GE(k, 1) << "segmented_topk requires k >= 1";
+  ICHECK_LE(k, n) << "segmented_topk requires k <= " << n << ", but got k = " << k;
+  int64_t num_rows = 1;
+  for (int i = 0; i < input->ndim - 1; ++i) {
+    num_rows *= input->shape[i];
+  }
+
+  using Entry = std::pair<int64_t, DataType>;
+  bool (*compare)(const Entry&, const Entry&) =
+      is_ascend ? CompareAscend<DataType, true> : CompareDescend<DataType, true>;
+
+  parallel_for_with_threading_backend(
+      [&](int64_t row) {
+        thread_local std::vector<Entry> selector;
+        selector.clear();
+        selector.reserve(n);
+        const DataType* row_ptr = data_ptr + row * n;
+        for (int64_t i = 0; i < n; ++i) {
+          selector.emplace_back(i, row_ptr[i]);
+        }
+        if (k < n) {
+          std::nth_element(selector.begin(), selector.begin() + k, selector.end(), compare);
+        }
+        std::sort(selector.begin(), selector.begin() + k, compare);
+        for (int64_t i = 0; i < k; ++i) {
+          values_ptr[row * k + i] = selector[i].second;
+          indices_ptr[row * k + i] = static_cast<IndicesType>(selector[i].first);
+        }
+      },
+      0, num_rows);
+}
+
+template <typename DataType>
+void segmented_topk_dispatch_indices(DLTensor* input, DLTensor* values_out, DLTensor* indices_out,
+                                     bool is_ascend) {
+  auto out_dtype = DLDataType2String(indices_out->dtype);
+  if (out_dtype == "int32") {
+    segmented_topk<DataType, int32_t>(input, values_out, indices_out, is_ascend);
+  } else if (out_dtype == "int64") {
+    segmented_topk<DataType, int64_t>(input, values_out, indices_out, is_ascend);
+  } else {
+    LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
+  }
+}
+
+// Segmented top-k along the last axis.
+// Arguments: input (..., n), values_out (..., k), indices_out (..., k), is_ascend.
+TVM_REGISTER_GLOBAL("tvm.contrib.sort.segmented_topk")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      ICHECK_EQ(args.num_args, 4);
+      DLTensor* input = args[0];
+      DLTensor* values_out = args[1];
+      DLTensor* indices_out = args[2];
+      bool is_ascend = args[3];
+      ICHECK_EQ(input->ndim, values_out->ndim);
+      ICHECK_EQ(input->ndim, indices_out->ndim);
+
+      auto data_dtype = DLDataType2String(input->dtype);
+      if (data_dtype == "float32") {
+        segmented_topk_dispatch_indices<float>(input, values_out, indices_out, is_ascend);
+      } else if (data_dtype == "float64") {
+        segmented_topk_dispatch_indices<double>(input, values_out, indices_out, is_ascend);
+      } else if (data_dtype == "float16") {
+        segmented_topk_dispatch_indices<float16>(input, values_out, indices_out, is_ascend);
+      } else if (data_dtype == "int32") {
+        segmented_topk_dispatch_indices<int32_t>(input, values_out, indices_out, is_ascend);
+      } else if (data_dtype == "int64") {
+        segmented_topk_dispatch_indices<int64_t>(input, values_out, indices_out, is_ascend);
+      } else {
+        LOG(FATAL) << "Unsupported input dtype: " << data_dtype;
+      }
+    });
+
 }  // namespace contrib
 }  // namespace tvm
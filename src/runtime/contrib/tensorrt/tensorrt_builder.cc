@@ -26,6 +26,7 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -40,13 +41,15 @@ namespace contrib {
 TensorRTBuilder::TensorRTBuilder(TensorRTLogger* logger,
                                  const std::vector<const DLTensor*>& data_entry,
                                  size_t max_workspace_size, bool use_implicit_batch, bool use_fp16,
-                                 int batch_size, nvinfer1::IInt8Calibrator* calibrator)
+                                 int batch_size, int max_batch_size,
+                                 nvinfer1::IInt8Calibrator* calibrator)
     : data_entry_(data_entry),
       max_workspace_size_(max_workspace_size),
       use_implicit_batch_(use_implicit_batch),
       use_fp16_(use_fp16),
       use_int8_(false),
       batch_size_(batch_size),
+      max_batch_size_(max_batch_size),
       calibrator_(calibrator) {
   // Create TRT builder and network.
   builder_ = nvinfer1::createInferBuilder(*logger);
@@ -57,14 +60,14 @@ TensorRTBuilder::TensorRTBuilder(TensorRTLogger* logger,
       1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
   if (use_implicit_batch_) {
     flags = 0U;
-    builder_->setMaxBatchSize(batch_size_);
+    builder_->setMaxBatchSize(max_batch_size_);
   }
   if (calibrator_ != nullptr) {
     use_int8_ = true;
   }
   network_ = builder_->createNetworkV2(flags);
 #else
-  builder_->setMaxBatchSize(batch_size_);
+  builder_->setMaxBatchSize(max_batch_size_);
   builder_->setMaxWorkspaceSize(max_workspace_size_);
   builder_->setFp16Mode(use_fp16_);
   network_ = builder_->createNetwork();
@@ -193,10 +196,14 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
       auto dims = VectorToTrtDims(shape);
 
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, dims);
+      // Cover the batch sizes from 1 to the max batch size when dynamic batching is used.
+      const bool dynamic_batch = network_->getInput(i)->getDimensions().nbDims >= 1 &&
+                                 network_->getInput(i)->getDimensions().d[0] == -1;
+      if (dynamic_batch) {
+        dims.d[0] = std::max(max_batch_size_, batch_size_);
+      }
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX, dims);
-      // Set minimum batch size to 1 when dynamic batching is used.
-      if (network_->getInput(i)->getDimensions().nbDims >= 1 &&
-          network_->getInput(i)->getDimensions().d[0] == -1) {
+      if (dynamic_batch) {
         dims.d[0] = 1;
       }
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN, dims);
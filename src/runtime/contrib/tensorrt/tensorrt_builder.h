@@ -69,11 +69,13 @@ class TensorRTBuilder {
    * \param max_workspace_size Workspace size parameter for TensorRT engine build phase.
    * \param use_implicit_batch Whether to use implicit batch mode (default)
    * \param use_fp16 Whether to automatically convert a model to fp16
-   * \param batch_size If use_implicit_batch,
+   * \param batch_size The batch size to optimize for.
+   * \param max_batch_size The largest batch size the engine supports, from which the engine covers
+   * all batch sizes down to 1.
    */
   TensorRTBuilder(TensorRTLogger* logger, const std::vector<const DLTensor*>& data_entry,
                   size_t max_workspace_size, bool use_implicit_batch, bool use_fp16, int batch_size,
-                  nvinfer1::IInt8Calibrator* calibrator = nullptr);
+                  int max_batch_size, nvinfer1::IInt8Calibrator* calibrator = nullptr);
 
   /*!
    * \brief Add TensorRT input(s) for input node in network definition.
@@ -159,6 +161,9 @@ class TensorRTBuilder {
   /*! \brief Batch size to optimize for. */
   int batch_size_;
 
+  /*! \brief Largest batch size of the engine. */
+  int max_batch_size_;
+
   /*! \brief Input names. */
   std::vector<std::string> network_input_names_;
 
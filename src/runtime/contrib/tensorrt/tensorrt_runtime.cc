@@ -23,20 +23,30 @@
  */
 
 #include <dmlc/parameter.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "../../../support/utils.h"
 #include "../../file_utils.h"
 #include "../json/json_node.h"
 #include "../json/json_runtime.h"
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+#include "../../cuda/cuda_common.h"
 #include "NvInfer.h"
 #include "tensorrt_builder.h"
 #include "tensorrt_calibrator.h"
@@ -72,10 +82,14 @@ class TensorRTRuntime : public JSONRuntimeBase {
         use_implicit_batch_(true),
         max_workspace_size_(size_t(1) << 30),
         max_batch_size_(-1),
+        min_max_batch_size_(0),
         multi_engine_mode_(false),
-        use_fp16_(false) {
+        use_fp16_(false),
+        max_contexts_(4) {
     const bool use_int8 = dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
     multi_engine_mode_ = dmlc::GetEnv("TVM_TENSORRT_MULTI_ENGINE", false);
+    min_max_batch_size_ = dmlc::GetEnv("TVM_TENSORRT_MAX_BATCH_SIZE", 0);
+    max_contexts_ = dmlc::GetEnv("TVM_TENSORRT_MAX_CONTEXTS", max_contexts_);
     num_calibration_batches_remaining_ = dmlc::GetEnv("TENSORRT_NUM_CALI_INT8", 0);
     if (use_int8) {
       ICHECK(num_calibration_batches_remaining_ != 0)
@@ -142,6 +156,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
   /*! \brief Destroy engines and contexts. */
   void DestroyEngines() {
+    DestroyExecutionSlots();
     for (auto& it : trt_engine_cache_) {
       VLOG(1) << "Destroying TensorRT context for function '" << it.first.first << "' (batch size "
               << it.first.second << ")";
@@ -159,13 +174,158 @@ class TensorRTRuntime : public JSONRuntimeBase {
     VLOG(1) << "Destroyed TensorRT runtime";
   }
 
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) override {
+    // Each call binds its arguments to its own data entries and leases its own execution context,
+    // so that the calls from different threads run concurrently on the same engine.
+    if (this->symbol_name_ == name) {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK(this->initialized_) << "The module has not been initialized";
+        std::vector<const DLTensor*> data_entry = this->data_entry_;
+        this->BindInputOutputBuffers(args, &data_entry);
+        this->Run(data_entry);
+      });
+    } else {
+      return JSONRuntimeBase::GetFunction(name, sptr_to_self);
+    }
+  }
+
   /*! \brief Run inference using built engine. */
-  void Run() override {
-    auto& engine_and_context = GetOrBuildEngine();
-    int batch_size = GetBatchSize();
+  void Run() override { Run(data_entry_); }
+
+  /*!
+   * \brief Run inference on the given data entries. The calls share the engine under a shared
+   * lock, and take the lock exclusively only to build an engine or to calibrate.
+   */
+  void Run(const std::vector<const DLTensor*>& data_entry) {
+    int batch_size = GetBatchSize(data_entry);
     if (batch_size == 0) return;
+    while (true) {
+      {
+        std::shared_lock<std::shared_mutex> lock(engine_mutex_);
+        int engine_batch_size = -1;
+        if (calibrator_ == nullptr && FindCompatibleEngine(batch_size, &engine_batch_size)) {
+          RunOnEngine(engine_batch_size, data_entry);
+          return;
+        }
+      }
+      std::unique_lock<std::shared_mutex> lock(engine_mutex_);
+      int engine_batch_size = -1;
+      GetOrBuildEngine(data_entry, &engine_batch_size);
+      if (calibrator_ != nullptr) {
+        // The calls which collect the data for the int8 calibration run one at a time.
+        RunOnEngine(engine_batch_size, data_entry);
+        return;
+      }
+    }
+  }
+
+ private:
+  /*!
+   * \brief An execution context of an engine with its own stream and device buffers, which a call
+   * leases to run concurrently with the other calls on the engine.
+   */
+  struct ExecutionSlot {
+    nvinfer1::IExecutionContext* context = nullptr;
+    /*! \brief Whether the context is owned by the slot, or is the one created with the engine. */
+    bool owns_context = false;
+    cudaStream_t stream = nullptr;
+    /*! \brief Map of binding index to GPU buffers for inputs and outputs. Only used when target
+     * device is not "cuda". Since TensorRT execution can only read data from GPU, we need to copy
+     * data from the runtime device to these buffers first. These will be allocated for the highest
+     * batch size run with the slot. */
+    std::unordered_map<int, NDArray> device_buffers;
+  };
+
+  /*! \brief The execution slots of an engine, and the ones of them which are not leased. */
+  struct ExecutionSlotPool {
+    std::vector<std::unique_ptr<ExecutionSlot>> slots;
+    std::vector<ExecutionSlot*> free_slots;
+  };
+
+  /*! \brief Lease an execution slot of an engine, and run inference with it. */
+  void RunOnEngine(int engine_batch_size, const std::vector<const DLTensor*>& data_entry) {
+    auto key = std::make_pair(symbol_name_, engine_batch_size);
+    const TensorRTEngineAndContext& engine_and_context = trt_engine_cache_.at(key);
+    ExecutionSlot* slot = LeaseExecutionSlot(key, engine_and_context);
+    try {
+      RunWithExecutionSlot(engine_and_context, slot, data_entry);
+    } catch (...) {
+      ReturnExecutionSlot(key, slot);
+      throw;
+    }
+    ReturnExecutionSlot(key, slot);
+  }
+
+  /*!
+   * \brief Lease an execution slot of an engine. The first slot shares the context created with
+   * the engine, and the others are created on demand up to TVM_TENSORRT_MAX_CONTEXTS, beyond which
+   * the call waits for a slot to be returned.
+   */
+  ExecutionSlot* LeaseExecutionSlot(const std::pair<std::string, int>& key,
+                                    const TensorRTEngineAndContext& engine_and_context) {
+    std::unique_lock<std::mutex> lock(slot_mutex_);
+    ExecutionSlotPool& pool = slot_pools_[key];
+    size_t max_contexts = std::max(max_contexts_, 1);
+#if !TRT_VERSION_GE(8, 0, 1)
+    // Before TensorRT 8, the contexts of an engine with dynamic shapes need an optimization profile
+    // each, while the engines are built with one.
+    if (!use_implicit_batch_) max_contexts = 1;
+#endif
+    slot_cv_.wait(lock,
+                  [&] { return !pool.free_slots.empty() || pool.slots.size() < max_contexts; });
+    if (pool.free_slots.empty()) {
+      auto slot = std::make_unique<ExecutionSlot>();
+      if (pool.slots.empty()) {
+        slot->context = engine_and_context.context;
+      } else {
+        slot->context = engine_and_context.engine->createExecutionContext();
+        ICHECK(slot->context) << "Failed to create a TensorRT execution context";
+        slot->owns_context = true;
+      }
+      CUDA_CALL(cudaStreamCreateWithFlags(&slot->stream, cudaStreamNonBlocking));
+      pool.free_slots.push_back(slot.get());
+      pool.slots.push_back(std::move(slot));
+    }
+    ExecutionSlot* slot = pool.free_slots.back();
+    pool.free_slots.pop_back();
+    return slot;
+  }
+
+  /*! \brief Return a leased execution slot to the pool of its engine. */
+  void ReturnExecutionSlot(const std::pair<std::string, int>& key, ExecutionSlot* slot) {
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex_);
+      slot_pools_.at(key).free_slots.push_back(slot);
+    }
+    slot_cv_.notify_all();
+  }
+
+  /*! \brief Destroy the execution slots of all engines, none of which may be leased. */
+  void DestroyExecutionSlots() {
+    std::lock_guard<std::mutex> lock(slot_mutex_);
+    for (auto& it : slot_pools_) {
+      ICHECK_EQ(it.second.free_slots.size(), it.second.slots.size())
+          << "The TensorRT engine is destroyed while running";
+      for (const auto& slot : it.second.slots) {
+        if (slot->owns_context) slot->context->destroy();
+        CUDA_CALL(cudaStreamDestroy(slot->stream));
+      }
+    }
+    slot_pools_.clear();
+  }
+
+  /*! \brief Run inference with an execution slot of an engine. */
+  void RunWithExecutionSlot(const TensorRTEngineAndContext& engine_and_context,
+                            ExecutionSlot* slot, const std::vector<const DLTensor*>& data_entry) {
+    int batch_size = GetBatchSize(data_entry);
     auto engine = engine_and_context.engine;
-    auto context = engine_and_context.context;
+    auto context = slot->context;
+    // The inputs may be produced on the current stream of TVM.
+    int device_id;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    Device device{kDLCUDA, device_id};
+    DeviceAPI* device_api = DeviceAPI::Get(device);
+    device_api->SyncStreamFromTo(device, device_api->GetCurrentStream(device), slot->stream);
     const int num_bindings = engine->getNbBindings();
     std::vector<void*> bindings(num_bindings, nullptr);
     std::vector<size_t> binding_sizes(num_bindings, 0);
@@ -180,17 +340,18 @@ class TensorRTRuntime : public JSONRuntimeBase {
           ICHECK_NE(binding_index, -1);
 #if TRT_VERSION_GE(6, 0, 1)
           if (!use_implicit_batch_) {
-            std::vector<int64_t> shape(data_entry_[eid]->shape,
-                                       data_entry_[eid]->shape + data_entry_[eid]->ndim);
+            std::vector<int64_t> shape(data_entry[eid]->shape,
+                                       data_entry[eid]->shape + data_entry[eid]->ndim);
             auto dims = VectorToTrtDims(shape);
             ICHECK(context->setBindingDimensions(binding_index, dims));
           }
 #endif
-          if (data_entry_[eid]->device.device_type == kDLCUDA) {
-            bindings[binding_index] = data_entry_[eid]->data;
+          if (data_entry[eid]->device.device_type == kDLCUDA) {
+            bindings[binding_index] = data_entry[eid]->data;
           } else {
-            auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
-            device_buffer.CopyFrom(data_entry_[eid]);
+            auto device_buffer = GetOrAllocateDeviceBuffer(slot, data_entry, eid, binding_index);
+            NDArray::CopyFromTo(data_entry[eid], const_cast<DLTensor*>(device_buffer.operator->()),
+                                slot->stream);
             bindings[binding_index] = device_buffer->data;
           }
 
@@ -207,6 +368,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
       if (calibrator_ != nullptr) {
         LOG(INFO) << "Starting adding last " << num_calibration_batches_remaining_
                   << "-th batch data to the calibrator";
+        CUDA_CALL(cudaStreamSynchronize(slot->stream));
         calibrator_->AddBatchData(bindings, binding_sizes);
         num_calibration_batches_remaining_--;
       }
@@ -219,22 +381,25 @@ class TensorRTRuntime : public JSONRuntimeBase {
       const std::string& name = engine_and_context.outputs[i];
       int binding_index = engine->getBindingIndex(name.c_str());
       ICHECK_NE(binding_index, -1);
-      if (data_entry_[eid]->device.device_type == kDLCUDA) {
-        bindings[binding_index] = data_entry_[eid]->data;
+      if (data_entry[eid]->device.device_type == kDLCUDA) {
+        bindings[binding_index] = data_entry[eid]->data;
       } else {
-        auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
+        auto device_buffer = GetOrAllocateDeviceBuffer(slot, data_entry, eid, binding_index);
         bindings[binding_index] = device_buffer->data;
       }
     }
 
 #if TRT_VERSION_GE(6, 0, 1)
     if (use_implicit_batch_) {
-      ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueue(batch_size, bindings.data(), slot->stream, nullptr))
+          << "Running TensorRT failed.";
     } else {
-      ICHECK(context->executeV2(bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueueV2(bindings.data(), slot->stream, nullptr))
+          << "Running TensorRT failed.";
     }
 #else
-    ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+    ICHECK(context->enqueue(batch_size, bindings.data(), slot->stream, nullptr))
+        << "Running TensorRT failed.";
 #endif
 
     // Copy outputs from GPU buffers if needed.
@@ -243,17 +408,19 @@ class TensorRTRuntime : public JSONRuntimeBase {
       const std::string& name = engine_and_context.outputs[i];
       int binding_index = engine->getBindingIndex(name.c_str());
       ICHECK_NE(binding_index, -1);
-      if (data_entry_[eid]->device.device_type != kDLCUDA) {
-        auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
-        device_buffer.CopyTo(const_cast<DLTensor*>(data_entry_[eid]));
+      if (data_entry[eid]->device.device_type != kDLCUDA) {
+        auto device_buffer = GetOrAllocateDeviceBuffer(slot, data_entry, eid, binding_index);
+        NDArray::CopyFromTo(device_buffer.operator->(), const_cast<DLTensor*>(data_entry[eid]),
+                            slot->stream);
       }
     }
+    // The outputs are ready once the call returns, as with the synchronous execution.
+    CUDA_CALL(cudaStreamSynchronize(slot->stream));
   }
 
- private:
   /*! \brief Get batch size for engine from the runtime input shapes. */
-  int GetBatchSize() {
-    return data_entry_[input_var_eid_[0]]->ndim == 0 ? 1 : data_entry_[input_var_eid_[0]]->shape[0];
+  int GetBatchSize(const std::vector<const DLTensor*>& data_entry) {
+    return data_entry[input_var_eid_[0]]->ndim == 0 ? 1 : data_entry[input_var_eid_[0]]->shape[0];
   }
 
   /*! \brief Find an engine in the cache which we can reuse depending on the mode. If no compatible
@@ -278,9 +445,12 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*!
    * \brief Build TensorRT engine from JSON representation and cache it. If compatible engine is
    * already built, do nothing.
+   * \param data_entry The data entries of the call.
+   * \param engine_batch_size The batch size the engine is cached under.
    */
-  TensorRTEngineAndContext& GetOrBuildEngine() {
-    int batch_size = GetBatchSize();
+  TensorRTEngineAndContext& GetOrBuildEngine(const std::vector<const DLTensor*>& data_entry,
+                                             int* engine_batch_size) {
+    int batch_size = GetBatchSize(data_entry);
     int compatible_engine_batch_size = -1;
     bool find_engine_flag = FindCompatibleEngine(batch_size, &compatible_engine_batch_size);
     const bool use_int8 = (dmlc::GetEnv("TVM_TENSORRT_USE_INT8", 0) != 0);
@@ -289,42 +459,52 @@ class TensorRTRuntime : public JSONRuntimeBase {
     if (find_engine_flag &&
         (!use_int8 || calibrator_ == nullptr || int8_calibration_not_used_or_not_complete)) {
       // A compatible engine already exists.
+      *engine_batch_size = compatible_engine_batch_size;
       return trt_engine_cache_.at(std::make_pair(symbol_name_, compatible_engine_batch_size));
     }
 
-    // For single engine mode, remove previous engine and update max_batch_size.
+    // For single engine mode, remove previous engine and update max_batch_size. The engine covers
+    // at least the batch sizes up to TVM_TENSORRT_MAX_BATCH_SIZE, so that it is built only once.
+    *engine_batch_size = batch_size;
     if (!multi_engine_mode_) {
       DestroyEngines();
-      max_batch_size_ = batch_size;
+      max_batch_size_ = std::max(batch_size, min_max_batch_size_);
+      *engine_batch_size = max_batch_size_;
     }
     DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
-               << " with batch size " << batch_size;
+               << " with batch size " << batch_size << " and max batch size "
+               << *engine_batch_size;
 
     // Build engine.
     if (calibrator_ != nullptr && num_calibration_batches_remaining_ == 0) {
       // Calibration complete and build int8 engine
-      BuildEngineFromJson(batch_size);
+      BuildEngineFromJson(data_entry, batch_size, *engine_batch_size);
       calibrator_.reset(nullptr);
     } else {
       // Build new engine
-      BuildEngineFromJson(batch_size);
+      BuildEngineFromJson(data_entry, batch_size, *engine_batch_size);
       TensorRTEngineAndContext& engine_and_context =
-          trt_engine_cache_[std::make_pair(symbol_name_, batch_size)];
+          trt_engine_cache_[std::make_pair(symbol_name_, *engine_batch_size)];
       if (use_int8) {
-        this->CreateInt8Calibrator(engine_and_context);
+        this->CreateInt8Calibrator(engine_and_context, batch_size);
       }
     }
 
     VLOG(1) << "Finished building TensorRT engine for subgraph " << symbol_name_
             << " with batch size " << batch_size;
-    CacheEngineToDisk();
-    return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    CacheEngineToDisk(*engine_batch_size);
+    return trt_engine_cache_.at(std::make_pair(symbol_name_, *engine_batch_size));
   }
 
-  void BuildEngineFromJson(int batch_size) {
+  /*!
+   * \brief Build the engine optimized for a batch size, which supports the batch sizes from 1 to
+   * the max batch size, and cache it under the max batch size.
+   */
+  void BuildEngineFromJson(const std::vector<const DLTensor*>& data_entry, int batch_size,
+                           int max_batch_size) {
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
-    TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
-                            use_fp16, batch_size, calibrator_.get());
+    TensorRTBuilder builder(&logger_, data_entry, max_workspace_size_, use_implicit_batch_,
+                            use_fp16, batch_size, max_batch_size, calibrator_.get());
     for (size_t i = 0; i < input_nodes_.size(); ++i) {
       auto nid = input_nodes_[i];
       const auto& node = nodes_[nid];
@@ -334,7 +514,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
       } else {
         ICHECK_EQ(node.GetOpType(), "const");
         uint32_t eid = EntryID(nid, 0);
-        builder.AddConstant(nid, data_entry_[eid]);
+        builder.AddConstant(nid, data_entry[eid]);
       }
     }
 
@@ -351,7 +531,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
     }
 
     TensorRTEngineAndContext engine_and_context = builder.BuildEngine();
-    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
+    trt_engine_cache_[std::make_pair(symbol_name_, max_batch_size)] = engine_and_context;
   }
 
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
@@ -375,6 +555,11 @@ class TensorRTRuntime : public JSONRuntimeBase {
     TensorRTEngineAndContext engine_and_context;
     engine_and_context.engine =
         runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
+    if (engine_and_context.engine == nullptr) {
+      LOG(WARNING) << "Failed to deserialize the cached TensorRT engine " << path
+                   << ", which will be rebuilt";
+      return false;
+    }
     engine_and_context.context = engine_and_context.engine->createExecutionContext();
     // Load metadata
     std::string meta_path = cache_dir + "/" + key + ".meta";
@@ -397,8 +582,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
    * directory so it can be loaded later.
    */
-  void CacheEngineToDisk() {
-    int batch_size = GetBatchSize();
+  void CacheEngineToDisk(int batch_size) {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
     if (cache_dir.empty()) return;
     std::string key = GetSubgraphKey();
@@ -424,46 +608,77 @@ class TensorRTRuntime : public JSONRuntimeBase {
     SaveBinaryToFile(meta_path, os.str());
   }
 
+  /*!
+   * \brief The key of the engine of the subgraph in TVM_TENSORRT_CACHE_DIR. The key holds a hash of
+   * the graph and the weights, so that many models can share a directory, and the versions of
+   * TensorRT and the GPU, which the engines are only valid for.
+   */
   std::string GetSubgraphKey() {
-    // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
-    // instead use a hash of graph_json and all weights to allow many models in the same directory,
-    // but the cost of computing the hash is high.
-    return symbol_name_ + (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
+    if (subgraph_hash_.empty()) {
+      uint64_t hash = std::hash<std::string_view>()(graph_json_);
+      for (uint32_t nid : const_idx_) {
+        const DLTensor* data = data_entry_[EntryID(nid, 0)];
+        std::string_view bytes(static_cast<const char*>(data->data) + data->byte_offset,
+                               GetDataSize(*data));
+        hash = support::HashCombine(hash, std::hash<std::string_view>()(bytes));
+      }
+      std::ostringstream os;
+      os << std::hex << hash;
+      subgraph_hash_ = os.str();
+    }
+    int device_id;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    cudaDeviceProp prop;
+    CUDA_CALL(cudaGetDeviceProperties(&prop, device_id));
+    std::string gpu_name = prop.name;
+    for (char& c : gpu_name) {
+      if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    std::ostringstream os;
+    os << symbol_name_ << (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32") << "_"
+       << subgraph_hash_ << "_trt" << NV_TENSORRT_MAJOR << "." << NV_TENSORRT_MINOR << "."
+       << NV_TENSORRT_PATCH << "_" << gpu_name << "_sm" << prop.major << prop.minor;
+    return os.str();
   }
 
   /*! \brief Retreive a GPU buffer for input or output or allocate if needed. */
-  NDArray GetOrAllocateDeviceBuffer(int entry_id, int binding_index) {
-    std::vector<int64_t> shape(data_entry_[entry_id]->shape,
-                               data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
-    if (device_buffers_.count(binding_index)) {
+  NDArray GetOrAllocateDeviceBuffer(ExecutionSlot* slot,
+                                    const std::vector<const DLTensor*>& data_entry, int entry_id,
+                                    int binding_index) {
+    std::unordered_map<int, NDArray>& device_buffers = slot->device_buffers;
+    std::vector<int64_t> shape(data_entry[entry_id]->shape,
+                               data_entry[entry_id]->shape + data_entry[entry_id]->ndim);
+    if (device_buffers.count(binding_index)) {
       // Buffer is already initialized.
-      if (shape[0] > device_buffers_[binding_index]->shape[0]) {
+      if (shape[0] > device_buffers[binding_index]->shape[0]) {
         // Buffer is too small. Need to allocate bigger buffer.
-        device_buffers_[binding_index] =
-            runtime::NDArray::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
-      } else if (shape[0] < device_buffers_[binding_index]->shape[0]) {
+        device_buffers[binding_index] =
+            runtime::NDArray::Empty(shape, data_entry[entry_id]->dtype, {kDLCUDA, 0});
+      } else if (shape[0] < device_buffers[binding_index]->shape[0]) {
         // Buffer is too large. Create view.
-        return device_buffers_[binding_index].CreateView(shape, data_entry_[entry_id]->dtype);
+        return device_buffers[binding_index].CreateView(shape, data_entry[entry_id]->dtype);
       }
     } else {
       // Buffer not initialized yet.
-      device_buffers_[binding_index] =
-          runtime::NDArray::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
+      device_buffers[binding_index] =
+          runtime::NDArray::Empty(shape, data_entry[entry_id]->dtype, {kDLCUDA, 0});
     }
-    return device_buffers_.at(binding_index);
+    return device_buffers.at(binding_index);
   }
 
-  void CreateInt8Calibrator(const TensorRTEngineAndContext& engine_and_context) {
+  void CreateInt8Calibrator(const TensorRTEngineAndContext& engine_and_context, int batch_size) {
     // Get input names in binding order.
     std::vector<std::string> input_names;
     for (size_t i = 0; i < engine_and_context.inputs.size(); i++) {
       std::string ele = engine_and_context.inputs[i];
       input_names.push_back(ele);
     }
-    const int batch_size = GetBatchSize();
     calibrator_.reset(new TensorRTCalibrator(batch_size, input_names));
   }
 
+  /*! \brief The hash of the graph and the weights in the key of the cached engines. */
+  std::string subgraph_hash_;
+
   /*! \brief Map of function name and max batch size to TRT engine if built already. */
   std::unordered_map<std::pair<std::string, int>, TensorRTEngineAndContext, PairHash>
       trt_engine_cache_;
@@ -471,11 +686,17 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief Calibrator for INT8 mode. */
   std::unique_ptr<TensorRTCalibrator> calibrator_;
 
-  /*! \brief Map of inding index to GPU buffers for inputs and outputs. Only used when target device
-   * is not "cuda". Since TensorRT execution can only read data from GPU, we need to copy data from
-   * the runtime device to these buffers first. These will be allocated for the highest batch size
-   * used by all engines. */
-  std::unordered_map<int, NDArray> device_buffers_;
+  /*! \brief Map of function name and max batch size to the execution slots of the engine. */
+  std::unordered_map<std::pair<std::string, int>, ExecutionSlotPool, PairHash> slot_pools_;
+
+  /*! \brief Guards the engines, which the calls share and the builds replace. */
+  std::shared_mutex engine_mutex_;
+
+  /*! \brief Guards the pools of execution slots. */
+  std::mutex slot_mutex_;
+
+  /*! \brief Notified when an execution slot is returned. */
+  std::condition_variable slot_cv_;
 
   /*! \brief TensorRT logger. */
   TensorRTLogger logger_;
@@ -493,7 +714,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   bool GetCachedEnginesFromDisk() { return false; }
 
-  void CacheEngineToDisk() {}
+  void CacheEngineToDisk(int batch_size) {}
 #endif  // TVM_GRAPH_EXECUTOR_TENSORRT
 
   bool use_implicit_batch_;
@@ -507,6 +728,10 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * (multi_engine_mode=false). */
   int max_batch_size_;
 
+  /*! \brief The least max batch size of the engines in single-engine mode, set by
+   * TVM_TENSORRT_MAX_BATCH_SIZE, so that a single engine covers the batch sizes up to it. */
+  int min_max_batch_size_;
+
   /*! \brief The strategy to use for dynamic batching. With multi_engine_mode=true, a new TensorRT
    * engine is created for each unique batch size encountered. With multi_engine_mode=false, only
    * one TensorRT engine is alive at any given time. It is replaced if a higher batch size is
@@ -516,6 +741,10 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief Use auto-conversion to fp16 */
   bool use_fp16_;
+
+  /*! \brief The max number of execution contexts of an engine which run concurrently, set by
+   * TVM_TENSORRT_MAX_CONTEXTS. */
+  int max_contexts_;
 };
 
 runtime::Module TensorRTRuntimeCreate(const String& symbol_name, const String& graph_json,
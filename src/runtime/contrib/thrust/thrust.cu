@@ -39,6 +39,10 @@
 #include <vector>
 
 #include "../../cuda/cuda_common.h"
+
+#if !defined(__HIPCC__)
+#include <cub/block/block_scan.cuh>
+#endif
 namespace tvm {
 namespace contrib {
 
@@ -470,5 +474,315 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.sum_scan").set_body([](TVMArgs args, TVM
   }
 });
 
+#if !defined(__HIPCC__)
+// The segmented top-k kernels rely on 32-wide warps and cub, they are CUDA only.
+
+/*!
+ * \brief Segmented top-k along the last axis.
+ *
+ * Every candidate is packed into a 64-bit key: the upper half is the value mapped to an
+ * order-preserving unsigned integer (flipped for ascending order), the lower half is the
+ * bitwise negated index. Larger packed keys rank first and ties go to the smaller index,
+ * which matches the CPU topk.
+ */
+template <typename DataType>
+__device__ __forceinline__ uint32_t TopKOrderedKey(DataType v, bool is_ascend) {
+  uint32_t bits = __float_as_uint(static_cast<float>(v));
+  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  return is_ascend ? ~bits : bits;
+}
+
+__device__ __forceinline__ uint64_t TopKPack(uint32_t key, uint32_t index) {
+  return (static_cast<uint64_t>(key) << 32) | static_cast<uint64_t>(~index);
+}
+
+__device__ __forceinline__ uint32_t TopKUnpackIndex(uint64_t packed) {
+  return ~static_cast<uint32_t>(packed);
+}
+
+/*! \brief Bitonic merge of a bitonic sequence held one element per lane, descending. */
+__device__ __forceinline__ uint64_t WarpBitonicMergeDesc(uint64_t v, int lane) {
+#pragma unroll
+  for (int stride = 16; stride > 0; stride >>= 1) {
+    uint64_t other = __shfl_xor_sync(0xffffffff, v, stride);
+    v = ((lane & stride) == 0) ? max(v, other) : min(v, other);
+  }
+  return v;
+}
+
+/*! \brief Bitonic sort of one element per lane, descending. */
+__device__ __forceinline__ uint64_t WarpBitonicSortDesc(uint64_t v, int lane) {
+#pragma unroll
+  for (int size = 2; size <= 32; size <<= 1) {
+    bool desc = (lane & size) == 0;
+#pragma unroll
+    for (int stride = size >> 1; stride > 0; stride >>= 1) {
+      uint64_t other = __shfl_xor_sync(0xffffffff, v, stride);
+      bool lower = (lane & stride) == 0;
+      v = (lower == desc) ? max(v, other) : min(v, other);
+    }
+  }
+  return v;
+}
+
+constexpr int kTopKWarpMaxK = 32;
+constexpr int kTopKWarpsPerBlock = 4;
+constexpr int kTopKRadixThreads = 256;
+constexpr int kTopKBlockSortMaxK = 1024;
+
+/*!
+ * \brief Top-k for k <= 32, one warp per row.
+ *
+ * The warp keeps the best 32 candidates seen so far, one per lane and sorted. Each chunk
+ * of 32 elements is bitonic sorted, merged against the reversed running list and the
+ * resulting bitonic sequence is merged again. Chunks without any element better than the
+ * current k-th candidate are skipped.
+ */
+template <typename DataType, typename IndicesType>
+__global__ void SegmentedTopKWarpKernel(const DataType* input, DataType* values,
+                                        IndicesType* indices, int64_t num_rows, int64_t n, int k,
+                                        bool is_ascend) {
+  const int lane = threadIdx.x & 31;
+  const int64_t row = static_cast<int64_t>(blockIdx.x) * kTopKWarpsPerBlock + (threadIdx.x >> 5);
+  if (row >= num_rows) return;
+  const DataType* row_ptr = input + row * n;
+
+  uint64_t best = 0;
+  for (int64_t base = 0; base < n; base += 32) {
+    int64_t i = base + lane;
+    uint64_t cand = i < n ? TopKPack(TopKOrderedKey(row_ptr[i], is_ascend), i) : 0;
+    uint64_t threshold = __shfl_sync(0xffffffff, best, k - 1);
+    if (!__any_sync(0xffffffff, cand > threshold)) continue;
+    cand = WarpBitonicSortDesc(cand, lane);
+    cand = __shfl_sync(0xffffffff, cand, 31 - lane);
+    best = WarpBitonicMergeDesc(max(best, cand), lane);
+  }
+  if (lane < k) {
+    uint32_t index = TopKUnpackIndex(best);
+    values[row * k + lane] = row_ptr[index];
+    indices[row * k + lane] = static_cast<IndicesType>(index);
+  }
+}
+
+/*!
+ * \brief Radix select for larger k, one block per row.
+ *
+ * Four 8-bit passes over the ordered keys find the k-th key of the row. Elements with a
+ * larger key are always selected, elements equal to it are selected in index order. When
+ * k <= kTopKBlockSortMaxK the selected candidates are bitonic sorted in shared memory and
+ * written out sorted, otherwise they are written unsorted to candidates for a later sort.
+ */
+template <typename DataType>
+__global__ void SegmentedRadixSelectKernel(const DataType* input, uint64_t* candidates,
+                                           int64_t n, int k, int sort_size, bool is_ascend) {
+  using BlockScan = cub::BlockScan<int, kTopKRadixThreads>;
+  __shared__ typename BlockScan::TempStorage scan_storage;
+  __shared__ int histogram[256];
+  __shared__ uint32_t selected_digit;
+  __shared__ int remaining;
+  __shared__ int num_greater;
+  __shared__ uint64_t sorted[kTopKBlockSortMaxK];
+
+  const int tid = threadIdx.x;
+  const int64_t row = blockIdx.x;
+  const DataType* row_ptr = input + row * n;
+  const bool sort_in_block = sort_size > 0;
+  uint64_t* out = sort_in_block ? sorted : candidates + row * k;
+
+  if (tid == 0) {
+    remaining = k;
+    num_greater = 0;
+  }
+  uint32_t prefix = 0;
+  uint32_t mask = 0;
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    for (int b = tid; b < 256; b += kTopKRadixThreads) histogram[b] = 0;
+    __syncthreads();
+    for (int64_t i = tid; i < n; i += kTopKRadixThreads) {
+      uint32_t key = TopKOrderedKey(row_ptr[i], is_ascend);
+      if ((key & mask) == prefix) atomicAdd(&histogram[(key >> shift) & 0xff], 1);
+    }
+    __syncthreads();
+    if (tid == 0) {
+      int count = 0;
+      for (int b = 255; b >= 0; --b) {
+        if (count + histogram[b] >= remaining) {
+          selected_digit = b;
+          remaining -= count;
+          break;
+        }
+        count += histogram[b];
+      }
+    }
+    __syncthreads();
+    prefix |= selected_digit << shift;
+    mask |= 0xffu << shift;
+  }
+  // prefix now holds the k-th key, `remaining` elements equal to it are selected.
+  const int num_ties = remaining;
+  for (int64_t i = tid; i < n; i += kTopKRadixThreads) {
+    uint32_t key = TopKOrderedKey(row_ptr[i], is_ascend);
+    if (key > prefix) out[atomicAdd(&num_greater, 1)] = TopKPack(key, i);
+  }
+  __syncthreads();
+  const int tie_offset = k - num_ties;
+  int num_taken = 0;
+  for (int64_t base = 0; base < n && num_taken < num_ties; base += kTopKRadixThreads) {
+    int64_t i = base + tid;
+    int is_tie = (i < n && TopKOrderedKey(row_ptr[i], is_ascend) == prefix) ? 1 : 0;
+    int slot, total;
+    BlockScan(scan_storage).ExclusiveSum(is_tie, slot, total);
+    if (is_tie && num_taken + slot < num_ties) {
+      out[tie_offset + num_taken + slot] = TopKPack(prefix, i);
+    }
+    num_taken += total;
+    __syncthreads();
+  }
+  if (!sort_in_block) return;
+
+  for (int i = k + tid; i < sort_size; i += kTopKRadixThreads) sorted[i] = 0;
+  __syncthreads();
+  for (int size = 2; size <= sort_size; size <<= 1) {
+    for (int stride = size >> 1; stride > 0; stride >>= 1) {
+      for (int i = tid; i < sort_size; i += kTopKRadixThreads) {
+        int j = i ^ stride;
+        if (j > i) {
+          bool desc = (i & size) == 0;
+          uint64_t a = sorted[i];
+          uint64_t b = sorted[j];
+          if ((a < b) == desc) {
+            sorted[i] = b;
+            sorted[j] = a;
+          }
+        }
+      }
+      __syncthreads();
+    }
+  }
+  for (int i = tid; i < k; i += kTopKRadixThreads) candidates[row * k + i] = sorted[i];
+}
+
+template <typename DataType, typename IndicesType>
+__global__ void SegmentedTopKUnpackKernel(const DataType* input, const uint64_t* candidates,
+                                          DataType* values, IndicesType* indices, int64_t total,
+                                          int64_t n, int k) {
+  int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (i >= total) return;
+  int64_t row = i / k;
+  uint32_t index = TopKUnpackIndex(candidates[i]);
+  values[i] = input[row * n + index];
+  indices[i] = static_cast<IndicesType>(index);
+}
+
+template <typename DataType, typename IndicesType>
+void thrust_segmented_topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices,
+                           bool is_ascend, DLTensor* workspace) {
+  const DataType* data_ptr = static_cast<const DataType*>(input->data);
+  DataType* values_ptr = static_cast<DataType*>(out_values->data);
+  IndicesType* indices_ptr = static_cast<IndicesType*>(out_indices->data);
+
+  const int64_t n = input->shape[input->ndim - 1];
+  const int64_t k = out_values->shape[out_values->ndim - 1];
+  ICHECK_GE(k, 1) << "segmented_topk requires k >= 1";
+  ICHECK_LE(k, n) << "segmented_topk requires k <= " << n << ", but got k = " << k;
+  ICHECK_LT(n, static_cast<int64_t>(UINT32_MAX)) << "segmented_topk rows are limited to 2^32";
+  int64_t num_rows = 1;
+  for (int i = 0; i < input->ndim - 1; ++i) {
+    num_rows *= input->shape[i];
+  }
+  if (num_rows == 0) return;
+  cudaStream_t stream = GetCUDAStream();
+
+  if (k <= kTopKWarpMaxK) {
+    int num_blocks = (num_rows + kTopKWarpsPerBlock - 1) / kTopKWarpsPerBlock;
+    SegmentedTopKWarpKernel<<<num_blocks, kTopKWarpsPerBlock * 32, 0, stream>>>(
+        data_ptr, values_ptr, indices_ptr, num_rows, n, k, is_ascend);
+    CUDA_CALL(cudaGetLastError());
+    return;
+  }
+
+  WorkspaceMemoryResource mr(workspace);
+  const int64_t total = num_rows * k;
+  uint64_t* candidates =
+      static_cast<uint64_t*>(mr.do_allocate(sizeof(uint64_t) * total, sizeof(uint64_t)));
+  int sort_size = 0;
+  if (k <= kTopKBlockSortMaxK) {
+    sort_size = 1;
+    while (sort_size < k) sort_size <<= 1;
+  }
+  SegmentedRadixSelectKernel<<<num_rows, kTopKRadixThreads, 0, stream>>>(
+      data_ptr, candidates, n, k, sort_size, is_ascend);
+  CUDA_CALL(cudaGetLastError());
+
+  if (sort_size == 0) {
+    // Rows are too long to sort in shared memory, sort the candidates with the
+    // back-to-back stable_sort_by_key strategy of thrust_sort.
+    auto policy = get_thrust_exec_policy(&mr);
+    thrust::device_ptr<uint64_t> keys(candidates);
+    thrust::device_ptr<int> segment_ids(
+        static_cast<int*>(mr.do_allocate(sizeof(int) * total, sizeof(int))));
+    auto linear_index_to_segment_id = [k] __host__ __device__(int64_t i) {
+      return static_cast<int>(i / k);
+    };  // NOLINT(*)
+    thrust::transform(policy, thrust::counting_iterator<int64_t>(0),
+                      thrust::counting_iterator<int64_t>(total), segment_ids,
+                      linear_index_to_segment_id);
+    thrust::stable_sort_by_key(policy, keys, keys + total, segment_ids,
+                               thrust::greater<uint64_t>());
+    thrust::stable_sort_by_key(policy, segment_ids, segment_ids + total, keys);
+    mr.do_deallocate(segment_ids.get(), sizeof(int) * total, sizeof(int));
+  }
+
+  constexpr int kThreads = 256;
+  SegmentedTopKUnpackKernel<<<(total + kThreads - 1) / kThreads, kThreads, 0, stream>>>(
+      data_ptr, candidates, values_ptr, indices_ptr, total, n, k);
+  CUDA_CALL(cudaGetLastError());
+  mr.do_deallocate(candidates, sizeof(uint64_t) * total, sizeof(uint64_t));
+}
+
+template <typename DataType>
+void thrust_segmented_topk_dispatch_indices(DLTensor* input, DLTensor* values_out,
+                                            DLTensor* indices_out, bool is_ascend,
+                                            DLTensor* workspace) {
+  auto out_dtype = DLDataType2String(indices_out->dtype);
+  if (out_dtype == "int32") {
+    thrust_segmented_topk<DataType, int32_t>(input, values_out, indices_out, is_ascend,
+                                             workspace);
+  } else if (out_dtype == "int64") {
+    thrust_segmented_topk<DataType, int64_t>(input, values_out, indices_out, is_ascend,
+                                             workspace);
+  } else {
+    LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
+  }
+}
+
+// Segmented top-k along the last axis.
+// Arguments: input (..., n), values_out (..., k), indices_out (..., k), is_ascend, [workspace].
+TVM_REGISTER_GLOBAL("tvm.contrib.thrust.segmented_topk")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      ICHECK(args.num_args == 4 || args.num_args == 5);
+      DLTensor* input = args[0];
+      DLTensor* values_out = args[1];
+      DLTensor* indices_out = args[2];
+      bool is_ascend = args[3];
+      DLTensor* workspace = nullptr;
+      if (args.num_args == 5) {
+        workspace = args[4];
+      }
+
+      auto data_dtype = DLDataType2String(input->dtype);
+      if (data_dtype == "float32") {
+        thrust_segmented_topk_dispatch_indices<float>(input, values_out, indices_out, is_ascend,
+                                                      workspace);
+      } else if (data_dtype == "float16") {
+        thrust_segmented_topk_dispatch_indices<half>(input, values_out, indices_out, is_ascend,
+                                                     workspace);
+      } else {
+        LOG(FATAL) << "Unsupported input dtype: " << data_dtype
+                   << ". Supported input dtypes are float16 and float32";
+      }
+    });
+#endif  // !defined(__HIPCC__)
+
 }  // namespace contrib
 }  // namespace tvm
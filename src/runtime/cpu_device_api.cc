@@ -24,7 +24,9 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 
@@ -36,6 +38,20 @@
 
 namespace tvm {
 namespace runtime {
+namespace {
+/*! \brief Allocations from this size on are bound to the NUMA node of the allocating thread. */
+constexpr size_t kNumaLocalAllocMinBytes = 64 << 10;
+
+/*! \brief Whether node-local allocation is enabled through TVM_NUMA_LOCAL_ALLOC. */
+bool NumaLocalAllocEnabled() {
+  static bool enabled = [] {
+    const char* val = getenv("TVM_NUMA_LOCAL_ALLOC");
+    return val != nullptr && atoi(val) != 0 && threading::NumaNodeCpus().size() > 1;
+  }();
+  return enabled;
+}
+}  // namespace
+
 class CPUDeviceAPI final : public DeviceAPI {
  public:
   void SetDevice(Device dev) final {}
@@ -46,6 +62,11 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
     void* ptr;
+    bool numa_local = nbytes >= kNumaLocalAllocMinBytes && NumaLocalAllocEnabled();
+    if (numa_local) {
+      // Page alignment lets the whole buffer be bound to the node.
+      alignment = std::max<size_t>(alignment, 4096);
+    }
 #if _MSC_VER
     ptr = _aligned_malloc(nbytes, alignment);
     if (ptr == nullptr) throw std::bad_alloc();
@@ -57,6 +78,11 @@ class CPUDeviceAPI final : public DeviceAPI {
     int ret = posix_memalign(&ptr, alignment, nbytes);
     if (ret != 0) throw std::bad_alloc();
 #endif
+    if (numa_local) {
+      // Workspaces are pooled per thread, so the node of the allocating thread is
+      // also the node of the thread that uses the memory.
+      threading::BindMemoryToNumaNode(ptr, nbytes, threading::CurrentNumaNode());
+    }
     return ptr;
   }
 
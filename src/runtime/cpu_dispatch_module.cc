@@ -0,0 +1,234 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/cpu_dispatch_module.cc
+ * \brief A module which dispatches each function to the best of its variants built for several
+ * CPU feature sets, by the features of the host CPU at load time.
+ */
+#include <dmlc/io.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#define TVM_CPU_DISPATCH_X86 1
+#endif
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The x86 features the dispatch can detect, by their names in LLVM. */
+static const char* kDispatchFeatures[] = {
+    "sse4.1",   "sse4.2",   "avx",      "fma",      "f16c",       "bmi",
+    "bmi2",     "avx2",     "avxvnni",  "avx512f",  "avx512dq",   "avx512cd",
+    "avx512bw", "avx512vl", "amx-tile", "amx-int8", "avx512vnni", "avx512bf16",
+    "amx-bf16"};
+
+/*!
+ * \brief Detect the features of the host CPU which the OS also enables, by their names in LLVM.
+ * \return The detected features, a subset of kDispatchFeatures.
+ */
+std::unordered_set<std::string> DetectHostCPUFeatures() {
+  std::unordered_set<std::string> features;
+#ifdef TVM_CPU_DISPATCH_X86
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return features;
+  }
+  auto bit = [](unsigned int reg, int index) { return ((reg >> index) & 1) != 0; };
+  // The OS saves the register state of the enabled extensions, which XGETBV reports.
+  uint64_t xcr0 = 0;
+  if (bit(ecx, 27)) {
+    unsigned int xcr0_lo = 0, xcr0_hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    xcr0 = (static_cast<uint64_t>(xcr0_hi) << 32) | xcr0_lo;
+  }
+  bool avx_state = (xcr0 & 0x6) == 0x6;
+  bool avx512_state = avx_state && (xcr0 & 0xe0) == 0xe0;
+  bool amx_state = (xcr0 & 0x60000) == 0x60000;
+
+  if (bit(ecx, 19)) features.insert("sse4.1");
+  if (bit(ecx, 20)) features.insert("sse4.2");
+  if (avx_state && bit(ecx, 28)) features.insert("avx");
+  if (avx_state && bit(ecx, 12)) features.insert("fma");
+  if (avx_state && bit(ecx, 29)) features.insert("f16c");
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    return features;
+  }
+  if (bit(ebx, 3)) features.insert("bmi");
+  if (bit(ebx, 8)) features.insert("bmi2");
+  if (avx_state && bit(ebx, 5)) features.insert("avx2");
+  if (avx512_state) {
+    if (bit(ebx, 16)) features.insert("avx512f");
+    if (bit(ebx, 17)) features.insert("avx512dq");
+    if (bit(ebx, 28)) features.insert("avx512cd");
+    if (bit(ebx, 30)) features.insert("avx512bw");
+    if (bit(ebx, 31)) features.insert("avx512vl");
+    if (bit(ecx, 11)) features.insert("avx512vnni");
+  }
+  if (amx_state) {
+    if (bit(edx, 22)) features.insert("amx-bf16");
+    if (bit(edx, 24)) features.insert("amx-tile");
+    if (bit(edx, 25)) features.insert("amx-int8");
+  }
+
+  if (__get_cpuid_count(7, 1, &eax, &ebx, &ecx, &edx)) {
+    if (avx_state && bit(eax, 4)) features.insert("avxvnni");
+    if (avx512_state && bit(eax, 5)) features.insert("avx512bf16");
+  }
+#endif
+  return features;
+}
+
+/*! \brief The features of the host CPU, detected once. */
+const std::unordered_set<std::string>& HostCPUFeatures() {
+  static const std::unordered_set<std::string> features = DetectHostCPUFeatures();
+  return features;
+}
+
+/*!
+ * \brief The module of the variants of the functions, which are built for several CPU feature
+ * sets into its imports.
+ *
+ * The symbol of a function in a variant is the name of the function and the suffix of the
+ * variant. The variants are ordered by preference, and the first one whose features the host
+ * CPU has serves all the functions.
+ */
+class CPUDispatchModuleNode : public ModuleNode {
+ public:
+  CPUDispatchModuleNode(std::vector<std::string> suffixes,
+                        std::vector<std::vector<std::string>> features)
+      : suffixes_(std::move(suffixes)), features_(std::move(features)) {
+    ICHECK_EQ(suffixes_.size(), features_.size());
+    const auto& host_features = HostCPUFeatures();
+    for (size_t i = 0; i < features_.size() && selected_ < 0; ++i) {
+      bool supported = true;
+      for (const std::string& feature : features_[i]) {
+        supported = supported && host_features.count(feature);
+      }
+      if (supported) {
+        selected_ = static_cast<int>(i);
+      }
+    }
+  }
+
+  const char* type_key() const final { return "cpu_dispatch"; }
+
+  int GetPropertyMask() const final {
+    return ModulePropertyMask::kBinarySerializable | ModulePropertyMask::kRunnable;
+  }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (selected_ < 0) {
+      std::ostringstream os;
+      for (size_t i = 0; i < features_.size(); ++i) {
+        os << (i > 0 ? "], [" : "[");
+        for (size_t j = 0; j < features_[i].size(); ++j) {
+          os << (j > 0 ? ", " : "") << features_[i][j];
+        }
+      }
+      LOG(FATAL) << "The host CPU has the features of none of the variants: " << os.str() << "]";
+    }
+    // The functions are only served by the selected variant, as the others may not run here.
+    std::string symbol = name + suffixes_[selected_];
+    for (Module& mod : imports_) {
+      PackedFunc pf = mod->GetFunction(symbol, true);
+      if (pf != nullptr) {
+        return pf;
+      }
+    }
+    return PackedFunc();
+  }
+
+  /*! \return The index of the variant selected for the host CPU, or -1 if none runs here. */
+  int selected() const { return selected_; }
+
+  void SaveToBinary(dmlc::Stream* stream) final {
+    stream->Write(suffixes_);
+    stream->Write(features_);
+  }
+
+  static Module LoadFromBinary(void* strm) {
+    dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+    std::vector<std::string> suffixes;
+    std::vector<std::vector<std::string>> features;
+    ICHECK(stream->Read(&suffixes)) << "Loading the variant suffixes failed";
+    ICHECK(stream->Read(&features)) << "Loading the variant features failed";
+    return Module(make_object<CPUDispatchModuleNode>(std::move(suffixes), std::move(features)));
+  }
+
+ private:
+  /*! \brief The symbol suffix of each variant. */
+  std::vector<std::string> suffixes_;
+  /*! \brief The CPU features each variant requires. */
+  std::vector<std::vector<std::string>> features_;
+  /*! \brief The index of the variant selected for the host CPU, or -1 if none runs here. */
+  int selected_ = -1;
+};
+
+TVM_REGISTER_GLOBAL("runtime.module.loadbinary_cpu_dispatch")
+    .set_body_typed(CPUDispatchModuleNode::LoadFromBinary);
+
+TVM_REGISTER_GLOBAL("runtime.CPUDispatchModuleCreate")
+    .set_body_typed([](Array<String> suffixes, Array<Array<String>> features) {
+      std::vector<std::vector<std::string>> variant_features;
+      for (const Array<String>& variant : features) {
+        variant_features.emplace_back(variant.begin(), variant.end());
+      }
+      auto n = make_object<CPUDispatchModuleNode>(
+          std::vector<std::string>(suffixes.begin(), suffixes.end()), std::move(variant_features));
+      return Module(n);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.CPUDispatchModuleSelected").set_body_typed([](Module mod) {
+  ICHECK_EQ(std::string(mod->type_key()), "cpu_dispatch")
+      << "Expected a cpu_dispatch module, but got " << mod->type_key();
+  return static_cast<const CPUDispatchModuleNode*>(mod.operator->())->selected();
+});
+
+TVM_REGISTER_GLOBAL("runtime.CPUDispatchFeatures").set_body_typed([]() {
+  Array<String> features;
+  for (const char* feature : kDispatchFeatures) {
+    features.push_back(feature);
+  }
+  return features;
+});
+
+TVM_REGISTER_GLOBAL("runtime.HostCPUFeatures").set_body_typed([]() {
+  Array<String> features;
+  for (const std::string& feature : HostCPUFeatures()) {
+    features.push_back(feature);
+  }
+  return features;
+});
+
+}  // namespace runtime
+}  // namespace tvm
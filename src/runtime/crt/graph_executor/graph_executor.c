@@ -915,10 +915,48 @@ int TVMGraphExecutor_GetOutput(TVMGraphExecutor* executor, const int32_t idx, DL
   return status;
 }
 
+/*!
+ * \brief Find the place of a storage entry in the arena of the executor.
+ * \param executor The graph executor.
+ * \param storage_id The storage id of the entry.
+ * \param size The size of the entry in bytes.
+ * \param next_offset The offset of the entry when the arena has no offset table. It is moved
+ * past the entry.
+ * \param out_data Pointer which receives the start of the entry.
+ * \return 0 on success, -1 if the entry is misaligned or does not fit in the arena.
+ */
+static int TVMGraphExecutor_PlaceInArena(TVMGraphExecutor* executor, uint32_t storage_id,
+                                         size_t size, size_t* next_offset, void** out_data) {
+  const TVMGraphExecutorArena* arena = &(executor->arena);
+  const size_t align = TVM_CRT_GRAPH_EXECUTOR_ARENA_ALIGNMENT_BYTES;
+  size_t offset = *next_offset;
+  if (arena->offsets != NULL) {
+    if (storage_id >= arena->offsets_count) {
+      fprintf(stderr, "arena has no offset for storage_id=%u\n", storage_id);
+      return -1;
+    }
+    offset = arena->offsets[storage_id];
+  }
+  if (offset > arena->size || size > arena->size - offset) {
+    fprintf(stderr, "storage_id=%u of %lu bytes at offset %lu overflows the arena of %lu bytes\n",
+            storage_id, (unsigned long)size, (unsigned long)offset, (unsigned long)arena->size);
+    return -1;
+  }
+  if (((uintptr_t)(arena->data + offset)) % align != 0) {
+    fprintf(stderr, "storage_id=%u at offset %lu is not aligned to %lu bytes\n", storage_id,
+            (unsigned long)offset, (unsigned long)align);
+    return -1;
+  }
+  *next_offset = offset + (size + align - 1) / align * align;
+  *out_data = arena->data + offset;
+  return 0;
+}
+
 int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
   TVMPackedFunc lookup_linked_param;
   int lookup_linked_param_valid;
   uint32_t idx;
+  size_t arena_offset = 0;
 
   {
     TVMArgs temp_args;
@@ -980,6 +1018,7 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
     fprintf(stderr, "memory allocate error: %08x", err);
     return -1;
   }
+  memset(executor->storage_pool, 0, sizeof(TVMGraphExecutorStorageEntry) * pool_entry_count);
   for (idx = 0; idx < pool_entry_count; idx++) {
     TVMGraphExecutorPoolEntry pit = pool_entry[idx];
     DLDevice dev = executor->devices[0];
@@ -1001,7 +1040,22 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
         did_find_linked_param = 1;
       }
     }
-    if (did_find_linked_param == 0) {
+    if (did_find_linked_param == 0 && executor->arena.data != NULL) {
+      void* data = NULL;
+      if (TVMGraphExecutor_PlaceInArena(executor, idx, pit.size, &arena_offset, &data) != 0) {
+        TVMPlatformMemoryFree(vtype, alloc_dev);
+        TVMPlatformMemoryFree(pool_entry, alloc_dev);
+        return -1;
+      }
+      executor->storage_pool[executor->storage_pool_count].is_in_arena = 1;
+      DLTensor* tensor = &executor->storage_pool[executor->storage_pool_count].array.dl_tensor;
+      tensor->data = data;
+      tensor->device = dev;
+      tensor->ndim = attrs->ndim[pit.entry_id];
+      tensor->shape = attrs->shape + pit.entry_id * TVM_CRT_MAX_NDIM;
+      tensor->strides = NULL;
+      tensor->byte_offset = 0;
+    } else if (did_find_linked_param == 0) {
       DLDataType dtype = {kDLFloat, 32, 1};
       int64_t shape[TVM_CRT_MAX_NDIM] = {
           0,
@@ -1201,6 +1255,25 @@ int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
   return TVMGraphExecutor_Init(*executor, sym_json, module_handle, devs);
 }
 
+int TVMGraphExecutor_CreateWithArena(const char* sym_json, TVMModuleHandle module_handle,
+                                     const DLDevice* devs, const TVMGraphExecutorArena* arena,
+                                     TVMGraphExecutor** executor) {
+  if (arena == NULL || arena->data == NULL) {
+    fprintf(stderr, "graph executor arena is NULL\n");
+    return -1;
+  }
+  DLDevice dev = {kDLCPU, 0};
+  tvm_crt_error_t err = TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutor), dev, (void**)executor);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+
+  memset(*executor, 0, sizeof(TVMGraphExecutor));
+  (*executor)->arena = *arena;
+  return TVMGraphExecutor_Init(*executor, sym_json, module_handle, devs);
+}
+
 int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
   int status = 0;
   int32_t idx;
@@ -1221,7 +1294,8 @@ int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
     return status;
   }
   for (idx = 0; idx < executor->storage_pool_count; ++idx) {
-    if (executor->storage_pool[idx].is_linked_param == 0) {
+    if (executor->storage_pool[idx].is_linked_param == 0 &&
+        executor->storage_pool[idx].is_in_arena == 0) {
       status = TVMNDArray_Release(&(executor->storage_pool[idx]).array);
       if (status != 0) {
         return status;
@@ -52,6 +52,8 @@ typedef struct TVMGraphExecutorNodeEntry {
 // Storage entry.
 typedef struct TVMGraphExecutorStorageEntry {
   uint8_t is_linked_param;
+  // Whether array points into the arena of the executor instead of owning its data.
+  uint8_t is_in_arena;
   TVMNDArray array;
 } TVMGraphExecutorStorageEntry;
 
@@ -100,6 +102,8 @@ typedef struct TVMGraphExecutor {
   /*! \brief Common storage pool for all devices. */
   TVMGraphExecutorStorageEntry* storage_pool;
   uint32_t storage_pool_count;
+  /*! \brief Caller-provided buffer for the storage pool, unused when arena.data is NULL. */
+  TVMGraphExecutorArena arena;
   /*! \brief Data entry of each node. */
   TVMNDArray* data_entry;
   uint32_t data_entry_count;
@@ -122,6 +126,7 @@ int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpPara
                                      DLTensorPtr* args, const uint32_t args_count,
                                      TVMPackedFunc* pf);
 int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader);
+int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor);
 
 #ifdef __cplusplus
 }
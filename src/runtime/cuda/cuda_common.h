@@ -24,11 +24,14 @@
 #ifndef TVM_RUNTIME_CUDA_CUDA_COMMON_H_
 #define TVM_RUNTIME_CUDA_CUDA_COMMON_H_
 
+#include <cuda.h>
 #include <cuda_runtime.h>
 #include <tvm/runtime/packed_func.h>
 
 #include <string>
+#include <vector>
 
+#include "../thread_storage_scope.h"
 #include "../workspace_pool.h"
 
 namespace tvm {
@@ -51,11 +54,50 @@ namespace runtime {
         << "CUDA: " << cudaGetErrorString(e);                 \
   }
 
+/*!
+ * \brief A sequence of kernel launches of the CUDA modules, with their functions, launch
+ * configurations and marshalled parameters. It is recorded from the launches on a thread, and
+ * launched again with one host call, which skips the unpacking of the arguments of each kernel.
+ */
+class CUDALaunchSequence {
+ public:
+  /*!
+   * \brief Record a kernel launch.
+   * \param func The kernel.
+   * \param wl The launch configuration.
+   * \param args The addresses of the kernel parameters.
+   * \param arg_sizes The number of bytes of each kernel parameter.
+   */
+  void Record(CUfunction func, const ThreadWorkLoad& wl, void** args,
+              const std::vector<size_t>& arg_sizes);
+
+  /*! \brief Launch the recorded kernels in order on a stream. */
+  void Launch(CUstream stream);
+
+  /*! \brief The number of recorded kernel launches. */
+  size_t size() const { return launches_.size(); }
+
+ private:
+  struct KernelLaunch {
+    CUfunction func;
+    ThreadWorkLoad wl;
+    /*! \brief The index of the first parameter in params_. */
+    size_t param_begin;
+  };
+  std::vector<KernelLaunch> launches_;
+  /*! \brief The parameters of all the launches, each in an 8-byte slot. */
+  std::vector<uint64_t> params_;
+  /*! \brief The addresses of the parameters, built at the first launch. */
+  std::vector<void*> param_addrs_;
+};
+
 /*! \brief Thread local workspace */
 class CUDAThreadEntry {
  public:
   /*! \brief The cuda stream */
   cudaStream_t stream{nullptr};
+  /*! \brief The sequence which records the kernel launches on the thread, or nullptr. */
+  CUDALaunchSequence* launch_sequence{nullptr};
   /*! \brief thread local pool*/
   WorkspacePool pool;
   /*! \brief constructor */
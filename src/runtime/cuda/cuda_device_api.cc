@@ -24,11 +24,20 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <dmlc/thread_local.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "cuda_common.h"
 
@@ -127,6 +136,10 @@ class CUDADeviceAPI final : public DeviceAPI {
         *rv = static_cast<int64_t>(free_mem);
         return;
       }
+      case kPeerTopology: {
+        *rv = GetPeerTopology(dev.device_id);
+        return;
+      }
     }
     *rv = value;
   }
@@ -203,7 +216,7 @@ class CUDADeviceAPI final : public DeviceAPI {
       if (dev_from.device_id == dev_to.device_id) {
         GPUCopy(from, to, size, cudaMemcpyDeviceToDevice, cu_stream);
       } else {
-        cudaMemcpyPeerAsync(to, dev_to.device_id, from, dev_from.device_id, size, cu_stream);
+        PeerCopy(from, dev_from.device_id, to, dev_to.device_id, size, cu_stream);
       }
     } else if (dev_from.device_type == kDLCUDA && dev_to.device_type == kDLCPU) {
       CUDA_CALL(cudaSetDevice(dev_from.device_id));
@@ -230,6 +243,32 @@ class CUDADeviceAPI final : public DeviceAPI {
     CUDA_CALL(cudaStreamDestroy(cu_stream));
   }
 
+  /*!
+   * \brief Enable the access of a device to the memory of a peer, once for each pair.
+   * \return Whether the device can access the memory of the peer.
+   */
+  bool EnablePeerAccess(int device_id, int peer_id) {
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    auto it = peer_access_.find({device_id, peer_id});
+    if (it != peer_access_.end()) {
+      return it->second;
+    }
+    int can_access = 0;
+    CUDA_CALL(cudaDeviceCanAccessPeer(&can_access, device_id, peer_id));
+    if (can_access) {
+      CUDA_CALL(cudaSetDevice(device_id));
+      cudaError_t err = cudaDeviceEnablePeerAccess(peer_id, 0);
+      if (err == cudaErrorPeerAccessAlreadyEnabled) {
+        // Enabled outside of TVM, clear the error.
+        cudaGetLastError();
+      } else {
+        CUDA_CALL(err);
+      }
+    }
+    peer_access_[{device_id, peer_id}] = can_access != 0;
+    return can_access != 0;
+  }
+
   void SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst) {
     CUDA_CALL(cudaSetDevice(dev.device_id));
     cudaStream_t src_stream = static_cast<cudaStream_t>(event_src);
@@ -274,6 +313,59 @@ class CUDADeviceAPI final : public DeviceAPI {
                       cudaStream_t stream) {
     CUDA_CALL(cudaMemcpyAsync(to, from, size, kind, stream));
   }
+
+  /*!
+   * \brief Copy between two devices on a stream of the source device, directly over NVLink or
+   * PCIe once the peer access is enabled, or staged through the host otherwise.
+   *
+   * The copy is not ordered with the work of the destination device, so the default stream of
+   * the destination, and the blocking streams with it, wait for the copy on an event.
+   */
+  void PeerCopy(const void* from, int from_id, void* to, int to_id, size_t size,
+                cudaStream_t stream) {
+    // Both directions are enabled, so that the copies in either direction run without staging.
+    EnablePeerAccess(from_id, to_id);
+    EnablePeerAccess(to_id, from_id);
+    CUDA_CALL(cudaSetDevice(from_id));
+    CUDA_CALL(cudaMemcpyPeerAsync(to, to_id, from, from_id, size, stream));
+    cudaEvent_t evt;
+    CUDA_CALL(cudaEventCreateWithFlags(&evt, cudaEventDisableTiming));
+    CUDA_CALL(cudaEventRecord(evt, stream));
+    CUDA_CALL(cudaSetDevice(to_id));
+    CUDA_CALL(cudaStreamWaitEvent(nullptr, evt, 0));
+    // The event is released once the wait completes.
+    CUDA_CALL(cudaEventDestroy(evt));
+    CUDA_CALL(cudaSetDevice(from_id));
+  }
+
+  /*! \brief The links of a device to the other devices, see kPeerTopology. */
+  static std::string GetPeerTopology(int device_id) {
+    int count = 0;
+    CUDA_CALL(cudaGetDeviceCount(&count));
+    std::ostringstream os;
+    os << "[";
+    for (int peer_id = 0; peer_id < count; ++peer_id) {
+      if (peer_id == device_id) continue;
+      int access = 0, atomics = 0, rank = 0;
+      CUDA_CALL(
+          cudaDeviceGetP2PAttribute(&access, cudaDevP2PAttrAccessSupported, device_id, peer_id));
+      CUDA_CALL(cudaDeviceGetP2PAttribute(&atomics, cudaDevP2PAttrNativeAtomicSupported,
+                                          device_id, peer_id));
+      CUDA_CALL(
+          cudaDeviceGetP2PAttribute(&rank, cudaDevP2PAttrPerformanceRank, device_id, peer_id));
+      // The native atomics between peers are supported over NVLink, but not over PCIe.
+      const char* link = !access ? "none" : (atomics ? "nvlink" : "pcie");
+      os << (os.tellp() > 1 ? ", " : "") << "{\"device_id\": " << peer_id
+         << ", \"access\": " << access << ", \"link\": \"" << link
+         << "\", \"performance_rank\": " << rank << "}";
+    }
+    os << "]";
+    return os.str();
+  }
+
+  /*! \brief Whether each device can access the memory of a peer, by (device, peer). */
+  std::map<std::pair<int, int>, bool> peer_access_;
+  std::mutex peer_mutex_;
 };
 
 typedef dmlc::ThreadLocalStore<CUDAThreadEntry> CUDAThreadStore;
@@ -352,5 +444,72 @@ TVM_DLL int GetCudaDeviceCount() {
 
 TVM_REGISTER_GLOBAL("runtime.GetCudaDeviceCount").set_body_typed(GetCudaDeviceCount);
 
+#if CUDA_VERSION >= 12000
+/*!
+ * \brief Encode the CUtensorMap that tiles a tensor for the TMA copies of cp.async.bulk.tensor.
+ * \param tensor The contiguous tensor in global memory.
+ * \param box_shape The shape of a tile, ordered like the shape of the tensor.
+ * \param swizzle_bytes The swizzle of the tiles in shared memory, 0, 32, 64 or 128.
+ * \return The tensor map, a 128-byte uint8 array on the device of the tensor.
+ */
+NDArray EncodeTensorMapTiled(NDArray tensor, ShapeTuple box_shape, int swizzle_bytes) {
+  static const std::vector<std::pair<DataType, CUtensorMapDataType>> dtype_map = {
+      {DataType::UInt(8), CU_TENSOR_MAP_DATA_TYPE_UINT8},
+      {DataType::UInt(16), CU_TENSOR_MAP_DATA_TYPE_UINT16},
+      {DataType::UInt(32), CU_TENSOR_MAP_DATA_TYPE_UINT32},
+      {DataType::Int(32), CU_TENSOR_MAP_DATA_TYPE_INT32},
+      {DataType::UInt(64), CU_TENSOR_MAP_DATA_TYPE_UINT64},
+      {DataType::Int(64), CU_TENSOR_MAP_DATA_TYPE_INT64},
+      {DataType::Float(16), CU_TENSOR_MAP_DATA_TYPE_FLOAT16},
+      {DataType::Float(32), CU_TENSOR_MAP_DATA_TYPE_FLOAT32},
+      {DataType::Float(64), CU_TENSOR_MAP_DATA_TYPE_FLOAT64},
+      {DataType::BFloat(16), CU_TENSOR_MAP_DATA_TYPE_BFLOAT16},
+  };
+  static const std::unordered_map<int, CUtensorMapSwizzle> swizzle_map = {
+      {0, CU_TENSOR_MAP_SWIZZLE_NONE},
+      {32, CU_TENSOR_MAP_SWIZZLE_32B},
+      {64, CU_TENSOR_MAP_SWIZZLE_64B},
+      {128, CU_TENSOR_MAP_SWIZZLE_128B},
+  };
+  int rank = tensor->ndim;
+  CHECK(tensor->device.device_type == kDLCUDA && tensor.IsContiguous())
+      << "ValueError: The tensor of a tensor map should be a contiguous CUDA tensor";
+  CHECK(1 <= rank && rank <= 5) << "ValueError: A tensor map supports tensors of 1 to 5 "
+                                << "dimensions, but got " << rank;
+  CHECK_EQ(static_cast<int>(box_shape.size()), rank)
+      << "ValueError: The tile of a tensor map should have the rank " << rank << " of the tensor";
+  auto dtype_it = std::find_if(dtype_map.begin(), dtype_map.end(),
+                               [&](const auto& kv) { return kv.first == tensor.DataType(); });
+  CHECK(dtype_it != dtype_map.end())
+      << "ValueError: Unsupported data type of a tensor map " << tensor.DataType();
+  auto swizzle_it = swizzle_map.find(swizzle_bytes);
+  CHECK(swizzle_it != swizzle_map.end())
+      << "ValueError: The swizzle of a tensor map should be 0, 32, 64 or 128 bytes, but got "
+      << swizzle_bytes;
+  // The tensor map orders the dimensions from the innermost one outwards.
+  std::vector<cuuint64_t> global_dim(rank), global_strides(rank);
+  std::vector<cuuint32_t> box_dim(rank), element_strides(rank, 1);
+  cuuint64_t stride = tensor.DataType().bytes();
+  for (int i = 0; i < rank; ++i) {
+    global_dim[i] = tensor->shape[rank - 1 - i];
+    box_dim[i] = box_shape[rank - 1 - i];
+    global_strides[i] = stride;
+    stride *= global_dim[i];
+  }
+  CUtensorMap tensor_map;
+  CUDA_DRIVER_CALL(cuTensorMapEncodeTiled(
+      &tensor_map, dtype_it->second, rank, static_cast<char*>(tensor->data) + tensor->byte_offset,
+      global_dim.data(), global_strides.data() + 1, box_dim.data(), element_strides.data(),
+      CU_TENSOR_MAP_INTERLEAVE_NONE, swizzle_it->second, CU_TENSOR_MAP_L2_PROMOTION_L2_128B,
+      CU_TENSOR_MAP_FLOAT_OOB_FILL_NONE));
+  int64_t num_bytes = sizeof(CUtensorMap);
+  NDArray result = NDArray::Empty({num_bytes}, DataType::UInt(8), tensor->device);
+  result.CopyFromBytes(&tensor_map, sizeof(CUtensorMap));
+  return result;
+}
+
+TVM_REGISTER_GLOBAL("runtime.cuda.encode_tensor_map_tiled").set_body_typed(EncodeTensorMapTiled);
+#endif
+
 }  // namespace runtime
 }  // namespace tvm
@@ -24,11 +24,16 @@
 
 #include <cuda.h>
 #include <cuda_runtime.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <array>
+#include <cstdlib>
+#include <cstring>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -41,10 +46,25 @@
 namespace tvm {
 namespace runtime {
 
+namespace {
+/*!
+ * \brief Whether the modules loaded from files or binaries are preloaded on all the devices in
+ * the background, enabled through TVM_CUDA_PRELOAD_MODULES.
+ */
+bool PreloadModulesEnabled() {
+  static bool enabled = [] {
+    const char* val = getenv("TVM_CUDA_PRELOAD_MODULES");
+    return val != nullptr && atoi(val) != 0;
+  }();
+  return enabled;
+}
+}  // namespace
+
 // Module to support thread-safe multi-GPU execution.
 // cuModule is a per-GPU module
 // The runtime will contain a per-device module table
-// The modules will be lazily loaded
+// The modules will be lazily loaded, or preloaded in the background with
+// TVM_CUDA_PRELOAD_MODULES=1, so that the JIT of PTX is off the first call.
 class CUDAModuleNode : public runtime::ModuleNode {
  public:
   explicit CUDAModuleNode(std::string data, std::string fmt,
@@ -55,6 +75,9 @@ class CUDAModuleNode : public runtime::ModuleNode {
   }
   // destructor
   ~CUDAModuleNode() {
+    if (preload_thread_.joinable()) {
+      preload_thread_.join();
+    }
     for (size_t i = 0; i < module_.size(); ++i) {
       if (module_[i] != nullptr) {
         CUDA_CALL(cudaSetDevice(static_cast<int>(i)));
@@ -72,6 +95,16 @@ class CUDAModuleNode : public runtime::ModuleNode {
 
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final;
 
+  /*!
+   * \brief Read the loop profiling counters of the kernels on the current device.
+   * \param reset Whether to clear the counters after reading them.
+   * \return The (loop id, number of runs, total cycles) of each loop which ran, counted once per
+   *  block with the clock of the SM.
+   */
+  Array<ShapeTuple> DumpLoopProfile(bool reset);
+
+  String GetFormat() final { return fmt_; }
+
   void SaveToFile(const String& file_name, const String& format) final {
     std::string fmt = GetFileFormat(file_name, format);
     std::string meta_file = GetMetaFilePath(file_name);
@@ -102,15 +135,35 @@ class CUDAModuleNode : public runtime::ModuleNode {
     }
   }
 
+  /*!
+   * \brief Load the module on all the devices in a background thread, in which the driver
+   * compiles the PTX or picks the cubin of each device. The calls on a device wait for its load.
+   */
+  void StartPreload() {
+    preload_thread_ = std::thread([this]() {
+      int num_devices = 0;
+      if (cudaGetDeviceCount(&num_devices) != cudaSuccess) {
+        return;
+      }
+      for (int device_id = 0; device_id < std::min(num_devices, kMaxNumGPUs); ++device_id) {
+        try {
+          CUDA_CALL(cudaSetDevice(device_id));
+          std::lock_guard<std::mutex> lock(mutex_[device_id]);
+          LoadModule(device_id);
+        } catch (const Error& e) {
+          // The error is raised again by the load at the first call on the device.
+          LOG(WARNING) << "Failed to preload the CUDA module on device " << device_id << ": "
+                       << e.what();
+        }
+      }
+    });
+  }
+
   // get a CUfunction from primary context in device_id
   CUfunction GetFunc(int device_id, const std::string& func_name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // must recheck under the lock scope
-    if (module_[device_id] == nullptr) {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
-    }
+    std::lock_guard<std::mutex> lock(mutex_[device_id]);
     CUfunction func;
-    CUresult result = cuModuleGetFunction(&func, module_[device_id], func_name.c_str());
+    CUresult result = cuModuleGetFunction(&func, LoadModule(device_id), func_name.c_str());
     if (result != CUDA_SUCCESS) {
       const char* msg;
       cuGetErrorName(result, &msg);
@@ -120,15 +173,12 @@ class CUDAModuleNode : public runtime::ModuleNode {
   }
   // get a global var from primary context in device_id
   CUdeviceptr GetGlobal(int device_id, const std::string& global_name, size_t expect_nbytes) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // must recheck under the lock scope
-    if (module_[device_id] == nullptr) {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
-    }
+    std::lock_guard<std::mutex> lock(mutex_[device_id]);
     CUdeviceptr global;
     size_t nbytes;
 
-    CUresult result = cuModuleGetGlobal(&global, &nbytes, module_[device_id], global_name.c_str());
+    CUresult result =
+        cuModuleGetGlobal(&global, &nbytes, LoadModule(device_id), global_name.c_str());
     ICHECK_EQ(nbytes, expect_nbytes);
     if (result != CUDA_SUCCESS) {
       const char* msg;
@@ -137,8 +187,29 @@ class CUDAModuleNode : public runtime::ModuleNode {
     }
     return global;
   }
+  // get a global var from primary context in device_id, or 0 if the module does not define it
+  CUdeviceptr FindGlobal(int device_id, const std::string& global_name) {
+    std::lock_guard<std::mutex> lock(mutex_[device_id]);
+    CUdeviceptr global;
+    size_t nbytes;
+    CUresult result =
+        cuModuleGetGlobal(&global, &nbytes, LoadModule(device_id), global_name.c_str());
+    if (result == CUDA_ERROR_NOT_FOUND) {
+      return 0;
+    }
+    CUDA_DRIVER_CALL(result);
+    return global;
+  }
 
  private:
+  // get the module in device_id, loading it if needed, with mutex_[device_id] held
+  CUmodule LoadModule(int device_id) {
+    if (module_[device_id] == nullptr) {
+      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
+    }
+    return module_[device_id];
+  }
+
   // the binary data
   std::string data_;
   // The format
@@ -149,8 +220,10 @@ class CUDAModuleNode : public runtime::ModuleNode {
   std::string cuda_source_;
   // the internal modules per GPU, to be lazily initialized.
   std::array<CUmodule, kMaxNumGPUs> module_;
-  // internal mutex when updating the module
-  std::mutex mutex_;
+  // internal mutex per GPU when updating the module
+  std::array<std::mutex, kMaxNumGPUs> mutex_;
+  // the thread which preloads the modules
+  std::thread preload_thread_;
 };
 
 // a wrapped function class to get packed func.
@@ -158,12 +231,16 @@ class CUDAWrappedFunc {
  public:
   // initialize the CUDA function.
   void Init(CUDAModuleNode* m, ObjectPtr<Object> sptr, const std::string& func_name,
-            size_t num_void_args, const std::vector<std::string>& launch_param_tags) {
+            const std::vector<DLDataType>& arg_types,
+            const std::vector<std::string>& launch_param_tags) {
     m_ = m;
     sptr_ = sptr;
     func_name_ = func_name;
     std::fill(fcache_.begin(), fcache_.end(), nullptr);
-    launch_param_config_.Init(num_void_args, launch_param_tags);
+    launch_param_config_.Init(arg_types.size(), launch_param_tags);
+    for (const DLDataType& arg_type : arg_types) {
+      arg_sizes_.push_back(arg_type.code == kTVMOpaqueHandle ? sizeof(void*) : arg_type.bits / 8);
+    }
   }
   // invoke the function with void arguments
   void operator()(TVMArgs args, TVMRetValue* rv, void** void_args) const {
@@ -184,7 +261,8 @@ class CUDAWrappedFunc {
         }
       }
     }
-    CUstream strm = static_cast<CUstream>(CUDAThreadEntry::ThreadLocal()->stream);
+    CUDAThreadEntry* thread_entry = CUDAThreadEntry::ThreadLocal();
+    CUstream strm = static_cast<CUstream>(thread_entry->stream);
     CUresult result = cuLaunchKernel(fcache_[device_id], wl.grid_dim(0), wl.grid_dim(1),
                                      wl.grid_dim(2), wl.block_dim(0), wl.block_dim(1),
                                      wl.block_dim(2), wl.dyn_shmem_size, strm, void_args, nullptr);
@@ -205,6 +283,9 @@ class CUDAWrappedFunc {
       }
       LOG(FATAL) << os.str();
     }
+    if (thread_entry->launch_sequence != nullptr) {
+      thread_entry->launch_sequence->Record(fcache_[device_id], wl, void_args, arg_sizes_);
+    }
   }
 
  private:
@@ -214,6 +295,8 @@ class CUDAWrappedFunc {
   ObjectPtr<Object> sptr_;
   // The name of the function.
   std::string func_name_;
+  // The number of bytes of each kernel parameter.
+  std::vector<size_t> arg_sizes_;
   // Device function cache per device.
   // mark as mutable, to enable lazy initialization
   mutable std::array<CUfunction, kMaxNumGPUs> fcache_;
@@ -252,14 +335,71 @@ PackedFunc CUDAModuleNode::GetFunction(const String& name, const ObjectPtr<Objec
   if (name == symbol::tvm_prepare_global_barrier) {
     return PackedFunc(CUDAPrepGlobalBarrier(this, sptr_to_self));
   }
+  if (name == symbol::tvm_loop_profile_dump) {
+    return TypedPackedFunc<Array<ShapeTuple>(bool)>([this, sptr_to_self](bool reset) {
+      return DumpLoopProfile(reset);
+    });
+  }
   auto it = fmap_.find(name);
   if (it == fmap_.end()) return PackedFunc();
   const FunctionInfo& info = it->second;
   CUDAWrappedFunc f;
-  f.Init(this, sptr_to_self, name, info.arg_types.size(), info.launch_param_tags);
+  f.Init(this, sptr_to_self, name, info.arg_types, info.launch_param_tags);
   return PackFuncVoidAddr(f, info.arg_types);
 }
 
+Array<ShapeTuple> CUDAModuleNode::DumpLoopProfile(bool reset) {
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  CUdeviceptr ptr = FindGlobal(device_id, symbol::tvm_loop_profile_counters);
+  Array<ShapeTuple> result;
+  if (ptr == 0) {
+    // None of the kernels is instrumented.
+    return result;
+  }
+  // The counters are interleaved, the number of runs and the cycles of each loop id.
+  std::vector<uint64_t> counters(2 * profiling::kMaxProfiledLoops);
+  CUDA_CALL(cudaDeviceSynchronize());
+  CUDA_DRIVER_CALL(cuMemcpyDtoH(counters.data(), ptr, counters.size() * sizeof(uint64_t)));
+  if (reset) {
+    CUDA_DRIVER_CALL(cuMemsetD32(ptr, 0, counters.size() * 2));
+  }
+  for (int64_t id = 0; id < profiling::kMaxProfiledLoops; ++id) {
+    if (counters[2 * id] != 0) {
+      result.push_back(ShapeTuple({id, static_cast<int64_t>(counters[2 * id]),
+                                   static_cast<int64_t>(counters[2 * id + 1])}));
+    }
+  }
+  return result;
+}
+
+void CUDALaunchSequence::Record(CUfunction func, const ThreadWorkLoad& wl, void** args,
+                                const std::vector<size_t>& arg_sizes) {
+  launches_.push_back(KernelLaunch{func, wl, params_.size()});
+  for (size_t i = 0; i < arg_sizes.size(); ++i) {
+    uint64_t param = 0;
+    std::memcpy(&param, args[i], arg_sizes[i]);
+    params_.push_back(param);
+  }
+  param_addrs_.clear();
+}
+
+void CUDALaunchSequence::Launch(CUstream stream) {
+  if (param_addrs_.size() != params_.size()) {
+    // The addresses are taken once the parameters stop moving.
+    for (uint64_t& param : params_) {
+      param_addrs_.push_back(&param);
+    }
+  }
+  for (const KernelLaunch& launch : launches_) {
+    const ThreadWorkLoad& wl = launch.wl;
+    CUDA_DRIVER_CALL(cuLaunchKernel(launch.func, wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2),
+                                    wl.block_dim(0), wl.block_dim(1), wl.block_dim(2),
+                                    wl.dyn_shmem_size, stream,
+                                    param_addrs_.data() + launch.param_begin, nullptr));
+  }
+}
+
 Module CUDAModuleCreate(std::string data, std::string fmt,
                         std::unordered_map<std::string, FunctionInfo> fmap,
                         std::string cuda_source) {
@@ -267,6 +407,16 @@ Module CUDAModuleCreate(std::string data, std::string fmt,
   return Module(n);
 }
 
+// Create a module loaded from a file or a binary, which is preloaded if enabled.
+Module CUDAModuleCreateLoaded(std::string data, std::string fmt,
+                              std::unordered_map<std::string, FunctionInfo> fmap) {
+  auto n = make_object<CUDAModuleNode>(data, fmt, fmap, std::string());
+  if (PreloadModulesEnabled()) {
+    n->StartPreload();
+  }
+  return Module(n);
+}
+
 // Load module from module.
 Module CUDAModuleLoadFile(const std::string& file_name, const String& format) {
   std::string data;
@@ -275,7 +425,7 @@ Module CUDAModuleLoadFile(const std::string& file_name, const String& format) {
   std::string meta_file = GetMetaFilePath(file_name);
   LoadBinaryFromFile(file_name, &data);
   LoadMetaDataFromFile(meta_file, &fmap);
-  return CUDAModuleCreate(data, fmt, fmap, std::string());
+  return CUDAModuleCreateLoaded(data, fmt, fmap);
 }
 
 Module CUDAModuleLoadBinary(void* strm) {
@@ -286,7 +436,7 @@ Module CUDAModuleLoadBinary(void* strm) {
   stream->Read(&fmt);
   stream->Read(&fmap);
   stream->Read(&data);
-  return CUDAModuleCreate(data, fmt, fmap, std::string());
+  return CUDAModuleCreateLoaded(data, fmt, fmap);
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_cubin").set_body_typed(CUDAModuleLoadFile);
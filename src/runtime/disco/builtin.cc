@@ -21,6 +21,7 @@
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/vm.h>
@@ -80,29 +81,163 @@ const PackedFunc& GetCCLFunc(const char* name) {
 }
 
 void AllReduce(NDArray send, ReduceKind reduce_kind, NDArray recv) {
+  NVTXScopedRange scope("Disco: allreduce");
   GetCCLFunc("allreduce")(send, static_cast<int>(reduce_kind), recv);
 }
 
-void AllGather(NDArray send, NDArray recv) { GetCCLFunc("allgather")(send, recv); }
+void AllGather(NDArray send, NDArray recv) {
+  NVTXScopedRange scope("Disco: allgather");
+  GetCCLFunc("allgather")(send, recv);
+}
+
+void AllReduceGroup(NDArray send, ReduceKind reduce_kind, String group, NDArray recv) {
+  NVTXScopedRange scope("Disco: allreduce_group");
+  GetCCLFunc("allreduce_group")(send, static_cast<int>(reduce_kind), group, recv);
+}
+
+void AllGatherGroup(NDArray send, String group, NDArray recv) {
+  NVTXScopedRange scope("Disco: allgather_group");
+  GetCCLFunc("allgather_group")(send, group, recv);
+}
+
+ObjectRef AllReduceAsync(NDArray send, ReduceKind reduce_kind, NDArray recv) {
+  return GetCCLFunc("allreduce_async")(send, static_cast<int>(reduce_kind), recv);
+}
+
+ObjectRef AllGatherAsync(NDArray send, NDArray recv) {
+  return GetCCLFunc("allgather_async")(send, recv);
+}
+
+void WaitCCL(ObjectRef handle) {
+  NVTXScopedRange scope("Disco: wait");
+  GetCCLFunc("wait")(handle);
+}
 
 TVM_DLL void BroadcastFromWorker0(NDArray send, NDArray recv) {
+  NVTXScopedRange scope("Disco: broadcast_from_worker0");
   GetCCLFunc("broadcast_from_worker0")(send, recv);
 }
 
 TVM_DLL void ScatterFromWorker0(Optional<NDArray> send, NDArray recv) {
+  NVTXScopedRange scope("Disco: scatter_from_worker0");
   GetCCLFunc("scatter_from_worker0")(send, recv);
 }
 
 void GatherToWorker0(NDArray send, Optional<NDArray> recv) {
+  NVTXScopedRange scope("Disco: gather_to_worker0");
   GetCCLFunc("gather_to_worker0")(send, recv);
 }
 
-void RecvFromWorker0(NDArray buffer) { GetCCLFunc("recv_from_worker0")(buffer); }
+void RecvFromWorker0(NDArray buffer) {
+  NVTXScopedRange scope("Disco: recv_from_worker0");
+  GetCCLFunc("recv_from_worker0")(buffer);
+}
+
+void InitWorkerGroups(int num_groups) {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  CHECK(num_groups > 0 && worker->num_workers % num_groups == 0)
+      << "ValueError: The number of groups must divide the number of workers "
+      << worker->num_workers << ", but got " << num_groups;
+  worker->num_groups = num_groups;
+  GetCCLFunc("init_groups")(num_groups);
+}
+
+void InitCCLGroup(String name, IntTuple group_sizes, IntTuple ranks) {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  // The subgroup and the position within it of each worker, -1 if it is in none.
+  std::vector<int64_t> colors(worker->num_workers, -1);
+  std::vector<int64_t> keys(worker->num_workers, -1);
+  int64_t total = 0;
+  for (int64_t size : group_sizes) {
+    CHECK_GT(size, 0) << "ValueError: The groups of `" << name << "` must not be empty";
+    total += size;
+  }
+  CHECK_EQ(total, static_cast<int64_t>(ranks.size()))
+      << "ValueError: The sizes of the groups of `" << name << "` sum to " << total << ", but got "
+      << ranks.size() << " ranks";
+  int64_t pos = 0;
+  for (int64_t color = 0; color < static_cast<int64_t>(group_sizes.size()); ++color) {
+    for (int64_t key = 0; key < group_sizes[color]; ++key, ++pos) {
+      int64_t rank = ranks[pos];
+      CHECK(0 <= rank && rank < worker->num_workers)
+          << "ValueError: The rank " << rank << " in the groups of `" << name
+          << "` is out of range for " << worker->num_workers << " workers";
+      CHECK_EQ(colors[rank], -1) << "ValueError: The rank " << rank
+                                 << " appears more than once in the groups of `" << name << "`";
+      colors[rank] = color;
+      keys[rank] = key;
+    }
+  }
+  GetCCLFunc("init_ccl_group")(name, IntTuple(colors), IntTuple(keys));
+}
+
+void SendToWorker(NDArray buffer, int receiver_id) {
+  NVTXScopedRange scope("Disco: send_to_worker");
+  GetCCLFunc("send_to_worker")(buffer, receiver_id);
+}
+
+void RecvFromWorker(NDArray buffer, int sender_id) {
+  NVTXScopedRange scope("Disco: recv_from_worker");
+  GetCCLFunc("recv_from_worker")(buffer, sender_id);
+}
+
+void SendToNextGroup(NDArray buffer) {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  int group_size = worker->num_workers / worker->num_groups;
+  CHECK_LT(worker->worker_id + group_size, worker->num_workers)
+      << "ValueError: The last group has no next group to send to";
+  SendToWorker(buffer, worker->worker_id + group_size);
+}
+
+void RecvFromPrevGroup(NDArray buffer) {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  int group_size = worker->num_workers / worker->num_groups;
+  CHECK_GE(worker->worker_id - group_size, 0)
+      << "ValueError: The first group has no previous group to receive from";
+  RecvFromWorker(buffer, worker->worker_id - group_size);
+}
 
 int WorkerId() { return DiscoWorker::ThreadLocal()->worker_id; }
 
+int WorkerGroup() {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  return worker->worker_id / (worker->num_workers / worker->num_groups);
+}
+
+/*!
+ * \brief Run one tick of a pipeline over the worker groups, where group `g` is stage `g` and
+ * processes micro-batch `tick - g`. A stage receives its input from the previous stage, calls
+ * `fstage(micro_batch, input, output)` and sends the output to the next stage. The first stage
+ * gets None as input and the last stage None as output, which read and write the micro-batch
+ * themselves.
+ */
+void PipelineStageStep(PackedFunc fstage, int tick, int num_micro_batches, NDArray recv,
+                       NDArray send) {
+  int num_stages = DiscoWorker::ThreadLocal()->num_groups;
+  int stage = WorkerGroup();
+  int micro_batch = tick - stage;
+  if (micro_batch < 0 || micro_batch >= num_micro_batches) {
+    // The stage is in the fill or drain bubble of the pipeline.
+    return;
+  }
+  Optional<NDArray> input = NullOpt;
+  Optional<NDArray> output = NullOpt;
+  if (stage > 0) {
+    RecvFromPrevGroup(recv);
+    input = recv;
+  }
+  if (stage + 1 < num_stages) {
+    output = send;
+  }
+  fstage(micro_batch, input, output);
+  if (stage + 1 < num_stages) {
+    SendToNextGroup(send);
+  }
+}
+
 void SyncWorker() {
   if (DiscoWorker::ThreadLocal()->ccl != "") {
+    NVTXScopedRange scope("Disco: sync_worker");
     GetCCLFunc("sync_worker")();
   }
 }
@@ -126,16 +261,46 @@ TVM_REGISTER_GLOBAL("runtime.disco.allreduce")
       AllReduce(send, static_cast<ReduceKind>(kind), recv);
     });
 TVM_REGISTER_GLOBAL("runtime.disco.allgather").set_body_typed(AllGather);
+TVM_REGISTER_GLOBAL("runtime.disco.allreduce_group")
+    .set_body_typed([](NDArray send, ShapeTuple reduce_kind, String group, NDArray recv) {
+      int kind = IntegerFromShapeTuple(reduce_kind);
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      AllReduceGroup(send, static_cast<ReduceKind>(kind), group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco.allgather_group").set_body_typed(AllGatherGroup);
+TVM_REGISTER_GLOBAL("runtime.disco.allreduce_async")
+    .set_body_typed([](NDArray send, ShapeTuple reduce_kind, NDArray recv) {
+      int kind = IntegerFromShapeTuple(reduce_kind);
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      return AllReduceAsync(send, static_cast<ReduceKind>(kind), recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco.allgather_async").set_body_typed(AllGatherAsync);
+// The buffers of the collective operation can be passed after the handle, which keeps them
+// alive until the wait in the eyes of the memory planner.
+TVM_REGISTER_GLOBAL("runtime.disco.wait").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK_GE(args.size(), 1) << "ValueError: runtime.disco.wait expects the handle to wait for";
+  WaitCCL(args[0]);
+});
 TVM_REGISTER_GLOBAL("runtime.disco.broadcast_from_worker0").set_body_typed(BroadcastFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.scatter_from_worker0").set_body_typed(ScatterFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.gather_to_worker0").set_body_typed(GatherToWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.recv_from_worker0").set_body_typed(RecvFromWorker0);
+TVM_REGISTER_GLOBAL("runtime.disco.init_groups").set_body_typed(InitWorkerGroups);
+TVM_REGISTER_GLOBAL("runtime.disco.init_ccl_group").set_body_typed(InitCCLGroup);
+TVM_REGISTER_GLOBAL("runtime.disco.send_to_worker").set_body_typed(SendToWorker);
+TVM_REGISTER_GLOBAL("runtime.disco.recv_from_worker").set_body_typed(RecvFromWorker);
+TVM_REGISTER_GLOBAL("runtime.disco.send_to_next_group").set_body_typed(SendToNextGroup);
+TVM_REGISTER_GLOBAL("runtime.disco.recv_from_prev_group").set_body_typed(RecvFromPrevGroup);
+TVM_REGISTER_GLOBAL("runtime.disco.pipeline_stage_step").set_body_typed(PipelineStageStep);
 TVM_REGISTER_GLOBAL("runtime.disco.worker_id").set_body_typed([]() -> ShapeTuple {
   return ShapeTuple({WorkerId()});
 });
 TVM_REGISTER_GLOBAL("runtime.disco.worker_rank").set_body_typed([]() -> int64_t {
   return WorkerId();
 });
+TVM_REGISTER_GLOBAL("runtime.disco.worker_group").set_body_typed([]() -> int64_t {
+  return WorkerGroup();
+});
 TVM_REGISTER_GLOBAL("runtime.disco.device").set_body_typed([]() -> Device {
   return DiscoWorker::ThreadLocal()->default_device;
 });
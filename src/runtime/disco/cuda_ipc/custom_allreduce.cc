@@ -22,6 +22,9 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
+#include <unordered_map>
+
 #include "../../../../3rdparty/tensorrt_llm/custom_allreduce_kernels.h"
 #include "../nccl/nccl_context.h"
 
@@ -56,6 +59,45 @@ inline bool CanApplyTwoShotAllReduce(int64_t num_elements, DLDataType dtype, int
   return (num_elements / num_workers) % (16 / ((dtype.bits * dtype.lanes + 7) / 8)) == 0;
 }
 
+/*! \brief The crossover sizes set by the user for each world size. */
+struct CrossoverTable {
+  std::mutex mutex;
+  std::unordered_map<int, tensorrt_llm::AllReduceCrossover> table;
+
+  static CrossoverTable* Global() {
+    static CrossoverTable* inst = new CrossoverTable();
+    return inst;
+  }
+};
+
+/*! \brief Get the crossover sizes used by the AUTO strategy for the given world size. */
+tensorrt_llm::AllReduceCrossover GetCrossover(int world_size) {
+  CrossoverTable* crossover = CrossoverTable::Global();
+  std::lock_guard<std::mutex> lock(crossover->mutex);
+  auto it = crossover->table.find(world_size);
+  if (it != crossover->table.end()) {
+    return it->second;
+  }
+  return tensorrt_llm::DefaultCrossover(world_size);
+}
+
+/*!
+ * \brief Override the message sizes up to which the AUTO strategy picks each custom kernel.
+ * \param world_size The number of workers the crossover applies to.
+ * \param oneshot_max_bytes The largest message size, in bytes, that uses the one-shot kernel.
+ * \param twoshot_max_bytes The largest message size, in bytes, that uses the two-shot kernel.
+ * Larger messages are reduced by NCCL.
+ */
+void SetCrossover(int world_size, int64_t oneshot_max_bytes, int64_t twoshot_max_bytes) {
+  CHECK(oneshot_max_bytes >= 0 && oneshot_max_bytes <= twoshot_max_bytes)
+      << "ValueError: Expected 0 <= oneshot_max_bytes <= twoshot_max_bytes, but got "
+      << oneshot_max_bytes << " and " << twoshot_max_bytes;
+  CrossoverTable* crossover = CrossoverTable::Global();
+  std::lock_guard<std::mutex> lock(crossover->mutex);
+  crossover->table[world_size] = {static_cast<size_t>(oneshot_max_bytes),
+                                  static_cast<size_t>(twoshot_max_bytes)};
+}
+
 /*!
  * \brief Customized all-reduce kernel backed by CUDA IPC memory.
  * \param send The input tensor of all-reduce.
@@ -65,42 +107,45 @@ inline bool CanApplyTwoShotAllReduce(int64_t num_elements, DLDataType dtype, int
 void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
   int64_t num_elements = TensorSize(send);
   nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  int num_workers = ctx->worker->num_workers;
 
   tensorrt_llm::AllReduceStrategyType strategy_ =
       static_cast<tensorrt_llm::AllReduceStrategyType>(strategy);
   if (strategy_ == tensorrt_llm::AllReduceStrategyType::AUTO) {
     strategy_ = tensorrt_llm::SelectImplementation(
-        num_elements * ((send->dtype.bits * send->dtype.lanes + 7) / 8), ctx->worker->num_workers);
+        num_elements * ((send->dtype.bits * send->dtype.lanes + 7) / 8), GetCrossover(num_workers));
   }
 
-  if (strategy_ == tensorrt_llm::AllReduceStrategyType::RING ||
+  if (strategy_ == tensorrt_llm::AllReduceStrategyType::RING || ctx->worker->num_groups != 1 ||
+      !tensorrt_llm::IsSupportedWorldSize(num_workers) ||
+      !tensorrt_llm::IsSupportedDataType(send->dtype) ||
       !CanApplyCustomAllReduce(num_elements, send->dtype)) {
     // Dispatch to nccl AllReduce if the customized all-reduce cannot apply.
     deviceStream_t stream = ctx->GetDefaultStream();
     NCCL_CALL(ncclAllReduce(send->data, recv->data, num_elements,
                             /*datatype=*/nccl::AsNCCLDataType(DataType(send->dtype)),
-                            /*op=*/ncclSum, ctx->comm, stream));
+                            /*op=*/ncclSum, ctx->GetGroupComm(), stream));
     return;
   }
 
   // Initialize the all-reduce kernel arguments.
   tensorrt_llm::AllReduceParams params;
-  params.ranks_per_node = ctx->worker->num_workers;
+  params.ranks_per_node = num_workers;
   params.rank = ctx->worker->worker_id;
   params.local_rank = ctx->worker->worker_id;
   CUDAIPCMemory ipc_memory = CUDAIPCMemory::GetIPCMemoryFromDevicePtr(send->data);
   params.barrier_flag = ipc_memory->barrier_flag++;
-  for (int i = 0; i < ctx->worker->num_workers; ++i) {
+  for (int i = 0; i < num_workers; ++i) {
     params.peer_comm_buffer_ptrs[i] = ipc_memory->remote_data[i];
   }
-  for (int i = 0; i < ctx->worker->num_workers; ++i) {
+  for (int i = 0; i < num_workers; ++i) {
     params.peer_barrier_ptrs_in[i] = reinterpret_cast<uint32_t*>(ipc_memory->barrier_in[i]);
   }
-  for (int i = 0; i < ctx->worker->num_workers; ++i) {
+  for (int i = 0; i < num_workers; ++i) {
     params.peer_barrier_ptrs_out[i] = reinterpret_cast<uint32_t*>(ipc_memory->barrier_out[i]);
   }
 
-  if (!CanApplyTwoShotAllReduce(num_elements, send->dtype, ctx->worker->num_workers)) {
+  if (!CanApplyTwoShotAllReduce(num_elements, send->dtype, num_workers)) {
     // Two-shot all-reduce does not support this case.
     // So we fallback to the one-shot strategy.
     strategy_ = tensorrt_llm::AllReduceStrategyType::ONESHOT;
@@ -110,7 +155,39 @@ void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
                                 ctx->GetDefaultStream());
 }
 
+/*!
+ * \brief Measure the all-reduce with the given strategy on the default stream.
+ * \param send The input tensor of all-reduce, allocated in CUDA IPC memory.
+ * \param strategy The all-reduce strategy. See AllReduceStrategyType for detail.
+ * \param recv The output tensor of all-reduce.
+ * \param num_iters The number of timed runs, after one warm-up run.
+ * \return The average latency in microseconds.
+ */
+double BenchmarkCustomAllReduce(DLTensor* send, int strategy, DLTensor* recv, int num_iters) {
+  CHECK_GT(num_iters, 0) << "ValueError: num_iters must be positive";
+  cudaStream_t stream = nccl::CCLThreadLocalContext::Get()->GetDefaultStream();
+  CustomAllReduce(send, strategy, recv);
+  cudaEvent_t start, stop;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&stop));
+  CUDA_CALL(cudaEventRecord(start, stream));
+  for (int i = 0; i < num_iters; ++i) {
+    CustomAllReduce(send, strategy, recv);
+  }
+  CUDA_CALL(cudaEventRecord(stop, stream));
+  CUDA_CALL(cudaEventSynchronize(stop));
+  float elapsed_ms = 0;
+  CUDA_CALL(cudaEventElapsedTime(&elapsed_ms, start, stop));
+  CUDA_CALL(cudaEventDestroy(start));
+  CUDA_CALL(cudaEventDestroy(stop));
+  return static_cast<double>(elapsed_ms) * 1000.0 / num_iters;
+}
+
 TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.custom_allreduce").set_body_typed(CustomAllReduce);
+TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.benchmark_custom_allreduce")
+    .set_body_typed(BenchmarkCustomAllReduce);
+TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.set_custom_allreduce_crossover")
+    .set_body_typed(SetCrossover);
 
 }  // namespace cuda_ipc
 }  // namespace nccl
@@ -27,7 +27,9 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/ndarray_cache_support.h>
 
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -159,8 +161,24 @@ class ShardLoaderObj : public Object {
   mutable const FileRecord* current_file_;
   /*! \brief The context of the current file to be loaded from */
   mutable std::string current_file_stream_;
+  /*! \brief The order in which the files are going to be opened, when it is known */
+  mutable std::vector<const FileRecord*> file_schedule_;
+  /*! \brief The position in `file_schedule_` of the next file to be prefetched */
+  mutable size_t next_scheduled_file_ = 0;
+  /*! \brief The file being read in the background, and the pending content of it */
+  mutable const FileRecord* prefetch_file_ = nullptr;
+  mutable std::future<std::string> prefetch_stream_;
 
  private:
+  /*!
+   * \brief Set the order in which the given parameters are going to be loaded, so that
+   * the next file is read in the background while the current one is being loaded.
+   */
+  void ScheduleLoads(const std::vector<int>& weight_indices) const;
+
+  /*! \brief Make `file` the current file, reading it unless it has been prefetched */
+  void OpenFile(const FileRecord* file) const;
+
   /*! \brief Load the i-th parameter without post-processing
    *
    * This function should not be called externally, as it does not
@@ -239,6 +257,47 @@ std::string GetSiblingPath(const std::string& path, const std::string& filename)
   LOG(FATAL) << "ValueError: Cannot find the parent directory: " << path;
 }
 
+void ShardLoaderObj::ScheduleLoads(const std::vector<int>& weight_indices) const {
+  prefetch_stream_ = std::future<std::string>();
+  file_schedule_.clear();
+  next_scheduled_file_ = 0;
+  for (int weight_index : weight_indices) {
+    const FileRecord* file = param_info_.at(weight_index).file;
+    if (file_schedule_.empty() || file_schedule_.back() != file) {
+      file_schedule_.push_back(file);
+    }
+  }
+}
+
+void ShardLoaderObj::OpenFile(const FileRecord* file) const {
+  if (file == current_file_) {
+    return;
+  }
+  current_file_ = file;
+  if (prefetch_stream_.valid() && prefetch_file_ == file) {
+    current_file_stream_ = prefetch_stream_.get();
+  } else {
+    // Drop a prefetch that does not match, which waits for it to finish.
+    prefetch_stream_ = std::future<std::string>();
+    std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
+    LoadBinaryFromFile(file_name, &this->current_file_stream_);
+  }
+  // Move past the current file in the schedule, and read the file after it in the background.
+  auto it = std::find(file_schedule_.begin() + next_scheduled_file_, file_schedule_.end(), file);
+  if (it != file_schedule_.end()) {
+    next_scheduled_file_ = it - file_schedule_.begin() + 1;
+  }
+  if (next_scheduled_file_ < file_schedule_.size()) {
+    prefetch_file_ = file_schedule_[next_scheduled_file_];
+    std::string file_name = GetSiblingPath(this->metadata_.path, prefetch_file_->data_path);
+    prefetch_stream_ = std::async(std::launch::async, [file_name]() {
+      std::string data;
+      LoadBinaryFromFile(file_name, &data);
+      return data;
+    });
+  }
+}
+
 NDArray ShardLoaderObj::LoadParamOnWorker0(int weight_index) const {
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
   int worker_id = worker->worker_id;
@@ -249,11 +308,7 @@ NDArray ShardLoaderObj::LoadParamOnWorker0(int weight_index) const {
   const FileRecord* file = param_info.file;
 
   auto load = [this, param, device, file]() {
-    if (file != current_file_) {
-      current_file_ = file;
-      std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-      LoadBinaryFromFile(file_name, &this->current_file_stream_);
-    }
+    this->OpenFile(file);
     return param->Load(device, &this->current_file_stream_);
   };
 
@@ -296,11 +351,7 @@ NDArray ShardLoaderObj::LoadDirect(int weight_index) const {
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
   Device device = worker->default_device;
 
-  if (file != current_file_) {
-    current_file_ = file;
-    std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-    LoadBinaryFromFile(file_name, &this->current_file_stream_);
-  }
+  OpenFile(file);
   return param->Load(device, &this->current_file_stream_);
 }
 
@@ -346,14 +397,23 @@ NDArray ShardLoaderObj::Load(int weight_index) const {
 
 Array<NDArray> ShardLoaderObj::LoadAll() const {
   int n = static_cast<int>(param_info_.size());
-  Array<NDArray> shards;
-  shards.reserve(n);
+  std::vector<int> shard_ids;
+  shard_ids.reserve(n);
   for (int i = 0; i < n; ++i) {
     std::string param_name = "param_" + std::to_string(i);
     ICHECK(this->param_name_to_index_.count(param_name));
-    int shard_id = this->param_name_to_index_.at(param_name);
+    shard_ids.push_back(this->param_name_to_index_.at(param_name));
+  }
+  // Only worker 0 reads the files, the other workers receive their shards from it.
+  if (DiscoWorker::ThreadLocal()->worker_id == 0) {
+    ScheduleLoads(shard_ids);
+  }
+  Array<NDArray> shards;
+  shards.reserve(n);
+  for (int shard_id : shard_ids) {
     shards.push_back(this->Load(shard_id));
   }
+  ScheduleLoads({});
   return shards;
 }
 
@@ -389,8 +449,8 @@ Array<NDArray> ShardLoaderObj::LoadAllPresharded() const {
   size_t num_workers = static_cast<size_t>(worker->num_workers);
   size_t num_params = param_info_.size() / num_workers;
 
-  Array<NDArray> params;
-  params.reserve(num_params);
+  std::vector<int> param_ids;
+  param_ids.reserve(num_params);
   for (size_t i_param = 0; i_param < num_params; ++i_param) {
     std::string param_name = static_cast<const std::stringstream&>(
                                  std::stringstream() << "param_" << i_param << "_shard-"
@@ -400,9 +460,15 @@ Array<NDArray> ShardLoaderObj::LoadAllPresharded() const {
     auto it = param_name_to_index_.find(param_name);
     CHECK(it != param_name_to_index_.end())
         << "Parameter " << param_name << " was not found in the parameter set";
-    int param_id = this->param_name_to_index_.at(param_name);
+    param_ids.push_back(it->second);
+  }
+  ScheduleLoads(param_ids);
+  Array<NDArray> params;
+  params.reserve(num_params);
+  for (int param_id : param_ids) {
     params.push_back(this->LoadDirect(param_id));
   }
+  ScheduleLoads({});
   return params;
 }
 
@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/disco/mscclpp/mscclpp.cc
+ * \brief The "mscclpp" CCL of disco. The allreduce of small messages runs the proxy-free LL
+ * protocol kernel of MSCCL++, which has a lower latency than NCCL, and all the other operations,
+ * as well as the allreduce of larger messages, run on NCCL.
+ */
+#include <msccl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#include "../nccl/nccl_context.h"
+
+namespace tvm {
+namespace runtime {
+namespace msccl {
+
+#define MSCCL_CALL(cmd)                                         \
+  do {                                                          \
+    auto r = (cmd);                                             \
+    if (r != mscclSuccess) {                                    \
+      LOG(FATAL) << "mscclppError: " << mscclGetErrorString(r); \
+    }                                                           \
+  } while (0)
+
+/*! \brief The largest message the LL protocol kernel of MSCCL++ reduces. */
+constexpr int64_t kMSCCLMaxBytes = 1 << 24;
+
+/*!
+ * \brief The largest message which is reduced by MSCCL++ rather than NCCL. The LL protocol
+ * trades bandwidth for latency, so NCCL is faster for larger messages.
+ */
+std::atomic<int64_t> allreduce_max_bytes{1 << 20};
+
+struct MSCCLThreadLocalContext {
+  mscclComm_t comm = nullptr;
+
+  ~MSCCLThreadLocalContext() {
+    if (comm) {
+      MSCCL_CALL(mscclCommDestroy(comm));
+      comm = nullptr;
+    }
+  }
+
+  static MSCCLThreadLocalContext* Get() {
+    thread_local static MSCCLThreadLocalContext ctx;
+    return &ctx;
+  }
+};
+
+/*! \brief Call the operation of the same name of NCCL, which serves it for MSCCL++. */
+PackedFunc ForwardToNCCL(std::string name) {
+  return PackedFunc([name = "runtime.disco.nccl." + name](TVMArgs args, TVMRetValue* rv) {
+    const PackedFunc* pf = Registry::Get(name);
+    ICHECK(pf != nullptr) << "Cannot find " << name;
+    pf->CallPacked(args, rv);
+  });
+}
+
+void InitCCL(Session sess, IntTuple device_ids) {
+  DRef func = sess->GetGlobalFunc("runtime.disco.mscclpp.init_ccl_per_worker");
+  DLOG(INFO) << "Initializing mscclpp with devices: " << device_ids;
+  ncclUniqueId nccl_id;
+  NCCL_CALL(ncclGetUniqueId(&nccl_id));
+  mscclUniqueId msccl_id;
+  MSCCL_CALL(mscclGetUniqueId(&msccl_id));
+  TVMByteArray nccl_array{nccl_id.internal, NCCL_UNIQUE_ID_BYTES};
+  TVMByteArray msccl_array{msccl_id.internal, MSCCL_UNIQUE_ID_BYTES};
+  sess->CallPacked(func, device_ids, nccl_array, msccl_array);
+}
+
+void InitCCLPerWorker(IntTuple device_ids, std::string nccl_id_bytes,
+                      std::string msccl_id_bytes) {
+  const PackedFunc* init_nccl = Registry::Get("runtime.disco.nccl.init_ccl_per_worker");
+  ICHECK(init_nccl != nullptr);
+  (*init_nccl)(device_ids, TVMByteArray{nccl_id_bytes.data(), nccl_id_bytes.size()});
+
+  CHECK_EQ(msccl_id_bytes.size(), MSCCL_UNIQUE_ID_BYTES)
+      << "ValueError: The length of unique_id must be " << MSCCL_UNIQUE_ID_BYTES << ", but got "
+      << msccl_id_bytes.size() << ".";
+  MSCCLThreadLocalContext* ctx = MSCCLThreadLocalContext::Get();
+  CHECK(!ctx->comm) << "Cannot initialize mscclpp, the previous thread-global comm still exists, "
+                    << "and has not been destructed";
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  worker->ccl = "mscclpp";
+  mscclUniqueId id;
+  std::memcpy(id.internal, msccl_id_bytes.data(), MSCCL_UNIQUE_ID_BYTES);
+  MSCCL_CALL(mscclCommInitRank(&ctx->comm, worker->num_workers, id, worker->worker_id));
+}
+
+/*! \return The MSCCL++ type of the dtype, if the LL protocol kernel reduces it. */
+bool AsMSCCLDataType(DataType dtype, mscclDataType_t* out) {
+  if (dtype == DataType::Float(16)) {
+    *out = mscclFloat16;
+  } else if (dtype == DataType::Float(32)) {
+    *out = mscclFloat32;
+  } else if (dtype == DataType::Int(32)) {
+    *out = mscclInt32;
+  } else if (dtype == DataType::UInt(32)) {
+    *out = mscclUint32;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void AllReduce(NDArray send, int kind, NDArray recv) {
+  nccl::CCLThreadLocalContext* nccl_ctx = nccl::CCLThreadLocalContext::Get();
+  int num_workers = nccl_ctx->worker->num_workers;
+  DataType dtype = send.DataType();
+  int64_t numel = send.Shape()->Product();
+  int64_t num_bytes = numel * ((dtype.bits() * dtype.lanes() + 7) / 8);
+  mscclDataType_t msccl_dtype;
+  // The kernel reduces the whole world, and splits the message into 8-byte packets evenly over
+  // the workers. All the workers see the same message, so they make the same choice.
+  if (kind == static_cast<int>(ReduceKind::kSum) && num_workers > 1 &&
+      nccl_ctx->group_comm == nullptr && AsMSCCLDataType(dtype, &msccl_dtype) &&
+      num_bytes <= std::min(allreduce_max_bytes.load(), kMSCCLMaxBytes) &&
+      num_bytes % (8 * num_workers) == 0) {
+    MSCCL_CALL(mscclAllReduce(send->data, recv->data, numel, msccl_dtype, mscclSum,
+                              MSCCLThreadLocalContext::Get()->comm,
+                              nccl_ctx->GetDefaultStream()));
+    return;
+  }
+  const PackedFunc* nccl_allreduce = Registry::Get("runtime.disco.nccl.allreduce");
+  ICHECK(nccl_allreduce != nullptr);
+  (*nccl_allreduce)(send, kind, recv);
+}
+
+void SetAllReduceMaxBytes(int64_t max_bytes) {
+  CHECK_LE(max_bytes, kMSCCLMaxBytes) << "ValueError: MSCCL++ reduces messages of at most "
+                                      << kMSCCLMaxBytes << " bytes, but got " << max_bytes;
+  allreduce_max_bytes = max_bytes;
+}
+
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.init_ccl").set_body_typed(InitCCL);
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.init_ccl_per_worker").set_body_typed(InitCCLPerWorker);
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.allreduce").set_body_typed(AllReduce);
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.set_allreduce_max_bytes")
+    .set_body_typed(SetAllReduceMaxBytes);
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.allgather").set_body(ForwardToNCCL("allgather"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.allreduce_group")
+    .set_body(ForwardToNCCL("allreduce_group"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.allgather_group")
+    .set_body(ForwardToNCCL("allgather_group"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.allreduce_async")
+    .set_body(ForwardToNCCL("allreduce_async"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.allgather_async")
+    .set_body(ForwardToNCCL("allgather_async"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.wait").set_body(ForwardToNCCL("wait"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.init_groups").set_body(ForwardToNCCL("init_groups"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.init_ccl_group")
+    .set_body(ForwardToNCCL("init_ccl_group"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.send_to_worker")
+    .set_body(ForwardToNCCL("send_to_worker"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.recv_from_worker")
+    .set_body(ForwardToNCCL("recv_from_worker"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.broadcast_from_worker0")
+    .set_body(ForwardToNCCL("broadcast_from_worker0"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.scatter_from_worker0")
+    .set_body(ForwardToNCCL("scatter_from_worker0"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.gather_to_worker0")
+    .set_body(ForwardToNCCL("gather_to_worker0"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.recv_from_worker0")
+    .set_body(ForwardToNCCL("recv_from_worker0"));
+TVM_REGISTER_GLOBAL("runtime.disco.mscclpp.sync_worker").set_body(ForwardToNCCL("sync_worker"));
+
+}  // namespace msccl
+}  // namespace runtime
+}  // namespace tvm
@@ -18,6 +18,7 @@
  */
 
 #include <cstring>
+#include <functional>
 #include <mutex>
 #include <sstream>
 #include <vector>
@@ -99,23 +100,89 @@ void InitCCLPerWorker(IntTuple device_ids, std::string unique_id_bytes) {
   NCCL_CALL(ncclCommInitRank(&ctx->comm, worker->num_workers, id, worker->worker_id));
 }
 
-void AllReduce(NDArray send, ReduceKind reduce_kind, NDArray recv) {
+void AllReduceOnComm(NDArray send, ReduceKind reduce_kind, NDArray recv, ncclComm_t comm) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ShapeTuple shape = send.Shape();
   int64_t numel = shape->Product();
   deviceStream_t stream = ctx->GetDefaultStream();
   NCCL_CALL(ncclAllReduce(send->data, recv->data, numel,
                           /*datatype=*/AsNCCLDataType(DataType(send->dtype)),
-                          /*op=*/AsNCCLRedOp(reduce_kind), ctx->comm, stream));
+                          /*op=*/AsNCCLRedOp(reduce_kind), comm, stream));
 }
 
-void AllGather(NDArray send, NDArray recv) {
+void AllGatherOnComm(NDArray send, NDArray recv, ncclComm_t comm) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ShapeTuple shape = send.Shape();
   int64_t numel = shape->Product();
   deviceStream_t stream = ctx->GetDefaultStream();
   NCCL_CALL(ncclAllGather(send->data, recv->data, numel,
-                          /*datatype=*/AsNCCLDataType(DataType(send->dtype)), ctx->comm, stream));
+                          /*datatype=*/AsNCCLDataType(DataType(send->dtype)), comm, stream));
+}
+
+void AllReduce(NDArray send, ReduceKind reduce_kind, NDArray recv) {
+  AllReduceOnComm(send, reduce_kind, recv, CCLThreadLocalContext::Get()->GetGroupComm());
+}
+
+void AllGather(NDArray send, NDArray recv) {
+  AllGatherOnComm(send, recv, CCLThreadLocalContext::Get()->GetGroupComm());
+}
+
+void AllReduceGroup(NDArray send, ReduceKind reduce_kind, String group, NDArray recv) {
+  AllReduceOnComm(send, reduce_kind, recv, CCLThreadLocalContext::Get()->GetNamedComm(group));
+}
+
+void AllGatherGroup(NDArray send, String group, NDArray recv) {
+  AllGatherOnComm(send, recv, CCLThreadLocalContext::Get()->GetNamedComm(group));
+}
+
+TVM_REGISTER_OBJECT_TYPE(CCLEventObj);
+
+/*!
+ * \brief Run a collective operation on the communication stream, after the work enqueued on
+ * the compute stream so far, and return an event recorded after it.
+ */
+ObjectRef LaunchAsync(Array<NDArray> buffers,
+                      const std::function<void(deviceStream_t stream)>& flaunch) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  deviceStream_t compute_stream = ctx->GetDefaultStream();
+  deviceStream_t comm_stream = ctx->GetCommStream();
+  ObjectPtr<CCLEventObj> ready = make_object<CCLEventObj>();
+  EventCreate(&ready->event);
+  EventRecord(ready->event, compute_stream);
+  StreamWaitEvent(comm_stream, ready->event);
+  flaunch(comm_stream);
+  ObjectPtr<CCLEventObj> done = make_object<CCLEventObj>();
+  EventCreate(&done->event);
+  EventRecord(done->event, comm_stream);
+  done->buffers = std::move(buffers);
+  return ObjectRef(done);
+}
+
+ObjectRef AllReduceAsync(NDArray send, ReduceKind reduce_kind, NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int64_t numel = send.Shape()->Product();
+  return LaunchAsync({send, recv}, [&](deviceStream_t stream) {
+    NCCL_CALL(ncclAllReduce(send->data, recv->data, numel,
+                            /*datatype=*/AsNCCLDataType(DataType(send->dtype)),
+                            /*op=*/AsNCCLRedOp(reduce_kind), ctx->GetGroupComm(), stream));
+  });
+}
+
+ObjectRef AllGatherAsync(NDArray send, NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int64_t numel = send.Shape()->Product();
+  return LaunchAsync({send, recv}, [&](deviceStream_t stream) {
+    NCCL_CALL(ncclAllGather(send->data, recv->data, numel,
+                            /*datatype=*/AsNCCLDataType(DataType(send->dtype)), ctx->GetGroupComm(),
+                            stream));
+  });
+}
+
+void Wait(ObjectRef handle) {
+  const auto* event = handle.as<CCLEventObj>();
+  CHECK(event != nullptr) << "TypeError: Expected the handle of an asynchronous "
+                          << TVM_DISCO_CCL_NAME " operation, but got: " << handle->GetTypeKey();
+  StreamWaitEvent(CCLThreadLocalContext::Get()->GetDefaultStream(), event->event);
 }
 
 void BroadcastFromWorker0(Optional<NDArray> send, NDArray recv) {
@@ -234,6 +301,74 @@ void RecvFromWorker0(NDArray buffer) {
   NCCL_CALL(ncclGroupEnd());
 }
 
+void InitGroups(int num_groups) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  if (ctx->group_comm) {
+    NCCL_CALL(ncclCommDestroy(ctx->group_comm));
+    ctx->group_comm = nullptr;
+  }
+  if (num_groups == 1) {
+    return;
+  }
+  int group_size = ctx->worker->num_workers / num_groups;
+#if NCCL_VERSION_CODE >= NCCL_VERSION(2, 18, 0)
+  NCCL_CALL(ncclCommSplit(ctx->comm, /*color=*/ctx->worker->worker_id / group_size,
+                          /*key=*/ctx->worker->worker_id, &ctx->group_comm, nullptr));
+#else
+  LOG(FATAL) << "Splitting the workers into groups requires " TVM_DISCO_CCL_NAME
+             << " with ncclCommSplit (NCCL 2.18 or later)";
+#endif
+}
+
+/*!
+ * \brief Name the subgroups of a partition of the workers. Worker `i` is in subgroup `colors[i]`,
+ * or in none if it is negative, at the rank ordered by `keys[i]` within the subgroup. The
+ * communicators are split once per partition, so partitions shared by several names, such as
+ * the same tensor parallel groups of all the replicas, reuse them.
+ */
+void InitCCLGroup(String name, IntTuple colors, IntTuple keys) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int worker_id = ctx->worker->worker_id;
+  ICHECK_EQ(static_cast<int>(colors.size()), ctx->worker->num_workers);
+  ICHECK_EQ(static_cast<int>(keys.size()), ctx->worker->num_workers);
+  std::vector<int64_t> partition(colors.begin(), colors.end());
+  partition.insert(partition.end(), keys.begin(), keys.end());
+  auto it = ctx->subgroup_comms.find(partition);
+  if (it == ctx->subgroup_comms.end()) {
+    // All the workers see the same partitions, so they take this branch together, as the split
+    // requires.
+    ncclComm_t comm = nullptr;
+#if NCCL_VERSION_CODE >= NCCL_VERSION(2, 18, 0)
+    int color = colors[worker_id] < 0 ? NCCL_SPLIT_NOCOLOR : static_cast<int>(colors[worker_id]);
+    NCCL_CALL(ncclCommSplit(ctx->comm, color, /*key=*/static_cast<int>(keys[worker_id]), &comm,
+                            nullptr));
+#else
+    LOG(FATAL) << "Creating groups of workers requires " TVM_DISCO_CCL_NAME
+               << " with ncclCommSplit (NCCL 2.18 or later)";
+#endif
+    it = ctx->subgroup_comms.emplace(std::move(partition), comm).first;
+  }
+  ctx->named_comms[name] = it->second;
+}
+
+void SendToWorker(NDArray buffer, int receiver_id) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  CHECK_NE(ctx->worker->worker_id, receiver_id)
+      << "ValueError: A worker cannot send a buffer to itself";
+  deviceStream_t stream = ctx->GetDefaultStream();
+  NCCL_CALL(ncclSend(buffer->data, buffer.Shape()->Product(), AsNCCLDataType(buffer.DataType()),
+                     receiver_id, ctx->comm, stream));
+}
+
+void RecvFromWorker(NDArray buffer, int sender_id) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  CHECK_NE(ctx->worker->worker_id, sender_id)
+      << "ValueError: A worker cannot receive a buffer from itself";
+  deviceStream_t stream = ctx->GetDefaultStream();
+  NCCL_CALL(ncclRecv(buffer->data, buffer.Shape()->Product(), AsNCCLDataType(buffer.DataType()),
+                     sender_id, ctx->comm, stream));
+}
+
 void SyncWorker() {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ICHECK(ctx->worker != nullptr);
@@ -254,6 +389,28 @@ TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce")
     });
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather")
     .set_body_typed([](NDArray send, NDArray recv) { nccl::AllGather(send, recv); });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_group")
+    .set_body_typed([](NDArray send, int kind, String group, NDArray recv) {
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      nccl::AllReduceGroup(send, static_cast<ReduceKind>(kind), group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather_group")
+    .set_body_typed(AllGatherGroup);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_async")
+    .set_body_typed([](NDArray send, int kind, NDArray recv) {
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      return nccl::AllReduceAsync(send, static_cast<ReduceKind>(kind), recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather_async")
+    .set_body_typed(AllGatherAsync);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".wait").set_body_typed(Wait);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".init_groups").set_body_typed(InitGroups);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".init_ccl_group")
+    .set_body_typed(InitCCLGroup);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".send_to_worker")
+    .set_body_typed(SendToWorker);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".recv_from_worker")
+    .set_body_typed(RecvFromWorker);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".broadcast_from_worker0")
     .set_body_typed(BroadcastFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".scatter_from_worker0")
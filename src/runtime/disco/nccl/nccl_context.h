@@ -26,6 +26,11 @@
 #include <tvm/runtime/disco/session.h>
 #include <tvm/runtime/registry.h>
 
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "../../../support/process_id.h"
 #include "../utils.h"
 
@@ -67,6 +72,18 @@ inline void StreamSynchronize(deviceStream_t stream) { CUDA_CALL(cudaStreamSynch
 inline void StreamCreate(deviceStream_t* stream) { CUDA_CALL(cudaStreamCreate(stream)); }
 inline void StreamDestroy(deviceStream_t stream) { CUDA_CALL(cudaStreamDestroy(stream)); }
 
+using deviceEvent_t = cudaEvent_t;
+inline void EventCreate(deviceEvent_t* event) {
+  CUDA_CALL(cudaEventCreateWithFlags(event, cudaEventDisableTiming));
+}
+inline void EventDestroy(deviceEvent_t event) { CUDA_CALL(cudaEventDestroy(event)); }
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  CUDA_CALL(cudaEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  CUDA_CALL(cudaStreamWaitEvent(stream, event, 0));
+}
+
 #else
 
 #define TVM_DISCO_DEVICE_NAME "rocm"
@@ -79,6 +96,18 @@ inline void StreamSynchronize(deviceStream_t stream) { ROCM_CALL(hipStreamSynchr
 inline void StreamCreate(deviceStream_t* stream) { ROCM_CALL(hipStreamCreate(stream)); }
 inline void StreamDestroy(deviceStream_t stream) { ROCM_CALL(hipStreamDestroy(stream)); }
 
+using deviceEvent_t = hipEvent_t;
+inline void EventCreate(deviceEvent_t* event) {
+  ROCM_CALL(hipEventCreateWithFlags(event, hipEventDisableTiming));
+}
+inline void EventDestroy(deviceEvent_t event) { ROCM_CALL(hipEventDestroy(event)); }
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  ROCM_CALL(hipEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  ROCM_CALL(hipStreamWaitEvent(stream, event, 0));
+}
+
 #endif
 
 /*! \brief Convert DataType to ncclDataType. */
@@ -117,15 +146,56 @@ inline ncclDataType_t AsNCCLDataType(runtime::DataType dtype) {
   throw;
 }
 
+/*!
+ * \brief The handle of an asynchronous collective operation, an event recorded on the
+ * communication stream after it. It keeps the buffers of the operation alive.
+ */
+class CCLEventObj : public Object {
+ public:
+  deviceEvent_t event = nullptr;
+  Array<NDArray> buffers;
+
+  ~CCLEventObj() {
+    if (event) {
+      EventDestroy(event);
+    }
+  }
+
+  static constexpr const char* _type_key = "runtime.disco.CCLEvent";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CCLEventObj, Object);
+};
+
 struct CCLThreadLocalContext {
   DiscoWorker* worker = nullptr;
   int device_id;
   deviceStream_t default_stream = nullptr;
+  /*! \brief The stream of the asynchronous collective operations, created on first use */
+  deviceStream_t comm_stream = nullptr;
   ncclComm_t comm = nullptr;
+  /*! \brief The communicator within the worker group, only created when there are groups */
+  ncclComm_t group_comm = nullptr;
+  /*!
+   * \brief The communicators split from `comm`, keyed by the partition of the workers. The
+   * communicator is nullptr if the worker is in none of the subgroups of the partition.
+   */
+  std::map<std::vector<int64_t>, ncclComm_t> subgroup_comms;
+  /*! \brief The subgroup communicator of each named group, referring into `subgroup_comms` */
+  std::unordered_map<std::string, ncclComm_t> named_comms;
 
   ~CCLThreadLocalContext() { Clear(); }
 
   void Clear() {
+    named_comms.clear();
+    for (const auto& kv : subgroup_comms) {
+      if (kv.second) {
+        NCCL_CALL(ncclCommDestroy(kv.second));
+      }
+    }
+    subgroup_comms.clear();
+    if (group_comm) {
+      NCCL_CALL(ncclCommDestroy(group_comm));
+      group_comm = nullptr;
+    }
     if (comm) {
       NCCL_CALL(ncclCommDestroy(comm));
       comm = nullptr;
@@ -134,9 +204,34 @@ struct CCLThreadLocalContext {
       StreamDestroy(default_stream);
       default_stream = nullptr;
     }
+    if (comm_stream) {
+      StreamDestroy(comm_stream);
+      comm_stream = nullptr;
+    }
     worker = nullptr;
   }
 
+  /*! \brief The communicator of the collective operations, which run within the group */
+  ncclComm_t GetGroupComm() const { return group_comm ? group_comm : comm; }
+
+  /*! \brief The communicator of a named group, which the worker must be a member of */
+  ncclComm_t GetNamedComm(const std::string& name) const {
+    auto it = named_comms.find(name);
+    CHECK(it != named_comms.end()) << "ValueError: Unknown " TVM_DISCO_CCL_NAME " group `" << name
+                                   << "`, which must be created by `init_ccl_group` first";
+    CHECK(it->second != nullptr) << "ValueError: Worker " << worker->worker_id
+                                 << " is not a member of the " TVM_DISCO_CCL_NAME " group `"
+                                 << name << "`";
+    return it->second;
+  }
+
+  deviceStream_t GetCommStream() {
+    if (comm_stream == nullptr) {
+      StreamCreate(&comm_stream);
+    }
+    return comm_stream;
+  }
+
   deviceStream_t GetDefaultStream() {
     const auto* func = tvm::runtime::Registry::Get("runtime.get_" TVM_DISCO_DEVICE_NAME "_stream");
     ICHECK(func != nullptr);
@@ -22,16 +22,30 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#endif
+#ifndef _WIN32
+#include <netinet/tcp.h>
+#endif
+
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "../../support/pipe.h"
+#include "../../support/socket.h"
 #include "../minrpc/rpc_reference.h"
 #include "./bcast_session.h"
 #include "./disco_worker_thread.h"
 #include "./protocol.h"
+#include "./shm_ring_buffer.h"
 
 namespace tvm {
 namespace runtime {
@@ -47,6 +61,9 @@ class DiscoPipeMessageQueue : private dmlc::Stream, private DiscoProtocol<DiscoP
     CommitSendAndNotifyEnqueue();
   }
 
+  /*! \brief Send a packet that has been serialized already */
+  void SendPacket(const std::string& packet) { pipe_.Write(packet.data(), packet.size()); }
+
   TVMArgs Recv() {
     bool is_implicit_shutdown = DequeueNextPacket();
     TVMValue* values = nullptr;
@@ -134,27 +151,176 @@ class DiscoPipeMessageQueue : private dmlc::Stream, private DiscoProtocol<DiscoP
   support::Pipe pipe_;
 };
 
+/*!
+ * \brief The action sent over the pipe to ask a worker process to read the messages
+ * from the controler over a shared-memory ring, followed by the name of the ring.
+ */
+constexpr int kDiscoShmAttach = -1;
+
+#ifdef __linux__
+/*!
+ * \brief The queue of the messages from the controler to all the worker processes,
+ * over a ring buffer in shared memory.
+ *
+ * The controler writes each message once, and every worker reads it in place, so a
+ * broadcast costs a single copy and no system call while the workers are busy polling.
+ * Messages too large for the ring are sent over the pipe of each worker instead, after
+ * an empty record in the ring that tells the workers to read their pipe, which keeps
+ * the order of the messages.
+ */
+class DiscoShmBroadcastQueue : private dmlc::Stream,
+                               private DiscoProtocol<DiscoShmBroadcastQueue> {
+ public:
+  /*! \brief The number of bytes of messages the ring holds */
+  static constexpr uint64_t kCapacity = 4 << 20;
+
+  explicit DiscoShmBroadcastQueue(std::unique_ptr<ShmBroadcastRing> ring)
+      : ring_(std::move(ring)) {}
+
+  /*! \brief Send a message to all the workers, whose pipes are used for large messages */
+  void Send(const TVMArgs& args, const std::vector<DiscoPipeMessageQueue*>& pipes) {
+    RPCReference::ReturnPackedSeq(args.values, args.type_codes, args.num_args, this);
+    if (ring_->Fits(write_buffer_.size())) {
+      ring_->Write(write_buffer_.data(), write_buffer_.size());
+    } else {
+      ring_->Write(nullptr, 0);
+      for (DiscoPipeMessageQueue* pipe : pipes) {
+        pipe->SendPacket(write_buffer_);
+      }
+    }
+    write_buffer_.clear();
+  }
+
+  /*!
+   * \brief Receive the next message on a worker.
+   * \param pipe The pipe from the controler to the worker.
+   * \param pipe_fd The file descriptor of the pipe, polled to detect the controler is gone.
+   */
+  TVMArgs Recv(DiscoPipeMessageQueue* pipe, int64_t pipe_fd) {
+    const char* data = nullptr;
+    uint64_t nbytes = ring_->Acquire(&data, [pipe_fd]() {
+      struct pollfd pfd;
+      pfd.fd = static_cast<int>(pipe_fd);
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      return !(poll(&pfd, 1, 0) == 1 && (pfd.revents & (POLLHUP | POLLERR)));
+    });
+    if (nbytes == ShmBroadcastRing::kClosed) {
+      // The controler is gone, which is treated as a request to shutdown.
+      return pipe->Recv();
+    }
+    if (nbytes == 0) {
+      ring_->Release();
+      return pipe->Recv();
+    }
+    // Skip the packet size, which is the size of the record.
+    read_data_ = data + sizeof(uint64_t);
+    read_size_ = nbytes - sizeof(uint64_t);
+    read_offset_ = 0;
+    this->RecycleAll();
+    RPCCode code = RPCCode::kReturn;
+    this->Read(&code);
+    TVMValue* values = nullptr;
+    int* type_codes = nullptr;
+    int num_args = 0;
+    // All the values are unpacked into the arena, so the record can be released right away.
+    RPCReference::RecvPackedSeq(&values, &type_codes, &num_args, this);
+    ring_->Release();
+    return TVMArgs(values, type_codes, num_args);
+  }
+
+ private:
+  size_t Read(void* data, size_t size) final {
+    ICHECK_LE(read_offset_ + size, read_size_);
+    std::memcpy(data, read_data_ + read_offset_, size);
+    read_offset_ += size;
+    return size;
+  }
+
+  size_t Write(const void* data, size_t size) final {
+    size_t cur_size = write_buffer_.size();
+    write_buffer_.resize(cur_size + size);
+    std::memcpy(write_buffer_.data() + cur_size, data, size);
+    return size;
+  }
+
+  using dmlc::Stream::Read;
+  using dmlc::Stream::ReadArray;
+  using dmlc::Stream::Write;
+  using dmlc::Stream::WriteArray;
+  friend struct RPCReference;
+  friend struct DiscoProtocol<DiscoShmBroadcastQueue>;
+
+  std::unique_ptr<ShmBroadcastRing> ring_;
+  std::string write_buffer_;
+  const char* read_data_ = nullptr;
+  size_t read_size_ = 0;
+  size_t read_offset_ = 0;
+};
+#endif
+
 class DiscoProcessChannel final : public DiscoChannel {
  public:
-  DiscoProcessChannel(int64_t controler_to_worker_fd, int64_t worker_to_controler_fd)
+  DiscoProcessChannel(int64_t controler_to_worker_fd, int64_t worker_to_controler_fd,
+                      int worker_id = -1)
       : controler_to_worker_(controler_to_worker_fd),
-        worker_to_controler_(worker_to_controler_fd) {}
+        worker_to_controler_(worker_to_controler_fd),
+        controler_to_worker_fd_(controler_to_worker_fd),
+        worker_id_(worker_id) {}
 
   DiscoProcessChannel(DiscoProcessChannel&& other) = delete;
   DiscoProcessChannel(const DiscoProcessChannel& other) = delete;
 
   void Send(const TVMArgs& args) { controler_to_worker_.Send(args); }
-  TVMArgs Recv() { return controler_to_worker_.Recv(); }
+  TVMArgs Recv() {
+#ifdef __linux__
+    if (broadcast_ != nullptr) {
+      return broadcast_->Recv(&controler_to_worker_, controler_to_worker_fd_);
+    }
+    TVMArgs args = controler_to_worker_.Recv();
+    if (args.size() == 2 && args[0].type_code() == kDLInt &&
+        args[0].operator int() == kDiscoShmAttach) {
+      std::string name = args[1];
+      broadcast_ = std::make_unique<DiscoShmBroadcastQueue>(
+          ShmBroadcastRing::Open(name, /*reader=*/worker_id_ - 1));
+      TVMValue values[1];
+      int type_codes[1];
+      PackArgs(values, type_codes, kDiscoShmAttach);
+      Reply(TVMArgs(values, type_codes, 1));
+      return Recv();
+    }
+    return args;
+#else
+    return controler_to_worker_.Recv();
+#endif
+  }
   void Reply(const TVMArgs& args) { worker_to_controler_.Send(args); }
   TVMArgs RecvReply() { return worker_to_controler_.Recv(); }
 
   DiscoPipeMessageQueue controler_to_worker_;
   DiscoPipeMessageQueue worker_to_controler_;
+
+ private:
+  int64_t controler_to_worker_fd_;
+  /*! \brief The id of the worker on the worker side of the channel, or -1 on the controler */
+  int worker_id_;
+#ifdef __linux__
+  /*! \brief The queue of broadcast messages, once the controler has sent its name */
+  std::unique_ptr<DiscoShmBroadcastQueue> broadcast_;
+#endif
 };
 
 class ProcessSessionObj final : public BcastSessionObj {
  public:
-  explicit ProcessSessionObj(int num_workers, PackedFunc process_pool)
+  /*!
+   * \brief Create the session.
+   * \param num_workers The number of workers.
+   * \param process_pool The process pool, see `Session::ProcessSession`.
+   * \param use_shared_memory Whether the workers run on the host of the controler, so that the
+   * messages to them can be broadcast over shared memory.
+   */
+  explicit ProcessSessionObj(int num_workers, PackedFunc process_pool,
+                             bool use_shared_memory = true)
       : process_pool_(process_pool),
         worker_0_(std::make_unique<DiscoWorkerThread>(0, num_workers, &worker_zero_data_)) {
     std::vector<int64_t> read_fds;
@@ -171,6 +337,11 @@ class ProcessSessionObj final : public BcastSessionObj {
     for (int i = 0; i < num_workers - 1; ++i) {
       workers_.emplace_back(std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i]));
     }
+#ifdef __linux__
+    if (num_workers > 1 && use_shared_memory) {
+      InitBroadcastQueue();
+    }
+#endif
   }
 
   void Kill() {
@@ -196,7 +367,7 @@ class ProcessSessionObj final : public BcastSessionObj {
       int type_codes[3];
       PackArgs(values, type_codes, static_cast<int>(DiscoAction::kDebugGetFromRemote), reg_id,
                worker_id);
-      workers_[worker_id - 1]->Send(TVMArgs(values, type_codes, 3));
+      SendToWorker(worker_id, TVMArgs(values, type_codes, 3));
     }
     TVMArgs args = this->RecvReplyPacked(worker_id);
     ICHECK_EQ(args.size(), 2);
@@ -225,7 +396,7 @@ class ProcessSessionObj final : public BcastSessionObj {
       int type_codes[4];
       PackArgs(values, type_codes, static_cast<int>(DiscoAction::kDebugSetRegister), reg_id,
                worker_id, value);
-      workers_[worker_id - 1]->Send(TVMArgs(values, type_codes, 4));
+      SendToWorker(worker_id, TVMArgs(values, type_codes, 4));
     }
     TVMRetValue result;
     TVMArgs args = this->RecvReplyPacked(worker_id);
@@ -235,6 +406,12 @@ class ProcessSessionObj final : public BcastSessionObj {
 
   void BroadcastPacked(const TVMArgs& args) final {
     worker_0_->channel->Send(args);
+#ifdef __linux__
+    if (broadcast_ != nullptr) {
+      broadcast_->Send(args, worker_pipes_);
+      return;
+    }
+#endif
     for (std::unique_ptr<DiscoProcessChannel>& channel : workers_) {
       channel->Send(args);
     }
@@ -247,9 +424,57 @@ class ProcessSessionObj final : public BcastSessionObj {
     return this->workers_.at(worker_id - 1)->RecvReply();
   }
 
+  /*!
+   * \brief Send a message to a single worker process. Once the workers read from the shared
+   * ring, the message is broadcast instead so that it stays in order with the others, and the
+   * workers it is not meant for ignore it.
+   */
+  void SendToWorker(int worker_id, const TVMArgs& args) {
+#ifdef __linux__
+    if (broadcast_ != nullptr) {
+      broadcast_->Send(args, worker_pipes_);
+      return;
+    }
+#endif
+    workers_[worker_id - 1]->Send(args);
+  }
+
+#ifdef __linux__
+  /*! \brief Create the shared ring and make all the worker processes read from it */
+  void InitBroadcastQueue() {
+    static std::atomic<int> counter{0};
+    std::string name = "/tvm-disco-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+    std::unique_ptr<ShmBroadcastRing> ring = ShmBroadcastRing::Create(
+        name, DiscoShmBroadcastQueue::kCapacity, static_cast<int>(workers_.size()));
+    if (ring == nullptr) {
+      // Keep sending the messages over the pipes.
+      return;
+    }
+    for (std::unique_ptr<DiscoProcessChannel>& channel : workers_) {
+      TVMValue values[2];
+      int type_codes[2];
+      PackArgs(values, type_codes, kDiscoShmAttach, name);
+      channel->Send(TVMArgs(values, type_codes, 2));
+    }
+    for (std::unique_ptr<DiscoProcessChannel>& channel : workers_) {
+      TVMArgs args = channel->RecvReply();
+      ICHECK(args.size() == 1 && args[0].operator int() == kDiscoShmAttach);
+      worker_pipes_.push_back(&channel->controler_to_worker_);
+    }
+    // All the workers have mapped the ring, which is freed once the last of them unmaps it.
+    ShmBroadcastRing::Unlink(name);
+    broadcast_ = std::make_unique<DiscoShmBroadcastQueue>(std::move(ring));
+  }
+#endif
+
   PackedFunc process_pool_;
   std::unique_ptr<DiscoWorkerThread> worker_0_;
   std::vector<std::unique_ptr<DiscoProcessChannel>> workers_;
+#ifdef __linux__
+  /*! \brief The queue of the messages to all the worker processes, if shared memory is usable */
+  std::unique_ptr<DiscoShmBroadcastQueue> broadcast_;
+  std::vector<DiscoPipeMessageQueue*> worker_pipes_;
+#endif
 
   static constexpr const char* _type_key = "runtime.disco.ProcessSession";
   TVM_DECLARE_FINAL_OBJECT_INFO(ProcessSessionObj, SessionObj);
@@ -268,13 +493,115 @@ Session Session::ProcessSession(int num_workers, String process_pool_creator, St
 }
 
 void WorkerProcess(int worker_id, int num_workers, int64_t read_fd, int64_t write_fd) {
-  DiscoProcessChannel channel(read_fd, write_fd);
+  DiscoProcessChannel channel(read_fd, write_fd, worker_id);
   DiscoWorker worker(worker_id, num_workers, nullptr, &channel);
   worker.MainLoop();
 }
 
+#ifndef _WIN32
+/*! \brief Disable Nagle's algorithm, since the messages of disco are small and latency bound */
+void SetNoDelay(const support::TCPSocket& sock) {
+  int opt = 1;
+  if (setsockopt(sock.sockfd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&opt),
+                 sizeof(opt)) < 0) {
+    support::Socket::Error("SetNoDelay");
+  }
+}
+
+/*!
+ * \brief Create a process pool, following the convention of `Session::ProcessSession`, whose
+ * workers are the processes connecting to the controler over TCP.
+ *
+ * At the first request, the pool accepts the connections of all the workers. Each of them
+ * sends its worker id as the handshake, and receives the number of workers in reply.
+ */
+PackedFunc CreateSocketWorkerPool(int num_workers, const std::string& host, int port) {
+  support::SockAddr addr(host.c_str(), port);
+  auto listener = std::make_shared<support::TCPSocket>();
+  listener->Create(addr.addr.ss_family);
+  int reuse = 1;
+  setsockopt(listener->sockfd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char*>(&reuse),
+             sizeof(reuse));
+  listener->Bind(addr);
+  listener->Listen(num_workers);
+  auto workers = std::make_shared<std::vector<support::TCPSocket>>();
+  return PackedFunc([=](TVMArgs args, TVMRetValue* rv) {
+    int worker_id = args[0];
+    if (worker_id == 0) {
+      for (support::TCPSocket& sock : *workers) {
+        sock.Close();
+      }
+      workers->clear();
+      listener->Close();
+      return;
+    }
+    if (workers->empty()) {
+      workers->resize(num_workers);
+      for (int i = 1; i < num_workers; ++i) {
+        support::TCPSocket sock = listener->Accept();
+        int32_t remote_id = -1;
+        CHECK_EQ(sock.RecvAll(&remote_id, sizeof(remote_id)), sizeof(remote_id))
+            << "ValueError: A disco worker disconnected during the handshake";
+        CHECK(remote_id >= 1 && remote_id < num_workers && workers->at(remote_id).IsClosed())
+            << "ValueError: Unexpected or duplicate worker id " << remote_id << " for "
+            << num_workers << " workers";
+        int32_t total = num_workers;
+        sock.SendAll(&total, sizeof(total));
+        SetNoDelay(sock);
+        workers->at(remote_id) = sock;
+      }
+    }
+    int64_t fd = workers->at(worker_id).sockfd;
+    *rv = IntTuple({fd, fd});
+  });
+}
+
+Session SocketSession(int num_workers, String host, int port) {
+  PackedFunc pool = CreateSocketWorkerPool(num_workers, host, port);
+  auto n = make_object<ProcessSessionObj>(num_workers, pool, /*use_shared_memory=*/false);
+  return Session(n);
+}
+
+/*!
+ * \brief The main loop of a worker connecting to the controler of a socket session.
+ * \param worker_id The id of the worker.
+ * \param host The host of the controler.
+ * \param port The port of the controler.
+ * \param timeout_sec For how long to retry connecting while the controler is not listening yet.
+ */
+void WorkerSocket(int worker_id, String host, int port, int timeout_sec) {
+  support::SockAddr addr(host.c_str(), port);
+  support::TCPSocket sock;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+  while (true) {
+    sock.Create(addr.addr.ss_family);
+    if (sock.Connect(addr)) break;
+    sock.Close();
+    CHECK(std::chrono::steady_clock::now() < deadline)
+        << "Cannot connect to the disco controler at " << addr.AsString();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  SetNoDelay(sock);
+  int32_t id = worker_id;
+  sock.SendAll(&id, sizeof(id));
+  int32_t num_workers = 0;
+  CHECK_EQ(sock.RecvAll(&num_workers, sizeof(num_workers)), sizeof(num_workers))
+      << "The disco controler at " << addr.AsString() << " rejected worker " << worker_id;
+  {
+    DiscoProcessChannel channel(sock.sockfd, sock.sockfd, worker_id);
+    DiscoWorker worker(worker_id, num_workers, nullptr, &channel);
+    worker.MainLoop();
+  }
+  sock.Close();
+}
+#endif
+
 TVM_REGISTER_GLOBAL("runtime.disco.SessionProcess").set_body_typed(Session::ProcessSession);
 TVM_REGISTER_GLOBAL("runtime.disco.WorkerProcess").set_body_typed(WorkerProcess);
+#ifndef _WIN32
+TVM_REGISTER_GLOBAL("runtime.disco.SessionSocket").set_body_typed(SocketSession);
+TVM_REGISTER_GLOBAL("runtime.disco.WorkerSocket").set_body_typed(WorkerSocket);
+#endif
 
 }  // namespace runtime
 }  // namespace tvm
@@ -0,0 +1,297 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file shm_ring_buffer.h
+ * \brief A single-producer ring buffer in shared memory, whose records are read by every reader.
+ */
+#ifndef TVM_RUNTIME_DISCO_SHM_RING_BUFFER_H_
+#define TVM_RUNTIME_DISCO_SHM_RING_BUFFER_H_
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <tvm/runtime/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief A broadcast ring buffer in POSIX shared memory.
+ *
+ * One writer appends records, and each of the readers reads every record in order.
+ * A record is an 8-byte length followed by the payload, padded to 8 bytes, and is
+ * never split at the end of the ring: a wrap marker sends the readers back to the
+ * start instead. The writer waits for the slowest reader when the ring is full.
+ *
+ * Both sides spin for a short while before sleeping on a futex in the shared memory,
+ * so that back-to-back messages are exchanged without any system call.
+ */
+class ShmBroadcastRing {
+ public:
+  /*! \brief The length of a record telling the readers to skip to the start of the ring */
+  static constexpr uint64_t kWrapMarker = ~0ULL;
+  /*! \brief The length returned to a reader when the writer is gone */
+  static constexpr uint64_t kClosed = ~0ULL - 1;
+  /*! \brief The number of checks before a waiting side sleeps on the futex */
+  static constexpr int kSpinCount = 4096;
+  /*! \brief The timeout of the futex, after which a waiting reader checks the writer is alive */
+  static constexpr int kWaitTimeoutMs = 100;
+
+  /*!
+   * \brief Create a ring in a new shared memory object.
+   * \param name The name of the shared memory object.
+   * \param capacity The number of bytes of records the ring can hold.
+   * \param num_readers The number of readers.
+   * \return The ring, or nullptr if the shared memory object cannot be created.
+   */
+  static std::unique_ptr<ShmBroadcastRing> Create(const std::string& name, uint64_t capacity,
+                                                  int num_readers) {
+    capacity = RoundUp(capacity);
+    size_t nbytes = DataOffset(num_readers) + capacity;
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      LOG(WARNING) << "Cannot create shared memory " << name << ": " << strerror(errno);
+      return nullptr;
+    }
+    void* base = MAP_FAILED;
+    if (ftruncate(fd, nbytes) == 0) {
+      base = mmap(nullptr, nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+      LOG(WARNING) << "Cannot map shared memory " << name << ": " << strerror(errno);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+    Header* header = new (base) Header();
+    header->capacity = capacity;
+    header->num_readers = num_readers;
+    for (int i = 0; i < num_readers; ++i) {
+      new (static_cast<char*>(base) + sizeof(Header) + i * sizeof(ReaderSlot)) ReaderSlot();
+    }
+    return std::unique_ptr<ShmBroadcastRing>(new ShmBroadcastRing(base, nbytes, -1));
+  }
+
+  /*!
+   * \brief Open the ring created by the writer.
+   * \param name The name of the shared memory object.
+   * \param reader The index of the reader opening the ring.
+   */
+  static std::unique_ptr<ShmBroadcastRing> Open(const std::string& name, int reader) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    CHECK_GE(fd, 0) << "Cannot open shared memory " << name << ": " << strerror(errno);
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << "Cannot stat shared memory " << name << ": " << strerror(errno);
+    void* base = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(base != MAP_FAILED) << "Cannot map shared memory " << name << ": " << strerror(errno);
+    std::unique_ptr<ShmBroadcastRing> ring(new ShmBroadcastRing(base, st.st_size, reader));
+    CHECK_LT(reader, static_cast<int>(ring->header_->num_readers));
+    return ring;
+  }
+
+  /*! \brief Remove the name of a shared memory object, which is freed once it is unmapped */
+  static void Unlink(const std::string& name) { shm_unlink(name.c_str()); }
+
+  ~ShmBroadcastRing() { munmap(base_, nbytes_); }
+
+  /*! \brief Whether a payload of the given size can be written to the ring */
+  bool Fits(uint64_t nbytes) const { return RecordBytes(nbytes) * 2 <= header_->capacity; }
+
+  /*! \brief Write a record, waiting for the readers if the ring is full. */
+  void Write(const void* data, uint64_t nbytes) {
+    ICHECK(Fits(nbytes));
+    uint64_t capacity = header_->capacity;
+    uint64_t record = RecordBytes(nbytes);
+    uint64_t pos = header_->write_pos.load(std::memory_order_relaxed);
+    uint64_t offset = pos % capacity;
+    uint64_t pad = capacity - offset < record ? capacity - offset : 0;
+    WaitForSpace(pos + pad + record);
+    if (pad != 0) {
+      std::memcpy(data_ + offset, &kWrapMarker, sizeof(uint64_t));
+      offset = 0;
+    }
+    std::memcpy(data_ + offset, &nbytes, sizeof(uint64_t));
+    std::memcpy(data_ + offset + sizeof(uint64_t), data, nbytes);
+    header_->write_pos.store(pos + pad + record, std::memory_order_seq_cst);
+    header_->write_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->num_waiting_readers.load(std::memory_order_seq_cst) != 0) {
+      FutexWake(&header_->write_seq, INT_MAX);
+    }
+  }
+
+  /*!
+   * \brief Wait for the next record of this reader. The record stays valid until `Release`.
+   * \param data The start of the payload.
+   * \param fis_alive Checks whether the writer is alive while waiting.
+   * \return The length of the payload, or kClosed if the writer is gone.
+   */
+  uint64_t Acquire(const char** data, const std::function<bool()>& fis_alive) {
+    uint64_t capacity = header_->capacity;
+    std::atomic<uint64_t>& read_pos = Slot(reader_)->read_pos;
+    uint64_t pos = read_pos.load(std::memory_order_relaxed);
+    while (true) {
+      if (!WaitForData(pos, fis_alive)) {
+        return kClosed;
+      }
+      uint64_t offset = pos % capacity;
+      uint64_t nbytes;
+      std::memcpy(&nbytes, data_ + offset, sizeof(uint64_t));
+      if (nbytes == kWrapMarker) {
+        pos += capacity - offset;
+        read_pos.store(pos, std::memory_order_seq_cst);
+        continue;
+      }
+      *data = data_ + offset + sizeof(uint64_t);
+      acquired_end_ = pos + RecordBytes(nbytes);
+      return nbytes;
+    }
+  }
+
+  /*! \brief Release the record acquired last, so the writer can reuse its space. */
+  void Release() {
+    Slot(reader_)->read_pos.store(acquired_end_, std::memory_order_seq_cst);
+    if (header_->writer_waiting.load(std::memory_order_seq_cst) != 0) {
+      header_->read_seq.fetch_add(1, std::memory_order_seq_cst);
+      FutexWake(&header_->read_seq, 1);
+    }
+  }
+
+ private:
+  /*! \brief The control block at the start of the shared memory */
+  struct alignas(64) Header {
+    uint64_t capacity = 0;
+    uint32_t num_readers = 0;
+    /*! \brief The total number of bytes written */
+    std::atomic<uint64_t> write_pos{0};
+    /*! \brief Bumped for each record written, the futex readers sleep on */
+    std::atomic<uint32_t> write_seq{0};
+    std::atomic<uint32_t> num_waiting_readers{0};
+    /*! \brief Bumped when a reader releases a record while the writer waits, its futex */
+    std::atomic<uint32_t> read_seq{0};
+    std::atomic<uint32_t> writer_waiting{0};
+  };
+  /*! \brief The progress of a reader, on its own cache line */
+  struct alignas(64) ReaderSlot {
+    /*! \brief The total number of bytes released by the reader */
+    std::atomic<uint64_t> read_pos{0};
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                    std::atomic<uint32_t>::is_always_lock_free,
+                "Shared memory atomics must be lock free");
+
+  ShmBroadcastRing(void* base, size_t nbytes, int reader)
+      : base_(base),
+        nbytes_(nbytes),
+        header_(static_cast<Header*>(base)),
+        data_(static_cast<char*>(base) + DataOffset(header_->num_readers)),
+        reader_(reader) {}
+
+  static uint64_t RoundUp(uint64_t nbytes) { return (nbytes + 7) / 8 * 8; }
+  static uint64_t RecordBytes(uint64_t nbytes) { return sizeof(uint64_t) + RoundUp(nbytes); }
+  static size_t DataOffset(int num_readers) {
+    return sizeof(Header) + num_readers * sizeof(ReaderSlot);
+  }
+
+  ReaderSlot* Slot(int reader) const {
+    return reinterpret_cast<ReaderSlot*>(static_cast<char*>(base_) + sizeof(Header)) + reader;
+  }
+
+  uint64_t MinReadPos() const {
+    uint64_t result = ~0ULL;
+    for (uint32_t i = 0; i < header_->num_readers; ++i) {
+      result = std::min(result, Slot(i)->read_pos.load(std::memory_order_seq_cst));
+    }
+    return result;
+  }
+
+  void WaitForSpace(uint64_t end) {
+    for (int spin = 0; end - MinReadPos() > header_->capacity; ++spin) {
+      if (spin < kSpinCount) continue;
+      uint32_t seq = header_->read_seq.load(std::memory_order_seq_cst);
+      header_->writer_waiting.store(1, std::memory_order_seq_cst);
+      if (end - MinReadPos() > header_->capacity) {
+        FutexWait(&header_->read_seq, seq, kWaitTimeoutMs);
+      }
+      header_->writer_waiting.store(0, std::memory_order_seq_cst);
+    }
+  }
+
+  bool WaitForData(uint64_t pos, const std::function<bool()>& fis_alive) {
+    for (int spin = 0; header_->write_pos.load(std::memory_order_seq_cst) <= pos; ++spin) {
+      if (spin < kSpinCount) continue;
+      uint32_t seq = header_->write_seq.load(std::memory_order_seq_cst);
+      header_->num_waiting_readers.fetch_add(1, std::memory_order_seq_cst);
+      bool timed_out = false;
+      if (header_->write_pos.load(std::memory_order_seq_cst) <= pos) {
+        timed_out = FutexWait(&header_->write_seq, seq, kWaitTimeoutMs);
+      }
+      header_->num_waiting_readers.fetch_sub(1, std::memory_order_seq_cst);
+      if (timed_out && !fis_alive()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief Sleep while the futex holds `expected`, returning whether the wait timed out */
+  static bool FutexWait(std::atomic<uint32_t>* addr, uint32_t expected, int timeout_ms) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    long ret = syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected,
+                       &timeout, nullptr, 0);
+    return ret != 0 && errno == ETIMEDOUT;
+  }
+
+  static void FutexWake(std::atomic<uint32_t>* addr, int count) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, count, nullptr, nullptr, 0);
+  }
+
+  void* base_;
+  size_t nbytes_;
+  Header* header_;
+  char* data_;
+  /*! \brief The index of this reader, or -1 for the writer */
+  int reader_;
+  /*! \brief The end of the record acquired last */
+  uint64_t acquired_end_ = 0;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // __linux__
+#endif  // TVM_RUNTIME_DISCO_SHM_RING_BUFFER_H_
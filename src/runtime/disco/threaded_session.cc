@@ -21,14 +21,13 @@
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/object.h>
 
-#include <condition_variable>
 #include <cstdint>
 #include <memory>
-#include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 
-#include "../../support/ring_buffer.h"
+#include "../../support/mpmc_queue.h"
 #include "../minrpc/rpc_reference.h"
 #include "./bcast_session.h"
 #include "./disco_worker_thread.h"
@@ -56,32 +55,15 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
 
  protected:
   void CommitSendAndNotifyEnqueue() {
-    bool need_notify = false;
-    {
-      std::lock_guard<std::mutex> lock{mutex_};
-      ++msg_cnt_;
-      ring_buffer_.Write(write_buffer_.data(), write_buffer_.size());
-      need_notify = dequeue_waiting_;
-    }
-    if (need_notify) {
-      condition_.notify_one();
-    }
+    queue_.Push(std::move(write_buffer_));
     write_buffer_.clear();
   }
 
   void DequeueNextPacket() {
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-      dequeue_waiting_ = true;
-      condition_.wait(lock, [this] { return msg_cnt_.load() > 0; });
-      dequeue_waiting_ = false;
-      --msg_cnt_;
-      uint64_t packet_nbytes = 0;
-      ring_buffer_.Read(&packet_nbytes, sizeof(packet_nbytes));
-      read_buffer_.resize(packet_nbytes);
-      ring_buffer_.Read(read_buffer_.data(), packet_nbytes);
-      read_offset_ = 0;
-    }
+    queue_.Pop(&read_buffer_);
+    // The packet starts with its length, which the queue already keeps.
+    read_offset_ = sizeof(uint64_t);
+    ICHECK_LE(read_offset_, read_buffer_.size());
     this->RecycleAll();
     RPCCode code = RPCCode::kReturn;
     this->Read(&code);
@@ -110,16 +92,14 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
   friend struct RPCReference;
   friend struct DiscoProtocol<DiscoThreadedMessageQueue>;
 
-  // The read/write buffer will only be accessed by the producer thread.
+  // The number of packets in flight, beyond which the sender waits for the receiver.
+  static constexpr size_t kQueueCapacity = 4096;
+  // The write buffer is only accessed by the producer thread, and the read buffer by the consumer.
   std::string write_buffer_;
   std::string read_buffer_;
   size_t read_offset_ = 0;
-  bool dequeue_waiting_ = false;
-
-  std::mutex mutex_;
-  std::atomic<int> msg_cnt_{0};
-  std::condition_variable condition_;
-  support::RingBuffer ring_buffer_;
+  // The packets, which the receiver parks on when there are none.
+  support::MPMCQueue<std::string> queue_{kQueueCapacity};
 };
 
 class DiscoThreadChannel final : public DiscoChannel {
@@ -28,10 +28,24 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
 
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace tvm {
 namespace runtime {
 
@@ -101,6 +115,137 @@ std::string GetCacheDir() {
   return ".";
 }
 
+namespace {
+
+struct KernelCacheConfig {
+  std::mutex mutex;
+  std::string dir;
+
+  KernelCacheConfig() {
+    if (const char* env_dir = getenv("TVM_KERNEL_CACHE_DIR")) {
+      dir = env_dir;
+    }
+  }
+
+  static KernelCacheConfig* Global() {
+    static KernelCacheConfig* inst = new KernelCacheConfig();
+    return inst;
+  }
+};
+
+constexpr uint64_t kKernelCacheEntryMagic = 0x54564D4B43414348;
+
+/*! \brief Create a directory and its parents, returns whether it exists afterwards. */
+bool CreateDirectories(const std::string& dir) {
+  for (size_t pos = dir.find_first_of("/\\", 1);; pos = dir.find_first_of("/\\", pos + 1)) {
+    std::string prefix = dir.substr(0, pos);
+#ifdef _WIN32
+    _mkdir(prefix.c_str());
+#else
+    mkdir(prefix.c_str(), 0755);
+#endif
+    if (pos == std::string::npos) break;
+  }
+#ifdef _WIN32
+  struct _stat info;
+  return _stat(dir.c_str(), &info) == 0 && (info.st_mode & _S_IFDIR);
+#else
+  struct stat info;
+  return stat(dir.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+}  // namespace
+
+std::string GetKernelCacheDir() {
+  KernelCacheConfig* config = KernelCacheConfig::Global();
+  std::lock_guard<std::mutex> lock(config->mutex);
+  return config->dir;
+}
+
+void SetKernelCacheDir(const std::string& dir) {
+  KernelCacheConfig* config = KernelCacheConfig::Global();
+  std::lock_guard<std::mutex> lock(config->mutex);
+  config->dir = dir;
+}
+
+std::string GetKernelCacheKey(const std::vector<std::string>& parts) {
+  // Two FNV-1a hashes with different offset bases, each part is
+  // prefixed by its length so that the split between parts matters.
+  uint64_t hashes[2] = {0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL};
+  auto update = [&hashes](const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      for (uint64_t& hash : hashes) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+      }
+    }
+  };
+  for (const std::string& part : parts) {
+    uint64_t size = part.size();
+    update(reinterpret_cast<const char*>(&size), sizeof(size));
+    update(part.data(), part.size());
+  }
+  std::ostringstream os;
+  os << std::hex;
+  for (uint64_t hash : hashes) {
+    os.width(16);
+    os.fill('0');
+    os << hash;
+  }
+  return os.str();
+}
+
+bool LoadKernelCacheEntry(const std::string& key, std::string* data) {
+  std::string dir = GetKernelCacheDir();
+  if (dir.empty()) return false;
+  std::ifstream fs(dir + "/" + key + ".bin", std::ios::in | std::ios::binary);
+  if (fs.fail()) return false;
+  uint64_t header[2];
+  if (!fs.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+      header[0] != kKernelCacheEntryMagic) {
+    return false;
+  }
+  data->resize(header[1]);
+  if (!fs.read(&(*data)[0], header[1])) {
+    data->clear();
+    return false;
+  }
+  return true;
+}
+
+void SaveKernelCacheEntry(const std::string& key, const std::string& data) {
+  std::string dir = GetKernelCacheDir();
+  if (dir.empty()) return;
+  if (!CreateDirectories(dir)) {
+    LOG(WARNING) << "Cannot create the kernel cache directory " << dir;
+    return;
+  }
+  std::string file_name = dir + "/" + key + ".bin";
+  std::string tmp_file_name =
+      file_name + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream fs(tmp_file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+    uint64_t header[2] = {kKernelCacheEntryMagic, data.size()};
+    fs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    fs.write(data.data(), data.size());
+    if (fs.fail()) {
+      LOG(WARNING) << "Cannot write the kernel cache entry " << tmp_file_name;
+      fs.close();
+      std::remove(tmp_file_name.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+    // rename does not replace an existing file on all platforms.
+    std::remove(file_name.c_str());
+    if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+      LOG(WARNING) << "Cannot write the kernel cache entry " << file_name;
+      std::remove(tmp_file_name.c_str());
+    }
+  }
+}
+
 std::string GetFileBasename(const std::string& file_name) {
   size_t last_slash = file_name.find_last_of("/");
   if (last_slash == std::string::npos) return file_name;
@@ -133,6 +278,64 @@ void SaveBinaryToFile(const std::string& file_name, const std::string& data) {
   fs.write(&data[0], data.length());
 }
 
+MappedFile::MappedFile(const std::string& path) {
+#ifndef _WIN32
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Cannot open " << path;
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << path;
+  size_ = st.st_size;
+  if (size_ > 0) {
+    // A private writable mapping, so that accidental writes to the views never reach
+    // the file, and pages that are never written stay shared with the page cache.
+    void* ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    CHECK(ptr != MAP_FAILED) << "Cannot mmap " << path;
+    data_ = static_cast<char*>(ptr);
+  }
+  close(fd);
+#else
+  LoadBinaryFromFile(path, &buffer_);
+  size_ = buffer_.size();
+  data_ = &buffer_[0];
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+#endif
+}
+
+/*! \brief The DLPack context of an NDArray that views a mapped file. */
+struct MappedNDArrayContext {
+  std::shared_ptr<MappedFile> file;
+  ShapeTuple shape;
+  DLManagedTensor tensor;
+};
+
+NDArray NDArrayViewOfMappedFile(std::shared_ptr<MappedFile> file, size_t byte_offset,
+                                ShapeTuple shape, DLDataType dtype, Device device) {
+  ICHECK_EQ(device.device_type, kDLCPU) << "Only CPU NDArrays can view a mapped file.";
+  MappedNDArrayContext* ctx = new MappedNDArrayContext();
+  DLTensor& tensor = ctx->tensor.dl_tensor;
+  tensor.data = file->data() + byte_offset;
+  tensor.device = device;
+  tensor.ndim = static_cast<int>(shape.size());
+  tensor.dtype = dtype;
+  tensor.shape = const_cast<int64_t*>(shape.data());
+  tensor.strides = nullptr;
+  tensor.byte_offset = 0;
+  ctx->file = std::move(file);
+  ctx->shape = std::move(shape);
+  ctx->tensor.manager_ctx = ctx;
+  ctx->tensor.deleter = [](DLManagedTensor* self) {
+    delete static_cast<MappedNDArrayContext*>(self->manager_ctx);
+  };
+  return NDArray::FromDLPack(&ctx->tensor);
+}
+
 void SaveMetaDataToFile(const std::string& file_name,
                         const std::unordered_map<std::string, FunctionInfo>& fmap) {
   std::string version = "0.1.0";
@@ -250,6 +453,14 @@ TVM_REGISTER_GLOBAL("runtime.SaveParamsToFile")
       SaveParams(&strm, params);
     });
 
+TVM_REGISTER_GLOBAL("runtime.GetKernelCacheDir").set_body_typed([]() {
+  return String(GetKernelCacheDir());
+});
+
+TVM_REGISTER_GLOBAL("runtime.SetKernelCacheDir").set_body_typed([](const String& dir) {
+  SetKernelCacheDir(dir);
+});
+
 TVM_REGISTER_GLOBAL("runtime.LoadParams").set_body_typed([](const String& s) {
   return ::tvm::runtime::LoadParams(s);
 });
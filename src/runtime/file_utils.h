@@ -27,8 +27,10 @@
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "meta_data.h"
 
@@ -47,6 +49,53 @@ std::string GetFileFormat(const std::string& file_name, const std::string& forma
  */
 std::string GetCacheDir();
 
+/*!
+ * \brief Get the directory of the persistent cache of compiled device kernels.
+ *
+ * Runtimes that compile kernels when a module is loaded, such as the
+ * Vulkan pipelines and the OpenCL programs, keep the compiled
+ * binaries in this directory so that later processes skip the
+ * compilation.  It is set with TVM_KERNEL_CACHE_DIR or
+ * SetKernelCacheDir.
+ *
+ * \return The cache directory, or an empty string if the cache is disabled.
+ */
+std::string GetKernelCacheDir();
+
+/*!
+ * \brief Set the directory of the persistent kernel cache.
+ * \param dir The cache directory.  An empty string disables the cache.
+ */
+void SetKernelCacheDir(const std::string& dir);
+
+/*!
+ * \brief Compute the key of a kernel cache entry.
+ * \param parts The strings that identify the entry, e.g. the device,
+ *    the driver version and the kernel source.
+ * \return A hexadecimal digest of the parts, usable as a file name.
+ */
+std::string GetKernelCacheKey(const std::vector<std::string>& parts);
+
+/*!
+ * \brief Load an entry of the kernel cache.
+ * \param key The key of the entry, from GetKernelCacheKey.
+ * \param data The cached data.
+ * \return Whether the cache is enabled and holds a valid entry for the key.
+ */
+bool LoadKernelCacheEntry(const std::string& key, std::string* data);
+
+/*!
+ * \brief Save an entry of the kernel cache, if the cache is enabled.
+ *
+ * The entry is written to a temporary file first and then renamed, so
+ * that concurrent processes never read a partial entry.  Failures are
+ * reported as warnings, as the cache is only an optimization.
+ *
+ * \param key The key of the entry, from GetKernelCacheKey.
+ * \param data The data to be cached.
+ */
+void SaveKernelCacheEntry(const std::string& key, const std::string& data);
+
 /*!
  * \brief Get meta file path given file name and format.
  * \param file_name The name of the file.
@@ -74,6 +123,42 @@ void LoadBinaryFromFile(const std::string& file_name, std::string* data);
  */
 void SaveBinaryToFile(const std::string& file_name, const std::string& data);
 
+/*!
+ * \brief A read-only view of a whole file in memory.
+ * The file is memory-mapped where mmap is available, and read otherwise.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  char* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  std::string buffer_;
+#endif
+};
+
+/*!
+ * \brief Create an NDArray which views the bytes of a mapped file without copying them.
+ * The NDArray keeps the file mapped while it is alive.
+ * \param file The mapped file.
+ * \param byte_offset The offset of the data of the NDArray in the file.
+ * \param shape The shape of the NDArray.
+ * \param dtype The data type of the NDArray.
+ * \param device The device of the NDArray, which is a CPU device.
+ * \return The NDArray.
+ */
+NDArray NDArrayViewOfMappedFile(std::shared_ptr<MappedFile> file, size_t byte_offset,
+                                ShapeTuple shape, DLDataType dtype, Device device);
+
 /*!
  * \brief Save meta data to file.
  * \param file_name The name of the file.
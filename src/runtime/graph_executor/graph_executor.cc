@@ -31,12 +31,21 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -53,18 +62,307 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
   return align;
 }
 constexpr auto Is2DStorage = IsTextureStorage;
+
+/*! \brief A tensor of a parameter blob, whose data stays in the blob. */
+struct ParamBlobTensor {
+  std::string name;
+  const char* data;
+  size_t nbytes;
+};
+
+/*! \brief Parse a parameter blob without copying the data of its tensors. */
+std::vector<ParamBlobTensor> ParseParamBlob(const char* data, size_t size) {
+  dmlc::MemoryFixedSizeStream reader(const_cast<char*>(data), size);
+  dmlc::Stream* strm = &reader;
+  uint64_t header, reserved;
+  ICHECK(strm->Read(&header)) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
+  std::vector<std::string> names;
+  ICHECK(strm->Read(&names)) << "Invalid parameters file format";
+  uint64_t sz;
+  ICHECK(strm->Read(&sz)) << "Invalid parameters file format";
+  ICHECK(sz == names.size()) << "Invalid parameters file format";
+  std::vector<ParamBlobTensor> tensors;
+  for (const std::string& name : names) {
+    Device dev;
+    int ndim;
+    DLDataType dtype;
+    ICHECK(strm->Read(&header)) << "Invalid DLTensor file format";
+    ICHECK(header == kTVMNDArrayMagic) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&reserved)) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&dev)) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&ndim)) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&dtype)) << "Invalid DLTensor file format";
+    std::vector<int64_t> shape(ndim);
+    if (ndim != 0) {
+      ICHECK(strm->ReadArray(shape.data(), ndim)) << "Invalid DLTensor file format";
+    }
+    int64_t data_byte_size;
+    ICHECK(strm->Read(&data_byte_size)) << "Invalid DLTensor file format";
+    size_t offset = reader.Tell();
+    ICHECK(data_byte_size >= 0 && offset + data_byte_size <= size)
+        << "Invalid DLTensor file format";
+    tensors.push_back({name, data + offset, static_cast<size_t>(data_byte_size)});
+    reader.Seek(offset + data_byte_size);
+  }
+  return tensors;
+}
+
+/*!
+ * \brief The parameters shared by the executors which loaded the same parameter blob on the same
+ *  devices, counted by the number of executors holding them.
+ */
+class SharedParamRegistry {
+ public:
+  static SharedParamRegistry* Global() {
+    static SharedParamRegistry* inst = new SharedParamRegistry();
+    return inst;
+  }
+
+  /*!
+   * \brief Acquire the parameters of a key, which are loaded by `fload` when no executor holds
+   *  them. The executors acquiring a key being loaded wait for the load.
+   * \return The parameters, and whether they were loaded by `fload`.
+   */
+  std::pair<Map<String, NDArray>, bool> Acquire(
+      const std::string& key, const std::function<Map<String, NDArray>()>& fload) {
+    std::shared_ptr<Entry> entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::shared_ptr<Entry>& slot = entries_[key];
+      if (slot == nullptr) {
+        slot = std::make_shared<Entry>();
+      }
+      slot->num_refs += 1;
+      entry = slot;
+    }
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (entry->loaded) {
+      return {entry->params, false};
+    }
+    try {
+      entry->params = fload();
+    } catch (...) {
+      Release(key);
+      throw;
+    }
+    entry->loaded = true;
+    return {entry->params, true};
+  }
+
+  /*! \brief Release the parameters of a key, which are dropped with the last executor. */
+  void Release(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    ICHECK(it != entries_.end());
+    if (--it->second->num_refs == 0) {
+      entries_.erase(it);
+    }
+  }
+
+  int64_t NumEntries() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::mutex mutex;
+    Map<String, NDArray> params;
+    bool loaded = false;
+    int64_t num_refs = 0;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+};
 }  // namespace details
 
 /*!
  * \brief Run all the operations one by one.
  */
 void GraphExecutor::Run() {
+  if (sampler_ != nullptr && sampler_->StartRequest()) {
+    for (size_t i = 0; i < op_execs_.size(); ++i) {
+      if (!op_execs_[i]) continue;
+      sampler_->StartCall(i);
+      op_execs_[i]();
+      sampler_->StopCall();
+    }
+    sampler_->StopRequest();
+    return;
+  }
   // setup the array and requirements.
   for (size_t i = 0; i < op_execs_.size(); ++i) {
     if (op_execs_[i]) op_execs_[i]();
   }
 }
 
+void GraphExecutor::EnableSamplingProfiler(int sample_interval) {
+  CHECK_GE(sample_interval, 0) << "ValueError: The sample interval should not be negative, but got "
+                               << sample_interval;
+  if (sample_interval == 0) {
+    sampler_ = nullptr;
+    return;
+  }
+  sampler_ = std::make_unique<profiling::SamplingProfiler>(
+      sample_interval,
+      std::unordered_map<String, ObjectRef>{{String("Executor"), String("Graph")}});
+  for (uint32_t nid = 0; nid < nodes_.size(); ++nid) {
+    sampler_->RegisterCall(nodes_[nid].param.func_name, GetNodeDevice(nid));
+  }
+}
+
+std::string GraphExecutor::GetSamplingReport() {
+  CHECK(sampler_ != nullptr) << "ValueError: The sampling profiler is not enabled";
+  return sampler_->Report()->AsJSON();
+}
+
+void GraphExecutor::RunParallel(int num_workers) {
+  CHECK_GE(num_workers, 1) << "ValueError: The number of workers should be positive, but got "
+                           << num_workers;
+  bool on_device = std::any_of(op_nodes_.begin(), op_nodes_.end(), [this](uint32_t nid) {
+    return GetNodeDevice(nid).device_type != kDLCPU;
+  });
+  if (num_workers == 1 || op_nodes_.size() <= 1) {
+    Run();
+  } else if (on_device) {
+    RunOnStreams(num_workers);
+  } else {
+    RunOnThreads(num_workers);
+  }
+}
+
+void GraphExecutor::RunOnThreads(int num_threads) {
+  std::vector<size_t> num_pending(nodes_.size());
+  std::deque<uint32_t> ready;
+  for (uint32_t nid : op_nodes_) {
+    num_pending[nid] = op_deps_[nid].size();
+    if (num_pending[nid] == 0) ready.push_back(nid);
+  }
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t num_done = 0;
+  std::exception_ptr error = nullptr;
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&]() { return !ready.empty() || num_done == op_nodes_.size() || error; });
+      if (num_done == op_nodes_.size() || error) return;
+      uint32_t nid = ready.front();
+      ready.pop_front();
+      lock.unlock();
+      std::exception_ptr op_error = nullptr;
+      try {
+        op_execs_[nid]();
+      } catch (...) {
+        op_error = std::current_exception();
+      }
+      lock.lock();
+      if (op_error) {
+        error = op_error;
+        cv.notify_all();
+        return;
+      }
+      ++num_done;
+      for (uint32_t succ : op_succs_[nid]) {
+        if (--num_pending[succ] == 0) ready.push_back(succ);
+      }
+      cv.notify_all();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+void GraphExecutor::RunOnStreams(int num_streams) {
+  // The streams of a device, and the stream of the caller that they join at the end.
+  struct DeviceStreams {
+    Device dev;
+    TVMStreamHandle original;
+    std::vector<TVMStreamHandle> streams;
+  };
+  std::unordered_map<int, DeviceStreams> device_streams;
+  auto get_streams = [&](Device dev) -> DeviceStreams& {
+    auto it = device_streams.find(dev.device_type);
+    if (it == device_streams.end()) {
+      DeviceAPI* api = DeviceAPI::Get(dev);
+      DeviceStreams entry{dev, api->GetCurrentStream(dev), {}};
+      for (int i = 0; i < num_streams; ++i) {
+        entry.streams.push_back(api->CreateStream(dev));
+      }
+      it = device_streams.emplace(dev.device_type, std::move(entry)).first;
+    }
+    return it->second;
+  };
+  // The operations are issued in order from this thread, each on a stream of its device. An
+  // operation stays on the stream of its first producer that no other consumer has taken, so
+  // that chains share a stream and branches spread over the others.
+  std::vector<int> stream_of(nodes_.size(), -1);
+  std::vector<bool> stream_taken(nodes_.size(), false);
+  int next_stream = 0;
+  auto sync_host = [&](uint32_t dep) {
+    Device dep_dev = GetNodeDevice(dep);
+    DeviceAPI::Get(dep_dev)->StreamSync(dep_dev, get_streams(dep_dev).streams[stream_of[dep]]);
+  };
+  for (uint32_t nid : op_nodes_) {
+    Device dev = GetNodeDevice(nid);
+    if (dev.device_type == kDLCPU) {
+      // A host operation reads what the device operations before it produced.
+      for (uint32_t dep : op_deps_[nid]) {
+        if (stream_of[dep] >= 0) sync_host(dep);
+      }
+      op_execs_[nid]();
+      continue;
+    }
+    DeviceAPI* api = DeviceAPI::Get(dev);
+    DeviceStreams& streams = get_streams(dev);
+    for (uint32_t dep : op_deps_[nid]) {
+      if (stream_of[dep] >= 0 && !stream_taken[dep] &&
+          GetNodeDevice(dep).device_type == dev.device_type) {
+        stream_of[nid] = stream_of[dep];
+        stream_taken[dep] = true;
+        break;
+      }
+    }
+    if (stream_of[nid] < 0) {
+      stream_of[nid] = next_stream;
+      next_stream = (next_stream + 1) % num_streams;
+    }
+    TVMStreamHandle stream = streams.streams[stream_of[nid]];
+    for (uint32_t dep : op_deps_[nid]) {
+      if (stream_of[dep] < 0) continue;
+      if (GetNodeDevice(dep).device_type != dev.device_type) {
+        sync_host(dep);
+      } else if (stream_of[dep] != stream_of[nid]) {
+        api->SyncStreamFromTo(dev, streams.streams[stream_of[dep]], stream);
+      }
+    }
+    api->SetStream(dev, stream);
+    op_execs_[nid]();
+  }
+  // Join the streams back into the stream of the caller, which then sees the outputs.
+  for (auto& kv : device_streams) {
+    DeviceStreams& streams = kv.second;
+    DeviceAPI* api = DeviceAPI::Get(streams.dev);
+    for (TVMStreamHandle stream : streams.streams) {
+      api->SyncStreamFromTo(streams.dev, stream, streams.original);
+    }
+    api->SetStream(streams.dev, streams.original);
+    for (TVMStreamHandle stream : streams.streams) {
+      api->FreeStream(streams.dev, stream);
+    }
+  }
+}
+
 /*!
  * \brief Initialize the graph executor with graph and device.
  * \param graph_json The execution graph.
@@ -80,6 +378,11 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
   std::istringstream is(graph_json);
   dmlc::JSONReader reader(&is);
   this->Load(&reader);
+  this->Setup(module, devs, lookup_linked_param_func);
+}
+
+void GraphExecutor::Setup(tvm::runtime::Module module, const std::vector<Device>& devs,
+                          const PackedFunc lookup_linked_param_func) {
   module_ = module;
   devices_ = devs;
   lookup_linked_param_ = lookup_linked_param_func;
@@ -293,13 +596,111 @@ void GraphExecutor::CopyOutputTo(int index, DLTensor* data_out) {
   data_entry_[eid].CopyTo(data_out);
 }
 
+void GraphExecutor::InitAsync(int num_slots) {
+  CHECK_GE(num_slots, 1) << "ValueError: The number of staging slots should be positive, but got "
+                         << num_slots;
+  CHECK(staging_slots_.empty()) << "ValueError: The staging slots are already set up";
+  CHECK(!outputs_.empty()) << "ValueError: The graph has no output to stage";
+  staging_device_ = data_entry_[this->entry_id(outputs_[0])]->device;
+  DeviceAPI* api = DeviceAPI::Get(staging_device_);
+  compute_stream_ = api->CreateStream(staging_device_);
+  staging_slots_.resize(num_slots);
+  for (StagingSlot& slot : staging_slots_) {
+    slot.inputs.resize(input_nodes_.size());
+    for (const NodeEntry& output : outputs_) {
+      const NDArray& entry = data_entry_[this->entry_id(output)];
+      slot.outputs.push_back(NDArray::Empty(entry.Shape(), entry.DataType(), entry->device));
+    }
+    slot.upload_stream = api->CreateStream(staging_device_);
+    slot.download_stream = api->CreateStream(staging_device_);
+  }
+}
+
+GraphExecutor::StagingSlot& GraphExecutor::GetStagingSlot(int64_t request) {
+  CHECK(!staging_slots_.empty()) << "ValueError: The staging slots are not set up by init_async";
+  int64_t num_slots = staging_slots_.size();
+  CHECK(0 <= request && request < next_request_ && request >= next_request_ - num_slots)
+      << "ValueError: The request " << request << " is not in flight, the staging slots hold "
+      << "the requests from " << std::max<int64_t>(next_request_ - num_slots, 0) << " to "
+      << next_request_ - 1;
+  return staging_slots_[request % num_slots];
+}
+
+void GraphExecutor::SetInputAsync(int index, DLTensor* data_in) {
+  CHECK(!staging_slots_.empty()) << "ValueError: The staging slots are not set up by init_async";
+  ICHECK_LT(static_cast<size_t>(index), input_nodes_.size());
+  StagingSlot& slot = staging_slots_[next_request_ % staging_slots_.size()];
+  NDArray& staged = slot.inputs[index];
+  if (!staged.defined()) {
+    const NDArray& entry = data_entry_[this->entry_id(input_nodes_[index], 0)];
+    staged = NDArray::Empty(entry.Shape(), entry.DataType(), entry->device);
+  }
+  // The upload stream of the slot already waits for the run of the previous request of the slot.
+  NDArray::CopyFromTo(data_in, const_cast<DLTensor*>(staged.operator->()), slot.upload_stream);
+}
+
+int64_t GraphExecutor::RunAsync() {
+  CHECK(!staging_slots_.empty()) << "ValueError: The staging slots are not set up by init_async";
+  int64_t request = next_request_++;
+  StagingSlot& slot = staging_slots_[request % staging_slots_.size()];
+  DeviceAPI* api = DeviceAPI::Get(staging_device_);
+  api->SyncStreamFromTo(staging_device_, slot.upload_stream, compute_stream_);
+  api->SyncStreamFromTo(staging_device_, slot.download_stream, compute_stream_);
+  for (size_t i = 0; i < slot.inputs.size(); ++i) {
+    if (slot.inputs[i].defined()) {
+      SetInputZeroCopy(i, const_cast<DLTensor*>(slot.inputs[i].operator->()));
+    }
+  }
+  for (size_t i = 0; i < slot.outputs.size(); ++i) {
+    SetOutputZeroCopy(i, const_cast<DLTensor*>(slot.outputs[i].operator->()));
+  }
+  TVMStreamHandle original = api->GetCurrentStream(staging_device_);
+  api->SetStream(staging_device_, compute_stream_);
+  Run();
+  api->SetStream(staging_device_, original);
+  // The next uploads into the slot wait for this run, and so do the downloads of its outputs.
+  api->SyncStreamFromTo(staging_device_, compute_stream_, slot.upload_stream);
+  api->SyncStreamFromTo(staging_device_, compute_stream_, slot.download_stream);
+  return request;
+}
+
+void GraphExecutor::GetOutputAsync(int64_t request, int index, DLTensor* data_out) {
+  StagingSlot& slot = GetStagingSlot(request);
+  ICHECK_LT(static_cast<size_t>(index), slot.outputs.size());
+  const NDArray& data = slot.outputs[index];
+  ICHECK_EQ(data->ndim, data_out->ndim);
+  for (int32_t j = 0; j < data->ndim; ++j) {
+    ICHECK_EQ(data->shape[j], data_out->shape[j]);
+  }
+  NDArray::CopyFromTo(data.operator->(), data_out, slot.download_stream);
+}
+
+void GraphExecutor::WaitAsync(int64_t request) {
+  StagingSlot& slot = GetStagingSlot(request);
+  DeviceAPI::Get(staging_device_)->StreamSync(staging_device_, slot.download_stream);
+}
+
+GraphExecutor::~GraphExecutor() {
+  if (!shared_params_key_.empty()) {
+    details::SharedParamRegistry::Global()->Release(shared_params_key_);
+  }
+  if (staging_slots_.empty()) return;
+  DeviceAPI* api = DeviceAPI::Get(staging_device_);
+  api->StreamSync(staging_device_, compute_stream_);
+  api->FreeStream(staging_device_, compute_stream_);
+  for (StagingSlot& slot : staging_slots_) {
+    api->StreamSync(staging_device_, slot.download_stream);
+    api->FreeStream(staging_device_, slot.upload_stream);
+    api->FreeStream(staging_device_, slot.download_stream);
+  }
+}
+
 /*!
  * \brief Load parameters from parameter blob.
  * \param param_blob A binary blob of parameter.
  */
 void GraphExecutor::LoadParams(const std::string& param_blob) {
-  dmlc::MemoryStringStream strm(const_cast<std::string*>(&param_blob));
-  this->LoadParams(&strm);
+  this->LoadParams(param_blob.data(), param_blob.size());
 }
 
 void GraphExecutor::LoadParams(dmlc::Stream* strm) {
@@ -313,6 +714,87 @@ void GraphExecutor::LoadParams(dmlc::Stream* strm) {
   }
 }
 
+void GraphExecutor::LoadParams(const char* data, size_t size) {
+  if (!DMLC_IO_NO_ENDIAN_SWAP) {
+    // The data of the tensors is byte-swapped as it is read.
+    dmlc::MemoryFixedSizeStream strm(const_cast<char*>(data), size);
+    this->LoadParams(&strm);
+    return;
+  }
+  std::vector<details::ParamBlobTensor> tensors = details::ParseParamBlob(data, size);
+  std::vector<std::pair<const details::ParamBlobTensor*, uint32_t>> copies;
+  for (const details::ParamBlobTensor& tensor : tensors) {
+    param_names_.insert(tensor.name);
+    int in_idx = GetInputIndex(tensor.name);
+    if (in_idx < 0) continue;
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    // Checked here rather than in the copies, which run on the worker threads.
+    ICHECK_EQ(GetDataSize(*data_entry_[eid].operator->()), tensor.nbytes)
+        << "The size of parameter " << tensor.name << " does not match the graph";
+    copies.emplace_back(&tensor, eid);
+  }
+  parallel_for_with_threading_backend(
+      [&copies, this](int i) {
+        const auto& [tensor, eid] = copies[i];
+        data_entry_[eid].CopyFromBytes(tensor->data, tensor->nbytes);
+      },
+      0, copies.size());
+}
+
+void GraphExecutor::LoadParamsFromFile(const std::string& path, bool shared) {
+  MappedFile file(path);
+  if (shared) {
+    this->LoadSharedParams(file.data(), file.size());
+  } else {
+    this->LoadParams(file.data(), file.size());
+  }
+}
+
+void GraphExecutor::LoadSharedParams(const char* data, size_t size) {
+  ICHECK(shared_params_key_.empty()) << "The executor already holds shared parameters";
+  std::ostringstream key;
+  key << std::hash<std::string_view>()(std::string_view(data, size)) << ":" << size;
+  for (const Device& dev : devices_) {
+    key << ":" << dev.device_type << "." << dev.device_id;
+  }
+  auto [params, loaded] = details::SharedParamRegistry::Global()->Acquire(key.str(), [&]() {
+    this->LoadParams(data, size);
+    Map<String, NDArray> params;
+    for (const details::ParamBlobTensor& tensor : details::ParseParamBlob(data, size)) {
+      int in_idx = GetInputIndex(tensor.name);
+      if (in_idx < 0) continue;
+      params.Set(tensor.name, data_entry_[this->entry_id(input_nodes_[in_idx], 0)]);
+    }
+    return params;
+  });
+  shared_params_key_ = key.str();
+  if (loaded) return;
+  std::unordered_set<uint32_t> shared_eids;
+  for (const auto& [name, array] : params) {
+    param_names_.insert(name);
+    int in_idx = GetInputIndex(name);
+    if (in_idx < 0) continue;
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    const NDArray& entry = data_entry_[eid];
+    CHECK(entry.DataType() == array.DataType() &&
+          std::equal(entry->shape, entry->shape + entry->ndim, array->shape,
+                     array->shape + array->ndim))
+        << "The shared parameter " << name << " does not match the graph";
+    data_entry_[eid] = array;
+    data_alignment_[eid] = details::GetDataAlignment(*array.operator->());
+    shared_eids.insert(eid);
+  }
+  // Free the storage of the executor that only the shared parameters were planned in.
+  for (uint32_t eid : shared_eids) {
+    int sid = attrs_.storage_id[eid];
+    if (std::all_of(sid_to_eid_[sid].begin(), sid_to_eid_[sid].end(),
+                    [&](uint32_t other) { return shared_eids.count(other); })) {
+      storage_pool_[sid] = NDArray();
+    }
+  }
+  this->SetupOpExecs();
+}
+
 void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm) {
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
@@ -425,6 +907,10 @@ void GraphExecutor::SetupStorage() {
       size_t bits = t.bits * t.lanes;
       ICHECK(bits % 8U == 0U || bits == 1U || bits == 4U);
       int64_t bytes = ((bits + 7U) / 8U) * size;
+      // Entries of a storage pool are placed at offsets within the pool.
+      if (!attrs_.storage_offset.empty()) {
+        bytes += attrs_.storage_offset[i];
+      }
       pool_entry[sid].shape[0] = std::max(pool_entry[sid].shape[0], bytes);
       pool_entry[sid].dtype = DLDataType{kDLFloat, 32, 1};
     } else {
@@ -484,7 +970,15 @@ void GraphExecutor::SetupStorage() {
     sid_to_eid_[storage_id].push_back(i);
 
     ICHECK_LT(static_cast<size_t>(storage_id), storage_pool_.size());
-    data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i]);
+    uint64_t offset = attrs_.storage_offset.empty() ? 0 : attrs_.storage_offset[i];
+    data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i], offset);
+    if (offset != 0) {
+      // The kernels take their arguments at a zero byte offset, so fold the offset of the view
+      // into its data pointer, as for the tensors set without copies.
+      DLTensor* view = const_cast<DLTensor*>(data_entry_[i].operator->());
+      view->data = static_cast<char*>(view->data) + view->byte_offset;
+      view->byte_offset = 0;
+    }
 
     const DLTensor* tmp = data_entry_[i].operator->();
     data_alignment_[i] = details::GetDataAlignment(*tmp);
@@ -557,6 +1051,61 @@ void GraphExecutor::SetupOpExecs() {
       }
     }
   }
+  this->SetupOpDependencies();
+}
+
+void GraphExecutor::SetupOpDependencies() {
+  op_nodes_.clear();
+  op_deps_.assign(nodes_.size(), {});
+  op_succs_.assign(nodes_.size(), {});
+  // The last operation that wrote each storage, and the operations that read it since.
+  std::unordered_map<int, uint32_t> last_writer;
+  std::unordered_map<int, std::vector<uint32_t>> readers;
+  for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
+    const auto& inode = nodes_[nid];
+    if (inode.op_type == "null") continue;
+    std::vector<uint32_t> deps;
+    auto add_dep = [&](uint32_t dep) {
+      if (dep != nid && std::find(deps.begin(), deps.end(), dep) == deps.end()) {
+        deps.push_back(dep);
+      }
+    };
+    for (const auto& e : inode.inputs) {
+      int sid = attrs_.storage_id[this->entry_id(e)];
+      auto it = last_writer.find(sid);
+      if (it != last_writer.end()) add_dep(it->second);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      auto it = last_writer.find(sid);
+      if (it != last_writer.end()) add_dep(it->second);
+      for (uint32_t reader : readers[sid]) add_dep(reader);
+    }
+    for (const auto& e : inode.inputs) {
+      readers[attrs_.storage_id[this->entry_id(e)]].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      last_writer[sid] = nid;
+      readers[sid].clear();
+    }
+    for (uint32_t dep : deps) {
+      op_succs_[dep].push_back(nid);
+    }
+    op_deps_[nid] = std::move(deps);
+    op_nodes_.push_back(nid);
+  }
+}
+
+Device GraphExecutor::GetNodeDevice(uint32_t nid) const {
+  if (attrs_.device_index.empty() || nodes_[nid].param.num_outputs == 0) {
+    return devices_[0];
+  }
+  int device_type = attrs_.device_index[this->entry_id(nid, 0)];
+  auto it = std::find_if(devices_.begin(), devices_.end(), [device_type](const Device& d) {
+    return static_cast<int>(d.device_type) == device_type;
+  });
+  return it == devices_.end() ? devices_[0] : *it;
 }
 
 std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphExecutor::CreateTVMOp(
@@ -596,8 +1145,14 @@ std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphEx
   }
 
   // Get compiled function from the module that contains both host and device
-  // code.
-  tvm::runtime::PackedFunc pf = module_.GetFunction(param.func_name, true);
+  // code. The shapes of the tensors are fixed by the graph and the inputs are
+  // checked when they are set, so prefer the entry of the kernel that skips the
+  // argument checks, if it was emitted.
+  tvm::runtime::PackedFunc pf =
+      module_.GetFunction(param.func_name + symbol::tvm_unchecked_suffix, true);
+  if (pf == nullptr) {
+    pf = module_.GetFunction(param.func_name, true);
+  }
   ICHECK(pf != nullptr) << "no such function in module: " << param.func_name;
 
   auto fexec = [arg_ptr, pf]() {
@@ -678,6 +1233,41 @@ PackedFunc GraphExecutor::GetFunction(const String& name, const ObjectPtr<Object
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "enable_sampling_profiler") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->EnableSamplingProfiler(args[0]);
+    });
+  } else if (name == "get_sampling_report") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetSamplingReport(); });
+  } else if (name == "init_async") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->InitAsync(args[0]); });
+  } else if (name == "set_input_async") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int in_idx = 0;
+      if (String::CanConvertFrom(args[0])) {
+        in_idx = this->GetInputIndex(args[0].operator String());
+        CHECK_GE(in_idx, 0) << "ValueError: " << args[0].operator String()
+                            << " is not a valid input name";
+      } else {
+        in_idx = args[0];
+      }
+      this->SetInputAsync(in_idx, args[1]);
+    });
+  } else if (name == "run_async") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->RunAsync(); });
+  } else if (name == "get_output_async") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->GetOutputAsync(args[0], args[1], args[2]);
+    });
+  } else if (name == "wait_async") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->WaitAsync(args[0]); });
+  } else if (name == "run_parallel") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->RunParallel(args[0]); });
   } else if (name == "run_from_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -710,6 +1300,16 @@ PackedFunc GraphExecutor::GetFunction(const String& name, const ObjectPtr<Object
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       this->LoadParams(args[0].operator std::string());
     });
+  } else if (name == "load_params_from_file") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      bool shared = args.size() > 1 ? args[1].operator bool() : false;
+      this->LoadParamsFromFile(args[0].operator std::string(), shared);
+    });
+  } else if (name == "load_shared_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      const auto& param_blob = args[0].operator std::string();
+      this->LoadSharedParams(param_blob.data(), param_blob.size());
+    });
   } else if (name == "share_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       const auto& module = args[0].operator Module();
@@ -784,5 +1384,9 @@ TVM_REGISTER_GLOBAL("tvm.graph_executor.create").set_body([](TVMArgs args, TVMRe
   const auto& devices = GetAllDevice(args, dev_start_arg);
   *rv = GraphExecutorCreate(args[0], args[1], devices, lookup_linked_param_func);
 });
+
+TVM_REGISTER_GLOBAL("tvm.graph_executor.num_shared_params").set_body_typed([]() {
+  return details::SharedParamRegistry::Global()->NumEntries();
+});
 }  // namespace runtime
 }  // namespace tvm
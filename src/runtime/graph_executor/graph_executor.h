@@ -31,6 +31,7 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/profiling.h>
 
 #include <memory>
 #include <string>
@@ -92,6 +93,27 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   const char* type_key() const final { return "GraphExecutor"; }
   void Run();
+  /*!
+   * \brief Run the operations as their dependencies allow, instead of one by one.
+   *
+   *  Graphs of CPU operations run on `num_workers` threads. Graphs with device operations are
+   *  issued on `num_workers` streams of their device, which wait on each other through events
+   *  where an operation depends on one of another stream.
+   *
+   * \param num_workers The number of threads or streams.
+   */
+  void RunParallel(int num_workers);
+  /*!
+   * \brief Time the operations of one in `sample_interval` runs, with no synchronization of the
+   *  device, for the latency of each operation to be watched in production.
+   * \param sample_interval The number of runs per sampled run, or 0 to turn the sampling off.
+   */
+  void EnableSamplingProfiler(int sample_interval);
+  /*!
+   * \brief The report of the latency histograms of the operations in the sampled runs.
+   * \return The report as JSON, which can be sent over RPC.
+   */
+  std::string GetSamplingReport();
 
   /*! \brief Get the property of the runtime module .*/
   int GetPropertyMask() const final { return ModulePropertyMask::kRunnable; }
@@ -197,6 +219,28 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param param_blob A binary blob of parameter.
    */
   void LoadParams(const std::string& param_blob);
+  /*!
+   * \brief Load parameters from a parameter blob in memory, copying the tensors to their data
+   *  entries in parallel.
+   * \param data The parameter blob.
+   * \param size The size of the blob in bytes.
+   */
+  void LoadParams(const char* data, size_t size);
+  /*!
+   * \brief Load parameters from a parameter file, which is memory-mapped rather than read.
+   * \param path The path of the parameter file.
+   * \param shared Whether to share the parameters with the other executors, see LoadSharedParams.
+   */
+  void LoadParamsFromFile(const std::string& path, bool shared);
+  /*!
+   * \brief Load parameters shared by all the executors of the process which load the same
+   *  parameter blob on the same devices. The first one copies the parameters to its data entries,
+   *  and the others reuse them until all of them are destructed. The shared parameters should
+   *  not be set as inputs afterwards.
+   * \param data The parameter blob.
+   * \param size The size of the blob in bytes.
+   */
+  void LoadSharedParams(const char* data, size_t size);
 
   /*!
    * \brief Share parameters from pre-existing GraphExecutor instance.
@@ -206,6 +250,45 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   void ShareParams(const GraphExecutor& other, dmlc::Stream* strm);
 
+  /*!
+   * \brief Setup the staging slots of the asynchronous API, which pipelines the uploads of the
+   *  inputs, the runs and the downloads of the outputs of consecutive requests on separate
+   *  streams. The request k stages its inputs and outputs in the slot k % num_slots, so up to
+   *  num_slots requests are in flight. The runs write the outputs to the slots, through
+   *  SetInputZeroCopy and SetOutputZeroCopy, so the synchronous SetInput and GetOutput should not
+   *  be mixed with the asynchronous API afterwards.
+   * \param num_slots The number of staging slots, at least 2 to overlap consecutive requests.
+   */
+  void InitAsync(int num_slots);
+  /*!
+   * \brief Upload an input of the next request to its staging slot, on the upload stream of the
+   *  slot. The data should be in pinned host memory for the copy to be asynchronous.
+   * \param index The input index.
+   * \param data_in The input data.
+   */
+  void SetInputAsync(int index, DLTensor* data_in);
+  /*!
+   * \brief Issue the run of the next request on the compute stream, after the uploads of its
+   *  inputs and the downloads of the previous request of its slot.
+   * \return The id of the request.
+   */
+  int64_t RunAsync();
+  /*!
+   * \brief Download an output of a request on the download stream of its slot, after its run.
+   *  It should be issued before the run of the request that reuses the slot.
+   * \param request The id of the request.
+   * \param index The output index.
+   * \param data_out The output data.
+   */
+  void GetOutputAsync(int64_t request, int index, DLTensor* data_out);
+  /*!
+   * \brief Wait for the run of a request and the downloads of its outputs that were issued.
+   * \param request The id of the request.
+   */
+  void WaitAsync(int64_t request);
+
+  ~GraphExecutor();
+
   /*!
    * \brief Get total number of nodes.
    * \return Total number of nodes.
@@ -215,6 +298,15 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::string GetNodeName(uint32_t nid) const { return nodes_[nid].name; }
 
  protected:
+  friend class GraphExecutorMultiProfile;
+  /*!
+   * \brief Allocate the storage and create the executors of a loaded graph.
+   * \param module The module containing the compiled functions.
+   * \param devs The devices of the host and devices where graph nodes will be executed on.
+   * \param lookup_linked_param_func The linked parameter lookup function, or nullptr.
+   */
+  void Setup(tvm::runtime::Module module, const std::vector<Device>& devs,
+             const PackedFunc lookup_linked_param_func);
   // Memory pool entry.
   struct PoolEntry {
     int device_type;
@@ -316,6 +408,7 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   struct GraphAttr {
     size_t storage_num_not_alloctaed{0};
     std::vector<int> storage_id;
+    std::vector<int64_t> storage_offset;
     std::vector<int> device_index;
     std::vector<std::string> dltype;
     std::vector<std::string> storage_scope;
@@ -344,6 +437,14 @@ class TVM_DLL GraphExecutor : public ModuleNode {
           reader->Read(&storage_id);
           ICHECK(!reader->NextArrayItem());
           bitmask |= 2;
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          ICHECK(!reader->NextArrayItem());
         } else if (key == "storage_scope") {
           reader->BeginArray();
           ICHECK(reader->NextArrayItem());
@@ -428,6 +529,18 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   void SetupStorage();
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*!
+   * \brief Setup the dependencies between the executors, i.e. the producers of their inputs and,
+   *  since the memory plan shares storage between entries, the earlier readers and writers of the
+   *  storage of their outputs.
+   */
+  void SetupOpDependencies();
+  /*! \brief Run the operations of a CPU graph on a number of threads. */
+  void RunOnThreads(int num_threads);
+  /*! \brief Issue the operations of a device graph on a number of streams. */
+  void RunOnStreams(int num_streams);
+  /*! \brief Get the device of the operation of a node. */
+  Device GetNodeDevice(uint32_t nid) const;
   /*!
    * \brief Check the legality of external DLTensor*.
    * \param external The external DLTensor*.
@@ -484,6 +597,35 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()>> op_execs_;
+  /*! \brief The staging buffers and the streams of a slot of the asynchronous API. */
+  struct StagingSlot {
+    /*! \brief The staged inputs, only defined for the inputs that were set asynchronously. */
+    std::vector<NDArray> inputs;
+    /*! \brief The outputs that the runs of the slot write to. */
+    std::vector<NDArray> outputs;
+    /*! \brief The stream of the uploads of the inputs. */
+    TVMStreamHandle upload_stream = nullptr;
+    /*! \brief The stream of the downloads of the outputs. */
+    TVMStreamHandle download_stream = nullptr;
+  };
+  /*! \brief Get the slot of a request that is still staged. */
+  StagingSlot& GetStagingSlot(int64_t request);
+  /*! \brief The staging slots of the asynchronous API. */
+  std::vector<StagingSlot> staging_slots_;
+  /*! \brief The device of the staging slots. */
+  Device staging_device_;
+  /*! \brief The stream of the asynchronous runs. */
+  TVMStreamHandle compute_stream_ = nullptr;
+  /*! \brief The id of the next asynchronous request. */
+  int64_t next_request_ = 0;
+  /*! \brief The sampling profiler of the runs, whose call sites are the nodes. */
+  std::unique_ptr<profiling::SamplingProfiler> sampler_;
+  /*! \brief The operator nodes in execution order. */
+  std::vector<uint32_t> op_nodes_;
+  /*! \brief The operator nodes that each node waits for. */
+  std::vector<std::vector<uint32_t>> op_deps_;
+  /*! \brief The operator nodes that wait for each node. */
+  std::vector<std::vector<uint32_t>> op_succs_;
   /*! \brief Linked parameter lookup function. */
   PackedFunc lookup_linked_param_;
   /*! \brief Module's _lookup_linked_param function, used by DefaultLookupLinkedParam. */
@@ -493,6 +635,8 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * When the module does not include linked parmeters, module_lookup_linked_param_ will be nullptr.
    */
   bool module_lookup_linked_param_valid_;
+  /*! \brief The key of the shared parameters the executor holds, empty when it holds none. */
+  std::string shared_params_key_;
 };
 
 std::vector<Device> GetAllDevice(const TVMArgs& args, int dev_start_arg);
@@ -0,0 +1,237 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file graph_executor_multi_profile.cc
+ * \brief A graph executor over several profiles of a graph, e.g. compiled for several batch sizes.
+ */
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/registry.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "graph_executor.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Graph executor over several profiles of a graph, which differ in the shapes of their
+ *  inputs, such as the buckets of the batch size of a model.
+ *
+ *  The profiles share one set of parameters. The storage of a profile is only allocated when it is
+ *  first selected, which `set_input` does from the shape of the input it is given.
+ */
+class GraphExecutorMultiProfile : public ModuleNode {
+ public:
+  const char* type_key() const final { return "GraphExecutorMultiProfile"; }
+
+  int GetPropertyMask() const final { return ModulePropertyMask::kRunnable; }
+
+  /*!
+   * \brief Initialize the executor.
+   * \param graph_jsons The graph of each profile.
+   * \param modules The module of the compiled functions of each profile.
+   * \param devs The devices of the host and devices where graph nodes will be executed on.
+   */
+  void Init(const Array<String>& graph_jsons, const Array<Module>& modules,
+            const std::vector<Device>& devs) {
+    CHECK(!graph_jsons.empty()) << "ValueError: A multi-profile graph executor needs a profile";
+    CHECK_EQ(graph_jsons.size(), modules.size())
+        << "ValueError: Got " << graph_jsons.size() << " graphs but " << modules.size()
+        << " modules for the profiles";
+    for (size_t i = 0; i < graph_jsons.size(); ++i) {
+      auto exec = make_object<GraphExecutor>();
+      std::istringstream is(graph_jsons[i].operator std::string());
+      dmlc::JSONReader reader(&is);
+      exec->Load(&reader);
+      executors_.push_back(exec);
+      ready_.push_back(false);
+    }
+    modules_ = modules;
+    devices_ = devs;
+  }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "set_input") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->SelectProfileOfInput(args[0], args[1]);
+        Active()->GetFunction("set_input", active_).CallPacked(args, rv);
+      });
+    } else if (name == "set_input_zero_copy") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->SelectProfileOfInput(args[0], args[1]);
+        Active()->GetFunction("set_input_zero_copy", active_).CallPacked(args, rv);
+      });
+    } else if (name == "load_params") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->param_blob_ = args[0].operator std::string();
+        if (this->params_owner_ >= 0) {
+          // The other profiles share the arrays of the owner, which the parameters update.
+          this->executors_[this->params_owner_]->LoadParams(this->param_blob_);
+          return;
+        }
+        for (size_t i = 0; i < executors_.size(); ++i) {
+          if (ready_[i]) this->ShareParamsWith(i);
+        }
+      });
+    } else if (name == "select_profile") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int index = args[0];
+        CHECK(0 <= index && index < static_cast<int>(executors_.size()))
+            << "ValueError: The profile " << index << " is out of the " << executors_.size()
+            << " profiles";
+        this->Select(index);
+      });
+    } else if (name == "get_profile") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->active_index_; });
+    } else if (name == "get_num_profiles") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int>(this->executors_.size());
+      });
+    } else if (name == "share_params") {
+      return PackedFunc([sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+        LOG(FATAL) << "ValueError: The profiles of a multi-profile graph executor share the "
+                   << "parameters of load_params, and cannot share the ones of another executor";
+      });
+    }
+    // The other functions run on the selected profile at the time of the call.
+    if (!executors_[0]->GetFunction(name, executors_[0]).defined()) {
+      return PackedFunc();
+    }
+    return PackedFunc([sptr_to_self, this, name](TVMArgs args, TVMRetValue* rv) {
+      Active()->GetFunction(name, active_).CallPacked(args, rv);
+    });
+  }
+
+ private:
+  /*! \brief The selected profile, by default the first one. */
+  GraphExecutor* Active() {
+    if (active_index_ < 0) Select(0);
+    return static_cast<GraphExecutor*>(active_.get());
+  }
+
+  /*! \brief Select a profile, allocating its storage on first use. */
+  void Select(int index) {
+    if (!ready_[index]) {
+      executors_[index]->Setup(modules_[index], devices_, nullptr);
+      ready_[index] = true;
+      ShareParamsWith(index);
+    }
+    active_index_ = index;
+    active_ = executors_[index];
+  }
+
+  /*! \brief Load the parameters into a profile, or share them with the profile that has them. */
+  void ShareParamsWith(int index) {
+    if (param_blob_.empty()) return;
+    dmlc::MemoryStringStream strm(&param_blob_);
+    if (params_owner_ < 0) {
+      executors_[index]->LoadParams(&strm);
+      params_owner_ = index;
+    } else if (params_owner_ != index) {
+      executors_[index]->ShareParams(*executors_[params_owner_], &strm);
+    }
+  }
+
+  /*! \brief The shape of an input of a profile, or nullptr if it has no such input. */
+  const std::vector<int64_t>* InputShape(int index, const std::string& name) const {
+    const GraphExecutor& exec = *executors_[index];
+    for (uint32_t nid : exec.input_nodes_) {
+      if (exec.nodes_[nid].name == name) {
+        return &exec.attrs_.shape[exec.entry_id(nid, 0)];
+      }
+    }
+    return nullptr;
+  }
+
+  /*!
+   * \brief Select the profile whose input matches the shape of the data set to it, keeping the
+   *  selected profile when it matches.
+   */
+  void SelectProfileOfInput(const TVMArgValue& key, const TVMArgValue& value) {
+    std::string name;
+    if (String::CanConvertFrom(key)) {
+      name = key.operator String();
+    } else {
+      const GraphExecutor& exec = *executors_[0];
+      int index = key;
+      CHECK(0 <= index && index < static_cast<int>(exec.input_nodes_.size()))
+          << "ValueError: The input " << index << " is out of the inputs of the graph";
+      name = exec.nodes_[exec.input_nodes_[index]].name;
+    }
+    DLTensor* data = value;
+    std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+    auto matches = [&](int index) {
+      const std::vector<int64_t>* input_shape = InputShape(index, name);
+      return input_shape != nullptr && *input_shape == shape;
+    };
+    if (active_index_ >= 0 && matches(active_index_)) return;
+    bool is_input = false;
+    for (size_t i = 0; i < executors_.size(); ++i) {
+      if (matches(i)) {
+        Select(i);
+        return;
+      }
+      is_input |= InputShape(i, name) != nullptr;
+    }
+    // Like the graph executor, ignore the names that are not inputs of the graph.
+    if (!is_input) return;
+    std::ostringstream os;
+    for (size_t i = 0; i < shape.size(); ++i) {
+      os << (i ? ", " : "") << shape[i];
+    }
+    LOG(FATAL) << "ValueError: No profile of the graph has the input " << name << " of shape ("
+               << os.str() << ")";
+  }
+
+  /*! \brief The executor of each profile, whose graph is loaded. */
+  std::vector<ObjectPtr<GraphExecutor>> executors_;
+  /*! \brief Whether the storage of each profile is allocated. */
+  std::vector<bool> ready_;
+  /*! \brief The module of each profile. */
+  Array<Module> modules_;
+  /*! \brief The devices of the executors. */
+  std::vector<Device> devices_;
+  /*! \brief The serialized parameters shared by the profiles. */
+  std::string param_blob_;
+  /*! \brief The profile that holds the parameters which the others share. */
+  int params_owner_ = -1;
+  /*! \brief The selected profile. */
+  int active_index_ = -1;
+  /*! \brief The executor of the selected profile. */
+  ObjectPtr<Object> active_;
+};
+
+TVM_REGISTER_GLOBAL("tvm.graph_executor.create_multi_profile")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_GE(args.num_args, 4)
+          << "The expected number of arguments for graph_executor.create_multi_profile is at "
+          << "least 4, but it has " << args.num_args;
+      auto exec = make_object<GraphExecutorMultiProfile>();
+      exec->Init(args[0], args[1], GetAllDevice(args, 2));
+      *rv = Module(exec);
+    });
+
+}  // namespace runtime
+}  // namespace tvm
@@ -30,9 +30,11 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
 
 #include "../workspace_pool.h"
 #include "hexagon_common.h"
+#include "hexagon_dma_staging.h"
 
 namespace tvm {
 namespace runtime {
@@ -184,6 +186,10 @@ void HexagonDeviceAPI::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHan
   }
 }
 
+int HexagonDeviceAPI::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  return Global()->ThreadManager()->ParallelLaunch(flambda, cdata, num_task);
+}
+
 void HexagonDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to,
                                       size_t to_offset, size_t size, Device dev_from, Device dev_to,
                                       DLDataType type_hint, TVMStreamHandle stream) {
@@ -246,6 +252,25 @@ TVM_REGISTER_GLOBAL("device_api.hexagon.dma_end_group").set_body([](TVMArgs args
   *rv = static_cast<int32_t>(0);
 });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.dma_stage_tiles")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      uint32_t queue_id = static_cast<int>(args[0]);
+      void* src = args[1];
+      uint32_t tile_bytes = static_cast<int>(args[2]);
+      int64_t src_stride = args[3];
+      int num_tiles = args[4];
+      int num_slots = args[5];
+      bool bypass_cache = args[6];
+      PackedFunc compute = args[7];
+
+      HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
+      HexagonDMAStaging staging(api->UserDMA(), api->VtcmPool(), queue_id, tile_bytes, num_slots,
+                                bypass_cache);
+      staging.Run(src, src_stride, num_tiles,
+                  [&compute](int tile, void* vtcm) { compute(tile, vtcm); });
+      *rv = static_cast<int32_t>(0);
+    });
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.alloc_nd").set_body([](TVMArgs args, TVMRetValue* rv) {
   int32_t device_type = args[0];
   int32_t device_id = args[1];
@@ -304,6 +329,22 @@ TVM_REGISTER_GLOBAL("device_api.hexagon.vtcm_device_bytes")
       *rv = static_cast<int32_t>(api->VtcmPool()->VtcmDeviceBytes());
     });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.vtcm_pool_stats").set_body_typed([]() {
+  HexagonVtcmPoolStats stats = HexagonDeviceAPI::Global()->VtcmPool()->GetStats();
+  std::ostringstream os;
+  os << "{\"total_bytes\": " << stats.total_bytes
+     << ", \"allocated_bytes\": " << stats.allocated_bytes
+     << ", \"peak_allocated_bytes\": " << stats.peak_allocated_bytes
+     << ", \"free_bytes\": " << stats.free_bytes
+     << ", \"largest_free_bytes\": " << stats.largest_free_bytes
+     << ", \"num_free_segments\": " << stats.num_free_segments
+     << ", \"num_live_allocations\": " << stats.num_live_allocations
+     << ", \"num_allocs\": " << stats.num_allocs << ", \"num_frees\": " << stats.num_frees
+     << ", \"num_alloc_failures\": " << stats.num_alloc_failures
+     << ", \"fragmentation\": " << stats.fragmentation << "}";
+  return String(os.str());
+});
+
 TVM_REGISTER_GLOBAL("device_api.hexagon").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = HexagonDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
@@ -21,6 +21,7 @@
 #define TVM_RUNTIME_HEXAGON_HEXAGON_DEVICE_API_H_
 
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <map>
 #include <memory>
@@ -68,6 +69,8 @@ class HexagonDeviceAPI final : public DeviceAPI {
     CHECK_EQ(runtime_threads, nullptr);
     runtime_threads =
         std::make_unique<HexagonThreadManager>(threads, stack_size, pipe_size, hw_resources);
+    // Run the parallel loops of the kernels on the HVX threads
+    threading::SetParallelLauncher(ParallelLaunch);
 
     CHECK_EQ(runtime_dma, nullptr);
     runtime_dma = std::make_unique<HexagonUserDMA>();
@@ -79,6 +82,7 @@ class HexagonDeviceAPI final : public DeviceAPI {
     runtime_dma.reset();
 
     CHECK(runtime_threads) << "runtime_threads was not created in AcquireResources";
+    threading::SetParallelLauncher(nullptr);
     runtime_threads.reset();
 
     CHECK(runtime_hexbuffs) << "runtime_hexbuffs was not created in AcquireResources";
@@ -148,6 +152,12 @@ class HexagonDeviceAPI final : public DeviceAPI {
    */
   void CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHandle stream) final;
 
+  /*!
+   * \brief Run the tasks of a parallel loop on the HVX threads of the thread manager, the
+   * launcher of TVMBackendParallelLaunch while the runtime resources are acquired.
+   */
+  static int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task);
+
   HexagonThreadManager* ThreadManager() {
     CHECK(runtime_threads) << "runtime_threads has not been created";
     return runtime_threads.get();
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "hexagon_dma_staging.h"
+
+#include <algorithm>
+
+#include "hexagon_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+
+HexagonDMAStaging::HexagonDMAStaging(HexagonUserDMA* dma, HexagonVtcmPool* vtcm,
+                                     uint32_t queue_id, uint32_t tile_bytes, int num_slots,
+                                     bool bypass_cache)
+    : dma_(dma),
+      vtcm_(vtcm),
+      queue_id_(queue_id),
+      tile_bytes_(tile_bytes),
+      num_slots_(num_slots),
+      bypass_cache_(bypass_cache) {
+  CHECK(dma_ != nullptr);
+  CHECK(vtcm_ != nullptr);
+  CHECK_LT(queue_id, MAX_DMA_QUEUES);
+  CHECK_NE(queue_id, SYNC_DMA_QUEUE) << "The synchronous DMA queue cannot be used for staging";
+  CHECK_GT(tile_bytes, 0);
+  CHECK_GE(num_slots, 2) << "Staging needs at least two slots to overlap copies and compute";
+  // keep every slot aligned for HVX loads
+  slot_bytes_ = (tile_bytes + 0x7F) & ~uint32_t(0x7F);
+  slots_ = static_cast<char*>(vtcm_->Allocate(static_cast<size_t>(slot_bytes_) * num_slots_));
+}
+
+HexagonDMAStaging::~HexagonDMAStaging() {
+  dma_->Wait(queue_id_, 0);
+  vtcm_->Free(slots_, static_cast<size_t>(slot_bytes_) * num_slots_);
+}
+
+void HexagonDMAStaging::Issue(void* dst, const void* src) {
+  int ret = DMA_RETRY;
+  do {
+    ret = dma_->Copy(queue_id_, dst, const_cast<void*>(src), tile_bytes_, bypass_cache_);
+  } while (ret == DMA_RETRY);
+  CHECK(ret == DMA_SUCCESS) << "DMA of a " << tile_bytes_ << " bytes tile failed";
+}
+
+void HexagonDMAStaging::Run(const void* src, size_t src_stride, int num_tiles,
+                            const std::function<void(int, void*)>& compute) {
+  const char* src_char = static_cast<const char*>(src);
+  // fill every slot before processing the first tile
+  int issued = 0;
+  for (; issued < std::min(num_tiles, num_slots_); ++issued) {
+    Issue(Slot(issued), src_char + issued * src_stride);
+  }
+  for (int i = 0; i < num_tiles; ++i) {
+    // the copies are completed in order, so this leaves the later tiles in flight
+    dma_->Wait(queue_id_, static_cast<uint32_t>(issued - i - 1));
+    compute(i, Slot(i));
+    // the slot of tile i is free again
+    if (issued < num_tiles) {
+      Issue(Slot(issued), src_char + issued * src_stride);
+      ++issued;
+    }
+  }
+}
+
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
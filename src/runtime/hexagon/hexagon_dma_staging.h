@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef TVM_RUNTIME_HEXAGON_HEXAGON_DMA_STAGING_H_
+#define TVM_RUNTIME_HEXAGON_HEXAGON_DMA_STAGING_H_
+
+#include <functional>
+
+#include "hexagon_user_dma.h"
+#include "hexagon_vtcm_pool.h"
+
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+
+/*!
+ * \brief Double-buffered staging of tiles from DDR into VTCM.
+ *
+ * A ring of `num_slots` VTCM slots is allocated from the VTCM pool.  While tile i
+ * is processed from its slot, the user DMA engine copies the following tiles into
+ * the other slots, so that the transfers overlap with the HVX compute.  This is
+ * the runtime side of the schedule that `tir.LowerAsyncDMA` produces for a
+ * software-pipelined copy, for kernels that are written by hand.
+ */
+class HexagonDMAStaging {
+ public:
+  /*!
+   * \brief Allocate the VTCM slots.
+   * \param dma The user DMA engine.
+   * \param vtcm The VTCM pool the slots are allocated from.
+   * \param queue_id The virtual DMA queue, which must not be used by anything else meanwhile.
+   * \param tile_bytes The size of a tile.
+   * \param num_slots The number of slots, 2 for double buffering.
+   * \param bypass_cache Whether the DMA bypasses the cache.
+   */
+  HexagonDMAStaging(HexagonUserDMA* dma, HexagonVtcmPool* vtcm, uint32_t queue_id,
+                    uint32_t tile_bytes, int num_slots = 2, bool bypass_cache = false);
+
+  //! \brief Wait for the copies in flight and free the VTCM slots.
+  ~HexagonDMAStaging();
+
+  HexagonDMAStaging(const HexagonDMAStaging&) = delete;
+  HexagonDMAStaging& operator=(const HexagonDMAStaging&) = delete;
+  HexagonDMAStaging(HexagonDMAStaging&&) = delete;
+  HexagonDMAStaging& operator=(HexagonDMAStaging&&) = delete;
+
+  /*!
+   * \brief Stage tiles and process them in order.
+   * \param src The first tile, in DDR.
+   * \param src_stride The distance in bytes between two tiles in DDR.
+   * \param num_tiles The number of tiles.
+   * \param compute Called with the index of each tile and its copy in VTCM, which is
+   * only valid during the call.
+   */
+  void Run(const void* src, size_t src_stride, int num_tiles,
+           const std::function<void(int, void*)>& compute);
+
+  //! \brief Returns the size of a slot, the tile size rounded up to 128 bytes
+  uint32_t SlotBytes() const { return slot_bytes_; }
+
+ private:
+  //! \brief Issue the copy of a tile into a slot, retrying while the queue is full
+  void Issue(void* dst, const void* src);
+
+  //! \brief Returns the slot of a tile
+  void* Slot(int tile) const { return slots_ + (tile % num_slots_) * slot_bytes_; }
+
+  HexagonUserDMA* dma_;
+  HexagonVtcmPool* vtcm_;
+  uint32_t queue_id_;
+  uint32_t tile_bytes_;
+  uint32_t slot_bytes_;
+  int num_slots_;
+  bool bypass_cache_;
+  //! \brief The VTCM allocation holding all the slots
+  char* slots_{nullptr};
+};
+
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_HEXAGON_HEXAGON_DMA_STAGING_H_
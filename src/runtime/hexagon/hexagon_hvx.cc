@@ -36,8 +36,9 @@ HexagonHvx::HexagonHvx() { Acquire(); }
 HexagonHvx::~HexagonHvx() { Release(); }
 
 void HexagonHvx::Acquire() {
-  reserved_count_ = qurt_hvx_reserve(QURT_HVX_RESERVE_ALL);
-  CHECK(reserved_count_ == QURT_HVX_RESERVE_ALL) << "error reserving HVX: " << reserved_count_;
+  // Chips have from 2 to 4 HVX contexts, take all those that are available
+  reserved_count_ = qurt_hvx_reserve(QURT_HVX_RESERVE_ALL_AVAILABLE);
+  CHECK(reserved_count_ > 0) << "error reserving HVX: " << reserved_count_;
 }
 
 void HexagonHvx::Release() {
@@ -19,6 +19,10 @@
 
 #include "hexagon_thread_manager.h"
 
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+
 namespace tvm {
 namespace runtime {
 namespace hexagon {
@@ -49,6 +53,12 @@ HexagonThreadManager::HexagonThreadManager(unsigned num_threads, unsigned thread
     // objects in the thread context.
     htp_ = std::make_unique<HexagonHtp>();
     hvx_ = std::make_unique<HexagonHvx>();
+    // Only as many HVX threads as reserved contexts can lock one
+    for (unsigned i = 0; i < hw_resources_.size(); i++) {
+      if (IsHvx(hw_resources_[i]) && hw_resources_[i] - HVX_0 < hvx_->ReservedCount()) {
+        hvx_threads_.push_back(reinterpret_cast<TVMStreamHandle>(i));
+      }
+    }
   }
 
   DLOG(INFO) << "Spawning threads";
@@ -227,6 +237,62 @@ bool HexagonThreadManager::Dispatch(TVMStreamHandle stream, voidfunc f, void* ar
   return trysend == 0;
 }
 
+bool HexagonThreadManager::IsManagedThread() {
+  qurt_thread_t self = qurt_thread_get_id();
+  return std::find(threads_.begin(), threads_.end(), self) != threads_.end();
+}
+
+int HexagonThreadManager::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  if (hvx_threads_.empty() || IsManagedThread()) {
+    std::atomic<int> sync_counter{0};
+    TVMParallelGroupEnv env;
+    env.num_task = 1;
+    env.sync_handle = &sync_counter;
+    return (*flambda)(0, &env, cdata);
+  }
+  if (num_task == 0) num_task = NumHvxThreads();
+  CHECK_LE(num_task, NumHvxThreads())
+      << "Cannot run " << num_task << " parallel tasks on " << NumHvxThreads() << " HVX threads";
+
+  // In case Start() was never explicitly called, call it now to prevent deadlock
+  if (qurt_sem_get_val(&start_semaphore_) == 0) {
+    Start();
+  }
+
+  using threading::kSyncStride;
+  std::unique_ptr<std::atomic<int>[]> sync_counter(new std::atomic<int>[num_task * kSyncStride]);
+  for (int i = 0; i < num_task; i++) {
+    sync_counter[i * kSyncStride].store(0, std::memory_order_relaxed);
+  }
+  TVMParallelGroupEnv env;
+  env.num_task = num_task;
+  env.sync_handle = sync_counter.get();
+
+  std::atomic<int> result{0};
+  qurt_sem_t done;
+  qurt_sem_init_val(&done, 0);
+  std::vector<ParallelTask> tasks(num_task);
+  for (int i = 0; i < num_task; i++) {
+    tasks[i] = ParallelTask{flambda, cdata, &env, i, &result, &done};
+    while (!Dispatch(hvx_threads_[i], thread_parallel_task, &tasks[i])) {
+    }
+  }
+  for (int i = 0; i < num_task; i++) {
+    qurt_sem_down(&done);
+  }
+  qurt_sem_destroy(&done);
+  return result.load();
+}
+
+void HexagonThreadManager::thread_parallel_task(void* task) {
+  ParallelTask* t = static_cast<ParallelTask*>(task);
+  int ret = (*t->flambda)(t->task_id, t->env, t->cdata);
+  if (ret != 0) {
+    t->result->store(ret);
+  }
+  qurt_sem_up(t->done);
+}
+
 void HexagonThreadManager::Start() { thread_signal(&start_semaphore_); }
 
 void HexagonThreadManager::WaitOnThreads() {
@@ -326,8 +392,7 @@ void HexagonThreadManager::thread_exit(void* context) {
   unsigned index = tc->index;
   HardwareResourceType resource_type = tc->resource_type;
 
-  if ((resource_type == HVX_0) || (resource_type == HVX_1) || (resource_type == HVX_2) ||
-      (resource_type == HVX_3)) {
+  if (tc->hvx_locked) {
     tc->hvx->Unlock();
     DLOG(INFO) << "Thread " << index << " unlocked an HVX instance";
   } else if (resource_type == HTP_0) {
@@ -348,10 +413,16 @@ void HexagonThreadManager::thread_main(void* context) {
 
   DLOG(INFO) << "Thread " << index << " spawned";
 
-  if ((resource_type == HVX_0) || (resource_type == HVX_1) || (resource_type == HVX_2) ||
-      (resource_type == HVX_3)) {
-    tc->hvx->Lock();
-    DLOG(INFO) << "Thread " << index << " locked an HVX instance";
+  if (IsHvx(resource_type)) {
+    // Locking more contexts than reserved would block this thread for good
+    if (resource_type - HVX_0 < tc->hvx->ReservedCount()) {
+      tc->hvx->Lock();
+      tc->hvx_locked = true;
+      DLOG(INFO) << "Thread " << index << " locked an HVX instance";
+    } else {
+      LOG(WARNING) << "Thread " << index << " runs without HVX, only "
+                   << tc->hvx->ReservedCount() << " HVX instances are reserved";
+    }
   } else if (resource_type == HTP_0) {
     // TODO(HWE): Perform HTP lock/unlock in thread instead of HexagonHtp
     // tc->htp->Lock();
@@ -20,10 +20,12 @@
 #ifndef TVM_RUNTIME_HEXAGON_HEXAGON_THREAD_MANAGER_H_
 #define TVM_RUNTIME_HEXAGON_HEXAGON_THREAD_MANAGER_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -139,6 +141,21 @@ class HexagonThreadManager {
    *before retrying dispatch or 2) create a `HexagonThreadManager` with a larger pipe.
    */
   bool SyncFromTo(TVMStreamHandle signal_thread, TVMStreamHandle wait_thread);
+  /*!
+   * \brief Run the tasks of a parallel loop on the threads that locked an HVX context, with the
+   * semantics of TVMBackendParallelLaunch; blocking call.
+   * \param flambda The task.
+   * \param cdata The closure data of the task.
+   * \param num_task The number of tasks, 0 for one per HVX thread.
+   * \returns 0 when every task succeeded, otherwise the error code of a failed task.
+   * \note Tasks run on the calling thread, one after the other, when there is no HVX thread or
+   * when called from one of the threads of this manager, as for a nested parallel loop.
+   */
+  int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task);
+
+  //! \brief Number of threads that run the tasks of `ParallelLaunch`.
+  int NumHvxThreads() const { return static_cast<int>(hvx_threads_.size()); }
+
   //! \brief Unblock threads to start execution.
   void Start();
   //! \brief Unblock threads to start execution if `Start` has not already been called; blocking
@@ -153,6 +170,9 @@ class HexagonThreadManager {
     HexagonHvx* hvx;
     HexagonHtp* htp;
     uint64_t status;
+    //! \brief Whether the thread holds an HVX context, HVX threads beyond the reserved
+    //! count do not.
+    bool hvx_locked{false};
     ThreadContext(qurt_pipe_t* pipe, unsigned index, HardwareResourceType resource_type,
                   HexagonHvx* hvx, HexagonHtp* htp)
         : pipe(pipe), index(index), resource_type(resource_type), hvx(hvx), htp(htp), status(0) {
@@ -181,6 +201,25 @@ class HexagonThreadManager {
   //! `SyncFromTo`.
   static void thread_wait_free(void* semaphore);
 
+  //! \brief A task of `ParallelLaunch`.
+  struct ParallelTask {
+    FTVMParallelLambda flambda;
+    void* cdata;
+    TVMParallelGroupEnv* env;
+    int task_id;
+    std::atomic<int>* result;
+    qurt_sem_t* done;
+  };
+
+  //! \brief Void function executed by a thread to run a task of `ParallelLaunch`.
+  static void thread_parallel_task(void* task);
+
+  //! \brief Whether a resource type is an HVX context.
+  static bool IsHvx(HardwareResourceType type) { return type >= HVX_0 && type <= HVX_3; }
+
+  //! \brief Whether the calling thread is one of the threads of this manager.
+  bool IsManagedThread();
+
   //! \brief Void function executed by a thread to exit at time of destruction.
   static void thread_exit(void* context);
 
@@ -231,6 +270,9 @@ class HexagonThreadManager {
   //! \brief List of hardware resources
   std::vector<HardwareResourceType> hw_resources_;
 
+  //! \brief Threads holding an HVX context, which run the tasks of `ParallelLaunch`.
+  std::vector<TVMStreamHandle> hvx_threads_;
+
   //! \brief Whether or not resource managers should be created
   bool create_resource_managers_{false};
 
@@ -18,6 +18,8 @@
  */
 #include "hexagon_vtcm_pool.h"
 
+#include <algorithm>
+
 #include "HAP_compute_res.h"
 #include "hexagon_common.h"
 
@@ -64,46 +66,47 @@ HexagonVtcmPool::~HexagonVtcmPool() { HEXAGON_SAFE_CALL(HAP_compute_res_release(
 void* HexagonVtcmPool::Allocate(size_t nbytes) {
   std::lock_guard<std::mutex> lock(mutex_);
 
-  CHECK(!free_.empty()) << "No free VTCM";
   CHECK(nbytes >= 0x80) << "Minimum VTCM alloation must be 128 bytes - nbytes " << nbytes;
+  num_allocs_++;
 
-  // If this is not aligned on a 2k block, allocate from the end to avoid fragmentation
-  if (nbytes & size_t(0x7FF)) {
-    DLOG(INFO) << "VTCM nbytes requested: " << nbytes << " allocate from the end";
-    auto last_free_entry = free_.end();
-    last_free_entry--;
-    CHECK(last_free_entry->second >= nbytes)
-        << "Not enough contiguous VTCM space at the end to allocate";
-    char* ptr = last_free_entry->first + (last_free_entry->second - nbytes);
-    allocations_.emplace_back(std::pair<char*, size_t>(ptr, nbytes));
-    last_free_entry->second -= nbytes;
-    if (last_free_entry->second == 0) {
-      free_.erase(last_free_entry);
-    }
-    // DebugDump();
-    return ptr;
-  }
+  // If this is not aligned on a 2k block, allocate from the end of the segment to avoid
+  // fragmentation
+  bool from_end = nbytes & size_t(0x7FF);
 
-  auto entry_to_allocate = free_.begin();
+  // Best fit, ties go to the lowest segment for 2k blocks and to the highest one otherwise
+  auto entry_to_allocate = free_.end();
   for (auto it = free_.begin(); it != free_.end(); it++) {
-    if ((entry_to_allocate->second < nbytes || it->second < entry_to_allocate->second) &&
-        it->second >= nbytes) {
+    if (it->second < nbytes) continue;
+    if (entry_to_allocate == free_.end() || it->second < entry_to_allocate->second ||
+        (from_end && it->second == entry_to_allocate->second)) {
       entry_to_allocate = it;
-      if (entry_to_allocate->second == nbytes) {
-        break;
-      }
+      if (!from_end && it->second == nbytes) break;
     }
   }
-  CHECK(entry_to_allocate->second >= nbytes) << "Not enough contiguous VTCM space to allocate";
-  char* ptr = entry_to_allocate->first;
-  allocations_.emplace(allocations_.end(), std::pair<char*, size_t>(ptr, nbytes));
+  if (entry_to_allocate == free_.end()) {
+    num_alloc_failures_++;
+    HexagonVtcmPoolStats stats = GetStatsLocked();
+    CHECK(!free_.empty()) << "No free VTCM";
+    LOG(FATAL) << "Not enough contiguous VTCM space to allocate " << nbytes << " bytes, "
+               << stats.free_bytes << " bytes free in " << stats.num_free_segments
+               << " segments, the largest one has " << stats.largest_free_bytes << " bytes";
+  }
 
-  if (entry_to_allocate->second == nbytes) {
-    free_.erase(entry_to_allocate);
+  char* ptr;
+  if (from_end) {
+    DLOG(INFO) << "VTCM nbytes requested: " << nbytes << " allocate from the end";
+    ptr = entry_to_allocate->first + (entry_to_allocate->second - nbytes);
   } else {
+    ptr = entry_to_allocate->first;
     entry_to_allocate->first = entry_to_allocate->first + nbytes;
-    entry_to_allocate->second = entry_to_allocate->second - nbytes;
   }
+  entry_to_allocate->second -= nbytes;
+  if (entry_to_allocate->second == 0) {
+    free_.erase(entry_to_allocate);
+  }
+  allocations_.emplace_back(std::pair<char*, size_t>(ptr, nbytes));
+  allocated_bytes_ += nbytes;
+  peak_allocated_bytes_ = std::max(peak_allocated_bytes_, allocated_bytes_);
   // DebugDump();
   return ptr;
 }
@@ -117,6 +120,8 @@ void HexagonVtcmPool::Free(void* ptr, size_t nbytes) {
   CHECK(it != allocations_.end()) << "Attempted to free a pointer that had not been allocated";
   CHECK(it->second == nbytes) << "Attempted to free a different size than was allocated";
   allocations_.erase(it);
+  allocated_bytes_ -= nbytes;
+  num_frees_++;
 
   it = std::lower_bound(free_.begin(), free_.end(), std::pair<char*, size_t>(ptr_to_free, nbytes),
                         [](auto p, auto q) { return p.first <= q.first; });
@@ -151,6 +156,32 @@ void HexagonVtcmPool::Free(void* ptr, size_t nbytes) {
   // DebugDump();
 }
 
+HexagonVtcmPoolStats HexagonVtcmPool::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return GetStatsLocked();
+}
+
+HexagonVtcmPoolStats HexagonVtcmPool::GetStatsLocked() {
+  HexagonVtcmPoolStats stats;
+  stats.total_bytes = vtcm_allocated_size_;
+  stats.allocated_bytes = allocated_bytes_;
+  stats.peak_allocated_bytes = peak_allocated_bytes_;
+  for (auto entry : free_) {
+    stats.free_bytes += entry.second;
+    stats.largest_free_bytes = std::max(stats.largest_free_bytes, entry.second);
+  }
+  stats.num_free_segments = free_.size();
+  stats.num_live_allocations = allocations_.size();
+  stats.num_allocs = num_allocs_;
+  stats.num_frees = num_frees_;
+  stats.num_alloc_failures = num_alloc_failures_;
+  if (stats.free_bytes != 0) {
+    stats.fragmentation =
+        1.0 - static_cast<double>(stats.largest_free_bytes) / static_cast<double>(stats.free_bytes);
+  }
+  return stats;
+}
+
 void HexagonVtcmPool::DebugDump() {
   LOG(INFO) << "VTCM list state";
   for (auto entry : allocations_) {
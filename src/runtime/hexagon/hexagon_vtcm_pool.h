@@ -33,6 +33,30 @@ namespace tvm {
 namespace runtime {
 namespace hexagon {
 
+/*! \brief Usage and fragmentation statistics of the VTCM pool. */
+struct HexagonVtcmPoolStats {
+  //! \brief Size of the pool.
+  size_t total_bytes = 0;
+  //! \brief Bytes held by live allocations.
+  size_t allocated_bytes = 0;
+  //! \brief High-water mark of allocated_bytes.
+  size_t peak_allocated_bytes = 0;
+  //! \brief Bytes in free segments.
+  size_t free_bytes = 0;
+  //! \brief Size of the largest free segment, the largest allocation that can succeed.
+  size_t largest_free_bytes = 0;
+  //! \brief Number of free segments.
+  size_t num_free_segments = 0;
+  //! \brief Number of live allocations.
+  size_t num_live_allocations = 0;
+  //! \brief Number of calls to Allocate, Free, and failed Allocate.
+  size_t num_allocs = 0;
+  size_t num_frees = 0;
+  size_t num_alloc_failures = 0;
+  //! \brief 1 - largest_free_bytes / free_bytes, 0 when the free space is contiguous.
+  double fragmentation = 0;
+};
+
 class HexagonVtcmPool {
  public:
   //! \brief Allocates all of VTCM memory, and manages allocations from the runtime
@@ -54,6 +78,10 @@ class HexagonVtcmPool {
   HexagonVtcmPool& operator=(HexagonVtcmPool&&) = delete;
 
   /* \brief Allocate memory from the VTCM manager
+   *
+   * The smallest free segment that fits is used.  Sizes that are a multiple of 2k
+   * are taken from the start of the segment and other sizes from its end, so that
+   * small allocations stay packed together instead of splitting the 2k blocks.
    *
    * \param nbytes The number of bytes to allocate.
    */
@@ -73,6 +101,9 @@ class HexagonVtcmPool {
   //! \brief Returns the total number of bytes in this pool
   size_t VtcmAllocatedBytes() { return reinterpret_cast<size_t>(vtcm_allocated_size_); }
 
+  //! \brief Returns the usage and fragmentation statistics of this pool
+  HexagonVtcmPoolStats GetStats();
+
   bool IsVtcm(void* ptr, unsigned size) {
     auto char_ptr = static_cast<char*>(ptr);
     CHECK(char_ptr != nullptr);
@@ -107,6 +138,18 @@ class HexagonVtcmPool {
   //! \brief Mutext to protect access to the lists
   std::mutex mutex_;
 
+  //! \brief Bytes held by live allocations, and their high-water mark
+  size_t allocated_bytes_{0};
+  size_t peak_allocated_bytes_{0};
+
+  //! \brief Counters reported by GetStats
+  size_t num_allocs_{0};
+  size_t num_frees_{0};
+  size_t num_alloc_failures_{0};
+
+  //! \brief Statistics of the pool, requires mutex_
+  HexagonVtcmPoolStats GetStatsLocked();
+
   //! \brief Debug only dump of the state of the lists
   void DebugDump();
 };
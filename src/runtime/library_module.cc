@@ -27,7 +27,9 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -48,6 +50,23 @@ class LibraryModuleNode final : public ModuleNode {
   };
 
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    TVMBackendPackedCFunc faddr = GetFuncAddr(name);
+    if (faddr == nullptr) return PackedFunc();
+    return packed_func_wrapper_(faddr, sptr_to_self);
+  }
+
+ private:
+  /*!
+   * \brief Get the address of a function in the library.
+   * The found addresses are cached, since the symbol lookup of a library, a dlsym or a lookup
+   * in the registry of the system library under a lock, is repeated whenever a virtual machine
+   * is initialized. The missing functions are not cached, as the symbols of the system library
+   * can be registered later.
+   */
+  TVMBackendPackedCFunc GetFuncAddr(const String& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = func_addrs_.find(name);
+    if (it != func_addrs_.end()) return it->second;
     TVMBackendPackedCFunc faddr;
     if (name == runtime::symbol::tvm_module_main) {
       const char* entry_name =
@@ -58,13 +77,18 @@ class LibraryModuleNode final : public ModuleNode {
     } else {
       faddr = reinterpret_cast<TVMBackendPackedCFunc>(lib_->GetSymbol(name.c_str()));
     }
-    if (faddr == nullptr) return PackedFunc();
-    return packed_func_wrapper_(faddr, sptr_to_self);
+    if (faddr != nullptr) {
+      func_addrs_.emplace(name, faddr);
+    }
+    return faddr;
   }
 
- private:
   ObjectPtr<Library> lib_;
   PackedFuncWrapper packed_func_wrapper_;
+  /*! \brief The cached addresses of the functions. */
+  std::unordered_map<String, TVMBackendPackedCFunc> func_addrs_;
+  /*! \brief The mutex of the cache. */
+  std::mutex mutex_;
 };
 
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
@@ -100,6 +124,8 @@ void InitContextFunctions(std::function<void*(const char*)> fgetsymbol) {
   TVM_INIT_CONTEXT_FUNC(TVMBackendFreeWorkspace);
   TVM_INIT_CONTEXT_FUNC(TVMBackendParallelLaunch);
   TVM_INIT_CONTEXT_FUNC(TVMBackendParallelBarrier);
+  TVM_INIT_CONTEXT_FUNC(TVMBackendLoopProfileStart);
+  TVM_INIT_CONTEXT_FUNC(TVMBackendLoopProfileEnd);
 
 #undef TVM_INIT_CONTEXT_FUNC
 }
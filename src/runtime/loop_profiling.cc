@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/loop_profiling.cc
+ * \brief The host counters of the loops instrumented by InstrumentProfileIntrinsics, which the
+ * LLVM CPU codegen lowers to calls of `TVMBackendLoopProfileStart` and `TVMBackendLoopProfileEnd`.
+ */
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TVM_LOOP_PROFILE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TVM_LOOP_PROFILE_RDTSC 1
+#endif
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief Read the cycle counter of the host, or the steady clock where there is none. */
+inline uint64_t ReadCycleCounter() {
+#ifdef TVM_LOOP_PROFILE_RDTSC
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t value;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/*!
+ * \brief The counters of one thread, indexed by the loop id. A loop does not nest in itself, so
+ * one start per id is enough.
+ */
+struct LoopCounters {
+  std::vector<uint64_t> starts = std::vector<uint64_t>(kMaxProfiledLoops, 0);
+  std::vector<uint64_t> counts = std::vector<uint64_t>(kMaxProfiledLoops, 0);
+  std::vector<uint64_t> cycles = std::vector<uint64_t>(kMaxProfiledLoops, 0);
+};
+
+/*! \brief The counters of all the threads, which outlive the threads until they are read. */
+class LoopCounterRegistry {
+ public:
+  static LoopCounterRegistry* Global() {
+    static LoopCounterRegistry* inst = new LoopCounterRegistry();
+    return inst;
+  }
+
+  /*! \return The counters of the calling thread, registered at its first use. */
+  static LoopCounters* ThreadLocal() {
+    thread_local LoopCounters* counters = Global()->Register();
+    return counters;
+  }
+
+  Array<ShapeTuple> Dump(bool reset) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint64_t> counts(kMaxProfiledLoops, 0);
+    std::vector<uint64_t> cycles(kMaxProfiledLoops, 0);
+    for (const auto& counters : counters_) {
+      for (int32_t id = 0; id < kMaxProfiledLoops; ++id) {
+        counts[id] += counters->counts[id];
+        cycles[id] += counters->cycles[id];
+      }
+      if (reset) {
+        std::fill(counters->counts.begin(), counters->counts.end(), 0);
+        std::fill(counters->cycles.begin(), counters->cycles.end(), 0);
+      }
+    }
+    Array<ShapeTuple> result;
+    for (int32_t id = 0; id < kMaxProfiledLoops; ++id) {
+      if (counts[id] != 0) {
+        result.push_back(ShapeTuple({id, static_cast<int64_t>(counts[id]),
+                                     static_cast<int64_t>(cycles[id])}));
+      }
+    }
+    return result;
+  }
+
+ private:
+  LoopCounters* Register() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.push_back(std::make_unique<LoopCounters>());
+    return counters_.back().get();
+  }
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<LoopCounters>> counters_;
+};
+
+Array<ShapeTuple> DumpLoopProfile(bool reset) {
+  return LoopCounterRegistry::Global()->Dump(reset);
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.DumpLoopProfile").set_body_typed(DumpLoopProfile);
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+void TVMBackendLoopProfileStart(int32_t loop_id) {
+  using namespace tvm::runtime::profiling;
+  if (loop_id < 0 || loop_id >= kMaxProfiledLoops) return;
+  LoopCounterRegistry::ThreadLocal()->starts[loop_id] = ReadCycleCounter();
+}
+
+void TVMBackendLoopProfileEnd(int32_t loop_id) {
+  using namespace tvm::runtime::profiling;
+  uint64_t end = ReadCycleCounter();
+  if (loop_id < 0 || loop_id >= kMaxProfiledLoops) return;
+  LoopCounters* counters = LoopCounterRegistry::ThreadLocal();
+  counters->counts[loop_id] += 1;
+  counters->cycles[loop_id] += end - counters->starts[loop_id];
+}
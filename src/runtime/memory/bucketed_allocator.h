@@ -0,0 +1,403 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/bucketed_allocator.h
+ * \brief A pooled allocator with geometric size classes, best-fit reuse,
+ *  optional block splitting and lock sharding.
+ */
+#ifndef TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+/*!
+ * \brief Pooled allocator that caches freed buffers in geometric size classes.
+ *
+ * Unlike PooledAllocator, which only reuses a free buffer of exactly the same
+ * page-rounded size, requests are first rounded up to a size class (a page
+ * multiple below `num_sub_classes` pages, otherwise one of `num_sub_classes`
+ * evenly spaced steps within each power of two), and then served by the
+ * smallest cached block that fits (best fit).
+ *
+ * On devices whose data pointers support arithmetic (CPU, CUDA, ROCm), a
+ * larger cached block can be split and the remainder returned to the free
+ * list; neighbouring free blocks of the same device allocation are merged
+ * again when they are freed.
+ *
+ * The free lists are sharded so that threads allocating concurrently from
+ * the same device do not serialize on one lock. A thread always allocates
+ * from its own shard, and a buffer is returned to the shard it came from.
+ */
+class BucketedAllocator : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+  static constexpr size_t kDefaultNumSubClasses = 4;
+  static constexpr size_t kDefaultNumShards = 4;
+  /*!
+   * \brief Without splitting, a cached block is only reused when it is at
+   *  most this many times the size of the request.
+   */
+  static constexpr size_t kMaxReuseRatio = 2;
+
+  /*!
+   * \brief Construct the allocator.
+   * \param dev The device the allocator serves, used to decide whether splitting is legal.
+   * \param page_size The allocation granularity.
+   * \param num_sub_classes The number of size classes per power of two.
+   * \param num_shards The number of independently locked free lists.
+   * \param allow_split Whether to split large cached blocks, when the device supports it.
+   */
+  explicit BucketedAllocator(Device dev, size_t page_size = kDefaultPageSize,
+                             size_t num_sub_classes = kDefaultNumSubClasses,
+                             size_t num_shards = kDefaultNumShards, bool allow_split = true)
+      : Allocator(kBucketed),
+        page_size_(page_size),
+        num_sub_classes_(std::max<size_t>(num_sub_classes, 1)),
+        allow_split_(allow_split && SupportsPointerArithmetic(dev)),
+        used_memory_(0) {
+    ICHECK_GT(page_size_, 0);
+    num_shards = std::max<size_t>(num_shards, 1);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>());
+    }
+  }
+
+  ~BucketedAllocator() { ReleaseAll(); }
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    size_t size = SizeClass(nbytes);
+    Shard* shard = LocalShard();
+    {
+      std::lock_guard<std::mutex> lock(shard->mu);
+      if (Block* block = shard->FindBestFit(size, alignment, allow_split_)) {
+        if (allow_split_) shard->Split(block, size, page_size_);
+        return shard->Acquire(block, dev, nbytes, /*cache_hit=*/true);
+      }
+    }
+    // Allocate a new segment without holding the shard lock, so that slow device
+    // allocations do not block other threads that hit the cache.
+    void* data = nullptr;
+    try {
+      data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "BucketedAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      ReleaseAll();
+      data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    }
+    size_t used = used_memory_.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = peak_memory_.load(std::memory_order_relaxed);
+    while (used > peak && !peak_memory_.compare_exchange_weak(peak, used)) {
+    }
+    VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
+
+    std::lock_guard<std::mutex> lock(shard->mu);
+    Block* block = shard->NewSegment(data, size);
+    return shard->Acquire(block, dev, nbytes, /*cache_hit=*/false);
+  }
+
+  Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+               const std::string& mem_scope) override {
+    if (AllowMemoryScope(mem_scope)) {
+      return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+    }
+    LOG(FATAL) << "This alloc should be implemented";
+    return {};
+  }
+
+  void Free(const Buffer& buffer) override {
+    // Buffers are usually freed by the thread that allocated them, so look at
+    // the local shard first before searching the others.
+    Shard* local = LocalShard();
+    if (local->Release(buffer.data)) return;
+    for (const auto& shard : shards_) {
+      if (shard.get() != local && shard->Release(buffer.data)) return;
+    }
+    LOG(FATAL) << "BucketedAllocator: trying to free a buffer that was not allocated by it";
+  }
+
+  void Clear() override { ReleaseAll(); }
+
+  size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
+
+  AllocatorStats GetStats() const override {
+    AllocatorStats stats;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mu);
+      stats.live_bytes += shard->stats.live_bytes;
+      stats.rounding_waste_bytes += shard->stats.rounding_waste_bytes;
+      stats.num_allocs += shard->stats.num_allocs;
+      stats.num_frees += shard->stats.num_frees;
+      stats.num_cache_hits += shard->stats.num_cache_hits;
+      for (const Block* block : shard->free_blocks) {
+        stats.cached_bytes += block->size;
+      }
+      if (!shard->free_blocks.empty()) {
+        stats.largest_free_block =
+            std::max(stats.largest_free_block, (*shard->free_blocks.rbegin())->size);
+      }
+    }
+    stats.peak_bytes = peak_memory_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /*!
+   * \brief Round a request up to its size class.
+   * \param nbytes The requested number of bytes.
+   * \return The number of bytes that will be reserved for the request.
+   */
+  size_t SizeClass(size_t nbytes) const {
+    size_t size = RoundUp(std::max<size_t>(nbytes, 1), page_size_);
+    if (size <= page_size_ * num_sub_classes_) return size;
+    size_t msb = 1;
+    while (msb <= size / 2) msb <<= 1;
+    size_t step = std::max(msb / num_sub_classes_, page_size_);
+    return RoundUp(size, step);
+  }
+
+ protected:
+  virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
+                                     DLDataType type_hint) {
+    return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
+  }
+
+  virtual void DeviceFreeDataSpace(Device dev, void* ptr) {
+    DeviceAPI::Get(dev)->FreeDataSpace(dev, ptr);
+  }
+
+  /*! \brief Release every cached device allocation that is entirely free. */
+  virtual void ReleaseAll() {
+    for (const auto& shard : shards_) {
+      std::vector<std::pair<Device, void*>> released;
+      size_t released_bytes = 0;
+      {
+        std::lock_guard<std::mutex> lock(shard->mu);
+        released_bytes = shard->TakeFreeSegments(&released);
+      }
+      for (const auto& [dev, data] : released) {
+        DeviceFreeDataSpace(dev, data);
+      }
+      used_memory_.fetch_sub(released_bytes, std::memory_order_relaxed);
+    }
+    VLOG(1) << "release all buffers";
+  }
+
+ private:
+  /*!
+   * \brief A contiguous piece of a device allocation (segment).
+   *  Blocks of the same segment form a doubly linked list in address order.
+   */
+  struct Block {
+    /*! \brief The start of the block. */
+    void* data{nullptr};
+    /*! \brief The size of the block. */
+    size_t size{0};
+    /*! \brief The size requested by the current user of the block. */
+    size_t requested{0};
+    /*! \brief Whether the block is in the free list. */
+    bool free{false};
+    /*! \brief The device that owns the segment, valid once the block was acquired. */
+    Device device{kDLCPU, 0};
+    /*! \brief The neighbouring blocks of the same segment. */
+    Block* prev{nullptr};
+    Block* next{nullptr};
+  };
+
+  struct BlockLess {
+    using is_transparent = void;
+    bool operator()(const Block* lhs, const Block* rhs) const {
+      if (lhs->size != rhs->size) return lhs->size < rhs->size;
+      return lhs < rhs;
+    }
+    bool operator()(const Block* lhs, size_t rhs) const { return lhs->size < rhs; }
+    bool operator()(size_t lhs, const Block* rhs) const { return lhs < rhs->size; }
+  };
+
+  struct Shard {
+    mutable std::mutex mu;
+    /*! \brief The statistics of the allocations served by this shard. */
+    AllocatorStats stats;
+    /*! \brief Free blocks ordered by size for best-fit lookup. */
+    std::set<Block*, BlockLess> free_blocks;
+    /*! \brief All blocks owned by this shard, indexed by data pointer. */
+    std::unordered_map<void*, std::unique_ptr<Block>> blocks;
+
+    Block* FindBestFit(size_t size, size_t alignment, bool allow_split) {
+      for (auto it = free_blocks.lower_bound(size); it != free_blocks.end(); ++it) {
+        Block* block = *it;
+        if (!allow_split && block->size > size * kMaxReuseRatio) return nullptr;
+        if (!allow_split || reinterpret_cast<uintptr_t>(block->data) % alignment == 0) {
+          return block;
+        }
+      }
+      return nullptr;
+    }
+
+    void Split(Block* block, size_t size, size_t page_size) {
+      if (block->size - size < page_size) return;
+      auto rest = std::make_unique<Block>();
+      rest->data = static_cast<char*>(block->data) + size;
+      rest->size = block->size - size;
+      rest->device = block->device;
+      rest->prev = block;
+      rest->next = block->next;
+      if (block->next != nullptr) block->next->prev = rest.get();
+      block->next = rest.get();
+      free_blocks.erase(block);
+      block->size = size;
+      free_blocks.insert(block);
+      rest->free = true;
+      free_blocks.insert(rest.get());
+      blocks.emplace(rest->data, std::move(rest));
+    }
+
+    Block* NewSegment(void* data, size_t size) {
+      auto block = std::make_unique<Block>();
+      block->data = data;
+      block->size = size;
+      Block* ret = block.get();
+      blocks.emplace(data, std::move(block));
+      return ret;
+    }
+
+    Buffer Acquire(Block* block, Device dev, size_t nbytes, bool cache_hit) {
+      if (block->free) {
+        free_blocks.erase(block);
+        block->free = false;
+      }
+      block->device = dev;
+      block->requested = std::min(nbytes, block->size);
+      stats.live_bytes += block->size;
+      stats.rounding_waste_bytes += block->size - block->requested;
+      stats.num_allocs += 1;
+      stats.num_cache_hits += cache_hit;
+      Buffer buf;
+      buf.data = block->data;
+      buf.size = block->size;
+      buf.device = dev;
+      buf.alloc_type = kBucketed;
+      return buf;
+    }
+
+    /*! \brief Return a block to the free list, return false if it is not owned by the shard. */
+    bool Release(void* data) {
+      std::lock_guard<std::mutex> lock(mu);
+      auto it = blocks.find(data);
+      if (it == blocks.end()) return false;
+      Block* block = it->second.get();
+      ICHECK(!block->free) << "BucketedAllocator: double free of buffer " << data;
+      stats.live_bytes -= block->size;
+      stats.rounding_waste_bytes -= block->size - block->requested;
+      stats.num_frees += 1;
+      if (block->next != nullptr && block->next->free) {
+        Merge(block, block->next);
+      }
+      if (block->prev != nullptr && block->prev->free) {
+        Block* prev = block->prev;
+        free_blocks.erase(prev);
+        Merge(prev, block);
+        block = prev;
+      }
+      block->free = true;
+      free_blocks.insert(block);
+      VLOG(1) << "reclaim buffer " << block->size;
+      return true;
+    }
+
+    /*! \brief Merge the free block `rhs` into its left neighbour `lhs`. */
+    void Merge(Block* lhs, Block* rhs) {
+      if (rhs->free) free_blocks.erase(rhs);
+      lhs->size += rhs->size;
+      lhs->next = rhs->next;
+      if (rhs->next != nullptr) rhs->next->prev = lhs;
+      blocks.erase(rhs->data);
+    }
+
+    /*!
+     * \brief Remove every segment that consists of a single free block.
+     * \param released The segments to be freed on the device.
+     * \return The total size of the removed segments.
+     */
+    size_t TakeFreeSegments(std::vector<std::pair<Device, void*>>* released) {
+      size_t total = 0;
+      for (auto it = free_blocks.begin(); it != free_blocks.end();) {
+        Block* block = *it;
+        if (block->prev == nullptr && block->next == nullptr) {
+          released->emplace_back(block->device, block->data);
+          total += block->size;
+          it = free_blocks.erase(it);
+          blocks.erase(block->data);
+        } else {
+          ++it;
+        }
+      }
+      return total;
+    }
+  };
+
+  static size_t RoundUp(size_t value, size_t unit) { return (value + unit - 1) / unit * unit; }
+
+  static bool SupportsPointerArithmetic(Device dev) {
+    switch (static_cast<int>(dev.device_type)) {
+      case kDLCPU:
+      case kDLCUDA:
+      case kDLCUDAHost:
+      case kDLCUDAManaged:
+      case kDLROCM:
+      case kDLROCMHost:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  Shard* LocalShard() {
+    static std::atomic<size_t> next_thread_index{0};
+    thread_local size_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return shards_[thread_index % shards_.size()].get();
+  }
+
+  size_t page_size_;
+  size_t num_sub_classes_;
+  bool allow_split_;
+  std::atomic<size_t> used_memory_;
+  std::atomic<size_t> peak_memory_{0};
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
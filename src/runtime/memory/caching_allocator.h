@@ -0,0 +1,251 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/caching_allocator.h
+ * \brief A stream-ordered caching allocator with high-water-mark trimming.
+ */
+#ifndef TVM_RUNTIME_MEMORY_CACHING_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_CACHING_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+/*!
+ * \brief Caching allocator that is aware of the device stream a buffer was used on.
+ *
+ * When a buffer is freed, the current stream of the device is recorded with it.
+ * A cached buffer is handed out again right away to requests issued on the same
+ * stream, since work on one stream executes in order. A request on another stream
+ * prefers buffers cached from its own stream; if it has to take a buffer from a
+ * different stream, the reuse is ordered after the pending work of the previous
+ * stream with DeviceAPI::SyncStreamFromTo so the host never blocks.
+ *
+ * Whenever the total reserved memory exceeds the high-water mark, the least
+ * recently freed cached buffers are returned to the device until the reservation
+ * drops back below the mark, instead of dropping the whole cache at once.
+ */
+class CachingAllocator : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief A cached buffer is only reused when it is at most this many times the request. */
+  static constexpr size_t kMaxReuseRatio = 2;
+
+  /*!
+   * \brief Construct the allocator.
+   * \param page_size The allocation granularity.
+   * \param high_water_mark The number of reserved bytes above which idle cached buffers
+   *  are released. Zero means unlimited.
+   */
+  explicit CachingAllocator(size_t page_size = kDefaultPageSize, size_t high_water_mark = 0)
+      : Allocator(kCaching),
+        page_size_(page_size),
+        high_water_mark_(high_water_mark == 0 ? std::numeric_limits<size_t>::max()
+                                              : high_water_mark),
+        used_memory_(0) {}
+
+  ~CachingAllocator() { ReleaseAll(); }
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
+    TVMStreamHandle stream = DeviceAPI::Get(dev)->GetCurrentStream(dev);
+    auto it = FindCached(size, stream);
+    if (it != by_size_.end()) {
+      auto entry = it->second;
+      if (entry->stream != stream) {
+        // The previous stream may still be using the buffer, make the current stream wait.
+        DeviceAPI::Get(dev)->SyncStreamFromTo(dev, entry->stream, stream);
+      }
+      Buffer ret = entry->buffer;
+      by_size_.erase(it);
+      lru_.erase(entry);
+      cached_memory_ -= ret.size;
+      RecordAlloc(ret, nbytes, /*cache_hit=*/true);
+      return ret;
+    }
+    Buffer buf;
+    buf.device = dev;
+    buf.size = size;
+    buf.alloc_type = kCaching;
+    try {
+      buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "CachingAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      ReleaseAll();
+      buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    }
+
+    used_memory_.fetch_add(size, std::memory_order_relaxed);
+    peak_memory_ = std::max(peak_memory_, used_memory_.load(std::memory_order_relaxed));
+    RecordAlloc(buf, nbytes, /*cache_hit=*/false);
+    VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
+    return buf;
+  }
+
+  Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+               const std::string& mem_scope) override {
+    if (AllowMemoryScope(mem_scope)) {
+      return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+    }
+    LOG(FATAL) << "This alloc should be implemented";
+    return {};
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    TVMStreamHandle stream = DeviceAPI::Get(buffer.device)->GetCurrentStream(buffer.device);
+    lru_.push_back(CachedBuffer{buffer, stream, by_size_.end()});
+    auto entry = std::prev(lru_.end());
+    entry->pos = by_size_.emplace(buffer.size, entry);
+    cached_memory_ += buffer.size;
+    auto waste = rounding_waste_.find(buffer.data);
+    if (waste != rounding_waste_.end()) {
+      stats_.live_bytes -= buffer.size;
+      stats_.rounding_waste_bytes -= waste->second;
+      rounding_waste_.erase(waste);
+    }
+    stats_.num_frees += 1;
+    VLOG(1) << "reclaim buffer " << buffer.size;
+    Trim(high_water_mark_);
+  }
+
+  void Clear() override { ReleaseAll(); }
+
+  size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
+
+  AllocatorStats GetStats() const override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    AllocatorStats stats = stats_;
+    stats.cached_bytes = cached_memory_;
+    stats.peak_bytes = peak_memory_;
+    if (!by_size_.empty()) stats.largest_free_block = by_size_.rbegin()->first;
+    return stats;
+  }
+
+  /*!
+   * \brief Set the high-water mark and trim the cache to it.
+   * \param high_water_mark The number of reserved bytes to keep at most, zero means unlimited.
+   */
+  void SetHighWaterMark(size_t high_water_mark) {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    high_water_mark_ =
+        high_water_mark == 0 ? std::numeric_limits<size_t>::max() : high_water_mark;
+    Trim(high_water_mark_);
+  }
+
+ protected:
+  virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
+                                     DLDataType type_hint) {
+    return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
+  }
+
+  virtual void DeviceFreeDataSpace(Device dev, void* ptr) {
+    DeviceAPI::Get(dev)->FreeDataSpace(dev, ptr);
+  }
+
+  virtual void ReleaseAll() {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    Trim(0);
+    VLOG(1) << "release all buffers";
+  }
+
+ private:
+  struct CachedBuffer;
+  using LRUList = std::list<CachedBuffer>;
+  using SizeIndex = std::multimap<size_t, LRUList::iterator>;
+
+  /*! \brief A free buffer together with the stream it was last used on. */
+  struct CachedBuffer {
+    Buffer buffer;
+    TVMStreamHandle stream;
+    SizeIndex::iterator pos;
+  };
+
+  void RecordAlloc(const Buffer& buf, size_t nbytes, bool cache_hit) {
+    stats_.live_bytes += buf.size;
+    stats_.rounding_waste_bytes += buf.size - nbytes;
+    stats_.num_allocs += 1;
+    stats_.num_cache_hits += cache_hit;
+    rounding_waste_[buf.data] = buf.size - nbytes;
+  }
+
+  /*!
+   * \brief Find the smallest cached buffer that fits, preferring the given stream.
+   * \return The position in the size index, or by_size_.end() if nothing fits.
+   */
+  SizeIndex::iterator FindCached(size_t size, TVMStreamHandle stream) {
+    auto fallback = by_size_.end();
+    for (auto it = by_size_.lower_bound(size);
+         it != by_size_.end() && it->first <= size * kMaxReuseRatio; ++it) {
+      if (it->second->stream == stream) return it;
+      if (fallback == by_size_.end()) fallback = it;
+    }
+    return fallback;
+  }
+
+  /*! \brief Release least recently freed buffers until the reservation is at most `limit`. */
+  void Trim(size_t limit) {
+    while (!lru_.empty() && used_memory_.load(std::memory_order_relaxed) > limit) {
+      CachedBuffer& entry = lru_.front();
+      const Buffer& buf = entry.buffer;
+      // Make sure no pending work still refers to the buffer before returning it.
+      DeviceAPI::Get(buf.device)->StreamSync(buf.device, entry.stream);
+      DeviceFreeDataSpace(buf.device, buf.data);
+      used_memory_.fetch_sub(buf.size, std::memory_order_relaxed);
+      cached_memory_ -= buf.size;
+      by_size_.erase(entry.pos);
+      lru_.pop_front();
+    }
+  }
+
+  size_t page_size_;
+  size_t high_water_mark_;
+  std::atomic<size_t> used_memory_;
+  size_t peak_memory_{0};
+  size_t cached_memory_{0};
+  /*! \brief The rounding overhead of each live buffer. */
+  std::unordered_map<void*, size_t> rounding_waste_;
+  AllocatorStats stats_;
+  /*! \brief Cached buffers from the least to the most recently freed. */
+  LRUList lru_;
+  /*! \brief Cached buffers indexed by size. */
+  SizeIndex by_size_;
+  mutable std::recursive_mutex mu_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_CACHING_ALLOCATOR_H_
@@ -24,9 +24,13 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstdlib>
 #include <memory>
+#include <sstream>
 #include <utility>
 
+#include "bucketed_allocator.h"
+#include "caching_allocator.h"
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
 
@@ -147,6 +151,19 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
         alloc.reset(new PooledAllocator());
         break;
       }
+      case kBucketed: {
+        VLOG(1) << "New bucketed allocator for " << dev;
+        alloc.reset(new BucketedAllocator(dev));
+        break;
+      }
+      case kCaching: {
+        VLOG(1) << "New caching allocator for " << dev;
+        // The high-water mark (in bytes) of reserved memory, unlimited when unset.
+        const char* val = getenv("TVM_CACHING_ALLOCATOR_HIGH_WATER_MARK");
+        size_t high_water_mark = val ? std::strtoull(val, nullptr, 10) : 0;
+        alloc.reset(new CachingAllocator(CachingAllocator::kDefaultPageSize, high_water_mark));
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
@@ -186,6 +203,37 @@ void MemoryManager::Clear() {
   }
 }
 
+std::string MemoryManager::GetStatsJSON() {
+  MemoryManager* m = MemoryManager::Global();
+  std::lock_guard<std::mutex> lock(m->mu_);
+  std::ostringstream os;
+  os << "[";
+  bool first = true;
+  for (const auto& [device, allocators] : m->allocators_) {
+    for (const auto& [allocator_type, allocator] : allocators) {
+      AllocatorStats stats = allocator->GetStats();
+      double hit_rate = stats.num_allocs == 0 ? 0.0
+                                              : static_cast<double>(stats.num_cache_hits) /
+                                                    static_cast<double>(stats.num_allocs);
+      os << (first ? "" : ", ") << "{\"device_type\": " << static_cast<int>(device.device_type)
+         << ", \"device_id\": " << device.device_id
+         << ", \"allocator_type\": " << static_cast<int>(allocator_type)
+         << ", \"used_bytes\": " << allocator->UsedMemory()
+         << ", \"live_bytes\": " << stats.live_bytes
+         << ", \"cached_bytes\": " << stats.cached_bytes
+         << ", \"peak_bytes\": " << stats.peak_bytes
+         << ", \"rounding_waste_bytes\": " << stats.rounding_waste_bytes
+         << ", \"largest_free_block\": " << stats.largest_free_block
+         << ", \"num_allocs\": " << stats.num_allocs << ", \"num_frees\": " << stats.num_frees
+         << ", \"num_cache_hits\": " << stats.num_cache_hits
+         << ", \"cache_hit_rate\": " << hit_rate << "}";
+      first = false;
+    }
+  }
+  os << "]";
+  return os.str();
+}
+
 NDArray Allocator::Empty(ShapeTuple shape, DLDataType dtype, DLDevice dev,
                          Optional<String> mem_scope) {
   VerifyDataType(dtype);
@@ -222,6 +270,12 @@ Buffer Allocator::Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
   return {};
 }
 
+AllocatorStats Allocator::GetStats() const {
+  AllocatorStats stats;
+  stats.live_bytes = UsedMemory();
+  return stats;
+}
+
 void Allocator::Clear() {
   // This function by default does nothing.
   // For naive allocator, no explicit manual clear is needed.
@@ -230,6 +284,18 @@ void Allocator::Clear() {
 
 TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.clear").set_body_typed(MemoryManager::Clear);
 
+TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.stats").set_body_typed([]() {
+  return String(MemoryManager::GetStatsJSON());
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.set_high_water_mark")
+    .set_body_typed([](int device_type, int device_id, int64_t high_water_mark) {
+      Device dev{static_cast<DLDeviceType>(device_type), device_id};
+      auto* alloc = static_cast<CachingAllocator*>(
+          MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kCaching));
+      alloc->SetHighWaterMark(static_cast<size_t>(high_water_mark));
+    });
+
 }  // namespace memory
 }  // namespace runtime
 }  // namespace tvm
@@ -43,7 +43,7 @@ class NaiveAllocator final : public Allocator {
     buf.size = nbytes;
     buf.alloc_type = kNaive;
     buf.data = DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
-    used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    RecordAlloc(nbytes);
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -68,7 +68,7 @@ class NaiveAllocator final : public Allocator {
     buf.size = nbytes;
     buf.data = DeviceAPI::Get(dev)->AllocDataSpace(dev, shape.size(), shape.data(), type_hint,
                                                    String(mem_scope));
-    used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    RecordAlloc(nbytes);
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     buf.alloc_type = kNaive;
     return buf;
@@ -77,13 +77,34 @@ class NaiveAllocator final : public Allocator {
   void Free(const Buffer& buffer) override {
     DeviceAPI::Get(buffer.device)->FreeDataSpace(buffer.device, buffer.data);
     used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    num_frees_.fetch_add(1, std::memory_order_relaxed);
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
   }
 
   size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
 
+  AllocatorStats GetStats() const override {
+    AllocatorStats stats;
+    stats.live_bytes = used_memory_.load(std::memory_order_relaxed);
+    stats.peak_bytes = peak_memory_.load(std::memory_order_relaxed);
+    stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats.num_frees = num_frees_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
  private:
+  void RecordAlloc(size_t nbytes) {
+    size_t used = used_memory_.fetch_add(nbytes, std::memory_order_relaxed) + nbytes;
+    size_t peak = peak_memory_.load(std::memory_order_relaxed);
+    while (used > peak && !peak_memory_.compare_exchange_weak(peak, used)) {
+    }
+    num_allocs_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   std::atomic<size_t> used_memory_;
+  std::atomic<size_t> peak_memory_{0};
+  std::atomic<uint64_t> num_allocs_{0};
+  std::atomic<uint64_t> num_frees_{0};
 };
 
 }  // namespace memory
@@ -26,6 +26,7 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/memory/memory_manager.h>
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <string>
@@ -53,6 +54,7 @@ class PooledAllocator : public Allocator {
       auto&& pool = it->second;
       auto ret = pool.back();
       pool.pop_back();
+      RecordAlloc(ret, nbytes, /*cache_hit=*/true);
       return ret;
     }
     Buffer buf;
@@ -69,6 +71,8 @@ class PooledAllocator : public Allocator {
     }
 
     used_memory_.fetch_add(size, std::memory_order_relaxed);
+    peak_memory_ = std::max(peak_memory_, used_memory_.load(std::memory_order_relaxed));
+    RecordAlloc(buf, nbytes, /*cache_hit=*/false);
     VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -88,6 +92,13 @@ class PooledAllocator : public Allocator {
       memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
     }
     memory_pool_.at(buffer.size).push_back(buffer);
+    auto it = rounding_waste_.find(buffer.data);
+    if (it != rounding_waste_.end()) {
+      stats_.live_bytes -= buffer.size;
+      stats_.rounding_waste_bytes -= it->second;
+      rounding_waste_.erase(it);
+    }
+    stats_.num_frees += 1;
     VLOG(1) << "reclaim buffer " << buffer.size;
   }
 
@@ -95,7 +106,27 @@ class PooledAllocator : public Allocator {
 
   size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
 
+  AllocatorStats GetStats() const override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    AllocatorStats stats = stats_;
+    stats.peak_bytes = peak_memory_;
+    stats.cached_bytes = 0;
+    for (const auto& [size, pool] : memory_pool_) {
+      stats.cached_bytes += size * pool.size();
+      if (!pool.empty()) stats.largest_free_block = std::max(stats.largest_free_block, size);
+    }
+    return stats;
+  }
+
  protected:
+  void RecordAlloc(const Buffer& buf, size_t nbytes, bool cache_hit) {
+    stats_.live_bytes += buf.size;
+    stats_.rounding_waste_bytes += buf.size - nbytes;
+    stats_.num_allocs += 1;
+    stats_.num_cache_hits += cache_hit;
+    rounding_waste_[buf.data] = buf.size - nbytes;
+  }
+
   virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
                                      DLDataType type_hint) {
     return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
@@ -121,8 +152,12 @@ class PooledAllocator : public Allocator {
  protected:
   size_t page_size_;
   std::atomic<size_t> used_memory_;
+  size_t peak_memory_{0};
   std::unordered_map<size_t, std::vector<Buffer>> memory_pool_;
-  std::recursive_mutex mu_;
+  /*! \brief The rounding overhead of each live buffer. */
+  std::unordered_map<void*, size_t> rounding_waste_;
+  AllocatorStats stats_;
+  mutable std::recursive_mutex mu_;
 };
 
 }  // namespace memory
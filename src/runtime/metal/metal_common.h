@@ -28,6 +28,8 @@
 #import <Metal/MTLBuffer.h>
 #import <Metal/MTLCommandBuffer.h>
 #import <Metal/MTLCommandQueue.h>
+#import <Metal/MTLComputeCommandEncoder.h>
+#import <Metal/MTLComputePipeline.h>
 #import <Metal/MTLDevice.h>
 #import <Metal/MTLLibrary.h>
 #include <tvm/runtime/c_runtime_api.h>
@@ -103,12 +105,23 @@ class AutoReleasePoolWrapper {
 };
 
 /*!
- * \brief Structure for error handling in queues
+ * \brief A command queue that batches the work recorded on it.
+ *
+ * Kernel launches and copies are encoded into a pending command buffer which is
+ * only committed at a sync point, or once it holds max_batched_launches launches,
+ * so that back-to-back launches do not pay for a command buffer each.  Launches
+ * share a serial compute encoder, which keeps them ordered, and the pipeline
+ * state and buffer bindings left by the previous launch are not set again.
+ *
+ * The maximum batch size can be set with TVM_METAL_MAX_BATCHED_LAUNCHES,
+ * 1 commits every launch on its own.
+ *
+ * The error of a failed command buffer is kept and reported at the next sync.
  */
 class Stream {
  public:
-  explicit Stream(id<MTLDevice> device) { queue_ = [device newCommandQueue]; }
-  ~Stream() { [queue_ release]; }
+  explicit Stream(id<MTLDevice> device);
+  ~Stream();
   id<MTLCommandBuffer> GetCommandBuffer(std::string label = "", bool attach_error_callback = true) {
     id<MTLCommandBuffer> cb = [queue_ commandBuffer];
     if (!label.empty()) {
@@ -122,6 +135,42 @@ class Stream {
     }];
     return cb;
   }
+  /*!
+   * \brief Encode a kernel launch into the pending command buffer.
+   * \param kernel_name The kernel name, used in the error message.
+   * \param state The pipeline state of the kernel.
+   * \param buffers The buffer arguments, bound to indices [0, num_buffers).
+   * \param num_buffers The number of buffer arguments.
+   * \param pack_args The POD arguments, bound to index num_buffers, can be nullptr.
+   * \param pack_nbytes The size of pack_args.
+   * \param grid The number of threadgroups.
+   * \param block The number of threads per threadgroup.
+   */
+  void Dispatch(const std::string& kernel_name, id<MTLComputePipelineState> state,
+                const TVMValue* buffers, size_t num_buffers, const void* pack_args,
+                size_t pack_nbytes, MTLSize grid, MTLSize block);
+  /*! \brief Encode a copy between two buffers of the device into the pending command buffer. */
+  void EncodeCopy(id<MTLBuffer> from, size_t from_offset, id<MTLBuffer> to, size_t to_offset,
+                  size_t size);
+  /*!
+   * \brief Encode an upload from host memory.
+   *
+   * The data is copied to a staging buffer right away, so the host memory can be
+   * reused as soon as this returns, and the staging buffer is released once the
+   * command buffer completes.
+   */
+  void EncodeUpload(const void* from, id<MTLBuffer> to, size_t to_offset, size_t size);
+  /*!
+   * \brief Encode a readback into host memory.
+   *
+   * The host memory is only written by the next Synchronize and must stay alive
+   * until then.
+   */
+  void EncodeReadback(id<MTLBuffer> from, size_t from_offset, void* to, size_t size);
+  /*! \brief Commit the pending command buffer, if any, without waiting for it. */
+  void Flush();
+  /*! \brief Commit the pending work, wait for all of it and finish the pending readbacks. */
+  void Synchronize();
 
   void SetError(std::string error_description) {
     error_happened_ = true;
@@ -133,8 +182,46 @@ class Stream {
   const std::string& ErrorDescription() const { return error_description_; }
 
  private:
+  /*! \brief A readback waiting for its command buffer. */
+  struct PendingReadback {
+    id<MTLBuffer> staging;
+    void* dst;
+    size_t size;
+  };
+  // Get the pending command buffer, create it if needed.
+  id<MTLCommandBuffer> PendingCommandBuffer();
+  // Get a compute encoder on the pending command buffer.
+  id<MTLComputeCommandEncoder> PendingComputeEncoder();
+  // Get a blit encoder on the pending command buffer.
+  id<MTLBlitCommandEncoder> PendingBlitEncoder();
+  // End the open encoder of the pending command buffer.
+  void EndEncoding();
+  // Commit the pending command buffer, requires mutex_.
+  void FlushLocked();
+  // The device
+  id<MTLDevice> device_;
   // Queue
   id<MTLCommandQueue> queue_;
+  // Guards the pending command buffer, the default stream is shared by threads.
+  std::mutex mutex_;
+  // The command buffer being recorded, retained, or nil.
+  id<MTLCommandBuffer> pending_cb_{nil};
+  // The open encoders of pending_cb_, retained, at most one of them is not nil.
+  id<MTLComputeCommandEncoder> compute_encoder_{nil};
+  id<MTLBlitCommandEncoder> blit_encoder_{nil};
+  // The bindings of compute_encoder_.
+  id<MTLComputePipelineState> bound_state_{nil};
+  std::vector<id<MTLBuffer>> bound_buffers_;
+  // The kernels launched in pending_cb_, for error messages.
+  std::vector<std::string> pending_kernels_;
+  // The staging buffers to release once pending_cb_ completes.
+  std::vector<id<MTLBuffer>> pending_staging_;
+  // The total size of pending_staging_.
+  size_t pending_staging_bytes_{0};
+  // The readbacks to finish at the next sync.
+  std::vector<PendingReadback> pending_readbacks_;
+  // The number of launches after which the pending command buffer is committed.
+  size_t max_batched_launches_;
   // Check if error happened in one previous run
   bool error_happened_{false};
   // error description
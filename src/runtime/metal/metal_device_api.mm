@@ -23,6 +23,11 @@
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
 #include "metal_common.h"
 
 namespace tvm {
@@ -34,6 +39,194 @@ AutoReleasePoolWrapper& AutoReleasePoolWrapper::GetInstance() {
   return instance;
 }
 
+/*! \brief The default number of launches batched into one command buffer. */
+static constexpr size_t kDefaultMaxBatchedLaunches = 64;
+/*! \brief The staging memory after which pending uploads are committed. */
+static constexpr size_t kMaxPendingStagingBytes = 256 << 20;
+
+Stream::Stream(id<MTLDevice> device) : device_(device) {
+  queue_ = [device newCommandQueue];
+  max_batched_launches_ = kDefaultMaxBatchedLaunches;
+  if (const char* env = std::getenv("TVM_METAL_MAX_BATCHED_LAUNCHES")) {
+    max_batched_launches_ = static_cast<size_t>(std::max(1, std::atoi(env)));
+  }
+}
+
+Stream::~Stream() {
+  AUTORELEASEPOOL { this->Synchronize(); };
+  [queue_ release];
+}
+
+id<MTLCommandBuffer> Stream::PendingCommandBuffer() {
+  if (pending_cb_ == nil) {
+    pending_cb_ = [[queue_ commandBuffer] retain];
+    pending_cb_.label = @"TVMBatch";
+  }
+  return pending_cb_;
+}
+
+void Stream::EndEncoding() {
+  if (compute_encoder_ != nil) {
+    [compute_encoder_ endEncoding];
+    [compute_encoder_ release];
+    compute_encoder_ = nil;
+  }
+  if (blit_encoder_ != nil) {
+    [blit_encoder_ endEncoding];
+    [blit_encoder_ release];
+    blit_encoder_ = nil;
+  }
+}
+
+id<MTLComputeCommandEncoder> Stream::PendingComputeEncoder() {
+  if (compute_encoder_ != nil) return compute_encoder_;
+  id<MTLCommandBuffer> cb = PendingCommandBuffer();
+  EndEncoding();
+  compute_encoder_ = [[cb computeCommandEncoder] retain];
+  bound_state_ = nil;
+  bound_buffers_.clear();
+  return compute_encoder_;
+}
+
+id<MTLBlitCommandEncoder> Stream::PendingBlitEncoder() {
+  if (blit_encoder_ != nil) return blit_encoder_;
+  id<MTLCommandBuffer> cb = PendingCommandBuffer();
+  EndEncoding();
+  blit_encoder_ = [[cb blitCommandEncoder] retain];
+  return blit_encoder_;
+}
+
+void Stream::Dispatch(const std::string& kernel_name, id<MTLComputePipelineState> state,
+                      const TVMValue* buffers, size_t num_buffers, const void* pack_args,
+                      size_t pack_nbytes, MTLSize grid, MTLSize block) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  id<MTLComputeCommandEncoder> encoder = PendingComputeEncoder();
+  if (bound_state_ != state) {
+    [encoder setComputePipelineState:state];
+    bound_state_ = state;
+  }
+  if (bound_buffers_.size() <= num_buffers) {
+    bound_buffers_.resize(num_buffers + 1, nil);
+  }
+  for (size_t i = 0; i < num_buffers; ++i) {
+    id<MTLBuffer> buf = (id<MTLBuffer>)(buffers[i].v_handle);
+    if (bound_buffers_[i] != buf) {
+      [encoder setBuffer:buf offset:0 atIndex:i];
+      bound_buffers_[i] = buf;
+    }
+  }
+  if (pack_nbytes != 0) {
+    [encoder setBytes:pack_args length:pack_nbytes atIndex:num_buffers];
+    // the bytes replace whatever buffer was bound at this index
+    bound_buffers_[num_buffers] = nil;
+  }
+  [encoder dispatchThreadgroups:grid threadsPerThreadgroup:block];
+  pending_kernels_.push_back(kernel_name);
+  if (pending_kernels_.size() >= max_batched_launches_) {
+    this->FlushLocked();
+  }
+}
+
+void Stream::EncodeCopy(id<MTLBuffer> from, size_t from_offset, id<MTLBuffer> to,
+                        size_t to_offset, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  [PendingBlitEncoder() copyFromBuffer:from
+                          sourceOffset:from_offset
+                              toBuffer:to
+                     destinationOffset:to_offset
+                                  size:size];
+}
+
+void Stream::EncodeUpload(const void* from, id<MTLBuffer> to, size_t to_offset, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  id<MTLBuffer> staging = [device_ newBufferWithBytes:from
+                                               length:size
+                                              options:MTLResourceStorageModeShared];
+  ICHECK(staging != nil) << "Failed to allocate a staging buffer of " << size << " bytes";
+  [PendingBlitEncoder() copyFromBuffer:staging
+                          sourceOffset:0
+                              toBuffer:to
+                     destinationOffset:to_offset
+                                  size:size];
+  pending_staging_.push_back(staging);
+  pending_staging_bytes_ += size;
+  // do not hold on to a copy of a whole model while its weights are uploaded
+  if (pending_staging_bytes_ >= kMaxPendingStagingBytes) {
+    this->FlushLocked();
+  }
+}
+
+void Stream::EncodeReadback(id<MTLBuffer> from, size_t from_offset, void* to, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  id<MTLBuffer> staging = [device_ newBufferWithLength:size options:MTLResourceStorageModeShared];
+  ICHECK(staging != nil) << "Failed to allocate a staging buffer of " << size << " bytes";
+  [PendingBlitEncoder() copyFromBuffer:from
+                          sourceOffset:from_offset
+                              toBuffer:staging
+                     destinationOffset:0
+                                  size:size];
+  pending_readbacks_.push_back(PendingReadback{staging, to, size});
+}
+
+void Stream::FlushLocked() {
+  if (pending_cb_ == nil) return;
+  EndEncoding();
+  std::vector<std::string> kernels;
+  std::vector<id<MTLBuffer>> staging;
+  kernels.swap(pending_kernels_);
+  staging.swap(pending_staging_);
+  pending_staging_bytes_ = 0;
+  [pending_cb_ addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+    if (buffer.status == MTLCommandBufferStatusError) {
+      ICHECK(buffer.error != nil);
+      std::ostringstream os;
+      os << "GPUError happens after running ";
+      if (kernels.empty()) {
+        os << "TVMCopyDataFromTo";
+      } else if (kernels.size() == 1) {
+        os << kernels[0];
+      } else {
+        os << "one of [";
+        for (size_t i = 0; i < kernels.size(); ++i) {
+          os << (i == 0 ? "" : ", ") << kernels[i];
+        }
+        os << "]";
+      }
+      os << ": " << buffer.error.localizedDescription.UTF8String;
+      this->SetError(os.str());
+    }
+    for (id<MTLBuffer> buf : staging) {
+      [buf release];
+    }
+  }];
+  [pending_cb_ commit];
+  [pending_cb_ release];
+  pending_cb_ = nil;
+}
+
+void Stream::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  this->FlushLocked();
+}
+
+void Stream::Synchronize() {
+  std::vector<PendingReadback> readbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->FlushLocked();
+    readbacks.swap(pending_readbacks_);
+  }
+  // commit an empty command buffer and wait until it completes.
+  id<MTLCommandBuffer> cb = this->GetCommandBuffer(/*label=*/"TVMStreamSync");
+  [cb commit];
+  [cb waitUntilCompleted];
+  for (const PendingReadback& rb : readbacks) {
+    memcpy(rb.dst, [rb.staging contents], rb.size);
+    [rb.staging setPurgeableState:MTLPurgeableStateEmpty];
+    [rb.staging release];
+  }
+}
+
 MetalWorkspace* MetalWorkspace::Global() {
   // NOTE: explicitly use new to avoid exit-time destruction of global state
   // Global state will be recycled by OS as the process exits.
@@ -91,6 +284,8 @@ void MetalWorkspace::GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) {
         return;
       case kAvailableGlobalMemory:
         return;
+      case kPeerTopology:
+        return;
       case kTotalGlobalMemory: {
         *rv = static_cast<int64_t>([devices[dev.device_id] recommendedMaxWorkingSetSize]);
         return;
@@ -227,52 +422,37 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "GPUError: " << s->ErrorDescription();
     }
-    id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMCopyDataFromTo");
     int from_dev_type = static_cast<int>(dev_from.device_type);
     int to_dev_type = static_cast<int>(dev_to.device_type);
 
     if (from_dev_type == kDLMetal && to_dev_type == kDLMetal) {
       ICHECK_EQ(dev_from.device_id, dev_to.device_id) << "Metal disallow cross device copy.";
-      id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
-      [encoder copyFromBuffer:(id<MTLBuffer>)(from)
-                 sourceOffset:from_offset
-                     toBuffer:(id<MTLBuffer>)(to)destinationOffset:to_offset
-                         size:size];
-      [encoder endEncoding];
-      [cb commit];
+      s->EncodeCopy((id<MTLBuffer>)(from), from_offset, (id<MTLBuffer>)(to), to_offset, size);
     } else if (from_dev_type == kDLMetal && to_dev_type == kDLCPU) {
-      // copy to a local buffer before get into global buffer.
       id<MTLBuffer> from_buf = (id<MTLBuffer>)(from);
-      if (from_buf.storageMode != MTLStorageModeShared) {
-        id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_from, size);
-        id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
-        [encoder copyFromBuffer:from_buf
-                   sourceOffset:from_offset
-                       toBuffer:temp
-              destinationOffset:0
-                           size:size];
-        [encoder endEncoding];
-        [cb commit];
-        [cb waitUntilCompleted];
-        memcpy(static_cast<char*>(to) + to_offset, static_cast<char*>([temp contents]), size);
-      } else {
+      if (from_buf.storageMode == MTLStorageModeShared) {
+        // the pending kernels may still write to the buffer.
+        s->Synchronize();
         memcpy(static_cast<char*>(to) + to_offset,
                static_cast<char*>([from_buf contents]) + from_offset, size);
+      } else if (stream != nullptr) {
+        // the destination is written when the stream is synchronized.
+        s->EncodeReadback(from_buf, from_offset, static_cast<char*>(to) + to_offset, size);
+      } else {
+        // copy to a local buffer before get into global buffer.
+        id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_from, size);
+        s->EncodeCopy(from_buf, from_offset, temp, 0, size);
+        s->Synchronize();
+        if (s->HasErrorHappened()) {
+          LOG(FATAL) << "GPUError: " << s->ErrorDescription();
+        }
+        memcpy(static_cast<char*>(to) + to_offset, static_cast<char*>([temp contents]), size);
       }
     } else if (from_dev_type == kDLCPU && to_dev_type == kDLMetal) {
       id<MTLBuffer> to_buf = (id<MTLBuffer>)(to);
       if (to_buf.storageMode != MTLStorageModeShared) {
-        id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_to, size);
-        memcpy([temp contents], static_cast<const char*>(from) + from_offset, size);
-        id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
-        [encoder copyFromBuffer:temp
-                   sourceOffset:0
-                       toBuffer:to_buf
-              destinationOffset:to_offset
-                           size:size];
-        [encoder endEncoding];
-        [cb commit];
-        [cb waitUntilCompleted];
+        // staged, so there is no need to wait for the copy.
+        s->EncodeUpload(static_cast<const char*>(from) + from_offset, to_buf, to_offset, size);
       } else {
         memcpy(static_cast<char*>([to_buf contents]) + to_offset,
                static_cast<const char*>(from) + from_offset, size);
@@ -299,10 +479,7 @@ void MetalWorkspace::FreeStream(Device dev, TVMStreamHandle stream) {
 void MetalWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   AUTORELEASEPOOL {
     Stream* s = CastStreamOrGetDefault(stream, dev.device_id);
-    // commit an empty command buffer and wait until it completes.
-    id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMStreamSync");
-    [cb commit];
-    [cb waitUntilCompleted];
+    s->Synchronize();
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "GPUError: " << s->ErrorDescription();
     }
@@ -377,6 +554,9 @@ class MetalTimerNode : public TimerNode {
   }
 
   virtual void Start() {
+    // do not leave the earlier launches batched with the timed ones.
+    auto ws = MetalWorkspace::Global();
+    ws->CastStreamOrGetDefault(ws->GetCurrentStream(dev_), dev_.device_id)->Flush();
     [mtl_dev_ sampleTimestamps:&start_cpu_time_ gpuTimestamp:&start_gpu_time_];
   }
   virtual void Stop() {
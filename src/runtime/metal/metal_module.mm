@@ -205,36 +205,11 @@ class MetalWrappedFunc {
       int blockSize = wl.block_dim(0) * wl.block_dim(1) * wl.block_dim(2);
       auto maxTotalThreadsPerThreadgroup = scache_[device_id].maxTotalThreadsPerThreadgroup;
       CHECK_LE(blockSize, maxTotalThreadsPerThreadgroup);
-      // attach error message directly in this functio
-      id<MTLCommandBuffer> cb = stream->GetCommandBuffer(/*label=*/"TVMKernel:" + func_name_,
-                                                         /*attach_error_callback=*/false);
-      id<MTLComputeCommandEncoder> encoder = [cb computeCommandEncoder];
-      [encoder setComputePipelineState:scache_[device_id]];
-      for (size_t i = 0; i < num_buffer_args_; ++i) {
-        void* buf = args[static_cast<int>(i)];
-        [encoder setBuffer:(id<MTLBuffer>)(buf) offset:0 atIndex:i];
-      }
-      if (num_pack_args_ != 0) {
-        [encoder setBytes:pack_args
-                   length:num_pack_args_ * sizeof(ArgUnion64)
-                  atIndex:num_buffer_args_];
-      }
-      // launch
       MTLSize dimGrid = MTLSizeMake(wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
       MTLSize dimBlock = MTLSizeMake(wl.block_dim(0), wl.block_dim(1), wl.block_dim(2));
-      [encoder dispatchThreadgroups:dimGrid threadsPerThreadgroup:dimBlock];
-      [encoder endEncoding];
-      // attach error message with function name
-      [cb addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
-        if (buffer.status == MTLCommandBufferStatusError) {
-          ICHECK(buffer.error != nil);
-          std::ostringstream os;
-          os << "GPUError happens after running " << func_name_ << ": "
-             << buffer.error.localizedDescription.UTF8String;
-          stream->SetError(os.str());
-        }
-      }];
-      [cb commit];
+      // the launch is batched with the others on the stream, and committed at the next sync.
+      stream->Dispatch(func_name_, scache_[device_id], args.values, num_buffer_args_, pack_args,
+                       num_pack_args_ * sizeof(ArgUnion64), dimGrid, dimBlock);
     };
   }
 
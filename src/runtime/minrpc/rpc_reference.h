@@ -70,6 +70,7 @@ enum class RPCCode : int {
   kDevFreeStream,
   kDevSetStream,
   kDevGetCurrentStream,
+  kEnableMultiplex,
 };
 
 /*!
@@ -134,6 +135,8 @@ inline const char* RPCCodeToString(RPCCode code) {
       return "kCopyAmongRemote";
     case RPCCode::kDevAllocDataWithScope:
       return "kDevAllocDataWithScope";
+    case RPCCode::kEnableMultiplex:
+      return "kEnableMultiplex";
     default:
       return "";
   }
@@ -16,27 +16,70 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #ifndef TVM_NVTX_ENABLED
 #define TVM_NVTX_ENABLED 0
 #endif
+#ifndef TVM_ROCTX_ENABLED
+#define TVM_ROCTX_ENABLED 0
+#endif
 
 #if TVM_NVTX_ENABLED
 #include <nvtx3/nvToolsExt.h>
+#elif TVM_ROCTX_ENABLED
+#include <roctracer/roctx.h>
 #endif  // TVM_NVTX_ENABLED
 
 #include <tvm/runtime/nvtx.h>
+#include <tvm/runtime/registry.h>
 
 namespace tvm {
 namespace runtime {
 
+#if TVM_NVTX_ENABLED || TVM_ROCTX_ENABLED
+/*! \brief Whether the ranges are recorded, initialized from the environment. */
+static std::atomic<bool> nvtx_enabled{[]() {
+  const char* val = std::getenv("TVM_NVTX_RANGES");
+  return val != nullptr && val[0] != '\0' && std::strcmp(val, "0") != 0;
+}()};
+
+bool NVTXScopedRange::Enabled() { return nvtx_enabled.load(std::memory_order_relaxed); }
+
+void NVTXScopedRange::SetEnabled(bool enabled) { nvtx_enabled = enabled; }
+
+NVTXScopedRange::NVTXScopedRange(const char* name) : entered_(Enabled()) {
+  if (entered_) {
 #if TVM_NVTX_ENABLED
-NVTXScopedRange::NVTXScopedRange(const char* name) { nvtxRangePush(name); }
-NVTXScopedRange::~NVTXScopedRange() { nvtxRangePop(); }
+    nvtxRangePush(name);
 #else
-NVTXScopedRange::NVTXScopedRange(const char* name) {}
-NVTXScopedRange::~NVTXScopedRange() {}
+    roctxRangePush(name);
+#endif  // TVM_NVTX_ENABLED
+  }
+}
+
+NVTXScopedRange::~NVTXScopedRange() {
+  if (entered_) {
+#if TVM_NVTX_ENABLED
+    nvtxRangePop();
+#else
+    roctxRangePop();
 #endif  // TVM_NVTX_ENABLED
+  }
+}
+#else
+bool NVTXScopedRange::Enabled() { return false; }
+void NVTXScopedRange::SetEnabled(bool enabled) {}
+NVTXScopedRange::NVTXScopedRange(const char* name) : entered_(false) {}
+NVTXScopedRange::~NVTXScopedRange() {}
+#endif  // TVM_NVTX_ENABLED || TVM_ROCTX_ENABLED
+
+TVM_REGISTER_GLOBAL("runtime.profiling.SetNVTXRangesEnabled").set_body_typed([](bool enabled) {
+  NVTXScopedRange::SetEnabled(enabled);
+  return NVTXScopedRange::Enabled();
+});
 
 }  // namespace runtime
 }  // namespace tvm
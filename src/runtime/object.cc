@@ -21,6 +21,7 @@
  * \brief Object type management system.
  */
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/registry.h>
 
@@ -37,6 +38,8 @@
 namespace tvm {
 namespace runtime {
 
+std::atomic<int> ObjectAllocationCounter::num_active{0};
+
 /*! \brief Type information */
 struct TypeInfo {
   /*! \brief The current index. */
@@ -58,6 +58,7 @@
 #include <CL/opencl.h>
 #endif
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -211,6 +212,20 @@ inline cl_channel_type DTypeToOpenCLChannelType(DLDataType data_type) {
     OPENCL_CHECK_ERROR(e); \
   }
 
+/*!
+ * \brief Query a string parameter of an OpenCL platform.
+ * \param pid The platform.
+ * \param param_name The parameter, e.g. CL_PLATFORM_NAME.
+ */
+std::string GetPlatformInfo(cl_platform_id pid, cl_platform_info param_name);
+
+/*!
+ * \brief Query a string parameter of an OpenCL device.
+ * \param pid The device.
+ * \param param_name The parameter, e.g. CL_DEVICE_NAME.
+ */
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
+
 class OpenCLThreadEntry;
 struct BufferDescriptor;
 
@@ -233,8 +248,18 @@ class OpenCLWorkspace : public DeviceAPI {
   std::vector<cl_device_id> devices;
   // the queues
   std::vector<cl_command_queue> queues;
+  // the properties the queues were created with
+  std::vector<cl_command_queue_properties> queue_properties;
   // the events
   std::vector<std::vector<cl_event>> events;
+  // the last event using each buffer on the out-of-order queues, which the next kernel using the
+  // buffer waits for
+  std::vector<std::unordered_map<cl_mem, cl_event>> buffer_events;
+  // the mutex for the buffer events
+  std::mutex buffer_events_mu;
+  // Flush the queue after this many kernels launched by a thread, zero defers the flush to the
+  // next sync point.
+  std::atomic<size_t> flush_interval{0};
   // Number of registered kernels
   // Used to register kernel into the workspace.
   size_t num_registered_kernels{0};
@@ -272,37 +297,53 @@ class OpenCLWorkspace : public DeviceAPI {
         << "Invalid OpenCL device_id=" << dev.device_id << ". " << GetError();
     return events[dev.device_id];
   }
+  // get the properties the queue of the device was created with
+  cl_command_queue_properties GetQueueProperties(Device dev) {
+    ICHECK(IsOpenCLDevice(dev));
+    this->Init();
+    ICHECK(dev.device_id >= 0 && static_cast<size_t>(dev.device_id) < queues.size())
+        << "Invalid OpenCL device_id=" << dev.device_id << ". " << GetError();
+    return queue_properties[dev.device_id];
+  }
   // is current clCommandQueue in profiling mode
-  bool IsProfiling(Device dev) {
-    cl_command_queue queue = GetQueue(dev);
-    cl_command_queue_properties prop;
-
-    OPENCL_CALL(clGetCommandQueueInfo(queue, CL_QUEUE_PROPERTIES,
-                                      sizeof(cl_command_queue_properties), &prop, nullptr));
-
-    return prop & CL_QUEUE_PROFILING_ENABLE;
+  bool IsProfiling(Device dev) { return GetQueueProperties(dev) & CL_QUEUE_PROFILING_ENABLE; }
+  // is current clCommandQueue executing the commands out of order
+  bool IsOutOfOrder(Device dev) {
+    return GetQueueProperties(dev) & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
   }
   // Check if the device is present or not
   bool IsDeviceExists(unsigned int device_id) { return device_id < devices.size(); }
   // Enable queue profiling, recreate if required
   void EnableQueueProfiling(Device dev, bool enable) {
-    bool is_enabled = cl::OpenCLWorkspace::Global()->IsProfiling(dev);
-    if (is_enabled == enable) {
+    if (IsProfiling(dev) == enable) {
       return;
     }
-    cl_command_queue_properties prop = (enable) ? CL_QUEUE_PROFILING_ENABLE : 0;
-    auto queue = cl::OpenCLWorkspace::Global()->GetQueue(dev);
-    OPENCL_CALL(clFlush(queue));
-    OPENCL_CALL(clFinish(queue));
-    OPENCL_CALL(clReleaseCommandQueue(queue));
-    cl_int err_code;
-    cl_device_id did = cl::OpenCLWorkspace::Global()->GetCLDeviceID(dev.device_id);
-    cl_platform_id platform = cl::OpenCLWorkspace::Global()->device_to_platform[did];
-    auto profiling_queue = clCreateCommandQueue(cl::OpenCLWorkspace::Global()->contexts[platform],
-                                                did, prop, &err_code);
-    OPENCL_CHECK_ERROR(err_code);
-    cl::OpenCLWorkspace::Global()->queues[dev.device_id] = profiling_queue;
+    RecreateQueue(dev, GetQueueProperties(dev) ^ CL_QUEUE_PROFILING_ENABLE);
   }
+  /*!
+   * \brief Enable the out-of-order execution of the queue, recreate if required. The kernels
+   *  then only wait for the earlier kernels sharing a buffer with them, and the copies wait for
+   *  all the earlier commands.
+   * \return Whether the queue is out of order, which the device may not support.
+   */
+  bool EnableOutOfOrderQueue(Device dev, bool enable);
+  // Finish the earlier commands and recreate the queue of the device with the properties.
+  void RecreateQueue(Device dev, cl_command_queue_properties prop);
+  /*!
+   * \brief Enqueue a kernel on the out-of-order queue of the device after the earlier kernels
+   *  using any of its buffers, which are conservatively taken as both read and written, and
+   *  record it as the last kernel using them.
+   * \param event The event of the kernel, or nullptr if it is not needed.
+   */
+  void EnqueueOrderedKernel(Device dev, cl_kernel kernel, cl_uint work_dim,
+                            const size_t* global_work_size, const size_t* local_work_size,
+                            const std::vector<cl_mem>& buffers, cl_event* event);
+  // Order the next commands after all the earlier ones, if the queue of the device is out of order.
+  void EnqueueBarrier(Device dev);
+  // Wait for all the commands on the queue of the device.
+  void FinishQueue(Device dev);
+  // Release the events recorded for the buffers on the queue of the device.
+  void ReleaseBufferEvents(Device dev);
 
   cl_device_id GetCLDeviceID(int device_id);
   // override device API
@@ -351,6 +392,8 @@ class OpenCLThreadEntry {
     cl_kernel kernel{nullptr};
     // timestamp used to recognize stale kernel
     size_t version{0};
+    // The bytes of the arguments last bound to the kernel, empty if none is bound yet.
+    std::vector<char> bound_args;
   };
   /*! \brief The current device */
   Device device;
@@ -360,6 +403,8 @@ class OpenCLThreadEntry {
   WorkspacePool pool;
   /*! \brief texture pool */
   TexturePool texture_pool;
+  /*! \brief The number of kernels launched since the queue was last flushed */
+  size_t num_unflushed_kernels{0};
   // constructor
   OpenCLThreadEntry(DLDeviceType device_type, DeviceAPI* device_api)
       : pool(device_type, device_api), texture_pool(device_type, device_api) {
@@ -488,6 +533,15 @@ class OpenCLModuleNode : public OpenCLModuleNodeBase {
   std::string source_;
   // parsed kernel data
   std::unordered_map<std::string, std::string> parsed_kernels_;
+
+  // Return the key of a program in the kernel cache directory
+  std::string ProgramCacheKey(cl::OpenCLWorkspace* w, const std::string& func_name, int device_id);
+  // Create and build a program from the kernel cache, return false if there is no usable entry
+  bool LoadProgramFromKernelCache(cl::OpenCLWorkspace* w, const std::string& func_name,
+                                  int device_id, const std::string& cache_key);
+  // Save the binary of a built program to the kernel cache
+  void SaveProgramToKernelCache(const std::string& func_name, int device_id,
+                                const std::string& cache_key);
 };
 
 /*! \brief OpenCL timer node */
@@ -25,6 +25,7 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <sstream>
 
 #include "opencl_common.h"
@@ -39,8 +40,6 @@ namespace tvm {
 namespace runtime {
 namespace cl {
 
-std::string GetPlatformInfo(cl_platform_id pid, cl_platform_info param_name);
-std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
 std::string GetOpenCLVersion(cl_device_id pid);
 
 struct ImageInfo {
@@ -220,6 +219,8 @@ void OpenCLWorkspace::GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv)
       // https://stackoverflow.com/a/3568223, may not be implementable
       // at all through OpenCL API.
       break;
+    case kPeerTopology:
+      break;
   }
 }
 
@@ -280,7 +281,7 @@ void* OpenCLWorkspace::GetNativePtr(const tvm::runtime::NDArray& narr) {
 void OpenCLWorkspace::FreeDataSpace(Device dev, void* ptr) {
   // We have to make sure that the memory object is not in the command queue
   // for some OpenCL platforms.
-  OPENCL_CALL(clFinish(this->GetQueue(dev)));
+  this->FinishQueue(dev);
 
   cl::BufferDescriptor* desc = static_cast<cl::BufferDescriptor*>(ptr);
   if (desc->host_ptr) {
@@ -323,6 +324,7 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
       << "CopyDataFromTo only support contiguous array for now";
 
   if (IsOpenCLDevice(from->device) && IsOpenCLDevice(to->device)) {
+    this->EnqueueBarrier(to->device);
     const auto* from_desc = static_cast<const cl::BufferDescriptor*>(from->data);
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
     if (to_desc->layout == cl::BufferDescriptor::MemoryLayout::kBuffer1D &&
@@ -349,7 +351,9 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
                                      from_image_info.origin, to_image_info.origin,
                                      to_image_info.region, 0, nullptr, nullptr));
     }
+    this->EnqueueBarrier(to->device);
   } else if (IsOpenCLDevice(from->device) && to->device.device_type == kDLCPU) {
+    this->EnqueueBarrier(from->device);
     const auto* from_desc = static_cast<const cl::BufferDescriptor*>(from->data);
     switch (from_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
@@ -370,8 +374,9 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
             static_cast<char*>(to->data) + to->byte_offset, 0, nullptr, nullptr));
         break;
     }
-    OPENCL_CALL(clFinish(this->GetQueue(from->device)));
+    this->FinishQueue(from->device);
   } else if (from->device.device_type == kDLCPU && IsOpenCLDevice(to->device)) {
+    this->EnqueueBarrier(to->device);
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
     switch (to_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
@@ -389,7 +394,7 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
             static_cast<const char*>(from->data) + from->byte_offset, 0, nullptr, nullptr));
         break;
     }
-    OPENCL_CALL(clFinish(this->GetQueue(to->device)));
+    this->FinishQueue(to->device);
   } else {
     LOG(FATAL) << "Expect copy from/to OpenCL or between OpenCL";
   }
@@ -398,7 +403,98 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
 void OpenCLWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   this->Init();
   ICHECK(stream == nullptr);
+  this->FinishQueue(dev);
+}
+
+bool OpenCLWorkspace::EnableOutOfOrderQueue(Device dev, bool enable) {
+  if (IsOutOfOrder(dev) == enable) {
+    return enable;
+  }
+  if (enable) {
+    cl_command_queue_properties supported;
+    OPENCL_CALL(clGetDeviceInfo(GetCLDeviceID(dev.device_id), CL_DEVICE_QUEUE_PROPERTIES,
+                                sizeof(supported), &supported, nullptr));
+    if (!(supported & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+      LOG(WARNING) << "OpenCL device " << dev << " does not support out-of-order queues";
+      return false;
+    }
+  }
+  RecreateQueue(dev, GetQueueProperties(dev) ^ CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
+  return enable;
+}
+
+void OpenCLWorkspace::RecreateQueue(Device dev, cl_command_queue_properties prop) {
+  cl_command_queue queue = this->GetQueue(dev);
+  OPENCL_CALL(clFlush(queue));
+  this->FinishQueue(dev);
+  OPENCL_CALL(clReleaseCommandQueue(queue));
+  cl_int err_code;
+  cl_device_id did = this->GetCLDeviceID(dev.device_id);
+  cl_platform_id platform = this->device_to_platform[did];
+  cl_command_queue new_queue = clCreateCommandQueue(this->contexts[platform], did, prop, &err_code);
+  OPENCL_CHECK_ERROR(err_code);
+  this->queues[dev.device_id] = new_queue;
+  this->queue_properties[dev.device_id] = prop;
+}
+
+void OpenCLWorkspace::EnqueueOrderedKernel(Device dev, cl_kernel kernel, cl_uint work_dim,
+                                           const size_t* global_work_size,
+                                           const size_t* local_work_size,
+                                           const std::vector<cl_mem>& buffers, cl_event* event) {
+  cl_command_queue queue = this->GetQueue(dev);
+  std::lock_guard<std::mutex> lock(buffer_events_mu);
+  std::unordered_map<cl_mem, cl_event>& last_events = buffer_events[dev.device_id];
+  std::vector<cl_event> wait_list;
+  for (cl_mem buffer : buffers) {
+    auto it = last_events.find(buffer);
+    if (it != last_events.end() &&
+        std::find(wait_list.begin(), wait_list.end(), it->second) == wait_list.end()) {
+      wait_list.push_back(it->second);
+    }
+  }
+  cl_event kernel_event;
+  OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, global_work_size,
+                                     local_work_size, static_cast<cl_uint>(wait_list.size()),
+                                     wait_list.empty() ? nullptr : wait_list.data(),
+                                     &kernel_event));
+  for (cl_mem buffer : buffers) {
+    cl_event& last_event = last_events[buffer];
+    if (last_event == kernel_event) {
+      continue;
+    }
+    if (last_event != nullptr) {
+      OPENCL_CALL(clReleaseEvent(last_event));
+    }
+    OPENCL_CALL(clRetainEvent(kernel_event));
+    last_event = kernel_event;
+  }
+  if (event != nullptr) {
+    *event = kernel_event;
+  } else {
+    OPENCL_CALL(clReleaseEvent(kernel_event));
+  }
+}
+
+void OpenCLWorkspace::EnqueueBarrier(Device dev) {
+  if (!IsOutOfOrder(dev)) {
+    return;
+  }
+  OPENCL_CALL(clEnqueueBarrierWithWaitList(this->GetQueue(dev), 0, nullptr, nullptr));
+  // The next commands wait for the barrier, thus for all the kernels using the buffers.
+  ReleaseBufferEvents(dev);
+}
+
+void OpenCLWorkspace::FinishQueue(Device dev) {
   OPENCL_CALL(clFinish(this->GetQueue(dev)));
+  ReleaseBufferEvents(dev);
+}
+
+void OpenCLWorkspace::ReleaseBufferEvents(Device dev) {
+  std::lock_guard<std::mutex> lock(buffer_events_mu);
+  for (auto& [buffer, event] : buffer_events[dev.device_id]) {
+    OPENCL_CALL(clReleaseEvent(event));
+  }
+  buffer_events[dev.device_id].clear();
 }
 
 void* OpenCLWorkspace::AllocWorkspace(Device dev, size_t size, DLDataType type_hint) {
@@ -545,11 +641,13 @@ void OpenCLWorkspace::Init(const std::string& type_key, const std::string& devic
       cl_device_id did = devices[i];
       device_to_platform[did] = platform;
       this->queues.push_back(clCreateCommandQueue(this->contexts[platform], did, 0, &err_code));
+      this->queue_properties.push_back(0);
       OPENCL_CHECK_ERROR(err_code);
     }
     OPENCL_CHECK_ERROR(err_code);
   }
   this->events.resize(this->devices.size());
+  this->buffer_events.resize(this->devices.size());
   initialized_ = true;
 }
 
@@ -594,6 +692,43 @@ TVM_REGISTER_GLOBAL("device_api.opencl.free_nd").set_body([](TVMArgs args, TVMRe
   *rv = static_cast<int32_t>(0);
 });
 
+TVM_REGISTER_GLOBAL("device_api.opencl.texture_pool_stats").set_body_typed([](int device_id) {
+  Device dev{kDLOpenCL, device_id};
+  TexturePoolStats stats = OpenCLWorkspace::Global()->GetThreadEntry()->texture_pool.GetStats(dev);
+  std::ostringstream os;
+  os << "{\"live_bytes\": " << stats.live_bytes << ", \"cached_bytes\": " << stats.cached_bytes
+     << ", \"peak_bytes\": " << stats.peak_bytes << ", \"waste_bytes\": " << stats.waste_bytes
+     << ", \"num_allocs\": " << stats.num_allocs << ", \"num_frees\": " << stats.num_frees
+     << ", \"num_reuses\": " << stats.num_reuses << ", \"num_evictions\": " << stats.num_evictions
+     << ", \"num_alloc_failures\": " << stats.num_alloc_failures << "}";
+  return String(os.str());
+});
+
+TVM_REGISTER_GLOBAL("device_api.opencl.texture_pool_trim")
+    .set_body_typed([](int device_id, int64_t max_cached_bytes) {
+      Device dev{kDLOpenCL, device_id};
+      OpenCLWorkspace::Global()->GetThreadEntry()->texture_pool.Trim(
+          dev, static_cast<size_t>(max_cached_bytes));
+    });
+
+TVM_REGISTER_GLOBAL("device_api.opencl.texture_pool_set_max_cached_bytes")
+    .set_body_typed([](int64_t max_cached_bytes) {
+      OpenCLWorkspace::Global()->GetThreadEntry()->texture_pool.SetMaxCachedBytes(
+          static_cast<size_t>(max_cached_bytes));
+    });
+
+TVM_REGISTER_GLOBAL("device_api.opencl.set_out_of_order_queue")
+    .set_body_typed([](int device_id, bool enable) {
+      return OpenCLWorkspace::Global()->EnableOutOfOrderQueue(Device{kDLOpenCL, device_id},
+                                                              enable);
+    });
+
+TVM_REGISTER_GLOBAL("device_api.opencl.set_flush_interval").set_body_typed([](int64_t interval) {
+  CHECK_GE(interval, 0) << "ValueError: The flush interval should be non-negative, but got "
+                        << interval;
+  OpenCLWorkspace::Global()->flush_interval = static_cast<size_t>(interval);
+});
+
 TVM_REGISTER_GLOBAL("device_api.opencl").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = OpenCLWorkspace::Global();
   *rv = static_cast<void*>(ptr);
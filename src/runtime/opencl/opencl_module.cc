@@ -25,10 +25,12 @@
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "../file_utils.h"
 #include "../source_utils.h"
 #include "opencl_common.h"
 
@@ -47,6 +49,11 @@ class OpenCLWrappedFunc {
     entry_ = entry;
     func_name_ = func_name;
     arg_size_ = arg_size;
+    arg_offsets_.resize(arg_size.size());
+    for (size_t i = 0; i < arg_size.size(); ++i) {
+      arg_offsets_[i] = arg_bytes_;
+      arg_bytes_ += arg_size[i];
+    }
     launch_param_config_.Init(arg_size.size(), launch_param_tags);
   }
   // invoke the function with void arguments
@@ -57,20 +64,35 @@ class OpenCLWrappedFunc {
     if (entry_.kernel_id >= t->kernel_table.size()) {
       t->kernel_table.resize(entry_.kernel_id + 1);
     }
-    const auto& e = t->kernel_table[entry_.kernel_id];
+    auto& e = t->kernel_table[entry_.kernel_id];
     cl_kernel kernel = e.kernel;
     if (kernel == nullptr || e.version != entry_.version) {
       kernel = m_->InstallKernel(w_, t, func_name_, entry_);
+      e.bound_args.clear();
+    }
+    // setup arguments. The arguments stay bound to the kernel of this thread between the
+    // launches, so only the ones changed since the last launch are bound again.
+    bool bind_all = e.bound_args.size() != arg_bytes_;
+    if (bind_all) {
+      e.bound_args.resize(arg_bytes_);
     }
-    // setup arguments.
+    bool out_of_order = w_->IsOutOfOrder(t->device);
+    std::vector<cl_mem> buffers;
     for (cl_uint i = 0; i < arg_size_.size(); ++i) {
       void* arg = nullptr;
       if (args.type_codes[i] == DLDataTypeCode::kDLOpaqueHandle) {
         arg = static_cast<cl::BufferDescriptor*>(void_args[i])->buffer;
+        if (out_of_order) {
+          buffers.push_back(*static_cast<cl_mem*>(arg));
+        }
       } else {
         arg = void_args[i];
       }
-      OPENCL_CALL(clSetKernelArg(kernel, i, arg_size_[i], arg));
+      char* bound_arg = e.bound_args.data() + arg_offsets_[i];
+      if (bind_all || std::memcmp(bound_arg, arg, arg_size_[i]) != 0) {
+        OPENCL_CALL(clSetKernelArg(kernel, i, arg_size_[i], arg));
+        std::memcpy(bound_arg, arg, arg_size_[i]);
+      }
     }
     cl_command_queue queue = w_->GetQueue(t->device);
     ThreadWorkLoad wl = launch_param_config_.Extract(args);
@@ -79,15 +101,23 @@ class OpenCLWrappedFunc {
       wl.work_size[i] *= wl.work_size[i + 3];
     }
     // launch kernel
-
+    cl_event* event = nullptr;
     if (w_->IsProfiling(t->device)) {
       w_->GetEventQueue(t->device).resize(w_->GetEventQueue(t->device).size() + 1);
-      OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, wl.work_size,
-                                         wl.work_size + 3, 0, nullptr,
-                                         &(w_->GetEventQueue(t->device).back())));
+      event = &(w_->GetEventQueue(t->device).back());
+    }
+    if (out_of_order) {
+      w_->EnqueueOrderedKernel(t->device, kernel, work_dim, wl.work_size, wl.work_size + 3,
+                               buffers, event);
     } else {
       OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, wl.work_size,
-                                         wl.work_size + 3, 0, nullptr, nullptr));
+                                         wl.work_size + 3, 0, nullptr, event));
+    }
+    // submit the kernels in batches, the queue is otherwise flushed at the next sync point.
+    size_t flush_interval = w_->flush_interval;
+    if (flush_interval != 0 && ++t->num_unflushed_kernels >= flush_interval) {
+      OPENCL_CALL(clFlush(queue));
+      t->num_unflushed_kernels = 0;
     }
   }
 
@@ -104,6 +134,10 @@ class OpenCLWrappedFunc {
   std::string func_name_;
   // convert code for void argument
   std::vector<size_t> arg_size_;
+  // The offsets of the arguments in the bytes bound to the kernel.
+  std::vector<size_t> arg_offsets_;
+  // The total bytes of the arguments.
+  size_t arg_bytes_{0};
   // launch parameters config
   LaunchParamConfig launch_param_config_;
 };
@@ -227,40 +261,52 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   auto did = w->GetCLDeviceID(device_id);
   auto platform = w->device_to_platform[did];
   if (!IsProgramCreated(func_name, device_id)) {
-    // create program
-    if (fmt_ == "cl") {
-      const char* s = parsed_kernels_[func_name].c_str();
-      size_t len = parsed_kernels_[func_name].length();
-      cl_int err;
-      programs_[func_name][device_id] =
-          clCreateProgramWithSource(w->contexts[platform], 1, &s, &len, &err);
-      OPENCL_CHECK_ERROR(err);
-    } else if (fmt_ == "xclbin" || fmt_ == "awsxclbin" || fmt_ == "aocx") {
-      const unsigned char* s = (const unsigned char*)data_.c_str();
-      size_t len = data_.length();
+    // Programs built from source are looked up in the kernel cache
+    // first, as compiling them dominates the model load time on some
+    // mobile drivers.
+    std::string cache_key;
+    if (fmt_ == "cl" && !GetKernelCacheDir().empty()) {
+      cache_key = ProgramCacheKey(w, func_name, device_id);
+    }
+    if (cache_key.empty() || !LoadProgramFromKernelCache(w, func_name, device_id, cache_key)) {
+      // create program
+      if (fmt_ == "cl") {
+        const char* s = parsed_kernels_[func_name].c_str();
+        size_t len = parsed_kernels_[func_name].length();
+        cl_int err;
+        programs_[func_name][device_id] =
+            clCreateProgramWithSource(w->contexts[platform], 1, &s, &len, &err);
+        OPENCL_CHECK_ERROR(err);
+      } else if (fmt_ == "xclbin" || fmt_ == "awsxclbin" || fmt_ == "aocx") {
+        const unsigned char* s = (const unsigned char*)data_.c_str();
+        size_t len = data_.length();
+        cl_int err;
+        cl_device_id dev = w->devices[device_id];
+        programs_[func_name][device_id] =
+            clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &len, &s, nullptr, &err);
+        OPENCL_CHECK_ERROR(err);
+      } else {
+        LOG(FATAL) << "Unknown OpenCL format " << fmt_;
+      }
+      // build program
       cl_int err;
       cl_device_id dev = w->devices[device_id];
-      programs_[func_name][device_id] =
-          clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &len, &s, nullptr, &err);
-      OPENCL_CHECK_ERROR(err);
-    } else {
-      LOG(FATAL) << "Unknown OpenCL format " << fmt_;
-    }
-    // build program
-    cl_int err;
-    cl_device_id dev = w->devices[device_id];
-    err = clBuildProgram(programs_[func_name][device_id], 1, &dev, nullptr, nullptr, nullptr);
-    if (err != CL_SUCCESS) {
-      size_t len;
-      std::string log;
-      clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, 0, nullptr,
-                            &len);
-      log.resize(len);
-      clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, len,
-                            &log[0], nullptr);
-      LOG(FATAL) << "OpenCL build error for device=" << dev
-                 << "\nError: " << cl::CLGetErrorString(err) << "\n"
-                 << log;
+      err = clBuildProgram(programs_[func_name][device_id], 1, &dev, nullptr, nullptr, nullptr);
+      if (err != CL_SUCCESS) {
+        size_t len;
+        std::string log;
+        clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, 0,
+                              nullptr, &len);
+        log.resize(len);
+        clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, len,
+                              &log[0], nullptr);
+        LOG(FATAL) << "OpenCL build error for device=" << dev
+                   << "\nError: " << cl::CLGetErrorString(err) << "\n"
+                   << log;
+      }
+      if (!cache_key.empty()) {
+        SaveProgramToKernelCache(func_name, device_id, cache_key);
+      }
     }
   }
   // build kernel
@@ -273,6 +319,64 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   return kernel;
 }
 
+std::string OpenCLModuleNode::ProgramCacheKey(cl::OpenCLWorkspace* w,
+                                              const std::string& func_name, int device_id) {
+  cl_device_id dev = w->devices[device_id];
+  cl_platform_id platform = w->device_to_platform[dev];
+  return GetKernelCacheKey({"opencl_program", cl::GetPlatformInfo(platform, CL_PLATFORM_NAME),
+                            cl::GetPlatformInfo(platform, CL_PLATFORM_VERSION),
+                            cl::GetDeviceInfo(dev, CL_DEVICE_NAME),
+                            cl::GetDeviceInfo(dev, CL_DEVICE_VERSION),
+                            cl::GetDeviceInfo(dev, CL_DRIVER_VERSION), func_name,
+                            parsed_kernels_[func_name]});
+}
+
+bool OpenCLModuleNode::LoadProgramFromKernelCache(cl::OpenCLWorkspace* w,
+                                                  const std::string& func_name, int device_id,
+                                                  const std::string& cache_key) {
+  std::string binary;
+  if (!LoadKernelCacheEntry(cache_key, &binary)) {
+    return false;
+  }
+  cl_device_id dev = w->devices[device_id];
+  cl_platform_id platform = w->device_to_platform[dev];
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(binary.data());
+  size_t len = binary.size();
+  cl_int binary_status = CL_SUCCESS;
+  cl_int err;
+  cl_program program =
+      clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &len, &s, &binary_status, &err);
+  if (err == CL_SUCCESS && binary_status == CL_SUCCESS) {
+    err = clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr);
+  }
+  if (err != CL_SUCCESS || binary_status != CL_SUCCESS) {
+    // The driver rejected the binary, e.g. after an update that kept
+    // the version string, so the program is built from source again.
+    if (program != nullptr) {
+      clReleaseProgram(program);
+    }
+    return false;
+  }
+  programs_[func_name][device_id] = program;
+  return true;
+}
+
+void OpenCLModuleNode::SaveProgramToKernelCache(const std::string& func_name, int device_id,
+                                                const std::string& cache_key) {
+  cl_program program = programs_[func_name][device_id];
+  size_t size = 0;
+  OPENCL_CALL(
+      clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &size, nullptr));
+  if (size == 0) {
+    return;
+  }
+  std::string binary(size, '\0');
+  unsigned char* ptr = reinterpret_cast<unsigned char*>(&binary[0]);
+  OPENCL_CALL(
+      clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &ptr, nullptr));
+  SaveKernelCacheEntry(cache_key, binary);
+}
+
 void OpenCLModuleNode::SetPreCompiledPrograms(const std::string& bytes) {
   workspace_->Init();
   std::string data = bytes;
@@ -172,6 +172,8 @@ using f_clSetKernelArg = cl_int (*)(cl_kernel, cl_uint, size_t, const void*);
 using f_clWaitForEvents = cl_int (*)(cl_uint, const cl_event*);
 using f_clCreateUserEvent = cl_event (*)(cl_context, cl_int*);
 using f_clGetEventProfilingInfo = cl_int (*)(cl_event, cl_profiling_info, size_t, void*, size_t*);
+using f_clRetainEvent = cl_int (*)(cl_event);
+using f_clReleaseEvent = cl_int (*)(cl_event);
 using f_clFlush = cl_int (*)(cl_command_queue);
 using f_clFinish = cl_int (*)(cl_command_queue);
 using f_clEnqueueReadBuffer = cl_int (*)(cl_command_queue, cl_mem, cl_bool, size_t, size_t, void*,
@@ -204,6 +206,8 @@ using f_clEnqueueUnmapMemObject = cl_int (*)(cl_command_queue, cl_mem, void*, cl
                                              const cl_event*, cl_event*);
 using f_clEnqueueMapBuffer = void* (*)(cl_command_queue, cl_mem, cl_bool, cl_map_flags, size_t,
                                        size_t, cl_uint, const cl_event*, cl_event*, cl_int*);
+using f_clEnqueueBarrierWithWaitList = cl_int (*)(cl_command_queue, cl_uint, const cl_event*,
+                                                  cl_event*);
 
 }  // namespace
 
@@ -459,6 +463,26 @@ cl_int clGetEventProfilingInfo(cl_event event, cl_profiling_info param_name,
   }
 }
 
+cl_int clRetainEvent(cl_event event) {
+  auto& lib = LibOpenCLWrapper::getInstance();
+  auto func = (f_clRetainEvent)lib.getOpenCLFunction("clRetainEvent");
+  if (func) {
+    return func(event);
+  } else {
+    return CL_INVALID_PLATFORM;
+  }
+}
+
+cl_int clReleaseEvent(cl_event event) {
+  auto& lib = LibOpenCLWrapper::getInstance();
+  auto func = (f_clReleaseEvent)lib.getOpenCLFunction("clReleaseEvent");
+  if (func) {
+    return func(event);
+  } else {
+    return CL_INVALID_PLATFORM;
+  }
+}
+
 cl_int clFlush(cl_command_queue command_queue) {
   auto& lib = LibOpenCLWrapper::getInstance();
   auto func = (f_clFlush)lib.getOpenCLFunction("clFlush");
@@ -641,3 +665,16 @@ void* clEnqueueMapBuffer(cl_command_queue command_queue, cl_mem buffer, cl_bool
     return nullptr;
   }
 }
+
+cl_int clEnqueueBarrierWithWaitList(cl_command_queue command_queue,
+                                    cl_uint num_events_in_wait_list,
+                                    const cl_event* event_wait_list, cl_event* event) {
+  auto& lib = LibOpenCLWrapper::getInstance();
+  auto func =
+      (f_clEnqueueBarrierWithWaitList)lib.getOpenCLFunction("clEnqueueBarrierWithWaitList");
+  if (func) {
+    return func(command_queue, num_events_in_wait_list, event_wait_list, event);
+  } else {
+    return CL_INVALID_PLATFORM;
+  }
+}
@@ -21,88 +21,95 @@
  * \file texture_pool.h
  * \brief Texture pool utility.
  */
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "../texture.h"
 
 namespace tvm {
 namespace runtime {
 
+size_t Pool2D::SizeClass(size_t extent) {
+  // Eight classes per power of two bound the rounding waste to 12.5%
+  // in each dimension.
+  constexpr size_t kNumSubClasses = 8;
+  if (extent <= kNumSubClasses) return std::max<size_t>(extent, 1);
+  size_t msb = 1;
+  while (msb <= extent / 2) msb <<= 1;
+  size_t step = msb / kNumSubClasses;
+  return (extent + step - 1) / step * step;
+}
+
+void* Pool2D::AllocTexture(Device dev, DeviceAPI* device, size_t x, size_t y, DLDataType type) {
+  std::vector<int64_t> shape{int64_t(y), int64_t(x), 4};
+  try {
+    return device->AllocDataSpace(dev, shape.size(), shape.data(), type,
+                                  Optional<String>("global.texture"));
+  } catch (const Error&) {
+    if (free_list_.empty()) throw;
+    // Most likely out of device memory, so make room by releasing the
+    // free textures and retry once.
+    stats_.num_alloc_failures += 1;
+    Trim(dev, device, 0);
+  }
+  return device->AllocDataSpace(dev, shape.size(), shape.data(), type,
+                                Optional<String>("global.texture"));
+}
+
 void* Pool2D::Alloc(Device dev, DeviceAPI* device, size_t width, size_t height,
                     DLDataType type_hint) {
-  Entry e;
-  Entry new_mem;
   // Processed several experiments and found that when we are trying to fit
   // small texture to too big texture then it may lead to the performance
   // degradation.
   // Coefficient at 5 looks like robust variant for reusing textures.
-  const int64_t max_ratio = 5;
-  e.data = nullptr;
-  std::vector<Entry>::iterator best_mem;
-  if (free_list_.size() != 0) {
-    int64_t min_added_size_x = std::numeric_limits<int64_t>::max();
-    int64_t min_added_size_y = std::numeric_limits<int64_t>::max();
-    int64_t min_wasted_size_x = std::numeric_limits<int64_t>::max();
-    int64_t min_wasted_size_y = std::numeric_limits<int64_t>::max();
-    for (auto it = free_list_.begin(); it != free_list_.end(); ++it) {
-      if (it->type.code != type_hint.code) {
-        continue;
-      }
-      // avoid reusing too small and too big textures
-      if (width / it->x > max_ratio || it->x / width > max_ratio || height / it->y > max_ratio ||
-          it->y / height > max_ratio) {
-        continue;
-      }
-      int64_t new_width = std::max(it->x, width);
-      int64_t new_height = std::max(it->y, height);
-      int64_t added_size_x = new_width - it->x;
-      int64_t added_size_y = new_height - it->y;
-      int64_t wasted_size_x = new_width - width;
-      int64_t wasted_size_y = new_height - height;
-      // Minimize added size first and wasted size thereafter
-      if ((min_added_size_x > 0 && added_size_x < min_added_size_x) ||
-          (min_added_size_y > 0 && added_size_y < min_added_size_y) ||
-          (min_added_size_x == added_size_x && wasted_size_x < min_wasted_size_x) ||
-          (min_added_size_y == added_size_y && wasted_size_y < min_wasted_size_y)) {
-        min_added_size_x = added_size_x;
-        min_added_size_y = added_size_y;
-        min_wasted_size_x = wasted_size_x;
-        min_wasted_size_y = wasted_size_y;
-        best_mem = it;
-        new_mem.x = new_width;
-        new_mem.y = new_height;
-      }
-    }
+  const size_t max_ratio = 5;
+  size_t class_x = SizeClass(width);
+  size_t class_y = SizeClass(height);
+  size_t requested_bytes = TextureBytes(width, height, type_hint);
 
-    if (min_added_size_x == 0 && min_added_size_y == 0) {
-      // use existing block
-      e = *best_mem;
-      free_list_.erase(best_mem);
-    } else if (static_cast<size_t>(min_added_size_x) <= width ||
-               static_cast<size_t>(min_added_size_y) <= height) {
-      // if added size is less or equal to
-      // what is needed by alloc, then grow entry
-      device->FreeDataSpace(dev, best_mem->data);
-      free_list_.erase(best_mem);
-      new_mem.type = type_hint;
-      std::vector<int64_t> shape{int64_t(new_mem.y), int64_t(new_mem.x), 4};
-      new_mem.data = device->AllocDataSpace(dev, shape.size(), shape.data(), new_mem.type,
-                                            Optional<String>("global.texture"));
-      e = new_mem;
+  // Best fit by area among the free textures covering the size class.
+  auto best_mem = free_list_.end();
+  for (auto it = free_list_.begin(); it != free_list_.end(); ++it) {
+    if (it->type.code != type_hint.code || it->type.bits != type_hint.bits ||
+        it->type.lanes != type_hint.lanes) {
+      continue;
+    }
+    if (it->x < class_x || it->y < class_y) {
+      continue;
+    }
+    // avoid reusing too big textures
+    if (it->x / class_x > max_ratio || it->y / class_y > max_ratio) {
+      continue;
+    }
+    if (best_mem == free_list_.end() || it->x * it->y < best_mem->x * best_mem->y ||
+        (it->x * it->y == best_mem->x * best_mem->y && it->last_use > best_mem->last_use)) {
+      best_mem = it;
     }
   }
 
-  if (e.data == nullptr) {
-    // create new block
-    std::vector<int64_t> shape{int64_t(height), int64_t(width), 4};
-    e.data = device->AllocDataSpace(dev, shape.size(), shape.data(), type_hint,
-                                    Optional<String>("global.texture"));
-    e.x = width;
-    e.y = height;
+  Entry e;
+  if (best_mem != free_list_.end()) {
+    e = *best_mem;
+    free_list_.erase(best_mem);
+    stats_.cached_bytes -= TextureBytes(e.x, e.y, e.type);
+    stats_.num_reuses += 1;
+  } else {
+    e.data = AllocTexture(dev, device, class_x, class_y, type_hint);
+    e.x = class_x;
+    e.y = class_y;
     e.type = type_hint;
   }
+  e.requested_bytes = requested_bytes;
 
+  size_t bytes = TextureBytes(e.x, e.y, e.type);
+  stats_.live_bytes += bytes;
+  stats_.waste_bytes += bytes - requested_bytes;
+  stats_.num_allocs += 1;
+  stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.live_bytes + stats_.cached_bytes);
   allocated_.push_back(e);
   return e.data;
 }
@@ -121,9 +128,29 @@ void Pool2D::Free(void* data) {
     e = allocated_[index];
     allocated_.erase(allocated_.begin() + index);
   }
+  size_t bytes = TextureBytes(e.x, e.y, e.type);
+  stats_.live_bytes -= bytes;
+  stats_.waste_bytes -= bytes - e.requested_bytes;
+  stats_.cached_bytes += bytes;
+  stats_.num_frees += 1;
+  e.last_use = ++clock_;
   free_list_.push_back(e);
 }
 
+void Pool2D::Trim(Device dev, DeviceAPI* device, size_t max_cached_bytes) {
+  if (stats_.cached_bytes <= max_cached_bytes) return;
+  // Release the least recently freed textures first.
+  std::sort(free_list_.begin(), free_list_.end(),
+            [](const Entry& a, const Entry& b) { return a.last_use > b.last_use; });
+  while (!free_list_.empty() && stats_.cached_bytes > max_cached_bytes) {
+    const Entry& e = free_list_.back();
+    device->FreeDataSpace(dev, e.data);
+    stats_.cached_bytes -= TextureBytes(e.x, e.y, e.type);
+    stats_.num_evictions += 1;
+    free_list_.pop_back();
+  }
+}
+
 // Release all resources immediately
 void Pool2D::Release(Device dev, DeviceAPI* device) {
   for (auto& e : allocated_) {
@@ -134,10 +161,18 @@ void Pool2D::Release(Device dev, DeviceAPI* device) {
   }
   allocated_.clear();
   free_list_.clear();
+  stats_.live_bytes = 0;
+  stats_.cached_bytes = 0;
+  stats_.waste_bytes = 0;
 }
 
 TexturePool::TexturePool(DLDeviceType device_type, DeviceAPI* device)
-    : device_type_(device_type), device_(device) {}
+    : device_type_(device_type), device_(device) {
+  max_cached_bytes_ = std::numeric_limits<size_t>::max();
+  if (const char* max_cached_mb = getenv("TVM_TEXTURE_POOL_MAX_CACHED_MB")) {
+    max_cached_bytes_ = static_cast<size_t>(std::stoull(max_cached_mb)) << 20;
+  }
+}
 
 TexturePool::~TexturePool() {
   for (size_t i = 0; i < array_.size(); ++i) {
@@ -165,6 +200,20 @@ void TexturePool::FreeTexture(Device dev, void* ptr) {
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr)
       << "Attempt to free texture from null texture pool";
   array_[dev.device_id]->Free(ptr);
+  array_[dev.device_id]->Trim(dev, device_, max_cached_bytes_);
+}
+
+void TexturePool::Trim(Device dev, size_t max_cached_bytes) {
+  if (static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr) {
+    array_[dev.device_id]->Trim(dev, device_, max_cached_bytes);
+  }
+}
+
+TexturePoolStats TexturePool::GetStats(Device dev) const {
+  if (static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr) {
+    return array_[dev.device_id]->GetStats();
+  }
+  return TexturePoolStats();
 }
 
 }  // namespace runtime
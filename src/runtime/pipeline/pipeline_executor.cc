@@ -85,6 +85,9 @@ PackedFunc PipelineExecutor::GetFunction(const String& name,
   } else if (name == "get_execute_count") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetExecutionCount(); });
+  } else if (name == "get_stage_metrics") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetStageMetrics(); });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
   }
@@ -235,6 +238,19 @@ std::pair<int, int> PipelineExecutor::GetInputIndex(const std::string& name) {
  * \brief Getting the count of running pipeline.
  */
 int PipelineExecutor::GetExecutionCount() { return runtimes_.back()->GetExecutionCount(); }
+/*!
+ * \brief Getting the throughput and the queue metrics of each runtime.
+ */
+std::string PipelineExecutor::GetStageMetrics() {
+  std::vector<std::map<std::string, double>> metrics;
+  for (auto runtime : runtimes_) {
+    metrics.push_back(runtime->GetMetrics());
+  }
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.Write(metrics);
+  return os.str();
+}
 /*!
  * \brief Initialize the pipeline executor with a list of modules to be pipelined
  *  and config in JSON format.
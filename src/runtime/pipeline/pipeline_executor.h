@@ -99,6 +99,11 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
    * \brief Getting the count of running pipeline.
    */
   int GetExecutionCount();
+  /*!
+   * \brief Getting the throughput and the queue metrics of each runtime.
+   * \return The metrics in a JSON list, one object per runtime in the order of the modules.
+   */
+  std::string GetStageMetrics();
   /*!
    * \brief Use the parameters group name to get the specific backend runtime then use
    *  the param_key_name to set param data for the said backend runtime.
@@ -38,6 +38,17 @@ std::shared_ptr<GlobalRuntime> PipelineScheduler::PipelineInit(
     auto run_item = std::make_shared<BackendRuntime>(graph_modules_[i], i);
     runtimes.push_back(run_item);
   }
+  // Configuring the queues and the batching of the runtimes, which the forwarding queues
+  // created by the initialization below depend on.
+  InputConnectionConfig input_config = input_connection_config;
+  bool global_inputs_to_later_stages = false;
+  for (size_t i = 1; i < runtimes.size(); i++) {
+    input_config.VisitConfig([&](int, int, std::string) { global_inputs_to_later_stages = true; },
+                             i);
+  }
+  for (auto runtime : runtimes) {
+    runtime->ConfigureStage(pipeline_config, global_inputs_to_later_stages);
+  }
   // Creating the global runtime to represent the pipeline executor.
   global_runtime_ = std::make_shared<GlobalRuntime>(GLOBAL_MODULE_INDEX);
   // Initializing the data structures used by pipeline logic.
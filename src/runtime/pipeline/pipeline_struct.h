@@ -26,9 +26,11 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
@@ -40,6 +42,8 @@
 namespace tvm {
 namespace runtime {
 #define GLOBAL_MODULE_INDEX -1
+/*!\brief The default number of elements that the queue of an input interface can hold.*/
+#define DEFAULT_QUEUE_CAPACITY 1024
 /*!
  *\brief The function is used to build the binding configuration for a runtime. The first
  * 'int' is the output index of the current runtime, the second 'int' is the index of child
@@ -66,6 +70,13 @@ enum InterfaceType {
   INPUT = 0,
   OUTPUT,
 };
+/*!\brief What the pipeline does with a request when the queues of a runtime are full.*/
+enum QueuePolicy {
+  /*!\brief Wait until the queues have room for the request.*/
+  BLOCK = 0,
+  /*!\brief Drop the request, which is only supported when it enters the pipeline.*/
+  DROP,
+};
 /*!\brief The state of the pipeline.*/
 enum PipelineState {
   STOPPED = 0,
@@ -325,6 +336,9 @@ class ConfigRuntime {
   ConfigRuntime& operator=(const ConfigRuntime& output) {
     output_binding_map_ = output.GetOutBindings();
     cpu_affinity_ = output.GetCPUAffinity();
+    queue_capacity_ = output.GetQueueCapacity();
+    batch_size_ = output.GetBatchSize();
+    queue_policy_ = output.GetQueuePolicy();
     return *this;
   }
 
@@ -342,6 +356,23 @@ class ConfigRuntime {
    * \param Returning the cpu affinity in text form.
    */
   std::string GetCPUAffinity() const { return cpu_affinity_; }
+  /*!
+   * \brief Store the settings of the queues and the batching of the module.
+   * \param queue_capacity The number of elements that the queue of each input can hold.
+   * \param batch_size The number of requests that the module processes in one run.
+   * \param queue_policy The policy when the queues of the children of the module are full.
+   */
+  void StoreStageConfig(int queue_capacity, int batch_size, QueuePolicy queue_policy) {
+    queue_capacity_ = queue_capacity;
+    batch_size_ = batch_size;
+    queue_policy_ = queue_policy;
+  }
+  /*!\brief Getting the number of elements that the queue of each input can hold.*/
+  int GetQueueCapacity() const { return queue_capacity_; }
+  /*!\brief Getting the number of requests that the module processes in one run.*/
+  int GetBatchSize() const { return batch_size_; }
+  /*!\brief Getting the policy when the queues of the children of the module are full.*/
+  QueuePolicy GetQueuePolicy() const { return queue_policy_; }
   /*!
    * \brief Enumerating the output configuration.
    * \param parse_function The callback function is used to parse the binding configeration.
@@ -413,6 +444,12 @@ class ConfigRuntime {
   std::unordered_map<int, ConfigBindings> output_binding_map_;
   /*!\brief The cpu affinity setting for the tvm thread pool.*/
   std::string cpu_affinity_;
+  /*!\brief The number of elements that the queue of each input can hold.*/
+  int queue_capacity_ = DEFAULT_QUEUE_CAPACITY;
+  /*!\brief The number of requests that the module processes in one run.*/
+  int batch_size_ = 1;
+  /*!\brief The policy when the queues of the children of the module are full.*/
+  QueuePolicy queue_policy_ = BLOCK;
 };
 
 /*!
@@ -433,6 +470,14 @@ class ConfigPipelineExecution {
     auto config_runtime = config->second;
     return config_runtime.GetCPUAffinity();
   }
+  /*!\brief Get the configuration of a runtime.*/
+  const ConfigRuntime& GetRuntimeConfig(int runtime_idx) const {
+    auto config = config_.find(runtime_idx);
+    if (config == config_.end()) {
+      LOG(FATAL) << "Do not finding the runtime " << runtime_idx;
+    }
+    return config->second;
+  }
   /*!
    * \brief Enumerating the binding configuration for a specified runtime.
    * \param parse_function The callback function is used to parse the binding configuration.
@@ -503,6 +548,9 @@ class ConfigPipelineExecution {
       ConfigRuntime output;
       std::string dev;
       std::string cpu_affinity;
+      int queue_capacity = DEFAULT_QUEUE_CAPACITY;
+      int batch_size = 1;
+      std::string queue_policy = "block";
       while (reader->NextObjectItem(&key)) {
         if (key == "mod_idx") {
           reader->Read(&mod_idx);
@@ -512,6 +560,12 @@ class ConfigPipelineExecution {
           reader->Read(&output);
         } else if (key == "cpu_affinity") {
           reader->Read(&cpu_affinity);
+        } else if (key == "queue_capacity") {
+          reader->Read(&queue_capacity);
+        } else if (key == "batch_size") {
+          reader->Read(&batch_size);
+        } else if (key == "queue_policy") {
+          reader->Read(&queue_policy);
         } else {
           LOG(FATAL) << "do not support key " << key;
         }
@@ -521,6 +575,14 @@ class ConfigPipelineExecution {
       ICHECK(!output.Empty()) << "Invalid output binding result.";
       // Store the cpu affinity into the 'ConfigRuntime' structure.
       output.StoreCPUAffinity(cpu_affinity);
+      CHECK_GE(queue_capacity, 1) << "ValueError: The queue capacity of module " << mod_idx
+                                  << " should be positive, but got " << queue_capacity;
+      CHECK_GE(batch_size, 1) << "ValueError: The batch size of module " << mod_idx
+                              << " should be positive, but got " << batch_size;
+      CHECK(queue_policy == "block" || queue_policy == "drop")
+          << "ValueError: The queue policy of module " << mod_idx
+          << " should be 'block' or 'drop', but got '" << queue_policy << "'";
+      output.StoreStageConfig(queue_capacity, batch_size, queue_policy == "drop" ? DROP : BLOCK);
       // Build the mapping of mod_idx and "ConfigRuntime".
       config_[mod_idx] = output;
     }
@@ -677,6 +739,8 @@ class BasicRuntime {
   explicit BasicRuntime(int runtime_idx) : runtime_idx_(runtime_idx) {}
   /*!\brief Return the index of the current module.*/
   int GetModuleIndex() { return runtime_idx_; }
+  /*!\brief Return the number of elements that the queue of each input interface can hold.*/
+  int GetQueueCapacity() const { return queue_capacity_; }
   /*!\brief Setting the data into this runtime via the input index.*/
   virtual void SetInput(const int index, DLTensor* data_in) {}
   /*!
@@ -704,6 +768,10 @@ class BasicRuntime {
  protected:
   /*!\brief The index of runtime indicates the runtime position in the pipeline.*/
   int runtime_idx_;
+  /*!\brief The number of elements that the queue of each input interface can hold.*/
+  int queue_capacity_ = DEFAULT_QUEUE_CAPACITY;
+  /*!\brief The microseconds spent waiting for room in the queues of the children.*/
+  std::atomic<uint64_t> output_blocked_us_{0};
   /*!\brief A list of runtime which depends on the current runtime.*/
   std::unordered_map<int, ModuleInputPairList> children_;
   /*!\brief The map includes the runtime input index and the notification data structure.*/
@@ -749,13 +817,20 @@ class BasicRuntime {
     }
     auto forward_queue = forward_queue_map->at(queue_id);
     // If the queue is full, keep try until the push get success or the pipeline run into
-    // a STOP state.
-    while (!forward_queue->Push<const DLTensor*>(data)) {
-      if (PipelineIsStop()) {
-        LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
-                  << " into stop.";
-        return false;
+    // a STOP state. The time spent here is the back-pressure of the child on this runtime.
+    if (!forward_queue->Push<const DLTensor*>(data)) {
+      auto start = std::chrono::steady_clock::now();
+      while (!forward_queue->Push<const DLTensor*>(data)) {
+        if (PipelineIsStop()) {
+          LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
+                    << " into stop.";
+          return false;
+        }
+        std::this_thread::yield();
       }
+      output_blocked_us_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
     }
     child_runtime->ParentNotify(child_input_index);
     return true;
@@ -777,7 +852,7 @@ class BasicRuntime {
                  << " is already created!";
       return;
     }
-    auto queue = std::make_shared<ForwardQueue>(queue_id);
+    auto queue = std::make_shared<ForwardQueue>(queue_id, child_runtime->GetQueueCapacity());
     queue_map[queue_id] = queue;
     // Use the created queue as the consumer queue for the input interface of this forwarding
     // pair.
@@ -809,7 +884,27 @@ class BackendRuntime : public BasicRuntime {
   /*\brief The thread is associated with the current runtime*/
   std::thread thread_;
   /*!\brief The execution count of the 'RunPipeline' function. */
-  uint32_t pipeline_execution_count_ = 0;
+  std::atomic<uint32_t> pipeline_execution_count_{0};
+  /*!\brief The number of requests that the runtime processes in one run.*/
+  int batch_size_ = 1;
+  /*!\brief The policy when the queues of the children are full.*/
+  QueuePolicy queue_policy_ = BLOCK;
+  /*!\brief The views of the slots of the batched inputs, keyed by the input index.*/
+  std::unordered_map<int, std::vector<NDArray>> input_slots_;
+  /*!\brief The views of the slots of the batched outputs, keyed by the output index.*/
+  std::unordered_map<int, std::vector<NDArray>> output_slots_;
+  /*!\brief The time at which the pipeline started, which the throughput is measured from.*/
+  std::chrono::steady_clock::time_point start_time_;
+  /*!\brief The number of requests processed by the runtime.*/
+  std::atomic<uint64_t> requests_{0};
+  /*!\brief The number of requests dropped because the queues of the children were full.*/
+  std::atomic<uint64_t> dropped_requests_{0};
+  /*!\brief The microseconds spent running the module.*/
+  std::atomic<uint64_t> run_us_{0};
+  /*!\brief The microseconds spent waiting for the inputs.*/
+  std::atomic<uint64_t> input_wait_us_{0};
+  /*!\brief The largest number of elements seen in an input queue.*/
+  std::atomic<uint64_t> max_queue_depth_{0};
   /*!
    *\brief In order to transfer data from one backend runtime to another, we need a local
    * tensor variable as a medium. "input_tensor_local_copy_" is a map including
@@ -826,6 +921,7 @@ class BackendRuntime : public BasicRuntime {
   tvm::runtime::PackedFunc run_;
   /*!\brief The worker thread is used to execute the runtimes in pipeline.*/
   void StartWorkThread() {
+    start_time_ = std::chrono::steady_clock::now();
     SetPipelineState(RUNNING);
     if (runtime_idx_ == 0) {
       this->SetCPUAffinity();
@@ -859,10 +955,26 @@ class BackendRuntime : public BasicRuntime {
     SetPipelineState(STOPPED);
   }
   /*!
-   * \brief Waiting for the internal forwarding data.
+   * \brief Waiting for the internal forwarding data of all the requests of a batch.
    * \return Returning 'true' when getting a 'exit' notification otherwise returning 'false'.
    */
   bool WaitAndLoadPipelineData() {
+    auto start = std::chrono::steady_clock::now();
+    bool exit_notify = false;
+    for (int slot = 0; slot < batch_size_ && !exit_notify; slot++) {
+      exit_notify = WaitAndLoadSlotData(slot);
+    }
+    input_wait_us_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    return exit_notify;
+  }
+  /*!
+   * \brief Waiting for the internal forwarding data of one request.
+   * \param slot The slot of the batch which the data of the request is loaded into.
+   * \return Returning 'true' when getting a 'exit' notification otherwise returning 'false'.
+   */
+  bool WaitAndLoadSlotData(int slot) {
     std::unordered_map<int, std::shared_ptr<DataNotify>> notifys = parents_notify_;
     bool exit_notify = false;
     while (!notifys.empty() && !exit_notify) {
@@ -872,7 +984,7 @@ class BackendRuntime : public BasicRuntime {
       // Getting the source which sends this notification.
       auto target_input_interface_index = notify->first;
       // Loading the binding data.
-      while (!this->LoadBindingData(target_input_interface_index)) {
+      while (!this->LoadBindingData(target_input_interface_index, slot)) {
         // Waiting for the notification.
         if (!notify->second->Wait()) {
           exit_notify = true;
@@ -886,19 +998,24 @@ class BackendRuntime : public BasicRuntime {
   /*!
    * \brief Loading the binding data.
    * \param input_index The index of the interface which will receive the forwarding data.
+   * \param slot The slot of the batch which the data is loaded into.
    * \return Returning 'true' when data is loaded successfully, otherwise returning 'false'.
    */
-  bool LoadBindingData(int input_index) {
+  bool LoadBindingData(int input_index, int slot) {
     if (input_queue_.find(input_index) == input_queue_.end()) {
       LOG(FATAL) << "Not finding the associated input queue of the input " << input_index << " !";
     }
     auto queue = input_queue_[input_index];
+    uint64_t depth = queue->Size();
+    if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+      max_queue_depth_.store(depth, std::memory_order_relaxed);
+    }
     QueueData data;
     // TODO(huajsj): Doing the 'SetInput' inside the poll function to avoid one time data copy.
     if (!queue->Poll<QueueData>(&data)) {
       return false;
     }
-    SetInput(input_index, data.GetDLData());
+    SetInput(input_index, data.GetDLData(), slot);
     return true;
   }
   /*!
@@ -912,20 +1029,65 @@ class BackendRuntime : public BasicRuntime {
       if (forward_queue_.find(output_idx) == forward_queue_.end()) {
         LOG(FATAL) << "Not find the forwarding queue map for output(" << output_idx << ")!";
       }
-      NDArray output = GetOutput(output_idx);
       auto forward_queue_map = forward_queue_[output_idx];
-      // Notifying the 'children runtime' that the forwarding data are ready.
-      for (auto module_pair : child.second) {
-        auto child_runtime = module_pair.first;
-        auto child_input_index = module_pair.second;
-        auto output_data = const_cast<DLTensor*>(output.operator->());
-        if (!ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data)) {
+      // Forwarding the requests of the batch in order, and notifying the 'children runtime'
+      // that the forwarding data are ready.
+      for (int slot = 0; slot < batch_size_; slot++) {
+        NDArray output = GetOutputSlot(output_idx, slot);
+        for (auto module_pair : child.second) {
+          auto child_runtime = module_pair.first;
+          auto child_input_index = module_pair.second;
+          auto output_data = const_cast<DLTensor*>(output.operator->());
+          if (!ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+  /*!
+   * \brief Whether every queue of the children has room for the outputs of a run.
+   */
+  bool ChildrenHaveRoom() {
+    for (auto& queue_map : forward_queue_) {
+      for (auto& queue : queue_map.second) {
+        if (queue.second->Capacity() - queue.second->Size() < static_cast<size_t>(batch_size_)) {
           return false;
         }
       }
     }
     return true;
   }
+  /*!
+   * \brief Splitting a batched tensor into the views of its requests along the first axis.
+   * \param data The batched tensor.
+   */
+  std::vector<NDArray> SplitBatch(NDArray data) {
+    CHECK(data->ndim >= 1 && data->shape[0] % batch_size_ == 0)
+        << "ValueError: The batch size " << batch_size_ << " of runtime " << runtime_idx_
+        << " should divide the first dimension of its inputs and outputs, but got the shape "
+        << data.Shape();
+    std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+    shape[0] /= batch_size_;
+    uint64_t slot_bytes = GetDataSize(*data.operator->()) / batch_size_;
+    std::vector<NDArray> slots;
+    for (int slot = 0; slot < batch_size_; slot++) {
+      slots.push_back(data.CreateView(shape, data->dtype, slot * slot_bytes));
+    }
+    return slots;
+  }
+  /*!\brief Getting the view of a request in a batched output.*/
+  NDArray GetOutputSlot(int output_idx, int slot) {
+    if (batch_size_ == 1) {
+      return GetOutput(output_idx);
+    }
+    auto it = output_slots_.find(output_idx);
+    if (it == output_slots_.end()) {
+      it = output_slots_.emplace(output_idx, SplitBatch(GetOutput(output_idx))).first;
+    }
+    return it->second[slot];
+  }
   /*!
    * \brief Copying from a given tensor and using 'CPU' as the device.
    */
@@ -1002,6 +1164,54 @@ class BackendRuntime : public BasicRuntime {
    * \return The times of using pipeline function.
    */
   int GetExecutionCount() const { return pipeline_execution_count_; }
+  /*!
+   * \brief Configuring the queues and the batching of the runtime, which is done before the
+   *  pipeline is initialized.
+   * \param config The pipeline configueration.
+   * \param global_inputs_to_later_stages Whether global inputs are forwarded to the runtimes
+   *  after the first one.
+   */
+  void ConfigureStage(const ConfigPipelineExecution& config, bool global_inputs_to_later_stages) {
+    const ConfigRuntime& runtime_config = config.GetRuntimeConfig(runtime_idx_);
+    queue_capacity_ = runtime_config.GetQueueCapacity();
+    batch_size_ = runtime_config.GetBatchSize();
+    queue_policy_ = runtime_config.GetQueuePolicy();
+    // The first runtime takes the global inputs directly, one request at a time.
+    CHECK(runtime_idx_ != 0 || batch_size_ == 1)
+        << "ValueError: The first module of the pipeline takes one request at a time and "
+        << "cannot batch, but got the batch size " << batch_size_;
+    // Dropping a request in the middle of the pipeline would leave the runtimes which take the
+    // request from several parents with unmatched inputs, so requests are only dropped when they
+    // enter the pipeline.
+    CHECK(queue_policy_ == BLOCK || (runtime_idx_ == 0 && !global_inputs_to_later_stages))
+        << "ValueError: The 'drop' queue policy is only supported by the first module when no "
+        << "global input is bound to the other modules, but got it in module " << runtime_idx_;
+  }
+  /*!
+   * \brief Getting the throughput and the queue metrics of the runtime.
+   */
+  std::map<std::string, double> GetMetrics() {
+    std::map<std::string, double> metrics;
+    double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                         std::chrono::steady_clock::now() - start_time_)
+                         .count();
+    uint64_t queue_depth = 0;
+    for (auto& queue : input_queue_) {
+      queue_depth += queue.second->Size();
+    }
+    metrics["batch_size"] = batch_size_;
+    metrics["runs"] = pipeline_execution_count_.load();
+    metrics["requests"] = requests_.load();
+    metrics["dropped_requests"] = dropped_requests_.load();
+    metrics["run_us"] = run_us_.load();
+    metrics["input_wait_us"] = input_wait_us_.load();
+    metrics["output_blocked_us"] = output_blocked_us_.load();
+    metrics["queue_depth"] = queue_depth;
+    metrics["max_queue_depth"] = max_queue_depth_.load();
+    metrics["queue_capacity"] = queue_capacity_;
+    metrics["throughput"] = seconds > 0 ? requests_.load() / seconds : 0;
+    return metrics;
+  }
   /*!
    * \brief Initializing data structures for the pipeline execution.
    * \param config The pipeline configueration.
@@ -1059,9 +1269,12 @@ class BackendRuntime : public BasicRuntime {
     }
     notify->second->Notify();
   }
-  /*!\brief Creating a NDArray containing same shape and data type with a module output. */
+  /*!
+   * \brief Creating a NDArray containing same shape and data type with a module output, which
+   *  is the shape of one request when the runtime batches.
+   */
   NDArray CreateFromOutput(int idx) {
-    NDArray data = get_output_(idx);
+    NDArray data = GetOutputSlot(idx, 0);
     return CreateNDArrayFromDLTensor(const_cast<DLTensor*>(data.operator->()));
   }
   /*!\brief Return the number of output*/
@@ -1069,8 +1282,22 @@ class BackendRuntime : public BasicRuntime {
   /*!\brief Return the number of input*/
   int NumInputs() const { return get_num_inputs_(); }
   /*!\brief Setting the data to this runtime via input index.*/
-  void SetInput(const int index, DLTensor* data_in) {
+  void SetInput(const int index, DLTensor* data_in) { SetInput(index, data_in, 0); }
+  /*!
+   * \brief Setting the data of a request to this runtime via input index.
+   * \param index The input index.
+   * \param data_in The data of the request.
+   * \param slot The slot of the batch which the request takes.
+   */
+  void SetInput(const int index, DLTensor* data_in, int slot) {
     NDArray input = get_input_(index);
+    if (batch_size_ > 1) {
+      auto it = input_slots_.find(index);
+      if (it == input_slots_.end()) {
+        it = input_slots_.emplace(index, SplitBatch(input)).first;
+      }
+      input = it->second[slot];
+    }
     DLTensor* dltensor_input = const_cast<DLTensor*>(input.operator->());
     CopyFromTo(data_in, dltensor_input);
   }
@@ -1092,8 +1319,17 @@ class BackendRuntime : public BasicRuntime {
    * \return Returning false if the forwarding function failed. Otherwise, returning true.;
    */
   bool RunPipeline() {
+    if (queue_policy_ == DROP && !ChildrenHaveRoom()) {
+      dropped_requests_ += batch_size_;
+      return true;
+    }
+    auto start = std::chrono::steady_clock::now();
     Run();
+    run_us_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
     bool ret = ForwardingOutputDataToChildren();
+    requests_ += batch_size_;
     pipeline_execution_count_++;
     return ret;
   }
@@ -19,27 +19,29 @@
 #ifndef TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
 #define TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
 #include <cstddef>
-#include <thread>
-/*!\brief A single producer and single consumer lock free queue.
+
+#include "../../support/mpmc_queue.h"
+/*!\brief A single producer and single consumer lock free queue, which is the shared lock free
+ * queue of the support library with the ID of the interface it connects.
  */
 template <typename SlotType, typename IDType = int, int QueueLength = 1024>
 class SPSCLockFreeQueue {
  public:
-  explicit SPSCLockFreeQueue(IDType id) : id_(id) {}
-  /*A read barrier enforcing the CPU to performe the reads before this barrier.*/
-  inline void read_barrier() { std::atomic_thread_fence(std::memory_order_acquire); }
-  /*A write barrier enforcing the CPU to performe the writes before this barrier.*/
-  inline void write_barrier() { std::atomic_thread_fence(std::memory_order_release); }
+  /*!
+   * \brief Create a queue.
+   * \param id The ID of the queue.
+   * \param capacity The number of elements that the queue can hold.
+   */
+  explicit SPSCLockFreeQueue(IDType id, size_t capacity = QueueLength)
+      : queue_(capacity), id_(id) {}
   /*!\brief Checking whether the queue is full.*/
-  bool Full() {
-    read_barrier();
-    return ((tail_ + 1) % len_) == head_;
-  }
+  bool Full() { return queue_.Full(); }
   /*!brief Checking whether the queue is empty.*/
-  bool Empty() {
-    read_barrier();
-    return head_ == tail_;
-  }
+  bool Empty() { return queue_.Empty(); }
+  /*!\brief The number of elements in the queue.*/
+  size_t Size() { return queue_.Size(); }
+  /*!\brief The number of elements that the queue can hold.*/
+  size_t Capacity() const { return queue_.Capacity(); }
   /*!
    * \brief Pushing the data into the queue. Only a single producer will call this function.
    * \param data The data which is pushed into the queue.
@@ -47,11 +49,7 @@ class SPSCLockFreeQueue {
    */
   template <typename data_type>
   bool Push(const data_type& data) {
-    if (Full()) return false;
-    queue_[tail_] = data;
-    write_barrier();
-    tail_ = (tail_ + 1) % len_;
-    return true;
+    return queue_.TryPush(data);
   }
   /*!
    * \brief Poll the data from the front of the queue. Only the single consumer will call this
@@ -61,22 +59,12 @@ class SPSCLockFreeQueue {
    */
   template <typename data_type>
   bool Poll(data_type* data) {
-    if (Empty()) return false;
-    *data = queue_[head_];
-    write_barrier();
-    head_ = (head_ + 1) % len_;
-    return true;
+    return queue_.TryPop(data);
   }
 
  private:
-  /*!\brief The pointer points to the first slot with valid data in the queue.*/
-  size_t head_ = 0;
-  /*!\brief The end of the queue at which elements are added.*/
-  size_t tail_ = 0;
-  /*!\brief The length of the queue.*/
-  size_t len_ = QueueLength;
   /*!\brief The queue used to store the data.*/
-  SlotType queue_[QueueLength];
+  tvm::support::MPMCQueue<SlotType> queue_;
   /*!\brief The ID of the queue.*/
   IDType id_;
 };
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -697,6 +698,195 @@ Report Profiler::Report() {
   return profiling::Report(converted_rows, device_metrics, configuration_);
 }
 
+namespace {
+
+/*! \brief A latency histogram written by one thread and read concurrently by the report. */
+struct LatencyHistogram {
+  LatencyHistogram() {
+    for (std::atomic<int64_t>& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+  }
+
+  void Add(int64_t nanos) {
+    nanos = std::max<int64_t>(nanos, 0);
+    int bucket = 0;
+    for (uint64_t bits = nanos; bits != 0; bits >>= 1) ++bucket;
+    bucket = std::min(bucket, SamplingProfiler::kNumBuckets - 1);
+    // The only writer is the owning thread, so a relaxed load and store need no read-modify-write.
+    auto bump = [](std::atomic<int64_t>& value, int64_t delta) {
+      value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    };
+    bump(buckets[bucket], 1);
+    bump(count, 1);
+    bump(total_nanos, nanos);
+  }
+
+  std::atomic<int64_t> count{0};
+  std::atomic<int64_t> total_nanos{0};
+  std::atomic<int64_t> buckets[SamplingProfiler::kNumBuckets];
+};
+
+/*! \brief Estimate a quantile in nanoseconds, interpolating linearly inside its bucket. */
+double HistogramQuantile(const std::vector<int64_t>& buckets, int64_t count, double quantile) {
+  double rank = quantile * count;
+  int64_t before = 0;
+  for (size_t b = 0; b < buckets.size(); ++b) {
+    if (buckets[b] == 0) continue;
+    if (before + buckets[b] >= rank) {
+      // Bucket b holds the latencies in [2^(b - 1), 2^b) nanoseconds.
+      double lo = b == 0 ? 0 : std::ldexp(1.0, b - 1);
+      double hi = b == 0 ? 1 : std::ldexp(1.0, b);
+      return lo + (hi - lo) * (rank - before) / buckets[b];
+    }
+    before += buckets[b];
+  }
+  return 0;
+}
+
+}  // namespace
+
+struct SamplingProfiler::ThreadBuffer {
+  explicit ThreadBuffer(size_t num_calls) : histograms(num_calls) {}
+
+  /*! \brief The histogram of each call site. */
+  std::vector<LatencyHistogram> histograms;
+  /*! \brief The calls of the current request that are being timed. */
+  std::vector<std::pair<int, Timer>> in_flight;
+  /*! \brief The calls of the current request that are timed. */
+  std::vector<std::pair<int, Timer>> stopped;
+  /*! \brief The calls of the previous sampled request, whose timers are not read yet. */
+  std::vector<std::pair<int, Timer>> pending;
+  /*! \brief The number of sampled requests that ended on the thread. */
+  std::atomic<int64_t> num_sampled{0};
+
+  void ReadPending() {
+    for (std::pair<int, Timer>& call : pending) {
+      histograms[call.first].Add(call.second->SyncAndGetElapsedNanos());
+    }
+    pending.clear();
+  }
+};
+
+SamplingProfiler::SamplingProfiler(int sample_interval,
+                                   std::unordered_map<String, ObjectRef> configuration)
+    : sample_interval_(sample_interval), configuration_(configuration) {
+  CHECK_GE(sample_interval, 1) << "ValueError: The sample interval should be positive, but got "
+                               << sample_interval;
+  static std::atomic<int64_t> next_id{0};
+  id_ = next_id.fetch_add(1);
+}
+
+SamplingProfiler::~SamplingProfiler() {}
+
+int SamplingProfiler::RegisterCall(String name, Device dev) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ICHECK(buffers_.empty())
+      << "The call sites of a sampling profiler should be registered before its first request";
+  call_names_.push_back(name);
+  call_devices_.push_back(dev);
+  return static_cast<int>(call_names_.size()) - 1;
+}
+
+SamplingProfiler::ThreadBuffer* SamplingProfiler::GetThreadBuffer() {
+  static thread_local std::unordered_map<int64_t, ThreadBuffer*> thread_buffers;
+  ThreadBuffer*& buffer = thread_buffers[id_];
+  if (buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(std::make_unique<ThreadBuffer>(call_names_.size()));
+    buffer = buffers_.back().get();
+  }
+  return buffer;
+}
+
+void SamplingProfiler::ResetThreadRequest() {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  buffer->in_flight.clear();
+  buffer->stopped.clear();
+}
+
+void SamplingProfiler::StartCall(int call_id) {
+  ICHECK(0 <= call_id && call_id < static_cast<int>(call_devices_.size()));
+  GetThreadBuffer()->in_flight.emplace_back(call_id, Timer::Start(call_devices_[call_id]));
+}
+
+void SamplingProfiler::StopCall() {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  ICHECK(!buffer->in_flight.empty()) << "StopCall without a matching StartCall";
+  buffer->in_flight.back().second->Stop();
+  buffer->stopped.push_back(std::move(buffer->in_flight.back()));
+  buffer->in_flight.pop_back();
+}
+
+void SamplingProfiler::StopRequest() {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  ICHECK(buffer->in_flight.empty()) << "A sampled request ended with calls that are not stopped";
+  // The device has finished the previous sampled request, so reading its timers does not wait.
+  buffer->ReadPending();
+  std::swap(buffer->pending, buffer->stopped);
+  buffer->num_sampled.fetch_add(1, std::memory_order_relaxed);
+}
+
+Report SamplingProfiler::Report() {
+  GetThreadBuffer()->ReadPending();
+  size_t num_calls = call_names_.size();
+  std::vector<int64_t> counts(num_calls, 0);
+  std::vector<int64_t> total_nanos(num_calls, 0);
+  std::vector<std::vector<int64_t>> buckets(num_calls, std::vector<int64_t>(kNumBuckets, 0));
+  int64_t num_sampled = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+      num_sampled += buffer->num_sampled.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < num_calls; ++i) {
+        const LatencyHistogram& histogram = buffer->histograms[i];
+        counts[i] += histogram.count.load(std::memory_order_relaxed);
+        total_nanos[i] += histogram.total_nanos.load(std::memory_order_relaxed);
+        for (int b = 0; b < kNumBuckets; ++b) {
+          buckets[i][b] += histogram.buckets[b].load(std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  double overall_us = std::accumulate(total_nanos.begin(), total_nanos.end(), 0.0) / 1e3;
+  auto percent = [overall_us](double us) {
+    return ObjectRef(make_object<PercentNode>(overall_us > 0 ? us / overall_us * 100 : 0));
+  };
+  std::vector<Map<String, ObjectRef>> rows;
+  std::unordered_map<std::string, double> device_us;
+  for (size_t i = 0; i < num_calls; ++i) {
+    if (counts[i] == 0) continue;
+    double us = total_nanos[i] / 1e3;
+    std::string device = DeviceString(call_devices_[i]);
+    device_us[device] += us;
+    Map<String, ObjectRef> row;
+    row.Set("Name", call_names_[i]);
+    row.Set("Device", String(device));
+    row.Set("Count", ObjectRef(make_object<CountNode>(counts[i])));
+    row.Set("Duration (us)", ObjectRef(make_object<DurationNode>(us)));
+    row.Set("Percent", percent(us));
+    row.Set("Mean (us)", ObjectRef(make_object<DurationNode>(us / counts[i])));
+    for (auto q : {std::make_pair("p50 (us)", 0.5), std::make_pair("p90 (us)", 0.9),
+                   std::make_pair("p99 (us)", 0.99)}) {
+      double nanos = HistogramQuantile(buckets[i], counts[i], q.second);
+      row.Set(q.first, ObjectRef(make_object<DurationNode>(nanos / 1e3)));
+    }
+    rows.push_back(row);
+  }
+
+  Map<String, Map<String, ObjectRef>> device_metrics;
+  for (const auto& kv : device_us) {
+    Map<String, ObjectRef> metrics;
+    metrics.Set("Device", String(kv.first));
+    metrics.Set("Duration (us)", ObjectRef(make_object<DurationNode>(kv.second)));
+    metrics.Set("Percent", percent(kv.second));
+    device_metrics.Set(kv.first, metrics);
+  }
+  std::unordered_map<String, ObjectRef> configuration = configuration_;
+  configuration[String("Sample Interval")] = ObjectRef(make_object<CountNode>(sample_interval_));
+  configuration[String("Sampled Requests")] = ObjectRef(make_object<CountNode>(num_sampled));
+  return profiling::Report(rows, device_metrics, configuration);
+}
+
 Report::Report(Array<Map<String, ObjectRef>> calls,
                Map<String, Map<String, ObjectRef>> device_metrics,
                Map<String, ObjectRef> configuration) {
@@ -932,6 +1122,102 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
   return PackedFunc(ftimer);
 }
 
+Array<ObjectRef> InterleavedTimeEvaluate(Array<PackedFunc> funcs, Array<Array<NDArray>> args,
+                                         Device dev, int number, int repeat, int min_repeat_ms,
+                                         int cache_flush_bytes) {
+  CHECK_EQ(funcs.size(), args.size())
+      << "ValueError: Got " << funcs.size() << " functions but " << args.size()
+      << " argument lists";
+  CHECK(number > 0 && repeat > 0) << "ValueError: number and repeat must be positive";
+  int n = funcs.size();
+  std::vector<std::vector<TVMValue>> values(n);
+  std::vector<std::vector<int>> type_codes(n);
+  for (int i = 0; i < n; ++i) {
+    int num_args = args[i].size();
+    values[i].resize(num_args);
+    type_codes[i].resize(num_args);
+    TVMArgsSetter setter(values[i].data(), type_codes[i].data());
+    for (int j = 0; j < num_args; ++j) {
+      setter(j, args[i][j]);
+    }
+  }
+  NDArray arr1, arr2;
+  if (cache_flush_bytes > 0) {
+    arr1 = NDArray::Empty({cache_flush_bytes / 4}, {kDLInt, 32, 1}, dev);
+    arr2 = NDArray::Empty({cache_flush_bytes / 4}, {kDLInt, 32, 1}, dev);
+  }
+  std::vector<int> numbers(n, number);
+  std::vector<std::string> errors(n);
+  std::vector<std::vector<double>> costs(n);
+  // Time `num` runs of function `i`, and record the error if it throws
+  auto f_time = [&](int i, int num) -> double {
+    try {
+      TVMArgs fargs(values[i].data(), type_codes[i].data(), values[i].size());
+      TVMRetValue temp;
+      if (cache_flush_bytes > 0) {
+        arr1.CopyFrom(arr2);
+      }
+      DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+      Timer t = Timer::Start(dev);
+      for (int j = 0; j < num; ++j) {
+        funcs[i].CallPacked(fargs, &temp);
+      }
+      t->Stop();
+      return t->SyncAndGetElapsedNanos() / 1e6;
+    } catch (const std::runtime_error& e) {
+      errors[i] = e.what();
+      return -1.0;
+    }
+  };
+  constexpr int kLimitZeroTimeIterations = 100;
+  for (int i = 0; i < n; ++i) {
+    // Warm up, and grow `number` until a repeat takes `min_repeat_ms`
+    if (f_time(i, 1) < 0.0) {
+      continue;
+    }
+    int absolute_zero_times = 0;
+    for (double duration_ms = 0.0; duration_ms < min_repeat_ms;) {
+      if (duration_ms > 0.0) {
+        const double golden_ratio = 1.618;
+        numbers[i] = static_cast<int>(std::max((min_repeat_ms / (duration_ms / numbers[i]) + 1),
+                                               numbers[i] * golden_ratio));
+      }
+      duration_ms = f_time(i, numbers[i]);
+      if (duration_ms < 0.0 ||
+          (duration_ms == 0.0 && ++absolute_zero_times >= kLimitZeroTimeIterations)) {
+        break;
+      }
+    }
+  }
+  for (int r = 0; r < repeat; ++r) {
+    for (int k = 0; k < n; ++k) {
+      int i = (k + r) % n;
+      if (!errors[i].empty()) {
+        continue;
+      }
+      double duration_ms = f_time(i, numbers[i]);
+      if (duration_ms >= 0.0) {
+        costs[i].push_back(duration_ms / 1e3 / numbers[i]);
+      }
+    }
+  }
+  Array<ObjectRef> results;
+  results.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    if (!errors[i].empty()) {
+      results.push_back(String(errors[i]));
+    } else {
+      NDArray result = NDArray::Empty({repeat}, DataType::Float(64), {kDLCPU, 0});
+      result.CopyFromBytes(costs[i].data(), repeat * sizeof(double));
+      results.push_back(result);
+    }
+  }
+  return results;
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.InterleavedTimeEvaluate")
+    .set_body_typed(InterleavedTimeEvaluate);
+
 TVM_REGISTER_GLOBAL("runtime.profiling.Report")
     .set_body_typed([](Array<Map<String, ObjectRef>> calls,
                        Map<String, Map<String, ObjectRef>> device_metrics,
@@ -382,18 +382,14 @@ TVM_REGISTER_GLOBAL("vm.builtin.call_tir_dyn").set_body([](TVMArgs args, TVMRetV
   ShapeTuple to_unpack = args[args.size() - 1];
   size_t num_tensor_args = args.size() - 2;
 
-  std::vector<TVMValue> values(num_tensor_args + to_unpack.size());
-  std::vector<int> tcodes(num_tensor_args + to_unpack.size());
-  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
-
-  std::copy(args.values + 1, args.values + args.size() - 1, values.data());
-  std::copy(args.type_codes + 1, args.type_codes + args.size() - 1, tcodes.data());
+  TVMArgsPack<> pack(num_tensor_args + to_unpack.size());
+  runtime::TVMArgsSetter setter = pack.setter();
+  pack.CopyFrom(TVMArgs(args.values + 1, args.type_codes + 1, num_tensor_args), 0);
 
   for (size_t i = 0; i < to_unpack.size(); ++i) {
     setter(i + num_tensor_args, to_unpack[i]);
   }
-  TVMArgs func_args(values.data(), tcodes.data(), values.size());
-  func.CallPacked(func_args, rv);
+  func.CallPacked(pack.args(), rv);
 });
 
 //-------------------------------------
@@ -26,44 +26,21 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
-#include "../../../support/utils.h"
+#include <atomic>
+#include <list>
+#include <vector>
+
 #include "../../cuda/cuda_common.h"
+#include "../graph_capture.h"
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
-struct CUDAGraphCaptureKey {
-  // The unique index of the capture function within the module
-  int64_t index;
-  // The symbolic variables the capture function depends on. When the capture function is ran with
-  // different symbolic variable values, the CUDA graph will be re-captured as a different version,
-  // identified by this shape tuple. This is default constructed as an empty tuple.
-  ShapeTuple shape_expr;
-
-  CUDAGraphCaptureKey(int64_t index, const Optional<ShapeTuple>& shape_expr) : index(index) {
-    if (shape_expr) {
-      this->shape_expr = shape_expr.value();
-    }
-  }
-};
-
-struct CUDAGraphCaptureKeyHash {
-  size_t operator()(const CUDAGraphCaptureKey& key) const {
-    std::hash<int64_t> hash_fn;
-    size_t hash = hash_fn(key.index);
-    for (const auto& shape : key.shape_expr) {
-      support::HashCombine(hash, hash_fn(shape));
-    }
-    return hash;
-  }
-};
-
-struct CUDAGraphCaptureKeyEqual {
-  bool operator()(const CUDAGraphCaptureKey& lhs, const CUDAGraphCaptureKey& rhs) const {
-    return lhs.index == rhs.index && std::equal(lhs.shape_expr.begin(), lhs.shape_expr.end(),
-                                                rhs.shape_expr.begin(), rhs.shape_expr.end());
-  }
-};
+/*!
+ * \brief The maximum number of CUDA graphs kept by each virtual machine, the least recently
+ * launched ones are evicted beyond it. Zero means unlimited.
+ */
+static std::atomic<int64_t> max_num_captured_graphs{0};
 
 /*! \brief The captured state of a CUDA graph */
 struct CUDAGraphCapturedState {
@@ -80,6 +57,20 @@ struct CUDAGraphCapturedState {
   ObjectRef states;
   /*! \brief The instantiated cuda graph */
   cudaGraphExec_t exec = nullptr;
+  /*! \brief The data pointers of the tensor arguments the graph was captured with */
+  std::vector<const void*> arg_pointers;
+  /*! \brief The position of the entry in the least recently used order */
+  std::list<GraphCaptureKey>::iterator lru_pos;
+};
+
+/*! \brief The recorded kernel launches of a function, the host-side alternative of a graph */
+struct CUDALaunchRecordedState {
+  /*! \brief The returned tuple of the function */
+  ObjectRef states;
+  /*! \brief The recorded kernel launches */
+  CUDALaunchSequence launches;
+  /*! \brief The data pointers of the tensor arguments the launches were recorded with */
+  std::vector<const void*> arg_pointers;
 };
 
 /*! \brief The VM extension of CUDA graph. */
@@ -89,6 +80,8 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
 
   /*!
    * \brief Launch the cuda graph if it has been cached, otherwise execute it in capture mode.
+   * When the tensor arguments moved to other addresses since the capture, the graph is captured
+   * again and the instantiated graph is updated in place with `cudaGraphExecUpdate`.
    * \param vm The virtual machine.
    * \param capture_func The function of type (args...) -> Tuple[ObjectRef], where 'args' are the
    * static arguments that are the same for all invocations of the capture function, the returned
@@ -99,18 +92,6 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
    */
   ObjectRef RunOrCapture(VirtualMachine* vm, const ObjectRef& capture_func, ObjectRef args,
                          int64_t entry_index, Optional<ShapeTuple> shape_expr) {
-    CUDAGraphCaptureKey entry_key{entry_index, shape_expr};
-    if (auto it = capture_cache_.find(entry_key); it != capture_cache_.end()) {
-      // Launch CUDA graph
-      const auto& [states, exec] = it->second;
-      CUDA_CALL(cudaGraphLaunch(exec, CUDAThreadEntry::ThreadLocal()->stream));
-      return states;
-    }
-
-    cudaStream_t capture_stream;
-    CUDA_CALL(cudaStreamCreate(&capture_stream));
-    CUDAGraphCapturedState entry;
-
     // Set up arguments for the graph execution
     Array<ObjectRef> tuple_args = Downcast<Array<ObjectRef>>(args);
     int nargs = static_cast<int>(tuple_args.size());
@@ -121,32 +102,99 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
       ObjectRef arg = tuple_args[i];
       setter(i, arg);
     }
+    TVMArgs capture_args(values.data(), tcodes.data(), nargs);
+    std::vector<const void*> arg_pointers = GetGraphArgPointers(tuple_args);
 
+    GraphCaptureKey entry_key{entry_index, shape_expr};
+    if (auto it = capture_cache_.find(entry_key); it != capture_cache_.end()) {
+      CUDAGraphCapturedState& entry = it->second;
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+      if (entry.arg_pointers != arg_pointers) {
+        // The inputs moved. Capture the graph again and patch the instantiated graph with it,
+        // which is much cheaper than instantiating a new one.
+        cudaGraph_t graph = Capture(vm, capture_func, capture_args, &entry.states);
+        if (!UpdateGraphExec(entry.exec, graph)) {
+          CUDA_CALL(cudaGraphExecDestroy(entry.exec));
+          CUDA_CALL(cudaGraphInstantiate(&entry.exec, graph, NULL, NULL, 0));
+        }
+        CUDA_CALL(cudaGraphDestroy(graph));
+        entry.arg_pointers = std::move(arg_pointers);
+      }
+      // Launch CUDA graph
+      CUDA_CALL(cudaGraphLaunch(entry.exec, CUDAThreadEntry::ThreadLocal()->stream));
+      return entry.states;
+    }
+    EvictCapturedGraphs(max_num_captured_graphs.load() - 1);
+
+    CUDAGraphCapturedState entry;
     TVMRetValue capture_func_rv;
     // Run the function without CUDA graph. This is a warm up step to do necessary initialization
     // of the CUDA module such as loading module data, setting kernel attributes.
-    vm->InvokeClosurePacked(capture_func, TVMArgs(values.data(), tcodes.data(), nargs),
-                            &capture_func_rv);
+    vm->InvokeClosurePacked(capture_func, capture_args, &capture_func_rv);
 
     // Run the graph in capture mode
-    cudaGraph_t graph;
-    std::swap(capture_stream, CUDAThreadEntry::ThreadLocal()->stream);
-    CUDA_CALL(cudaStreamBeginCapture(CUDAThreadEntry::ThreadLocal()->stream,
-                                     cudaStreamCaptureModeGlobal));
-
-    vm->InvokeClosurePacked(capture_func, TVMArgs(values.data(), tcodes.data(), nargs),
-                            &capture_func_rv);
-    entry.states = capture_func_rv;
-    CUDA_CALL(cudaStreamEndCapture(CUDAThreadEntry::ThreadLocal()->stream, &graph));
-    std::swap(capture_stream, CUDAThreadEntry::ThreadLocal()->stream);
+    cudaGraph_t graph = Capture(vm, capture_func, capture_args, &entry.states);
+    entry.arg_pointers = std::move(arg_pointers);
 
+    lru_.push_front(entry_key);
+    entry.lru_pos = lru_.begin();
     capture_cache_[entry_key] = entry;
     CUDA_CALL(cudaGraphInstantiate(&capture_cache_[entry_key].exec, graph, NULL, NULL, 0));
-    CUDA_CALL(cudaStreamDestroy(capture_stream));
     CUDA_CALL(cudaGraphDestroy(graph));
     return entry.states;
   }
 
+  /*!
+   * \brief Launch the recorded kernels of the function if they have been recorded with the same
+   * tensor arguments, otherwise run the function and record its kernel launches. Unlike a CUDA
+   * graph, the replay is a sequence of kernel launches from the host with the launch
+   * configurations and parameters marshalled at the recording, which needs no instantiation and
+   * is recorded again cheaply when the arguments move. The function should only launch the
+   * kernels of the CUDA modules on the device, since the other device work is not replayed.
+   * \param vm The virtual machine.
+   * \param func The function of type (args...) -> Tuple[ObjectRef], as the capture function of
+   * `RunOrCapture`.
+   * \param args The static arguments of the function.
+   * \param entry_index The unique index of the function used for lookup.
+   * \return The return value of the function.
+   */
+  ObjectRef RunOrRecord(VirtualMachine* vm, const ObjectRef& func, ObjectRef args,
+                        int64_t entry_index, Optional<ShapeTuple> shape_expr) {
+    Array<ObjectRef> tuple_args = Downcast<Array<ObjectRef>>(args);
+    std::vector<const void*> arg_pointers = GetGraphArgPointers(tuple_args);
+    GraphCaptureKey entry_key{entry_index, shape_expr};
+    CUDALaunchRecordedState& entry = launch_cache_[entry_key];
+    if (entry.launches.size() > 0 && entry.arg_pointers == arg_pointers) {
+      entry.launches.Launch(static_cast<CUstream>(CUDAThreadEntry::ThreadLocal()->stream));
+      return entry.states;
+    }
+
+    int nargs = static_cast<int>(tuple_args.size());
+    std::vector<TVMValue> values(nargs);
+    std::vector<int> tcodes(nargs);
+    TVMArgsSetter setter(values.data(), tcodes.data());
+    for (int i = 0; i < nargs; ++i) {
+      ObjectRef arg = tuple_args[i];
+      setter(i, arg);
+    }
+    CUDALaunchRecordedState recorded;
+    CUDALaunchSequence*& launch_sequence = CUDAThreadEntry::ThreadLocal()->launch_sequence;
+    ICHECK(launch_sequence == nullptr) << "The recording of kernel launches cannot be nested.";
+    launch_sequence = &recorded.launches;
+    TVMRetValue rv;
+    try {
+      vm->InvokeClosurePacked(func, TVMArgs(values.data(), tcodes.data(), nargs), &rv);
+    } catch (...) {
+      launch_sequence = nullptr;
+      throw;
+    }
+    launch_sequence = nullptr;
+    recorded.states = rv;
+    recorded.arg_pointers = std::move(arg_pointers);
+    entry = std::move(recorded);
+    return entry.states;
+  }
+
   /*!
    * \brief Get the cached allocation from the cache or run the allocation function.
    * \param vm The virtual machine.
@@ -166,6 +214,69 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
     return alloc_result;
   }
 
+  /*!
+   * \brief Run the capture function on a new stream in capture mode.
+   * \param vm The virtual machine.
+   * \param capture_func The capture function.
+   * \param args The arguments of the capture function.
+   * \param states The returned tuple of the capture function.
+   * \return The captured graph, owned by the caller.
+   */
+  static cudaGraph_t Capture(VirtualMachine* vm, const ObjectRef& capture_func, TVMArgs args,
+                             ObjectRef* states) {
+    cudaStream_t capture_stream;
+    CUDA_CALL(cudaStreamCreate(&capture_stream));
+    cudaGraph_t graph;
+    std::swap(capture_stream, CUDAThreadEntry::ThreadLocal()->stream);
+    CUDA_CALL(cudaStreamBeginCapture(CUDAThreadEntry::ThreadLocal()->stream,
+                                     cudaStreamCaptureModeGlobal));
+
+    TVMRetValue capture_func_rv;
+    vm->InvokeClosurePacked(capture_func, args, &capture_func_rv);
+    *states = capture_func_rv;
+    CUDA_CALL(cudaStreamEndCapture(CUDAThreadEntry::ThreadLocal()->stream, &graph));
+    std::swap(capture_stream, CUDAThreadEntry::ThreadLocal()->stream);
+    CUDA_CALL(cudaStreamDestroy(capture_stream));
+    return graph;
+  }
+
+  /*!
+   * \brief Update the kernel parameters of an instantiated graph in place from a graph of the
+   * same topology.
+   * \return Whether the update succeeded. Otherwise the graph has to be instantiated again.
+   */
+  static bool UpdateGraphExec(cudaGraphExec_t exec, cudaGraph_t graph) {
+#if CUDART_VERSION >= 12000
+    cudaGraphExecUpdateResultInfo result_info;
+    cudaError_t err = cudaGraphExecUpdate(exec, graph, &result_info);
+#else
+    cudaGraphNode_t error_node;
+    cudaGraphExecUpdateResult update_result;
+    cudaError_t err = cudaGraphExecUpdate(exec, graph, &error_node, &update_result);
+#endif
+    if (err == cudaErrorGraphExecUpdateFailure) {
+      // Clear the error so that it is not reported by the next CUDA call.
+      cudaGetLastError();
+      return false;
+    }
+    CUDA_CALL(err);
+    return true;
+  }
+
+  /*!
+   * \brief Evict the least recently launched CUDA graphs until at most `max_num_graphs` are kept.
+   * \param max_num_graphs The number of graphs to keep, negative for no limit.
+   */
+  void EvictCapturedGraphs(int64_t max_num_graphs) {
+    if (max_num_graphs < 0) {
+      return;
+    }
+    while (static_cast<int64_t>(capture_cache_.size()) > max_num_graphs) {
+      capture_cache_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
   static constexpr const char* _type_key = "relax_vm.CUDAGraphExtension";
 
  private:
@@ -173,9 +284,15 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
    * \brief The cache of captured cuda graphs. The key is a unique index for the capture function.
    * The value is the result of the capture.
    */
-  std::unordered_map<CUDAGraphCaptureKey, CUDAGraphCapturedState, CUDAGraphCaptureKeyHash,
-                     CUDAGraphCaptureKeyEqual>
+  std::unordered_map<GraphCaptureKey, CUDAGraphCapturedState, GraphCaptureKeyHash,
+                     GraphCaptureKeyEqual>
       capture_cache_;
+  /*! \brief The keys of the captured graphs, from the most to the least recently launched */
+  std::list<GraphCaptureKey> lru_;
+  /*! \brief The cache of recorded kernel launches, with the same keys as the cuda graphs. */
+  std::unordered_map<GraphCaptureKey, CUDALaunchRecordedState, GraphCaptureKeyHash,
+                     GraphCaptureKeyEqual>
+      launch_cache_;
   /*!
    * \brief The cache of allocations. The key is a unique index for the allocation function.
    * The value is the cached allocations, which is a tuple of storages.
@@ -208,6 +325,28 @@ TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.run_or_capture")
       *rv = extension->RunOrCapture(vm, capture_func, func_args, entry_index, shape_expr);
     });
 
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_launch_sequence.run_or_record")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK(args.size() == 5 || args.size() == 4);
+      VirtualMachine* vm = VirtualMachine::GetContextPtr(args[0]);
+      auto extension = vm->GetOrCreateExtension<CUDAGraphExtension>();
+      ObjectRef func = args[1];
+      ObjectRef func_args = args[2];
+      int64_t entry_index = args[3];
+      Optional<ShapeTuple> shape_expr = NullOpt;
+      if (args.size() == 5) {
+        shape_expr = args[4].AsObjectRef<ShapeTuple>();
+      }
+      *rv = extension->RunOrRecord(vm, func, func_args, entry_index, shape_expr);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.set_max_num_captured_graphs")
+    .set_body_typed([](int64_t max_num_graphs) {
+      CHECK_GE(max_num_graphs, 0) << "ValueError: The maximum number of captured CUDA graphs "
+                                  << "should be non-negative, but got " << max_num_graphs;
+      max_num_captured_graphs = max_num_graphs;
+    });
+
 TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.get_cached_alloc")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
       ICHECK_EQ(args.size(), 3);
@@ -0,0 +1,287 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/detokenizer.cc
+ * \brief Incremental detokenization and stop-string matching of generated sequences.
+ */
+#include "detokenizer.h"
+
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <array>
+#include <queue>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The Aho-Corasick automaton of a set of stop strings, whose states are the prefixes of the
+ * stop strings, with the transitions of all bytes resolved through the failure links.
+ */
+class StopStringMatcher {
+ public:
+  explicit StopStringMatcher(const Array<String>& stop_strings) {
+    // - Build the trie of the stop strings.
+    NewState(0);
+    for (const String& stop_string : stop_strings) {
+      CHECK(!stop_string.empty()) << "The stop strings should not be empty.";
+      int32_t state = 0;
+      for (char c : std::string(stop_string)) {
+        uint8_t byte = static_cast<uint8_t>(c);
+        if (next_[state][byte] < 0) {
+          next_[state][byte] = NewState(depth_[state] + 1);
+        }
+        state = next_[state][byte];
+      }
+      match_length_[state] = stop_string.size();
+    }
+
+    // - Resolve the failure links and the transitions in breadth-first order, so that the
+    // failure state of a state is resolved before the state.
+    std::vector<int32_t> fail(next_.size(), 0);
+    std::queue<int32_t> queue;
+    for (int byte = 0; byte < 256; ++byte) {
+      if (next_[0][byte] < 0) {
+        next_[0][byte] = 0;
+      } else {
+        queue.push(next_[0][byte]);
+      }
+    }
+    while (!queue.empty()) {
+      int32_t state = queue.front();
+      queue.pop();
+      // A stop string ending at the failure state, a suffix of this state, also ends here.
+      match_length_[state] = std::max(match_length_[state], match_length_[fail[state]]);
+      for (int byte = 0; byte < 256; ++byte) {
+        int32_t child = next_[state][byte];
+        if (child < 0) {
+          next_[state][byte] = next_[fail[state]][byte];
+        } else {
+          fail[child] = next_[fail[state]][byte];
+          queue.push(child);
+        }
+      }
+    }
+  }
+
+  /*! \brief The state after a byte. */
+  int32_t Next(int32_t state, uint8_t byte) const { return next_[state][byte]; }
+
+  /*! \brief The length of the longest prefix of a stop string which the state matches. */
+  int32_t Depth(int32_t state) const { return depth_[state]; }
+
+  /*! \brief The length of the longest stop string ending at the state, or 0 if none. */
+  int32_t MatchLength(int32_t state) const { return match_length_[state]; }
+
+ private:
+  int32_t NewState(int32_t depth) {
+    std::array<int32_t, 256> next;
+    next.fill(-1);
+    next_.push_back(next);
+    depth_.push_back(depth);
+    match_length_.push_back(0);
+    return next_.size() - 1;
+  }
+
+  std::vector<std::array<int32_t, 256>> next_;
+  std::vector<int32_t> depth_;
+  std::vector<int32_t> match_length_;
+};
+
+/*! \brief The number of bytes of the UTF-8 character with a leading byte, or 0 if invalid. */
+inline int Utf8Length(uint8_t lead) {
+  if (lead < 0x80) return 1;
+  if ((lead & 0xE0) == 0xC0) return 2;
+  if ((lead & 0xF0) == 0xE0) return 3;
+  if ((lead & 0xF8) == 0xF0) return 4;
+  return 0;
+}
+
+/*!
+ * \brief Emit the complete UTF-8 characters in the first `end` bytes, replacing the invalid bytes
+ * with U+FFFD.
+ * \param bytes The bytes to emit.
+ * \param end The number of bytes which can be emitted.
+ * \param flush Whether to replace the incomplete character at the end instead of holding it.
+ * \param text The string to which the characters are appended.
+ * \return The number of emitted bytes.
+ */
+size_t EmitUtf8(const std::string& bytes, size_t end, bool flush, std::string* text) {
+  static constexpr const char* kReplacement = "\xEF\xBF\xBD";
+  size_t pos = 0;
+  while (pos < end) {
+    int length = Utf8Length(static_cast<uint8_t>(bytes[pos]));
+    bool valid = length > 0;
+    for (int i = 1; valid && i < length && pos + i < end; ++i) {
+      valid = (static_cast<uint8_t>(bytes[pos + i]) & 0xC0) == 0x80;
+    }
+    if (valid && pos + length > end) {
+      if (!flush) {
+        break;
+      }
+      valid = false;
+    }
+    if (valid) {
+      text->append(bytes, pos, length);
+      pos += length;
+    } else {
+      text->append(kReplacement);
+      pos += 1;
+    }
+  }
+  return pos;
+}
+
+DetokenizerObj::DetokenizerObj(NDArray token_bytes, NDArray token_offsets) {
+  CHECK_EQ(token_bytes->ndim, 1) << "The token bytes should be 1-dimensional.";
+  CHECK(token_bytes.DataType() == DataType::UInt(8)) << "The token bytes should be uint8.";
+  CHECK_EQ(token_offsets->ndim, 1) << "The token offsets should be 1-dimensional.";
+  CHECK(token_offsets.DataType() == DataType::Int(32)) << "The token offsets should be int32.";
+  token_bytes_.resize(token_bytes->shape[0]);
+  token_bytes.CopyToBytes(token_bytes_.data(), token_bytes_.size());
+  token_offsets_.resize(token_offsets->shape[0]);
+  token_offsets.CopyToBytes(token_offsets_.data(), token_offsets_.size() * sizeof(int32_t));
+  CHECK_GE(token_offsets_.size(), 1) << "The token offsets should have vocab_size + 1 elements.";
+  CHECK_EQ(token_offsets_.front(), 0) << "The token offsets should start at 0.";
+  CHECK_EQ(token_offsets_.back(), static_cast<int64_t>(token_bytes_.size()))
+      << "The token offsets should end at the number of token bytes.";
+  CHECK(std::is_sorted(token_offsets_.begin(), token_offsets_.end()))
+      << "The token offsets should be non-decreasing.";
+}
+
+void DetokenizerObj::AddSequence(int64_t seq_id, Array<String> stop_strings) {
+  CHECK(seq_map_.find(seq_id) == seq_map_.end())
+      << "The sequence \"" << seq_id << "\" is already in the detokenizer.";
+  Sequence seq;
+  seq.matcher = GetMatcher(stop_strings);
+  seq_map_.emplace(seq_id, std::move(seq));
+}
+
+void DetokenizerObj::RemoveSequence(int64_t seq_id, std::string* text) {
+  auto it = seq_map_.find(seq_id);
+  CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found.";
+  EmitUtf8(it->second.held, it->second.held.size(), /*flush=*/true, text);
+  seq_map_.erase(it);
+}
+
+bool DetokenizerObj::IsStopped(int64_t seq_id) const {
+  auto it = seq_map_.find(seq_id);
+  CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found.";
+  return it->second.stopped;
+}
+
+bool DetokenizerObj::Append(int64_t seq_id, int32_t token, std::string* text) {
+  auto it = seq_map_.find(seq_id);
+  CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found.";
+  Sequence& seq = it->second;
+  if (seq.stopped) {
+    return true;
+  }
+  CHECK(token >= 0 && token + 1 < static_cast<int64_t>(token_offsets_.size()))
+      << "The token " << token << " is out of the vocabulary.";
+
+  const StopStringMatcher* matcher = seq.matcher.get();
+  for (int32_t i = token_offsets_[token]; i < token_offsets_[token + 1]; ++i) {
+    seq.held.push_back(token_bytes_[i]);
+    if (matcher == nullptr) {
+      continue;
+    }
+    seq.state = matcher->Next(seq.state, static_cast<uint8_t>(token_bytes_[i]));
+    if (int32_t match_length = matcher->MatchLength(seq.state)) {
+      seq.held.resize(seq.held.size() - match_length);
+      seq.stopped = true;
+      break;
+    }
+  }
+  if (seq.stopped) {
+    EmitUtf8(seq.held, seq.held.size(), /*flush=*/true, text);
+    seq.held.clear();
+    return true;
+  }
+  // Hold the bytes which may begin a stop string, i.e., the prefix matched by the automaton.
+  // The held bytes always cover it, since at most one byte is matched per byte held.
+  size_t num_held = matcher != nullptr ? matcher->Depth(seq.state) : 0;
+  size_t num_emitted = EmitUtf8(seq.held, seq.held.size() - num_held, /*flush=*/false, text);
+  seq.held.erase(0, num_emitted);
+  return false;
+}
+
+std::shared_ptr<const StopStringMatcher> DetokenizerObj::GetMatcher(
+    const Array<String>& stop_strings) {
+  if (stop_strings.empty()) {
+    return nullptr;
+  }
+  std::string key;
+  for (const String& stop_string : stop_strings) {
+    key += std::to_string(stop_string.size()) + ":" + std::string(stop_string);
+  }
+  auto it = matchers_.find(key);
+  if (it != matchers_.end()) {
+    if (std::shared_ptr<const StopStringMatcher> matcher = it->second.lock()) {
+      return matcher;
+    }
+  }
+  // Drop the automata of the removed sequences before adding a new one.
+  for (auto iter = matchers_.begin(); iter != matchers_.end();) {
+    iter = iter->second.expired() ? matchers_.erase(iter) : std::next(iter);
+  }
+  std::shared_ptr<const StopStringMatcher> matcher =
+      std::make_shared<StopStringMatcher>(stop_strings);
+  matchers_[key] = matcher;
+  return matcher;
+}
+
+TVM_REGISTER_OBJECT_TYPE(DetokenizerObj);
+
+//-------------------------------------------------
+//  Register runtime functions
+//-------------------------------------------------
+
+TVM_REGISTER_GLOBAL("vm.builtin.detokenizer_create")
+    .set_body_typed([](NDArray token_bytes, NDArray token_offsets) {
+      return Detokenizer(
+          make_object<DetokenizerObj>(std::move(token_bytes), std::move(token_offsets)));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.detokenizer_add_sequence")
+    .set_body_method<Detokenizer>(&DetokenizerObj::AddSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.detokenizer_remove_sequence")
+    .set_body_typed([](Detokenizer detokenizer, int64_t seq_id) {
+      std::string text;
+      detokenizer->RemoveSequence(seq_id, &text);
+      return String(text);
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.detokenizer_append")
+    .set_body_typed([](Detokenizer detokenizer, int64_t seq_id, IntTuple tokens) {
+      std::string text;
+      for (int64_t token : tokens) {
+        if (detokenizer->Append(seq_id, token, &text)) {
+          break;
+        }
+      }
+      return String(text);
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.detokenizer_is_stopped")
+    .set_body_method<Detokenizer>(&DetokenizerObj::IsStopped);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/detokenizer.h
+ * \brief Incremental detokenization and stop-string matching of generated sequences.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_DETOKENIZER_H_
+#define TVM_RUNTIME_RELAX_VM_DETOKENIZER_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The Aho-Corasick automaton of a set of stop strings, defined in detokenizer.cc. */
+class StopStringMatcher;
+
+/*!
+ * \brief The detokenizer of generated sequences, which turns the tokens of each sequence into
+ * UTF-8 text incrementally from a byte-level vocabulary table, and stops a sequence at the first
+ * occurrence of any of its stop strings.
+ *
+ * The text of a sequence is emitted as soon as it is known not to be a part of a stop string or
+ * of a multi-byte UTF-8 character, so the emitted text never contains a stop string and is always
+ * valid UTF-8. The sequences with the same stop strings share one automaton.
+ */
+class DetokenizerObj : public Object {
+ public:
+  /*!
+   * \brief Create a detokenizer from a vocabulary table.
+   * \param token_bytes The uint8 bytes of all the tokens, concatenated in the order of token ids.
+   * \param token_offsets The int32 offsets of the bytes of each token in `token_bytes`, of shape
+   * (vocab_size + 1,).
+   */
+  explicit DetokenizerObj(NDArray token_bytes, NDArray token_offsets);
+
+  /*!
+   * \brief Add a sequence.
+   * \param seq_id The id of the sequence.
+   * \param stop_strings The stop strings of the sequence.
+   */
+  void AddSequence(int64_t seq_id, Array<String> stop_strings);
+
+  /*!
+   * \brief Remove a sequence, emitting its held text.
+   * \param seq_id The id of the sequence.
+   * \param text The string to which the held text is appended.
+   */
+  void RemoveSequence(int64_t seq_id, std::string* text);
+
+  /*!
+   * \brief Append a token to a sequence.
+   * \param seq_id The id of the sequence.
+   * \param token The token to append.
+   * \param text The string to which the new text of the sequence is appended.
+   * \return Whether a stop string occurs in the sequence, in which case the text ends before it
+   * and the later tokens are ignored.
+   */
+  bool Append(int64_t seq_id, int32_t token, std::string* text);
+
+  /*! \brief Whether a stop string occurs in a sequence. */
+  bool IsStopped(int64_t seq_id) const;
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.Detokenizer";
+  TVM_DECLARE_FINAL_OBJECT_INFO(DetokenizerObj, Object);
+
+ private:
+  /*! \brief The detokenization state of a sequence. */
+  struct Sequence {
+    /*! \brief The automaton of the stop strings, or nullptr without stop strings. */
+    std::shared_ptr<const StopStringMatcher> matcher;
+    /*! \brief The state of the sequence in the automaton. */
+    int32_t state = 0;
+    /*! \brief The bytes not emitted yet. */
+    std::string held;
+    /*! \brief Whether a stop string occurs in the sequence. */
+    bool stopped = false;
+  };
+
+  /*! \brief Get the automaton of a set of stop strings, shared with the other sequences. */
+  std::shared_ptr<const StopStringMatcher> GetMatcher(const Array<String>& stop_strings);
+
+  /*! \brief The bytes of all the tokens. */
+  std::string token_bytes_;
+  /*! \brief The offsets of the bytes of each token. */
+  std::vector<int32_t> token_offsets_;
+  /*! \brief The automata of the stop strings of the sequences, by the joined stop strings. */
+  std::unordered_map<std::string, std::weak_ptr<const StopStringMatcher>> matchers_;
+  std::unordered_map<int64_t, Sequence> seq_map_;
+};
+
+class Detokenizer : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(Detokenizer, ObjectRef, DetokenizerObj);
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_DETOKENIZER_H_
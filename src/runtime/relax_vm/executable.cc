@@ -22,10 +22,12 @@
  */
 
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/relax_vm/executable.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <cstring>
 #include <functional>
 #include <sstream>
 
@@ -38,6 +40,12 @@ namespace relax_vm {
 /*! \brief The magic number for the serialized VM bytecode file  */
 constexpr uint64_t kTVMVMBytecodeMagic = 0xD225DE2F4214151D;
 
+/*! \brief The magic number for the VM executable file with a mapped constant section */
+constexpr uint64_t kTVMVMMappedMagic = 0xD225DE2F4214151E;
+
+/*! \brief The alignment of the constant section in the VM executable file, a page size */
+constexpr uint64_t kMappedSectionAlignment = 4096;
+
 /*! \brief Possible types in the constant pool */
 enum ConstantType : int {
   kNDArray = 0,
@@ -46,6 +54,7 @@ enum ConstantType : int {
   kString = 3,
   kInt = 4,
   kFloat = 5,
+  kMappedNDArray = 6,
 };
 
 #define STREAM_CHECK(val, section)                                          \
@@ -194,11 +203,27 @@ void Executable::SaveToBinary(dmlc::Stream* stream) {
 }
 
 void Executable::SaveToFile(const String& file_name, const String& format) {
-  std::string data;
-  dmlc::MemoryStringStream writer(&data);
-  dmlc::SeekStream* strm = &writer;
-  Executable::SaveToBinary(strm);
-  runtime::SaveBinaryToFile(file_name, data);
+  // The file is the magic, the offset of the constant section, and the rest of the executable
+  // as a string, followed by the data of the NDArray constants at an aligned offset.
+  std::string meta, mapped_data;
+  dmlc::MemoryStringStream meta_strm(&meta);
+  SaveHeader(&meta_strm);
+  SaveGlobalSection(&meta_strm);
+  SaveConstantSection(&meta_strm, &mapped_data);
+  SaveCodeSection(&meta_strm);
+
+  uint64_t data_offset = sizeof(kTVMVMMappedMagic) + 2 * sizeof(uint64_t) + meta.size();
+  data_offset = (data_offset + kMappedSectionAlignment - 1) / kMappedSectionAlignment *
+                kMappedSectionAlignment;
+  SimpleBinaryFileStream writer(file_name, "wb");
+  dmlc::Stream* strm = &writer;
+  strm->Write(kTVMVMMappedMagic);
+  strm->Write(data_offset);
+  strm->Write(meta);
+  std::string padding(data_offset - sizeof(kTVMVMMappedMagic) - 2 * sizeof(uint64_t) - meta.size(),
+                      '\0');
+  strm->Write(padding.data(), padding.size());
+  strm->Write(mapped_data.data(), mapped_data.size());
 }
 
 Module Executable::LoadFromBinary(void* stream) {
@@ -227,11 +252,37 @@ TVM_REGISTER_GLOBAL("runtime.module.loadbinary_relax.Executable")
     .set_body_typed(Executable::LoadFromBinary);
 
 Module Executable::LoadFromFile(const String& file_name) {
-  std::string data;
-  runtime::LoadBinaryFromFile(file_name, &data);
-  dmlc::MemoryStringStream reader(&data);
-  dmlc::Stream* strm = &reader;
-  return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  auto file = std::make_shared<MappedFile>(file_name);
+  uint64_t magic = 0;
+  if (file->size() >= sizeof(magic)) {
+    std::memcpy(&magic, file->data(), sizeof(magic));
+  }
+  if (magic != kTVMVMMappedMagic) {
+    // The file only holds the executable saved by SaveToBinary.
+    std::string data(file->data(), file->size());
+    file.reset();
+    dmlc::MemoryStringStream reader(&data);
+    dmlc::Stream* strm = &reader;
+    return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  }
+
+  dmlc::MemoryFixedSizeStream reader(file->data(), file->size());
+  dmlc::Stream* file_strm = &reader;
+  uint64_t data_offset;
+  std::string meta;
+  file_strm->Read(&magic);
+  STREAM_CHECK(file_strm->Read(&data_offset), "header");
+  STREAM_CHECK(file_strm->Read(&meta), "header");
+  STREAM_CHECK(data_offset % kMappedSectionAlignment == 0 && data_offset <= file->size(),
+               "header");
+  dmlc::MemoryStringStream strm(&meta);
+
+  ObjectPtr<Executable> exec = make_object<Executable>();
+  LoadHeader(&strm);
+  exec->LoadGlobalSection(&strm);
+  exec->LoadConstantSection(&strm, file, data_offset);
+  exec->LoadCodeSection(&strm);
+  return Module(exec);
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_relax.Executable")
@@ -263,10 +314,28 @@ bool VMFuncInfo::Load(dmlc::Stream* strm) {
 
 void Executable::SaveGlobalSection(dmlc::Stream* strm) { strm->Write(func_table); }
 
-void Executable::SaveConstantSection(dmlc::Stream* strm) {
+void Executable::SaveConstantSection(dmlc::Stream* strm, std::string* mapped_data) {
   strm->Write(static_cast<uint64_t>(this->constants.size()));
   for (const auto& it : this->constants) {
-    if (it.IsObjectRef<runtime::NDArray>()) {
+    if (it.IsObjectRef<runtime::NDArray>() && mapped_data != nullptr) {
+      NDArray ndarray = it.operator NDArray();
+      size_t nbytes = GetDataSize(*ndarray.operator->());
+      size_t offset =
+          (mapped_data->size() + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+      mapped_data->resize(offset + nbytes, '\0');
+      if (nbytes != 0) {
+        ndarray.CopyToBytes(&(*mapped_data)[offset], nbytes);
+      }
+      if (!DMLC_IO_NO_ENDIAN_SWAP) {
+        int type_bytes = (ndarray->dtype.bits + 7) / 8;
+        dmlc::ByteSwap(&(*mapped_data)[offset], type_bytes, nbytes / type_bytes);
+      }
+      strm->Write(ConstantType::kMappedNDArray);
+      strm->Write(ndarray->dtype);
+      strm->Write(std::vector<int64_t>(ndarray->shape, ndarray->shape + ndarray->ndim));
+      strm->Write(static_cast<uint64_t>(offset));
+      strm->Write(static_cast<uint64_t>(nbytes));
+    } else if (it.IsObjectRef<runtime::NDArray>()) {
       strm->Write(ConstantType::kNDArray);
       runtime::SaveDLTensor(strm, it.operator DLTensor*());
     } else if (it.IsObjectRef<ShapeTuple>()) {
@@ -314,7 +383,8 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+void Executable::LoadConstantSection(dmlc::Stream* strm, const std::shared_ptr<MappedFile>& file,
+                                     size_t data_offset) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
@@ -331,6 +401,32 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
       TVMRetValue cell;
       cell = ndarray;
       this->constants.push_back(cell);
+    } else if (constant_type == ConstantType::kMappedNDArray) {
+      std::vector<int64_t> shape;
+      uint64_t offset, nbytes;
+      STREAM_CHECK(strm->Read(&dtype), "constant");
+      STREAM_CHECK(strm->Read(&shape), "constant");
+      STREAM_CHECK(strm->Read(&offset), "constant");
+      STREAM_CHECK(strm->Read(&nbytes), "constant");
+      ICHECK(file != nullptr) << "The mapped NDArray constants can only be loaded from a file.";
+      STREAM_CHECK(offset % kAllocAlignment == 0 && data_offset + offset + nbytes <= file->size(),
+                   "constant");
+      // The NDArray views the mapped file, whose pages are only read in when the data is used.
+      ndarray = NDArrayViewOfMappedFile(file, data_offset + offset, ShapeTuple(shape), dtype,
+                                        Device{kDLCPU, 0});
+      STREAM_CHECK(GetDataSize(*ndarray.operator->()) == nbytes, "constant");
+      if (!DMLC_IO_NO_ENDIAN_SWAP) {
+        // The mapping is private, so the bytes are swapped in place without touching the file.
+        int type_bytes = (dtype.bits + 7) / 8;
+        dmlc::ByteSwap(ndarray->data, type_bytes, nbytes / type_bytes);
+      }
+      if (reinterpret_cast<uintptr_t>(ndarray->data) % kAllocAlignment != 0) {
+        // The file is read into an unaligned buffer where mmap is unavailable.
+        ndarray = ndarray.CopyTo(ndarray->device);
+      }
+      TVMRetValue cell;
+      cell = ndarray;
+      this->constants.push_back(cell);
     } else if (constant_type == ConstantType::kShapeTuple) {
       uint64_t size;
       strm->Read(&size);
@@ -418,6 +514,49 @@ Module Executable::VMProfilerLoadExecutable() const {
 
 bool Executable::HasFunction(const String& name) const { return func_map.count(name); }
 
+Map<String, ShapeTuple> Executable::GetPlannedStorageBytes() const {
+  auto it_alloc = func_map.find("vm.builtin.alloc_storage");
+  Map<String, ShapeTuple> result;
+  for (const VMFuncInfo& gfunc : func_table) {
+    if (gfunc.kind != VMFuncInfo::FuncKind::kVMFunc) {
+      continue;
+    }
+    int64_t planned_bytes = 0;
+    int64_t num_dynamic_allocs = 0;
+    for (Index idx = gfunc.start_instr; it_alloc != func_map.end() && idx < gfunc.end_instr;
+         ++idx) {
+      Instruction instr = this->GetInstruction(idx);
+      if (instr.op != Opcode::Call || instr.func_idx != it_alloc->second) {
+        continue;
+      }
+      // The arguments are the VM, the buffer shape, the device index and the dtype.
+      ICHECK_GE(instr.num_args, 4);
+      Instruction::Arg shape_arg = instr.args[1];
+      Instruction::Arg device_arg = instr.args[2];
+      Instruction::Arg dtype_arg = instr.args[3];
+      if (device_arg.kind() == Instruction::ArgKind::kImmediate && device_arg.value() == -1) {
+        continue;
+      }
+      if (shape_arg.kind() != Instruction::ArgKind::kConstIdx ||
+          dtype_arg.kind() != Instruction::ArgKind::kConstIdx ||
+          !constants[shape_arg.value()].IsObjectRef<ShapeTuple>() ||
+          constants[dtype_arg.value()].type_code() != kTVMDataType) {
+        ++num_dynamic_allocs;
+        continue;
+      }
+      ShapeTuple shape = constants[shape_arg.value()].operator ShapeTuple();
+      DataType dtype(constants[dtype_arg.value()].operator DLDataType());
+      int64_t num_elements = 1;
+      for (int64_t dim : shape) {
+        num_elements *= dim;
+      }
+      planned_bytes += (num_elements * dtype.bits() * dtype.lanes() + 7) / 8;
+    }
+    result.Set(gfunc.name, ShapeTuple({planned_bytes, num_dynamic_allocs}));
+  }
+  return result;
+}
+
 String Executable::AsText() const {
   auto get_func_name = [&](Index index) -> std::string {
     if (static_cast<size_t>(index) < func_table.size()) {
@@ -0,0 +1,834 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/grammar.cc
+ * \brief Grammars of constrained decoding, compiled to token-level automata.
+ */
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief An expression of a grammar rule. */
+struct GrammarExpr {
+  enum class Kind {
+    /*! \brief A sequence of the children. */
+    kSequence,
+    /*! \brief A choice among the children. */
+    kChoice,
+    /*! \brief A string of bytes. */
+    kBytes,
+    /*! \brief A character in a set of ranges of code points. */
+    kCharClass,
+    /*! \brief A reference to a rule. */
+    kRuleRef,
+    /*! \brief A repetition of the only child. */
+    kRepeat,
+  };
+  Kind kind;
+  std::string bytes;
+  std::vector<std::pair<uint32_t, uint32_t>> ranges;
+  std::string rule;
+  std::vector<GrammarExpr> children;
+  int64_t min_repeat = 0;
+  /*! \brief The maximum number of repetitions, or -1 if unbounded. */
+  int64_t max_repeat = -1;
+};
+
+/*! \brief Append the UTF-8 encoding of a code point to a string. */
+void AppendUtf8(uint32_t code_point, std::string* bytes) {
+  if (code_point < 0x80) {
+    bytes->push_back(code_point);
+  } else if (code_point < 0x800) {
+    bytes->push_back(0xC0 | (code_point >> 6));
+    bytes->push_back(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    bytes->push_back(0xE0 | (code_point >> 12));
+    bytes->push_back(0x80 | ((code_point >> 6) & 0x3F));
+    bytes->push_back(0x80 | (code_point & 0x3F));
+  } else {
+    bytes->push_back(0xF0 | (code_point >> 18));
+    bytes->push_back(0x80 | ((code_point >> 12) & 0x3F));
+    bytes->push_back(0x80 | ((code_point >> 6) & 0x3F));
+    bytes->push_back(0x80 | (code_point & 0x3F));
+  }
+}
+
+/*!
+ * \brief The parser of the GBNF grammars, i.e., rules `name ::= expr` whose expressions are made
+ * of string literals, character classes, `.`, rule references, groups, alternatives `|` and the
+ * repetitions `*`, `+`, `?` and `{m,n}`. Comments start with `#`.
+ */
+class GrammarParser {
+ public:
+  explicit GrammarParser(const std::string& text) : text_(text) {}
+
+  std::unordered_map<std::string, GrammarExpr> Parse() {
+    std::unordered_map<std::string, GrammarExpr> rules;
+    SkipSpace();
+    while (pos_ < text_.size()) {
+      std::string name = ParseName();
+      SkipSpace();
+      Expect("::=");
+      SkipSpace();
+      CHECK(rules.find(name) == rules.end()) << "The rule \"" << name << "\" is defined twice.";
+      rules[name] = ParseChoice();
+    }
+    return rules;
+  }
+
+ private:
+  void SkipSpace() {
+    while (pos_ < text_.size()) {
+      if (std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+        ++pos_;
+      } else if (text_[pos_] == '#') {
+        while (pos_ < text_.size() && text_[pos_] != '\n') ++pos_;
+      } else {
+        break;
+      }
+    }
+  }
+
+  static bool IsNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
+  }
+
+  void Expect(const char* token) {
+    CHECK_EQ(text_.compare(pos_, std::strlen(token), token), 0)
+        << "Expect \"" << token << "\" at position " << pos_ << " of the grammar.";
+    pos_ += std::strlen(token);
+  }
+
+  std::string ParseName() {
+    size_t begin = pos_;
+    while (pos_ < text_.size() && IsNameChar(text_[pos_])) ++pos_;
+    CHECK_GT(pos_, begin) << "Expect a rule name at position " << begin << " of the grammar.";
+    return text_.substr(begin, pos_ - begin);
+  }
+
+  /*! \brief Whether a rule definition `name ::=` begins at the current position. */
+  bool AtRuleDefinition() {
+    size_t pos = pos_;
+    while (pos < text_.size() && IsNameChar(text_[pos])) ++pos;
+    if (pos == pos_) return false;
+    while (pos < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos]))) ++pos;
+    return text_.compare(pos, 3, "::=") == 0;
+  }
+
+  GrammarExpr ParseChoice() {
+    GrammarExpr choice{GrammarExpr::Kind::kChoice};
+    choice.children.push_back(ParseSequence());
+    while (pos_ < text_.size() && text_[pos_] == '|') {
+      ++pos_;
+      SkipSpace();
+      choice.children.push_back(ParseSequence());
+    }
+    return choice;
+  }
+
+  GrammarExpr ParseSequence() {
+    GrammarExpr sequence{GrammarExpr::Kind::kSequence};
+    while (pos_ < text_.size() && text_[pos_] != '|' && text_[pos_] != ')' &&
+           !AtRuleDefinition()) {
+      GrammarExpr item = ParsePrimary();
+      SkipSpace();
+      sequence.children.push_back(ParseRepetition(std::move(item)));
+    }
+    return sequence;
+  }
+
+  GrammarExpr ParseRepetition(GrammarExpr item) {
+    while (pos_ < text_.size()) {
+      int64_t min_repeat, max_repeat;
+      char c = text_[pos_];
+      if (c == '*' || c == '+' || c == '?') {
+        ++pos_;
+        min_repeat = c == '+' ? 1 : 0;
+        max_repeat = c == '?' ? 1 : -1;
+      } else if (c == '{') {
+        ++pos_;
+        min_repeat = ParseInt();
+        max_repeat = min_repeat;
+        if (text_[pos_] == ',') {
+          ++pos_;
+          max_repeat = text_[pos_] == '}' ? -1 : ParseInt();
+        }
+        Expect("}");
+        CHECK(max_repeat == -1 || max_repeat >= min_repeat)
+            << "Invalid repetition {" << min_repeat << "," << max_repeat << "} in the grammar.";
+      } else {
+        break;
+      }
+      GrammarExpr repeat{GrammarExpr::Kind::kRepeat};
+      repeat.min_repeat = min_repeat;
+      repeat.max_repeat = max_repeat;
+      repeat.children.push_back(std::move(item));
+      item = std::move(repeat);
+      SkipSpace();
+    }
+    return item;
+  }
+
+  int64_t ParseInt() {
+    size_t begin = pos_;
+    while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    CHECK_GT(pos_, begin) << "Expect an integer at position " << begin << " of the grammar.";
+    return std::stoll(text_.substr(begin, pos_ - begin));
+  }
+
+  GrammarExpr ParsePrimary() {
+    CHECK_LT(pos_, text_.size()) << "Unexpected end of the grammar.";
+    char c = text_[pos_];
+    if (c == '"') {
+      ++pos_;
+      GrammarExpr literal{GrammarExpr::Kind::kBytes};
+      while (pos_ < text_.size() && text_[pos_] != '"') {
+        if (text_[pos_] == '\\') {
+          AppendUtf8(ParseEscape(), &literal.bytes);
+        } else {
+          literal.bytes.push_back(text_[pos_++]);
+        }
+      }
+      Expect("\"");
+      return literal;
+    }
+    if (c == '[') {
+      ++pos_;
+      return ParseCharClass();
+    }
+    if (c == '.') {
+      ++pos_;
+      GrammarExpr any{GrammarExpr::Kind::kCharClass};
+      any.ranges.emplace_back(0, kMaxCodePoint);
+      return any;
+    }
+    if (c == '(') {
+      ++pos_;
+      SkipSpace();
+      GrammarExpr group = ParseChoice();
+      Expect(")");
+      return group;
+    }
+    GrammarExpr ref{GrammarExpr::Kind::kRuleRef};
+    ref.rule = ParseName();
+    return ref;
+  }
+
+  GrammarExpr ParseCharClass() {
+    GrammarExpr char_class{GrammarExpr::Kind::kCharClass};
+    bool negated = pos_ < text_.size() && text_[pos_] == '^';
+    if (negated) ++pos_;
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    while (pos_ < text_.size() && text_[pos_] != ']') {
+      uint32_t lo = ParseClassChar();
+      uint32_t hi = lo;
+      if (pos_ + 1 < text_.size() && text_[pos_] == '-' && text_[pos_ + 1] != ']') {
+        ++pos_;
+        hi = ParseClassChar();
+      }
+      CHECK_LE(lo, hi) << "Invalid character range at position " << pos_ << " of the grammar.";
+      ranges.emplace_back(lo, hi);
+    }
+    Expect("]");
+    std::sort(ranges.begin(), ranges.end());
+    if (!negated) {
+      char_class.ranges = std::move(ranges);
+      return char_class;
+    }
+    uint32_t next = 0;
+    for (const auto& [lo, hi] : ranges) {
+      if (lo > next) char_class.ranges.emplace_back(next, lo - 1);
+      next = std::max(next, hi + 1);
+    }
+    if (next <= kMaxCodePoint) char_class.ranges.emplace_back(next, kMaxCodePoint);
+    return char_class;
+  }
+
+  /*! \brief Parse a character of a character class, i.e., an escape or a UTF-8 character. */
+  uint32_t ParseClassChar() {
+    if (text_[pos_] == '\\') {
+      return ParseEscape();
+    }
+    uint8_t lead = text_[pos_];
+    int length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+    uint32_t code_point = length == 1 ? lead : lead & (0x3F >> (length - 1));
+    for (int i = 1; i < length; ++i) {
+      CHECK_LT(pos_ + i, text_.size()) << "Invalid UTF-8 in the grammar.";
+      code_point = (code_point << 6) | (static_cast<uint8_t>(text_[pos_ + i]) & 0x3F);
+    }
+    pos_ += length;
+    return code_point;
+  }
+
+  uint32_t ParseEscape() {
+    ++pos_;
+    CHECK_LT(pos_, text_.size()) << "Unexpected end of the grammar.";
+    char c = text_[pos_++];
+    int num_hex_digits = c == 'x' ? 2 : c == 'u' ? 4 : c == 'U' ? 8 : 0;
+    if (num_hex_digits == 0) {
+      switch (c) {
+        case 'n':
+          return '\n';
+        case 't':
+          return '\t';
+        case 'r':
+          return '\r';
+        default:
+          return static_cast<uint8_t>(c);
+      }
+    }
+    CHECK_LE(pos_ + num_hex_digits, text_.size()) << "Unexpected end of the grammar.";
+    uint32_t code_point = std::stoul(text_.substr(pos_, num_hex_digits), nullptr, 16);
+    pos_ += num_hex_digits;
+    CHECK_LE(code_point, kMaxCodePoint) << "Invalid code point in the grammar.";
+    return code_point;
+  }
+
+  static constexpr uint32_t kMaxCodePoint = 0x10FFFF;
+
+  const std::string& text_;
+  size_t pos_ = 0;
+};
+
+/*!
+ * \brief The byte-level NFA of a grammar, built by Thompson's construction with the references
+ * of rules inlined.
+ */
+class GrammarNFA {
+ public:
+  struct Edge {
+    uint8_t lo;
+    uint8_t hi;
+    int32_t target;
+  };
+
+  /*!
+   * \brief Build the NFA of a grammar.
+   * \param rules The rules of the grammar.
+   * \param root_rule The rule of the whole output.
+   * \param max_rule_depth The maximum number of nested expansions of each rule. The expansions of
+   * a recursive rule deeper than it match nothing, which bounds the nesting of the outputs.
+   */
+  GrammarNFA(std::unordered_map<std::string, GrammarExpr> rules, const std::string& root_rule,
+             int64_t max_rule_depth)
+      : rules_(std::move(rules)), max_rule_depth_(max_rule_depth) {
+    GrammarExpr root{GrammarExpr::Kind::kRuleRef};
+    root.rule = root_rule;
+    auto [begin, end] = Build(root);
+    start_ = begin;
+    accept_ = end;
+    PruneDeadStates();
+  }
+
+  int32_t start() const { return start_; }
+  int32_t accept() const { return accept_; }
+  size_t size() const { return edges_.size(); }
+  const std::vector<Edge>& edges(int32_t state) const { return edges_[state]; }
+  const std::vector<int32_t>& epsilons(int32_t state) const { return epsilons_[state]; }
+
+ private:
+  /*! \brief The maximum number of NFA states, which catches the grammars unrolled too deep. */
+  static constexpr size_t kMaxNumStates = 1 << 22;
+
+  int32_t NewState() {
+    CHECK_LT(edges_.size(), kMaxNumStates)
+        << "The grammar is too large, please reduce the maximum rule depth.";
+    edges_.emplace_back();
+    epsilons_.emplace_back();
+    return edges_.size() - 1;
+  }
+
+  /*! \brief Build the fragment of an expression, returning its begin and end states. */
+  std::pair<int32_t, int32_t> Build(const GrammarExpr& expr) {
+    using Kind = GrammarExpr::Kind;
+    int32_t begin = NewState();
+    int32_t end = NewState();
+    switch (expr.kind) {
+      case Kind::kSequence: {
+        int32_t cur = begin;
+        for (const GrammarExpr& child : expr.children) {
+          auto [child_begin, child_end] = Build(child);
+          epsilons_[cur].push_back(child_begin);
+          cur = child_end;
+        }
+        epsilons_[cur].push_back(end);
+        break;
+      }
+      case Kind::kChoice: {
+        for (const GrammarExpr& child : expr.children) {
+          auto [child_begin, child_end] = Build(child);
+          epsilons_[begin].push_back(child_begin);
+          epsilons_[child_end].push_back(end);
+        }
+        break;
+      }
+      case Kind::kBytes: {
+        int32_t cur = begin;
+        for (char c : expr.bytes) {
+          int32_t next = NewState();
+          edges_[cur].push_back({static_cast<uint8_t>(c), static_cast<uint8_t>(c), next});
+          cur = next;
+        }
+        epsilons_[cur].push_back(end);
+        break;
+      }
+      case Kind::kCharClass: {
+        for (const auto& [lo, hi] : expr.ranges) {
+          AddCodePointRange(lo, hi, begin, end);
+        }
+        break;
+      }
+      case Kind::kRuleRef: {
+        auto it = rules_.find(expr.rule);
+        CHECK(it != rules_.end()) << "The rule \"" << expr.rule << "\" is not defined.";
+        int64_t& depth = rule_depth_[expr.rule];
+        if (depth < max_rule_depth_) {
+          ++depth;
+          auto [child_begin, child_end] = Build(it->second);
+          --depth;
+          epsilons_[begin].push_back(child_begin);
+          epsilons_[child_end].push_back(end);
+        }
+        break;
+      }
+      case Kind::kRepeat: {
+        const GrammarExpr& child = expr.children[0];
+        int32_t cur = begin;
+        for (int64_t i = 0; i < expr.min_repeat; ++i) {
+          auto [child_begin, child_end] = Build(child);
+          epsilons_[cur].push_back(child_begin);
+          cur = child_end;
+        }
+        if (expr.max_repeat == -1) {
+          auto [child_begin, child_end] = Build(child);
+          epsilons_[cur].push_back(child_begin);
+          epsilons_[child_end].push_back(cur);
+        } else {
+          for (int64_t i = expr.min_repeat; i < expr.max_repeat; ++i) {
+            auto [child_begin, child_end] = Build(child);
+            epsilons_[cur].push_back(child_begin);
+            epsilons_[cur].push_back(end);
+            cur = child_end;
+          }
+        }
+        epsilons_[cur].push_back(end);
+        break;
+      }
+    }
+    return {begin, end};
+  }
+
+  /*!
+   * \brief Remove the transitions into the states from which the accepting state is unreachable,
+   * e.g., the prefixes of the expansions of rules beyond the maximum depth, so that every byte
+   * accepted by the automaton can be completed into an output.
+   */
+  void PruneDeadStates() {
+    std::vector<std::vector<int32_t>> predecessors(edges_.size());
+    for (size_t state = 0; state < edges_.size(); ++state) {
+      for (const Edge& edge : edges_[state]) predecessors[edge.target].push_back(state);
+      for (int32_t target : epsilons_[state]) predecessors[target].push_back(state);
+    }
+    std::vector<bool> live(edges_.size(), false);
+    std::vector<int32_t> stack{accept_};
+    live[accept_] = true;
+    while (!stack.empty()) {
+      int32_t state = stack.back();
+      stack.pop_back();
+      for (int32_t predecessor : predecessors[state]) {
+        if (!live[predecessor]) {
+          live[predecessor] = true;
+          stack.push_back(predecessor);
+        }
+      }
+    }
+    CHECK(live[start_]) << "The grammar matches nothing.";
+    for (size_t state = 0; state < edges_.size(); ++state) {
+      auto is_dead_edge = [&live](const Edge& edge) { return !live[edge.target]; };
+      auto is_dead_state = [&live](int32_t target) { return !live[target]; };
+      edges_[state].erase(std::remove_if(edges_[state].begin(), edges_[state].end(), is_dead_edge),
+                          edges_[state].end());
+      epsilons_[state].erase(
+          std::remove_if(epsilons_[state].begin(), epsilons_[state].end(), is_dead_state),
+          epsilons_[state].end());
+    }
+  }
+
+  /*! \brief Add the paths of the UTF-8 encodings of a range of code points. */
+  void AddCodePointRange(uint32_t lo, uint32_t hi, int32_t begin, int32_t end) {
+    // - Split the range at the boundaries of the lengths of the encodings.
+    static constexpr uint32_t kMaxOfLength[] = {0x7F, 0x7FF, 0xFFFF, 0x10FFFF};
+    uint32_t min_of_length = 0;
+    for (uint32_t max_of_length : kMaxOfLength) {
+      if (lo <= max_of_length && hi >= min_of_length) {
+        AddSameLengthRange(std::max(lo, min_of_length), std::min(hi, max_of_length), begin, end);
+      }
+      min_of_length = max_of_length + 1;
+    }
+  }
+
+  /*! \brief Add the paths of a range of code points whose encodings have the same length. */
+  void AddSameLengthRange(uint32_t lo, uint32_t hi, int32_t begin, int32_t end) {
+    // - Split the range until each byte of the encodings ranges independently of the others.
+    std::string lo_bytes, hi_bytes;
+    AppendUtf8(lo, &lo_bytes);
+    for (size_t i = 1; i < lo_bytes.size(); ++i) {
+      uint32_t mask = (1u << (6 * i)) - 1;
+      if ((lo & ~mask) != (hi & ~mask)) {
+        if ((lo & mask) != 0) {
+          AddSameLengthRange(lo, lo | mask, begin, end);
+          AddSameLengthRange((lo | mask) + 1, hi, begin, end);
+          return;
+        }
+        if ((hi & mask) != mask) {
+          AddSameLengthRange(lo, (hi & ~mask) - 1, begin, end);
+          AddSameLengthRange(hi & ~mask, hi, begin, end);
+          return;
+        }
+      }
+    }
+    AppendUtf8(hi, &hi_bytes);
+    int32_t cur = begin;
+    for (size_t i = 0; i < lo_bytes.size(); ++i) {
+      int32_t next = i + 1 == lo_bytes.size() ? end : NewState();
+      edges_[cur].push_back(
+          {static_cast<uint8_t>(lo_bytes[i]), static_cast<uint8_t>(hi_bytes[i]), next});
+      cur = next;
+    }
+  }
+
+  std::unordered_map<std::string, GrammarExpr> rules_;
+  int64_t max_rule_depth_;
+  std::unordered_map<std::string, int64_t> rule_depth_;
+  std::vector<std::vector<Edge>> edges_;
+  std::vector<std::vector<int32_t>> epsilons_;
+  int32_t start_;
+  int32_t accept_;
+};
+
+/*!
+ * \brief A grammar compiled for a vocabulary, whose states are the states of the byte-level DFA
+ * of the grammar, determinized lazily from its NFA.
+ *
+ * The tokens allowed at each state are computed once into a bitmask and cached. The computation
+ * walks the tokens in the order of their bytes, so that the tokens sharing a prefix share the
+ * transitions of the prefix, and the tokens extending a rejected prefix are skipped.
+ * The stop tokens are allowed exactly at the accepting states.
+ */
+class GrammarObj : public Object {
+ public:
+  /*!
+   * \brief Compile a grammar for a vocabulary.
+   * \param grammar The text of the grammar in GBNF.
+   * \param root_rule The rule of the whole output.
+   * \param token_bytes The uint8 bytes of all the tokens, concatenated in the order of token ids.
+   * \param token_offsets The int32 offsets of the bytes of each token in `token_bytes`, of shape
+   * (vocab_size + 1,).
+   * \param stop_token_ids The tokens which end the output.
+   * \param max_rule_depth The maximum number of nested expansions of each rule.
+   */
+  explicit GrammarObj(const std::string& grammar, const std::string& root_rule,
+                      NDArray token_bytes, NDArray token_offsets, IntTuple stop_token_ids,
+                      int64_t max_rule_depth)
+      : nfa_(GrammarParser(grammar).Parse(), root_rule, max_rule_depth) {
+    CHECK(token_bytes.DataType() == DataType::UInt(8)) << "The token bytes should be uint8.";
+    CHECK(token_offsets.DataType() == DataType::Int(32)) << "The token offsets should be int32.";
+    token_bytes_.resize(token_bytes.Shape()->Product());
+    token_bytes.CopyToBytes(token_bytes_.data(), token_bytes_.size());
+    token_offsets_.resize(token_offsets.Shape()->Product());
+    token_offsets.CopyToBytes(token_offsets_.data(), token_offsets_.size() * sizeof(int32_t));
+    CHECK_GE(token_offsets_.size(), 1) << "The token offsets should have vocab_size + 1 elements.";
+    vocab_size_ = token_offsets_.size() - 1;
+    num_mask_words_ = (vocab_size_ + 31) / 32;
+
+    is_stop_token_.resize(vocab_size_, false);
+    for (int64_t token : stop_token_ids) {
+      CHECK(token >= 0 && token < vocab_size_) << "The stop token " << token << " is invalid.";
+      is_stop_token_[token] = true;
+      stop_token_ids_.push_back(token);
+    }
+    // - Sort the tokens by their bytes, and record the common prefix with the previous token.
+    for (int32_t token = 0; token < vocab_size_; ++token) {
+      if (!is_stop_token_[token] && TokenLength(token) > 0) {
+        sorted_tokens_.push_back(token);
+      }
+    }
+    std::sort(sorted_tokens_.begin(), sorted_tokens_.end(), [this](int32_t a, int32_t b) {
+      return token_bytes_.compare(token_offsets_[a], TokenLength(a), token_bytes_,
+                                  token_offsets_[b], TokenLength(b)) < 0;
+    });
+    common_prefix_lengths_.resize(sorted_tokens_.size(), 0);
+    for (size_t i = 1; i < sorted_tokens_.size(); ++i) {
+      const char* prev = TokenData(sorted_tokens_[i - 1]);
+      const char* cur = TokenData(sorted_tokens_[i]);
+      int32_t max_length =
+          std::min(TokenLength(sorted_tokens_[i - 1]), TokenLength(sorted_tokens_[i]));
+      int32_t length = 0;
+      while (length < max_length && prev[length] == cur[length]) ++length;
+      common_prefix_lengths_[i] = length;
+    }
+
+    std::vector<int32_t> start{nfa_.start()};
+    initial_state_ = GetDFAState(EpsilonClosure(std::move(start)));
+  }
+
+  /*! \brief The initial state of the grammar. */
+  int64_t GetInitialState() { return initial_state_; }
+
+  /*!
+   * \brief Accept a token at a state.
+   * \return The state after the token, or -1 if the token is not allowed.
+   */
+  int64_t AcceptToken(int64_t state, int64_t token) {
+    CheckState(state);
+    CHECK(token >= 0 && token < vocab_size_) << "The token " << token << " is invalid.";
+    if (is_stop_token_[token]) {
+      return dfa_states_[state].accepting ? state : -1;
+    }
+    if (TokenLength(token) == 0) {
+      return -1;
+    }
+    int32_t cur = state;
+    const char* data = TokenData(token);
+    for (int32_t i = 0; i < TokenLength(token) && cur >= 0; ++i) {
+      cur = Next(cur, data[i]);
+    }
+    return cur;
+  }
+
+  /*! \brief Whether the output may end at a state. */
+  bool IsAccepting(int64_t state) {
+    CheckState(state);
+    return dfa_states_[state].accepting;
+  }
+
+  /*!
+   * \brief Fill the bitmasks of the tokens allowed at the states of a batch.
+   * \param states The state of each sequence of the batch, where a negative state allows all the
+   * tokens.
+   * \param bitmask The int32 bitmask of shape (batch_size, ceil(vocab_size / 32)) on CPU, whose
+   * bit `i % 32` of word `i / 32` tells whether token `i` is allowed.
+   */
+  void FillNextTokenBitmask(IntTuple states, NDArray bitmask) {
+    CHECK_EQ(bitmask->device.device_type, kDLCPU) << "The bitmask should be on CPU.";
+    CHECK(bitmask.DataType() == DataType::Int(32)) << "The bitmask should be int32.";
+    CHECK(bitmask.IsContiguous());
+    CHECK_EQ(bitmask.Shape()->Product(), static_cast<int64_t>(states.size()) * num_mask_words_)
+        << "The bitmask should have shape (batch_size, " << num_mask_words_ << ").";
+    int32_t* data = static_cast<int32_t*>(bitmask->data) + bitmask->byte_offset / sizeof(int32_t);
+    for (size_t i = 0; i < states.size(); ++i) {
+      int32_t* row = data + i * num_mask_words_;
+      if (states[i] < 0) {
+        std::fill(row, row + num_mask_words_, -1);
+        continue;
+      }
+      const std::vector<int32_t>& mask = GetMask(states[i]);
+      std::copy(mask.begin(), mask.end(), row);
+    }
+  }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.Grammar";
+  TVM_DECLARE_FINAL_OBJECT_INFO(GrammarObj, Object);
+
+ private:
+  /*! \brief The transition to be computed. */
+  static constexpr int32_t kUnknown = -2;
+
+  struct DFAState {
+    std::vector<int32_t> nfa_states;
+    bool accepting;
+    std::array<int32_t, 256> next;
+    /*! \brief The bitmask of the allowed tokens, or empty if not computed. */
+    std::vector<int32_t> mask;
+  };
+
+  int32_t TokenLength(int32_t token) const {
+    return token_offsets_[token + 1] - token_offsets_[token];
+  }
+  const char* TokenData(int32_t token) const { return token_bytes_.data() + token_offsets_[token]; }
+
+  void CheckState(int64_t state) const {
+    CHECK(state >= 0 && state < static_cast<int64_t>(dfa_states_.size()))
+        << "The grammar state " << state << " is invalid.";
+  }
+
+  std::vector<int32_t> EpsilonClosure(std::vector<int32_t> states) {
+    // The NFA states are marked with the index of the closure which visits them, so that the
+    // marks need no reset between the closures.
+    visit_marks_.resize(nfa_.size(), 0);
+    ++num_closures_;
+    std::vector<int32_t> stack = states;
+    for (int32_t state : states) visit_marks_[state] = num_closures_;
+    while (!stack.empty()) {
+      int32_t state = stack.back();
+      stack.pop_back();
+      for (int32_t next : nfa_.epsilons(state)) {
+        if (visit_marks_[next] != num_closures_) {
+          visit_marks_[next] = num_closures_;
+          states.push_back(next);
+          stack.push_back(next);
+        }
+      }
+    }
+    std::sort(states.begin(), states.end());
+    return states;
+  }
+
+  /*! \brief Get the DFA state of a closed set of NFA states, or -1 if the set is empty. */
+  int32_t GetDFAState(std::vector<int32_t> nfa_states) {
+    if (nfa_states.empty()) {
+      return -1;
+    }
+    auto it = dfa_state_ids_.find(nfa_states);
+    if (it != dfa_state_ids_.end()) {
+      return it->second;
+    }
+    DFAState state;
+    state.accepting = std::binary_search(nfa_states.begin(), nfa_states.end(), nfa_.accept());
+    state.next.fill(kUnknown);
+    state.nfa_states = nfa_states;
+    dfa_states_.push_back(std::move(state));
+    int32_t id = dfa_states_.size() - 1;
+    dfa_state_ids_.emplace(std::move(nfa_states), id);
+    return id;
+  }
+
+  int32_t Next(int32_t state, char c) {
+    uint8_t byte = static_cast<uint8_t>(c);
+    if (dfa_states_[state].next[byte] == kUnknown) {
+      std::vector<int32_t> targets;
+      for (int32_t nfa_state : dfa_states_[state].nfa_states) {
+        for (const GrammarNFA::Edge& edge : nfa_.edges(nfa_state)) {
+          if (edge.lo <= byte && byte <= edge.hi) targets.push_back(edge.target);
+        }
+      }
+      std::sort(targets.begin(), targets.end());
+      targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+      // `dfa_states_` may grow here, so the transition is stored after.
+      int32_t next = GetDFAState(EpsilonClosure(std::move(targets)));
+      dfa_states_[state].next[byte] = next;
+    }
+    return dfa_states_[state].next[byte];
+  }
+
+  const std::vector<int32_t>& GetMask(int32_t state) {
+    if (!dfa_states_[state].mask.empty()) {
+      return dfa_states_[state].mask;
+    }
+    std::vector<int32_t> mask(num_mask_words_, 0);
+    auto allow = [&mask](int32_t token) { mask[token / 32] |= 1u << (token % 32); };
+    // The DFA state after each prefix of the last token walked.
+    std::vector<int32_t> prefix_states{state};
+    // The length of the shortest rejected prefix of the last token walked.
+    int32_t rejected_length = std::numeric_limits<int32_t>::max();
+    for (size_t i = 0; i < sorted_tokens_.size(); ++i) {
+      int32_t token = sorted_tokens_[i];
+      int32_t common_length = common_prefix_lengths_[i];
+      if (common_length >= rejected_length) {
+        continue;
+      }
+      prefix_states.resize(common_length + 1);
+      rejected_length = std::numeric_limits<int32_t>::max();
+      int32_t cur = prefix_states.back();
+      const char* data = TokenData(token);
+      for (int32_t k = common_length; k < TokenLength(token); ++k) {
+        cur = Next(cur, data[k]);
+        if (cur < 0) {
+          rejected_length = k + 1;
+          break;
+        }
+        prefix_states.push_back(cur);
+      }
+      if (cur >= 0) {
+        allow(token);
+      }
+    }
+    if (dfa_states_[state].accepting) {
+      for (int32_t token : stop_token_ids_) allow(token);
+    }
+    dfa_states_[state].mask = std::move(mask);
+    return dfa_states_[state].mask;
+  }
+
+  GrammarNFA nfa_;
+  std::string token_bytes_;
+  std::vector<int32_t> token_offsets_;
+  int32_t vocab_size_;
+  int64_t num_mask_words_;
+  std::vector<bool> is_stop_token_;
+  std::vector<int32_t> stop_token_ids_;
+  /*! \brief The tokens with bytes which are not stop tokens, sorted by their bytes. */
+  std::vector<int32_t> sorted_tokens_;
+  /*! \brief The length of the common prefix of each sorted token and the previous one. */
+  std::vector<int32_t> common_prefix_lengths_;
+  std::vector<uint64_t> visit_marks_;
+  uint64_t num_closures_ = 0;
+  std::vector<DFAState> dfa_states_;
+  std::map<std::vector<int32_t>, int32_t> dfa_state_ids_;
+  int32_t initial_state_;
+};
+
+class Grammar : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(Grammar, ObjectRef, GrammarObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(GrammarObj);
+
+//-------------------------------------------------
+//  Register runtime functions
+//-------------------------------------------------
+
+TVM_REGISTER_GLOBAL("vm.builtin.grammar_compile")
+    .set_body_typed([](String grammar, String root_rule, NDArray token_bytes,
+                       NDArray token_offsets, IntTuple stop_token_ids, int64_t max_rule_depth) {
+      CHECK_GT(max_rule_depth, 0) << "The maximum rule depth should be positive.";
+      return Grammar(make_object<GrammarObj>(grammar, root_rule, std::move(token_bytes),
+                                             std::move(token_offsets), std::move(stop_token_ids),
+                                             max_rule_depth));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.grammar_get_initial_state")
+    .set_body_method<Grammar>(&GrammarObj::GetInitialState);
+TVM_REGISTER_GLOBAL("vm.builtin.grammar_accept_token")
+    .set_body_method<Grammar>(&GrammarObj::AcceptToken);
+TVM_REGISTER_GLOBAL("vm.builtin.grammar_is_accepting")
+    .set_body_method<Grammar>(&GrammarObj::IsAccepting);
+TVM_REGISTER_GLOBAL("vm.builtin.grammar_fill_next_token_bitmask")
+    .set_body_method<Grammar>(&GrammarObj::FillNextTokenBitmask);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/graph_capture.h
+ * \brief The utilities shared by the device graph builtins of Relax virtual machine, which
+ * capture the kernel launches of a function into a CUDA graph or a HIP graph and replay it.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_GRAPH_CAPTURE_H_
+#define TVM_RUNTIME_RELAX_VM_GRAPH_CAPTURE_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../../support/utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+struct GraphCaptureKey {
+  // The unique index of the capture function within the module
+  int64_t index;
+  // The symbolic variables the capture function depends on. When the capture function is ran with
+  // different symbolic variable values, the graph will be re-captured as a different version,
+  // identified by this shape tuple. This is default constructed as an empty tuple.
+  ShapeTuple shape_expr;
+
+  GraphCaptureKey(int64_t index, const Optional<ShapeTuple>& shape_expr) : index(index) {
+    if (shape_expr) {
+      this->shape_expr = shape_expr.value();
+    }
+  }
+};
+
+struct GraphCaptureKeyHash {
+  size_t operator()(const GraphCaptureKey& key) const {
+    std::hash<int64_t> hash_fn;
+    size_t hash = hash_fn(key.index);
+    for (const auto& shape : key.shape_expr) {
+      support::HashCombine(hash, hash_fn(shape));
+    }
+    return hash;
+  }
+};
+
+struct GraphCaptureKeyEqual {
+  bool operator()(const GraphCaptureKey& lhs, const GraphCaptureKey& rhs) const {
+    return lhs.index == rhs.index && std::equal(lhs.shape_expr.begin(), lhs.shape_expr.end(),
+                                                rhs.shape_expr.begin(), rhs.shape_expr.end());
+  }
+};
+
+/*! \brief Get the data pointers of the tensor arguments, which the captured kernels read. */
+inline std::vector<const void*> GetGraphArgPointers(const Array<ObjectRef>& args) {
+  std::vector<const void*> pointers;
+  for (const ObjectRef& arg : args) {
+    if (const auto* tensor = arg.as<NDArray::Container>()) {
+      pointers.push_back(static_cast<const char*>(tensor->dl_tensor.data) +
+                         tensor->dl_tensor.byte_offset);
+    }
+  }
+  return pointers;
+}
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_GRAPH_CAPTURE_H_
@@ -0,0 +1,189 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/host_copy.cc
+ * \brief The pinned host arrays and the asynchronous copies of the device arrays to the host.
+ */
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The host device whose memory is pinned for the copies of a device, or the CPU if the
+ * device has none.
+ */
+inline Device PinnedHostDevice(Device dev) {
+  switch (dev.device_type) {
+    case kDLCUDA:
+      return Device{kDLCUDAHost, 0};
+    case kDLROCM:
+      return Device{kDLROCMHost, 0};
+    default:
+      return Device{kDLCPU, 0};
+  }
+}
+
+/*!
+ * \brief Allocate an array in the pinned host memory of a device, from the pooled allocator of
+ * the pinned host device, since the allocations of pinned memory are slow.
+ *
+ * The array is a CPU array, so that the CPU functions take it as is, and returns its memory to
+ * the pool once released.
+ */
+NDArray AllocPinnedHost(ShapeTuple shape, DLDataType dtype, Device dev) {
+  Device host = PinnedHostDevice(dev);
+  memory::Allocator* alloc =
+      memory::MemoryManager::GetOrCreateAllocator(host, memory::AllocatorType::kPooled);
+  NDArray pinned = alloc->Empty(shape, dtype, host);
+  if (host.device_type == kDLCPU) {
+    return pinned;
+  }
+  // The view of the pinned array on the CPU holds the pinned array.
+  DLManagedTensor* view = new DLManagedTensor();
+  view->dl_tensor = *pinned.operator->();
+  view->dl_tensor.device = Device{kDLCPU, 0};
+  view->manager_ctx = new NDArray(pinned);
+  view->deleter = [](DLManagedTensor* self) {
+    delete static_cast<NDArray*>(self->manager_ctx);
+    delete self;
+  };
+  return NDArray::FromDLPack(view);
+}
+
+/*!
+ * \brief The copies of the arrays of a device to the host, which run on a copy stream, and
+ * finish on a thread which waits for the stream.
+ */
+class HostCopyQueue {
+ public:
+  explicit HostCopyQueue(Device dev) : dev_(dev), api_(DeviceAPI::Get(dev)) {
+    stream_ = api_->CreateStream(dev);
+    std::thread([this] { this->WaitLoop(); }).detach();
+  }
+
+  /*!
+   * \brief Copy an array of the device to a host array after the work issued to the current
+   * stream, without waiting for the copy.
+   */
+  VMFuture Copy(NDArray src, NDArray dst) {
+    VMFuture future(make_object<VMFutureObj>());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // The copy waits for the kernels which produce the source.
+      api_->SyncStreamFromTo(dev_, api_->GetCurrentStream(dev_), stream_);
+      NDArray::CopyFromTo(src.operator->(), const_cast<DLTensor*>(dst.operator->()), stream_);
+      pending_.push_back(PendingCopy{std::move(src), std::move(dst), future});
+    }
+    cv_.notify_one();
+    return future;
+  }
+
+ private:
+  struct PendingCopy {
+    NDArray src;
+    NDArray dst;
+    VMFuture future;
+  };
+
+  void WaitLoop() {
+    while (true) {
+      PendingCopy copy;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !pending_.empty(); });
+        copy = std::move(pending_.front());
+        pending_.pop_front();
+      }
+      // The copies run in order on the stream, so the copy has landed once the stream is done.
+      TVMRetValue result;
+      std::string error;
+      try {
+        api_->StreamSync(dev_, stream_);
+        result = copy.dst;
+      } catch (const std::exception& e) {
+        error = e.what();
+      }
+      copy.src = NDArray();
+      copy.dst = NDArray();
+      copy.future->Finish(std::move(result), std::move(error));
+    }
+  }
+
+  Device dev_;
+  DeviceAPI* api_;
+  TVMStreamHandle stream_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<PendingCopy> pending_;
+};
+
+/*!
+ * \brief Copy an array to the host without waiting for the copy.
+ * \param src The array to copy.
+ * \param dst The host array to copy to, or none to allocate a pinned host array.
+ * \return The future of the copy, whose result is the host array.
+ */
+VMFuture CopyToHostAsync(NDArray src, Optional<NDArray> dst) {
+  Device dev = src->device;
+  NDArray host = dst.defined() ? dst.value() : AllocPinnedHost(src.Shape(), src->dtype, dev);
+  CHECK(host->device.device_type == kDLCPU || host->device.device_type == kDLCUDAHost ||
+        host->device.device_type == kDLROCMHost)
+      << "ValueError: The destination of the copy should be a host array, but got "
+      << host->device;
+  if (dev.device_type == kDLCPU) {
+    host.CopyFrom(src);
+    VMFuture future(make_object<VMFutureObj>());
+    TVMRetValue result;
+    result = host;
+    future->Finish(std::move(result), "");
+    return future;
+  }
+  // The queues and their threads live as long as the process, like the device APIs.
+  static std::mutex mutex;
+  static auto* queues = new std::unordered_map<int64_t, std::unique_ptr<HostCopyQueue>>();
+  HostCopyQueue* queue;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<HostCopyQueue>& entry =
+        (*queues)[static_cast<int64_t>(dev.device_type) << 32 | dev.device_id];
+    if (entry == nullptr) {
+      entry = std::make_unique<HostCopyQueue>(dev);
+    }
+    queue = entry.get();
+  }
+  return queue->Copy(std::move(src), std::move(host));
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.alloc_pinned_host").set_body_typed(AllocPinnedHost);
+TVM_REGISTER_GLOBAL("vm.builtin.copy_to_host_async").set_body_typed(CopyToHostAsync);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -60,10 +60,24 @@ TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_enable_sliding_window_for_seq
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::EnableSlidingWindowForSeq);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::CommitAcceptedTokenTreeNodes);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_swap_out_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::SwapOutSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_swap_in_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::SwapInSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_add_sequence_with_prefix")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::AddSequenceWithPrefix);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_commit_sequence_prefix")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::CommitSequencePrefix);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_empty")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::Empty);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_num_available_pages")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetNumAvailablePages);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_num_total_pages")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetNumTotalPages);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_resize_page_pool")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::ResizePagePool);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_resize_page_pool_to_budget")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::ResizePagePoolToBudget);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_total_sequence_length")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetTotalSequenceLength);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_query_positions")
@@ -86,6 +100,10 @@ TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_set")
     });
 TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_debug_get")
     .set_body_method<RNNState>(&RNNStateObj::DebugGet);
+TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_get_storage")
+    .set_body_method<RNNState>(&RNNStateObj::GetStorage);
+TVM_REGISTER_GLOBAL("vm.builtin.rnn_state_get_slot_ids")
+    .set_body_method<RNNState>(&RNNStateObj::GetSlotIds);
 
 }  // namespace relax_vm
 }  // namespace runtime
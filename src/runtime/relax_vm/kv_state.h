@@ -157,6 +157,74 @@ class AttentionKVCacheObj : public KVStateObj {
   virtual void CommitAcceptedTokenTreeNodes(const IntTuple& seq_ids,
                                             const IntTuple& leaf_indices) = 0;
 
+  /************** Host Memory Swap **************/
+
+  /*!
+   * \brief Swap the K/V data of a sequence out to host memory and release its pages.
+   * The copy runs asynchronously on the copy stream of the KV cache. The sequence
+   * cannot be used until it is swapped in again, but it can be removed.
+   * \param seq_id The id of the sequence to swap out.
+   * \sa SwapInSequence
+   */
+  virtual void SwapOutSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Restore a swapped out sequence from host memory.
+   * The copy runs asynchronously and the next forward waits for it on device,
+   * so that it overlaps with the work issued before the attention.
+   * \param seq_id The id of the sequence to swap in.
+   */
+  virtual void SwapInSequence(int64_t seq_id) = 0;
+
+  /************** Prefix Cache **************/
+
+  /*!
+   * \brief Add a new sequence that reuses the K/V data of the longest prefix
+   * of its tokens found in the prefix cache.
+   * The reused K/V data is shared with the cache, not copied, except for a
+   * partially matched last page.
+   * \param seq_id The id of the new sequence to be added.
+   * \param token_ids The tokens of the new sequence.
+   * \return The length of the reused prefix. Only the tokens after it need to
+   * be prefilled. It is always smaller than the number of tokens.
+   * \sa CommitSequencePrefix
+   */
+  virtual int64_t AddSequenceWithPrefix(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /*!
+   * \brief Insert the K/V data of a sequence into the prefix cache, so that later
+   * sequences starting with the same tokens can reuse it.
+   * Cached prefixes are evicted in LRU order when the KV cache runs out of pages.
+   * \param seq_id The id of the sequence whose K/V data is to be cached.
+   * \param token_ids The tokens of the sequence, whose length must equal the
+   * current length of the sequence.
+   */
+  virtual void CommitSequencePrefix(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /************** Page Pool **************/
+
+  /*! \brief Get the total number of pages in the KV cache, used or free. */
+  virtual int32_t GetNumTotalPages() const = 0;
+
+  /*!
+   * \brief Grow or shrink the pool of pages while sequences are in the KV cache.
+   * The used pages keep their K/V data. When shrinking, cached prefixes are evicted
+   * in LRU order, and the pool does not shrink below the pages still in use.
+   * This cannot be called between BeginForward and EndForward.
+   * \param num_total_pages The requested total number of pages.
+   * \return The total number of pages after the resize.
+   */
+  virtual int32_t ResizePagePool(int64_t num_total_pages) = 0;
+
+  /*!
+   * \brief Resize the pool of pages so that the device keeps the given bytes free
+   * afterwards, such as the planned activation footprint of the model functions.
+   * \param reserved_bytes The bytes of device memory to leave for the rest of the model.
+   * \return The total number of pages after the resize.
+   * \sa ResizePagePool
+   */
+  virtual int32_t ResizePagePoolToBudget(int64_t reserved_bytes) = 0;
+
   /************** Attention **************/
 
   /*!
@@ -263,6 +331,25 @@ class RNNStateObj : public KVStateObj {
    */
   virtual NDArray DebugGet(int64_t layer_id, int64_t state_id, int64_t seq_id) = 0;
 
+  /*!
+   * \brief Get the storage of a state, in layout `(reserved_num_seqs, max_history, *state_shape)`,
+   * so that model kernels read and write the states of the current batch in place with the
+   * slot ids of GetSlotIds, instead of copying them through Get and Set.
+   * \param layer_id The model layer of the state.
+   * \param state_id The state id within the layer.
+   * \return The storage of the state.
+   */
+  virtual NDArray GetStorage(int64_t layer_id, int64_t state_id) = 0;
+
+  /*!
+   * \brief Get the slot ids of the sequences in the current batch on device.
+   * A kernel reads the state of sequence "i" at `storage[seq_slot_ids[i], history_slot_ids[i]]`
+   * and writes the new state at `storage[seq_slot_ids[i], (history_slot_ids[i] + 1) %
+   * max_history]`, as the functions of Get and Set do.
+   * \return The int32 arrays `[seq_slot_ids, history_slot_ids]` of the batch size.
+   */
+  virtual Array<NDArray> GetSlotIds() = 0;
+
   static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
   static constexpr const char* _type_key = "relax.vm.RNNState";
   TVM_DECLARE_BASE_OBJECT_INFO(RNNStateObj, KVStateObj);
@@ -0,0 +1,505 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/lm_engine.cc
+ * \brief Runtime engine of continuous batching for language models.
+ */
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "detokenizer.h"
+#include "kv_state.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The generation engine of a language model, which owns the step loop of continuous
+ * batching on top of a KV state.
+ *
+ * Each step of the engine
+ * - admits the waiting requests in submission order, while the batch has room and, for a paged
+ * KV cache, the pages of the admitted requests for their prompts and maximum numbers of new
+ * tokens fit in the cache, so that no request is preempted;
+ * - runs one forward of a batch of the decodes of the requests in generation, followed by the
+ * chunks of the prompts of the requests in prefill, of at most `prefill_chunk_size` tokens in
+ * total, which lets the paged KV cache run the decodes with the decode kernel;
+ * - samples the next token of every request whose prompt is complete in one call, checks the
+ * stop conditions, and streams the new tokens to the callbacks of the requests.
+ *
+ * With a detokenizer, the engine also turns the new tokens into text and finishes the requests
+ * at their stop strings in the same step.
+ *
+ * The forward function of the model has signature
+ * `f_forward(input_ids, logit_positions, kv_state) -> logits`, where `input_ids` are the int32
+ * tokens of the batch of shape (num_tokens,), `logit_positions` the int32 index of the last token
+ * of each sequence in `input_ids` of shape (batch_size,), and `logits` the float32 logits of those
+ * tokens of shape (batch_size, vocab_size), with optional leading unit dimensions.
+ *
+ * The engine can record the host time of the phases of each step, for benchmarking the step
+ * loop. The forward function should synchronize the device for its time to cover the kernels.
+ *
+ * The engine is not thread-safe.
+ */
+class LMEngineObj : public Object {
+ public:
+  explicit LMEngineObj(PackedFunc f_forward, KVState kv_state, Device device,
+                       int64_t max_batch_size, int64_t prefill_chunk_size, int64_t page_size)
+      : f_forward_(std::move(f_forward)),
+        kv_state_(std::move(kv_state)),
+        device_(device),
+        max_batch_size_(max_batch_size),
+        prefill_chunk_size_(prefill_chunk_size),
+        page_size_(page_size) {
+    if (const auto* kv_cache = kv_state_.as<AttentionKVCacheObj>()) {
+      num_total_pages_ = kv_cache->GetNumAvailablePages();
+    } else {
+      // The KV states other than the paged KV cache have no page budget.
+      page_size_ = 0;
+    }
+    const PackedFunc* f_sample = Registry::Get("vm.builtin.batched_sample_from_logits");
+    ICHECK(f_sample != nullptr) << "Cannot find \"vm.builtin.batched_sample_from_logits\".";
+    f_sample_ = *f_sample;
+  }
+
+  /*!
+   * \brief Set the detokenizer of the engine, with which the new text of the requests is streamed
+   * and polled along the new tokens. It should be set before any request is submitted.
+   */
+  void SetDetokenizer(Detokenizer detokenizer) {
+    CHECK(requests_.empty()) << "The detokenizer should be set before any request is submitted.";
+    detokenizer_ = std::move(detokenizer);
+  }
+
+  /*!
+   * \brief Submit a request to the engine.
+   * \param request_id The id of the request, which is also the id of its sequence in the KV state.
+   * \param prompt The tokens of the prompt.
+   * \param max_tokens The maximum number of new tokens.
+   * \param temperature The sampling temperature, where 0 means greedy.
+   * \param top_p The top-p value of sampling.
+   * \param stop_token_ids The tokens which stop the generation, and are not output.
+   * \param f_stream The optional callback `f_stream(request_id, new_tokens, finish_reason,
+   * new_text)` called after each step with new tokens or at the finish of the request.
+   * \param stop_strings The strings which stop the generation, and are not output. They need the
+   * detokenizer of the engine.
+   */
+  void Submit(int64_t request_id, IntTuple prompt, int64_t max_tokens, double temperature,
+              double top_p, IntTuple stop_token_ids, Optional<PackedFunc> f_stream,
+              Array<String> stop_strings) {
+    CHECK(requests_.find(request_id) == requests_.end())
+        << "The request \"" << request_id << "\" is already submitted.";
+    CHECK_GT(prompt.size(), 0) << "The prompt of request \"" << request_id << "\" is empty.";
+    CHECK_GT(max_tokens, 0) << "The maximum number of new tokens should be positive.";
+    CHECK(stop_strings.empty() || detokenizer_.defined())
+        << "The stop strings of request \"" << request_id << "\" need a detokenizer.";
+    Request request;
+    request.prompt.assign(prompt.begin(), prompt.end());
+    request.max_tokens = max_tokens;
+    request.temperature = temperature;
+    request.top_p = top_p;
+    request.stop_token_ids.assign(stop_token_ids.begin(), stop_token_ids.end());
+    request.f_stream = std::move(f_stream);
+    request.num_pages = NumPages(request);
+    CHECK_LE(request.num_pages, num_total_pages_)
+        << "The request \"" << request_id << "\" needs " << request.num_pages
+        << " pages, more than the " << num_total_pages_ << " pages of the KV cache.";
+    if (detokenizer_.defined()) {
+      detokenizer_->AddSequence(request_id, stop_strings);
+    }
+    requests_.emplace(request_id, std::move(request));
+    waiting_.push_back(request_id);
+  }
+
+  /*! \brief Cancel a request, releasing its sequence in the KV state. */
+  void Cancel(int64_t request_id) {
+    Request& request = GetRequest(request_id);
+    if (request.finish_reason.empty()) {
+      Finish(request_id, &request, "cancel");
+    }
+  }
+
+  /*!
+   * \brief Get the tokens and the text of a request generated since the last poll, and the reason
+   * of its finish. A request is released once a poll returns its finish reason.
+   * \return The new tokens, the finish reason "stop", "length" or "cancel", or an empty string
+   * while the request is not finished, and the new text, which is empty without a detokenizer.
+   */
+  Array<ObjectRef> Poll(int64_t request_id) {
+    Request& request = GetRequest(request_id);
+    IntTuple new_tokens(request.output.begin() + request.num_polled, request.output.end());
+    request.num_polled = request.output.size();
+    String new_text(request.text.substr(request.num_text_polled));
+    request.num_text_polled = request.text.size();
+    String finish_reason = request.finish_reason;
+    if (!finish_reason.empty()) {
+      requests_.erase(request_id);
+    }
+    return {new_tokens, finish_reason, new_text};
+  }
+
+  /*!
+   * \brief Run one step of the engine.
+   * \return The number of the unfinished requests after the step.
+   */
+  int64_t Step() {
+    Admit();
+    if (running_.empty()) {
+      return waiting_.size();
+    }
+
+    // - Batch the decodes first and then the chunks of the prompts.
+    std::vector<int64_t> seq_ids;
+    std::vector<int64_t> append_lengths;
+    std::vector<int32_t> input_ids;
+    std::vector<int32_t> logit_positions;
+    for (int64_t request_id : running_) {
+      Request& request = requests_.at(request_id);
+      if (request.num_prefilled == static_cast<int64_t>(request.prompt.size())) {
+        seq_ids.push_back(request_id);
+        append_lengths.push_back(1);
+        input_ids.push_back(request.output.back());
+        logit_positions.push_back(input_ids.size() - 1);
+      }
+    }
+    int64_t num_decodes = seq_ids.size();
+    int64_t prefill_budget = prefill_chunk_size_ - num_decodes;
+    for (int64_t request_id : running_) {
+      Request& request = requests_.at(request_id);
+      int64_t remaining = request.prompt.size() - request.num_prefilled;
+      if (remaining == 0 || prefill_budget <= 0) {
+        continue;
+      }
+      int64_t length = std::min(remaining, prefill_budget);
+      seq_ids.push_back(request_id);
+      append_lengths.push_back(length);
+      input_ids.insert(input_ids.end(), request.prompt.begin() + request.num_prefilled,
+                       request.prompt.begin() + request.num_prefilled + length);
+      logit_positions.push_back(input_ids.size() - 1);
+      prefill_budget -= length;
+    }
+
+    // - Run the forward of the batch.
+    auto tbegin = std::chrono::high_resolution_clock::now();
+    kv_state_->BeginForward(IntTuple(seq_ids), IntTuple(append_lengths));
+    auto tforward = std::chrono::high_resolution_clock::now();
+    NDArray logits = f_forward_(ToDevice(input_ids), ToDevice(logit_positions), kv_state_);
+    kv_state_->EndForward();
+    auto tsample = std::chrono::high_resolution_clock::now();
+
+    // - Sample the next token of each sequence in one call.
+    int64_t batch_size = seq_ids.size();
+    int64_t vocab_size = logits->shape[logits->ndim - 1];
+    CHECK_EQ(logits.Shape()->Product(), batch_size * vocab_size)
+        << "The forward function should return the logits of shape (batch_size, vocab_size), "
+        << "but got " << logits.Shape() << " for a batch of " << batch_size << " sequences.";
+    logits = logits.CreateView({batch_size, vocab_size}, logits->dtype);
+    std::vector<float> temperature, top_p;
+    std::vector<int32_t> top_k(batch_size, 0);
+    std::vector<int64_t> seed;
+    for (int64_t request_id : seq_ids) {
+      const Request& request = requests_.at(request_id);
+      temperature.push_back(request.temperature);
+      top_p.push_back(request.top_p);
+      seed.push_back(request_id * 1000003 + request.output.size());
+    }
+    NDArray sampled =
+        f_sample_(logits, ToCPU(temperature, DataType::Float(32)),
+                  ToCPU(top_p, DataType::Float(32)), ToCPU(top_k, DataType::Int(32)),
+                  ToCPU(seed, DataType::Int(64)));
+    const int32_t* tokens = static_cast<const int32_t*>(sampled->data);
+    if (record_step_stats_) {
+      auto tend = std::chrono::high_resolution_clock::now();
+      using Seconds = std::chrono::duration<double>;
+      step_stats_.push_back(num_decodes);
+      step_stats_.push_back(input_ids.size() - num_decodes);
+      step_stats_.push_back(Seconds(tforward - tbegin).count());
+      step_stats_.push_back(Seconds(tsample - tforward).count());
+      step_stats_.push_back(Seconds(tend - tsample).count());
+    }
+
+    // - Take the new tokens and check the stop conditions.
+    for (int64_t i = 0; i < batch_size; ++i) {
+      int64_t request_id = seq_ids[i];
+      auto it = requests_.find(request_id);
+      if (it == requests_.end() || !it->second.finish_reason.empty()) {
+        // The request is cancelled by a stream callback in this step.
+        continue;
+      }
+      Request& request = it->second;
+      if (i >= num_decodes) {
+        request.num_prefilled += append_lengths[i];
+        if (request.num_prefilled < static_cast<int64_t>(request.prompt.size())) {
+          // The prompt is not complete, so the sampled token is discarded.
+          continue;
+        }
+      }
+      int32_t token = tokens[i];
+      const std::vector<int32_t>& stop_ids = request.stop_token_ids;
+      if (std::find(stop_ids.begin(), stop_ids.end(), token) != stop_ids.end()) {
+        Finish(request_id, &request, "stop");
+        continue;
+      }
+      request.output.push_back(token);
+      if (detokenizer_.defined() && detokenizer_->Append(request_id, token, &request.text)) {
+        Finish(request_id, &request, "stop");
+      } else if (static_cast<int64_t>(request.output.size()) == request.max_tokens) {
+        Finish(request_id, &request, "length");
+      } else {
+        Stream(request_id, &request);
+      }
+    }
+    return running_.size() + waiting_.size();
+  }
+
+  /*!
+   * \brief Enable or disable the recording of the statistics of each step.
+   * \param enabled Whether to record the statistics of the following steps.
+   */
+  void SetRecordStepStats(bool enabled) { record_step_stats_ = enabled; }
+
+  /*!
+   * \brief Take the recorded statistics of the steps since the last call.
+   * \return The float64 statistics on CPU of shape (num_steps, 5), where each row is the number
+   * of decode tokens, the number of prefill tokens, and the host time in seconds of
+   * `BeginForward`, of the forward function and of sampling of a step.
+   */
+  NDArray TakeStepStats() {
+    int64_t num_steps = step_stats_.size() / kNumStepStats;
+    NDArray stats =
+        NDArray::Empty({num_steps, kNumStepStats}, DataType::Float(64), Device{kDLCPU, 0});
+    stats.CopyFromBytes(step_stats_.data(), step_stats_.size() * sizeof(double));
+    step_stats_.clear();
+    return stats;
+  }
+
+  /*!
+   * \brief Run the steps of the engine until all the requests finish.
+   * \return The number of steps.
+   */
+  int64_t Run() {
+    int64_t num_steps = 0;
+    while (!running_.empty() || !waiting_.empty()) {
+      Step();
+      ++num_steps;
+    }
+    return num_steps;
+  }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.LMEngine";
+  TVM_DECLARE_FINAL_OBJECT_INFO(LMEngineObj, Object);
+
+ private:
+  /*! \brief The number of the recorded statistics of a step. */
+  static constexpr int64_t kNumStepStats = 5;
+
+  /*! \brief The state of a request. */
+  struct Request {
+    std::vector<int32_t> prompt;
+    int64_t max_tokens;
+    float temperature;
+    float top_p;
+    std::vector<int32_t> stop_token_ids;
+    Optional<PackedFunc> f_stream;
+    /*! \brief The number of pages reserved for the request. */
+    int64_t num_pages = 0;
+    /*! \brief The number of prompt tokens in the KV state. */
+    int64_t num_prefilled = 0;
+    /*! \brief The generated tokens. */
+    std::vector<int32_t> output;
+    /*! \brief The number of generated tokens returned by Poll. */
+    int64_t num_polled = 0;
+    /*! \brief The number of generated tokens passed to the stream callback. */
+    int64_t num_streamed = 0;
+    /*! \brief The generated text, with a detokenizer. */
+    std::string text;
+    /*! \brief The number of bytes of the text returned by Poll. */
+    size_t num_text_polled = 0;
+    /*! \brief The number of bytes of the text passed to the stream callback. */
+    size_t num_text_streamed = 0;
+    /*! \brief The reason of the finish, or empty while the request is not finished. */
+    String finish_reason;
+  };
+
+  Request& GetRequest(int64_t request_id) {
+    auto it = requests_.find(request_id);
+    CHECK(it != requests_.end()) << "The request \"" << request_id << "\" cannot be found.";
+    return it->second;
+  }
+
+  /*! \brief The number of pages for the prompt and maximum new tokens of a request. */
+  int64_t NumPages(const Request& request) const {
+    if (page_size_ <= 0) {
+      return 0;
+    }
+    int64_t max_length = request.prompt.size() + request.max_tokens;
+    return (max_length + page_size_ - 1) / page_size_;
+  }
+
+  /*! \brief Admit the waiting requests in order while the batch and the pages allow. */
+  void Admit() {
+    while (!waiting_.empty() && static_cast<int64_t>(running_.size()) < max_batch_size_) {
+      int64_t request_id = waiting_.front();
+      Request& request = requests_.at(request_id);
+      if (num_reserved_pages_ + request.num_pages > num_total_pages_) {
+        break;
+      }
+      num_reserved_pages_ += request.num_pages;
+      kv_state_->AddSequence(request_id);
+      running_.push_back(request_id);
+      waiting_.pop_front();
+    }
+  }
+
+  /*! \brief Finish a request, releasing its sequence, pages and held text. */
+  void Finish(int64_t request_id, Request* request, String reason) {
+    if (detokenizer_.defined()) {
+      detokenizer_->RemoveSequence(request_id, &request->text);
+    }
+    auto it = std::find(waiting_.begin(), waiting_.end(), request_id);
+    if (it != waiting_.end()) {
+      waiting_.erase(it);
+    } else {
+      kv_state_->RemoveSequence(request_id);
+      num_reserved_pages_ -= request->num_pages;
+      running_.erase(std::find(running_.begin(), running_.end(), request_id));
+    }
+    request->finish_reason = reason;
+    Stream(request_id, request);
+  }
+
+  /*! \brief Pass the new tokens and the finish reason of a request to its callback. */
+  void Stream(int64_t request_id, Request* request) {
+    if (!request->f_stream.defined()) {
+      return;
+    }
+    IntTuple new_tokens(request->output.begin() + request->num_streamed, request->output.end());
+    request->num_streamed = request->output.size();
+    String new_text(request->text.substr(request->num_text_streamed));
+    request->num_text_streamed = request->text.size();
+    request->f_stream.value()(request_id, new_tokens, request->finish_reason, new_text);
+  }
+
+  template <typename T>
+  static NDArray ToCPU(const std::vector<T>& values, DataType dtype) {
+    NDArray array =
+        NDArray::Empty({static_cast<int64_t>(values.size())}, dtype, Device{kDLCPU, 0});
+    array.CopyFromBytes(values.data(), values.size() * sizeof(T));
+    return array;
+  }
+
+  NDArray ToDevice(const std::vector<int32_t>& values) const {
+    NDArray array =
+        NDArray::Empty({static_cast<int64_t>(values.size())}, DataType::Int(32), device_);
+    array.CopyFromBytes(values.data(), values.size() * sizeof(int32_t));
+    return array;
+  }
+
+  PackedFunc f_forward_;
+  PackedFunc f_sample_;
+  KVState kv_state_;
+  /*! \brief The detokenizer of the requests, or undefined. */
+  Detokenizer detokenizer_;
+  Device device_;
+  int64_t max_batch_size_;
+  int64_t prefill_chunk_size_;
+  int64_t page_size_;
+  /*! \brief The pages of the paged KV cache, or 0 for the KV states without pages. */
+  int64_t num_total_pages_ = 0;
+  /*! \brief The pages reserved for the admitted requests. */
+  int64_t num_reserved_pages_ = 0;
+  std::unordered_map<int64_t, Request> requests_;
+  /*! \brief The submitted requests not admitted yet, in submission order. */
+  std::deque<int64_t> waiting_;
+  /*! \brief The admitted requests, in admission order. */
+  std::vector<int64_t> running_;
+  /*! \brief Whether to record the statistics of each step. */
+  bool record_step_stats_ = false;
+  /*! \brief The recorded statistics of the steps, kNumStepStats per step. */
+  std::vector<double> step_stats_;
+};
+
+class LMEngine : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(LMEngine, ObjectRef, LMEngineObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(LMEngineObj);
+
+//-------------------------------------------------
+//  Register runtime functions
+//-------------------------------------------------
+
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_create")
+    .set_body_typed([](PackedFunc f_forward,        //
+                       KVState kv_state,            //
+                       Device device,               //
+                       int64_t max_batch_size,      //
+                       int64_t prefill_chunk_size,  //
+                       int64_t page_size) {
+      CHECK_GT(max_batch_size, 0) << "The maximum batch size should be positive.";
+      CHECK_GT(prefill_chunk_size, max_batch_size)
+          << "The prefill chunk size should be larger than the maximum batch size, so that the "
+             "prompts make progress along the decodes.";
+      return LMEngine(make_object<LMEngineObj>(std::move(f_forward), std::move(kv_state), device,
+                                               max_batch_size, prefill_chunk_size, page_size));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_submit")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      CHECK(args.size() >= 7 && args.size() <= 9)
+          << "ValueError: `vm.builtin.lm_engine_submit` expects 7 to 9 arguments, but got "
+          << args.size() << ".";
+      LMEngine engine = args[0];
+      Optional<PackedFunc> f_stream = NullOpt;
+      Array<String> stop_strings;
+      if (args.size() >= 8) {
+        f_stream = args[7].AsObjectRef<Optional<PackedFunc>>();
+      }
+      if (args.size() >= 9) {
+        stop_strings = args[8].AsObjectRef<Array<String>>();
+      }
+      engine->Submit(args[1], args[2], args[3], args[4], args[5], args[6], f_stream,
+                     stop_strings);
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_set_detokenizer")
+    .set_body_method<LMEngine>(&LMEngineObj::SetDetokenizer);
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_cancel").set_body_method<LMEngine>(&LMEngineObj::Cancel);
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_poll").set_body_method<LMEngine>(&LMEngineObj::Poll);
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_step").set_body_method<LMEngine>(&LMEngineObj::Step);
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_run").set_body_method<LMEngine>(&LMEngineObj::Run);
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_set_record_step_stats")
+    .set_body_method<LMEngine>(&LMEngineObj::SetRecordStepStats);
+TVM_REGISTER_GLOBAL("vm.builtin.lm_engine_take_step_stats")
+    .set_body_method<LMEngine>(&LMEngineObj::TakeStepStats);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -42,8 +42,15 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../contrib/random/philox.h"
 
 namespace tvm {
 namespace runtime {
@@ -113,6 +120,35 @@ class AttentionKVCacheLegacyObj : public Object {
     this->fill_count = value->shape[0];
   }
 
+  /*!
+   * \brief Reserve the slots of the cache for at least the given number of entries.
+   * The capacity grows geometrically, and only the filled entries are copied into the new data.
+   * \param num_slots The number of entries to reserve.
+   * \param max_slots The maximum number of slots, which the capacity does not grow beyond.
+   */
+  void Reserve(int64_t num_slots, int64_t max_slots = -1) {
+    int64_t reserved_slots = std::max<int64_t>(data->shape[0], 1);
+    while (num_slots > reserved_slots) {
+      reserved_slots *= 2;
+    }
+    if (max_slots >= 0) {
+      reserved_slots = std::max(std::min(reserved_slots, max_slots), num_slots);
+    }
+    if (reserved_slots <= data->shape[0]) {
+      return;
+    }
+    std::vector<int64_t> new_shape(data->shape, data->shape + data->ndim);
+    new_shape[0] = reserved_slots;
+    NDArray new_data = NDArray::Empty(new_shape, data->dtype, data->device);
+    if (fill_count > 0) {
+      std::vector<int64_t> filled_shape(data->shape, data->shape + data->ndim);
+      filled_shape[0] = fill_count;
+      new_data.CreateView(filled_shape, data->dtype)
+          .CopyFrom(data.CreateView(filled_shape, data->dtype));
+    }
+    this->data = new_data;
+  }
+
   /*!
    * \brief Append value to the cache, overrides if full.
    * \param value The value to override previous elements.
@@ -122,20 +158,8 @@ class AttentionKVCacheLegacyObj : public Object {
   void WindowOverride(NDArray value, int64_t max_cache_size, int64_t num_attention_sinks = 0) {
     CHECK(data.DataType() == value.DataType()) << "dtype mismatch";
     CHECK_LE(value->shape[0], max_cache_size - num_attention_sinks) << "dim 0 of value too large";
-    // reallocate cache
-    if (fill_count + value->shape[0] <= max_cache_size) {
-      int64_t reserved_slots = data->shape[0];
-      while (fill_count + value->shape[0] > reserved_slots) {
-        reserved_slots *= 2;
-      }
-      if (reserved_slots != data->shape[0]) {
-        std::vector<int64_t> new_shape(data->shape, data->shape + data->ndim);
-        new_shape[0] = reserved_slots;
-        NDArray new_data = NDArray::Empty(new_shape, data->dtype, data->device);
-        new_data.CreateView(data.Shape(), data->dtype).CopyFrom(data);
-        this->data = new_data;
-      }
-    }
+    // reallocate cache, which never grows beyond the window, where the values wrap around.
+    Reserve(std::min(fill_count + value->shape[0], max_cache_size), max_cache_size);
     // copy into the current position.
     ICHECK(data.IsContiguous());
 
@@ -197,17 +221,7 @@ class AttentionKVCacheLegacyObj : public Object {
   void Append(NDArray value) {
     CHECK(data.DataType() == value.DataType()) << "dtype mismatch";
     // reallocate cache
-    int64_t reserved_slots = data->shape[0];
-    while (fill_count + value->shape[0] > reserved_slots) {
-      reserved_slots *= 2;
-    }
-    if (reserved_slots != data->shape[0]) {
-      std::vector<int64_t> new_shape(data->shape, data->shape + data->ndim);
-      new_shape[0] = reserved_slots;
-      NDArray new_data = NDArray::Empty(new_shape, data->dtype, data->device);
-      new_data.CreateView(data.Shape(), data->dtype).CopyFrom(data);
-      this->data = new_data;
-    }
+    Reserve(fill_count + value->shape[0]);
     // copy into the fill count position.
     ICHECK_LE(fill_count + value->shape[0], data->shape[0]);
     ICHECK(data.IsContiguous());
@@ -337,6 +351,29 @@ void AttentionKVCacheArrayClear(Array<AttentionKVCacheLegacy> caches) {
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_array_clear")
     .set_body_typed(AttentionKVCacheArrayClear);
 
+Array<AttentionKVCacheLegacy> AttentionKVCacheArrayAppend(Array<AttentionKVCacheLegacy> caches,
+                                                          Array<NDArray> values) {
+  CHECK_EQ(caches.size(), values.size())
+      << "The number of caches (" << caches.size() << ") and values (" << values.size()
+      << ") mismatch.";
+  for (size_t i = 0; i < caches.size(); ++i) {
+    caches[i]->Append(values[i]);
+  }
+  return caches;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_array_append")
+    .set_body_typed(AttentionKVCacheArrayAppend);
+
+void AttentionKVCacheArrayReserve(Array<AttentionKVCacheLegacy> caches, int64_t num_slots) {
+  for (AttentionKVCacheLegacy cache : caches) {
+    cache->Reserve(num_slots, /*max_slots=*/num_slots);
+  }
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_array_reserve")
+    .set_body_typed(AttentionKVCacheArrayReserve);
+
 // NOTE this is a built-in highly related to LM so we put it here.
 int SampleTopPFromLogits(NDArray logits, double temperature, double top_p, double uniform_sample) {
   ICHECK(logits.IsContiguous());
@@ -496,6 +533,160 @@ int SampleTopPFromProb(NDArray prob, double top_p, double uniform_sample) {
 
 TVM_REGISTER_GLOBAL("vm.builtin.sample_top_p_from_prob").set_body_typed(SampleTopPFromProb);
 
+/*!
+ * \brief Sample a token from one row of logits with temperature, top-p and top-k.
+ *
+ * Only the candidates that can be part of the top-p / top-k set are ordered: the
+ * probabilities are filtered by a cutoff and partially sorted, so the common case
+ * never sorts the whole vocabulary.
+ *
+ * \param plogits The logits of the row.
+ * \param vocab_size The number of logits in the row.
+ * \param temperature The temperature, values close to zero select the argmax.
+ * \param top_p The probability mass to keep, 1 disables top-p.
+ * \param top_k The number of most likely tokens to keep, non-positive disables top-k.
+ * \param seed The seed of the random number generator for this row.
+ * \return The sampled token id.
+ */
+int SampleFromLogitsRow(const float* plogits, int64_t vocab_size, float temperature, float top_p,
+                        int top_k, uint64_t seed) {
+  thread_local std::vector<float> prob;
+  thread_local std::vector<std::pair<float, int>> data;
+
+  int64_t argmax = 0;
+  float max_value = plogits[0];
+  for (int64_t i = 1; i < vocab_size; ++i) {
+    if (plogits[i] > max_value) {
+      max_value = plogits[i];
+      argmax = i;
+    }
+  }
+  if (temperature < 1e-6f || top_k == 1) {
+    return static_cast<int>(argmax);
+  }
+
+  // unnormalized probabilities scaled by temperature
+  prob.resize(vocab_size);
+  float sum = 0.0f, logit_scale = 1.0f / temperature;
+  for (int64_t i = 0; i < vocab_size; ++i) {
+    prob[i] = expf((plogits[i] - max_value) * logit_scale);
+    sum += prob[i];
+  }
+  if (std::isnan(sum)) {
+    LOG(FATAL) << "The output probabilities contain NaNs, can not sample from it";
+  }
+
+  int64_t k = (top_k <= 0 || top_k > vocab_size) ? vocab_size : top_k;
+  float mass_limit = top_p < 1.0f ? top_p * sum : sum;
+
+  data.clear();
+  if (top_p < 1.0f) {
+    // By pigeonhole principle at most 1024 elements pass the cutoff. Everything that
+    // is filtered out is smaller than everything that is kept, so the filtered set
+    // is enough whenever it covers the top-p mass or has at least k elements.
+    float cutoff = mass_limit / 1024;
+    float kept = 0.0f;
+    for (int64_t i = 0; i < vocab_size; ++i) {
+      if (prob[i] >= cutoff) {
+        data.emplace_back(prob[i], static_cast<int>(i));
+        kept += prob[i];
+      }
+    }
+    if (kept < mass_limit && static_cast<int64_t>(data.size()) < k) {
+      data.clear();
+    }
+  }
+  if (data.empty()) {
+    data.reserve(vocab_size);
+    for (int64_t i = 0; i < vocab_size; ++i) {
+      data.emplace_back(prob[i], static_cast<int>(i));
+    }
+  }
+
+  auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
+    return lhs.first > rhs.first;
+  };
+  if (k < static_cast<int64_t>(data.size())) {
+    std::partial_sort(data.begin(), data.begin() + k, data.end(), fcmp);
+    data.resize(k);
+  } else {
+    std::sort(data.begin(), data.end(), fcmp);
+  }
+
+  // the sampling set ends at the first element that reaches the top-p mass
+  float top_p_sum = 0.0f;
+  size_t num_kept = 0;
+  while (num_kept < data.size() && top_p_sum < mass_limit) {
+    top_p_sum += data[num_kept++].first;
+  }
+
+  float uniform_sample = contrib::PhiloxUniform(seed) * top_p_sum;
+  float cum_sum_prob = 0.0f;
+  for (size_t i = 0; i < num_kept; ++i) {
+    cum_sum_prob += data[i].first;
+    if (uniform_sample < cum_sum_prob) {
+      return data[i].second;
+    }
+  }
+  return data[num_kept - 1].second;
+}
+
+/*!
+ * \brief Sample one token for each row of a batch of logits.
+ * \param logits The logits of shape (batch_size, vocab_size), float32.
+ * \param temperature The temperature of each row, float32 of shape (batch_size,).
+ * \param top_p The top-p value of each row, float32 of shape (batch_size,).
+ * \param top_k The top-k value of each row, int32 of shape (batch_size,). Non-positive
+ *  values disable top-k.
+ * \param seed The random seed of each row, int64 of shape (batch_size,).
+ * \return The sampled token ids, int32 of shape (batch_size,) on CPU.
+ */
+NDArray BatchedSampleFromLogits(NDArray logits, NDArray temperature, NDArray top_p,
+                                NDArray top_k, NDArray seed) {
+  auto to_cpu = [](NDArray arr) {
+    ICHECK(arr.IsContiguous());
+    return arr->device.device_type == kDLCPU ? arr : arr.CopyTo(DLDevice{kDLCPU, 0});
+  };
+  logits = to_cpu(logits);
+  temperature = to_cpu(temperature);
+  top_p = to_cpu(top_p);
+  top_k = to_cpu(top_k);
+  seed = to_cpu(seed);
+  ICHECK_EQ(logits->ndim, 2) << "The logits must have shape (batch_size, vocab_size)";
+  ICHECK(logits.DataType() == DataType::Float(32)) << "Logits data type is not float32!";
+  ICHECK(temperature.DataType() == DataType::Float(32)) << "temperature must be float32!";
+  ICHECK(top_p.DataType() == DataType::Float(32)) << "top_p must be float32!";
+  ICHECK(top_k.DataType() == DataType::Int(32)) << "top_k must be int32!";
+  ICHECK(seed.DataType() == DataType::Int(64)) << "seed must be int64!";
+
+  int64_t batch_size = logits->shape[0];
+  int64_t vocab_size = logits->shape[1];
+  ICHECK_GT(vocab_size, 0);
+  for (const NDArray& arr : {temperature, top_p, top_k, seed}) {
+    ICHECK_EQ(arr.Shape()->Product(), batch_size)
+        << "The sampling parameters must have one value for each row of logits";
+  }
+
+  NDArray result = NDArray::Empty({batch_size}, DataType::Int(32), DLDevice{kDLCPU, 0});
+  const float* plogits = static_cast<float*>(logits->data);
+  const float* ptemperature = static_cast<float*>(temperature->data);
+  const float* ptop_p = static_cast<float*>(top_p->data);
+  const int32_t* ptop_k = static_cast<int32_t*>(top_k->data);
+  const int64_t* pseed = static_cast<int64_t*>(seed->data);
+  int32_t* presult = static_cast<int32_t*>(result->data);
+  if (batch_size == 0) return result;
+  parallel_for_with_threading_backend(
+      [&](int64_t i) {
+        presult[i] = SampleFromLogitsRow(plogits + i * vocab_size, vocab_size, ptemperature[i],
+                                         ptop_p[i], ptop_k[i], static_cast<uint64_t>(pseed[i]));
+      },
+      0, batch_size);
+  return result;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.batched_sample_from_logits")
+    .set_body_typed(BatchedSampleFromLogits);
+
 NDArray MultinomialFromUniform(NDArray prob, NDArray uniform_sample) {
   ICHECK(prob.IsContiguous());
   ICHECK(uniform_sample.IsContiguous());
@@ -592,6 +783,52 @@ void ApplyPresenceAndFrequencyPenalty(NDArray logits, NDArray token_ids, NDArray
 TVM_REGISTER_GLOBAL("vm.builtin.apply_presence_and_frequency_penalty")
     .set_body_typed(ApplyPresenceAndFrequencyPenalty);
 
+/*!
+ * \brief Mask the logits of the tokens disallowed by a bitmask, e.g., of grammars, for a batch.
+ * This is an inplace operation.
+ * \param logits The logits of shape (batch_size, vocab_size).
+ * \param bitmask The int32 bitmask of shape (batch_size, ceil(vocab_size / 32)), whose bit
+ * `i % 32` of word `i / 32` tells whether token `i` is allowed. The logits of the disallowed
+ * tokens are set to -inf.
+ */
+void ApplyTokenBitmaskInplace(NDArray logits, NDArray bitmask) {
+  ICHECK(logits.IsContiguous());
+  ICHECK(bitmask.IsContiguous());
+  ICHECK(logits.DataType() == DataType::Float(32)) << "Logits data type is not float32!";
+  ICHECK(bitmask.DataType() == DataType::Int(32)) << "bitmask must be int32!";
+  ICHECK(logits->device.device_type == kDLCPU) << "logits device must be CPU!";
+  ICHECK(bitmask->device.device_type == kDLCPU) << "bitmask device must be CPU!";
+  ICHECK_EQ(logits->ndim, 2) << "The logits must have shape (batch_size, vocab_size)";
+  int64_t batch_size = logits->shape[0];
+  int64_t vocab_size = logits->shape[1];
+  int64_t num_words = (vocab_size + 31) / 32;
+  ICHECK_EQ(bitmask.Shape()->Product(), batch_size * num_words)
+      << "The bitmask must have shape (batch_size, ceil(vocab_size / 32))";
+
+  float* logits_raw_data = static_cast<float*>(logits->data);
+  const uint32_t* bitmask_data = static_cast<const uint32_t*>(bitmask->data);
+  if (batch_size == 0) return;
+  parallel_for_with_threading_backend(
+      [&](int64_t i) {
+        float* row = logits_raw_data + i * vocab_size;
+        const uint32_t* mask = bitmask_data + i * num_words;
+        for (int64_t w = 0; w < num_words; ++w) {
+          // Most words of a grammar's mask are all zeros or all ones.
+          if (mask[w] == ~0u) continue;
+          int64_t end = std::min(vocab_size, (w + 1) * 32);
+          for (int64_t j = w * 32; j < end; ++j) {
+            if (!((mask[w] >> (j - w * 32)) & 1u)) {
+              row[j] = -std::numeric_limits<float>::infinity();
+            }
+          }
+        }
+      },
+      0, batch_size);
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.apply_token_bitmask_inplace")
+    .set_body_typed(ApplyTokenBitmaskInplace);
+
 // This is an inplace operation.
 void ApplySoftmaxWithTemperature(NDArray logits, double temperature) {
   ICHECK(logits.IsContiguous());
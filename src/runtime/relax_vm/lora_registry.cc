@@ -0,0 +1,230 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/lora_registry.cc
+ * \brief Runtime registry of the LoRA adapters served on one base model.
+ */
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The device-resident A and B matrices of the LoRA adapters of a model.
+ *
+ * For each adapted weight of shape (out_features, in_features), the registry holds a pool of the
+ * A matrices of shape (max_num_adapters, max_rank, in_features) and a pool of the B matrices of
+ * shape (max_num_adapters, out_features, max_rank), allocated once. Like the pages of the KV
+ * cache, an adapter occupies a slot of every pool from its registration to its removal, and
+ * slots are reused. Adapters of a smaller rank are padded with zeros, so that the pools can be
+ * passed as they are to `relax.nn.lora_bgmv` with the slot of the adapter of each token.
+ */
+class LoraRegistryObj : public Object {
+ public:
+  explicit LoraRegistryObj(int64_t max_num_adapters, int64_t max_rank,
+                           Array<ShapeTuple> weight_shapes, DLDataType dtype, Device device)
+      : max_num_adapters_(max_num_adapters), max_rank_(max_rank), dtype_(dtype), device_(device) {
+    for (const ShapeTuple& shape : weight_shapes) {
+      CHECK_EQ(shape.size(), 2) << "The shape of an adapted weight should be "
+                                << "(out_features, in_features), but got " << shape;
+      lora_a_.push_back(ZeroPool({max_num_adapters, max_rank, shape[1]}));
+      lora_b_.push_back(ZeroPool({max_num_adapters, shape[0], max_rank}));
+    }
+    for (int64_t slot = max_num_adapters - 1; slot >= 0; --slot) {
+      free_slots_.push_back(slot);
+    }
+  }
+
+  /*!
+   * \brief Register an adapter, copying its matrices to a free slot of the pools.
+   * \param name The name of the adapter.
+   * \param lora_a The A matrix of each adapted weight, of shape (rank, in_features).
+   * \param lora_b The B matrix of each adapted weight, of shape (out_features, rank), with the
+   * scaling of the adapter folded in.
+   * \return The slot of the adapter.
+   */
+  int64_t AddAdapter(String name, Array<NDArray> lora_a, Array<NDArray> lora_b) {
+    CHECK(slot_of_.find(name) == slot_of_.end())
+        << "The LoRA adapter \"" << name << "\" is already registered.";
+    CHECK_EQ(lora_a.size(), lora_a_.size())
+        << "The LoRA registry has " << lora_a_.size() << " adapted weights, but adapter \""
+        << name << "\" has " << lora_a.size() << " A matrices.";
+    CHECK_EQ(lora_b.size(), lora_b_.size())
+        << "The LoRA registry has " << lora_b_.size() << " adapted weights, but adapter \""
+        << name << "\" has " << lora_b.size() << " B matrices.";
+    CHECK(!free_slots_.empty()) << "The LoRA registry is full, with " << max_num_adapters_
+                                << " adapters. Remove an adapter before adding another one.";
+    int64_t slot = free_slots_.back();
+    for (size_t i = 0; i < lora_a_.size(); ++i) {
+      int64_t rank = lora_a[i]->shape[0];
+      CHECK(lora_a[i]->ndim == 2 && lora_b[i]->ndim == 2 &&
+            lora_a[i]->shape[1] == lora_a_[i]->shape[2] &&
+            lora_b[i]->shape[0] == lora_b_[i]->shape[1] && lora_b[i]->shape[1] == rank)
+          << "The A and B matrices of adapter \"" << name << "\" should be of shapes (rank, "
+          << lora_a_[i]->shape[2] << ") and (" << lora_b_[i]->shape[1] << ", rank), but got "
+          << lora_a[i].Shape() << " and " << lora_b[i].Shape();
+      CHECK_LE(rank, max_rank_) << "The rank " << rank << " of adapter \"" << name
+                                << "\" exceeds the maximum rank " << max_rank_;
+      CopyToSlot(lora_a_[i], slot, lora_a[i]);
+      CopyToSlot(lora_b_[i], slot, lora_b[i]);
+    }
+    free_slots_.pop_back();
+    slot_of_[name] = slot;
+    return slot;
+  }
+
+  /*! \brief Remove an adapter, freeing its slot. */
+  void RemoveAdapter(String name) {
+    free_slots_.push_back(GetSlot(name));
+    slot_of_.erase(name);
+  }
+
+  /*! \brief Get the slot of an adapter. */
+  int64_t GetSlot(String name) const {
+    auto it = slot_of_.find(name);
+    CHECK(it != slot_of_.end()) << "The LoRA adapter \"" << name << "\" is not registered.";
+    return it->second;
+  }
+
+  /*! \brief Get the pool of the A matrices of an adapted weight. */
+  NDArray GetLoraA(int64_t weight_id) const {
+    CHECK(weight_id >= 0 && weight_id < static_cast<int64_t>(lora_a_.size()))
+        << "The adapted weight " << weight_id << " is out of range.";
+    return lora_a_[weight_id];
+  }
+
+  /*! \brief Get the pool of the B matrices of an adapted weight. */
+  NDArray GetLoraB(int64_t weight_id) const {
+    CHECK(weight_id >= 0 && weight_id < static_cast<int64_t>(lora_b_.size()))
+        << "The adapted weight " << weight_id << " is out of range.";
+    return lora_b_[weight_id];
+  }
+
+  /*!
+   * \brief Get the slot of the adapter of each token of a batch of sequences.
+   * \param adapters The adapter of each sequence, or an empty string for the base model.
+   * \param append_lengths The number of tokens of each sequence in the batch.
+   * \return The int32 slots on the device of the registry, -1 for the tokens of the base model.
+   */
+  NDArray GetTokenSlots(Array<String> adapters, ShapeTuple append_lengths) const {
+    CHECK_EQ(adapters.size(), append_lengths.size())
+        << "The number of adapters and of sequence lengths should be the same.";
+    std::vector<int32_t> token_slots;
+    for (size_t i = 0; i < adapters.size(); ++i) {
+      int32_t slot = adapters[i].empty() ? -1 : GetSlot(adapters[i]);
+      token_slots.insert(token_slots.end(), append_lengths[i], slot);
+    }
+    NDArray result = NDArray::Empty({static_cast<int64_t>(token_slots.size())},
+                                    DLDataType{kDLInt, 32, 1}, device_);
+    result.CopyFromBytes(token_slots.data(), token_slots.size() * sizeof(int32_t));
+    return result;
+  }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.LoraRegistry";
+  TVM_DECLARE_FINAL_OBJECT_INFO(LoraRegistryObj, Object);
+
+ private:
+  NDArray ZeroPool(ShapeTuple shape) const {
+    NDArray pool = NDArray::Empty(shape, dtype_, device_);
+    std::vector<uint8_t> zeros(GetDataSize(*pool.operator->()), 0);
+    pool.CopyFromBytes(zeros.data(), zeros.size());
+    return pool;
+  }
+
+  /*!
+   * \brief Copy a matrix to the top-left corner of the slot of a pool, zero-filling the rest of
+   * the slot.
+   */
+  void CopyToSlot(NDArray pool, int64_t slot, NDArray matrix) const {
+    CHECK(matrix->dtype == dtype_) << "The LoRA registry holds matrices of dtype " << dtype_
+                                   << ", but got " << matrix->dtype;
+    ShapeTuple slot_shape{pool->shape[1], pool->shape[2]};
+    NDArray host = matrix.CopyTo(Device{kDLCPU, 0});
+    size_t elem_bytes = (dtype_.bits * dtype_.lanes + 7) / 8;
+    size_t src_row_bytes = matrix->shape[1] * elem_bytes;
+    size_t dst_row_bytes = slot_shape[1] * elem_bytes;
+    std::vector<uint8_t> padded(slot_shape[0] * dst_row_bytes, 0);
+    const uint8_t* src = static_cast<const uint8_t*>(host->data) + host->byte_offset;
+    for (int64_t row = 0; row < matrix->shape[0]; ++row) {
+      std::memcpy(padded.data() + row * dst_row_bytes, src + row * src_row_bytes, src_row_bytes);
+    }
+    pool.CreateView(slot_shape, dtype_, slot * padded.size())
+        .CopyFromBytes(padded.data(), padded.size());
+  }
+
+  int64_t max_num_adapters_;
+  int64_t max_rank_;
+  DLDataType dtype_;
+  Device device_;
+  std::vector<NDArray> lora_a_;
+  std::vector<NDArray> lora_b_;
+  std::vector<int64_t> free_slots_;
+  std::unordered_map<String, int64_t> slot_of_;
+};
+
+class LoraRegistry : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(LoraRegistry, ObjectRef, LoraRegistryObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(LoraRegistryObj);
+
+//-------------------------------------------------
+//  Register runtime functions
+//-------------------------------------------------
+
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_create")
+    .set_body_typed([](int64_t max_num_adapters,         //
+                       int64_t max_rank,                 //
+                       Array<ShapeTuple> weight_shapes,  //
+                       String dtype,                     //
+                       Device device) {
+      CHECK_GT(max_num_adapters, 0) << "The maximum number of adapters should be positive.";
+      CHECK_GT(max_rank, 0) << "The maximum rank should be positive.";
+      return LoraRegistry(make_object<LoraRegistryObj>(
+          max_num_adapters, max_rank, std::move(weight_shapes), String2DLDataType(dtype), device));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_add_adapter")
+    .set_body_method<LoraRegistry>(&LoraRegistryObj::AddAdapter);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_remove_adapter")
+    .set_body_method<LoraRegistry>(&LoraRegistryObj::RemoveAdapter);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_get_slot")
+    .set_body_method<LoraRegistry>(&LoraRegistryObj::GetSlot);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_get_lora_a")
+    .set_body_method<LoraRegistry>(&LoraRegistryObj::GetLoraA);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_get_lora_b")
+    .set_body_method<LoraRegistry>(&LoraRegistryObj::GetLoraB);
+TVM_REGISTER_GLOBAL("vm.builtin.lora_registry_get_token_slots")
+    .set_body_method<LoraRegistry>(&LoraRegistryObj::GetTokenSlots);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -39,11 +39,22 @@
 #define __STDC_FORMAT_MACROS
 #endif
 #include <picojson.h>
+#include <tvm/runtime/builtin_fp16.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/ndarray_cache_support.h>
 
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "../../support/utils.h"
@@ -165,24 +176,145 @@ void CopyNDArrayFromBytes(NDArray param, const void* data, size_t nbytes,
   TVMSynchronize(device.device_type, device.device_id, nullptr);
 }
 
-NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
-    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
-  NDArray arr = NDArray::Empty(shape, dtype, device);
-  if (dtype == DataType::Float(32) && format == "f32-to-bf16") {
-    // decode bf16 to f32
-    std::vector<uint16_t> buffer(nbytes / 2);
-    std::vector<uint32_t> decoded(nbytes / 2);
-    std::memcpy(buffer.data(), raw_data->data() + byte_offset, nbytes);
-    for (size_t i = 0; i < buffer.size(); ++i) {
-      decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
-    }
-    CopyNDArrayFromBytes(arr, decoded.data(), decoded.size() * sizeof(uint32_t), staging_buffer);
+/*!
+ * \brief A decoder of an encoded parameter format.
+ *
+ * A parameter recorded with the format is decoded only when its dtype matches
+ * `dtype`. Parameters of other dtypes are stored raw.
+ */
+struct ParamDecoder {
+  /*! \brief The dtype of the decoded parameters. */
+  DataType dtype;
+  /*!
+   * \brief Decode on the host, or nullptr if the format can only be decoded on device.
+   * Takes the encoded bytes and their size, the output and its number of elements.
+   */
+  void (*fhost)(const char* data, int64_t nbytes, void* out, int64_t numel) = nullptr;
+  /*!
+   * \brief The device kernels for each device type. A kernel takes the encoded bytes as
+   * 1-D uint8 NDArray and the flattened output NDArray, both on the device.
+   */
+  std::unordered_map<int, PackedFunc> fdevice;
+};
+
+void DecodeBF16ToF32(const char* data, int64_t nbytes, void* out, int64_t numel) {
+  CHECK_EQ(nbytes, numel * 2);
+  const uint16_t* src = reinterpret_cast<const uint16_t*>(data);
+  uint32_t* dst = static_cast<uint32_t*>(out);
+  for (int64_t i = 0; i < numel; ++i) {
+    dst[i] = static_cast<uint32_t>(src[i]) << 16;
+  }
+}
+
+void DecodeF16ToF32(const char* data, int64_t nbytes, void* out, int64_t numel) {
+  CHECK_EQ(nbytes, numel * 2);
+  const uint16_t* src = reinterpret_cast<const uint16_t*>(data);
+  float* dst = static_cast<float*>(out);
+  for (int64_t i = 0; i < numel; ++i) {
+    dst[i] = __gnu_h2f_ieee(src[i]);
+  }
+}
+
+void DecodeInt4ToInt8(const char* data, int64_t nbytes, void* out, int64_t numel) {
+  // Two signed values per byte, the lower nibble holds the element with the even index.
+  CHECK_EQ(nbytes, (numel + 1) / 2);
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  int8_t* dst = static_cast<int8_t*>(out);
+  for (int64_t i = 0; i < numel; ++i) {
+    uint8_t nibble = (src[i / 2] >> ((i % 2) * 4)) & 0xF;
+    dst[i] = static_cast<int8_t>(static_cast<uint8_t>(nibble << 4)) >> 4;
+  }
+}
+
+/*! \brief The registry of parameter decoders, keyed by format. */
+class ParamDecoderRegistry {
+ public:
+  static ParamDecoderRegistry* Global() {
+    static ParamDecoderRegistry* inst = new ParamDecoderRegistry();
+    return inst;
+  }
+
+  /*! \brief Get the decoder of a format, or return false if the format is not encoded. */
+  bool Get(const std::string& format, ParamDecoder* decoder) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = decoders_.find(format);
+    if (it == decoders_.end()) return false;
+    *decoder = it->second;
+    return true;
+  }
+
+  /*! \brief Register the device kernel of a format, creating the format if it is new. */
+  void RegisterDeviceKernel(const std::string& format, DataType dtype, int device_type,
+                            PackedFunc fdecode) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = decoders_.find(format);
+    if (it == decoders_.end()) {
+      it = decoders_.emplace(format, ParamDecoder{dtype}).first;
+    }
+    CHECK(it->second.dtype == dtype) << "ValueError: Format " << format << " decodes to "
+                                     << it->second.dtype << ", but got " << dtype;
+    it->second.fdevice[device_type] = fdecode;
+  }
+
+ private:
+  ParamDecoderRegistry() {
+    decoders_.emplace("f32-to-bf16", ParamDecoder{DataType::Float(32), DecodeBF16ToF32});
+    decoders_.emplace("f32-to-f16", ParamDecoder{DataType::Float(32), DecodeF16ToF32});
+    decoders_.emplace("int8-to-int4", ParamDecoder{DataType::Int(8), DecodeInt4ToInt8});
+  }
+
+  std::mutex mu_;
+  std::unordered_map<std::string, ParamDecoder> decoders_;
+};
+
+/*!
+ * \brief Load a parameter by copying it from the raw bytes of its shard.
+ *
+ * Encoded parameters are uploaded in their compact form and decoded by the device
+ * kernel of their format when one is registered for the device. Otherwise they are
+ * decoded on the host, directly into the parameter when it lives on CPU.
+ *
+ * \param rec The parameter record.
+ * \param device The device to load the parameter onto.
+ * \param shard_data The start of the shard data.
+ * \param staging_buffer The staging buffer for OpenCL, or nullptr.
+ */
+NDArray LoadParamFromBytes(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                           Device device, const char* shard_data,
+                           Optional<NDArray>* staging_buffer) {
+  NDArray arr = NDArray::Empty(rec.shape, rec.dtype, device);
+  const char* data = shard_data + rec.byte_offset;
+  ParamDecoder decoder;
+  if (rec.format == "raw" || !ParamDecoderRegistry::Global()->Get(rec.format, &decoder) ||
+      decoder.dtype != rec.dtype) {
+    CopyNDArrayFromBytes(arr, data, rec.nbytes, staging_buffer);
+    return arr;
+  }
+  int64_t numel = rec.shape->Product();
+  auto it_kernel = decoder.fdevice.find(device.device_type);
+  if (it_kernel != decoder.fdevice.end()) {
+    NDArray encoded = NDArray::Empty({rec.nbytes}, DataType::UInt(8), device);
+    CopyNDArrayFromBytes(encoded, data, rec.nbytes, staging_buffer);
+    it_kernel->second(encoded, arr.CreateView({numel}, rec.dtype));
+    return arr;
+  }
+  CHECK(decoder.fhost != nullptr) << "ValueError: No decoder of format " << rec.format
+                                  << " is registered for device " << device;
+  if (device.device_type == kDLCPU) {
+    decoder.fhost(data, rec.nbytes, arr->data, numel);
   } else {
-    CopyNDArrayFromBytes(arr, raw_data->data() + byte_offset, nbytes, staging_buffer);
+    std::vector<char> decoded(numel * rec.dtype.bytes());
+    decoder.fhost(data, rec.nbytes, decoded.data(), numel);
+    CopyNDArrayFromBytes(arr, decoded.data(), decoded.size(), staging_buffer);
   }
   return arr;
 }
 
+NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
+    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
+  return LoadParamFromBytes(*this, device, raw_data->data(), staging_buffer);
+}
+
 TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::Load(
     Device device,
     const std::string& path_prefix,  //
@@ -201,6 +333,207 @@ TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::Load(
   return result;
 }
 
+TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::LoadMapped(
+    Device device,
+    const std::string& path_prefix,  //
+    Optional<NDArray>* staging_buffer) const {
+  CHECK_EQ(this->format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
+  auto file = std::make_shared<MappedFile>(path_prefix + "/" + this->data_path);
+  CHECK_EQ(this->nbytes, file->size())
+      << "ValueError: Encountered an corrupted parameter shard. It means it is not downloaded "
+         "completely or downloading is interrupted. Please try to download again.";
+  Array<NDArray> result;
+  result.reserve(this->records.size());
+  for (const ParamRecord& nd_rec : this->records) {
+    char* data = file->data() + nd_rec.byte_offset;
+    bool can_view = device.device_type == kDLCPU && nd_rec.format == "raw" &&
+                    reinterpret_cast<uintptr_t>(data) % kAllocAlignment == 0;
+    if (!can_view) {
+      result.push_back(LoadParamFromBytes(nd_rec, device, file->data(), staging_buffer));
+      continue;
+    }
+    result.push_back(NDArrayViewOfMappedFile(file, nd_rec.byte_offset, nd_rec.shape,
+                                             nd_rec.dtype, device));
+  }
+  return result;
+}
+
+/*!
+ * \brief Load the shards of an NDArray cache in a pipeline.
+ *
+ * Reader threads read the shards from disk into a fixed number of staging
+ * buffers, in shard order. The staging buffers are in pinned host memory on
+ * CUDA and ROCm. Meanwhile the calling thread creates the parameters of each
+ * read shard and copies them to the device asynchronously on a dedicated
+ * stream, and returns the staging buffer to the readers once the copies are done.
+ */
+class PipelinedShardLoader {
+ public:
+  using FileRecord = NDArrayCacheMetadata::FileRecord;
+
+  /*!
+   * \brief Create the loader.
+   * \param metadata The metadata of the NDArray cache.
+   * \param cache_path The path of the NDArray cache.
+   * \param device The device to load the parameters onto.
+   * \param num_staging_buffers The number of staging buffers, which is also the
+   * number of reader threads.
+   */
+  PipelinedShardLoader(const NDArrayCacheMetadata& metadata, std::string cache_path,
+                       Device device, int num_staging_buffers)
+      : metadata_(metadata), cache_path_(std::move(cache_path)), device_(device) {
+    ICHECK_GT(num_staging_buffers, 0);
+    int64_t max_nbytes = 0;
+    for (const FileRecord& shard_rec : metadata_.records) {
+      CHECK_EQ(shard_rec.format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
+      max_nbytes = std::max(max_nbytes, shard_rec.nbytes);
+    }
+    Device host_device = GetPreferredHostDevice(device);
+    for (int i = 0; i < num_staging_buffers; ++i) {
+      staging_buffers_.push_back(NDArray::Empty({max_nbytes}, DataType::UInt(8), host_device));
+      free_buffers_.push_back(i);
+    }
+    if (device.device_type == kDLCUDA || device.device_type == kDLROCM ||
+        device.device_type == kDLVulkan) {
+      copy_stream_ = DeviceAPI::Get(device)->CreateStream(device);
+    }
+  }
+
+  ~PipelinedShardLoader() {
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->FreeStream(device_, copy_stream_);
+    }
+  }
+
+  /*!
+   * \brief Load all the shards.
+   * \param fdone The callback invoked with each loaded shard and its parameters, in order.
+   */
+  void Run(const std::function<void(const FileRecord&, Array<NDArray>)>& fdone) {
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < staging_buffers_.size(); ++i) {
+      readers.emplace_back([this]() { ReaderLoop(); });
+    }
+    try {
+      int num_shards = metadata_.records.size();
+      for (int shard = 0; shard < num_shards; ++shard) {
+        int buffer;
+        {
+          std::unique_lock<std::mutex> lock(mu_);
+          cv_.wait(lock, [&]() { return ready_.count(shard) || error_ != nullptr; });
+          if (error_ != nullptr) std::rethrow_exception(error_);
+          buffer = ready_.at(shard);
+          ready_.erase(shard);
+        }
+        const FileRecord& shard_rec = metadata_.records[shard];
+        Array<NDArray> params = LoadFromStaging(shard_rec, staging_buffers_[buffer]);
+        {
+          std::lock_guard<std::mutex> lock(mu_);
+          free_buffers_.push_back(buffer);
+        }
+        cv_.notify_all();
+        fdone(shard_rec, std::move(params));
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (error_ == nullptr) error_ = std::current_exception();
+      }
+      cv_.notify_all();
+      for (std::thread& reader : readers) reader.join();
+      throw;
+    }
+    for (std::thread& reader : readers) reader.join();
+  }
+
+ private:
+  /*! \brief Read the next shards into the free staging buffers, in shard order. */
+  void ReaderLoop() {
+    int num_shards = metadata_.records.size();
+    while (true) {
+      int shard, buffer;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [&]() {
+          return !free_buffers_.empty() || next_shard_ == num_shards || error_ != nullptr;
+        });
+        if (next_shard_ == num_shards || error_ != nullptr) return;
+        shard = next_shard_++;
+        buffer = free_buffers_.back();
+        free_buffers_.pop_back();
+      }
+      try {
+        const FileRecord& shard_rec = metadata_.records[shard];
+        std::string path = cache_path_ + "/" + shard_rec.data_path;
+        std::ifstream fs(path, std::ios::in | std::ios::binary);
+        CHECK(!fs.fail()) << "Cannot open " << path;
+        fs.read(static_cast<char*>(staging_buffers_[buffer]->data), shard_rec.nbytes);
+        CHECK(fs.gcount() == shard_rec.nbytes && fs.peek() == EOF)
+            << "ValueError: Encountered an corrupted parameter shard " << shard_rec.data_path
+            << ". It means it is not downloaded completely or downloading is interrupted. "
+               "Please try to download again.";
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (error_ == nullptr) error_ = std::current_exception();
+        cv_.notify_all();
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        ready_[shard] = buffer;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  /*! \brief Create the parameters of a shard from its staging buffer. */
+  Array<NDArray> LoadFromStaging(const FileRecord& shard_rec, const NDArray& staging) {
+    const char* shard_data = static_cast<const char*>(staging->data);
+    Array<NDArray> result;
+    result.reserve(shard_rec.records.size());
+    for (const FileRecord::ParamRecord& nd_rec : shard_rec.records) {
+      if (copy_stream_ == nullptr || nd_rec.format != "raw") {
+        result.push_back(LoadParamFromBytes(nd_rec, device_, shard_data, &opencl_staging_));
+        continue;
+      }
+      NDArray arr = NDArray::Empty(nd_rec.shape, nd_rec.dtype, device_);
+      int64_t nbytes = nd_rec.nbytes;
+      DLTensor from = *staging.operator->();
+      from.shape = &nbytes;
+      from.byte_offset = nd_rec.byte_offset;
+      DLTensor to = *arr.operator->();
+      to.ndim = 1;
+      to.shape = &nbytes;
+      to.dtype = DataType::UInt(8);
+      NDArray::CopyFromTo(&from, &to, copy_stream_);
+      result.push_back(arr);
+    }
+    if (copy_stream_ != nullptr) {
+      // The staging buffer can be reused once the copies are done.
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+    }
+    return result;
+  }
+
+  const NDArrayCacheMetadata& metadata_;
+  std::string cache_path_;
+  Device device_;
+  TVMStreamHandle copy_stream_ = nullptr;
+  std::vector<NDArray> staging_buffers_;
+  Optional<NDArray> opencl_staging_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  /*! \brief The next shard to be read. */
+  int next_shard_ = 0;
+  /*! \brief The staging buffers that readers can fill. */
+  std::vector<int> free_buffers_;
+  /*! \brief The shards that are read, mapped to their staging buffers. */
+  std::unordered_map<int, int> ready_;
+  /*! \brief The first error raised while loading. */
+  std::exception_ptr error_ = nullptr;
+};
+
 /*!
  * A NDArray cache to store pre-loaded arrays in the system.
  */
@@ -241,16 +574,39 @@ class NDArrayCache {
    * \param cache_path The cache to path.
    * \param device_type The type of device to be loaded.
    * \param device_id The device id.
+   * \param use_mmap Whether to memory-map the shards instead of reading them.
+   * \param num_staging_buffers When positive and not using mmap, load the shards
+   * in a pipeline with this many staging buffers and reader threads.
    */
-  static void Load(const std::string& cache_path, int device_type, int device_id) {
+  static void Load(const std::string& cache_path, int device_type, int device_id,
+                   bool use_mmap = false, int num_staging_buffers = 0) {
     DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
     NDArrayCacheMetadata metadata = NDArrayCacheMetadata::Load(cache_path);
+    if (!use_mmap && num_staging_buffers > 0 && !metadata.records.empty()) {
+      PipelinedShardLoader loader(metadata, cache_path, device, num_staging_buffers);
+      try {
+        loader.Run([](const NDArrayCacheMetadata::FileRecord& shard_rec, Array<NDArray> params) {
+          int num_params = params.size();
+          for (int i = 0; i < num_params; ++i) {
+            Update(shard_rec.records[i].name, params[i], true);
+          }
+        });
+      } catch (const dmlc::Error& e) {
+        LOG(FATAL) << "ValueError: Error when loading parameters from " << cache_path << ": "
+                   << e.what();
+      }
+      return;
+    }
     Optional<NDArray> staging_buffer;
     std::string raw_data;
     Array<NDArray> params;
     for (const NDArrayCacheMetadata::FileRecord& shard_rec : metadata.records) {
       try {
-        params = shard_rec.Load(device, cache_path, &raw_data, &staging_buffer);
+        if (use_mmap) {
+          params = shard_rec.LoadMapped(device, cache_path, &staging_buffer);
+        } else {
+          params = shard_rec.Load(device, cache_path, &raw_data, &staging_buffer);
+        }
       } catch (const dmlc::Error& e) {
         LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
                    << ": " << e.what();
@@ -291,7 +647,19 @@ TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.update").set_body([](TVMArgs args,
 });
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.remove").set_body_typed(NDArrayCache::Remove);
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.clear").set_body_typed(NDArrayCache::Clear);
-TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load").set_body_typed(NDArrayCache::Load);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.register_decoder")
+    .set_body_typed([](String format, DataType dtype, int device_type, PackedFunc fdecode) {
+      ParamDecoderRegistry::Global()->RegisterDeviceKernel(format, dtype, device_type, fdecode);
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK(args.size() >= 3 && args.size() <= 5);
+  std::string cache_path = args[0];
+  int device_type = args[1];
+  int device_id = args[2];
+  bool use_mmap = args.size() <= 3 ? false : args[3];
+  int num_staging_buffers = args.size() <= 4 ? 0 : args[4];
+  NDArrayCache::Load(cache_path, device_type, device_id, use_mmap, num_staging_buffers);
+});
 
 // This param module node can be useful to get param dict in RPC mode
 // when the remote already have loaded parameters from file.
@@ -352,12 +720,180 @@ class ParamModuleNode : public runtime::ModuleNode {
   Array<NDArray> params_;
 };
 
+/*!
+ * \brief The parameters offloaded to host memory, which are uploaded to a device on demand.
+ *
+ * It serves models whose parameters do not fit in the device memory. The parameters stay in
+ * host memory, and `get_param` uploads them by index into a ring buffer on the device, so it is
+ * the `fget_param` callback of a function transformed by LazyGetInput. Each request also
+ * prefetches the following parameters, up to half of the ring buffer, which overlaps the upload
+ * of the next layer with the kernels of the current one. On CUDA the uploads run on a copy
+ * stream, which the kernels wait for only after the prefetches they need were issued.
+ *
+ * An upload overwrites the parameters least recently uploaded, so the parameters which one
+ * kernel uses together should fit in half of the ring buffer, and the returned arrays should
+ * not be kept after the next requests.
+ */
+class OffloadedParamModuleNode : public runtime::ModuleNode {
+ public:
+  /*!
+   * \brief Create the module.
+   * \param host_params The parameters in host memory.
+   * \param device The device to upload the parameters to.
+   * \param ring_bytes The size of the ring buffer on the device.
+   */
+  OffloadedParamModuleNode(Array<NDArray> host_params, Device device, int64_t ring_bytes)
+      : host_params_(std::move(host_params)), device_(device), ring_bytes_(ring_bytes) {
+    for (const NDArray& param : host_params_) {
+      int64_t nbytes = GetDataSize(*param.operator->());
+      CHECK_LE(nbytes * 2, ring_bytes_)
+          << "ValueError: The ring buffer of " << ring_bytes_ << " bytes should hold twice the "
+          << "largest parameter, but got a parameter of " << nbytes << " bytes";
+      nbytes_.push_back(nbytes);
+    }
+    offsets_.assign(host_params_.size(), -1);
+    views_.resize(host_params_.size());
+    ring_ = NDArray::Empty({ring_bytes_}, DataType::UInt(8), device_);
+    if (device_.device_type == kDLCUDA) {
+      copy_stream_ = DeviceAPI::Get(device_)->CreateStream(device_);
+    }
+  }
+
+  ~OffloadedParamModuleNode() {
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->FreeStream(device_, copy_stream_);
+    }
+  }
+
+  const char* type_key() const final { return "offloaded_param_module"; }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "get_param") {
+      // The second argument is the name of the parameter in the function, which is unused.
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        CHECK(args.size() == 1 || args.size() == 2);
+        *rv = this->GetParam(args[0]);
+      });
+    } else if (name == "num_uploads") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = num_uploads_; });
+    } else {
+      return PackedFunc();
+    }
+  }
+
+  /*! \brief Get a parameter on the device, and prefetch the parameters after it. */
+  NDArray GetParam(int64_t index) {
+    int64_t num_params = host_params_.size();
+    CHECK(index >= 0 && index < num_params)
+        << "IndexError: Parameter index " << index << " is out of range [0, " << num_params << ")";
+    copy_waits_compute_ = false;
+    if (offsets_[index] < 0) {
+      Upload(index);
+    }
+    DeviceAPI* api = DeviceAPI::Get(device_);
+    if (copy_stream_ != nullptr && unsynced_uploads_) {
+      // The kernels using the parameter wait for its upload, before the prefetches are issued.
+      api->SyncStreamFromTo(device_, copy_stream_, api->GetCurrentStream(device_));
+      unsynced_uploads_ = false;
+    }
+    NDArray result = views_[index];
+    int64_t prefetch_bytes = 0;
+    for (int64_t i = index + 1; i < num_params; ++i) {
+      prefetch_bytes += nbytes_[i];
+      if (prefetch_bytes * 2 > ring_bytes_) break;
+      if (offsets_[i] < 0) {
+        Upload(i);
+      }
+    }
+    return result;
+  }
+
+  static Module CreateByName(const Array<String>& names, Device device, int64_t ring_bytes,
+                             bool pin_memory) {
+    Array<NDArray> params = ParamModuleNode::GetParamByName(names);
+    if (pin_memory) {
+      Device host_device = GetPreferredHostDevice(device);
+      for (int i = 0, n = params.size(); i < n; ++i) {
+        NDArray pinned = NDArray::Empty(params[i].Shape(), params[i]->dtype, host_device);
+        pinned.CopyFrom(params[i]);
+        params.Set(i, pinned);
+      }
+    }
+    return Module(make_object<OffloadedParamModuleNode>(params, device, ring_bytes));
+  }
+
+ private:
+  /*! \brief Upload a parameter to the next free region of the ring buffer. */
+  void Upload(int64_t index) {
+    int64_t nbytes = nbytes_[index];
+    int64_t start = (cursor_ + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+    if (start + nbytes > ring_bytes_) {
+      start = 0;
+    }
+    // Evict the parameters whose regions the upload overwrites.
+    for (auto it = resident_.begin(); it != resident_.end();) {
+      int64_t offset = offsets_[*it];
+      if (offset < start + nbytes && start < offset + nbytes_[*it]) {
+        offsets_[*it] = -1;
+        views_[*it] = NDArray();
+        it = resident_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    DeviceAPI* api = DeviceAPI::Get(device_);
+    if (copy_stream_ != nullptr && !copy_waits_compute_) {
+      // The upload waits for the kernels issued so far, which may use the evicted parameters.
+      api->SyncStreamFromTo(device_, api->GetCurrentStream(device_), copy_stream_);
+      copy_waits_compute_ = true;
+    }
+    const NDArray& host = host_params_[index];
+    NDArray view = ring_.CreateView(host.Shape(), host->dtype, start);
+    NDArray::CopyFromTo(host.operator->(), const_cast<DLTensor*>(view.operator->()),
+                        copy_stream_);
+    offsets_[index] = start;
+    views_[index] = view;
+    resident_.push_back(index);
+    cursor_ = start + nbytes;
+    unsynced_uploads_ = unsynced_uploads_ || copy_stream_ != nullptr;
+    ++num_uploads_;
+  }
+
+  /*! \brief The parameters in host memory. */
+  Array<NDArray> host_params_;
+  /*! \brief The size of each parameter in bytes. */
+  std::vector<int64_t> nbytes_;
+  Device device_;
+  /*! \brief The ring buffer on the device. */
+  NDArray ring_;
+  int64_t ring_bytes_;
+  /*! \brief The end of the last upload in the ring buffer. */
+  int64_t cursor_ = 0;
+  /*! \brief The offset of each parameter in the ring buffer, or -1 if it is not uploaded. */
+  std::vector<int64_t> offsets_;
+  /*! \brief The view of each uploaded parameter in the ring buffer. */
+  std::vector<NDArray> views_;
+  /*! \brief The uploaded parameters, in the order of their uploads. */
+  std::list<int64_t> resident_;
+  /*! \brief The stream of the uploads on CUDA, or nullptr to upload on the default stream. */
+  TVMStreamHandle copy_stream_ = nullptr;
+  /*! \brief Whether the copy stream waits for the kernels issued before the current request. */
+  bool copy_waits_compute_ = false;
+  /*! \brief Whether some uploads are not waited for by the kernels. */
+  bool unsynced_uploads_ = false;
+  /*! \brief The number of uploads so far. */
+  int64_t num_uploads_ = 0;
+};
+
 TVM_REGISTER_GLOBAL("vm.builtin.param_module_from_cache").set_body_typed(ParamModuleNode::Create);
 TVM_REGISTER_GLOBAL("vm.builtin.param_module_from_cache_by_name")
     .set_body_typed(ParamModuleNode::CreateByName);
 TVM_REGISTER_GLOBAL("vm.builtin.param_array_from_cache").set_body_typed(ParamModuleNode::GetParams);
 TVM_REGISTER_GLOBAL("vm.builtin.param_array_from_cache_by_name")
     .set_body_typed(ParamModuleNode::GetParamByName);
+TVM_REGISTER_GLOBAL("vm.builtin.offloaded_param_module_from_cache_by_name")
+    .set_body_typed(OffloadedParamModuleNode::CreateByName);
 TVM_REGISTER_GLOBAL("vm.builtin.param_array_from_cache_by_name_unpacked")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
       Array<String> names;
@@ -24,10 +24,18 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/nvtx.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -56,10 +64,22 @@ namespace relax_vm {
 constexpr const int kPagedKVCacheMaxBlockDepth = 5;
 /*! \brief The maximum tree size of a single sequence in tree attention. */
 constexpr const int kTreeAttnMaxTreeSize = 256;
+/*! \brief The maximum number of token tree shapes whose topology is kept for reuse. */
+constexpr const int kMaxNumCachedTokenTreeTopologies = 64;
 /*! \brief The 8MB workspace size for attention auxiliary data. */
 constexpr const int kAttnWorkspaceByte = 8 * 1024 * 1024;
 /*! \brief The id of the temporary logical page, which is useful for sliding window. */
 constexpr const int kPagedKVCacheTempPageId = -1;
+/*!
+ * \brief The number of bytes appended to each (token, head) row of K/V data
+ * in quantized pages, which hold the float32 dequantization scale of the row.
+ */
+constexpr const int kQuantizedPageScaleBytes = 4;
+/*!
+ * \brief The first id of the internal sequences that hold the K/V data of
+ * cached prefixes. These ids are far from any sequence id in use.
+ */
+constexpr const int64_t kPrefixCacheSeqIdBase = std::numeric_limits<int64_t>::min() / 2;
 
 /*!
  * \brief The block structure in paged KV cache with common prefix support.
@@ -123,6 +143,61 @@ struct Block {
   }
 };
 
+/*!
+ * \brief The topology of a token tree, which only depends on the parent pointers of its nodes.
+ * Speculative decoding verifies trees of the same few shapes at every step, so the topology is
+ * built once per shape and shared by the later trees of the shape.
+ */
+struct TokenTreeTopology {
+  /*! \brief Whether the tree is a chain. */
+  bool is_chain = true;
+  /*! \brief The attention mask, where row n marks the ancestors of node n and itself. */
+  std::vector<int32_t> mask;
+  /*! \brief The depth of each node. */
+  std::vector<int32_t> depths;
+  /*!
+   * \brief The (src, dst) positions, in the appended tokens, of the KV data copies that compact
+   * the path from the root to each node when the node is the accepted leaf.
+   */
+  std::vector<std::vector<std::pair<int32_t, int32_t>>> commit_copies;
+
+  explicit TokenTreeTopology(const std::vector<int32_t>& parent_ptr) {
+    int64_t tree_size = parent_ptr.size();
+    mask.resize(tree_size * tree_size, 0);
+    depths.reserve(tree_size);
+    commit_copies.resize(tree_size);
+    for (int64_t n = 0; n < tree_size; ++n) {
+      int32_t parent = parent_ptr[n];
+      if (parent != n - 1) {
+        is_chain = false;
+      }
+      if (parent != -1) {
+        std::copy_n(mask.begin() + parent * tree_size, tree_size, mask.begin() + n * tree_size);
+        depths.push_back(depths[parent] + 1);
+      } else {
+        depths.push_back(0);
+      }
+      mask[n * tree_size + n] = 1;
+
+      // The path from the root on the tree is copied to the first positions. The leading nodes
+      // that are already in place need no copy.
+      std::vector<int32_t> path_on_tree;
+      path_on_tree.reserve(depths[n] + 1);
+      for (int32_t node = n; node != -1; node = parent_ptr[node]) {
+        path_on_tree.push_back(node);
+      }
+      std::reverse(path_on_tree.begin(), path_on_tree.end());
+      int32_t dst = 0;
+      while (dst < static_cast<int32_t>(path_on_tree.size()) && path_on_tree[dst] == dst) {
+        ++dst;
+      }
+      for (; dst < static_cast<int32_t>(path_on_tree.size()); ++dst) {
+        commit_copies[n].emplace_back(path_on_tree[dst], dst);
+      }
+    }
+  }
+};
+
 /*!
  * \brief The sequence structure in paged KV cache with common prefix support.
  * Each sequence contains one or more blocks to support common prefix.
@@ -157,6 +232,8 @@ struct Sequence {
   std::vector<int32_t> token_tree_parent_ptr;
   /*! \brief The depth of each node in the token tree. */
   std::vector<int32_t> token_tree_node_depths;
+  /*! \brief The topology of the token tree of the current appended tokens. */
+  std::shared_ptr<const TokenTreeTopology> token_tree_topology;
   /*!
    * \brief A boolean denoting whether the accepted token tree indices of
    * this sequence are committed
@@ -194,6 +271,41 @@ struct Sequence {
   }
 };
 
+/*!
+ * \brief The node of the radix tree over token ids used by the prefix cache.
+ * The tokens on the path from the root to a node form a prefix. Each leaf owns
+ * an internal sequence of the KV cache, which holds the K/V data of the whole
+ * path, and shares its pages by reference counting with the sequences forked
+ * from it.
+ */
+struct PrefixTreeNode {
+  /*! \brief The tokens on the edge from the parent to this node. */
+  std::vector<int32_t> tokens;
+  /*! \brief The total number of tokens from the root to the end of this node. */
+  int64_t length = 0;
+  /*! \brief The parent node, or nullptr for the root. */
+  PrefixTreeNode* parent = nullptr;
+  /*! \brief The children, keyed by the first token on their edge. */
+  std::unordered_map<int32_t, std::unique_ptr<PrefixTreeNode>> children;
+  /*! \brief Whether the node owns an internal sequence. Only leaves own one. */
+  bool has_seq = false;
+  /*! \brief The id of the owned internal sequence. */
+  int64_t seq_id = 0;
+  /*! \brief The logical time of the last match or insertion, for LRU eviction. */
+  uint64_t last_access = 0;
+};
+
+/*! \brief The K/V data of a sequence that is swapped out to host memory. */
+struct SwappedSequence {
+  /*!
+   * \brief The K/V data in host memory, with layout
+   * (num_layers, num_pages, 2, num_heads, page_size, head_dim).
+   */
+  NDArray host_data;
+  /*! \brief The length of the sequence. */
+  int32_t seq_length;
+};
+
 /*!
  * \brief The rotary embedding mode adopted by the paged KV cache
  * when computing attention.
@@ -231,6 +343,12 @@ class HostMemoryVector {
     static_cast<int32_t*>(data_->data)[current_size_++] = value;
   }
 
+  void append(const std::vector<int32_t>& values) {
+    ICHECK_LE(current_size_ + static_cast<int64_t>(values.size()), reserved_size_);
+    std::copy(values.begin(), values.end(), static_cast<int32_t*>(data_->data) + current_size_);
+    current_size_ += values.size();
+  }
+
   const int32_t& operator[](int64_t idx) const {
     ICHECK_GE(idx, 0) << "Index " << idx << " is negative.";
     ICHECK_LT(idx, current_size_) << "Index " << idx << " out of bounds " << current_size_;
@@ -831,8 +949,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   const int64_t num_kv_heads_;
   /*! \brief The number of features each head has. */
   const int64_t head_dim_;
-  /*! \brief The number of total pages allocated in KV cache. */
-  const int64_t num_total_pages_;
+  /*! \brief The number of sequences the auxiliary arrays are reserved for. */
+  const int64_t reserved_num_seqs_;
+  /*! \brief The number of total pages allocated in KV cache, which changes on resizes. */
+  int64_t num_total_pages_;
   /*! \brief The maximum total sequence length in a prefill. */
   const int64_t prefill_chunk_size_;
   /*! \brief A boolean flag indicating if the KV cache supports sliding window. */
@@ -845,6 +965,17 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The RoPE theta. */
   const double rotary_theta_;
 
+  /*! \brief The dtype of the K/V data the model computes with. */
+  const DLDataType kv_dtype_;
+  /*!
+   * \brief Whether the pages store quantized K/V data.
+   * A quantized page stores K/V in an 8-bit dtype (int8 or e4m3_float), and each
+   * row of `head_dim` values is followed by its float32 scale, taking
+   * `kQuantizedPageScaleBytes` more elements. The append kernel quantizes and
+   * the attention and debug kernels dequantize on the fly.
+   */
+  const bool quantized_pages_;
+
   /*! \brief We fix int32 to be the index dtype of auxiliary data. */
   const DLDataType dtype_aux_ = DLDataType(DataType::Int(32, 1));
 
@@ -853,7 +984,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*!
    * \brief The KV data managed by the KV cache.
    * The array has `num_layers` NDArrays, each of them
-   * has layout (num_pages, 2, num_heads, page_size, head_dim).
+   * has layout (num_pages, 2, num_heads, page_size, head_dim), where the last
+   * dimension grows by `kQuantizedPageScaleBytes` for quantized pages.
    * Along on the "2" dimension, index 0 stands for K and 1 stands for V.
    */
   Array<NDArray> pages_;
@@ -869,6 +1001,22 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The list of free available blocks (in their indices). */
   std::vector<int32_t> free_block_idx_;
 
+  /*! \brief The sequences swapped out to host memory. */
+  std::unordered_map<int64_t, SwappedSequence> swapped_seq_map_;
+  /*! \brief The host buffers of swapped in sequences whose copy may still be in flight. */
+  std::vector<NDArray> pending_swap_in_buffers_;
+
+  /********************* Prefix Cache Structures *********************/
+
+  /*! \brief The root of the radix tree of cached prefixes. */
+  std::unique_ptr<PrefixTreeNode> prefix_tree_root_ = std::make_unique<PrefixTreeNode>();
+  /*! \brief The id of the next internal sequence created for the prefix cache. */
+  int64_t prefix_cache_next_seq_id_ = kPrefixCacheSeqIdBase;
+  /*! \brief The logical clock for the LRU order of cached prefixes. */
+  uint64_t prefix_cache_clock_ = 0;
+  /*! \brief The internal sequence that must not be evicted, while it is being forked. */
+  const PrefixTreeNode* prefix_cache_pinned_ = nullptr;
+
   /*********** Current Batch Info & Auxiliary Arrays on Device ***********/
   //-------------------------------------------
   // The following fields are auxiliary arrays on device.
@@ -895,8 +1043,27 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   bool append_before_attn_;
   /*! \brief Whether to use decode kernel for each depth. (see GetChunkedBlockIds) */
   std::vector<bool> use_decode_kernel_;
+  /*!
+   * \brief The number of leading decode sequences of a mixed batch of decodes and prefills whose
+   * attention on each depth uses the decode kernel, while the rest of the batch uses the prefill
+   * kernel. It is 0 on the depths which use a single kernel.
+   */
+  std::vector<int64_t> num_decode_seqs_on_depths_;
   /*! \brief Whether the attention request is a decode request, set in BeginForwardFunction. */
   bool is_decode_request_;
+  /*!
+   * \brief Whether the next decode of the same batch can patch the auxiliary arrays of the last
+   * forward, which was a decode of sequences of one block each. See BeginDecodeIncrementally.
+   */
+  bool decode_plan_valid_ = false;
+  /*! \brief The ids of the sequences in the last decode. */
+  IntTuple decode_plan_seq_ids_;
+  /*! \brief The block of each sequence in the last decode. */
+  std::vector<int32_t> decode_plan_block_ids_;
+  /*! \brief The length of the block of each sequence after the last decode. */
+  std::vector<int32_t> decode_plan_block_lengths_;
+  /*! \brief The number of pages of the block of each sequence after the last decode. */
+  std::vector<int32_t> decode_plan_num_pages_;
   /*! \brief The auxiliary data manager for attention. */
   std::unique_ptr<PagedKVCacheAuxDataManager> aux_data_manager_;
 
@@ -952,6 +1119,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   std::vector<NDArray> length_info_on_depths_view_;
   std::vector<NDArray> k_rope_pos_offset_view_;
 
+  /*! \brief The topologies of the recent token tree shapes, keyed by the parent pointers. */
+  std::map<std::vector<int32_t>, std::shared_ptr<const TokenTreeTopology>> token_tree_topologies_;
+
   PackedFunc f_transpose_append_;
   PackedFunc f_compact_copy_;
   PackedFunc f_attention_prefill_;
@@ -971,6 +1141,19 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   PackedFunc f_copy_single_page_;
   Optional<PackedFunc> f_debug_get_kv_;
 
+  /*!
+   * \brief The decode kernels to select from by measurement, when more than one: the decode
+   * kernel given at construction and its candidates, e.g. of different split-KV factors.
+   * f_attention_decode_ then dispatches to the kernel chosen for the shape of the batch.
+   */
+  std::vector<PackedFunc> decode_kernels_;
+  /*! \brief The key of the kernel configuration of the cache in the decode kernel choices. */
+  std::string decode_kernel_key_prefix_;
+  /*! \brief The key of the current batch in the decode kernel choices. */
+  std::string decode_kernel_key_;
+  /*! \brief The decode kernel chosen for the current batch, or -1 if not looked up yet. */
+  int decode_kernel_choice_ = -1;
+
   /*! \brief The device this PagedKVCache runs on. */
   Device device_;
   /*! \brief The device stream for the default computation operations. */
@@ -985,8 +1168,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       int64_t num_layers, int64_t num_qo_heads, int64_t num_kv_heads, int64_t head_dim,
       int64_t reserved_num_seqs, int64_t num_total_pages, int64_t prefill_chunk_size,
       bool support_sliding_window, RoPEMode rope_mode, double rotary_scale, double rotary_theta,
-      DLDataType dtype, Device device, PackedFunc f_transpose_append, PackedFunc f_compact_copy,
-      PackedFunc f_attention_prefill, PackedFunc f_attention_decode,
+      DLDataType dtype, DLDataType page_dtype, Device device, PackedFunc f_transpose_append,
+      PackedFunc f_compact_copy, PackedFunc f_attention_prefill, PackedFunc f_attention_decode,
       PackedFunc f_attention_prefill_sliding_window, PackedFunc f_attention_decode_sliding_window,
       PackedFunc f_attention_prefill_ragged, PackedFunc f_attention_prefill_with_tree_mask,
       Optional<PackedFunc> f_attention_prefill_ragged_begin_forward,
@@ -995,12 +1178,14 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       Optional<PackedFunc> f_attention_prefill_end_forward,
       Optional<PackedFunc> f_attention_decode_begin_forward,
       Optional<PackedFunc> f_attention_decode_end_forward, PackedFunc f_merge_inplace,
-      PackedFunc f_split_rotary, PackedFunc f_copy_single_page, Optional<PackedFunc> f_debug_get_kv)
+      PackedFunc f_split_rotary, PackedFunc f_copy_single_page, Optional<PackedFunc> f_debug_get_kv,
+      Array<PackedFunc> f_attention_decode_candidates = {})
       : page_size_(page_size),
         num_layers_(num_layers),
         num_qo_heads_(num_qo_heads),
         num_kv_heads_(num_kv_heads),
         head_dim_(head_dim),
+        reserved_num_seqs_(reserved_num_seqs),
         num_total_pages_(num_total_pages),
         prefill_chunk_size_(prefill_chunk_size),
         support_sliding_window_(support_sliding_window),
@@ -1008,6 +1193,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
                                                                           : rope_mode),
         rotary_scale_(rotary_scale),
         rotary_theta_(rotary_theta),
+        kv_dtype_(dtype),
+        quantized_pages_(DataType(page_dtype) != DataType(dtype)),
         f_transpose_append_(std::move(f_transpose_append)),
         f_compact_copy_(std::move(f_compact_copy)),
         f_attention_prefill_(std::move(f_attention_prefill)),
@@ -1028,10 +1215,17 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         f_copy_single_page_(std::move(f_copy_single_page)),
         f_debug_get_kv_(std::move(f_debug_get_kv)),
         device_(device) {
+    int64_t page_row_size = head_dim;
+    if (quantized_pages_) {
+      CHECK(DataType(page_dtype) == DataType::Int(8) || DataType(page_dtype).is_e4m3_float8())
+          << "Quantized KV cache pages only support int8 and e4m3_float, but got "
+          << DataType(page_dtype);
+      page_row_size += kQuantizedPageScaleBytes;
+    }
     pages_.reserve(num_layers);
     for (int i = 0; i < num_layers; ++i) {
-      pages_.push_back(
-          NDArray::Empty({num_total_pages, 2, num_kv_heads, page_size, head_dim}, dtype, device));
+      pages_.push_back(NDArray::Empty({num_total_pages, 2, num_kv_heads, page_size, page_row_size},
+                                      page_dtype, device));
     }
     // Allocate the host memory.
     Device preferred_host_device = GetPreferredHostDevice(device);
@@ -1111,17 +1305,25 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       copy_stream_ = DeviceAPI::Get(device)->CreateStream(device);
     }
 
-    // Create the auxiliary data manager for attention.
-    // We only use the merged aux data for CUDA, since direct pointer
-    // operations may have issues on other platforms.
-    if (device_.device_type == DLDeviceType::kDLCUDA) {
-      aux_data_manager_ = std::make_unique<CachedPagedKVCacheAuxDataManager>(
-          reserved_num_seqs, num_total_pages, prefill_chunk_size, dtype_aux_, device,
-          preferred_host_device, copy_stream_);
-    } else {
-      aux_data_manager_ = std::make_unique<PlainPagedKVCacheAuxDataManager>(
-          reserved_num_seqs, num_total_pages, prefill_chunk_size, dtype_aux_, device,
-          preferred_host_device, copy_stream_);
+    aux_data_manager_ = CreateAuxDataManager();
+
+    // Dispatch the decode attention to the fastest of the candidate kernels.
+    if (!f_attention_decode_candidates.empty()) {
+      CHECK(!f_attention_decode_begin_forward_.defined())
+          << "The decode kernels with \"begin forward\" functions cannot be selected at runtime.";
+      std::ostringstream key;
+      key << device.device_type << ":" << device.device_id << "," << num_qo_heads << ","
+          << num_kv_heads << "," << head_dim << "," << page_size << "," << DataType(dtype);
+      decode_kernels_.push_back(f_attention_decode_);
+      for (PackedFunc f_decode : f_attention_decode_candidates) {
+        decode_kernels_.push_back(f_decode);
+      }
+      for (const PackedFunc& f_decode : decode_kernels_) {
+        key << "," << f_decode.get();
+      }
+      decode_kernel_key_prefix_ = key.str();
+      f_attention_decode_ = PackedFunc(
+          [this](TVMArgs args, TVMRetValue* rv) { DispatchDecodeKernel(args, rv); });
     }
   }
 
@@ -1142,6 +1344,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
     global_block_pool_.clear();
     free_block_idx_.clear();
+    prefix_tree_root_ = std::make_unique<PrefixTreeNode>();
+    prefix_cache_next_seq_id_ = kPrefixCacheSeqIdBase;
+    swapped_seq_map_.clear();
     dirty_aux_data_device_ = false;
   }
 
@@ -1150,12 +1355,17 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   void AddSequence(int64_t seq_id) final {
     CHECK(seq_map_.find(seq_id) == seq_map_.end())
         << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    CHECK(swapped_seq_map_.find(seq_id) == swapped_seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is swapped out of the KV cache.";
     int32_t block_idx = GetFreeBlock();
     seq_map_.insert({seq_id, Sequence(&global_block_pool_, block_idx)});
     dirty_aux_data_device_ = true;
   }
 
   void RemoveSequence(int64_t seq_id) final {
+    if (swapped_seq_map_.erase(seq_id)) {
+      return;
+    }
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
     int32_t block_idx = it->second.last_block_idx;
@@ -1291,6 +1501,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void CompactKVCopy() {
+    NVTXScopedRange nvtx_scope("PagedKVCache: CompactKVCopy");
     int total_copy_length = commit_copy_length_indptr_host_.back();
     ICHECK_GE(total_copy_length, 0);
     if (total_copy_length == 0) {
@@ -1413,6 +1624,255 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     dirty_aux_data_device_ = true;
   }
 
+  /************** Host Memory Swap **************/
+
+  void SwapOutSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK_EQ(it->second.sliding_window_size, -1)
+        << "The sequence \"" << seq_id
+        << "\" is enabled with sliding window and thus cannot be swapped out.";
+    CHECK(it->second.accepted_indices_committed)
+        << "The sequence's token tree computed in the last round of forward has not been "
+           "committed with accepted nodes.";
+    // All blocks but the last one are full pages, so the concatenated pages of the
+    // blocks hold the sequence in order.
+    std::vector<int32_t> page_ids;
+    for (int32_t block_idx : it->second.GetBlockTrace(global_block_pool_)) {
+      const std::vector<int32_t>& block_page_ids = global_block_pool_[block_idx].page_ids;
+      page_ids.insert(page_ids.end(), block_page_ids.begin(), block_page_ids.end());
+    }
+    ICHECK_EQ(static_cast<int64_t>(page_ids.size()),
+              (it->second.seq_length + page_size_ - 1) / page_size_);
+
+    SwappedSequence swapped;
+    swapped.seq_length = it->second.seq_length;
+    swapped.host_data = NDArray::Empty(
+        {num_layers_, static_cast<int64_t>(page_ids.size()), 2, num_kv_heads_, page_size_,
+         pages_[0]->shape[4]},
+        pages_[0].DataType(), GetPreferredHostDevice(device_));
+    if (copy_stream_ != compute_stream_) {
+      // The copy must see the K/V data written by the computation so far.
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    CopyPagesWithHost(page_ids, swapped.host_data, /*to_host=*/true);
+    // The freed pages are only reused by the computation after the next
+    // BeginForward, which makes the compute stream wait for the copy stream.
+    RemoveSequence(seq_id);
+    swapped_seq_map_.insert({seq_id, std::move(swapped)});
+  }
+
+  void SwapInSequence(int64_t seq_id) final {
+    auto it = swapped_seq_map_.find(seq_id);
+    CHECK(it != swapped_seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is not swapped out of the KV cache.";
+    int64_t num_pages = it->second.host_data->shape[1];
+    while (static_cast<int64_t>(free_page_ids_.size()) < num_pages && EvictPrefixCacheLeaf()) {
+    }
+    CHECK_GE(static_cast<int64_t>(free_page_ids_.size()), num_pages)
+        << "The KV cache does not have enough free pages to swap in sequence \"" << seq_id
+        << "\", which needs " << num_pages << " pages.";
+
+    // The sequence comes back as a single block.
+    int32_t block_idx = GetFreeBlock();
+    std::vector<int32_t> page_ids;
+    for (int64_t i = 0; i < num_pages; ++i) {
+      page_ids.push_back(GetFreePage());
+    }
+    global_block_pool_[block_idx].page_ids = page_ids;
+    global_block_pool_[block_idx].seq_length = it->second.seq_length;
+    CopyPagesWithHost(page_ids, it->second.host_data, /*to_host=*/false);
+    seq_map_.insert({seq_id, Sequence(&global_block_pool_, block_idx)});
+    // Keep the host buffer alive until the copy is done.
+    pending_swap_in_buffers_.push_back(std::move(it->second.host_data));
+    swapped_seq_map_.erase(it);
+    dirty_aux_data_device_ = true;
+    // The block of the sequence may have the length and number of pages it had before the swap
+    // out, but not its pages.
+    decode_plan_valid_ = false;
+  }
+
+  /************** Prefix Cache **************/
+
+  int64_t AddSequenceWithPrefix(int64_t seq_id, const IntTuple& token_ids) final {
+    CHECK(seq_map_.find(seq_id) == seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    auto [node, matched_length] = MatchPrefix(token_ids);
+    // Leave at least one token to prefill, so that the forward computes the logits.
+    matched_length = std::min(matched_length, static_cast<int64_t>(token_ids.size()) - 1);
+    if (matched_length <= 0) {
+      AddSequence(seq_id);
+      return 0;
+    }
+    // Every leaf below the matched node holds the K/V data of the matched prefix.
+    while (!node->has_seq) {
+      ICHECK(!node->children.empty());
+      node = node->children.begin()->second.get();
+    }
+    node->last_access = ++prefix_cache_clock_;
+    prefix_cache_pinned_ = node;
+    ForkSequence(node->seq_id, seq_id, matched_length);
+    prefix_cache_pinned_ = nullptr;
+    return matched_length;
+  }
+
+  void CommitSequencePrefix(int64_t seq_id, const IntTuple& token_ids) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK_EQ(it->second.seq_length, static_cast<int64_t>(token_ids.size()))
+        << "The number of tokens does not match the length of sequence \"" << seq_id << "\".";
+    int64_t num_tokens = token_ids.size();
+    if (num_tokens == 0 || MatchPrefix(token_ids).second == num_tokens) {
+      return;
+    }
+    // Fork first: it may evict cached prefixes and thus change the tree.
+    int64_t cached_seq_id = prefix_cache_next_seq_id_++;
+    ForkSequence(seq_id, cached_seq_id);
+
+    auto [node, matched_length] = MatchPrefix(token_ids);
+    if (matched_length < node->length) {
+      // The match ends inside the edge of the node, split the edge.
+      int64_t split = node->tokens.size() - (node->length - matched_length);
+      auto mid = std::make_unique<PrefixTreeNode>();
+      mid->tokens.assign(node->tokens.begin(), node->tokens.begin() + split);
+      mid->length = matched_length;
+      mid->parent = node->parent;
+      node->tokens.erase(node->tokens.begin(), node->tokens.begin() + split);
+      std::unique_ptr<PrefixTreeNode>& slot = node->parent->children.at(mid->tokens[0]);
+      node->parent = mid.get();
+      mid->children.emplace(node->tokens[0], std::move(slot));
+      slot = std::move(mid);
+      node = slot.get();
+    } else if (node->has_seq) {
+      // The new prefix extends a cached one, which becomes redundant.
+      RemoveSequence(node->seq_id);
+      node->has_seq = false;
+    }
+    auto leaf = std::make_unique<PrefixTreeNode>();
+    leaf->tokens.assign(token_ids.begin() + matched_length, token_ids.end());
+    leaf->length = num_tokens;
+    leaf->parent = node;
+    leaf->has_seq = true;
+    leaf->seq_id = cached_seq_id;
+    leaf->last_access = ++prefix_cache_clock_;
+    node->children.emplace(leaf->tokens[0], std::move(leaf));
+  }
+
+  /************** Page Pool **************/
+
+  int32_t GetNumTotalPages() const final { return num_total_pages_; }
+
+  int32_t ResizePagePool(int64_t num_total_pages) final {
+    CHECK_GT(num_total_pages, 0) << "The KV cache needs at least one page, but got "
+                                 << num_total_pages;
+    auto f_num_used_pages = [this]() {
+      return num_total_pages_ - static_cast<int64_t>(free_page_ids_.size());
+    };
+    while (f_num_used_pages() > num_total_pages && EvictPrefixCacheLeaf()) {
+    }
+    num_total_pages = std::max(num_total_pages, f_num_used_pages());
+    if (num_total_pages == num_total_pages_) {
+      return num_total_pages_;
+    }
+
+    // The used pages beyond the new size move to the lowest free pages below it.
+    std::vector<bool> is_free(num_total_pages_, false);
+    for (int32_t page_id : free_page_ids_) {
+      is_free[page_id] = true;
+    }
+    int64_t num_kept_pages = std::min(num_total_pages, num_total_pages_);
+    std::vector<int32_t> kept_free_page_ids;
+    for (int64_t page_id = num_kept_pages - 1; page_id >= 0; --page_id) {
+      if (is_free[page_id]) {
+        kept_free_page_ids.push_back(page_id);
+      }
+    }
+    std::vector<int32_t> new_page_ids(num_total_pages_);
+    std::iota(new_page_ids.begin(), new_page_ids.end(), 0);
+    std::vector<std::pair<int32_t, int32_t>> moved_pages;
+    for (int64_t page_id = num_kept_pages; page_id < num_total_pages_; ++page_id) {
+      if (!is_free[page_id]) {
+        ICHECK(!kept_free_page_ids.empty());
+        new_page_ids[page_id] = kept_free_page_ids.back();
+        kept_free_page_ids.pop_back();
+        moved_pages.emplace_back(page_id, new_page_ids[page_id]);
+      }
+    }
+
+    if (copy_stream_ != nullptr) {
+      // The swaps in flight read or write the pages.
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+    }
+    int64_t page_bytes = GetDataSize(*pages_[0].operator->()) / num_total_pages_;
+    // Reallocate one layer at a time, so that the pages of a single layer are
+    // alive twice at the peak.
+    for (int64_t layer = 0; layer < num_layers_; ++layer) {
+      NDArray old_pages = pages_[layer];
+      std::vector<int64_t> shape(old_pages.Shape().begin(), old_pages.Shape().end());
+      shape[0] = num_total_pages;
+      NDArray new_pages = NDArray::Empty(ShapeTuple(shape), old_pages.DataType(), device_);
+      CopyPagesOnDevice(old_pages, 0, new_pages, 0, num_kept_pages, page_bytes);
+      for (const auto& [src_page_id, tgt_page_id] : moved_pages) {
+        CopyPagesOnDevice(old_pages, src_page_id, new_pages, tgt_page_id, 1, page_bytes);
+      }
+      // The old pages are freed at the end of the iteration.
+      DeviceAPI::Get(device_)->StreamSync(device_, compute_stream_);
+      pages_.Set(layer, new_pages);
+    }
+
+    for (Block& block : global_block_pool_) {
+      for (int32_t& page_id : block.page_ids) {
+        page_id = new_page_ids[page_id];
+      }
+    }
+    free_page_ids_.clear();
+    for (int64_t page_id = num_total_pages - 1; page_id >= num_kept_pages; --page_id) {
+      free_page_ids_.push_back(page_id);
+    }
+    free_page_ids_.insert(free_page_ids_.end(), kept_free_page_ids.begin(),
+                          kept_free_page_ids.end());
+    num_total_pages_ = num_total_pages;
+
+    // The page tables of a batch hold up to all the pages.
+    Device preferred_host_device = GetPreferredHostDevice(device_);
+    for (int d = 0; d < kPagedKVCacheMaxBlockDepth; ++d) {
+      page_indices_on_depths_host_[d] =
+          HostMemoryVector(num_total_pages_, dtype_aux_, preferred_host_device);
+    }
+    aux_data_manager_ = CreateAuxDataManager();
+    dirty_aux_data_device_ = true;
+    decode_plan_valid_ = false;
+    return num_total_pages_;
+  }
+
+  int32_t ResizePagePoolToBudget(int64_t reserved_bytes) final {
+    TVMRetValue rv;
+    DeviceAPI::Get(device_)->GetAttr(device_, DeviceAttrKind::kAvailableGlobalMemory, &rv);
+    CHECK(rv.type_code() != kTVMNullptr)
+        << "The device " << device_ << " does not report its free memory.";
+    int64_t free_bytes = rv;
+    int64_t layer_page_bytes = GetDataSize(*pages_[0].operator->()) / num_total_pages_;
+    // All the layers grow or shrink by the same number of pages, rounded down.
+    int64_t budget_bytes = free_bytes - reserved_bytes;
+    int64_t all_layer_page_bytes = layer_page_bytes * num_layers_;
+    int64_t num_delta_pages = budget_bytes >= 0
+                                  ? budget_bytes / all_layer_page_bytes
+                                  : -((-budget_bytes + all_layer_page_bytes - 1) /
+                                      all_layer_page_bytes);
+    int64_t num_total_pages = num_total_pages_ + num_delta_pages;
+    // While a layer is reallocated, its old and new pages are both alive, and
+    // the layers before it have been resized.
+    int64_t num_free_layer_pages = free_bytes / layer_page_bytes;
+    if (num_total_pages > num_total_pages_) {
+      int64_t max_num_total_pages =
+          (num_free_layer_pages + (num_layers_ - 1) * num_total_pages_) / num_layers_;
+      num_total_pages = std::max(num_total_pages_, std::min(num_total_pages, max_num_total_pages));
+    } else {
+      num_total_pages = std::min(num_total_pages, num_free_layer_pages);
+    }
+    return ResizePagePool(std::max<int64_t>(num_total_pages, 1));
+  }
+
   /************** Raw Info Query **************/
 
   bool Empty() const final {
@@ -1435,12 +1895,18 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
   void BeginForward(const IntTuple& seq_ids, const IntTuple& append_lengths,
                     const Optional<IntTuple>& opt_token_tree_parent_ptr) final {
+    NVTXScopedRange nvtx_scope("PagedKVCache: BeginForward");
     CHECK_EQ(seq_ids.size(), append_lengths.size())
         << "The seq_ids size (" << seq_ids.size() << ") and append_lengths size ("
         << append_lengths.size() << ") mismatch.";
     cur_batch_size_ = seq_ids.size();
     cur_seq_ids_ = seq_ids;
     cur_append_lengths_ = append_lengths;
+    UpdateDecodeKernelKey();
+
+    if (BeginDecodeIncrementally(opt_token_tree_parent_ptr)) {
+      return;
+    }
 
     // - Collect sequence/block/page information for attention.
     std::vector<Sequence*> sequences;
@@ -1482,6 +1948,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         sequence->is_chain = true;
         sequence->token_tree_parent_ptr.clear();
         sequence->token_tree_node_depths.clear();
+        sequence->token_tree_topology = nullptr;
       }
       is_chain_ = true;
     }
@@ -1491,16 +1958,46 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         std::min(static_cast<int>(block_ids_on_depths.size()), kPagedKVCacheMaxBlockDepth);
     ICHECK_LE(num_depths_, kPagedKVCacheMaxBlockDepth);
 
+    // A batch whose leading sequences are decodes and the others prefills, e.g. of chunked
+    // prefill, computes the attention on the cache of the decodes with the decode kernel.
+    // The mixed kernels rely on the kernels without "begin forward" plans.
+    int num_leading_decode_seqs = 0;
+    if (!is_decode_request_ && is_chain_ && !support_sliding_window_ &&
+        !f_attention_prefill_begin_forward_.defined()) {
+      while (append_lengths[num_leading_decode_seqs] == 1) {
+        ++num_leading_decode_seqs;
+      }
+    }
+
     std::vector<std::vector<std::pair<int32_t, int32_t>>> chunked_block_ids_arr;
     chunked_block_ids_arr.reserve(num_depths_);
     use_decode_kernel_.clear();
+    num_decode_seqs_on_depths_.clear();
     for (int d = 0; d < num_depths_; ++d) {
       // We force the blocks at maximum depth not to coalesce, so that it can be concatenated with
       // trailing exceeding blocks.
-      auto [chunked_block_ids, use_decode_kernel] = GetChunkedBlockIds(
-          block_ids_on_depths[d], /*enable_coalesce=*/d != kPagedKVCacheMaxBlockDepth - 1);
+      bool enable_coalesce = d != kPagedKVCacheMaxBlockDepth - 1;
+      auto [chunked_block_ids, use_decode_kernel] =
+          GetChunkedBlockIds(block_ids_on_depths[d], enable_coalesce);
+      int64_t num_decode_seqs = 0;
+      if (num_leading_decode_seqs > 0) {
+        auto [decode_block_ids, use_decode_kernel_on_decodes] =
+            GetChunkedBlockIds(block_ids_on_depths[d], 0, num_leading_decode_seqs,
+                               /*is_decode=*/true, enable_coalesce);
+        if (use_decode_kernel_on_decodes) {
+          chunked_block_ids = std::move(decode_block_ids);
+          std::vector<std::pair<int32_t, int32_t>> prefill_block_ids =
+              GetChunkedBlockIds(block_ids_on_depths[d], num_leading_decode_seqs, cur_batch_size_,
+                                 /*is_decode=*/false, enable_coalesce)
+                  .first;
+          chunked_block_ids.insert(chunked_block_ids.end(), prefill_block_ids.begin(),
+                                   prefill_block_ids.end());
+          num_decode_seqs = num_leading_decode_seqs;
+        }
+      }
       chunked_block_ids_arr.push_back(chunked_block_ids);
       use_decode_kernel_.push_back(use_decode_kernel);
+      num_decode_seqs_on_depths_.push_back(num_decode_seqs);
     }
 
     if (num_depths_ == kPagedKVCacheMaxBlockDepth) {
@@ -1534,11 +2031,14 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       sliding_window_offset_h.clear();
       sink_size_h.clear();
       k_rope_pos_offset_h.clear();
-      qo_indptr_h.push_back(0);
+      // The decode sequences of a mixed batch, whose queries are the first rows of the batch,
+      // have no queries for the prefill kernel.
+      const int64_t num_decode_seqs = num_decode_seqs_on_depths_[d];
+      qo_indptr_h.push_back(num_decode_seqs);
       page_indptr_h.push_back(0);
       for (int i = 0; i < static_cast<int>(chunked_block_ids_arr[d].size()); ++i) {
         const auto& [block_id, chunk_append_length] = chunked_block_ids_arr[d][i];
-        qo_indptr_h.push_back(qo_indptr_h.back() + chunk_append_length);
+        qo_indptr_h.push_back(qo_indptr_h.back() + (i < num_decode_seqs ? 0 : chunk_append_length));
         if (block_id == -1) {
           page_indptr_h.push_back(page_indptr_h.back());
           last_page_len_h.push_back(0);
@@ -1638,9 +2138,31 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         }
       }
     }
+
+    // - Record the page table of a decode, which the next decode of the batch can patch.
+    decode_plan_valid_ =
+        is_decode_request_ && !opt_token_tree_parent_ptr.defined() && append_before_attn_;
+    if (decode_plan_valid_) {
+      decode_plan_seq_ids_ = seq_ids;
+      decode_plan_block_ids_.clear();
+      decode_plan_block_lengths_.clear();
+      decode_plan_num_pages_.clear();
+      for (int i = 0; i < cur_batch_size_; ++i) {
+        const Block& block = global_block_pool_[sequences[i]->last_block_idx];
+        decode_plan_block_ids_.push_back(block.index);
+        decode_plan_block_lengths_.push_back(block.seq_length);
+        decode_plan_num_pages_.push_back(block.page_ids.size());
+      }
+    }
   }
 
   void EndForward() final {
+    NVTXScopedRange nvtx_scope("PagedKVCache: EndForward");
+    if (!pending_swap_in_buffers_.empty()) {
+      // The computation of this round already waited for the swap in copies.
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+      pending_swap_in_buffers_.clear();
+    }
     if (!f_attention_prefill_end_forward_.defined() || !f_attention_decode_end_forward_.defined() ||
         !f_attention_prefill_ragged_end_forward_.defined()) {
       return;
@@ -1654,10 +2176,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
   void AttentionWithFusedQKV(int64_t layer_id, NDArray qkv_data, Optional<NDArray> mask,
                              NDArray o_data, double attn_score_scaling_factor) final {
+    NVTXScopedRange nvtx_scope("PagedKVCache: AttentionWithFusedQKV");
     // Part 1. Shape and dtype check.
-    NDArray pages = pages_[layer_id];
-    CHECK(qkv_data.DataType() == pages.DataType());
-    CHECK(o_data.DataType() == pages.DataType());
+    CHECK(qkv_data.DataType() == DataType(kv_dtype_));
+    CHECK(o_data.DataType() == DataType(kv_dtype_));
 
     // qkv_data: (num_total_length, num_qo_heads + 2 * num_kv_heads, head_dim)
     // o_data: (num_total_length, num_qo_heads, head_dim)
@@ -1691,8 +2213,11 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     NDArray v_data = temp_attn_v_device_.CreateView({total_seq_length, num_kv_heads_, head_dim_},
                                                     qkv_data->dtype);
     // Part 2. Split fused qkv and apply rotary embedding to q/k data.
-    f_split_rotary_(qkv_data, q_rope_position_map_view_, q_data, k_data, v_data,
-                    rope_mode_ == RoPEMode::kNormal);
+    {
+      NVTXScopedRange nvtx_rotary_scope("PagedKVCache: SplitRotary");
+      f_split_rotary_(qkv_data, q_rope_position_map_view_, q_data, k_data, v_data,
+                      rope_mode_ == RoPEMode::kNormal);
+    }
 
     // Part 3. Append k/v data to kv-cache if flag "append_before_attn" is set.
     if (append_before_attn_) {
@@ -1740,39 +2265,21 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
           continue;
         }
 
-        // Get the accepted node path on the token tree.
-        std::vector<int32_t> path_on_tree;
-        path_on_tree.reserve(sequences[i]->token_tree_node_depths[leaf_indices[i]] + 1);
-        int node = leaf_indices[i];
-        while (node != -1) {
-          path_on_tree.push_back(node);
-          node = sequences[i]->token_tree_parent_ptr[node];
-        }
-        ICHECK_EQ(path_on_tree.size(), sequences[i]->token_tree_node_depths[leaf_indices[i]] + 1);
-        // Get the destination array (range [0, path_length - 1)) of KV cache copy.
-        std::vector<int32_t> copy_dst_pos_in_seq;
-        copy_dst_pos_in_seq.resize(path_on_tree.size());
-        std::iota(copy_dst_pos_in_seq.rbegin(), copy_dst_pos_in_seq.rend(), /*value=*/0);
-        // Remove the positions whose KV data do not need copy.
-        while (!path_on_tree.empty() && path_on_tree.back() == copy_dst_pos_in_seq.back()) {
-          path_on_tree.pop_back();
-          copy_dst_pos_in_seq.pop_back();
-        }
-        // Reverse the position arrays so that they are in ascending order.
-        std::reverse(path_on_tree.begin(), path_on_tree.end());
-        std::reverse(copy_dst_pos_in_seq.begin(), copy_dst_pos_in_seq.end());
+        // Get the copies that compact the accepted node path, prebuilt with the tree topology.
+        ICHECK(sequences[i]->token_tree_topology != nullptr);
+        const std::vector<std::pair<int32_t, int32_t>>& copies =
+            sequences[i]->token_tree_topology->commit_copies[leaf_indices[i]];
 
         // Convert the in-sequence src/dst positions to src/dst positions in page table
         // by looking up "append_position_map".
-        for (int p = 0; p < static_cast<int>(path_on_tree.size()); ++p) {
+        for (const auto& [src_pos_in_seq, dst_pos_in_seq] : copies) {
           commit_copy_src_pos_in_page_table_host_.push_back(
-              append_position_map_host_[cur_append_lengths_indptr_host_[i] + path_on_tree[p]]);
+              append_position_map_host_[cur_append_lengths_indptr_host_[i] + src_pos_in_seq]);
           commit_copy_dst_pos_in_page_table_host_.push_back(
-              append_position_map_host_[cur_append_lengths_indptr_host_[i] +
-                                        copy_dst_pos_in_seq[p]]);
+              append_position_map_host_[cur_append_lengths_indptr_host_[i] + dst_pos_in_seq]);
         }
         commit_copy_length_indptr_host_.push_back(commit_copy_length_indptr_host_.back() +
-                                                  path_on_tree.size());
+                                                  copies.size());
       }
 
       // Compact the KV data for each sequence by copying KV data.
@@ -1792,6 +2299,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       sequences[i]->accepted_indices_committed = true;
       sequences[i]->token_tree_parent_ptr.clear();
       sequences[i]->token_tree_node_depths.clear();
+      sequences[i]->token_tree_topology = nullptr;
     }
   }
 
@@ -1863,13 +2371,148 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
  private:
   /*! \brief Get a new free page and return its id. */
   int32_t GetFreePage() {
-    // Find a page from the free page pools.
+    // Find a page from the free page pools, evict cached prefixes under page pressure.
+    while (free_page_ids_.empty() && EvictPrefixCacheLeaf()) {
+    }
     CHECK(!free_page_ids_.empty()) << "The KV cache is full. No page can be allocated.";
     int32_t page_id = free_page_ids_.back();
     free_page_ids_.pop_back();
     return page_id;
   }
 
+  /*!
+   * \brief Copy the K/V data of the given pages between the KV cache and a host
+   * buffer, on the copy stream. Runs of consecutive pages are copied at once.
+   * \param page_ids The pages in the KV cache.
+   * \param host_data The host buffer, in layout
+   * (num_layers, num_pages, 2, num_heads, page_size, head_dim).
+   * \param to_host Whether to copy from the KV cache to the host buffer, or the reverse.
+   */
+  void CopyPagesWithHost(const std::vector<int32_t>& page_ids, const NDArray& host_data,
+                         bool to_host) {
+    int64_t num_pages = page_ids.size();
+    int64_t page_bytes = GetDataSize(*pages_[0].operator->()) / num_total_pages_;
+    for (int64_t layer = 0; layer < num_layers_; ++layer) {
+      for (int64_t i = 0; i < num_pages;) {
+        int64_t j = i + 1;
+        while (j < num_pages && page_ids[j] == page_ids[j - 1] + 1) {
+          ++j;
+        }
+        int64_t nbytes = (j - i) * page_bytes;
+        DLTensor device_view = *pages_[layer].operator->();
+        DLTensor host_view = *host_data.operator->();
+        for (DLTensor* view : {&device_view, &host_view}) {
+          view->ndim = 1;
+          view->shape = &nbytes;
+          view->strides = nullptr;
+          view->dtype = DLDataType{kDLUInt, 8, 1};
+        }
+        device_view.byte_offset += page_ids[i] * page_bytes;
+        host_view.byte_offset += (layer * num_pages + i) * page_bytes;
+        if (to_host) {
+          NDArray::CopyFromTo(&device_view, &host_view, copy_stream_);
+        } else {
+          NDArray::CopyFromTo(&host_view, &device_view, copy_stream_);
+        }
+        i = j;
+      }
+    }
+  }
+
+  /*!
+   * \brief Copy the K/V data of consecutive pages between the page arrays of a layer, on the
+   * compute stream.
+   */
+  void CopyPagesOnDevice(const NDArray& src, int64_t src_page_id, const NDArray& tgt,
+                         int64_t tgt_page_id, int64_t num_pages, int64_t page_bytes) {
+    if (num_pages == 0) {
+      return;
+    }
+    int64_t nbytes = num_pages * page_bytes;
+    DLTensor src_view = *src.operator->();
+    DLTensor tgt_view = *tgt.operator->();
+    for (DLTensor* view : {&src_view, &tgt_view}) {
+      view->ndim = 1;
+      view->shape = &nbytes;
+      view->strides = nullptr;
+      view->dtype = DLDataType{kDLUInt, 8, 1};
+    }
+    src_view.byte_offset += src_page_id * page_bytes;
+    tgt_view.byte_offset += tgt_page_id * page_bytes;
+    NDArray::CopyFromTo(&src_view, &tgt_view, compute_stream_);
+  }
+
+  /*!
+   * \brief Create the auxiliary data manager for attention, sized by the pages.
+   * We only use the merged aux data for CUDA, since direct pointer
+   * operations may have issues on other platforms.
+   */
+  std::unique_ptr<PagedKVCacheAuxDataManager> CreateAuxDataManager() const {
+    Device preferred_host_device = GetPreferredHostDevice(device_);
+    if (device_.device_type == DLDeviceType::kDLCUDA) {
+      return std::make_unique<CachedPagedKVCacheAuxDataManager>(
+          reserved_num_seqs_, num_total_pages_, prefill_chunk_size_, dtype_aux_, device_,
+          preferred_host_device, copy_stream_);
+    }
+    return std::make_unique<PlainPagedKVCacheAuxDataManager>(
+        reserved_num_seqs_, num_total_pages_, prefill_chunk_size_, dtype_aux_, device_,
+        preferred_host_device, copy_stream_);
+  }
+
+  /*!
+   * \brief Find the longest prefix of the given tokens in the prefix cache.
+   * \return The deepest node the match reaches (possibly ending inside the edge
+   * of the node), and the length of the matched prefix.
+   */
+  std::pair<PrefixTreeNode*, int64_t> MatchPrefix(const IntTuple& token_ids) const {
+    PrefixTreeNode* node = prefix_tree_root_.get();
+    int64_t pos = 0;
+    int64_t num_tokens = token_ids.size();
+    while (pos < num_tokens) {
+      auto it = node->children.find(token_ids[pos]);
+      if (it == node->children.end()) break;
+      node = it->second.get();
+      size_t i = 0;
+      while (i < node->tokens.size() && pos < num_tokens && node->tokens[i] == token_ids[pos]) {
+        ++i;
+        ++pos;
+      }
+      if (i < node->tokens.size()) break;
+    }
+    return {node, pos};
+  }
+
+  /*!
+   * \brief Evict the least recently used cached prefix.
+   * \return Whether a cached prefix was evicted.
+   */
+  bool EvictPrefixCacheLeaf() {
+    PrefixTreeNode* lru = nullptr;
+    std::vector<PrefixTreeNode*> stack = {prefix_tree_root_.get()};
+    while (!stack.empty()) {
+      PrefixTreeNode* node = stack.back();
+      stack.pop_back();
+      if (node->has_seq && node != prefix_cache_pinned_ &&
+          (lru == nullptr || node->last_access < lru->last_access)) {
+        lru = node;
+      }
+      for (auto& kv : node->children) {
+        stack.push_back(kv.second.get());
+      }
+    }
+    if (lru == nullptr) return false;
+    RemoveSequence(lru->seq_id);
+    lru->has_seq = false;
+    // Drop the leaf and the ancestors that no longer lead to any cached prefix.
+    PrefixTreeNode* node = lru;
+    while (node->parent != nullptr && node->children.empty() && !node->has_seq) {
+      PrefixTreeNode* parent = node->parent;
+      parent->children.erase(node->tokens[0]);
+      node = parent;
+    }
+    return true;
+  }
+
   /*! \brief Get a new free block and return its index. */
   int32_t GetFreeBlock() {
     if (!free_block_idx_.empty()) {
@@ -1914,51 +2557,46 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         << " while there are " << token_tree_parent_ptr.size()
         << " elements in \"token_tree_parent_ptr\".";
 
-    // - Construct the mask of each sequence.
+    // - Construct the mask of each sequence, from the topology of its tree shape.
     for (int i = 0; i < cur_batch_size_; ++i) {
-      int64_t tree_size = sequences[i]->token_tree_parent_ptr.size();
-      std::vector<std::vector<int32_t>> mask;
-      std::vector<int32_t> depth;
-      mask.reserve(tree_size);
-      depth.reserve(tree_size);
-      sequences[i]->is_chain = true;
+      std::shared_ptr<const TokenTreeTopology> topology =
+          GetTokenTreeTopology(sequences[i]->token_tree_parent_ptr, i);
+      sequences[i]->is_chain = topology->is_chain;
       sequences[i]->accepted_indices_committed = false;
-      for (int64_t n = 0; n < tree_size; ++n) {
-        CHECK_LT(sequences[i]->token_tree_parent_ptr[n], n)
-            << "Invalid token tree. The parent of node " << n << " in tree " << i << " is "
-            << sequences[i]->token_tree_parent_ptr[n] << ", which is not smaller than " << n;
-        CHECK_GE(sequences[i]->token_tree_parent_ptr[n], -1)
-            << "Invalid token tree. The parent of node " << n << " in tree " << i << " is "
-            << sequences[i]->token_tree_parent_ptr[n];
-        if (sequences[i]->token_tree_parent_ptr[n] != n - 1) {
-          // The parent of the current node is not the last node.
-          // Therefore the tree is not a chain.
-          sequences[i]->is_chain = false;
-          is_chain = false;
-        }
-
-        std::vector<int32_t> single_pos_mask;
-        if (sequences[i]->token_tree_parent_ptr[n] != -1) {
-          // The current node has a parent in the token tree.
-          single_pos_mask = {mask[sequences[i]->token_tree_parent_ptr[n]].begin(),
-                             mask[sequences[i]->token_tree_parent_ptr[n]].end()};
-          depth.push_back(depth[sequences[i]->token_tree_parent_ptr[n]] + 1);
-        } else {
-          // The current node is root in the token tree.
-          single_pos_mask.resize(tree_size, /*value=*/0);
-          depth.push_back(0);
-        }
-        single_pos_mask[n] = 1;
-        mask.push_back(single_pos_mask);
-        for (int32_t mask_val : single_pos_mask) {
-          tree_attn_mask_host_.push_back(mask_val);
-        }
-      }
-      sequences[i]->token_tree_node_depths = std::move(depth);
+      is_chain = is_chain && topology->is_chain;
+      tree_attn_mask_host_.append(topology->mask);
+      sequences[i]->token_tree_node_depths = topology->depths;
+      sequences[i]->token_tree_topology = std::move(topology);
     }
     return is_chain;
   }
 
+  /*!
+   * \brief Get the topology of a token tree, which is built on the first tree of its shape.
+   * \param parent_ptr The parent pointers of the nodes of the tree.
+   * \param tree_index The index of the tree in the batch, for the error messages.
+   */
+  std::shared_ptr<const TokenTreeTopology> GetTokenTreeTopology(
+      const std::vector<int32_t>& parent_ptr, int tree_index) {
+    auto it = token_tree_topologies_.find(parent_ptr);
+    if (it != token_tree_topologies_.end()) {
+      return it->second;
+    }
+    for (int64_t n = 0; n < static_cast<int64_t>(parent_ptr.size()); ++n) {
+      CHECK_LT(parent_ptr[n], n) << "Invalid token tree. The parent of node " << n << " in tree "
+                                 << tree_index << " is " << parent_ptr[n]
+                                 << ", which is not smaller than " << n;
+      CHECK_GE(parent_ptr[n], -1) << "Invalid token tree. The parent of node " << n
+                                  << " in tree " << tree_index << " is " << parent_ptr[n];
+    }
+    if (static_cast<int>(token_tree_topologies_.size()) >= kMaxNumCachedTokenTreeTopologies) {
+      token_tree_topologies_.clear();
+    }
+    auto topology = std::make_shared<const TokenTreeTopology>(parent_ptr);
+    token_tree_topologies_.emplace(parent_ptr, topology);
+    return topology;
+  }
+
   /*!
    * \brief Slide the KV cache window of the given sequence when
    * it has sliding window enabled.
@@ -1997,13 +2635,19 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int32_t page_start_offset_after_sliding =
         (block.sliding_window_offset + length_to_slide) % page_size_;
 
-    // - Free the pages that are fully slidden.
-    while (page_idx_after_sliding > num_sink_pages) {
-      if (block.page_ids[num_sink_pages] != kPagedKVCacheTempPageId) {
-        free_page_ids_.push_back(block.page_ids[num_sink_pages]);
+    // - Free the pages that are fully slidden, which are the oldest pages after the sink pages.
+    // The pages return to the free pages right away, so that the pages reserved for the append
+    // reuse them. The KV data in the remaining pages stays in place.
+    if (page_idx_after_sliding > num_sink_pages) {
+      auto slidden_begin = block.page_ids.begin() + num_sink_pages;
+      auto slidden_end = block.page_ids.begin() + page_idx_after_sliding;
+      for (auto it = slidden_begin; it != slidden_end; ++it) {
+        if (*it != kPagedKVCacheTempPageId) {
+          free_page_ids_.push_back(*it);
+        }
       }
-      block.page_ids.erase(block.page_ids.begin() + num_sink_pages);
-      --page_idx_after_sliding;
+      block.page_ids.erase(slidden_begin, slidden_end);
+      page_idx_after_sliding = num_sink_pages;
     }
     // - The first sliding page after sliding is either the last sink page,
     // or the page next to the last sink page.
@@ -2049,11 +2693,13 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int64_t tgt_npage = (block.seq_length - block.sink_length + block.sliding_window_offset +
                          append_length + page_size_ - 1) /
                         page_size_;
+    int64_t num_temp_pages = 0;
     for (int64_t page_idx = cur_npage; page_idx < tgt_npage; ++page_idx) {
       // When sliding window is enabled for the seq, we can "borrow temporary pages (-1)",
       // since the pages need to be slidden out might not have been released.
       if (free_page_ids_.empty() && seq->sliding_window_size != -1) {
         block.page_ids.push_back(kPagedKVCacheTempPageId);
+        ++num_temp_pages;
       } else {
         block.page_ids.push_back(GetFreePage());
       }
@@ -2063,9 +2709,11 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     // ==================== Slide ====================
     // Slide the sequences so that the pages exceed the sliding window are released.
     SlideWindowForSequence(seq);
-    for (int i = 0; i < static_cast<int>(block.page_ids.size()); ++i) {
+    // Re-allocate the temporary pages after sliding window release. They are the last pages of
+    // the block, unless they are slidden out already.
+    int64_t num_pages = block.page_ids.size();
+    for (int64_t i = num_pages - 1; i >= 0 && i >= num_pages - num_temp_pages; --i) {
       if (block.page_ids[i] == kPagedKVCacheTempPageId) {
-        // Re-allocate the temporary pages after sliding window release.
         block.page_ids[i] = GetFreePage();
       }
     }
@@ -2073,6 +2721,89 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     dirty_aux_data_device_ = true;
   }
 
+  /*!
+   * \brief Begin a decode of the same batch as the last forward, which was a decode of
+   * sequences of one block each, by patching the auxiliary arrays of the last forward in place.
+   * In steady-state decode, each sequence only gains a token, which changes its positions and
+   * last page length, and the page table only changes when a sequence takes a new page. This
+   * skips collecting the block traces and rebuilding the arrays on every step.
+   * \param opt_token_tree_parent_ptr The token tree of the forward.
+   * \return Whether the forward began, or false if it is not such a decode, in which case
+   * nothing has changed.
+   */
+  bool BeginDecodeIncrementally(const Optional<IntTuple>& opt_token_tree_parent_ptr) {
+    if (!decode_plan_valid_ || opt_token_tree_parent_ptr.defined() ||
+        cur_seq_ids_.size() != decode_plan_seq_ids_.size()) {
+      return false;
+    }
+    // - Check that no sequence changed since the last decode but by the decode itself.
+    std::vector<Sequence*> sequences;
+    sequences.reserve(cur_batch_size_);
+    for (int i = 0; i < cur_batch_size_; ++i) {
+      if (cur_seq_ids_[i] != decode_plan_seq_ids_[i] || cur_append_lengths_[i] != 1) {
+        return false;
+      }
+      auto it = seq_map_.find(cur_seq_ids_[i]);
+      if (it == seq_map_.end() || !it->second.accepted_indices_committed) {
+        return false;
+      }
+      const Block& block = global_block_pool_[it->second.last_block_idx];
+      if (block.index != decode_plan_block_ids_[i] || block.parent_idx != -1 ||
+          block.external_ref_cnt != 1 || block.sink_length != 0 ||
+          block.sliding_window_offset != 0 || block.seq_length != decode_plan_block_lengths_[i] ||
+          static_cast<int32_t>(block.page_ids.size()) != decode_plan_num_pages_[i]) {
+        return false;
+      }
+      sequences.push_back(&it->second);
+    }
+
+    // - Append the token of each sequence, and patch its entries.
+    int32_t* k_ragged_rope_pos_offset = k_ragged_rope_pos_offset_host_.data();
+    int32_t* q_rope_position_map = q_rope_position_map_host_.data();
+    int32_t* append_position_map = append_position_map_host_.data();
+    int32_t* last_page_len = last_page_len_on_depths_host_[0].data();
+    bool page_table_changed = false;
+    for (int i = 0; i < cur_batch_size_; ++i) {
+      Sequence* seq = sequences[i];
+      k_ragged_rope_pos_offset[i] = seq->seq_length;
+      q_rope_position_map[i] = seq->seq_length;
+      seq->seq_length += 1;
+      ReserveAppendLengthInSeq(seq, 1);
+      const Block& block = global_block_pool_[seq->last_block_idx];
+      int32_t pos_in_block = block.seq_length - 1;
+      last_page_len[i] = pos_in_block % page_size_ + 1;
+      append_position_map[i] =
+          block.page_ids[pos_in_block / page_size_] * page_size_ + pos_in_block % page_size_;
+      decode_plan_block_lengths_[i] = block.seq_length;
+      if (static_cast<int32_t>(block.page_ids.size()) != decode_plan_num_pages_[i]) {
+        decode_plan_num_pages_[i] = block.page_ids.size();
+        page_table_changed = true;
+      }
+    }
+
+    // - Rebuild the page table if a sequence took a new page.
+    if (page_table_changed) {
+      HostMemoryVector& page_indptr_h = page_indptr_on_depths_host_[0];
+      HostMemoryVector& page_indices_h = page_indices_on_depths_host_[0];
+      page_indptr_h.clear();
+      page_indices_h.clear();
+      page_indptr_h.push_back(0);
+      for (int i = 0; i < cur_batch_size_; ++i) {
+        const Block& block = global_block_pool_[sequences[i]->last_block_idx];
+        page_indices_h.append(block.page_ids);
+        page_indptr_h.push_back(page_indptr_h.back() + block.page_ids.size());
+      }
+    }
+
+    is_decode_request_ = true;
+    is_chain_ = true;
+    num_depths_ = 1;
+    use_decode_kernel_ = {true};
+    num_decode_seqs_on_depths_ = {0};
+    append_before_attn_ = true;
+    return true;
+  }
+
   /*!
    * \brief For the given list of sequences, check the block trace of
    * each sequence, and return the blocks ids used by the sequences
@@ -2135,16 +2866,27 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
    */
   std::pair<std::vector<std::pair<int32_t, int32_t>>, bool> GetChunkedBlockIds(
       const std::vector<int32_t>& block_ids, bool enable_coalesce = true) const {
+    return GetChunkedBlockIds(block_ids, 0, block_ids.size(), is_decode_request_,
+                              enable_coalesce);
+  }
+
+  /*!
+   * \brief The GetChunkedBlockIds above on the sequences [begin, end) of the batch only,
+   * which are a decode if `is_decode` is true.
+   */
+  std::pair<std::vector<std::pair<int32_t, int32_t>>, bool> GetChunkedBlockIds(
+      const std::vector<int32_t>& block_ids, int begin, int end, bool is_decode,
+      bool enable_coalesce) const {
     std::vector<std::pair<int32_t, int32_t>> uncoalesced_block_ids;
     std::vector<std::pair<int32_t, int32_t>> coalesced_block_ids;
 
     // Gather the number of pages before/after coalescing respectively.
-    int cur_block_id = block_ids[0];
-    int chunk_append_length = cur_append_lengths_[0];
+    int cur_block_id = block_ids[begin];
+    int chunk_append_length = cur_append_lengths_[begin];
     int page_counter_coalesced = 0;
     int page_counter_uncoalesced =
-        block_ids[0] != -1 ? global_block_pool_[block_ids[0]].page_ids.size() : 0;
-    for (int i = 1; i < static_cast<int>(block_ids.size()); ++i) {
+        block_ids[begin] != -1 ? global_block_pool_[block_ids[begin]].page_ids.size() : 0;
+    for (int i = begin + 1; i < end; ++i) {
       if (block_ids[i] != -1) {
         page_counter_uncoalesced += global_block_pool_[block_ids[i]].page_ids.size();
       }
@@ -2160,18 +2902,113 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         chunk_append_length = cur_append_lengths_[i];
       }
     }
-    uncoalesced_block_ids.emplace_back(block_ids.back(), cur_append_lengths_.back());
+    uncoalesced_block_ids.emplace_back(block_ids[end - 1], cur_append_lengths_[end - 1]);
     coalesced_block_ids.emplace_back(cur_block_id, chunk_append_length);
     if (cur_block_id != -1) {
       page_counter_coalesced += global_block_pool_[cur_block_id].page_ids.size();
     }
     double coalesce_ratio = 1.0 * page_counter_uncoalesced / page_counter_coalesced;
     // Do not coalesce and use batch decode kernel when coalesce ratio is small.
-    bool use_decode_kernel = is_decode_request_ && coalesce_ratio < 1.1;
+    bool use_decode_kernel = is_decode && coalesce_ratio < 1.1;
     return {use_decode_kernel || !enable_coalesce ? uncoalesced_block_ids : coalesced_block_ids,
             use_decode_kernel};
   }
 
+  /*!
+   * \brief The decode kernel chosen by measurement for each kernel configuration and shape of
+   * batch, shared by the KV caches of the process.
+   */
+  struct DecodeKernelChoices {
+    std::mutex mutex;
+    std::unordered_map<std::string, int> choices;
+
+    static DecodeKernelChoices* Global() {
+      static DecodeKernelChoices inst;
+      return &inst;
+    }
+  };
+
+  /*!
+   * \brief Key the shape of the current batch in the decode kernel choices, by the power-of-two
+   * buckets of the batch size and of the mean sequence length, which decide how much the kernels
+   * parallelize over the batch and split the KV of a sequence respectively.
+   */
+  void UpdateDecodeKernelKey() {
+    if (decode_kernels_.empty()) {
+      return;
+    }
+    int64_t total_length = 0;
+    for (int64_t seq_id : cur_seq_ids_) {
+      auto it = seq_map_.find(seq_id);
+      if (it != seq_map_.end()) {
+        total_length += it->second.seq_length;
+      }
+    }
+    auto bucket = [](int64_t value) {
+      int64_t bucket = 1;
+      while (bucket < value) {
+        bucket *= 2;
+      }
+      return bucket;
+    };
+    int64_t mean_length = total_length / std::max<int64_t>(cur_batch_size_, 1);
+    std::string key = decode_kernel_key_prefix_ + "," + std::to_string(bucket(cur_batch_size_)) +
+                      "," + std::to_string(bucket(mean_length));
+    if (key != decode_kernel_key_) {
+      decode_kernel_key_ = std::move(key);
+      decode_kernel_choice_ = -1;
+    }
+  }
+
+  /*!
+   * \brief Run the decode kernel chosen for the shape of the current batch. The first batch of a
+   * shape in the process measures every decode kernel on its arguments, which only write the
+   * attention output and scores, and records the fastest.
+   */
+  void DispatchDecodeKernel(TVMArgs args, TVMRetValue* rv) {
+    if (decode_kernel_choice_ == -1) {
+      DecodeKernelChoices* choices = DecodeKernelChoices::Global();
+      {
+        std::lock_guard<std::mutex> lock(choices->mutex);
+        auto it = choices->choices.find(decode_kernel_key_);
+        if (it != choices->choices.end()) {
+          decode_kernel_choice_ = it->second;
+        }
+      }
+      if (decode_kernel_choice_ == -1) {
+        decode_kernel_choice_ = MeasureDecodeKernels(args);
+        std::lock_guard<std::mutex> lock(choices->mutex);
+        choices->choices.emplace(decode_kernel_key_, decode_kernel_choice_);
+      }
+    }
+    decode_kernels_[decode_kernel_choice_].CallPacked(args, rv);
+  }
+
+  /*! \brief Measure the decode kernels on the given arguments and return the fastest one. */
+  int MeasureDecodeKernels(TVMArgs args) {
+    constexpr int kNumRepeats = 3;
+    int best = 0;
+    int64_t best_nanos = std::numeric_limits<int64_t>::max();
+    for (int i = 0; i < static_cast<int>(decode_kernels_.size()); ++i) {
+      TVMRetValue rv;
+      // Warm up the kernel, e.g. its module loading, before the measurement.
+      decode_kernels_[i].CallPacked(args, &rv);
+      Timer timer = Timer::Start(device_);
+      for (int r = 0; r < kNumRepeats; ++r) {
+        decode_kernels_[i].CallPacked(args, &rv);
+      }
+      timer->Stop();
+      int64_t nanos = timer->SyncAndGetElapsedNanos();
+      VLOG(1) << "Decode kernel " << i << " takes " << nanos / kNumRepeats << " ns for "
+              << decode_kernel_key_;
+      if (nanos < best_nanos) {
+        best = i;
+        best_nanos = nanos;
+      }
+    }
+    return best;
+  }
+
   /*! \brief Invoke the "begin forward" functions of underlying kernels. */
   void KernelBeginForward() {
     if (!f_attention_prefill_begin_forward_.defined() ||
@@ -2221,6 +3058,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
    */
   void AttentionInternal(int64_t layer_id, NDArray q_data, NDArray k_data, NDArray v_data,
                          NDArray output, double attn_score_scaling_factor) {
+    NVTXScopedRange nvtx_scope("PagedKVCache: Attention");
     PackedFunc f_prefill =
         !support_sliding_window_ ? f_attention_prefill_ : f_attention_prefill_sliding_window_;
     PackedFunc f_decode =
@@ -2261,6 +3099,11 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         if (page_indices_on_depths_view_[d]->shape[0] == 0) {
           continue;
         }
+        if (num_decode_seqs_on_depths_[d] > 0) {
+          // Use decode kernel for the decode sequences and prefill kernel for the others
+          AttentionOnDepthMixed(d, layer_id, q_data, output, attn_score_scaling_factor);
+          continue;
+        }
         if (use_decode_kernel_[d]) {
           // Use decode kernel for depth d
           f_decode(/*depth=*/d, q_data, pages_[layer_id], page_indptr_on_depths_view_[d],
@@ -2286,6 +3129,51 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
   }
 
+  /*!
+   * \brief Compute the attention on the cache at the given depth of a mixed batch, with the decode
+   * kernel on the leading decode sequences and the prefill kernel on the others, and merge it into
+   * the output. The prefill kernel is skipped when the other sequences have no pages at the depth.
+   */
+  void AttentionOnDepthMixed(int d, int64_t layer_id, NDArray q_data, NDArray output,
+                             double attn_score_scaling_factor) {
+    const int64_t num_decode_seqs = num_decode_seqs_on_depths_[d];
+    const HostMemoryVector& page_indptr_h = page_indptr_on_depths_host_[d];
+    int64_t num_qo = q_data->shape[0];
+    // The decode sequences take the first rows of the batch and the first entries of the
+    // auxiliary arrays, whose views start at the same addresses.
+    auto prefix = [](NDArray array, int64_t length) {
+      ShapeTuple shape = array.Shape();
+      std::vector<int64_t> view_shape(shape.begin(), shape.end());
+      view_shape[0] = length;
+      return array.CreateView(view_shape, array->dtype);
+    };
+    f_attention_decode_(
+        /*depth=*/d, prefix(q_data, num_decode_seqs), pages_[layer_id],
+        prefix(page_indptr_on_depths_view_[d], num_decode_seqs + 1),
+        page_indices_on_depths_view_[d], prefix(length_info_on_depths_view_[d], num_decode_seqs),
+        prefix(k_rope_pos_offset_view_[d], num_decode_seqs),
+        prefix(q_rope_position_map_view_, num_decode_seqs),
+        prefix(temp_attn_output_view_, num_decode_seqs),
+        prefix(temp_attn_scores_view_, num_decode_seqs),
+        /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_, rotary_theta_,
+        attn_score_scaling_factor);
+    if (page_indptr_h[num_decode_seqs] != page_indptr_h.back()) {
+      f_attention_prefill_(
+          /*depth=*/d, q_data, qo_indptr_on_depths_view_[d], pages_[layer_id],
+          page_indptr_on_depths_view_[d], page_indices_on_depths_view_[d],
+          length_info_on_depths_view_[d], k_rope_pos_offset_view_[d], q_rope_position_map_view_,
+          temp_attn_output_view_, temp_attn_scores_view_,
+          /*causal=*/0,
+          /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_, rotary_theta_,
+          attn_score_scaling_factor);
+    } else {
+      num_qo = num_decode_seqs;
+    }
+    f_merge_inplace_(prefix(output, num_qo), prefix(merged_attn_scores_view_, num_qo),
+                     prefix(temp_attn_output_view_, num_qo),
+                     prefix(temp_attn_scores_view_, num_qo));
+  }
+
   /*! \brief Synchronize the copy stream and the compute stream. */
   void ComputeStreamWaitForCopyStream() {
     if (!dirty_aux_data_device_) {
@@ -2416,7 +3304,7 @@ TVM_REGISTER_OBJECT_TYPE(PagedAttentionKVCacheObj);
 
 TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
-      CHECK(args.size() == 25 || args.size() == 26 || args.size() == 27)
+      CHECK(args.size() >= 25 && args.size() <= 29)
           << "Invalid number of KV cache constructor args.";
       ShapeTuple cache_config = args[0];
       int64_t num_layers = args[1];
@@ -2452,6 +3340,14 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
       if (args.size() >= 27) {
         f_attention_prefill_with_tree_mask = args[26].AsObjectRef<PackedFunc>();
       }
+      DLDataType page_dtype = init->dtype;
+      if (args.size() >= 28) {
+        page_dtype = args[27];
+      }
+      Array<PackedFunc> f_attention_decode_candidates;
+      if (args.size() >= 29) {
+        f_attention_decode_candidates = args[28].AsObjectRef<Array<PackedFunc>>();
+      }
 
       CHECK_EQ(cache_config.size(), 5);
       int64_t reserved_num_seqs = cache_config[0];
@@ -2467,9 +3363,9 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
       ObjectPtr<PagedAttentionKVCacheObj> n = make_object<PagedAttentionKVCacheObj>(
           page_size, num_layers, num_qo_heads, num_kv_heads, head_dim, reserved_num_seqs,
           num_total_pages, prefill_chunk_size, support_sliding_window, RoPEMode(rope_mode),
-          rotary_scale, rotary_theta, init->dtype, init->device, std::move(f_transpose_append),
-          std::move(f_compact_copy), std::move(f_attention_prefill), std::move(f_attention_decode),
-          std::move(f_attention_prefill_sliding_window),
+          rotary_scale, rotary_theta, init->dtype, page_dtype, init->device,
+          std::move(f_transpose_append), std::move(f_compact_copy), std::move(f_attention_prefill),
+          std::move(f_attention_decode), std::move(f_attention_prefill_sliding_window),
           std::move(f_attention_decode_sliding_window), std::move(f_attention_prefill_ragged),
           std::move(f_attention_prefill_with_tree_mask),
           std::move(f_attention_prefill_ragged_begin_forward),
@@ -2477,13 +3373,13 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
           std::move(f_attention_prefill_begin_forward), std::move(f_attention_prefill_end_forward),
           std::move(f_attention_decode_begin_forward), std::move(f_attention_decode_end_forward),
           std::move(f_merge_inplace), std::move(f_split_rotary), std::move(f_copy_single_page),
-          std::move(f_debug_get_kv));
+          std::move(f_debug_get_kv), std::move(f_attention_decode_candidates));
       *rv = AttentionKVCache(std::move(n));
     });
 
 TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
-      CHECK(args.size() == 19 || args.size() == 20 || args.size() == 21)
+      CHECK(args.size() >= 19 && args.size() <= 23)
           << "Invalid number of KV cache constructor args.";
       ShapeTuple cache_config = args[0];
       int64_t num_layers = args[1];
@@ -2513,6 +3409,14 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
       if (args.size() >= 21) {
         f_attention_prefill_with_tree_mask = args[20].AsObjectRef<PackedFunc>();
       }
+      DLDataType page_dtype = init->dtype;
+      if (args.size() >= 22) {
+        page_dtype = args[21];
+      }
+      Array<PackedFunc> f_attention_decode_candidates;
+      if (args.size() >= 23) {
+        f_attention_decode_candidates = args[22].AsObjectRef<Array<PackedFunc>>();
+      }
 
       CHECK_EQ(cache_config.size(), 5);
       int64_t reserved_num_seqs = cache_config[0];
@@ -2528,14 +3432,14 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
       ObjectPtr<PagedAttentionKVCacheObj> n = make_object<PagedAttentionKVCacheObj>(
           page_size, num_layers, num_qo_heads, num_kv_heads, head_dim, reserved_num_seqs,
           num_total_pages, prefill_chunk_size, support_sliding_window, RoPEMode(rope_mode),
-          rotary_scale, rotary_theta, init->dtype, init->device, std::move(f_transpose_append),
-          std::move(f_compact_copy), std::move(f_attention_prefill), std::move(f_attention_decode),
-          std::move(f_attention_prefill_sliding_window),
+          rotary_scale, rotary_theta, init->dtype, page_dtype, init->device,
+          std::move(f_transpose_append), std::move(f_compact_copy), std::move(f_attention_prefill),
+          std::move(f_attention_decode), std::move(f_attention_prefill_sliding_window),
           std::move(f_attention_decode_sliding_window), std::move(f_attention_prefill_ragged),
           std::move(f_attention_prefill_with_tree_mask),         //
           NullOpt, NullOpt, NullOpt, NullOpt, NullOpt, NullOpt,  //
           std::move(f_merge_inplace), std::move(f_split_rotary), std::move(f_copy_single_page),
-          std::move(f_debug_get_kv));
+          std::move(f_debug_get_kv), std::move(f_attention_decode_candidates));
       *rv = AttentionKVCache(std::move(n));
     });
 
@@ -0,0 +1,221 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/ragged_builtin.cc
+ * \brief The builtin functions for ragged batches of sequences.
+ *
+ * A ragged batch is a pair (values, indptr). The values concatenate the sequences along axis 0,
+ * in a tensor of shape (total_length, *row_shape), and the int32 indptr of shape
+ * (batch_size + 1,) holds the offsets of the sequences, where sequence i is the rows
+ * [indptr[i], indptr[i + 1]) of the values. Both live on the device of the sequences, so that
+ * the kernels that take an indptr, e.g. the ones of the paged KV cache, consume the batch with
+ * no padding.
+ */
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The number of bytes of one row of a tensor, i.e. of the elements from `begin_axis`.
+ */
+int64_t RowBytes(const NDArray& arr, int begin_axis = 1) {
+  int64_t bytes = (arr->dtype.bits * arr->dtype.lanes + 7) / 8;
+  for (int i = begin_axis; i < arr->ndim; ++i) {
+    bytes *= arr->shape[i];
+  }
+  return bytes;
+}
+
+/*! \brief The shape of `length` rows of a tensor, i.e. of the elements from `begin_axis`. */
+ShapeTuple ShapeWithLength(const NDArray& arr, int64_t length, int begin_axis = 1) {
+  std::vector<int64_t> shape = {length};
+  shape.insert(shape.end(), arr->shape + begin_axis, arr->shape + arr->ndim);
+  return ShapeTuple(shape);
+}
+
+/*! \brief Check that the tensor has rows along axis 0 that are contiguous in memory. */
+void CheckRowTensor(const NDArray& arr, const char* name) {
+  CHECK_GE(arr->ndim, 1) << "ValueError: The " << name << " of a ragged batch should have at "
+                         << "least one dimension";
+  CHECK(arr.IsContiguous()) << "ValueError: The " << name
+                            << " of a ragged batch should be contiguous";
+}
+
+/*! \brief Copy the indptr of a ragged batch to the host. */
+std::vector<int32_t> IndptrToHost(const NDArray& indptr) {
+  CHECK(indptr->ndim == 1 && indptr->shape[0] >= 1 && indptr.DataType() == DataType::Int(32))
+      << "ValueError: The indptr of a ragged batch should be a 1-D int32 tensor of "
+      << "batch_size + 1 elements";
+  std::vector<int32_t> host(indptr->shape[0]);
+  indptr.CopyToBytes(host.data(), host.size() * sizeof(int32_t));
+  for (size_t i = 1; i < host.size(); ++i) {
+    CHECK_LE(host[i - 1], host[i]) << "ValueError: The indptr of a ragged batch should be "
+                                   << "non-decreasing";
+  }
+  return host;
+}
+
+/*! \brief Create the indptr of the lengths on the device. */
+NDArray IndptrFromLengths(const std::vector<int64_t>& lengths, Device device) {
+  std::vector<int32_t> host(lengths.size() + 1, 0);
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    host[i + 1] = host[i] + static_cast<int32_t>(lengths[i]);
+  }
+  NDArray indptr = NDArray::Empty({static_cast<int64_t>(host.size())}, DataType::Int(32), device);
+  indptr.CopyFromBytes(host.data(), host.size() * sizeof(int32_t));
+  return indptr;
+}
+
+/*!
+ * \brief Pack sequences of the same row shape into a ragged batch.
+ * \param seqs The sequences, each of shape (length_i, *row_shape).
+ * \return The values and the indptr of the batch.
+ */
+Array<NDArray> RaggedPack(Array<NDArray> seqs) {
+  CHECK(!seqs.empty()) << "ValueError: A ragged batch should have at least one sequence";
+  const NDArray& first = seqs[0];
+  CheckRowTensor(first, "sequence");
+  std::vector<int64_t> lengths;
+  int64_t total_length = 0;
+  for (const NDArray& seq : seqs) {
+    CheckRowTensor(seq, "sequence");
+    CHECK(seq->ndim == first->ndim && seq.DataType() == first.DataType() &&
+          std::equal(seq->shape + 1, seq->shape + seq->ndim, first->shape + 1))
+        << "ValueError: The sequences of a ragged batch should have the same dtype and row shape, "
+        << "but got " << seq.Shape() << " " << seq.DataType() << " and " << first.Shape() << " "
+        << first.DataType();
+    CHECK(seq->device.device_type == first->device.device_type &&
+          seq->device.device_id == first->device.device_id)
+        << "ValueError: The sequences of a ragged batch should be on the same device";
+    lengths.push_back(seq->shape[0]);
+    total_length += seq->shape[0];
+  }
+  NDArray values =
+      NDArray::Empty(ShapeWithLength(first, total_length), first->dtype, first->device);
+  int64_t row_bytes = RowBytes(first);
+  int64_t offset = 0;
+  for (const NDArray& seq : seqs) {
+    if (seq->shape[0] != 0) {
+      values.CreateView(seq.Shape(), seq->dtype, offset * row_bytes).CopyFrom(seq);
+      offset += seq->shape[0];
+    }
+  }
+  return {values, IndptrFromLengths(lengths, first->device)};
+}
+
+/*!
+ * \brief Unpack a ragged batch into views of its sequences.
+ * \param values The values of the batch.
+ * \param indptr The indptr of the batch.
+ * \return The sequences, which share the memory of the values.
+ */
+Array<NDArray> RaggedUnpack(NDArray values, NDArray indptr) {
+  CheckRowTensor(values, "values");
+  std::vector<int32_t> offsets = IndptrToHost(indptr);
+  CHECK_LE(offsets.back(), values->shape[0])
+      << "ValueError: The indptr of the ragged batch ends at " << offsets.back()
+      << ", beyond the " << values->shape[0] << " rows of the values";
+  int64_t row_bytes = RowBytes(values);
+  Array<NDArray> seqs;
+  seqs.reserve(offsets.size() - 1);
+  for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+    seqs.push_back(values.CreateView(ShapeWithLength(values, offsets[i + 1] - offsets[i]),
+                                     values->dtype, offsets[i] * row_bytes));
+  }
+  return seqs;
+}
+
+/*!
+ * \brief Pack the leading rows of each entry of a padded batch into a ragged batch.
+ * \param padded The padded batch, of shape (batch_size, max_length, *row_shape).
+ * \param lengths The length of each sequence.
+ * \return The values and the indptr of the batch.
+ */
+Array<NDArray> RaggedFromPadded(NDArray padded, ShapeTuple lengths) {
+  CHECK_GE(padded->ndim, 2) << "ValueError: The padded batch should have at least two dimensions";
+  CHECK(padded.IsContiguous()) << "ValueError: The padded batch should be contiguous";
+  CHECK_EQ(static_cast<int64_t>(lengths.size()), padded->shape[0])
+      << "ValueError: The padded batch has " << padded->shape[0] << " sequences, but got "
+      << lengths.size() << " lengths";
+  int64_t max_length = padded->shape[1];
+  int64_t row_bytes = RowBytes(padded, /*begin_axis=*/2);
+  int64_t total_length = 0;
+  for (int64_t length : lengths) {
+    CHECK(0 <= length && length <= max_length)
+        << "ValueError: The length " << length << " is out of the padded length " << max_length;
+    total_length += length;
+  }
+  NDArray values = NDArray::Empty(ShapeWithLength(padded, total_length, /*begin_axis=*/2),
+                                  padded->dtype, padded->device);
+  int64_t offset = 0;
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    if (lengths[i] == 0) continue;
+    ShapeTuple shape = ShapeWithLength(padded, lengths[i], /*begin_axis=*/2);
+    values.CreateView(shape, padded->dtype, offset * row_bytes)
+        .CopyFrom(padded.CreateView(shape, padded->dtype, i * max_length * row_bytes));
+    offset += lengths[i];
+  }
+  return {values, IndptrFromLengths({lengths.begin(), lengths.end()}, padded->device)};
+}
+
+/*!
+ * \brief Unpack a ragged batch into a zero-padded batch.
+ * \param values The values of the batch.
+ * \param indptr The indptr of the batch.
+ * \param max_length The padded length, which should be at least the longest sequence.
+ * \return The padded batch, of shape (batch_size, max_length, *row_shape).
+ */
+NDArray RaggedToPadded(NDArray values, NDArray indptr, int64_t max_length) {
+  Array<NDArray> seqs = RaggedUnpack(values, indptr);
+  std::vector<int64_t> shape = {static_cast<int64_t>(seqs.size()), max_length};
+  shape.insert(shape.end(), values->shape + 1, values->shape + values->ndim);
+  NDArray padded = NDArray::Empty(ShapeTuple(shape), values->dtype, values->device);
+  int64_t row_bytes = RowBytes(values);
+  std::vector<uint8_t> zeros(seqs.size() * max_length * row_bytes, 0);
+  padded.CopyFromBytes(zeros.data(), zeros.size());
+  for (size_t i = 0; i < seqs.size(); ++i) {
+    const NDArray& seq = seqs[i];
+    CHECK_LE(seq->shape[0], max_length)
+        << "ValueError: The sequence " << i << " of length " << seq->shape[0]
+        << " is longer than the padded length " << max_length;
+    if (seq->shape[0] == 0) continue;
+    padded.CreateView(seq.Shape(), values->dtype, i * max_length * row_bytes).CopyFrom(seq);
+  }
+  return padded;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.ragged_pack").set_body_typed(RaggedPack);
+TVM_REGISTER_GLOBAL("vm.builtin.ragged_unpack").set_body_typed(RaggedUnpack);
+TVM_REGISTER_GLOBAL("vm.builtin.ragged_from_padded").set_body_typed(RaggedFromPadded);
+TVM_REGISTER_GLOBAL("vm.builtin.ragged_to_padded").set_body_typed(RaggedToPadded);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
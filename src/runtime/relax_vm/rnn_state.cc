@@ -21,6 +21,7 @@
  * \brief Runtime RNN state object for space state models.
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -128,6 +129,10 @@ class RNNStateImpObj : public RNNStateObj {
    * The view is used to reuse the memory but with different shape.
    */
   NDArray history_slot_ids_view_;
+  /*! \brief The sequence slot ids last copied to device. */
+  std::vector<int32_t> seq_slot_ids_host_;
+  /*! \brief The history slot ids last copied to device. */
+  std::vector<int32_t> history_slot_ids_host_;
 
   /******************* Interaction Functions *******************/
 
@@ -200,6 +205,8 @@ class RNNStateImpObj : public RNNStateObj {
     for (int64_t slot_id = reserved_num_seqs_ - 1; slot_id >= 0; --slot_id) {
       free_slot_ids_.push_back(slot_id);
     }
+    seq_slot_ids_host_.clear();
+    history_slot_ids_host_.clear();
     dirty_aux_data_device_ = false;
   }
 
@@ -284,6 +291,24 @@ class RNNStateImpObj : public RNNStateObj {
     f_sets_[state_id](state, seq_slot_ids_view_, history_slot_ids_view_, data);
   }
 
+  NDArray GetStorage(int64_t layer_id, int64_t state_id) final {
+    CHECK(0 <= layer_id && layer_id < num_layers_)
+        << "The layer id " << layer_id << " is out of range [0, " << num_layers_ << ").";
+    CHECK(0 <= state_id && state_id < num_states_per_layer_)
+        << "The state id " << state_id << " is out of range [0, " << num_states_per_layer_
+        << ").";
+    return storages_[layer_id][state_id];
+  }
+
+  Array<NDArray> GetSlotIds() final {
+    // The auxiliary data structure on device must have been synchronized.
+    CHECK(!dirty_aux_data_device_)
+        << "The auxiliary arrays are not synchronized to device. Please call "
+           "`BeginForward` to synchronize before calling `GetSlotIds`.";
+    CHECK_GT(cur_batch_size_, 0) << "The curent batch size should be greater than 0.";
+    return {seq_slot_ids_view_, history_slot_ids_view_};
+  }
+
   NDArray DebugGet(int64_t layer_id, int64_t state_id, int64_t seq_id) {
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
@@ -344,13 +369,26 @@ class RNNStateImpObj : public RNNStateObj {
     int64_t child_slot_id = GetFreeSlot();
     seq_map_.insert({child_seq_id, Sequence::Fork(parent_it->second, child_slot_id)});
 
-    // Copy the parent state data to the child state data.
-    int64_t parent_slot_id = parent_it->second.seq_slot_id;
+    // Copy the parent state data to the child state data. Only the history slots which the
+    // parent can roll back to are copied, in at most two ranges as the history is a ring.
+    const Sequence& parent = parent_it->second;
+    int64_t parent_slot_id = parent.seq_slot_id;
+    int64_t num_history_slots = parent.available_history_num + 1;
+    int64_t begin_history_slot_id =
+        (parent.history_slot_id - parent.available_history_num + max_history_) % max_history_;
     for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
       for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
-        DLTensor copy_src = GetStatePtrBySeq(layer_id, state_id, parent_slot_id);
-        DLTensor copy_dst = GetStatePtrBySeq(layer_id, state_id, child_slot_id);
-        NDArray::CopyFromTo(&copy_src, &copy_dst);
+        int64_t history_slot_id = begin_history_slot_id;
+        for (int64_t num_copied = 0; num_copied < num_history_slots;) {
+          int64_t length = std::min(num_history_slots - num_copied, max_history_ - history_slot_id);
+          NDArray copy_src =
+              GetStateViewBySeqHistory(layer_id, state_id, parent_slot_id, history_slot_id, length);
+          NDArray copy_dst =
+              GetStateViewBySeqHistory(layer_id, state_id, child_slot_id, history_slot_id, length);
+          NDArray::CopyFromTo(copy_src.operator->(), copy_dst.operator->());
+          num_copied += length;
+          history_slot_id = 0;
+        }
       }
     }
     dirty_aux_data_device_ = true;
@@ -397,19 +435,18 @@ class RNNStateImpObj : public RNNStateObj {
     return _state;
   }
 
-  DLTensor GetStatePtrBySeq(int64_t layer_id, int64_t state_id, int64_t seq_slot_id) {
+  /*! \brief Get the view of `num_history_slots` history slots of a sequence from the given one. */
+  NDArray GetStateViewBySeqHistory(int64_t layer_id, int64_t state_id, int64_t seq_slot_id,
+                                   int64_t history_slot_id, int64_t num_history_slots) {
     NDArray state = storages_[layer_id][state_id];
     int64_t state_size = 1;
-    for (int64_t i = 1; i < state->ndim; ++i) {
+    for (int64_t i = 2; i < state->ndim; ++i) {
       state_size *= state->shape[i];
     }
-    int64_t elem_offset = seq_slot_id * state_size;
-    // Create a new DLTensor with the same shape and dtype as the state.
-    DLTensor _state = *(state.operator->());
-    _state.byte_offset = elem_offset * state->dtype.bits / 8;
-    _state.ndim = state->ndim - 1;
-    _state.shape = const_cast<int64_t*>(_state.shape + 1);
-    return _state;
+    int64_t elem_offset = (seq_slot_id * max_history_ + history_slot_id) * state_size;
+    std::vector<int64_t> shape{state->shape + 1, state->shape + state->ndim};
+    shape[0] = num_history_slots;
+    return state.CreateView(shape, state->dtype, elem_offset * state->dtype.bits / 8);
   }
 
   /*!
@@ -446,8 +483,16 @@ class RNNStateImpObj : public RNNStateObj {
     seq_slot_ids_view_ = seq_slot_ids_device_.CreateView({cur_batch_size_}, dtype_aux_);
     history_slot_ids_view_ = history_slot_ids_device_.CreateView({cur_batch_size_}, dtype_aux_);
 
-    fcopy_from_vec(seq_slot_ids_view_, seq_slot_ids);
-    fcopy_from_vec(history_slot_ids_view_, history_slot_ids);
+    // Only copy the arrays which changed since the last copy, e.g. a decode of the same batch
+    // after a forward only advances the history slot ids.
+    if (seq_slot_ids != seq_slot_ids_host_) {
+      fcopy_from_vec(seq_slot_ids_view_, seq_slot_ids);
+      seq_slot_ids_host_ = std::move(seq_slot_ids);
+    }
+    if (history_slot_ids != history_slot_ids_host_) {
+      fcopy_from_vec(history_slot_ids_view_, history_slot_ids);
+      history_slot_ids_host_ = std::move(history_slot_ids);
+    }
 
     // Reset the dirty flag to false.
     dirty_aux_data_device_ = false;
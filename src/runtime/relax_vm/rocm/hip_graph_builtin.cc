@@ -0,0 +1,263 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/rocm/hip_graph_builtin.cc
+ * \brief The HIP graph related builtin functions for Relax virtual machine, the counterpart of
+ * the CUDA graph builtins on ROCm.
+ */
+
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+#include "../../rocm/rocm_common.h"
+#include "../graph_capture.h"
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The maximum number of HIP graphs kept by each virtual machine, the least recently
+ * launched ones are evicted beyond it. Zero means unlimited.
+ */
+static std::atomic<int64_t> max_num_captured_hip_graphs{0};
+
+/*! \brief The captured state of a HIP graph */
+struct HIPGraphCapturedState {
+  ~HIPGraphCapturedState() {
+    if (exec) {
+      ROCM_CALL(hipGraphExecDestroy(exec));
+    }
+  }
+
+  /*!
+   * \brief Tuple of intemediate tensors in the capture func that will be used outside the
+   * capture func
+   */
+  ObjectRef states;
+  /*! \brief The instantiated hip graph */
+  hipGraphExec_t exec = nullptr;
+  /*! \brief The data pointers of the tensor arguments the graph was captured with */
+  std::vector<const void*> arg_pointers;
+  /*! \brief The position of the entry in the least recently used order */
+  std::list<GraphCaptureKey>::iterator lru_pos;
+};
+
+/*! \brief The VM extension of HIP graph. */
+class HIPGraphExtensionNode : public VMExtensionNode {
+ public:
+  TVM_DECLARE_FINAL_OBJECT_INFO(HIPGraphExtensionNode, VMExtensionNode);
+
+  /*!
+   * \brief Launch the hip graph if it has been cached, otherwise execute it in capture mode.
+   * When the tensor arguments moved to other addresses since the capture, the graph is captured
+   * again and the instantiated graph is updated in place with `hipGraphExecUpdate`.
+   * \param vm The virtual machine.
+   * \param capture_func The function of type (args...) -> Tuple[ObjectRef], where 'args' are the
+   * static arguments that are the same for all invocations of the capture function, the returned
+   * tuple contains the intermediate tensors that will be used outside the capture function.
+   * \param args The static arguments of the capture function
+   * \param entry_index The unique index of the capture function used for lookup.
+   * \return The return value of the capture function.
+   */
+  ObjectRef RunOrCapture(VirtualMachine* vm, const ObjectRef& capture_func, ObjectRef args,
+                         int64_t entry_index, Optional<ShapeTuple> shape_expr) {
+    Array<ObjectRef> tuple_args = Downcast<Array<ObjectRef>>(args);
+    int nargs = static_cast<int>(tuple_args.size());
+    std::vector<TVMValue> values(nargs);
+    std::vector<int> tcodes(nargs);
+    TVMArgsSetter setter(values.data(), tcodes.data());
+    for (int i = 0; i < nargs; ++i) {
+      ObjectRef arg = tuple_args[i];
+      setter(i, arg);
+    }
+    TVMArgs capture_args(values.data(), tcodes.data(), nargs);
+    std::vector<const void*> arg_pointers = GetGraphArgPointers(tuple_args);
+
+    GraphCaptureKey entry_key{entry_index, shape_expr};
+    if (auto it = capture_cache_.find(entry_key); it != capture_cache_.end()) {
+      HIPGraphCapturedState& entry = it->second;
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+      if (entry.arg_pointers != arg_pointers) {
+        hipGraph_t graph = Capture(vm, capture_func, capture_args, &entry.states);
+        if (!UpdateGraphExec(entry.exec, graph)) {
+          ROCM_CALL(hipGraphExecDestroy(entry.exec));
+          ROCM_CALL(hipGraphInstantiate(&entry.exec, graph, nullptr, nullptr, 0));
+        }
+        ROCM_CALL(hipGraphDestroy(graph));
+        entry.arg_pointers = std::move(arg_pointers);
+      }
+      ROCM_CALL(hipGraphLaunch(entry.exec, ROCMThreadEntry::ThreadLocal()->stream));
+      return entry.states;
+    }
+    EvictCapturedGraphs(max_num_captured_hip_graphs.load() - 1);
+
+    HIPGraphCapturedState entry;
+    TVMRetValue capture_func_rv;
+    // Run the function without HIP graph. This is a warm up step to do necessary initialization
+    // of the ROCm module such as loading module data.
+    vm->InvokeClosurePacked(capture_func, capture_args, &capture_func_rv);
+
+    hipGraph_t graph = Capture(vm, capture_func, capture_args, &entry.states);
+    entry.arg_pointers = std::move(arg_pointers);
+
+    lru_.push_front(entry_key);
+    entry.lru_pos = lru_.begin();
+    capture_cache_[entry_key] = entry;
+    ROCM_CALL(hipGraphInstantiate(&capture_cache_[entry_key].exec, graph, nullptr, nullptr, 0));
+    ROCM_CALL(hipGraphDestroy(graph));
+    return entry.states;
+  }
+
+  /*!
+   * \brief Get the cached allocation from the cache or run the allocation function.
+   * \param vm The virtual machine.
+   * \param alloc_func The function of type () -> ObjectRef, where the returned object is the
+   * tuple of allocated storage objects.
+   * \param entry_index The unique index of the allocation function used for lookup.
+   */
+  ObjectRef GetCachedAllocation(VirtualMachine* vm, const ObjectRef& alloc_func,
+                                int64_t entry_index) {
+    if (auto it = alloc_cache_.find(entry_index); it != alloc_cache_.end()) {
+      return it->second;
+    }
+    TVMRetValue alloc_func_rv;
+    vm->InvokeClosurePacked(alloc_func, TVMArgs(nullptr, nullptr, 0), &alloc_func_rv);
+    ObjectRef alloc_result = alloc_func_rv;
+    alloc_cache_[entry_index] = alloc_result;
+    return alloc_result;
+  }
+
+  /*!
+   * \brief Run the capture function on a new stream in capture mode.
+   * \return The captured graph, owned by the caller.
+   */
+  static hipGraph_t Capture(VirtualMachine* vm, const ObjectRef& capture_func, TVMArgs args,
+                            ObjectRef* states) {
+    hipStream_t capture_stream;
+    ROCM_CALL(hipStreamCreate(&capture_stream));
+    hipGraph_t graph;
+    std::swap(capture_stream, ROCMThreadEntry::ThreadLocal()->stream);
+    ROCM_CALL(hipStreamBeginCapture(ROCMThreadEntry::ThreadLocal()->stream,
+                                    hipStreamCaptureModeGlobal));
+
+    TVMRetValue capture_func_rv;
+    vm->InvokeClosurePacked(capture_func, args, &capture_func_rv);
+    *states = capture_func_rv;
+    ROCM_CALL(hipStreamEndCapture(ROCMThreadEntry::ThreadLocal()->stream, &graph));
+    std::swap(capture_stream, ROCMThreadEntry::ThreadLocal()->stream);
+    ROCM_CALL(hipStreamDestroy(capture_stream));
+    return graph;
+  }
+
+  /*!
+   * \brief Update the kernel parameters of an instantiated graph in place from a graph of the
+   * same topology.
+   * \return Whether the update succeeded. Otherwise the graph has to be instantiated again.
+   */
+  static bool UpdateGraphExec(hipGraphExec_t exec, hipGraph_t graph) {
+    hipGraphNode_t error_node;
+    hipGraphExecUpdateResult update_result;
+    hipError_t err = hipGraphExecUpdate(exec, graph, &error_node, &update_result);
+    if (err == hipErrorGraphExecUpdateFailure) {
+      // Clear the error so that it is not reported by the next HIP call.
+      (void)hipGetLastError();
+      return false;
+    }
+    ROCM_CALL(err);
+    return true;
+  }
+
+  /*!
+   * \brief Evict the least recently launched HIP graphs until at most `max_num_graphs` are kept.
+   * \param max_num_graphs The number of graphs to keep, negative for no limit.
+   */
+  void EvictCapturedGraphs(int64_t max_num_graphs) {
+    if (max_num_graphs < 0) {
+      return;
+    }
+    while (static_cast<int64_t>(capture_cache_.size()) > max_num_graphs) {
+      capture_cache_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  static constexpr const char* _type_key = "relax_vm.HIPGraphExtension";
+
+ private:
+  /*! \brief The cache of captured hip graphs, keyed as the cuda graphs. */
+  std::unordered_map<GraphCaptureKey, HIPGraphCapturedState, GraphCaptureKeyHash,
+                     GraphCaptureKeyEqual>
+      capture_cache_;
+  /*! \brief The keys of the captured graphs, from the most to the least recently launched */
+  std::list<GraphCaptureKey> lru_;
+  /*! \brief The cache of allocations, keyed by the unique index of the allocation function. */
+  std::unordered_map<int64_t, ObjectRef> alloc_cache_;
+};
+
+/*! Managed reference to HIPGraphExtensionNode */
+class HIPGraphExtension : public VMExtension {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(HIPGraphExtension, VMExtension, HIPGraphExtensionNode);
+  static HIPGraphExtension Create() {
+    auto data_ = make_object<HIPGraphExtensionNode>();
+    return HIPGraphExtension(std::move(data_));
+  }
+};
+
+TVM_REGISTER_GLOBAL("vm.builtin.hip_graph.run_or_capture")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK(args.size() == 5 || args.size() == 4);
+      VirtualMachine* vm = VirtualMachine::GetContextPtr(args[0]);
+      auto extension = vm->GetOrCreateExtension<HIPGraphExtension>();
+      ObjectRef capture_func = args[1];
+      ObjectRef func_args = args[2];
+      int64_t entry_index = args[3];
+      Optional<ShapeTuple> shape_expr = NullOpt;
+      if (args.size() == 5) {
+        shape_expr = args[4].AsObjectRef<ShapeTuple>();
+      }
+      *rv = extension->RunOrCapture(vm, capture_func, func_args, entry_index, shape_expr);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.hip_graph.set_max_num_captured_graphs")
+    .set_body_typed([](int64_t max_num_graphs) {
+      CHECK_GE(max_num_graphs, 0) << "ValueError: The maximum number of captured HIP graphs "
+                                  << "should be non-negative, but got " << max_num_graphs;
+      max_num_captured_hip_graphs = max_num_graphs;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.hip_graph.get_cached_alloc")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 3);
+      VirtualMachine* vm = VirtualMachine::GetContextPtr(args[0]);
+      auto extension = vm->GetOrCreateExtension<HIPGraphExtension>();
+      ObjectRef alloc_func = args[1];
+      int64_t entry_index = args[2];
+      *rv = extension->GetCachedAllocation(vm, alloc_func, entry_index);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/stream_builtin.cc
+ * \brief The builtin functions for running the kernels of a Relax function on multiple streams,
+ * emitted by the AssignStreams pass.
+ */
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The side streams of the VM. Stream 0 is the stream that is current when the function
+ * starts to use side streams, and the streams 1, 2, ... are created on first use and held until
+ * the VM is destructed.
+ */
+class StreamExtensionNode : public VMExtensionNode {
+ public:
+  TVM_DECLARE_FINAL_OBJECT_INFO(StreamExtensionNode, VMExtensionNode);
+
+  ~StreamExtensionNode() {
+    for (auto& [device_index, entry] : entries_) {
+      for (TVMStreamHandle stream : entry.streams) {
+        DeviceAPI::Get(entry.device)->FreeStream(entry.device, stream);
+      }
+    }
+  }
+
+  /*! \brief Make the stream of the given index the current stream of the device. */
+  void Switch(VirtualMachine* vm, int64_t device_index, int64_t stream_index) {
+    Entry& entry = GetEntry(vm, device_index);
+    if (stream_index != 0 && !entry.active) {
+      entry.base = DeviceAPI::Get(entry.device)->GetCurrentStream(entry.device);
+      entry.active = true;
+    }
+    DeviceAPI::Get(entry.device)->SetStream(entry.device, GetStream(&entry, stream_index));
+  }
+
+  /*! \brief Make the later work of stream `dst` wait for the work issued to stream `src`. */
+  void Sync(VirtualMachine* vm, int64_t device_index, int64_t src, int64_t dst) {
+    Entry& entry = GetEntry(vm, device_index);
+    DeviceAPI::Get(entry.device)
+        ->SyncStreamFromTo(entry.device, GetStream(&entry, src), GetStream(&entry, dst));
+  }
+
+  /*! \brief Make stream 0 wait for all the side streams, and make it the current stream again. */
+  void Join(VirtualMachine* vm, int64_t device_index) {
+    Entry& entry = GetEntry(vm, device_index);
+    if (!entry.active) {
+      return;
+    }
+    DeviceAPI* api = DeviceAPI::Get(entry.device);
+    for (TVMStreamHandle stream : entry.streams) {
+      api->SyncStreamFromTo(entry.device, stream, entry.base);
+    }
+    api->SetStream(entry.device, entry.base);
+    entry.active = false;
+  }
+
+  static constexpr const char* _type_key = "relax_vm.StreamExtension";
+
+ private:
+  struct Entry {
+    Device device;
+    /*! \brief The stream 0, valid when the side streams are in use. */
+    TVMStreamHandle base = nullptr;
+    /*! \brief Whether a side stream has been switched to since the last join. */
+    bool active = false;
+    /*! \brief The side streams, where `streams[i]` is the stream of index `i + 1`. */
+    std::vector<TVMStreamHandle> streams;
+  };
+
+  Entry& GetEntry(VirtualMachine* vm, int64_t device_index) {
+    ICHECK_GE(device_index, 0);
+    ICHECK_LT(device_index, static_cast<int64_t>(vm->devices.size()))
+        << "The device index " << device_index << " is out of range";
+    auto [it, inserted] = entries_.try_emplace(device_index);
+    if (inserted) {
+      it->second.device = vm->devices[device_index];
+    }
+    return it->second;
+  }
+
+  TVMStreamHandle GetStream(Entry* entry, int64_t stream_index) {
+    ICHECK_GE(stream_index, 0);
+    if (stream_index == 0) {
+      return entry->active ? entry->base
+                           : DeviceAPI::Get(entry->device)->GetCurrentStream(entry->device);
+    }
+    while (static_cast<int64_t>(entry->streams.size()) < stream_index) {
+      entry->streams.push_back(DeviceAPI::Get(entry->device)->CreateStream(entry->device));
+    }
+    return entry->streams[stream_index - 1];
+  }
+
+  std::unordered_map<int64_t, Entry> entries_;
+};
+
+/*! Managed reference to StreamExtensionNode */
+class StreamExtension : public VMExtension {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(StreamExtension, VMExtension, StreamExtensionNode);
+  static StreamExtension Create() {
+    auto data_ = make_object<StreamExtensionNode>();
+    return StreamExtension(std::move(data_));
+  }
+};
+
+TVM_REGISTER_GLOBAL("vm.builtin.stream_switch")
+    .set_body_typed([](void* vm_ptr, int64_t device_index, int64_t stream_index) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      vm->GetOrCreateExtension<StreamExtension>()->Switch(vm, device_index, stream_index);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.stream_sync")
+    .set_body_typed([](void* vm_ptr, int64_t device_index, int64_t src, int64_t dst) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      vm->GetOrCreateExtension<StreamExtension>()->Sync(vm, device_index, src, dst);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.stream_join").set_body_typed([](void* vm_ptr,
+                                                                 int64_t device_index) {
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  vm->GetOrCreateExtension<StreamExtension>()->Join(vm, device_index);
+});
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
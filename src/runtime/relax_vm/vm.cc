@@ -25,8 +25,19 @@
 #include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/profiling.h>
+#include <tvm/runtime/relax_vm/builtin.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <thread>
 
@@ -54,18 +65,103 @@ VMClosure::VMClosure(String func_name, PackedFunc impl) {
  */
 PackedFunc VMClosure::BindLastArgs(PackedFunc func, std::vector<TVMRetValue> last_args) {
   return PackedFunc([func, last_args](TVMArgs args, TVMRetValue* rv) {
-    std::vector<TVMValue> values(args.size() + last_args.size());
-    std::vector<int> tcodes(args.size() + last_args.size());
-    runtime::TVMArgsSetter setter(values.data(), tcodes.data());
-    std::copy(args.values, args.values + args.size(), values.data());
-    std::copy(args.type_codes, args.type_codes + args.size(), tcodes.data());
+    TVMArgsPack<> pack(args.size() + last_args.size());
+    runtime::TVMArgsSetter setter = pack.setter();
+    pack.CopyFrom(args, 0);
     for (size_t i = 0; i < last_args.size(); ++i) {
       setter(i + args.size(), last_args[i]);
     }
-    func.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), rv);
+    func.CallPacked(pack.args(), rv);
   });
 }
 
+//---------------------------------------------
+// VM Future object
+//---------------------------------------------
+TVM_REGISTER_OBJECT_TYPE(VMFutureObj);
+
+VMFutureObj::VMFutureObj() {
+#ifndef _WIN32
+  if (pipe(fds_) != 0) {
+    fds_[0] = fds_[1] = -1;
+  }
+#endif
+}
+
+VMFutureObj::~VMFutureObj() {
+#ifndef _WIN32
+  for (int fd : fds_) {
+    if (fd >= 0) close(fd);
+  }
+#endif
+}
+
+bool VMFutureObj::IsDone() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return done_;
+}
+
+bool VMFutureObj::Wait(int64_t timeout_ms) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (timeout_ms < 0) {
+    cv_.wait(lock, [this] { return done_; });
+    return true;
+  }
+  return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return done_; });
+}
+
+TVMRetValue VMFutureObj::Get() const {
+  Wait();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!error_.empty()) {
+    throw Error(error_);
+  }
+  return result_;
+}
+
+void VMFutureObj::OnDone(PackedFunc callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!done_) {
+      callback_ = std::move(callback);
+      return;
+    }
+  }
+  callback(GetRef<VMFuture>(this));
+}
+
+void VMFutureObj::Finish(TVMRetValue result, std::string error) {
+  PackedFunc callback;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK(!done_) << "The call of the future has already finished";
+    result_ = std::move(result);
+    error_ = std::move(error);
+    done_ = true;
+    callback = std::move(callback_);
+  }
+  cv_.notify_all();
+#ifndef _WIN32
+  if (fds_[1] >= 0) {
+    char byte = 0;
+    ssize_t written = write(fds_[1], &byte, 1);
+    (void)written;
+  }
+#endif
+  if (callback != nullptr) {
+    callback(GetRef<VMFuture>(this));
+  }
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.future_is_done").set_body_method<VMFuture>(&VMFutureObj::IsDone);
+TVM_REGISTER_GLOBAL("vm.builtin.future_wait").set_body_method<VMFuture>(&VMFutureObj::Wait);
+TVM_REGISTER_GLOBAL("vm.builtin.future_get").set_body_typed([](VMFuture future) {
+  return future->Get();
+});
+TVM_REGISTER_GLOBAL("vm.builtin.future_cancel").set_body_method<VMFuture>(&VMFutureObj::Cancel);
+TVM_REGISTER_GLOBAL("vm.builtin.future_on_done").set_body_method<VMFuture>(&VMFutureObj::OnDone);
+TVM_REGISTER_GLOBAL("vm.builtin.future_fd").set_body_method<VMFuture>(&VMFutureObj::fd);
+
 //-----------------------------------------------------------
 // Utility functions.
 //-----------------------------------------------------------
@@ -193,8 +289,73 @@ struct VMFrame {
   }
 };
 
+/*!
+ * \brief The execution state of the VM on one host thread.
+ *
+ * The executable, the constant pool and the function pool of a VM are only read during the
+ * execution, so the VM serves calls from several host threads at the same time, each running on
+ * its own context taken from a pool of the VM. Nested calls on the same thread, e.g. a builtin
+ * that invokes a closure, run on the context of the outer call.
+ */
+struct VMExecContext {
+  /*!
+   * \brief The current stack of call frames.
+   * \note: Use unique ptr to avoid re-allocation and copy when frames get resized.
+   */
+  std::vector<std::unique_ptr<VMFrame>> frames;
+  /*!
+   * \brief A free list of frame
+   */
+  std::vector<std::unique_ptr<VMFrame>> frame_free_list;
+  /*! \brief The virtual machine PC. */
+  Index pc{0};
+  /*! \brief The special return register. */
+  RegType return_value;
+  /*! \brief Whether the calls of the request are timed by the sampling profiler. */
+  bool sampled{false};
+  /*! \brief The flag of the cancellation of the request, if it is an async call. */
+  const std::atomic<bool>* cancelled{nullptr};
+  /*!
+   * \brief The value each cached structure check last validated, indexed by the check slot of
+   * the call, see VirtualMachineImpl::IsCachedCheck. It is kept across the calls which reuse the
+   * context, so a decode loop checks its parameters once.
+   */
+  std::vector<ObjectRef> checked_values;
+};
+
+/*!
+ * \brief An instruction decoded once at load time for the dispatch loop.
+ *
+ * The callee of a call is resolved from the function pool, and the arguments that do not
+ * depend on the registers (immediates, constants, functions and special registers) are
+ * written to a template of argument values once, so a call only copies the template and
+ * fills in the register arguments.
+ */
+struct DecodedInstr {
+  Opcode op;
+  /*! \brief The destination register of Call, the result of Ret or the condition of If. */
+  RegName reg = 0;
+  /*! \brief The pc offset of Goto, or the false offset of If. */
+  Index pc_offset = 0;
+  /*! \brief The index of the callee in the function pool. */
+  Index func_idx = 0;
+  /*! \brief The callee, when it is a PackedFunc, so that it is called directly. */
+  PackedFunc packed;
+  /*! \brief The number of arguments. */
+  int num_args = 0;
+  /*! \brief The offset of the argument template. */
+  Index args_begin = 0;
+  /*! \brief The range of the register arguments. */
+  Index reg_args_begin = 0, reg_args_end = 0;
+  /*! \brief The range of the registers released after the call, see ComputeRegisterKills. */
+  Index kills_begin = 0, kills_end = 0;
+  /*! \brief The slot of the cached structure check, see IsCachedCheck, or -1. */
+  Index check_slot = -1;
+};
+
 class VirtualMachineImpl : public VirtualMachine {
  public:
+  ~VirtualMachineImpl() { StopAsyncWorkers(); }
   //---------------------------------------------------
   // Public facing functions overloading
   //---------------------------------------------------
@@ -206,7 +367,17 @@ class VirtualMachineImpl : public VirtualMachine {
   }
   void InvokeClosurePacked(const ObjectRef& closure_or_packedfunc, TVMArgs args,
                            TVMRetValue* rv) final;
-  void SetInstrument(PackedFunc instrument) final { this->instrument_ = instrument; }
+  void SetInstrument(PackedFunc instrument) final {
+    if (instrument != nullptr && exec_ != nullptr) {
+      for (const VMFuncInfo& finfo : exec_->func_table) {
+        if (finfo.kind == VMFuncInfo::FuncKind::kVMTIRFunc) {
+          LOG(WARNING) << "The instrument only applies to the bytecode functions, and is not "
+                       << "called within the compiled function " << finfo.name;
+        }
+      }
+    }
+    this->instrument_ = instrument;
+  }
 
   //---------------------------------------------------
   // Functions in the vtable of Module
@@ -216,12 +387,19 @@ class VirtualMachineImpl : public VirtualMachine {
   void _InvokeClosure(TVMArgs args, TVMRetValue* rv);
   void _InvokeClosureStateful(std::string func_name);
   void _SetInstrument(TVMArgs args, TVMRetValue* rv);
+  void _EnableSamplingProfiler(int sample_interval);
+  std::string _GetSamplingReport();
   void _GetOutputArity(TVMArgs args, TVMRetValue* rv);
   void _GetOutput(TVMArgs args, TVMRetValue* rv);
   void _SetInputWithoutParamModule(TVMArgs args, TVMRetValue* rv);
   void _SetInputWithParamModule(TVMArgs args, TVMRetValue* rv);
   int _GetFunctionArity(std::string func_name);
   std::string _GetFunctionParamName(std::string func_name, int index);
+  void _InvokeClosureAsync(TVMArgs args, TVMRetValue* rv);
+  void _SetNumAsyncWorkers(int num_workers);
+  void _RecordShapeSignatures(bool enable);
+  Array<ShapeTuple> _GetShapeSignatures(std::string func_name);
+  void _SetShapeVariant(TVMArgs args, TVMRetValue* rv);
   PackedFunc _LookupFunction(const String& name);
 
   TVM_MODULE_VTABLE_BEGIN("relax.VirtualMachine");
@@ -230,6 +408,9 @@ class VirtualMachineImpl : public VirtualMachine {
   TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_closure", &VirtualMachineImpl::_InvokeClosure);
   TVM_MODULE_VTABLE_ENTRY("invoke_stateful", &VirtualMachineImpl::_InvokeClosureStateful);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_instrument", &VirtualMachineImpl::_SetInstrument);
+  TVM_MODULE_VTABLE_ENTRY("enable_sampling_profiler",
+                          &VirtualMachineImpl::_EnableSamplingProfiler);
+  TVM_MODULE_VTABLE_ENTRY("get_sampling_report", &VirtualMachineImpl::_GetSamplingReport);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output_arity", &VirtualMachineImpl::_GetOutputArity);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output", &VirtualMachineImpl::_GetOutput);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_input", &VirtualMachineImpl::_SetInputWithoutParamModule);
@@ -237,6 +418,11 @@ class VirtualMachineImpl : public VirtualMachine {
                                  &VirtualMachineImpl::_SetInputWithParamModule);
   TVM_MODULE_VTABLE_ENTRY("get_function_arity", &VirtualMachineImpl::_GetFunctionArity);
   TVM_MODULE_VTABLE_ENTRY("get_function_param_name", &VirtualMachineImpl::_GetFunctionParamName);
+  TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_closure_async", &VirtualMachineImpl::_InvokeClosureAsync);
+  TVM_MODULE_VTABLE_ENTRY("set_num_async_workers", &VirtualMachineImpl::_SetNumAsyncWorkers);
+  TVM_MODULE_VTABLE_ENTRY("record_shape_signatures", &VirtualMachineImpl::_RecordShapeSignatures);
+  TVM_MODULE_VTABLE_ENTRY("get_shape_signatures", &VirtualMachineImpl::_GetShapeSignatures);
+  TVM_MODULE_VTABLE_ENTRY_PACKED("set_shape_variant", &VirtualMachineImpl::_SetShapeVariant);
   TVM_MODULE_VTABLE_END_WITH_DEFAULT(&VirtualMachineImpl::_LookupFunction);
 
   //--------------------------------------------------
@@ -250,6 +436,21 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   Optional<VMClosure> GetClosureInternal(const String& func_name, bool allow_missing);
 
+  /*!
+   * \brief The shape signature of the arguments of a call, which is the number of dimensions
+   *  followed by the shape of each tensor argument, and -1 for each other argument.
+   */
+  static std::vector<int64_t> GetShapeSignature(TVMArgs args);
+
+  /*!
+   * \brief Record the shape signature of a call of a function, and find the variant of the
+   *  function specialized to the signature.
+   * \param func_name The name of the function.
+   * \param args The arguments of the call.
+   * \return The variant, or NullOpt if the function itself is called.
+   */
+  Optional<ObjectRef> LookupShapeVariant(const std::string& func_name, TVMArgs args);
+
   /*!
    * \brief Set inputs to a function.
    * \param func_name The function name.
@@ -306,6 +507,14 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   RegType InvokeBytecode(Index fidx, const std::vector<RegType>& args);
 
+  /*!
+   * \brief Invoke a closure on the async workers of the VM.
+   * \param closure_or_packed The closure to be invoked.
+   * \param args The arguments to the function.
+   * \return The future of the call.
+   */
+  VMFuture InvokeClosureAsync(ObjectRef closure_or_packed, std::vector<RegType> args);
+
  protected:
   /*!
    * \brief Get function by querying all of the current module's imports.
@@ -329,37 +538,112 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   class FrameGuard {
    public:
-    VirtualMachineImpl* vm;
-    explicit FrameGuard(VirtualMachineImpl* vm, std::unique_ptr<VMFrame> frame) : vm(vm) {
-      vm->frames_.emplace_back(std::move(frame));
+    VMExecContext* ctx;
+    explicit FrameGuard(VMExecContext* ctx, std::unique_ptr<VMFrame> frame) : ctx(ctx) {
+      ctx->frames.emplace_back(std::move(frame));
     }
     ~FrameGuard() {
-      ICHECK_GT(vm->frames_.size(), 0);
-      vm->pc_ = vm->frames_.back()->return_pc;
-      vm->frames_.back()->Clear();
-      vm->frame_free_list_.emplace_back(std::move(vm->frames_.back()));
-      vm->frames_.pop_back();
+      ICHECK_GT(ctx->frames.size(), 0);
+      ctx->pc = ctx->frames.back()->return_pc;
+      ctx->frames.back()->Clear();
+      ctx->frame_free_list.emplace_back(std::move(ctx->frames.back()));
+      ctx->frames.pop_back();
+    }
+  };
+
+  /*! \brief The execution contexts the current thread runs on, innermost first. */
+  struct ActiveExecContext {
+    const VirtualMachineImpl* vm;
+    VMExecContext* ctx;
+    ActiveExecContext* prev;
+  };
+  static ActiveExecContext*& ActiveExecContexts() {
+    static thread_local ActiveExecContext* active = nullptr;
+    return active;
+  }
+  /*! \brief The flag of the cancellation of the async call the current thread runs. */
+  static const std::atomic<bool>*& AsyncCancelFlag() {
+    static thread_local const std::atomic<bool>* cancelled = nullptr;
+    return cancelled;
+  }
+
+  /*!
+   * \brief A RAII wrapper that provides the execution context of the current thread. A thread
+   * that is not running in the VM yet takes a context from the pool, and returns it at the end.
+   */
+  class ExecContextGuard {
+   public:
+    VMExecContext* ctx = nullptr;
+    explicit ExecContextGuard(VirtualMachineImpl* vm) {
+      for (ActiveExecContext* it = ActiveExecContexts(); it != nullptr; it = it->prev) {
+        if (it->vm == vm) {
+          ctx = it->ctx;
+          return;
+        }
+      }
+      vm_ = vm;
+      owned_ = vm->AcquireExecContext();
+      ctx = owned_.get();
+      ctx->cancelled = AsyncCancelFlag();
+      entry_ = ActiveExecContext{vm, ctx, ActiveExecContexts()};
+      ActiveExecContexts() = &entry_;
+    }
+    /*! \brief Whether the guard took the context, i.e. the call comes from outside the VM. */
+    bool owns() const { return owned_ != nullptr; }
+    ExecContextGuard(const ExecContextGuard&) = delete;
+    ExecContextGuard& operator=(const ExecContextGuard&) = delete;
+    ~ExecContextGuard() {
+      if (owned_ != nullptr) {
+        ActiveExecContexts() = entry_.prev;
+        vm_->ReleaseExecContext(std::move(owned_));
+      }
     }
+
+   private:
+    VirtualMachineImpl* vm_ = nullptr;
+    std::unique_ptr<VMExecContext> owned_;
+    ActiveExecContext entry_;
   };
+
+  /*! \brief Take an execution context from the pool, or create one if the pool is empty. */
+  std::unique_ptr<VMExecContext> AcquireExecContext() {
+    std::lock_guard<std::mutex> lock(exec_context_mutex_);
+    if (exec_context_pool_.empty()) {
+      return std::make_unique<VMExecContext>();
+    }
+    std::unique_ptr<VMExecContext> ctx = std::move(exec_context_pool_.back());
+    exec_context_pool_.pop_back();
+    return ctx;
+  }
+
+  /*! \brief Return an execution context to the pool. */
+  void ReleaseExecContext(std::unique_ptr<VMExecContext> ctx) {
+    ctx->return_value = nullptr;
+    ctx->sampled = false;
+    ctx->cancelled = nullptr;
+    std::lock_guard<std::mutex> lock(exec_context_mutex_);
+    exec_context_pool_.emplace_back(std::move(ctx));
+  }
   //-------------------------------------------------
   // Instruction interpretations.
   //-------------------------------------------------
   /*!
    * \brief Push a call frame onto the call stack.
+   * \param ctx The execution context.
    * \param ret_pc The program counter to return to.
    * \param vm_func The function to be pushed to the call stack.
    * \return A RAII wrapper that pops the frame when going out of scope.
    */
-  FrameGuard PushFrame(Index ret_pc, const VMFuncInfo& vm_func) {
+  FrameGuard PushFrame(VMExecContext* ctx, Index ret_pc, const VMFuncInfo& vm_func) {
     std::unique_ptr<VMFrame> new_frame;
-    if (!frame_free_list_.empty()) {
-      new_frame = std::move(frame_free_list_.back());
-      frame_free_list_.pop_back();
+    if (!ctx->frame_free_list.empty()) {
+      new_frame = std::move(ctx->frame_free_list.back());
+      ctx->frame_free_list.pop_back();
       new_frame->ResetForRecycle(ret_pc, vm_func.register_file_size);
     } else {
       new_frame = std::make_unique<VMFrame>(ret_pc, vm_func.register_file_size);
     }
-    return FrameGuard(this, std::move(new_frame));
+    return FrameGuard(ctx, std::move(new_frame));
   }
   /*!
    * \brief Write to a VM register.
@@ -393,15 +677,103 @@ class VirtualMachineImpl : public VirtualMachine {
     }
     return ret;
   }
+  /*! \brief Stop the request if it is an async call whose cancellation was requested. */
+  TVM_ALWAYS_INLINE void CheckCancelled(VMExecContext* ctx) {
+    if (ctx->cancelled != nullptr && ctx->cancelled->load(std::memory_order_relaxed)) {
+      LOG(FATAL) << "The async call of the VM is cancelled";
+    }
+  }
+  //-------------------------------------------------
+  // Async workers.
+  //-------------------------------------------------
+  /*! \brief A call queued for the async workers. */
+  struct AsyncTask {
+    ObjectRef closure_or_packed;
+    std::vector<RegType> args;
+    VMFuture future;
+  };
+  /*! \brief Start the async workers if they are not running. */
+  void StartAsyncWorkers();
+  /*! \brief Stop the async workers, finishing the queued calls with an error. */
+  void StopAsyncWorkers();
+  /*! \brief The loop of an async worker. */
+  void AsyncWorkerLoop();
+  /*! \brief Run a call on the current async worker and finish its future. */
+  void RunAsyncTask(AsyncTask* task);
+
   /*!
    * \brief Run call instruction.
+   * \param ctx The execution context.
    * \param curr_frame The current frame.
    * \param inst The call instruction.
    */
-  virtual void RunInstrCall(VMFrame* curr_frame, Instruction inst);
+  virtual void RunInstrCall(VMExecContext* ctx, VMFrame* curr_frame, Instruction inst);
+
+  /*!
+   * \brief Run VM dispatch loop.
+   * \param ctx The execution context.
+   */
+  void RunLoop(VMExecContext* ctx);
+
+  /*!
+   * \brief Whether to run the pre-decoded dispatch loop. Instrumentation keeps the generic
+   * path that goes through RunInstrCall.
+   */
+  virtual bool UseDecodedDispatch() const { return instrument_ == nullptr; }
+
+  /*! \brief Decode the instructions of the executable into decoded_instrs_. */
+  void DecodeInstructions();
+
+  /*!
+   * \brief Whether a call is a structure check whose result only depends on its first argument,
+   *  which is immutable, so that it is skipped when the value is the one it last validated.
+   *
+   * These are the checks of the tensor, shape and tuple information, and the match_shape of a
+   * value against constants only, which neither reads nor writes the shape heap. The check
+   * keeps the value it validated alive, so that another object cannot take its address.
+   */
+  bool IsCachedCheck(const Instruction& instr);
+
+  /*! \brief Run the dispatch loop over the pre-decoded instructions. */
+  void RunDecodedLoop(VMExecContext* ctx);
+
+  /*!
+   * \brief Compute, from the liveness of the registers of each bytecode function, the
+   *  registers whose value is no longer needed after each call, into decoded_kills_.
+   *
+   * A call drops the registers it reads or writes that are dead after it, so that the
+   * tensors they hold return to the allocator at their last use, instead of when the frame
+   * is popped. Between `vm.builtin.stream_switch` and `vm.builtin.stream_join`, a kernel on
+   * a side stream may still use the released tensor, so the release waits until the join.
+   */
+  void ComputeRegisterKills();
+
+  /*!
+   * \brief Compute the register kills of one bytecode function.
+   * \param info The function.
+   * \param kills The registers released after each instruction, indexed by pc.
+   */
+  void ComputeFuncRegisterKills(const VMFuncInfo& info, std::vector<std::vector<RegName>>* kills);
+
+  /*!
+   * \brief Release the registers that are dead after a call.
+   * \param frame The current frame.
+   * \param instr The call instruction.
+   */
+  TVM_ALWAYS_INLINE void ReleaseDeadRegisters(VMFrame* frame, const DecodedInstr& instr) {
+    for (Index i = instr.kills_begin; i < instr.kills_end; ++i) {
+      frame->register_file[decoded_kills_[i]] = nullptr;
+    }
+  }
 
-  /*! \brief Run VM dispatch loop. */
-  void RunLoop();
+  /*!
+   * \brief Run a pre-decoded call instruction.
+   * \param ctx The execution context.
+   * \param curr_frame The current frame.
+   * \param instr The call instruction.
+   */
+  TVM_ALWAYS_INLINE void RunDecodedCall(VMExecContext* ctx, VMFrame* curr_frame,
+                                        const DecodedInstr& instr);
 
   /*!
    * \brief Retrieve the name of the function identified by the given index.
@@ -433,7 +805,8 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   std::vector<TVMRetValue> func_pool_;
   //--------------------------------------------------------
-  // Executor interface support
+  // Executor interface support. These states are set by the stateful interface, which is
+  // not meant to be used from several threads at the same time.
   //--------------------------------------------------------
   /*! \brief The function name to input register mapping. */
   std::unordered_map<std::string, std::vector<RegType>> inputs_;
@@ -444,22 +817,51 @@ class VirtualMachineImpl : public VirtualMachine {
   //------------------------------------------------------------
   // VM Instruction execution.
   //------------------------------------------------------------
-  /*!
-   * \brief The current stack of call frames.
-   * \note: Use unique ptr to avoid re-allocation and copy when frames_ get resized.
-   */
-  std::vector<std::unique_ptr<VMFrame>> frames_;
-  /*!
-   * \brief A free list of frame
-   */
-  std::vector<std::unique_ptr<VMFrame>> frame_free_list_;
-
-  /*! \brief The virtual machine PC. */
-  Index pc_{0};
-  /*! \brief The special return register. */
-  RegType return_value_;
+  /*! \brief The execution contexts that are not in use by any thread. */
+  std::vector<std::unique_ptr<VMExecContext>> exec_context_pool_;
+  /*! \brief The mutex that guards the pool of execution contexts. */
+  std::mutex exec_context_mutex_;
   /*!\ brief instrument function. */
   PackedFunc instrument_ = nullptr;
+  //------------------------------------------------------------
+  // The shape signatures of the calls of the functions, and the variants of the functions
+  // specialized to some of them, see `record_shape_signatures` and `set_shape_variant`.
+  //------------------------------------------------------------
+  /*! \brief The maximum number of distinct signatures recorded per function. */
+  static constexpr size_t kMaxShapeSignatures = 1024;
+  std::atomic<bool> record_shape_signatures_{false};
+  /*! \brief Whether any function has a variant, so that the calls skip the lookup otherwise. */
+  std::atomic<bool> has_shape_variants_{false};
+  std::mutex shape_variant_mutex_;
+  /*! \brief The number of calls of each signature, per function name. */
+  std::unordered_map<std::string, std::map<std::vector<int64_t>, int64_t>> shape_signatures_;
+  /*! \brief The variant, a closure or a PackedFunc, of each signature, per function name. */
+  std::unordered_map<std::string, std::map<std::vector<int64_t>, ObjectRef>> shape_variants_;
+  //------------------------------------------------------------
+  // The async workers, which run the calls of `invoke_closure_async`.
+  //------------------------------------------------------------
+  /*! \brief The number of async workers, started at the first async call. */
+  int num_async_workers_ = 1;
+  std::vector<std::thread> async_workers_;
+  std::deque<AsyncTask> async_tasks_;
+  bool async_stopped_ = false;
+  std::mutex async_mutex_;
+  std::condition_variable async_cv_;
+  /*! \brief The sampling profiler of the requests, whose call sites are the function table. */
+  std::unique_ptr<profiling::SamplingProfiler> sampler_;
+  //------------------------------------------------------------
+  // Pre-decoded instructions, indexed by pc.
+  //------------------------------------------------------------
+  std::vector<DecodedInstr> decoded_instrs_;
+  /*! \brief The argument templates of the decoded calls. */
+  std::vector<TVMValue> decoded_arg_values_;
+  std::vector<int> decoded_arg_tcodes_;
+  /*! \brief The (argument index, register) pairs of the decoded calls. */
+  std::vector<std::pair<int, RegName>> decoded_reg_args_;
+  /*! \brief The registers released after the decoded calls. */
+  std::vector<RegName> decoded_kills_;
+  /*! \brief The number of slots of the cached structure checks. */
+  Index num_check_slots_ = 0;
 };
 
 void VirtualMachineImpl::LoadExecutable(ObjectPtr<Executable> exec) {
@@ -489,6 +891,8 @@ void VirtualMachineImpl::Init(const std::vector<Device>& devices,
   }
   // Setup function sections.
   this->InitFuncPool();
+  this->DecodeInstructions();
+  this->ComputeRegisterKills();
 }
 
 VMFuncInfo VirtualMachineImpl::LookupVMFuncInfo(const std::string& func_name) {
@@ -544,18 +948,17 @@ void VirtualMachineImpl::InvokeClosurePacked(const ObjectRef& closure_or_packedf
   auto* clo = closure_or_packedfunc.as<VMClosureObj>();
   ICHECK(clo != nullptr) << "Function expects a closure or PackedFunc ";
 
-  std::vector<TVMValue> values(args.size() + 1);
-  std::vector<int> tcodes(args.size() + 1);
-  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
+  TVMArgsPack<> pack(args.size() + 1);
   // per convention, ctx ptr must be VirtualMachine* casted to void.
   // this and VirtualMachine* may or maynot be the same
   // do first cast to VirtualMachine* then to void*
-  setter(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
-  std::copy(args.values, args.values + args.size(), values.begin() + 1);
-  std::copy(args.type_codes, args.type_codes + args.size(), tcodes.begin() + 1);
+  pack.setter()(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
+  pack.CopyFrom(args, 1);
   {
-    NVTXScopedRange scope("RelaxVM: " + clo->func_name);
-    clo->impl.CallPacked(TVMArgs(values.data(), tcodes.data(), args.size() + 1), rv);
+    // Check the flag first, so that the name of the range is not built when it is off.
+    std::optional<NVTXScopedRange> scope;
+    if (NVTXScopedRange::Enabled()) scope.emplace("RelaxVM: " + clo->func_name);
+    clo->impl.CallPacked(pack.args(), rv);
   }
 }
 
@@ -566,9 +969,8 @@ RegType VirtualMachineImpl::InvokeClosureInternal(const ObjectRef& closure_or_pa
   auto* packed = closure_or_packed.as<PackedFunc::ContainerType>();
   auto* clo = closure_or_packed.as<VMClosureObj>();
   int clo_offset = clo != nullptr ? 1 : 0;
-  std::vector<TVMValue> values(args.size() + clo_offset);
-  std::vector<int> tcodes(args.size() + clo_offset);
-  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
+  TVMArgsPack<> pack(args.size() + clo_offset);
+  runtime::TVMArgsSetter setter = pack.setter();
 
   if (clo != nullptr) {
     setter(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
@@ -578,10 +980,10 @@ RegType VirtualMachineImpl::InvokeClosureInternal(const ObjectRef& closure_or_pa
   }
 
   if (packed != nullptr) {
-    packed->CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &ret);
+    packed->CallPacked(pack.args(), &ret);
   } else {
     ICHECK(clo != nullptr);
-    clo->impl.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &ret);
+    clo->impl.CallPacked(pack.args(), &ret);
   }
   return ret;
 }
@@ -638,14 +1040,45 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
     PackedFunc tir_func = GetFuncFromImports("__vmtir__" + finfo.name);
     ICHECK(tir_func != nullptr) << "Cannot find underlying compiled tir function of VMTIRFunc "
                                 << finfo.name;
-    auto impl = PackedFunc([this, finfo, tir_func](TVMArgs args, TVMRetValue* rv) {
+    // The register files released by finished calls, reused by later calls instead of
+    // allocating a new one per call. Recursive and concurrent calls take a fresh one when the
+    // pool is empty.
+    struct RegFilePool {
+      std::mutex mutex;
+      std::vector<std::vector<TVMRetValue>> reg_files;
+    };
+    auto reg_file_pool = std::make_shared<RegFilePool>();
+    auto impl = PackedFunc([this, finfo, tir_func, reg_file_pool](TVMArgs args, TVMRetValue* rv) {
       // Per convention, ctx ptr is a VirtualMachine*
       VirtualMachine* ctx_ptr = static_cast<VirtualMachine*>(args[0].operator void*());
       ICHECK(ctx_ptr == this);
       ICHECK_EQ(args.size() - 1, finfo.num_args)
           << "Function " << finfo.name << " expects " << finfo.num_args << " arguments";
       ICHECK_GE(finfo.register_file_size, finfo.num_args + 1);
-      std::vector<TVMRetValue> reg_file(finfo.register_file_size);
+      std::vector<TVMRetValue> reg_file;
+      {
+        std::lock_guard<std::mutex> lock(reg_file_pool->mutex);
+        if (!reg_file_pool->reg_files.empty()) {
+          reg_file = std::move(reg_file_pool->reg_files.back());
+          reg_file_pool->reg_files.pop_back();
+        }
+      }
+      if (reg_file.empty()) {
+        reg_file.resize(finfo.register_file_size);
+      }
+      // Release the values held by the registers and return the register file to the pool,
+      // also when the function throws.
+      struct RegFileGuard {
+        std::vector<TVMRetValue>* reg_file;
+        RegFilePool* pool;
+        ~RegFileGuard() {
+          for (TVMRetValue& reg : *reg_file) {
+            reg = nullptr;
+          }
+          std::lock_guard<std::mutex> lock(pool->mutex);
+          pool->reg_files.push_back(std::move(*reg_file));
+        }
+      } guard{&reg_file, reg_file_pool.get()};
       for (int64_t i = 0; i < finfo.num_args; ++i) {
         reg_file[i] = args[i + 1];
       }
@@ -655,7 +1088,7 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
       tir_func(static_cast<void*>(ctx_ptr), reg_anylist_handle, const_anylist_handle,
                func_anylist_handle);
       // Return value always stored after inputs.
-      *rv = reg_file[finfo.num_args];
+      *rv = std::move(reg_file[finfo.num_args]);
     });
     return VMClosure(func_name, impl);
   }
@@ -668,13 +1101,24 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
   const VMFuncInfo& gfunc = exec_->func_table[gf_idx];
   ICHECK(gfunc.kind == VMFuncInfo::FuncKind::kVMFunc);
 
+  ExecContextGuard context_guard(this);
+  VMExecContext* ctx = context_guard.ctx;
   // Get the curr instr which might be a potential caller.
-  Instruction curr_instr = exec_->GetInstruction(pc_);
-  auto guard = PushFrame(this->pc_, gfunc);
+  Opcode caller_op;
+  RegName caller_dst;
+  if (static_cast<size_t>(ctx->pc) < decoded_instrs_.size()) {
+    caller_op = decoded_instrs_[ctx->pc].op;
+    caller_dst = decoded_instrs_[ctx->pc].reg;
+  } else {
+    Instruction curr_instr = exec_->GetInstruction(ctx->pc);
+    caller_op = curr_instr.op;
+    caller_dst = curr_instr.dst;
+  }
+  auto guard = PushFrame(ctx, ctx->pc, gfunc);
   // Get new frame and set the caller info.
-  VMFrame* curr_frame = frames_.back().get();
-  if (curr_instr.op == Opcode::Call) {
-    curr_frame->caller_return_register = curr_instr.dst;
+  VMFrame* curr_frame = ctx->frames.back().get();
+  if (caller_op == Opcode::Call) {
+    curr_frame->caller_return_register = caller_dst;
   }
 
   // load arguments to the register file
@@ -682,12 +1126,111 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
       << "ValueError: Invoking function " << gfunc.name << " requires " << gfunc.num_args
       << " inputs but only " << args.size() << " inputs are provided.";
   for (size_t i = 0; i < args.size(); ++i) {
-    WriteRegister(frames_.back().get(), i, args[i]);
+    WriteRegister(curr_frame, i, args[i]);
   }
   // set program counter
-  pc_ = gfunc.start_instr;
-  RunLoop();
-  return return_value_;
+  ctx->pc = gfunc.start_instr;
+  // A call from outside the VM is a request of the sampling profiler.
+  bool sampled = context_guard.owns() && sampler_ != nullptr && sampler_->StartRequest();
+  if (sampled) ctx->sampled = true;
+  RunLoop(ctx);
+  if (sampled) {
+    ctx->sampled = false;
+    sampler_->StopRequest();
+  }
+  return ctx->return_value;
+}
+
+//--------------------------------------------------------------------
+// Async calls.
+//--------------------------------------------------------------------
+VMFuture VirtualMachineImpl::InvokeClosureAsync(ObjectRef closure_or_packed,
+                                                std::vector<RegType> args) {
+  VMFuture future(make_object<VMFutureObj>());
+  StartAsyncWorkers();
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    async_tasks_.push_back(AsyncTask{std::move(closure_or_packed), std::move(args), future});
+  }
+  async_cv_.notify_one();
+  return future;
+}
+
+void VirtualMachineImpl::StartAsyncWorkers() {
+  std::lock_guard<std::mutex> lock(async_mutex_);
+  if (!async_workers_.empty()) return;
+  async_stopped_ = false;
+  for (int i = 0; i < num_async_workers_; ++i) {
+    async_workers_.emplace_back([this] { this->AsyncWorkerLoop(); });
+  }
+}
+
+void VirtualMachineImpl::StopAsyncWorkers() {
+  std::vector<std::thread> workers;
+  std::deque<AsyncTask> tasks;
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    async_stopped_ = true;
+    workers.swap(async_workers_);
+    tasks.swap(async_tasks_);
+  }
+  async_cv_.notify_all();
+  for (AsyncTask& task : tasks) {
+    task.future->Finish(TVMRetValue(), "The VM is stopped before the async call runs");
+  }
+  for (std::thread& worker : workers) {
+    // The callback of a call may release the VM on its worker.
+    if (worker.get_id() == std::this_thread::get_id()) {
+      worker.detach();
+    } else {
+      worker.join();
+    }
+  }
+}
+
+void VirtualMachineImpl::AsyncWorkerLoop() {
+  while (true) {
+    AsyncTask task;
+    {
+      std::unique_lock<std::mutex> lock(async_mutex_);
+      async_cv_.wait(lock, [this] { return async_stopped_ || !async_tasks_.empty(); });
+      if (async_stopped_) return;
+      task = std::move(async_tasks_.front());
+      async_tasks_.pop_front();
+    }
+    RunAsyncTask(&task);
+  }
+}
+
+void VirtualMachineImpl::RunAsyncTask(AsyncTask* task) {
+  VMFutureObj* future = task->future.operator->();
+  if (future->cancelled()->load(std::memory_order_relaxed)) {
+    future->Finish(TVMRetValue(), "The async call of the VM is cancelled");
+    return;
+  }
+  TVMRetValue result;
+  std::string error;
+  AsyncCancelFlag() = future->cancelled();
+  try {
+    result = InvokeClosureInternal(task->closure_or_packed, task->args);
+    task->args.clear();
+    // The kernels are launched on the streams of the worker without waiting for them, and the
+    // call finishes once they complete.
+    for (const Device& dev : devices) {
+      if (dev.device_type != kDLCPU) {
+        DeviceAPI* api = DeviceAPI::Get(dev);
+        api->StreamSync(dev, api->GetCurrentStream(dev));
+      }
+    }
+  } catch (const std::exception& e) {
+    result = nullptr;
+    error = e.what();
+  }
+  AsyncCancelFlag() = nullptr;
+  // Drop the references of the call before the callback, which may release the VM.
+  task->closure_or_packed = ObjectRef();
+  VMFuture keep_alive = std::move(task->future);
+  future->Finish(std::move(result), std::move(error));
 }
 
 void VirtualMachineImpl::InitFuncPool() {
@@ -696,8 +1239,14 @@ void VirtualMachineImpl::InitFuncPool() {
   for (size_t func_index = 0; func_index < exec_->func_table.size(); ++func_index) {
     const VMFuncInfo& info = exec_->func_table[func_index];
     if (info.kind == VMFuncInfo::FuncKind::kPackedFunc) {
-      // only look through imports first
-      PackedFunc func = GetFuncFromImports(info.name);
+      // only look through imports first. The arguments of the kernels are
+      // derived from the parameters of the VM functions, which are checked on
+      // entry, so prefer the entry of the kernel that skips the argument checks,
+      // if it was emitted.
+      PackedFunc func = GetFuncFromImports(info.name + symbol::tvm_unchecked_suffix);
+      if (!func.defined()) {
+        func = GetFuncFromImports(info.name);
+      }
       if (!func.defined()) {
         const PackedFunc* p_func = Registry::Get(info.name);
         if (p_func != nullptr) func = *(p_func);
@@ -717,8 +1266,8 @@ void VirtualMachineImpl::InitFuncPool() {
   }
 }
 
-void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
-  DLOG(INFO) << "\n  pc = " << pc_ << ", execute: " << GetFuncName(instr.func_idx);
+void VirtualMachineImpl::RunInstrCall(VMExecContext* ctx, VMFrame* curr_frame, Instruction instr) {
+  DLOG(INFO) << "\n  pc = " << ctx->pc << ", execute: " << GetFuncName(instr.func_idx);
   int args_begin_offset = instrument_ != nullptr ? 4 : 0;
   // Use the call arg stack from the current frame to increase reuse
   // and avoid re-allocation
@@ -763,6 +1312,16 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
 
   ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
 
+  // The calls of bytecode functions are not timed, as the calls they make are.
+  bool timed = ctx->sampled && sampler_ != nullptr &&
+               exec_->func_table[instr.func_idx].kind != VMFuncInfo::FuncKind::kVMFunc;
+  // The calls of bytecode functions get their ranges in InvokeClosurePacked.
+  std::optional<NVTXScopedRange> nvtx_scope;
+  if (NVTXScopedRange::Enabled() &&
+      exec_->func_table[instr.func_idx].kind != VMFuncInfo::FuncKind::kVMFunc) {
+    nvtx_scope.emplace(GetFuncName(instr.func_idx));
+  }
+  if (timed) sampler_->StartCall(instr.func_idx);
   if (instrument_ == nullptr) {
     this->InvokeClosurePacked(func_pool_[instr.func_idx], args, &ret);
   } else {
@@ -793,58 +1352,473 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
       instrument_.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &rv);
     }
   }
+  if (timed) sampler_->StopCall();
+  nvtx_scope.reset();
 
   // save the return value to the register
   // saving to special register is a NOP
   if (instr.dst < Instruction::kBeginSpecialReg) {
     WriteRegister(curr_frame, instr.dst, ret);
   }
+  ReleaseDeadRegisters(curr_frame, decoded_instrs_[ctx->pc]);
   // increment pc
-  pc_++;
+  ctx->pc++;
 }
 
-void VirtualMachineImpl::RunLoop() {
-  VMFrame* curr_frame = frames_.back().get();
+void VirtualMachineImpl::RunLoop(VMExecContext* ctx) {
+  if (UseDecodedDispatch() && !ctx->sampled && !decoded_instrs_.empty()) {
+    RunDecodedLoop(ctx);
+    return;
+  }
+  VMFrame* curr_frame = ctx->frames.back().get();
 
   while (true) {
-    ICHECK_LT(static_cast<size_t>(pc_), exec_->instr_offset.size()) << "run into invalid section";
-    Instruction instr = exec_->GetInstruction(pc_);
+    ICHECK_LT(static_cast<size_t>(ctx->pc), exec_->instr_offset.size())
+        << "run into invalid section";
+    Instruction instr = exec_->GetInstruction(ctx->pc);
     switch (instr.op) {
       case Opcode::Call: {
-        this->RunInstrCall(curr_frame, instr);
+        CheckCancelled(ctx);
+        this->RunInstrCall(ctx, curr_frame, instr);
         break;
       }
       case Opcode::Ret: {
         // If we have hit the point from which we started
         // running, we should return to the caller breaking
         // the dispatch loop.
-        return_value_ = ReadRegister(curr_frame, instr.result);
+        ctx->return_value = ReadRegister(curr_frame, instr.result);
         RegName caller_return_register = curr_frame->caller_return_register;
-        if (frames_.size() <= 1) {
+        if (ctx->frames.size() <= 1) {
           // directly return if no other frame in the call stack.
         } else {
           // return from a local call.
           // Update the current frame to be the parent frame.
-          VMFrame* parent_frame = frames_.end()[-2].get();
-          WriteRegister(parent_frame, caller_return_register, return_value_);
+          VMFrame* parent_frame = ctx->frames.end()[-2].get();
+          WriteRegister(parent_frame, caller_return_register, ctx->return_value);
         }
         return;
       }
       case Opcode::Goto: {
-        pc_ += instr.pc_offset;
+        CheckCancelled(ctx);
+        ctx->pc += instr.pc_offset;
         break;
       }
       case Opcode::If: {
         int64_t cond_val = ReadRegister(curr_frame, instr.cond);
         if (cond_val != 0) {
-          pc_++;
+          ctx->pc++;
         } else {
           ICHECK_GT(instr.false_offset, 1);
-          pc_ += instr.false_offset;
+          ctx->pc += instr.false_offset;
+        }
+        break;
+      }
+    }
+  }
+}
+
+void VirtualMachineImpl::DecodeInstructions() {
+  decoded_instrs_.clear();
+  decoded_arg_values_.clear();
+  decoded_arg_tcodes_.clear();
+  decoded_reg_args_.clear();
+  num_check_slots_ = 0;
+  {
+    // The slots are assigned again, so the values validated with the previous executable go.
+    std::lock_guard<std::mutex> lock(exec_context_mutex_);
+    for (const std::unique_ptr<VMExecContext>& ctx : exec_context_pool_) {
+      ctx->checked_values.clear();
+    }
+  }
+  size_t num_instrs = exec_->instr_offset.size();
+  decoded_instrs_.reserve(num_instrs);
+  for (size_t pc = 0; pc < num_instrs; ++pc) {
+    Instruction instr = exec_->GetInstruction(pc);
+    DecodedInstr decoded;
+    decoded.op = instr.op;
+    switch (instr.op) {
+      case Opcode::Call: {
+        ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
+        decoded.reg = instr.dst;
+        decoded.func_idx = instr.func_idx;
+        const TVMRetValue& func = func_pool_[instr.func_idx];
+        if (func.type_code() == kTVMPackedFuncHandle) {
+          decoded.packed = func;
         }
+        decoded.num_args = instr.num_args;
+        decoded.args_begin = decoded_arg_values_.size();
+        decoded.reg_args_begin = decoded_reg_args_.size();
+        decoded_arg_values_.resize(decoded.args_begin + instr.num_args);
+        decoded_arg_tcodes_.resize(decoded.args_begin + instr.num_args);
+        runtime::TVMArgsSetter setter(decoded_arg_values_.data() + decoded.args_begin,
+                                      decoded_arg_tcodes_.data() + decoded.args_begin);
+        for (Index i = 0; i < instr.num_args; ++i) {
+          Instruction::Arg arg = instr.args[i];
+          switch (arg.kind()) {
+            case Instruction::ArgKind::kRegister: {
+              if (arg.value() < Instruction::kBeginSpecialReg) {
+                decoded_reg_args_.emplace_back(i, arg.value());
+              } else if (arg.value() == Instruction::kVoidRegister) {
+                setter(i, nullptr);
+              } else {
+                ICHECK_EQ(arg.value(), Instruction::kVMRegister);
+                setter(i, static_cast<void*>(static_cast<VirtualMachine*>(this)));
+              }
+              break;
+            }
+            case Instruction::ArgKind::kImmediate: {
+              setter(i, arg.value());
+              break;
+            }
+            case Instruction::ArgKind::kConstIdx: {
+              setter(i, this->const_pool_[arg.value()]);
+              break;
+            }
+            case Instruction::ArgKind::kFuncIdx: {
+              ICHECK_LT(static_cast<size_t>(arg.value()), this->func_pool_.size());
+              setter(i, this->func_pool_[arg.value()]);
+              break;
+            }
+            default: {
+              LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+            }
+          }
+        }
+        decoded.reg_args_end = decoded_reg_args_.size();
+        if (IsCachedCheck(instr)) {
+          decoded.check_slot = num_check_slots_++;
+        }
+        break;
+      }
+      case Opcode::Ret: {
+        decoded.reg = instr.result;
+        break;
+      }
+      case Opcode::Goto: {
+        decoded.pc_offset = instr.pc_offset;
+        break;
+      }
+      case Opcode::If: {
+        ICHECK_GT(instr.false_offset, 1);
+        decoded.reg = instr.cond;
+        decoded.pc_offset = instr.false_offset;
         break;
       }
     }
+    decoded_instrs_.push_back(decoded);
+  }
+}
+
+bool VirtualMachineImpl::IsCachedCheck(const Instruction& instr) {
+  auto is_register = [&](Index i) {
+    return instr.args[i].kind() == Instruction::ArgKind::kRegister &&
+           instr.args[i].value() < Instruction::kBeginSpecialReg;
+  };
+  auto is_immediate = [&](Index i) {
+    return instr.args[i].kind() == Instruction::ArgKind::kImmediate;
+  };
+  if (instr.num_args == 0 || !is_register(0)) {
+    return false;
+  }
+  const std::string& name = GetFuncName(instr.func_idx);
+  if (name == "vm.builtin.check_tensor_info" || name == "vm.builtin.check_shape_info" ||
+      name == "vm.builtin.check_tuple_info") {
+    for (Index i = 1; i < instr.num_args; ++i) {
+      if (is_register(i)) return false;
+    }
+    return true;
+  }
+  if (name != "vm.builtin.match_shape") {
+    return false;
+  }
+  // The arguments are the value, the heap, the size, the (code, value) pairs and the error
+  // context. The heap is passed in a register, but is not used by the codes allowed here.
+  if (instr.num_args < 3 || !is_immediate(2)) {
+    return false;
+  }
+  int64_t size = instr.args[2].value();
+  if (instr.num_args != 4 + size * 2 || is_register(3 + size * 2)) {
+    return false;
+  }
+  for (int64_t i = 0; i < size; ++i) {
+    if (!is_immediate(3 + i * 2) || is_register(4 + i * 2)) {
+      return false;
+    }
+    MatchShapeCode code = static_cast<MatchShapeCode>(instr.args[3 + i * 2].value());
+    if (code != MatchShapeCode::kAssertEqualToImm && code != MatchShapeCode::kNoOp) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void VirtualMachineImpl::ComputeRegisterKills() {
+  decoded_kills_.clear();
+  std::vector<std::vector<RegName>> kills(decoded_instrs_.size());
+  for (const VMFuncInfo& info : exec_->func_table) {
+    if (info.kind == VMFuncInfo::FuncKind::kVMFunc) {
+      this->ComputeFuncRegisterKills(info, &kills);
+    }
+  }
+  for (size_t pc = 0; pc < kills.size(); ++pc) {
+    decoded_instrs_[pc].kills_begin = decoded_kills_.size();
+    decoded_kills_.insert(decoded_kills_.end(), kills[pc].begin(), kills[pc].end());
+    decoded_instrs_[pc].kills_end = decoded_kills_.size();
+  }
+}
+
+void VirtualMachineImpl::ComputeFuncRegisterKills(const VMFuncInfo& info,
+                                                  std::vector<std::vector<RegName>>* kills) {
+  Index begin = info.start_instr;
+  Index end = info.end_instr;
+  size_t num_regs = info.register_file_size;
+  if (begin >= end) return;
+  ICHECK_LE(static_cast<size_t>(end), decoded_instrs_.size());
+  auto is_reg = [&](RegName reg) {
+    if (reg >= Instruction::kBeginSpecialReg) return false;
+    ICHECK_LT(static_cast<size_t>(reg), num_regs)
+        << "Function " << info.name << " uses register " << reg << " out of its register file";
+    return true;
+  };
+  // The registers the instruction reads, and the one it writes.
+  auto for_each_use = [&](Index pc, std::function<void(RegName)> fvisit) {
+    const DecodedInstr& instr = decoded_instrs_[pc];
+    if (instr.op == Opcode::Call) {
+      for (Index i = instr.reg_args_begin; i < instr.reg_args_end; ++i) {
+        if (is_reg(decoded_reg_args_[i].second)) fvisit(decoded_reg_args_[i].second);
+      }
+    } else if (instr.op == Opcode::Ret || instr.op == Opcode::If) {
+      if (is_reg(instr.reg)) fvisit(instr.reg);
+    }
+  };
+  auto def_of = [&](Index pc) -> std::optional<RegName> {
+    const DecodedInstr& instr = decoded_instrs_[pc];
+    if (instr.op == Opcode::Call && is_reg(instr.reg)) return instr.reg;
+    return std::nullopt;
+  };
+
+  // Split the function into basic blocks.
+  std::vector<Index> leaders = {begin};
+  for (Index pc = begin; pc < end; ++pc) {
+    const DecodedInstr& instr = decoded_instrs_[pc];
+    if (instr.op == Opcode::Goto || instr.op == Opcode::If) {
+      leaders.push_back(pc + instr.pc_offset);
+      leaders.push_back(pc + 1);
+    } else if (instr.op == Opcode::Ret) {
+      leaders.push_back(pc + 1);
+    }
+  }
+  std::sort(leaders.begin(), leaders.end());
+  leaders.erase(std::unique(leaders.begin(), leaders.end()), leaders.end());
+  leaders.erase(std::remove_if(leaders.begin(), leaders.end(),
+                               [&](Index pc) { return pc < begin || pc >= end; }),
+                leaders.end());
+  size_t num_blocks = leaders.size();
+  auto block_of = [&](Index pc) -> size_t {
+    return std::upper_bound(leaders.begin(), leaders.end(), pc) - leaders.begin() - 1;
+  };
+  auto block_end = [&](size_t b) { return b + 1 < num_blocks ? leaders[b + 1] : end; };
+
+  std::vector<std::vector<size_t>> succs(num_blocks);
+  // The registers read before written in the block, and the registers written in the block.
+  std::vector<std::vector<bool>> gen(num_blocks, std::vector<bool>(num_regs, false));
+  std::vector<std::vector<bool>> def(num_blocks, std::vector<bool>(num_regs, false));
+  for (size_t b = 0; b < num_blocks; ++b) {
+    Index last = block_end(b) - 1;
+    const DecodedInstr& instr = decoded_instrs_[last];
+    auto add_succ = [&](Index pc) {
+      if (pc >= begin && pc < end) succs[b].push_back(block_of(pc));
+    };
+    if (instr.op == Opcode::Call) {
+      add_succ(last + 1);
+    } else if (instr.op == Opcode::Goto) {
+      add_succ(last + instr.pc_offset);
+    } else if (instr.op == Opcode::If) {
+      add_succ(last + 1);
+      add_succ(last + instr.pc_offset);
+    }
+    for (Index pc = last; pc >= leaders[b]; --pc) {
+      if (std::optional<RegName> reg = def_of(pc)) {
+        gen[b][*reg] = false;
+        def[b][*reg] = true;
+      }
+      for_each_use(pc, [&](RegName reg) { gen[b][reg] = true; });
+    }
+  }
+
+  // Solve the live-out registers of the blocks backward until the fixpoint.
+  std::vector<std::vector<bool>> live_in(num_blocks, std::vector<bool>(num_regs, false));
+  std::vector<std::vector<bool>> live_out(num_blocks, std::vector<bool>(num_regs, false));
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t b = num_blocks; b-- > 0;) {
+      std::vector<bool>& out = live_out[b];
+      for (size_t succ : succs[b]) {
+        for (size_t r = 0; r < num_regs; ++r) {
+          if (live_in[succ][r]) out[r] = true;
+        }
+      }
+      for (size_t r = 0; r < num_regs; ++r) {
+        bool in = gen[b][r] || (out[r] && !def[b][r]);
+        if (in != live_in[b][r]) {
+          live_in[b][r] = in;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  for (size_t b = 0; b < num_blocks; ++b) {
+    // A call releases the registers it touches that are dead after it.
+    std::vector<bool> live = live_out[b];
+    for (Index pc = block_end(b) - 1; pc >= leaders[b]; --pc) {
+      const DecodedInstr& instr = decoded_instrs_[pc];
+      std::vector<RegName>& pc_kills = (*kills)[pc];
+      std::optional<RegName> dst = def_of(pc);
+      if (instr.op == Opcode::Call) {
+        auto maybe_kill = [&](RegName reg) {
+          if (!live[reg] && std::find(pc_kills.begin(), pc_kills.end(), reg) == pc_kills.end()) {
+            pc_kills.push_back(reg);
+          }
+        };
+        if (dst) maybe_kill(*dst);
+        for_each_use(pc, maybe_kill);
+      }
+      if (dst) live[*dst] = false;
+      for_each_use(pc, [&](RegName reg) { live[reg] = true; });
+    }
+
+    // Defer the releases in a stream region until the join. A region that does not end in
+    // the block keeps its registers until the frame is popped.
+    bool in_stream_region = false;
+    std::vector<RegName> deferred;
+    for (Index pc = leaders[b]; pc < block_end(b); ++pc) {
+      const DecodedInstr& instr = decoded_instrs_[pc];
+      if (instr.op != Opcode::Call) continue;
+      const std::string& name = GetFuncName(instr.func_idx);
+      std::vector<RegName>& pc_kills = (*kills)[pc];
+      if (std::optional<RegName> dst = def_of(pc)) {
+        // The register holds a new value from here on.
+        deferred.erase(std::remove(deferred.begin(), deferred.end(), *dst), deferred.end());
+      }
+      if (name == "vm.builtin.stream_switch") {
+        in_stream_region = true;
+      } else if (name == "vm.builtin.stream_join") {
+        pc_kills.insert(pc_kills.end(), deferred.begin(), deferred.end());
+        deferred.clear();
+        in_stream_region = false;
+      } else if (in_stream_region) {
+        deferred.insert(deferred.end(), pc_kills.begin(), pc_kills.end());
+        pc_kills.clear();
+      }
+    }
+  }
+}
+
+void VirtualMachineImpl::RunDecodedCall(VMExecContext* ctx, VMFrame* curr_frame,
+                                        const DecodedInstr& instr) {
+  ObjectRef checked;
+  if (instr.check_slot >= 0) {
+    // The checked value is the first argument, the first register argument of the call.
+    RegName checked_reg = decoded_reg_args_[instr.reg_args_begin].second;
+    const RegType& value = curr_frame->register_file[checked_reg];
+    if (value.type_code() == kTVMObjectHandle || value.type_code() == kTVMNDArrayHandle) {
+      checked = value;
+      if (static_cast<size_t>(instr.check_slot) < ctx->checked_values.size() &&
+          ctx->checked_values[instr.check_slot].same_as(checked)) {
+        if (instr.reg < Instruction::kBeginSpecialReg) {
+          curr_frame->register_file[instr.reg] = nullptr;
+        }
+        ReleaseDeadRegisters(curr_frame, instr);
+        ctx->pc++;
+        return;
+      }
+    }
+  }
+  std::vector<TVMValue>& values = curr_frame->call_arg_values;
+  std::vector<int>& tcodes = curr_frame->call_arg_tcodes;
+  if (values.size() < static_cast<size_t>(instr.num_args)) {
+    values.resize(instr.num_args);
+    tcodes.resize(instr.num_args);
+  }
+  std::copy_n(decoded_arg_values_.data() + instr.args_begin, instr.num_args, values.data());
+  std::copy_n(decoded_arg_tcodes_.data() + instr.args_begin, instr.num_args, tcodes.data());
+  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
+  for (Index i = instr.reg_args_begin; i < instr.reg_args_end; ++i) {
+    const std::pair<int, RegName>& reg_arg = decoded_reg_args_[i];
+    setter(reg_arg.first, curr_frame->register_file[reg_arg.second]);
+  }
+  TVMArgs args(values.data(), tcodes.data(), instr.num_args);
+  TVMRetValue ret;
+  if (instr.packed != nullptr) {
+    instr.packed.CallPacked(args, &ret);
+  } else {
+    this->InvokeClosurePacked(func_pool_[instr.func_idx], args, &ret);
+  }
+  if (instr.reg < Instruction::kBeginSpecialReg) {
+    curr_frame->register_file[instr.reg] = std::move(ret);
+  }
+  if (checked.defined()) {
+    if (ctx->checked_values.size() < static_cast<size_t>(num_check_slots_)) {
+      ctx->checked_values.resize(num_check_slots_);
+    }
+    ctx->checked_values[instr.check_slot] = std::move(checked);
+  }
+  ReleaseDeadRegisters(curr_frame, instr);
+  ctx->pc++;
+}
+
+void VirtualMachineImpl::RunDecodedLoop(VMExecContext* ctx) {
+  VMFrame* curr_frame = ctx->frames.back().get();
+  const DecodedInstr* instrs = decoded_instrs_.data();
+  const DecodedInstr* instr = nullptr;
+#if defined(__GNUC__) || defined(__clang__)
+  // Threaded dispatch, indexed by Opcode.
+  static const void* dispatch_table[] = {nullptr, &&op_call, &&op_ret, &&op_goto, &&op_if};
+#define TVM_VM_DISPATCH()   \
+  instr = &instrs[ctx->pc]; \
+  goto* dispatch_table[static_cast<int>(instr->op)]
+#else
+#define TVM_VM_DISPATCH()    \
+  instr = &instrs[ctx->pc];  \
+  switch (instr->op) {       \
+    case Opcode::Call:       \
+      goto op_call;          \
+    case Opcode::Ret:        \
+      goto op_ret;           \
+    case Opcode::Goto:       \
+      goto op_goto;          \
+    case Opcode::If:         \
+      goto op_if;            \
+  }
+#endif
+  TVM_VM_DISPATCH();
+op_call:
+  // The calls and the jumps, which close the loops, are where a cancelled request stops.
+  CheckCancelled(ctx);
+  RunDecodedCall(ctx, curr_frame, *instr);
+  TVM_VM_DISPATCH();
+op_goto:
+  CheckCancelled(ctx);
+  ctx->pc += instr->pc_offset;
+  TVM_VM_DISPATCH();
+op_if:
+  if (ReadRegister(curr_frame, instr->reg).operator int64_t() != 0) {
+    ctx->pc++;
+  } else {
+    ctx->pc += instr->pc_offset;
+  }
+  TVM_VM_DISPATCH();
+op_ret:
+#undef TVM_VM_DISPATCH
+  // If we have hit the point from which we started running, we should return to the caller
+  // breaking the dispatch loop.
+  ctx->return_value = ReadRegister(curr_frame, instr->reg);
+  if (ctx->frames.size() > 1) {
+    // return from a local call.
+    // Update the current frame to be the parent frame.
+    VMFrame* parent_frame = ctx->frames.end()[-2].get();
+    WriteRegister(parent_frame, curr_frame->caller_return_register, ctx->return_value);
   }
 }
 
@@ -907,6 +1881,27 @@ void VirtualMachineImpl::_SetInstrument(TVMArgs args, TVMRetValue* rv) {
   }
 }
 
+void VirtualMachineImpl::_EnableSamplingProfiler(int sample_interval) {
+  CHECK_GE(sample_interval, 0) << "ValueError: The sample interval should not be negative, but got "
+                               << sample_interval;
+  if (sample_interval == 0) {
+    sampler_ = nullptr;
+    return;
+  }
+  ICHECK(exec_ != nullptr && !devices.empty()) << "The VM should be initialized before profiling";
+  sampler_ = std::make_unique<profiling::SamplingProfiler>(
+      sample_interval, std::unordered_map<String, ObjectRef>{{String("Executor"), String("VM")}});
+  // The call sites are the entries of the function table, which run on the first device.
+  for (const VMFuncInfo& finfo : exec_->func_table) {
+    sampler_->RegisterCall(finfo.name, devices[0]);
+  }
+}
+
+std::string VirtualMachineImpl::_GetSamplingReport() {
+  CHECK(sampler_ != nullptr) << "ValueError: The sampling profiler is not enabled";
+  return sampler_->Report()->AsJSON();
+}
+
 void VirtualMachineImpl::_GetOutputArity(TVMArgs args, TVMRetValue* rv) {
   std::string func_name = args[0];
   RegType out = LookupVMOutput(func_name);
@@ -955,14 +1950,138 @@ std::string VirtualMachineImpl::_GetFunctionParamName(std::string func_name, int
   return vm_func.param_names[index];
 }
 
+void VirtualMachineImpl::_InvokeClosureAsync(TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.size(), 1);
+  ObjectRef closure_or_packed;
+  if (args[0].type_code() == kTVMStr) {
+    closure_or_packed = this->GetClosure(args[0].operator String());
+  } else {
+    closure_or_packed = args[0];
+  }
+  // The arguments are held by the call, which outlives the caller.
+  std::vector<RegType> inputs(args.size() - 1);
+  for (int i = 1; i < args.size(); ++i) {
+    inputs[i - 1] = args[i];
+  }
+  *rv = this->InvokeClosureAsync(std::move(closure_or_packed), std::move(inputs));
+}
+
+void VirtualMachineImpl::_SetNumAsyncWorkers(int num_workers) {
+  CHECK_GT(num_workers, 0) << "ValueError: The number of async workers should be positive, but got "
+                           << num_workers;
+  StopAsyncWorkers();
+  std::lock_guard<std::mutex> lock(async_mutex_);
+  num_async_workers_ = num_workers;
+}
+
+void VirtualMachineImpl::_RecordShapeSignatures(bool enable) {
+  std::lock_guard<std::mutex> lock(shape_variant_mutex_);
+  record_shape_signatures_ = enable;
+  if (enable) {
+    shape_signatures_.clear();
+  }
+}
+
+Array<ShapeTuple> VirtualMachineImpl::_GetShapeSignatures(std::string func_name) {
+  std::vector<std::pair<int64_t, const std::vector<int64_t>*>> signatures;
+  std::lock_guard<std::mutex> lock(shape_variant_mutex_);
+  for (const auto& kv : shape_signatures_[func_name]) {
+    signatures.emplace_back(kv.second, &kv.first);
+  }
+  std::stable_sort(signatures.begin(), signatures.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  // Each entry is the number of calls followed by the signature.
+  Array<ShapeTuple> result;
+  for (const auto& [count, signature] : signatures) {
+    std::vector<int64_t> entry{count};
+    entry.insert(entry.end(), signature->begin(), signature->end());
+    result.push_back(ShapeTuple(std::move(entry)));
+  }
+  return result;
+}
+
+void VirtualMachineImpl::_SetShapeVariant(TVMArgs args, TVMRetValue* rv) {
+  ICHECK_EQ(args.size(), 3) << "set_shape_variant expects the function name, the signature and "
+                            << "the variant";
+  std::string func_name = args[0];
+  ShapeTuple signature = args[1];
+  ObjectRef variant;
+  if (args[2].type_code() == kTVMStr || args[2].IsObjectRef<String>()) {
+    variant = this->GetClosureInternal(args[2].operator String(), false).value();
+  } else if (args[2].type_code() == kTVMPackedFuncHandle) {
+    variant = args[2].operator PackedFunc();
+  } else if (args[2].type_code() != kTVMNullptr) {
+    variant = args[2].operator ObjectRef();
+    CHECK(variant->IsInstance<VMClosureObj>() || variant->IsInstance<PackedFuncObj>())
+        << "TypeError: The variant of " << func_name << " should be a function, but got "
+        << variant->GetTypeKey();
+  }
+  std::vector<int64_t> key(signature.begin(), signature.end());
+  std::lock_guard<std::mutex> lock(shape_variant_mutex_);
+  auto& variants = shape_variants_[func_name];
+  if (variant.defined()) {
+    variants[key] = variant;
+  } else {
+    variants.erase(key);
+  }
+  bool has_variants = false;
+  for (const auto& kv : shape_variants_) {
+    has_variants = has_variants || !kv.second.empty();
+  }
+  has_shape_variants_ = has_variants;
+}
+
+std::vector<int64_t> VirtualMachineImpl::GetShapeSignature(TVMArgs args) {
+  std::vector<int64_t> signature;
+  for (int i = 0; i < args.size(); ++i) {
+    int type_code = args[i].type_code();
+    if (type_code == kTVMNDArrayHandle || type_code == kTVMDLTensorHandle) {
+      const DLTensor* tensor = args[i];
+      signature.push_back(tensor->ndim);
+      signature.insert(signature.end(), tensor->shape, tensor->shape + tensor->ndim);
+    } else {
+      signature.push_back(-1);
+    }
+  }
+  return signature;
+}
+
+Optional<ObjectRef> VirtualMachineImpl::LookupShapeVariant(const std::string& func_name,
+                                                            TVMArgs args) {
+  std::vector<int64_t> signature = GetShapeSignature(args);
+  std::lock_guard<std::mutex> lock(shape_variant_mutex_);
+  if (record_shape_signatures_) {
+    auto& counts = shape_signatures_[func_name];
+    auto it = counts.find(signature);
+    if (it != counts.end()) {
+      ++it->second;
+    } else if (counts.size() < kMaxShapeSignatures) {
+      counts.emplace(signature, 1);
+    }
+  }
+  auto it = shape_variants_.find(func_name);
+  if (it == shape_variants_.end()) return NullOpt;
+  auto variant_it = it->second.find(signature);
+  if (variant_it == it->second.end()) return NullOpt;
+  return variant_it->second;
+}
+
 PackedFunc VirtualMachineImpl::_LookupFunction(const String& name) {
   if (Optional<VMClosure> opt = this->GetClosureInternal(name, true)) {
-    return PackedFunc(
-        [clo = opt.value(), _self = GetRef<Module>(this)](TVMArgs args, TVMRetValue* rv) -> void {
-          auto* self = const_cast<VirtualMachineImpl*>(_self.as<VirtualMachineImpl>());
-          ICHECK(self);
-          self->InvokeClosurePacked(clo, args, rv);
-        });
+    return PackedFunc([clo = opt.value(), name = std::string(name),
+                       _self = GetRef<Module>(this)](TVMArgs args, TVMRetValue* rv) -> void {
+      auto* self = const_cast<VirtualMachineImpl*>(_self.as<VirtualMachineImpl>());
+      ICHECK(self);
+      // The calls of the shape signatures which have a specialized variant go to the variant,
+      // and the other ones to the generic function.
+      if (self->record_shape_signatures_ || self->has_shape_variants_) {
+        if (Optional<ObjectRef> variant = self->LookupShapeVariant(name, args)) {
+          self->InvokeClosurePacked(variant.value(), args, rv);
+          return;
+        }
+      }
+      self->InvokeClosurePacked(clo, args, rv);
+    });
   }
   return PackedFunc(nullptr);
 }
@@ -1029,7 +2148,11 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
   }
 
  protected:
-  void RunInstrCall(VMFrame* curr_frame, Instruction inst) override {
+  bool UseDecodedDispatch() const final {
+    return !(prof_ && prof_->IsRunning()) && VirtualMachineImpl::UseDecodedDispatch();
+  }
+
+  void RunInstrCall(VMExecContext* ctx, VMFrame* curr_frame, Instruction inst) override {
     bool profiling = false;
     if (prof_ && prof_->IsRunning()) {
       auto f_name = GetFuncName(inst.func_idx);
@@ -1065,7 +2188,7 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
       }
     }
 
-    VirtualMachineImpl::RunInstrCall(curr_frame, inst);
+    VirtualMachineImpl::RunInstrCall(ctx, curr_frame, inst);
 
     if (profiling) {
       prof_->StopCall();
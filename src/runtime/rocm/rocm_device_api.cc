@@ -140,6 +140,9 @@ class ROCMDeviceAPI final : public DeviceAPI {
       case kAvailableGlobalMemory:
         // Not currently implemented.
         break;
+      case kPeerTopology:
+        // Not currently implemented.
+        return;
     }
     *rv = value;
   }
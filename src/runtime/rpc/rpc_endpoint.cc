@@ -33,8 +33,11 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <cstring>
+#include <deque>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -58,12 +61,14 @@ namespace runtime {
 class RPCEndpoint::EventHandler : public dmlc::Stream {
  public:
   EventHandler(support::RingBuffer* reader, support::RingBuffer* writer, std::string name,
-               std::string* remote_key, std::function<void()> flush_writer)
+               std::string* remote_key, std::function<void()> flush_writer,
+               std::function<void(const void*, size_t)> send_bulk)
       : reader_(reader),
         writer_(writer),
         name_(name),
         remote_key_(remote_key),
-        flush_writer_(flush_writer) {
+        flush_writer_(flush_writer),
+        send_bulk_(send_bulk) {
     this->Clear();
 
     if (*remote_key == "%toinit") {
@@ -102,6 +107,25 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   /*! \brief Finish the copy ack stage. */
   void FinishCopyAck() { this->SwitchToState(kRecvPacketNumBytes); }
 
+  /*!
+   * \brief Stop the next copy ack of the given payload size after its code, and leave the payload
+   *  in the channel, so that the client receives it into the destination instead of the reader.
+   * \param nbytes The number of bytes of the payload.
+   */
+  void ExpectBulkCopyAck(uint64_t nbytes) { bulk_copy_ack_bytes_ = nbytes; }
+
+  /*! \return The number of workers that the client asked for in the multiplexed protocol. */
+  int MultiplexNumWorkers() const { return multiplex_num_workers_; }
+
+  /*! \return The session that serves the requests. */
+  std::shared_ptr<RPCSession> serving_session() const { return serving_session_; }
+
+  /*! \brief Serve the requests with the session of another handler. */
+  void SetServingSession(std::shared_ptr<RPCSession> sess) { serving_session_ = sess; }
+
+  /*! \brief Reply an error that escaped the handling of a request. */
+  void ReplyError(const std::string& msg) { this->ReturnException(msg.c_str()); }
+
   /*!
    * \brief Enter the io loop until the next event.
    * \param client_mode Whether we are in the client.
@@ -124,7 +148,11 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
         case kRecvPacketNumBytes: {
           uint64_t packet_nbytes;
           ICHECK(this->Read(&packet_nbytes));
-          if (packet_nbytes != 0) {
+          if (packet_nbytes != 0 && bulk_copy_ack_bytes_ != 0) {
+            this->SwitchToState(kRecvPacketCode);
+            this->RequestBytes(sizeof(int32_t));
+            packet_rest_bytes_ = packet_nbytes - sizeof(int32_t);
+          } else if (packet_nbytes != 0) {
             this->SwitchToState(kProcessPacket);
             this->RequestBytes(packet_nbytes);
           } else {
@@ -132,6 +160,20 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
           }
           break;
         }
+        case kRecvPacketCode: {
+          RPCCode code;
+          ICHECK(this->Read(&code));
+          if (code == RPCCode::kCopyAck && packet_rest_bytes_ == bulk_copy_ack_bytes_) {
+            this->SwitchToState(kCopyAckReceived);
+          } else {
+            // Not the expected copy ack, e.g. an exception, which is processed as usual.
+            packet_code_ = code;
+            this->SwitchToState(kProcessPacket);
+            this->RequestBytes(packet_rest_bytes_);
+          }
+          bulk_copy_ack_bytes_ = 0;
+          break;
+        }
         case kProcessPacket: {
           this->HandleProcessPacket(setreturn);
           break;
@@ -150,6 +192,11 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
         }
         case kShutdownReceived: {
           status = RPCCode::kShutdown;
+          break;
+        }
+        case kMultiplexReceived: {
+          status = RPCCode::kEnableMultiplex;
+          break;
         }
       }
     }
@@ -163,6 +210,8 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   void Clear() {
     state_ = kRecvPacketNumBytes;
     pending_request_bytes_ = sizeof(uint64_t);
+    bulk_copy_ack_bytes_ = 0;
+    packet_code_ = RPCCode::kNone;
   }
 
   /*!
@@ -290,11 +339,13 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   enum State {
     kInitHeader,
     kRecvPacketNumBytes,
+    kRecvPacketCode,
     kProcessPacket,
     kWaitForAsyncCallback,
     kReturnReceived,
     kCopyAckReceived,
-    kShutdownReceived
+    kShutdownReceived,
+    kMultiplexReceived
   };
   // Current state;
   State state_;
@@ -304,6 +355,14 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   bool client_mode_{false};
   // Whether current handler is in the async server mode.
   bool async_server_mode_{false};
+  // The payload size of the copy ack whose payload is left in the channel, or 0.
+  uint64_t bulk_copy_ack_bytes_{0};
+  // The bytes of the packet after its code, when the code is received first.
+  uint64_t packet_rest_bytes_{0};
+  // The code of the packet when it is received first, or kNone.
+  RPCCode packet_code_{RPCCode::kNone};
+  // The number of workers of the multiplexed protocol.
+  int multiplex_num_workers_{0};
   // Internal arena
   support::Arena arena_;
   // internal arena for temp objects
@@ -347,8 +406,11 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
 
   // Handler for read code.
   void HandleProcessPacket(RPCSession::FEncodeReturn setreturn) {
-    RPCCode code = RPCCode::kNone;
-    this->Read(&code);
+    RPCCode code = packet_code_;
+    if (code == RPCCode::kNone) {
+      this->Read(&code);
+    }
+    packet_code_ = RPCCode::kNone;
 
     if (code >= RPCCode::kSyscallCodeStart) {
       this->HandleSyscall(code);
@@ -453,14 +515,21 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
     this->Read(&data_bytes);
     size_t elem_bytes = (arr->dtype.bits * arr->dtype.lanes + 7) / 8;
     auto* sess = GetServingSession();
+    // The async server mode owns the IO of the channel, which the reply has to go through.
+    bool send_bulk = !async_server_mode_ && data_bytes >= kRPCBulkTransferMinBytes;
     // Return Copy Ack with the given data
-    auto fcopyack = [this](char* dptr, size_t num_bytes) {
+    auto fcopyack = [this, send_bulk](char* dptr, size_t num_bytes) {
       RPCCode code = RPCCode::kCopyAck;
       uint64_t packet_nbytes = sizeof(code) + num_bytes;
 
       this->Write(packet_nbytes);
       this->Write(code);
-      this->WriteArray(dptr, num_bytes);
+      if (send_bulk) {
+        flush_writer_();
+        send_bulk_(dptr, num_bytes);
+      } else {
+        this->WriteArray(dptr, num_bytes);
+      }
       this->SwitchToState(kRecvPacketNumBytes);
     };
 
@@ -601,7 +670,11 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
       std::string tkey = mod->type_key();
       ICHECK_EQ(tkey, "rpc") << "Constructor " << constructor_name << " to return an RPCModule";
       serving_session_ = RPCModuleGetSession(mod);
-      this->ReturnVoid();
+      // Report the optional features of the server, which clients of earlier versions ignore.
+      TVMValue features;
+      int features_tcode = kDLInt;
+      features.v_int64 = async_server_mode_ ? 0 : kRPCFeatureMultiplex;
+      this->ReturnPackedSeq(TVMArgs(&features, &features_tcode, 1));
     } catch (const std::exception& e) {
       this->ReturnException(e.what());
     }
@@ -630,6 +703,19 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
     }
   }
 
+  void HandleSyscallEnableMultiplex() {
+    TVMArgs args = RecvPackedSeq();
+    if (async_server_mode_) {
+      this->ReturnException("The async server mode does not support the multiplexed protocol");
+      this->SwitchToState(kRecvPacketNumBytes);
+      return;
+    }
+    multiplex_num_workers_ = std::max(args[0].operator int(), 1);
+    this->ReturnVoid();
+    // Stop here, the frames of the multiplexed protocol follow.
+    this->SwitchToState(kMultiplexReceived);
+  }
+
   // Handler for special syscalls that have a specific RPCCode.
   template <typename F>
   void SysCallHandler(F f) {
@@ -686,6 +772,8 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   std::string* remote_key_;
   // function to flush the writer.
   std::function<void()> flush_writer_;
+  // function to send a large payload to the channel, bypassing the writer.
+  std::function<void(const void*, size_t)> send_bulk_;
 };
 
 RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn) {
@@ -693,7 +781,8 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
 
   CHECK(channel_) << "Expected connection to server " << name_
                   << " to be active, but the connection was previously closed";
-  while (code != RPCCode::kReturn && code != RPCCode::kShutdown && code != RPCCode::kCopyAck) {
+  while (code != RPCCode::kReturn && code != RPCCode::kShutdown && code != RPCCode::kCopyAck &&
+         code != RPCCode::kEnableMultiplex) {
     while (writer_.bytes_available() != 0) {
       writer_.ReadWithCallback(
           [this](const void* data, size_t size) { return channel_->Send(data, size); },
@@ -716,6 +805,220 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
   return code;
 }
 
+/*!
+ * \brief A request of the multiplexed protocol, whose packets are encoded and decoded in buffers
+ *  of its own, so that several requests are in flight on the channel at once.
+ *
+ *  A frame of the protocol is the sequence number of a request followed by a packet of the
+ *  sequential protocol, and the reply to the request is the frame of the same sequence number.
+ */
+class RPCEndpoint::MultiplexRequest {
+ public:
+  MultiplexRequest(RPCEndpoint* endpt, uint64_t seq)
+      : endpt_(endpt),
+        seq_(seq),
+        remote_key_(endpt->remote_key_),
+        handler_(
+            &reader_, &writer_, endpt->name_, &remote_key_, []() {},
+            [this](const void* data, size_t size) { writer_.Write(data, size); }) {
+    handler_.Write(seq_);
+  }
+
+  /*! \return The handler that encodes the packet of the request or its reply. */
+  EventHandler* handler() { return &handler_; }
+
+  /*! \brief Load a received packet for the handler to decode. */
+  void Load(const std::string& packet) { reader_.Write(packet.data(), packet.size()); }
+
+  /*! \brief Send the frame of the encoded packet. */
+  void Send() { endpt_->SendFrame(&writer_); }
+
+  /*! \brief Send the request and handle its reply, which is a return or a copy ack. */
+  RPCCode HandleUntilReturnEvent(RPCSession::FEncodeReturn setreturn) {
+    this->Send();
+    this->Load(endpt_->RecvReply(seq_));
+    return handler_.HandleNextEvent(true, false, setreturn);
+  }
+
+ private:
+  RPCEndpoint* endpt_;
+  uint64_t seq_;
+  support::RingBuffer reader_;
+  support::RingBuffer writer_;
+  std::string remote_key_;
+  EventHandler handler_;
+};
+
+void RPCEndpoint::SendFrame(support::RingBuffer* frame) {
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  while (frame->bytes_available() != 0) {
+    size_t n = frame->ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        frame->bytes_available());
+    CHECK_NE(n, 0U) << "Channel closes before we send the frame";
+  }
+}
+
+bool RPCEndpoint::RecvFrame(uint64_t* seq, std::string* packet) {
+  uint64_t header[2];
+  char* ptr = reinterpret_cast<char*>(header);
+  size_t n = channel_->Recv(ptr, sizeof(header));
+  if (n == 0) return false;
+  RecvBulk(ptr + n, sizeof(header) - n);
+  // The packet keeps its size in the wire format, for the handler that decodes it.
+  uint64_t packet_nbytes = header[1];
+  if (!DMLC_IO_NO_ENDIAN_SWAP) {
+    dmlc::ByteSwap(header, sizeof(uint64_t), 2);
+  }
+  *seq = header[0];
+  packet->resize(sizeof(uint64_t) + header[1]);
+  std::memcpy(&(*packet)[0], &packet_nbytes, sizeof(uint64_t));
+  RecvBulk(&(*packet)[sizeof(uint64_t)], header[1]);
+  return true;
+}
+
+std::string RPCEndpoint::RecvReply(uint64_t seq) {
+  std::unique_lock<std::mutex> lock(reply_mutex_);
+  while (true) {
+    auto it = replies_.find(seq);
+    if (it != replies_.end()) {
+      std::string packet = std::move(it->second);
+      replies_.erase(it);
+      return packet;
+    }
+    if (receiving_) {
+      // Another request receives the next frame, which may be the reply to this one.
+      reply_cv_.wait(lock);
+      continue;
+    }
+    receiving_ = true;
+    lock.unlock();
+    uint64_t reply_seq = 0;
+    std::string packet;
+    bool received = false;
+    try {
+      received = RecvFrame(&reply_seq, &packet);
+    } catch (const std::exception& e) {
+      lock.lock();
+      receiving_ = false;
+      reply_cv_.notify_all();
+      throw;
+    }
+    lock.lock();
+    receiving_ = false;
+    reply_cv_.notify_all();
+    CHECK(received) << "Channel closes before we get the reply to request " << seq;
+    replies_[reply_seq] = std::move(packet);
+  }
+}
+
+RPCCode RPCEndpoint::ServeMultiplexed(int num_workers) {
+  // Flush the reply to the handshake, which the frames of the multiplexed protocol follow.
+  while (writer_.bytes_available() != 0) {
+    size_t n = writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+    CHECK_NE(n, 0U) << "Channel closes before we send the reply";
+  }
+  std::shared_ptr<RPCSession> sess = handler_->serving_session();
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::pair<uint64_t, std::string>> queue;
+  bool closed = false;
+
+  auto fserve = [this, sess](uint64_t seq, const std::string& packet) {
+    MultiplexRequest request(this, seq);
+    request.handler()->SetServingSession(sess);
+    request.Load(packet);
+    try {
+      request.handler()->HandleNextEvent(false, false, [](TVMArgs) {});
+    } catch (const std::exception& e) {
+      // Reply from a clean handler, as the failed one may have stopped anywhere in the packet.
+      MultiplexRequest error(this, seq);
+      error.handler()->ReplyError(e.what());
+      error.Send();
+      return;
+    }
+    request.Send();
+  };
+  auto fworker = [&]() {
+    while (true) {
+      std::pair<uint64_t, std::string> frame;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return closed || !queue.empty(); });
+        if (queue.empty()) return;
+        frame = std::move(queue.front());
+        queue.pop_front();
+      }
+      try {
+        fserve(frame.first, frame.second);
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Server[" << name_ << "]: Cannot reply to request " << frame.first << ": "
+                     << e.what();
+      }
+    }
+  };
+  auto is_shutdown = [](const std::string& packet) {
+    int32_t code;
+    std::memcpy(&code, packet.data() + sizeof(uint64_t), sizeof(code));
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(&code, sizeof(code), 1);
+    }
+    return static_cast<RPCCode>(code) == RPCCode::kShutdown;
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < num_workers; ++i) {
+    workers.emplace_back(fworker);
+  }
+  // The workers finish the requests in the queue before they exit.
+  auto fjoin = [&]() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+    }
+    cv.notify_all();
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  };
+  try {
+    uint64_t seq;
+    std::string packet;
+    while (RecvFrame(&seq, &packet) && packet.size() > sizeof(uint64_t) && !is_shutdown(packet)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.emplace_back(seq, std::move(packet));
+      cv.notify_one();
+    }
+  } catch (const std::exception& e) {
+    fjoin();
+    throw;
+  }
+  fjoin();
+  return RPCCode::kShutdown;
+}
+
+void RPCEndpoint::SendBulk(const void* data, uint64_t nbytes) {
+  const char* ptr = static_cast<const char*>(data);
+  while (nbytes != 0) {
+    size_t n = channel_->Send(ptr, std::min(nbytes, kRPCBulkTransferChunkBytes));
+    CHECK_NE(n, 0U) << "Channel closes before we send the bulk data";
+    ptr += n;
+    nbytes -= n;
+  }
+}
+
+void RPCEndpoint::RecvBulk(void* data, uint64_t nbytes) {
+  char* ptr = static_cast<char*>(data);
+  while (nbytes != 0) {
+    size_t n = channel_->Recv(ptr, std::min(nbytes, kRPCBulkTransferChunkBytes));
+    CHECK_NE(n, 0U) << "Channel closes before we get the bulk data";
+    ptr += n;
+    nbytes -= n;
+  }
+}
+
 void RPCEndpoint::Init() {
   // callback to flush the writer.
   auto flush_writer = [this]() {
@@ -727,27 +1030,42 @@ void RPCEndpoint::Init() {
     }
   };
 
+  // callback to send a large payload after the flushed writer.
+  auto send_bulk = [this](const void* data, size_t size) { this->SendBulk(data, size); };
+
   // Event handler
-  handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer);
+  handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer,
+                                            send_bulk);
 
   // Quick function to for syscall remote.
   syscall_remote_ = PackedFunc([this](TVMArgs all_args, TVMRetValue* rv) {
-    std::lock_guard<std::mutex> lock(mutex_);
     RPCCode code = static_cast<RPCCode>(all_args[0].operator int());
     TVMArgs args(all_args.values + 1, all_args.type_codes + 1, all_args.num_args - 1);
 
-    uint64_t packet_nbytes = sizeof(code) + handler_->PackedSeqGetNumBytes(
-                                                args.values, args.type_codes, args.num_args, true);
+    auto fwrite = [&](EventHandler* handler) {
+      uint64_t packet_nbytes =
+          sizeof(code) +
+          handler->PackedSeqGetNumBytes(args.values, args.type_codes, args.num_args, true);
 
-    // All packet begins with packet nbytes
-    handler_->Write(packet_nbytes);
-    handler_->Write(code);
-    handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
-
-    code = HandleUntilReturnEvent(true, [rv](TVMArgs args) {
+      // All packet begins with packet nbytes
+      handler->Write(packet_nbytes);
+      handler->Write(code);
+      handler->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
+    };
+    auto fsetrv = [rv](TVMArgs args) {
       ICHECK_EQ(args.size(), 1);
       *rv = args[0];
-    });
+    };
+
+    if (multiplex_) {
+      MultiplexRequest request(this, next_seq_++);
+      fwrite(request.handler());
+      code = request.HandleUntilReturnEvent(fsetrv);
+    } else {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fwrite(handler_.get());
+      code = HandleUntilReturnEvent(true, fsetrv);
+    }
     ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
   });
 }
@@ -780,6 +1098,19 @@ void RPCEndpoint::Shutdown() {
     RPCCode code = RPCCode::kShutdown;
     uint64_t packet_nbytes = sizeof(code);
 
+    if (multiplex_) {
+      // The shutdown has no reply, and hence no sequence number.
+      MultiplexRequest request(this, 0);
+      request.handler()->Write(packet_nbytes);
+      request.handler()->Write(code);
+      try {
+        request.Send();
+      } catch (const Error& e) {
+      }
+      channel_.reset(nullptr);
+      return;
+    }
+
     handler_->Write(packet_nbytes);
     handler_->Write(code);
 
@@ -802,7 +1133,11 @@ void RPCEndpoint::ServerLoop() {
     (*f)();
   }
   TVMRetValue rv;
-  ICHECK(HandleUntilReturnEvent(false, [](TVMArgs) {}) == RPCCode::kShutdown);
+  RPCCode code = HandleUntilReturnEvent(false, [](TVMArgs) {});
+  if (code == RPCCode::kEnableMultiplex) {
+    code = ServeMultiplexed(handler_->MultiplexNumWorkers());
+  }
+  ICHECK(code == RPCCode::kShutdown);
   if (const auto* f = Registry::Get("tvm.rpc.server.shutdown")) {
     (*f)();
   }
@@ -844,35 +1179,55 @@ void RPCEndpoint::InitRemoteSession(TVMArgs args) {
   handler_->WriteArray(protocol_ver.data(), length);
   handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
 
-  code = HandleUntilReturnEvent(true, [](TVMArgs args) {});
+  code = HandleUntilReturnEvent(true, [this](TVMArgs args) {
+    // Servers of earlier versions return nothing, and have no optional features.
+    if (args.size() == 1 && args.type_codes[0] == kDLInt) {
+      remote_features_ = args[0];
+    }
+  });
   ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
 }
 
+bool RPCEndpoint::EnableMultiplex(int num_workers) {
+  if (multiplex_) return true;
+  if ((remote_features_ & kRPCFeatureMultiplex) == 0) return false;
+  this->SysCallRemote(RPCCode::kEnableMultiplex, num_workers);
+  multiplex_ = true;
+  return true;
+}
+
 // Get remote function with name
 void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
                            const int* arg_type_codes, int num_args,
                            RPCSession::FEncodeReturn encode_return) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
   RPCCode code = RPCCode::kCallFunc;
   uint64_t handle = reinterpret_cast<uint64_t>(h);
 
-  uint64_t packet_nbytes =
-      sizeof(code) + sizeof(handle) +
-      handler_->PackedSeqGetNumBytes(arg_values, arg_type_codes, num_args, true);
+  auto fwrite = [&](EventHandler* handler) {
+    handler->ValidateArguments(arg_values, arg_type_codes, num_args);
+    uint64_t packet_nbytes =
+        sizeof(code) + sizeof(handle) +
+        handler->PackedSeqGetNumBytes(arg_values, arg_type_codes, num_args, true);
 
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  handler_->Write(handle);
-  handler_->SendPackedSeq(arg_values, arg_type_codes, num_args, true);
+    handler->Write(packet_nbytes);
+    handler->Write(code);
+    handler->Write(handle);
+    handler->SendPackedSeq(arg_values, arg_type_codes, num_args, true);
+  };
 
-  code = HandleUntilReturnEvent(true, encode_return);
+  if (multiplex_) {
+    MultiplexRequest request(this, next_seq_++);
+    fwrite(request.handler());
+    code = request.HandleUntilReturnEvent(encode_return);
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fwrite(handler_.get());
+    code = HandleUntilReturnEvent(true, encode_return);
+  }
   ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
 void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
   RPCCode code = RPCCode::kCopyToRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
@@ -883,16 +1238,38 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
   uint64_t packet_nbytes = overhead + nbytes;
 
+  if (multiplex_) {
+    MultiplexRequest request(this, next_seq_++);
+    EventHandler* handler = request.handler();
+    handler->Write(packet_nbytes);
+    handler->Write(code);
+    RPCReference::SendDLTensor(handler, to);
+    handler->Write(nbytes);
+    handler->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
+    ICHECK(request.HandleUntilReturnEvent([](TVMArgs) {}) == RPCCode::kReturn);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
   handler_->Write(packet_nbytes);
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, to);
   handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
+  if (nbytes >= kRPCBulkTransferMinBytes) {
+    // Send the data behind the header, instead of copying it into the writer first.
+    while (writer_.bytes_available() != 0) {
+      writer_.ReadWithCallback(
+          [this](const void* data, size_t size) { return channel_->Send(data, size); },
+          writer_.bytes_available());
+    }
+    SendBulk(from_bytes, nbytes);
+  } else {
+    handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
+  }
   ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
 }
 
 void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
   RPCCode code = RPCCode::kCopyFromRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
@@ -903,13 +1280,36 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(from, code, nbytes);
   uint64_t packet_nbytes = overhead;
 
+  if (multiplex_) {
+    MultiplexRequest request(this, next_seq_++);
+    EventHandler* handler = request.handler();
+    handler->Write(packet_nbytes);
+    handler->Write(code);
+    RPCReference::SendDLTensor(handler, from);
+    handler->Write(nbytes);
+    ICHECK(request.HandleUntilReturnEvent([](TVMArgs) {}) == RPCCode::kCopyAck);
+    handler->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
+    handler->FinishCopyAck();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
   handler_->Write(packet_nbytes);
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, from);
   handler_->Write(nbytes);
+  bool bulk = nbytes >= kRPCBulkTransferMinBytes;
+  if (bulk) {
+    handler_->ExpectBulkCopyAck(nbytes);
+  }
   ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
+  if (bulk) {
+    // The payload is left in the channel, receive it into the destination.
+    RecvBulk(to_bytes, nbytes);
+  } else {
+    handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
+  }
   handler_->FinishCopyAck();
 }
 
@@ -1058,11 +1458,14 @@ void RPCEndpoint::EventHandler::HandleSyscall(RPCCode code) {
     case RPCCode::kCopyAmongRemote:
       SysCallHandler(RPCCopyAmongRemote);
       break;
+    case RPCCode::kEnableMultiplex:
+      this->HandleSyscallEnableMultiplex();
+      break;
     default:
       LOG(FATAL) << "Unknown event " << static_cast<int>(code);
   }
 
-  if (state_ != kWaitForAsyncCallback) {
+  if (state_ != kWaitForAsyncCallback && state_ != kMultiplexReceived) {
     ICHECK_EQ(state_, kRecvPacketNumBytes);
   }
 }
@@ -1210,6 +1613,9 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   void Shutdown() final { endpoint_->Shutdown(); }
 
+  /*! \brief Switch the connection to the multiplexed protocol, see RPCEndpoint::EnableMultiplex. */
+  bool EnableMultiplex(int num_workers) { return endpoint_->EnableMultiplex(num_workers); }
+
  private:
   uint64_t GetRPCMaxTransferSize() {
     if (rpc_chunk_max_size_bytes_ > 0) {
@@ -1240,6 +1646,12 @@ std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> end
   return std::make_shared<RPCClientSession>(endpoint);
 }
 
+TVM_REGISTER_GLOBAL("rpc.SessEnableMultiplex").set_body_typed([](Module mod, int num_workers) {
+  auto* sess = dynamic_cast<RPCClientSession*>(RPCModuleGetSession(mod).get());
+  CHECK(sess != nullptr) << "ValueError: Only the sessions of a remote server can be multiplexed";
+  return sess->EnableMultiplex(num_workers);
+});
+
 uint64_t RemoteCopyCalculatePacketOverheadSize(DLTensor* tensor, RPCCode code, uint64_t nbytes) {
   uint64_t shape_bytes = tensor->ndim * sizeof(int64_t);
   uint64_t to_data = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(tensor->data));
@@ -26,9 +26,12 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "../../support/ring_buffer.h"
@@ -48,6 +51,12 @@ const int kRPCTrackerMagic = 0x2f271;
 const int kRPCSuccess = kRPCMagic + 0;
 // cannot found matched key in server
 const int kRPCMismatch = kRPCMagic + 2;
+// copies of at least this size bypass the ring buffers and go directly through the channel
+const uint64_t kRPCBulkTransferMinBytes = 1 << 20;
+// the size of each send/recv call of a bulk transfer
+const uint64_t kRPCBulkTransferChunkBytes = 4 << 20;
+// feature bit of the servers that support the multiplexed protocol
+const int kRPCFeatureMultiplex = 1;
 
 /*! \brief Enumeration code for the RPC tracker */
 enum class TrackerCode : int {
@@ -130,6 +139,24 @@ class RPCEndpoint {
    */
   void InitRemoteSession(TVMArgs session_constructor_args);
 
+  /*!
+   * \brief Switch the connection to the multiplexed protocol.
+   *
+   *  In the multiplexed protocol, every packet is prefixed by the sequence number of its request,
+   *  and the server processes the requests on a pool of workers. Requests issued concurrently
+   *  from several threads are all in flight at once, and complete in any order. Requests issued
+   *  from the same thread still complete in order, as each one waits for its reply.
+   *
+   *  The server reports whether it supports the protocol when the session is initialized.
+   *  Servers of earlier versions and async servers do not, and then the connection keeps
+   *  processing one request at a time.
+   *
+   * \param num_workers The number of requests the server processes concurrently.
+   * \return Whether the connection uses the multiplexed protocol.
+   * \note Call it before issuing requests from several threads.
+   */
+  bool EnableMultiplex(int num_workers);
+
   /*!
    * \brief Call into remote function
    * \param handle The function handle
@@ -186,11 +213,23 @@ class RPCEndpoint {
 
  private:
   class EventHandler;
+  class MultiplexRequest;
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
   // Initalization
   void Init();
+  // Send or receive a large payload directly through the channel, bypassing the ring buffers.
+  void SendBulk(const void* data, uint64_t nbytes);
+  void RecvBulk(void* data, uint64_t nbytes);
+  // Serve the requests of the multiplexed protocol until the shutdown.
+  RPCCode ServeMultiplexed(int num_workers);
+  // Send a frame of the multiplexed protocol, i.e. a sequence number followed by a packet.
+  void SendFrame(support::RingBuffer* frame);
+  // Receive a frame of the multiplexed protocol, return false if the channel is closed.
+  bool RecvFrame(uint64_t* seq, std::string* packet);
+  // Wait for the packet of the reply to the request of the sequence number.
+  std::string RecvReply(uint64_t seq);
   // Internal channel.
   std::unique_ptr<RPCChannel> channel_;
 
@@ -208,6 +247,19 @@ class RPCEndpoint {
   std::string remote_key_;
   // Invoked when the RPC session is terminated
   TypedPackedFunc<void()> fcleanup_;
+  // The optional features that the server reported.
+  int remote_features_{0};
+  // Whether the connection uses the multiplexed protocol.
+  std::atomic<bool> multiplex_{false};
+  // The sequence number of the next request, 0 is for the requests without reply.
+  std::atomic<uint64_t> next_seq_{1};
+  // Serializes the frames sent in the multiplexed protocol.
+  std::mutex send_mutex_;
+  // The replies received for the other requests in flight, and whether a request is receiving.
+  std::mutex reply_mutex_;
+  std::condition_variable reply_cv_;
+  std::unordered_map<uint64_t, std::string> replies_;
+  bool receiving_{false};
 };
 
 /*!
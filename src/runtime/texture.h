@@ -94,13 +94,58 @@ inline bool IsTextureStorage(std::string scope) {
   return scope.find("texture") != std::string::npos;
 }
 
+/*! \brief Statistics of the textures of a Pool2D */
+struct TexturePoolStats {
+  /*! \brief The size of the textures that are currently handed out. */
+  size_t live_bytes{0};
+  /*! \brief The size of the free textures kept for reuse. */
+  size_t cached_bytes{0};
+  /*! \brief The peak of live_bytes + cached_bytes. */
+  size_t peak_bytes{0};
+  /*! \brief The part of live_bytes not covered by the requested sizes. */
+  size_t waste_bytes{0};
+  /*! \brief The number of allocations. */
+  uint64_t num_allocs{0};
+  /*! \brief The number of frees. */
+  uint64_t num_frees{0};
+  /*! \brief The number of allocations served by a free texture. */
+  uint64_t num_reuses{0};
+  /*! \brief The number of free textures released by trimming. */
+  uint64_t num_evictions{0};
+  /*! \brief The number of device allocations that failed and were retried after trimming. */
+  uint64_t num_alloc_failures{0};
+};
+
+/*!
+ * \brief A pool of two dimensional textures of one device.
+ *
+ * Requests are rounded up to size classes, with eight classes per
+ * power of two in each dimension, so that textures of similar shapes
+ * can be exchanged.  A request is served by the free texture of the
+ * smallest area that covers its size class, and a new texture is
+ * allocated otherwise.  When a device allocation fails, the free
+ * textures are released and the allocation is retried.
+ */
 class TVM_DLL Pool2D {
  public:
   Pool2D() = default;
   void* Alloc(Device dev, DeviceAPI* device, size_t width, size_t height, DLDataType type_hint);
   void Free(void* data);
+  /*!
+   * \brief Release the least recently used free textures.
+   * \param max_cached_bytes The size of free textures that may stay in the pool.
+   */
+  void Trim(Device dev, DeviceAPI* device, size_t max_cached_bytes);
   // Release all resources immediately
   void Release(Device dev, DeviceAPI* device);
+  /*! \return The statistics of the pool. */
+  const TexturePoolStats& GetStats() const { return stats_; }
+  /*!
+   * \brief Round a texture extent up to its size class.
+   * \param extent The width or height of a request.
+   * \return The extent of the texture that is allocated for the request.
+   */
+  static size_t SizeClass(size_t extent);
 
  protected:
   struct Entry {
@@ -108,9 +153,21 @@ class TVM_DLL Pool2D {
     size_t x;
     size_t y;
     DLDataType type;
+    /*! \brief The size of the texture that was requested. */
+    size_t requested_bytes;
+    /*! \brief The time of the last free, used to trim the oldest textures first. */
+    uint64_t last_use;
   };
+  /*! \return The size in bytes of an RGBA texture. */
+  static size_t TextureBytes(size_t x, size_t y, DLDataType type) {
+    return x * y * 4 * ((type.bits * type.lanes + 7) / 8);
+  }
+  /*! \brief Allocate a texture on the device, trimming the pool if the allocation fails. */
+  void* AllocTexture(Device dev, DeviceAPI* device, size_t x, size_t y, DLDataType type);
   std::vector<Entry> free_list_;
   std::vector<Entry> allocated_;
+  TexturePoolStats stats_;
+  uint64_t clock_{0};
 };
 
 /*!
@@ -132,13 +189,16 @@ class TVM_DLL TexturePool {
   /*!
    * \brief Allocate a two dimensional temporal texture workspace on device
    *
-   * \note Two dimensional texture workspaces will be grown and reused
-   * according to the following strategy:
-   *  - Choose the workspace which minimizes the amount of memory required to
-   *    grow the workspace to fit the request.
-   *  - If a set of workspaces exist that fit the current request without
-   *    expansion, choose the workspace of that set which most closely
-   *    matches the request size, minimizing wasted space.
+   * \note Two dimensional texture workspaces are reused according to
+   * the following strategy:
+   *  - The requested width and height are rounded up to their size
+   *    classes, see Pool2D::SizeClass.
+   *  - Among the free workspaces that cover the rounded request, and
+   *    that are not more than five times larger in either dimension,
+   *    the one of the smallest area is chosen.
+   *  - Otherwise a new workspace of the rounded size is allocated.  If
+   *    this fails, the free workspaces are released and the allocation
+   *    is retried.
    *
    * \param dev The context of allocation.
    * \param width The width of the 2d texture to be allocated.
@@ -153,6 +213,28 @@ class TVM_DLL TexturePool {
    * \param ptr The pointer to be freed.
    */
   void FreeTexture(Device dev, void* ptr);
+  /*!
+   * \brief Release the free textures of a device.
+   *
+   * \param dev The device.
+   * \param max_cached_bytes The size of free textures that may stay in the pool.
+   */
+  void Trim(Device dev, size_t max_cached_bytes = 0);
+  /*!
+   * \brief Limit the size of the free textures kept for reuse on each device.
+   *
+   * The least recently used free textures are released when a texture is
+   * freed beyond the limit.  The limit defaults to the value of
+   * TVM_TEXTURE_POOL_MAX_CACHED_MB, and is unlimited if it is not set.
+   *
+   * \param max_cached_bytes The limit in bytes.
+   */
+  void SetMaxCachedBytes(size_t max_cached_bytes) { max_cached_bytes_ = max_cached_bytes; }
+  /*!
+   * \brief Get the statistics of the pool of a device.
+   * \param dev The device.
+   */
+  TexturePoolStats GetStats(Device dev) const;
 
  private:
   /*! \brief pool of device local array */
@@ -161,6 +243,8 @@ class TVM_DLL TexturePool {
   DLDeviceType device_type_;
   /*! \brief The device API */
   DeviceAPI* device_;
+  /*! \brief See SetMaxCachedBytes */
+  size_t max_cached_bytes_;
 };
 
 }  // namespace runtime
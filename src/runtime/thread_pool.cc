@@ -34,6 +34,7 @@
 #endif
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <memory>
@@ -43,6 +44,7 @@
 #include <thread>
 #include <vector>
 
+#include "../support/mpmc_queue.h"
 #include "../support/utils.h"
 const constexpr int kL1CacheBytes = 64;
 
@@ -60,10 +62,65 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+/*!
+ * \brief Get the number of tasks each worker is given under work stealing.
+ *  Zero (the default) keeps the static partitioning of tasks across workers.
+ */
+/*!
+ * \brief Get the NUMA node the workers of a new pool are bound to, from TVM_NUMA_NODE.
+ *  "auto" assigns the nodes to pools in a round-robin fashion in creation order.
+ * \return The node, or -1 to keep the default affinity.
+ */
+int GetPoolNumaNode() {
+  const char* val = getenv("TVM_NUMA_NODE");
+  if (!val) {
+    return -1;
+  }
+  int num_nodes = static_cast<int>(threading::NumaNodeCpus().size());
+  if (std::string(val) == "auto") {
+    static std::atomic<int> next_pool{0};
+    return next_pool.fetch_add(1) % num_nodes;
+  }
+  int node = atoi(val);
+  if (node < 0 || node >= num_nodes) {
+    LOG(WARNING) << "TVM_NUMA_NODE=" << val << " is out of range, the system has " << num_nodes
+                 << " NUMA nodes";
+    return -1;
+  }
+  return node;
+}
+
+/*!
+ * \brief Get the wait policy of the workers from TVM_THREAD_POOL_WAIT_POLICY, which is "fixed"
+ *  (the default) or "adaptive".
+ */
+int GetWaitPolicy() {
+  const char* val = getenv("TVM_THREAD_POOL_WAIT_POLICY");
+  if (val && std::string(val) == "adaptive") {
+    return threading::kAdaptiveSpin;
+  }
+  return threading::kFixedSpin;
+}
+
+/*! \brief The steady clock in nanoseconds. */
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int GetWorkStealingChunks() {
+  const char* val = getenv("TVM_THREAD_POOL_WORK_STEALING");
+  if (!val) {
+    return 0;
+  }
+  return std::max(atoi(val), 0);
+}
+
 }  // namespace
 
 // stride in the page, fit to cache line.
-constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
+using threading::kSyncStride;
 
 /*!
  * \brief Thread local main environment.
@@ -95,9 +152,49 @@ class ParallelLauncher {
     }
   }
   ~ParallelLauncher() { delete[] sync_counter_; }
+  /*!
+   * \brief Enable work stealing for the current request.
+   *  The tasks are split into `num_slots` contiguous ranges, one per participating worker.
+   * \param num_slots The number of workers running the request.
+   */
+  void InitStealing(int num_slots) {
+    if (static_cast<size_t>(num_slots) > num_steal_ranges_) {
+      steal_ranges_.reset(new StealRange[num_slots]);
+      num_steal_ranges_ = num_slots;
+    }
+    int num_task = env.num_task;
+    for (int i = 0; i < num_slots; ++i) {
+      steal_ranges_[i].next.store(static_cast<int64_t>(num_task) * i / num_slots,
+                                  std::memory_order_relaxed);
+      steal_ranges_[i].end = static_cast<int64_t>(num_task) * (i + 1) / num_slots;
+    }
+    num_slots_ = num_slots;
+    // Barriers need every task to run concurrently, which is not the case under stealing.
+    env.sync_handle = nullptr;
+    num_running_slots_.store(num_slots, std::memory_order_release);
+  }
+  /*!
+   * \brief Run the tasks of a slot, then steal the remaining tasks of the other slots.
+   * \param slot The slot owned by the calling worker.
+   */
+  void RunStealing(int slot) {
+    for (int k = 0; k < num_slots_; ++k) {
+      StealRange& range = steal_ranges_[(slot + k) % num_slots_];
+      while (true) {
+        int64_t task_id = range.next.fetch_add(1, std::memory_order_relaxed);
+        if (task_id >= range.end) break;
+        if ((*flambda)(static_cast<int>(task_id), &env, cdata) == 0) {
+          SignalJobFinish();
+        } else {
+          SignalJobError(static_cast<int>(task_id));
+        }
+      }
+    }
+    num_running_slots_.fetch_sub(1, std::memory_order_release);
+  }
   // Wait n jobs to finish
   int WaitForJobs() {
-    while (num_pending_.load() != 0) {
+    while (num_pending_.load() != 0 || num_running_slots_.load(std::memory_order_acquire) != 0) {
       tvm::runtime::threading::Yield();
     }
     if (!has_error_.load()) return 0;
@@ -130,8 +227,15 @@ class ParallelLauncher {
   // Whether this thread is worker of the pool.
   // used to prevent recursive launch.
   bool is_worker{false};
+  // Whether the current request is executed with work stealing.
+  bool stealing{false};
 
  private:
+  // The range of task ids that has not been claimed yet, padded to a cache line.
+  struct alignas(kL1CacheBytes) StealRange {
+    std::atomic<int64_t> next{0};
+    int64_t end{0};
+  };
   // The pending jobs.
   std::atomic<int32_t> num_pending_;
   // Whether error has been countered.
@@ -140,6 +244,12 @@ class ParallelLauncher {
   std::atomic<int32_t>* sync_counter_{nullptr};
   // The error message
   std::vector<std::string> par_errors_;
+  // The task ranges of each slot under work stealing.
+  std::unique_ptr<StealRange[]> steal_ranges_;
+  size_t num_steal_ranges_{0};
+  int num_slots_{0};
+  // The number of slots that are still claiming tasks.
+  std::atomic<int32_t> num_running_slots_{0};
 };
 
 /*! \brief Lock-free single-producer-single-consumer queue for each thread */
@@ -151,26 +261,16 @@ class SpscTaskQueue {
     int32_t task_id;
   };
 
-  SpscTaskQueue() : buffer_(new Task[kRingSize]), head_(0), tail_(0) {}
-
-  ~SpscTaskQueue() { delete[] buffer_; }
+  SpscTaskQueue() : queue_(kCapacity) {}
 
   /*!
    * \brief Push a task into the queue and notify the comsumer if it is on wait.
    * \param input The task to be dequeued.
    */
-  void Push(const Task& input) {
-    while (!Enqueue(input)) {
-      tvm::runtime::threading::Yield();
-    }
-    if (pending_.fetch_add(1) == -1) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      cv_.notify_one();
-    }
-  }
+  void Push(const Task& input) { queue_.Push(input); }
 
   /*!
-   * \brief Pop a task out of the queue and condition wait if no tasks.
+   * \brief Pop a task out of the queue and park on a futex if no tasks.
    * \param output The pointer to the task to be dequeued.
    * \param spin_count The number of iterations to spin before sleep.
    * \return Whether pop is successful (true) or we need to exit now (false).
@@ -179,87 +279,68 @@ class SpscTaskQueue {
     // Busy wait a bit when the queue is empty.
     // If a new task comes to the queue quickly, this wait avoid the worker from sleeping.
     // The default spin count is set by following the typical omp convention
-    for (uint32_t i = 0; i < spin_count && pending_.load() == 0; ++i) {
-      tvm::runtime::threading::Yield();
-    }
-    if (pending_.fetch_sub(1) == 0) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      cv_.wait(lock, [this] { return pending_.load() >= 0 || exit_now_.load(); });
-    }
-    if (exit_now_.load(std::memory_order_relaxed)) {
-      return false;
-    }
-    const uint32_t head = head_.load(std::memory_order_relaxed);
-    // sanity check if the queue is empty
-    ICHECK(tail_.load(std::memory_order_acquire) != head);
-    *output = buffer_[head];
-    head_.store((head + 1) % kRingSize, std::memory_order_release);
-    return true;
+    return queue_.Pop(output, spin_count);
   }
 
   /*!
-   * \brief Signal to terminate the worker.
+   * \brief Pop a task if there is one, without waiting.
+   * \param output The pointer to the task to be dequeued.
+   * \return Whether a task is popped.
    */
-  void SignalForKill() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    exit_now_.store(true);
-    cv_.notify_all();
-  }
+  bool TryPop(Task* output) { return queue_.TryPop(output); }
 
- protected:
   /*!
-   * \brief Lock-free enqueue.
-   * \param input The task to be enqueued.
-   * \return Whether the task is enqueued.
+   * \brief Wake the worker with an empty task, unless it has a task already.
    */
-  bool Enqueue(const Task& input) {
-    if (exit_now_.load(std::memory_order_relaxed)) return false;
-
-    const uint32_t tail = tail_.load(std::memory_order_relaxed);
-
-    if ((tail + 1) % kRingSize != (head_.load(std::memory_order_acquire))) {
-      buffer_[tail] = input;
-      tail_.store((tail + 1) % kRingSize, std::memory_order_release);
-      return true;
-    }
-    return false;
-  }
-
-  // the cache line paddings are used for avoid false sharing between atomic variables
-  typedef char cache_line_pad_t[kL1CacheBytes];
-  cache_line_pad_t pad0_;
-  // size of the queue, the queue can host size_ - 1 items at most
-  // define it as a constant for better compiler optimization
-  static constexpr const int kRingSize = 2;
-  // pointer to access the item
-  Task* const buffer_;
+  void Wake() { queue_.TryPush(Task{nullptr, -1}); }
 
-  cache_line_pad_t pad1_;
-  // queue head, where one gets a task from the queue
-  std::atomic<uint32_t> head_;
+  /*!
+   * \brief Signal to terminate the worker.
+   */
+  void SignalForKill() { queue_.Close(); }
 
-  cache_line_pad_t pad2_;
-  // queue tail, when one puts a task to the queue
-  std::atomic<uint32_t> tail_;
+  /*! \brief Whether the worker is terminated. */
+  bool Killed() const { return queue_.Closed(); }
 
-  cache_line_pad_t pad3_;
-  // pending tasks in the queue
-  std::atomic<int8_t> pending_{0};
+ protected:
+  // The queue can host one task, as the launcher only hands a worker one task at a time.
+  static constexpr const int kCapacity = 1;
+  // The lock-free queue, whose consumer parks on a futex when it is empty.
+  support::MPMCQueue<Task> queue_;
+};
 
-  cache_line_pad_t pad4_;
-  // signal for exit now
-  std::atomic<bool> exit_now_{false};
+/*!
+ * \brief The adaptive wait of a worker. It spins for about twice the recent idle gaps of the
+ *  worker when they are short, which keeps the wakeup latency of spinning for back-to-back
+ *  launches, and only briefly when they are long, so that an idle worker does not burn a core.
+ */
+class AdaptiveSpin {
+ public:
+  /*! \brief The nanoseconds to spin before sleeping in the next wait. */
+  int64_t SpinBudgetNs() const {
+    if (avg_gap_ns_ > kMaxSpinNs) return kMinSpinNs;
+    return std::min(static_cast<int64_t>(2 * avg_gap_ns_) + kMinSpinNs, kMaxSpinNs);
+  }
+  /*! \brief Record the idle gap of a wait that got a task. */
+  void Observe(int64_t gap_ns) { avg_gap_ns_ += (gap_ns - avg_gap_ns_) / 8; }
 
-  // internal mutex
-  std::mutex mutex_;
-  // cv for consumer
-  std::condition_variable cv_;
+ private:
+  // The spin of a wait when the gaps are long, which still catches a task that is about to come.
+  static constexpr int64_t kMinSpinNs = 5000;
+  // The longest spin, beyond which sleeping costs less than the spin.
+  static constexpr int64_t kMaxSpinNs = 1000000;
+  // The moving average of the idle gaps.
+  double avg_gap_ns_ = 0;
 };
 
 // The thread pool
 class ThreadPool {
  public:
-  ThreadPool() : num_workers_(tvm::runtime::threading::MaxConcurrency()) {
+  ThreadPool()
+      : num_workers_(tvm::runtime::threading::MaxConcurrency()),
+        work_stealing_chunks_(GetWorkStealingChunks()),
+        wait_policy_(GetWaitPolicy()),
+        numa_node_(GetPoolNumaNode()) {
     const char* exclude_worker0 = getenv("TVM_EXCLUDE_WORKER0");
     if (exclude_worker0 && atoi(exclude_worker0) == 0) {
       exclude_worker0_ = false;
@@ -288,6 +369,9 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    if (work_stealing_chunks_ > 0) {
+      return LaunchStealing(launcher, flambda, cdata, num_task);
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -319,6 +403,35 @@ class ThreadPool {
 
   static ThreadPool* ThreadLocal() { return dmlc::ThreadLocalStore<ThreadPool>::Get(); }
 
+  /*!
+   * \brief Configure work stealing.
+   * \param chunks_per_worker The number of tasks created per worker, zero disables stealing.
+   */
+  void SetWorkStealing(int chunks_per_worker) {
+    work_stealing_chunks_ = std::max(chunks_per_worker, 0);
+  }
+
+  /*!
+   * \brief Configure how the idle workers wait for tasks.
+   * \param policy The threading::WaitPolicy.
+   */
+  void SetWaitPolicy(int policy) {
+    ICHECK(policy == threading::kFixedSpin || policy == threading::kAdaptiveSpin)
+        << "ValueError: Unknown wait policy " << policy;
+    wait_policy_.store(policy, std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief Keep the idle workers spinning for a while, waking the ones that sleep.
+   * \param milliseconds How long the workers keep spinning.
+   */
+  void KeepWarm(int64_t milliseconds) {
+    keep_warm_until_ns_.store(NowNs() + milliseconds * 1000000, std::memory_order_relaxed);
+    for (int i = exclude_worker0_; i < num_workers_; ++i) {
+      queues_[i]->Wake();
+    }
+  }
+
   void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
                                  const std::vector<unsigned int>& cpus) {
     // this will also reset the affinity of the ThreadGroup
@@ -341,7 +454,81 @@ class ThreadPool {
     threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
         num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
         exclude_worker0_ /* include_main_thread */);
-    num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    if (numa_node_ >= 0) {
+      // Keep the workers and the launching thread on one node, so that the memory
+      // they first touch stays local to the node.
+      num_workers_used_ =
+          threads_->Configure(threading::ThreadGroup::kSpecifyOneCorePerThread, 0,
+                              exclude_worker0_, threading::NumaNodeCpus()[numa_node_]);
+      num_workers_used_ = std::min(num_workers_, num_workers_used_);
+    } else {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    }
+  }
+
+  /*!
+   * \brief Launch with work stealing.
+   *
+   *  Every worker is given a range of `work_stealing_chunks_` tasks. Once a worker
+   *  has finished its own range it claims the remaining tasks of its peers, so
+   *  imbalanced tasks no longer wait on the slowest worker.
+   */
+  int LaunchStealing(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata,
+                     int num_task) {
+    if (num_task == 0) {
+      num_task = num_workers_used_ * work_stealing_chunks_;
+    }
+    int num_slots = std::min(num_task, num_workers_used_);
+    // Allocate the sync counters anyway so that they stay large enough for later
+    // launches with static partitioning; they are not exposed to the tasks.
+    launcher->Init(flambda, cdata, num_task, /*need_sync=*/true);
+    launcher->InitStealing(num_slots);
+    launcher->stealing = true;
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    for (int i = exclude_worker0_; i < num_slots; ++i) {
+      tsk.task_id = i;
+      queues_[i]->Push(tsk);
+    }
+    if (exclude_worker0_) {
+      launcher->RunStealing(0);
+    }
+    int res = launcher->WaitForJobs();
+    launcher->stealing = false;
+    return res;
+  }
+
+  /*!
+   * \brief Wait for the next task of a worker.
+   * \param queue The queue of the worker.
+   * \param task The pointer to the task.
+   * \param spin_count The spin count of the fixed policy.
+   * \param adaptive The adaptive wait state of the worker.
+   * \return Whether a task is popped (true) or the worker needs to exit now (false).
+   */
+  bool WaitForTask(SpscTaskQueue* queue, SpscTaskQueue::Task* task, uint32_t spin_count,
+                   AdaptiveSpin* adaptive) {
+    int policy = wait_policy_.load(std::memory_order_relaxed);
+    int64_t warm_until = keep_warm_until_ns_.load(std::memory_order_relaxed);
+    if (policy == threading::kFixedSpin && warm_until == 0) {
+      return queue->Pop(task, spin_count);
+    }
+    int64_t start = NowNs();
+    int64_t deadline = policy == threading::kAdaptiveSpin ? start + adaptive->SpinBudgetNs() : 0;
+    deadline = std::max(deadline, warm_until);
+    bool popped = false;
+    while (!(popped = queue->TryPop(task)) && !queue->Killed() && NowNs() < deadline) {
+      tvm::runtime::threading::Yield();
+    }
+    if (!popped && policy == threading::kFixedSpin) {
+      popped = queue->Pop(task, spin_count);
+    } else if (!popped) {
+      popped = queue->Pop(task, /*spin_count=*/0);
+    }
+    if (popped && task->launcher != nullptr) {
+      adaptive->Observe(NowNs() - start);
+    }
+    return popped;
   }
 
   // Internal worker function.
@@ -351,10 +538,18 @@ class ThreadPool {
     ParallelLauncher::ThreadLocal()->is_worker = true;
     // Initialize the spin count (from envvar TVM_THREAD_POOL_SPIN_COUNT) on
     // the global first use of the ThreadPool.
-    // TODO(tulloch): should we make this configurable via standard APIs?
     static size_t spin_count = GetSpinCount();
-    while (queue->Pop(&task, spin_count)) {
-      ICHECK(task.launcher != nullptr);
+    AdaptiveSpin adaptive;
+    while (WaitForTask(queue, &task, spin_count, &adaptive)) {
+      if (task.launcher == nullptr) {
+        // The worker is woken up to keep warm.
+        continue;
+      }
+      if (task.launcher->stealing) {
+        // Under work stealing the task id is the slot of the worker.
+        task.launcher->RunStealing(task.task_id);
+        continue;
+      }
       TVMParallelGroupEnv* penv = &(task.launcher->env);
       void* cdata = task.launcher->cdata;
       if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
@@ -367,15 +562,169 @@ class ThreadPool {
   int num_workers_;
   // number of workers used (can be restricted with affinity pref)
   int num_workers_used_;
+  // the number of tasks per worker under work stealing, 0 means static partitioning
+  int work_stealing_chunks_;
+  // the threading::WaitPolicy of the idle workers
+  std::atomic<int> wait_policy_;
+  // the steady clock time in nanoseconds until which the idle workers keep spinning
+  std::atomic<int64_t> keep_warm_until_ns_{0};
+  // the NUMA node the workers are bound to, -1 if they are not bound to a node
+  int numa_node_;
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
   std::vector<std::unique_ptr<SpscTaskQueue>> queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
 };
 
+/*!
+ * \brief A process-wide thread pool that is shared by all launching threads.
+ *
+ *  Enabled by setting TVM_THREAD_POOL_SHARED=1. Instead of every application
+ *  thread owning its own ThreadPool, all launches go to one set of workers:
+ *
+ *  - Each launch is published as a job whose tasks are claimed one at a time.
+ *  - Idle workers join the job with the fewest helpers, so concurrent launches
+ *    from different host threads get a fair share of the pool.
+ *  - The launching thread always runs tasks of its own job, so a launch from
+ *    inside a task (a nested parallel region) makes progress on the calling
+ *    worker and is sped up by whichever workers are idle.
+ *
+ *  As tasks of a job do not necessarily run concurrently, barriers are not
+ *  supported in this mode.
+ */
+class SharedThreadPool {
+ public:
+  SharedThreadPool()
+      : num_workers_(std::max(tvm::runtime::threading::MaxConcurrency() - 1, 1)),
+        spin_count_(GetSpinCount()) {
+    threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
+        num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
+        /*exclude_worker0=*/false);
+    // The workers are not bound to cores, since the launching threads are not either
+    // and any of them may run alongside the workers.
+  }
+
+  static SharedThreadPool* Global() {
+    // NOTE: explicitly use new to avoid exit-time destruction of the workers.
+    static auto* inst = new SharedThreadPool();
+    return inst;
+  }
+
+  /*! \brief Whether launches should use the shared pool. */
+  static bool Enabled() {
+    static bool enabled = [] {
+      const char* val = getenv("TVM_THREAD_POOL_SHARED");
+      return val != nullptr && atoi(val) != 0;
+    }();
+    return enabled;
+  }
+
+  int Launch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+    Job job;
+    job.flambda = flambda;
+    job.cdata = cdata;
+    job.num_task = num_task == 0 ? num_workers_ + 1 : num_task;
+    job.num_pending.store(job.num_task);
+    job.env.num_task = job.num_task;
+    job.env.sync_handle = nullptr;
+    job.num_helpers.store(1);
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      jobs_.push_back(&job);
+      num_jobs_.fetch_add(1, std::memory_order_release);
+    }
+    cv_.notify_all();
+    job.Run();
+    Retire(&job);
+    job.num_helpers.fetch_sub(1);
+    // Wait until every claimed task is done and no worker refers to the job anymore.
+    while (job.num_pending.load() != 0 || job.num_helpers.load() != 0) {
+      tvm::runtime::threading::Yield();
+    }
+    if (!job.has_error.load()) return 0;
+    TVMAPISetLastError(job.errors.c_str());
+    return -1;
+  }
+
+ private:
+  struct Job {
+    FTVMParallelLambda flambda;
+    void* cdata;
+    TVMParallelGroupEnv env;
+    int32_t num_task;
+    // The next task to be claimed.
+    std::atomic<int32_t> next_task{0};
+    // The number of tasks that have not finished.
+    std::atomic<int32_t> num_pending{0};
+    // The number of threads that may still access the job.
+    std::atomic<int32_t> num_helpers{0};
+    std::atomic<bool> has_error{false};
+    std::mutex error_mu;
+    std::string errors;
+
+    // Claim and run tasks until all of them are claimed.
+    void Run() {
+      while (true) {
+        int32_t task_id = next_task.fetch_add(1, std::memory_order_relaxed);
+        if (task_id >= num_task) return;
+        if ((*flambda)(task_id, &env, cdata) != 0) {
+          std::lock_guard<std::mutex> lock(error_mu);
+          errors += "Task " + std::to_string(task_id) + " error: " + TVMGetLastError() + '\n';
+          has_error.store(true);
+        }
+        num_pending.fetch_sub(1);
+      }
+    }
+  };
+
+  // Remove a job whose tasks have all been claimed from the list of jobs.
+  void Retire(Job* job) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) {
+      jobs_.erase(it);
+      num_jobs_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  void RunWorker(int worker_id) {
+    ParallelLauncher::ThreadLocal()->is_worker = true;
+    while (true) {
+      for (uint32_t i = 0; i < spin_count_ && num_jobs_.load(std::memory_order_acquire) == 0;
+           ++i) {
+        tvm::runtime::threading::Yield();
+      }
+      Job* job = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return !jobs_.empty(); });
+        // Help the job with the fewest helpers for fairness across launches.
+        job = *std::min_element(jobs_.begin(), jobs_.end(), [](const Job* a, const Job* b) {
+          return a->num_helpers.load() < b->num_helpers.load();
+        });
+        job->num_helpers.fetch_add(1);
+      }
+      job->Run();
+      Retire(job);
+      job->num_helpers.fetch_sub(1);
+    }
+  }
+
+  int num_workers_;
+  uint32_t spin_count_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // The jobs that still have unclaimed tasks.
+  std::vector<Job*> jobs_;
+  std::atomic<int32_t> num_jobs_{0};
+  std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
+};
+
 /*!
  * \brief args[0] is the AffinityMode, args[1] is the number of threads.
  *  args2 is a list of CPUs which is used to set the CPU affinity.
+ *  args3 is optional, the number of tasks per worker under work stealing (0 disables it).
+ *  args4 is optional, the threading::WaitPolicy of the idle workers.
  */
 TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRetValue* rv) {
   threading::ThreadGroup::AffinityMode mode =
@@ -390,6 +739,20 @@ TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRe
     }
   }
   threading::Configure(mode, nthreads, cpus);
+  if (args.num_args >= 4) {
+    threading::SetWorkStealing(args[3]);
+  }
+  if (args.num_args >= 5) {
+    threading::SetWaitPolicy(args[4]);
+  }
+});
+
+TVM_REGISTER_GLOBAL("runtime.threadpool_keep_warm").set_body_typed([](int64_t milliseconds) {
+  threading::KeepWarm(milliseconds);
+});
+
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_numa_node").set_body_typed([](int node) {
+  threading::ConfigureNumaNode(node);
 });
 
 TVM_REGISTER_GLOBAL("runtime.NumThreads").set_body_typed([]() -> int32_t {
@@ -467,11 +830,44 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
 #endif
 }
 int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+void ConfigureNumaNode(int node) {
+  const auto& nodes = NumaNodeCpus();
+  ICHECK(node >= 0 && node < static_cast<int>(nodes.size()))
+      << "NUMA node " << node << " does not exist, the system has " << nodes.size() << " nodes";
+  Configure(ThreadGroup::kSpecifyOneCorePerThread, 0, nodes[node]);
+}
+/*! \brief The launcher set by SetParallelLauncher, nullptr for the thread pool. */
+static std::atomic<FParallelLaunch> parallel_launcher{nullptr};
+
+void SetParallelLauncher(FParallelLaunch launcher) {
+  parallel_launcher.store(launcher, std::memory_order_release);
+}
+static FParallelLaunch GetParallelLauncher() {
+  return parallel_launcher.load(std::memory_order_acquire);
+}
+void SetWorkStealing(int chunks_per_worker) {
+#if !TVM_THREADPOOL_USE_OPENMP
+  tvm::runtime::ThreadPool::ThreadLocal()->SetWorkStealing(chunks_per_worker);
+#endif
+}
+void SetWaitPolicy(int policy) {
+#if !TVM_THREADPOOL_USE_OPENMP
+  tvm::runtime::ThreadPool::ThreadLocal()->SetWaitPolicy(policy);
+#endif
+}
+void KeepWarm(int64_t milliseconds) {
+#if !TVM_THREADPOOL_USE_OPENMP
+  tvm::runtime::ThreadPool::ThreadLocal()->KeepWarm(milliseconds);
+#endif
+}
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
 
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  if (auto launcher = tvm::runtime::threading::GetParallelLauncher()) {
+    return launcher(flambda, cdata, num_task);
+  }
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_workers == 1) {
     std::atomic<int32_t> sync_counter{0};
@@ -482,6 +878,9 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
+    if (tvm::runtime::SharedThreadPool::Enabled()) {
+      return tvm::runtime::SharedThreadPool::Global()->Launch(flambda, cdata, num_task);
+    }
     int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
     return res;
 #else
@@ -505,6 +904,10 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
   using tvm::runtime::kSyncStride;
   int num_task = penv->num_task;
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
+  ICHECK(sync_counter != nullptr)
+      << "TVMBackendParallelBarrier is not supported when the thread pool uses work stealing "
+      << "or is shared across threads, unset TVM_THREAD_POOL_WORK_STEALING and "
+      << "TVM_THREAD_POOL_SHARED to run this kernel";
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
   for (int i = 0; i < num_task; ++i) {
     if (i != task_id) {
@@ -35,6 +35,8 @@
 #endif
 #if defined(__linux__)
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 #if defined(__hexagon__)
 extern "C" {
@@ -47,7 +49,10 @@ extern "C" {
 #define HEXAGON_STACK_ALIGNMENT 32
 #endif
 #include <algorithm>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <vector>
 #define CURRENT_THREAD_HANDLE (static_cast<std::thread::native_handle_type>(0))
 namespace tvm {
 namespace runtime {
@@ -434,6 +439,80 @@ int MaxConcurrency() {
   return std::max(max_concurrency, 1);
 }
 
+namespace {
+// Parse a sysfs CPU list such as "0-3,8-11".
+std::vector<unsigned int> ParseCpuList(const std::string& cpulist) {
+  std::vector<unsigned int> cpus;
+  std::istringstream is(cpulist);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    if (range.empty() || range == "\n") continue;
+    size_t dash = range.find('-');
+    unsigned int begin = std::stoul(range.substr(0, dash));
+    unsigned int end = dash == std::string::npos ? begin : std::stoul(range.substr(dash + 1));
+    for (unsigned int cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+}  // namespace
+
+const std::vector<std::vector<unsigned int>>& NumaNodeCpus() {
+  static std::vector<std::vector<unsigned int>> nodes = [] {
+    std::vector<std::vector<unsigned int>> nodes;
+#if defined(__linux__) && !defined(__ANDROID__)
+    for (int node = 0;; ++node) {
+      std::ostringstream filepath;
+      filepath << "/sys/devices/system/node/node" << node << "/cpulist";
+      std::ifstream ifs(filepath.str());
+      if (ifs.fail()) break;
+      std::string cpulist;
+      std::getline(ifs, cpulist);
+      nodes.push_back(ParseCpuList(cpulist));
+    }
+#endif
+    if (nodes.empty()) {
+      std::vector<unsigned int> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+      for (size_t i = 0; i < cpus.size(); ++i) cpus[i] = i;
+      nodes.push_back(cpus);
+    }
+    return nodes;
+  }();
+  return nodes;
+}
+
+int CurrentNumaNode() {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_getcpu)
+  unsigned int cpu = 0, node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return 0;
+}
+
+void BindMemoryToNumaNode(void* ptr, size_t nbytes, int node) {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+  // MPOL_PREFERRED from <linux/mempolicy.h>, the pages are placed on the node when possible.
+  constexpr int kMPolPreferred = 1;
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8) ||  // NOLINT(*)
+      NumaNodeCpus().size() <= 1) {
+    return;
+  }
+  // mbind operates on whole pages, only bind the pages that are fully covered.
+  uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + page_size - 1) / page_size * page_size;
+  uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + nbytes) / page_size * page_size;
+  if (end <= begin) return;
+  unsigned long nodemask = 1UL << node;  // NOLINT(*)
+  if (syscall(SYS_mbind, begin, end - begin, kMPolPreferred, &nodemask, sizeof(nodemask) * 8,
+              0) != 0) {
+    VLOG(1) << "mbind to NUMA node " << node << " failed";
+  }
+#endif
+}
+
 // This global function can be used by disco runtime to bind processes
 // to CPUs.
 TVM_REGISTER_GLOBAL("tvm.runtime.threading.set_current_thread_affinity")
@@ -442,6 +521,14 @@ TVM_REGISTER_GLOBAL("tvm.runtime.threading.set_current_thread_affinity")
                         std::vector<unsigned int>{cpu_ids.begin(), cpu_ids.end()});
     });
 
+TVM_REGISTER_GLOBAL("runtime.NumaNodeCpus").set_body_typed([]() {
+  Array<IntTuple> nodes;
+  for (const std::vector<unsigned int>& cpus : NumaNodeCpus()) {
+    nodes.push_back(IntTuple(std::vector<int64_t>(cpus.begin(), cpus.end())));
+  }
+  return nodes;
+});
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
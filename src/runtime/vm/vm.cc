@@ -394,8 +394,13 @@ inline Allocator* VirtualMachine::GetAllocator(Index device_index) const {
 }
 
 void VirtualMachine::PushFrame(Index arg_count, Index ret_pc, const VMFunction& vm_func) {
-  auto frame = VMFrame(ret_pc, func_index_, arg_count, code_, vm_func.register_file_size);
-  frames_.push_back(frame);
+  std::vector<ObjectRef> register_file;
+  if (!register_file_pool_.empty()) {
+    register_file = std::move(register_file_pool_.back());
+    register_file_pool_.pop_back();
+  }
+  register_file.resize(vm_func.register_file_size);
+  frames_.emplace_back(ret_pc, func_index_, arg_count, code_, std::move(register_file));
 }
 
 Index VirtualMachine::PopFrame() {
@@ -405,6 +410,10 @@ Index VirtualMachine::PopFrame() {
   code_ = fr.code;
   pc_ = fr.pc;
   auto call_stack_size = frames_.size();
+  // Release the registers but keep the capacity of the register file for the next frame.
+  std::vector<ObjectRef> register_file = std::move(frames_.back().register_file);
+  register_file.clear();
+  register_file_pool_.push_back(std::move(register_file));
   frames_.pop_back();
   return call_stack_size;
 }
@@ -496,6 +505,7 @@ void VirtualMachine::LoadExecutable(const ObjectPtr<Executable>& exec) {
   ICHECK(exec->late_bound_constant_names.empty())
       << "Need to load late-bound-constants before creating VM";
   exec_ = exec;
+  storage_cache_.clear();
 
   runtime::Module lib = exec_->GetLib();
 
@@ -528,6 +538,7 @@ void VirtualMachine::Init(const std::vector<Device>& physical_devices,
   const size_t num_virtual_devices = exec_->virtual_devices.size();
   devices_.reserve(num_virtual_devices);
   allocators_.reserve(num_virtual_devices);
+  storage_cache_.clear();
 
   for (size_t device_index = 0; device_index < num_virtual_devices; ++device_index) {
     // We'll retain the legacy behaviour and just match by device type.
@@ -627,6 +638,8 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
   ICHECK(this->code_);
   pc_ = 0;
   Index frame_start = frames_.size();
+  // Drop the result of the previous run, so its storage can be reused once the caller drops it.
+  return_register_ = ObjectRef();
   while (true) {
   main_loop:
     auto const& instr = code_[this->pc_];
@@ -677,11 +690,12 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         goto main_loop;
       }
       case Opcode::Invoke: {
-        std::vector<ObjectRef> args;
+        invoke_args_.clear();
         for (Index i = 0; i < instr.num_args; ++i) {
-          args.push_back(ReadRegister(instr.invoke_args_registers[i]));
+          invoke_args_.push_back(ReadRegister(instr.invoke_args_registers[i]));
         }
-        InvokeGlobal(exec_->functions[instr.func_index], args);
+        InvokeGlobal(exec_->functions[instr.func_index], invoke_args_);
+        invoke_args_.clear();
         frames_.back().caller_return_register = instr.dst;
         goto main_loop;
       }
@@ -722,14 +736,15 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         auto object = ReadRegister(instr.closure);
         const auto* closure = object.as<VMClosureObj>();
         ICHECK(closure);
-        std::vector<ObjectRef> args;
+        invoke_args_.clear();
         for (auto free_var : closure->free_vars) {
-          args.push_back(free_var);
+          invoke_args_.push_back(free_var);
         }
         for (Index i = 0; i < instr.num_closure_args; ++i) {
-          args.push_back(ReadRegister(instr.closure_args[i]));
+          invoke_args_.push_back(ReadRegister(instr.closure_args[i]));
         }
-        InvokeGlobal(exec_->functions[closure->func_index], args);
+        InvokeGlobal(exec_->functions[closure->func_index], invoke_args_);
+        invoke_args_.clear();
         frames_.back().caller_return_register = instr.dst;
         goto main_loop;
       }
@@ -821,10 +836,25 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
       case Opcode::AllocStorage: {
         OpStartHook(instr);
 
-        auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
         Allocator* allocator = GetAllocator(instr.alloc_storage.device_index);
-        Device device = devices_[instr.alloc_storage.device_index];
         ICHECK(allocator) << "Did you forget to init the VirtualMachine with devices?";
+        int64_t size =
+            instr.alloc_storage.ndim > 0 ? -1 : LoadScalarInt(instr.alloc_storage.allocation_size);
+        // A pooled allocator keeps the freed memory anyway, so skip the round trip through it.
+        bool memoize = allocator->type() == AllocatorType::kPooled;
+        if (memoize) {
+          auto it = storage_cache_.find(&instr);
+          if (it != storage_cache_.end() && it->second.second == size &&
+              it->second.first.unique()) {
+            WriteRegister(instr.dst, it->second.first);
+            OpStopHook();
+            pc_++;
+            goto main_loop;
+          }
+        }
+
+        auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
+        Device device = devices_[instr.alloc_storage.device_index];
 
         if (instr.alloc_storage.ndim > 0) {
           std::string shape = "[";
@@ -849,7 +879,6 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
                                                  instr.alloc_storage.dtype_hint, mem_scope);
           storage_obj->allocator = allocator;
         } else {
-          auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
           auto alignment = instr.alloc_storage.alignment;
           VLOG(2) << "allocating with allocation_size=" << size << ", alignment=" << alignment
                   << ", dtype_hint=" << DLDataType2String(instr.alloc_storage.dtype_hint)
@@ -859,6 +888,9 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
           storage_obj->allocator = allocator;
         }
         Storage storage(storage_obj);
+        if (memoize) {
+          storage_cache_[&instr] = std::make_pair(storage, size);
+        }
         WriteRegister(instr.dst, storage);
         OpStopHook();
         pc_++;
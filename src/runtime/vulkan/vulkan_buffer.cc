@@ -20,6 +20,7 @@
 #include "vulkan_buffer.h"
 
 #include <utility>
+#include <vector>
 
 #include "vulkan_device_api.h"
 
@@ -42,6 +43,14 @@ VulkanBuffer::VulkanBuffer(const VulkanDevice& device, size_t nbytes, VkBufferUs
     : device_(device) {
   // Create a buffer
   VkBufferCreateInfo buffer_info = MakeBufferCreateInfo(nbytes, usage);
+  // Buffers are accessed by both the compute and the transfer queue
+  // families, if a separate transfer queue is used.
+  const std::vector<uint32_t>& queue_families = device.SharedQueueFamilyIndices();
+  if (queue_families.size() > 1) {
+    buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    buffer_info.queueFamilyIndexCount = queue_families.size();
+    buffer_info.pQueueFamilyIndices = queue_families.data();
+  }
   VULKAN_CALL(vkCreateBuffer(device, &buffer_info, nullptr, &buffer));
 
   // Allocate memory
@@ -25,6 +25,7 @@
 #include <utility>
 
 #include "../../support/utils.h"
+#include "../file_utils.h"
 #include "vulkan_common.h"
 #include "vulkan_device.h"
 #include "vulkan_device_api.h"
@@ -70,6 +71,8 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR};
 
   // Set up linked list for feature query
   {
@@ -86,6 +89,10 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       *pp_next = &float16_int8;
       pp_next = &float16_int8.pNext;
     }
+    if (device.HasExtension("VK_KHR_timeline_semaphore")) {
+      *pp_next = &timeline_semaphore;
+      pp_next = &timeline_semaphore.pNext;
+    }
   }
 
   if (instance.HasExtension("VK_KHR_get_physical_device_properties2")) {
@@ -136,6 +143,12 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
 
   supports_cooperative_matrix = device.HasExtension("VK_NV_cooperative_matrix");
 
+  // Support is available based on this extension, but allow it to
+  // be disabled based on an environment variable.
+  supports_timeline_semaphore =
+      device.HasExtension("VK_KHR_timeline_semaphore") && timeline_semaphore.timelineSemaphore &&
+      !support::BoolEnvironmentVar("TVM_VULKAN_DISABLE_TIMELINE_SEMAPHORE");
+
   // The check of VK_SHADER_STAGE_COMPUTE_BIT isn't technically
   // needed, since it will be set so long at least one queue has
   // VK_QUEUE_COMPUTE_BIT.  Including it to avoid potential future
@@ -234,6 +247,13 @@ VulkanGetBufferMemoryRequirements2Functions::VulkanGetBufferMemoryRequirements2F
       vkGetDeviceProcAddr(device, "vkGetBufferMemoryRequirements2KHR"));
 }
 
+VulkanTimelineSemaphoreKHRFunctions::VulkanTimelineSemaphoreKHRFunctions(VkDevice device) {
+  vkGetSemaphoreCounterValueKHR = (PFN_vkGetSemaphoreCounterValueKHR)ICHECK_NOTNULL(
+      vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+  vkWaitSemaphoresKHR =
+      (PFN_vkWaitSemaphoresKHR)ICHECK_NOTNULL(vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+}
+
 VulkanQueueInsertDebugUtilsLabelFunctions::VulkanQueueInsertDebugUtilsLabelFunctions(
     VkInstance instance) {
   vkQueueInsertDebugUtilsLabelEXT = (PFN_vkQueueInsertDebugUtilsLabelEXT)ICHECK_NOTNULL(
@@ -250,6 +270,12 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
 
   enabled_extensions = SelectEnabledExtensions();
   device_properties = VulkanDeviceProperties(instance, *this);
+  // Copies on a separate queue are ordered against the compute queue
+  // with timeline semaphores.
+  if (device_properties.supports_timeline_semaphore &&
+      !support::BoolEnvironmentVar("TVM_VULKAN_DISABLE_TRANSFER_QUEUE")) {
+    transfer_queue_family_index = SelectTransferQueueFamily();
+  }
   CreateVkDevice(instance);
 
   // Currently, any exceptions called after this point will prevent
@@ -259,6 +285,16 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
   // holds the ancillary handles that TVM needs.
 
   vkGetDeviceQueue(device_, queue_family_index, 0, &queue);
+  compute_queues.push_back(queue);
+  for (uint32_t i = 1; i < num_compute_queues_; ++i) {
+    VkQueue extra_queue;
+    vkGetDeviceQueue(device_, queue_family_index, i, &extra_queue);
+    compute_queues.push_back(extra_queue);
+  }
+  if (transfer_queue_family_index != uint32_t(-1)) {
+    vkGetDeviceQueue(device_, transfer_queue_family_index, 0, &transfer_queue);
+    shared_queue_family_indices = {queue_family_index, transfer_queue_family_index};
+  }
 
   // Find suitable memory type for staging and compute
   // Find suitable compute index.
@@ -344,6 +380,11 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
     queue_insert_debug_utils_label_functions =
         std::make_unique<VulkanQueueInsertDebugUtilsLabelFunctions>(instance);
   }
+
+  if (device_properties.supports_timeline_semaphore) {
+    timeline_semaphore_khr_functions =
+        std::make_unique<VulkanTimelineSemaphoreKHRFunctions>(device_);
+  }
 }
 
 VulkanDevice::~VulkanDevice() {
@@ -351,10 +392,17 @@ VulkanDevice::~VulkanDevice() {
   // vkDestroyDevice.  Might be a sign that the VkDevice should be
   // held by member variable rather than beind owned directly by
   // VulkanDevice.
+  active_stream_per_thread.Clear();
   stream_per_thread.Clear();
+  transfer_stream_per_thread.Clear();
   staging_buffer_per_thread.Clear();
   uniform_buffer_per_thread.Clear();
 
+  if (pipeline_cache_ != VK_NULL_HANDLE) {
+    SavePipelineCache();
+    vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
+  }
+
   if (device_) {
     vkDestroyDevice(device_, nullptr);
   }
@@ -384,10 +432,19 @@ void VulkanDevice::do_swap(VulkanDevice&& other) {
             other.get_buffer_memory_requirements_2_functions);
   std::swap(queue_insert_debug_utils_label_functions,
             other.queue_insert_debug_utils_label_functions);
+  std::swap(timeline_semaphore_khr_functions, other.timeline_semaphore_khr_functions);
   std::swap(compute_mtype_index, other.compute_mtype_index);
   std::swap(compute_memory_size, other.compute_memory_size);
   std::swap(queue, other.queue);
   std::swap(queue_family_index, other.queue_family_index);
+  std::swap(compute_queues, other.compute_queues);
+  std::swap(num_compute_queues_, other.num_compute_queues_);
+  std::swap(next_stream_queue, other.next_stream_queue);
+  std::swap(transfer_queue, other.transfer_queue);
+  std::swap(transfer_queue_family_index, other.transfer_queue_family_index);
+  std::swap(shared_queue_family_indices, other.shared_queue_family_indices);
+  std::swap(pipeline_cache_, other.pipeline_cache_);
+  std::swap(pipeline_cache_saved_size_, other.pipeline_cache_saved_size_);
   std::swap(physical_device_, other.physical_device_);
   std::swap(enabled_extensions, other.enabled_extensions);
   std::swap(device_, other.device_);
@@ -396,10 +453,37 @@ void VulkanDevice::do_swap(VulkanDevice&& other) {
 bool VulkanDevice::SupportsCompute() const { return queue_family_index != uint32_t(-1); }
 
 void VulkanDevice::QueueSubmit(VkSubmitInfo submit_info, VkFence fence) const {
+  QueueSubmit(queue, submit_info, fence);
+}
+
+void VulkanDevice::QueueSubmit(VkQueue target_queue, const VkSubmitInfo& submit_info,
+                               VkFence fence) const {
   // Multiple streams (on different threads) use the same VulkanDevice
   // instance, so we need to externally synchronize accesses.
   std::lock_guard<std::mutex> lock(queue_mutex);
-  VULKAN_CALL(vkQueueSubmit(queue, 1, &submit_info, fence));
+  VULKAN_CALL(vkQueueSubmit(target_queue, 1, &submit_info, fence));
+}
+
+void VulkanDevice::WaitTimelineSemaphore(VkSemaphore semaphore, uint64_t value) const {
+  ICHECK(UseTimelineSemaphore());
+  VkSemaphoreWaitInfoKHR wait_info = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+  wait_info.semaphoreCount = 1;
+  wait_info.pSemaphores = &semaphore;
+  wait_info.pValues = &value;
+  uint64_t timeout = 1UL << 30UL;
+  VkResult res;
+  do {
+    res = timeline_semaphore_khr_functions->vkWaitSemaphoresKHR(device_, &wait_info, timeout);
+  } while (res == VK_TIMEOUT);
+  VULKAN_CHECK_ERROR(res);
+}
+
+uint64_t VulkanDevice::GetTimelineSemaphoreValue(VkSemaphore semaphore) const {
+  ICHECK(UseTimelineSemaphore());
+  uint64_t value = 0;
+  VULKAN_CALL(
+      timeline_semaphore_khr_functions->vkGetSemaphoreCounterValueKHR(device_, semaphore, &value));
+  return value;
 }
 
 uint32_t VulkanDevice::SelectComputeQueueFamily() const {
@@ -432,6 +516,23 @@ uint32_t VulkanDevice::SelectComputeQueueFamily() const {
   return -1;
 }
 
+uint32_t VulkanDevice::SelectTransferQueueFamily() const {
+  uint32_t queue_prop_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queue_prop_count, nullptr);
+  std::vector<VkQueueFamilyProperties> queue_props(queue_prop_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queue_prop_count,
+                                           dmlc::BeginPtr(queue_props));
+
+  for (uint32_t i = 0; i != queue_prop_count; ++i) {
+    if (i != queue_family_index && (VK_QUEUE_TRANSFER_BIT & queue_props[i].queueFlags) != 0 &&
+        (VK_QUEUE_COMPUTE_BIT & queue_props[i].queueFlags) == 0 &&
+        (VK_QUEUE_GRAPHICS_BIT & queue_props[i].queueFlags) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 std::vector<const char*> VulkanDevice::SelectEnabledExtensions() const {
   std::vector<const char*> required_extensions{};
   std::vector<const char*> optional_extensions{"VK_KHR_driver_properties",
@@ -445,7 +546,8 @@ std::vector<const char*> VulkanDevice::SelectEnabledExtensions() const {
                                                "VK_KHR_dedicated_allocation",
                                                "VK_KHR_spirv_1_4",
                                                "VK_KHR_shader_integer_dot_product",
-                                               "VK_NV_cooperative_matrix"};
+                                               "VK_NV_cooperative_matrix",
+                                               "VK_KHR_timeline_semaphore"};
 
   uint32_t device_extension_prop_count;
   VULKAN_CALL(vkEnumerateDeviceExtensionProperties(physical_device_, nullptr,
@@ -471,6 +573,8 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR};
 
   void** pp_next = &enabled_features.pNext;
   bool needs_float16_int8 = false;
@@ -507,23 +611,43 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
     *pp_next = &float16_int8;
     pp_next = &float16_int8.pNext;
   }
+  if (device_properties.supports_timeline_semaphore) {
+    timeline_semaphore.timelineSemaphore = true;
+    *pp_next = &timeline_semaphore;
+    pp_next = &timeline_semaphore.pNext;
+  }
 
-  float priority = 1.0f;
+  // Request several queues of the compute family, if available, so
+  // that streams can be executed concurrently.
+  uint32_t queue_prop_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queue_prop_count, nullptr);
+  std::vector<VkQueueFamilyProperties> queue_props(queue_prop_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queue_prop_count,
+                                           dmlc::BeginPtr(queue_props));
+  num_compute_queues_ = std::min(queue_props[queue_family_index].queueCount, kMaxComputeQueues);
+  std::vector<float> priorities(num_compute_queues_, 1.0f);
 
-  struct VkDeviceQueueCreateInfo queue_create_info;
+  std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
+  VkDeviceQueueCreateInfo queue_create_info;
   queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
   queue_create_info.pNext = nullptr;
   queue_create_info.flags = 0;
   queue_create_info.queueFamilyIndex = queue_family_index;
-  queue_create_info.queueCount = 1;
-  queue_create_info.pQueuePriorities = &priority;
+  queue_create_info.queueCount = num_compute_queues_;
+  queue_create_info.pQueuePriorities = priorities.data();
+  queue_create_infos.push_back(queue_create_info);
+  if (transfer_queue_family_index != uint32_t(-1)) {
+    queue_create_info.queueFamilyIndex = transfer_queue_family_index;
+    queue_create_info.queueCount = 1;
+    queue_create_infos.push_back(queue_create_info);
+  }
 
   VkDeviceCreateInfo device_create_info;
   device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   device_create_info.pNext = nullptr;
   device_create_info.flags = 0;
-  device_create_info.queueCreateInfoCount = 1;
-  device_create_info.pQueueCreateInfos = &queue_create_info;
+  device_create_info.queueCreateInfoCount = queue_create_infos.size();
+  device_create_info.pQueueCreateInfos = queue_create_infos.data();
   device_create_info.enabledLayerCount = 0;
   device_create_info.ppEnabledLayerNames = nullptr;
   device_create_info.enabledExtensionCount = enabled_extensions.size();
@@ -544,9 +668,106 @@ VulkanStream& VulkanDevice::ThreadLocalStream() {
 }
 
 const VulkanStream& VulkanDevice::ThreadLocalStream() const {
+  if (VulkanStream* active_stream = ThreadLocalActiveStream()) {
+    return *active_stream;
+  }
+  return ThreadLocalDefaultStream();
+}
+
+void VulkanDevice::SetThreadLocalStream(VulkanStream* stream) {
+  active_stream_per_thread.GetOrMake(nullptr) = stream;
+}
+
+VulkanStream* VulkanDevice::ThreadLocalActiveStream() const {
+  VulkanStream** active_stream = active_stream_per_thread.Get();
+  return active_stream ? *active_stream : nullptr;
+}
+
+VulkanStream& VulkanDevice::ThreadLocalDefaultStream() const {
   return stream_per_thread.GetOrMake(this);
 }
 
+VulkanStream& VulkanDevice::ThreadLocalTransferStream() {
+  ICHECK(UseTransferQueue());
+  return transfer_stream_per_thread.GetOrMake(this, transfer_queue, transfer_queue_family_index);
+}
+
+void VulkanDevice::SynchronizeThreadLocalStreams() {
+  ThreadLocalDefaultStream().Synchronize();
+  if (VulkanStream* active_stream = ThreadLocalActiveStream()) {
+    active_stream->Synchronize();
+  }
+  if (VulkanStream* transfer_stream = transfer_stream_per_thread.Get()) {
+    transfer_stream->Synchronize();
+  }
+}
+
+VulkanStream* VulkanDevice::CreateStream() const {
+  VkQueue stream_queue;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    // The first queue is used by the default streams, so hand out the
+    // other queues first when there are any.
+    if (compute_queues.size() == 1) {
+      stream_queue = compute_queues[0];
+    } else {
+      stream_queue = compute_queues[1 + next_stream_queue++ % (compute_queues.size() - 1)];
+    }
+  }
+  return new VulkanStream(this, stream_queue, queue_family_index);
+}
+
+std::string VulkanDevice::PipelineCacheKey() const {
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physical_device_, &properties);
+  std::string cache_uuid(reinterpret_cast<const char*>(properties.pipelineCacheUUID),
+                         VK_UUID_SIZE);
+  return GetKernelCacheKey({"vulkan_pipeline_cache", std::to_string(properties.vendorID),
+                            std::to_string(properties.deviceID),
+                            std::to_string(properties.driverVersion), properties.deviceName,
+                            cache_uuid});
+}
+
+VkPipelineCache VulkanDevice::PipelineCache() {
+  std::lock_guard<std::mutex> lock(pipeline_cache_mutex_);
+  if (pipeline_cache_ == VK_NULL_HANDLE) {
+    // The driver validates the header of the initial data, and starts
+    // from an empty cache if it was written by another device or
+    // driver version.
+    std::string initial_data;
+    if (LoadKernelCacheEntry(PipelineCacheKey(), &initial_data)) {
+      pipeline_cache_saved_size_ = initial_data.size();
+    }
+    VkPipelineCacheCreateInfo cache_cinfo = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    cache_cinfo.initialDataSize = initial_data.size();
+    cache_cinfo.pInitialData = initial_data.data();
+    VULKAN_CALL(vkCreatePipelineCache(device_, &cache_cinfo, nullptr, &pipeline_cache_));
+  }
+  return pipeline_cache_;
+}
+
+void VulkanDevice::SavePipelineCache() {
+  std::lock_guard<std::mutex> lock(pipeline_cache_mutex_);
+  if (pipeline_cache_ == VK_NULL_HANDLE || GetKernelCacheDir().empty()) {
+    return;
+  }
+  size_t size = 0;
+  VULKAN_CALL(vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr));
+  // Drivers only append to the cache, so an unchanged size means
+  // that no pipeline was added.
+  if (size == pipeline_cache_saved_size_) {
+    return;
+  }
+  std::string data(size, '\0');
+  VkResult res = vkGetPipelineCacheData(device_, pipeline_cache_, &size, &data[0]);
+  if (res != VK_INCOMPLETE) {
+    VULKAN_CHECK_ERROR(res);
+  }
+  data.resize(size);
+  SaveKernelCacheEntry(PipelineCacheKey(), data);
+  pipeline_cache_saved_size_ = size;
+}
+
 VulkanStagingBuffer& VulkanDevice::ThreadLocalStagingBuffer(size_t min_size) {
   auto usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
   VulkanStagingBuffer& result =
@@ -57,6 +57,13 @@ struct VulkanGetBufferMemoryRequirements2Functions {
   PFN_vkGetBufferMemoryRequirements2KHR vkGetBufferMemoryRequirements2KHR{nullptr};
 };
 
+struct VulkanTimelineSemaphoreKHRFunctions {
+  explicit VulkanTimelineSemaphoreKHRFunctions(VkDevice device);
+
+  PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR{nullptr};
+  PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR{nullptr};
+};
+
 struct VulkanQueueInsertDebugUtilsLabelFunctions {
   explicit VulkanQueueInsertDebugUtilsLabelFunctions(VkInstance instance);
 
@@ -89,6 +96,7 @@ struct VulkanDeviceProperties {
   bool supports_dedicated_allocation{false};
   bool supports_integer_dot_product{false};
   bool supports_cooperative_matrix{false};
+  bool supports_timeline_semaphore{false};
   uint32_t supported_subgroup_operations{0};
   uint32_t max_num_threads{1};
   uint32_t thread_warp_size{1};
@@ -162,6 +170,29 @@ class VulkanDevice {
    */
   void QueueSubmit(VkSubmitInfo submit_info, VkFence fence) const;
 
+  /*! \brief Calls vkQueueSubmit on a specific queue of the device
+   *
+   * \param queue The compute or transfer queue to submit to.
+   *
+   * \param submit_info The job submission information to be passed to
+   * vkQueueSubmit.
+   *
+   * \param fence Optional fence to be passed to vkQueueSubmit.
+   */
+  void QueueSubmit(VkQueue queue, const VkSubmitInfo& submit_info, VkFence fence) const;
+
+  /*! \brief Block the host until a timeline semaphore reaches a value
+   *
+   * Requires UseTimelineSemaphore().
+   */
+  void WaitTimelineSemaphore(VkSemaphore semaphore, uint64_t value) const;
+
+  /*! \brief Return the current value of a timeline semaphore
+   *
+   * Requires UseTimelineSemaphore().
+   */
+  uint64_t GetTimelineSemaphoreValue(VkSemaphore semaphore) const;
+
   /*! \brief Checks if the device has an extension enabled
    *
    * Returns true if the device was initialized with the extension
@@ -171,12 +202,68 @@ class VulkanDevice {
    */
   bool HasExtension(const char* query) const;
 
-  //! \brief Return the VulkanStream for the current CPU thread
+  /*! \brief Return the VulkanStream for the current CPU thread
+   *
+   * This is the stream set by SetThreadLocalStream if any, and the
+   * default stream of the thread otherwise.
+   */
   VulkanStream& ThreadLocalStream();
 
   //! \brief Return the VulkanStream for the current CPU thread
   const VulkanStream& ThreadLocalStream() const;
 
+  /*! \brief Set the stream used by the current CPU thread
+   *
+   * \param stream The stream to use, or nullptr to go back to the
+   * default stream of the thread.
+   */
+  void SetThreadLocalStream(VulkanStream* stream);
+
+  //! \brief Return the stream set by SetThreadLocalStream, or nullptr if none is set.
+  VulkanStream* ThreadLocalActiveStream() const;
+
+  //! \brief Return the default VulkanStream of the current CPU thread
+  VulkanStream& ThreadLocalDefaultStream() const;
+
+  /*! \brief Return the VulkanStream on the transfer queue for the
+   * current CPU thread
+   *
+   * Requires UseTransferQueue().
+   */
+  VulkanStream& ThreadLocalTransferStream();
+
+  /*! \brief Synchronize the streams of the current CPU thread
+   *
+   * Synchronizes the default stream, the stream set by
+   * SetThreadLocalStream and, if it was used, the transfer stream of
+   * the thread.
+   */
+  void SynchronizeThreadLocalStreams();
+
+  /*! \brief Create a new stream
+   *
+   * Streams are assigned to the compute queues of the device in a
+   * round-robin order, so that independent streams can run
+   * concurrently on devices exposing several compute queues.  The
+   * caller owns the returned stream.
+   */
+  VulkanStream* CreateStream() const;
+
+  /*! \brief Return the VkPipelineCache used to create compute pipelines
+   *
+   * The cache is created on first use.  If a kernel cache directory is
+   * set (see GetKernelCacheDir), it is initialized with the cache data
+   * saved by an earlier process for the same device and driver.
+   */
+  VkPipelineCache PipelineCache();
+
+  /*! \brief Save the pipeline cache to the kernel cache directory
+   *
+   * Does nothing if the kernel cache is disabled, or if no pipeline was
+   * added to the cache since it was loaded or last saved.
+   */
+  void SavePipelineCache();
+
   /*! \brief Return the staging buffer for the current CPU thread
    *
    * This function may re-allocate the staging buffer depending on the
@@ -233,8 +320,26 @@ class VulkanDevice {
 
   bool UseDebugUtilsLabel() const { return queue_insert_debug_utils_label_functions != nullptr; }
 
+  bool UseTimelineSemaphore() const { return timeline_semaphore_khr_functions != nullptr; }
+
+  bool UseTransferQueue() const { return transfer_queue != nullptr; }
+
   VkQueue Queue() const { return queue; }
 
+  /*! \brief The queue families that buffers are shared between
+   *
+   * Contains the compute and the transfer queue families when a
+   * separate transfer queue family is used, and is empty otherwise.
+   */
+  const std::vector<uint32_t>& SharedQueueFamilyIndices() const {
+    return shared_queue_family_indices;
+  }
+
+  std::unique_ptr<VulkanTimelineSemaphoreKHRFunctions> timeline_semaphore_khr_functions{nullptr};
+
+  // queue family index of the dedicated transfer queue, uint32_t(-1) if not used.
+  uint32_t transfer_queue_family_index{uint32_t(-1)};
+
  private:
   /*! \brief Helper function for move assignment/construction
    *
@@ -248,6 +353,18 @@ class VulkanDevice {
    */
   uint32_t SelectComputeQueueFamily() const;
 
+  /*! \brief Returns a queue family dedicated to transfers, or
+   * uint32_t(-1) if the device has none.
+   *
+   * A family with the transfer capability but neither compute nor
+   * graphics capabilities is backed by a copy engine, and can run
+   * uploads and readbacks concurrently with the compute queue.
+   */
+  uint32_t SelectTransferQueueFamily() const;
+
+  //! \brief The key of the pipeline cache in the kernel cache directory
+  std::string PipelineCacheKey() const;
+
   /*! \brief Returns the extensions to be enabled.
    *
    * All char* in the returned vector point to static memory
@@ -277,6 +394,12 @@ class VulkanDevice {
   //! \brief Handle to the Vulkan API logical device
   VkDevice device_{nullptr};
 
+  //! \brief The maximum number of queues requested from the compute queue family
+  static constexpr uint32_t kMaxComputeQueues = 4;
+
+  //! \brief The number of queues created from the compute queue family
+  uint32_t num_compute_queues_{1};
+
   //! \brief Mutex to protect access to queue
   mutable std::mutex queue_mutex;
 
@@ -287,6 +410,22 @@ class VulkanDevice {
    */
   VkQueue queue{nullptr};
 
+  /*! \brief All queues created from the compute queue family
+   *
+   * compute_queues[0] is `queue`.  Streams created by CreateStream
+   * are distributed over these queues.
+   */
+  std::vector<VkQueue> compute_queues;
+
+  //! \brief The compute queue of the next stream created by CreateStream
+  mutable uint32_t next_stream_queue{0};
+
+  //! \brief Handle to the dedicated transfer queue, nullptr if not used.
+  VkQueue transfer_queue{nullptr};
+
+  //! \brief See SharedQueueFamilyIndices
+  std::vector<uint32_t> shared_queue_family_indices;
+
   /*! \brief The VulkanStream for each CPU thread.
    *
    * To mimic the semantics of cudaSetDevice and cuLaunchKernel, each
@@ -296,6 +435,21 @@ class VulkanDevice {
    */
   mutable ThreadMap<VulkanStream> stream_per_thread;
 
+  //! \brief The stream selected by SetThreadLocalStream for each CPU thread.
+  mutable ThreadMap<VulkanStream*> active_stream_per_thread;
+
+  //! \brief The VulkanStream on the transfer queue for each CPU thread.
+  ThreadMap<VulkanStream> transfer_stream_per_thread;
+
+  //! \brief Mutex to protect the creation and saving of pipeline_cache_
+  std::mutex pipeline_cache_mutex_;
+
+  //! \brief See PipelineCache
+  VkPipelineCache pipeline_cache_{VK_NULL_HANDLE};
+
+  //! \brief The size of the pipeline cache data when it was loaded or last saved
+  size_t pipeline_cache_saved_size_{0};
+
   //! \brief The VulkanStagingBuffer for each CPU thread.
   ThreadMap<VulkanStagingBuffer> staging_buffer_per_thread;
 
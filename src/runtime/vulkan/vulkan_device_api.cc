@@ -173,6 +173,9 @@ void VulkanDeviceAPI::GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv)
       // Not currently implemented.  Will only be implementable for
       // devices that support the VK_EXT_memory_budget extension.
       break;
+
+    case kPeerTopology:
+      break;
   }
 }
 
@@ -258,6 +261,10 @@ void VulkanDeviceAPI::GetTargetProperty(Device dev, const std::string& property,
     *rv = prop.supports_cooperative_matrix;
   }
 
+  if (property == "supports_timeline_semaphore") {
+    *rv = prop.supports_timeline_semaphore;
+  }
+
   if (property == "device_name") {
     *rv = prop.device_name;
   }
@@ -311,39 +318,128 @@ void VulkanDeviceAPI::FreeWorkspace(Device dev, void* data) {
   pool->FreeWorkspace(dev, data);
 }
 
-TVMStreamHandle VulkanDeviceAPI::CreateStream(Device dev) { return nullptr; }
+TVMStreamHandle VulkanDeviceAPI::CreateStream(Device dev) {
+  return device(dev.device_id).CreateStream();
+}
 
 void VulkanDeviceAPI::FreeStream(Device dev, TVMStreamHandle stream) {
-  ICHECK_EQ(stream, static_cast<void*>(nullptr));
+  if (stream == nullptr) {
+    return;
+  }
+  auto& device = this->device(dev.device_id);
+  auto* vk_stream = static_cast<VulkanStream*>(stream);
+  vk_stream->Synchronize();
+  if (device.ThreadLocalActiveStream() == vk_stream) {
+    device.SetThreadLocalStream(nullptr);
+  }
+  delete vk_stream;
 }
 
-// Syncing two streams is a nop, since there is only one stream.
 void VulkanDeviceAPI::SyncStreamFromTo(Device dev, TVMStreamHandle event_src,
                                        TVMStreamHandle event_dst) {
-  ICHECK_EQ(event_src, static_cast<void*>(nullptr));
-  ICHECK_EQ(event_dst, static_cast<void*>(nullptr));
+  VulkanStream& src = GetStream(dev, event_src);
+  VulkanStream& dst = GetStream(dev, event_dst);
+  if (&src == &dst) {
+    return;
+  }
+  // Without timeline semaphores, Submit waits for the work of `src`
+  // to finish and WaitOn is a no-op.
+  dst.WaitOn(src, src.Submit());
 }
 
 void VulkanDeviceAPI::StreamSync(Device dev, TVMStreamHandle stream) {
-  ICHECK_EQ(stream, static_cast<void*>(nullptr));
-  device(dev.device_id).ThreadLocalStream().Synchronize();
+  if (stream == nullptr) {
+    device(dev.device_id).SynchronizeThreadLocalStreams();
+  } else {
+    static_cast<VulkanStream*>(stream)->Synchronize();
+  }
 }
 
 void VulkanDeviceAPI::SetStream(Device dev, TVMStreamHandle stream) {
-  ICHECK_EQ(stream, static_cast<void*>(nullptr));
+  device(dev.device_id).SetThreadLocalStream(static_cast<VulkanStream*>(stream));
 }
 
-TVMStreamHandle VulkanDeviceAPI::GetCurrentStream(Device dev) { return nullptr; }
+TVMStreamHandle VulkanDeviceAPI::GetCurrentStream(Device dev) {
+  return device(dev.device_id).ThreadLocalActiveStream();
+}
+
+VulkanStream& VulkanDeviceAPI::GetStream(Device dev, TVMStreamHandle stream) {
+  if (stream == nullptr) {
+    return device(dev.device_id).ThreadLocalDefaultStream();
+  }
+  return *static_cast<VulkanStream*>(stream);
+}
+
+namespace {
+
+// host side flush if access is not coherent, so that writes from the
+// CPU are visible to the GPU
+void FlushStagingBuffer(const VulkanDevice& device, const VulkanStagingBuffer& staging_buffer) {
+  if (!device.coherent_staging) {
+    VkMappedMemoryRange mrange;
+    mrange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    mrange.pNext = nullptr;
+    mrange.memory = staging_buffer.vk_buf.memory;
+    mrange.offset = 0;
+    mrange.size = VK_WHOLE_SIZE;  // size;
+    VULKAN_CALL(vkFlushMappedMemoryRanges(device, 1, &mrange));
+  }
+}
+
+// host side invalidate if access is not coherent, so that writes
+// from the GPU are visible to the CPU
+void InvalidateStagingBuffer(const VulkanDevice& device,
+                             const VulkanStagingBuffer& staging_buffer) {
+  if (!device.coherent_staging) {
+    VkMappedMemoryRange mrange;
+    mrange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    mrange.pNext = nullptr;
+    mrange.memory = staging_buffer.vk_buf.memory;
+    mrange.offset = 0;
+    mrange.size = VK_WHOLE_SIZE;  // size;
+    VULKAN_CALL(vkInvalidateMappedMemoryRanges(device, 1, &mrange));
+  }
+}
+
+void RecordCopyToStaging(VulkanStream* stream, const VulkanBuffer* from_buf, size_t from_offset,
+                         const VulkanStagingBuffer& staging_buffer, size_t size) {
+  stream->Launch([=, &staging_buffer](VulkanStreamState* state) {
+    VkBufferCopy copy_info;
+    copy_info.srcOffset = from_offset;
+    copy_info.dstOffset = 0;
+    copy_info.size = size;
+    vkCmdCopyBuffer(state->cmd_buffer_, from_buf->buffer, staging_buffer.vk_buf.buffer, 1,
+                    &copy_info);
+  });
+}
+
+void RecordCopyFromStaging(VulkanStream* stream, const VulkanStagingBuffer& staging_buffer,
+                           const VulkanBuffer* to_buf, size_t to_offset, size_t size) {
+  stream->Launch([=, &staging_buffer](VulkanStreamState* state) {
+    // 0: barrier(host->transfer)
+    VkMemoryBarrier barrier_info;
+    barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier_info.pNext = nullptr;
+    barrier_info.srcAccessMask = 0;
+    barrier_info.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_HOST_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier_info, 0, nullptr, 0,
+                         nullptr);
+    // 1: copy
+    VkBufferCopy copy_info;
+    copy_info.srcOffset = 0;
+    copy_info.dstOffset = to_offset;
+    copy_info.size = size;
+    vkCmdCopyBuffer(state->cmd_buffer_, staging_buffer.vk_buf.buffer, to_buf->buffer, 1,
+                    &copy_info);
+  });
+}
+
+}  // namespace
 
 void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to,
                                      size_t to_offset, size_t size, Device dev_from, Device dev_to,
                                      DLDataType type_hint, TVMStreamHandle stream) {
-  ICHECK(stream == nullptr);
-  Device dev = dev_from;
-  if (dev_from.device_type == kDLCPU) {
-    dev = dev_to;
-  }
-
   int from_dev_type = static_cast<int>(dev_from.device_type);
   int to_dev_type = static_cast<int>(dev_to.device_type);
   if (from_dev_type == kDLVulkan && to_dev_type == kDLVulkan) {
@@ -351,7 +447,9 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
         << "The Vulkan runtime does not support deviceA to deviceB copies. "
         << "This should be changed to a deviceA to CPU copy, followed by a CPU to deviceB copy";
 
-    device(dev_from.device_id).ThreadLocalStream().Launch([=](VulkanStreamState* state) {
+    auto& device = this->device(dev_from.device_id);
+    auto& vk_stream = stream ? GetStream(dev_from, stream) : device.ThreadLocalStream();
+    vk_stream.Launch([=](VulkanStreamState* state) {
       // 1: copy
       const auto* from_buf = static_cast<const VulkanBuffer*>(from);
       auto* to_buf = static_cast<VulkanBuffer*>(to);
@@ -374,70 +472,79 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
 
   } else if (from_dev_type == kDLVulkan && to_dev_type == kDLCPU) {
     const auto* from_buf = static_cast<const VulkanBuffer*>(from);
+    char* host_to = static_cast<char*>(to) + to_offset;
     auto& device = this->device(dev_from.device_id);
-    auto& stream = device.ThreadLocalStream();
-    auto& staging_buffer = device.ThreadLocalStagingBuffer(size);
-    stream.Launch([&](VulkanStreamState* state) {
-      VkBufferCopy copy_info;
-      copy_info.srcOffset = from_offset;
-      copy_info.dstOffset = 0;
-      copy_info.size = size;
-      vkCmdCopyBuffer(state->cmd_buffer_, from_buf->buffer, staging_buffer.vk_buf.buffer, 1,
-                      &copy_info);
-    });
-    stream.Synchronize();
-    stream.ProfilerReset();
-    if (!device.coherent_staging) {
-      VkMappedMemoryRange mrange;
-      mrange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-      mrange.pNext = nullptr;
-      mrange.memory = staging_buffer.vk_buf.memory;
-      mrange.offset = 0;
-      mrange.size = VK_WHOLE_SIZE;  // size;
-      VULKAN_CALL(vkInvalidateMappedMemoryRanges(device, 1, &mrange));
+    if (stream != nullptr) {
+      // Asynchronous readback, `to` is written once the stream has
+      // been synchronized.
+      auto& vk_stream = GetStream(dev_from, stream);
+      auto& staging_buffer = vk_stream.AcquireStagingBuffer(size);
+      RecordCopyToStaging(&vk_stream, from_buf, from_offset, staging_buffer, size);
+      vk_stream.AddCompletionCallback([&device, &staging_buffer, host_to, size]() {
+        InvalidateStagingBuffer(device, staging_buffer);
+        memcpy(host_to, staging_buffer.host_addr, size);
+      });
+      return;
+    }
+
+    auto& compute_stream = device.ThreadLocalStream();
+    if (device.UseTransferQueue()) {
+      // Read back on the transfer queue, once the kernels submitted so
+      // far on the compute queue have finished.
+      auto& transfer_stream = device.ThreadLocalTransferStream();
+      transfer_stream.WaitOn(compute_stream, compute_stream.Submit());
+      auto& staging_buffer = transfer_stream.AcquireStagingBuffer(size);
+      RecordCopyToStaging(&transfer_stream, from_buf, from_offset, staging_buffer, size);
+      transfer_stream.Synchronize();
+      InvalidateStagingBuffer(device, staging_buffer);
+      memcpy(host_to, staging_buffer.host_addr, size);
+      return;
     }
-    memcpy(static_cast<char*>(to) + to_offset, static_cast<char*>(staging_buffer.host_addr), size);
+
+    auto& staging_buffer = device.ThreadLocalStagingBuffer(size);
+    RecordCopyToStaging(&compute_stream, from_buf, from_offset, staging_buffer, size);
+    compute_stream.Synchronize();
+    compute_stream.ProfilerReset();
+    InvalidateStagingBuffer(device, staging_buffer);
+    memcpy(host_to, staging_buffer.host_addr, size);
   } else if (from_dev_type == kDLCPU && to_dev_type == kDLVulkan) {
-    auto& device = this->device(dev_to.device_id);
-    auto& stream = device.ThreadLocalStream();
     const auto* to_buf = static_cast<const VulkanBuffer*>(to);
-    auto& staging_buffer = device.ThreadLocalStagingBuffer(size);
-    memcpy(staging_buffer.host_addr, static_cast<const char*>(from) + from_offset, size);
-    // host side flush if access is not coherent.
-    // so writes from CPU is visible to GPU
-    if (!device.coherent_staging) {
-      VkMappedMemoryRange mrange;
-      mrange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-      mrange.pNext = nullptr;
-      mrange.memory = staging_buffer.vk_buf.memory;
-      mrange.offset = 0;
-      mrange.size = VK_WHOLE_SIZE;  // size;
-      VULKAN_CALL(vkFlushMappedMemoryRanges(device, 1, &mrange));
+    const char* host_from = static_cast<const char*>(from) + from_offset;
+    auto& device = this->device(dev_to.device_id);
+    if (stream != nullptr) {
+      // The data is copied to a staging buffer owned by the stream, so
+      // there is no need to wait for the upload.
+      auto& vk_stream = GetStream(dev_to, stream);
+      auto& staging_buffer = vk_stream.AcquireStagingBuffer(size);
+      memcpy(staging_buffer.host_addr, host_from, size);
+      FlushStagingBuffer(device, staging_buffer);
+      RecordCopyFromStaging(&vk_stream, staging_buffer, to_buf, to_offset, size);
+      return;
     }
 
-    stream.Launch([&](VulkanStreamState* state) {
-      // 0: barrier(host->transfer)
-      VkMemoryBarrier barrier_info;
-      barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-      barrier_info.pNext = nullptr;
-      barrier_info.srcAccessMask = 0;
-      barrier_info.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_HOST_BIT,
-                           VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier_info, 0, nullptr, 0,
-                           nullptr);
-      // 1: copy
-      VkBufferCopy copy_info;
-      copy_info.srcOffset = 0;
-      copy_info.dstOffset = to_offset;
-      copy_info.size = size;
-      vkCmdCopyBuffer(state->cmd_buffer_, staging_buffer.vk_buf.buffer, to_buf->buffer, 1,
-                      &copy_info);
-    });
+    auto& compute_stream = device.ThreadLocalStream();
+    if (device.UseTransferQueue()) {
+      // Upload on the transfer queue, after the kernels submitted so
+      // far, and make the following kernels wait for the upload on
+      // the GPU instead of on the host.
+      auto& transfer_stream = device.ThreadLocalTransferStream();
+      transfer_stream.WaitOn(compute_stream, compute_stream.Submit());
+      auto& staging_buffer = transfer_stream.AcquireStagingBuffer(size);
+      memcpy(staging_buffer.host_addr, host_from, size);
+      FlushStagingBuffer(device, staging_buffer);
+      RecordCopyFromStaging(&transfer_stream, staging_buffer, to_buf, to_offset, size);
+      compute_stream.WaitOn(transfer_stream, transfer_stream.Submit());
+      return;
+    }
 
-    stream.ProfilerReady();
-    // TODO(tulloch): should we instead make the staging buffer a property of the
-    // Stream? This would allow us to elide synchronizations here.
-    stream.Synchronize();
+    auto& staging_buffer = device.ThreadLocalStagingBuffer(size);
+    memcpy(staging_buffer.host_addr, host_from, size);
+    FlushStagingBuffer(device, staging_buffer);
+    RecordCopyFromStaging(&compute_stream, staging_buffer, to_buf, to_offset, size);
+    compute_stream.ProfilerReady();
+    // The thread local staging buffer is reused by the next copy, so
+    // wait for the upload to finish.
+    compute_stream.Synchronize();
   } else {
     LOG(FATAL) << "Expect copy from/to Vulkan or between Vulkan"
                << ", from=" << from_dev_type << ", to=" << to_dev_type;
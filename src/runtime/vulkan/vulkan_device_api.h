@@ -52,11 +52,10 @@ class VulkanDeviceAPI final : public DeviceAPI {
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final;
   void FreeWorkspace(Device dev, void* data) final;
 
-  // Current vulkan implementation has one "stream" per CPU thread,
-  // with all commands writing into a single command buffer that is
-  // submitted on a call to StreamSync.  Therefore, for now, these are
-  // mostly no-ops.  If needed in the future, could have multiple
-  // command buffers to act as multiple streams.
+  // Each CPU thread has a default stream (the nullptr handle).  Streams
+  // created by CreateStream are VulkanStream objects on the compute
+  // queues of the device.  With timeline semaphores, SyncStreamFromTo
+  // orders two streams on the GPU, without blocking the host.
   TVMStreamHandle CreateStream(Device dev) final;
   void FreeStream(Device dev, TVMStreamHandle stream) final;
   void SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst) final;
@@ -102,6 +101,13 @@ class VulkanDeviceAPI final : public DeviceAPI {
    */
   VulkanDevice& device(size_t device_id);
 
+  /*! \brief Return the VulkanStream of a stream handle
+   *
+   * The nullptr handle is the default stream of the current CPU
+   * thread.
+   */
+  VulkanStream& GetStream(Device dev, TVMStreamHandle stream);
+
   /*! \brief Returns a property to be stored in a target.
    *
    * Returns the results of feature/property queries done during the
@@ -19,6 +19,8 @@
 
 #include "vulkan_stream.h"
 
+#include <algorithm>
+
 #include "../../support/utils.h"
 #include "vulkan_device.h"
 
@@ -26,36 +28,44 @@ namespace tvm {
 namespace runtime {
 namespace vulkan {
 
-VulkanStream::VulkanStream(const VulkanDevice* device)
+namespace {
+
+// The number of idle staging buffers kept by a stream for reuse.
+constexpr size_t kMaxFreeStagingBuffers = 8;
+
+}  // namespace
+
+VulkanStream::VulkanStream(const VulkanDevice* device, VkQueue queue, uint32_t queue_family_index)
     : device_(device), state_(new VulkanStreamState()) {
+  queue_ = (queue == VK_NULL_HANDLE) ? device_->Queue() : queue;
+  if (queue_family_index == uint32_t(-1)) {
+    queue_family_index = device_->queue_family_index;
+  }
+
   // create command pool
   VkCommandPoolCreateInfo cmd_pool_cinfo;
   cmd_pool_cinfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
   cmd_pool_cinfo.pNext = nullptr;
   cmd_pool_cinfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-  cmd_pool_cinfo.queueFamilyIndex = device_->queue_family_index;
+  cmd_pool_cinfo.queueFamilyIndex = queue_family_index;
   VULKAN_CALL(vkCreateCommandPool(*device_, &cmd_pool_cinfo, nullptr, &cmd_pool_));
 
-  VkCommandBufferAllocateInfo buffer_alloc_info;
-  buffer_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  buffer_alloc_info.pNext = nullptr;
-  buffer_alloc_info.commandPool = cmd_pool_;
-  buffer_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  buffer_alloc_info.commandBufferCount = 1;
-  VULKAN_CALL(vkAllocateCommandBuffers(*device_, &buffer_alloc_info, &(state_->cmd_buffer_)));
-
   VkFenceCreateInfo fence_cinfo;
   fence_cinfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
   fence_cinfo.pNext = nullptr;
   fence_cinfo.flags = 0;  // VK_FENCE_CREATE_SIGNALED_BIT;
   VULKAN_CALL(vkCreateFence(*device_, &fence_cinfo, nullptr, &(state_->fence_)));
 
-  VkCommandBufferBeginInfo cb_begin;
-  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  cb_begin.pNext = nullptr;
-  cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  cb_begin.pInheritanceInfo = nullptr;
-  VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
+  if (device_->UseTimelineSemaphore()) {
+    VkSemaphoreTypeCreateInfoKHR type_cinfo = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+    type_cinfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    type_cinfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphore_cinfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    semaphore_cinfo.pNext = &type_cinfo;
+    VULKAN_CALL(vkCreateSemaphore(*device_, &semaphore_cinfo, nullptr, &timeline_));
+  }
+
+  BeginCommandBuffer();
 
   if (support::BoolEnvironmentVar("TVM_USE_AMD_RGP")) {
     profiler_ = new AmdRgpProfiler(device_);
@@ -63,6 +73,12 @@ VulkanStream::VulkanStream(const VulkanDevice* device)
 }
 
 VulkanStream::~VulkanStream() {
+  if (HasTimeline()) {
+    // Command buffers and staging buffers of pending submissions
+    // must outlive their execution.
+    device_->WaitTimelineSemaphore(timeline_, submitted_value_);
+    vkDestroySemaphore(*device_, timeline_, nullptr);
+  }
   vkDestroyFence(*device_, state_->fence_, nullptr);
   vkDestroyCommandPool(*device_, cmd_pool_, nullptr);
 
@@ -71,12 +87,36 @@ VulkanStream::~VulkanStream() {
   }
 }
 
+void VulkanStream::BeginCommandBuffer() {
+  if (!free_cmd_buffers_.empty()) {
+    state_->cmd_buffer_ = free_cmd_buffers_.back();
+    free_cmd_buffers_.pop_back();
+    VULKAN_CALL(vkResetCommandBuffer(state_->cmd_buffer_, 0));
+  } else {
+    VkCommandBufferAllocateInfo buffer_alloc_info;
+    buffer_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    buffer_alloc_info.pNext = nullptr;
+    buffer_alloc_info.commandPool = cmd_pool_;
+    buffer_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    buffer_alloc_info.commandBufferCount = 1;
+    VULKAN_CALL(vkAllocateCommandBuffers(*device_, &buffer_alloc_info, &(state_->cmd_buffer_)));
+  }
+
+  VkCommandBufferBeginInfo cb_begin;
+  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cb_begin.pNext = nullptr;
+  cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  cb_begin.pInheritanceInfo = nullptr;
+  VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
+}
+
 void VulkanStream::Launch(const std::function<void(VulkanStreamState*)>& kernel) {
   if (device_->UseImmediate()) {
     kernel(state_.get());
   } else {
     deferred_kernels_.push_back(kernel);
   }
+  recorded_ = true;
 }
 
 void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initializer,
@@ -115,9 +155,10 @@ void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initiali
   // Save the kernel itself to be called later.
   deferred_kernels_.push_back(deferred_kernel);
   deferred_tokens_[deferred_token.descriptor_set_].push_back(deferred_token);
+  recorded_ = true;
 }
 
-void VulkanStream::Synchronize() {
+uint64_t VulkanStream::Submit() {
   if (!device_->UseImmediate()) {
     for (const auto& deferred_kernel : deferred_kernels_) {
       deferred_kernel(state_.get());
@@ -129,40 +170,165 @@ void VulkanStream::Synchronize() {
     DCHECK_EQ(deferred_tokens_.size(), 0);
   }
 
+  if (!recorded_ && wait_semaphores_.empty()) {
+    return submitted_value_;
+  }
+
   VULKAN_CALL(vkEndCommandBuffer(state_->cmd_buffer_));
+  uint64_t signal_value = submitted_value_ + 1;
+  std::vector<VkPipelineStageFlags> wait_stages(wait_semaphores_.size(),
+                                                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+  VkTimelineSemaphoreSubmitInfoKHR timeline_submit = {
+      VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+  timeline_submit.waitSemaphoreValueCount = wait_values_.size();
+  timeline_submit.pWaitSemaphoreValues = wait_values_.data();
+  timeline_submit.signalSemaphoreValueCount = 1;
+  timeline_submit.pSignalSemaphoreValues = &signal_value;
+
   VkSubmitInfo cb_submit;
   cb_submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  cb_submit.pNext = nullptr;
-  cb_submit.waitSemaphoreCount = 0;
-  cb_submit.pWaitSemaphores = nullptr;
-  cb_submit.pWaitDstStageMask = nullptr;
+  cb_submit.pNext = HasTimeline() ? &timeline_submit : nullptr;
+  cb_submit.waitSemaphoreCount = wait_semaphores_.size();
+  cb_submit.pWaitSemaphores = wait_semaphores_.data();
+  cb_submit.pWaitDstStageMask = wait_stages.data();
   cb_submit.commandBufferCount = 1;
   cb_submit.pCommandBuffers = &(state_->cmd_buffer_);
-  cb_submit.signalSemaphoreCount = 0;
-  cb_submit.pSignalSemaphores = nullptr;
+  cb_submit.signalSemaphoreCount = HasTimeline() ? 1 : 0;
+  cb_submit.pSignalSemaphores = HasTimeline() ? &timeline_ : nullptr;
 
   if (profiler_) {
     profiler_->capture();
   }
 
-  device_->QueueSubmit(cb_submit, state_->fence_);
+  device_->QueueSubmit(queue_, cb_submit, HasTimeline() ? VK_NULL_HANDLE : state_->fence_);
+  submitted_value_ = signal_value;
+  wait_semaphores_.clear();
+  wait_values_.clear();
+  recorded_ = false;
+
+  if (HasTimeline()) {
+    in_flight_cmd_buffers_.emplace_back(signal_value, state_->cmd_buffer_);
+    if (!device_->UseImmediate()) {
+      // Without push descriptors, the descriptor sets are updated from
+      // the host when a kernel is launched, and may not be updated
+      // while a previous submission still reads them.
+      device_->WaitTimelineSemaphore(timeline_, signal_value);
+    }
+    Recycle();
+    BeginCommandBuffer();
+  } else {
+    uint64_t timeout = 1UL << 30UL;
+    VkResult res;
+    do {
+      res = vkWaitForFences(*device_, 1, &(state_->fence_), 0, timeout);
+    } while (res == VK_TIMEOUT);
+    VULKAN_CHECK_ERROR(res);
+    VULKAN_CALL(vkResetFences(*device_, 1, &(state_->fence_)));
+    free_cmd_buffers_.push_back(state_->cmd_buffer_);
+    Recycle();
+    // Re-initialize the command buffer
+    BeginCommandBuffer();
+  }
+  return signal_value;
+}
+
+void VulkanStream::Synchronize() {
+  uint64_t value = Submit();
+  if (HasTimeline()) {
+    device_->WaitTimelineSemaphore(timeline_, value);
+  }
+  Recycle();
+}
+
+void VulkanStream::WaitOn(const VulkanStream& other, uint64_t value) {
+  if (&other == this || !HasTimeline() || !other.HasTimeline()) {
+    return;
+  }
+  if (value <= other.CompletedValue()) {
+    return;
+  }
+  for (size_t i = 0; i < wait_semaphores_.size(); ++i) {
+    if (wait_semaphores_[i] == other.timeline_) {
+      wait_values_[i] = std::max(wait_values_[i], value);
+      return;
+    }
+  }
+  wait_semaphores_.push_back(other.timeline_);
+  wait_values_.push_back(value);
+}
 
-  uint64_t timeout = 1UL << 30UL;
-  VkResult res;
-  do {
-    res = vkWaitForFences(*device_, 1, &(state_->fence_), 0, timeout);
-  } while (res == VK_TIMEOUT);
-  VULKAN_CHECK_ERROR(res);
-  VULKAN_CALL(vkResetCommandBuffer(state_->cmd_buffer_, 0));
-  VULKAN_CALL(vkResetFences(*device_, 1, &(state_->fence_)));
+void VulkanStream::AddCompletionCallback(std::function<void()> callback) {
+  completion_callbacks_.emplace_back(submitted_value_ + 1, std::move(callback));
+  // The callback waits for the next submission, so make sure there is one.
+  recorded_ = true;
+}
 
-  // Re-initialize the command buffer
-  VkCommandBufferBeginInfo cb_begin;
-  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  cb_begin.pNext = nullptr;
-  cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  cb_begin.pInheritanceInfo = nullptr;
-  VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
+VulkanStagingBuffer& VulkanStream::AcquireStagingBuffer(size_t min_size) {
+  Recycle();
+  std::unique_ptr<VulkanStagingBuffer> buffer;
+  // Best fit among the idle staging buffers.
+  auto best = free_staging_buffers_.end();
+  for (auto it = free_staging_buffers_.begin(); it != free_staging_buffers_.end(); ++it) {
+    if ((*it)->size < min_size) continue;
+    if (best == free_staging_buffers_.end() || (*it)->size < (*best)->size) {
+      best = it;
+    }
+  }
+  if (best != free_staging_buffers_.end()) {
+    buffer = std::move(*best);
+    free_staging_buffers_.erase(best);
+  } else {
+    auto usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer = std::make_unique<VulkanStagingBuffer>(*device_, min_size, usage,
+                                                   device_->staging_mtype_index);
+  }
+  busy_staging_buffers_.emplace_back(submitted_value_ + 1, std::move(buffer));
+  return *busy_staging_buffers_.back().second;
+}
+
+uint64_t VulkanStream::CompletedValue() const {
+  if (!HasTimeline()) {
+    // Every submission has been waited for.
+    return submitted_value_;
+  }
+  return device_->GetTimelineSemaphoreValue(timeline_);
+}
+
+void VulkanStream::Recycle() {
+  uint64_t completed = CompletedValue();
+  // The callbacks may still read the staging buffers that are released below.
+  RunCompletionCallbacks(completed);
+
+  auto cmd_it = std::stable_partition(
+      in_flight_cmd_buffers_.begin(), in_flight_cmd_buffers_.end(),
+      [&](const std::pair<uint64_t, VkCommandBuffer>& entry) { return entry.first > completed; });
+  for (auto it = cmd_it; it != in_flight_cmd_buffers_.end(); ++it) {
+    free_cmd_buffers_.push_back(it->second);
+  }
+  in_flight_cmd_buffers_.erase(cmd_it, in_flight_cmd_buffers_.end());
+
+  auto staging_it = std::stable_partition(
+      busy_staging_buffers_.begin(), busy_staging_buffers_.end(),
+      [&](const std::pair<uint64_t, std::unique_ptr<VulkanStagingBuffer>>& entry) {
+        return entry.first > completed;
+      });
+  for (auto it = staging_it; it != busy_staging_buffers_.end(); ++it) {
+    if (free_staging_buffers_.size() < kMaxFreeStagingBuffers) {
+      free_staging_buffers_.push_back(std::move(it->second));
+    }
+  }
+  busy_staging_buffers_.erase(staging_it, busy_staging_buffers_.end());
+}
+
+void VulkanStream::RunCompletionCallbacks(uint64_t completed) {
+  size_t num_done = 0;
+  while (num_done < completion_callbacks_.size() &&
+         completion_callbacks_[num_done].first <= completed) {
+    completion_callbacks_[num_done].second();
+    ++num_done;
+  }
+  completion_callbacks_.erase(completion_callbacks_.begin(),
+                              completion_callbacks_.begin() + num_done);
 }
 
 }  // namespace vulkan
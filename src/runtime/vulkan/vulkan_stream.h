@@ -23,9 +23,11 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "vulkan_amdrgp.h"
+#include "vulkan_buffer.h"
 #include "vulkan_common.h"
 
 namespace tvm {
@@ -46,25 +48,30 @@ struct VulkanStreamToken {
   std::vector<VkBuffer> buffers_;
 };
 
-/*!
- *  \brief Wrapper around a vulkan command buffer
+/*! \brief A sequence of commands executed in order on one VkQueue
  *
- *  The VulkanStream collects commands into a VkCommandBuffer.  When a
- *  newly submitted command requires resources reserved by an
- *  already-submitted command, all of the queued commands are
- *  submitted to the GPU, and the CPU waits for all queued commands to
- *  finish.  The queued commands can also be explicitly pushed/waited
- *  on by calling VulkanStream::Synchronize.
- *
- *  Currently, there exists one VulkanStream for each GPU device, for
- *  each CPU thread.  Each time a VulkanWrappedFunc is called, it is
- *  submitted to the VulkanStream associated with the submitting CPU
- *  thread, and associated the thread-specific active device set by
- *  `DeviceAPI::SetDevice`.
+ * If the device supports timeline semaphores, every submission of
+ * the stream signals the next value of the stream's timeline
+ * semaphore.  Submissions then do not block the host, other streams
+ * can wait for them on the GPU (see WaitOn), and the host only waits
+ * in Synchronize.  Command buffers are recycled once the timeline has
+ * passed their submission.  Otherwise, each submission waits on a
+ * fence before returning, as a single-stream fallback.
  */
 class VulkanStream {
  public:
-  explicit VulkanStream(const VulkanDevice* device);
+  /*! \brief Construct a stream
+   *
+   * \param device The device owning the queue.
+   *
+   * \param queue The queue to submit to.  Defaults to the compute
+   * queue of the device.
+   *
+   * \param queue_family_index The family of the queue, for the
+   * command pool.
+   */
+  explicit VulkanStream(const VulkanDevice* device, VkQueue queue = VK_NULL_HANDLE,
+                        uint32_t queue_family_index = uint32_t(-1));
 
   ~VulkanStream();
 
@@ -114,18 +121,93 @@ class VulkanStream {
     }
   }
 
+  /*! \brief Submit the commands recorded so far to the queue.
+   *
+   * Does not wait for the commands to finish if the stream has a
+   * timeline semaphore.  If nothing was recorded since the last
+   * submission, no submission is made.
+   *
+   * \return The timeline value that is reached once the submitted
+   * commands have finished.
+   */
+  uint64_t Submit();
+
   // Synchronize the current stream `state_` with respect to the host.
   void Synchronize();
 
+  /*! \brief Make the next submission of this stream wait on the GPU
+   * until `other` has reached `value`.
+   *
+   * Without timeline semaphores every submission has finished on
+   * return of Submit, and this is a no-op.
+   */
+  void WaitOn(const VulkanStream& other, uint64_t value);
+
+  /*! \brief Run a callback on the host once the commands recorded so
+   * far have finished.
+   *
+   * Callbacks are run in order once their submission is seen to have
+   * finished, at the latest from Synchronize, e.g. to copy an
+   * asynchronous readback out of its staging buffer.
+   */
+  void AddCompletionCallback(std::function<void()> callback);
+
+  /*! \brief Return a host visible staging buffer for the commands
+   * being recorded.
+   *
+   * The buffer stays reserved until the next submission has
+   * finished, so that uploads and readbacks do not need to wait for
+   * the queue before the staging memory is reused.
+   */
+  VulkanStagingBuffer& AcquireStagingBuffer(size_t min_size);
+
+  //! \brief Whether the stream uses a timeline semaphore
+  bool HasTimeline() const { return timeline_ != VK_NULL_HANDLE; }
+
+  //! \brief The timeline value of the last submission
+  uint64_t SubmittedValue() const { return submitted_value_; }
+
+  //! \brief The timeline value of the last finished submission
+  uint64_t CompletedValue() const;
+
  private:
+  //! \brief Begin recording into a fresh or recycled command buffer.
+  void BeginCommandBuffer();
+
+  /*! \brief Run the completion callbacks of finished submissions, and
+   * move their command buffers and staging buffers to the free lists.
+   */
+  void Recycle();
+
+  //! \brief Run the completion callbacks of submissions up to `completed`.
+  void RunCompletionCallbacks(uint64_t completed);
+
   const VulkanDevice* device_;
+  VkQueue queue_{VK_NULL_HANDLE};
   std::unique_ptr<VulkanStreamState> state_;
+  // Whether any command was recorded into state_->cmd_buffer_ since the last submission.
+  bool recorded_{false};
   // An index of deferred tokens, allowing us to efficiently detect duplicated
   // deferred_initializer blocks.
   std::unordered_map<VkDescriptorSet, std::vector<VulkanStreamToken>> deferred_tokens_;
   std::vector<std::function<void(VulkanStreamState*)>> deferred_kernels_;
   VkCommandPool cmd_pool_;
   VulkanStreamProfiler* profiler_ = nullptr;
+
+  // Timeline semaphore signaled by each submission, VK_NULL_HANDLE if unsupported.
+  VkSemaphore timeline_{VK_NULL_HANDLE};
+  uint64_t submitted_value_{0};
+  // Semaphores and values that the next submission waits on.
+  std::vector<VkSemaphore> wait_semaphores_;
+  std::vector<uint64_t> wait_values_;
+  // Submitted command buffers, with the timeline value at which they finish.
+  std::vector<std::pair<uint64_t, VkCommandBuffer>> in_flight_cmd_buffers_;
+  std::vector<VkCommandBuffer> free_cmd_buffers_;
+  // Staging buffers reserved until the timeline reaches the value.
+  std::vector<std::pair<uint64_t, std::unique_ptr<VulkanStagingBuffer>>> busy_staging_buffers_;
+  std::vector<std::unique_ptr<VulkanStagingBuffer>> free_staging_buffers_;
+  // Host callbacks to run once the timeline reaches the value.
+  std::vector<std::pair<uint64_t, std::function<void()>>> completion_callbacks_;
 };
 
 }  // namespace vulkan
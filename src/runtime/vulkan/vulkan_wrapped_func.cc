@@ -187,6 +187,10 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
 VulkanModuleNode::~VulkanModuleNode() {
   // cleanup vulkan related caches.
   for (size_t device_id = 0; device_id < ecache_.size(); ++device_id) {
+    if (!ecache_[device_id].empty()) {
+      // Persist the pipelines of this module for later processes.
+      VulkanDeviceAPI::Global()->device(device_id).SavePipelineCache();
+    }
     for (auto& kv : ecache_[device_id]) {
       auto& pe = kv.second;
       ICHECK(pe);
@@ -382,8 +386,8 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   pipeline_cinfo.layout = pe->pipeline_layout;
   pipeline_cinfo.basePipelineHandle = VK_NULL_HANDLE;
   pipeline_cinfo.basePipelineIndex = 0;
-  VULKAN_CALL(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipeline_cinfo, nullptr,
-                                       &(pe->pipeline)));
+  VULKAN_CALL(vkCreateComputePipelines(device, device.PipelineCache(), 1, &pipeline_cinfo,
+                                       nullptr, &(pe->pipeline)));
 
   if (device.UseImmediate()) {
     VkDescriptorUpdateTemplateCreateInfoKHR descrip_template_cinfo;
@@ -23,6 +23,7 @@
  */
 #include "workspace_pool.h"
 
+#include <array>
 #include <memory>
 
 namespace tvm {
@@ -30,6 +31,10 @@ namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// The number of size classes of the small workspaces, from 1 to 64 pages.
+constexpr int kNumSizeClasses = 7;
+// The maximum number of free workspaces kept in each size class.
+constexpr size_t kMaxCachedPerSizeClass = 8;
 
 class WorkspacePool::Pool {
  public:
@@ -52,7 +57,18 @@ class WorkspacePool::Pool {
     type.code = kDLUInt;
     type.bits = 8;
     type.lanes = 1;
-    if (free_list_.size() == 2) {
+    int size_class = SizeClass(nbytes);
+    if (size_class != -1) {
+      // small workspaces are rounded up to their size class, and reused without search.
+      std::vector<void*>& cache = size_class_cache_[size_class];
+      e.size = kWorkspacePageSize << size_class;
+      if (!cache.empty()) {
+        e.data = cache.back();
+        cache.pop_back();
+      } else {
+        e.data = device->AllocDataSpace(dev, e.size, kTempAllocaAlignment, type);
+      }
+    } else if (free_list_.size() == 2) {
       e = free_list_.back();
       free_list_.pop_back();
       if (e.size < nbytes) {
@@ -85,7 +101,7 @@ class WorkspacePool::Pool {
     return e.data;
   }
   // free resource back to pool
-  void Free(void* data) {
+  void Free(Device dev, DeviceAPI* device, void* data) {
     Entry e;
     if (allocated_.back().data == data) {
       // quick path, last allocated.
@@ -99,7 +115,16 @@ class WorkspacePool::Pool {
       e = allocated_[index];
       allocated_.erase(allocated_.begin() + index);
     }
-    if (free_list_.back().size < e.size) {
+    int size_class = SizeClass(e.size);
+    if (size_class != -1) {
+      // bound the memory held by the size class.
+      std::vector<void*>& cache = size_class_cache_[size_class];
+      if (cache.size() < kMaxCachedPerSizeClass) {
+        cache.push_back(e.data);
+      } else {
+        device->FreeDataSpace(dev, e.data);
+      }
+    } else if (free_list_.back().size < e.size) {
       free_list_.push_back(e);
     } else if (free_list_.size() == 2) {
       free_list_.push_back(free_list_.back());
@@ -119,9 +144,24 @@ class WorkspacePool::Pool {
       device->FreeDataSpace(dev, free_list_[i].data);
     }
     free_list_.clear();
+    for (std::vector<void*>& cache : size_class_cache_) {
+      for (void* data : cache) {
+        device->FreeDataSpace(dev, data);
+      }
+      cache.clear();
+    }
   }
 
  private:
+  // The size class of a page aligned size, or -1 if the size is not small.
+  static int SizeClass(size_t nbytes) {
+    size_t num_pages = nbytes / kWorkspacePageSize;
+    int size_class = 0;
+    while ((static_cast<size_t>(1) << size_class) < num_pages) {
+      if (++size_class == kNumSizeClasses) return -1;
+    }
+    return size_class;
+  }
   /*! \brief a single entry in the pool */
   struct Entry {
     void* data;
@@ -131,6 +171,8 @@ class WorkspacePool::Pool {
   std::vector<Entry> free_list_;
   /*! \brief List of allocated items */
   std::vector<Entry> allocated_;
+  /*! \brief The free workspaces of each size class */
+  std::array<std::vector<void*>, kNumSizeClasses> size_class_cache_;
 };
 
 WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
@@ -160,7 +202,7 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
-  array_[dev.device_id]->Free(ptr);
+  array_[dev.device_id]->Free(dev, device_, ptr);
 }
 
 }  // namespace runtime
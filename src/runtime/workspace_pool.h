@@ -41,6 +41,11 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  The small workspaces, up to 64 pages, are rounded up to power of two
+ *  size classes, whose free workspaces are reused without search, and
+ *  of which a bounded number are kept.  The larger ones are reused from
+ *  a free list sorted by size.
  */
 class TVM_DLL WorkspacePool {
  public:
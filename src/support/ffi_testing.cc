@@ -23,6 +23,7 @@
  */
 #include <tvm/ir/attrs.h>
 #include <tvm/ir/env_func.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/variant.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
@@ -189,6 +190,77 @@ TVM_REGISTER_GLOBAL("testing.ReturnsVariant").set_body_typed([](int x) -> Varian
 TVM_REGISTER_GLOBAL("testing.AcceptsVariant")
     .set_body_typed([](Variant<String, Integer> arg) -> String { return arg->GetTypeKey(); });
 
+// Measure the overhead in nanoseconds of a call from C++ to a function registered with
+// set_body_typed, through each calling convention.
+TVM_REGISTER_GLOBAL("testing.packed_call_overhead").set_body_typed([](int64_t num_calls) {
+  runtime::TypedPackedFunc<int64_t(int64_t, ObjectRef)> ftyped(
+      [](int64_t x, ObjectRef obj) -> int64_t { return x + obj.defined(); });
+  PackedFunc fpacked = ftyped.packed();
+  ObjectRef obj = String("x");
+  auto time_ns = [num_calls](auto fcall) {
+    int64_t sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int64_t i = 0; i < num_calls; ++i) {
+      sum = fcall(sum);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    ICHECK_EQ(sum, num_calls);
+    double total_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return FloatImm(DataType::Float(64), total_ns / num_calls);
+  };
+  Map<String, FloatImm> result;
+  result.Set("typed", time_ns([&](int64_t x) { return ftyped(x, obj); }));
+  result.Set("packed", time_ns([&](int64_t x) -> int64_t { return fpacked(x, obj); }));
+  result.Set("vector_args", time_ns([&](int64_t x) -> int64_t {
+               std::vector<TVMValue> values(2);
+               std::vector<int> type_codes(2);
+               runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+               setter(0, x);
+               setter(1, obj);
+               TVMRetValue rv;
+               fpacked.CallPacked(TVMArgs(values.data(), type_codes.data(), 2), &rv);
+               return rv;
+             }));
+  result.Set("args_pack", time_ns([&](int64_t x) -> int64_t {
+               runtime::TVMArgsPack<> pack(2);
+               pack.setter()(0, x);
+               pack.setter()(1, obj);
+               TVMRetValue rv;
+               fpacked.CallPacked(pack.args(), &rv);
+               return rv;
+             }));
+  return result;
+});
+
+// Measure the alloc/free pairs per second of the CPU workspace, on a number of threads which
+// each allocate two nested workspaces of the given sizes in turn, like the parallel workers.
+TVM_REGISTER_GLOBAL("testing.workspace_alloc_throughput")
+    .set_body_typed([](int num_threads, int64_t num_pairs, Array<Integer> sizes) {
+      ICHECK(!sizes.empty());
+      auto worker = [num_pairs, &sizes]() {
+        for (int64_t i = 0; i < num_pairs; i += 2) {
+          int64_t outer = sizes[i % sizes.size()]->value;
+          int64_t inner = sizes[(i + 1) % sizes.size()]->value;
+          void* a = TVMBackendAllocWorkspace(kDLCPU, 0, outer, kDLFloat, 32);
+          void* b = TVMBackendAllocWorkspace(kDLCPU, 0, inner, kDLFloat, 32);
+          ICHECK(a != nullptr && b != nullptr);
+          TVMBackendFreeWorkspace(kDLCPU, 0, b);
+          TVMBackendFreeWorkspace(kDLCPU, 0, a);
+        }
+      };
+      std::vector<std::thread> threads;
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(worker);
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      double total_s = std::chrono::duration<double>(end - start).count();
+      return num_pairs * num_threads / total_s;
+    });
+
 /**
  * Simple event logger that can be used for testing purposes
  */
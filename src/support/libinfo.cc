@@ -199,6 +199,10 @@
 #define TVM_INFO_USE_CUBLAS "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_CUPTI
+#define TVM_INFO_USE_CUPTI "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_THRUST
 #define TVM_INFO_USE_THRUST "NOT-FOUND"
 #endif
@@ -223,6 +227,10 @@
 #define TVM_INFO_USE_NNPACK "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_OBJECT_POOL_ALLOCATOR
+#define TVM_INFO_USE_OBJECT_POOL_ALLOCATOR "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_RANDOM
 #define TVM_INFO_USE_RANDOM "NOT-FOUND"
 #endif
@@ -318,6 +326,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_NCCL", TVM_INFO_USE_NCCL},
       {"USE_MSCCL", TVM_INFO_USE_MSCCL},
       {"USE_CUDNN", TVM_INFO_USE_CUDNN},
+      {"USE_CUPTI", TVM_INFO_USE_CUPTI},
       {"USE_CUSTOM_LOGGING", TVM_INFO_USE_CUSTOM_LOGGING},
       {"USE_CUTLASS", TVM_INFO_USE_CUTLASS},
       {"USE_FLASHINFER", TVM_INFO_USE_FLASHINFER},
@@ -348,6 +357,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_MRVL", TVM_INFO_USE_MRVL},
       {"USE_MSVC_MT", TVM_INFO_USE_MSVC_MT},
       {"USE_NNPACK", TVM_INFO_USE_NNPACK},
+      {"USE_OBJECT_POOL_ALLOCATOR", TVM_INFO_USE_OBJECT_POOL_ALLOCATOR},
       {"USE_OPENCL", TVM_INFO_USE_OPENCL},
       {"USE_OPENCL_ENABLE_HOST_PTR", TVM_INFO_USE_OPENCL_ENABLE_HOST_PTR},
       {"USE_OPENCL_GTEST", TVM_INFO_USE_OPENCL_GTEST},
@@ -0,0 +1,297 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file mpmc_queue.h
+ * \brief A bounded lock-free multi-producer multi-consumer queue, whose blocking operations park
+ *  the waiting threads on a futex.
+ */
+#ifndef TVM_SUPPORT_MPMC_QUEUE_H_
+#define TVM_SUPPORT_MPMC_QUEUE_H_
+
+#include <tvm/runtime/logging.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace tvm {
+namespace support {
+
+/*! \brief The size of a cache line, which the contended atomics are padded to. */
+constexpr size_t kCacheLineBytes = 64;
+
+/*!
+ * \brief An event count, on which threads park until an event happens after they prepare to wait.
+ *
+ *  A waiter calls PrepareWait, re-checks its condition, and then calls Wait with the returned
+ *  epoch, or CancelWait when the condition holds. A notification between PrepareWait and Wait
+ *  makes the Wait return immediately, so no wakeup is lost. The notifier only pays a fence when
+ *  nobody waits.
+ */
+class EventCount {
+ public:
+  /*! \brief Announce a waiter, returning the epoch to wait on. */
+  uint32_t PrepareWait() {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    // Pairs with the fence of Notify, so that either the waiter sees the event in its re-check or
+    // the notifier sees the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+  /*! \brief Withdraw a waiter announced by PrepareWait. */
+  void CancelWait() { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+  /*! \brief Park until the epoch moves past the one returned by PrepareWait. */
+  void Wait(uint32_t epoch) {
+#if defined(__linux__)
+    while (epoch_.load(std::memory_order_acquire) == epoch) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, nullptr,
+              nullptr, 0);
+    }
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return epoch_.load(std::memory_order_acquire) != epoch; });
+#endif
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  /*! \brief Wake one waiter, if any. */
+  void NotifyOne() { Notify(1); }
+  /*! \brief Wake all the waiters. */
+  void NotifyAll() { Notify(INT32_MAX); }
+
+ private:
+  void Notify(int count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) return;
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, count, nullptr,
+            nullptr, 0);
+#else
+    // Taking the lock orders the epoch change with a waiter between its check and its sleep.
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    if (count == 1) {
+      cv_.notify_one();
+    } else {
+      cv_.notify_all();
+    }
+#endif
+  }
+
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "The futex word should be a plain 32-bit integer");
+  /*! \brief The futex word, which moves on every notification. */
+  std::atomic<uint32_t> epoch_{0};
+  /*! \brief The number of the threads between PrepareWait and the end of Wait. */
+  std::atomic<int32_t> waiters_{0};
+#if !defined(__linux__)
+  std::mutex mutex_;
+  std::condition_variable cv_;
+#endif
+};
+
+/*!
+ * \brief A bounded lock-free queue for any number of producers and consumers.
+ *
+ *  Each cell carries a sequence number which tells the lap of the ring that it is free or filled
+ *  for, so that producers and consumers only contend on their own index. Counting the state of
+ *  the cell in the sequence number also distinguishes the laps of a ring of a single cell.
+ *  The Try* operations never block. Push and Pop spin for a while and then park on an event count
+ *  until the queue has room or data, or until it is closed.
+ *
+ * \tparam T The element type, which should be default constructible and assignable.
+ */
+template <typename T>
+class MPMCQueue {
+ public:
+  /*!
+   * \brief Create a queue.
+   * \param capacity The number of elements that the queue can hold.
+   */
+  explicit MPMCQueue(size_t capacity) : capacity_(capacity), cells_(capacity) {
+    ICHECK_GT(capacity, 0) << "The capacity of a queue should be positive";
+    for (size_t i = 0; i < capacity; ++i) {
+      cells_[i].sequence.store(0, std::memory_order_relaxed);
+    }
+  }
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  /*!
+   * \brief Push an element if the queue has room.
+   * \param value The element.
+   * \return Whether the element is pushed.
+   */
+  template <typename U>
+  bool TryPush(U&& value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[pos % capacity_];
+      // The cell is free for the lap of the position at the sequence number 2 * lap.
+      size_t free_seq = 2 * (pos / capacity_);
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(free_seq);
+      if (dif == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.data = std::forward<U>(value);
+          cell.sequence.store(free_seq + 1, std::memory_order_release);
+          not_empty_.NotifyOne();
+          return true;
+        }
+      } else if (dif < 0) {
+        // The cell still holds the element of the previous lap, i.e. the queue is full.
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  /*!
+   * \brief Pop an element if the queue has one.
+   * \param output The pointer to store the element.
+   * \return Whether an element is popped.
+   */
+  template <typename U>
+  bool TryPop(U* output) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[pos % capacity_];
+      // The cell is filled for the lap of the position at the sequence number 2 * lap + 1.
+      size_t filled_seq = 2 * (pos / capacity_) + 1;
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(filled_seq);
+      if (dif == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          *output = std::move(cell.data);
+          cell.sequence.store(filled_seq + 1, std::memory_order_release);
+          not_full_.NotifyOne();
+          return true;
+        }
+      } else if (dif < 0) {
+        // The cell is not filled yet, i.e. the queue is empty.
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  /*!
+   * \brief Push an element, waiting for room when the queue is full.
+   * \param value The element.
+   * \param spin_count The number of times to retry before parking.
+   * \return Whether the element is pushed, which fails when the queue is closed.
+   */
+  template <typename U>
+  bool Push(U&& value, uint32_t spin_count = kDefaultSpinCount) {
+    return Wait(&not_full_, spin_count, [&] { return TryPush(std::forward<U>(value)); });
+  }
+  /*!
+   * \brief Pop an element, waiting for one when the queue is empty.
+   * \param output The pointer to store the element.
+   * \param spin_count The number of times to retry before parking.
+   * \return Whether an element is popped, which fails when the queue is closed.
+   */
+  template <typename U>
+  bool Pop(U* output, uint32_t spin_count = kDefaultSpinCount) {
+    return Wait(&not_empty_, spin_count, [&] { return TryPop(output); });
+  }
+  /*! \brief Close the queue, which fails the current and the future blocking operations. */
+  void Close() {
+    closed_.store(true, std::memory_order_seq_cst);
+    not_empty_.NotifyAll();
+    not_full_.NotifyAll();
+  }
+  /*! \brief Whether the queue is closed. */
+  bool Closed() const { return closed_.load(std::memory_order_acquire); }
+  /*! \brief The number of elements in the queue, which is exact when nobody pushes or pops. */
+  size_t Size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+  /*! \brief Whether the queue has no element. */
+  bool Empty() const { return Size() == 0; }
+  /*! \brief Whether the queue has no room. */
+  bool Full() const { return Size() >= capacity_; }
+  /*! \brief The number of elements that the queue can hold. */
+  size_t Capacity() const { return capacity_; }
+
+  /*! \brief The default number of retries before a blocking operation parks. */
+  static constexpr uint32_t kDefaultSpinCount = 1024;
+
+ private:
+  /*! \brief The slot of an element, with the sequence number of the position it serves. */
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+  /*! \brief Retry an operation until it succeeds, parking on the event between the attempts. */
+  template <typename FTry>
+  bool Wait(EventCount* event, uint32_t spin_count, FTry ftry) {
+    for (uint32_t i = 0;; ++i) {
+      if (Closed()) return false;
+      if (ftry()) return true;
+      if (i < spin_count) {
+        std::this_thread::yield();
+        continue;
+      }
+      uint32_t epoch = event->PrepareWait();
+      if (Closed()) {
+        event->CancelWait();
+        return false;
+      }
+      if (ftry()) {
+        event->CancelWait();
+        return true;
+      }
+      event->Wait(epoch);
+    }
+  }
+
+  /*! \brief The number of elements that the queue can hold. */
+  const size_t capacity_;
+  /*! \brief The cells of the ring. */
+  std::vector<Cell> cells_;
+  /*! \brief The position of the next push. */
+  alignas(kCacheLineBytes) std::atomic<size_t> tail_{0};
+  /*! \brief The position of the next pop. */
+  alignas(kCacheLineBytes) std::atomic<size_t> head_{0};
+  /*! \brief Whether the queue is closed. */
+  alignas(kCacheLineBytes) std::atomic<bool> closed_{false};
+  /*! \brief The event of the consumers waiting for data. */
+  EventCount not_empty_;
+  /*! \brief The event of the producers waiting for room. */
+  EventCount not_full_;
+};
+
+}  // namespace support
+}  // namespace tvm
+#endif  // TVM_SUPPORT_MPMC_QUEUE_H_
@@ -124,13 +124,19 @@ class Pipe : public dmlc::Stream {
     DWORD nwrite = static_cast<DWORD>(RetryCallOnEINTR(fwrite, GetLastErrorCode));
     ICHECK_EQ(static_cast<size_t>(nwrite), size) << "Write Error: " << GetLastError();
 #else
-    ssize_t nwrite =
-        RetryCallOnEINTR([&]() { return write(handle_, ptr, size); }, GetLastErrorCode);
-    ICHECK_NE(nwrite, -1) << "Write Error: " << strerror(errno);
-
-    ICHECK_LE(nwrite, size) << "Wrote " << nwrite << " bytes, "
-                            << "but only expected to write " << size << " bytes";
-
+    // A socket may accept fewer bytes than requested, keep writing the rest.
+    size_t nwrite = 0;
+    while (size) {
+      ssize_t nwrite_chunk =
+          RetryCallOnEINTR([&]() { return write(handle_, ptr, size); }, GetLastErrorCode);
+      ICHECK_NE(nwrite_chunk, -1) << "Write Error: " << strerror(errno);
+
+      ICHECK_LE(nwrite_chunk, size) << "Wrote " << nwrite_chunk << " bytes, "
+                                    << "but only expected to write " << size << " bytes";
+      size -= nwrite_chunk;
+      ptr = static_cast<const char*>(ptr) + nwrite_chunk;
+      nwrite += nwrite_chunk;
+    }
 #endif
 
     return nwrite;
@@ -23,6 +23,8 @@
  */
 #include <dmlc/memory_io.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
@@ -31,14 +33,20 @@
 #include <tvm/tir/function.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <unordered_set>
 #include <vector>
 
 #include "../runtime/library_module.h"
 #include "../support/base64.h"
+#include "../support/process_id.h"
+#include "../support/utils.h"
 
 namespace tvm {
 namespace codegen {
@@ -55,12 +63,98 @@ namespace codegen {
  */
 using FTVMTIRToRuntime = tvm::runtime::TypedPackedFunc<runtime::Module(IRModule, Target)>;
 
-runtime::Module Build(IRModule mod, Target target) {
-  if (transform::PassContext::Current()
-          ->GetConfig<Bool>("tir.disable_assert", Bool(false))
-          .value()) {
-    mod = tir::transform::SkipAssert()(mod);
+TVM_REGISTER_PASS_CONFIG_OPTION("target.kernel_cache_dir", String);
+
+/*!
+ * \brief The on-disk cache of the modules built by `Build`, which is enabled by setting the pass
+ * config "target.kernel_cache_dir" to an existing directory.
+ *
+ * A module is keyed by the structural hash of the lowered IRModule, the target, the pass context
+ * and the versions of TVM and LLVM, and stored as its binary serialization, e.g. the PTX or
+ * cubin of CUDA. Only the modules that are binary serializable with all their imports are
+ * cached, i.e. the device modules; the host modules, e.g. of LLVM, are always built again.
+ */
+class KernelCache {
+ public:
+  /*! \brief The key of a module in the cache. */
+  static std::string Key(const IRModule& mod, const Target& target) {
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    uint64_t hash = StructuralHash()(mod);
+    hash = support::HashCombine(hash, std::hash<std::string>()(target->str()));
+    hash = support::HashCombine(hash, pass_ctx->opt_level);
+    std::vector<std::string> config_keys;
+    for (const auto& kv : pass_ctx->config) {
+      if (kv.first != "target.kernel_cache_dir") {
+        config_keys.push_back(kv.first);
+      }
+    }
+    std::sort(config_keys.begin(), config_keys.end());
+    for (const std::string& key : config_keys) {
+      hash = support::HashCombine(hash, std::hash<std::string>()(key));
+      hash = support::HashCombine(hash, StructuralHash()(pass_ctx->config[key]));
+    }
+    hash = support::HashCombine(hash, std::hash<std::string>()(TVM_VERSION));
+    if (const PackedFunc* f = runtime::Registry::Get("target.llvm_version_major")) {
+      hash = support::HashCombine(hash, static_cast<int>((*f)()));
+    }
+    std::ostringstream os;
+    os << target->kind->name << "-" << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return os.str();
+  }
+
+  /*! \brief Whether the module and all its imports can be saved to and loaded from binary. */
+  static bool IsCacheable(const runtime::Module& mod) {
+    if (!mod->IsBinarySerializable()) {
+      return false;
+    }
+    return std::all_of(mod->imports().begin(), mod->imports().end(), IsCacheable);
+  }
+
+  /*! \brief Load a module from the cache, or NullOpt if it is not there or cannot be loaded. */
+  static Optional<runtime::Module> Load(const std::string& dir, const std::string& key) {
+    std::ifstream is(Path(dir, key), std::ios::binary);
+    if (!is.good()) {
+      return NullOpt;
+    }
+    std::string blob((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    try {
+      return DeserializeModuleFromBytes(blob);
+    } catch (const std::runtime_error& e) {
+      LOG(WARNING) << "Cannot load the cached kernel " << key << ", building it again: "
+                   << e.what();
+      return NullOpt;
+    }
   }
+
+  /*!
+   * \brief Store a module in the cache, through a temporary file renamed into place so that
+   * concurrent builds never read a partial file.
+   */
+  static void Store(const std::string& dir, const std::string& key, const runtime::Module& mod) {
+    std::string path = Path(dir, key);
+    std::string tmp_path = path + ".tmp" + std::to_string(support::GetProcessId());
+    std::string blob = SerializeModuleToBytes(mod, /*export_dso=*/false);
+    {
+      std::ofstream os(tmp_path, std::ios::binary);
+      os.write(blob.data(), blob.size());
+      if (!os.good()) {
+        LOG(WARNING) << "Cannot write the kernel cache file " << tmp_path;
+        return;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      LOG(WARNING) << "Cannot write the kernel cache file " << path;
+      std::remove(tmp_path.c_str());
+    }
+  }
+
+ private:
+  static std::string Path(const std::string& dir, const std::string& key) {
+    return dir + "/" + key + ".bin";
+  }
+};
+
+runtime::Module BuildUncached(IRModule mod, Target target) {
   auto target_attr_map = tvm::TargetKind::GetAttrMap<FTVMTIRToRuntime>("TIRToRuntime");
   if (target_attr_map.count(target->kind)) {
     return target_attr_map[target->kind](mod, target);
@@ -73,6 +167,27 @@ runtime::Module Build(IRModule mod, Target target) {
   return (*bf)(mod, target);
 }
 
+runtime::Module Build(IRModule mod, Target target) {
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  if (pass_ctx->GetConfig<Bool>("tir.disable_assert", Bool(false)).value()) {
+    mod = tir::transform::SkipAssert()(mod);
+  }
+  std::string cache_dir =
+      pass_ctx->GetConfig<String>("target.kernel_cache_dir", String("")).value();
+  if (cache_dir.empty()) {
+    return BuildUncached(mod, target);
+  }
+  std::string key = KernelCache::Key(mod, target);
+  if (Optional<runtime::Module> cached = KernelCache::Load(cache_dir, key)) {
+    return cached.value();
+  }
+  runtime::Module built = BuildUncached(mod, target);
+  if (KernelCache::IsCacheable(built)) {
+    KernelCache::Store(cache_dir, key, built);
+  }
+  return built;
+}
+
 /*! \brief Helper class to serialize module */
 class ModuleSerializer {
  public:
@@ -91,10 +91,14 @@ std::unique_ptr<llvm::Module> CodeGenBlob(const std::string& data, bool system_l
     tvm_dev_mblob->setSection(".lrodata");
   }
 
+  // Page align the large blobs, so their pages hold nothing else and map straight from the
+  // shared library.
+  const size_t page_size = 4096;
+  const size_t blob_alignment = data.size() >= page_size ? page_size : 1;
 #if TVM_LLVM_VERSION >= 100
-  tvm_dev_mblob->setAlignment(llvm::Align(1));
+  tvm_dev_mblob->setAlignment(llvm::Align(blob_alignment));
 #else
-  tvm_dev_mblob->setAlignment(1);
+  tvm_dev_mblob->setAlignment(blob_alignment);
 #endif
 
   if (triple.isOSWindows()) {
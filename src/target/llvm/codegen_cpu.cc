@@ -455,6 +455,8 @@ void CodeGenCPU::InitGlobalContext(bool dynamic_lookup) {
       // Mark as context functions
       gv_func_map_["TVMBackendAllocWorkspace"] = nullptr;
       gv_func_map_["TVMBackendFreeWorkspace"] = nullptr;
+      gv_func_map_["TVMBackendLoopProfileStart"] = nullptr;
+      gv_func_map_["TVMBackendLoopProfileEnd"] = nullptr;
     }
   }
 }
@@ -1352,6 +1354,11 @@ llvm::Value* CodeGenCPU::CreateIntrinsic(const CallNode* op) {
     return CreateCallPacked(op, false /* use_string_lookup */);
   } else if (op->op.same_as(builtin::tvm_static_handle())) {
     return CreateStaticHandle();
+  } else if (op->op.same_as(builtin::start_profile_intrinsic())) {
+    // Count the cycles of the instrumented loop in the runtime, see DumpLoopProfile.
+    return CreateCallExtern(VoidType(), "TVMBackendLoopProfileStart", op->args, false);
+  } else if (op->op.same_as(builtin::end_profile_intrinsic())) {
+    return CreateCallExtern(VoidType(), "TVMBackendLoopProfileEnd", op->args, false);
   } else if (op->op.same_as(builtin::tvm_throw_last_error())) {
     builder_->CreateRet(ConstInt32(-1));
     auto next_block = std::next(builder_->GetInsertBlock()->getIterator());
@@ -206,9 +206,9 @@ llvm::Value* CodeGenHexagon::VisitExpr_(const BufferLoadNode* op) {
 }
 
 llvm::Value* CodeGenHexagon::CreateIntrinsic(const CallNode* op) {
-#if TVM_LLVM_VERSION >= 150
   if (op->op.same_as(builtin::start_profile_intrinsic()) ||
       op->op.same_as(builtin::end_profile_intrinsic())) {
+#if TVM_LLVM_VERSION >= 150
     llvm::Value* id = MakeValue(op->args[0]);
     auto instrprof_id = llvm::Intrinsic::hexagon_instrprof_custom;
     llvm::Function* func = llvm::Intrinsic::getDeclaration(module_.get(), instrprof_id);
@@ -222,8 +222,11 @@ llvm::Value* CodeGenHexagon::CreateIntrinsic(const CallNode* op) {
     }
     llvm::Type* t_int8_p_ = t_int8_->getPointerTo();
     return builder_->CreateCall(func, {llvm::ConstantExpr::getBitCast(name_var, t_int8_p_), id});
-  }
+#else
+    // Hexagon collects the profile with its own handler, which needs LLVM 15.
+    return CodeGenLLVM::CreateIntrinsic(op);
 #endif
+  }
   return CodeGenCPU::CreateIntrinsic(op);
 }
 
@@ -1465,6 +1465,37 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
       indices.push_back(i);
     }
     return builder_->CreateShuffleVector(v0, v1, indices);
+  } else if (op->op.same_as(builtin::vector_reduce_add()) ||
+             op->op.same_as(builtin::vector_reduce_mul())) {
+    llvm::Value* v = MakeValue(op->args[0]);
+    bool is_add = op->op.same_as(builtin::vector_reduce_add());
+    if (!op->dtype.is_float()) {
+      return is_add ? builder_->CreateAddReduce(v) : builder_->CreateMulReduce(v);
+    }
+    // The lanes may be combined in any order, which lets LLVM use a tree of vector operations
+    // rather than a sequential chain.
+    llvm::IRBuilderBase::FastMathFlagGuard fmf_guard(*builder_);
+    llvm::FastMathFlags fmf = builder_->getFastMathFlags();
+    fmf.setAllowReassoc();
+    builder_->setFastMathFlags(fmf);
+    llvm::Type* type = DTypeToLLVMType(op->dtype);
+    return is_add ? builder_->CreateFAddReduce(llvm::ConstantFP::get(type, -0.0), v)
+                  : builder_->CreateFMulReduce(llvm::ConstantFP::get(type, 1.0), v);
+  } else if (op->op.same_as(builtin::vector_reduce_max()) ||
+             op->op.same_as(builtin::vector_reduce_min())) {
+    llvm::Value* v = MakeValue(op->args[0]);
+    bool is_max = op->op.same_as(builtin::vector_reduce_max());
+    if (op->dtype.is_float()) {
+#if TVM_LLVM_VERSION >= 120
+      return is_max ? builder_->CreateFPMaxReduce(v) : builder_->CreateFPMinReduce(v);
+#else
+      return is_max ? builder_->CreateFPMaxReduce(v, /*NoNaN=*/false)
+                    : builder_->CreateFPMinReduce(v, /*NoNaN=*/false);
+#endif
+    }
+    bool is_signed = op->dtype.is_int();
+    return is_max ? builder_->CreateIntMaxReduce(v, is_signed)
+                  : builder_->CreateIntMinReduce(v, is_signed);
   } else if (op->op.same_as(builtin::atomic_add())) {
     // TODO(masahi): Support atomic for CPU backend
     LOG(FATAL) << "CPU backend does not support atomic add yet.";
@@ -2016,6 +2047,16 @@ void CodeGenLLVM::VisitStmt_(const AllocateConstNode* op) {
   std::string symbol_name = op->buffer_var->name_hint;
   llvm::GlobalVariable* param_symbol = new llvm::GlobalVariable(
       *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
+  // Page align the large constants, so their pages hold nothing else and map straight from the
+  // object file.
+  const size_t page_size = 4096;
+  if (runtime::GetDataSize(*data.operator->()) >= page_size) {
+#if TVM_LLVM_VERSION >= 100
+    param_symbol->setAlignment(llvm::Align(page_size));
+#else
+    param_symbol->setAlignment(page_size);
+#endif
+  }
 
   var_map_[op->buffer_var.operator->()] = param_symbol;
   this->VisitStmt(op->body);
@@ -266,10 +266,11 @@ LLVMTargetInfo::LLVMTargetInfo(LLVMInstance& instance, const TargetJSON& target)
   // LLVM JIT engine options
   if (const auto& v = Downcast<Optional<String>>(target.Get("jit"))) {
     String value = v.value();
-    if ((value == "mcjit") || (value == "orcjit")) {
+    if ((value == "mcjit") || (value == "orcjit") || (value == "orcjit-lazy")) {
       jit_engine_ = value;
     } else {
-      LOG(FATAL) << "invalid jit option " << value << " (can be `mcjit` or `orcjit`).";
+      LOG(FATAL) << "invalid jit option " << value
+                 << " (can be `mcjit`, `orcjit` or `orcjit-lazy`).";
     }
   }
 
@@ -222,7 +222,7 @@ class LLVMTargetInfo {
   llvm::FastMathFlags GetFastMathFlags() const { return fast_math_flags_; }
   /*!
    * \brief Get the LLVM JIT engine type
-   * \return the type name of the JIT engine (default "mcjit" or "orcjit")
+   * \return the type name of the JIT engine (default "mcjit", "orcjit" or "orcjit-lazy")
    */
   const std::string GetJITEngine() const { return jit_engine_; }
   /*!
@@ -31,6 +31,7 @@
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
@@ -44,6 +45,7 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #if TVM_LLVM_VERSION >= 180
 #include <llvm/TargetParser/Host.h>
 #else
@@ -55,6 +57,7 @@
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relay/runtime.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/string.h>
@@ -64,16 +67,21 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
 #include <memory>
+#include <functional>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -92,6 +100,52 @@ using runtime::PackedFunc;
 using runtime::TVMArgs;
 using runtime::TVMRetValue;
 
+/*!
+ * \brief The object cache of the JIT engines in the persistent kernel cache, so that the objects
+ * compiled from the same LLVM module for the same target machine are reused by later processes.
+ * An object is keyed by the bitcode of the compiled module, which is a partition of the module
+ * with a lazy JIT, and the target machine. It is disabled without a kernel cache directory.
+ */
+class LLVMObjectCache : public llvm::ObjectCache {
+ public:
+  explicit LLVMObjectCache(const llvm::TargetMachine& tm)
+      : target_key_(tm.getTargetTriple().str() + "\n" + tm.getTargetCPU().str() + "\n" +
+                    tm.getTargetFeatureString().str() + "\n" +
+                    std::to_string(static_cast<int>(tm.getOptLevel())) + "\n" +
+                    std::to_string(TVM_LLVM_VERSION)) {}
+
+  void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) final {
+    if (runtime::GetKernelCacheDir().empty()) {
+      return;
+    }
+    runtime::SaveKernelCacheEntry(Key(*module), obj.getBuffer().str());
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) final {
+    std::string data;
+    if (runtime::GetKernelCacheDir().empty() ||
+        !runtime::LoadKernelCacheEntry(Key(*module), &data)) {
+      return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(data, module->getModuleIdentifier());
+  }
+
+ private:
+  std::string Key(const llvm::Module& module) const {
+    std::string bitcode;
+    llvm::raw_string_ostream os(bitcode);
+#if TVM_LLVM_VERSION <= 60
+    llvm::WriteBitcodeToFile(&module, os);
+#else
+    llvm::WriteBitcodeToFile(module, os);
+#endif
+    os.flush();
+    return runtime::GetKernelCacheKey({"llvm_object", target_key_, bitcode});
+  }
+
+  std::string target_key_;
+};
+
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode();
@@ -118,12 +172,25 @@ class LLVMModuleNode final : public runtime::ModuleNode {
 
   void SetJITEngine(const std::string& jit_engine) { jit_engine_ = jit_engine; }
 
+  /*!
+   * \brief Add a module built from another partition of the same IRModule. It is imported, so that
+   * it is linked in when exporting, and its functions are looked up through this module, which
+   * also resolves the packed functions they call.
+   */
+  void AddPartition(ObjectPtr<LLVMModuleNode> partition) {
+    partition->env_module_ = this;
+    runtime::Module mod(partition);
+    this->Import(mod);
+    partitions_.push_back(mod);
+  }
+
  private:
   void InitMCJIT();
   void InitORCJIT();
   bool IsCompatibleWithHost(const llvm::TargetMachine* tm) const;
   void* GetGlobalAddr(const std::string& name, const LLVMTarget& llvm_target) const;
   void* GetFunctionAddr(const std::string& name, const LLVMTarget& llvm_target) const;
+  bool IsORCJIT() const { return jit_engine_ == "orcjit" || jit_engine_ == "orcjit-lazy"; }
 
   // The LLVM scope object.
   std::unique_ptr<LLVMInstance> llvm_instance_;
@@ -132,6 +199,8 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   // jit execution engines
   llvm::ExecutionEngine* mcjit_ee_{nullptr};
   std::unique_ptr<llvm::orc::LLJIT> orcjit_ee_{nullptr};
+  // the object cache of the jit execution engine
+  std::unique_ptr<LLVMObjectCache> object_cache_{nullptr};
   // The raw pointer to the module.
   llvm::Module* module_{nullptr};
   // The unique_ptr owning the module. This becomes empty once JIT has been initialized
@@ -140,6 +209,10 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   /* \brief names of the external functions declared in this module */
   Array<String> function_names_;
   std::string jit_engine_;
+  /*! \brief The other partitions of a partitioned build, see `AddPartition` */
+  std::vector<runtime::Module> partitions_;
+  /*! \brief The module that resolves the packed function calls, or nullptr for this module */
+  runtime::ModuleNode* env_module_{nullptr};
 };
 
 LLVMModuleNode::~LLVMModuleNode() {
@@ -184,7 +257,7 @@ PackedFunc LLVMModuleNode::GetFunction(const String& name, const ObjectPtr<Objec
   }
   ICHECK(jit_engine_.size()) << "JIT engine type is missing";
   if ((jit_engine_ == "mcjit") && (mcjit_ee_ == nullptr)) InitMCJIT();
-  if ((jit_engine_ == "orcjit") && (orcjit_ee_ == nullptr)) InitORCJIT();
+  if (IsORCJIT() && (orcjit_ee_ == nullptr)) InitORCJIT();
 
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -199,7 +272,18 @@ PackedFunc LLVMModuleNode::GetFunction(const String& name, const ObjectPtr<Objec
   } else {
     faddr = reinterpret_cast<TVMBackendPackedCFunc>(GetFunctionAddr(name, *llvm_target));
   }
-  if (faddr == nullptr) return PackedFunc();
+  if (faddr == nullptr) {
+    for (runtime::Module& partition : partitions_) {
+      PackedFunc pf = partition.GetFunction(name);
+      if (pf != nullptr) {
+        // Keep this module, which resolves the packed calls of the partition, alive
+        return PackedFunc([pf, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+          pf.CallPacked(args, rv);
+        });
+      }
+    }
+    return PackedFunc();
+  }
   return WrapPackedFunc(faddr, sptr_to_self);
 }
 
@@ -400,6 +484,11 @@ void LLVMModuleNode::LoadIR(const std::string& file_name) {
 }
 
 bool LLVMModuleNode::ImplementsFunction(const String& name, bool query_imports) {
+  for (runtime::Module& partition : partitions_) {
+    if (partition->ImplementsFunction(name, false)) {
+      return true;
+    }
+  }
   return std::find(function_names_.begin(), function_names_.end(), name) != function_names_.end();
 }
 
@@ -428,6 +517,7 @@ void LLVMModuleNode::InitMCJIT() {
   if (!IsCompatibleWithHost(tm.get())) {
     LOG(FATAL) << "Cannot run module, architecture mismatch";
   }
+  object_cache_ = std::make_unique<LLVMObjectCache>(*tm);
 
   // data layout
   llvm::DataLayout layout(tm->createDataLayout());
@@ -440,6 +530,7 @@ void LLVMModuleNode::InitMCJIT() {
   mcjit_ee_ = builder.create(tm.release());
   ICHECK(mcjit_ee_ != nullptr) << "Failed to initialize LLVM MCJIT engine for "
                                << module_->getTargetTriple();
+  mcjit_ee_->setObjectCache(object_cache_.get());
 
   VLOG(2) << "LLVM MCJIT execute " << module_->getModuleIdentifier() << " for triple `"
           << llvm_target->GetTargetTriple() << "`"
@@ -450,7 +541,7 @@ void LLVMModuleNode::InitMCJIT() {
 
   if (void** ctx_addr =
           reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx, *llvm_target))) {
-    *ctx_addr = this;
+    *ctx_addr = env_module_ ? env_module_ : this;
   }
   runtime::InitContextFunctions(
       [this, &llvm_target](const char* name) { return GetGlobalAddr(name, *llvm_target); });
@@ -487,6 +578,7 @@ void LLVMModuleNode::InitORCJIT() {
   if (!IsCompatibleWithHost(tm.get())) {
     LOG(FATAL) << "Cannot run module, architecture mismatch";
   }
+  object_cache_ = std::make_unique<LLVMObjectCache>(*tm);
 
   // data layout
   String module_name = module_->getModuleIdentifier();
@@ -499,7 +591,7 @@ void LLVMModuleNode::InitORCJIT() {
   // compiler
   const auto compilerBuilder = [&](const llvm::orc::JITTargetMachineBuilder&)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
-    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(tm));
+    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(tm), object_cache_.get());
   };
 
 #if TVM_LLVM_VERSION >= 130
@@ -509,16 +601,26 @@ void LLVMModuleNode::InitORCJIT() {
   };
 #endif
 
-  // create LLJIT
-  orcjit_ee_ = llvm::cantFail(llvm::orc::LLJITBuilder()
+  // create LLJIT, or LLLazyJIT which compiles each function at its first call
+  const auto configure = [&](auto& jit_builder) {
 #if TVM_LLVM_VERSION >= 110
-                                  .setDataLayout(layout)
+    jit_builder.setDataLayout(layout);
 #endif
-                                  .setCompileFunctionCreator(compilerBuilder)
+    jit_builder.setCompileFunctionCreator(compilerBuilder);
 #if TVM_LLVM_VERSION >= 130
-                                  .setObjectLinkingLayerCreator(linkerBuilder)
+    jit_builder.setObjectLinkingLayerCreator(linkerBuilder);
 #endif
-                                  .create());
+  };
+  bool lazy = jit_engine_ == "orcjit-lazy";
+  if (lazy) {
+    llvm::orc::LLLazyJITBuilder jit_builder;
+    configure(jit_builder);
+    orcjit_ee_ = llvm::cantFail(jit_builder.create());
+  } else {
+    llvm::orc::LLJITBuilder jit_builder;
+    configure(jit_builder);
+    orcjit_ee_ = llvm::cantFail(jit_builder.create());
+  }
 
   ICHECK(orcjit_ee_ != nullptr) << "Failed to initialize LLVM ORCJIT engine for "
                                 << module_->getTargetTriple();
@@ -540,7 +642,8 @@ void LLVMModuleNode::InitORCJIT() {
 
   // add the llvm module to run
   llvm::orc::ThreadSafeModule tsm(std::move(umod), std::move(uctx));
-  auto err = orcjit_ee_->addIRModule(std::move(tsm));
+  auto err = lazy ? static_cast<llvm::orc::LLLazyJIT&>(*orcjit_ee_).addLazyIRModule(std::move(tsm))
+                  : orcjit_ee_->addIRModule(std::move(tsm));
   ICHECK(!err) << llvm::toString(std::move(err));
 
   VLOG(2) << "LLVM ORCJIT execute " << module_->getModuleIdentifier() << " for triple `"
@@ -553,7 +656,7 @@ void LLVMModuleNode::InitORCJIT() {
 
   if (void** ctx_addr =
           reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx, *llvm_target))) {
-    *ctx_addr = this;
+    *ctx_addr = env_module_ ? env_module_ : this;
   }
   runtime::InitContextFunctions(
       [this, &llvm_target](const char* name) { return GetGlobalAddr(name, *llvm_target); });
@@ -576,7 +679,7 @@ void* LLVMModuleNode::GetGlobalAddr(const std::string& name, const LLVMTarget& l
   if (module_->getGlobalVariable(name) != nullptr) {
     if (jit_engine_ == "mcjit") {
       return reinterpret_cast<void*>(mcjit_ee_->getGlobalValueAddress(name));
-    } else if (jit_engine_ == "orcjit") {
+    } else if (IsORCJIT()) {
 #if TVM_LLVM_VERSION >= 150
       auto addr = llvm::cantFail(orcjit_ee_->lookup(name)).getValue();
 #else
@@ -596,7 +699,7 @@ void* LLVMModuleNode::GetFunctionAddr(const std::string& name,
   if (module_->getFunction(name) != nullptr) {
     if (jit_engine_ == "mcjit") {
       return reinterpret_cast<void*>(mcjit_ee_->getFunctionAddress(name));
-    } else if (jit_engine_ == "orcjit") {
+    } else if (IsORCJIT()) {
 #if TVM_LLVM_VERSION >= 150
       auto addr = llvm::cantFail(orcjit_ee_->lookup(name)).getValue();
 #else
@@ -610,11 +713,116 @@ void* LLVMModuleNode::GetFunctionAddr(const std::string& name,
   return nullptr;
 }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("target.llvm_codegen_partitions", Integer);
+
+/*!
+ * \brief Split the functions of a module into at most `num_partitions` modules of balanced sizes
+ * that can be compiled apart, i.e. with no calls between them. The entry function is always in
+ * the first partition, which becomes the root module.
+ */
+std::vector<IRModule> PartitionForParallelCodegen(const IRModule& mod, int num_partitions) {
+  std::vector<GlobalVar> gvars;
+  std::unordered_map<const GlobalVarNode*, int> gvar2index;
+  for (const auto& kv : mod->functions) {
+    gvar2index[kv.first.get()] = gvars.size();
+    gvars.push_back(kv.first);
+  }
+  int n = gvars.size();
+  // Union the functions that call each other, and estimate their sizes by their number of nodes
+  std::vector<int> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<int(int)> f_find = [&](int i) {
+    return parent[i] == i ? i : parent[i] = f_find(parent[i]);
+  };
+  std::vector<int64_t> sizes(n, 1);
+  int entry = 0;
+  for (int i = 0; i < n; ++i) {
+    const auto* func = mod->functions[gvars[i]].as<PrimFuncNode>();
+    if (func == nullptr) {
+      continue;
+    }
+    if (func->HasNonzeroAttr(tir::attr::kIsEntryFunc)) {
+      entry = i;
+    }
+    tir::PostOrderVisit(func->body, [&](const ObjectRef& node) {
+      ++sizes[i];
+      if (const auto* call = node.as<tir::CallNode>()) {
+        if (const auto* callee = call->op.as<GlobalVarNode>()) {
+          auto it = gvar2index.find(callee);
+          if (it != gvar2index.end()) {
+            parent[f_find(i)] = f_find(it->second);
+          }
+        }
+      }
+    });
+  }
+  std::unordered_map<int, int> root2group;
+  std::vector<std::vector<int>> groups;
+  std::vector<int64_t> group_sizes;
+  for (int i = 0; i < n; ++i) {
+    auto [it, inserted] = root2group.emplace(f_find(i), groups.size());
+    if (inserted) {
+      groups.emplace_back();
+      group_sizes.push_back(0);
+    }
+    groups[it->second].push_back(i);
+    group_sizes[it->second] += sizes[i];
+  }
+  // Assign the largest groups first to the least loaded partition, the entry group to the first
+  int entry_group = root2group.at(f_find(entry));
+  std::vector<int> order(groups.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    if ((a == entry_group) != (b == entry_group)) {
+      return a == entry_group;
+    }
+    return group_sizes[a] > group_sizes[b];
+  });
+  num_partitions = std::min<int>(num_partitions, groups.size());
+  std::vector<Map<GlobalVar, BaseFunc>> partitions(num_partitions);
+  std::vector<int64_t> loads(num_partitions, 0);
+  for (int g : order) {
+    int p = g == entry_group ? 0 : std::min_element(loads.begin(), loads.end()) - loads.begin();
+    for (int i : groups[g]) {
+      partitions[p].Set(gvars[i], mod->functions[gvars[i]]);
+    }
+    loads[p] += group_sizes[g];
+  }
+  std::vector<IRModule> results;
+  for (const Map<GlobalVar, BaseFunc>& functions : partitions) {
+    results.push_back(IRModule(functions, {}, {}, {}, mod->attrs));
+  }
+  return results;
+}
+
 TVM_REGISTER_GLOBAL("target.build.llvm")
     .set_body_typed([](IRModule mod, Target target) -> runtime::Module {
-      auto n = make_object<LLVMModuleNode>();
-      n->Init(mod, target);
-      return runtime::Module(n);
+      tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+      int num_partitions =
+          pass_ctx->GetConfig<Integer>("target.llvm_codegen_partitions", Integer(1)).value()->value;
+      relay::Runtime runtime =
+          mod->GetAttr<relay::Runtime>(tvm::attr::kRuntime).value_or(relay::Runtime::Create("cpp"));
+      // The system library registers the symbols of a single module, and the LLVM command line
+      // options are global state that the threads cannot set concurrently.
+      Optional<Array<String>> cl_opt = target->GetAttr<Array<String>>("cl-opt");
+      if (num_partitions > 1 && (mod->GetAttr<String>(tvm::attr::kSystemLibPrefix).defined() ||
+                                 runtime->GetAttr<Bool>("system-lib").value_or(Bool(false)) ||
+                                 runtime->name == "crt" || (cl_opt && !cl_opt.value().empty()))) {
+        num_partitions = 1;
+      }
+      std::vector<IRModule> partitions = num_partitions > 1
+                                             ? PartitionForParallelCodegen(mod, num_partitions)
+                                             : std::vector<IRModule>{mod};
+      std::vector<ObjectPtr<LLVMModuleNode>> nodes(partitions.size());
+      support::parallel_for_dynamic(0, partitions.size(), partitions.size(), [&](int, int i) {
+        tvm::transform::PassContextWorkerScope scope(pass_ctx);
+        nodes[i] = make_object<LLVMModuleNode>();
+        nodes[i]->Init(partitions[i], target);
+      });
+      for (size_t i = 1; i < nodes.size(); ++i) {
+        nodes[0]->AddPartition(nodes[i]);
+      }
+      return runtime::Module(nodes[0]);
     });
 
 TVM_REGISTER_GLOBAL("codegen.LLVMModuleCreate")
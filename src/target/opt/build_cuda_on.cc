@@ -172,5 +172,6 @@ runtime::Module BuildCUDA(IRModule mod, Target target) {
 
 TVM_REGISTER_GLOBAL("target.build.cuda").set_body_typed(BuildCUDA);
 TVM_REGISTER_PASS_CONFIG_OPTION("cuda.kernels_output_dir", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("cuda.fatbin_archs", Array<String>);
 }  // namespace codegen
 }  // namespace tvm
@@ -42,7 +42,10 @@
 namespace tvm {
 namespace codegen {
 
-CodeGenCHost::CodeGenCHost() { module_name_ = name_supply_->FreshName("__tvm_module_ctx"); }
+CodeGenCHost::CodeGenCHost() {
+  module_name_ = name_supply_->FreshName("__tvm_module_ctx");
+  restrict_keyword_ = "TVM_RESTRICT";
+}
 
 void CodeGenCHost::Init(bool output_ssa, bool emit_asserts, bool emit_fwd_func_decl,
                         std::string target_str, const std::unordered_set<std::string>& devices) {
@@ -55,6 +58,33 @@ void CodeGenCHost::Init(bool output_ssa, bool emit_asserts, bool emit_fwd_func_d
   decl_stream << "#include \"tvm/runtime/c_backend_api.h\"\n";
   decl_stream << "#include <math.h>\n";
   decl_stream << "#include <stdbool.h>\n";
+  // Hints of the buffer aliasing, alignment and vectorized loops, which are empty for the
+  // compilers not supporting them.
+  decl_stream << "#ifndef TVM_RESTRICT\n"
+              << "#if defined(__GNUC__) || defined(_MSC_VER)\n"
+              << "#define TVM_RESTRICT __restrict\n"
+              << "#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L\n"
+              << "#define TVM_RESTRICT restrict\n"
+              << "#else\n"
+              << "#define TVM_RESTRICT\n"
+              << "#endif\n"
+              << "#endif\n";
+  decl_stream << "#ifndef TVM_ASSUME_ALIGNED\n"
+              << "#if defined(__GNUC__)\n"
+              << "#define TVM_ASSUME_ALIGNED(ptr, align) __builtin_assume_aligned((ptr), (align))\n"
+              << "#else\n"
+              << "#define TVM_ASSUME_ALIGNED(ptr, align) (ptr)\n"
+              << "#endif\n"
+              << "#endif\n";
+  decl_stream << "#ifndef TVM_VECTORIZE_LOOP\n"
+              << "#if defined(__clang__)\n"
+              << "#define TVM_VECTORIZE_LOOP _Pragma(\"clang loop vectorize(enable)\")\n"
+              << "#elif defined(__GNUC__)\n"
+              << "#define TVM_VECTORIZE_LOOP _Pragma(\"GCC ivdep\")\n"
+              << "#else\n"
+              << "#define TVM_VECTORIZE_LOOP\n"
+              << "#endif\n"
+              << "#endif\n";
   if (devices.find("ethos-u") != devices.end()) {
     decl_stream << "#include <tvm_ethosu_runtime.h>\n";
   }
@@ -87,7 +117,9 @@ void CodeGenCHost::AddFunction(const GlobalVar& gvar, const PrimFunc& func,
   }
 
   emit_fwd_func_decl_ = emit_fwd_func_decl;
+  no_alias_ = func->HasNonzeroAttr(tir::attr::kNoAlias);
   CodeGenC::AddFunction(gvar, func);
+  no_alias_ = false;
   if (func->HasNonzeroAttr(tir::attr::kIsEntryFunc)) {
     ICHECK(global_symbol.defined())
         << "CodeGenCHost: The entry func must have the global_symbol attribute, "
@@ -137,6 +169,15 @@ void CodeGenCHost::PrintFuncPrefix(std::ostream& os) {  // NOLINT(*)
      << "TVM_DLL ";
 }
 
+void CodeGenCHost::PrintRestrict(const Var& v, std::ostream& os) {  // NOLINT(*)
+  // Only the buffer pointers are restricted, not the handles of the packed function arguments.
+  if (auto* ptr = v->type_annotation.as<PointerTypeNode>()) {
+    if (ptr->element_type.as<PrimTypeNode>()) {
+      CodeGenC::PrintRestrict(v, os);
+    }
+  }
+}
+
 void CodeGenCHost::PrintType(DataType t, std::ostream& os) {  // NOLINT(*)
   int lanes = t.lanes();
   if (t.is_handle()) {
@@ -398,6 +439,61 @@ void CodeGenCHost::VisitStmt_(const AssertStmtNode* op) {  // NOLINT(*)
   this->PrintStmt(op->body);
 }
 
+void CodeGenCHost::VisitStmt_(const LetStmtNode* op) {  // NOLINT(*)
+  // The data pointers of the DLTensor arguments of a noalias function do not alias.
+  const auto* call = op->value.as<CallNode>();
+  bool is_arg_data = no_alias_ && !print_ssa_form_ && call != nullptr &&
+                     call->op.same_as(builtin::tvm_struct_get()) && call->args.size() == 3 &&
+                     is_const_int(call->args[2], builtin::kArrData);
+  if (!is_arg_data) {
+    CodeGenC::VisitStmt_(op);
+    return;
+  }
+  std::string value = PrintExpr(op->value);
+  PrintIndent();
+  if (handle_data_type_.count(op->var.get())) {
+    PrintType(handle_data_type_.at(op->var.get()), stream);
+    stream << "* " << restrict_keyword_ << " " << AllocVarID(op->var.get()) << " = (";
+    PrintType(handle_data_type_.at(op->var.get()), stream);
+    stream << "*)" << value << ";\n";
+  } else {
+    PrintType(op->var.dtype(), stream);
+    stream << " " << restrict_keyword_ << " " << AllocVarID(op->var.get()) << " = " << value
+           << ";\n";
+  }
+  PrintStmt(op->body);
+}
+
+void CodeGenCHost::VisitStmt_(const AttrStmtNode* op) {  // NOLINT(*)
+  if (op->attr_key == tir::attr::storage_alignment && !print_ssa_form_) {
+    // The pointers to the aligned buffers, as LLVM assumes them in CodeGenLLVM.
+    const VarNode* buffer_var = op->node.as<VarNode>();
+    const auto* align = op->value.as<IntImmNode>();
+    if (buffer_var != nullptr && align != nullptr && align->value > 1 &&
+        var_idmap_.count(buffer_var)) {
+      std::string vid = GetVarID(buffer_var);
+      PrintIndent();
+      stream << vid << " = ";
+      if (handle_data_type_.count(buffer_var)) {
+        stream << "(";
+        PrintType(handle_data_type_.at(buffer_var), stream);
+        stream << "*)";
+      }
+      stream << "TVM_ASSUME_ALIGNED(" << vid << ", " << align->value << ");\n";
+    }
+  }
+  CodeGenC::VisitStmt_(op);
+}
+
+void CodeGenCHost::VisitStmt_(const ForNode* op) {  // NOLINT(*)
+  // The loops vectorized in the schedule, but not by TVM, are hinted to the C compiler.
+  if (op->kind == ForKind::kVectorized || op->annotations.count(tir::attr::vectorize_hint)) {
+    PrintIndent();
+    stream << "TVM_VECTORIZE_LOOP\n";
+  }
+  CodeGenC::VisitStmt_(op);
+}
+
 void CodeGenCHost::VisitExpr_(const MinNode* op, std::ostream& os) {  // NOLINT(*)
   PrintTernaryCondExpr(op, "<", os);
 }
@@ -58,6 +58,7 @@ class CodeGenCHost : public CodeGenC {
   using CodeGenC::PrintType;
   void PrintType(DataType t, std::ostream& os) final;  // NOLINT(*)
   void PrintFuncPrefix(std::ostream& os) final;        // NOLINT(*)
+  void PrintRestrict(const Var& v, std::ostream& os) final;  // NOLINT(*)
 
   // overload visitor functions
   void VisitExpr_(const BroadcastNode* op, std::ostream& os) final;  // NOLINT(*)
@@ -68,6 +69,10 @@ class CodeGenCHost : public CodeGenC {
   void VisitExpr_(const MaxNode* op, std::ostream& os) final;  // NOLINT(*)
 
   void VisitStmt_(const AssertStmtNode* op) final;  // NOLINT(*)
+  // annotate the buffer pointers and the vectorized loops for the downstream C compiler
+  void VisitStmt_(const LetStmtNode* op) override;   // NOLINT(*)
+  void VisitStmt_(const AttrStmtNode* op) override;  // NOLINT(*)
+  void VisitStmt_(const ForNode* op) override;       // NOLINT(*)
 
   void GenerateForwardFunctionDeclarations(String global_symbol, const Array<Type>& arg_types,
                                            const Type& ret_type) override;
@@ -92,6 +97,8 @@ class CodeGenCHost : public CodeGenC {
   bool emit_asserts_;
   /*! \brief whether to emit forwared function declarations in the resulting C code */
   bool emit_fwd_func_decl_;
+  /*! \brief whether the buffers of the current function do not alias */
+  bool no_alias_{false};
 
   FunctionInfo GetFunctionInfo(const CallNode* op, bool has_resource_handle);
   std::string GetPackedName(const CallNode* op);
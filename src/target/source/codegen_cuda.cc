@@ -24,6 +24,7 @@
 #include "codegen_cuda.h"
 
 #include <tvm/arith/analyzer.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/index_map.h>
 #include <tvm/tir/stmt_functor.h>
@@ -74,6 +75,8 @@ void CodeGenCUDA::Init(bool output_ssa) {
   vid_global_barrier_state_ = name_supply_->FreshName(runtime::symbol::tvm_global_barrier_state);
   vid_global_barrier_expect_ = name_supply_->FreshName("__barrier_expect");
   ICHECK_EQ(vid_global_barrier_state_, runtime::symbol::tvm_global_barrier_state);
+  vid_loop_profile_counters_ = name_supply_->FreshName(runtime::symbol::tvm_loop_profile_counters);
+  ICHECK_EQ(vid_loop_profile_counters_, runtime::symbol::tvm_loop_profile_counters);
 }
 
 void CodeGenCUDA::PrintFuncPrefix(std::ostream& os) { os << "extern \"C\" __global__ "; }
@@ -182,6 +185,23 @@ std::string CodeGenCUDA::Finish() {
     decl_stream << "}\n";
   }
 
+  if (need_wgmma_desc_) {
+    // The matrix descriptor of wgmma packs the shared memory address, the leading and stride
+    // byte offsets, all in units of 16 bytes, and the swizzle mode.
+    decl_stream << "__forceinline__ __device__ unsigned long long\n";
+    decl_stream << "tvm_make_wgmma_desc(const void* const smem_ptr,\n";
+    decl_stream << "                    unsigned int leading_byte_offset,\n";
+    decl_stream << "                    unsigned int stride_byte_offset,\n";
+    decl_stream << "                    unsigned int swizzle_mode)\n";
+    decl_stream << "{\n";
+    decl_stream << "  unsigned long long desc = (cast_smem_ptr_to_int(smem_ptr) & 0x3FFFF) >> 4;\n";
+    decl_stream << "  desc |= (unsigned long long)((leading_byte_offset & 0x3FFFF) >> 4) << 16;\n";
+    decl_stream << "  desc |= (unsigned long long)((stride_byte_offset & 0x3FFFF) >> 4) << 32;\n";
+    decl_stream << "  desc |= (unsigned long long)(swizzle_mode & 0x3) << 62;\n";
+    decl_stream << "  return desc;\n";
+    decl_stream << "}\n";
+  }
+
   decl_stream << "\n#if (((__CUDACC_VER_MAJOR__ == 11) && (__CUDACC_VER_MINOR__ >= 4)) || \\\n";
   decl_stream << "     (__CUDACC_VER_MAJOR__ > 11))\n";
   decl_stream << "#define TVM_ENABLE_L2_PREFETCH 1\n";
@@ -1068,6 +1088,65 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
                  << barrier_name_ << "[" << barrier_count << "];\n";
     this->stream << "for (int i = 0; i < " << barrier_count << "; ++i) { " << barrier_name_
                  << "[i] = 0; }\n";
+  } else if (op->op.same_as(builtin::ptx_cp_async_bulk_tensor())) {
+    need_cast_smem_ptr_to_int_ = true;
+    std::string dst = this->PrintExpr(op->args[0]);
+    std::string dst_offset = this->PrintExpr(op->args[1]);
+    std::string tensor_map = this->PrintExpr(op->args[2]);
+    int barrier_id = Downcast<IntImm>(op->args[3])->value;
+    CHECK(barrier_id < barrier_count_);
+    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::vector<std::string> coords;
+    for (size_t i = 4; i < op->args.size(); ++i) {
+      coords.push_back(this->PrintExpr(op->args[i]));
+    }
+    this->stream << PrintCpAsyncBulkTensorAsm(dst, dst_offset, tensor_map, coords, barrier);
+  } else if (op->op.same_as(builtin::ptx_wgmma_mma_async())) {
+    // arg 0: shape: m64nNk16
+    // arg 1: A precision: fp16, bf16
+    // arg 2: B precision: fp16, bf16
+    // arg 3: C precision: fp16, fp32
+    // arg 4: A shared memory pointer
+    // arg 5: A offset
+    // arg 6: B shared memory pointer
+    // arg 7: B offset
+    // arg 8: C pointer
+    // arg 9: C index
+    // arg 10: whether A is transposed
+    // arg 11: whether B is transposed
+    // arg 12: the swizzle bytes of the shared memory layout
+    // arg 13: the leading byte offset of the matrix descriptors
+    // arg 14: the stride byte offset of the matrix descriptors
+    ICHECK_EQ(op->args.size(), 15U);
+    need_cast_smem_ptr_to_int_ = true;
+    need_wgmma_desc_ = true;
+    std::string shape = Downcast<StringImm>(op->args[0])->value;
+    std::string A_dtype = Downcast<StringImm>(op->args[1])->value;
+    std::string B_dtype = Downcast<StringImm>(op->args[2])->value;
+    std::string C_dtype = Downcast<StringImm>(op->args[3])->value;
+    std::string a_ptr = this->PrintExpr(op->args[4]);
+    std::string a_offset = this->PrintExpr(op->args[5]);
+    std::string b_ptr = this->PrintExpr(op->args[6]);
+    std::string b_offset = this->PrintExpr(op->args[7]);
+    std::string c_ptr = this->PrintExpr(op->args[8]);
+    std::string c_offset = this->PrintExpr(op->args[9]);
+    bool trans_a = Downcast<Bool>(op->args[10])->value;
+    bool trans_b = Downcast<Bool>(op->args[11])->value;
+    int swizzle_bytes = Downcast<IntImm>(op->args[12])->value;
+    std::string leading_byte_offset = this->PrintExpr(op->args[13]);
+    std::string stride_byte_offset = this->PrintExpr(op->args[14]);
+    this->stream << PrintWGMMAAssembly(shape, A_dtype, B_dtype, C_dtype, a_ptr, a_offset, b_ptr,
+                                       b_offset, c_ptr, c_offset, trans_a, trans_b, swizzle_bytes,
+                                       leading_byte_offset, stride_byte_offset);
+  } else if (op->op.same_as(builtin::ptx_wgmma_fence())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.fence.sync.aligned;\" ::: \"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_commit_group())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.commit_group.sync.aligned;\" ::: "
+                    "\"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_wait_group())) {
+    int n = Downcast<IntImm>(op->args[0])->value;
+    this->stream << "__asm__ __volatile__(\"wgmma.wait_group.sync.aligned " << n
+                 << ";\" ::: \"memory\");\n\n";
   } else if (op->op.same_as(builtin::ptx_ldg32())) {
     /*
     asm volatile (
@@ -1194,11 +1273,52 @@ void CodeGenCUDA::VisitStmt_(const EvaluateNode* op) {
     stream << "  " << vid_global_barrier_expect_ << " = 0;\n";
     PrintIndent();
     stream << "}\n";
+  } else if (call && (call->op.same_as(builtin::start_profile_intrinsic()) ||
+                      call->op.same_as(builtin::end_profile_intrinsic()))) {
+    PrintLoopProfile(call);
   } else {
     CodeGenC::VisitStmt_(op);
   }
 }
 
+void CodeGenCUDA::PrintLoopProfile(const CallNode* op) {
+  const auto* id_imm = op->args[0].as<IntImmNode>();
+  ICHECK(id_imm) << "The id of an instrumented loop must be a constant";
+  int64_t id = id_imm->value;
+  if (id < 0 || id >= runtime::profiling::kMaxProfiledLoops) {
+    DLOG(WARNING) << "The loop " << id << " is not profiled, as the loop profiling collects "
+                  << runtime::profiling::kMaxProfiledLoops << " loops";
+    return;
+  }
+  if (!need_loop_profile_) {
+    need_loop_profile_ = true;
+    this->decl_stream << "extern \"C\" {\n__device__ unsigned long long "
+                      << vid_loop_profile_counters_ << "["
+                      << 2 * runtime::profiling::kMaxProfiledLoops << "];\n}\n";
+  }
+  if (op->op.same_as(builtin::start_profile_intrinsic())) {
+    std::string vid = name_supply_->FreshName("loop_profile_start");
+    loop_profile_starts_[id] = vid;
+    this->PrintIndent();
+    this->stream << "long long " << vid << " = clock64();\n";
+    return;
+  }
+  auto it = loop_profile_starts_.find(id);
+  ICHECK(it != loop_profile_starts_.end()) << "The loop " << id << " ends before it starts";
+  // Every thread runs the loop, the first thread of each block counts it for the block.
+  this->PrintIndent();
+  this->stream << "if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {\n";
+  int scope = this->BeginScope();
+  this->PrintIndent();
+  this->stream << "atomicAdd(&" << vid_loop_profile_counters_ << "[" << 2 * id << "], 1ULL);\n";
+  this->PrintIndent();
+  this->stream << "atomicAdd(&" << vid_loop_profile_counters_ << "[" << 2 * id + 1
+               << "], (unsigned long long)(clock64() - " << it->second << "));\n";
+  this->EndScope(scope);
+  this->PrintIndent();
+  this->stream << "}\n";
+}
+
 void CodeGenCUDA::VisitExpr_(const RampNode* op, std::ostream& os) {
   int lanes = op->dtype.lanes();
   CHECK_LE(lanes, 4) << "ValueError: Ramp of more than 4 lanes is not allowed.";
@@ -90,6 +90,12 @@ class CodeGenCUDA final : public CodeGenC {
   std::string vid_global_barrier_state_;
   // Global barrier expected node.
   std::string vid_global_barrier_expect_;
+  // Whether the loop profiling counters are declared.
+  bool need_loop_profile_{false};
+  // The loop profiling counters, the number of runs and the cycles of each loop id.
+  std::string vid_loop_profile_counters_;
+  // The variable holding the start cycle of each instrumented loop.
+  std::unordered_map<int64_t, std::string> loop_profile_starts_;
   // whether enable fp16
   bool enable_fp16_{false};
   // whether enable bf16
@@ -106,6 +112,8 @@ class CodeGenCUDA final : public CodeGenC {
   bool need_mma_h_{false};
   // whether need cast_smem_ptr_to_int helper function
   bool need_cast_smem_ptr_to_int_{false};
+  // whether need tvm_make_wgmma_desc helper function
+  bool need_wgmma_desc_{false};
   // Op attribute map
   OpAttrMap<bool> op_need_warp_shuffle_ = Op::GetAttrMap<bool>("cuda.need_warp_shuffle");
 
@@ -123,6 +131,8 @@ class CodeGenCUDA final : public CodeGenC {
   void PrintWmmaScope(const std::string& scope, DataType t, const VarNode* variable,
                       std::ostream& os);
   int32_t GetWmmaFragmentSize(const std::string& scope, const VarNode* variable, int32_t size);
+  // Print the start_profile_intrinsic or end_profile_intrinsic of an instrumented loop.
+  void PrintLoopProfile(const CallNode* op);
 };
 
 }  // namespace codegen
@@ -827,5 +827,125 @@ std::string PrintWaitBarrierAsm(const std::string& barrier) {
   return predicated_asm_code;
 }
 
+std::string PrintCpAsyncBulkTensorAsm(const std::string& shared_ptr,
+                                      const std::string& shared_elem_offset,
+                                      const std::string& tensor_map,
+                                      const std::vector<std::string>& coords,
+                                      const std::string& barrier) {
+  CHECK(1 <= coords.size() && coords.size() <= 5)
+      << "ValueError: cp.async.bulk.tensor supports tensors of 1 to 5 dimensions, but got "
+      << coords.size() << " coordinates";
+  std::string coord_operands, coord_inputs;
+  for (size_t i = 0; i < coords.size(); ++i) {
+    coord_operands += ", %" + std::to_string(i + 3);
+    coord_inputs += ", \"r\"((int)(" + coords[i] + "))";
+  }
+  std::string asm_code = R"(
+  {
+    unsigned int smem_addr_int = cast_smem_ptr_to_int({smem_addr});
+    unsigned int barrier_addr_int = cast_smem_ptr_to_int({barrier});
+    __asm__ __volatile__(
+      "cp.async.bulk.tensor.{dim}d.shared::cluster.global.tile.mbarrier::complete_tx::bytes"
+      " [%0], [%1{coord_operands}], [%2];"
+      :: "r"(smem_addr_int), "l"((const void*)({tensor_map})), "r"(barrier_addr_int)
+         {coord_inputs}
+      : "memory"
+    );
+  }
+)";
+
+  Replacer replacer;
+  replacer.register_rule("{smem_addr}", shared_ptr + " + " + shared_elem_offset);
+  replacer.register_rule("{tensor_map}", tensor_map);
+  replacer.register_rule("{barrier}", "&" + barrier);
+  replacer.register_rule("{dim}", std::to_string(coords.size()));
+  replacer.register_rule("{coord_operands}", coord_operands);
+  replacer.register_rule("{coord_inputs}", coord_inputs);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
+std::string PrintWGMMAAssembly(const std::string& shape, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& a_ptr, const std::string& a_offset,
+                               const std::string& b_ptr, const std::string& b_offset,
+                               const std::string& c_ptr, const std::string& c_offset,
+                               bool trans_a, bool trans_b, int swizzle_bytes,
+                               const std::string& leading_byte_offset,
+                               const std::string& stride_byte_offset) {
+  ptx::DataType dtype_a = ptx::DTypeFromString(A_dtype), dtype_b = ptx::DTypeFromString(B_dtype),
+                dtype_c = ptx::DTypeFromString(C_dtype);
+  auto [m, n, k] = ptx::ParseMMAShape(shape);
+  CHECK(m == 64 && k == 16 && n % 8 == 0 && 8 <= n && n <= 256)
+      << "ValueError: wgmma supports the shapes m64nNk16 with N a multiple of 8 up to 256, but got "
+      << shape;
+  CHECK(dtype_a == dtype_b &&
+        (dtype_a == ptx::DataType::kFloat16 || dtype_a == ptx::DataType::kBFloat16))
+      << "ValueError: wgmma supports float16 or bfloat16 multiplicands, but got " << A_dtype
+      << " and " << B_dtype;
+  CHECK(dtype_c == ptx::DataType::kFloat32 ||
+        (dtype_c == ptx::DataType::kFloat16 && dtype_a == ptx::DataType::kFloat16))
+      << "ValueError: wgmma accumulates float16 multiplicands in float16 or float32 and "
+      << "bfloat16 multiplicands in float32, but got " << C_dtype;
+  int swizzle_mode = 0;
+  if (swizzle_bytes == 128) {
+    swizzle_mode = 1;
+  } else if (swizzle_bytes == 64) {
+    swizzle_mode = 2;
+  } else if (swizzle_bytes == 32) {
+    swizzle_mode = 3;
+  } else {
+    CHECK_EQ(swizzle_bytes, 0) << "ValueError: The swizzle of wgmma should be 0, 32, 64 or 128 "
+                               << "bytes, but got " << swizzle_bytes;
+  }
+  // Each thread of the warpgroup holds 64 * N / 128 accumulators, two float16 ones per register.
+  bool c_is_f32 = dtype_c == ptx::DataType::kFloat32;
+  int num_regs = c_is_f32 ? n / 2 : n / 4;
+  std::string reg_operands, reg_outputs;
+  for (int i = 0; i < num_regs; ++i) {
+    std::string index = "[" + std::to_string(i) + "]";
+    reg_operands += (i ? ", %" : "%") + std::to_string(i);
+    reg_outputs += i ? ", " : "";
+    if (c_is_f32) {
+      reg_outputs += "\"+f\"((" + c_ptr + " + " + c_offset + ")" + index + ")";
+    } else {
+      reg_outputs += "\"+r\"(((unsigned *)(" + c_ptr + " + " + c_offset + "))" + index + ")";
+    }
+  }
+  std::string asm_code = R"(
+  {
+    unsigned long long desc_a = tvm_make_wgmma_desc({a_ptr}, {lbo}, {sbo}, {swizzle});
+    unsigned long long desc_b = tvm_make_wgmma_desc({b_ptr}, {lbo}, {sbo}, {swizzle});
+    __asm__ __volatile__(
+      "{ .reg .pred p; setp.ne.b32 p, %{scale_d}, 0; "
+      "wgmma.mma_async.sync.aligned.{shape}{dtype_c}{dtype_a}{dtype_b} "
+      "{{reg_operands}}, %{desc_a}, %{desc_b}, p, 1, 1, {trans_a}, {trans_b}; }"
+      : {reg_outputs}
+      : "r"(1), "l"(desc_a), "l"(desc_b)
+    );
+  }
+)";
+
+  Replacer replacer;
+  replacer.register_rule("{a_ptr}", a_ptr + " + " + a_offset);
+  replacer.register_rule("{b_ptr}", b_ptr + " + " + b_offset);
+  replacer.register_rule("{lbo}", leading_byte_offset);
+  replacer.register_rule("{sbo}", stride_byte_offset);
+  replacer.register_rule("{swizzle}", std::to_string(swizzle_mode));
+  replacer.register_rule("{scale_d}", std::to_string(num_regs));
+  replacer.register_rule("{desc_a}", std::to_string(num_regs + 1));
+  replacer.register_rule("{desc_b}", std::to_string(num_regs + 2));
+  replacer.register_rule("{shape}", shape);
+  replacer.register_rule("{dtype_a}", ptx::DTypeToString(dtype_a));
+  replacer.register_rule("{dtype_b}", ptx::DTypeToString(dtype_b));
+  replacer.register_rule("{dtype_c}", ptx::DTypeToString(dtype_c));
+  replacer.register_rule("{reg_operands}", reg_operands);
+  replacer.register_rule("{reg_outputs}", reg_outputs);
+  replacer.register_rule("{trans_a}", trans_a ? "1" : "0");
+  replacer.register_rule("{trans_b}", trans_b ? "1" : "0");
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
 }  // namespace codegen
 }  // namespace tvm
@@ -28,6 +28,7 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace tvm {
 namespace codegen {
@@ -158,6 +159,48 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
  */
 std::string PrintWaitBarrierAsm(const std::string& barrier);
 
+/*!
+ * \brief Print ptx async copy of a tensor tile from global to shared memory using
+ * cp.async.bulk.tensor
+ * \param shared_ptr: The pointer to the destination shared memory.
+ * \param shared_elem_offset: The offset into the shared memory.
+ * \param tensor_map: The address of the CUtensorMap of the tensor.
+ * \param coords: The coordinates of the tile, from the innermost dimension outwards.
+ * \param barrier: The name of the barrier in shared memory.
+ */
+std::string PrintCpAsyncBulkTensorAsm(const std::string& shared_ptr,
+                                      const std::string& shared_elem_offset,
+                                      const std::string& tensor_map,
+                                      const std::vector<std::string>& coords,
+                                      const std::string& barrier);
+
+/*!
+ * \brief Print wgmma.mma_async assembly string given parameters.
+ * \param shape The shape string m64nNk16.
+ * \param A_dtype The data type of multiplicand A.
+ * \param B_dtype The data type of multiplicand B.
+ * \param C_dtype The data type of the accumulator.
+ * \param a_ptr Pointer to the shared memory of A.
+ * \param a_offset The offset of element in A.
+ * \param b_ptr Pointer to the shared memory of B.
+ * \param b_offset The offset of element in B.
+ * \param c_ptr Pointer to the accumulator.
+ * \param c_offset The offset of element in the accumulator.
+ * \param trans_a Whether A is M-major instead of K-major.
+ * \param trans_b Whether B is N-major instead of K-major.
+ * \param swizzle_bytes The swizzle of the shared memory layout, 0, 32, 64 or 128.
+ * \param leading_byte_offset The leading dimension byte offset of the matrix descriptors.
+ * \param stride_byte_offset The stride dimension byte offset of the matrix descriptors.
+ */
+std::string PrintWGMMAAssembly(const std::string& shape, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& a_ptr, const std::string& a_offset,
+                               const std::string& b_ptr, const std::string& b_offset,
+                               const std::string& c_ptr, const std::string& c_offset,
+                               bool trans_a, bool trans_b, int swizzle_bytes,
+                               const std::string& leading_byte_offset,
+                               const std::string& stride_byte_offset);
+
 }  // namespace codegen
 }  // namespace tvm
 
@@ -268,7 +268,8 @@ TVM_REGISTER_TARGET_KIND("llvm", kDLCPU)
     .add_attr_option<Integer>("opt-level")
     // LLVM command line flags, see below
     .add_attr_option<Array<String>>("cl-opt")
-    // LLVM JIT engine mcjit/orcjit
+    // LLVM JIT engine mcjit/orcjit/orcjit-lazy, where orcjit-lazy compiles each function at its
+    // first call
     .add_attr_option<String>("jit")
     .set_default_keys({"cpu"})
     // Force the external codegen kind attribute to be registered, even if no external
@@ -382,6 +383,7 @@ TVM_REGISTER_TARGET_KIND("vulkan", kDLVulkan)
     .add_attr_option<Bool>("supports_dedicated_allocation")
     .add_attr_option<Bool>("supports_integer_dot_product")
     .add_attr_option<Bool>("supports_cooperative_matrix")
+    .add_attr_option<Bool>("supports_timeline_semaphore")
     .add_attr_option<Integer>("supported_subgroup_operations")
     // Physical device limits
     .add_attr_option<Integer>("max_num_threads", Integer(256))
@@ -21,6 +21,7 @@
  * \file tir/ir/transform.cc
  * \brief TIR specific transformation passes.
  */
+#include <tvm/ir/instrument.h>
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/transform.h>
@@ -92,18 +93,38 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
 
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
-  // directly loop over the underlying dict
+  // directly loop over the underlying dict, and only pick up tir::PrimFunc
+  std::vector<MapNode::KVType*> entries;
   for (auto& kv : *func_dict) {
-    // only picks up tir::PrimFunc
     if (kv.second->IsInstance<PrimFuncNode>()) {
+      entries.push_back(&kv);
+    }
+  }
+  int num_threads = tvm::transform::GetFunctionPassNumThreads(pass_ctx, pass_info, entries.size());
+  if (num_threads > 1) {
+    // The functions are not moved out, as the other passes see the module while they run.
+    std::vector<PrimFunc> results(entries.size());
+    tvm::transform::ParallelForFunctions(pass_ctx, num_threads, entries.size(), [&](int i) {
+      instrument::FunctionPassProfileScope scope(pass_info,
+                                                 Downcast<GlobalVar>(entries[i]->first)->name_hint);
+      results[i] = pass_func(Downcast<PrimFunc>(entries[i]->second), mod, pass_ctx);
+    });
+    for (size_t i = 0; i < entries.size(); ++i) {
+      entries[i]->second = std::move(results[i]);
+    }
+  } else {
+    for (MapNode::KVType* kv : entries) {
+      instrument::FunctionPassProfileScope scope(pass_info,
+                                                 Downcast<GlobalVar>(kv->first)->name_hint);
       // move out the function so that it is the only copy.
-      PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
+      PrimFunc func = Downcast<PrimFunc>(std::move(kv->second));
       func = pass_func(std::move(func), mod, pass_ctx);
-      kv.second = std::move(func);
-
-      if (!kv.second.defined()) {
-        deleted_list.push_back(Downcast<GlobalVar>(kv.first));
-      }
+      kv->second = std::move(func);
+    }
+  }
+  for (MapNode::KVType* kv : entries) {
+    if (!kv->second.defined()) {
+      deleted_list.push_back(Downcast<GlobalVar>(kv->first));
     }
   }
 
@@ -537,6 +537,14 @@ std::vector<runtime::TypedPackedFunc<Optional<CommReducer>(Array<PrimExpr>)>> Ge
 bool FromIdentityCombiner(const Array<PrimExpr>& identities, const Array<BufferStore>& combiners,
                           CommReducer* result_reducer, Array<PrimExpr>* lhs, Array<PrimExpr>* rhs);
 
+/*!
+ * \brief Check whether a block is a reduction into a single buffer with a commutative reducer,
+ * whose reduction block iters VectorizeLoop can vectorize into vector accumulators.
+ * \param block The block to be checked
+ * \return A boolean indicating whether the reduction of the block can be vectorized
+ */
+bool IsVectorizableReductionBlock(const Block& block);
+
 /******** Misc ********/
 
 /*!
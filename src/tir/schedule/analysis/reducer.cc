@@ -634,6 +634,17 @@ std::tuple<CommReducer, Array<PrimExpr>, Array<PrimExpr>> GetReducerAndCombinerL
   return std::make_tuple(std::move(reducer), std::move(combiner_lhs), std::move(combiner_rhs));
 }
 
+bool IsVectorizableReductionBlock(const Block& block) {
+  const auto* init = block->init.as<BufferStoreNode>();
+  const auto* update = block->body.as<BufferStoreNode>();
+  if (init == nullptr || update == nullptr || !init->buffer.same_as(update->buffer)) {
+    return false;
+  }
+  CommReducer reducer{nullptr};
+  Array<PrimExpr> lhs, rhs;
+  return FromIdentityCombiner({init->value}, {GetRef<BufferStore>(update)}, &reducer, &lhs, &rhs);
+}
+
 /******** Commutative Reducer ********/
 
 bool MatchReducer(const CommReducer& reducer, const Array<PrimExpr>& identities,
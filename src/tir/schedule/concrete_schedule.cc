@@ -52,18 +52,27 @@ class ScheduleCopier {
   using SMap = std::unordered_map<K, V, ObjectPtrHash, ObjectPtrEqual>;
 
  public:
-  static void Copy(const ConcreteScheduleNode* self, ScheduleState* new_state,
-                   TSymbolTable* new_symbol_table) {
-    const ScheduleState& src_state = self->state_;
+  /*!
+   * \brief Copy a schedule state
+   * \param src_state The schedule state to be copied
+   * \param symbol_tables The symbol tables referring to the srefs of `src_state`, which are
+   * rewritten in place to refer to the srefs of the copy
+   * \return The copied schedule state
+   */
+  static ScheduleState Copy(const ScheduleState& src_state,
+                            const std::vector<TSymbolTable*>& symbol_tables) {
     ScheduleCopier copier(src_state);
     ObjectPtr<ScheduleStateNode> n = make_object<ScheduleStateNode>();
     n->mod = src_state->mod;
     n->block_info = copier.Copy(src_state->block_info);
     n->stmt2ref = copier.Copy(src_state->stmt2ref);
+    n->affine_binding_cache = src_state->affine_binding_cache;
     n->debug_mask = src_state->debug_mask;
     n->enable_check = src_state->enable_check;
-    *new_state = ScheduleState(std::move(n));
-    *new_symbol_table = copier.Copy(self->symbol_table_);
+    for (TSymbolTable* symbol_table : symbol_tables) {
+      *symbol_table = copier.Copy(*symbol_table);
+    }
+    return ScheduleState(std::move(n));
   }
 
  private:
@@ -188,23 +197,85 @@ void ConcreteScheduleNode::WorkOn(const String& func_name) {
   this->func_working_on_ = this->state_->mod->GetGlobalVar(func_name);
 }
 
-void ConcreteScheduleNode::Copy(ScheduleState* new_state, TSymbolTable* new_symbol_table) const {
-  ScheduleCopier::Copy(this, new_state, new_symbol_table);
-  new_state->get()->DebugVerify();
+ConcreteScheduleNode::~ConcreteScheduleNode() {
+  if (fork_group_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(fork_group_->mutex);
+  std::vector<ConcreteScheduleNode*>& forks = fork_group_->forks;
+  if (fork_group_->owner == this) {
+    // A fork has not handed out any sref, and takes over the state
+    if (!forks.empty()) {
+      fork_group_->owner = forks.back();
+      forks.pop_back();
+    }
+  } else {
+    forks.erase(std::find(forks.begin(), forks.end(), this));
+  }
+}
+
+void ConcreteScheduleNode::ShareStateWith(ConcreteScheduleNode* fork) {
+  if (fork_group_ == nullptr) {
+    fork_group_ = std::make_shared<ScheduleForkGroup>();
+    fork_group_->owner = this;
+  }
+  std::lock_guard<std::mutex> lock(fork_group_->mutex);
+  fork->state_ = this->state_;
+  fork->symbol_table_ = this->symbol_table_;
+  fork->fork_group_ = fork_group_;
+  fork_group_->forks.push_back(fork);
+}
+
+void ConcreteScheduleNode::DetachFromForkGroup(bool exclusive) {
+  std::shared_ptr<ScheduleForkGroup> group = fork_group_;
+  std::lock_guard<std::mutex> lock(group->mutex);
+  std::vector<ConcreteScheduleNode*>& forks = group->forks;
+  if (group->owner != this) {
+    // A fork copies the state for itself
+    forks.erase(std::find(forks.begin(), forks.end(), this));
+    state_ = ScheduleCopier::Copy(state_, {&symbol_table_});
+    state_->DebugVerify();
+    fork_group_ = nullptr;
+  } else if (exclusive) {
+    // The owner keeps the state, and the forks move to a copy of it, which they share
+    if (!forks.empty()) {
+      std::vector<TSymbolTable*> symbol_tables;
+      symbol_tables.reserve(forks.size());
+      for (ConcreteScheduleNode* fork : forks) {
+        symbol_tables.push_back(&fork->symbol_table_);
+      }
+      ScheduleState new_state = ScheduleCopier::Copy(state_, symbol_tables);
+      new_state->DebugVerify();
+      std::shared_ptr<ScheduleForkGroup> new_group = nullptr;
+      if (forks.size() > 1) {
+        new_group = std::make_shared<ScheduleForkGroup>();
+        new_group->owner = forks.front();
+        new_group->forks.assign(forks.begin() + 1, forks.end());
+      }
+      for (ConcreteScheduleNode* fork : forks) {
+        fork->state_ = new_state;
+        fork->fork_group_ = new_group;
+      }
+      forks.clear();
+    }
+    fork_group_ = nullptr;
+  }
 }
 
 Schedule ConcreteScheduleNode::Copy() {
   ObjectPtr<ConcreteScheduleNode> n = make_object<ConcreteScheduleNode>();
   n->func_working_on_ = this->func_working_on_;
   n->error_render_level_ = this->error_render_level_;
-  ConcreteScheduleNode::Copy(&n->state_, &n->symbol_table_);
+  this->ShareStateWith(n.get());
   n->analyzer_ = std::make_unique<arith::Analyzer>();  // new analyzer needed because it is stateful
   n->rand_state_ = ForkSeed();
   return Schedule(std::move(n));
 }
 
 /*! \brief Macro that guards the beginning of each invocation of TensorIR schedule primitive */
-#define TVM_TIR_SCHEDULE_BEGIN() try {
+#define TVM_TIR_SCHEDULE_BEGIN() \
+  this->EnsureOwnState();        \
+  try {
 /*!
  * \brief Macro that pairs with `TVM_TIR_SCHEDULE_BEGIN`, handling potential errors and error
  * message rendering
@@ -318,6 +389,7 @@ BlockRV ConcreteScheduleNode::GetBlock(const String& name, const Optional<String
                   "specify the function name explicitly, or call `work_on` to specify the function "
                   "before using `get_block`.";
   }
+  this->EnsureOwnState();
   Array<StmtSRef> blocks = tir::GetBlocks(this->state_, name, gv);
   if (blocks.size() != 1) {
     TVM_TIR_SCHEDULE_BEGIN();
@@ -376,6 +448,7 @@ LoopRV ConcreteScheduleNode::Merge(const Array<LoopRV>& loop_rvs) {
   CHECK(loop_rvs.size() > 1) << "ValueError: 'merge' requires at least 2 loop(s)";
   Array<StmtSRef> loop_srefs = this->GetSRefs(loop_rvs);
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::Merge(state_, loop_srefs);
   TVM_TIR_SCHEDULE_END("merge", this->error_render_level_);
@@ -387,6 +460,7 @@ LoopRV ConcreteScheduleNode::Fuse(const Array<LoopRV>& loop_rvs, bool preserve_u
   CHECK(!loop_rvs.empty()) << "ValueError: 'fuse' requires at least 1 loop(s)";
   Array<StmtSRef> loop_srefs = this->GetSRefs(loop_rvs);
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::Fuse(state_, loop_srefs, preserve_unit_iters);
   TVM_TIR_SCHEDULE_END("fuse", this->error_render_level_);
@@ -475,6 +549,7 @@ Array<LoopRV> ConcreteScheduleNode::Split(const LoopRV& loop_rv,
   int infer_index = -1;
   PrimExpr tot_length = 1;
   Array<StmtSRef> results;
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   // infer factor if needed and check validity of factors
   for (size_t i = 0; i < factor_rvs.size(); i++) {
@@ -539,6 +614,7 @@ Array<LoopRV> ConcreteScheduleNode::LoopPartition(const LoopRV& loop_rv,
   int infer_index = -1;
   PrimExpr tot_length = 0;
   Array<StmtSRef> results;
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   if (!is_const_number(loop->min) || !is_const_number(loop->extent)) {
     throw SymbolicShapeError(state_->mod, GetRef<For>(loop));
@@ -584,6 +660,7 @@ Array<LoopRV> ConcreteScheduleNode::LoopPartition(const LoopRV& loop_rv,
 }
 
 void ConcreteScheduleNode::Reorder(const Array<LoopRV>& ordered_loop_rvs) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Reorder(state_, GetSRefs(ordered_loop_rvs));
   TVM_TIR_SCHEDULE_END("reorder", this->error_render_level_);
@@ -592,6 +669,7 @@ void ConcreteScheduleNode::Reorder(const Array<LoopRV>& ordered_loop_rvs) {
 
 void ConcreteScheduleNode::ReorderBlockIterVar(const BlockRV& block_rv,
                                                const Array<Integer> new_order) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::ReorderBlockIterVar(state_, GetSRef(block_rv), new_order);
   TVM_TIR_SCHEDULE_END("reorder_block_iter_var", this->error_render_level_);
@@ -600,6 +678,7 @@ void ConcreteScheduleNode::ReorderBlockIterVar(const BlockRV& block_rv,
 
 LoopRV ConcreteScheduleNode::AddUnitLoop(const BlockRV& block_rv) {
   LoopRV result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = CreateRV<LoopRV>(tir::AddUnitLoop(state_, GetSRef(block_rv)));
   TVM_TIR_SCHEDULE_END("add-unit-loop", this->error_render_level_);
@@ -609,6 +688,7 @@ LoopRV ConcreteScheduleNode::AddUnitLoop(const BlockRV& block_rv) {
 
 LoopRV ConcreteScheduleNode::AddUnitLoop(const LoopRV& loop_rv) {
   LoopRV result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = CreateRV<LoopRV>(tir::AddUnitLoop(state_, GetSRef(loop_rv)));
   TVM_TIR_SCHEDULE_END("add-unit-loop", this->error_render_level_);
@@ -619,6 +699,7 @@ LoopRV ConcreteScheduleNode::AddUnitLoop(const LoopRV& loop_rv) {
 /******** Schedule: Manipulate ForKind ********/
 
 void ConcreteScheduleNode::Parallel(const LoopRV& loop_rv) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Parallel(state_, this->GetSRef(loop_rv));
   this->state_->DebugVerify();
@@ -626,6 +707,7 @@ void ConcreteScheduleNode::Parallel(const LoopRV& loop_rv) {
 }
 
 void ConcreteScheduleNode::Vectorize(const LoopRV& loop_rv) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Vectorize(state_, this->GetSRef(loop_rv));
   this->state_->DebugVerify();
@@ -637,6 +719,7 @@ void ConcreteScheduleNode::Bind(const LoopRV& loop_rv, const String& thread_axis
     LOG(WARNING) << "`vthread` is legacy behavior and is going to be deprecated. Please use "
                     "`vthread.x`, `vthread.y` and `vthread.z` instead";
   }
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Bind(state_, this->GetSRef(loop_rv), thread_axis);
   this->state_->DebugVerify();
@@ -644,6 +727,7 @@ void ConcreteScheduleNode::Bind(const LoopRV& loop_rv, const String& thread_axis
 }
 
 void ConcreteScheduleNode::Unroll(const LoopRV& loop_rv) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Unroll(state_, this->GetSRef(loop_rv));
   this->state_->DebugVerify();
@@ -661,6 +745,7 @@ BlockRV ConcreteScheduleNode::CacheRead(const BlockRV& block_rv, int read_buffer
   for (BlockRV block : consumer_blocks) {
     consumer_block_refs.push_back(this->GetSRef(block));
   }
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::CacheRead(state_, this->GetSRef(block_rv), read_buffer_index, storage_scope,
                           consumer_block_refs);
@@ -678,6 +763,7 @@ BlockRV ConcreteScheduleNode::CacheWrite(const BlockRV& block_rv, int write_buff
   for (BlockRV block : consumer_blocks) {
     consumer_block_refs.push_back(this->GetSRef(block));
   }
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::CacheWrite(state_, this->GetSRef(block_rv), write_buffer_index, storage_scope,
                            consumer_block_refs);
@@ -690,6 +776,7 @@ BlockRV ConcreteScheduleNode::ReindexCacheRead(const BlockRV& block_rv, int read
                                                const String& storage_scope,
                                                const IndexMap& index_map) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::ReindexCacheRead(state_, this->GetSRef(block_rv), read_buffer_index, storage_scope,
                                  index_map);
@@ -702,6 +789,7 @@ BlockRV ConcreteScheduleNode::ReindexCacheWrite(const BlockRV& block_rv, int wri
                                                 const String& storage_scope,
                                                 const IndexMap& index_map) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::ReindexCacheWrite(state_, this->GetSRef(block_rv), write_buffer_index,
                                   storage_scope, index_map);
@@ -713,6 +801,7 @@ BlockRV ConcreteScheduleNode::ReindexCacheWrite(const BlockRV& block_rv, int wri
 Array<BlockRV> ConcreteScheduleNode::CacheInplace(const BlockRV& block_rv, int write_buffer_index,
                                                   const String& storage_scope) {
   Array<StmtSRef> results;
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   results = tir::CacheInplace(state_, this->GetSRef(block_rv), write_buffer_index, storage_scope);
   TVM_TIR_SCHEDULE_END("cache-buffer", this->error_render_level_);
@@ -726,6 +815,7 @@ Array<BlockRV> ConcreteScheduleNode::CacheInplace(const BlockRV& block_rv, int w
 Array<BlockRV> ConcreteScheduleNode::CacheIndex(const BlockRV& block_rv,
                                                 const String& storage_scope, int cse_thresh) {
   Array<StmtSRef> result;
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::CacheIndex(state_, this->GetSRef(block_rv), storage_scope, cse_thresh);
   TVM_TIR_SCHEDULE_END("cache-index", this->error_render_level_);
@@ -740,6 +830,7 @@ Array<BlockRV> ConcreteScheduleNode::CacheIndex(const BlockRV& block_rv,
 BlockRV ConcreteScheduleNode::ReIndex(const BlockRV& block_rv, int buffer_index,
                                       BufferIndexType buffer_index_type) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::ReIndex(state_, this->GetSRef(block_rv), buffer_index, buffer_index_type);
   TVM_TIR_SCHEDULE_END("reindex", this->error_render_level_);
@@ -752,6 +843,7 @@ BlockRV ConcreteScheduleNode::ReIndex(const BlockRV& block_rv, int buffer_index,
 BlockRV ConcreteScheduleNode::ReadAt(const LoopRV& loop_rv, const BlockRV& block_rv,
                                      int read_buffer_index, const String& storage_scope) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::ReadAt(state_, this->GetSRef(loop_rv), this->GetSRef(block_rv), read_buffer_index,
                        storage_scope);
@@ -763,6 +855,7 @@ BlockRV ConcreteScheduleNode::ReadAt(const LoopRV& loop_rv, const BlockRV& block
 BlockRV ConcreteScheduleNode::WriteAt(const LoopRV& loop_rv, const BlockRV& block_rv,
                                       int write_buffer_index, const String& storage_scope) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::WriteAt(state_, this->GetSRef(loop_rv), this->GetSRef(block_rv), write_buffer_index,
                         storage_scope);
@@ -781,6 +874,7 @@ void ConcreteScheduleNode::ComputeAt(const BlockRV& block_rv, const LoopRV& loop
   if (loop_sref.same_as(root_mark)) {
     // do nothing
   } else if (loop_sref.same_as(inline_mark)) {
+  this->EnsureExclusiveState();
     TVM_TIR_SCHEDULE_BEGIN();
     tir::ComputeInline(state_, this->GetSRef(block_rv));
     TVM_TIR_SCHEDULE_END("compute-at", this->error_render_level_);
@@ -800,6 +894,7 @@ void ConcreteScheduleNode::ReverseComputeAt(const BlockRV& block_rv, const LoopR
   if (loop_sref.same_as(root_mark)) {
     // do nothing
   } else if (loop_sref.same_as(inline_mark)) {
+  this->EnsureExclusiveState();
     TVM_TIR_SCHEDULE_BEGIN();
     tir::ReverseComputeInline(state_, this->GetSRef(block_rv));
     TVM_TIR_SCHEDULE_END("reverse-compute-at", this->error_render_level_);
@@ -812,6 +907,7 @@ void ConcreteScheduleNode::ReverseComputeAt(const BlockRV& block_rv, const LoopR
 }
 
 void ConcreteScheduleNode::ComputeInline(const BlockRV& block_rv) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::ComputeInline(state_, this->GetSRef(block_rv));
   TVM_TIR_SCHEDULE_END("compute-inline", this->error_render_level_);
@@ -819,6 +915,7 @@ void ConcreteScheduleNode::ComputeInline(const BlockRV& block_rv) {
 }
 
 void ConcreteScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::ReverseComputeInline(state_, this->GetSRef(block_rv));
   TVM_TIR_SCHEDULE_END("reverse-compute-inline", this->error_render_level_);
@@ -829,6 +926,7 @@ void ConcreteScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
 
 void ConcreteScheduleNode::StorageAlign(const BlockRV& block_rv, int buffer_index, int axis,
                                         int factor, int offset) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::StorageAlign(state_, this->GetSRef(block_rv), buffer_index, axis, factor, offset);
   TVM_TIR_SCHEDULE_END("storage-align", this->error_render_level_);
@@ -837,6 +935,7 @@ void ConcreteScheduleNode::StorageAlign(const BlockRV& block_rv, int buffer_inde
 
 void ConcreteScheduleNode::SetScope(const BlockRV& block_rv, int buffer_index,
                                     const String& storage_scope) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::SetScope(state_, this->GetSRef(block_rv), buffer_index, storage_scope);
   TVM_TIR_SCHEDULE_END("set-scope", this->error_render_level_);
@@ -845,6 +944,7 @@ void ConcreteScheduleNode::SetScope(const BlockRV& block_rv, int buffer_index,
 
 void ConcreteScheduleNode::UnsafeSetDType(const BlockRV& block_rv, int buffer_index,
                                           const String& dtype) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::UnsafeSetDType(state_, this->GetSRef(block_rv), buffer_index, dtype);
   TVM_TIR_SCHEDULE_END("set-dtype", this->error_render_level_);
@@ -855,6 +955,7 @@ void ConcreteScheduleNode::UnsafeSetDType(const BlockRV& block_rv, int buffer_in
 
 BlockRV ConcreteScheduleNode::DecomposeReduction(const BlockRV& block_rv, const LoopRV& loop_rv) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::DecomposeReduction(state_, this->GetSRef(block_rv), this->GetSRef(loop_rv));
   TVM_TIR_SCHEDULE_END("decompose-reduction", this->error_render_level_);
@@ -864,6 +965,7 @@ BlockRV ConcreteScheduleNode::DecomposeReduction(const BlockRV& block_rv, const
 
 BlockRV ConcreteScheduleNode::RFactor(const LoopRV& loop_rv, int factor_axis) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::RFactor(state_, this->GetSRef(loop_rv), factor_axis);
   TVM_TIR_SCHEDULE_END("rfactor", this->error_render_level_);
@@ -874,6 +976,7 @@ BlockRV ConcreteScheduleNode::RFactor(const LoopRV& loop_rv, int factor_axis) {
 /******** Schedule: Blockize & Tensorize ********/
 BlockRV ConcreteScheduleNode::Blockize(const LoopRV& loop_rv, bool preserve_unit_iters) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::Blockize(state_, this->GetSRef(loop_rv), preserve_unit_iters);
   this->state_->DebugVerify();
@@ -883,6 +986,7 @@ BlockRV ConcreteScheduleNode::Blockize(const LoopRV& loop_rv, bool preserve_unit
 
 BlockRV ConcreteScheduleNode::Blockize(const Array<BlockRV>& blocks, bool preserve_unit_iters) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::Blockize(state_, this->GetSRefs(blocks), preserve_unit_iters);
   this->state_->DebugVerify();
@@ -892,6 +996,7 @@ BlockRV ConcreteScheduleNode::Blockize(const Array<BlockRV>& blocks, bool preser
 
 void ConcreteScheduleNode::Tensorize(const LoopRV& loop_rv, const String& intrin,
                                      bool preserve_unit_iters) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Tensorize(state_, this->GetSRef(loop_rv), tir::TensorIntrin::Get(intrin).value(),
                  preserve_unit_iters);
@@ -901,6 +1006,7 @@ void ConcreteScheduleNode::Tensorize(const LoopRV& loop_rv, const String& intrin
 
 void ConcreteScheduleNode::Tensorize(const BlockRV& block_rv, const String& intrin,
                                      bool preserve_unit_iters) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Tensorize(state_, this->GetSRef(block_rv), tir::TensorIntrin::Get(intrin).value(),
                  preserve_unit_iters);
@@ -950,6 +1056,7 @@ ObjectRef ConcreteScheduleNode::CheckAndGetAnnotationValue(const ObjectRef& ann_
 
 void ConcreteScheduleNode::Annotate(const LoopRV& loop_rv, const String& ann_key,
                                     const ObjectRef& ann_val) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Annotate(state_, this->GetSRef(loop_rv), ann_key, this->CheckAndGetAnnotationValue(ann_val));
   this->state_->DebugVerify();
@@ -957,6 +1064,7 @@ void ConcreteScheduleNode::Annotate(const LoopRV& loop_rv, const String& ann_key
 }
 
 void ConcreteScheduleNode::Unannotate(const LoopRV& loop_rv, const String& ann_key) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Unannotate(state_, this->GetSRef(loop_rv), ann_key);
   this->state_->DebugVerify();
@@ -965,6 +1073,7 @@ void ConcreteScheduleNode::Unannotate(const LoopRV& loop_rv, const String& ann_k
 
 void ConcreteScheduleNode::Annotate(const BlockRV& block_rv, const String& ann_key,
                                     const ObjectRef& ann_val) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Annotate(state_, this->GetSRef(block_rv), ann_key,
                 this->CheckAndGetAnnotationValue(ann_val));
@@ -973,6 +1082,7 @@ void ConcreteScheduleNode::Annotate(const BlockRV& block_rv, const String& ann_k
 }
 
 void ConcreteScheduleNode::Unannotate(const BlockRV& block_rv, const String& ann_key) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Unannotate(state_, this->GetSRef(block_rv), ann_key);
   this->state_->DebugVerify();
@@ -985,6 +1095,7 @@ void ConcreteScheduleNode::TransformLayout(const BlockRV& block_rv, int buffer_i
                                            const IndexMap& index_map,
                                            const Optional<IndexMap>& pad_value,
                                            bool assume_injective_transform) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   auto f_subst = [&](const Var& var) -> Optional<PrimExpr> {
     return Downcast<Optional<PrimExpr>>(symbol_table_.Get(var));
@@ -998,6 +1109,7 @@ void ConcreteScheduleNode::TransformLayout(const BlockRV& block_rv, int buffer_i
 
 void ConcreteScheduleNode::TransformBlockLayout(const BlockRV& block_rv,
                                                 const IndexMap& index_map) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::TransformBlockLayout(state_, this->GetSRef(block_rv), index_map);
   this->state_->DebugVerify();
@@ -1007,6 +1119,7 @@ void ConcreteScheduleNode::TransformBlockLayout(const BlockRV& block_rv,
 void ConcreteScheduleNode::SetAxisSeparator(const BlockRV& block_rv, int buffer_index,
                                             BufferIndexType buffer_index_type,
                                             const Array<IntImm>& axis_separators) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::SetAxisSeparator(state_, this->GetSRef(block_rv), buffer_index, buffer_index_type,
                         axis_separators);
@@ -1018,6 +1131,7 @@ void ConcreteScheduleNode::SetAxisSeparator(const BlockRV& block_rv, int buffer_
 
 BlockRV ConcreteScheduleNode::DecomposePadding(const BlockRV& block_rv, const LoopRV& loop_rv) {
   StmtSRef result{nullptr};
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::DecomposePadding(state_, this->GetSRef(block_rv), this->GetSRef(loop_rv));
   TVM_TIR_SCHEDULE_END("decompose-padding", this->error_render_level_);
@@ -1026,6 +1140,7 @@ BlockRV ConcreteScheduleNode::DecomposePadding(const BlockRV& block_rv, const Lo
 }
 
 void ConcreteScheduleNode::PadEinsum(const BlockRV& block_rv, const Array<Integer>& padding) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::PadEinsum(state_, this->GetSRef(block_rv), padding);
   TVM_TIR_SCHEDULE_END("pad-einsum", this->error_render_level_);
@@ -1035,6 +1150,7 @@ void ConcreteScheduleNode::PadEinsum(const BlockRV& block_rv, const Array<Intege
 /******** Schedule: Buffer Transformation ********/
 
 void ConcreteScheduleNode::RollingBuffer(const BlockRV& block_rv, int write_buffer_index) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::RollingBuffer(state_, this->GetSRef(block_rv), write_buffer_index);
   TVM_TIR_SCHEDULE_END("rolling-buffer", this->error_render_level_);
@@ -1045,6 +1161,7 @@ void ConcreteScheduleNode::RollingBuffer(const BlockRV& block_rv, int write_buff
 
 void ConcreteScheduleNode::UnsafeHideBufferAccess(const BlockRV& block_rv, const String& buf_type,
                                                   const Array<IntImm>& buf_index_array) {
+  this->EnsureExclusiveState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::UnsafeHideBufferAccess(state_, this->GetSRef(block_rv), buf_type, buf_index_array);
   TVM_TIR_SCHEDULE_END("hide-buffer-access", this->error_render_level_);
@@ -20,6 +20,7 @@
 #define TVM_TIR_SCHEDULE_CONCRETE_SCHEDULE_H_
 
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -28,6 +29,26 @@
 namespace tvm {
 namespace tir {
 
+class ConcreteScheduleNode;
+
+/*!
+ * \brief The schedules that share a schedule state after `Copy`, until they are modified.
+ *
+ * The owner is the schedule whose srefs may have been handed out, and it keeps the state when it
+ * is modified, after the forks move to a copy of it. A fork copies the state for itself before it
+ * hands out an sref or is modified, and takes over the state if the owner is destroyed first.
+ * \note A schedule and the forks sharing its state should not be used from different threads
+ * until they are modified.
+ */
+struct ScheduleForkGroup {
+  /*! \brief The mutex guarding the group */
+  std::mutex mutex;
+  /*! \brief The schedule that owns the shared state */
+  ConcreteScheduleNode* owner = nullptr;
+  /*! \brief The schedules that share the state of the owner */
+  std::vector<ConcreteScheduleNode*> forks;
+};
+
 class ConcreteScheduleNode : public ScheduleNode {
   friend class Schedule;
   friend class ScheduleCopier;
@@ -48,6 +69,8 @@ class ConcreteScheduleNode : public ScheduleNode {
   std::unique_ptr<arith::Analyzer> analyzer_;
   /*! \brief The value of random state for sampling. */
   support::LinearCongruentialEngine::TRandState rand_state_;
+  /*! \brief The schedules sharing `state_`, nullptr if it is not shared */
+  std::shared_ptr<ScheduleForkGroup> fork_group_;
 
  public:
   void VisitAttrs(tvm::AttrVisitor* v) {
@@ -57,12 +80,18 @@ class ConcreteScheduleNode : public ScheduleNode {
     // `symbol_table_` is not visited
     // `analyzer_` is not visited
     // `rand_state_` is not visited
+    // `fork_group_` is not visited
   }
 
-  virtual ~ConcreteScheduleNode() = default;
+  virtual ~ConcreteScheduleNode();
 
  public:
-  ScheduleState state() const final { return state_; }
+  IRModule mod() const final { return state_->mod; }
+  ScheduleState state() const final {
+    // The caller may modify the state directly
+    const_cast<ConcreteScheduleNode*>(this)->EnsureExclusiveState();
+    return state_;
+  }
   Optional<Trace> trace() const override { return NullOpt; }
   Optional<GlobalVar> func_working_on() const final { return func_working_on_; }
   void WorkOn(const String& func_name) final;
@@ -186,11 +215,20 @@ class ConcreteScheduleNode : public ScheduleNode {
  protected:
   /******** Utility functions ********/
   /*!
-   * \brief Copy the schedule state, as well as the symbol table
-   * \param new_state The ScheduleState copied
-   * \param new_symbol_table The symbol table copied
+   * \brief Share the schedule state, as well as the symbol table, with a new fork, which copies
+   * them lazily
+   * \param fork The schedule forked from this schedule
+   */
+  void ShareStateWith(ConcreteScheduleNode* fork);
+  /*! \brief Copy the shared schedule state if this schedule is a fork, before handing out srefs */
+  inline void EnsureOwnState() const;
+  /*! \brief Stop sharing the schedule state with other schedules, before modifying it */
+  inline void EnsureExclusiveState();
+  /*!
+   * \brief Leave the group of schedules sharing the schedule state
+   * \param exclusive Whether the owner of the state moves the forks to a copy of it
    */
-  void Copy(ScheduleState* new_state, TSymbolTable* new_symbol_table) const;
+  void DetachFromForkGroup(bool exclusive);
   /*!
    * \brief Add srefs as random variables into the symbol table
    * \tparam T The type of the random variables
@@ -232,6 +270,18 @@ class ConcreteScheduleNode : public ScheduleNode {
 
 // implementations
 
+inline void ConcreteScheduleNode::EnsureOwnState() const {
+  if (fork_group_ != nullptr) {
+    const_cast<ConcreteScheduleNode*>(this)->DetachFromForkGroup(/*exclusive=*/false);
+  }
+}
+
+inline void ConcreteScheduleNode::EnsureExclusiveState() {
+  if (fork_group_ != nullptr) {
+    this->DetachFromForkGroup(/*exclusive=*/true);
+  }
+}
+
 /******** Lookup random variables ********/
 
 inline Block ConcreteScheduleNode::Get(const BlockRV& block_rv) const {
@@ -273,6 +323,7 @@ inline bool ConcreteScheduleNode::HasBlock(const BlockRV& block_rv) const {
 }
 
 inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
+  this->EnsureOwnState();
   auto it = this->symbol_table_.find(block_rv);
   if (it == this->symbol_table_.end()) {
     LOG(FATAL) << "IndexError: Cannot find corresponding BlockRV: " << block_rv;
@@ -292,6 +343,7 @@ inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
 inline StmtSRef ConcreteScheduleNode::GetSRef(const LoopRV& loop_rv) const {
   static StmtSRef inline_mark = StmtSRef::InlineMark();
   static StmtSRef root_mark = StmtSRef::RootMark();
+  this->EnsureOwnState();
   auto it = this->symbol_table_.find(loop_rv);
   if (it == this->symbol_table_.end()) {
     LOG(FATAL) << "IndexError: Cannot find corresponding LoopRV: " << loop_rv;
@@ -37,10 +37,15 @@ class WrongBlockIterTypeError : public ScheduleError {
   }
   String DetailRenderTemplate() const final {
     std::ostringstream os;
-    if (op_str_ != "bind") {
+    if (op_str_ == "parallel") {
       os << "The \"" << op_str_
          << "\" cannot be fulfilled with regard to block {0} because some block iter whose block "
             "binding contains the loop var is not a data parallel block iter";
+    } else if (op_str_ == "vectorize") {
+      os << "The \"vectorize\" cannot be fulfilled with regard to block {0} because some block "
+            "iter whose block binding contains the loop var is neither a data parallel block iter, "
+            "nor a reduction block iter of a block that reduces into a single buffer with a "
+            "commutative reducer";
     } else {
       os << "The \"bind\" cannot be fulfilled with regard to block {0}. This is because some of its"
             " block iter whose block binding contains "
@@ -66,7 +71,10 @@ class WrongBlockIterTypeError : public ScheduleError {
  * 2) For each block iter whose binding contains the input loop variable, either
  *   - the block iter is data parallel, or
  *   - the block iter is a reduction block iter, and the input `thread_tag` starts with "threadIdx"
- *   in case of cross-thread reduction.
+ *   in case of cross-thread reduction, or
+ *   - the block iter is a reduction block iter of a block that reduces into a single buffer with a
+ *   commutative reducer, and the loop is vectorized, which VectorizeLoop lowers to vector
+ *   accumulators.
  * \param self The schedule state
  * \param for_kind The desired ForKind (only `kParallel`, `kVectorized` and `kThreadBinding` are
  * allowed)
@@ -96,13 +104,17 @@ void CheckLoopParallelizableInBlock(const ScheduleState& self, ForKind for_kind,
     if (!UsesVar(binding, [v = loop_var.get()](const VarNode* var) { return var == v; })) {
       continue;
     }
-    // Only two cases are allowed:
+    // Only three cases are allowed:
     // - The block iter is data parallel, or
     // - The block iter is a reduction block iter, and the `thread_scope` is "threadIdx.x/y/z"
-    // in case of cross-thread reduction.
+    // in case of cross-thread reduction, or
+    // - The block iter is a reduction block iter of a vectorizable reduction, and the loop is
+    // vectorized.
     IterVarType iter_type = iter_var->iter_type;
     if (!(iter_type == kDataPar ||
-          (iter_type == kCommReduce && thread_scope.rank == 1 && thread_scope.dim_index != -1))) {
+          (iter_type == kCommReduce && thread_scope.rank == 1 && thread_scope.dim_index != -1) ||
+          (iter_type == kCommReduce && for_kind == ForKind::kVectorized &&
+           IsVectorizableReductionBlock(block)))) {
       throw WrongBlockIterTypeError(self->mod, for_kind, loop_var, block);
     }
   }
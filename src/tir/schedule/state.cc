@@ -184,9 +184,8 @@ class BlockInfoCollector : private StmtVisitor {
       if (block->iter_vars.empty()) info.affine_binding = true;
     } else {
       info.affine_binding =
-          IsAffineBinding(/*realize=*/block2realize_.at(scope_root->stmt),
-                          /*loop_var_ranges=*/LoopDomainOfSRefTreePath(srefs_.back()),
-                          /*analyzer=*/&analyzer_);
+          IsAffineBindingMemoized(/*realize=*/block2realize_.at(scope_root->stmt),
+                                  /*loop_var_ranges=*/LoopDomainOfSRefTreePath(srefs_.back()));
     }
     // Set `region_cover` to true, will be updated on its scope block
     info.region_cover = true;
@@ -194,6 +193,48 @@ class BlockInfoCollector : private StmtVisitor {
     info.stage_pipeline = CheckRegionCoverAndStagePipeline(info, scope_root, child_block_srefs);
   }
 
+  /*!
+   * \brief Check if the binding of a block is affine, with the results memoized on the schedule
+   * state. The check depends on the analyzer only through the domains of the loops bound in it, so
+   * it is memoized only when every such loop that the binding refers to is in the key.
+   */
+  bool IsAffineBindingMemoized(const BlockRealize& realize,
+                               const Map<Var, Range>& loop_var_ranges) {
+    if (loop_var_ranges.empty()) {
+      return IsAffineBinding(realize, loop_var_ranges, &analyzer_);
+    }
+    auto f_in_key = [&](const PrimExpr& expr) -> bool {
+      for (const Var& var : UndefinedVars(expr)) {
+        if (bound_loop_vars_.count(var.get()) && !loop_var_ranges.count(var)) {
+          return false;
+        }
+      }
+      return true;
+    };
+    bool memoizable = f_in_key(realize->predicate);
+    for (const PrimExpr& value : realize->iter_values) {
+      memoizable = memoizable && f_in_key(value);
+    }
+    for (const auto& kv : loop_var_ranges) {
+      memoizable = memoizable && f_in_key(kv.second->min) && f_in_key(kv.second->extent);
+    }
+    if (!memoizable) {
+      return IsAffineBinding(realize, loop_var_ranges, &analyzer_);
+    }
+    Array<ObjectRef> key{realize->iter_values, loop_var_ranges, realize->predicate};
+    auto it = self_->affine_binding_cache.find(key);
+    if (it != self_->affine_binding_cache.end()) {
+      return it->second;
+    }
+    bool result = IsAffineBinding(realize, loop_var_ranges, &analyzer_);
+    // The entries hold the IR they are keyed by, so the memo is dropped once it grows too large.
+    if (self_->affine_binding_cache.size() >= kMaxAffineBindingCacheSize) {
+      self_->affine_binding_cache.clear();
+    }
+    self_->affine_binding_cache.emplace(std::move(key), result);
+    return result;
+  }
+
   bool CheckRegionCoverAndStagePipeline(const BlockInfo& info, const StmtSRef& scope_root,
                                         const Array<StmtSRef>& child_block_srefs) {
     const StmtSRefNode* limit = scope_root->parent;
@@ -326,6 +367,7 @@ class BlockInfoCollector : private StmtVisitor {
 
   void VisitStmt_(const ForNode* loop) final {
     analyzer_.Bind(loop->loop_var, Range::FromMinExtent(loop->min, loop->extent));
+    bound_loop_vars_.insert(loop->loop_var.get());
     PushSRef(loop);
     VisitStmt(loop->body);
     PopSRef();
@@ -362,6 +404,10 @@ class BlockInfoCollector : private StmtVisitor {
   std::vector<Array<StmtSRef>> block_frames_;
   /*! \brief The auxiliary analyzer */
   arith::Analyzer analyzer_;
+  /*! \brief The loop variables bound in the analyzer */
+  std::unordered_set<const VarNode*> bound_loop_vars_;
+  /*! \brief The maximum number of entries in the memo of the affine binding checks */
+  static constexpr size_t kMaxAffineBindingCacheSize = 4096;
 };
 
 /**************** Constructor ****************/
@@ -22,6 +22,31 @@
 namespace tvm {
 namespace tir {
 namespace transform {
+/*!
+ * \brief Bind a fused data parallel loop to the threadblocks and threads.
+ * \param sch The schedule to work on.
+ * \param fused The fused loop.
+ * \param product The extent of the fused loop, or the max of int64 if it is not constant.
+ * \param max_thread_per_block The maximum number of threads per block.
+ * \param max_threadblocks The maximum number of threadblocks.
+ */
+void BindFusedLoop(tir::Schedule sch, const tir::LoopRV& fused, int64_t product,
+                   int64_t max_thread_per_block, int64_t max_threadblocks) {
+  if (product > max_thread_per_block * max_threadblocks) {
+    Array<tir::LoopRV> splits =
+        sch->Split(fused,
+                   /*factors=*/{NullOpt, Integer(max_threadblocks), Integer(max_thread_per_block)});
+    sch->Reorder(/*ordered_loop_rvs=*/{splits[1], splits[2], splits[0]});
+    sch->Bind(splits[1], "blockIdx.x");
+    sch->Bind(splits[2], "threadIdx.x");
+  } else {
+    Array<tir::LoopRV> splits =
+        sch->Split(fused, /*factors=*/{NullOpt, Integer(std::min(product, max_thread_per_block))});
+    sch->Bind(splits[0], "blockIdx.x");
+    sch->Bind(splits[1], "threadIdx.x");
+  }
+}
+
 /*!
  * \brief A helper function to do default thread binding for a block.
  * \param sch The schedule to work on.
@@ -65,19 +90,259 @@ void ThreadBind(tir::Schedule sch, const tir::BlockRV& block, int64_t max_thread
     product = sch->Get(fused)->extent.as<tir::IntImmNode>()->value;
   }
   // schedule the fused loop
-  if (product > max_thread_per_block * max_threadblocks) {
-    Array<tir::LoopRV> splits =
-        sch->Split(fused,
-                   /*factors=*/{NullOpt, Integer(max_threadblocks), Integer(max_thread_per_block)});
-    sch->Reorder(/*ordered_loop_rvs=*/{splits[1], splits[2], splits[0]});
-    sch->Bind(splits[1], "blockIdx.x");
-    sch->Bind(splits[2], "threadIdx.x");
-  } else {
-    Array<tir::LoopRV> splits =
-        sch->Split(fused, /*factors=*/{NullOpt, Integer(std::min(product, max_thread_per_block))});
-    sch->Bind(splits[0], "blockIdx.x");
-    sch->Bind(splits[1], "threadIdx.x");
+  BindFusedLoop(sch, fused, product, max_thread_per_block, max_threadblocks);
+}
+
+/*!
+ * \brief Check whether a block is not scheduled yet and each of its iters is bound to one of its
+ * loops in order, which the pattern-specific schedules below rely on.
+ */
+bool IsUnscheduledTrivialBlock(const tir::Schedule& sch, const tir::BlockRV& block,
+                               const Array<tir::LoopRV>& loops) {
+  if (loops.empty() || loops.size() != sch->Get(block)->iter_vars.size()) {
+    return false;
+  }
+  for (const tir::LoopRV& loop : loops) {
+    tir::For loop_node = sch->Get(loop);
+    if (loop_node->kind != tir::ForKind::kSerial || !loop_node->annotations.empty()) {
+      return false;
+    }
+  }
+  return tir::IsTrivialBinding(sch->state(), sch->GetSRef(block));
+}
+
+/*! \return The product of the extents of the loops, or -1 if any of them is not constant. */
+int64_t GetLoopExtentProduct(const tir::Schedule& sch, const Array<tir::LoopRV>& loops) {
+  int64_t product = 1;
+  for (const tir::LoopRV& loop : loops) {
+    const int64_t* extent = tir::GetLoopIntExtent(sch->Get(loop).get());
+    if (extent == nullptr) {
+      return -1;
+    }
+    product *= *extent;
+  }
+  return product;
+}
+
+/*!
+ * \brief Check whether two operands of a reduction are each reused along a spatial iter which
+ * indexes the other one, as in a matrix multiplication. Such reductions need a tiled schedule
+ * rather than one threadblock per output element.
+ */
+bool HasCrossOperandReuse(const tir::Block& block, size_t num_spatial) {
+  auto region_uses = [](const tir::BufferRegion& region, const tir::Var& var) {
+    for (const Range& range : region->region) {
+      if (tir::UsesVar(range->min, [&](const tir::VarNode* v) { return v == var.get(); })) {
+        return true;
+      }
+    }
+    return false;
+  };
+  // the spatial iters indexing each operand read along the reduction
+  std::vector<std::vector<bool>> operands;
+  for (const tir::BufferRegion& read : block->reads) {
+    bool reduced = false;
+    for (size_t i = num_spatial; i < block->iter_vars.size(); ++i) {
+      reduced = reduced || region_uses(read, block->iter_vars[i]->var);
+    }
+    if (!reduced) {
+      continue;
+    }
+    std::vector<bool> spatial_uses;
+    for (size_t i = 0; i < num_spatial; ++i) {
+      spatial_uses.push_back(region_uses(read, block->iter_vars[i]->var));
+    }
+    operands.push_back(std::move(spatial_uses));
+  }
+  auto indexed_by_only_first = [num_spatial](const std::vector<bool>& a,
+                                             const std::vector<bool>& b) {
+    for (size_t i = 0; i < num_spatial; ++i) {
+      if (a[i] && !b[i]) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (size_t a = 0; a < operands.size(); ++a) {
+    for (size_t b = a + 1; b < operands.size(); ++b) {
+      if (indexed_by_only_first(operands[a], operands[b]) &&
+          indexed_by_only_first(operands[b], operands[a])) {
+        return true;
+      }
+    }
   }
+  return false;
+}
+
+/*!
+ * \brief Schedule a reduction over its innermost loops, such as the row reductions of softmax and
+ * normalizations, and GEMV. Each threadblock computes one output element, whose threads read
+ * consecutive elements of the row and combine their partial results by a cross-thread reduction.
+ * \param sch The schedule to work on.
+ * \param block The block to be scheduled.
+ * \param max_thread_per_block The maximum number of threads per block.
+ * \param warp_size The number of threads in a warp.
+ * \return Whether the block is such a reduction and has been scheduled.
+ */
+bool ScheduleInnerReduction(tir::Schedule sch, const tir::BlockRV& block,
+                            int64_t max_thread_per_block, int64_t warp_size) {
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  if (!IsUnscheduledTrivialBlock(sch, block, loops)) {
+    return false;
+  }
+  tir::Block block_node = sch->Get(block);
+  // the cross-thread reduction lowers a single output combined by a known reducer
+  const auto* update = block_node->body.as<tir::BufferStoreNode>();
+  const auto* init = block_node->init.as<tir::BufferStoreNode>();
+  if (update == nullptr || init == nullptr) {
+    return false;
+  }
+  tir::CommReducer reducer;
+  Array<PrimExpr> lhs, rhs;
+  if (!tir::FromIdentityCombiner({init->value}, {GetRef<tir::BufferStore>(update)}, &reducer,
+                                 &lhs, &rhs)) {
+    return false;
+  }
+  // the spatial iters are followed by the reduction iters
+  const Array<tir::IterVar>& iters = block_node->iter_vars;
+  size_t num_spatial = 0;
+  while (num_spatial < iters.size() && iters[num_spatial]->iter_type == tir::kDataPar) {
+    ++num_spatial;
+  }
+  if (num_spatial == iters.size()) {
+    return false;
+  }
+  for (size_t i = num_spatial; i < iters.size(); ++i) {
+    if (iters[i]->iter_type != tir::kCommReduce) {
+      return false;
+    }
+  }
+  if (HasCrossOperandReuse(block_node, num_spatial)) {
+    return false;
+  }
+  Array<tir::LoopRV> spatial_loops(loops.begin(), loops.begin() + num_spatial);
+  Array<tir::LoopRV> reduction_loops(loops.begin() + num_spatial, loops.end());
+  // short reductions are left to a single thread
+  int64_t reduction_extent = GetLoopExtentProduct(sch, reduction_loops);
+  if (reduction_extent != -1 && reduction_extent < warp_size) {
+    return false;
+  }
+  int64_t num_threads = std::min<int64_t>(256, max_thread_per_block);
+  while (reduction_extent != -1 && num_threads > warp_size && num_threads / 2 >= reduction_extent) {
+    num_threads /= 2;
+  }
+
+  if (spatial_loops.empty()) {
+    spatial_loops.push_back(sch->AddUnitLoop(loops[0]));
+  }
+  tir::LoopRV bx = sch->Fuse(spatial_loops, /*preserve_unit_iters=*/false);
+  tir::LoopRV reduction = sch->Fuse(reduction_loops, /*preserve_unit_iters=*/false);
+  Array<tir::LoopRV> splits = sch->Split(reduction, /*factors=*/{NullOpt, Integer(num_threads)});
+  sch->Reorder(/*ordered_loop_rvs=*/{splits[1], splits[0]});
+  sch->Bind(bx, "blockIdx.x");
+  sch->Bind(splits[1], "threadIdx.x");
+  return true;
+}
+
+/*!
+ * \brief Schedule a 2D transpose. Each threadblock stages a tile of the input in shared memory, so
+ * that both the reads of the input and the writes of the output are coalesced.
+ * \param sch The schedule to work on.
+ * \param block The block to be scheduled.
+ * \param max_thread_per_block The maximum number of threads per block.
+ * \return Whether the block is a transpose and has been scheduled.
+ */
+bool ScheduleTranspose(tir::Schedule sch, const tir::BlockRV& block,
+                       int64_t max_thread_per_block) {
+  constexpr int64_t kTileRows = 8;
+  constexpr int64_t kTileCols = 16;
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  if (loops.size() != 2 || kTileRows * kTileCols > max_thread_per_block ||
+      !IsUnscheduledTrivialBlock(sch, block, loops)) {
+    return false;
+  }
+  tir::Block block_node = sch->Get(block);
+  const auto* store = block_node->body.as<tir::BufferStoreNode>();
+  if (store == nullptr || block_node->init.defined() || block_node->reads.size() != 1) {
+    return false;
+  }
+  const auto* load = store->value.as<tir::BufferLoadNode>();
+  const Array<tir::IterVar>& iters = block_node->iter_vars;
+  if (load == nullptr || store->indices.size() != 2 || load->indices.size() != 2 ||
+      iters[0]->iter_type != tir::kDataPar || iters[1]->iter_type != tir::kDataPar ||
+      !store->indices[0].same_as(iters[0]->var) || !store->indices[1].same_as(iters[1]->var) ||
+      !load->indices[0].same_as(iters[1]->var) || !load->indices[1].same_as(iters[0]->var)) {
+    return false;
+  }
+  // tiny transposes are not worth staging
+  for (int i = 0; i < 2; ++i) {
+    const int64_t* extent = tir::GetLoopIntExtent(sch->Get(loops[i]).get());
+    if (extent != nullptr && *extent < (i == 0 ? kTileRows : kTileCols)) {
+      return false;
+    }
+  }
+
+  Array<tir::LoopRV> row_splits = sch->Split(loops[0], /*factors=*/{NullOpt, Integer(kTileRows)});
+  Array<tir::LoopRV> col_splits = sch->Split(loops[1], /*factors=*/{NullOpt, Integer(kTileCols)});
+  sch->Reorder(/*ordered_loop_rvs=*/{row_splits[0], col_splits[0], row_splits[1], col_splits[1]});
+  tir::LoopRV bx = sch->Fuse({row_splits[0], col_splits[0]}, /*preserve_unit_iters=*/false);
+  sch->Bind(bx, "blockIdx.x");
+  sch->Bind(row_splits[1], "threadIdx.y");
+  sch->Bind(col_splits[1], "threadIdx.x");
+  // the threads read the tile of the input along its rows
+  tir::BlockRV cache = sch->CacheRead(block, /*read_buffer_index=*/0, /*storage_scope=*/"shared");
+  sch->ComputeAt(cache, bx, /*preserve_unit_loops=*/true);
+  Array<tir::LoopRV> cache_loops = sch->GetLoops(cache);
+  tir::LoopRV fused = sch->Fuse({cache_loops.begin() + 1, cache_loops.end()},
+                                /*preserve_unit_iters=*/false);
+  Array<tir::LoopRV> cache_splits =
+      sch->Split(fused, /*factors=*/{NullOpt, Integer(kTileRows), Integer(kTileCols)});
+  sch->Bind(cache_splits[1], "threadIdx.y");
+  sch->Bind(cache_splits[2], "threadIdx.x");
+  // pad the rows of the tile to avoid the bank conflicts of the column-wise reads
+  sch->StorageAlign(cache, /*buffer_index=*/0, /*axis=*/0, /*factor=*/32, /*offset=*/1);
+  return true;
+}
+
+/*!
+ * \brief Schedule an elementwise or broadcast operator which writes its output in order. Each
+ * thread writes a vector of 16 bytes, in addition to the binding of ThreadBind.
+ * \param sch The schedule to work on.
+ * \param block The block to be scheduled.
+ * \param max_thread_per_block The maximum number of threads per block.
+ * \param max_threadblocks The maximum number of threadblocks.
+ * \return Whether the block is such an operator and has been scheduled.
+ */
+bool ScheduleVectorizedElementwise(tir::Schedule sch, const tir::BlockRV& block,
+                                   int64_t max_thread_per_block, int64_t max_threadblocks = 256) {
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  if (!IsUnscheduledTrivialBlock(sch, block, loops)) {
+    return false;
+  }
+  tir::Block block_node = sch->Get(block);
+  const auto* store = block_node->body.as<tir::BufferStoreNode>();
+  if (store == nullptr || block_node->init.defined() ||
+      store->indices.size() != block_node->iter_vars.size() || store->buffer->dtype.lanes() != 1) {
+    return false;
+  }
+  for (size_t i = 0; i < store->indices.size(); ++i) {
+    if (block_node->iter_vars[i]->iter_type != tir::kDataPar ||
+        !store->indices[i].same_as(block_node->iter_vars[i]->var)) {
+      return false;
+    }
+  }
+  int64_t vector_lanes = std::min<int64_t>(128 / store->buffer->dtype.bits(), 16);
+  int64_t product = GetLoopExtentProduct(sch, loops);
+  // small operators are bound by the launch rather than the memory bandwidth
+  if (vector_lanes < 2 || product == -1 || product % vector_lanes != 0 ||
+      product < max_thread_per_block * vector_lanes) {
+    return false;
+  }
+  tir::LoopRV fused = sch->Fuse(loops, /*preserve_unit_iters=*/false);
+  Array<tir::LoopRV> splits = sch->Split(fused, /*factors=*/{NullOpt, Integer(vector_lanes)});
+  BindFusedLoop(sch, splits[0], product / vector_lanes, max_thread_per_block, max_threadblocks);
+  sch->Vectorize(splits[1]);
+  return true;
 }
 
 IRModule MarkScheduled(const IRModule& mod) {
@@ -145,6 +410,7 @@ Pass DefaultGPUSchedule() {
             ICHECK(opt_max_thread_per_block.defined())
                 << "max_num_threads is not set for target " << target;
             int64_t max_thread_per_block = opt_max_thread_per_block.value().IntValue();
+            int64_t warp_size = target->GetAttr<Integer>("thread_warp_size", 32).value().IntValue();
 
             sch->WorkOn(gv->name_hint);
             Array<tir::BlockRV> blocks = meta_schedule::BlockCollector::Collect(sch);
@@ -153,6 +419,12 @@ Pass DefaultGPUSchedule() {
               if (!childs.empty()) {
                 continue;
               }
+              // the patterns which have a dedicated schedule, the others are only bound to threads
+              if (ScheduleTranspose(sch, block, max_thread_per_block) ||
+                  ScheduleInnerReduction(sch, block, max_thread_per_block, warp_size) ||
+                  ScheduleVectorizedElementwise(sch, block, max_thread_per_block)) {
+                continue;
+              }
               ThreadBind(sch, block, max_thread_per_block);
             }
           }
@@ -0,0 +1,446 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_shared_memory_padding.cc
+ * \brief Pad the rows of the shared memory buffers to reduce the bank conflicts of the accesses
+ * of the warps.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../runtime/thread_storage_scope.h"
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+using runtime::StorageRank;
+using runtime::StorageScope;
+using runtime::ThreadScope;
+
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.pad_shared_memory", Bool);
+
+/*! \brief The number of the banks of the shared memory. */
+static constexpr int64_t kNumBanks = 32;
+/*! \brief The width of a bank in bytes. */
+static constexpr int64_t kBankBytes = 4;
+/*! \brief The number of the threads of a warp. */
+static constexpr int64_t kWarpSize = 32;
+
+/*! \brief An access to a shared memory buffer by the lanes of the first warp. */
+struct WarpAccess {
+  /*! \brief The indices accessed by each lane. */
+  std::vector<std::vector<int64_t>> lane_indices;
+  /*! \brief The number of bytes accessed by each lane. */
+  int64_t bytes;
+};
+
+/*! \brief The accesses of a shared memory buffer which may be padded. */
+struct SharedBufferInfo {
+  /*! \brief The accesses whose indices are known for each lane. */
+  std::vector<WarpAccess> accesses;
+  /*! \brief The annotation of the blocks writing the buffer: -1 if none, otherwise 0 or 1. */
+  int annotation = -1;
+  /*! \brief Whether the layout of the buffer is used besides its loads and stores. */
+  bool excluded = false;
+};
+
+/*!
+ * \brief Count the shared memory wavefronts of the accesses with the given strides of the buffer.
+ *
+ * The lanes of a warp are split into the phases of 128 bytes, and a phase takes as many wavefronts
+ * as the distinct 4-byte words it accesses in the same bank.
+ */
+int64_t CountWavefronts(const std::vector<WarpAccess>& accesses,
+                        const std::vector<int64_t>& strides, int64_t elem_bytes) {
+  int64_t wavefronts = 0;
+  for (const WarpAccess& access : accesses) {
+    int64_t num_lanes = access.lane_indices.size();
+    int64_t phase_lanes = std::max<int64_t>(
+        kWarpSize * kBankBytes / std::max(kBankBytes, access.bytes), 1);
+    for (int64_t begin = 0; begin < num_lanes; begin += phase_lanes) {
+      std::vector<std::unordered_set<int64_t>> bank_words(kNumBanks);
+      for (int64_t lane = begin; lane < std::min(begin + phase_lanes, num_lanes); ++lane) {
+        int64_t offset = 0;
+        for (size_t i = 0; i < strides.size(); ++i) {
+          offset += access.lane_indices[lane][i] * strides[i];
+        }
+        int64_t first_byte = offset * elem_bytes;
+        int64_t last_byte = first_byte + access.bytes - 1;
+        for (int64_t word = first_byte / kBankBytes; word <= last_byte / kBankBytes; ++word) {
+          bank_words[word % kNumBanks].insert(word);
+        }
+      }
+      size_t conflicts = 1;
+      for (const auto& words : bank_words) {
+        conflicts = std::max(conflicts, words.size());
+      }
+      wavefronts += conflicts;
+    }
+  }
+  return wavefronts;
+}
+
+/*! \brief The strides of a buffer whose second innermost dimension has the given stride. */
+std::vector<int64_t> PaddedStrides(const std::vector<int64_t>& shape, int64_t row_stride) {
+  size_t ndim = shape.size();
+  std::vector<int64_t> strides(ndim, 1);
+  strides[ndim - 2] = row_stride;
+  for (size_t i = ndim - 2; i != 0; --i) {
+    strides[i - 1] = strides[i] * shape[i];
+  }
+  return strides;
+}
+
+/*!
+ * \brief Collect the accesses of the shared memory buffers which may be padded, with the indices
+ * accessed by each lane of the first warp.
+ */
+class SharedAccessCollector : public StmtExprVisitor {
+ public:
+  static std::unordered_map<const BufferNode*, std::pair<Buffer, SharedBufferInfo>> Collect(
+      const PrimFunc& f) {
+    SharedAccessCollector collector;
+    collector(f->body);
+    return std::move(collector.infos_);
+  }
+
+ private:
+  struct LoopInfo {
+    Var var;
+    int64_t extent;
+    bool vectorized;
+    String thread_tag;
+  };
+
+  void VisitStmt_(const BlockNode* op) final {
+    for (const Buffer& buffer : op->alloc_buffers) {
+      if (IsPaddable(buffer)) {
+        infos_.emplace(buffer.get(), std::make_pair(buffer, SharedBufferInfo()));
+        data_vars_.emplace(buffer->data.get(), buffer.get());
+      }
+    }
+    for (const MatchBufferRegion& match_buffer : op->match_buffers) {
+      Exclude(match_buffer->source->buffer.get());
+    }
+    if (auto it = op->annotations.find(attr::pad_shared_memory); it != op->annotations.end()) {
+      int annotation = Downcast<Integer>((*it).second)->value != 0;
+      for (const BufferRegion& region : op->writes) {
+        if (auto info = infos_.find(region->buffer.get()); info != infos_.end()) {
+          info->second.second.annotation = annotation;
+        }
+      }
+    }
+    bool is_permuted = in_permuted_layout_;
+    if (op->annotations.count("permuted_layout")) {
+      // The permuted layout rewrites the indices of the accesses in the block.
+      in_permuted_layout_ = true;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+    in_permuted_layout_ = is_permuted;
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    const auto* extent = op->extent.as<IntImmNode>();
+    String thread_tag = op->kind == ForKind::kThreadBinding ? op->thread_binding.value()->thread_tag
+                                                            : String("");
+    loops_.push_back(LoopInfo{op->loop_var, extent != nullptr ? extent->value : -1,
+                              op->kind == ForKind::kVectorized, thread_tag});
+    StmtExprVisitor::VisitStmt_(op);
+    loops_.pop_back();
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      const auto* extent = op->value.as<IntImmNode>();
+      loops_.push_back(LoopInfo{iv->var, extent != nullptr ? extent->value : -1, false,
+                                iv->thread_tag});
+      StmtExprVisitor::VisitStmt_(op);
+      loops_.pop_back();
+      return;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    RecordAccess(op->buffer, op->indices);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    RecordAccess(op->buffer, op->indices);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const VarNode* op) final {
+    // The data of the buffer is used by address, e.g. in tvm_access_ptr.
+    if (auto it = data_vars_.find(op); it != data_vars_.end()) {
+      Exclude(it->second);
+    }
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::address_of())) {
+      if (const auto* load = op->args[0].as<BufferLoadNode>()) {
+        Exclude(load->buffer.get());
+      }
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  static bool IsPaddable(const Buffer& buffer) {
+    if (buffer->shape.size() < 2 || !buffer->strides.empty() ||
+        !buffer->axis_separators.empty() || buffer->dtype.lanes() != 1 ||
+        buffer->dtype.bits() % 8 != 0) {
+      return false;
+    }
+    for (const PrimExpr& dim : buffer->shape) {
+      if (!dim->IsInstance<IntImmNode>()) {
+        return false;
+      }
+    }
+    return StorageScope::Create(GetPtrStorageScope(buffer->data)).rank == StorageRank::kShared;
+  }
+
+  void Exclude(const BufferNode* buffer) {
+    if (auto it = infos_.find(buffer); it != infos_.end()) {
+      it->second.second.excluded = true;
+    }
+  }
+
+  void RecordAccess(const Buffer& buffer, const Array<PrimExpr>& indices) {
+    auto it = infos_.find(buffer.get());
+    if (it == infos_.end()) {
+      return;
+    }
+    SharedBufferInfo& info = it->second.second;
+    if (in_permuted_layout_) {
+      info.excluded = true;
+      return;
+    }
+    // The lanes of a warp are the consecutive threads in the order of threadIdx.x, y and z. The
+    // other loops are at their first iteration, and the vectorized loops widen the access.
+    WarpAccess access;
+    access.bytes = buffer->dtype.bytes();
+    Map<Var, PrimExpr> vmap;
+    Var thread_vars[3];
+    int64_t thread_extents[3] = {1, 1, 1};
+    for (const LoopInfo& loop : loops_) {
+      if (!loop.thread_tag.empty() && ThreadScope::Create(loop.thread_tag).rank == 1) {
+        if (loop.extent <= 0) {
+          return;
+        }
+        int dim = ThreadScope::Create(loop.thread_tag).dim_index;
+        thread_vars[dim] = loop.var;
+        thread_extents[dim] = loop.extent;
+        continue;
+      }
+      if (loop.vectorized && loop.extent > 0) {
+        access.bytes *= loop.extent;
+      }
+      vmap.Set(loop.var, make_zero(loop.var->dtype));
+    }
+    int64_t num_lanes =
+        std::min(kWarpSize, thread_extents[0] * thread_extents[1] * thread_extents[2]);
+    for (int64_t lane = 0; lane < num_lanes; ++lane) {
+      int64_t thread_index[3] = {lane % thread_extents[0],
+                                 lane / thread_extents[0] % thread_extents[1],
+                                 lane / (thread_extents[0] * thread_extents[1])};
+      for (int dim = 0; dim < 3; ++dim) {
+        if (thread_vars[dim].defined()) {
+          vmap.Set(thread_vars[dim], make_const(thread_vars[dim]->dtype, thread_index[dim]));
+        }
+      }
+      std::vector<int64_t> lane_indices;
+      for (const PrimExpr& index : indices) {
+        PrimExpr value = analyzer_.Simplify(Substitute(index, vmap));
+        const auto* imm = value.as<IntImmNode>();
+        if (imm == nullptr) {
+          // The index depends on a value other than the loops, e.g. a ramp or a load.
+          return;
+        }
+        lane_indices.push_back(imm->value);
+      }
+      access.lane_indices.push_back(std::move(lane_indices));
+    }
+    info.accesses.push_back(std::move(access));
+  }
+
+  arith::Analyzer analyzer_;
+  std::vector<LoopInfo> loops_;
+  bool in_permuted_layout_ = false;
+  std::unordered_map<const BufferNode*, std::pair<Buffer, SharedBufferInfo>> infos_;
+  std::unordered_map<const VarNode*, const BufferNode*> data_vars_;
+};
+
+/*! \brief Replace the padded buffers in their allocations, regions, loads and stores. */
+class SharedBufferPadder : public StmtExprMutator {
+ public:
+  explicit SharedBufferPadder(std::unordered_map<const BufferNode*, Buffer> new_buffers)
+      : new_buffers_(std::move(new_buffers)) {}
+
+ private:
+  Buffer Rewrite(const Buffer& buffer) {
+    auto it = new_buffers_.find(buffer.get());
+    return it != new_buffers_.end() ? it->second : buffer;
+  }
+
+  Array<BufferRegion> Rewrite(const Array<BufferRegion>& regions) {
+    return regions.Map([this](const BufferRegion& region) {
+      Buffer buffer = Rewrite(region->buffer);
+      return buffer.same_as(region->buffer) ? region : BufferRegion(buffer, region->region);
+    });
+  }
+
+  Stmt VisitStmt_(const BlockNode* op) final {
+    Block block = Downcast<Block>(StmtExprMutator::VisitStmt_(op));
+    Array<Buffer> alloc_buffers =
+        block->alloc_buffers.Map([this](const Buffer& buffer) { return Rewrite(buffer); });
+    Array<BufferRegion> reads = Rewrite(block->reads);
+    Array<BufferRegion> writes = Rewrite(block->writes);
+    if (alloc_buffers.same_as(block->alloc_buffers) && reads.same_as(block->reads) &&
+        writes.same_as(block->writes) && !block->annotations.count(attr::pad_shared_memory)) {
+      return std::move(block);
+    }
+    BlockNode* n = block.CopyOnWrite();
+    n->alloc_buffers = std::move(alloc_buffers);
+    n->reads = std::move(reads);
+    n->writes = std::move(writes);
+    n->annotations.erase(attr::pad_shared_memory);
+    return std::move(block);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    BufferStore store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    Buffer buffer = Rewrite(store->buffer);
+    if (!buffer.same_as(store->buffer)) {
+      store.CopyOnWrite()->buffer = buffer;
+    }
+    return std::move(store);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    BufferLoad load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    Buffer buffer = Rewrite(load->buffer);
+    if (!buffer.same_as(load->buffer)) {
+      load.CopyOnWrite()->buffer = buffer;
+    }
+    return std::move(load);
+  }
+
+  std::unordered_map<const BufferNode*, Buffer> new_buffers_;
+};
+
+/*!
+ * \brief Choose the stride of the rows of a buffer with the fewest wavefronts of its accesses.
+ *
+ * The candidates are the strides of storage_align of the second innermost dimension with the
+ * factor of the 128 bytes of all banks, which keep the vector accesses aligned. The smaller stride
+ * is taken between the strides of the same wavefronts, and the rows are not padded unless it
+ * reduces the wavefronts.
+ * \return The stride of the rows, or -1 if the rows are not padded.
+ */
+int64_t ChoosePaddedRowStride(const Buffer& buffer, const std::vector<WarpAccess>& accesses) {
+  int64_t elem_bytes = buffer->dtype.bytes();
+  int64_t factor = kNumBanks * kBankBytes / elem_bytes;
+  if (factor <= 1) {
+    return -1;
+  }
+  std::vector<int64_t> shape;
+  for (const PrimExpr& dim : buffer->shape) {
+    shape.push_back(Downcast<IntImm>(dim)->value);
+  }
+  int64_t row = shape.back();
+  int64_t vector_elems = 1;
+  for (const WarpAccess& access : accesses) {
+    vector_elems = std::max(vector_elems, access.bytes / elem_bytes);
+  }
+  int64_t best_stride = row;
+  int64_t best_wavefronts = CountWavefronts(accesses, PaddedStrides(shape, row), elem_bytes);
+  for (int64_t offset = 0; offset < factor; ++offset) {
+    int64_t stride = row + (factor + offset - row % factor) % factor;
+    if (stride == row || stride % vector_elems != 0) {
+      continue;
+    }
+    int64_t wavefronts = CountWavefronts(accesses, PaddedStrides(shape, stride), elem_bytes);
+    if (wavefronts < best_wavefronts || (wavefronts == best_wavefronts && stride < best_stride)) {
+      best_stride = stride;
+      best_wavefronts = wavefronts;
+    }
+  }
+  return best_stride != row ? best_stride : -1;
+}
+
+PrimFunc PadSharedMemory(PrimFunc f, bool pad_by_default) {
+  std::unordered_map<const BufferNode*, Buffer> new_buffers;
+  for (auto& kv : SharedAccessCollector::Collect(f)) {
+    const Buffer& buffer = kv.second.first;
+    const SharedBufferInfo& info = kv.second.second;
+    bool pad = info.annotation != -1 ? info.annotation == 1 : pad_by_default;
+    if (!pad || info.excluded || info.accesses.empty()) {
+      continue;
+    }
+    int64_t row_stride = ChoosePaddedRowStride(buffer, info.accesses);
+    if (row_stride == -1) {
+      continue;
+    }
+    std::vector<int64_t> shape;
+    for (const PrimExpr& dim : buffer->shape) {
+      shape.push_back(Downcast<IntImm>(dim)->value);
+    }
+    DataType index_dtype = buffer->shape[0].dtype();
+    ObjectPtr<BufferNode> n = make_object<BufferNode>(*buffer.get());
+    for (int64_t stride : PaddedStrides(shape, row_stride)) {
+      n->strides.push_back(make_const(index_dtype, stride));
+    }
+    new_buffers.emplace(buffer.get(), Buffer(n));
+  }
+  PrimFuncNode* fptr = f.CopyOnWrite();
+  fptr->body = SharedBufferPadder(std::move(new_buffers))(std::move(fptr->body));
+  return f;
+}
+
+namespace transform {
+
+Pass InjectSharedMemoryPadding() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    bool pad_by_default = ctx->GetConfig<Bool>("tir.pad_shared_memory", Bool(false)).value();
+    return PadSharedMemory(std::move(f), pad_by_default);
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSharedMemoryPadding", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSharedMemoryPadding")
+    .set_body_typed(InjectSharedMemoryPadding);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -19,13 +19,17 @@
 
 /*!
  * \file inject_software_pipeline.cc
- * \brief Transform annotated loops into pipelined one that parallelize producers and consumers
+ * \brief Transform annotated loops into pipelined one that parallelize producers and consumers,
+ * or that prefetch the data of later iterations into the cache.
  */
 #include <tvm/target/target.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../../support/utils.h"
 #include "../schedule/utils.h"
@@ -1054,9 +1058,12 @@ class PipelineInjector : private StmtExprMutator {
   Stmt VisitStmt_(const ForNode* op) final {
     // Step 1: Recursively rewrite the children first.
     For for_node = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    bool has_prefetch = op->annotations.count(attr::software_prefetch_distance);
     if (!HasPipelineAnnotation(op)) {
-      return std::move(for_node);
+      return has_prefetch ? InjectPrefetch(for_node) : std::move(for_node);
     }
+    CHECK(!has_prefetch) << "ValueError: A loop cannot be both a software pipeline and prefetch "
+                            "the data of later iterations";
     // Step 2: Find the body and buffer allocations of the pipeline. The body can be direct child of
     // the for-loop. If the for-loop has BlockRealize as its child, the pipeline body will be the
     // child of the block.
@@ -1161,6 +1168,121 @@ class PipelineInjector : private StmtExprMutator {
     return pipeline;
   }
 
+  /*!
+   * \brief Prefetch the global buffers that a loop reads into the cache, a number of iterations
+   * ahead of the iteration that reads them, so that a CPU loop that streams through memory finds
+   * its data in the cache.
+   *
+   * for k in T.serial(256, annotations={"software_prefetch_distance": 4}):
+   *     C[i] = C[i] + A[i, k] * B[k]
+   *
+   * becomes
+   *
+   * for k in range(256):
+   *     if k + 4 < 256:
+   *         T.prefetch(T.address_of(A[i, k + 4]), 0, 3, 1)
+   *         T.prefetch(T.address_of(B[k + 4]), 0, 3, 1)
+   *     C[i] = C[i] + A[i, k] * B[k]
+   *
+   * The region that an iteration reads is prefetched a cache line at a time along its last
+   * dimension. The buffers that the loop writes, and the ones whose region does not depend on the
+   * loop variable, are not prefetched.
+   */
+  Stmt InjectPrefetch(For loop) {
+    int64_t distance = Downcast<Integer>(loop->annotations.at(attr::software_prefetch_distance))
+                           ->value;
+    int64_t locality = 3;
+    if (auto opt_locality = loop->annotations.Get(attr::software_prefetch_locality)) {
+      locality = Downcast<Integer>(opt_locality.value())->value;
+    }
+    CHECK(distance >= 0) << "ValueError: The prefetch distance should be non-negative, but got "
+                         << distance;
+    CHECK(0 <= locality && locality <= 3)
+        << "ValueError: The prefetch locality should be in [0, 3], but got " << locality;
+    For result = loop;
+    ForNode* n = result.CopyOnWrite();
+    n->annotations.erase(attr::software_prefetch_distance);
+    n->annotations.erase(attr::software_prefetch_locality);
+    if (distance == 0) {
+      return std::move(result);
+    }
+
+    std::unordered_set<const BufferNode*> written;
+    PostOrderVisit(loop->body, [&written](const ObjectRef& obj) {
+      if (const auto* block = obj.as<BlockNode>()) {
+        for (const Buffer& buffer : block->alloc_buffers) {
+          written.insert(buffer.get());
+        }
+        for (const BufferRegion& write : block->writes) {
+          written.insert(write->buffer.get());
+        }
+      } else if (const auto* store = obj.as<BufferStoreNode>()) {
+        written.insert(store->buffer.get());
+      } else if (const auto* decl = obj.as<DeclBufferNode>()) {
+        written.insert(decl->buffer.get());
+      }
+    });
+    Block body(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{}, /*name_hint=*/"",
+               /*body*/ loop->body);
+    Array<BufferRegion> reads = GetBlockReadWriteRegion(body, buffer_data_to_buffer_)[0];
+
+    const Var& loop_var = loop->loop_var;
+    PrimExpr ahead = loop_var + make_const(loop_var.dtype(), distance);
+    auto f_ahead = [&](const PrimExpr& e) { return Substitute(e, {{loop_var, ahead}}); };
+    auto f_uses_loop_var = [&loop_var](const VarNode* v) { return v == loop_var.get(); };
+    Array<Stmt> prefetches;
+    for (const BufferRegion& read : reads) {
+      const Buffer& buffer = read->buffer;
+      bool depends_on_loop =
+          std::any_of(read->region.begin(), read->region.end(),
+                      [&](const Range& range) { return UsesVar(range->min, f_uses_loop_var); });
+      if (written.count(buffer.get()) || buffer.scope() != "global" || !buffer->strides.empty() ||
+          read->region.empty() || !depends_on_loop) {
+        continue;
+      }
+      Region region = read->region.Map([&](const Range& range) {
+        return Range::FromMinExtent(f_ahead(range->min), f_ahead(range->extent));
+      });
+      prefetches.push_back(MakePrefetch(buffer, region, locality));
+    }
+    if (prefetches.empty()) {
+      return std::move(result);
+    }
+    Stmt prefetch = IfThenElse(ahead < loop->min + loop->extent, SeqStmt::Flatten(prefetches));
+    n->body = SeqStmt({prefetch, loop->body});
+    return std::move(result);
+  }
+
+  /*! \brief Prefetch a region of a buffer, a cache line at a time along its last dimension. */
+  static Stmt MakePrefetch(const Buffer& buffer, const Region& region, int64_t locality) {
+    constexpr int64_t kCacheLineBytes = 64;
+    int64_t line_elems = std::max<int64_t>(1, kCacheLineBytes / buffer->dtype.bytes());
+    Array<PrimExpr> indices;
+    std::vector<std::pair<Var, PrimExpr>> loops;
+    for (size_t i = 0; i < region.size(); ++i) {
+      const Range& range = region[i];
+      DataType dtype = range->min.dtype();
+      bool is_last = i + 1 == region.size();
+      PrimExpr extent =
+          is_last ? ceildiv(range->extent, make_const(dtype, line_elems)) : range->extent;
+      if (is_one(extent)) {
+        indices.push_back(range->min);
+        continue;
+      }
+      Var var("prefetch_" + buffer->name + "_" + std::to_string(i), dtype);
+      loops.emplace_back(var, extent);
+      indices.push_back(range->min + (is_last ? var * make_const(dtype, line_elems) : var));
+    }
+    PrimExpr address =
+        Call(DataType::Handle(), builtin::address_of(), {BufferLoad(buffer, indices)});
+    Stmt stmt = Evaluate(Call(DataType::Int(32), builtin::prefetch(),
+                              {address, Integer(0), Integer(locality), Integer(1)}));
+    for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+      stmt = For(it->first, make_zero(it->first.dtype()), it->second, ForKind::kSerial, stmt);
+    }
+    return stmt;
+  }
+
   /*!
    * \brief Add buffer allocations to a block and update the write region of the block.
    * \param n The block pointer to which the buffer allocations are added.
@@ -29,6 +29,7 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <chrono>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
@@ -44,6 +45,8 @@ struct LoopPartitionConfigNode : public tvm::AttrsNode<LoopPartitionConfigNode>
   bool partition_const_loop;
   bool no_unroll_loop_with_extent_one;
   bool unroll_loop_with_partition_hint_no_interval;
+  bool require_simpler_body;
+  double max_code_growth;
 
   TVM_DECLARE_ATTRS(LoopPartitionConfigNode, "tir.transform.LoopPartitionConfig") {
     TVM_ATTR_FIELD(partition_const_loop).describe("Split constant loop").set_default(false);
@@ -53,6 +56,16 @@ struct LoopPartitionConfigNode : public tvm::AttrsNode<LoopPartitionConfigNode>
     TVM_ATTR_FIELD(unroll_loop_with_partition_hint_no_interval)
         .describe("Unroll loops with pragma_loop_partition_hint and no interval")
         .set_default(false);
+    TVM_ATTR_FIELD(require_simpler_body)
+        .describe(
+            "Partition a loop only if its steady-state range has fewer predicates in the "
+            "innermost loops, unless the loop has pragma_loop_partition_hint")
+        .set_default(false);
+    TVM_ATTR_FIELD(max_code_growth)
+        .describe(
+            "The maximum number of statements duplicated by the partitioning, as a ratio of the "
+            "statements of the function, or no limit if not positive")
+        .set_default(0.0);
   }
 };
 
@@ -347,6 +360,59 @@ class ConditionEliminator : public StmtExprMutator {
   bool cond_value_;
 };
 
+// Count the predicates which are not constant in the innermost loops of a
+// statement, or in the whole statement if it has no loop.
+class InnermostPredicateCounter : public StmtExprVisitor {
+ public:
+  static int64_t Count(const Stmt& stmt) {
+    InnermostPredicateCounter counter;
+    counter(stmt);
+    return counter.has_loop_ ? counter.innermost_count_ : counter.count_;
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    int64_t count = count_;
+    has_loop_ = false;
+    StmtExprVisitor::VisitStmt_(op);
+    if (!has_loop_) {
+      innermost_count_ += count_ - count;
+    }
+    has_loop_ = true;
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    count_ += !is_const_int(op->condition);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::if_then_else())) {
+      count_ += !is_const_int(op->args[0]);
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const SelectNode* op) final {
+    count_ += !is_const_int(op->condition);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  // The predicates visited
+  int64_t count_{0};
+  // The predicates visited in the innermost loops
+  int64_t innermost_count_{0};
+  // Whether a loop is visited in the current loop, or at the top level
+  bool has_loop_{false};
+};
+
+// Count the statements, as a measure of the code size.
+inline int64_t CountStmts(const Stmt& stmt) {
+  int64_t count = 0;
+  PostOrderVisit(stmt, [&count](const ObjectRef& node) { count += node->IsInstance<StmtNode>(); });
+  return count;
+}
+
 // Insert the partition branch at the innermost thread scope
 class ThreadPartitionInserter : public StmtMutator {
  public:
@@ -382,10 +448,18 @@ class ThreadPartitionInserter : public StmtMutator {
 class LoopPartitioner : public StmtMutator {
  public:
   explicit LoopPartitioner(bool partition_const_loop, bool no_unroll_loop_with_extent_one,
-                           bool unroll_loop_with_partition_hint_no_interval)
+                           bool unroll_loop_with_partition_hint_no_interval,
+                           bool require_simpler_body = false, int64_t max_duplicated_stmts = -1)
       : selector(CandidateSelector(partition_const_loop)),
         no_unroll_loop_with_extent_one_(no_unroll_loop_with_extent_one),
-        unroll_loop_with_partition_hint_no_interval_(unroll_loop_with_partition_hint_no_interval) {}
+        unroll_loop_with_partition_hint_no_interval_(unroll_loop_with_partition_hint_no_interval),
+        require_simpler_body_(require_simpler_body),
+        max_duplicated_stmts_(max_duplicated_stmts) {}
+
+  // The number of loops partitioned
+  int num_partitioned{0};
+  // The number of loops not partitioned by the cost model
+  int num_rejected{0};
 
   Stmt VisitAndMutate(Stmt stmt) {
     selector(stmt);
@@ -455,6 +529,10 @@ class LoopPartitioner : public StmtMutator {
   CandidateSelector selector;
   bool no_unroll_loop_with_extent_one_;
   bool unroll_loop_with_partition_hint_no_interval_;
+  bool require_simpler_body_;
+  // The budget of the duplicated statements, or -1 if unlimited
+  int64_t max_duplicated_stmts_;
+  int64_t num_duplicated_stmts_{0};
 };
 
 // Returns an interval (in the first component) in which all the conditions
@@ -639,6 +717,15 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
   }
   bool cond_value = opt_cond_value.value();
 
+  // The partition is only worth its duplication if it simplifies the steady
+  // state, which is the innermost loops of the middle subrange.
+  Stmt simplified_body = ConditionEliminator(cond_set, cond_value)(body);
+  if (require_simpler_body_ && !has_partition_hint_ && !partition_thread_scope &&
+      InnermostPredicateCounter::Count(simplified_body) >= InnermostPredicateCounter::Count(body)) {
+    ++num_rejected;
+    return Stmt();
+  }
+
   IntervalSet middle_interval_i = Downcast<IntervalSet>(middle_interval);
   // middle_interval is the subrange of the loop variable range for which a
   // set of conditions are true (or false resp.)
@@ -696,6 +783,17 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
     post_doubt_begin = max + 1;
   }
 
+  if (max_duplicated_stmts_ >= 0 && !has_partition_hint_) {
+    int64_t num_stmts = (pre_stmt.defined() ? CountStmts(pre_stmt) : 0) +
+                        (post_stmt.defined() ? CountStmts(post_stmt) : 0);
+    if (num_duplicated_stmts_ + num_stmts > max_duplicated_stmts_) {
+      ++num_rejected;
+      return Stmt();
+    }
+    num_duplicated_stmts_ += num_stmts;
+  }
+  ++num_partitioned;
+
   Stmt s;
 
   // Generating code for middle subrange
@@ -703,7 +801,6 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
     Stmt mid_stmt;
     if (!analyzer_.CanProve(body_begin >= post_doubt_begin)) {
       // [body_begin, post_doubt_begin)
-      Stmt simplified_body = ConditionEliminator(cond_set, cond_value)(body);
       Stmt new_body = Substitute(simplified_body, {{Var{var}, var + body_begin}});
       mid_stmt = MakeFor(stmt.get(), post_doubt_begin - body_begin, new_body);
       // Recurse until partitions is empty
@@ -763,28 +860,36 @@ class RemoveLikelyTagsAndHints : public StmtExprMutator {
   }
 };
 
-Stmt LoopPartition(Stmt stmt, bool partition_const_loop, bool no_unroll_loop_with_extent_one,
-                   bool unroll_loop_with_partition_hint_no_interval) {
-  stmt = LoopPartitioner(partition_const_loop, no_unroll_loop_with_extent_one,
-                         unroll_loop_with_partition_hint_no_interval)
-             .VisitAndMutate(std::move(stmt));
-  stmt = RemoveLikelyTagsAndHints()(std::move(stmt));
-  return stmt;
+PrimFunc LoopPartition(PrimFunc f, const LoopPartitionConfig& cfg) {
+  auto start = std::chrono::steady_clock::now();
+  int64_t num_stmts = CountStmts(f->body);
+  int64_t max_duplicated_stmts =
+      cfg->max_code_growth > 0 ? static_cast<int64_t>(cfg->max_code_growth * num_stmts) : -1;
+  LoopPartitioner partitioner(cfg->partition_const_loop, cfg->no_unroll_loop_with_extent_one,
+                              cfg->unroll_loop_with_partition_hint_no_interval,
+                              cfg->require_simpler_body, max_duplicated_stmts);
+  auto* n = f.CopyOnWrite();
+  n->body = partitioner.VisitAndMutate(std::move(n->body));
+  n->body = RemoveLikelyTagsAndHints()(std::move(n->body));
+  auto end = std::chrono::steady_clock::now();
+  // The statements stand for the code size, which grows with the duplicated loop bodies.
+  VLOG(1) << "LoopPartition of " << f->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or("")
+          << ": partitioned " << partitioner.num_partitioned << " loop(s), rejected "
+          << partitioner.num_rejected << " by the cost model, " << num_stmts << " -> "
+          << CountStmts(n->body) << " statements in "
+          << std::chrono::duration<double, std::micro>(end - start).count() << " us";
+  return f;
 }
 
 namespace transform {
 
 Pass LoopPartition() {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
-    auto* n = f.CopyOnWrite();
     auto cfg = ctx->GetConfig<LoopPartitionConfig>("tir.LoopPartition");
     if (!cfg.defined()) {
       cfg = AttrsWithDefaultValues<LoopPartitionConfig>();
     }
-    n->body = LoopPartition(std::move(n->body), cfg.value()->partition_const_loop,
-                            cfg.value()->no_unroll_loop_with_extent_one,
-                            cfg.value()->unroll_loop_with_partition_hint_no_interval);
-    return f;
+    return LoopPartition(std::move(f), cfg.value());
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {});
 }
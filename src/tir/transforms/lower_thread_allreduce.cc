@@ -32,6 +32,7 @@
 #include <unordered_set>
 
 #include "../../runtime/thread_storage_scope.h"
+#include "../../support/utils.h"
 #include "ir_utils.h"
 #include "update_pointer_storage_scope.h"
 
@@ -43,7 +44,19 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   explicit ThreadAllreduceBuilder(const TargetNode* target)
       : target_(target),
         warp_size_(target->GetAttr<Integer>("thread_warp_size", 1).value().IntValue()),
-        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()) {}
+        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()) {
+    // redux.sync is available on sm_80 and later.
+    if (Optional<String> opt_sm = target->GetAttr<String>("arch")) {
+      std::string sm = opt_sm.value();
+      if (target->kind->name == "cuda" && support::StartsWith(sm, "sm_")) {
+        try {
+          supports_redux_sync_ = std::stoi(sm.substr(3)) >= 80;
+        } catch (const std::invalid_argument& e) {
+          supports_redux_sync_ = false;
+        }
+      }
+    }
+  }
 
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == attr::thread_extent) {
@@ -303,8 +316,11 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
 
         // Broadcast the reduction result from lane 0 to all other lanes.
         // This avoids to emit predicated stores, as all threads are
-        // uniformly writing the same result.
-        for (size_t i = 0; i < size; ++i) {
+        // uniformly writing the same result. redux.sync has the result
+        // in all lanes already.
+        bool is_redux_sync =
+            reduce_extent == warp_size_ && GetReduxSyncIntrinsic(combiner, types).defined();
+        for (size_t i = 0; i < size && !is_redux_sync; ++i) {
           Buffer buf = Downcast<BufferLoad>(reduce_results[i])->buffer;
           PrimExpr val = BufferLoad(buf, {zero_index});
           ICHECK_EQ(val->dtype, types[i]);
@@ -445,6 +461,9 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       PrimExpr mask, Optional<PrimExpr> predicate,  //
       std::vector<Stmt>* seq) {
     int n_buffers = src_values.size();
+    // A full warp of the 32-bit integers is reduced by one redux.sync.
+    Optional<String> redux_sync =
+        reduce_extent == warp_size_ ? GetReduxSyncIntrinsic(combiner, dtypes) : NullOpt;
 
     std::vector<Buffer> shared_bufs;
     std::vector<Buffer> local_bufs;
@@ -465,7 +484,9 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
 
       // Uses a local variable to store the shuffled data.  Later
       // on, an allocation will be built for this local variable.
-      local_bufs.push_back(decl_buffer(shape, dtypes[idx], "t" + std::to_string(idx), "local"));
+      if (!redux_sync.defined()) {
+        local_bufs.push_back(decl_buffer(shape, dtypes[idx], "t" + std::to_string(idx), "local"));
+      }
     }
 
     if (predicate.defined()) {
@@ -486,6 +507,19 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       local_bufs.push_back(mask_buffer.value());
     }
 
+    std::vector<PrimExpr> reduce_results;
+    reduce_results.reserve(n_buffers);
+    for (int i = 0; i < n_buffers; ++i) {
+      reduce_results.push_back(BufferLoad(shared_bufs[i], zero_indices));
+    }
+
+    if (redux_sync.defined()) {
+      seq->push_back(BufferStore(shared_bufs[0],
+                                 ReduxSync(redux_sync.value(), mask_buffer, reduce_results[0]),
+                                 zero_indices));
+      return {reduce_results, local_bufs};
+    }
+
     // Emit reductions within a warp.
     int start_offset = 1;
     while (start_offset * 2 < reduce_extent) {
@@ -547,12 +581,6 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       }
     }
 
-    std::vector<PrimExpr> reduce_results;
-    reduce_results.reserve(n_buffers);
-    for (int i = 0; i < n_buffers; ++i) {
-      reduce_results.push_back(BufferLoad(shared_bufs[i], zero_indices));
-    }
-
     return {reduce_results, local_bufs};
   }
 
@@ -714,6 +742,56 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     return Call(val.dtype(), op, args);
   }
 
+  // The intrinsic of redux.sync for the combiner, if the target has it.
+  //
+  // redux.sync reduces a 32-bit integer of each lane of a warp with add, min,
+  // max, and, or and xor, and gives the result to all lanes.
+  Optional<String> GetReduxSyncIntrinsic(const CommReducerNode* combiner,
+                                         const std::vector<DataType>& types) {
+    if (!supports_redux_sync_ || warp_size_ != 32 || types.size() != 1 ||
+        (types[0] != DataType::Int(32) && types[0] != DataType::UInt(32))) {
+      return NullOpt;
+    }
+    const Var& x = combiner->lhs[0];
+    const Var& y = combiner->rhs[0];
+    auto is_operands = [&](const PrimExpr& a, const PrimExpr& b) {
+      return (a.same_as(x) && b.same_as(y)) || (a.same_as(y) && b.same_as(x));
+    };
+    const PrimExpr& result = combiner->result[0];
+    if (const auto* op = result.as<AddNode>(); op && is_operands(op->a, op->b)) {
+      return String("__reduce_add_sync");
+    } else if (const auto* op = result.as<MinNode>(); op && is_operands(op->a, op->b)) {
+      return String("__reduce_min_sync");
+    } else if (const auto* op = result.as<MaxNode>(); op && is_operands(op->a, op->b)) {
+      return String("__reduce_max_sync");
+    } else if (const auto* op = result.as<CallNode>(); op && op->args.size() == 2 &&
+                                                       is_operands(op->args[0], op->args[1])) {
+      if (op->op.same_as(builtin::bitwise_and())) {
+        return String("__reduce_and_sync");
+      } else if (op->op.same_as(builtin::bitwise_or())) {
+        return String("__reduce_or_sync");
+      } else if (op->op.same_as(builtin::bitwise_xor())) {
+        return String("__reduce_xor_sync");
+      }
+    }
+    return NullOpt;
+  }
+
+  // Emit the redux.sync call.
+  PrimExpr ReduxSync(const String& intrinsic, Optional<Buffer> mask_buffer, PrimExpr val) {
+    PrimExpr mask = mask_buffer.defined() ? BufferLoad(mask_buffer.value(), {0})
+                                          : make_const(DataType::UInt(32), 0xFFFFFFFF);
+    // The bitwise reductions are on the unsigned integers only.
+    bool is_bitwise = intrinsic == "__reduce_and_sync" || intrinsic == "__reduce_or_sync" ||
+                      intrinsic == "__reduce_xor_sync";
+    if (is_bitwise && val.dtype().is_int()) {
+      PrimExpr ret = Call(DataType::UInt(32), builtin::call_pure_extern(),
+                          {StringImm(intrinsic), mask, cast(DataType::UInt(32), val)});
+      return cast(val.dtype(), ret);
+    }
+    return Call(val.dtype(), builtin::call_pure_extern(), {StringImm(intrinsic), mask, val});
+  }
+
   // Check if we can use warp level reduction.
   //
   // Note: The ROCm backend will only have warp reductions for now.
@@ -783,6 +861,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   int max_num_threads_{-1};
   // A boolean indicating if the target supports warp-level masking.
   bool need_warp_shuffle_mask_;
+  // A boolean indicating if the target supports redux.sync.
+  bool supports_redux_sync_{false};
 
   // surrounding scope of thread extent.
   std::vector<const AttrStmtNode*> thread_extents_;
@@ -213,7 +213,19 @@ Optional<String> RequiresPackedAPI(const PrimFunc& func) {
   return global_symbol;
 }
 
-PrimFunc MakePackedAPI(PrimFunc func) {
+/*!
+ * \brief Lower a PrimFunc to the packed function API.
+ *
+ * \param func The function to be lowered.
+ *
+ * \param check_args Whether to validate the arguments on entry.  If
+ * false, the number of arguments, their type codes and the fields of
+ * the DLTensor arguments are trusted, and only read to bind the
+ * parameters, shapes and strides of the function.
+ *
+ * \returns The lowered function.
+ */
+PrimFunc MakePackedAPI(PrimFunc func, bool check_args = true) {
   auto global_symbol = RequiresPackedAPI(func);
   if (!global_symbol.defined()) {
     return func;
@@ -290,13 +302,15 @@ PrimFunc MakePackedAPI(PrimFunc func) {
   // `binder.BindDLTensor()`.  The validity of those initialization
   // steps depends on the correct types being present, and must not
   // occur before the type codes are actually checked.
-  seq_init.push_back(MakeAssertEQ(v_num_packed_args, num_args, [&]() -> std::string {
-    std::ostringstream error_message;
-    error_message << name_hint << ": num_args should be " << num_args;
-    return error_message.str();
-  }()));
+  if (check_args) {
+    seq_init.push_back(MakeAssertEQ(v_num_packed_args, num_args, [&]() -> std::string {
+      std::ostringstream error_message;
+      error_message << name_hint << ": num_args should be " << num_args;
+      return error_message.str();
+    }()));
+  }
 
-  if (num_args > 0) {
+  if (check_args && num_args > 0) {
     seq_init.push_back(
         MakeAssertNotNull(v_packed_args, name_hint + ": TVMValue* arg pointer was NULL"));
     seq_init.push_back(
@@ -324,6 +338,10 @@ PrimFunc MakePackedAPI(PrimFunc func) {
       buffer_def.emplace_back(param, func_ptr->buffer_map[param]);
     }
 
+    if (!check_args) {
+      continue;
+    }
+
     // type code checks
     Var tcode(param->name_hint + ".code", DataType::Int(32));
     seq_init.emplace_back(
@@ -391,8 +409,20 @@ PrimFunc MakePackedAPI(PrimFunc func) {
   // Return error code of zero on success
   body = SeqStmt({body, Evaluate(ret(Integer(0)))});
 
-  body = MergeNest(
-      {seq_init, binder.init_nest(), seq_check, binder.asserts(), arg_buffer_declarations}, body);
+  if (check_args) {
+    body = MergeNest(
+        {seq_init, binder.init_nest(), seq_check, binder.asserts(), arg_buffer_declarations}, body);
+  } else {
+    // Keep the bindings of the DLTensor fields, but not the checks on
+    // them.
+    std::vector<Stmt> init_nest;
+    for (const Stmt& stmt : binder.init_nest()) {
+      if (!stmt->IsInstance<AssertStmtNode>()) {
+        init_nest.push_back(stmt);
+      }
+    }
+    body = MergeNest({seq_init, init_nest, seq_check, arg_buffer_declarations}, body);
+  }
   func_ptr->body = body;
   func_ptr->params = args;
 
@@ -422,6 +452,8 @@ Pass MakePackedAPI() {
       }
     }
 
+    bool emit_unchecked_api = ctx->GetConfig<Bool>("tir.emit_unchecked_api", Bool(false)).value();
+
     IRModuleNode* mptr = mod.CopyOnWrite();
     IRModule updates;
 
@@ -434,10 +466,23 @@ Pass MakePackedAPI() {
           func.CopyOnWrite()->body = body.value();
         }
 
-        func = MakePackedAPI(std::move(func));
+        PrimFunc lowered = MakePackedAPI(func);
+
+        // The unchecked entry is lowered from a copy of the function with
+        // fresh variables, so that no variable is defined by both
+        // entries.
+        if (emit_unchecked_api && !lowered.same_as(func)) {
+          String symbol = packed_func_methods[gvar] + runtime::symbol::tvm_unchecked_suffix;
+          GlobalVar unchecked_gvar(gvar->name_hint + runtime::symbol::tvm_unchecked_suffix);
+          ICHECK(!mptr->ContainGlobalVar(unchecked_gvar->name_hint))
+              << "Cannot emit the unchecked entry of " << gvar << ", because the module already "
+              << "contains a function named " << unchecked_gvar->name_hint;
+          PrimFunc unchecked = WithAttr(RenewDefs(func), tvm::attr::kGlobalSymbol, symbol);
+          updates->Add(unchecked_gvar, MakePackedAPI(std::move(unchecked), false));
+        }
 
-        if (!func.same_as(orig_func)) {
-          updates->Add(gvar, func);
+        if (!lowered.same_as(orig_func)) {
+          updates->Add(gvar, lowered);
         }
       }
     }
@@ -24,6 +24,7 @@
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/ir/type.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/target/target_info.h>
 #include <tvm/tir/analysis.h>
@@ -367,6 +368,28 @@ class InplaceOpVerifier : public StmtExprVisitor {
   const BufferStoreNode* store_{nullptr};
 };
 
+// Collects the buffer variables whose address is used directly, rather
+// than through a buffer access or tvm_access_ptr, e.g. when passed to an
+// extern call.  Such buffers cannot be placed at an offset of another
+// allocation.
+class DirectAddressUseCollector : public StmtExprVisitor {
+ public:
+  std::unordered_set<const VarNode*> vars;
+
+  void VisitExpr_(const VarNode* op) final { vars.insert(op); }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::tvm_access_ptr())) {
+      ICHECK_EQ(op->args.size(), 5U);
+      this->VisitExpr(op->args[2]);
+      this->VisitExpr(op->args[3]);
+      this->VisitExpr(op->args[4]);
+    } else {
+      StmtExprVisitor::VisitExpr_(op);
+    }
+  }
+};
+
 /* \brief Rewrite and merge memory allocation.
  *
  * Using LinearAccessPatternFinder, determines which buffers could share an
@@ -381,11 +404,17 @@ class StoragePlanRewriter : public StmtExprMutator {
   using AllocEntry = LinearAccessPatternFinder::AllocEntry;
 
   Stmt Rewrite(Stmt stmt, bool detect_inplace, bool enable_reuse,
-               bool reuse_require_exact_matched_dtype) {
+               bool reuse_require_exact_matched_dtype, bool merge_static_workspace = false) {
     detect_inplace_ = detect_inplace;
+    merge_static_workspace_ = merge_static_workspace;
     // plan the rewrite
     LinearAccessPatternFinder finder;
     finder(stmt);
+    if (merge_static_workspace) {
+      DirectAddressUseCollector collector;
+      collector(stmt);
+      direct_address_vars_ = std::move(collector.vars);
+    }
     this->LivenessAnalysis(finder.linear_seq_);
     this->PlanMemory(finder.linear_seq_, finder.alloc_info_, enable_reuse,
                      reuse_require_exact_matched_dtype);
@@ -622,13 +651,26 @@ class StoragePlanRewriter : public StmtExprMutator {
           }
         }
       }
+      // pack the static workspace of the function into a single arena,
+      // the entries are already shared by the liveness analysis.
+      if (merge_static_workspace_ && kv.first == nullptr) {
+        StorageEntry* arena = nullptr;
+        for (StorageEntry* e : vec) {
+          if (!IsStaticWorkspace(e)) continue;
+          if (arena == nullptr) {
+            arena = e;
+          } else {
+            arena->merged_children.push_back(e);
+          }
+        }
+      }
       // Start allocation
       for (size_t i = 0; i < vec.size(); ++i) {
         StorageEntry* e = vec[i];
         // already merged
         if (e->bits_offset != 0) continue;
         if (e->merged_children.size() != 0) {
-          NewAllocTagMerged(e);
+          NewAllocMerged(e);
           continue;
         }
         // Get the allocation size;
@@ -727,15 +769,31 @@ class StoragePlanRewriter : public StmtExprMutator {
       }
     }
   }
+  // Whether the entry is a constant size global allocation which can be
+  // placed in the workspace arena of the function.
+  bool IsStaticWorkspace(const StorageEntry* e) {
+    if (e->scope.rank != StorageRank::kGlobal || e->scope.tag.length() != 0) return false;
+    // small arrays are lowered to registers in LLVM
+    if (e->const_nbits <= 32 || e->ndim != 1) return false;
+    for (const AllocateNode* op : e->allocs) {
+      if (op->dtype.is_handle() || direct_address_vars_.count(op->buffer_var.get())) {
+        return false;
+      }
+    }
+    return true;
+  }
   // New allocation for merged data
-  void NewAllocTagMerged(StorageEntry* e) {
-    ICHECK_NE(e->scope.tag.length(), 0U);
+  void NewAllocMerged(StorageEntry* e) {
     // allocate with element type.
     ICHECK_NE(e->const_nbits, 0U);
-    MemoryInfo info = GetMemoryInfo(e->scope.to_string());
+    MemoryInfo info;
+    if (IsSpecialTaggedMemory(e->scope)) {
+      info = GetMemoryInfo(e->scope.to_string());
+    }
     uint64_t total_bits = e->const_nbits;
-    // By default, align to 32 bits.
-    size_t align = 32;
+    // By default, align to 32 bits, and the workspace arena to the
+    // alignment of the workspace allocations.
+    size_t align = e->scope.tag.length() != 0 ? 32 : runtime::kAllocAlignment * 8;
     if (info.defined()) {
       align = info->max_simd_bits;
     }
@@ -1021,6 +1079,10 @@ class StoragePlanRewriter : public StmtExprMutator {
   const Object* thread_scope_{nullptr};
   // whether enable inplace detection.
   bool detect_inplace_{false};
+  // whether to pack the static workspace of the function into one allocation.
+  bool merge_static_workspace_{false};
+  // The buffer variables whose address is used directly.
+  std::unordered_set<const VarNode*> direct_address_vars_;
   // Locations of free ops.
   std::unordered_map<const Object*, EventEntry> event_map_;
   // constant size free map.
@@ -1733,6 +1795,8 @@ Pass StorageRewrite() {
     bool enable_reuse = true;
     bool reuse_require_exact_matched_dtype = false;
     bool merge_static_smem = ctx->GetConfig<Bool>("tir.merge_static_smem", Bool(false)).value();
+    bool merge_static_workspace =
+        ctx->GetConfig<Bool>("tir.merge_static_workspace", Bool(false)).value();
     if (merge_static_smem) {
       // When `merge_static_smem` is true, we will reuse and merge shared
       // memory in a dedicated pass `MergeSharedMemoryAllocations`.
@@ -1748,7 +1812,8 @@ Pass StorageRewrite() {
     }
     auto* n = f.CopyOnWrite();
     n->body = StoragePlanRewriter().Rewrite(std::move(n->body), true, enable_reuse,
-                                            reuse_require_exact_matched_dtype);
+                                            reuse_require_exact_matched_dtype,
+                                            merge_static_workspace);
     // Parameters may not be rewritten, but internal allocations may.
     // Vectorization of AllocateConst is currently disabled, as it has
     // indexing issues for types that include padding (e.g. int8x3
@@ -31,7 +31,11 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <optional>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../src/arith/scalable_expression.h"
@@ -107,7 +111,13 @@ bool EnableBufferLevelPredication(Target target) {
  */
 class TryPredicateBufferAccesses : public StmtExprMutator {
  public:
-  TryPredicateBufferAccesses() {}
+  /*!
+   * \param lane_mask_of_loop Whether the condition is the lane mask of a whole vectorized loop,
+   * which then predicates any contiguous access of its lanes, and leaves the scalar loads, which
+   * are the same for all lanes, unpredicated.
+   */
+  explicit TryPredicateBufferAccesses(bool lane_mask_of_loop = false)
+      : lane_mask_of_loop_(lane_mask_of_loop) {}
 
   /*!
    * \brief Run the pass to try to exact predicates.
@@ -134,6 +144,7 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
 
     base_ = Downcast<Ramp>(lt->a)->base;
     limit_ = Downcast<Broadcast>(lt->b)->value;
+    lanes_dtype_ = lt->a->dtype;
 
     // Now we can try to predicate
     Stmt predicated_stmt = StmtExprMutator::operator()(std::move(stmt));
@@ -158,6 +169,10 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
   AccessNode TryPredicateBufferAccess(AccessNode node) {
     num_accesses_analyzed_ += 1;
 
+    if (lane_mask_of_loop_) {
+      return TryPredicateLoopAccess(node);
+    }
+
     // Do not try to predicate non-vectorized accesses
     Array<PrimExpr> indices = node->indices;
     if (!indices.size() || !indices[0]->IsInstance<RampNode>()) {
@@ -181,6 +196,38 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
     return node;
   }
 
+  template <typename AccessNode>
+  AccessNode TryPredicateLoopAccess(AccessNode node) {
+    const Array<PrimExpr>& indices = node->indices;
+    if (!indices.size() || !std::all_of(indices.begin(), indices.end() - 1, [](const PrimExpr& e) {
+          return e.dtype().is_scalar();
+        })) {
+      return node;
+    }
+    if (std::is_same<AccessNode, BufferLoad>::value && indices.back().dtype().is_scalar()) {
+      num_accesses_rewritten_ += 1;
+      return node;
+    }
+    // Only a contiguous access is a masked load or store of the lanes.
+    const auto* ramp = indices.back().as<RampNode>();
+    if (!ramp || !is_one(ramp->stride) ||
+        ramp->dtype.get_lanes_or_vscale_factor() != lanes_dtype_.get_lanes_or_vscale_factor() ||
+        ramp->dtype.is_scalable_vector() != lanes_dtype_.is_scalable_vector()) {
+      return node;
+    }
+    DataType buf_predicate_dtype =
+        DataType(DataType::kUInt, 1, ramp->dtype.get_lanes_or_vscale_factor(),
+                 ramp->dtype.is_scalable_vector());
+    num_accesses_rewritten_ += 1;
+    node.CopyOnWrite()->predicate =
+        Call(buf_predicate_dtype, builtin::get_active_lane_mask(), {base_, limit_});
+    return node;
+  }
+
+  /*! \brief Whether the condition is the lane mask of a whole vectorized loop. */
+  bool lane_mask_of_loop_;
+  /*! \brief The dtype of the lanes of the predicate. */
+  DataType lanes_dtype_;
   /*! \brief The variable base expr of the predicate. */
   PrimExpr base_;
   /*! \brief The limit of the predicate. The expr specifies the upper bound of the base's
@@ -309,6 +356,20 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
   PrimExpr VisitExpr(const PrimExpr& e) final { return ExprFunctor::VisitExpr(e); }
 
+  /*!
+   * \brief Vectorize an expression outside of a statement.
+   * \return The vectorized expression, or NullOpt if it would need to be scalarized.
+   */
+  Optional<PrimExpr> VectorizeExpr(const PrimExpr& e) {
+    ICHECK(!need_scalarize_);
+    PrimExpr ret = VisitExpr(e);
+    if (need_scalarize_) {
+      need_scalarize_ = false;
+      return NullOpt;
+    }
+    return ret;
+  }
+
   PrimExpr VisitExpr_(const AddNode* op) final {
     return AddSubVec(op, [](PrimExpr a, PrimExpr b) { return a + b; });
   }
@@ -633,6 +694,13 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
     PrimExpr value = this->VisitExpr(op->value);
 
+    if (indices.same_as(op->indices) && !value.same_as(op->value) && ReadsStoredElement(op)) {
+      // A reduction into an element that is the same for all lanes, which can not be a vector
+      // store, as every lane reads the element before any of them writes it.
+      need_scalarize_ = true;
+      return std::move(store);
+    }
+
     if (!indices.same_as(op->indices) || !value.same_as(op->value)) {
       ICHECK(!op->buffer->dtype.is_scalable_vector())
           << "Vectorizing over scalable buffer elements is not supported in vectorizer.";
@@ -807,6 +875,24 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   }
 
  private:
+  /*! \brief Check if the value of a store loads the element that it stores to. */
+  bool ReadsStoredElement(const BufferStoreNode* op) {
+    bool reads = false;
+    PostOrderVisit(op->value, [&](const ObjectRef& obj) {
+      const auto* load = obj.as<BufferLoadNode>();
+      if (load == nullptr || !load->buffer.same_as(op->buffer) ||
+          load->indices.size() != op->indices.size()) {
+        return;
+      }
+      bool same_indices = true;
+      for (size_t i = 0; i < op->indices.size(); ++i) {
+        same_indices = same_indices && deep_equal_(load->indices[i], op->indices[i]);
+      }
+      reads = reads || same_indices;
+    });
+    return reads;
+  }
+
   // analyzer
   arith::Analyzer analyzer_;
   // deep equal
@@ -892,6 +978,155 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   }
 };
 
+/*!
+ * \brief A reduction `buffer[indices] = buffer[indices] op value` into an element that is the same
+ * for all iterations of a loop, with one of the combiners that LLVM reduces the lanes of a vector
+ * with.
+ */
+class VectorizableReduction {
+ public:
+  /*! \brief The combiners of the reduction. */
+  enum class Kind { kAdd, kMul, kMax, kMin };
+
+  /*!
+   * \brief Match the body of a loop as a reduction.
+   * \param body The body of the loop.
+   * \param loop_var The variable of the loop.
+   * \return The reduction, or nothing if the body is not one.
+   */
+  static std::optional<VectorizableReduction> Match(const Stmt& body, const Var& loop_var) {
+    const auto* store = body.as<BufferStoreNode>();
+    if (store == nullptr || !store->value.dtype().is_scalar() ||
+        !store->buffer->dtype.is_scalar() || UsesIndices(store->indices, loop_var)) {
+      return std::nullopt;
+    }
+    VectorizableReduction reduction;
+    reduction.store = GetRef<BufferStore>(store);
+    PrimExpr a, b;
+    if (const auto* add = store->value.as<AddNode>()) {
+      reduction.kind = Kind::kAdd;
+      a = add->a;
+      b = add->b;
+    } else if (const auto* mul = store->value.as<MulNode>()) {
+      reduction.kind = Kind::kMul;
+      a = mul->a;
+      b = mul->b;
+    } else if (const auto* max = store->value.as<MaxNode>()) {
+      reduction.kind = Kind::kMax;
+      a = max->a;
+      b = max->b;
+    } else if (const auto* min = store->value.as<MinNode>()) {
+      reduction.kind = Kind::kMin;
+      a = min->a;
+      b = min->b;
+    } else {
+      return std::nullopt;
+    }
+    // The combiners are commutative, so the stored element may be either operand.
+    if (reduction.IsStoredElement(b)) {
+      std::swap(a, b);
+    }
+    if (!reduction.IsStoredElement(a)) {
+      return std::nullopt;
+    }
+    reduction.value = b;
+    bool value_reads_buffer = false;
+    PostOrderVisit(b, [&](const ObjectRef& obj) {
+      if (const auto* load = obj.as<BufferLoadNode>()) {
+        value_reads_buffer = value_reads_buffer || load->buffer.same_as(store->buffer);
+      }
+    });
+    if (value_reads_buffer) {
+      return std::nullopt;
+    }
+    return reduction;
+  }
+
+  /*! \brief Combine two values of the reduction. */
+  PrimExpr Combine(PrimExpr a, PrimExpr b) const {
+    switch (kind) {
+      case Kind::kAdd:
+        return Add(a, b);
+      case Kind::kMul:
+        return Mul(a, b);
+      case Kind::kMax:
+        return Max(a, b);
+      case Kind::kMin:
+        return Min(a, b);
+    }
+    throw;
+  }
+
+  /*! \brief The identity of the combiner, of the given type. */
+  PrimExpr Identity(DataType dtype) const {
+    DataType element = dtype.element_of();
+    PrimExpr identity;
+    switch (kind) {
+      case Kind::kAdd:
+        identity = make_zero(element);
+        break;
+      case Kind::kMul:
+        identity = make_const(element, 1);
+        break;
+      case Kind::kMax:
+        identity = min_value(element);
+        break;
+      case Kind::kMin:
+        identity = max_value(element);
+        break;
+    }
+    return dtype.is_scalar() ? identity : Broadcast(identity, dtype.lanes());
+  }
+
+  /*! \brief Reduce the lanes of a vector into a scalar, with a vector reduction of LLVM. */
+  PrimExpr ReduceLanes(PrimExpr vec) const {
+    static const Op* ops[] = {&builtin::vector_reduce_add(), &builtin::vector_reduce_mul(),
+                              &builtin::vector_reduce_max(), &builtin::vector_reduce_min()};
+    return Call(vec.dtype().element_of(), *ops[static_cast<int>(kind)], {vec});
+  }
+
+  /*! \brief Store a value into the stored element. */
+  Stmt StoreToElement(PrimExpr value) const {
+    return BufferStore(store->buffer, value, store->indices);
+  }
+
+  /*! \brief Check if the index of the stored element uses a variable. */
+  bool IndexUses(const Var& var) const { return UsesIndices(store->indices, var); }
+
+  /*! \brief Load the stored element. */
+  PrimExpr LoadElement() const { return BufferLoad(store->buffer, store->indices); }
+
+  /*! \brief The store of the reduction. */
+  BufferStore store;
+  /*! \brief The combiner of the reduction. */
+  Kind kind;
+  /*! \brief The value that is combined into the stored element at each iteration. */
+  PrimExpr value;
+
+ private:
+  static bool UsesIndices(const Array<PrimExpr>& indices, const Var& var) {
+    return std::any_of(indices.begin(), indices.end(),
+                       [&var](const PrimExpr& index) {
+                         return UsesVar(index, [&var](const VarNode* v) { return v == var.get(); });
+                       });
+  }
+
+  bool IsStoredElement(const PrimExpr& e) const {
+    const auto* load = e.as<BufferLoadNode>();
+    if (load == nullptr || !load->buffer.same_as(store->buffer) ||
+        load->indices.size() != store->indices.size()) {
+      return false;
+    }
+    ExprDeepEqual deep_equal;
+    for (size_t i = 0; i < load->indices.size(); ++i) {
+      if (!deep_equal(load->indices[i], store->indices[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
 class LoopVectorizer : public StmtMutator {
  public:
   explicit LoopVectorizer(DictAttrs attrs) {
@@ -906,12 +1141,23 @@ class LoopVectorizer : public StmtMutator {
 
       if (!extent_as_int || extent_as_int->value < 1) {
         bool is_scalable_expr = CheckContains::ExprContains(op->extent, arith::IsVScaleCall);
+        if (!is_scalable_expr) {
+          if (Optional<PrimExpr> lanes = GetPredicatedLanes(op)) {
+            return VectorizePredicated(op, lanes.value());
+          }
+        }
         ICHECK(is_scalable_expr && arith::TargetHasSVE(target_))
             << "Failed to vectorize loop with extent " << op->extent << " for target " << target_;
       }
       ICHECK(is_zero(op->min));
+      if (Optional<Stmt> reduction = VectorizeReduction(op)) {
+        return reduction.value();
+      }
       return Vectorizer(op->loop_var, op->extent, target_)(op->body);
     } else {
+      if (Optional<Stmt> reduction = VectorizeReductionWithAccumulator(op)) {
+        return reduction.value();
+      }
       return StmtMutator::VisitStmt_(op);
     }
   }
@@ -928,6 +1174,206 @@ class LoopVectorizer : public StmtMutator {
   }
 
  private:
+  /*!
+   * \brief Get the lanes of the predicated vectors of the target for a loop of symbolic extent,
+   * a vector register of the widest element the loop accesses: a scalable vector on SVE, and an
+   * AVX-512 register on x86.
+   * \return The lanes, or NullOpt if the target has no predicated vectors or it is disabled.
+   */
+  Optional<PrimExpr> GetPredicatedLanes(const ForNode* op) {
+    if (!target_.defined() || target_->kind->name != "llvm") {
+      return NullOpt;
+    }
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    if (!pass_ctx->GetConfig<Bool>("tir.enable_buffer_level_predication").value_or(Bool(true))) {
+      return NullOpt;
+    }
+    int max_bits = 0;
+    PostOrderVisit(op->body, [&max_bits](const ObjectRef& obj) {
+      if (const auto* load = obj.as<BufferLoadNode>()) {
+        max_bits = std::max(max_bits, load->buffer->dtype.bits());
+      } else if (const auto* store = obj.as<BufferStoreNode>()) {
+        max_bits = std::max(max_bits, store->buffer->dtype.bits());
+      }
+    });
+    if (max_bits < 8 || max_bits > 64) {
+      return NullOpt;
+    }
+    if (arith::TargetHasSVE(target_)) {
+      return Call(DataType::Int(32), builtin::vscale(), {}) * (128 / max_bits);
+    }
+    static const runtime::PackedFunc* f_has_feature =
+        runtime::Registry::Get("target.target_has_feature");
+    if (f_has_feature != nullptr && (*f_has_feature)(String("avx512f"), target_).operator bool()) {
+      return IntImm(DataType::Int(32), 512 / max_bits);
+    }
+    return NullOpt;
+  }
+
+  /*!
+   * \brief Vectorize a loop of symbolic extent into a loop over vectors of the lanes, whose
+   * accesses are masked by the active lanes, so that the tail needs no scalar epilogue.
+   *
+   * for i in T.vectorized(n):
+   *     B[i] = A[i] + 1.0
+   *
+   * becomes, for 16 lanes,
+   *
+   * for i_outer in range(T.ceildiv(n, 16)):
+   *     mask = T.get_active_lane_mask("uint1x16", i_outer * 16, n)
+   *     B.vstore([T.Ramp(i_outer * 16, 1, 16)], A.vload([...], predicate=mask) + 1.0,
+   *              predicate=mask)
+   *
+   * The body is instead guarded and vectorized as a conditional, which scalarizes it, if it has
+   * an access that can not be masked, or an integer division by a value of the lanes, which
+   * could trap on the inactive lanes.
+   */
+  Stmt VectorizePredicated(const ForNode* op, PrimExpr lanes) {
+    DataType dtype = op->loop_var.dtype();
+    Var outer = op->loop_var.copy_with_suffix(".outer");
+    Var inner = op->loop_var.copy_with_suffix(".inner");
+    PrimExpr base = outer * cast(dtype, lanes);
+    Stmt body = Substitute(op->body, {{op->loop_var, base + inner}});
+
+    bool has_variable_divisor = false;
+    PostOrderVisit(body, [&has_variable_divisor](const ObjectRef& obj) {
+      auto is_variable_int = [](const PrimExpr& e) {
+        return (e.dtype().is_int() || e.dtype().is_uint()) && !is_const_int(e);
+      };
+      if (const auto* div = obj.as<DivNode>()) {
+        has_variable_divisor |= is_variable_int(div->b);
+      } else if (const auto* mod = obj.as<ModNode>()) {
+        has_variable_divisor |= is_variable_int(mod->b);
+      } else if (const auto* floordiv = obj.as<FloorDivNode>()) {
+        has_variable_divisor |= is_variable_int(floordiv->b);
+      } else if (const auto* floormod = obj.as<FloorModNode>()) {
+        has_variable_divisor |= is_variable_int(floormod->b);
+      }
+    });
+    Optional<Stmt> vectorized = NullOpt;
+    if (!has_variable_divisor) {
+      Stmt vectorized_body = Vectorizer(inner, lanes, target_)(body);
+      // A loop in the vectorized body is a part of it that was scalarized.
+      bool has_loop = false;
+      PostOrderVisit(vectorized_body,
+                     [&has_loop](const ObjectRef& obj) { has_loop |= obj->IsInstance<ForNode>(); });
+      if (!has_loop) {
+        PrimExpr lane_mask =
+            LT(Ramp(base, make_const(dtype, 1), lanes), Broadcast(op->extent, lanes));
+        std::pair<bool, Stmt> success_stmt_pair =
+            TryPredicateBufferAccesses(/*lane_mask_of_loop=*/true).Run(vectorized_body, lane_mask);
+        if (success_stmt_pair.first) {
+          vectorized = success_stmt_pair.second;
+        }
+      }
+    }
+    if (!vectorized.defined()) {
+      vectorized = Vectorizer(inner, lanes, target_)(IfThenElse(base + inner < op->extent, body));
+    }
+    return For(outer, make_zero(dtype), ceildiv(op->extent, cast(dtype, lanes)), ForKind::kSerial,
+               vectorized.value(), NullOpt, op->annotations);
+  }
+
+  /*!
+   * \brief Vectorize a loop whose body is a reduction into an element that is the same for all
+   * iterations, by reducing the lanes of the vectorized value into the element.
+   *
+   * for k in T.vectorized(16):
+   *     B[0] = B[0] + A[k]
+   *
+   * becomes
+   *
+   * B[0] = B[0] + T.vector_reduce_add("float32", A[T.Ramp(0, 1, 16)])
+   *
+   * \return The vectorized loop, or NullOpt if the loop is not such a reduction, or the target
+   * has no vector reductions, in which case the reduction is scalarized.
+   */
+  Optional<Stmt> VectorizeReduction(const ForNode* op) {
+    std::optional<VectorizableReduction> reduction = MatchReduction(op);
+    if (!reduction.has_value()) {
+      return NullOpt;
+    }
+    Optional<PrimExpr> vectorized = VectorizeReductionValue(op, reduction.value());
+    if (!vectorized.defined()) {
+      return NullOpt;
+    }
+    const VectorizableReduction& r = reduction.value();
+    return r.StoreToElement(r.Combine(r.LoadElement(), r.ReduceLanes(vectorized.value())));
+  }
+
+  /*!
+   * \brief Vectorize a serial loop over a vectorized reduction into an element that is the same
+   * for all iterations of both, with a vector accumulator that is only reduced after the loop.
+   *
+   * for k_0 in range(64):
+   *     for k_1 in T.vectorized(16):
+   *         B[0] = B[0] + A[k_0 * 16 + k_1]
+   *
+   * becomes
+   *
+   * acc = T.decl_buffer((16,), "float32", scope="local")
+   * acc[T.Ramp(0, 1, 16)] = T.Broadcast(T.float32(0), 16)
+   * for k_0 in range(64):
+   *     acc[T.Ramp(0, 1, 16)] = acc[T.Ramp(0, 1, 16)] + A[T.Ramp(k_0 * 16, 1, 16)]
+   * B[0] = B[0] + T.vector_reduce_add("float32", acc[T.Ramp(0, 1, 16)])
+   *
+   * The accumulator only exists for vectors of a constant number of lanes. The lanes of floats
+   * are accumulated separately, which reassociates the reduction as an rfactor would.
+   */
+  Optional<Stmt> VectorizeReductionWithAccumulator(const ForNode* op) {
+    const auto* inner = op->body.as<ForNode>();
+    if (op->kind != ForKind::kSerial || inner == nullptr || inner->kind != ForKind::kVectorized ||
+        !is_zero(inner->min)) {
+      return NullOpt;
+    }
+    const auto* lanes = inner->extent.as<IntImmNode>();
+    if (lanes == nullptr || lanes->value < 2) {
+      return NullOpt;
+    }
+    std::optional<VectorizableReduction> reduction = MatchReduction(inner);
+    if (!reduction.has_value() || reduction.value().IndexUses(op->loop_var)) {
+      return NullOpt;
+    }
+    Optional<PrimExpr> vectorized = VectorizeReductionValue(inner, reduction.value());
+    if (!vectorized.defined()) {
+      return NullOpt;
+    }
+    const VectorizableReduction& r = reduction.value();
+    DataType dtype = vectorized.value().dtype();
+    Buffer acc = decl_buffer({IntImm(DataType::Int(32), lanes->value)}, dtype.element_of(),
+                             r.store->buffer->name + "_acc", "local");
+    Array<PrimExpr> acc_indices = {Ramp(make_zero(DataType::Int(32)),
+                                        make_const(DataType::Int(32), 1), inner->extent)};
+    PrimExpr acc_value = BufferLoad(acc, acc_indices);
+    Stmt init = BufferStore(acc, r.Identity(dtype), acc_indices);
+    Stmt update = BufferStore(acc, r.Combine(acc_value, vectorized.value()), acc_indices);
+    Stmt loop = For(op->loop_var, op->min, op->extent, op->kind, update, op->thread_binding,
+                    op->annotations);
+    Stmt reduce = r.StoreToElement(r.Combine(r.LoadElement(), r.ReduceLanes(acc_value)));
+    Stmt body = DeclBuffer(acc, SeqStmt({init, loop, reduce}));
+    return Allocate(acc->data, acc->dtype, acc->shape, const_true(), body);
+  }
+
+  /*! \brief Match the body of a vectorized loop as a reduction, if the target reduces vectors. */
+  std::optional<VectorizableReduction> MatchReduction(const ForNode* op) {
+    if (!target_.defined() || target_->kind->name != "llvm") {
+      return std::nullopt;
+    }
+    return VectorizableReduction::Match(op->body, op->loop_var);
+  }
+
+  /*! \brief Vectorize the value that a reduction combines at each iteration of a loop. */
+  Optional<PrimExpr> VectorizeReductionValue(const ForNode* op,
+                                             const VectorizableReduction& reduction) {
+    Optional<PrimExpr> vectorized =
+        Vectorizer(op->loop_var, op->extent, target_).VectorizeExpr(reduction.value);
+    if (vectorized.defined() && vectorized.value().dtype().is_scalar()) {
+      // The value is the same for all iterations.
+      return Broadcast(vectorized.value(), op->extent);
+    }
+    return vectorized;
+  }
+
   Target target_ = Target::Current();
 };
 
@@ -937,7 +1383,10 @@ class VectorizeSkipper : public StmtMutator {
     Stmt stmt = StmtMutator::VisitStmt_(op);
     op = stmt.as<ForNode>();
     if (op->kind == ForKind::kVectorized) {
-      return For(op->loop_var, op->min, op->extent, ForKind::kSerial, op->body);
+      Map<String, ObjectRef> annotations = op->annotations;
+      annotations.Set(attr::vectorize_hint, Bool(true));
+      return For(op->loop_var, op->min, op->extent, ForKind::kSerial, op->body, NullOpt,
+                 annotations);
     } else {
       return stmt;
     }
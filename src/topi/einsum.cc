@@ -24,6 +24,10 @@
 #include <tvm/topi/broadcast.h>
 #include <tvm/topi/einsum.h>
 
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
 namespace tvm {
 namespace topi {
 
@@ -204,6 +208,11 @@ class EinsumBuilder {
     return output_shape_;
   }
 
+  /*! \brief The extent of a label with broadcast rules applied, after the shape inference. */
+  const PrimExpr& GetLabelExtent(EinsumEquation::Label label) const {
+    return label_to_extent_.at(label);
+  }
+
   PrimExpr BuildOutputExpr(const Array<Tensor> inputs, const Array<Var>& indices) {
     std::unordered_map<EinsumEquation::Label, Var> label_to_index;
     Array<Var> ellipsis_indices;
@@ -333,13 +342,181 @@ class EinsumBuilder {
   Optional<Array<PrimExpr>> ellipsis_shape_;
 };
 
+/*! \brief The contraction order search of EinsumContractionPath. */
+class EinsumPathFinder {
+ public:
+  using LabelSet = std::bitset<LABELRANGE>;
+
+  /*! \brief The number of operands up to which the order is searched exhaustively. */
+  static constexpr int kMaxOptimalOperands = 5;
+  /*! \brief The extent assumed for a label of symbolic extent. */
+  static constexpr double kSymbolicExtent = 32;
+
+  EinsumPathFinder(const EinsumEquation& equation, const EinsumBuilder& builder) {
+    for (const EinsumEquation::Subscript& subscript : equation.inputs) {
+      LabelSet labels;
+      for (EinsumEquation::Label label : subscript) {
+        labels.set(label);
+        const auto* extent = builder.GetLabelExtent(label).as<IntImmNode>();
+        extents_[label] = extent ? static_cast<double>(extent->value) : kSymbolicExtent;
+      }
+      operands_.push_back(labels);
+    }
+    for (EinsumEquation::Label label : equation.output) {
+      output_.set(label);
+    }
+  }
+
+  /*! \return The pairs of operands to contract in order, indexed in the current list. */
+  std::vector<std::pair<int, int>> Find() {
+    std::vector<std::pair<int, int>> path;
+    if (static_cast<int>(operands_.size()) <= kMaxOptimalOperands) {
+      std::vector<std::pair<int, int>> best_path;
+      double best_cost = std::numeric_limits<double>::infinity();
+      Search(operands_, 0, &path, &best_path, &best_cost);
+      return best_path;
+    }
+    // Greedily contract the pair of the fewest multiply-adds, then of the smallest result.
+    std::vector<LabelSet> operands = operands_;
+    while (operands.size() > 1) {
+      std::pair<int, int> best_pair;
+      std::pair<double, double> best_key{std::numeric_limits<double>::infinity(), 0};
+      for (int i = 0; i < static_cast<int>(operands.size()); ++i) {
+        for (int j = i + 1; j < static_cast<int>(operands.size()); ++j) {
+          std::pair<double, double> key{Size(operands[i] | operands[j]),
+                                        Size(Contract(operands, i, j))};
+          if (key < best_key) {
+            best_key = key;
+            best_pair = {i, j};
+          }
+        }
+      }
+      operands = Apply(operands, best_pair.first, best_pair.second);
+      path.push_back(best_pair);
+    }
+    return path;
+  }
+
+  /*! \return The labels kept by the contraction of operands i and j. */
+  LabelSet Contract(const std::vector<LabelSet>& operands, int i, int j) const {
+    LabelSet kept = output_;
+    for (int k = 0; k < static_cast<int>(operands.size()); ++k) {
+      if (k != i && k != j) kept |= operands[k];
+    }
+    return (operands[i] | operands[j]) & kept;
+  }
+
+ private:
+  double Size(const LabelSet& labels) const {
+    double size = 1;
+    for (const auto& [label, extent] : extents_) {
+      if (labels.test(label)) size *= extent;
+    }
+    return size;
+  }
+
+  std::vector<LabelSet> Apply(std::vector<LabelSet> operands, int i, int j) const {
+    LabelSet result = Contract(operands, i, j);
+    operands.erase(operands.begin() + j);
+    operands.erase(operands.begin() + i);
+    operands.push_back(result);
+    return operands;
+  }
+
+  void Search(const std::vector<LabelSet>& operands, double cost,
+              std::vector<std::pair<int, int>>* path, std::vector<std::pair<int, int>>* best_path,
+              double* best_cost) const {
+    if (cost >= *best_cost) return;
+    if (operands.size() == 1) {
+      *best_cost = cost;
+      *best_path = *path;
+      return;
+    }
+    for (int i = 0; i < static_cast<int>(operands.size()); ++i) {
+      for (int j = i + 1; j < static_cast<int>(operands.size()); ++j) {
+        path->emplace_back(i, j);
+        Search(Apply(operands, i, j), cost + Size(operands[i] | operands[j]), path, best_path,
+               best_cost);
+        path->pop_back();
+      }
+    }
+  }
+
+  std::vector<LabelSet> operands_;
+  LabelSet output_;
+  std::unordered_map<EinsumEquation::Label, double> extents_;
+};
+
+std::vector<EinsumContraction> EinsumContractionPath(const std::string& subscripts_str,
+                                                     const Array<Array<PrimExpr>>& input_shapes) {
+  EinsumEquation equation = EinsumEquation::FromString(subscripts_str);
+  auto has_ellipsis = [](const EinsumEquation::Subscript& subscript) {
+    return std::find(subscript.begin(), subscript.end(), EinsumEquation::kEllipsis) !=
+           subscript.end();
+  };
+  if (equation.inputs.size() <= 2 || has_ellipsis(equation.output) ||
+      std::any_of(equation.inputs.begin(), equation.inputs.end(), has_ellipsis)) {
+    return {};
+  }
+  EinsumBuilder builder(equation, input_shapes);
+  builder.InferShape();
+  EinsumPathFinder finder(equation, builder);
+
+  // The subscripts of the current operands, the intermediate results listing their labels in
+  // order, and the last one producing the output of the einsum.
+  std::vector<std::string> subscripts;
+  std::vector<EinsumPathFinder::LabelSet> operands;
+  for (const EinsumEquation::Subscript& subscript : equation.inputs) {
+    subscripts.emplace_back(subscript.begin(), subscript.end());
+    EinsumPathFinder::LabelSet labels;
+    for (EinsumEquation::Label label : subscript) labels.set(label);
+    operands.push_back(labels);
+  }
+  std::vector<EinsumContraction> path;
+  for (const auto& [lhs, rhs] : finder.Find()) {
+    EinsumPathFinder::LabelSet result = finder.Contract(operands, lhs, rhs);
+    std::string result_subscript;
+    if (operands.size() == 2) {
+      result_subscript = std::string(equation.output.begin(), equation.output.end());
+    } else {
+      for (int label = 0; label < LABELRANGE; ++label) {
+        if (result.test(label)) result_subscript.push_back(static_cast<char>(label));
+      }
+    }
+    path.push_back({lhs, rhs, subscripts[lhs] + "," + subscripts[rhs] + "->" + result_subscript});
+    for (int index : {rhs, lhs}) {
+      subscripts.erase(subscripts.begin() + index);
+      operands.erase(operands.begin() + index);
+    }
+    subscripts.push_back(result_subscript);
+    operands.push_back(result);
+  }
+  return path;
+}
+
 Tensor einsum(const std::string& subscripts_str, const Array<Tensor> inputs, std::string name,
               std::string tag) {
-  EinsumEquation equation = EinsumEquation::FromString(subscripts_str);
   Array<Array<PrimExpr>> input_shapes;
   for (const Tensor& input : inputs) {
     input_shapes.push_back(input->shape);
   }
+  // An einsum of more operands is evaluated as a sequence of pairwise contractions, which costs
+  // far fewer multiply-adds than one reduction over all the labels.
+  std::vector<EinsumContraction> path = EinsumContractionPath(subscripts_str, input_shapes);
+  if (!path.empty()) {
+    std::vector<Tensor> operands(inputs.begin(), inputs.end());
+    for (size_t step = 0; step < path.size(); ++step) {
+      const EinsumContraction& contraction = path[step];
+      std::string step_name = step + 1 == path.size() ? name : name + "_" + std::to_string(step);
+      Array<Tensor> pair{operands[contraction.lhs], operands[contraction.rhs]};
+      Tensor result = einsum(contraction.equation, pair, step_name, tag);
+      operands.erase(operands.begin() + contraction.rhs);
+      operands.erase(operands.begin() + contraction.lhs);
+      operands.push_back(result);
+    }
+    return operands[0];
+  }
+  EinsumEquation equation = EinsumEquation::FromString(subscripts_str);
   EinsumBuilder einsum_builder = EinsumBuilder(equation, input_shapes);
   auto output_shape = einsum_builder.InferShape();
   return te::compute(
@@ -359,5 +536,15 @@ TVM_REGISTER_GLOBAL("topi.einsum").set_body([](TVMArgs args, TVMRetValue* rv) {
   *rv = einsum(args[0], args[1]);
 });
 
+TVM_REGISTER_GLOBAL("topi.einsum_contraction_path")
+    .set_body_typed([](std::string subscripts, Array<Array<PrimExpr>> input_shapes) {
+      Array<Array<ObjectRef>> result;
+      for (const EinsumContraction& contraction : EinsumContractionPath(subscripts, input_shapes)) {
+        result.push_back({Integer(contraction.lhs), Integer(contraction.rhs),
+                          String(contraction.equation)});
+      }
+      return result;
+    });
+
 }  // namespace topi
 }  // namespace tvm
@@ -359,3 +359,39 @@ TEST_F(HexagonThreadManagerTest, threads_for_resource_types) {
   thread = reinterpret_cast<TVMStreamHandle>(6);
   EXPECT_THROW(thread_manager->GetResourceTypeForStreamHandle(thread), InternalError);
 }
+
+int record_num_task(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  (*static_cast<std::vector<int>*>(cdata))[task_id] = penv->num_task;
+  return 0;
+}
+
+int count_and_sync(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  std::atomic<int>* arrived = static_cast<std::atomic<int>*>(cdata);
+  arrived->fetch_add(1);
+  TVMBackendParallelBarrier(task_id, penv);
+  return arrived->load() == penv->num_task ? 0 : -1;
+}
+
+// Without HVX threads, the tasks run on the calling thread
+TEST_F(HexagonThreadManagerTest, parallel_launch_without_hvx) {
+  std::vector<int> num_task(1, 0);
+  CHECK_EQ(htm->NumHvxThreads(), 0);
+  CHECK_EQ(htm->ParallelLaunch(record_num_task, &num_task, 0), 0);
+  CHECK_EQ(num_task[0], 1);
+}
+
+// Parallel loops run one task per HVX thread of the global manager
+TEST_F(HexagonThreadManagerTest, parallel_launch_on_hvx_threads) {
+  int num_hvx = HexagonDeviceAPI::Global()->ThreadManager()->NumHvxThreads();
+  if (num_hvx == 0) GTEST_SKIP() << "No HVX context reserved";
+
+  std::vector<int> num_task(num_hvx, 0);
+  CHECK_EQ(TVMBackendParallelLaunch(record_num_task, &num_task, 0), 0);
+  for (int i = 0; i < num_hvx; i++) {
+    CHECK_EQ(num_task[i], num_hvx);
+  }
+
+  std::atomic<int> arrived{0};
+  CHECK_EQ(TVMBackendParallelLaunch(count_and_sync, &arrived, 0), 0);
+  CHECK_EQ(arrived.load(), num_hvx);
+}
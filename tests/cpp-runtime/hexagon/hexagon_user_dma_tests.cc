@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include "../src/runtime/hexagon/hexagon_device_api.h"
+#include "../src/runtime/hexagon/hexagon_dma_staging.h"
 
 using namespace tvm::runtime;
 using namespace tvm::runtime::hexagon;
@@ -349,3 +350,30 @@ TEST_F(HexagonUserDMATest, sync_dma_bypass_) {
     ASSERT_EQ(src_char[i], dst_char[i]);
   }
 }
+
+TEST_F(HexagonUserDMATest, double_buffered_staging) {
+  uint32_t tile_bytes = 0x1000;  // 4KB
+  int num_tiles = length / tile_bytes;
+  for (uint32_t i = 0; i < length; ++i) {
+    src_char[i] = static_cast<char>(i / tile_bytes + 1);
+  }
+
+  std::vector<void*> slots;
+  HexagonDMAStaging staging(user_dma, HexagonDeviceAPI::Global()->VtcmPool(), queue_id,
+                            tile_bytes);
+  staging.Run(src, tile_bytes, num_tiles, [&](int tile, void* vtcm) {
+    ASSERT_TRUE(HexagonDeviceAPI::Global()->VtcmPool()->IsVtcm(vtcm, tile_bytes));
+    slots.push_back(vtcm);
+    memcpy(dst_char + tile * tile_bytes, vtcm, tile_bytes);
+  });
+
+  // tiles alternate between the two slots
+  ASSERT_EQ(slots.size(), static_cast<size_t>(num_tiles));
+  ASSERT_NE(slots[0], slots[1]);
+  ASSERT_EQ(slots[0], slots[2]);
+
+  // verify
+  for (uint32_t i = 0; i < length; ++i) {
+    ASSERT_EQ(src_char[i], dst_char[i]);
+  }
+}
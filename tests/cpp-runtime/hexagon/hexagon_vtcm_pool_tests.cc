@@ -249,6 +249,65 @@ TEST_F(HexagonVtcmPoolTest, find_smallest_allocation_combinations) {
   vtcm_pool->Free(ptr4, max_bytes);
 }
 
+TEST_F(HexagonVtcmPoolTest, small_allocation_in_hole) {
+  void* ptr1 = vtcm_pool->Allocate(two_k_block);
+  void* ptr2 = vtcm_pool->Allocate(two_k_block);
+  void* ptr3 = vtcm_pool->Allocate(max_bytes - 2 * two_k_block);
+
+  // Leave a hole at the start while the end is full
+  vtcm_pool->Free(ptr1, two_k_block);
+
+  // The small allocation goes to the end of the hole
+  void* new_ptr = vtcm_pool->Allocate(one_k_block);
+  CHECK(new_ptr == static_cast<char*>(ptr1) + one_k_block);
+
+  // And the rest of the hole is still usable
+  ptr1 = vtcm_pool->Allocate(one_k_block);
+
+  vtcm_pool->Free(new_ptr, one_k_block);
+  vtcm_pool->Free(ptr1, one_k_block);
+  vtcm_pool->Free(ptr2, two_k_block);
+  vtcm_pool->Free(ptr3, max_bytes - 2 * two_k_block);
+
+  // Make sure at the end we have the full amount available again
+  ptr1 = vtcm_pool->Allocate(max_bytes);
+  vtcm_pool->Free(ptr1, max_bytes);
+}
+
+TEST_F(HexagonVtcmPoolTest, stats) {
+  HexagonVtcmPoolStats before = vtcm_pool->GetStats();
+  EXPECT_EQ(before.total_bytes, max_bytes);
+  EXPECT_EQ(before.allocated_bytes, 0u);
+  EXPECT_EQ(before.free_bytes, max_bytes);
+  EXPECT_EQ(before.fragmentation, 0);
+
+  void* ptr1 = vtcm_pool->Allocate(two_k_block);
+  void* ptr2 = vtcm_pool->Allocate(two_k_block);
+  vtcm_pool->Free(ptr1, two_k_block);
+
+  // The free space is split in two segments
+  HexagonVtcmPoolStats stats = vtcm_pool->GetStats();
+  EXPECT_EQ(stats.allocated_bytes, two_k_block);
+  EXPECT_GE(stats.peak_allocated_bytes, 2 * two_k_block);
+  EXPECT_EQ(stats.free_bytes, max_bytes - two_k_block);
+  EXPECT_EQ(stats.largest_free_bytes, max_bytes - 2 * two_k_block);
+  EXPECT_EQ(stats.num_free_segments, 2u);
+  EXPECT_EQ(stats.num_live_allocations, 1u);
+  EXPECT_EQ(stats.num_allocs - before.num_allocs, 2u);
+  EXPECT_EQ(stats.num_frees - before.num_frees, 1u);
+  EXPECT_GT(stats.fragmentation, 0);
+
+  // There is enough free space, but not in one segment
+  EXPECT_THROW(vtcm_pool->Allocate(max_bytes - two_k_block), InternalError);
+  EXPECT_EQ(vtcm_pool->GetStats().num_alloc_failures - before.num_alloc_failures, 1u);
+
+  vtcm_pool->Free(ptr2, two_k_block);
+  stats = vtcm_pool->GetStats();
+  EXPECT_EQ(stats.allocated_bytes, 0u);
+  EXPECT_EQ(stats.num_free_segments, 1u);
+  EXPECT_EQ(stats.fragmentation, 0);
+}
+
 // Test alignment edge cases allocating through HexagonBuffer
 TEST_F(HexagonVtcmPoolTest, vtcm_alignment) {
   std::unique_ptr<HexagonBufferManager> test_hexbuffs = std::make_unique<HexagonBufferManager>();
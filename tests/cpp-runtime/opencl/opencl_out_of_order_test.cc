@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../src/runtime/opencl/opencl_common.h"
+
+using namespace tvm::runtime;
+using namespace tvm::runtime::cl;
+
+#define BUFF_SIZE 1024
+#define NUM_REPEAT 10
+
+TEST(OpenCLOutOfOrderQueue, ordered_kernels) {
+  OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
+  OpenCLThreadEntry* thr = workspace->GetThreadEntry();
+  Device dev = thr->device;
+  if (!workspace->EnableOutOfOrderQueue(dev, true)) {
+    GTEST_SKIP() << "The device does not support out-of-order queues";
+  }
+
+  auto did = workspace->GetCLDeviceID(dev.device_id);
+  auto context = workspace->contexts[workspace->device_to_platform[did]];
+  const char* source = "__kernel void add_one(__global int* a) { a[get_global_id(0)] += 1; }";
+  cl_int err;
+  cl_program program = clCreateProgramWithSource(context, 1, &source, nullptr, &err);
+  OPENCL_CHECK_ERROR(err);
+  OPENCL_CALL(clBuildProgram(program, 1, &did, nullptr, nullptr, nullptr));
+  cl_kernel kernel = clCreateKernel(program, "add_one", &err);
+  OPENCL_CHECK_ERROR(err);
+
+  std::vector<cl_int> host(BUFF_SIZE, 0);
+  cl_mem buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                                 BUFF_SIZE * sizeof(cl_int), host.data(), &err);
+  OPENCL_CHECK_ERROR(err);
+  OPENCL_CALL(clSetKernelArg(kernel, 0, sizeof(cl_mem), &buffer));
+  size_t global_size = BUFF_SIZE;
+  for (int i = 0; i < NUM_REPEAT; ++i) {
+    // Every kernel reads the result of the previous one, so they must not overlap.
+    workspace->EnqueueOrderedKernel(dev, kernel, 1, &global_size, nullptr, {buffer}, nullptr);
+  }
+  workspace->EnqueueBarrier(dev);
+  OPENCL_CALL(clEnqueueReadBuffer(workspace->GetQueue(dev), buffer, CL_FALSE, 0,
+                                  BUFF_SIZE * sizeof(cl_int), host.data(), 0, nullptr, nullptr));
+  workspace->FinishQueue(dev);
+  for (cl_int value : host) {
+    CHECK_EQ(value, NUM_REPEAT);
+  }
+
+  OPENCL_CALL(clReleaseMemObject(buffer));
+  OPENCL_CALL(clReleaseKernel(kernel));
+  OPENCL_CALL(clReleaseProgram(program));
+  CHECK(!workspace->EnableOutOfOrderQueue(dev, false));
+}
@@ -41,7 +41,7 @@ class PoolWrapper : public Pool2D {
   }
 };
 
-TEST(OpenCLTexturePool, textures_reallocation_optimal_size) {
+TEST(OpenCLTexturePool, textures_allocated_in_size_classes) {
   OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
   OpenCLThreadEntry* t = workspace->GetThreadEntry();
   PoolWrapper pool;
@@ -49,39 +49,83 @@ TEST(OpenCLTexturePool, textures_reallocation_optimal_size) {
   EXPECT_EQ(pool.FreeListSize(), 0);
 
   DLDataType type{kDLFloat, 16, 1};
-  void* data1 = pool.Alloc(t->device, workspace, 1024, 768, type);
+  void* data1 = pool.Alloc(t->device, workspace, 1000, 600, type);
   EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 0);
   auto item = pool.AllocatedListItemSize(0);
   EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 768);
+  EXPECT_EQ(item.second, 640);
+  EXPECT_EQ(pool.GetStats().live_bytes, 1024 * 640 * 4 * 2);
+  EXPECT_EQ(pool.GetStats().waste_bytes, (1024 * 640 - 1000 * 600) * 4 * 2);
+
+  pool.Free(data1);
+  EXPECT_EQ(pool.AllocatedListSize(), 0);
+  EXPECT_EQ(pool.FreeListSize(), 1);
+  EXPECT_EQ(pool.GetStats().live_bytes, 0);
+  EXPECT_EQ(pool.GetStats().cached_bytes, 1024 * 640 * 4 * 2);
 
-  pool.Alloc(t->device, workspace, 64, 12455, type);
-  EXPECT_EQ(pool.AllocatedListSize(), 2);
+  // A request of the same size class reuses the texture.
+  void* data2 = pool.Alloc(t->device, workspace, 1020, 630, type);
+  EXPECT_EQ(data2, data1);
+  EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 0);
-  item = pool.AllocatedListItemSize(1);
-  EXPECT_EQ(item.first, 64);
-  EXPECT_EQ(item.second, 12455);
+  EXPECT_EQ(pool.GetStats().num_allocs, 2);
+  EXPECT_EQ(pool.GetStats().num_reuses, 1);
+  EXPECT_EQ(pool.GetStats().cached_bytes, 0);
+}
+
+TEST(OpenCLTexturePool, reuse_textures_best_fit_by_area) {
+  OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
+  OpenCLThreadEntry* t = workspace->GetThreadEntry();
+  PoolWrapper pool;
 
+  DLDataType type{kDLFloat, 16, 1};
+  void* data1 = pool.Alloc(t->device, workspace, 1024, 1024, type);
+  void* data2 = pool.Alloc(t->device, workspace, 1024, 512, type);
   pool.Free(data1);
-  EXPECT_EQ(pool.AllocatedListSize(), 1);
+  pool.Free(data2);
+  EXPECT_EQ(pool.FreeListSize(), 2);
+
+  void* data3 = pool.Alloc(t->device, workspace, 1000, 500, type);
+  EXPECT_EQ(data3, data2);
   EXPECT_EQ(pool.FreeListSize(), 1);
-  item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 64);
-  EXPECT_EQ(item.second, 12455);
-  item = pool.FreeListItemSize(0);
+  auto item = pool.FreeListItemSize(0);
   EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 768);
+  EXPECT_EQ(item.second, 1024);
 
-  pool.Alloc(t->device, workspace, 768, 1024, type);
-  EXPECT_EQ(pool.AllocatedListSize(), 2);
-  EXPECT_EQ(pool.FreeListSize(), 0);
-  item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 64);
-  EXPECT_EQ(item.second, 12455);
+  // A texture that does not cover the request is not grown.
+  void* data4 = pool.Alloc(t->device, workspace, 2048, 256, type);
+  EXPECT_NE(data4, data1);
+  EXPECT_EQ(pool.FreeListSize(), 1);
   item = pool.AllocatedListItemSize(1);
-  EXPECT_EQ(item.first, 1024);
-  EXPECT_EQ(item.second, 1024);
+  EXPECT_EQ(item.first, 2048);
+  EXPECT_EQ(item.second, 256);
+}
+
+TEST(OpenCLTexturePool, trim_releases_least_recently_freed) {
+  OpenCLWorkspace* workspace = OpenCLWorkspace::Global();
+  OpenCLThreadEntry* t = workspace->GetThreadEntry();
+  PoolWrapper pool;
+
+  DLDataType type{kDLFloat, 16, 1};
+  void* data1 = pool.Alloc(t->device, workspace, 256, 256, type);
+  void* data2 = pool.Alloc(t->device, workspace, 512, 256, type);
+  pool.Free(data1);
+  pool.Free(data2);
+  EXPECT_EQ(pool.FreeListSize(), 2);
+  EXPECT_EQ(pool.GetStats().peak_bytes, (256 + 512) * 256 * 4 * 2);
+
+  pool.Trim(t->device, workspace, 512 * 256 * 4 * 2);
+  EXPECT_EQ(pool.FreeListSize(), 1);
+  auto item = pool.FreeListItemSize(0);
+  EXPECT_EQ(item.first, 512);
+  EXPECT_EQ(item.second, 256);
+  EXPECT_EQ(pool.GetStats().num_evictions, 1);
+  EXPECT_EQ(pool.GetStats().cached_bytes, 512 * 256 * 4 * 2);
+
+  pool.Trim(t->device, workspace, 0);
+  EXPECT_EQ(pool.FreeListSize(), 0);
+  EXPECT_EQ(pool.GetStats().cached_bytes, 0);
 }
 
 TEST(OpenCLTexturePool, avoid_reusing_too_big_textures) {
@@ -96,21 +140,21 @@ TEST(OpenCLTexturePool, avoid_reusing_too_big_textures) {
   EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 0);
   auto item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 12455);
+  EXPECT_EQ(item.first, 13312);
   EXPECT_EQ(item.second, 64);
 
   pool.Free(data1);
   EXPECT_EQ(pool.AllocatedListSize(), 0);
   EXPECT_EQ(pool.FreeListSize(), 1);
   item = pool.FreeListItemSize(0);
-  EXPECT_EQ(item.first, 12455);
+  EXPECT_EQ(item.first, 13312);
   EXPECT_EQ(item.second, 64);
 
   pool.Alloc(t->device, workspace, 1024, 768, type);
   EXPECT_EQ(pool.AllocatedListSize(), 1);
   EXPECT_EQ(pool.FreeListSize(), 1);
   item = pool.FreeListItemSize(0);
-  EXPECT_EQ(item.first, 12455);
+  EXPECT_EQ(item.first, 13312);
   EXPECT_EQ(item.second, 64);
   item = pool.AllocatedListItemSize(0);
   EXPECT_EQ(item.first, 1024);
@@ -146,6 +190,6 @@ TEST(OpenCLTexturePool, avoid_reusing_too_small_textures) {
   EXPECT_EQ(item.first, 1024);
   EXPECT_EQ(item.second, 64);
   item = pool.AllocatedListItemSize(0);
-  EXPECT_EQ(item.first, 12544);
+  EXPECT_EQ(item.first, 13312);
   EXPECT_EQ(item.second, 64);
 }
@@ -95,3 +95,25 @@ TEST(ObjectHierachy, Basic) {
   ICHECK(refB.as<ObjAA>() == nullptr);
   ICHECK(refB.as<ObjB>() != nullptr);
 }
+
+TEST(ObjectPool, Reuse) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+
+  ObjectPtr<ObjA> a = PoolObjAllocator().make_object<ObjA>();
+  const void* addr = a.get();
+  a.reset();
+  // The memory is reused by the next object of the same size class, whatever its type.
+  ObjectRef refB(PoolObjAllocator().make_object<ObjB>());
+  ICHECK_EQ(refB.get(), addr);
+  ICHECK_EQ(refB->type_index(), ObjB::RuntimeTypeIndex());
+  ICHECK(refB.as<ObjB>() != nullptr);
+
+  // Objects larger than the pooled ones use new/delete.
+  struct LargeObj : public ObjBase {
+    char data[ObjectPool::kMaxObjectSize];
+  };
+  static_assert(!ObjectPool::Pooled(sizeof(LargeObj), alignof(LargeObj)));
+  ObjectRef refLarge(PoolObjAllocator().make_object<LargeObj>());
+  ICHECK(refLarge.as<ObjBase>() != nullptr);
+}
@@ -319,3 +319,65 @@ TEST(TypedPackedFunc, RValue) {
     tf(1, true);
   }
 }
+
+TEST(TypedPackedFunc, TypedCall) {
+  using namespace tvm;
+  using namespace tvm::runtime;
+  // A lambda of the same signature up to references is called without packing the arguments.
+  TypedPackedFunc<String(String, const Array<Integer>&)> fconcat(
+      [](const String& prefix, Array<Integer> values) -> String {
+        std::string result = prefix;
+        for (const Integer& value : values) {
+          result += std::to_string(value->value);
+        }
+        return result;
+      });
+  ICHECK_EQ(fconcat("x", {1, 2}), "x12");
+  ICHECK_EQ(fconcat.packed()("y", Array<Integer>({3})).operator String(), "y3");
+
+  // Other lambdas go through the conversions of the packed call.
+  TypedPackedFunc<int64_t(int)> fwiden([](int64_t x) -> int64_t { return x << 32; });
+  ICHECK_EQ(fwiden(1), int64_t(1) << 32);
+  TypedPackedFunc<PrimExpr(int)> fexpr([](PrimExpr x) { return x; });
+  ICHECK(fexpr(1).as<IntImmNode>() != nullptr);
+
+  // The typed call of a PackedFunc obtained from the registry.
+  Registry::Register("test.typed_call.add", true).set_body_typed([](int x, int y) {
+    return x + y;
+  });
+  TypedPackedFunc<int(int, int)> fadd = *Registry::Get("test.typed_call.add");
+  ICHECK_EQ(fadd(1, 2), 3);
+  Registry::Remove("test.typed_call.add");
+}
+
+TEST(PackedFunc, TVMArgsPack) {
+  using namespace tvm;
+  using namespace tvm::runtime;
+  PackedFunc fsum([](TVMArgs args, TVMRetValue* rv) {
+    int64_t sum = 0;
+    for (int i = 0; i < args.size(); ++i) {
+      sum += args[i].operator int64_t();
+    }
+    *rv = sum;
+  });
+  // Arguments on the stack and on the heap.
+  for (int num_args : {0, 2, 8, 9, 32}) {
+    TVMArgsPack<> pack(num_args);
+    for (int i = 0; i < num_args; ++i) {
+      pack.setter()(i, i);
+    }
+    TVMRetValue rv;
+    fsum.CallPacked(pack.args(), &rv);
+    ICHECK_EQ(rv.operator int64_t(), num_args * (num_args - 1) / 2);
+  }
+  // Copy of packed arguments after a leading one.
+  TVMValue values[2];
+  int type_codes[2];
+  PackArgs(values, type_codes, 10, 20);
+  TVMArgsPack<2> pack(3);
+  pack.setter()(0, 1);
+  pack.CopyFrom(TVMArgs(values, type_codes, 2), 1);
+  TVMRetValue rv;
+  fsum.CallPacked(pack.args(), &rv);
+  ICHECK_EQ(rv.operator int64_t(), 31);
+}
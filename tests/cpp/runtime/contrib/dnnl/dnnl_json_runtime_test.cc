@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tests/cpp/runtime/contrib/dnnl/dnnl_json_runtime_test.cc
+ * \brief Tests of the plans of the DNNL JSON runtime for the batch sizes of the runs.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace contrib {
+
+constexpr int64_t kWidth = 256;
+
+/*! \brief The subgraph of relu(x) + x, whose batch size is one in the graph. */
+Module CreateReluAdd() {
+  std::string shape = "\"shape\": [[[1, " + std::to_string(kWidth) + "]]]";
+  std::string attrs = "\"dtype\": [[\"float32\"]], " + shape;
+  std::string graph_json = "{\"nodes\": [";
+  graph_json += "{\"op\": \"input\", \"name\": \"x\", \"attrs\": {" + attrs + "}}, ";
+  graph_json += "{\"op\": \"kernel\", \"name\": \"nn.relu\", \"inputs\": [[0, 0, 0]], ";
+  graph_json += "\"attrs\": {\"num_inputs\": \"1\", \"num_outputs\": \"1\", " + attrs + "}}, ";
+  graph_json += "{\"op\": \"kernel\", \"name\": \"add\", \"inputs\": [[1, 0, 0], [0, 0, 0]], ";
+  graph_json += "\"attrs\": {\"num_inputs\": \"2\", \"num_outputs\": \"1\", " + attrs + "}}], ";
+  graph_json += "\"arg_nodes\": [0], \"heads\": [[2, 0, 0]], \"node_row_ptr\": [0, 1, 2, 3]}";
+  const PackedFunc* create = Registry::Get("runtime.DNNLJSONRuntimeCreate");
+  Module mod = (*create)("dnnl_0", graph_json, Array<String>());
+  mod.GetFunction("__init_dnnl_0")(Array<NDArray>());
+  return mod;
+}
+
+/*! \brief Run the subgraph on a batch, and check the output. */
+void RunReluAdd(const PackedFunc& run, int64_t batch_size) {
+  NDArray x = NDArray::Empty({batch_size, kWidth}, DataType::Float(32), {kDLCPU, 0});
+  NDArray y = NDArray::Empty({batch_size, kWidth}, DataType::Float(32), {kDLCPU, 0});
+  float* x_data = static_cast<float*>(x->data);
+  for (int64_t i = 0; i < batch_size * kWidth; ++i) {
+    x_data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  run(x, y);
+  const float* y_data = static_cast<const float*>(y->data);
+  for (int64_t i = 0; i < batch_size * kWidth; ++i) {
+    ASSERT_FLOAT_EQ(y_data[i], std::max(x_data[i], 0.0f) + x_data[i]);
+  }
+}
+
+TEST(DNNLJSONRuntime, BatchSizes) {
+  if (Registry::Get("runtime.DNNLJSONRuntimeCreate") == nullptr) {
+    GTEST_SKIP() << "Skipping as the DNNL JSON runtime is not enabled.";
+  }
+  Module mod = CreateReluAdd();
+  PackedFunc run = mod.GetFunction("dnnl_0");
+  // The runs of a batch size reuse its plan, also after the runs of the other batch sizes.
+  for (int64_t batch_size : {1, 4, 7, 4, 1, 7}) {
+    RunReluAdd(run, batch_size);
+  }
+  NDArray x = NDArray::Empty({2, kWidth}, DataType::Float(32), {kDLCPU, 0});
+  NDArray y = NDArray::Empty({3, kWidth}, DataType::Float(32), {kDLCPU, 0});
+  EXPECT_THROW(run(x, y), Error);
+  NDArray z = NDArray::Empty({2, kWidth + 1}, DataType::Float(32), {kDLCPU, 0});
+  EXPECT_THROW(run(z, z), Error);
+}
+
+// The overhead of a run against the number of the batch sizes which the runs cycle through, run
+// with --gtest_filter=DNNLJSONRuntime.Benchmark*. Beyond TVM_DNNL_MAX_CACHED_PLANS (8 by
+// default), every run builds its plan.
+TEST(DNNLJSONRuntime, BenchmarkShapeVariety) {
+  if (Registry::Get("runtime.DNNLJSONRuntimeCreate") == nullptr) {
+    GTEST_SKIP() << "Skipping as the DNNL JSON runtime is not enabled.";
+  }
+  constexpr int kRuns = 512;
+  for (int num_shapes : {1, 2, 8, 16}) {
+    Module mod = CreateReluAdd();
+    PackedFunc run = mod.GetFunction("dnnl_0");
+    std::vector<NDArray> inputs, outputs;
+    for (int64_t batch_size = 1; batch_size <= num_shapes; ++batch_size) {
+      inputs.push_back(NDArray::Empty({batch_size, kWidth}, DataType::Float(32), {kDLCPU, 0}));
+      outputs.push_back(NDArray::Empty({batch_size, kWidth}, DataType::Float(32), {kDLCPU, 0}));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRuns; ++i) {
+      run(inputs[i % num_shapes], outputs[i % num_shapes]);
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG(INFO) << num_shapes << " batch sizes: " << seconds / kRuns * 1e6 << " us per run";
+  }
+}
+
+}  // namespace contrib
+}  // namespace runtime
+}  // namespace tvm
@@ -23,6 +23,8 @@
 
 #include <exception>
 
+#include "../../../../src/runtime/memory/bucketed_allocator.h"
+#include "../../../../src/runtime/memory/caching_allocator.h"
 #include "../../../../src/runtime/memory/pooled_allocator.h"
 
 namespace tvm {
@@ -150,6 +152,158 @@ TEST_F(TvmVMMemoryManagerTest, PooledAllocWithShape) {
   }
 }
 
+TEST_F(TvmVMMemoryManagerTest, BucketedSizeClass) {
+  Device dev = {kDLCPU, 0};
+  BucketedAllocator allocator(dev);
+  size_t page_size = BucketedAllocator::kDefaultPageSize;
+  EXPECT_EQ(allocator.SizeClass(1), page_size);
+  EXPECT_EQ(allocator.SizeClass(3 * page_size), 3 * page_size);
+  // Requests that only differ by a few pages fall into the same size class.
+  EXPECT_EQ(allocator.SizeClass(4096000), allocator.SizeClass(4100096));
+  EXPECT_GE(allocator.SizeClass(4096000), 4100096);
+  // The rounding waste is bounded by the number of sub classes.
+  EXPECT_LE(allocator.SizeClass(4096000), 4096000 + 4096000 / 2);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedAllocReuse) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kBucketed);
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  auto buff = allocator->Alloc(dev, 4100096, 64, DataType::Float(32));
+  size_t used = allocator->UsedMemory();
+  EXPECT_GE(used, 4100096);
+  allocator->Free(buff);
+  EXPECT_EQ(allocator->UsedMemory(), used);
+  auto reused = allocator->Alloc(dev, 4096000, 64, DataType::Float(32));
+  EXPECT_EQ(reused.data, buff.data);
+  EXPECT_EQ(allocator->UsedMemory(), used);
+  allocator->Free(reused);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedSplitAndMerge) {
+  Device dev = {kDLCPU, 0};
+  BucketedAllocator allocator(dev, BucketedAllocator::kDefaultPageSize,
+                              BucketedAllocator::kDefaultNumSubClasses, /*num_shards=*/1);
+  size_t page_size = BucketedAllocator::kDefaultPageSize;
+  auto large = allocator.Alloc(dev, 4 * page_size, 64, DataType::Float(32));
+  EXPECT_EQ(allocator.UsedMemory(), 4 * page_size);
+  allocator.Free(large);
+  // A smaller request is carved out of the cached block instead of allocating.
+  auto first = allocator.Alloc(dev, page_size, 64, DataType::Float(32));
+  auto second = allocator.Alloc(dev, page_size, 64, DataType::Float(32));
+  EXPECT_EQ(first.data, large.data);
+  EXPECT_EQ(second.data, static_cast<char*>(large.data) + page_size);
+  EXPECT_EQ(allocator.UsedMemory(), 4 * page_size);
+  allocator.Free(first);
+  allocator.Free(second);
+  // Freed neighbours are merged back, so the whole block is available again.
+  auto again = allocator.Alloc(dev, 4 * page_size, 64, DataType::Float(32));
+  EXPECT_EQ(again.data, large.data);
+  EXPECT_EQ(allocator.UsedMemory(), 4 * page_size);
+  allocator.Free(again);
+  allocator.Clear();
+  EXPECT_EQ(allocator.UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedEmptyBasic) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kBucketed);
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  auto dt = DataType::Float(32);
+  ShapeTuple shape = {1, 3, 6, 6};
+  {
+    auto ndarray = allocator->Empty(shape, dt, dev);
+    EXPECT_EQ(allocator->UsedMemory(), BucketedAllocator::kDefaultPageSize);
+  }
+  EXPECT_EQ(allocator->UsedMemory(), BucketedAllocator::kDefaultPageSize);
+}
+
+TEST_F(TvmVMMemoryManagerTest, CachingAllocReuse) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kCaching);
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  size_t page_size = CachingAllocator::kDefaultPageSize;
+  auto buff = allocator->Alloc(dev, 2 * page_size, 64, DataType::Float(32));
+  EXPECT_EQ(allocator->UsedMemory(), 2 * page_size);
+  allocator->Free(buff);
+  EXPECT_EQ(allocator->UsedMemory(), 2 * page_size);
+  // A slightly smaller request on the same stream reuses the cached buffer.
+  auto reused = allocator->Alloc(dev, page_size + 1, 64, DataType::Float(32));
+  EXPECT_EQ(reused.data, buff.data);
+  EXPECT_EQ(allocator->UsedMemory(), 2 * page_size);
+  allocator->Free(reused);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, CachingHighWaterMark) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = CachingAllocator::kDefaultPageSize;
+  CachingAllocator allocator(page_size, 2 * page_size);
+  auto a = allocator.Alloc(dev, page_size, 64, DataType::Float(32));
+  auto b = allocator.Alloc(dev, page_size, 64, DataType::Float(32));
+  auto c = allocator.Alloc(dev, page_size, 64, DataType::Float(32));
+  EXPECT_EQ(allocator.UsedMemory(), 3 * page_size);
+  // The least recently freed buffer is released once the reservation exceeds the mark.
+  allocator.Free(a);
+  EXPECT_EQ(allocator.UsedMemory(), 2 * page_size);
+  allocator.Free(b);
+  allocator.Free(c);
+  EXPECT_EQ(allocator.UsedMemory(), 2 * page_size);
+  allocator.SetHighWaterMark(page_size);
+  EXPECT_EQ(allocator.UsedMemory(), page_size);
+  allocator.Clear();
+  EXPECT_EQ(allocator.UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PooledStats) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kPooled);
+  size_t page_size = PooledAllocator::kDefaultPageSize;
+  auto buff = allocator->Alloc(dev, 100, 64, DataType::Float(32));
+  AllocatorStats stats = allocator->GetStats();
+  EXPECT_EQ(stats.live_bytes, page_size);
+  EXPECT_EQ(stats.cached_bytes, 0);
+  EXPECT_EQ(stats.rounding_waste_bytes, page_size - 100);
+  EXPECT_EQ(stats.num_allocs, 1);
+  EXPECT_EQ(stats.num_cache_hits, 0);
+  allocator->Free(buff);
+  stats = allocator->GetStats();
+  EXPECT_EQ(stats.live_bytes, 0);
+  EXPECT_EQ(stats.cached_bytes, page_size);
+  EXPECT_EQ(stats.rounding_waste_bytes, 0);
+  EXPECT_EQ(stats.largest_free_block, page_size);
+  EXPECT_EQ(stats.num_frees, 1);
+  buff = allocator->Alloc(dev, 200, 64, DataType::Float(32));
+  stats = allocator->GetStats();
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.peak_bytes, page_size);
+  allocator->Free(buff);
+
+  std::string json = MemoryManager::GetStatsJSON();
+  EXPECT_NE(json.find("\"num_cache_hits\": 1"), std::string::npos) << json;
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedStats) {
+  Device dev = {kDLCPU, 0};
+  BucketedAllocator allocator(dev);
+  size_t page_size = BucketedAllocator::kDefaultPageSize;
+  auto buff = allocator.Alloc(dev, 3 * page_size, 64, DataType::Float(32));
+  allocator.Free(buff);
+  buff = allocator.Alloc(dev, page_size - 1, 64, DataType::Float(32));
+  AllocatorStats stats = allocator.GetStats();
+  EXPECT_EQ(stats.live_bytes, page_size);
+  EXPECT_EQ(stats.cached_bytes, 2 * page_size);
+  EXPECT_EQ(stats.largest_free_block, 2 * page_size);
+  EXPECT_EQ(stats.rounding_waste_bytes, 1);
+  EXPECT_EQ(stats.peak_bytes, 3 * page_size);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  allocator.Free(buff);
+}
+
 TEST_F(TvmVMMemoryManagerTest, NaiveAllocOpenCLTexture) {
   bool enabled = tvm::runtime::RuntimeEnabled("opencl");
   if (!enabled) {
@@ -0,0 +1,184 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../../src/support/mpmc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace support {
+namespace {
+
+TEST(MPMCQueue, PushPop) {
+  MPMCQueue<int> queue(3);
+  ASSERT_TRUE(queue.Empty());
+  ASSERT_TRUE(queue.TryPush(1));
+  ASSERT_TRUE(queue.TryPush(2));
+  ASSERT_TRUE(queue.TryPush(3));
+  ASSERT_TRUE(queue.Full());
+  ASSERT_FALSE(queue.TryPush(4));
+  ASSERT_EQ(queue.Size(), 3);
+
+  // The queue keeps the order of the elements across the laps of the ring.
+  for (int i = 1; i <= 10; ++i) {
+    int value = 0;
+    ASSERT_TRUE(queue.TryPop(&value));
+    ASSERT_EQ(value, i);
+    ASSERT_TRUE(queue.TryPush(i + 3));
+  }
+  ASSERT_EQ(queue.Size(), 3);
+}
+
+TEST(MPMCQueue, MoveOnlyUse) {
+  MPMCQueue<std::string> queue(2);
+  std::string message(100, 'x');
+  ASSERT_TRUE(queue.Push(std::move(message)));
+  std::string output;
+  ASSERT_TRUE(queue.Pop(&output));
+  ASSERT_EQ(output, std::string(100, 'x'));
+  ASSERT_FALSE(queue.TryPop(&output));
+}
+
+TEST(MPMCQueue, CloseWakesWaiters) {
+  MPMCQueue<int> queue(1);
+  bool popped = true;
+  std::thread consumer([&]() {
+    int value;
+    popped = queue.Pop(&value, /*spin_count=*/0);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.Close();
+  consumer.join();
+  ASSERT_FALSE(popped);
+  ASSERT_FALSE(queue.Push(1));
+}
+
+TEST(MPMCQueue, BlockingProducer) {
+  MPMCQueue<int> queue(1);
+  ASSERT_TRUE(queue.Push(0));
+  std::thread producer([&]() { ASSERT_TRUE(queue.Push(1, /*spin_count=*/0)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  int value = -1;
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 0);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 1);
+  producer.join();
+}
+
+/*!
+ * \brief Run producers and consumers over a queue, checking that every element is popped once.
+ * \return The elements popped per second.
+ */
+double RunContention(size_t capacity, int num_producers, int num_consumers, int per_producer,
+                     uint32_t spin_count) {
+  MPMCQueue<int64_t> queue(capacity);
+  std::vector<std::vector<int64_t>> popped(num_consumers);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int p = 0; p < num_producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        EXPECT_TRUE(queue.Push(static_cast<int64_t>(p) * per_producer + i, spin_count));
+      }
+    });
+  }
+  int total = num_producers * per_producer;
+  std::atomic<int> remaining{total};
+  for (int c = 0; c < num_consumers; ++c) {
+    threads.emplace_back([&, c]() {
+      int64_t value;
+      while (remaining.fetch_sub(1) > 0) {
+        EXPECT_TRUE(queue.Pop(&value, spin_count));
+        popped[c].push_back(value);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::vector<int64_t> all;
+  for (auto& values : popped) {
+    // The elements of one producer come out of a consumer in the order they are pushed.
+    all.insert(all.end(), values.begin(), values.end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(all.size(), static_cast<size_t>(total));
+  for (int i = 0; i < static_cast<int>(all.size()); ++i) {
+    EXPECT_EQ(all[i], i);
+  }
+  return total / seconds;
+}
+
+TEST(MPMCQueue, Contention) {
+  RunContention(/*capacity=*/4, /*num_producers=*/4, /*num_consumers=*/4, 20000,
+                /*spin_count=*/16);
+  // Without spinning, every wait parks the thread.
+  RunContention(/*capacity=*/1, /*num_producers=*/2, /*num_consumers=*/2, 2000,
+                /*spin_count=*/0);
+}
+
+// The microbenchmark of the queue, run with --gtest_filter=MPMCQueue.Benchmark*.
+TEST(MPMCQueue, BenchmarkThroughput) {
+  for (int threads : {1, 2, 4}) {
+    double throughput = RunContention(/*capacity=*/1024, threads, threads, 100000,
+                                      MPMCQueue<int64_t>::kDefaultSpinCount);
+    LOG(INFO) << threads << " producers x " << threads
+              << " consumers: " << static_cast<int64_t>(throughput) << " elements/s";
+    ASSERT_GT(throughput, 0);
+  }
+}
+
+TEST(MPMCQueue, BenchmarkLatency) {
+  // Ping-pong one element between two threads, which parks them between the messages.
+  for (uint32_t spin_count : {0u, MPMCQueue<int>::kDefaultSpinCount}) {
+    MPMCQueue<int> ping(1), pong(1);
+    constexpr int kRounds = 10000;
+    std::thread echo([&]() {
+      int value;
+      for (int i = 0; i < kRounds; ++i) {
+        ASSERT_TRUE(ping.Pop(&value, spin_count));
+        ASSERT_TRUE(pong.Push(value, spin_count));
+      }
+    });
+    auto start = std::chrono::steady_clock::now();
+    int value;
+    for (int i = 0; i < kRounds; ++i) {
+      ASSERT_TRUE(ping.Push(i, spin_count));
+      ASSERT_TRUE(pong.Pop(&value, spin_count));
+      ASSERT_EQ(value, i);
+    }
+    echo.join();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                    .count();
+    LOG(INFO) << "spin_count " << spin_count << ": " << us / kRounds / 2
+              << " us per enqueue and dequeue";
+  }
+}
+
+}  // namespace
+}  // namespace support
+}  // namespace tvm
@@ -23,6 +23,7 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <sstream>
 #include <thread>
@@ -194,3 +195,57 @@ TEST(ThreadingBackend, TVMBackendParallelForWithThreadingBackend) {
     EXPECT_EQ(vec[i], i);
   }
 }
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  // Run on a fresh thread so that the configuration only affects its thread pool.
+  std::thread t([]() {
+    tvm::runtime::threading::SetWorkStealing(/*chunks_per_worker=*/4);
+    for (int i = 0; i < 3; ++i) {
+      std::atomic<size_t> acc(0);
+      TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+    tvm::runtime::threading::SetWorkStealing(0);
+    std::atomic<size_t> acc(0);
+    TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  });
+  t.join();
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWaitPolicy) {
+  // Run on a fresh thread so that the configuration only affects its thread pool.
+  std::thread t([]() {
+    tvm::runtime::threading::SetWaitPolicy(tvm::runtime::threading::kAdaptiveSpin);
+    for (int i = 0; i < 8; ++i) {
+      std::atomic<size_t> acc(0);
+      TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+      // Alternate short and long gaps between the launches.
+      std::this_thread::sleep_for(std::chrono::milliseconds(i % 2 ? 5 : 0));
+    }
+    // The workers that sleep are woken up and spin until the launch.
+    tvm::runtime::threading::KeepWarm(/*milliseconds=*/50);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::atomic<size_t> acc(0);
+    TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    tvm::runtime::threading::SetWaitPolicy(tvm::runtime::threading::kFixedSpin);
+  });
+  t.join();
+}
+
+TEST(ThreadingBackend, NumaTopology) {
+  const auto& nodes = tvm::runtime::threading::NumaNodeCpus();
+  ASSERT_FALSE(nodes.empty());
+  std::unordered_set<unsigned int> cpus;
+  for (const auto& node : nodes) {
+    for (unsigned int cpu : node) {
+      // Every CPU belongs to exactly one node.
+      EXPECT_TRUE(cpus.insert(cpu).second);
+    }
+  }
+  int node = tvm::runtime::threading::CurrentNumaNode();
+  EXPECT_GE(node, 0);
+  EXPECT_LT(node, static_cast<int>(nodes.size()));
+}
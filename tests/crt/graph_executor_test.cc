@@ -112,4 +112,59 @@ TEST(TVMGraphExecutor_Load, Parse) {
   EXPECT_EQ(executor.nodes_count, 3);
 }
 
+TVMGraphExecutor* LoadWithArena(const TVMGraphExecutorArena* arena) {
+  JSONReader reader;
+  EXPECT_EQ(JSONReader_Create(kJson, &reader), kTvmErrorNoError);
+  TVMGraphExecutor* executor = static_cast<TVMGraphExecutor*>(calloc(1, sizeof(TVMGraphExecutor)));
+  EXPECT_EQ(TVMGraphExecutor_Load(executor, &reader), 0);
+  EXPECT_EQ(JSONReader_Release(&reader), kTvmErrorNoError);
+  executor->devices[0] = {kDLCPU, 0};
+  executor->arena = *arena;
+  return executor;
+}
+
+// Check the storage entries are placed at the given offsets of the arena.
+TEST(TVMGraphExecutor_Arena, Offsets) {
+  alignas(16) uint8_t data[448];
+  const uint32_t offsets[] = {240, 0, 32};
+  TVMGraphExecutorArena arena = {data, sizeof(data), offsets, 3};
+  TVMGraphExecutor* executor = LoadWithArena(&arena);
+  ASSERT_EQ(TVMGraphExecutor_SetupStorage(executor), 0);
+  ASSERT_EQ(executor->storage_pool_count, 3);
+  for (uint32_t sid = 0; sid < 3; ++sid) {
+    EXPECT_EQ(executor->storage_pool[sid].is_in_arena, 1);
+    EXPECT_EQ(executor->storage_pool[sid].array.dl_tensor.data, data + offsets[sid]);
+  }
+  EXPECT_EQ(executor->data_entry[2].dl_tensor.data, data + 32);
+  EXPECT_EQ(TVMGraphExecutor_Release(&executor), 0);
+}
+
+// Check the storage entries are packed in storage id order without an offset table.
+TEST(TVMGraphExecutor_Arena, Packed) {
+  alignas(16) uint8_t data[448];
+  TVMGraphExecutorArena arena = {data, sizeof(data), nullptr, 0};
+  TVMGraphExecutor* executor = LoadWithArena(&arena);
+  ASSERT_EQ(TVMGraphExecutor_SetupStorage(executor), 0);
+  EXPECT_EQ(executor->data_entry[0].dl_tensor.data, data);
+  EXPECT_EQ(executor->data_entry[1].dl_tensor.data, data + 208);
+  EXPECT_EQ(executor->data_entry[2].dl_tensor.data, data + 240);
+  EXPECT_EQ(TVMGraphExecutor_Release(&executor), 0);
+}
+
+// Check a layout overflowing the arena or misaligned is rejected.
+TEST(TVMGraphExecutor_Arena, Invalid) {
+  alignas(16) uint8_t data[448];
+  const uint32_t overflow[] = {0, 208, 256};
+  TVMGraphExecutorArena arena = {data, sizeof(data), overflow, 3};
+  TVMGraphExecutor* executor = LoadWithArena(&arena);
+  EXPECT_NE(TVMGraphExecutor_SetupStorage(executor), 0);
+  EXPECT_EQ(TVMGraphExecutor_Release(&executor), 0);
+
+  const uint32_t misaligned[] = {0, 200, 240};
+  arena.offsets = misaligned;
+  executor = LoadWithArena(&arena);
+  EXPECT_NE(TVMGraphExecutor_SetupStorage(executor), 0);
+  EXPECT_EQ(TVMGraphExecutor_Release(&executor), 0);
+}
+
 }  // namespace
@@ -69,6 +69,21 @@ def test_memory_usage(target, dev, dtype):
     assert dev.available_global_memory == available_memory_before
 
 
+@tvm.testing.requires_cuda
+def test_peer_copy():
+    if not tvm.cuda(1).exist:
+        pytest.skip(reason="The peer copy needs two CUDA devices")
+    topology = tvm.cuda(0).peer_topology
+    assert 1 in [peer["device_id"] for peer in topology]
+    assert all(peer["link"] in ["nvlink", "pcie", "none"] for peer in topology)
+
+    x = np.random.rand(1024, 1024).astype("float32")
+    y = tvm.nd.array(x, device=tvm.cuda(0)).copyto(tvm.cuda(1))
+    z = y.copyto(tvm.cuda(0))
+    np.testing.assert_equal(y.numpy(), x)
+    np.testing.assert_equal(z.numpy(), x)
+
+
 def test_fp16_conversion():
     n = 100
 
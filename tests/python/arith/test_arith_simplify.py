@@ -102,5 +102,43 @@ def test_regression_simplify_inf_recursion():
     ana.rewrite_simplify(res)
 
 
+def test_simplify_cache():
+    ana = tvm.arith.Analyzer()
+    ana.enable_simplify_cache()
+    x = tir.Var("x", "int32")
+    ana.bind(x, tvm.ir.Range(0, 16))
+    expr = tvm.te.min(x, 10) + 0
+
+    tvm.ir.assert_structural_equal(ana.simplify(expr), tvm.te.min(x, 10))
+    tvm.ir.assert_structural_equal(ana.simplify(tvm.te.min(x, 10) + 0), tvm.te.min(x, 10))
+    assert int(ana.simplify_cache_stats["hits"]) == 1
+    assert int(ana.simplify_cache_stats["misses"]) == 1
+
+    # The results within a constraint scope are not shared with the enclosing scope
+    with ana.constraint_scope(x < 5):
+        tvm.ir.assert_structural_equal(ana.simplify(expr), x)
+        tvm.ir.assert_structural_equal(ana.simplify(expr), x)
+    tvm.ir.assert_structural_equal(ana.simplify(expr), tvm.te.min(x, 10))
+    assert int(ana.simplify_cache_stats["hits"]) == 3
+    assert int(ana.simplify_cache_stats["misses"]) == 2
+
+    # Binding a variable invalidates the results
+    y = tir.Var("y", "int32")
+    ana.bind(y, 3)
+    tvm.ir.assert_structural_equal(ana.simplify(expr), tvm.te.min(x, 10))
+    assert int(ana.simplify_cache_stats["misses"]) == 3
+
+
+def test_simplify_cache_pass_config():
+    tvm.arith.reset_simplify_cache_stats()
+    with tvm.transform.PassContext(config={"arith.enable_simplify_cache": True}):
+        ana = tvm.arith.Analyzer()
+    x = tir.Var("x", "int32")
+    for _ in range(3):
+        ana.simplify(x * 2 + x)
+    assert int(ana.simplify_cache_stats["hits"]) == 2
+    assert tvm.arith.simplify_cache_stats() == {"hits": 2, "misses": 1}
+
+
 if __name__ == "__main__":
     tvm.testing.main()
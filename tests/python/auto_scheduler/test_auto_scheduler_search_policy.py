@@ -209,6 +209,32 @@ def test_sketch_search_policy_custom_sketch():
     )
 
 
+@tvm.testing.requires_llvm
+def test_sketch_search_policy_similar_task():
+    auto_scheduler.search_policy.clear_similar_task_state_cache()
+    # The measured states of this task are shared with the tasks of the same structure
+    search_common(num_measure_trials=4)
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(128, 32, 48), target="llvm"
+    )
+    policy = auto_scheduler.SketchPolicy(task, verbose=0)
+    states = policy.sample_similar_task_states(4)
+    assert len(states) > 0
+
+    sch, args = task.compute_dag.apply_steps_from_state(task.compute_dag.init_state)
+    mod_ref = tvm.build(sch, args, "llvm")
+    np_arrays = [np.random.uniform(size=get_const_tuple(x.shape)).astype(x.dtype) for x in args]
+    expected = [tvm.nd.array(x) for x in np_arrays]
+    mod_ref(*expected)
+    for state in states:
+        sch, args = task.compute_dag.apply_steps_from_state(state)
+        mod = tvm.build(sch, args, "llvm")
+        actual = [tvm.nd.array(x) for x in np_arrays]
+        mod(*actual)
+        tvm.testing.assert_allclose(actual[-1].numpy(), expected[-1].numpy(), rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_workload_registry_empty_policy()
     test_sketch_search_policy_basic()
@@ -218,3 +244,4 @@ if __name__ == "__main__":
     test_sketch_search_policy_cuda_xgbmodel_rpc_runner()
     test_sketch_search_policy_zero_rank()
     test_sketch_search_policy_custom_sketch()
+    test_sketch_search_policy_similar_task()
@@ -266,5 +266,34 @@ def test_subroutine_call():
     ), "Expected three occurrences, for forward-declaration, definition, and call from main."
 
 
+def test_restrict_aligned_vectorized():
+    @T.prim_func
+    def func(A: T.Buffer((64, 16), "float32"), B: T.Buffer((64, 16), "float32")):
+        T.func_attr({"global_symbol": "add_one", "tir.noalias": True})
+        for i in range(64):
+            for j in T.vectorized(16):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+    # The C host does not vectorize, but hints the vectorized loops to the C compiler.
+    with tvm.transform.PassContext(config={"tir.disable_vectorize": True}):
+        built = tvm.build(func, target="c")
+    source = built.get_source()
+    assert source.count("TVM_RESTRICT A =") == 1
+    assert source.count("TVM_RESTRICT B =") == 1
+    assert "A = TVM_ASSUME_ALIGNED(A, 64);" in source
+    assert source.count("  TVM_VECTORIZE_LOOP\n") == 1
+
+    temp = utils.tempdir()
+    path_dso = temp.relpath("temp.so")
+    built.export_library(path_dso)
+    m = tvm.runtime.load_module(path_dso)
+    a = tvm.nd.array(np.random.uniform(size=(64, 16)).astype("float32"))
+    b = tvm.nd.array(np.zeros((64, 16), dtype="float32"))
+    m["add_one"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -22,7 +22,7 @@ import tvm
 from tvm import te
 import numpy as np
 from tvm import topi
-from tvm.contrib.nvcc import have_fp16, have_int8, have_bf16
+from tvm.contrib.nvcc import get_fatbin_arch, have_fp16, have_int8, have_bf16
 from tvm.contrib import utils
 from tvm.script import tir as T
 import tvm.testing
@@ -1069,6 +1069,61 @@ def test_cuda_save_kernels_for_profiling():
     check_cuda(64, 2)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_cuda_kernel_cache():
+    @T.prim_func
+    def add_one(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+        for bx in T.thread_binding(8, "blockIdx.x"):
+            for tx in T.thread_binding(8, "threadIdx.x"):
+                B[bx * 8 + tx] = A[bx * 8 + tx] + T.float32(1)
+
+    dev = tvm.cuda(0)
+    tmp_path = str(utils.tempdir().path)
+    a = tvm.nd.array(np.random.rand(64).astype("float32"), dev)
+    mtimes = []
+    for _ in range(2):
+        with tvm.transform.PassContext(config={"target.kernel_cache_dir": tmp_path}):
+            f = tvm.build(add_one, target="cuda")
+        (cache_file,) = os.listdir(tmp_path)
+        mtimes.append(os.path.getmtime(os.path.join(tmp_path, cache_file)))
+        b = tvm.nd.empty((64,), "float32", dev)
+        f(a, b)
+        np.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+    # The second build loads the kernel from the cache instead of writing it again
+    assert mtimes[0] == mtimes[1]
+
+
+def test_cuda_fatbin_arch():
+    assert get_fatbin_arch(["sm_90", "sm_80"]) == [
+        "-gencode",
+        "arch=compute_80,code=sm_80",
+        "-gencode",
+        "arch=compute_90,code=sm_90",
+        "-gencode",
+        "arch=compute_90,code=compute_90",
+    ]
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_cuda_fatbin_archs():
+    @T.prim_func
+    def add_one(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+        for bx in T.thread_binding(8, "blockIdx.x"):
+            for tx in T.thread_binding(8, "threadIdx.x"):
+                B[bx * 8 + tx] = A[bx * 8 + tx] + T.float32(1)
+
+    dev = tvm.cuda(0)
+    arch = "sm_" + dev.compute_version.replace(".", "")
+    with tvm.transform.PassContext(config={"cuda.fatbin_archs": ["sm_70", arch]}):
+        f = tvm.build(add_one, target="cuda")
+    a = tvm.nd.array(np.random.rand(64).astype("float32"), dev)
+    b = tvm.nd.empty((64,), "float32", dev)
+    f(a, b)
+    np.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_cuda_thread_sync_inside_condition():
@@ -288,6 +288,72 @@ def test_multiple_func():
     check_llvm()
 
 
+@tvm.testing.requires_llvm
+def test_llvm_parallel_codegen():
+    n = 1024
+    funcs = []
+    for i in range(6):
+        A = te.placeholder((n,), name="A")
+        B = te.placeholder((n,), name="B")
+        C = te.compute(A.shape, lambda j: A[j] * (i + 1) + B[j], name="C")
+        s = te.create_schedule(C.op)
+        xo, xi = s[C].split(C.op.axis[0], factor=4)
+        s[C].parallel(xo)
+        s[C].vectorize(xi)
+        funcs.append(tvm.lower(s, [A, B, C], name="fmuladd%d" % i))
+    with tvm.transform.PassContext(config={"target.llvm_codegen_partitions": 4}):
+        m = tvm.build(funcs, "llvm")
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    m.export_library(path)
+    loaded = tvm.runtime.load_module(path)
+
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float32"), dev)
+    b = tvm.nd.array(np.random.uniform(size=n).astype("float32"), dev)
+    for mod in [m, loaded]:
+        for i in range(6):
+            c = tvm.nd.array(np.zeros(n, dtype="float32"), dev)
+            mod["fmuladd%d" % i](a, b, c)
+            tvm.testing.assert_allclose(c.numpy(), a.numpy() * (i + 1) + b.numpy(), rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("jit", ["mcjit", "orcjit", "orcjit-lazy"])
+def test_llvm_jit_object_cache(jit, tmp_path):
+    """The objects compiled by the JIT engines are saved to the kernel cache directory"""
+    get_cache_dir = tvm.get_global_func("runtime.GetKernelCacheDir")
+    set_cache_dir = tvm.get_global_func("runtime.SetKernelCacheDir")
+    n = 64
+    funcs = []
+    for i in range(2):
+        A = te.placeholder((n,), name="A")
+        B = te.compute(A.shape, lambda j: A[j] * (i + 2), name="B")
+        funcs.append(tvm.lower(te.create_schedule(B.op), [A, B], name="fmul%d" % i))
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float32"))
+
+    def run():
+        m = tvm.build(funcs, "llvm -jit=" + jit)
+        for i in range(2):
+            b = tvm.nd.empty((n,), "float32")
+            m["fmul%d" % i](a, b)
+            tvm.testing.assert_allclose(b.numpy(), a.numpy() * (i + 2), rtol=1e-6)
+
+    old_cache_dir = get_cache_dir()
+    set_cache_dir(str(tmp_path))
+    try:
+        run()
+        cached = sorted(tmp_path.glob("*.bin"))
+        assert len(cached) > 0
+        mtimes = [path.stat().st_mtime for path in cached]
+        # The second JIT loads the objects from the cache instead of writing them again
+        run()
+        assert sorted(tmp_path.glob("*.bin")) == cached
+        assert [path.stat().st_mtime for path in cached] == mtimes
+    finally:
+        set_cache_dir(old_cache_dir)
+
+
 @tvm.testing.requires_llvm
 def test_llvm_condition():
     def check_llvm(n, offset):
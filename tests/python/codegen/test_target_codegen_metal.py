@@ -20,6 +20,7 @@ import tvm
 import tvm.script
 import tvm.testing
 from tvm import te
+from tvm._ffi.base import _LIB, check_call
 from tvm.script import tir as T
 
 
@@ -169,6 +170,46 @@ def test_vectorized_uint8():
     np.testing.assert_allclose(b_nd.numpy(), a.astype("float32"), atol=1e-5, rtol=1e-5)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_metal
+def test_batched_launches():
+    @T.prim_func
+    def add_one(A: T.Buffer((16), "float32"), B: T.Buffer((16), "float32"), x: T.float32):
+        for i in T.thread_binding(16, thread="threadIdx.x"):
+            with T.block("block"):
+                vi = T.axis.spatial(16, i)
+                B[vi] = A[vi] + x
+
+    dev = tvm.metal()
+    f = tvm.build(add_one, target="metal")
+    a = np.zeros(16, "float32")
+    bufs = [tvm.nd.array(a, dev), tvm.nd.empty((16,), "float32", dev)]
+    # more launches than fit in one command buffer, each reading the result of the previous one.
+    num_launches = 200
+    for i in range(num_launches):
+        f(bufs[i % 2], bufs[(i + 1) % 2], 1.0)
+    np.testing.assert_allclose(bufs[num_launches % 2].numpy(), a + num_launches)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_metal
+def test_async_copy_on_stream():
+    dev = tvm.metal()
+    stream = dev.create_raw_stream()
+    try:
+        a = np.random.uniform(size=(1024,)).astype("float32")
+        a_nd = tvm.nd.empty(a.shape, "float32", dev)
+        b_nd = tvm.nd.empty(a.shape, "float32", dev)
+        c_nd = tvm.nd.empty(a.shape, "float32", tvm.cpu())
+        # the copies are only finished by the sync of their stream.
+        for src, dst in [(tvm.nd.array(a), a_nd), (a_nd, b_nd), (b_nd, c_nd)]:
+            check_call(_LIB.TVMArrayCopyFromTo(src.handle, dst.handle, stream))
+        dev.sync(stream)
+        np.testing.assert_equal(c_nd.numpy(), a)
+    finally:
+        dev.free_raw_stream(stream)
+
+
 @tvm.testing.requires_metal(support_required="compile-only")
 def test_func_with_trailing_pod_params():
     from tvm.contrib import xcode  # pylint: disable=import-outside-toplevel
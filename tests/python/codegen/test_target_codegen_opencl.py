@@ -219,6 +219,39 @@ def test_opencl_ceil_log2(target):
     _check(target, 32, "float32")
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_opencl
+def test_opencl_kernel_cache(tmp_path):
+    get_cache_dir = tvm.get_global_func("runtime.GetKernelCacheDir")
+    set_cache_dir = tvm.get_global_func("runtime.SetKernelCacheDir")
+    dev = tvm.device(target, 0)
+    n = 64
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    s[B].bind(B.op.axis[0], te.thread_axis("threadIdx.x"))
+    a_np = np.random.uniform(size=(n,)).astype(A.dtype)
+
+    def run():
+        fun = tvm.build(s, [A, B], target)
+        a = tvm.nd.array(a_np, dev)
+        b = tvm.nd.empty((n,), B.dtype, dev)
+        fun(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np + 1)
+
+    old_cache_dir = get_cache_dir()
+    set_cache_dir(str(tmp_path))
+    try:
+        run()
+        entries = list(tmp_path.glob("*.bin"))
+        assert len(entries) == 1
+        # The second build loads the program binary from the cache.
+        run()
+        assert list(tmp_path.glob("*.bin")) == entries
+    finally:
+        set_cache_dir(old_cache_dir)
+
+
 def _get_maximum_kernel_args(source):
     def get_kernel_args(source):
         import re
@@ -177,6 +177,67 @@ def test_vulkan_stress(target, dev):
     run_stress()
 
 
+@tvm.testing.parametrize_targets("vulkan")
+def test_vulkan_streams(target, dev):
+    """Kernels and copies on a stream created with create_raw_stream"""
+    n = 1024
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=64)
+    s[B].bind(xo, te.thread_axis("blockIdx.x"))
+    s[B].bind(xi, te.thread_axis("threadIdx.x"))
+    func = tvm.build(s, [A, B], target)
+
+    a_np = np.random.uniform(size=(n,)).astype(A.dtype)
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.empty((n,), B.dtype, dev)
+    c = tvm.nd.empty((n,), B.dtype, dev)
+
+    stream = dev.create_raw_stream()
+    try:
+        dev.set_raw_stream(stream)
+        func(a, b)
+        func(b, c)
+        dev.sync(stream)
+    finally:
+        dev.set_raw_stream(None)
+        dev.free_raw_stream(stream)
+
+    tvm.testing.assert_allclose(b.numpy(), a_np + 1)
+    tvm.testing.assert_allclose(c.numpy(), a_np + 2)
+
+
+@tvm.testing.parametrize_targets("vulkan")
+def test_vulkan_pipeline_cache(target, dev, tmp_path):
+    """The pipeline cache is saved to the kernel cache directory"""
+    get_cache_dir = tvm.get_global_func("runtime.GetKernelCacheDir")
+    set_cache_dir = tvm.get_global_func("runtime.SetKernelCacheDir")
+    n = 64
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    s[B].bind(B.op.axis[0], te.thread_axis("threadIdx.x"))
+    a_np = np.random.uniform(size=(n,)).astype(A.dtype)
+
+    def run():
+        func = tvm.build(s, [A, B], target)
+        a = tvm.nd.array(a_np, dev)
+        b = tvm.nd.empty((n,), B.dtype, dev)
+        func(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np + 1)
+        # Releasing the module saves the pipeline cache.
+
+    old_cache_dir = get_cache_dir()
+    set_cache_dir(str(tmp_path))
+    try:
+        run()
+        assert len(list(tmp_path.glob("*.bin"))) == 1
+        run()
+    finally:
+        set_cache_dir(old_cache_dir)
+
+
 @tvm.testing.exclude_targets("llvm")
 def test_vulkan_bool_load(target, dev):
     arr_size = 1024
@@ -0,0 +1,73 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import platform
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.contrib import cpu_dispatch, utils
+from tvm.script import tir as T
+
+TARGETS = ["llvm", "llvm -mcpu=haswell", "llvm -mcpu=skylake-avx512", "llvm -mcpu=sapphirerapids"]
+
+
+@T.prim_func
+def add_one(A: T.Buffer((1024,), "float32"), B: T.Buffer((1024,), "float32")):
+    T.func_attr({"global_symbol": "add_one", "tir.noalias": True})
+    for i in T.vectorized(1024):
+        with T.block("B"):
+            vi = T.axis.spatial(1024, i)
+            B[vi] = A[vi] + T.float32(1)
+
+
+def _check(mod):
+    a = tvm.nd.array(np.random.uniform(size=1024).astype("float32"))
+    b = tvm.nd.empty((1024,), "float32")
+    mod["add_one"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(platform.machine() not in ["x86_64", "AMD64"], reason="x86 only")
+def test_cpu_dispatch():
+    mod = cpu_dispatch.build(add_one, TARGETS)
+    # The selected variant is the one requiring the most features which the host has.
+    host = cpu_dispatch.host_features()
+    supported = [cpu_dispatch.required_features(target) for target in TARGETS]
+    supported = sorted(
+        (features for features in supported if set(features) <= host), key=lambda f: -len(f)
+    )
+    variants = sorted(
+        (cpu_dispatch.required_features(target) for target in TARGETS), key=lambda f: -len(f)
+    )
+    selected = cpu_dispatch.selected_variant(mod)
+    assert variants[selected] == supported[0]
+    _check(mod)
+
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    mod.export_library(path)
+    loaded = tvm.runtime.load_module(path)
+    assert loaded.type_key == "cpu_dispatch"
+    assert cpu_dispatch.selected_variant(loaded) == selected
+    _check(loaded)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
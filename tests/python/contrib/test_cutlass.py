@@ -1129,7 +1129,11 @@ def verify_group_gemm(
         return a_np, b_np, indptr_np, c_np
 
     def to_numpy_dtype(dtype):
-        mapping = {"e5m2_float8": ml_dtypes.float8_e5m2, "e4m3_float8": ml_dtypes.float8_e4m3fn}
+        mapping = {
+            "e5m2_float8": ml_dtypes.float8_e5m2,
+            "e4m3_float8": ml_dtypes.float8_e4m3fn,
+            "bfloat16": ml_dtypes.bfloat16,
+        }
         return mapping.get(dtype, dtype)
 
     a_np, b_np, indptr_np, c_np = get_ref_data()
@@ -1144,7 +1148,7 @@ def verify_group_gemm(
         group_gemm_func(a_nd, b_nd, indptr_nd, workspace, scale, c_nd)
     else:
         group_gemm_func(a_nd, b_nd, indptr_nd, workspace, c_nd)
-    tvm.testing.assert_allclose(c_nd.asnumpy(), c_np, rtol=rtol, atol=atol)
+    tvm.testing.assert_allclose(c_nd.asnumpy().astype("float32"), c_np, rtol=rtol, atol=atol)
 
 
 @tvm.testing.requires_cutlass
@@ -1203,5 +1207,35 @@ def test_group_gemm_sm90():
     )
 
 
+@tvm.testing.requires_cutlass
+def test_group_gemm_sm80():
+    verify_group_gemm(
+        "cutlass.group_gemm_fp16_sm80",
+        16,
+        128,
+        128,
+        4,
+        "float16",
+        "float16",
+        "float16",
+        False,
+        rtol=1e-3,
+        atol=1e-3,
+    )
+    verify_group_gemm(
+        "cutlass.group_gemm_bf16_sm80",
+        16,
+        128,
+        128,
+        4,
+        "bfloat16",
+        "bfloat16",
+        "bfloat16",
+        False,
+        rtol=1e-2,
+        atol=1e-1,
+    )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
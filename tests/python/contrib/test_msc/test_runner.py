@@ -140,6 +140,40 @@ def test_tensorrt_runner():
     _test_from_torch(TensorRTRunner, "cuda", atol=1e-1, rtol=1e-1)
 
 
+def test_profile_nodes():
+    """Test profile the nodes on several runners"""
+
+    class ConvRelu(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.conv = torch.nn.Conv2d(3, 8, 3)
+
+        def forward(self, data):
+            return torch.relu(self.conv(data))
+
+    workspace = msc_utils.set_workspace(msc_utils.msc_dir("test_runner_profile_nodes"))
+    log_path = workspace.relpath("MSC_LOG", keep_history=False)
+    msc_utils.set_global_logger("critical", log_path)
+    input_info = [([1, 3, 32, 32], "float32")]
+    datas = [np.random.rand(*i[0]).astype(i[1]) for i in input_info]
+    with torch.no_grad():
+        mod = from_fx(fx.symbolic_trace(ConvRelu().eval()), input_info)
+    latencies = {}
+    for runner_cls in [TVMRunner, TorchRunner]:
+        runner = runner_cls(mod)
+        runner.build()
+        latencies[runner_cls.__name__] = runner.profile_nodes(datas, repeat=2, warm_up=1)
+    workspace.destory()
+    # The nodes share the names on the runners, and are timed on both of them.
+    nodes = set(latencies["TVMRunner"])
+    assert nodes and set(latencies["TorchRunner"]) == nodes
+    for node_latencies in latencies.values():
+        assert all(latency >= 0 for latency in node_latencies.values())
+    report = msc_utils.compare_latencies(latencies)
+    assert set(report["info"]) == nodes
+    assert sum(report["best"].values()) == len(nodes)
+
+
 def test_tensorflow_runner():
     """Test runner from tf graph"""
 
@@ -102,6 +102,51 @@ def test_normal():
     verify()
 
 
+def test_philox():
+    """Tests the Philox functions of the runtime and in TIR"""
+    if not tvm.get_global_func("tvm.contrib.random.philox_uniform", True):
+        print("skip because extern function is not available")
+        return
+    funiform = tvm.get_global_func("tvm.contrib.random.philox_uniform")
+    fnormal = tvm.get_global_func("tvm.contrib.random.philox_normal")
+
+    def build(tensor):
+        f = tvm.build(te.create_schedule(tensor.op), [tensor], "llvm")
+        out = tvm.nd.empty([int(dim) for dim in tensor.shape], "float32")
+        f(out)
+        return out.numpy()
+
+    # The block of seed 0 and counter 0 is the known answer of Philox-4x32-10.
+    a = tvm.nd.empty((4,), "float32")
+    funiform(0, 0, 0.0, 1.0, a)
+    bits = np.array([0x6627E8D5, 0xE169C58D, 0xBC57AC4C, 0x9B00DBD8], dtype="uint32")
+    np.testing.assert_equal(a.numpy(), (bits >> 8).astype("float32") / np.float32(1 << 24))
+
+    shape = (1001, 7)
+    a = tvm.nd.empty(shape, "float32")
+    funiform(7, 3, 0.0, 1.0, a)
+    na = a.numpy()
+    assert na.min() >= 0 and na.max() < 1
+    assert abs(np.mean(na) - 0.5) < 1e-2
+    np.testing.assert_equal(build(random.philox_uniform(7, 3, 0.0, 1.0, shape)), na)
+    # The offset skips four samples per block.
+    b = tvm.nd.empty((1001 * 7 - 12,), "float32")
+    funiform(7, 6, 0.0, 1.0, b)
+    np.testing.assert_equal(b.numpy(), na.flatten()[12:])
+
+    funiform(7, 3, -2.0, 3.0, a)
+    tvm.testing.assert_allclose(build(random.philox_uniform(7, 3, -2.0, 3.0, shape)), a.numpy())
+
+    n = tvm.nd.empty((100000,), "float32")
+    fnormal(1, 0, 3.0, 4.0, n)
+    nn = n.numpy()
+    assert abs(np.mean(nn) - 3) < 1e-1
+    assert abs(np.std(nn) - 4) < 1e-1
+    tvm.testing.assert_allclose(
+        build(random.philox_normal(1, 0, 3.0, 4.0, (100000,))), nn, rtol=1e-4, atol=1e-3
+    )
+
+
 @tvm.testing.uses_gpu
 def test_random_fill():
     """Tests random_fill function"""
@@ -191,5 +236,6 @@ if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
+    test_philox()
     test_random_fill()
     test_random_fill_mt()
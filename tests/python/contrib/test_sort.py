@@ -128,7 +128,28 @@ def test_sort_by_key_gpu():
             tvm.testing.assert_allclose(values_out.numpy(), ref_values_out, rtol=1e-5)
 
 
+def test_segmented_topk():
+    """Tests the segmented topk on the CPU against numpy"""
+    rows, n = 37, 100
+    data = te.placeholder((rows, n), name="data", dtype="float32")
+    for k, is_ascend in [(1, False), (8, False), (8, True), (100, False)]:
+        values, indices = tvm.topi.segmented_topk(data, k, is_ascend=is_ascend, dtype="int32")
+        s = te.create_schedule([values.op, indices.op])
+        f = tvm.build(s, [data, values, indices], "llvm")
+
+        dev = tvm.cpu(0)
+        # Few distinct values, so that ties are broken by the index.
+        data_np = np.random.randint(0, 10, size=(rows, n)).astype("float32")
+        order = np.argsort(data_np if is_ascend else -data_np, axis=-1, kind="stable")[:, :k]
+        values_nd = tvm.nd.array(np.zeros((rows, k), "float32"), dev)
+        indices_nd = tvm.nd.array(np.zeros((rows, k), "int32"), dev)
+        f(tvm.nd.array(data_np, dev), values_nd, indices_nd)
+        tvm.testing.assert_allclose(indices_nd.numpy(), order)
+        tvm.testing.assert_allclose(values_nd.numpy(), np.take_along_axis(data_np, order, -1))
+
+
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
     test_sort_by_key_gpu()
+    test_segmented_topk()
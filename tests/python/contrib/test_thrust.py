@@ -19,7 +19,7 @@ import numpy as np
 import tvm
 import tvm.testing
 from tvm import te
-from tvm.topi.cuda import stable_sort_by_key_thrust
+from tvm.topi.cuda import segmented_topk_thrust, stable_sort_by_key_thrust
 from tvm.topi.cuda.scan import exclusive_scan, scan_thrust, schedule_scan
 from tvm.contrib.thrust import can_use_thrust, can_use_rocthrust
 
@@ -140,7 +140,39 @@ def test_inclusive_scan():
                 tvm.testing.assert_allclose(values_out.numpy(), ref_values_out, rtol=1e-5)
 
 
+@tvm.testing.requires_cuda
+def test_segmented_topk():
+    """Tests the warp bitonic, the radix select and the sorted fallback paths"""
+    target = "cuda"
+    with tvm.target.Target(target + " -libs=thrust") as tgt:
+        if not can_use_thrust(tgt, "tvm.contrib.thrust.segmented_topk"):
+            print("skip because thrust is not enabled...")
+            return
+
+        dev = tvm.device(target, 0)
+        configs = [(33, 64, 1), (33, 100, 8), (17, 300, 32), (9, 3000, 200), (3, 5000, 2000)]
+        for rows, n, k in configs:
+            for is_ascend in [False, True]:
+                data = te.placeholder((rows, n), name="data", dtype="float32")
+                values, indices = segmented_topk_thrust(data, k, is_ascend=is_ascend)
+                s = te.create_schedule([values.op, indices.op])
+                f = tvm.build(s, [data, values, indices], target)
+
+                # Few distinct values, so that ties are broken by the index.
+                data_np = np.random.randint(0, 50, size=(rows, n)).astype("float32")
+                order = np.argsort(data_np if is_ascend else -data_np, axis=-1, kind="stable")
+                order = order[:, :k]
+                values_nd = tvm.nd.array(np.zeros((rows, k), "float32"), dev)
+                indices_nd = tvm.nd.array(np.zeros((rows, k), "int64"), dev)
+                f(tvm.nd.array(data_np, dev), values_nd, indices_nd)
+                tvm.testing.assert_allclose(indices_nd.numpy(), order)
+                tvm.testing.assert_allclose(
+                    values_nd.numpy(), np.take_along_axis(data_np, order, -1)
+                )
+
+
 if __name__ == "__main__":
     test_stable_sort_by_key()
     test_exclusive_scan()
     test_inclusive_scan()
+    test_segmented_topk()
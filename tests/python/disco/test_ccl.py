@@ -101,6 +101,59 @@ def test_allgather(session_kind, ccl):
     )
 
 
+@pytest.mark.skipif(
+    get_global_func("runtime.disco.mscclpp.init_ccl", allow_missing=True) is None,
+    reason="TVM is not built with USE_MSCCL",
+)
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_mscclpp_allreduce(session_kind):
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl("mscclpp", *devices)
+    # Messages up to 4KB are reduced by MSCCL++, and the larger ones by NCCL.
+    sess.call_packed(sess.get_global_func("runtime.disco.mscclpp.set_allreduce_max_bytes"), 4096)
+    for shape in [(8, 128), (64, 128)]:
+        array_1 = np.random.uniform(size=shape).astype("float16")
+        array_2 = np.random.uniform(size=shape).astype("float16")
+        d_array = sess.empty(shape, "float16")
+        d_array.debug_copy_from(0, array_1)
+        d_array.debug_copy_from(1, array_2)
+        d_dst = sess.empty(shape, "float16")
+        sess.allreduce(d_array, d_dst)
+        np.testing.assert_allclose(
+            d_dst.debug_get_from_remote(1).numpy(), array_1 + array_2, rtol=1e-3
+        )
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("ccl", _ccl)
+def test_collectives_in_group(session_kind, ccl):
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+    sess.init_ccl_group("single", [[0], [1]])
+    sess.init_ccl_group("pair", [[1, 0]])
+
+    array_1 = np.arange(12, dtype="float32").reshape(3, 4)
+    array_2 = np.arange(start=1, stop=-11, step=-1, dtype="float32").reshape(3, 4)
+    d_array = sess.empty((3, 4), "float32")
+    d_array.debug_copy_from(0, array_1)
+    d_array.debug_copy_from(1, array_2)
+    d_dst = sess.empty((3, 4), "float32")
+    sess.allreduce(d_array, d_dst, group="single")
+    np.testing.assert_equal(d_dst.debug_get_from_remote(0).numpy(), array_1)
+    np.testing.assert_equal(d_dst.debug_get_from_remote(1).numpy(), array_2)
+    sess.allreduce(d_array, d_dst, group="pair")
+    np.testing.assert_equal(d_dst.debug_get_from_remote(0).numpy(), array_1 + array_2)
+
+    # The ranks within the group follow the order of the worker ids given.
+    d_gathered = sess.empty((6, 4), "float32")
+    sess.allgather(d_array, d_gathered, group="pair")
+    np.testing.assert_equal(
+        d_gathered.debug_get_from_remote(0).numpy(), np.concatenate([array_2, array_1])
+    )
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 @pytest.mark.parametrize("use_explicit_output", [True, False])
@@ -225,6 +278,60 @@ def test_gather(session_kind, ccl, capfd):
     ), "No warning messages should be generated from disco.Session.gather_to_worker0"
 
 
+@pytest.mark.parametrize("ccl", _ccl)
+def test_send_to_next_group(ccl):
+    devices = [0, 1]
+
+    def send_recv(send, recv):
+        if get_global_func("runtime.disco.worker_group")() == 0:
+            get_global_func("runtime.disco.send_to_next_group")(send)
+        else:
+            get_global_func("runtime.disco.recv_from_prev_group")(recv)
+
+    tvm.register_func("tests.disco.group_send_recv", send_recv, override=True)
+    sess = di.ThreadedSession(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+    sess.init_groups(num_groups=2)
+
+    array = np.arange(12, dtype="float32").reshape(3, 4)
+    d_send = sess.empty((3, 4), "float32")
+    d_recv = sess.empty((3, 4), "float32")
+    d_send.debug_copy_from(0, array)
+    sess.call_packed(sess.get_global_func("tests.disco.group_send_recv"), d_send, d_recv)
+    np.testing.assert_equal(d_recv.debug_get_from_remote(1).numpy(), array)
+
+
+@pytest.mark.parametrize("ccl", _ccl)
+def test_run_pipeline(ccl):
+    devices = [0, 1]
+    num_micro_batches = 4
+    results = {}
+
+    def fstage(micro_batch, stage_input, stage_output):
+        if stage_input is None:
+            # The first stage produces the micro-batch.
+            stage_output.copyfrom(np.full((2, 2), micro_batch, dtype="float32"))
+        else:
+            # The last stage collects it.
+            results[micro_batch] = stage_input.numpy() + 1
+
+    tvm.register_func("tests.disco.pipeline_stage", fstage, override=True)
+    sess = di.ThreadedSession(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+    sess.init_groups(num_groups=2)
+    d_recv = sess.empty((2, 2), "float32")
+    d_send = sess.empty((2, 2), "float32")
+    sess.run_pipeline(
+        sess.get_global_func("tests.disco.pipeline_stage"), num_micro_batches, d_recv, d_send
+    )
+    sess.sync_worker_0()
+    sess._sync_worker(1)  # pylint: disable=protected-access
+    for micro_batch in range(num_micro_batches):
+        np.testing.assert_equal(
+            results[micro_batch], np.full((2, 2), micro_batch + 1, dtype="float32")
+        )
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_mlp(session_kind, ccl):  # pylint: disable=too-many-locals
@@ -77,6 +77,66 @@ def test_allreduce(shape, ccl, strategy):
     np.testing.assert_equal(result_2, expected)
 
 
+@pytest.mark.parametrize("ccl", _ccl)
+@pytest.mark.parametrize("strategy", _strategies)
+def test_allreduce_float16(ccl, strategy):
+    devices = [0, 1]
+    sess: Session = disco.ProcessSession(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    shape = (128, 128)
+    dtype = "float16"
+    falloc_ipc_storage = sess.get_global_func("runtime.disco.cuda_ipc.alloc_storage")
+    falloc_tensor = sess.get_global_func("vm.builtin.alloc_tensor")
+    fallreduce = sess.get_global_func("runtime.disco.cuda_ipc.custom_allreduce")
+    d_storage = sess.call_packed(falloc_ipc_storage, ShapeTuple(shape), DataType(dtype))
+    d_input = sess.call_packed(falloc_tensor, d_storage, 0, ShapeTuple(shape), DataType(dtype))
+
+    array_1 = (np.arange(np.prod(shape)) % 64).astype(dtype).reshape(shape)
+    array_2 = (np.arange(np.prod(shape)) % 32 - 16).astype(dtype).reshape(shape)
+    d_input.debug_copy_from(0, array_1)
+    d_input.debug_copy_from(1, array_2)
+    d_output = sess.empty(shape, dtype)
+
+    sess.call_packed(fallreduce, d_input, strategy, d_output)
+    expected = np.add(array_1, array_2)
+    np.testing.assert_equal(d_output.debug_get_from_remote(0).numpy(), expected)
+    np.testing.assert_equal(d_output.debug_get_from_remote(1).numpy(), expected)
+
+
+@pytest.mark.parametrize("ccl", _ccl)
+@pytest.mark.parametrize("oneshot_max_bytes,twoshot_max_bytes", [(0, 0), (0, 1 << 20)])
+def test_allreduce_crossover(ccl, oneshot_max_bytes, twoshot_max_bytes):
+    devices = [0, 1]
+    sess: Session = disco.ProcessSession(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+    fset_crossover = sess.get_global_func("runtime.disco.cuda_ipc.set_custom_allreduce_crossover")
+    sess.call_packed(fset_crossover, len(devices), oneshot_max_bytes, twoshot_max_bytes)
+
+    shape = (128, 128)
+    dtype = "float32"
+    falloc_ipc_storage = sess.get_global_func("runtime.disco.cuda_ipc.alloc_storage")
+    falloc_tensor = sess.get_global_func("vm.builtin.alloc_tensor")
+    fallreduce = sess.get_global_func("runtime.disco.cuda_ipc.custom_allreduce")
+    fbench = sess.get_global_func("runtime.disco.cuda_ipc.benchmark_custom_allreduce")
+    d_storage = sess.call_packed(falloc_ipc_storage, ShapeTuple(shape), DataType(dtype))
+    d_input = sess.call_packed(falloc_tensor, d_storage, 0, ShapeTuple(shape), DataType(dtype))
+
+    array_1 = np.arange(np.prod(shape), dtype=dtype).reshape(shape)
+    array_2 = np.ones(shape, dtype=dtype)
+    d_input.debug_copy_from(0, array_1)
+    d_input.debug_copy_from(1, array_2)
+    d_output = sess.empty(shape, dtype)
+
+    sess.call_packed(fallreduce, d_input, AllReduceStrategyType.AUTO, d_output)
+    expected = np.add(array_1, array_2)
+    np.testing.assert_equal(d_output.debug_get_from_remote(0).numpy(), expected)
+    np.testing.assert_equal(d_output.debug_get_from_remote(1).numpy(), expected)
+
+    latency = sess.call_packed(fbench, d_input, AllReduceStrategyType.AUTO, d_output, 3)
+    assert latency.debug_get_from_remote(0) > 0
+
+
 if __name__ == "__main__":
     for shape, strategy in product(_shapes, _strategies):
         test_allreduce(shape, "nccl", strategy)
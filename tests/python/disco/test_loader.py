@@ -80,9 +80,9 @@ def _shard_qkv_1(src, tgt):
     tgt.copyfrom(src.numpy().reshape(s, -1, h))
 
 
-def _create_loader(sess, path, param_dict, shard_info):
+def _create_loader(sess, path, param_dict, shard_info, shard_cap_mb=32):
     path_ndarray_cache = path + "/ndarray-cache.json"
-    tvmjs.dump_ndarray_cache(param_dict, path, encode_format="raw")
+    tvmjs.dump_ndarray_cache(param_dict, path, encode_format="raw", shard_cap_mb=shard_cap_mb)
     with open(path_ndarray_cache, "r", encoding="utf-8") as i_f:
         ndarray_cache = i_f.read()
     loader_create = sess.get_global_func("runtime.disco.ShardLoader")
@@ -345,6 +345,36 @@ def test_load_shard_all():
         np.testing.assert_equal(param_dict["param_1"][16:32, :], p_1[1].numpy())
 
 
+def test_load_shard_all_multiple_files():
+    devices = [0, 1]
+    num_shards = len(devices)
+    # Each parameter fills its own file, which are prefetched while loading.
+    param_dict = {
+        f"param_{i}": np.random.uniform(size=[256, 512]).astype("float32") for i in range(3)
+    }
+    shard_info = {
+        f"param_{i}": [
+            [
+                "tests.disco.shard_dim_0",
+                [(num_shards, 128, 512), "float32"],
+                num_shards,
+            ]
+        ]
+        for i in range(3)
+    }
+    with tempfile.TemporaryDirectory() as path:
+        sess = di.ThreadedSession(num_workers=len(devices))
+        sess.init_ccl("nccl", *devices)
+        loader = _create_loader(sess, path, param_dict, shard_info, shard_cap_mb=1)
+        loader_load = sess.get_global_func("runtime.disco.ShardLoaderLoadAll")
+        params = loader_load(loader)
+        p_0 = params.debug_get_from_remote(0)
+        p_1 = params.debug_get_from_remote(1)
+        for i in range(3):
+            np.testing.assert_equal(param_dict[f"param_{i}"][0:128, :], p_0[i].numpy())
+            np.testing.assert_equal(param_dict[f"param_{i}"][128:256, :], p_1[i].numpy())
+
+
 def test_load_all_presharded():
     devices = [0, 1]
     num_shards = len(devices)
@@ -16,6 +16,9 @@
 # under the License.
 """Basic tests for a Disco session"""
 # pylint: disable=missing-docstring
+import socket
+import subprocess
+import sys
 import tempfile
 
 import numpy as np
@@ -48,6 +51,27 @@ def _numpy_from_worker_0(sess: di.Session, remote_array, shape, dtype):
 _all_session_kinds = [di.ThreadedSession, di.ProcessSession]
 
 
+def test_socket_session():
+    num_workers = 3
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        port = sock.getsockname()[1]
+    workers = [
+        subprocess.Popen(  # pylint: disable=consider-using-with
+            [sys.executable, "-m", "tvm.exec.disco_socket_worker", "127.0.0.1", str(port), str(i)]
+        )
+        for i in range(1, num_workers)
+    ]
+    sess = di.SocketSession(num_workers, "127.0.0.1", port)
+    func: di.DPackedFunc = sess.get_global_func("tests.disco.add_one")
+    result: di.DRef = func(1)
+    for i in range(num_workers):
+        assert result.debug_get_from_remote(i) == 2
+    sess.shutdown()
+    for worker in workers:
+        assert worker.wait(timeout=60) == 0
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 def test_int(session_kind):  # pylint: disable=invalid-name
     num_workers = 4
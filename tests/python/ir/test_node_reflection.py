@@ -195,5 +195,33 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+def test_binary_roundtrip():
+    dev = tvm.cpu(0)
+    np_data = np.random.rand(16).astype("float32")
+    buf = tvm.tir.decl_buffer((16,), "float32")
+    n = te.size_var("n")
+    body = tvm.tir.Evaluate(n * -3)
+    alloc_const = tvm.tir.AllocateConst(buf.data, "float32", (16,), tvm.nd.array(np_data), body)
+    func = tvm.tir.PrimFunc([n], alloc_const).with_attrs(
+        {"global_symbol": "main", "flag": True, "bound": -float("inf")}
+    )
+    mod = tvm.IRModule({"main": func})
+    for node in [mod, {"key": mod, "other": [1, 2.5, "str"]}, {n: buf}, tvm.nd.array(np_data)]:
+        node = tvm.runtime.convert(node)
+        data = tvm.ir.save_binary(node)
+        assert len(data) < len(tvm.ir.save_json(node))
+        loaded = tvm.ir.load_binary(data)
+        tvm.ir.assert_structural_equal(node, loaded, map_free_vars=True)
+    loaded = tvm.ir.load_binary(tvm.ir.save_binary(mod))
+    np.testing.assert_array_equal(loaded["main"].body.data.numpy(), np_data)
+    # The variables keep being shared after loading.
+    assert loaded["main"].params[0].same_as(loaded["main"].body.body.value.a)
+
+    with pytest.raises(tvm.TVMError, match="not a binary of TVM nodes"):
+        tvm.ir.load_binary(b"not a binary")
+    with pytest.raises(tvm.TVMError, match="Truncated"):
+        tvm.ir.load_binary(tvm.ir.save_binary(tvm.runtime.convert([n]))[:-1])
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -17,9 +17,11 @@
 """ Instrument test cases.
 """
 
+import json
+
 import tvm
 from tvm import relax
-from tvm.ir.instrument import PrintAfterAll, PrintBeforeAll
+from tvm.ir.instrument import PassProfilingInstrument, PrintAfterAll, PrintBeforeAll
 from tvm.script import ir as I
 from tvm.script import relax as R
 from tvm.script import tir as T
@@ -61,3 +63,30 @@ def test_relax_print_all_passes(capsys):
     assert "Before Running Pass:" in all_passes_output
     assert "After Running Pass:" in all_passes_output
     assert "pass name: _pipeline" in all_passes_output
+
+
+def test_pass_profiling_instrument():
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                B[i] = A[i] + T.float32(1)
+
+        @T.prim_func
+        def mul_two(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                B[i] = A[i] * T.float32(2) + T.float32(0)
+
+    profiler = PassProfilingInstrument()
+    with tvm.transform.PassContext(instruments=[profiler]):
+        tvm.tir.transform.Simplify()(Module)
+    events = json.loads(profiler.chrome_trace())["traceEvents"]
+    passes = [e for e in events if e["cat"] == "pass"]
+    functions = [e for e in events if e["cat"] == "function"]
+    assert [e["name"] for e in passes] == ["tir.Simplify"]
+    assert sorted(e["args"]["function"] for e in functions) == ["add_one", "mul_two"]
+    for e in functions:
+        assert e["ph"] == "X" and e["args"]["pass"] == "tir.Simplify"
+        assert e["args"]["allocations"] > 0
+        assert passes[0]["ts"] <= e["ts"] and e["dur"] <= passes[0]["dur"]
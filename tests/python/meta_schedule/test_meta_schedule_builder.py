@@ -225,5 +225,31 @@ def test_meta_schedule_missing_build_func():
         LocalBuilder(f_build="wrong-name")
 
 
+@tvm.testing.requires_cuda
+def test_meta_schedule_local_memory_limit():
+    """Test the kernels using local memory fail to build beyond the limit"""
+
+    @T.prim_func
+    def local_array(A: T.Buffer((32, 64), "int32"), B: T.Buffer((32,), "float32")):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for tx in T.thread_binding(32, thread="threadIdx.x"):
+            with T.block("local_array"):
+                vx = T.axis.spatial(32, tx)
+                buf = T.alloc_buffer((64,), "float32", scope="local")
+                # The dynamic indices keep the array in local memory.
+                for i in range(64):
+                    buf[A[vx, i] % 64] = T.float32(i)
+                B[vx] = buf[A[vx, 0] % 64]
+
+    target = Target("cuda", host="llvm")
+    builder_inputs = [BuilderInput(tvm.IRModule({"main": local_array}), target)]
+    (result,) = LocalBuilder(max_local_memory_bytes=0).build(builder_inputs)
+    assert result.artifact_path is None
+    assert "bytes of local memory per thread" in result.error_msg
+    (result,) = LocalBuilder(max_local_memory_bytes=256).build(builder_inputs)
+    assert result.error_msg is None
+    os.remove(result.artifact_path)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -26,7 +26,12 @@ from typing import List
 import numpy as np
 import tvm
 import tvm.testing
-from tvm.meta_schedule.cost_model import PyCostModel, RandomModel, XGBModel
+from tvm.meta_schedule.cost_model import (
+    PyCostModel,
+    RandomModel,
+    TreeEnsembleModel,
+    XGBModel,
+)
 from tvm.meta_schedule.cost_model.xgb_model import PackSum, _get_custom_call_back
 from tvm.meta_schedule.feature_extractor import RandomFeatureExtractor
 from tvm.meta_schedule.runner import RunnerResult
@@ -257,6 +262,47 @@ def test_meta_schedule_xgb_model_reupdate():
     model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
 
 
+def test_meta_schedule_tree_ensemble_model():
+    extractor = RandomFeatureExtractor()
+    model = TreeEnsembleModel(extractor=extractor, num_warmup_samples=2)
+    update_sample_count = 60
+    predict_sample_count = 100
+    for _ in range(2):
+        model.update(
+            TuneContext(),
+            [_dummy_candidate() for i in range(update_sample_count)],
+            [_dummy_result() for i in range(update_sample_count)],
+        )
+    res = model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
+    assert res.shape == (predict_sample_count,)
+    assert np.isfinite(res).all()
+
+
+def test_meta_schedule_tree_ensemble_model_reload():
+    extractor = RandomFeatureExtractor()
+    model = TreeEnsembleModel(extractor=extractor, num_warmup_samples=10)
+    update_sample_count = 20
+    predict_sample_count = 30
+    model.update(
+        TuneContext(),
+        [_dummy_candidate() for i in range(update_sample_count)],
+        [_dummy_result() for i in range(update_sample_count)],
+    )
+    with tempfile.NamedTemporaryFile() as path:
+        random_state = model.extractor.random_state  # save feature extractor's random state
+        model.save(path.name)
+        res1 = model.predict(
+            TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)]
+        )
+        model.extractor.random_state = random_state  # load feature extractor's random state
+        new_model = TreeEnsembleModel(extractor=model.extractor, num_warmup_samples=10)
+        new_model.load(path.name)
+        res2 = new_model.predict(
+            TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)]
+        )
+    assert (res1 == res2).all()
+
+
 def xgb_version_check():
 
     # pylint: disable=import-outside-toplevel
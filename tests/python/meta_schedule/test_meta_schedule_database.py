@@ -24,7 +24,7 @@ import pytest
 import tvm
 import tvm.testing
 from tvm import meta_schedule as ms
-from tvm import relay, tir
+from tvm import relay, te, tir
 from tvm.ir.module import IRModule
 from tvm.meta_schedule.database import TuningRecord, Workload
 from tvm.script import tir as T
@@ -306,6 +306,44 @@ def test_meta_schedule_database_missing():
         assert len(ret) == 0
 
 
+def _te_matmul(n: int) -> IRModule:
+    a = te.placeholder((n, n), name="A")
+    b = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    c = te.compute((n, n), lambda i, j: te.sum(a[i, k] * b[k, j], axis=k), name="matmul")
+    return IRModule({"main": te.create_prim_func([a, b, c])})
+
+
+def test_meta_schedule_database_top_k_similar():
+    def _add_entry(database, mod, run_secs):
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                tir.Schedule(mod).trace,
+                database.commit_workload(mod),
+                [run_secs],
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            )
+        )
+
+    mod = _te_matmul(1024)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = _create_tmp_database(tmpdir)
+        _add_entry(database, mod, 1.0)
+        _add_entry(database, _te_matmul(64), 0.5)
+        _add_entry(database, _te_matmul(512), 2.0)
+        _add_entry(database, _te_matmul(512), 1.5)
+        a = te.placeholder((1024, 1024), name="A")
+        add = te.compute((1024, 1024), lambda i, j: a[i, j] + 1.0, name="matmul")
+        _add_entry(database, IRModule({"main": te.create_prim_func([a, add])}), 0.1)
+        ret = database.get_top_k_similar(mod, 3)
+        funcs = [r.workload.mod["main"] for r in ret]
+        assert [int(f.buffer_map[f.params[0]].shape[0]) for f in funcs] == [512, 512, 64]
+        assert [float(r.run_secs[0]) for r in ret] == [1.5, 2.0, 0.5]
+        assert len(database.get_top_k_similar(mod, 10)) == 3
+        assert len(database.get_top_k_similar(_te_matmul(64), 10)) == 3
+
+
 def test_meta_schedule_database_sorting():
     mod: IRModule = Matmul
     with tempfile.TemporaryDirectory() as tmpdir:
@@ -414,6 +452,36 @@ def test_meta_schedule_database_reload():
             _equal_record(ret[1], records[2])
 
 
+def test_meta_schedule_database_shared_files():
+    mod: IRModule = Matmul
+    with tempfile.TemporaryDirectory() as tmpdir:
+        # Two databases on the same files, as two tuning jobs would have.
+        db_a = _create_tmp_database(tmpdir)
+        db_b = _create_tmp_database(tmpdir)
+        db_b.commit_workload(MatmulFunc())
+        # `db_a` does not know about the workload of `db_b`, which is at index 0 in the file.
+        workload_a = db_a.commit_workload(mod)
+        assert db_a.has_workload(MatmulFunc())
+        record = ms.database.TuningRecord(
+            _create_schedule(mod, _schedule_matmul).trace,
+            workload_a,
+            [1.0, 2.0],
+            tvm.target.Target("llvm"),
+            ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+        )
+        db_a.commit_tuning_record(record)
+        # `db_b` picks up the record committed by `db_a`.
+        workload_b = db_b.commit_workload(mod)
+        assert len(db_b) == 1
+        (ret,) = db_b.get_top_k(workload_b, 2)
+        _equal_record(ret, record)
+        # The record refers to the right line of the workload file.
+        new_database = _create_tmp_database(tmpdir)
+        assert len(new_database) == 1
+        (ret,) = new_database.get_all_tuning_records()
+        _equal_record(ret, record)
+
+
 def test_meta_schedule_database_union():
     mod: IRModule = Matmul
     target = tvm.target.Target("llvm")
@@ -584,6 +652,53 @@ def test_json_database_get_top_k(k, expected):
     assert result == expected
 
 
+@pytest.mark.parametrize(
+    "k,expected",
+    [
+        (0, []),
+        (1, [[0.0, 2.0]]),
+        (4, [[0.0, 2.0], [2.0], [1.5, 4.5], [3.0, 1e10]]),
+        (5, [[0.0, 2.0], [2.0], [1.5, 4.5], [3.0, 1e10]]),
+    ],
+)
+def test_binary_database_get_top_k(k, expected):
+    run_secs_list = [[1.5, 4.5], [], [0.0, 2.0], None, [2.0], [3.0, 1e10], [1e10]]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = ms.database.BinaryDatabase(work_dir=tmpdir)
+        result = call_get_top_k(run_secs_list, database, k)
+    assert result == expected
+
+
+def test_binary_database_reload_and_compact():
+    run_secs_list = [[1.5, 4.5], [], [0.0, 2.0], [2.0], [3.0, 1e10], [1e10]]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = ms.database.BinaryDatabase(work_dir=tmpdir)
+        call_get_top_k(run_secs_list, database, 0)
+        assert len(database) == 6
+
+        def reload():
+            return ms.database.BinaryDatabase(
+                path_workload=database.path_workload,
+                path_tuning_record=database.path_tuning_record,
+                allow_missing=False,
+            )
+
+        new_database = reload()
+        assert len(new_database) == 6
+        assert new_database.has_workload(Matmul)
+        workload = new_database.commit_workload(Matmul)
+        top_2 = new_database.get_top_k(workload, 2)
+        assert [[v.value for v in r.run_secs] for r in top_2] == [[0.0, 2.0], [2.0]]
+        _equal_record(top_2[0], new_database.get_all_tuning_records()[0])
+
+        assert ms.database.BinaryDatabase.compact(database.path_tuning_record, top_k=2) == 4
+        new_database = reload()
+        assert len(new_database) == 2
+        workload = new_database.commit_workload(Matmul)
+        result = [[v.value for v in r.run_secs] for r in new_database.get_top_k(workload, 5)]
+        assert result == [[0.0, 2.0], [2.0]]
+
+
 def MatmulFunc() -> IRModule:
     a = relay.var("a", relay.TensorType((1024, 1024), "float32"))
     b = relay.var("b", relay.TensorType((1024, 1024), "float32"))
@@ -604,6 +719,15 @@ def test_json_database_commit_workload(f_mod, mod_eq):
         database.commit_workload(mod)
 
 
+@pytest.mark.parametrize("f_mod", [MatmulPrimFunc, MatmulFunc])
+@pytest.mark.parametrize("mod_eq", ["structural", "ignore-ndarray", "anchor-block"])
+def test_binary_database_commit_workload(f_mod, mod_eq):
+    mod: IRModule = f_mod()
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = ms.database.BinaryDatabase(work_dir=tmpdir, module_equality=mod_eq)
+        assert database.commit_workload(mod).same_as(database.commit_workload(mod))
+
+
 @pytest.mark.parametrize("f_mod", [MatmulPrimFunc, MatmulFunc])
 @pytest.mark.parametrize("mod_eq", ["structural", "ignore-ndarray", "anchor-block"])
 def test_memory_database_commit_workload(f_mod, mod_eq):
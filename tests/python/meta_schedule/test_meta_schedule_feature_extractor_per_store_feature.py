@@ -1616,6 +1616,30 @@ def test_cpu_layout_transform():
     )
 
 
+def test_cached_features():
+    def _create_schedule(factor):
+        sch = tir.Schedule(matmul, debug_mask="all")
+        i, _, _ = sch.get_loops(sch.get_block("C"))
+        sch.split(i, factors=[None, factor])
+        return sch
+
+    extractor = ms.feature_extractor.PerStoreFeature()
+    context = _make_context(tvm.target.Target("llvm"))
+    candidates = [
+        _make_candidate(lambda: _create_schedule(16)),
+        _make_candidate(lambda: _create_schedule(16)),
+        _make_candidate(lambda: _create_schedule(8)),
+    ]
+    features = [feature.numpy() for feature in extractor.extract_from(context, candidates)]
+    (uncached,) = ms.feature_extractor.PerStoreFeature().extract_from(context, candidates[:1])
+    # Equal modules hit the cache, and a different tile size does not.
+    assert_allclose(features[0], uncached.numpy())
+    assert_allclose(features[0], features[1])
+    assert not (features[0] == features[2]).all()
+    (cached,) = extractor.extract_from(context, candidates[2:])
+    assert_allclose(cached.numpy(), features[2])
+
+
 @T.prim_func
 def negative_extent(A: T.Buffer((1,), "float32")):
     for j in range(0, -1):
@@ -107,6 +107,34 @@ def test_mutate_sample_categorical_single_candidate():
     assert trace is None
 
 
+def test_mutate_tile_size_prune_thread_extent():
+    mutator = _make_mutator(
+        target=Target("cuda -max_threads_per_block=64"),
+    )
+    sch = Schedule(matmul, debug_mask="all")
+    # pylint: disable=invalid-name
+    b0 = sch.get_block(name="C", func_name="main")
+    l1, _, _ = sch.get_loops(block=b0)
+    v2, v3, v4 = sch.sample_perfect_tile(
+        loop=l1,
+        n=3,
+        max_innermost_factor=64,
+        decision=[16, 32, 1],
+    )
+    l5, l6, _ = sch.split(loop=l1, factors=[v2, v3, v4])
+    sch.bind(loop=l5, thread_axis="blockIdx.x")
+    sch.bind(loop=l6, thread_axis="threadIdx.x")
+    # pylint: enable=invalid-name
+    for _ in range(100):
+        trace = mutator.apply(sch.trace)
+        if trace is None:
+            continue
+        # The tile sizes with more threads than the target allows are pruned before replay.
+        decision = [int(x) for x in trace.decisions[trace.insts[2]]]
+        assert decision[1] <= 64
+
+
 if __name__ == "__main__":
     test_mutate_tile_size_matmul()
     test_mutate_sample_categorical_single_candidate()
+    test_mutate_tile_size_prune_thread_extent()
@@ -458,6 +458,20 @@ def test_target_blocks_search_space():
             IRModule({"main": get_matmul_packed(128, 128, 128, "uint8", "uint8", "int32")}),
             "dot_4x4_u8u8i32_hdot",
         ),
+        (
+            Target(
+                "llvm -device=arm_cpu -mtriple=aarch64-linux-gnu -mattr=+neon,+v8.6a,+i8mm -num-cores 2"
+            ),
+            IRModule({"main": get_matmul_packed(128, 128, 128, "int8", "int8", "int32")}),
+            "mmla_2x2x8_i8i8s32_smmla",
+        ),
+        (
+            Target(
+                "llvm -device=arm_cpu -mtriple=aarch64-linux-gnu -mattr=+neon,+v8.6a,+i8mm -num-cores 2"
+            ),
+            IRModule({"main": get_matmul_packed(128, 128, 128, "uint8", "uint8", "uint32")}),
+            "mmla_2x2x8_u8u8u32_ummla",
+        ),
     ],
 )
 def test_meta_schedule_post_order_apply_arm_intrin(target, mod, expected_intr):
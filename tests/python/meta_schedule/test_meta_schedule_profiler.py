@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """ Test Meta Schedule Profiler """
+import json
 import time
 
 from tvm import meta_schedule as ms
@@ -36,6 +37,27 @@ def test_meta_schedule_profiler_context_manager():
     assert 1.9 <= result["Level1"] <= 2.1
 
 
+def test_meta_schedule_profiler_chrome_trace():
+    with ms.Profiler() as profiler:
+        with ms.Profiler.timeit("Level0"):
+            time.sleep(0.1)
+            with ms.Profiler.timeit("Level1"):
+                time.sleep(0.1)
+    trace = json.loads(profiler.chrome_trace())
+    spans = {e["name"]: e for e in trace["traceEvents"] if e["ph"] == "X"}
+    assert set(spans) == {"Total", "Level0", "Level1"}
+    # The nested scopes share the lane of the search thread.
+    assert len({e["tid"] for e in spans.values()}) == 1
+    assert spans["Level0"]["ts"] <= spans["Level1"]["ts"]
+    assert spans["Level1"]["ts"] + spans["Level1"]["dur"] <= (
+        spans["Level0"]["ts"] + spans["Level0"]["dur"]
+    )
+    assert 0.19e6 <= spans["Level0"]["dur"] <= 0.3e6
+    names = [e["args"]["name"] for e in trace["traceEvents"] if e["ph"] == "M"]
+    assert names == ["search"]
+    assert "Search thread" in profiler.utilization()
+
+
 def test_meta_schedule_no_context():
     with ms.Profiler.timeit("Level0"):
         assert ms.Profiler.current() is None
@@ -43,4 +65,5 @@ def test_meta_schedule_no_context():
 
 if __name__ == "__main__":
     test_meta_schedule_profiler_context_manager()
+    test_meta_schedule_profiler_chrome_trace()
     test_meta_schedule_no_context()
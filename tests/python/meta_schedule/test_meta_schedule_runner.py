@@ -17,7 +17,9 @@
 """ Test Meta Schedule Runner """
 
 import itertools
+import os.path as osp
 import sys
+import tempfile
 import time
 from typing import Any, List
 
@@ -375,6 +377,50 @@ def test_meta_schedule_local_multiple_runs():
         _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_local_batched_runs():
+    """Test meta schedule local runner measuring multiple runs in one batch"""
+    mods = [MatmulModule, MatmulReluModule]
+    builder = LocalBuilder()
+    builder_results = builder.build([BuilderInput(mod, Target("llvm")) for mod in mods])
+    for builder_result in builder_results:
+        assert builder_result.artifact_path is not None
+        assert builder_result.error_msg is None
+    args_info = [
+        TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+    ]
+    runner_inputs = [
+        RunnerInput(builder_result.artifact_path, "llvm", args_info)
+        for builder_result in builder_results
+    ]
+    # An artifact that cannot be loaded only fails its own run
+    runner_inputs.append(RunnerInput("/nonexistent/artifact.tar", "llvm", args_info))
+    evaluator_config = EvaluatorConfig(
+        number=1,
+        repeat=3,
+        min_repeat_ms=0,
+        cache_flush_bytes=1 << 20,
+    )
+    runner = LocalRunner(
+        timeout_sec=100, evaluator_config=evaluator_config, alloc_repeat=2, batched=True
+    )
+    runner_results = [runner_future.result() for runner_future in runner.run(runner_inputs)]
+    assert len(runner_results) == 3
+    for runner_result in runner_results[:2]:
+        assert runner_result.error_msg is None
+        assert len(runner_result.run_secs) == 6
+        for result in runner_result.run_secs:
+            if isinstance(result, FloatImm):
+                result = result.value
+            assert isinstance(result, float)
+            assert result >= 0.0
+    assert runner_results[2].run_secs is None
+    assert "LocalRunner: An exception occurred" in runner_results[2].error_msg
+    for builder_result in builder_results:
+        _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_py_runner():
     """Test meta schedule PyRunner"""
 
@@ -535,6 +581,61 @@ def test_meta_schedule_rpc_runner_exception():
     assert runner_result.run_secs is None
 
 
+def test_meta_schedule_rpc_runner_requeue():
+    """Test meta schedule RPC Runner re-queueing the job of a worker that fails to take it"""
+
+    # The job is submitted to the popen worker twice, which do not share memory.
+    marker = osp.join(tempfile.mkdtemp(), "worker_was_down")
+
+    def flaky_session_creator(rpc_config: RPCConfig) -> RPCSession:
+        if not osp.exists(marker):
+            open(marker, "w").close()  # pylint: disable=consider-using-with
+            raise Exception("The worker is down")
+        return rpc_config.connect_server()
+
+    mod = MatmulModule
+    builder = LocalBuilder()
+    (builder_result,) = builder.build([BuilderInput(mod, Target("llvm"))])
+    assert builder_result.artifact_path is not None
+    assert builder_result.error_msg is None
+
+    runner_input = RunnerInput(
+        builder_result.artifact_path,
+        "llvm",
+        [
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        ],
+    )
+
+    with LocalRPC() as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+        )
+        evaluator_config = EvaluatorConfig(
+            number=1,
+            repeat=1,
+            min_repeat_ms=0,
+            enable_cpu_cache_flush=False,
+        )
+        runner = RPCRunner(
+            rpc_config,
+            evaluator_config,
+            f_create_session=flaky_session_creator,
+            max_retries=1,
+        )
+        (runner_future,) = runner.run([runner_input])
+        runner_result = runner_future.result()
+    assert runner_result.error_msg is None
+    assert len(runner_result.run_secs) == 1
+    _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_local_runner_exception():
     """Test meta schedule Local Runner exception"""
     mod = MatmulModule
@@ -884,5 +884,30 @@ def test_max_pool_blocked():
     )
 
 
+def test_cuda_matmul_pad_shared_memory():
+    rule = ms.schedule_rule.MultiLevelTiling(
+        structure="SSSRRSRS",
+        tile_binds=["blockIdx.x", "vthread.x", "threadIdx.x"],
+        max_innermost_factor=64,
+        vector_load_lens=[1, 2, 3, 4, 8, 16],
+        reuse_read=ms.schedule_rule.ReuseType(req="must", levels=[4], scope="shared", pad=True),
+        reuse_write=ms.schedule_rule.ReuseType(req="must", levels=[3], scope="local"),
+    )
+    mod = te.create_prim_func(te_workload.matmul(512, 512, 512))
+    (sch,) = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-2080"),
+        types=None,
+        sch_rules=[rule],
+    )
+    # Each shared memory cache samples whether it is padded.
+    for name in ["A_shared", "B_shared"]:
+        block = sch.get_sref(sch.get_block(name)).stmt
+        assert int(block.annotations["pad_shared_memory"]) in [0, 1]
+    num_categorical = [inst.kind.name for inst in sch.trace.insts].count("SampleCategorical")
+    assert num_categorical == 4
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -63,6 +63,19 @@ class ParallelizeVectorizeUnroll:
                     C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
 
 
+@tvm.script.ir_module
+class Rowsum:
+    @T.prim_func
+    def main(A: T.Buffer((128, 128), "float32"), B: T.Buffer((128,), "float32")) -> None:
+        T.func_attr({"global_symbol": "main"})
+        for i, k in T.grid(128, 128):
+            with T.block("B"):
+                vi, vk = T.axis.remap("SR", [i, k])
+                with T.init():
+                    B[vi] = 0.0
+                B[vi] = B[vi] + A[vi, vk]
+
+
 # from tvm.script import tir as T
 @tvm.script.ir_module
 class PureSpatial:
@@ -298,6 +311,50 @@ def test_parallel_vectorize_unroll_spatial():
     assert not trace.insts
 
 
+def test_parallel_vectorize_unroll_reduction():
+    @T.prim_func
+    def Rowsum_0(A: T.Buffer((128, 128), "float32"), B: T.Buffer((128,), "float32")) -> None:
+        T.func_attr({"global_symbol": "main"})
+        with T.block("root"):
+            T.reads()
+            T.writes()
+            T.block_attr({"meta_schedule.vectorize": 32})
+            for i, k_0 in T.grid(128, 4):
+                for k_1 in T.vectorized(32):
+                    with T.block("B"):
+                        vi = T.axis.spatial(128, i)
+                        vk = T.axis.reduce(128, k_0 * 32 + k_1)
+                        T.reads(A[vi, vk])
+                        T.writes(B[vi])
+                        with T.init():
+                            B[vi] = T.float32(0)
+                        B[vi] = B[vi] + A[vi, vk]
+
+    mod = Rowsum
+    actual = generate_design_space(
+        kind="llvm",
+        mod=mod,
+        target=Target("llvm --num-cores=32"),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.ParallelizeVectorizeUnroll(
+                max_jobs_per_core=-1,
+                max_vectorize_extent=32,
+                unroll_max_steps=[],
+                unroll_explicit=True,
+                vectorize_reduction=True,
+            ),
+        ],
+    )
+    check_sketches(
+        mod,
+        sketches=actual,
+        expected_mods=[Rowsum_0],
+        expected_decisions=[[]],
+    )
+
+
 if __name__ == "__main__":
     test_parallel_vectorize_unroll()
     test_parallel_vectorize_unroll_spatial()
+    test_parallel_vectorize_unroll_reduction()
@@ -353,6 +353,106 @@ def test_meta_schedule_task_scheduler_multiple_gradient_based():
         )
 
 
+@ms.derived_object
+class ConstantRunnerFuture(ms.runner.PyRunnerFuture):
+    def done(self) -> bool:
+        return True
+
+    def result(self) -> ms.runner.RunnerResult:
+        return ms.runner.RunnerResult([1.0], None)
+
+
+@ms.derived_object
+class ConstantRunner(ms.runner.PyRunner):
+    def run(self, runner_inputs):
+        return [ConstantRunnerFuture() for _ in runner_inputs]  # type: ignore
+
+
+def test_meta_schedule_task_scheduler_gradient_based_early_termination():
+    max_trials_per_task = 101
+    num_trials_per_iter = 6
+    patience = 2
+    tasks = [
+        ms.TuneContext(
+            MatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="Matmul",
+            rand_state=42,
+        ),
+        ms.TuneContext(
+            BatchMatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_batch_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="BatchMatmul",
+            rand_state=0x114514,
+        ),
+    ]
+    database = ms.database.MemoryDatabase()
+    gradient_based = ms.task_scheduler.GradientBased(patience=patience)
+    gradient_based.tune(
+        tasks,
+        task_weights=[1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=ConstantRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=num_trials_per_iter,
+        cost_model=None,
+    )
+    # The latency never improves, so each task stops after the first `patience + 1` rounds.
+    for task in tasks:
+        records = database.get_top_k(database.commit_workload(task.mod), 10000)
+        assert len(records) == num_trials_per_iter * (patience + 1)
+
+
+def test_meta_schedule_task_scheduler_measure_cache():
+    @ms.derived_object
+    class CountingBuilder(ms.builder.PyBuilder):
+        num_built = 0
+
+        def build(self, build_inputs):
+            CountingBuilder.num_built += len(build_inputs)
+            return [ms.builder.BuilderResult("test_path", None) for _ in build_inputs]
+
+    def _tune(database):
+        ms.task_scheduler.RoundRobin().tune(
+            [
+                ms.TuneContext(
+                    MatmulModule,
+                    target=tvm.target.Target("llvm"),
+                    space_generator=_schedule_matmul,
+                    search_strategy=ms.search_strategy.ReplayTrace(),
+                    task_name="Test",
+                    rand_state=42,
+                )
+            ],
+            [1.0],
+            max_trials_global=6,
+            max_trials_per_task=6,
+            num_trials_per_iter=2,
+            builder=CountingBuilder(),
+            runner=ConstantRunner(),
+            database=database,
+            measure_callbacks=[ms.measure_callback.AddToDatabase()],
+            cost_model=None,
+        )
+
+    database = ms.database.MemoryDatabase()
+    # The schedule is fixed, so only the first batch is built, and the rest are cached.
+    _tune(database)
+    assert CountingBuilder.num_built == 2
+    assert len(database) == 6
+    # The tuning resumed from the database measures nothing again.
+    _tune(database)
+    assert CountingBuilder.num_built == 2
+    assert len(database) == 12
+
+
 def test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy():
     """
     When search strategy of one task returns empty list of candidates or None,
@@ -443,4 +543,5 @@ if __name__ == "__main__":
     test_meta_schedule_task_scheduler_avoid_cyclic()
     test_meta_schedule_task_scheduler_override_next_task_id_only()
     test_meta_schedule_task_scheduler_multiple_gradient_based()
+    test_meta_schedule_task_scheduler_measure_cache()
     test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy()
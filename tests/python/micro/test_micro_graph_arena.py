@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the offline arena placement of the C runtime graph executor storage."""
+
+import json
+
+import tvm
+import tvm.relay
+import tvm.testing
+
+
+def _chain_graph():
+    """Return x -> a -> b -> c -> d, with the float32 sizes given per storage id."""
+
+    def tvm_op(name, inputs):
+        return {"op": "tvm_op", "name": name, "attrs": {}, "inputs": [[i, 0, 0] for i in inputs]}
+
+    nodes = [
+        {"op": "null", "name": "x", "inputs": []},
+        {"op": "null", "name": "w", "inputs": []},
+        tvm_op("a", [0, 1]),
+        tvm_op("b", [2]),
+        tvm_op("c", [3]),
+        tvm_op("d", [4]),
+    ]
+    return {
+        "nodes": nodes,
+        "arg_nodes": [0, 1],
+        "heads": [[5, 0, 0]],
+        "node_row_ptr": list(range(len(nodes) + 1)),
+        "attrs": {
+            "dltype": ["list_str", ["float32"] * len(nodes)],
+            "storage_id": ["list_int", list(range(len(nodes)))],
+            "shape": ["list_shape", [[10], [10], [100], [50], [100], [10]]],
+        },
+    }
+
+
+def _check_no_live_overlap(graph, plan):
+    """Check storage ids used by the same node never share bytes."""
+    storage_ids = graph["attrs"]["storage_id"][1]
+    row_ptr = graph["node_row_ptr"]
+    for nid, node in enumerate(graph["nodes"]):
+        eids = [row_ptr[i] + index for i, index, _ in node["inputs"]]
+        eids += list(range(row_ptr[nid], row_ptr[nid + 1]))
+        sids = sorted({storage_ids[eid] for eid in eids if plan.sizes[storage_ids[eid]]})
+        ranges = sorted((plan.offsets[sid], plan.offsets[sid] + plan.sizes[sid]) for sid in sids)
+        for (_, end), (begin, _) in zip(ranges, ranges[1:]):
+            assert end <= begin
+
+
+@tvm.testing.requires_micro
+def test_chain_reuses_dead_storage():
+    import tvm.micro
+
+    graph = _chain_graph()
+    plan = tvm.micro.plan_graph_arena(json.dumps(graph))
+    assert plan.sizes == [40, 40, 400, 200, 400, 40]
+    # a and c are never live together, neither are b and d.
+    assert plan.offsets[2] == plan.offsets[4]
+    assert plan.offsets[3] == plan.offsets[5]
+    assert plan.size < sum(plan.sizes)
+    assert all(offset % 16 == 0 for offset in plan.offsets)
+    _check_no_live_overlap(graph, plan)
+
+    linked = tvm.micro.plan_graph_arena(json.dumps(graph), linked_params=["w"])
+    assert linked.sizes[1] == 0
+    assert linked.size == plan.size - 48
+
+    source = plan.to_c_source("model")
+    assert f"#define MODEL_ARENA_SIZE {plan.size}" in source
+    assert "model_arena_offsets[6]" in source
+
+
+@tvm.testing.requires_micro
+def test_relay_graph():
+    import tvm.micro
+
+    data = tvm.relay.var("data", shape=(1, 8, 16, 16), dtype="float32")
+    out = data
+    for _ in range(4):
+        out = tvm.relay.nn.relu(tvm.relay.nn.max_pool2d(out, padding=(1, 1), strides=(1, 1)))
+    mod = tvm.IRModule.from_expr(tvm.relay.Function([data], out))
+    with tvm.transform.PassContext(opt_level=0):
+        factory = tvm.relay.build(mod, target="c")
+
+    graph = json.loads(factory.get_graph_json())
+    plan = tvm.micro.plan_graph_arena(factory.get_graph_json())
+    assert len(plan.offsets) == max(graph["attrs"]["storage_id"][1]) + 1
+    assert plan.size <= sum((size + 15) // 16 * 16 for size in plan.sizes)
+    _check_no_live_overlap(graph, plan)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
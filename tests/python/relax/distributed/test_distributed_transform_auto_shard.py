@@ -0,0 +1,97 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+#  type: ignore
+
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+import tvm
+from tvm import relax
+from tvm.relax.distributed import Placement
+import tvm.testing
+
+
+def _param_placements(func):
+    return [param.struct_info.placement for param in func.params]
+
+
+def _make_mlp(hidden, intermediate):
+    @I.ir_module
+    class MLP:
+        I.module_attrs({"device_num": 2})
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @R.function
+        def foo(
+            x: R.Tensor((1, hidden), "float32"),
+            weight1: R.Tensor((hidden, intermediate), "float32"),
+            weight2: R.Tensor((intermediate, hidden), "float32"),
+        ) -> R.Tensor((1, hidden), "float32"):
+            R.func_attr({"num_input": 1})
+            lv0 = R.matmul(x, weight1)
+            lv1 = R.nn.gelu(lv0)
+            lv2 = R.matmul(lv1, weight2)
+            return lv2
+
+    return MLP
+
+
+def _sharded_placements(mod):
+    mesh = mod.global_infos["mesh"][0]
+    mod = relax.distributed.transform.AutoShard(mesh)(mod)
+    mod = relax.distributed.transform.PropagateSharding()(mod)
+    return _param_placements(mod["foo"])
+
+
+def test_mlp_tensor_parallel():
+    # The weights are sharded Megatron-style: the columns of the first, the rows of the second,
+    # so only the output is allreduced.
+    placements = _sharded_placements(_make_mlp(4096, 16384))
+    expected = [Placement.from_text(text) for text in ["R", "S[1]", "S[0]"]]
+    for placement, expected_placement in zip(placements, expected):
+        tvm.ir.assert_structural_equal(placement, expected_placement)
+
+
+def test_small_mlp_replicated():
+    # The communication outweighs the compute of a small MLP.
+    placements = _sharded_placements(_make_mlp(8, 16))
+    for placement in placements:
+        tvm.ir.assert_structural_equal(placement, Placement.from_text("R"))
+
+
+def test_annotated_function_unchanged():
+    @I.ir_module
+    class MLP:
+        I.module_attrs({"device_num": 2})
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @R.function
+        def foo(
+            x: R.Tensor((1, 4096), "float32"),
+            weight1: R.Tensor((4096, 16384), "float32"),
+        ) -> R.Tensor((1, 16384), "float32"):
+            lv0 = R.matmul(x, weight1)
+            lv1 = R.dist.annotate_sharding(lv0, device_mesh="mesh[0]", placement="R")
+            return lv1
+
+    mesh = MLP.global_infos["mesh"][0]
+    after = relax.distributed.transform.AutoShard(mesh)(MLP)
+    tvm.ir.assert_structural_equal(after, MLP)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
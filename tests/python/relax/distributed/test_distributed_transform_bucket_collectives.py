@@ -0,0 +1,145 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+#  type: ignore
+
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+import tvm
+from tvm import relax
+import tvm.testing
+
+
+def _bound_ops(func):
+    ops = []
+    for block in func.body.blocks:
+        for binding in block.bindings:
+            if isinstance(binding.value, relax.Call) and isinstance(binding.value.op, tvm.ir.Op):
+                ops.append(binding.value.op.name)
+    return ops
+
+
+def test_bucket_allreduce():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((1, 64), "float32"),
+            w0: R.Tensor((64, 32), "float32"),
+            w1: R.Tensor((64, 16), "float32"),
+            w2: R.Tensor((64, 16), "float32"),
+        ):
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                lv1 = R.ccl.allreduce(lv0, "sum")
+                lv2 = R.add(lv1, lv1)
+                lv3 = R.matmul(x, w1)
+                lv4 = R.ccl.allreduce(lv3, "sum")
+                lv5 = R.matmul(x, w2)
+                gv = (lv2, lv4, lv5)
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((1, 64), "float32"),
+            w0: R.Tensor((64, 32), "float32"),
+            w1: R.Tensor((64, 16), "float32"),
+            w2: R.Tensor((64, 16), "float32"),
+        ):
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                lv3 = R.matmul(x, w1)
+                flat0 = R.reshape(lv0, R.shape([32]))
+                flat1 = R.reshape(lv3, R.shape([16]))
+                flat = R.concat((flat0, flat1), axis=0)
+                reduced = R.ccl.allreduce(flat, "sum")
+                parts = R.split(reduced, indices_or_sections=[32], axis=0)
+                lv1 = R.reshape(parts[0], R.shape([1, 32]))
+                lv4 = R.reshape(parts[1], R.shape([1, 16]))
+                lv2 = R.add(lv1, lv1)
+                lv5 = R.matmul(x, w2)
+                gv = (lv2, lv4, lv5)
+                R.output(gv)
+            return gv
+
+    after = relax.distributed.transform.BucketCollectives()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_bucket_allgather():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((2, 8), "float16"), y: R.Tensor((4,), "float16")):
+            with R.dataflow():
+                lv0 = R.ccl.allgather(x, num_workers=2)
+                lv1 = R.ccl.allgather(y, num_workers=2)
+                gv = (lv0, lv1)
+                R.output(gv)
+            return gv
+
+    after = relax.distributed.transform.BucketCollectives()(Before)
+    assert _bound_ops(after["main"]).count("relax.ccl.allgather") == 1
+    tvm.ir.assert_structural_equal(
+        after["main"].ret_struct_info, Before["main"].ret_struct_info
+    )
+    assert relax.analysis.well_formed(after)
+
+
+def test_no_bucket_of_dependent_collectives():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((1, 64), "float32"), w: R.Tensor((64, 64), "float32")):
+            with R.dataflow():
+                lv0 = R.matmul(x, w)
+                lv1 = R.ccl.allreduce(lv0, "sum")
+                lv2 = R.matmul(lv1, w)
+                lv3 = R.ccl.allreduce(lv2, "sum")
+                R.output(lv3)
+            return lv3
+
+    after = relax.distributed.transform.BucketCollectives()(Module)
+    tvm.ir.assert_structural_equal(after, Module)
+
+
+def test_no_bucket_of_large_or_mismatched_collectives():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(
+            x: R.Tensor((1024, 1024), "float32"),
+            y: R.Tensor((16,), "float32"),
+            z: R.Tensor((16,), "float32"),
+        ):
+            with R.dataflow():
+                lv0 = R.ccl.allreduce(x, "sum")
+                lv1 = R.ccl.allreduce(y, "sum")
+                lv2 = R.ccl.allreduce(z, "max")
+                gv = (lv0, lv1, lv2)
+                R.output(gv)
+            return gv
+
+    after = relax.distributed.transform.BucketCollectives(max_bucket_bytes=1024)(Module)
+    tvm.ir.assert_structural_equal(after, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
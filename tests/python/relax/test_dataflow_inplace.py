@@ -640,5 +640,168 @@ def test_dynamic_mismatch():
     tvm.ir.assert_structural_equal(new_mod, DynamicMistmatchTestCase)
 
 
+def test_inplace_across_blocks():
+    # z is defined in the first block and dies in the second one,
+    # so the fused elementwise call can overwrite it
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def fused_add_exp(
+            A: T.Buffer((2, 3), "float32"),
+            B: T.Buffer((2, 3), "float32"),
+            C: T.Buffer((2, 3), "float32"),
+        ):
+            for i, j in T.grid(2, 3):
+                with T.block("T_add_exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    T.reads(A[vi, vj], B[vi, vj])
+                    T.writes(C[vi, vj])
+                    C[vi, vj] = T.exp(A[vi, vj] + B[vi, vj])
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((2, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Before
+            with R.dataflow():
+                z = R.call_tir(cls.fused_add_exp, (x, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(z)
+            with R.dataflow():
+                w = R.call_tir(cls.fused_add_exp, (z, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(w)
+            return w
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def fused_add_exp(
+            A: T.Buffer((2, 3), "float32"),
+            B: T.Buffer((2, 3), "float32"),
+            C: T.Buffer((2, 3), "float32"),
+        ):
+            for i, j in T.grid(2, 3):
+                with T.block("T_add_exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    T.reads(A[vi, vj], B[vi, vj])
+                    T.writes(C[vi, vj])
+                    C[vi, vj] = T.exp(A[vi, vj] + B[vi, vj])
+
+        @T.prim_func(private=True)
+        def fused_add_exp_inplace(A: T.Buffer((2, 3), "float32"), B: T.Buffer((2, 3), "float32")):
+            for i, j in T.grid(2, 3):
+                with T.block("T_add_exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    T.reads(A[vi, vj], B[vi, vj])
+                    T.writes(A[vi, vj])
+                    A[vi, vj] = T.exp(A[vi, vj] + B[vi, vj])
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((2, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Expected
+            with R.dataflow():
+                z = R.call_tir(cls.fused_add_exp, (x, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(z)
+            with R.dataflow():
+                w = R.call_tir_inplace(
+                    cls.fused_add_exp_inplace,
+                    (z, y),
+                    inplace_indices=[0],
+                    out_sinfo=R.Tensor((2, 3), "float32"),
+                )
+                R.output(w)
+            return w
+
+    new_mod = DataflowUseInplaceCalls()(Before)
+    tvm.ir.assert_structural_equal(new_mod, Expected)
+
+    x = np.random.rand(2, 3).astype("float32")
+    y = np.random.rand(2, 3).astype("float32")
+    ex = relax.build(new_mod, tvm.target.Target("llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    res = vm["main"](tvm.nd.array(x), tvm.nd.array(y))
+    np.testing.assert_allclose(res.numpy(), np.exp(np.exp(x + y) + y), rtol=1e-5)
+
+
+def test_no_inplace_across_blocks_if_live():
+    @I.ir_module
+    class LiveAfter:
+        @T.prim_func(private=True)
+        def fused_add_exp(
+            A: T.Buffer((2, 3), "float32"),
+            B: T.Buffer((2, 3), "float32"),
+            C: T.Buffer((2, 3), "float32"),
+        ):
+            for i, j in T.grid(2, 3):
+                with T.block("T_add_exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = T.exp(A[vi, vj] + B[vi, vj])
+
+        @R.function
+        def main(x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((2, 3), dtype="float32")):
+            cls = LiveAfter
+            with R.dataflow():
+                z = R.call_tir(cls.fused_add_exp, (x, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(z)
+            with R.dataflow():
+                w = R.call_tir(cls.fused_add_exp, (z, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(w)
+            # z is still needed after the second block
+            return (w, z)
+
+    @I.ir_module
+    class Escaped:
+        @T.prim_func(private=True)
+        def fused_add_exp(
+            A: T.Buffer((2, 3), "float32"),
+            B: T.Buffer((2, 3), "float32"),
+            C: T.Buffer((2, 3), "float32"),
+        ):
+            for i, j in T.grid(2, 3):
+                with T.block("T_add_exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = T.exp(A[vi, vj] + B[vi, vj])
+
+        @R.function(pure=False)
+        def main(x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((2, 3), dtype="float32")):
+            cls = Escaped
+            with R.dataflow():
+                z = R.call_tir(cls.fused_add_exp, (x, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(z)
+            # the callee may keep a reference to z
+            _ = R.call_packed("test.store", z, sinfo_args=R.Tuple())
+            with R.dataflow():
+                w = R.call_tir(cls.fused_add_exp, (z, y), out_sinfo=R.Tensor((2, 3), "float32"))
+                R.output(w)
+            return w
+
+    for mod in [LiveAfter, Escaped]:
+        tvm.ir.assert_structural_equal(DataflowUseInplaceCalls()(mod), mod)
+
+
+def test_no_inplace_call_tir_not_elementwise():
+    @I.ir_module
+    class Transpose:
+        @T.prim_func(private=True)
+        def transpose(A: T.Buffer((3, 3), "float32"), B: T.Buffer((3, 3), "float32")):
+            for i, j in T.grid(3, 3):
+                with T.block("T_transpose"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vj, vi]
+
+        @R.function
+        def main(x: R.Tensor((3, 3), dtype="float32")) -> R.Tensor((3, 3), dtype="float32"):
+            cls = Transpose
+            with R.dataflow():
+                y = R.add(x, x)
+                # y dies here, but the transpose reads elements it would already have overwritten
+                z = R.call_tir(cls.transpose, (y,), out_sinfo=R.Tensor((3, 3), "float32"))
+                R.output(z)
+            return z
+
+    tvm.ir.assert_structural_equal(DataflowUseInplaceCalls()(Transpose), Transpose)
+
+
 if __name__ == "__main__":
     testing.main()
@@ -1166,6 +1166,68 @@ def test_renormalize_top_p_top_k_prob():
     )
 
 
+def test_apply_penalties_and_softmax():
+    batch, vocab_size, num_tokens = 2, 5, 3
+
+    class Model(Module):
+        def foo(
+            self,
+            logits: Tensor,
+            indptr: Tensor,
+            token_ids: Tensor,
+            token_cnt: Tensor,
+            penalties: Tensor,
+            temperature: Tensor,
+        ):
+            return op.apply_penalties_and_softmax(
+                logits, indptr, token_ids, token_cnt, penalties, temperature
+            )
+
+    m = Model()
+    mod, _ = m.export_tvm(
+        spec={
+            "foo": {
+                "logits": spec.Tensor((batch, vocab_size), "float32"),
+                "indptr": spec.Tensor((batch + 1,), "int32"),
+                "token_ids": spec.Tensor((num_tokens,), "int32"),
+                "token_cnt": spec.Tensor((num_tokens,), "int32"),
+                "penalties": spec.Tensor((batch, 3), "float32"),
+                "temperature": spec.Tensor((batch, 1), "float32"),
+            }
+        },
+        debug=True,
+    )
+
+    target = tvm.target.Target("llvm")
+    with target:
+        mod = relax.transform.LegalizeOps()(mod)
+    ex = relax.build(mod, target)
+    dev = tvm.cpu(0)
+    vm = relax.VirtualMachine(ex, dev)
+
+    logits = np.array([[1.0, -2.0, 3.0, 0.5, 0.0], [2.0, 1.0, -1.0, 0.0, 4.0]], "float32")
+    indptr = np.array([0, 2, 3], "int32")
+    token_ids = np.array([0, 1, 4], "int32")
+    token_cnt = np.array([1, 2, 3], "int32")
+    penalties = np.array([[0.5, 0.25, 2.0], [0.0, 0.0, 1.0]], "float32")
+    temperature = np.array([[0.5], [1.0]], "float32")
+
+    expected = logits.copy()
+    for i in range(batch):
+        presence, frequency, repetition = penalties[i]
+        for p in range(indptr[i], indptr[i + 1]):
+            x = expected[i, token_ids[p]]
+            x = x / repetition if x > 0 else x * repetition
+            expected[i, token_ids[p]] = x - token_cnt[p] * frequency - presence
+    expected = np.exp((expected - expected.max(axis=1, keepdims=True)) / temperature)
+    expected /= expected.sum(axis=1, keepdims=True)
+
+    effects = vm["_initialize_effect"]()
+    inputs = [logits, indptr, token_ids, token_cnt, penalties, temperature]
+    res = vm["foo"](*[tvm.nd.array(x, dev) for x in inputs], effects)
+    tvm.testing.assert_allclose(res[0].numpy(), expected, rtol=1e-5, atol=1e-6)
+
+
 def test_sort_argsort_topk():
     class Model(Module):
         def foo(self, x: Tensor):
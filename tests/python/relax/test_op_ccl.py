@@ -28,6 +28,9 @@ def test_op_correctness():
     assert relax.op.ccl.allreduce(x).op == Op.get("relax.ccl.allreduce")
     assert relax.op.ccl.broadcast_from_worker0(x).op == Op.get("relax.ccl.broadcast_from_worker0")
     assert relax.op.ccl.allgather(x, 2).op == Op.get("relax.ccl.allgather")
+    assert relax.op.ccl.allreduce(x).attrs.group == ""
+    assert relax.op.ccl.allreduce(x, "sum", group="tp").attrs.group == "tp"
+    assert relax.op.ccl.allgather(x, 2, group="dp").attrs.group == "dp"
 
 
 def _check_inference(bb: relax.BlockBuilder, call: relax.Call, expected_sinfo: relax.StructInfo):
@@ -1808,5 +1808,47 @@ def test_pad_infer_struct_info():
     )
 
 
+
+def test_lora_bgmv_infer_struct_info():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", R.Tensor((n, 64), "float16"))
+    a = relax.Var("a", R.Tensor((4, 8, 64), "float16"))
+    b = relax.Var("b", R.Tensor((4, 32, 8), "float16"))
+    indices = relax.Var("indices", R.Tensor((n,), "int32"))
+    x1 = relax.Var("x", R.Tensor("float16", ndim=2))
+
+    assert relax.op.nn.lora_bgmv(x, a, b, indices).op == Op.get("relax.nn.lora_bgmv")
+    _check_inference(
+        bb, relax.op.nn.lora_bgmv(x, a, b, indices), relax.TensorStructInfo((n, 32), "float16")
+    )
+    _check_inference(
+        bb,
+        relax.op.nn.lora_bgmv(x1, a, b, indices),
+        relax.TensorStructInfo(dtype="float16", ndim=2),
+    )
+
+
+def test_lora_bgmv_infer_struct_info_mismatch():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", R.Tensor((16, 64), "float16"))
+    a = relax.Var("a", R.Tensor((4, 8, 64), "float16"))
+    b = relax.Var("b", R.Tensor((4, 32, 8), "float16"))
+    indices = relax.Var("indices", R.Tensor((16,), "int32"))
+    a_rank = relax.Var("a", R.Tensor((4, 16, 64), "float16"))
+    b_fp32 = relax.Var("b", R.Tensor((4, 32, 8), "float32"))
+    indices_fp = relax.Var("indices", R.Tensor((16,), "float32"))
+    indices_len = relax.Var("indices", R.Tensor((8,), "int32"))
+
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.nn.lora_bgmv(x, a_rank, b, indices))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.nn.lora_bgmv(x, a, b_fp32, indices))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.nn.lora_bgmv(x, a, b, indices_fp))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.nn.lora_bgmv(x, a, b, indices_len))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -16,7 +16,9 @@
 # under the License.
 import tvm
 import tvm.testing
+from tvm import relax
 from tvm.contrib import tvmjs, utils
+from tvm.script import ir as I, relax as R
 
 import pytest
 import numpy as np
@@ -168,6 +170,45 @@ def test_attention_kv_cache():
         assert res[i][1] == i
 
 
+def test_attention_kv_cache_array_append():
+    fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create")
+    freserve = tvm.get_global_func("vm.builtin.attention_kv_cache_array_reserve")
+    fappend = tvm.get_global_func("vm.builtin.attention_kv_cache_array_append")
+    fview = tvm.get_global_func("vm.builtin.attention_kv_cache_view")
+
+    caches = [
+        fcreate(tvm.nd.empty((1, 2), dtype="int32"), tvm.runtime.ShapeTuple([1, 2]), 0)
+        for _ in range(3)
+    ]
+    freserve(caches, 4)
+    num_steps = 7
+    for i in range(num_steps):
+        values = [tvm.nd.array((i + j) * np.ones((1, 2)).astype("int32")) for j in range(3)]
+        caches = fappend(caches, values)
+
+    for j, cache in enumerate(caches):
+        res = fview(cache, tvm.runtime.ShapeTuple((num_steps, 2))).numpy()
+        np.testing.assert_equal(res[:, 0], np.arange(num_steps) + j)
+
+
+def test_attention_kv_cache_window_override_grow():
+    fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create")
+    foverride = tvm.get_global_func("vm.builtin.attention_kv_cache_window_override")
+    fview = tvm.get_global_func("vm.builtin.attention_kv_cache_view")
+
+    # The reserved slots are not a divisor of the window.
+    cache = fcreate(tvm.nd.empty((1, 2), dtype="int32"), tvm.runtime.ShapeTuple([5, 2]), 0)
+    np_all_arrays = np.zeros((0, 2)).astype("int32")
+    for i in range(1, 6):
+        np_array = i * np.ones((i, 2)).astype("int32")
+        np_all_arrays = np.concatenate((np_all_arrays, np_array), axis=0)
+        cache = foverride(cache, tvm.nd.array(np_array), 12)
+
+    # 15 values wrap around the window of 12 by 3.
+    res = fview(cache, tvm.runtime.ShapeTuple((12, 2))).numpy()
+    np.testing.assert_equal(np.concatenate((res[3:], res[:3])), np_all_arrays[-12:])
+
+
 def test_ndarray_cache():
     fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
     fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
@@ -188,6 +229,83 @@ def test_ndarray_cache():
         np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_ndarray_cache_mmap():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    fclear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    param_dict = {
+        "y_0": np.array([1, 2, 3], dtype="int32"),
+        "y_1": np.random.uniform(size=[10, 20]).astype("float32"),
+        "y_2": np.random.uniform(size=[7]).astype("float16"),
+    }
+
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format="raw")
+    fload(str(temp.path), tvm.cpu().device_type, 0, True)
+    res = fget_params("y", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        np.testing.assert_equal(v.numpy(), param_dict[f"y_{i}"])
+    # The views keep the mapping alive after the cache drops them.
+    fclear()
+    for i, v in enumerate(res):
+        np.testing.assert_equal(v.numpy(), param_dict[f"y_{i}"])
+
+
+def test_ndarray_cache_pipelined():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    # Each array fills its own shard, so readers work on several shards at once.
+    param_dict = {f"z_{i}": np.random.uniform(size=[300000]).astype("float32") for i in range(5)}
+    param_dict["z_5"] = np.random.uniform(size=[10, 20]).astype("float32")
+
+    for encode_format in ["raw", "f32-to-bf16"]:
+        temp = utils.tempdir()
+        tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format=encode_format, shard_cap_mb=1)
+        fload(str(temp.path), tvm.cpu().device_type, 0, False, 2)
+        res = fget_params("z", -1)
+        assert len(res) == len(param_dict)
+        for i, v in enumerate(res):
+            v_np = param_dict[f"z_{i}"]
+            if encode_format == "f32-to-bf16":
+                v_np = tvmjs._convert_bf16_to_f32(tvmjs._convert_f32_to_bf16(v_np))
+            np.testing.assert_equal(v.numpy(), v_np)
+
+
+def test_ndarray_cache_decode_formats():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    param_dict = {
+        "w_0": np.random.uniform(size=[10, 20]).astype("float32"),
+        "w_1": np.random.randint(-8, 8, size=[5, 7]).astype("int8"),
+        "w_2": np.array([1, 2, 3], dtype="int32"),
+    }
+    # Only the parameters of the dtype the format decodes to are encoded.
+    expected = {
+        "f32-to-f16": dict(param_dict, w_0=param_dict["w_0"].astype("float16").astype("float32")),
+        "int8-to-int4": param_dict,
+    }
+
+    def check(encode_format):
+        temp = utils.tempdir()
+        tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format=encode_format)
+        fload(str(temp.path), tvm.cpu().device_type, 0)
+        res = fget_params("w", -1)
+        assert len(res) == len(param_dict)
+        for i, v in enumerate(res):
+            np.testing.assert_equal(v.numpy(), expected[encode_format][f"w_{i}"])
+
+    # Decode on the host, and then with the kernels built for the CPU.
+    for encode_format in expected:
+        check(encode_format)
+    tvmjs.register_ndarray_cache_decoders("llvm")
+    for encode_format in expected:
+        check(encode_format)
+
+
 def test_ndarray_cache_update():
     fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
     fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
@@ -213,6 +331,46 @@ def test_ndarray_cache_update():
         np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_offloaded_param_module():
+    fupdate = tvm.get_global_func("vm.builtin.ndarray_cache.update")
+    fcreate = tvm.get_global_func("vm.builtin.offloaded_param_module_from_cache_by_name")
+
+    names = [f"offload_{i}" for i in range(4)]
+    params = [np.random.uniform(size=[1024]).astype("float32") for _ in names]
+    for name, param in zip(names, params):
+        fupdate(name, tvm.nd.array(param), True)
+
+    # The ring buffer holds three parameters, and prefetches one parameter ahead.
+    mod = fcreate(names, tvm.cpu(), 3 * 4096, False)
+    fget_param, fnum_uploads = mod["get_param"], mod["num_uploads"]
+    for index, num_uploads in [(0, 2), (1, 3), (2, 4), (0, 6), (3, 6)]:
+        np.testing.assert_equal(fget_param(index, "w").numpy(), params[index])
+        assert fnum_uploads() == num_uploads
+    with pytest.raises(tvm.TVMError):
+        fcreate(names, tvm.cpu(), 4096, False)
+
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(
+            x: R.Tensor((1024,), "float32"),
+            w0: R.Tensor((1024,), "float32"),
+            w1: R.Tensor((1024,), "float32"),
+        ):
+            R.func_attr({"num_input": 1})
+            y = R.add(x, w0)
+            z = R.multiply(y, w1)
+            return z
+
+    # The function fetches its parameters from the module as it runs.
+    ex = relax.build(relax.transform.LazyGetInput()(Module), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    mod = fcreate(names[:2], tvm.cpu(), 2 * 4096, True)
+    x_np = np.random.uniform(size=[1024]).astype("float32")
+    res = vm["main"](tvm.nd.array(x_np), mod["get_param"])
+    np.testing.assert_allclose(res.numpy(), (x_np + params[0]) * params[1], rtol=1e-6)
+
+
 def test_attention_kv_cache_window_override():
     fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create")
     foverride = tvm.get_global_func("vm.builtin.attention_kv_cache_window_override")
@@ -283,5 +441,104 @@ def test_attention_kv_cache_window_override_with_sinks():
     ).all()
 
 
+def test_batched_sample_from_logits():
+    fsample = tvm.get_global_func("vm.builtin.batched_sample_from_logits")
+
+    batch_size, vocab_size = 6, 1000
+    np.random.seed(0)
+    logits = np.random.uniform(-5, 5, size=(batch_size, vocab_size)).astype("float32")
+    # rows 0 and 1 have a dominant token, row 2 is greedy
+    logits[0, 17] = 100.0
+    logits[1, 42] = 100.0
+    temperature = np.array([1.0, 1.0, 0.0, 1.0, 1.0, 0.7], dtype="float32")
+    top_p = np.array([0.9, 1.0, 0.9, 1.0, 0.5, 0.95], dtype="float32")
+    top_k = np.array([0, 0, 0, 1, 3, 50], dtype="int32")
+    seed = np.arange(batch_size, dtype="int64")
+
+    def sample(seed):
+        return fsample(
+            tvm.nd.array(logits),
+            tvm.nd.array(temperature),
+            tvm.nd.array(top_p),
+            tvm.nd.array(top_k),
+            tvm.nd.array(seed),
+        ).numpy()
+
+    res = sample(seed)
+    assert res.shape == (batch_size,)
+    assert res[0] == 17
+    assert res[1] == 42
+    assert res[2] == np.argmax(logits[2])
+    assert res[3] == np.argmax(logits[3])
+    assert res[4] in np.argsort(-logits[4])[:3]
+    assert res[5] in np.argsort(-logits[5])[:50]
+    # the same seeds give the same samples
+    np.testing.assert_equal(res, sample(seed))
+
+
+
+def test_ragged_batch():
+    fpack = tvm.get_global_func("vm.builtin.ragged_pack")
+    funpack = tvm.get_global_func("vm.builtin.ragged_unpack")
+    ffrom_padded = tvm.get_global_func("vm.builtin.ragged_from_padded")
+    fto_padded = tvm.get_global_func("vm.builtin.ragged_to_padded")
+
+    lengths = [3, 0, 5, 1]
+    seqs = [np.random.rand(length, 2, 4).astype("float32") for length in lengths]
+    values, indptr = fpack([tvm.nd.array(seq) for seq in seqs])
+    np.testing.assert_equal(values.numpy(), np.concatenate(seqs))
+    np.testing.assert_equal(indptr.numpy(), np.array([0, 3, 3, 8, 9], dtype="int32"))
+
+    unpacked = funpack(values, indptr)
+    assert len(unpacked) == len(seqs)
+    for seq, res in zip(seqs, unpacked):
+        np.testing.assert_equal(res.numpy(), seq)
+
+    padded = fto_padded(values, indptr, 6).numpy()
+    expected = np.zeros((len(seqs), 6, 2, 4), dtype="float32")
+    for i, seq in enumerate(seqs):
+        expected[i, : len(seq)] = seq
+    np.testing.assert_equal(padded, expected)
+
+    values, indptr = ffrom_padded(tvm.nd.array(padded), tvm.runtime.ShapeTuple(lengths))
+    np.testing.assert_equal(values.numpy(), np.concatenate(seqs))
+    np.testing.assert_equal(indptr.numpy(), np.array([0, 3, 3, 8, 9], dtype="int32"))
+
+    with pytest.raises(tvm.TVMError):
+        fto_padded(values, indptr, 4)
+
+
+
+def test_copy_to_host_async_cpu():
+    fcopy = tvm.get_global_func("vm.builtin.copy_to_host_async")
+    x_np = np.random.rand(3, 4).astype("float32")
+    future = fcopy(tvm.nd.array(x_np), None)
+    assert future.done()
+    np.testing.assert_equal(future.result().numpy(), x_np)
+    dst = tvm.nd.empty((3, 4), "float32")
+    assert fcopy(tvm.nd.array(x_np), dst).result().same_as(dst)
+    np.testing.assert_equal(dst.numpy(), x_np)
+
+
+@tvm.testing.requires_cuda
+def test_copy_to_host_async_cuda():
+    falloc = tvm.get_global_func("vm.builtin.alloc_pinned_host")
+    fcopy = tvm.get_global_func("vm.builtin.copy_to_host_async")
+    dev = tvm.cuda()
+    pinned = falloc(tvm.runtime.ShapeTuple([16, 32]), "float32", dev)
+    assert pinned.device == tvm.cpu()
+    inputs = [np.random.rand(16, 32).astype("float32") for _ in range(4)]
+    futures = [fcopy(tvm.nd.array(x_np, dev), None) for x_np in inputs[:-1]]
+    futures.append(fcopy(tvm.nd.array(inputs[-1], dev), pinned))
+    done = []
+    futures[0].add_done_callback(lambda future: done.append(future.result().shape))
+    for x_np, future in zip(inputs, futures):
+        res = future.result()
+        assert res.device == tvm.cpu()
+        np.testing.assert_equal(res.numpy(), x_np)
+    assert futures[-1].result().same_as(pinned)
+    assert done == [(16, 32)]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,79 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.runtime import ShapeTuple
+
+# Tokens 0-25 are the letters, and tokens 26-28 are the bytes of "€".
+TOKENS = [bytes([ord("a") + i]) for i in range(26)] + [b"\xe2", b"\x82", b"\xac"]
+EURO = [26, 27, 28]
+
+f_create = tvm.get_global_func("vm.builtin.detokenizer_create")
+f_add_sequence = tvm.get_global_func("vm.builtin.detokenizer_add_sequence")
+f_remove_sequence = tvm.get_global_func("vm.builtin.detokenizer_remove_sequence")
+f_append = tvm.get_global_func("vm.builtin.detokenizer_append")
+f_is_stopped = tvm.get_global_func("vm.builtin.detokenizer_is_stopped")
+
+
+def _create_detokenizer():
+    offsets = np.cumsum([0] + [len(token) for token in TOKENS]).astype("int32")
+    token_bytes = np.frombuffer(b"".join(TOKENS), dtype="uint8")
+    return f_create(tvm.nd.array(token_bytes), tvm.nd.array(offsets))
+
+
+def _tokens(text):
+    return ShapeTuple([ord(c) - ord("a") for c in text])
+
+
+def test_utf8():
+    detokenizer = _create_detokenizer()
+    f_add_sequence(detokenizer, 0, [])
+    assert f_append(detokenizer, 0, _tokens("ab")) == "ab"
+    # The incomplete character is held until its last byte.
+    assert f_append(detokenizer, 0, ShapeTuple(EURO[:2])) == ""
+    assert f_append(detokenizer, 0, ShapeTuple(EURO[2:] + [2])) == "€c"
+    # The incomplete character is replaced when the sequence is removed.
+    assert f_append(detokenizer, 0, ShapeTuple(EURO[:1])) == ""
+    assert f_remove_sequence(detokenizer, 0) == "�"
+
+
+def test_stop_strings():
+    detokenizer = _create_detokenizer()
+    f_add_sequence(detokenizer, 0, ["abd", "bc"])
+    f_add_sequence(detokenizer, 1, ["abd", "bc"])
+    f_add_sequence(detokenizer, 2, ["cab"])
+    # "ab" is held as the prefix of "abd" until "bc" occurs.
+    assert f_append(detokenizer, 0, _tokens("xa")) == "x"
+    assert f_append(detokenizer, 0, _tokens("b")) == ""
+    assert not f_is_stopped(detokenizer, 0)
+    assert f_append(detokenizer, 0, _tokens("cd")) == "a"
+    assert f_is_stopped(detokenizer, 0)
+    assert f_append(detokenizer, 0, _tokens("e")) == ""
+    # The held prefix is emitted once it cannot begin a stop string.
+    assert f_append(detokenizer, 1, _tokens("ab")) == ""
+    assert f_append(detokenizer, 1, _tokens("e")) == "abe"
+    assert not f_is_stopped(detokenizer, 1)
+    assert f_append(detokenizer, 2, _tokens("ccabd")) == "c"
+    assert f_is_stopped(detokenizer, 2)
+    for seq_id in range(3):
+        f_remove_sequence(detokenizer, seq_id)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.runtime import ShapeTuple
+
+f_compile = tvm.get_global_func("vm.builtin.grammar_compile")
+f_get_initial_state = tvm.get_global_func("vm.builtin.grammar_get_initial_state")
+f_accept_token = tvm.get_global_func("vm.builtin.grammar_accept_token")
+f_is_accepting = tvm.get_global_func("vm.builtin.grammar_is_accepting")
+f_fill_bitmask = tvm.get_global_func("vm.builtin.grammar_fill_next_token_bitmask")
+f_apply_bitmask = tvm.get_global_func("vm.builtin.apply_token_bitmask_inplace")
+
+STOP = b"</s>"
+
+
+def _compile(grammar, tokens, max_rule_depth=1):
+    offsets = np.cumsum([0] + [len(token) for token in tokens]).astype("int32")
+    token_bytes = np.frombuffer(b"".join(tokens), dtype="uint8")
+    return f_compile(
+        grammar,
+        "root",
+        tvm.nd.array(token_bytes),
+        tvm.nd.array(offsets),
+        ShapeTuple([tokens.index(STOP)]),
+        max_rule_depth,
+    )
+
+
+def _allowed_tokens(grammar, tokens, states):
+    bitmask = tvm.nd.empty((len(states), (len(tokens) + 31) // 32), "int32")
+    f_fill_bitmask(grammar, ShapeTuple(states), bitmask)
+    bits = np.unpackbits(bitmask.numpy().view("uint8"), axis=-1, bitorder="little")
+    return [{tokens[i] for i in np.nonzero(row[: len(tokens)])[0]} for row in bits]
+
+
+def _accept(grammar, state, tokens, text):
+    for token in text:
+        state = f_accept_token(grammar, state, tokens.index(token))
+    return state
+
+
+def test_grammar_mask():
+    tokens = [b"a", b"b", b"ab", b"ba", b"c", STOP]
+    grammar = _compile(
+        """
+        # One or more "a", then "b".
+        root ::= "a"+ "b"
+        """,
+        tokens,
+    )
+    init = f_get_initial_state(grammar)
+    after_a = _accept(grammar, init, tokens, [b"a"])
+    after_ab = _accept(grammar, init, tokens, [b"ab"])
+    assert f_accept_token(grammar, init, tokens.index(b"b")) == -1
+    assert not f_is_accepting(grammar, after_a)
+    assert f_is_accepting(grammar, after_ab)
+    assert _allowed_tokens(grammar, tokens, [init, after_a, after_ab, -1]) == [
+        {b"a", b"ab"},
+        {b"a", b"b", b"ab"},
+        {STOP},
+        set(tokens),
+    ]
+
+
+def test_grammar_recursion():
+    tokens = [b"(", b")", b"()", STOP]
+    grammar = _compile('root ::= "(" root ")" | ""', tokens, max_rule_depth=3)
+    init = f_get_initial_state(grammar)
+    # The nesting is bounded by the maximum rule depth.
+    state = _accept(grammar, init, tokens, [b"(", b"()"])
+    assert f_accept_token(grammar, init, tokens.index(b")")) == -1
+    assert _allowed_tokens(grammar, tokens, [state]) == [{b")"}]
+    state = _accept(grammar, init, tokens, [b"("])
+    assert _allowed_tokens(grammar, tokens, [state]) == [{b"(", b")", b"()"}]
+    state = _accept(grammar, state, tokens, [b"("])
+    assert _allowed_tokens(grammar, tokens, [state]) == [{b")"}]
+    assert f_is_accepting(grammar, _accept(grammar, state, tokens, [b")", b")"]))
+
+
+def test_grammar_char_class():
+    tokens = ["a", "é", "€", "b", "=", STOP]
+    tokens = [token.encode() if isinstance(token, str) else token for token in tokens]
+    # The first byte of a multi-byte character is allowed as a token of its own.
+    tokens += [b"\xc3", b"\xa9"]
+    grammar = _compile('root ::= [^a-b] [a-z=]{1,2} | "b" "="?', tokens)
+    init = f_get_initial_state(grammar)
+    assert _allowed_tokens(grammar, tokens, [init]) == [
+        {"é".encode(), "€".encode(), b"b", b"=", b"\xc3"}
+    ]
+    state = _accept(grammar, init, tokens, [b"\xc3", b"\xa9", b"a"])
+    assert _allowed_tokens(grammar, tokens, [state]) == [{b"a", b"b", b"=", STOP}]
+    state = _accept(grammar, init, tokens, [b"b"])
+    assert _allowed_tokens(grammar, tokens, [state]) == [{b"=", STOP}]
+
+
+def test_grammar_invalid():
+    tokens = [b"a", STOP]
+    with pytest.raises(tvm.TVMError):
+        _compile("root ::= undefined", tokens)
+    with pytest.raises(tvm.TVMError):
+        _compile('root ::= "a" (', tokens)
+
+
+def test_apply_token_bitmask_inplace():
+    batch_size, vocab_size = 3, 40
+    logits = np.random.uniform(-5, 5, size=(batch_size, vocab_size)).astype("float32")
+    allowed = np.random.uniform(size=(batch_size, vocab_size)) < 0.5
+    bits = np.zeros((batch_size, 64), "uint8")
+    bits[:, :vocab_size] = allowed
+    bitmask = np.packbits(bits, axis=-1, bitorder="little").view("int32")
+    logits_nd = tvm.nd.array(logits)
+    f_apply_bitmask(logits_nd, tvm.nd.array(bitmask))
+    expected = np.where(allowed, logits, -np.inf).astype("float32")
+    tvm.testing.assert_allclose(logits_nd.numpy(), expected)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
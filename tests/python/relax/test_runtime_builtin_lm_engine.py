@@ -0,0 +1,172 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.runtime import ShapeTuple
+
+VOCAB_SIZE = 32
+
+f_create = tvm.get_global_func("vm.builtin.lm_engine_create")
+f_submit = tvm.get_global_func("vm.builtin.lm_engine_submit")
+f_cancel = tvm.get_global_func("vm.builtin.lm_engine_cancel")
+f_poll = tvm.get_global_func("vm.builtin.lm_engine_poll")
+f_step = tvm.get_global_func("vm.builtin.lm_engine_step")
+f_run = tvm.get_global_func("vm.builtin.lm_engine_run")
+f_set_detokenizer = tvm.get_global_func("vm.builtin.lm_engine_set_detokenizer")
+f_set_record_step_stats = tvm.get_global_func("vm.builtin.lm_engine_set_record_step_stats")
+f_take_step_stats = tvm.get_global_func("vm.builtin.lm_engine_take_step_stats")
+
+
+def _create_engine(max_batch_size=2, prefill_chunk_size=4):
+    """Create an engine whose model predicts the successor of the last token of each sequence.
+
+    The KV state is an RNN state, which has no page budget. The lengths of the sequences in the
+    batch of each forward are recorded in the returned list.
+    """
+    f_rnn_state_create = tvm.get_global_func("vm.builtin.rnn_state_create")
+    rnn_state = f_rnn_state_create(
+        1, max_batch_size, 1, [lambda: None], [lambda: None], [tvm.nd.array(np.zeros((4,)))]
+    )
+    batches = []
+
+    def forward(input_ids, logit_positions, _kv_state):
+        input_ids = input_ids.numpy()
+        logit_positions = logit_positions.numpy()
+        batches.append(np.diff(np.concatenate([[-1], logit_positions])).tolist())
+        logits = np.zeros((1, len(logit_positions), VOCAB_SIZE), "float32")
+        for i, pos in enumerate(logit_positions):
+            logits[0, i, (input_ids[pos] + 1) % VOCAB_SIZE] = 1.0
+        return tvm.nd.array(logits)
+
+    engine = f_create(forward, rnn_state, tvm.cpu(), max_batch_size, prefill_chunk_size, 0)
+    return engine, batches
+
+
+def _submit(
+    engine, request_id, prompt, max_tokens, stop_token_ids=(), f_stream=None, stop_strings=()
+):
+    args = [engine, request_id, ShapeTuple(prompt), max_tokens, 0.0, 1.0]
+    args += [ShapeTuple(list(stop_token_ids)), f_stream, list(stop_strings)]
+    f_submit(*args)
+
+
+def _poll(engine, request_id):
+    new_tokens, finish_reason, _ = f_poll(engine, request_id)
+    return list(new_tokens), str(finish_reason)
+
+
+def test_generate():
+    engine, batches = _create_engine()
+    _submit(engine, 0, [3, 4, 5], 4)
+    _submit(engine, 1, [10, 11, 12, 13, 14, 15], 3)
+    _submit(engine, 2, [20], 2)
+    f_run(engine)
+
+    assert _poll(engine, 0) == ([6, 7, 8, 9], "length")
+    assert _poll(engine, 1) == ([16, 17, 18], "length")
+    assert _poll(engine, 2) == ([21, 22], "length")
+    # The prompts are chunked, and the decodes lead the batches.
+    assert batches[0] == [3, 1]
+    assert batches[1] == [1, 3]
+    assert all(sum(batch) <= 4 for batch in batches)
+    assert all(len(batch) <= 2 for batch in batches)
+    # The finished requests are released once polled.
+    with pytest.raises(tvm.TVMError):
+        f_poll(engine, 0)
+
+
+def test_stop_and_cancel():
+    engine, _ = _create_engine()
+    _submit(engine, 0, [3, 4, 5], 10, stop_token_ids=[8])
+    _submit(engine, 1, [10], 10)
+    _submit(engine, 2, [20], 10)
+    assert f_step(engine) == 3
+    assert _poll(engine, 0) == ([6], "")
+    f_cancel(engine, 2)
+    assert _poll(engine, 2) == ([], "cancel")
+    f_run(engine)
+    assert _poll(engine, 0) == ([7], "stop")
+    assert _poll(engine, 1) == ([11, 12, 13, 14, 15, 16, 17, 18, 19, 20], "length")
+
+
+def test_stream():
+    engine, _ = _create_engine()
+    events = []
+
+    def f_stream(request_id, new_tokens, finish_reason, _new_text):
+        events.append((request_id, list(new_tokens), str(finish_reason)))
+
+    _submit(engine, 0, [3, 4, 5], 3, f_stream=f_stream)
+    f_run(engine)
+    assert events == [(0, [6], ""), (0, [7], ""), (0, [8], "length")]
+    assert _poll(engine, 0) == ([6, 7, 8], "length")
+
+
+def test_stop_strings():
+    engine, _ = _create_engine()
+    # Token i is the letter "a" + i.
+    tokens = [bytes([ord("a") + i]) for i in range(VOCAB_SIZE)]
+    offsets = np.cumsum([0] + [len(token) for token in tokens]).astype("int32")
+    token_bytes = np.frombuffer(b"".join(tokens), dtype="uint8")
+    f_detokenizer_create = tvm.get_global_func("vm.builtin.detokenizer_create")
+    detokenizer = f_detokenizer_create(tvm.nd.array(token_bytes), tvm.nd.array(offsets))
+    f_set_detokenizer(engine, detokenizer)
+    events = []
+
+    def f_stream(request_id, new_tokens, finish_reason, new_text):
+        events.append((request_id, list(new_tokens), str(finish_reason), str(new_text)))
+
+    _submit(engine, 0, [0], 10, f_stream=f_stream, stop_strings=["de"])
+    _submit(engine, 1, [0], 3)
+    f_run(engine)
+    # "d" is held as the prefix of the stop string, which is not output.
+    assert events == [
+        (0, [1], "", "b"),
+        (0, [2], "", "c"),
+        (0, [3], "", ""),
+        (0, [4], "stop", ""),
+    ]
+    assert f_poll(engine, 1)[2] == "bcd"
+
+
+def test_step_stats():
+    engine, batches = _create_engine()
+    f_set_record_step_stats(engine, True)
+    _submit(engine, 0, [3, 4, 5], 4)
+    _submit(engine, 1, [10, 11, 12, 13, 14, 15], 3)
+    num_steps = f_run(engine)
+    stats = f_take_step_stats(engine).numpy()
+    assert stats.shape == (num_steps, 5)
+    # The number of decode and prefill tokens of each step.
+    assert stats[0, :2].tolist() == [0, 4]
+    assert stats[1, :2].tolist() == [1, 3]
+    assert stats[:, :2].sum(axis=1).tolist() == [sum(batch) for batch in batches]
+    assert stats[:, 1].sum() == 9
+    assert (stats[:, 2:] >= 0).all()
+    # The stats are cleared once taken, and not recorded once disabled.
+    assert f_take_step_stats(engine).shape == (0, 5)
+    f_set_record_step_stats(engine, False)
+    _submit(engine, 2, [20], 2)
+    f_run(engine)
+    assert f_take_step_stats(engine).shape == (0, 5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
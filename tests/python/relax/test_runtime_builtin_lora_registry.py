@@ -0,0 +1,115 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.runtime import ShapeTuple
+from tvm.script import relax as R
+
+IN_FEATURES = 16
+OUT_FEATURES = 8
+MAX_RANK = 4
+
+f_create = tvm.get_global_func("vm.builtin.lora_registry_create")
+f_add_adapter = tvm.get_global_func("vm.builtin.lora_registry_add_adapter")
+f_remove_adapter = tvm.get_global_func("vm.builtin.lora_registry_remove_adapter")
+f_get_slot = tvm.get_global_func("vm.builtin.lora_registry_get_slot")
+f_get_lora_a = tvm.get_global_func("vm.builtin.lora_registry_get_lora_a")
+f_get_lora_b = tvm.get_global_func("vm.builtin.lora_registry_get_lora_b")
+f_get_token_slots = tvm.get_global_func("vm.builtin.lora_registry_get_token_slots")
+
+
+def _create_registry(max_num_adapters=2):
+    weight_shapes = [ShapeTuple([OUT_FEATURES, IN_FEATURES])]
+    return f_create(max_num_adapters, MAX_RANK, weight_shapes, "float32", tvm.cpu())
+
+
+def _random_adapter(rank):
+    lora_a = np.random.uniform(-1, 1, (rank, IN_FEATURES)).astype("float32")
+    lora_b = np.random.uniform(-1, 1, (OUT_FEATURES, rank)).astype("float32")
+    return lora_a, lora_b
+
+
+def _add_adapter(registry, name, lora_a, lora_b):
+    return f_add_adapter(registry, name, [tvm.nd.array(lora_a)], [tvm.nd.array(lora_b)])
+
+
+def test_slots():
+    registry = _create_registry()
+    _add_adapter(registry, "a", *_random_adapter(2))
+    _add_adapter(registry, "b", *_random_adapter(4))
+    assert {f_get_slot(registry, "a"), f_get_slot(registry, "b")} == {0, 1}
+
+    # The registry is full until an adapter is removed.
+    with pytest.raises(tvm.TVMError):
+        _add_adapter(registry, "c", *_random_adapter(2))
+    slot_a = f_get_slot(registry, "a")
+    f_remove_adapter(registry, "a")
+    assert _add_adapter(registry, "c", *_random_adapter(2)) == slot_a
+
+    slots = f_get_token_slots(registry, ["c", "", "b"], ShapeTuple([2, 1, 3])).numpy()
+    slot_b = f_get_slot(registry, "b")
+    np.testing.assert_equal(slots, [slot_a, slot_a, -1, slot_b, slot_b, slot_b])
+
+
+def test_mixed_adapter_batch():
+    @R.function
+    def main(
+        x: R.Tensor(("n", IN_FEATURES), "float32"),
+        lora_a: R.Tensor((2, MAX_RANK, IN_FEATURES), "float32"),
+        lora_b: R.Tensor((2, OUT_FEATURES, MAX_RANK), "float32"),
+        slots: R.Tensor(("n",), "int32"),
+    ):
+        with R.dataflow():
+            gv = R.nn.lora_bgmv(x, lora_a, lora_b, slots)
+            R.output(gv)
+        return gv
+
+    registry = _create_registry()
+    adapters = {"a": _random_adapter(2), "b": _random_adapter(4)}
+    for name, (lora_a, lora_b) in adapters.items():
+        _add_adapter(registry, name, lora_a, lora_b)
+
+    seq_adapters = ["b", "", "a"]
+    lengths = [3, 2, 1]
+    x = np.random.uniform(-1, 1, (sum(lengths), IN_FEATURES)).astype("float32")
+    slots = f_get_token_slots(registry, seq_adapters, ShapeTuple(lengths))
+
+    mod = tvm.IRModule.from_expr(main)
+    vm = relax.VirtualMachine(relax.build(mod, target="llvm"), tvm.cpu())
+    out = vm["main"](
+        tvm.nd.array(x), f_get_lora_a(registry, 0), f_get_lora_b(registry, 0), slots
+    ).numpy()
+
+    expected = []
+    token = 0
+    for name, length in zip(seq_adapters, lengths):
+        for _ in range(length):
+            if name:
+                lora_a, lora_b = adapters[name]
+                expected.append(lora_b @ (lora_a @ x[token]))
+            else:
+                expected.append(np.zeros(OUT_FEATURES, "float32"))
+            token += 1
+    tvm.testing.assert_allclose(out, np.stack(expected), rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -57,6 +57,12 @@ fcommit_accepted_token_tree_nodes = None
 fattention_with_fuse_qkv = None
 fis_empty = None
 fdebug_get_kv = None
+fadd_sequence_with_prefix = None
+fcommit_sequence_prefix = None
+fswap_out_sequence = None
+fswap_in_sequence = None
+fget_num_total_pages = None
+fresize_page_pool = None
 
 ftranspose_append = None
 fcopy_cache = None
@@ -77,6 +83,8 @@ def set_global_func(head_dim, dtype):
     global fclear, fadd_sequence, fremove_sequence, ffork_sequence, fenable_sliding_window_for_seq
     global fpopn, fbegin_forward, fend_forward, fcommit_accepted_token_tree_nodes
     global fattention_with_fuse_qkv, fis_empty, fdebug_get_kv
+    global fadd_sequence_with_prefix, fcommit_sequence_prefix
+    global fswap_out_sequence, fswap_in_sequence, fget_num_total_pages, fresize_page_pool
     global ftranspose_append, fcopy_cache, fattn_prefill, fattn_decode
     global fattn_prefill_ragged, fattn_prefill_with_tree_mask
     global fattn_prefill_sliding_window, fattn_decode_sliding_window
@@ -100,6 +108,16 @@ def set_global_func(head_dim, dtype):
     )
     fis_empty = tvm.get_global_func("vm.builtin.attention_kv_cache_empty")
     fdebug_get_kv = tvm.get_global_func("vm.builtin.attention_kv_cache_debug_get_kv")
+    fadd_sequence_with_prefix = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_add_sequence_with_prefix"
+    )
+    fcommit_sequence_prefix = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_commit_sequence_prefix"
+    )
+    fswap_out_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_swap_out_sequence")
+    fswap_in_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_swap_in_sequence")
+    fget_num_total_pages = tvm.get_global_func("vm.builtin.attention_kv_cache_get_num_total_pages")
+    fresize_page_pool = tvm.get_global_func("vm.builtin.attention_kv_cache_resize_page_pool")
 
     target = tvm.target.Target("cuda")
     builts = []
@@ -141,8 +159,9 @@ def set_global_func(head_dim, dtype):
     ) = builts
 
 
-def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window):
+def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window, decode_candidates=None):
     fcreate = tvm.get_global_func("vm.builtin.paged_attention_kv_cache_create_reduced")
+    extra_args = [] if decode_candidates is None else [dtype, decode_candidates]
     cache = fcreate(
         tvm.runtime.ShapeTuple(
             [
@@ -173,6 +192,7 @@ def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window):
         fcopy_cache,
         fcompact_copy,
         fattn_prefill_with_tree_mask,
+        *extra_args,
     )
     return cache
 
@@ -613,6 +633,197 @@ def test_paged_attention_kv_cache_fork_sequence(kv_cache_and_config):
     assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_prefix_cache(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    prompt = list(range(100, 140))
+    apply_attention(kv_cache, rope_mode, [(0, len(prompt))], cached_k, cached_v)
+    fcommit_sequence_prefix(kv_cache, 0, tvm.runtime.ShapeTuple(prompt))
+
+    # A sequence sharing the first 30 tokens reuses them.
+    tokens = prompt[:30] + [7] * 10
+    assert fadd_sequence_with_prefix(kv_cache, 1, tvm.runtime.ShapeTuple(tokens)) == 30
+    cached_k[1] = cached_k[0][::, :30]
+    cached_v[1] = cached_v[0][::, :30]
+    # A sequence with the same tokens leaves the last one to be prefilled.
+    assert fadd_sequence_with_prefix(kv_cache, 2, tvm.runtime.ShapeTuple(prompt)) == 39
+    cached_k[2] = cached_k[0][::, :39]
+    cached_v[2] = cached_v[0][::, :39]
+    # No shared prefix.
+    assert fadd_sequence_with_prefix(kv_cache, 3, tvm.runtime.ShapeTuple([1, 2, 3])) == 0
+    cached_k[3] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    cached_v[3] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    verify_cached_kv(kv_cache, [1, 2], cached_k, cached_v)
+
+    # The original sequence can go away, the cached prefix stays.
+    fremove_sequence(kv_cache, 0)
+    cached_k.pop(0)
+    cached_v.pop(0)
+    apply_attention(kv_cache, rope_mode, [(1, 10), (2, 1), (3, 3)], cached_k, cached_v)
+    assert fadd_sequence_with_prefix(kv_cache, 4, tvm.runtime.ShapeTuple(prompt)) == 39
+    cached_k[4] = cached_k[2][::, :39]
+    cached_v[4] = cached_v[2][::, :39]
+    verify_cached_kv(kv_cache, [1, 2, 3, 4], cached_k, cached_v)
+    fclear(kv_cache)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_swap(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 60), (1, 35), (2, 17)], cached_k, cached_v)
+    # A forked sequence is swapped out and back as a whole.
+    apply_attention(kv_cache, rope_mode, [((3, 0, 40), 9)], cached_k, cached_v)
+
+    for seq_id in [1, 3]:
+        fswap_out_sequence(kv_cache, seq_id)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (2, 5)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 2], cached_k, cached_v)
+
+    for seq_id in [3, 1]:
+        fswap_in_sequence(kv_cache, seq_id)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1), (3, 3)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 1, 2, 3], cached_k, cached_v)
+
+    # A swapped out sequence can be removed without swapping it in.
+    fswap_out_sequence(kv_cache, 2)
+    for seq_id in range(4):
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_resize_page_pool(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+    num_total_pages = fget_num_total_pages(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 60), (1, 35), (2, 17)], cached_k, cached_v)
+    assert fresize_page_pool(kv_cache, num_total_pages * 2) == num_total_pages * 2
+    apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 1, 2], cached_k, cached_v)
+
+    # The pages of the remaining sequences move to the front, and the pool
+    # does not shrink below them.
+    fremove_sequence(kv_cache, 0)
+    del cached_k[0]
+    del cached_v[0]
+    num_used_pages = (36 + page_size - 1) // page_size + (18 + page_size - 1) // page_size
+    assert fresize_page_pool(kv_cache, 1) == num_used_pages
+    assert fresize_page_pool(kv_cache, num_used_pages + 8) == num_used_pages + 8
+    apply_attention(kv_cache, rope_mode, [(1, 20), (2, 20)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [1, 2], cached_k, cached_v)
+
+    for seq_id in [1, 2]:
+        fremove_sequence(kv_cache, seq_id)
+    assert fresize_page_pool(kv_cache, num_total_pages) == num_total_pages
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_steady_decode(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 14), (1, 3), (2, 30)], cached_k, cached_v)
+    # The decodes of the same batch take new pages on the way.
+    decode = [(0, 1), (1, 1), (2, 1)]
+    for _ in range(20):
+        apply_attention(kv_cache, rope_mode, decode, cached_k, cached_v)
+    # The sequences change between decodes of the same batch.
+    fpopn(kv_cache, 1, 5)
+    cached_k[1] = cached_k[1][:, :-5, ...]
+    cached_v[1] = cached_v[1][:, :-5, ...]
+    apply_attention(kv_cache, rope_mode, decode, cached_k, cached_v)
+    fswap_out_sequence(kv_cache, 0)
+    fswap_out_sequence(kv_cache, 2)
+    fswap_in_sequence(kv_cache, 2)
+    fswap_in_sequence(kv_cache, 0)
+    for _ in range(3):
+        apply_attention(kv_cache, rope_mode, decode, cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 1, 2], cached_k, cached_v)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_mixed_batch(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 9), (1, 21)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [((2, 0, -1), 1), ((3, 0, -1), 1)], cached_k, cached_v)
+    # The decodes lead the batch and the prompt of a new sequence is prefilled in chunks.
+    decode = [(0, 1), (1, 1), (2, 1), (3, 1)]
+    for length in [16, 16, 7]:
+        apply_attention(kv_cache, rope_mode, decode + [(4, length)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, decode + [(4, 1), (5, 12)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(5, 1), (0, 3), (4, 1)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 1, 2, 3, 4, 5], cached_k, cached_v)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_decode_kernel_selection(kv_cache_and_config):
+    _, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window:
+        # The decode kernel candidates are not used under sliding window.
+        return
+
+    # A decode kernel of smaller thread blocks to select from.
+    target = tvm.target.Target("cuda -max_num_threads=128 -max_threads_per_block=128")
+    tir_func = _attention_decode(num_kv_heads, num_qo_heads, head_dim, dtype, False, target)
+    mod = tvm.IRModule({"main": tir_func})
+    with target:
+        mod = dl.ApplyDefaultSchedule(dl.gpu.Fallback())(mod)
+    fattn_decode_candidate = tvm.build(mod["main"], target=target).entry_func
+    kv_cache = create_kv_cache(
+        head_dim, dtype, rope_mode, support_sliding_window, [fattn_decode_candidate]
+    )
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 20), (1, 35), (2, 3)], cached_k, cached_v)
+    # The batches of different shapes measure and choose the decode kernel for their own.
+    for _ in range(5):
+        apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [((3, 1, -1), 1)], cached_k, cached_v)
+    for _ in range(5):
+        apply_attention(kv_cache, rope_mode, [(1, 1), (3, 1)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 1, 2, 3], cached_k, cached_v)
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_paged_attention_kv_cache_unlimited_depth(kv_cache_and_config):
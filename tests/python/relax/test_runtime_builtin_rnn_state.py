@@ -51,9 +51,12 @@ f_end_forward = None
 f_get = None
 f_set = None
 f_debug_get = None
+f_get_storage = None
+f_get_slot_ids = None
 
 f_tir_gets = []
 f_tir_sets = []
+f_tir_adds = []
 
 # pylint: enable=invalid-name
 
@@ -61,7 +64,8 @@ f_tir_sets = []
 def set_global_func():
     global f_clear, f_add_sequence, f_remove_sequence, f_fork_sequence, f_popn
     global f_begin_forward, f_end_forward, f_get, f_set, f_debug_get
-    global f_tir_gets, f_tir_sets
+    global f_get_storage, f_get_slot_ids
+    global f_tir_gets, f_tir_sets, f_tir_adds
 
     f_clear = tvm.get_global_func("vm.builtin.kv_state_clear")
     f_add_sequence = tvm.get_global_func("vm.builtin.kv_state_add_sequence")
@@ -73,6 +77,8 @@ def set_global_func():
     f_get = tvm.get_global_func("vm.builtin.rnn_state_get")
     f_set = tvm.get_global_func("vm.builtin.rnn_state_set")
     f_debug_get = tvm.get_global_func("vm.builtin.rnn_state_debug_get")
+    f_get_storage = tvm.get_global_func("vm.builtin.rnn_state_get_storage")
+    f_get_slot_ids = tvm.get_global_func("vm.builtin.rnn_state_get_slot_ids")
 
     target = tvm.target.Target("cuda")
 
@@ -83,14 +89,16 @@ def set_global_func():
         f = tvm.build(mod["main"], target=target)
         return f.entry_func
 
-    _f_tir_gets, _f_tir_sets = [], []
+    _f_tir_gets, _f_tir_sets, _f_tir_adds = [], [], []
     for state in states:
         shape, dtype = state
         _f_tir_gets.append(_build(rnn_state_get(shape, dtype)))
         _f_tir_sets.append(_build(rnn_state_set(shape, dtype)))
+        _f_tir_adds.append(_build(rnn_state_add_in_place(shape, dtype)))
 
     f_tir_gets = _f_tir_gets
     f_tir_sets = _f_tir_sets
+    f_tir_adds = _f_tir_adds
 
 
 def create_rnn_state():
@@ -179,6 +187,30 @@ def test_rnn_state_fork_sequence(rnn_state):  # pylint: disable=redefined-outer-
     verify_state(state, [0, 1], [[np_two, np_three], [np_zero, np_one]])
 
 
+@tvm.testing.requires_cuda
+def test_rnn_state_in_place(rnn_state):  # pylint: disable=redefined-outer-name
+    state = rnn_state
+    f_clear(state)
+
+    f_add_sequence(state, 0)
+    f_add_sequence(state, 1)
+    for _ in range(2):
+        f_begin_forward(state, ShapeTuple([1, 0]), ShapeTuple([1, 1]))
+        seq_slot_ids, history_slot_ids = f_get_slot_ids(state)
+        for state_id, value in enumerate([np_two, np_three]):
+            storage = f_get_storage(state, 0, state_id)
+            data = tvm.nd.array(np.stack([value, value]), device=device)
+            f_tir_adds[state_id](storage, seq_slot_ids, history_slot_ids, data)
+        f_end_forward(state)
+    expected = [np_zero + 2 * np_two, np_one + 2 * np_three]
+    verify_state(state, [0, 1], [expected, expected])
+
+    # The fork copies the history which the parent can roll back to.
+    f_fork_sequence(state, 0, 2, -1)
+    f_popn(state, 2, 2)
+    verify_state(state, [0, 2], [expected, [np_zero, np_one]])
+
+
 def rnn_state_get(
     shape: Sequence[int],
     dtype: str,
@@ -253,6 +285,46 @@ def rnn_state_set(
     return _rnn_state_set
 
 
+def rnn_state_add_in_place(
+    shape: Sequence[int],
+    dtype: str,
+):
+    # fmt: off
+    @T.prim_func
+    def _rnn_state_add_in_place(
+        var_storage: T.handle,
+        var_seq_slot_ids: T.handle,
+        var_history_slot_ids: T.handle,
+        var_data: T.handle,
+    ):
+        batch_size = T.int32(is_size_var=True)
+
+        storage = T.match_buffer(var_storage, (reserved_nseq, max_history, *shape), dtype)
+        seq_slot_ids = T.match_buffer(var_seq_slot_ids, (batch_size,), "int32")
+        history_slot_ids = T.match_buffer(var_history_slot_ids, (batch_size,), "int32")
+        data = T.match_buffer(var_data, (batch_size, *shape), dtype)
+
+        for i in range(batch_size):
+            for s in T.grid(*shape):
+                with T.block("add"):
+                    vi, *vs = T.axis.remap("S" * (len(shape) + 1), [i, *s])
+                    seq_id: T.int32 = seq_slot_ids[vi]
+                    history_id: T.int32 = history_slot_ids[vi]
+                    next_history_id: T.int32 = (history_id + 1) % T.cast(max_history, "int32")
+                    # `storage[seq_id, next_history_id, *vs] =
+                    #     storage[seq_id, history_id, *vs] + data[vi, *vs]`
+                    T.buffer_store(
+                        storage,
+                        T.BufferLoad(storage, [seq_id, history_id, *vs])
+                        + T.BufferLoad(data, [vi, *vs]),
+                        [seq_id, next_history_id, *vs],
+                    )
+
+    # fmt: on
+
+    return _rnn_state_add_in_place
+
+
 if __name__ == "__main__":
     set_global_func()
     rnn_state = create_rnn_state()
@@ -260,3 +332,4 @@ if __name__ == "__main__":
     test_rnn_state_set(rnn_state)
     test_rnn_state_popn(rnn_state)
     test_rnn_state_fork_sequence(rnn_state)
+    test_rnn_state_in_place(rnn_state)
@@ -0,0 +1,170 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+def _binding_summary(func):
+    """The kernels, the allocations and the stream builtins of the function, in order."""
+    summary = []
+    for binding in func.body.blocks[0].bindings:
+        value = binding.value
+        if not isinstance(value, relax.Call):
+            continue
+        if isinstance(value.op, relax.GlobalVar):
+            summary.append(value.op.name_hint)
+        elif value.op == tvm.ir.Op.get("relax.builtin.alloc_tensor"):
+            summary.append("alloc")
+        elif value.op == tvm.ir.Op.get("relax.call_builtin_with_ctx"):
+            name = value.args[0].global_symbol.replace("vm.builtin.", "")
+            args = [int(field.value) for field in value.args[1].fields[1:]]
+            summary.append(name + "".join(f" {arg}" for arg in args))
+        elif value.op == tvm.ir.Op.get("relax.memory.alloc_storage"):
+            summary.append("alloc_storage")
+    return summary
+
+
+# fmt: off
+@I.ir_module
+class TwoBranches:
+    @T.prim_func
+    def exp(A: T.Buffer((2, 4), "float32"), B: T.Buffer((2, 4), "float32")):
+        T.evaluate(0)
+
+    @T.prim_func
+    def relu(A: T.Buffer((2, 4), "float32"), B: T.Buffer((2, 4), "float32")):
+        T.evaluate(0)
+
+    @T.prim_func
+    def add(A: T.Buffer((2, 4), "float32"), B: T.Buffer((2, 4), "float32"), C: T.Buffer((2, 4), "float32")):
+        T.evaluate(0)
+
+    @R.function
+    def main(x: R.Tensor((2, 4), dtype="float32")) -> R.Tensor((2, 4), dtype="float32"):
+        R.func_attr({"relax.force_pure": True})
+        cls = TwoBranches
+        alloc: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+        _: R.Tuple() = cls.exp(x, alloc)
+        alloc1: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+        _1: R.Tuple() = cls.relu(x, alloc1)
+        alloc2: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+        _2: R.Tuple() = cls.exp(alloc, alloc2)
+        alloc3: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+        _3: R.Tuple() = cls.relu(alloc1, alloc3)
+        alloc4: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+        _4: R.Tuple() = cls.add(alloc2, alloc3, alloc4)
+        return alloc4
+# fmt: on
+
+
+def test_independent_branches():
+    mod = relax.transform.AssignStreams(num_streams=2)(TwoBranches)
+    assert _binding_summary(mod["main"]) == [
+        "alloc",
+        "exp",
+        "stream_switch 1",
+        "stream_sync 0 1",
+        "alloc",
+        "relu",
+        "stream_switch 0",
+        "alloc",
+        "exp",
+        "stream_switch 1",
+        "alloc",
+        "relu",
+        "stream_sync 0 1",
+        "alloc",
+        "add",
+        "stream_join",
+    ]
+
+
+def test_single_stream():
+    mod = relax.transform.AssignStreams(num_streams=1)(TwoBranches)
+    tvm.ir.assert_structural_equal(mod, TwoBranches)
+    # The number of streams is read from the PassContext when not given.
+    with tvm.transform.PassContext(config={"relax.backend.num_streams": 1}):
+        mod = relax.transform.AssignStreams()(TwoBranches)
+    tvm.ir.assert_structural_equal(mod, TwoBranches)
+
+
+def test_chain_stays_on_one_stream():
+    # fmt: off
+    @I.ir_module
+    class Chain:
+        @T.prim_func
+        def exp(A: T.Buffer((2, 4), "float32"), B: T.Buffer((2, 4), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((2, 4), dtype="float32")) -> R.Tensor((2, 4), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Chain
+            alloc: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((2, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([2, 4]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            return alloc1
+    # fmt: on
+
+    mod = relax.transform.AssignStreams(num_streams=2)(Chain)
+    tvm.ir.assert_structural_equal(mod, Chain)
+
+
+def test_memory_planning_across_streams():
+    # Without streams, alloc3 reuses the storage of alloc, which the other branch may still be
+    # reading when alloc3 runs on a side stream.
+    planned = relax.transform.StaticPlanBlockMemory()(TwoBranches)
+    assert _binding_summary(planned["main"]).count("alloc_storage") == 3
+
+    mod = relax.transform.AssignStreams(num_streams=2)(TwoBranches)
+    planned = relax.transform.StaticPlanBlockMemory()(mod)
+    assert _binding_summary(planned["main"]).count("alloc_storage") == 4
+
+
+def test_build_with_streams():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((2, 4), "float32")):
+            with R.dataflow():
+                a = R.exp(x)
+                b = R.nn.relu(x)
+                a1 = R.exp(a)
+                b1 = R.nn.relu(b)
+                gv = R.add(a1, b1)
+                R.output(gv)
+            return gv
+
+    with tvm.transform.PassContext(config={"relax.backend.num_streams": 2}):
+        ex = relax.build(Module, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_np = np.random.uniform(-1, 1, (2, 4)).astype("float32")
+    res = vm["main"](tvm.nd.array(x_np))
+    expected = np.exp(np.exp(x_np)) + np.maximum(x_np, 0)
+    tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
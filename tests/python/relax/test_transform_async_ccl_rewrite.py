@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+def test_async_allreduce_wait_before_first_use():
+    @I.ir_module
+    class Module:
+        @R.function(pure=False)
+        def main(x: R.Tensor((16,), "float16"), y: R.Tensor((16,), "float16")):
+            alloc: R.Tensor((16,), "float16") = R.builtin.alloc_tensor(
+                R.shape([16]), R.dtype("float16"), R.prim_value(0), R.str("global")
+            )
+            _: R.Object = R.call_packed("runtime.disco.allreduce", x, R.shape([0]), alloc)
+            lv: R.Tensor((16,), "float16") = R.call_packed(
+                "test.compute", y, sinfo_args=R.Tensor((16,), "float16")
+            )
+            lv1: R.Tensor((16,), "float16") = R.call_packed(
+                "test.compute", alloc, sinfo_args=R.Tensor((16,), "float16")
+            )
+            return (lv, lv1)
+
+    @I.ir_module
+    class Expected:
+        @R.function(pure=False)
+        def main(x: R.Tensor((16,), "float16"), y: R.Tensor((16,), "float16")):
+            alloc: R.Tensor((16,), "float16") = R.builtin.alloc_tensor(
+                R.shape([16]), R.dtype("float16"), R.prim_value(0), R.str("global")
+            )
+            _: R.Object = R.call_packed("runtime.disco.allreduce_async", x, R.shape([0]), alloc)
+            lv: R.Tensor((16,), "float16") = R.call_packed(
+                "test.compute", y, sinfo_args=R.Tensor((16,), "float16")
+            )
+            _1: R.Object = R.call_packed("runtime.disco.wait", _, x, alloc)
+            lv1: R.Tensor((16,), "float16") = R.call_packed(
+                "test.compute", alloc, sinfo_args=R.Tensor((16,), "float16")
+            )
+            return (lv, lv1)
+
+    mod = relax.transform.AsyncCCLRewrite()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_async_allgather_wait_at_block_end_and_alias():
+    @I.ir_module
+    class Module:
+        @R.function(pure=False)
+        def main(x: R.Tensor((16,), "float16"), y: R.Tensor((16,), "float16")):
+            alloc: R.Tensor((32,), "float16") = R.builtin.alloc_tensor(
+                R.shape([32]), R.dtype("float16"), R.prim_value(0), R.str("global")
+            )
+            lv: R.Tensor((32,), "float16") = alloc
+            _: R.Object = R.call_packed("runtime.disco.allgather", x, lv)
+            lv1: R.Tensor((16,), "float16") = R.call_packed(
+                "test.compute", y, sinfo_args=R.Tensor((16,), "float16")
+            )
+            return (alloc, lv1)
+
+    @I.ir_module
+    class Expected:
+        @R.function(pure=False)
+        def main(x: R.Tensor((16,), "float16"), y: R.Tensor((16,), "float16")):
+            alloc: R.Tensor((32,), "float16") = R.builtin.alloc_tensor(
+                R.shape([32]), R.dtype("float16"), R.prim_value(0), R.str("global")
+            )
+            lv: R.Tensor((32,), "float16") = alloc
+            _: R.Object = R.call_packed("runtime.disco.allgather_async", x, lv)
+            lv1: R.Tensor((16,), "float16") = R.call_packed(
+                "test.compute", y, sinfo_args=R.Tensor((16,), "float16")
+            )
+            _1: R.Object = R.call_packed("runtime.disco.wait", _, x, lv)
+            return (alloc, lv1)
+
+    mod = relax.transform.AsyncCCLRewrite()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,120 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the automatic placement of operators on the host or the device"""
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.transform import AutoPlaceVDevice
+from tvm.script.parser import ir as I, relax as R
+
+
+def _calls(mod):
+    """The (op name, vdevice of the result) of the calls of main, in order."""
+    calls = []
+    for block in mod["main"].body.blocks:
+        for binding in block.bindings:
+            if isinstance(binding.value, relax.Call):
+                sinfo = binding.var.struct_info
+                target = sinfo.vdevice.target.kind.name if sinfo.vdevice else None
+                calls.append((binding.value.op.name, target))
+    return calls
+
+
+def test_tiny_ops_on_host():
+    @I.ir_module
+    class Module:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(x: R.Tensor((4,), "int64")) -> R.Tensor((4,), "int64"):
+            with R.dataflow():
+                lv1 = R.add(x, x)
+                lv2 = R.multiply(lv1, lv1)
+                lv3 = R.add(lv2, x)
+                lv4 = R.multiply(lv3, lv3)
+                lv5 = R.add(lv4, lv1)
+                lv6 = R.multiply(lv5, lv5)
+                lv7 = R.add(lv6, lv2)
+                gv = R.multiply(lv7, lv7)
+                R.output(gv)
+            return gv
+
+    # Eight launches on the device cost more than moving the input and the output.
+    calls = _calls(AutoPlaceVDevice()(Module))
+    assert calls[0] == ("relax.to_vdevice", "llvm")
+    assert all(target == "llvm" for _, target in calls[1:9])
+    assert calls[9:] == [("relax.to_vdevice", "cuda")]
+
+    # The placement follows the cost model.
+    calls = _calls(AutoPlaceVDevice({"device_launch_overhead": 1e-7})(Module))
+    assert all(target is None for _, target in calls)
+
+
+def test_gemm_on_device():
+    @I.ir_module
+    class Module:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(
+            x: R.Tensor((1024, 1024), "float32"), w: R.Tensor((1024, 1024), "float32")
+        ) -> R.Tensor((1024, 1024), "float32"):
+            with R.dataflow():
+                lv = R.matmul(x, w)
+                gv = R.nn.relu(lv)
+                R.output(gv)
+            return gv
+
+    tvm.ir.assert_structural_equal(AutoPlaceVDevice()(Module), Module)
+
+
+def test_host_input():
+    @I.ir_module
+    class Module:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(
+            ids: R.Tensor((8,), "int64", "llvm"), table: R.Tensor((32000, 4096), "float16")
+        ) -> R.Tensor((8, 4096), "float16"):
+            with R.dataflow():
+                lv = R.take(table, ids, axis=0)
+                gv = R.nn.silu(lv)
+                R.output(gv)
+            return gv
+
+    # The lookup stays with the table, which costs far more to move than the indices.
+    tvm.ir.assert_structural_equal(AutoPlaceVDevice()(Module), Module)
+
+
+def test_no_host():
+    @I.ir_module
+    class Module:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0)]})
+
+        @R.function
+        def main(x: R.Tensor((4,), "int64")) -> R.Tensor((4,), "int64"):
+            with R.dataflow():
+                gv = R.add(x, x)
+                R.output(gv)
+            return gv
+
+    tvm.ir.assert_structural_equal(AutoPlaceVDevice()(Module), Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
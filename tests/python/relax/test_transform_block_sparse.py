@@ -0,0 +1,125 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm import relax
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.relax.transform.block_sparse import choose_block_size, pack_blocked_ell
+
+
+def _called_prim_funcs(func):
+    names = []
+
+    def visit(expr):
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.call_tir"):
+            names.append(expr.args[0].name_hint)
+
+    relax.analysis.post_order_visit(func.body, visit)
+    return names
+
+
+def _pruned_weight(shape, block_size, blocks_per_row, seed=0):
+    """A random weight keeping `blocks_per_row` blocks of each block row."""
+    rng = np.random.default_rng(seed)
+    bs_r, bs_c = block_size
+    weight = rng.uniform(-1, 1, shape).astype("float32")
+    num_block_cols = shape[1] // bs_c
+    for row in range(shape[0] // bs_r):
+        kept = rng.choice(num_block_cols, blocks_per_row, replace=False)
+        for col in range(num_block_cols):
+            if col not in kept:
+                weight[row * bs_r : (row + 1) * bs_r, col * bs_c : (col + 1) * bs_c] = 0
+    return weight
+
+
+def _linear(weight, x_shape):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", relax.TensorStructInfo(x_shape, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            weight_t = bb.emit(relax.op.permute_dims(relax.const(weight)))
+            gv = bb.emit_output(relax.op.matmul(x, weight_t))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_pack_blocked_ell():
+    weight = _pruned_weight((32, 64), (4, 1), 8)
+    # Leave a block row with fewer blocks, to be padded.
+    weight[:4, :] = 0
+    data, indices = pack_blocked_ell(weight, (4, 1))
+    assert data.shape == (8, 8, 4, 1) and indices.shape == (8, 8)
+
+    unpacked = np.zeros_like(weight)
+    for row in range(8):
+        for b in range(8):
+            col = indices[row, b]
+            unpacked[row * 4 : row * 4 + 4, col : col + 1] += data[row, b]
+    np.testing.assert_equal(unpacked, weight)
+
+    block_size, density = choose_block_size(weight, [(16, 1), (8, 1), (4, 4), (4, 1)])
+    assert block_size == (4, 1)
+    assert density == 8 / 64
+
+
+def test_rewrite_and_build():
+    weight = _pruned_weight((32, 64), (8, 1), 16)
+    mod = relax.transform.DenseToBlockSparse()(_linear(weight, (2, 5, 64)))
+    assert _called_prim_funcs(mod["main"]) == ["blocked_ell_dense"]
+
+    x = np.random.uniform(-1, 1, (2, 5, 64)).astype("float32")
+    vm = relax.VirtualMachine(relax.build(mod, target="llvm"), tvm.cpu())
+    out = vm["main"](tvm.nd.array(x)).numpy()
+    tvm.testing.assert_allclose(out, x @ weight.T, rtol=1e-5, atol=1e-5)
+
+
+def test_dense_weight_unchanged():
+    weight = np.random.uniform(-1, 1, (32, 64)).astype("float32")
+    mod = _linear(weight, (4, 64))
+    tvm.ir.assert_structural_equal(relax.transform.DenseToBlockSparse()(mod), mod)
+
+
+def test_schedule_rule():
+    weight = _pruned_weight((32, 64), (8, 1), 16)
+    mod = relax.transform.DenseToBlockSparse()(_linear(weight, (16, 64)))
+    func = mod["blocked_ell_dense"]
+    target = tvm.target.Target("llvm --num-cores=4")
+    (sch,) = generate_design_space(
+        "llvm",
+        tvm.IRModule({"main": func}),
+        target,
+        types=None,
+        sch_rules=[ms.schedule_rule.ApplyCustomRule()],
+    )
+    loop_kinds = [sch.get(loop).kind for loop in sch.get_loops(sch.get_block("blocked_ell_dense"))]
+    assert loop_kinds[0] == tvm.tir.ForKind.PARALLEL
+    assert loop_kinds[-1] == tvm.tir.ForKind.VECTORIZED
+
+    x = np.random.uniform(-1, 1, (16, 64)).astype("float32")
+    data, indices = pack_blocked_ell(weight, (8, 1))
+    out = tvm.nd.empty((16, 32), "float32")
+    tvm.build(sch.mod, target=target)(
+        tvm.nd.array(x), tvm.nd.array(data), tvm.nd.array(indices), out
+    )
+    tvm.testing.assert_allclose(out.numpy(), x @ weight.T, rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -324,6 +324,35 @@ def test_fold_multiple_relax_ops():
     tvm.ir.assert_structural_equal(after, expected)
 
 
+def test_fold_batched():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def before(c0: R.Tensor((16, 16), "float32"), c1: R.Tensor((16, 16), "float32")):
+            with R.dataflow():
+                lv0 = R.add(c0, c1)
+                lv1 = R.multiply(c0, lv0)
+                lv2 = R.subtract(c0, c1)
+                gv = R.add(lv1, lv2)
+                R.output(gv)
+            return gv
+
+        @R.function
+        def expected(c2: R.Tensor((16, 16), "float32")):
+            return c2
+
+    c0_np = np.arange((16 * 16)).astype("float32").reshape(16, 16)
+    c1_np = np.arange((16 * 16)).astype("float32").reshape(16, 16) * 2
+    c2_np = c0_np * (c0_np + c1_np) + (c0_np - c1_np)
+    before = gen_mod(Module, "before", {"c0": c0_np, "c1": c1_np})
+    expected = gen_mod(Module, "expected", {"c2": c2_np})
+
+    # The calls of each depth are built together and folded in one round.
+    after = relax.transform.FoldConstant(batched=True)(before)
+    tvm.ir.assert_structural_equal(after, expected)
+    tvm.ir.assert_structural_equal(after, relax.transform.FoldConstant()(before))
+
+
 def test_do_not_fold_ops_outside_dataflow():
     # put before after in a single module
     @tvm.script.ir_module
@@ -0,0 +1,163 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import math
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+def _grouped_functions(mod):
+    return {
+        gv.name_hint: func
+        for gv, func in mod.functions.items()
+        if isinstance(func, relax.Function) and func.attrs and "Composite" in func.attrs
+    }
+
+
+def _bound_ops(func):
+    ops = []
+
+    def visit(expr):
+        if isinstance(expr, relax.Call) and isinstance(expr.op, tvm.ir.Op):
+            ops.append(expr.op.name)
+
+    relax.analysis.post_order_visit(func.body, visit)
+    return ops
+
+
+@I.ir_module
+class MLP:
+    @R.function
+    def main(
+        x: R.Tensor((16, 64), "float32"),
+        w: R.Tensor((128, 64), "float32"),
+        b: R.Tensor((128,), "float32"),
+        res: R.Tensor((16, 128), "float32"),
+    ):
+        with R.dataflow():
+            wt = R.permute_dims(w)
+            mm = R.matmul(x, wt)
+            biased = R.add(mm, b)
+            act = R.nn.gelu(biased)
+            out = R.add(res, act)
+            gv = R.astype(out, "float16")
+            R.output(gv)
+        return gv
+
+
+def test_matmul_epilogue():
+    mod = relax.transform.FuseEpilogue()(MLP)
+    grouped = _grouped_functions(mod)
+    assert len(grouped) == 1
+    (func,) = grouped.values()
+    assert func.attrs["Primitive"] == 1
+    assert _bound_ops(func) == [
+        "relax.permute_dims",
+        "relax.matmul",
+        "relax.add",
+        "relax.nn.gelu",
+        "relax.add",
+        "relax.astype",
+    ]
+    assert _bound_ops(mod["main"]) == []
+
+
+def test_single_kernel():
+    mod = relax.get_pipeline("zero", fuse_epilogue=True)(MLP)
+    prim_funcs = [func for func in mod.functions.values() if isinstance(func, tvm.tir.PrimFunc)]
+    assert len(prim_funcs) == 1
+    assert _bound_ops(mod["main"]) == ["relax.call_tir"]
+
+    inputs = [
+        np.random.uniform(-1, 1, size).astype("float32")
+        for size in [(16, 64), (128, 64), (128,), (16, 128)]
+    ]
+    x, w, b, res = inputs
+    mm = x @ w.T + b
+    gelu = 0.5 * mm * (1 + np.vectorize(math.erf)(mm / np.sqrt(2)))
+    expected = (res + gelu).astype("float16")
+
+    ex = relax.build(mod, target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    out = vm["main"](*[tvm.nd.array(arr) for arr in inputs])
+    tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-2, atol=1e-2)
+
+
+def test_no_fusion_without_epilogue():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((16, 64), "float32"), w: R.Tensor((64, 32), "float32")):
+            with R.dataflow():
+                gv = R.matmul(x, w)
+                R.output(gv)
+            return gv
+
+    mod = relax.transform.FuseEpilogue()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_no_fusion_of_used_intermediate():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(
+            x: R.Tensor((16, 64), "float32"),
+            w: R.Tensor((64, 32), "float32"),
+            b: R.Tensor((32,), "float32"),
+        ):
+            with R.dataflow():
+                mm = R.matmul(x, w)
+                biased = R.add(mm, b)
+                act = R.nn.relu(biased)
+                gv = R.add(act, biased)
+                R.output(gv)
+            return gv
+
+    mod = relax.transform.FuseEpilogue()(Module)
+    (func,) = _grouped_functions(mod).values()
+    # The bias add is also used by the residual add, so only matmul + bias are grouped.
+    assert _bound_ops(func) == ["relax.matmul", "relax.add"]
+    assert _bound_ops(mod["main"]) == ["relax.nn.relu", "relax.add"]
+
+
+def test_no_fusion_of_broadcasting_epilogue():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(
+            x: R.Tensor((1, 16, 64), "float32"),
+            w: R.Tensor((64, 32), "float32"),
+            y: R.Tensor((4, 16, 32), "float32"),
+        ):
+            with R.dataflow():
+                mm = R.matmul(x, w)
+                gv = R.add(mm, y)
+                R.output(gv)
+            return gv
+
+    mod = relax.transform.FuseEpilogue()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
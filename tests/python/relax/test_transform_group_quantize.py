@@ -0,0 +1,145 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+def _called_prim_funcs(func):
+    names = []
+
+    def visit(expr):
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.call_tir"):
+            names.append(expr.args[0].name_hint)
+
+    relax.analysis.post_order_visit(func.body, visit)
+    return names
+
+
+def _reference_dequantize(weight, bits, group_size, axis):
+    """Quantize and dequantize a weight group-wise along axis with numpy."""
+    max_int = (1 << (bits - 1)) - 1
+    w = np.moveaxis(weight, axis, 0)
+    groups = w.reshape(w.shape[0] // group_size, group_size, w.shape[1])
+    scale = np.abs(groups).max(axis=1, keepdims=True) / np.float32(max_int)
+    q = np.clip(np.round(groups / scale), -max_int, max_int)
+    return np.moveaxis((q * scale).reshape(w.shape), 0, axis)
+
+
+@I.ir_module
+class Linear:
+    @R.function
+    def main(
+        x: R.Tensor((4, 64), "float32"),
+        w0: R.Tensor((64, 32), "float32"),
+        w1: R.Tensor((16, 32), "float32"),
+    ):
+        R.func_attr({"num_input": 1})
+        with R.dataflow():
+            lv = R.matmul(x, w0)
+            w1_t = R.permute_dims(w1)
+            gv = R.matmul(lv, w1_t)
+            R.output(gv)
+        return gv
+
+
+def test_rewrite():
+    mod = relax.transform.GroupQuantizeWeights(bits=4, group_size=16)(Linear)
+    called = _called_prim_funcs(mod["main"])
+    assert [name.startswith("group_quantize") for name in called].count(True) == 2
+    assert [name.startswith("group_dequantize") for name in called].count(True) == 2
+
+    lifted = relax.transform.LiftTransformParams()(mod)
+    # The quantization moved to transform_params, which outputs the packed weights and scales.
+    assert all(
+        not name.startswith("group_quantize") for name in _called_prim_funcs(lifted["main"])
+    )
+    params = sorted(
+        (param.struct_info.dtype, [int(dim) for dim in param.struct_info.shape])
+        for param in lifted["main"].params[1:]
+    )
+    assert params == [
+        # The 64 x 32 weight is quantized in groups of 16 along its 64 rows, and the transposed
+        # 16 x 32 weight along its 32 columns.
+        ("float32", [4, 32]),
+        ("float32", [16, 2]),
+        # 8 int4 values are packed per uint32 word.
+        ("uint32", [8, 32]),
+        ("uint32", [16, 4]),
+    ]
+
+
+def test_no_quantization_of_inputs():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4, 64), "float32"), w: R.Tensor((64, 32), "float32")):
+            with R.dataflow():
+                gv = R.matmul(x, w)
+                R.output(gv)
+            return gv
+
+    mod = relax.transform.GroupQuantizeWeights()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_no_quantization_of_unaligned_weight():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4, 48), "float32"), w: R.Tensor((48, 32), "float32")):
+            R.func_attr({"num_input": 1})
+            with R.dataflow():
+                gv = R.matmul(x, w)
+                R.output(gv)
+            return gv
+
+    mod = relax.transform.GroupQuantizeWeights(group_size=32)(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+@pytest.mark.parametrize("bits", [4, 8])
+def test_numerics(bits):
+    mod = relax.transform.GroupQuantizeWeights(bits=bits, group_size=16)(Linear)
+    mod = relax.transform.LiftTransformParams()(mod)
+    mod = relax.get_pipeline("zero", fuse_epilogue=True)(mod)
+    # Each dequantization is fused into the matmul reading it.
+    assert len(_called_prim_funcs(mod["main"])) == 2
+
+    x = np.random.uniform(-1, 1, (4, 64)).astype("float32")
+    w0 = np.random.uniform(-1, 1, (64, 32)).astype("float32")
+    w1 = np.random.uniform(-1, 1, (16, 32)).astype("float32")
+    expected = (
+        x
+        @ _reference_dequantize(w0, bits, 16, axis=0)
+        @ _reference_dequantize(w1, bits, 16, axis=1).T
+    )
+
+    ex = relax.build(mod, target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    params = vm["main_transform_params"]([tvm.nd.array(w0), tvm.nd.array(w1)])
+    out = vm["main"](tvm.nd.array(x), *params)
+    tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-4, atol=1e-4)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
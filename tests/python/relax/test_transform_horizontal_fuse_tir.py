@@ -0,0 +1,169 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+def test_fuse_independent_kernels():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def add_one(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(2, thread="blockIdx.x"):
+                for tx in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("add"):
+                        v = T.axis.spatial(256, bx * 128 + tx)
+                        B[v] = A[v] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def relu(A: T.Buffer((512,), "float32"), B: T.Buffer((512,), "float32")):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("relu"):
+                        v = T.axis.spatial(512, bx * 128 + tx)
+                        B[v] = T.max(A[v], T.float32(0))
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32"), y: R.Tensor((512,), "float32")):
+            cls = Before
+            with R.dataflow():
+                lv = R.call_tir(cls.add_one, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                lv1 = R.call_tir(cls.relu, (y,), out_sinfo=R.Tensor((512,), "float32"))
+                gv = (lv, lv1)
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def fused_horizontal_add_one_relu(
+            A: T.Buffer((256,), "float32"),
+            A_1: T.Buffer((512,), "float32"),
+            B: T.Buffer((256,), "float32"),
+            B_1: T.Buffer((512,), "float32"),
+        ):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(6, thread="blockIdx.x"):
+                if bx < 2:
+                    for tx in T.thread_binding(128, thread="threadIdx.x"):
+                        with T.block("add"):
+                            v = T.axis.spatial(256, bx * 128 + tx)
+                            B[v] = A[v] + T.float32(1)
+                else:
+                    for tx in T.thread_binding(128, thread="threadIdx.x"):
+                        with T.block("relu"):
+                            v = T.axis.spatial(512, (bx - 2) * 128 + tx)
+                            B_1[v] = T.max(A_1[v], T.float32(0))
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32"), y: R.Tensor((512,), "float32")):
+            cls = Expected
+            with R.dataflow():
+                lv2 = R.call_tir(
+                    cls.fused_horizontal_add_one_relu,
+                    (x, y),
+                    out_sinfo=[R.Tensor((256,), "float32"), R.Tensor((512,), "float32")],
+                )
+                lv: R.Tensor((256,), "float32") = lv2[0]
+                lv1: R.Tensor((512,), "float32") = lv2[1]
+                gv = (lv, lv1)
+                R.output(gv)
+            return gv
+
+    After = relax.transform.HorizontalFuseTIR()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_no_fusion_of_dependent_kernels():
+    @I.ir_module
+    class Module:
+        @T.prim_func(private=True)
+        def add_one(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(2, thread="blockIdx.x"):
+                for tx in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("add"):
+                        v = T.axis.spatial(256, bx * 128 + tx)
+                        B[v] = A[v] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32")):
+            cls = Module
+            with R.dataflow():
+                lv = R.call_tir(cls.add_one, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                gv = R.call_tir(cls.add_one, (lv,), out_sinfo=R.Tensor((256,), "float32"))
+                R.output(gv)
+            return gv
+
+    After = relax.transform.HorizontalFuseTIR()(Module)
+    tvm.ir.assert_structural_equal(After, Module)
+
+
+def test_no_fusion_of_large_or_mismatched_kernels():
+    @I.ir_module
+    class Module:
+        @T.prim_func(private=True)
+        def add_one(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(2, thread="blockIdx.x"):
+                for tx in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("add"):
+                        v = T.axis.spatial(256, bx * 128 + tx)
+                        B[v] = A[v] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def add_one_64(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("add"):
+                        v = T.axis.spatial(256, bx * 64 + tx)
+                        B[v] = A[v] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def relu(A: T.Buffer((512,), "float32"), B: T.Buffer((512,), "float32")):
+            T.func_attr({"tir.is_scheduled": T.bool(True), "tir.noalias": T.bool(True)})
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("relu"):
+                        v = T.axis.spatial(512, bx * 128 + tx)
+                        B[v] = T.max(A[v], T.float32(0))
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32"), y: R.Tensor((512,), "float32")):
+            cls = Module
+            with R.dataflow():
+                lv = R.call_tir(cls.add_one, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                lv1 = R.call_tir(cls.add_one_64, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                lv2 = R.call_tir(cls.relu, (y,), out_sinfo=R.Tensor((512,), "float32"))
+                gv = (lv, lv1, lv2)
+                R.output(gv)
+            return gv
+
+    # add_one_64 has other thread extents, and relu has more thread blocks than the limit.
+    After = relax.transform.HorizontalFuseTIR(max_num_blocks=2)(Module)
+    tvm.ir.assert_structural_equal(After, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
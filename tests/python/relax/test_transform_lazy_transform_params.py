@@ -1186,5 +1186,99 @@ def test_set_output_callback_with_non_tuple_output():
     tvm.ir.assert_structural_equal(After, Expected)
 
 
+def test_stream_param_chains():
+    """Each output is produced right after the parameters it reads are loaded"""
+
+    @I.ir_module
+    class Before:
+        @R.function
+        def transform_params(
+            fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object),
+            fset_output: R.Callable([R.Prim("int64"), R.Object], R.Tuple([])),
+        ):
+            R.func_attr({"num_input": 2})
+            A = fget_param(R.prim_value(0), R.str("A"))
+            A = R.match_cast(A, R.Tensor([16, 32], "float32"))
+            B = fget_param(R.prim_value(1), R.str("B"))
+            B = R.match_cast(B, R.Tensor([16, 32], "float32"))
+            A_t = R.permute_dims(A)
+            B_t = R.permute_dims(B)
+            fset_output(R.prim_value(0), A_t)
+            fset_output(R.prim_value(1), B_t)
+            return R.tuple()
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def transform_params(
+            fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object),
+            fset_output: R.Callable([R.Prim("int64"), R.Object], R.Tuple([])),
+        ):
+            R.func_attr({"num_input": 2})
+            A = fget_param(R.prim_value(0), R.str("A"))
+            A = R.match_cast(A, R.Tensor([16, 32], "float32"))
+            A_t = R.permute_dims(A)
+            fset_output(R.prim_value(0), A_t)
+            B = fget_param(R.prim_value(1), R.str("B"))
+            B = R.match_cast(B, R.Tensor([16, 32], "float32"))
+            B_t = R.permute_dims(B)
+            fset_output(R.prim_value(1), B_t)
+            return R.tuple()
+
+    After = relax.transform.StreamParamChains()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_stream_concurrent_param_chains():
+    """The loads of concurrent chains come first, and their outputs last"""
+
+    @I.ir_module
+    class Before:
+        @R.function
+        def transform_params(
+            fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object),
+            fset_output: R.Callable([R.Prim("int64"), R.Object], R.Tuple([])),
+        ):
+            R.func_attr({"num_input": 2})
+            A = fget_param(R.prim_value(0), R.str("A"))
+            A = R.match_cast(A, R.Tensor([16, 32], "float32"))
+            A_t = R.permute_dims(A)
+            fset_output(R.prim_value(0), A_t)
+            B = fget_param(R.prim_value(1), R.str("B"))
+            B = R.match_cast(B, R.Tensor([16, 32], "float32"))
+            B_t = R.permute_dims(B)
+            fset_output(R.prim_value(1), B_t)
+            C = fget_param(R.prim_value(2), R.str("C"))
+            C = R.match_cast(C, R.Tensor([16, 32], "float32"))
+            C_t = R.permute_dims(C)
+            fset_output(R.prim_value(2), C_t)
+            return R.tuple()
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def transform_params(
+            fget_param: R.Callable([R.Prim("int64"), R.Object], R.Object),
+            fset_output: R.Callable([R.Prim("int64"), R.Object], R.Tuple([])),
+        ):
+            R.func_attr({"num_input": 2})
+            A = fget_param(R.prim_value(0), R.str("A"))
+            A = R.match_cast(A, R.Tensor([16, 32], "float32"))
+            B = fget_param(R.prim_value(1), R.str("B"))
+            B = R.match_cast(B, R.Tensor([16, 32], "float32"))
+            A_t = R.permute_dims(A)
+            B_t = R.permute_dims(B)
+            fset_output(R.prim_value(0), A_t)
+            fset_output(R.prim_value(1), B_t)
+            C = fget_param(R.prim_value(2), R.str("C"))
+            C = R.match_cast(C, R.Tensor([16, 32], "float32"))
+            C_t = R.permute_dims(C)
+            fset_output(R.prim_value(2), C_t)
+            return R.tuple()
+
+    After = relax.transform.StreamParamChains(num_concurrent_chains=2)(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -75,6 +75,29 @@ def test_allgather():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_collectives_in_group():
+    # fmt: off
+    @tvm.script.ir_module
+    class Collectives:
+        @R.function
+        def main(x: R.Tensor((10, 10), "float32"))  -> R.Tensor((10, 10), "float32"):
+            gv0: R.Tensor((10, 10), "float32") = R.ccl.allreduce(x, "sum", group="tp")
+            gv1: R.Tensor((40, 10), "float32") = R.ccl.allgather(x, 4, group="tp")
+            return x
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((10, 10), dtype="float32")) -> R.Tensor((10, 10), dtype="float32"):
+            gv0: R.Tensor((10, 10), dtype="float32") = R.call_dps_packed("runtime.disco.allreduce_group", [x, R.shape([0]), R.str("tp")], out_sinfo=R.Tensor((10, 10), dtype="float32"))
+            gv1: R.Tensor((40, 10), dtype="float32") = R.call_dps_packed("runtime.disco.allgather_group", [x, R.str("tp")], out_sinfo=R.Tensor((40, 10), dtype="float32"))
+            return x
+    # fmt: on
+
+    mod = LegalizeOps()(Collectives)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
 def test_broadcast_from_zero():
     # fmt: off
     @tvm.script.ir_module
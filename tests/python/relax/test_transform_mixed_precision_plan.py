@@ -0,0 +1,106 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+@I.ir_module
+class MLP:
+    @R.function
+    def main(
+        x: R.Tensor((16, 64), "float32"),
+        w0: R.Tensor((64, 64), "float32"),
+        w1: R.Tensor((64, 8), "float32"),
+    ):
+        with R.dataflow():
+            lv = R.matmul(x, w0)
+            lv1 = R.nn.relu(lv)
+            gv = R.matmul(lv1, w1)
+            R.output(gv)
+        return gv
+
+
+def _inputs():
+    np.random.seed(0)
+    return [
+        [
+            np.random.uniform(-1, 1, (16, 64)).astype("float32"),
+            np.random.uniform(-1, 1, (64, 64)).astype("float32"),
+            np.random.uniform(-1, 1, (64, 8)).astype("float32"),
+        ]
+        for _ in range(2)
+    ]
+
+
+def _plan(mod):
+    plan = mod["main"].attrs[relax.transform.mixed_precision_plan.MIXED_PRECISION_PLAN_ATTR]
+    return {str(k): str(v) for k, v in plan.items()}
+
+
+def _run(mod, args):
+    vm = relax.VirtualMachine(relax.build(mod, target="llvm"), tvm.cpu())
+    return vm["main"](*[tvm.nd.array(arr) for arr in args]).numpy()
+
+
+def test_large_budget_casts_all():
+    mod = relax.transform.calibrate_mixed_precision(
+        MLP, _inputs(), error_budget=1.0, dtypes=["float16"]
+    )
+    assert _plan(mod) == {"lv": "float16", "gv": "float16"}
+
+    mod = relax.transform.ApplyMixedPrecisionPlan()(mod)
+    casts = []
+
+    def visit(expr):
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.astype"):
+            casts.append(expr.attrs.dtype)
+
+    relax.analysis.post_order_visit(mod["main"].body, visit)
+    assert casts == ["float16"] * 4
+    # The matmuls still output float32.
+    assert mod["main"].ret_struct_info.dtype == "float32"
+
+
+def test_zero_budget_casts_none():
+    mod = relax.transform.calibrate_mixed_precision(
+        MLP, _inputs(), error_budget=0.0, dtypes=["float16"]
+    )
+    assert _plan(mod) == {}
+    applied = relax.transform.ApplyMixedPrecisionPlan()(mod)
+    tvm.ir.assert_structural_equal(applied["main"].body, MLP["main"].body)
+
+
+def test_error_within_budget():
+    inputs = _inputs()
+    budget = 1e-3
+    mod = relax.transform.calibrate_mixed_precision(
+        MLP, inputs, error_budget=budget, dtypes=["float16"]
+    )
+    mod = relax.transform.ApplyMixedPrecisionPlan()(mod)
+    for args in inputs:
+        expected = _run(MLP, args)
+        out = _run(mod, args)
+        assert np.linalg.norm(out - expected) <= budget * np.linalg.norm(expected)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
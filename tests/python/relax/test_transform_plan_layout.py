@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+def _conv_layouts(mod):
+    layouts = []
+
+    def visit(expr):
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.nn.conv2d"):
+            layouts.append((expr.attrs.data_layout, expr.attrs.kernel_layout))
+
+    relax.analysis.post_order_visit(mod["main"].body, visit)
+    return layouts
+
+
+def _make_cnn(channels, size):
+    @I.ir_module
+    class CNN:
+        @R.function
+        def main(
+            x: R.Tensor((1, channels, size, size), "float32"),
+            w1: R.Tensor((channels, channels, 3, 3), "float32"),
+            w2: R.Tensor((channels, channels, 3, 3), "float32"),
+        ):
+            with R.dataflow():
+                lv0 = R.nn.conv2d(x, w1, padding=[1, 1])
+                lv1 = R.nn.relu(lv0)
+                lv2 = R.nn.conv2d(lv1, w2, padding=[1, 1])
+                gv = R.nn.relu(lv2)
+                R.output(gv)
+            return gv
+
+    return CNN
+
+
+def test_small_feature_map_converted_to_nhwc():
+    # A 7 wide NCHW feature map fills less than half of the vector lanes, while its 256
+    # channels fill all of them.
+    mod = relax.transform.PlanLayout()(_make_cnn(256, 7))
+    assert _conv_layouts(mod) == [("NHWC", "OHWI"), ("NHWC", "OHWI")]
+    # The feature map is only transposed at the boundaries of the converted region.
+    permutes = []
+    relax.analysis.post_order_visit(
+        mod["main"].body,
+        lambda e: isinstance(e, relax.Call)
+        and e.op == tvm.ir.Op.get("relax.permute_dims")
+        and permutes.append(e),
+    )
+    assert len(permutes) == 4
+
+
+def test_large_feature_map_unchanged():
+    # Both layouts fill the vector lanes, so converting would only add layout transforms.
+    cnn = _make_cnn(16, 64)
+    mod = relax.transform.PlanLayout()(cnn)
+    tvm.ir.assert_structural_equal(mod, cnn)
+
+
+def test_custom_cost_model():
+    def cost_model(call):
+        if call.op == tvm.ir.Op.get("relax.nn.conv2d") and call.attrs.data_layout == "NCHW":
+            return 1.0
+        return 0.0
+
+    candidates = {"relax.nn.conv2d": [["NHWC", "HWIO"]]}
+    mod = relax.transform.PlanLayout(candidates, cost_model)(_make_cnn(16, 64))
+    assert _conv_layouts(mod) == [("NHWC", "HWIO"), ("NHWC", "HWIO")]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -757,6 +757,25 @@ def test_static_args():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_hip_graph_on_rocm():
+    @I.ir_module
+    class Before:
+        @R.function(pure=False)
+        def main():
+            storage0 = R.memory.alloc_storage(R.shape([8]), 0, "global", "float32")
+            alloc0 = R.memory.alloc_tensor(storage0, 0, R.shape([8]), "float32")
+            _ = R.call_packed("dummy_func", alloc0, R.dtype("float32"), R.str("string"))
+            return R.tuple()
+
+    with tvm.target.Target("rocm"):
+        mod = relax.transform.RewriteCUDAGraph()(Before)
+
+    script = mod.script()
+    assert "vm.builtin.hip_graph.get_cached_alloc" in script
+    assert "vm.builtin.hip_graph.run_or_capture" in script
+    assert "vm.builtin.cuda_graph" not in script
+
+
 def test_dynamic_capture():
     @I.ir_module
     class Before:
@@ -875,6 +894,82 @@ def test_dynamic_capture():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+
+def test_dynamic_capture_with_buckets():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def add_one(x_handle: T.handle, y_handle: T.handle):
+            m = T.int64()
+            x = T.match_buffer(x_handle, (m, 4), "float32")
+            y = T.match_buffer(y_handle, (m, 4), "float32")
+            for i, j in T.grid(m, 4):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    y[vi, vj] = x[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor(("m", 4), "float32")) -> R.Tensor(("m", 4), "float32"):
+            R.func_attr(
+                {
+                    "relax.rewrite_cuda_graph.capture_buckets": {"m": [16, 4, 8]},
+                    "relax.force_pure": True,
+                }
+            )
+            m = T.int64()
+            storage: R.Object = R.memory.alloc_storage(R.shape([256]), 0, "global", "float32")
+            alloc1: R.Tensor((m, 4), "float32") = R.memory.alloc_tensor(
+                storage, 0, R.shape([m, 4]), "float32"
+            )
+            _ = Before.add_one(x, alloc1)
+            storage1: R.Object = R.memory.alloc_storage(R.shape([256]), 0, "global", "float32")
+            alloc2: R.Tensor((m, 4), "float32") = R.memory.alloc_tensor(
+                storage1, 0, R.shape([m, 4]), "float32"
+            )
+            _ = Before.add_one(alloc1, alloc2)
+            alloc3: R.Tensor((m, 4), "float32") = R.builtin.alloc_tensor(
+                R.shape([m, 4]), "float32", 0, "global"
+            )
+            _ = Before.add_one(alloc2, alloc3)
+            return alloc3
+
+    mod = relax.transform.RewriteCUDAGraph()(Before)
+    assert "main_cuda_graph_capture" in [gv.name_hint for gv in mod.get_global_vars()]
+
+    main = mod["main"]
+    m = main.params[0].struct_info.shape[0]
+    bindings = {binding.var: binding.value for binding in main.body.blocks[0].bindings}
+    run_or_capture = [
+        value
+        for value in bindings.values()
+        if isinstance(value, relax.Call)
+        and len(value.args) == 2
+        and isinstance(value.args[0], relax.ExternFunc)
+        and value.args[0].global_symbol == "vm.builtin.cuda_graph.run_or_capture"
+    ]
+    assert len(run_or_capture) == 1
+    _, args, _, key = run_or_capture[0].args[1].fields
+
+    # The cache key rounds m up to the smallest bucket, and keeps the values beyond the largest.
+    bucket = key.values[0]
+    analyzer = tvm.arith.Analyzer()
+
+    def round_up(value):
+        rounded = tvm.tir.stmt_functor.substitute(bucket, {m: tvm.tir.IntImm("int64", value)})
+        return int(analyzer.simplify(rounded))
+
+    assert [round_up(value) for value in [1, 4, 5, 8, 9, 16, 17]] == [4, 4, 8, 8, 16, 16, 17]
+    tvm.ir.assert_structural_equal(args.fields[-1], key)
+
+    # The inputs are re-created from their storage with the padded shape.
+    alloc_tensor_op = tvm.ir.Op.get("relax.memory.alloc_tensor")
+    for padded in args.fields[:-1]:
+        alloc = bindings[padded]
+        assert alloc.op == alloc_tensor_op
+        tvm.ir.assert_structural_equal(alloc.args[2].values[0], bucket)
+        assert int(alloc.args[2].values[1]) == 4
+
+
 class TestMergeAllocFuncs(BaseCompare):
     @I.ir_module
     class Before:
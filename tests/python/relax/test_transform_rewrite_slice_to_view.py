@@ -0,0 +1,139 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import relax as R
+
+
+def _ops(mod):
+    bindings = mod["main"].body.blocks[0].bindings
+    return [
+        binding.value.op.name
+        for binding in bindings
+        if isinstance(binding.value, relax.Call) and isinstance(binding.value.op, tvm.ir.Op)
+    ]
+
+
+def _view_offsets(mod):
+    view_op = tvm.ir.Op.get("relax.memory.view")
+    return [
+        int(binding.value.args[3].value)
+        for binding in mod["main"].body.blocks[0].bindings
+        if isinstance(binding.value, relax.Call) and binding.value.op.same_as(view_op)
+    ]
+
+
+def test_leading_slice():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4, 8), "float32")):
+            with R.dataflow():
+                lv = R.strided_slice(x, axes=[0], begin=[0], end=[2])
+                gv = R.add(lv, lv)
+                R.output(gv)
+            return gv
+
+    after = relax.transform.RewriteSliceToView()(Module)
+    assert _ops(after) == ["relax.memory.view", "relax.add"]
+    assert _view_offsets(after) == [0]
+
+    x = np.random.rand(4, 8).astype("float32")
+    vm = relax.VirtualMachine(relax.build(after, "llvm"), tvm.cpu())
+    tvm.testing.assert_allclose(vm["main"](tvm.nd.array(x)).numpy(), x[:2] * 2)
+
+
+def test_slice_with_byte_offset():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4, 8), "float32")):
+            with R.dataflow():
+                lv = R.strided_slice(x, axes=[0], begin=[1], end=[3])
+                gv = R.add(lv, lv)
+                R.output(gv)
+            return gv
+
+    after = relax.transform.RewriteSliceToView()(Module)
+    tvm.ir.assert_structural_equal(after, Module)
+    after = relax.transform.RewriteSliceToView(allow_byte_offset=True)(Module)
+    assert _ops(after) == ["relax.memory.view", "relax.add"]
+    assert _view_offsets(after) == [32]
+
+
+def test_non_contiguous_slice():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4, 8), "float32")):
+            with R.dataflow():
+                lv = R.strided_slice(x, axes=[1], begin=[0], end=[4])
+                gv = R.add(lv, lv)
+                R.output(gv)
+            return gv
+
+    after = relax.transform.RewriteSliceToView(allow_byte_offset=True)(Module)
+    tvm.ir.assert_structural_equal(after, Module)
+
+
+def test_split():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((1, 6, 4), "float32")):
+            with R.dataflow():
+                lv = R.split(x, indices_or_sections=3, axis=1)
+                lv1 = lv[0]
+                lv2 = lv[2]
+                gv = R.add(lv1, lv2)
+                R.output(gv)
+            return gv
+
+    after = relax.transform.RewriteSliceToView()(Module)
+    tvm.ir.assert_structural_equal(after, Module)
+    after = relax.transform.RewriteSliceToView(allow_byte_offset=True)(Module)
+    assert "relax.split" not in _ops(after)
+    assert _view_offsets(after) == [0, 32, 64]
+
+
+def test_permute_unit_axes():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((1, 4, 8), "float32"), y: R.Tensor((2, 4, 8), "float32")):
+            with R.dataflow():
+                lv = R.permute_dims(x, axes=[1, 0, 2])
+                lv1 = R.permute_dims(y, axes=[1, 0, 2])
+                gv = R.add(lv, lv1)
+                R.output(gv)
+            return gv
+
+    after = relax.transform.RewriteSliceToView()(Module)
+    assert _ops(after) == ["relax.memory.view", "relax.permute_dims", "relax.add"]
+
+    x = np.random.rand(1, 4, 8).astype("float32")
+    y = np.random.rand(2, 4, 8).astype("float32")
+    vm = relax.VirtualMachine(relax.build(after, "llvm"), tvm.cpu())
+    result = vm["main"](tvm.nd.array(x), tvm.nd.array(y)).numpy()
+    tvm.testing.assert_allclose(result, x.transpose(1, 0, 2) + y.transpose(1, 0, 2))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -1073,6 +1073,92 @@ def test_tir_var_decreasing_monotone():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+
+def test_capture_buckets_as_upper_bound():
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor(("n", 4), dtype="float32")) -> R.Tensor(("n", 4), dtype="float32"):
+            n = T.int64()
+            R.func_attr(
+                {
+                    "relax.rewrite_cuda_graph.capture_buckets": {"n": [2, 8, 4]},
+                    "relax.force_pure": True,
+                }
+            )
+            cls = Module
+            alloc = R.builtin.alloc_tensor(R.shape([n, 4]), R.dtype("float32"), R.prim_value(0))
+            _ = cls.tir_exp(x, alloc)
+            alloc1 = R.builtin.alloc_tensor(R.shape([n, 4]), R.dtype("float32"), R.prim_value(0))
+            _1 = cls.tir_exp(alloc, alloc1)
+            return alloc1
+
+    mod = relax.transform.StaticPlanBlockMemory()(Module)
+    alloc_storage_op = tvm.ir.Op.get("relax.memory.alloc_storage")
+    storage_sizes = [
+        int(binding.value.args[0].values[0])
+        for binding in mod["main"].body.blocks[0].bindings
+        if isinstance(binding.value, relax.Call) and binding.value.op == alloc_storage_op
+    ]
+    # The largest bucket bounds n: 8 * 4 float32 elements.
+    assert storage_sizes == [128]
+
+
+def test_arena():
+    # fmt: off
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor(("n",), dtype="float32")) -> R.Tensor(("n",), dtype="float32"):
+            n = T.int64()
+            R.func_attr({"tir_var_upper_bound": {"n": 16}, "relax.memory_plan_arena": True, "relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((n,), dtype="float32") = R.builtin.alloc_tensor(R.shape([n]), R.dtype("float32"), R.prim_value(0))
+            _: R.Tuple = cls.tir_exp(x, alloc)
+            alloc1: R.Tensor((8,), dtype="float32") = R.builtin.alloc_tensor(R.shape([8]), R.dtype("float32"), R.prim_value(0))
+            _1: R.Tuple = cls.tir_exp(alloc, alloc1)
+            alloc2: R.Tensor((n,), dtype="float16") = R.builtin.alloc_tensor(R.shape([n]), R.dtype("float16"), R.prim_value(0))
+            _2: R.Tuple = cls.tir_exp(alloc1, alloc2)
+            alloc3: R.Tensor((n,), dtype="float32") = R.builtin.alloc_tensor(R.shape([n]), R.dtype("float32"), R.prim_value(0))
+            _3: R.Tuple = cls.tir_exp(alloc2, alloc3)
+            return alloc3
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor(("n",), dtype="float32")) -> R.Tensor(("n",), dtype="float32"):
+            n = T.int64()
+            R.func_attr({"tir_var_upper_bound": {"n": 16}, "relax.force_pure": True})
+            cls = Expected
+            arena: R.Object = R.memory.alloc_storage(R.shape([96]), R.prim_value(0), R.str("global"), R.dtype("uint8"))
+            alloc: R.Tensor((n,), dtype="float32") = R.memory.alloc_tensor(arena, R.prim_value(0), R.shape([n]), R.dtype("float32"))
+            _: R.Tuple = cls.tir_exp(x, alloc)
+            alloc1: R.Tensor((8,), dtype="float32") = R.memory.alloc_tensor(arena, R.prim_value(64), R.shape([8]), R.dtype("float32"))
+            _1: R.Tuple = cls.tir_exp(alloc, alloc1)
+            # The last use of alloc is done, so alloc2 takes its place.
+            alloc2: R.Tensor((n,), dtype="float16") = R.memory.alloc_tensor(arena, R.prim_value(0), R.shape([n]), R.dtype("float16"))
+            _2: R.Tuple = cls.tir_exp(alloc1, alloc2)
+            alloc3: R.Tensor((n,), dtype="float32") = R.builtin.alloc_tensor(R.shape([n]), R.dtype("float32"), R.prim_value(0))
+            _3: R.Tuple = cls.tir_exp(alloc2, alloc3)
+            return alloc3
+    # fmt: on
+
+    mod = relax.transform.StaticPlanBlockMemory()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
 def test_call_tir_dyn():
     # fmt: off
     @I.ir_module
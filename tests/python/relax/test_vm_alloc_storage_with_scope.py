@@ -72,3 +72,10 @@ def test_alloc_storage_with_scope_global():
     vm_rt.invoke_stateful("main")
     output = vm_rt.get_outputs("main").numpy()
     tvm.testing.assert_allclose(output_ref, output)
+
+
+def test_planned_storage_bytes():
+    with tvm.transform.PassContext(opt_level=3):
+        ex = relax.build(Module, "llvm", exec_mode="bytecode")
+    # The storage of 2 * 2 float32 elements is planned, and none is sized at runtime.
+    assert ex.planned_storage_bytes() == {"main": (16, 0)}
@@ -16,6 +16,9 @@
 # under the License.
 
 import ctypes
+import select
+import threading
+from concurrent.futures import ThreadPoolExecutor
 from typing import Tuple, Callable
 
 import numpy as np
@@ -104,6 +107,31 @@ def test_match_check(exec_mode):
         vm["foo"](x0, y2)
 
 
+def test_match_check_repeated_value(exec_mode):
+    @tvm.script.ir_module
+    class TestMatchCheckRepeated:
+        @R.function
+        def foo(x: R.Tensor((2, 3), "float32")) -> R.Tensor((2, 3), "float32"):
+            return x
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.build(TestMatchCheckRepeated, target, exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x0 = tvm.nd.array(np.zeros((2, 3)).astype("float32"))
+    x1 = tvm.nd.array(np.zeros((3, 2)).astype("float32"))
+    x2 = tvm.nd.array(np.zeros((2, 3)).astype("int32"))
+
+    # The checks of a value validated by the previous call are skipped, but the other values
+    # are still checked.
+    for _ in range(3):
+        vm["foo"](x0)
+    with pytest.raises(RuntimeError, match=".*match_cast.*"):
+        vm["foo"](x1)
+    with pytest.raises(ValueError, match=".*dtype.*"):
+        vm["foo"](x2)
+    vm["foo"](x0)
+
+
 def test_vm_compile_stage2(exec_mode):
     @tvm.script.ir_module
     class TestVMCompileStage2:
@@ -846,6 +874,143 @@ def test_recursion(exec_mode):
     tvm.testing.assert_allclose(res.numpy(), np.power(2.0, recursion_runs), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_op_with_packed_impl(exec_mode):
+    @tvm.script.ir_module
+    class TestVMOpWithPackedImpl:
+        @R.function(pure=False)
+        def main(x: R.Tensor((), "int32"), cond: R.Tensor((), "bool")):
+            _ = R.assert_op(relax.const(True))
+            if cond:
+                _1 = R.assert_op(x == x, x, format="x equals itself: {}")
+            else:
+                _1 = R.assert_op(relax.const(True))
+            return R.shape_to_tensor(R.shape([1, 2]))
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.build(TestVMOpWithPackedImpl, target, exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = tvm.nd.array(np.array(1).astype("int32"))
+    for cond in [True, False]:
+        res = vm["main"](x, tvm.nd.array(np.array(cond)))
+        tvm.testing.assert_allclose(res.numpy(), np.array([1, 2], "int64"))
+
+
+def test_vm_exec_mode_from_pass_context():
+    @tvm.script.ir_module
+    class TestVMExecMode:
+        @R.function
+        def foo(x: R.Tensor((3, 4), "float32"), y: R.Tensor((3, 4), "float32")):
+            z = R.call_pure_packed(
+                "test.vm.identity", x, y, sinfo_args=(R.Tensor(ndim=2, dtype="float32"))
+            )
+            return y
+
+    target = tvm.target.Target("llvm", host="llvm")
+    with tvm.transform.PassContext(config={"relax.vm.exec_mode": "compiled"}):
+        ex = relax.build(TestVMExecMode, target)
+    assert "@foo num_inputs=2 vm_tir_func" in ex.as_text()
+    inp1 = tvm.nd.array(np.random.rand(3, 4).astype(np.float32))
+    inp2 = tvm.nd.array(np.random.rand(3, 4).astype(np.float32))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm["foo"](inp1, inp2)
+    tvm.testing.assert_allclose(inp2.numpy(), inp1.numpy(), rtol=1e-7, atol=1e-7)
+
+
+
+def test_vm_concurrent_calls(exec_mode):
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def add_one(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            y = R.add(x, R.const(1, "float32"))
+            return y
+
+        @R.function
+        def main(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            cls = Module
+            y = cls.add_one(x)
+            z = cls.add_one(y)
+            w = R.multiply(z, x)
+            return w
+
+    ex = relax.build(Module, "llvm", exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    def run(seed):
+        outputs = []
+        for i in range(16):
+            x_np = np.full((4,), seed * 16 + i, dtype="float32")
+            outputs.append((x_np, vm["main"](tvm.nd.array(x_np)).numpy()))
+        return outputs
+
+    # The threads share one VM, each call runs on its own execution context.
+    with ThreadPoolExecutor(max_workers=4) as executor:
+        results = list(executor.map(run, range(4)))
+    for outputs in results:
+        for x_np, res in outputs:
+            tvm.testing.assert_allclose(res, (x_np + 2) * x_np)
+
+
+def test_vm_invoke_closure_async(exec_mode):
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            y = R.add(x, R.const(2, "float32"))
+            z = R.multiply(y, x)
+            return z
+
+    ex = relax.build(Module, "llvm", exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm.set_num_async_workers(2)
+    x_np = np.arange(4).astype("float32")
+    futures = [vm.invoke_closure_async("main", tvm.nd.array(x_np + i)) for i in range(8)]
+    done = []
+    futures[-1].add_done_callback(lambda future: done.append(future.done()))
+    for i, future in enumerate(futures):
+        tvm.testing.assert_allclose(future.result().numpy(), (x_np + i + 2) * (x_np + i))
+    assert futures[-1].wait(timeout=0)
+    assert done == [True]
+    if futures[0].fileno() >= 0:
+        readable, _, _ = select.select([futures[0].fileno()], [], [], 0)
+        assert readable == [futures[0].fileno()]
+
+
+def test_vm_invoke_closure_async_cancel():
+    started = threading.Event()
+    release = threading.Event()
+    calls = []
+
+    @tvm.register_func("test.vm.async_block", override=True)
+    def async_block(x):
+        calls.append(x)
+        started.set()
+        release.wait()
+        return x
+
+    @tvm.script.ir_module
+    class Module:
+        @R.function(pure=False)
+        def main(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            y = R.call_packed("test.vm.async_block", x, sinfo_args=R.Tensor((4,), "float32"))
+            z = R.call_packed("test.vm.async_block", y, sinfo_args=R.Tensor((4,), "float32"))
+            return z
+
+    ex = relax.build(Module, "llvm", exec_mode="bytecode")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    running = vm.invoke_closure_async("main", tvm.nd.array(np.zeros((4,), "float32")))
+    queued = vm.invoke_closure_async("main", tvm.nd.array(np.zeros((4,), "float32")))
+    assert started.wait(timeout=10)
+    running.cancel()
+    queued.cancel()
+    release.set()
+    # The running call stops before its second call, and the queued call does not run.
+    for future in [running, queued]:
+        with pytest.raises(tvm.TVMError, match="cancelled"):
+            future.result()
+    assert len(calls) == 1
+
+
 @tvm.testing.requires_gpu
 def test_vm_to_device(exec_mode):
     @tvm.script.ir_module
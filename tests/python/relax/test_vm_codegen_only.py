@@ -129,6 +129,37 @@ def test_vm_exec_serialize_export_library(exec_mode):
     assert ex.as_text() == loaded_exec["as_text"]()
 
 
+def test_vm_exec_save_load_file_mapped_constants():
+    a = np.random.rand(3, 4).astype("float32")
+    b = np.arange(5).astype("int8")
+    c = np.zeros((0, 2), "float32")
+
+    @tvm.script.ir_module
+    class TestVMConstants:
+        @R.function
+        def main():
+            R.func_attr({"global_symbol": "main"})
+            return (relax.const(a), relax.const(b), relax.const(c))
+
+    mod = TestVMConstants
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = codegen(mod, target)
+    from tvm.contrib import utils
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.bin")
+    ex.mod.save(path_exec)
+
+    # The constants of the loaded executable view the mapped file.
+    loaded_exec = tvm.get_global_func("relax.ExecutableLoadFromFile")(path_exec)
+    assert ex.as_text() == loaded_exec["as_text"]()
+    vm = relax.VirtualMachine(loaded_exec, tvm.cpu())
+    res = vm["main"]()
+    for x, y in zip(res, [a, b, c]):
+        assert x.dtype == str(y.dtype)
+        tvm.testing.assert_allclose(x.numpy(), y)
+
+
 @pytest.mark.parametrize("exec_mode", EXEC_MODE)
 def test_if_cond(exec_mode):
     @tvm.script.ir_module
@@ -20,6 +20,7 @@ from tvm.script import tir as T, relax as R, ir as I
 from tvm import relax
 import tvm.testing
 import numpy as np
+import pytest
 
 
 # fmt: off
@@ -91,10 +92,11 @@ def codegen(mod, target, exec_mode="bytecode"):
 
 
 @tvm.testing.requires_cuda
-def test_vm_run():
+@pytest.mark.parametrize("exec_mode", ["bytecode", "compiled"])
+def test_vm_run(exec_mode):
     mod = Module
     target = tvm.target.Target("cuda", host="llvm")
-    ex = codegen(mod, target)
+    ex = codegen(mod, target, exec_mode)
     dev = tvm.cuda(0)
     vm = relax.VirtualMachine(ex, dev)
     x_np = np.random.uniform(size=(16, 16)).astype("float32")
@@ -104,5 +106,24 @@ def test_vm_run():
     tvm.testing.assert_allclose(y.asnumpy(), y_np, rtol=1e-5, atol=1e-5)
 
 
+@tvm.testing.requires_cuda
+def test_vm_run_launch_sequence():
+    # The kernels of the capture function are recorded and launched again instead of a graph.
+    source = Module.script().replace(
+        "vm.builtin.cuda_graph.run_or_capture", "vm.builtin.cuda_launch_sequence.run_or_record"
+    )
+    mod = tvm.script.from_source(source)
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = codegen(mod, target)
+    dev = tvm.cuda(0)
+    vm = relax.VirtualMachine(ex, dev)
+    for _ in range(3):
+        x_np = np.random.uniform(size=(16, 16)).astype("float32")
+        x = tvm.nd.array(x_np, dev)
+        y = vm["main"](x)
+        y_np = x_np + 1.0 + 1.0 + 1.0 + 1.0
+        tvm.testing.assert_allclose(y.asnumpy(), y_np, rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Lowest level testing VM. Test execbuilder and execution."""
+import weakref
+
 import numpy as np
 import pytest
 
@@ -240,6 +242,74 @@ def test_vm_if():
     tvm.testing.assert_allclose(res.numpy(), a.numpy() + b.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_dispatch_with_instrument():
+    ib = relax.ExecBuilder()
+    c = tvm.nd.array(np.random.rand(4))
+    with ib.function("inner", num_inputs=2):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    with ib.function("main", num_inputs=3):
+        ib.emit_if(ib.r(0), 3)
+        ib.emit_call("inner", args=[ib.r(1), ib.r(2)], dst=ib.r(3))
+        ib.emit_goto(2)
+        ib.emit_call("test.vm.mul", args=[ib.r(1), c], dst=ib.r(3))
+        ib.emit_ret(ib.r(3))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    a = tvm.nd.array(np.random.rand(4))
+    b = tvm.nd.array(np.random.rand(4))
+
+    def check():
+        res = vm["main"](0, a, b)
+        tvm.testing.assert_allclose(res.numpy(), a.numpy() * c.numpy(), rtol=1e-7, atol=1e-7)
+        res = vm["main"](1, a, b)
+        tvm.testing.assert_allclose(res.numpy(), a.numpy() + b.numpy(), rtol=1e-7, atol=1e-7)
+
+    # The pre-decoded dispatch loop without instrument.
+    check()
+    # The generic path with instrument.
+    hit_count = {}
+
+    def instrument(func, name, before_run, ret_value, *args):
+        hit_count[name] = hit_count.get(name, 0) + 1
+
+    vm.set_instrument(instrument)
+    check()
+    assert hit_count["test.vm.mul"] == 2
+    assert hit_count["test.vm.add"] == 2
+
+
+def test_vm_release_register_after_last_use():
+    class Token:
+        pass
+
+    tokens = []
+
+    @tvm.register_func("test.vm.make_token", override=True)
+    def make_token():
+        token = Token()
+        tokens.append(weakref.ref(token))
+        # The token lives as long as the function that captures it.
+        return tvm.runtime.convert(lambda: token)
+
+    @tvm.register_func("test.vm.token_alive", override=True)
+    def token_alive(*_args):
+        return tokens[-1]() is not None
+
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=0):
+        ib.emit_call("test.vm.make_token", dst=ib.r(0))
+        ib.emit_call("test.vm.token_alive", args=[ib.r(0)], dst=ib.r(1))
+        ib.emit_call("test.vm.token_alive", dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    # The register of the token is released after its last use, before the function returns.
+    assert not vm["main"]()
+    vm.set_instrument(lambda *args: None)
+    assert not vm["main"]()
+
+
 def test_vm_invoke_closure():
     ib = relax.ExecBuilder()
     with ib.function("lifted_func_1", num_inputs=4):
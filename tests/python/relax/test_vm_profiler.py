@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
 import tvm
 import tvm.testing
@@ -62,6 +64,22 @@ def test_conv2d_cpu():
     assert "matmul" in str(report)
 
 
+def test_sampling_profiler():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm.enable_sampling_profiler(2)
+    expected = vm["main"](tvm.nd.array(data_np)).numpy()
+    for _ in range(4):
+        tvm.testing.assert_allclose(vm["main"](tvm.nd.array(data_np)).numpy(), expected)
+
+    report = vm.sampling_report()
+    assert json.loads(report.json())["configuration"]["Sampled Requests"]["count"] == 3
+    assert "matmul" in str(report)
+    assert "p99 (us)" in str(report)
+
+
 def with_rpc(ex, f, data_np):
     temp = utils.tempdir()
     path = temp.relpath("vm_library.so")
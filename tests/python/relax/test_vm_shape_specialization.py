@@ -0,0 +1,95 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import relax as R
+
+
+@tvm.script.ir_module
+class Module:
+    @R.function
+    def add(x: R.Tensor(("n", "m"), "float32"), y: R.Tensor(("n", "m"), "float32")):
+        z = R.add(x, y)
+        return z
+
+
+def _build():
+    ex = relax.build(relax.transform.SpecializeShapes({"add": [((4, 8), (4, 8))]})(Module), "llvm")
+    return relax.VirtualMachine(ex, tvm.cpu())
+
+
+def _inputs(shape):
+    return [tvm.nd.array(np.random.rand(*shape).astype("float32")) for _ in range(2)]
+
+
+def test_record_shape_signatures():
+    vm = _build()
+    vm.record_shape_signatures()
+    for _ in range(3):
+        vm["add"](*_inputs((4, 8)))
+    vm["add"](*_inputs((2, 3)))
+    assert vm.get_shape_signatures("add") == [(((4, 8), (4, 8)), 3), (((2, 3), (2, 3)), 1)]
+    vm.record_shape_signatures(False)
+    vm["add"](*_inputs((2, 3)))
+    assert vm.get_shape_signatures("add")[1][1] == 1
+
+
+def test_specialize_shapes_ahead_of_time():
+    vm = _build()
+    x, y = _inputs((4, 8))
+    tvm.testing.assert_allclose(vm["add_specialized_0"](x, y).numpy(), x.numpy() + y.numpy())
+    vm.set_shape_variant("add", [(4, 8), (4, 8)], "add_specialized_0")
+    tvm.testing.assert_allclose(vm["add"](x, y).numpy(), x.numpy() + y.numpy())
+    # The other shapes still run the generic function.
+    x, y = _inputs((2, 3))
+    tvm.testing.assert_allclose(vm["add"](x, y).numpy(), x.numpy() + y.numpy())
+
+
+def test_shape_variant_dispatch():
+    vm = _build()
+    calls = []
+
+    def variant(x, y):
+        calls.append(tuple(x.shape))
+        return x
+
+    vm.set_shape_variant("add", [(4, 8), (4, 8)], tvm.runtime.convert(variant))
+    vm["add"](*_inputs((4, 8)))
+    vm["add"](*_inputs((2, 3)))
+    assert calls == [(4, 8)]
+    vm.set_shape_variant("add", [(4, 8), (4, 8)], None)
+    vm["add"](*_inputs((4, 8)))
+    assert calls == [(4, 8)]
+
+
+def test_specialize_hot_shapes():
+    vm = relax.VirtualMachine(relax.build(Module, "llvm"), tvm.cpu())
+    vm.record_shape_signatures()
+    for shape in [(4, 8), (4, 8), (2, 3)]:
+        vm["add"](*_inputs(shape))
+    thread = vm.specialize_hot_shapes(Module, "add", "llvm", background=True)
+    thread.join()
+    for shape in [(4, 8), (2, 3)]:
+        x, y = _inputs(shape)
+        tvm.testing.assert_allclose(vm["add"](x, y).numpy(), x.numpy() + y.numpy())
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -152,6 +152,46 @@ def test_mobilenet(enable_usmp: bool, target_kind: str):
     assert (runner.get_output(0).asnumpy() == list(ref_outputs.values())[0]).all()
 
 
+@pytest.mark.parametrize("enable_usmp", [True, False])
+def test_unchecked_kernels_zero_copy(enable_usmp):
+    """Runs the kernels through their unchecked entries, with inputs and outputs set without
+    copies"""
+    x = relay.var("x", shape=(4, 16), dtype="float32")
+    y = relay.nn.softmax(relay.nn.relu(x) + relay.const(1.0))
+    ir_mod = tvm.IRModule.from_expr(relay.Function([x], y * y))
+    x_data = np.random.uniform(-1, 1, (4, 16)).astype("float32")
+    ref_output = list(generate_ref_data(ir_mod, {"x": x_data}).values())[0]
+
+    config = {"tir.emit_unchecked_api": True, "tir.usmp.enable": enable_usmp}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        mod = tvm.relay.build(
+            ir_mod, target="llvm", executor=backend.Executor("aot", {"interface-api": "packed"})
+        )
+    llvm_source = "".join(
+        m.get_source("ll") for m in [mod.lib] + mod.lib.imported_modules if m.type_key == "llvm"
+    )
+    kernel_calls = [
+        name
+        for name in re.findall(r"call i32 @(tvmgen_default_fused_\w+)\(", llvm_source)
+        if not name.endswith("_compute_")
+    ]
+    assert kernel_calls and all(name.endswith("__unchecked") for name in kernel_calls)
+
+    runner = tvm.runtime.executor.AotModule(mod["default"](tvm.cpu(0)))
+    x_nd = tvm.nd.array(x_data)
+    out_nd = tvm.nd.empty((4, 16), "float32")
+    runner.set_input_zero_copy("x", x_nd)
+    runner.set_output_zero_copy(0, out_nd)
+    runner.run()
+    tvm.testing.assert_allclose(out_nd.numpy(), ref_output, rtol=1e-5)
+
+    # The next run reads the new content of the input.
+    x_nd.copyfrom(-x_data)
+    runner.run()
+    ref_output = list(generate_ref_data(ir_mod, {"x": -x_data}).values())[0]
+    tvm.testing.assert_allclose(out_nd.numpy(), ref_output, rtol=1e-5)
+
+
 def test_module_list():
     """Checks the correct list of module names is generated"""
     input_x = tvm.relay.var("x", tvm.relay.TensorType([1], dtype="float32"))
@@ -324,6 +324,48 @@ def test_reshape_nop():
     tvm.testing.assert_allclose(gmod.get_output(2).numpy(), z2_np)
 
 
+def _storage_bytes(graph_json):
+    """The total bytes of the storage of a graph, with the offsets of the pooled entries."""
+    attrs = graph_json["attrs"]
+    offsets = attrs.get("storage_offset", ["list_int", [0] * len(attrs["storage_id"][1])])[1]
+    sid_bytes = {}
+    for sid, shape, dtype, offset in zip(
+        attrs["storage_id"][1], attrs["shape"][1], attrs["dltype"][1], offsets
+    ):
+        nbytes = int(np.prod(shape)) * np.dtype(dtype).itemsize + offset
+        sid_bytes[sid] = max(sid_bytes.get(sid, 0), nbytes)
+    return sum(sid_bytes.values())
+
+
+def test_plan_memory_offset():
+    x = relay.var("x", shape=(16, 16))
+    a = relay.nn.relu(x)
+    b = relay.nn.softmax(a)
+    # The add runs in place of one of its inputs, so three buffers are never live at once.
+    c = relay.add(a, b)
+    func = relay.Function([x], relay.nn.softmax(c))
+    mod = tvm.IRModule.from_expr(func)
+    x_data = np.random.rand(16, 16).astype("float32")
+
+    outputs = {}
+    graphs = {}
+    for planner in ["greedy", "offset"]:
+        config = {"relay.backend.graph_memory_planner": planner}
+        with tvm.transform.PassContext(opt_level=0, config=config):
+            lib = relay.build(mod, "llvm")
+        graphs[planner] = json.loads(lib.get_graph_json())
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_input(x=x_data)
+        gmod.run()
+        outputs[planner] = gmod.get_output(0).numpy()
+
+    tvm.testing.assert_allclose(outputs["offset"], outputs["greedy"], rtol=1e-5)
+    # The input has a storage of its own, and the intermediates and output share one pool.
+    assert len(set(graphs["offset"]["attrs"]["storage_id"][1])) == 2
+    assert "storage_offset" in graphs["offset"]["attrs"]
+    assert _storage_bytes(graphs["offset"]) < _storage_bytes(graphs["greedy"])
+
+
 @tvm.testing.uses_gpu
 def test_gru_like():
     def unit(rnn_dim):
@@ -423,6 +423,9 @@ def test_tir_link_params():
         # Workload look up should succeed. This does not work when the test is invoked from pytest.
         assert not "Cannot find workload" in stderr_buf.getvalue()
 
+    # The linked weight spans several pages, so it is page aligned.
+    assert "align 4096" in lib.lib.get_source("ll")
+
     dev = tvm.device(target, 0)
     runtime = tvm.contrib.graph_executor.GraphModule(lib["default"](dev))
     runtime.set_input(**params)
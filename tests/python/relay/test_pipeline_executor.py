@@ -265,6 +265,9 @@ def get_manual_conf(mods, target):
     pipe_config1 = {
         "mod_idx": 0,
         "cpu_affinity": "0",
+        "queue_capacity": 1024,
+        "batch_size": 1,
+        "queue_policy": "block",
         "output": [
             {"output_idx": 0, "dependencies": [{"mod_idx": 1, "input_name": "data_n_0"}]},
             {"output_idx": 1, "dependencies": [{"mod_idx": 2, "input_name": "data_n_2"}]},
@@ -284,6 +287,9 @@ def get_manual_conf(mods, target):
     pipe_config2 = {
         "mod_idx": 1,
         "cpu_affinity": "0",
+        "queue_capacity": 1024,
+        "batch_size": 1,
+        "queue_policy": "block",
         "output": [
             {"output_idx": 0, "dependencies": [{"mod_idx": 2, "input_name": "data_n_1"}]},
         ],
@@ -302,6 +308,9 @@ def get_manual_conf(mods, target):
     pipe_config3 = {
         "mod_idx": 2,
         "cpu_affinity": "0",
+        "queue_capacity": 1024,
+        "batch_size": 1,
+        "queue_policy": "block",
         "output": [{"output_idx": 0, "dependencies": [{"global_output_index": 0}]}],
     }
     mod_config[mods[2]] = {
@@ -619,6 +628,16 @@ def test_pipeline():
 
                     assert pipeline_module_test.num_executing_pipeline == round + 1
 
+            # Checking the metrics of the stages after the pipeline drains.
+            metrics = pipeline_module_test.get_stage_metrics()
+            assert len(metrics) == 3
+            for stage in metrics:
+                assert stage["batch_size"] == 1
+                assert stage["dropped_requests"] == 0
+                assert stage["queue_capacity"] == 1024
+                assert stage["max_queue_depth"] <= stage["queue_capacity"]
+            assert metrics[-1]["requests"] == len(datas)
+
             # Reset the cpu affinity after a test.
             reset_cpu_affinity(affinity)
 
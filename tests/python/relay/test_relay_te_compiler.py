@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
 import tvm
 from tvm import te
@@ -21,6 +23,7 @@ import tvm.testing
 from tvm import relay
 from tvm import autotvm
 from tvm import topi
+from tvm.contrib import graph_executor, utils
 from tvm.relay.backend import te_compiler
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
@@ -161,6 +164,42 @@ def test_select_implementation():
                 assert impl.name == "conv2d_1"
 
 
+def test_select_implementation_engine_cache():
+    target = tvm.target.Target("llvm")
+    cache_dir = utils.tempdir().temp_dir
+    dshape, wshape = (1, 8, 7, 7), (32, 8, 3, 3)
+    data = relay.var("data", shape=dshape)
+    weight = relay.var("wshape", shape=wshape)
+    out = run_infer_type(relay.nn.conv2d(data, weight, padding=(1, 1)))
+
+    def _select_impl():
+        return relay.backend.te_compiler.select_implementation(
+            relay.op.get("nn.conv2d"),
+            out.attrs,
+            [te.placeholder(dshape), te.placeholder(wshape)],
+            out.checked_type,
+            target,
+        )
+
+    with TempOpAttr("nn.conv2d", "FTVMStrategy", _tmp_strategy):
+        # The first selection measures the implementations and records the fastest.
+        with relay.backend.EngineCache(cache_dir, number=1, repeat=1) as cache:
+            impl, _ = _select_impl()
+        with open(cache.cache_file(target)) as f:
+            records = json.load(f)
+        assert list(records.values()) == [impl.name]
+
+        # Later selections follow the record, even against the plevels.
+        records = {key: "conv2d_1" for key in records}
+        with open(cache.cache_file(target), "w") as f:
+            json.dump(records, f)
+        with relay.backend.EngineCache(cache_dir):
+            impl, _ = _select_impl()
+        assert impl.name == "conv2d_1"
+        impl, _ = _select_impl()
+        assert impl.name == "conv2d_2"
+
+
 def test_te_compiler():
     tec = relay.backend.te_compiler.get()
 
@@ -284,6 +323,33 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+def test_compile_parallel_lower_te():
+    x = relay.var("x", shape=(8, 16), dtype="float32")
+    w = relay.var("w", shape=(16, 16), dtype="float32")
+    y = relay.nn.relu(relay.nn.dense(x, w))
+    y = relay.exp(y) + relay.log(relay.abs(y) + relay.const(1.0))
+    y = relay.nn.relu(relay.nn.dense(y, w))
+    y = relay.nn.softmax(relay.exp(y))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], y))
+
+    def build(num_threads):
+        config = {"relay.backend.lower_te_num_threads": num_threads}
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            return relay.build(mod, target="llvm")
+
+    x_np = np.random.uniform(-1, 1, (8, 16)).astype("float32")
+    w_np = np.random.uniform(-1, 1, (16, 16)).astype("float32")
+    serial = build(1)
+    expected = relay.create_executor("graph", mod=mod, target="llvm").evaluate()(x_np, w_np)
+    for num_threads in [4, 0]:
+        lib = build(num_threads)
+        # The lowered functions have the same names as when lowering them one by one.
+        assert lib.get_graph_json() == serial.get_graph_json()
+        rt_mod = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        rt_mod.run(x=x_np, w=w_np)
+        tvm.testing.assert_allclose(rt_mod.get_output(0).numpy(), expected.numpy(), rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +359,4 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_compile_parallel_lower_te()
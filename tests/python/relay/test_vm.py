@@ -1168,6 +1168,28 @@ def test_multiple_set_one_input(target, dev):
     tvm.testing.assert_allclose(ref_res_core, output.numpy())
 
 
+def test_reuse_storage_of_released_outputs():
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    mod = IRModule.from_expr(relay.Function([x], relay.exp(x) + x))
+    vm_exec = vm.compile(mod, target="llvm")
+    exe = runtime.vm.VirtualMachine(vm_exec, tvm.cpu())
+
+    def run(num_rows):
+        data = np.random.uniform(size=(num_rows, 4)).astype("float32")
+        return data, exe.invoke("main", tvm.nd.array(data))
+
+    # The output held from the first call keeps its storage from being reused by the second.
+    data0, out0 = run(3)
+    data1, out1 = run(3)
+    tvm.testing.assert_allclose(out0.numpy(), np.exp(data0) + data0, rtol=1e-5)
+    tvm.testing.assert_allclose(out1.numpy(), np.exp(data1) + data1, rtol=1e-5)
+    del out0, out1
+    # The released storage is reused by a call of the same shape, but not of a new shape.
+    for num_rows in [3, 5, 3]:
+        data, out = run(num_rows)
+        tvm.testing.assert_allclose(out.numpy(), np.exp(data) + data, rtol=1e-5)
+
+
 @tvm.testing.parametrize_targets("llvm")
 def test_benchmark(target, dev):
     mod, params = mlp.get_workload(1)
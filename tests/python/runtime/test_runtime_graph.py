@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 import tempfile
+import pytest
 import tvm
 import tvm.testing
 from tvm import te, runtime
@@ -119,6 +120,107 @@ def test_graph_simple():
     check_sharing()
 
 
+@tvm.testing.requires_llvm
+def test_graph_run_parallel():
+    # Independent branches that the memory plan lays out on shared storage.
+    x = relay.var("x", shape=(16, 16))
+    branches = [relay.nn.relu(relay.add(x, relay.const(float(i)))) for i in range(4)]
+    y = branches[0]
+    for branch in branches[1:]:
+        y = relay.multiply(y, relay.exp(relay.negative(branch)))
+    func = relay.Function([x], y)
+    with tvm.transform.PassContext(opt_level=0):
+        lib = relay.build(func, target="llvm")
+
+    x_in = np.random.uniform(-2, 2, size=(16, 16)).astype("float32")
+    serial = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    serial.run(x=x_in)
+    expected = serial.get_output(0).numpy()
+
+    parallel = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    for num_workers in [1, 2, 4]:
+        parallel.run_parallel(num_workers, x=x_in)
+        tvm.testing.assert_allclose(parallel.get_output(0).numpy(), expected, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_graph_multi_profile():
+    w_in = np.random.uniform(size=(8, 8)).astype("float32")
+    graph_jsons, libs = [], []
+    for batch in [1, 2, 4]:
+        x = relay.var("x", shape=(batch, 8))
+        w = relay.var("w", shape=(8, 8))
+        func = relay.Function([x, w], relay.nn.relu(relay.nn.dense(x, w)))
+        lib = relay.build(func, target="llvm")
+        graph_jsons.append(lib.get_graph_json())
+        libs.append(lib.get_lib())
+
+    mod = graph_executor.create_multi_profile(graph_jsons, libs, tvm.cpu(0), params={"w": w_in})
+    assert mod.num_profiles == 3
+    assert mod.profile == -1
+    for batch, profile in [(2, 1), (4, 2), (1, 0), (2, 1)]:
+        x_in = np.random.uniform(size=(batch, 8)).astype("float32")
+        mod.run(x=x_in)
+        assert mod.profile == profile
+        expected = np.maximum(x_in @ w_in.T, 0)
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+
+    with pytest.raises(tvm.TVMError):
+        mod.set_input("x", np.zeros((3, 8), "float32"))
+
+
+@tvm.testing.requires_llvm
+def test_graph_async_staging():
+    x = relay.var("x", shape=(4, 8))
+    y = relay.var("y", shape=(4, 8))
+    func = relay.Function([x, y], relay.nn.relu(relay.subtract(x, y)))
+    lib = relay.build(func, target="llvm")
+    mod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    mod.init_async(2)
+
+    inputs, requests = [], []
+    for _ in range(5):
+        x_in = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        y_in = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        mod.set_input_async("x", x_in)
+        mod.set_input_async(1, y_in)
+        requests.append(mod.run_async())
+        inputs.append((x_in, y_in))
+        if len(requests) >= 2:
+            # Drain the oldest request in flight before its slot is taken again.
+            request = requests[-2]
+            out = tvm.nd.empty((4, 8), "float32")
+            mod.get_output_async(request, 0, out)
+            mod.wait_async(request)
+            x_in, y_in = inputs[request]
+            tvm.testing.assert_allclose(out.numpy(), np.maximum(x_in - y_in, 0), rtol=1e-5)
+
+    with pytest.raises(tvm.TVMError):
+        mod.get_output_async(requests[0], 0, tvm.nd.empty((4, 8), "float32"))
+
+
+@tvm.testing.requires_llvm
+def test_graph_sampling_profiler():
+    x = relay.var("x", shape=(16, 16))
+    func = relay.Function([x], relay.nn.relu(relay.exp(x)))
+    lib = relay.build(func, target="llvm")
+    mod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    mod.enable_sampling_profiler(4)
+    x_in = np.random.uniform(size=(16, 16)).astype("float32")
+    for _ in range(10):
+        mod.run(x=x_in)
+    tvm.testing.assert_allclose(mod.get_output(0).numpy(), np.maximum(np.exp(x_in), 0), rtol=1e-5)
+
+    report = mod.sampling_report()
+    parsed = json.loads(report.json())
+    assert parsed["configuration"]["Sampled Requests"]["count"] == 3
+    assert len(parsed["calls"]) > 0
+    for call in parsed["calls"]:
+        assert call["Count"]["count"] == 3
+        assert call["p50 (us)"]["microseconds"] <= call["p99 (us)"]["microseconds"]
+    assert "p99 (us)" in report.table()
+
+
 def test_load_unexpected_params():
     # Test whether graph_executor.load_params works if parameters
     # are provided that are not an expected input.
@@ -139,6 +241,38 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+@tvm.testing.requires_llvm
+def test_load_params_from_file_and_shared():
+    x = relay.var("x", shape=(4, 8))
+    w = relay.var("w", shape=(4, 8))
+    b = relay.var("b", shape=(8,))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w, b], relay.add(relay.multiply(x, w), b)))
+    params = {
+        "w": np.random.uniform(size=(4, 8)).astype("float32"),
+        "b": np.random.uniform(size=(8,)).astype("float32"),
+    }
+    lib = relay.build(mod, target="llvm")
+    x_in = np.random.uniform(size=(4, 8)).astype("float32")
+    expected = x_in * params["w"] + params["b"]
+
+    def run(load):
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        load(gmod)
+        gmod.run(x=x_in)
+        tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected, rtol=1e-5)
+        return gmod
+
+    num_shared = tvm.get_global_func("tvm.graph_executor.num_shared_params")
+    with tempfile.NamedTemporaryFile() as fp:
+        runtime.save_param_dict_to_file(params, fp.name)
+        run(lambda gmod: gmod.load_params_from_file(fp.name))
+        first = run(lambda gmod: gmod.load_params_from_file(fp.name, shared=True))
+        second = run(lambda gmod: gmod.load_params(runtime.save_param_dict(params), shared=True))
+        assert num_shared() == 1
+        del first, second
+        assert num_shared() == 0
+
+
 def test_save_load_file():
     p = np.random.randn(10)
     params = {"x": p}
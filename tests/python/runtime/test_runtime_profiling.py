@@ -138,6 +138,28 @@ def test_papi(target, dev):
     assert any([float(x) > 0 for x in csv[metric]])
 
 
+@tvm.testing.requires_cuda
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is None,
+    reason="CUPTI profiling not enabled",
+)
+def test_cupti():
+    dev = tvm.cuda()
+    mod, params = mlp.get_workload(1)
+    exe = relay.vm.compile(mod, "cuda", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, dev)
+
+    data = tvm.nd.array(np.random.rand(1, 1, 28, 28).astype("float32"), device=dev)
+    report = vm.profile(
+        data,
+        func_name="main",
+        collectors=[tvm.runtime.profiling.CUPTIMetricCollector({dev: ["dram_read_bytes"]})],
+    )
+    csv = read_csv(report)
+    assert "dram_read_bytes" in csv.keys()
+    assert any([float(x) > 0 for x in csv["dram_read_bytes"] if x])
+
+
 @tvm.testing.requires_llvm
 def test_json():
     mod, params = mlp.get_workload(1)
@@ -263,5 +285,14 @@ def test_profile_function(target, dev):
     assert report[metric].value > 0
 
 
+def test_set_nvtx_ranges_enabled():
+    try:
+        enabled = tvm.runtime.profiling.set_nvtx_ranges_enabled(True)
+        if tvm.support.libinfo().get("USE_NVTX", "OFF") in ["OFF", "0"]:
+            assert not enabled
+    finally:
+        assert not tvm.runtime.profiling.set_nvtx_ranges_enabled(False)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -181,6 +181,54 @@ def test_rpc_large_array():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_bulk_transfer():
+    # copies from 1MB go directly through the channel instead of the ring buffers
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    dev = remote.cpu(0)
+    for size in [(1 << 18) - 1, 1 << 18, 3 << 20]:
+        a_np = np.random.uniform(size=size).astype("float32")
+        a = tvm.nd.array(a_np, dev)
+        np.testing.assert_equal(a.numpy(), a_np)
+        b = tvm.nd.empty(a.shape, a.dtype, dev)
+        b.copyfrom(a_np + 1)
+        np.testing.assert_equal(b.numpy(), a_np + 1)
+
+
+@tvm.testing.requires_rpc
+def test_rpc_multiplex():
+    import threading
+
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    assert remote.enable_multiplex(num_workers=2)
+
+    # the wait only completes after the set, which is issued after it
+    fwait = remote.get_function("rpc.test.wait_event")
+    fset = remote.get_function("rpc.test.set_event")
+    result = []
+    waiter = threading.Thread(target=lambda: result.append(fwait(60.0)))
+    waiter.start()
+    fset()
+    waiter.join()
+    assert result == [True]
+
+    def check_copy():
+        a_np = np.random.uniform(size=(1 << 18) + 1).astype("float32")
+        a = tvm.nd.array(a_np, remote.cpu(0))
+        return np.array_equal(a.numpy(), a_np)
+
+    result = []
+    threads = [threading.Thread(target=lambda: result.append(check_copy())) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert result == [True] * 4
+    assert remote.get_function("rpc.test.addone")(10) == 11
+
+
 @tvm.testing.skip_if_32bit(reason="skipping test for i386.")
 @tvm.testing.requires_rpc
 def test_rpc_echo():
@@ -385,5 +385,23 @@ def test_buffer_access_with_let_binding():
     tvm.ir.assert_structural_equal(block.writes, ret[1])
 
 
+def test_access_of_strided_offsets():
+    @T.prim_func
+    def func(A: T.Buffer((130,), "float32"), B: T.Buffer((32,), "float32")):
+        for i in range(32):
+            with T.block("B"):
+                vi = T.axis.spatial(32, i)
+                B[vi] = A[vi * 4 + 1] + A[vi * 4] + A[vi * 4 + 5] + A[vi * 4 + 2]
+
+    block = func.body.block.body.body.block
+    vi = block.iter_vars[0].var
+    buffer_var_map = {buf.data: buf for buf in func.buffer_map.values()}
+    ret = tir.analysis.get_block_access_region(block, buffer_var_map)
+    # The union of the accesses keeps the affine form of the indices.
+    (read,) = ret[0]
+    tvm.ir.assert_structural_equal(read.region[0].min, vi * 4)
+    assert int(read.region[0].extent) == 6
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -281,6 +281,55 @@ def test_op_create_barriers():
     assert expr.op.name == "tir.create_barriers"
 
 
+def test_op_ptx_cp_async_bulk_tensor():
+    buffer_shared = tir.decl_buffer([16, 16], "float16", scope="shared")
+    tensor_map = tir.decl_buffer([128], "uint8")
+    expr = tir.ptx_cp_async_bulk_tensor(
+        "float16", buffer_shared.data, 0, tensor_map.data, 0, 0, 16
+    )
+    assert expr.op.name == "tir.ptx_cp_async_bulk_tensor"
+
+
+def test_op_ptx_wgmma_mma_async():
+    buffer_a = tir.decl_buffer([64, 16], "float16", scope="shared")
+    buffer_b = tir.decl_buffer([8, 16], "float16", scope="shared")
+    buffer_c = tir.decl_buffer([4], "float32", scope="local")
+    expr = tir.ptx_wgmma_mma_async(
+        "float32",
+        "m64n8k16",
+        "fp16",
+        "fp16",
+        "fp32",
+        buffer_a.data,
+        0,
+        buffer_b.data,
+        0,
+        buffer_c.data,
+        0,
+        False,
+        False,
+        0,
+        128,
+        256,
+    )
+    assert expr.op.name == "tir.ptx_wgmma_mma_async"
+
+
+def test_op_ptx_wgmma_fence():
+    expr = tir.ptx_wgmma_fence()
+    assert expr.op.name == "tir.ptx_wgmma_fence"
+
+
+def test_op_ptx_wgmma_commit_group():
+    expr = tir.ptx_wgmma_commit_group()
+    assert expr.op.name == "tir.ptx_wgmma_commit_group"
+
+
+def test_op_ptx_wgmma_wait_group():
+    expr = tir.ptx_wgmma_wait_group(0)
+    assert expr.op.name == "tir.ptx_wgmma_wait_group"
+
+
 def test_tir_op_vectorlow():
     buffer = tir.decl_buffer((4, 4), "int8", offset_factor=1)
     vec = buffer.vload([0, 0], dtype="int8x16")
@@ -149,7 +149,58 @@ def test_ptx_cp_async_bulk():
     tvm.testing.assert_allclose(B_nd.numpy(), A_np)
 
 
+@T.prim_func
+def ptx_cp_async_bulk_tensor(
+    A: T.Buffer((64, 64), "float16"),
+    A_map: T.Buffer((128,), "uint8"),
+    B: T.Buffer((32, 64), "float16"),
+) -> None:
+    T.func_attr({"global_symbol": "default_function", "tir.noalias": True})
+    bx = T.env_thread("blockIdx.x")
+    tx = T.env_thread("threadIdx.x")
+    T.launch_thread(bx, 1)
+    T.launch_thread(tx, 32)
+    with T.block():
+        A_shared = T.alloc_buffer([32, 64], "float16", scope="shared", align=128)
+
+        T.reads(A[32:64, 0:64], A_map[0:128])
+        T.writes(B[0:32, 0:64])
+
+        T.evaluate(T.create_barriers(1, dtype=""))
+        if tx == 0:
+            T.evaluate(T.ptx_init_barrier_thread_count(0, 1, dtype=""))
+        T.evaluate(T.tvm_storage_sync("shared", dtype="int32"))
+
+        if tx == 0:
+            # The tile of the rows 32 to 63, whose innermost coordinate comes first.
+            T.evaluate(
+                T.ptx_cp_async_bulk_tensor(A_shared.data, 0, A_map.data, 0, 0, 32, dtype="float16")
+            )
+            T.evaluate(T.ptx_arrive_barrier_expect_tx(0, 4096, dtype=""))
+        T.evaluate(T.ptx_wait_barrier(0, dtype=""))
+
+        for i in range(64):
+            B[tx, i] = A_shared[tx, i]
+
+
+@tvm.testing.requires_cuda_compute_version(9)
+def test_ptx_cp_async_bulk_tensor():
+    f = ptx_cp_async_bulk_tensor
+
+    mod = tvm.build(f, target="cuda")
+    A_np = np.random.rand(64, 64).astype("float16")
+    B_np = np.zeros((32, 64)).astype("float16")
+    dev = tvm.cuda(0)
+    A_nd = tvm.nd.array(A_np, device=dev)
+    B_nd = tvm.nd.array(B_np, device=dev)
+    encode_tensor_map = tvm.get_global_func("runtime.cuda.encode_tensor_map_tiled")
+    A_map = encode_tensor_map(A_nd, [32, 64], 0)
+    mod(A_nd, A_map, B_nd)
+    tvm.testing.assert_allclose(B_nd.numpy(), A_np[32:64])
+
+
 if __name__ == "__main__":
     test_ptx_cp_async()
     test_ptx_cp_async_barrier()
     test_ptx_cp_async_bulk()
+    test_ptx_cp_async_bulk_tensor()
@@ -0,0 +1,115 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+@T.prim_func
+def gemm_wgmma_m64n8k16_fp16fp16fp32(
+    A: T.Buffer((1024,), "float16"),
+    B: T.Buffer((128,), "float16"),
+    C: T.Buffer((64, 8), "float32"),
+):
+    T.func_attr({"global_symbol": "default_function", "tir.noalias": True})
+    bx = T.env_thread("blockIdx.x")
+    tx = T.env_thread("threadIdx.x")
+    T.launch_thread(bx, 1)
+    T.launch_thread(tx, 128)
+    with T.block():
+        # A and B are K-major without swizzle, made of 8x8 core matrices of 128 contiguous bytes.
+        A_shared = T.alloc_buffer([1024], "float16", scope="shared", align=128)
+        B_shared = T.alloc_buffer([128], "float16", scope="shared", align=128)
+        Accum = T.alloc_buffer([4], "float32", scope="local")
+
+        T.reads(A[0:1024], B[0:128])
+        T.writes(C[0:64, 0:8])
+
+        T.evaluate(T.create_barriers(1, dtype=""))
+        if tx == 0:
+            T.evaluate(T.ptx_init_barrier_thread_count(0, 1, dtype=""))
+        T.evaluate(T.tvm_storage_sync("shared", dtype="int32"))
+
+        if tx == 0:
+            T.evaluate(T.ptx_cp_async_bulk(A_shared.data, 0, A.data, 0, 2048, 0, dtype="float16"))
+            T.evaluate(T.ptx_cp_async_bulk(B_shared.data, 0, B.data, 0, 256, 0, dtype="float16"))
+            T.evaluate(T.ptx_arrive_barrier_expect_tx(0, 2304, dtype=""))
+        T.evaluate(T.ptx_wait_barrier(0, dtype=""))
+
+        for i in range(4):
+            Accum[i] = T.float32(0)
+        T.evaluate(T.ptx_wgmma_fence(dtype=""))
+        T.evaluate(
+            T.ptx_wgmma_mma_async(
+                "m64n8k16",
+                "fp16",
+                "fp16",
+                "fp32",
+                A_shared.data,
+                0,
+                B_shared.data,
+                0,
+                Accum.data,
+                0,
+                False,
+                False,
+                0,
+                128,
+                256,
+                dtype="float32",
+            )
+        )
+        T.evaluate(T.ptx_wgmma_commit_group(dtype=""))
+        T.evaluate(T.ptx_wgmma_wait_group(0, dtype=""))
+
+        for i in range(4):
+            C[tx // 32 * 16 + tx % 32 // 4 + i // 2 * 8, tx % 4 * 2 + i % 2] = Accum[i]
+
+
+def _to_core_matrices(x):
+    """Lay out a K-major matrix as the row-major grid of its 8x8 core matrices."""
+    rows, cols = x.shape
+    return x.reshape(rows // 8, 8, cols // 8, 8).transpose(0, 2, 1, 3).flatten()
+
+
+@tvm.testing.requires_cuda_compute_version(9)
+def test_gemm_wgmma_m64n8k16_fp16fp16fp32():
+    cuda_mod = tvm.build(gemm_wgmma_m64n8k16_fp16fp16fp32, target="cuda")
+    assert "wgmma.mma_async.sync.aligned.m64n8k16.f32.f16.f16" in (
+        cuda_mod.imported_modules[0].get_source()
+    )
+
+    A_np = np.random.uniform(-1, 1, [64, 16]).astype("float16")
+    B_np = np.random.uniform(-1, 1, [16, 8]).astype("float16")
+    C_np = np.zeros([64, 8]).astype("float32")
+
+    ctx = tvm.cuda()
+    A_tvm = tvm.nd.array(_to_core_matrices(A_np), ctx)
+    B_tvm = tvm.nd.array(_to_core_matrices(B_np.T), ctx)
+    C_tvm = tvm.nd.array(C_np, ctx)
+
+    cuda_mod(A_tvm, B_tvm, C_tvm)
+
+    golden = np.matmul(A_np.astype("float32"), B_np.astype("float32"))
+    tvm.testing.assert_allclose(golden, C_tvm.numpy(), atol=1e-3, rtol=1e-3)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -419,5 +419,40 @@ def test_ir_module_equal():
     assert '<root>.functions[I.GlobalVar("func")].body.extent.value' in err.value.args[0]
 
 
+def test_structural_hash_cache():
+    def make_func(num_stages):
+        tensor = te.placeholder((16, 16), name="A")
+        tensors = [tensor]
+        for i in range(num_stages):
+            tensor = te.compute(tensor.shape, lambda x, y: tensor[x, y] * 2 + i, name="T%d" % i)
+            tensors.append(tensor)
+        return te.create_prim_func([tensors[0], tensors[-1]])
+
+    func = make_func(32)
+    mod = tvm.IRModule({"main": func, "other": make_func(16)})
+    # The module shares the body of the functions, but not the functions.
+    renamed = tvm.IRModule({"main": func.with_attr("global_symbol", "main"), "other": mod["other"]})
+    expected = [
+        tvm.ir.structural_hash(node, map_free_vars)
+        for node in [mod, renamed, func.body]
+        for map_free_vars in [False, True]
+    ]
+    try:
+        tvm.ir.set_structural_hash_cache_capacity(1024)
+        for _ in range(2):
+            hashes = [
+                tvm.ir.structural_hash(node, map_free_vars)
+                for node in [mod, renamed, func.body]
+                for map_free_vars in [False, True]
+            ]
+            assert hashes == expected
+        stats = tvm.ir.structural_hash_cache_stats()
+        assert stats["misses"] > 0 and stats["hits"] > 0
+        assert 0 < stats["size"] <= stats["capacity"] == 1024
+    finally:
+        tvm.ir.set_structural_hash_cache_capacity(0)
+    assert tvm.ir.structural_hash_cache_stats()["size"] == 0
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -234,6 +234,19 @@ def rowsum_cross_thread_reduction(a: T.handle, b: T.handle) -> None:
                 B[vi] = B[vi] + A[vi, vk]
 
 
+@T.prim_func
+def rowsum_vectorized(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, (128, 128))
+    B = T.match_buffer(b, (128,))
+    for i0 in T.serial(0, 128):
+        for i1 in T.vectorized(0, 128):
+            with T.block("B"):
+                vi, vk = T.axis.remap("SR", [i0, i1])
+                with T.init():
+                    B[vi] = 0.0
+                B[vi] = B[vi] + A[vi, vk]
+
+
 @T.prim_func
 def opaque_block(a: T.handle) -> None:
     A = T.match_buffer(a, (16,))
@@ -535,6 +548,14 @@ def test_vectorize_predicate():
     verify_trace_roundtrip(s, mod=element_wise_split_predicate)
 
 
+def test_vectorize_reduction_block_iter():
+    s = tir.Schedule(rowsum, debug_mask="all")
+    _, k = s.get_loops(s.get_block("B"))
+    s.vectorize(k)
+    assert_structural_equal_ignore_global_symbol(s.mod["main"], rowsum_vectorized)
+    verify_trace_roundtrip(s, mod=rowsum)
+
+
 def test_vectorize_opaque_block():
     s = tir.Schedule(opaque_block, debug_mask="all")
     (i,) = s.get_loops(s.get_block("opaque"))
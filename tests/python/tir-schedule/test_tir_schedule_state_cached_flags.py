@@ -895,5 +895,25 @@ def test_splitted_square_sum_with_predicate():
     # pylint: enable=protected-access
 
 
+def test_affine_binding_memo_after_replace():
+    # The affine binding checks of the blocks untouched by a primitive are memoized, and the debug
+    # mask verifies the flags against the ones of a new schedule state after each primitive.
+    sch = tir.Schedule(elementwise, debug_mask="all")
+    for name in ["B", "C"]:
+        i, j = sch.get_loops(sch.get_block(name))
+        i_o, i_i = sch.split(i, factors=[None, 16])
+        j_o, j_i = sch.split(j, factors=[None, 48])
+        sch.reorder(i_o, j_o, i_i, j_i)
+        sch.fuse(i_o, j_o)
+    # pylint: disable=protected-access
+    for name in ["B", "C"]:
+        assert sch.state._get_cached_flags(_get_block(sch.state, name)) == CachedFlags(
+            affine_binding=True,
+            region_cover=True,
+            stage_pipeline=True,
+        )
+    # pylint: enable=protected-access
+
+
 if __name__ == "__main__":
     tvm.testing.main()
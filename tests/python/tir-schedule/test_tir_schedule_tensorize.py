@@ -32,9 +32,13 @@ from tvm.tir.tensor_intrin.arm_cpu import (
     DP4A_S8U8S32_INTRIN,
     ARM_DOT_4x4_i8_NEON_INTRIN,
     ARM_DOT_4x4_i8_SDOT_INTRIN,
+    ARM_MMLA_2x2x8_i8_SMMLA_INTRIN,
+    ARM_MMLA_2x2x8_u8_UMMLA_INTRIN,
+    ARM_MMLA_2x2x8_u8i8_USMMLA_INTRIN,
 )
 from tvm.tir.tensor_intrin.rocm import AMDGPU_SDOT4_INTRIN
 from tvm.tir.tensor_intrin.x86 import VNNI_DOT_16x4_INTRIN, AVX512_DOT_16x4_INTRIN
+from tvm.tir.tensor_intrin.x86 import AMX_INT8_16x16x64_INTRIN, AMX_BF16_16x16x32_INTRIN
 from tvm.tir.tensor_intrin.hexagon import VRMPY_u8u8i32_INTRIN, VDMPY_i16i16i32_INTRIN
 
 # fmt: off
@@ -584,7 +588,7 @@ def test_tensorize_intrinsic_with_annotation():
     verify_trace_roundtrip(sch=s, mod=func)
 
 
-def get_matmul_packed(m, n, k, lhs_type, rhs_dtype="int8"):
+def get_matmul_packed(m, n, k, lhs_type, rhs_dtype="int8", out_dtype="int32"):
     X = te.placeholder((m, k), name="X", dtype=lhs_type)
     W = te.placeholder((n, k), name="W", dtype=rhs_dtype)
 
@@ -592,7 +596,7 @@ def get_matmul_packed(m, n, k, lhs_type, rhs_dtype="int8"):
     matmul = te.compute(
         (m, n),
         lambda i, j: te.sum(
-            X[i, ak].astype("int32") * W[j, ak].astype("int32"),
+            X[i, ak].astype(out_dtype) * W[j, ak].astype(out_dtype),
             axis=ak,
         ),
         name="compute",
@@ -629,6 +633,35 @@ def test_tensorize_avx512():
     tensorize_16x4_test(AVX512_DOT_16x4_INTRIN)
 
 
+def tensorize_amx_test(intrin, lhs_dtype, rhs_dtype, out_dtype, lanes):
+    m, n, k = 128, 128, 128
+
+    func = get_matmul_packed(m, n, k, lhs_dtype, rhs_dtype, out_dtype)
+
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    sch.transform_layout(block, "W", lambda i, j: [i//16, j//lanes, i%16, j%lanes])
+    i, j, k = sch.get_loops(block)
+
+    io, ii = sch.split(i, factors=[None, 16])
+    jo, ji = sch.split(j, factors=[None, 16])
+    ko, ki = sch.split(k, factors=[None, 16 * lanes])
+    sch.reorder(io, jo, ko, ii, ji, ki)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, intrin)
+
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
+def test_tensorize_amx_int8():
+    tensorize_amx_test(AMX_INT8_16x16x64_INTRIN, "uint8", "int8", "int32", 4)
+
+
+def test_tensorize_amx_bf16():
+    tensorize_amx_test(AMX_BF16_16x16x32_INTRIN, "bfloat16", "bfloat16", "float32", 2)
+
+
 def test_tensorize_arm_dot():
     m, n, k = 128, 128, 128
 
@@ -650,6 +683,30 @@ def test_tensorize_arm_dot():
         verify_trace_roundtrip(sch=sch, mod=func)
 
 
+def test_tensorize_arm_i8mm():
+    m, n, k = 128, 128, 128
+
+    for intrin, lhs_dtype, rhs_dtype, out_dtype in [
+        (ARM_MMLA_2x2x8_i8_SMMLA_INTRIN, "int8", "int8", "int32"),
+        (ARM_MMLA_2x2x8_u8_UMMLA_INTRIN, "uint8", "uint8", "uint32"),
+        (ARM_MMLA_2x2x8_u8i8_USMMLA_INTRIN, "uint8", "int8", "int32"),
+    ]:
+        func = get_matmul_packed(m, n, k, lhs_dtype, rhs_dtype, out_dtype)
+        sch = tir.Schedule(func, debug_mask="all")
+        block = sch.get_block("compute")
+        i, j, r = sch.get_loops(block)
+
+        io, ii = sch.split(i, factors=[None, 2])
+        jo, ji = sch.split(j, factors=[None, 2])
+        ko, ki = sch.split(r, factors=[None, 8])
+        sch.reorder(io, jo, ko, ii, ji, ki)
+
+        sch.decompose_reduction(block, ko)
+        sch.tensorize(ii, intrin)
+
+        verify_trace_roundtrip(sch=sch, mod=func)
+
+
 def test_tensorize_vrmpy():
     m, n, k = 128, 128, 128
 
@@ -258,6 +258,35 @@ def test_tir_schedule_copy_2():
     verify_trace_roundtrip(sch_copy, mod=matmul)
 
 
+def test_tir_schedule_copy_modify_original_first():
+    # The forks share the state until either side is modified
+    sch = tir.Schedule(mod=matmul, debug_mask="all")
+    i, j, _ = sch.get_loops(sch.get_block("update"))
+    sch_copy_1 = sch.copy()
+    sch_copy_2 = sch.copy()
+    sch.split(i, factors=[None, 64])
+    assert sch_copy_1.get(i).extent == 128
+    assert sch_copy_2.get(i).extent == 128
+    sch_copy_1.split(j, factors=[None, 32])
+    sch_copy_2.reorder(j, i)
+    assert sch_copy_2.get(j).extent == 128
+    assert sch_copy_2.get(i).extent == 128
+    verify_trace_roundtrip(sch, mod=matmul)
+    verify_trace_roundtrip(sch_copy_1, mod=matmul)
+    verify_trace_roundtrip(sch_copy_2, mod=matmul)
+
+
+def test_tir_schedule_copy_drop_original():
+    sch = tir.Schedule(mod=matmul, debug_mask="all")
+    i, _, _ = sch.get_loops(sch.get_block("update"))
+    sch_copy = sch.copy().copy()
+    del sch
+    i_0, i_1 = sch_copy.split(i, factors=[None, 64])
+    assert sch_copy.get(i_0).extent == 2
+    assert sch_copy.get(i_1).extent == 64
+    verify_trace_roundtrip(sch_copy, mod=matmul)
+
+
 def test_tir_schedule_remove_rv():
     # Tests:
     # - Schedule.remove_rv
@@ -0,0 +1,122 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import IRModule
+from tvm.script import tir as T
+
+
+def _transform(func, pad_by_default=True):
+    with tvm.transform.PassContext(config={"tir.pad_shared_memory": pad_by_default}):
+        mod = tvm.tir.transform.InjectSharedMemoryPadding()(IRModule({"main": func}))
+    return mod["main"]
+
+
+def _check(func, expected, pad_by_default=True):
+    after = _transform(func, pad_by_default).without_attr("global_symbol")
+    tvm.ir.assert_structural_equal(after, expected.without_attr("global_symbol"))
+
+
+# The transpose reads the columns of the shared memory, which are in the same bank.
+@T.prim_func
+def transpose(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+    A_shared = T.alloc_buffer((32, 32), scope="shared")
+    for ty in T.thread_binding(8, thread="threadIdx.y"):
+        for tx in T.thread_binding(32, thread="threadIdx.x"):
+            for i in range(4):
+                with T.block("A_shared"):
+                    A_shared[ty * 4 + i, tx] = A[ty * 4 + i, tx]
+            for i in range(4):
+                with T.block("B"):
+                    B[ty * 4 + i, tx] = A_shared[tx, ty * 4 + i]
+
+
+def test_pad_transpose():
+    @T.prim_func
+    def expected(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        A_shared = T.alloc_buffer((32, 32), strides=(33, 1), scope="shared")
+        for ty in T.thread_binding(8, thread="threadIdx.y"):
+            for tx in T.thread_binding(32, thread="threadIdx.x"):
+                for i in range(4):
+                    with T.block("A_shared"):
+                        A_shared[ty * 4 + i, tx] = A[ty * 4 + i, tx]
+                for i in range(4):
+                    with T.block("B"):
+                        B[ty * 4 + i, tx] = A_shared[tx, ty * 4 + i]
+
+    _check(transpose, expected)
+    _check(transpose, transpose, pad_by_default=False)
+
+
+def test_no_conflict():
+    @T.prim_func
+    def copy(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        A_shared = T.alloc_buffer((32, 32), scope="shared")
+        for ty in T.thread_binding(8, thread="threadIdx.y"):
+            for tx in T.thread_binding(32, thread="threadIdx.x"):
+                for i in range(4):
+                    with T.block("A_shared"):
+                        A_shared[ty * 4 + i, tx] = A[ty * 4 + i, tx]
+                for i in range(4):
+                    with T.block("B"):
+                        B[ty * 4 + i, tx] = A_shared[ty * 4 + i, tx]
+
+    _check(copy, copy)
+
+
+def test_annotation():
+    @T.prim_func
+    def before(A: T.Buffer((32, 32), "float32"), B: T.Buffer((32, 32), "float32")):
+        A_shared = T.alloc_buffer((32, 32), scope="shared")
+        for ty in T.thread_binding(8, thread="threadIdx.y"):
+            for tx in T.thread_binding(32, thread="threadIdx.x"):
+                for i in range(4):
+                    with T.block("A_shared"):
+                        T.block_attr({"pad_shared_memory": 0})
+                        A_shared[ty * 4 + i, tx] = A[ty * 4 + i, tx]
+                for i in range(4):
+                    with T.block("B"):
+                        B[ty * 4 + i, tx] = A_shared[tx, ty * 4 + i]
+
+    # The annotation of the block writing the buffer overrides the config.
+    _check(before, transpose)
+
+
+def test_vectorized_access_alignment():
+    @T.prim_func
+    def before(A: T.Buffer((64, 64), "float16"), B: T.Buffer((64, 64), "float16")):
+        A_shared = T.alloc_buffer((64, 64), "float16", scope="shared")
+        for tx in T.thread_binding(32, thread="threadIdx.x"):
+            for i in range(16):
+                for v in T.vectorized(8):
+                    with T.block("A_shared"):
+                        A_shared[i * 4 + tx // 8, tx % 8 * 8 + v] = A[
+                            i * 4 + tx // 8, tx % 8 * 8 + v
+                        ]
+            for i in range(2):
+                for v in T.vectorized(8):
+                    with T.block("B"):
+                        B[i * 32 + tx, v] = A_shared[i * 32 + tx, v]
+
+    after = _transform(before)
+    (buffer,) = after.body.block.alloc_buffers
+    # The rows of the vector loads are padded by 16 bytes, which keeps the loads aligned.
+    assert [int(stride) for stride in buffer.strides] == [72, 1]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
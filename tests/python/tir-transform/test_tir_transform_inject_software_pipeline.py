@@ -1169,6 +1169,41 @@ def test_nest_pipeline_double_buffer():
     _check(nested_pipeline_double_buffer, transformed_nested_pipeline_double_buffer)
 
 
+def test_cpu_prefetch():
+    @T.prim_func
+    def before(
+        A: T.Buffer((16, 256), "float32"),
+        B: T.Buffer((256, 32), "float32"),
+        C: T.Buffer((16, 32), "float32"),
+    ):
+        for i in range(16):
+            for k in T.serial(256, annotations={"software_prefetch_distance": 4}):
+                with T.block():
+                    T.reads(C[i, 0:32], A[i, k], B[k, 0:32])
+                    T.writes(C[i, 0:32])
+                    for j in range(32):
+                        C[i, j] = C[i, j] + A[i, k] * B[k, j]
+
+    @T.prim_func
+    def expected(
+        A: T.Buffer((16, 256), "float32"),
+        B: T.Buffer((256, 32), "float32"),
+        C: T.Buffer((16, 32), "float32"),
+    ):
+        for i, k in T.grid(16, 256):
+            if k < 252:
+                T.call_intrin("int32", "tir.prefetch", T.address_of(A[i, k + 4]), 0, 3, 1)
+                for j in range(2):
+                    T.call_intrin("int32", "tir.prefetch", T.address_of(B[k + 4, j * 16]), 0, 3, 1)
+            with T.block():
+                T.reads(C[i, 0:32], A[i, k], B[k, 0:32])
+                T.writes(C[i, 0:32])
+                for j in range(32):
+                    C[i, j] = C[i, j] + A[i, k] * B[k, j]
+
+    _check(before, expected)
+
+
 def test_error_reorder():
     _check_error(simple_compute_incorrect_reorder)
 
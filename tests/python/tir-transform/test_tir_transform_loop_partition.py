@@ -1062,5 +1062,56 @@ def test_single_point_partition(origin, expected):
     tvm.ir.assert_structural_equal(mod["main"], expected)
 
 
+def _num_loops(mod):
+    return sum(collect_visit(mod["main"].body, lambda x: isinstance(x, tvm.tir.For)))
+
+
+def _has_if(mod):
+    return any(collect_visit(mod["main"].body, lambda x: isinstance(x, tvm.tir.IfThenElse)))
+
+
+def test_require_simpler_body():
+    @T.prim_func
+    def outer_condition(A: T.Buffer(512, "float32"), B: T.Buffer(512, "float32")):
+        for i in range(32):
+            if T.likely(i < 24):
+                for j in range(16):
+                    B[i * 16 + j] = A[i * 16 + j]
+
+    @T.prim_func
+    def inner_condition(A: T.Buffer(512, "float32"), B: T.Buffer(512, "float32")):
+        for i in range(32):
+            for j in range(16):
+                if T.likely(i * 16 + j < 390):
+                    B[i * 16 + j] = A[i * 16 + j]
+
+    config = {"tir.LoopPartition": {"partition_const_loop": True}}
+    assert not _has_if(partition_from_scheduled_tir(outer_condition, config))
+    # The innermost loop has no predicate either way, so the loop is not partitioned.
+    config = {"tir.LoopPartition": {"partition_const_loop": True, "require_simpler_body": True}}
+    assert _has_if(partition_from_scheduled_tir(outer_condition, config))
+    # The steady state of the innermost loop has no predicate once partitioned.
+    mod = partition_from_scheduled_tir(inner_condition, config)
+    assert _num_loops(mod) > 2
+
+
+def test_max_code_growth():
+    @T.prim_func
+    def before(A: T.Buffer(512, "float32"), B: T.Buffer(512, "float32")):
+        for i in range(32):
+            for j in range(16):
+                if T.likely(i * 16 + j < 390):
+                    B[i * 16 + j] = A[i * 16 + j]
+
+    config = {"partition_const_loop": True}
+    num_loops = _num_loops(partition_from_scheduled_tir(before, {"tir.LoopPartition": config}))
+    assert num_loops > 2
+    # The duplicated statements are capped by the budget.
+    config = {"partition_const_loop": True, "max_code_growth": 0.01}
+    mod = partition_from_scheduled_tir(before, {"tir.LoopPartition": config})
+    assert _num_loops(mod) == 2
+    assert _has_if(mod)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
 import pytest
 
 import tvm
@@ -394,5 +395,53 @@ def test_zero_arg_function():
     tvm.ir.assert_structural_equal(Expected, After)
 
 
+def test_unchecked_entry():
+    """With tir.emit_unchecked_api, each function gets an entry without the argument checks"""
+
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def func(A: T.Buffer([16], "int32"), B: T.Buffer([16], "int32")):
+            T.func_attr({"global_symbol": "func", "target": T.target("llvm", host="llvm")})
+            for i in range(16):
+                B[i] = A[i] + 1
+
+    with tvm.transform.PassContext(config={"tir.emit_unchecked_api": True}):
+        After = tvm.tir.transform.MakePackedAPI()(Before)
+
+    def num_asserts(func):
+        nodes = []
+        tir.stmt_functor.post_order_visit(func.body, nodes.append)
+        return len([node for node in nodes if isinstance(node, tir.AssertStmt)])
+
+    unchecked = After["func__unchecked"]
+    assert unchecked.attrs["global_symbol"] == "func__unchecked"
+    assert int(unchecked.attrs["calling_conv"]) == int(tvm.ir.CallingConv.C_PACKED_FUNC)
+    assert num_asserts(After["func"]) > 0
+    assert num_asserts(unchecked) == 0
+
+
+def test_call_unchecked_entry():
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def func(A: T.Buffer([16], "int32"), B: T.Buffer([16], "int32")):
+            T.func_attr({"global_symbol": "func"})
+            for i in range(16):
+                B[i] = A[i] + 1
+
+    with tvm.transform.PassContext(config={"tir.emit_unchecked_api": True}):
+        built = tvm.build(Module, target="llvm")
+
+    A = tvm.nd.array(np.arange(16, dtype="int32"))
+    B = tvm.nd.empty([16], "int32")
+    built["func__unchecked"](A, B)
+    tvm.testing.assert_allclose(B.numpy(), A.numpy() + 1)
+
+    # The checked entry still validates its arguments.
+    with pytest.raises(tvm.TVMError):
+        built["func"](A)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
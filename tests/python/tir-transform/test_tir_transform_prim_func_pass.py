@@ -63,6 +63,32 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def test_parallel_prim_func_pass():
+    @tvm.tir.transform.prim_func_pass(opt_level=0)
+    def remove_odd(func, mod, ctx):
+        assert tvm.transform.PassContext.current().config["ir.function_pass_num_threads"] == 4
+        return None if func.attrs["global_symbol"].endswith(("1", "3", "5", "7")) else func
+
+    funcs = {}
+    for i in range(8):
+        x = te.var("x")
+        body = tvm.tir.Evaluate(x * 2 + x + i)
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x], body).with_attr("global_symbol", "func%d" % i)
+    mod = tvm.IRModule(funcs)
+    seq = tvm.transform.Sequential([tvm.tir.transform.Simplify(), remove_odd])
+    expected = seq(mod)
+    with tvm.transform.PassContext(config={"ir.function_pass_num_threads": 4}):
+        result = seq(mod)
+    names = sorted(gv.name_hint for gv in result.get_global_vars())
+    assert names == ["func0", "func2", "func4", "func6"]
+    tvm.ir.assert_structural_equal(result, expected)
+
+    config = {"ir.function_pass_num_threads": 4, "ir.function_pass_sequential": ["remove_odd"]}
+    with tvm.transform.PassContext(config=config):
+        tvm.ir.assert_structural_equal(seq(mod), expected)
+
+
 if __name__ == "__main__":
     test_cow_pass()
     test_prim_func_pass()
+    test_parallel_prim_func_pass()
@@ -348,5 +348,60 @@ def test6():
     )
 
 
+# test7: The instrumented loops of a CPU build count their cycles in the runtime
+@tvm.testing.requires_llvm
+def test7():
+    with tvm.transform.PassContext(config=default_lwp_test_config):
+        f = tvm.build(input1.with_attr("global_symbol", "main"), target="llvm")
+    a = tvm.nd.array(numpy.ones((8, 8, 128), dtype="int32"))
+    b = tvm.nd.empty((8, 8, 128), "int32")
+    c = tvm.nd.empty((8, 8, 128), "int32")
+    tvm.runtime.profiling.dump_loop_profile(reset=True)
+    f(a, b, c)
+    profile = tvm.runtime.profiling.dump_loop_profile(f)["cpu"]
+    assert sorted(profile.keys()) == [3, 5]
+    for runs, cycles in profile.values():
+        assert runs == 64
+        assert cycles > 0
+    numpy.testing.assert_equal(c.numpy(), 4)
+
+
+@T.prim_func
+def input_cuda(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (8, 8, 128), dtype="int32")
+    B = T.match_buffer(b, (8, 8, 128), dtype="int32")
+    C = T.match_buffer(c, (8, 8, 128), dtype="int32")
+    for i in T.thread_binding(8, thread="blockIdx.x"):
+        for j in T.serial(8):
+            for k, l in T.grid(8, 16):
+                with T.block("B"):
+                    vi, vj, vk, vl = T.axis.remap("SSSS", [i, j, k, l])
+                    B[vi, vj, vk * 16 + vl] = A[vi, vj, vk * 16 + vl] * 2
+            for k, l in T.grid(8, 16):
+                with T.block("C"):
+                    vi, vj, vk, vl = T.axis.remap("SSSS", [i, j, k, l])
+                    C[vi, vj, vk * 16 + vl] = B[vi, vj, vk * 16 + vl] * 2
+
+
+# test8: The instrumented loops of CUDA kernels count their cycles once per block
+@tvm.testing.requires_cuda
+def test8():
+    with tvm.transform.PassContext(config=default_lwp_test_config):
+        f = tvm.build(input_cuda.with_attr("global_symbol", "main"), target="cuda")
+    dev = tvm.cuda()
+    a = tvm.nd.array(numpy.ones((8, 8, 128), dtype="int32"), dev)
+    b = tvm.nd.empty((8, 8, 128), "int32", dev)
+    c = tvm.nd.empty((8, 8, 128), "int32", dev)
+    f(a, b, c)
+    profile = tvm.runtime.profiling.dump_loop_profile(f)["cuda"]
+    # Each of the 8 blocks runs each of the two sibling loop nests 8 times.
+    assert len(profile) == 2
+    for runs, cycles in profile.values():
+        assert runs == 64
+        assert cycles > 0
+    assert "cuda" not in tvm.runtime.profiling.dump_loop_profile(f)
+    numpy.testing.assert_equal(c.numpy(), 4)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
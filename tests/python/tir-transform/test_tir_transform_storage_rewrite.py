@@ -930,6 +930,44 @@ class TestNoOrphanedDeclBuffer(BaseCompare):
             D[i] = C[i]
 
 
+def test_merge_static_workspace():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer(64, "float32"), D: T.Buffer(64, "float32")):
+        B = T.allocate([64], "float32", "global")
+        C = T.allocate([64], "int32", "global")
+        E = T.allocate([96], "float32", "global")
+        B_1 = T.Buffer(64, data=B)
+        C_1 = T.Buffer(64, "int32", data=C)
+        E_1 = T.Buffer(96, data=E)
+        for i in range(64):
+            B_1[i] = A[i]
+            C_1[i] = T.Cast("int32", A[i])
+        for i in range(64):
+            E_1[i] = B_1[i] + T.Cast("float32", C_1[i])
+        T.evaluate(T.call_extern("int32", "dummy_func", E))
+        for i in range(64):
+            D[i] = E_1[i]
+
+    def _allocates(merge_static_workspace):
+        with tvm.transform.PassContext(
+            config={"tir.merge_static_workspace": merge_static_workspace}
+        ):
+            mod = tvm.tir.transform.StorageRewrite()(tvm.IRModule.from_expr(func))
+        allocates = []
+        tvm.tir.stmt_functor.post_order_visit(
+            mod["main"].body,
+            lambda n: allocates.append(n) if isinstance(n, tvm.tir.Allocate) else None,
+        )
+        return allocates
+
+    assert len(_allocates(False)) == 3
+    # B and C are live at the same time, so C is placed after B, aligned to 64 bytes.  The
+    # address of E is passed to the extern call, so E keeps its own allocation.
+    allocates = _allocates(True)
+    assert len(allocates) == 2
+    assert sorted(int(alloc.extents[0]) for alloc in allocates) == [96, 128]
+
+
 def test_vulkan_smem_reuse():
     target = tvm.target.Target(
         {
@@ -848,5 +848,146 @@ def test_vectorize_llvm_pure_intrin_fail(extent, vec_str, target):
     assert "Intrinsic does not support vectors" in e_info.value.args[0]
 
 
+@tvm.testing.requires_llvm
+def test_vectorize_symbolic_extent_with_avx512_lane_mask():
+    @T.prim_func
+    def before(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i in T.vectorized(n):
+            B[i] = A[i] + 1.0
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i_outer in range((n + 16 - 1) // 16):
+            load_a = T.meta_var(
+                A.vload(
+                    [T.Ramp(i_outer * 16, 1, 16)],
+                    predicate=T.get_active_lane_mask("uint1x16", i_outer * 16, n),
+                )
+            )
+            B.vstore(
+                [T.Ramp(i_outer * 16, 1, 16)],
+                load_a + T.Broadcast(T.float32(1), 16),
+                predicate=T.get_active_lane_mask("uint1x16", i_outer * 16, n),
+            )
+
+    with tvm.target.Target("llvm -mtriple=x86_64-linux-gnu -mcpu=skylake-avx512"):
+        after = tvm.tir.transform.VectorizeLoop()(tvm.IRModule.from_expr(before))["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_symbolic_extent_with_sve_lane_mask():
+    @T.prim_func
+    def before(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i in T.vectorized(n):
+            B[i] = A[i + 1] * A[0]
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i_outer in range((n + T.vscale() * 4 - 1) // (T.vscale() * 4)):
+            load_a = T.meta_var(
+                A.vload(
+                    [T.Ramp(i_outer * (T.vscale() * 4) + 1, 1, T.vscale() * 4)],
+                    predicate=T.get_active_lane_mask(
+                        "uint1xvscalex4", i_outer * (T.vscale() * 4), n
+                    ),
+                )
+            )
+            B.vstore(
+                [T.Ramp(i_outer * (T.vscale() * 4), 1, T.vscale() * 4)],
+                load_a * T.Broadcast(A[0], T.vscale() * 4),
+                predicate=T.get_active_lane_mask("uint1xvscalex4", i_outer * (T.vscale() * 4), n),
+            )
+
+    with tvm.target.Target(sve_target):
+        after = tvm.tir.transform.VectorizeLoop()(tvm.IRModule.from_expr(before))["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_symbolic_extent_with_unmaskable_access():
+    # A strided access can not be masked, so the tail is guarded and scalarized instead.
+    @T.prim_func
+    def before(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (n * 2,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i in T.vectorized(n):
+            B[i] = A[i * 2]
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (n * 2,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i_outer, i_inner_s in T.grid((n + T.vscale() * 4 - 1) // (T.vscale() * 4), T.vscale() * 4):
+            if i_outer * (T.vscale() * 4) + i_inner_s < n:
+                B[i_outer * (T.vscale() * 4) + i_inner_s] = A[
+                    (i_outer * (T.vscale() * 4) + i_inner_s) * 2
+                ]
+
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        with tvm.target.Target(sve_target):
+            after = tvm.tir.transform.VectorizeLoop()(tvm.IRModule.from_expr(before))["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_reduction():
+    @T.prim_func
+    def before(A: T.Buffer((16,), "float32"), B: T.Buffer((1,), "float32")):
+        for k in T.vectorized(16):
+            B[0] = B[0] + A[k]
+
+    @T.prim_func
+    def expected(A: T.Buffer((16,), "float32"), B: T.Buffer((1,), "float32")):
+        B[0] = B[0] + T.vector_reduce_add("float32", A[T.Ramp(0, 1, 16)])
+
+    with tvm.target.Target(simple_target):
+        after = tvm.tir.transform.VectorizeLoop()(tvm.IRModule.from_expr(before))["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_reduction_with_accumulator():
+    @T.prim_func
+    def before(A: T.Buffer((128,), "float32"), B: T.Buffer((1,), "float32")):
+        for k_0 in range(8):
+            for k_1 in T.vectorized(16):
+                B[0] = T.max(B[0], A[k_0 * 16 + k_1])
+
+    @T.prim_func
+    def expected(A: T.Buffer((128,), "float32"), B: T.Buffer((1,), "float32")):
+        B_acc = T.decl_buffer((16,), "float32", scope="local")
+        B_acc[T.Ramp(0, 1, 16)] = T.Broadcast(T.min_value("float32"), 16)
+        for k_0 in range(8):
+            B_acc[T.Ramp(0, 1, 16)] = T.max(B_acc[T.Ramp(0, 1, 16)], A[T.Ramp(k_0 * 16, 1, 16)])
+        B[0] = T.max(B[0], T.vector_reduce_max("float32", B_acc[T.Ramp(0, 1, 16)]))
+
+    with tvm.target.Target(simple_target):
+        after = tvm.tir.transform.VectorizeLoop()(tvm.IRModule.from_expr(before))["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_reduction_without_vector_reduce():
+    # Without vector reductions on the target, every lane would read the element before any lane
+    # writes it, so the reduction is scalarized.
+    @T.prim_func
+    def before(A: T.Buffer((16,), "float32"), B: T.Buffer((1,), "float32")):
+        for k in T.vectorized(16):
+            B[0] = B[0] + A[k]
+
+    @T.prim_func
+    def expected(A: T.Buffer((16,), "float32"), B: T.Buffer((1,), "float32")):
+        for k_s in range(16):
+            B[0] = B[0] + A[k_s]
+
+    with tvm.target.Target("cuda"):
+        after = tvm.tir.transform.VectorizeLoop()(tvm.IRModule.from_expr(before))["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -566,5 +566,129 @@ def test_sum():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def _get_scheduled_loops(func):
+    """The extents of the thread-bound and the vectorized loops of a function"""
+    loops = {}
+
+    def visit(node):
+        if isinstance(node, tvm.tir.For):
+            if node.thread_binding is not None:
+                loops[node.thread_binding.thread_tag] = node.extent
+            elif node.kind == tvm.tir.ForKind.VECTORIZED:
+                loops["vectorized"] = node.extent
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, visit)
+    return {
+        key: int(extent) if isinstance(extent, tvm.tir.IntImm) else extent
+        for key, extent in loops.items()
+    }
+
+
+def test_gemv():
+    # pylint: disable=no-self-argument,missing-class-docstring,line-too-long
+    # fmt: off
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def gemv(A: T.Buffer((4096, 4096), "float16"), x: T.Buffer((4096,), "float16"), y: T.Buffer((4096,), "float16")):
+            T.func_attr({"tir.noalias": True})
+            for i, k in T.grid(4096, 4096):
+                with T.block("y"):
+                    v_i, v_k = T.axis.remap("SR", [i, k])
+                    with T.init():
+                        y[v_i] = T.float16(0)
+                    y[v_i] = y[v_i] + A[v_i, v_k] * x[v_k]
+    # fmt: on
+    # pylint: enable=no-self-argument,missing-class-docstring,line-too-long
+    target = tvm.target.Target("nvidia/geforce-rtx-3070")
+    with target, tvm.transform.PassContext(opt_level=3):
+        After = DefaultGPUSchedule()(Before)
+    # one threadblock per row, whose threads reduce the row together
+    assert _get_scheduled_loops(After["gemv"]) == {"blockIdx.x": 4096, "threadIdx.x": 256}
+
+
+def test_row_reduction_symbolic():
+    # pylint: disable=no-self-argument,missing-class-docstring,line-too-long
+    # fmt: off
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def row_max(var_A: T.handle, var_B: T.handle):
+            T.func_attr({"tir.noalias": True})
+            n, m = T.int64(), T.int64()
+            A = T.match_buffer(var_A, (n, m))
+            B = T.match_buffer(var_B, (n,))
+            for i, k in T.grid(n, m):
+                with T.block("B"):
+                    v_i, v_k = T.axis.remap("SR", [i, k])
+                    with T.init():
+                        B[v_i] = T.min_value("float32")
+                    B[v_i] = T.max(B[v_i], A[v_i, v_k])
+    # fmt: on
+    # pylint: enable=no-self-argument,missing-class-docstring,line-too-long
+    target = tvm.target.Target("nvidia/geforce-rtx-3070")
+    with target, tvm.transform.PassContext(opt_level=3):
+        After = DefaultGPUSchedule()(Before)
+    loops = _get_scheduled_loops(After["row_max"])
+    assert set(loops) == {"blockIdx.x", "threadIdx.x"}
+    assert loops["threadIdx.x"] == 256
+
+
+def test_transpose():
+    # pylint: disable=no-self-argument,missing-class-docstring,line-too-long
+    # fmt: off
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def transpose(A: T.Buffer((1024, 512), "float32"), B: T.Buffer((512, 1024), "float32")):
+            T.func_attr({"tir.noalias": True})
+            for i, j in T.grid(512, 1024):
+                with T.block("B"):
+                    v_i, v_j = T.axis.remap("SS", [i, j])
+                    B[v_i, v_j] = A[v_j, v_i]
+    # fmt: on
+    # pylint: enable=no-self-argument,missing-class-docstring,line-too-long
+    target = tvm.target.Target("nvidia/geforce-rtx-3070")
+    with target, tvm.transform.PassContext(opt_level=3):
+        After = DefaultGPUSchedule()(Before)
+    assert _get_scheduled_loops(After["transpose"]) == {
+        "blockIdx.x": 4096,
+        "threadIdx.y": 8,
+        "threadIdx.x": 16,
+    }
+    shared_buffers = []
+
+    def visit(node):
+        if isinstance(node, tvm.tir.Block):
+            shared_buffers.extend(buf for buf in node.alloc_buffers if buf.scope() == "shared")
+
+    tvm.tir.stmt_functor.post_order_visit(After["transpose"].body, visit)
+    assert len(shared_buffers) == 1
+
+
+def test_vectorized_broadcast_add():
+    # pylint: disable=no-self-argument,missing-class-docstring,line-too-long
+    # fmt: off
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def add(A: T.Buffer((1024, 1024), "float32"), B: T.Buffer((1024,), "float32"), C: T.Buffer((1024, 1024), "float32")):
+            T.func_attr({"tir.noalias": True})
+            for i, j in T.grid(1024, 1024):
+                with T.block("C"):
+                    v_i, v_j = T.axis.remap("SS", [i, j])
+                    C[v_i, v_j] = A[v_i, v_j] + B[v_j]
+    # fmt: on
+    # pylint: enable=no-self-argument,missing-class-docstring,line-too-long
+    target = tvm.target.Target("nvidia/geforce-rtx-3070")
+    with target, tvm.transform.PassContext(opt_level=3):
+        After = DefaultGPUSchedule()(Before)
+    assert _get_scheduled_loops(After["add"]) == {
+        "blockIdx.x": 256,
+        "threadIdx.x": 1024,
+        "vectorized": 4,
+    }
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -76,6 +76,13 @@ def verify_einsum(subscripts, shapes, shape_dict={}):
         c2 = with_tvm(
             lambda A, B, C: topi.einsum(subscripts, A, B, C), symbolic_shapes, ops, out_shape
         )
+    elif len(ops) == 4:
+        c2 = with_tvm(
+            lambda A, B, C, D: topi.einsum(subscripts, A, B, C, D),
+            symbolic_shapes,
+            ops,
+            out_shape,
+        )
 
     tvm.testing.assert_allclose(c1, c2, rtol=1e-5, atol=1e-5)
 
@@ -96,6 +103,9 @@ def verify_einsum(subscripts, shapes, shape_dict={}):
         ("...ik, ...jk, ...hk -> i...jh", [(3, 4, 4), (1, 5, 3, 8, 4), (2, 5, 3, 6, 4)]),
         ("ij,jk->ik", [(2, 3), (3, 4)]),
         ("ij,jk,km->im", [(2, 3), (3, 4), (4, 5)]),
+        ("ii,ij,jk->k", [(3, 3), (3, 4), (4, 5)]),
+        ("ij,jk,kl,lm->mi", [(2, 30), (30, 40), (40, 3), (3, 5)]),
+        ("abc,cd,bd,e->ae", [(2, 3, 4), (4, 5), (3, 5), (6,)]),
     ],
 )
 def test_einsum(equation, inputs):
@@ -114,5 +124,15 @@ def test_einsum_symblic_shape(equation, inputs, shape_dict):
     verify_einsum(equation, inputs, shape_dict)
 
 
+def test_einsum_contraction_path():
+    # The small outer operands are contracted into the large inner ones first.
+    path = topi.einsum_contraction_path(
+        "ij,jk,kl,lm->im", (2, 1000), (1000, 1000), (1000, 1000), (1000, 2)
+    )
+    assert path == [(0, 1, "ij,jk->ik"), (0, 1, "kl,lm->km"), (0, 1, "ik,km->im")]
+    assert topi.einsum_contraction_path("ij,jk->ik", (2, 3), (3, 4)) == []
+    assert topi.einsum_contraction_path("...j,j,j", (2, 3), (3,), (3,)) == []
+
+
 if __name__ == "__main__":
     tvm.testing.main()
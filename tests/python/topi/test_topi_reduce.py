@@ -74,6 +74,9 @@ in_shape, axis, keepdims, reduce_type, dtype = tvm.testing.parameters(
     ((3, 4, 5), (), True, "all", "bool"),
     ((3, 4, 5), (0, 1, 2), False, "all", "bool"),
     ((3, 4, 5), (0, 1, 2), True, "all", "bool"),
+    ((4, 4096), 1, False, "sum", "float32"),
+    ((1, 65536), (1,), True, "sum", "float32"),
+    ((2, 16, 4096), (1, 2), False, "max", "float32"),
 )
 
 
@@ -29,8 +29,9 @@ function __wasmLibInstantiateWasm(imports, successCallback) {
     __wasmLib.successCallback = successCallback;
 }
 
-function __wasmLibStart(wasmInstance) {
-    __wasmLib.successCallback(wasmInstance);
+// The module is passed on so that the threaded runtime can instantiate it in its workers.
+function __wasmLibStart(wasmInstance, wasmModule) {
+    __wasmLib.successCallback(wasmInstance, wasmModule);
 }
 
 __wasmLib.start = __wasmLibStart;
@@ -64,9 +64,16 @@
 #include "src/runtime/relax_vm/paged_kv_cache.cc"
 #include "src/runtime/relax_vm/rnn_state.cc"
 #include "src/runtime/relax_vm/vm.cc"
+// The threaded build, compiled with -pthread, runs the parallel tasks on the thread pool,
+// whose threads are backed by the pool of web workers of emscripten.
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include "src/runtime/thread_pool.cc"
+#include "src/runtime/threading_backend.cc"
+#endif
 
 // --- Implementations of backend and wasm runtime API. ---
 
+#ifndef __EMSCRIPTEN_PTHREADS__
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
@@ -75,6 +82,7 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
 }
 
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) { return 0; }
+#endif
 
 // --- Environment PackedFuncs for testing ---
 namespace tvm {
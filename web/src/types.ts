@@ -35,8 +35,9 @@ export interface LibraryProvider {
   /**
    * Callback function to notify the provider the created instance.
    * @param inst The created instance.
+   * @param module The module of the instance, which the threaded runtime shares with its workers.
    */
-  start: (inst: WebAssembly.Instance) => void;
+  start: (inst: WebAssembly.Instance, module?: WebAssembly.Module) => void;
 }
 
 /**
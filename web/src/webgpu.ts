@@ -302,7 +302,7 @@ class CanvasRenderManager implements Disposable {
     this.device.queue.submit([commandEncoder.finish()]);
   }
 
-  draw(buffer: GPUBuffer, height: number, width: number) {
+  draw(buffer: GPUBuffer, offset: number, height: number, width: number) {
     // resize the staging texture
     if (height != this.stagingTexture.height || width != this.stagingTexture.width) {
       this.stagingTexture.destroy();
@@ -319,7 +319,7 @@ class CanvasRenderManager implements Disposable {
     const commandEncoder = this.device.createCommandEncoder();
     commandEncoder.copyBufferToTexture({
       buffer: buffer,
-      offset: 0,
+      offset: offset,
       bytesPerRow: this.stagingTexture.width * 4
     }, {
       texture: this.stagingTexture
@@ -366,20 +366,69 @@ export interface FunctionInfo {
   launch_param_tags: Array<string>;
 }
 
+/**
+ * A region of a GPU buffer, which backs a GPUPointer.
+ */
+interface GPUBufferRegion {
+  buffer: GPUBuffer;
+  // offset of the region in the buffer
+  offset: number;
+  // size of the region, a multiple of 4
+  size: number;
+  // size class of a suballocated region, 0 for a dedicated buffer
+  sizeClass: number;
+  // unique id of the region once attached to the buffer table
+  id: number;
+}
+
+/**
+ * Round up a number to a multiple of the alignment.
+ */
+function alignUp(value: number, align: number): number {
+  return Math.ceil(value / align) * align;
+}
+
 /**
  * WebGPU context
  * Manages all the webgpu resources here.
+ *
+ * The dispatches and the copies within GPU are recorded into a pending command encoder,
+ * which is submitted once the current task, e.g. a function of the VM, returns, or
+ * before anything that has to observe the results of the commands.
  */
 export class WebGPUContext {
   device: GPUDevice;
   memory: Memory;
   // internal data
-  private bufferTable: Array<GPUBuffer | undefined> = [undefined];
+  private bufferTable: Array<GPUBufferRegion | undefined> = [undefined];
   private bufferTableFreeId: Array<number> = [];
-  private podArgStagingBuffers: Array<GPUBuffer> = [];
+  private nextRegionId = 0;
   private canvasRenderManager?: CanvasRenderManager = undefined;
-  // number of pod arg staging buffers
-  private maxNumPodArgsStagingBuffers = 2;
+  // the buffers no larger than this are suballocated from shared chunks
+  private maxSubAllocBytes = 1 << 20;
+  // size of the shared chunks
+  private subAllocChunkBytes = 1 << 24;
+  private subAllocChunks: Array<GPUBuffer> = [];
+  private subAllocChunkOffset = 0;
+  // free suballocated regions of each size class
+  private subAllocFreeRegions: Map<number, Array<GPUBufferRegion>> = new Map();
+  // the pending commands
+  private pendingCommandEncoder?: GPUCommandEncoder = undefined;
+  private pendingComputePass?: GPUComputePassEncoder = undefined;
+  // the pod args of the pending dispatches, written to the GPU when submitted
+  private podArgsBufferBytes = 1 << 18;
+  private podArgsBuffer?: GPUBuffer = undefined;
+  private podArgsHost = new ArrayBuffer(this.podArgsBufferBytes);
+  private podArgsHostI32 = new Int32Array(this.podArgsHost);
+  private podArgsHostU32 = new Uint32Array(this.podArgsHost);
+  private podArgsHostF32 = new Float32Array(this.podArgsHost);
+  private podArgsOffset = 0;
+  // the staging buffer of the copies to GPU while commands are pending
+  private uploadStagingBytes = 1 << 22;
+  private uploadStagingBuffer?: GPUBuffer = undefined;
+  private uploadStagingOffset = 0;
+  // maximum number of cached bind groups of each shader
+  private maxBindGroupCacheSize = 1024;
   // flags for debugging
   // stats of the runtime.
   // peak allocation
@@ -390,6 +439,8 @@ export class WebGPUContext {
   private allAllocatedBytes = 0;
   // shader submit counter
   private shaderSubmitCounter = 0;
+  // command buffer submit counter
+  private commandSubmitCounter = 0;
   // limite number of shaders to be submitted, useful for debugging, default to -1
   protected debugShaderSubmitLimit = -1;
   // log and sync each step
@@ -405,13 +456,21 @@ export class WebGPUContext {
    */
   dispose() {
     this.canvasRenderManager?.dispose();
+    this.pendingComputePass = undefined;
+    this.pendingCommandEncoder = undefined;
     this.bufferTableFreeId = [];
     while (this.bufferTable.length != 0) {
-      this.bufferTable.pop()?.destroy();
+      const region = this.bufferTable.pop();
+      if (region !== undefined && region.sizeClass == 0) {
+        region.buffer.destroy();
+      }
     }
-    while (this.podArgStagingBuffers.length != 0) {
-      this.podArgStagingBuffers.pop()?.destroy();
+    while (this.subAllocChunks.length != 0) {
+      this.subAllocChunks.pop()?.destroy();
     }
+    this.subAllocFreeRegions.clear();
+    this.podArgsBuffer?.destroy();
+    this.uploadStagingBuffer?.destroy();
     this.device.destroy();
   }
 
@@ -419,9 +478,30 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushCommands();
     await this.device.queue.onSubmittedWorkDone();
   }
 
+  /**
+   * Submit the pending commands to the GPU.
+   */
+  flushCommands(): void {
+    if (this.pendingCommandEncoder === undefined) return;
+    this.pendingComputePass?.end();
+    this.pendingComputePass = undefined;
+    if (this.podArgsOffset != 0) {
+      assert(this.podArgsBuffer !== undefined);
+      this.device.queue.writeBuffer(
+        this.podArgsBuffer, 0, this.podArgsHost, 0, this.podArgsOffset
+      );
+      this.podArgsOffset = 0;
+    }
+    this.uploadStagingOffset = 0;
+    this.device.queue.submit([this.pendingCommandEncoder.finish()]);
+    this.pendingCommandEncoder = undefined;
+    this.commandSubmitCounter += 1;
+  }
+
   /**
    * Obtain the runtime information in readable format.
    */
@@ -429,6 +509,7 @@ export class WebGPUContext {
     let info = "peak-memory=" + Math.ceil(this.peakAllocatedBytes / (1 << 20)) + " MB";
     info += ", all-memory=" + Math.ceil(this.allAllocatedBytes / (1 << 20)) + " MB";
     info += ", shader-submissions=" + this.shaderSubmitCounter;
+    info += ", command-submissions=" + this.commandSubmitCounter;
     return info;
   }
 
@@ -442,7 +523,9 @@ export class WebGPUContext {
     if (this.canvasRenderManager == undefined) {
       throw Error("Do not have a canvas context, call bindCanvas first");
     }
-    this.canvasRenderManager.draw(this.gpuBufferFromPtr(ptr), height, width);
+    this.flushCommands();
+    const region = this.gpuBufferRegionFromPtr(ptr);
+    this.canvasRenderManager.draw(region.buffer, region.offset, height, width);
   }
 
   /**
@@ -459,14 +542,7 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    // Perhaps it would be more useful to use a staging buffer?
-    this.device.queue.writeBuffer(
-      this.gpuBufferFromPtr(toPtr),
-      toOffset,
-      rawBytes,
-      0,
-      nbytes
-    );
+    this.writeBuffer(this.gpuBufferRegionFromPtr(toPtr), toOffset, rawBytes, nbytes);
   }
   /**
    * Clear canvas
@@ -508,37 +584,92 @@ export class WebGPUContext {
   }
 
   /**
-   * Get the pod arg staging buffer
-   * \param nbytes The minimum size.
-   * \return The allocated buffer
+   * Get the pending command encoder, ending its compute pass.
+   * @returns The command encoder.
    */
-  private getPodArgsBuffer(nbytes: number): GPUBuffer {
-    let buffer: GPUBuffer | undefined = undefined;
-    if (this.podArgStagingBuffers.length >= this.maxNumPodArgsStagingBuffers) {
-      buffer = this.podArgStagingBuffers.shift();
-    }
-    // minimum of 16 bytes
-    let allocSize = 16;
-    if (buffer !== undefined) {
-      allocSize = buffer.size;
-      if (buffer.size < nbytes) {
-        buffer.destroy();
-        buffer = undefined;
-      }
+  private getPendingCommandEncoder(): GPUCommandEncoder {
+    if (this.pendingCommandEncoder === undefined) {
+      this.pendingCommandEncoder = this.device.createCommandEncoder();
+      // submit the commands recorded by the current task once it returns.
+      queueMicrotask(() => this.flushCommands());
+    }
+    if (this.pendingComputePass !== undefined) {
+      this.pendingComputePass.end();
+      this.pendingComputePass = undefined;
     }
-    while (allocSize < nbytes) {
-      allocSize *= 2;
+    return this.pendingCommandEncoder;
+  }
+
+  /**
+   * Get the compute pass of the pending commands.
+   * @returns The compute pass.
+   */
+  private getPendingComputePass(): GPUComputePassEncoder {
+    if (this.pendingComputePass === undefined) {
+      this.pendingComputePass = this.getPendingCommandEncoder().beginComputePass();
     }
+    return this.pendingComputePass;
+  }
 
-    if (buffer == undefined) {
-      // create uniform buffer
-      buffer = tryCreateBuffer(this.device, {
-        size: allocSize,
+  /**
+   * Allocate the pod args of a dispatch in the pod arg buffer.
+   * \param nbytes The size of the pod args.
+   * \return The offset of the pod args in the pod arg buffer.
+   */
+  private allocPodArgs(nbytes: number): number {
+    let offset = alignUp(this.podArgsOffset, this.device.limits.minUniformBufferOffsetAlignment);
+    if (offset + nbytes > this.podArgsBufferBytes) {
+      // the pod args of the pending dispatches are written when the commands are submitted.
+      this.flushCommands();
+      offset = 0;
+    }
+    if (this.podArgsBuffer === undefined) {
+      this.podArgsBuffer = tryCreateBuffer(this.device, {
+        size: this.podArgsBufferBytes,
         usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_DST,
       });
     }
-    assert(nbytes <= buffer.size);
-    return buffer;
+    this.podArgsOffset = offset + nbytes;
+    return offset;
+  }
+
+  /**
+   * Write bytes into a buffer region in order with the pending commands.
+   *
+   * @param region The target buffer region.
+   * @param offset The beginning offset in the region.
+   * @param rawBytes The raw bytes, whose length is a multiple of 4.
+   * @param nbytes Number of bytes
+   */
+  private writeBuffer(
+    region: GPUBufferRegion,
+    offset: number,
+    rawBytes: Uint8Array,
+    nbytes: number
+  ): void {
+    if (this.pendingCommandEncoder !== undefined && nbytes <= this.uploadStagingBytes) {
+      // stage the bytes and copy them by the pending commands, so that the dispatches
+      // recorded before the copy do not observe the bytes.
+      const stagingOffset = alignUp(this.uploadStagingOffset, 4);
+      if (stagingOffset + nbytes <= this.uploadStagingBytes) {
+        if (this.uploadStagingBuffer === undefined) {
+          this.uploadStagingBuffer = tryCreateBuffer(this.device, {
+            size: this.uploadStagingBytes,
+            usage: GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
+          });
+        }
+        this.device.queue.writeBuffer(
+          this.uploadStagingBuffer, stagingOffset, rawBytes, 0, nbytes
+        );
+        this.getPendingCommandEncoder().copyBufferToBuffer(
+          this.uploadStagingBuffer, stagingOffset, region.buffer, region.offset + offset, nbytes
+        );
+        this.uploadStagingOffset = stagingOffset + nbytes;
+        return;
+      }
+    }
+    this.flushCommands();
+    this.device.queue.writeBuffer(region.buffer, region.offset + offset, rawBytes, 0, nbytes);
   }
 
   /**
@@ -616,6 +747,10 @@ export class WebGPUContext {
 
     // Function to create the pipeline.
     const createShaderFunc = (pipeline: GPUComputePipeline): Function => {
+      // the bind groups keyed by the ids of the buffer regions and the offset of the pod args,
+      // which repeat across the invocations of the same function of the VM.
+      const bindGroupCache: Map<string, GPUBindGroup> = new Map();
+
       const submitShader = (...args: Array<GPUPointer | number>): void => {
         if (this.debugShaderSubmitLimit != -1 &&
           this.shaderSubmitCounter >= this.debugShaderSubmitLimit) {
@@ -623,10 +758,6 @@ export class WebGPUContext {
           return;
         }
 
-        const commandEncoder = this.device.createCommandEncoder();
-        const compute = commandEncoder.beginComputePass();
-        compute.setPipeline(pipeline);
-        const bindGroupEntries: Array<GPUBindGroupEntry> = [];
         const numBufferOrPodArgs = bufferArgIndices.length + podArgIndices.length;
 
         assert(args.length == numBufferOrPodArgs + dispatchToDim.length);
@@ -660,58 +791,78 @@ export class WebGPUContext {
           assert(wl_x * wl_z >= packDimX);
         }
 
-        for (let i = 0; i < bufferArgIndices.length; ++i) {
-          bindGroupEntries.push({
-            binding: i,
-            resource: {
-              buffer: this.gpuBufferFromPtr(args[bufferArgIndices[i]])
-            }
-          });
-        }
-
-        // push pod buffer
+        // push pod args
         const sizeOfI32 = 4;
-        const podArgBuffer = this.getPodArgsBuffer((podArgIndices.length + 1) * sizeOfI32);
-        const i32View = new Int32Array(podArgIndices.length + 1);
-        const u32View = new Uint32Array(i32View.buffer);
-        const f32View = new Float32Array(i32View.buffer);
+        const podArgsBytes = (podArgIndices.length + 1) * sizeOfI32;
+        const podArgsOffset = this.allocPodArgs(podArgsBytes);
+        const podArgsBase = podArgsOffset / sizeOfI32;
+        const i32View = this.podArgsHostI32;
+        const u32View = this.podArgsHostU32;
+        const f32View = this.podArgsHostF32;
 
         for (let i = 0; i < podArgIndices.length; ++i) {
           const value = args[podArgIndices[i]];
           const dtype = finfo.arg_types[podArgIndices[i]];
           if (dtype.startsWith("int")) {
-            i32View[i] = value;
+            i32View[podArgsBase + i] = value;
           } else if (dtype.startsWith("uint")) {
-            u32View[i] = value;
+            u32View[podArgsBase + i] = value;
           } else if (dtype.startsWith("float")) {
-            f32View[i] = value;
+            f32View[podArgsBase + i] = value;
           } else {
             throw Error("Unknown pod dtype " + dtype);
           }
         }
         // always pass in dim z launching grid size in
-        u32View[podArgIndices.length] = packDimX;
-        this.device.queue.writeBuffer(podArgBuffer, 0, i32View.buffer);
+        u32View[podArgsBase + podArgIndices.length] = packDimX;
 
-        bindGroupEntries.push({
-          binding: bufferArgIndices.length,
-          resource: {
-            buffer: podArgBuffer,
-            size: i32View.buffer.byteLength
-          }
-        });
+        const regions: Array<GPUBufferRegion> = [];
+        let bindGroupKey = podArgsOffset.toString();
+        for (let i = 0; i < bufferArgIndices.length; ++i) {
+          const region = this.gpuBufferRegionFromPtr(args[bufferArgIndices[i]]);
+          regions.push(region);
+          bindGroupKey += "," + region.id;
+        }
 
-        compute.setBindGroup(0, this.device.createBindGroup({
-          layout: bindGroupLayout,
-          entries: bindGroupEntries
-        }));
+        let bindGroup = bindGroupCache.get(bindGroupKey);
+        if (bindGroup === undefined) {
+          const bindGroupEntries: Array<GPUBindGroupEntry> = [];
+          for (let i = 0; i < regions.length; ++i) {
+            bindGroupEntries.push({
+              binding: i,
+              resource: {
+                buffer: regions[i].buffer,
+                offset: regions[i].offset,
+                size: regions[i].size
+              }
+            });
+          }
+          assert(this.podArgsBuffer !== undefined);
+          bindGroupEntries.push({
+            binding: bufferArgIndices.length,
+            resource: {
+              buffer: this.podArgsBuffer,
+              offset: podArgsOffset,
+              size: podArgsBytes
+            }
+          });
+          bindGroup = this.device.createBindGroup({
+            layout: bindGroupLayout,
+            entries: bindGroupEntries
+          });
+          if (bindGroupCache.size >= this.maxBindGroupCacheSize) {
+            bindGroupCache.clear();
+          }
+          bindGroupCache.set(bindGroupKey, bindGroup);
+        }
 
-        compute.dispatchWorkgroups(workDim[0], workDim[1], workDim[2])
-        compute.end()
-        const command = commandEncoder.finish();
-        this.device.queue.submit([command]);
+        const compute = this.getPendingComputePass();
+        compute.setPipeline(pipeline);
+        compute.setBindGroup(0, bindGroup);
+        compute.dispatchWorkgroups(workDim[0], workDim[1], workDim[2]);
 
         if (this.debugLogFinish) {
+          this.flushCommands();
           const currCounter = this.shaderSubmitCounter;
           this.device.queue.onSubmittedWorkDone().then(() => {
             console.log("[" + currCounter + "][Debug] finish shader" + finfo.name);
@@ -803,31 +954,83 @@ export class WebGPUContext {
 
   // DeviceAPI
   private deviceAllocDataSpace(nbytes: number): GPUPointer {
-    // allocate 0 bytes buffer as 1 bytes buffer.
-    if (nbytes == 0) {
-      nbytes = 1;
-    }
-    const buffer = tryCreateBuffer(this.device, {
-      size: nbytes,
-      usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
-    });
-    this.currAllocatedBytes += nbytes;
-    this.allAllocatedBytes += nbytes;
-    if (this.currAllocatedBytes > this.peakAllocatedBytes) {
-      this.peakAllocatedBytes = this.currAllocatedBytes;
+    // allocate 0 bytes buffer as 4 bytes buffer, the sizes of bindings are multiples of 4.
+    const size = alignUp(Math.max(nbytes, 1), 4);
+    let region: GPUBufferRegion;
+    if (size <= this.maxSubAllocBytes) {
+      region = this.subAllocRegion(size);
+    } else {
+      const buffer = tryCreateBuffer(this.device, {
+        size: size,
+        usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
+      });
+      this.trackAllocation(size);
+      region = { buffer: buffer, offset: 0, size: size, sizeClass: 0, id: 0 };
     }
-    const ptr = this.attachToBufferTable(buffer);
+    const ptr = this.attachToBufferTable(region);
     return ptr;
   }
 
   private deviceFreeDataSpace(ptr: GPUPointer): void {
     const idx = ptr;
-    const buffer = this.bufferTable[idx];
+    const region = this.bufferTable[idx];
     this.bufferTable[idx] = undefined;
-    assert(buffer !== undefined);
+    assert(region !== undefined);
     this.bufferTableFreeId.push(idx);
-    this.currAllocatedBytes -= buffer.size;
-    buffer.destroy();
+    if (region.sizeClass != 0) {
+      // the pending commands that use the region run before any later use of it.
+      this.subAllocFreeRegions.get(region.sizeClass)?.push(region);
+      return;
+    }
+    // the buffer cannot be destroyed before the pending commands that use it are submitted.
+    this.flushCommands();
+    this.currAllocatedBytes -= region.size;
+    region.buffer.destroy();
+  }
+
+  /**
+   * Suballocate a buffer region from the shared chunks.
+   *
+   * The regions are in power of two size classes, which are aligned to the offset alignment
+   * of storage buffers, and are reused by the class once freed.
+   * \param size The size of the region.
+   * \return The region.
+   */
+  private subAllocRegion(size: number): GPUBufferRegion {
+    let sizeClass = this.device.limits.minStorageBufferOffsetAlignment;
+    while (sizeClass < size) {
+      sizeClass *= 2;
+    }
+    let freeRegions = this.subAllocFreeRegions.get(sizeClass);
+    if (freeRegions === undefined) {
+      freeRegions = [];
+      this.subAllocFreeRegions.set(sizeClass, freeRegions);
+    }
+    const freeRegion = freeRegions.pop();
+    if (freeRegion !== undefined) {
+      return { buffer: freeRegion.buffer, offset: freeRegion.offset, size: size, sizeClass, id: 0 };
+    }
+    if (this.subAllocChunks.length == 0 ||
+      this.subAllocChunkOffset + sizeClass > this.subAllocChunkBytes) {
+      this.subAllocChunks.push(tryCreateBuffer(this.device, {
+        size: this.subAllocChunkBytes,
+        usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
+      }));
+      this.trackAllocation(this.subAllocChunkBytes);
+      this.subAllocChunkOffset = 0;
+    }
+    const buffer = this.subAllocChunks[this.subAllocChunks.length - 1];
+    const offset = this.subAllocChunkOffset;
+    this.subAllocChunkOffset += sizeClass;
+    return { buffer: buffer, offset: offset, size: size, sizeClass: sizeClass, id: 0 };
+  }
+
+  private trackAllocation(nbytes: number): void {
+    this.currAllocatedBytes += nbytes;
+    this.allAllocatedBytes += nbytes;
+    if (this.currAllocatedBytes > this.peakAllocatedBytes) {
+      this.peakAllocatedBytes = this.currAllocatedBytes;
+    }
   }
 
   private deviceCopyToGPU(
@@ -836,22 +1039,16 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    // Perhaps it would be more useful to use a staging buffer?
     let rawBytes = this.memory.loadRawBytes(from, nbytes);
     if (rawBytes.length % 4 !== 0) {
       // writeBuffer requires length to be multiples of 4, so we pad here
       const toPad = 4 - rawBytes.length % 4;
-      rawBytes = new Uint8Array(rawBytes.length + toPad);
-      rawBytes.set(rawBytes);
+      const paddedBytes = new Uint8Array(rawBytes.length + toPad);
+      paddedBytes.set(rawBytes);
+      rawBytes = paddedBytes;
       nbytes = nbytes + toPad;
     }
-    this.device.queue.writeBuffer(
-      this.gpuBufferFromPtr(to),
-      toOffset,
-      rawBytes,
-      0,
-      nbytes
-    );
+    this.writeBuffer(this.gpuBufferRegionFromPtr(to), toOffset, rawBytes, nbytes);
   }
 
   private deviceCopyFromGPU(
@@ -866,16 +1063,15 @@ export class WebGPUContext {
       usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
     });
 
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
-      this.gpuBufferFromPtr(from),
-      fromOffset,
+    const region = this.gpuBufferRegionFromPtr(from);
+    this.getPendingCommandEncoder().copyBufferToBuffer(
+      region.buffer,
+      region.offset + fromOffset,
       gpuTemp,
       0,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
+    this.flushCommands();
 
     gpuTemp.mapAsync(GPUMapMode.READ).then(() => {
       const data = gpuTemp.getMappedRange();
@@ -891,32 +1087,34 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
-      this.gpuBufferFromPtr(from),
-      fromOffset,
-      this.gpuBufferFromPtr(to),
-      toOffset,
+    const fromRegion = this.gpuBufferRegionFromPtr(from);
+    const toRegion = this.gpuBufferRegionFromPtr(to);
+    this.getPendingCommandEncoder().copyBufferToBuffer(
+      fromRegion.buffer,
+      fromRegion.offset + fromOffset,
+      toRegion.buffer,
+      toRegion.offset + toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
   }
 
-  private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {
-    const buffer = this.bufferTable[ptr];
-    assert(buffer !== undefined);
-    return buffer;
+  private gpuBufferRegionFromPtr(ptr: GPUPointer): GPUBufferRegion {
+    const region = this.bufferTable[ptr];
+    assert(region !== undefined);
+    return region;
   }
 
-  private attachToBufferTable(buffer: GPUBuffer): GPUPointer {
+  private attachToBufferTable(region: GPUBufferRegion): GPUPointer {
+    // a new id for each attached region, so that the cached bind groups of a freed ptr
+    // are never reused.
+    region.id = this.nextRegionId++;
     if (this.bufferTableFreeId.length != 0) {
       const idx = this.bufferTableFreeId.pop() as number;
-      this.bufferTable[idx] = buffer;
+      this.bufferTable[idx] = region;
       return idx;
     } else {
       const idx = this.bufferTable.length;
-      this.bufferTable.push(buffer);
+      this.bufferTable.push(region);
       return idx;
     }
   }
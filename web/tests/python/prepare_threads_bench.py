@@ -0,0 +1,87 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Prepare the library and the page of the benchmark of the threaded wasm runtime.
+
+The library is a parallel and vectorized matmul linked with the threaded runtime of `make threads`,
+which the page `apps/browser/threads_bench.html` runs with one thread and with all threads. The
+shared memory of the threads needs a cross-origin isolated page, so `--serve` serves the files
+with the headers of the isolation.
+"""
+import argparse
+import http.server
+import os
+import shutil
+
+import tvm
+from tvm import te
+from tvm.contrib import tvmjs
+from tvm.relay.backend import Runtime
+
+TARGET = (
+    "llvm -mtriple=wasm32-unknown-unknown-wasm"
+    " -mattr=+simd128,+relaxed-simd,+atomics,+bulk-memory"
+)
+
+
+def prepare_matmul_lib(base_path, n):
+    runtime = Runtime("cpp", {"system-lib": True})
+    A = te.placeholder((n, n), name="A")
+    B = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    C = te.compute((n, n), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+    s = te.create_schedule(C.op)
+    i, j = s[C].op.axis
+    jo, ji = s[C].split(j, factor=4)
+    (kaxis,) = s[C].op.reduce_axis
+    s[C].reorder(i, jo, kaxis, ji)
+    s[C].vectorize(ji)
+    s[C].parallel(i)
+    fmatmul = tvm.build(s, [A, B, C], TARGET, runtime=runtime, name="matmul")
+
+    wasm_path = os.path.join(base_path, "threads_bench.wasm")
+    fmatmul.export_library(
+        wasm_path,
+        fcompile=lambda output, objects, **kwargs: tvmjs.create_tvmjs_wasm(
+            output, objects, threads=True, **kwargs
+        ),
+    )
+
+
+class IsolatedRequestHandler(http.server.SimpleHTTPRequestHandler):
+    """Serve the files of a cross-origin isolated page, which can use the shared memory."""
+
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        self.send_header("Cross-Origin-Embedder-Policy", "require-corp")
+        super().end_headers()
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--size", type=int, default=512)
+    parser.add_argument("--serve", action="store_true")
+    parser.add_argument("--port", type=int, default=8888)
+    args = parser.parse_args()
+
+    curr_path = os.path.dirname(os.path.abspath(os.path.expanduser(__file__)))
+    base_path = os.path.join(curr_path, "../../dist/wasm")
+    prepare_matmul_lib(base_path, args.size)
+    shutil.copy(os.path.join(curr_path, "../../apps/browser/threads_bench.html"), base_path)
+    if args.serve:
+        os.chdir(os.path.join(curr_path, "../../dist"))
+        print(f"Open http://localhost:{args.port}/wasm/threads_bench.html?n={args.size}")
+        http.server.ThreadingHTTPServer(("", args.port), IsolatedRequestHandler).serve_forever()